@@ -11,6 +11,11 @@ public abstract class AstVisitorClient
 	public abstract void logWarning(String warning);
 	
 	public abstract void logError(String error);
+	
+	// passes all buffered records on, called after a file has been indexed
+	public void flush()
+	{
+	}
 
 	public abstract void recordSymbol(
 			NameHierarchy symbolName, SymbolKind symbolKind, 
@@ -7,11 +7,17 @@ import java.io.InputStream;
 import java.io.OutputStream;
 import java.io.PrintWriter;
 import java.io.StringWriter;
+import java.lang.management.GarbageCollectorMXBean;
+import java.lang.management.ManagementFactory;
+import java.nio.ByteBuffer;
 import java.nio.file.Path;
 import java.nio.file.Paths;
 import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
 import java.util.Hashtable;
 import java.util.List;
+import java.util.Map;
 import java.util.jar.JarFile;
 import java.util.zip.ZipEntry;
 
@@ -23,119 +29,199 @@ import org.eclipse.jdt.core.dom.ASTVisitor;
 import org.eclipse.jdt.core.dom.BlockComment;
 import org.eclipse.jdt.core.dom.Comment;
 import org.eclipse.jdt.core.dom.CompilationUnit;
+import org.eclipse.jdt.core.dom.FileASTRequestor;
 import org.eclipse.jdt.core.dom.LineComment;
 import org.eclipse.jdt.core.dom.PackageDeclaration;
 
+import com.sourcetrail.name.resolver.LibraryNameCache;
+
 public class JavaIndexer 
-{	
+{
+	private static final double s_clearCachesHeapUsageRatio = 0.8;
+	
 	public static void processFile(int address, String filePath, String fileContent, String languageStandard, String classPath, int verbose)
 	{
 		processFile(new JavaIndexerAstVisitorClient(address), filePath, fileContent, languageStandard, classPath, verbose);
 	}
 	
-	public static void processFile(AstVisitorClient astVisitorClient, String filePath, String fileContent, String languageStandard, String classPath, int verbose)
+	// parses all files with a single parser, so the name environment built from the class path is shared by them
+	public static void processFiles(int[] addresses, String[] filePaths, String[] fileContents, String languageStandard, String classPath, int verbose)
 	{
+		if (filePaths.length == 0)
+		{
+			return;
+		}
+		
+		AstVisitorClient[] astVisitorClients = new AstVisitorClient[filePaths.length];
+		Map<String, Integer> filePathIndices = new HashMap<>();
+		for (int i = 0; i < filePaths.length; i++)
+		{
+			astVisitorClients[i] = new JavaIndexerAstVisitorClient(addresses[i]);
+			filePathIndices.put(filePaths[i], i);
+		}
+		
 		try
 		{
-			astVisitorClient.logInfo("indexing source file: " + filePath);
+			astVisitorClients[0].logInfo("indexing batch of " + filePaths.length + " source files");
 			
-			Path path = Paths.get(filePath);
-		
-			ASTParser parser = ASTParser.newParser(AST.JLS12);
+			ASTParser parser = createParser(languageStandard, classPath, astVisitorClients[0]);
 			
-			parser.setResolveBindings(true); // solve "bindings" like the declaration of the type used in a var decl
-			parser.setKind(ASTParser.K_COMPILATION_UNIT); // specify to parse the entire compilation unit
-			parser.setBindingsRecovery(true); // also return bindings that are not resolved completely
-			parser.setStatementsRecovery(true);
-
-			{
-				String convertedLanguageStandard = convertLanguageStandard(languageStandard);
-				astVisitorClient.logInfo("using language standard " + convertedLanguageStandard);
-				
-				Hashtable<String, String> options = JavaCore.getOptions();
-			    options.put(JavaCore.COMPILER_PB_ENABLE_PREVIEW_FEATURES, JavaCore.ENABLED);
-			    options.put(JavaCore.COMPILER_PB_REPORT_PREVIEW_FEATURES, JavaCore.IGNORE);
-			    options.put(JavaCore.COMPILER_SOURCE, convertedLanguageStandard);
-			    options.put(JavaCore.COMPILER_CODEGEN_TARGET_PLATFORM, convertedLanguageStandard);
-			    options.put(JavaCore.COMPILER_COMPLIANCE, convertedLanguageStandard);
-				parser.setCompilerOptions(options);
-			}
-			
-			parser.setUnitName(path.getFileName().toString());
-	
-			List<String> classpath = new ArrayList<>();
-			List<String> sources = new ArrayList<>();
+			String[] encodings = new String[filePaths.length];
+			Arrays.fill(encodings, "UTF-8");
 			
-			for (String classPathEntry: classPath.split("\\;"))
-			{	
-				if (classPathEntry.endsWith(".jar"))
-				{
-					classpath.add(classPathEntry);
-				}
-				else if(classPathEntry.endsWith(".aar"))
+			// the files are read from disk, the contents passed in only differ by replaced tabs and keep all offsets
+			parser.createASTs(filePaths, encodings, new String[0], new FileASTRequestor() 
+			{
+				@Override
+				public void acceptAST(String sourceFilePath, CompilationUnit cu)
 				{
-					File extractedJarFile = extractClassesJarFileFromAarFile(Paths.get(classPathEntry), astVisitorClient);
-					if (extractedJarFile != null)
+					Integer index = filePathIndices.get(sourceFilePath);
+					if (index == null)
 					{
-						classpath.add(extractedJarFile.getAbsolutePath());
+						astVisitorClients[0].logError("received AST of unknown source file: " + sourceFilePath);
+						return;
 					}
+					
+					AstVisitorClient astVisitorClient = astVisitorClients[index];
+					try
+					{
+						astVisitorClient.logInfo("indexing source file: " + sourceFilePath);
+						indexCompilationUnit(astVisitorClient, Paths.get(sourceFilePath), fileContents[index], cu, verbose);
+					}
+					catch (Exception e)
+					{
+						logException(astVisitorClient, e);
+					}
+					astVisitorClient.flush();
 				}
-				else if (!classPathEntry.isEmpty())
-				{
-					sources.add(classPathEntry);
-				}		
-			}
+			}, null);
+		}
+		catch (Exception e)
+		{
+			logException(astVisitorClients[0], e);
+		}
+	}
+	
+	public static void processFile(AstVisitorClient astVisitorClient, String filePath, String fileContent, String languageStandard, String classPath, int verbose)
+	{
+		try
+		{
+			astVisitorClient.logInfo("indexing source file: " + filePath);
 			
-			parser.setEnvironment(classpath.toArray(new String[0]), sources.toArray(new String[0]), null, true);
+			Path path = Paths.get(filePath);
+		
+			ASTParser parser = createParser(languageStandard, classPath, astVisitorClient);
+			parser.setUnitName(path.getFileName().toString());
 			parser.setSource(fileContent.toCharArray());
 			
 			CompilationUnit cu = (CompilationUnit) parser.createAST(null);
 			
-			ASTVisitor visitor;
-			if (verbose != 0)
-			{
-				visitor = new VerboseContextAwareAstVisitor(astVisitorClient, path.toFile(), fileContent, cu);
-			}
-			else
+			indexCompilationUnit(astVisitorClient, path, fileContent, cu, verbose);
+		}
+		catch (Exception e)
+		{
+			logException(astVisitorClient, e);
+		}
+		astVisitorClient.flush();
+	}
+	
+	private static ASTParser createParser(String languageStandard, String classPath, AstVisitorClient astVisitorClient)
+	{
+		ASTParser parser = ASTParser.newParser(AST.JLS12);
+		
+		parser.setResolveBindings(true); // solve "bindings" like the declaration of the type used in a var decl
+		parser.setKind(ASTParser.K_COMPILATION_UNIT); // specify to parse the entire compilation unit
+		parser.setBindingsRecovery(true); // also return bindings that are not resolved completely
+		parser.setStatementsRecovery(true);
+
+		{
+			String convertedLanguageStandard = convertLanguageStandard(languageStandard);
+			astVisitorClient.logInfo("using language standard " + convertedLanguageStandard);
+			
+			Hashtable<String, String> options = JavaCore.getOptions();
+		    options.put(JavaCore.COMPILER_PB_ENABLE_PREVIEW_FEATURES, JavaCore.ENABLED);
+		    options.put(JavaCore.COMPILER_PB_REPORT_PREVIEW_FEATURES, JavaCore.IGNORE);
+		    options.put(JavaCore.COMPILER_SOURCE, convertedLanguageStandard);
+		    options.put(JavaCore.COMPILER_CODEGEN_TARGET_PLATFORM, convertedLanguageStandard);
+		    options.put(JavaCore.COMPILER_COMPLIANCE, convertedLanguageStandard);
+			parser.setCompilerOptions(options);
+		}
+
+		List<String> classpath = new ArrayList<>();
+		List<String> sources = new ArrayList<>();
+		
+		for (String classPathEntry: classPath.split("\\;"))
+		{	
+			if (classPathEntry.endsWith(".jar"))
 			{
-				visitor = new ContextAwareAstVisitor(astVisitorClient, path.toFile(), fileContent, cu);
+				classpath.add(classPathEntry);
 			}
-			
-			astVisitorClient.logInfo("starting AST traversal");
-			
-			cu.accept(visitor);
-	
-			for (IProblem problem: cu.getProblems())
+			else if(classPathEntry.endsWith(".aar"))
 			{
-				if (problem.isError())
+				File extractedJarFile = extractClassesJarFileFromAarFile(Paths.get(classPathEntry), astVisitorClient);
+				if (extractedJarFile != null)
 				{
-					Range range = new Range(
-							cu.getLineNumber(problem.getSourceStart()),
-							cu.getColumnNumber(problem.getSourceStart() + 1),
-							cu.getLineNumber(problem.getSourceEnd()),
-							cu.getColumnNumber(problem.getSourceEnd()) + 1);
-	
-					astVisitorClient.recordError(problem.getMessage(), false, true, range);
+					classpath.add(extractedJarFile.getAbsolutePath());
 				}
 			}
-			
-			for (Object commentObject: cu.getCommentList())
+			else if (!classPathEntry.isEmpty())
 			{
-				if ((commentObject instanceof LineComment) || (commentObject instanceof BlockComment))
-				{
-					((Comment) commentObject).accept(visitor);
-				}
+				sources.add(classPathEntry);
+			}		
+		}
+		
+		parser.setEnvironment(classpath.toArray(new String[0]), sources.toArray(new String[0]), null, true);
+		
+		return parser;
+	}
+	
+	private static void indexCompilationUnit(AstVisitorClient astVisitorClient, Path path, String fileContent, CompilationUnit cu, int verbose)
+	{
+		ASTVisitor visitor;
+		if (verbose != 0)
+		{
+			visitor = new VerboseContextAwareAstVisitor(astVisitorClient, path.toFile(), fileContent, cu);
+		}
+		else
+		{
+			visitor = new ContextAwareAstVisitor(astVisitorClient, path.toFile(), fileContent, cu);
+		}
+		
+		astVisitorClient.logInfo("starting AST traversal");
+		
+		cu.accept(visitor);
+
+		for (IProblem problem: cu.getProblems())
+		{
+			if (problem.isError())
+			{
+				Range range = new Range(
+						cu.getLineNumber(problem.getSourceStart()),
+						cu.getColumnNumber(problem.getSourceStart() + 1),
+						cu.getLineNumber(problem.getSourceEnd()),
+						cu.getColumnNumber(problem.getSourceEnd()) + 1);
+
+				astVisitorClient.recordError(problem.getMessage(), false, true, range);
 			}
 		}
-		catch (Exception e)
+		
+		for (Object commentObject: cu.getCommentList())
 		{
-			StringWriter sw = new StringWriter();
-			PrintWriter pw = new PrintWriter(sw);
-			e.printStackTrace(pw);
-			astVisitorClient.logError(sw.toString());
+			if ((commentObject instanceof LineComment) || (commentObject instanceof BlockComment))
+			{
+				((Comment) commentObject).accept(visitor);
+			}
 		}
 	}
 	
+	private static void logException(AstVisitorClient astVisitorClient, Exception e)
+	{
+		StringWriter sw = new StringWriter();
+		PrintWriter pw = new PrintWriter(sw);
+		e.printStackTrace(pw);
+		astVisitorClient.logError(sw.toString());
+	}
+	
 	public static String getPackageName(String fileContent)
 	{
 		String packageName = "";
@@ -152,9 +238,31 @@ public class JavaIndexer
 		return packageName;
 	}
 	
+	// only collects garbage if the heap is about to run full, so the indexer does not stall on forced full collections
 	public static void clearCaches()
 	{
-		Runtime.getRuntime().gc();
+		Runtime runtime = Runtime.getRuntime();
+		long usedMemory = runtime.totalMemory() - runtime.freeMemory();
+		if (usedMemory > runtime.maxMemory() * s_clearCachesHeapUsageRatio)
+		{
+			LibraryNameCache.clear();
+			runtime.gc();
+		}
+	}
+	
+	// accumulated time all garbage collectors of the JVM have spent collecting so far
+	public static long getGarbageCollectionTime()
+	{
+		long time = 0;
+		for (GarbageCollectorMXBean gcBean: ManagementFactory.getGarbageCollectorMXBeans())
+		{
+			long collectionTime = gcBean.getCollectionTime();
+			if (collectionTime > 0)
+			{
+				time += collectionTime;
+			}
+		}
+		return time;
 	}
 	
 	private static String convertLanguageStandard(String s)
@@ -247,42 +355,6 @@ public class JavaIndexer
 	
 	static public native void logError(int address, String error);
 	
-	static public native void recordSymbol(
-			int address, String symbolName, int symbolType, 
-			int access, int definitionKind);
-
-	static public native void recordSymbolWithLocation(
-			int address, String symbolName, int symbolType, 
-			int beginLine, int beginColumn, int endLine, int endColumn,
-			int access, int definitionKind);
-	
-	static public native void recordSymbolWithLocationAndScope(
-			int address, String symbolName, int symbolType, 
-			int beginLine, int beginColumn, int endLine, int endColumn,
-			int scopeBeginLine, int scopeBeginColumn, int scopeEndLine, int scopeEndColumn,
-			int access, int definitionKind
-	);
-	
-	static public native void recordSymbolWithLocationAndScopeAndSignature(
-			int address, String symbolName, int symbolType, 
-			int beginLine, int beginColumn, int endLine, int endColumn,
-			int scopeBeginLine, int scopeBeginColumn, int scopeEndLine, int scopeEndColumn,
-			int signatureBeginLine, int signatureBeginColumn, int signatureEndLine, int signatureEndColumn,
-			int access, int definitionKind
-	);
-
-	static public native void recordReference(
-			int address, int referenceKind, String referencedName, String contextName, int beginLine, int beginColumn, int endLine, int endColumn);
-
-	static public native void recordQualifierLocation(
-			int address, String qualifierName, int beginLine, int beginColumn, int endLine, int endColumn);
-	
-	static public native void recordLocalSymbol(
-			int address, String symbolName, int beginLine, int beginColumn, int endLine, int endColumn);
-	
-	static public native void recordComment(
-			int address, int beginLine, int beginColumn, int endLine, int endColumn);
-	
-	static public native void recordError(
-			int address, String message, int fatal, int indexed, int beginLine, int beginColumn, int endLine, int endColumn);
-}
\ No newline at end of file
+	// passes the records serialized by a RecordChannel
+	static public native void flushRecords(int address, ByteBuffer buffer, int size);
+}
@@ -6,12 +6,14 @@ import com.sourcetrail.name.NameHierarchy;
 public class JavaIndexerAstVisitorClient extends AstVisitorClient 
 {
 	private int m_address;
+	private RecordChannel m_recordChannel;
 	private String m_javaLangPackageName;
 	private boolean m_javaLangPackageRecorded;
 
 	public JavaIndexerAstVisitorClient(int address)
 	{
 		m_address = address;
+		m_recordChannel = new RecordChannel(address);
 		
 		NameHierarchy javaLangPackageNameHierarchy = new NameHierarchy();
 		javaLangPackageNameHierarchy.push(new NameElement("java"));
@@ -44,14 +46,19 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		JavaIndexer.logError(m_address, error);
 	}
 	
+	@Override
+	public void flush()
+	{
+		m_recordChannel.flush();
+	}
+	
 	@Override
 	public void recordSymbol(
 			NameHierarchy symbolName, SymbolKind symbolKind,
 			AccessKind access, DefinitionKind definitionKind) 
 	{
-		JavaIndexer.recordSymbol(
-				m_address, symbolName.serialize(), symbolKind.getValue(),  
-				access.getValue(), definitionKind.getValue());
+		m_recordChannel.recordSymbol(
+				symbolName.serialize(), symbolKind.getValue(), access.getValue(), definitionKind.getValue());
 	}
 
 	@Override
@@ -59,10 +66,8 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 			NameHierarchy symbolName, SymbolKind symbolKind, Range range,
 			AccessKind access, DefinitionKind definitionKind) 
 	{
-		JavaIndexer.recordSymbolWithLocation(
-				m_address, symbolName.serialize(), symbolKind.getValue(), 
-				range.begin.line, range.begin.column, range.end.line, range.end.column, 
-				access.getValue(), definitionKind.getValue());
+		m_recordChannel.recordSymbolWithLocation(
+				symbolName.serialize(), symbolKind.getValue(), range, access.getValue(), definitionKind.getValue());
 	}
 
 	@Override
@@ -70,10 +75,8 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 			NameHierarchy symbolName, SymbolKind symbolKind, Range range,
 			Range scopeRange, AccessKind access, DefinitionKind definitionKind) 
 	{
-		JavaIndexer.recordSymbolWithLocationAndScope(
-				m_address, symbolName.serialize(), symbolKind.getValue(), 
-				range.begin.line, range.begin.column, range.end.line, range.end.column, 
-				scopeRange.begin.line, scopeRange.begin.column, scopeRange.end.line, scopeRange.end.column, 
+		m_recordChannel.recordSymbolWithLocationAndScope(
+				symbolName.serialize(), symbolKind.getValue(), range, scopeRange, 
 				access.getValue(), definitionKind.getValue());
 	}
 
@@ -82,11 +85,8 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 			NameHierarchy symbolName, SymbolKind symbolKind, Range range,
 			Range scopeRange, Range signatureRange, AccessKind access, DefinitionKind definitionKind) 
 	{
-		JavaIndexer.recordSymbolWithLocationAndScopeAndSignature(
-				m_address, symbolName.serialize(), symbolKind.getValue(), 
-				range.begin.line, range.begin.column, range.end.line, range.end.column, 
-				scopeRange.begin.line, scopeRange.begin.column, scopeRange.end.line, scopeRange.end.column, 
-				signatureRange.begin.line, signatureRange.begin.column, signatureRange.end.line, signatureRange.end.column, 
+		m_recordChannel.recordSymbolWithLocationAndScopeAndSignature(
+				symbolName.serialize(), symbolKind.getValue(), range, scopeRange, signatureRange, 
 				access.getValue(), definitionKind.getValue());
 	}
 
@@ -98,16 +98,15 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		String serializedReferencedName = referencedName.serialize();
 		if (!m_javaLangPackageRecorded && serializedReferencedName.startsWith(m_javaLangPackageName))
 		{
-			JavaIndexer.recordSymbol(
-					m_address, m_javaLangPackageName, SymbolKind.PACKAGE.getValue(),  
+			m_recordChannel.recordSymbol(
+					m_javaLangPackageName, SymbolKind.PACKAGE.getValue(),  
 					AccessKind.NONE.getValue(), DefinitionKind.NONE.getValue());
 			
 			m_javaLangPackageRecorded = true;
 		}
 		
-		JavaIndexer.recordReference(
-				m_address, referenceKind.getValue(), serializedReferencedName, contextName.serialize(), 
-				range.begin.line, range.begin.column, range.end.line, range.end.column);
+		m_recordChannel.recordReference(
+				referenceKind.getValue(), serializedReferencedName, contextName.serialize(), range);
 	}
 
 	@Override
@@ -115,32 +114,24 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 			NameHierarchy qualifierName, 
 			Range range)
 	{
-		JavaIndexer.recordQualifierLocation(
-				m_address, qualifierName.serialize(), 
-				range.begin.line, range.begin.column, range.end.line, range.end.column);
+		m_recordChannel.recordQualifierLocation(qualifierName.serialize(), range);
 	}
 
 	@Override
 	public void recordLocalSymbol(NameHierarchy symbolName, Range range) 
 	{
-		JavaIndexer.recordLocalSymbol(
-				m_address, symbolName.serialize(),
-				range.begin.line, range.begin.column, range.end.line, range.end.column);
+		m_recordChannel.recordLocalSymbol(symbolName.serialize(), range);
 	}
 
 	@Override
 	public void recordComment(Range range) 
 	{
-		JavaIndexer.recordComment(
-				m_address,
-				range.begin.line, range.begin.column, range.end.line, range.end.column);
+		m_recordChannel.recordComment(range);
 	}
 
 	@Override
 	public void recordError(String message, boolean fatal, boolean indexed, Range range) 
 	{
-		JavaIndexer.recordError(
-				m_address, message, (fatal ? 1 : 0), (indexed ? 1 : 0), 
-				range.begin.line, range.begin.column, range.end.line, range.end.column);
+		m_recordChannel.recordError(message, (fatal ? 1 : 0), (indexed ? 1 : 0), range);
 	}
 }
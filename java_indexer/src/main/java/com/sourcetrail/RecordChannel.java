@@ -0,0 +1,188 @@
+package com.sourcetrail;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.HashMap;
+import java.util.Map;
+
+// Serializes the records of one indexed file into a direct buffer that is passed to the native code in chunks.
+// Each distinct name is sent once and referenced by its id afterwards. The record layout has to match
+// RecordStreamDecoder.cpp.
+public class RecordChannel
+{
+	private static final int RECORD_NAME = 0;
+	private static final int RECORD_SYMBOL = 1;
+	private static final int RECORD_SYMBOL_WITH_LOCATION = 2;
+	private static final int RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE = 3;
+	private static final int RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE = 4;
+	private static final int RECORD_REFERENCE = 5;
+	private static final int RECORD_QUALIFIER_LOCATION = 6;
+	private static final int RECORD_LOCAL_SYMBOL = 7;
+	private static final int RECORD_COMMENT = 8;
+	private static final int RECORD_ERROR = 9;
+
+	private static final int s_defaultCapacity = 1024 * 1024;
+
+	private int m_address;
+	private ByteBuffer m_buffer;
+	private Map<String, Integer> m_nameIds = new HashMap<>();
+
+	public RecordChannel(int address)
+	{
+		m_address = address;
+		m_buffer = allocate(s_defaultCapacity);
+	}
+
+	public void recordSymbol(String symbolName, int symbolKind, int access, int definitionKind)
+	{
+		int nameId = getNameId(symbolName);
+		beginRecord(RECORD_SYMBOL, 4 * Integer.BYTES);
+		m_buffer.putInt(nameId);
+		m_buffer.putInt(symbolKind);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordSymbolWithLocation(
+			String symbolName, int symbolKind, Range range, int access, int definitionKind)
+	{
+		int nameId = getNameId(symbolName);
+		beginRecord(RECORD_SYMBOL_WITH_LOCATION, 8 * Integer.BYTES);
+		m_buffer.putInt(nameId);
+		m_buffer.putInt(symbolKind);
+		putRange(range);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordSymbolWithLocationAndScope(
+			String symbolName, int symbolKind, Range range, Range scopeRange, int access, int definitionKind)
+	{
+		int nameId = getNameId(symbolName);
+		beginRecord(RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE, 12 * Integer.BYTES);
+		m_buffer.putInt(nameId);
+		m_buffer.putInt(symbolKind);
+		putRange(range);
+		putRange(scopeRange);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordSymbolWithLocationAndScopeAndSignature(
+			String symbolName, int symbolKind, Range range, Range scopeRange, Range signatureRange,
+			int access, int definitionKind)
+	{
+		int nameId = getNameId(symbolName);
+		beginRecord(RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE, 16 * Integer.BYTES);
+		m_buffer.putInt(nameId);
+		m_buffer.putInt(symbolKind);
+		putRange(range);
+		putRange(scopeRange);
+		putRange(signatureRange);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordReference(int referenceKind, String referencedName, String contextName, Range range)
+	{
+		int referencedNameId = getNameId(referencedName);
+		int contextNameId = getNameId(contextName);
+		beginRecord(RECORD_REFERENCE, 7 * Integer.BYTES);
+		m_buffer.putInt(referenceKind);
+		m_buffer.putInt(referencedNameId);
+		m_buffer.putInt(contextNameId);
+		putRange(range);
+	}
+
+	public void recordQualifierLocation(String qualifierName, Range range)
+	{
+		int nameId = getNameId(qualifierName);
+		beginRecord(RECORD_QUALIFIER_LOCATION, 5 * Integer.BYTES);
+		m_buffer.putInt(nameId);
+		putRange(range);
+	}
+
+	public void recordLocalSymbol(String symbolName, Range range)
+	{
+		int nameId = getNameId(symbolName);
+		beginRecord(RECORD_LOCAL_SYMBOL, 5 * Integer.BYTES);
+		m_buffer.putInt(nameId);
+		putRange(range);
+	}
+
+	public void recordComment(Range range)
+	{
+		beginRecord(RECORD_COMMENT, 4 * Integer.BYTES);
+		putRange(range);
+	}
+
+	public void recordError(String message, int fatal, int indexed, Range range)
+	{
+		byte[] bytes = message.getBytes(StandardCharsets.UTF_8);
+		beginRecord(RECORD_ERROR, 7 * Integer.BYTES + bytes.length);
+		m_buffer.putInt(bytes.length);
+		m_buffer.put(bytes);
+		m_buffer.putInt(fatal);
+		m_buffer.putInt(indexed);
+		putRange(range);
+	}
+
+	public void flush()
+	{
+		if (m_buffer.position() > 0)
+		{
+			JavaIndexer.flushRecords(m_address, m_buffer, m_buffer.position());
+			m_buffer.clear();
+		}
+	}
+
+	private int getNameId(String name)
+	{
+		Integer id = m_nameIds.get(name);
+		if (id != null)
+		{
+			return id;
+		}
+
+		id = m_nameIds.size();
+		m_nameIds.put(name, id);
+
+		byte[] bytes = name.getBytes(StandardCharsets.UTF_8);
+		beginRecord(RECORD_NAME, 2 * Integer.BYTES + bytes.length);
+		m_buffer.putInt(id);
+		m_buffer.putInt(bytes.length);
+		m_buffer.put(bytes);
+
+		return id;
+	}
+
+	// makes sure the whole record fits into the buffer, so records never get split between flushes
+	private void beginRecord(int kind, int byteCount)
+	{
+		byteCount += Integer.BYTES;
+		if (m_buffer.remaining() < byteCount)
+		{
+			flush();
+
+			if (m_buffer.capacity() < byteCount)
+			{
+				m_buffer = allocate(Math.max(2 * m_buffer.capacity(), byteCount));
+			}
+		}
+		m_buffer.putInt(kind);
+	}
+
+	private void putRange(Range range)
+	{
+		m_buffer.putInt(range.begin.line);
+		m_buffer.putInt(range.begin.column);
+		m_buffer.putInt(range.end.line);
+		m_buffer.putInt(range.end.column);
+	}
+
+	private static ByteBuffer allocate(int capacity)
+	{
+		return ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder());
+	}
+}
@@ -96,8 +96,23 @@ public class BindingNameResolver extends NameResolver
 	
 	public static Optional<TypeName> getQualifiedName(ITypeBinding binding, File currentFile, CompilationUnit compilationUnit, ContextList ignoredContexts)
 	{
+		boolean cacheable = ignoredContexts == null && LibraryNameCache.isCacheable(binding);
+		if (cacheable)
+		{
+			Optional<TypeName> typeName = LibraryNameCache.getTypeName(binding);
+			if (typeName != null)
+			{
+				return typeName;
+			}
+		}
+		
 		BindingNameResolver resolver = new BindingNameResolver(currentFile, compilationUnit, ignoredContexts);
-		return resolver.getQualifiedName(binding);
+		Optional<TypeName> typeName = resolver.getQualifiedName(binding);
+		if (cacheable)
+		{
+			LibraryNameCache.putTypeName(binding, typeName);
+		}
+		return typeName;
 	}
 	
 	public Optional<TypeName> getQualifiedName(ITypeBinding binding)
@@ -177,8 +192,23 @@ public class BindingNameResolver extends NameResolver
 	
 	public static Optional<DeclName> getQualifiedName(IMethodBinding binding, File currentFile, CompilationUnit compilationUnit, ContextList ignoredContexts)
 	{
+		boolean cacheable = ignoredContexts == null && LibraryNameCache.isCacheable(binding);
+		if (cacheable)
+		{
+			Optional<DeclName> methodName = LibraryNameCache.getMethodName(binding);
+			if (methodName != null)
+			{
+				return methodName;
+			}
+		}
+		
 		BindingNameResolver resolver = new BindingNameResolver(currentFile, compilationUnit, ignoredContexts);
-		return resolver.getQualifiedName(binding);
+		Optional<DeclName> methodName = resolver.getQualifiedName(binding);
+		if (cacheable)
+		{
+			LibraryNameCache.putMethodName(binding, methodName);
+		}
+		return methodName;
 	}
 	
 	public Optional<DeclName> getQualifiedName(IMethodBinding binding)
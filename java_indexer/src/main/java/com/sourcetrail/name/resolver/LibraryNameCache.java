@@ -0,0 +1,102 @@
+package com.sourcetrail.name.resolver;
+
+import java.util.Map;
+import java.util.Optional;
+import java.util.concurrent.ConcurrentHashMap;
+
+import org.eclipse.jdt.core.dom.IMethodBinding;
+import org.eclipse.jdt.core.dom.ITypeBinding;
+
+import com.sourcetrail.name.DeclName;
+import com.sourcetrail.name.TypeName;
+
+// Keeps the resolved names of types and methods that come from class files for the lifetime of the JVM.
+// These names only depend on the class files themselves, so they are shared by all files, batches and
+// projects indexed by this process instead of being resolved again from the bindings of every file.
+// The maps are shared by the parsers of all threads of the process.
+public class LibraryNameCache
+{
+	private static final int s_maximumEntryCount = 200000;
+
+	private static Map<String, Optional<TypeName>> s_typeNames = new ConcurrentHashMap<>();
+	private static Map<String, Optional<DeclName>> s_methodNames = new ConcurrentHashMap<>();
+
+	// only names built entirely from class files are cached, captures and local types have keys that
+	// depend on the current file
+	public static boolean isCacheable(ITypeBinding binding)
+	{
+		if (binding == null || binding.isRecovered() || binding.isCapture() || binding.isWildcardType()
+			|| binding.isAnonymous() || binding.isLocal() || binding.getKey() == null)
+		{
+			return false;
+		}
+		if (binding.isArray())
+		{
+			return isCacheable(binding.getElementType());
+		}
+		if (binding.isParameterizedType())
+		{
+			for (ITypeBinding typeArgument: binding.getTypeArguments())
+			{
+				if (!isCacheable(typeArgument))
+				{
+					return false;
+				}
+			}
+			return isCacheable(binding.getTypeDeclaration());
+		}
+		return !binding.isFromSource();
+	}
+
+	public static boolean isCacheable(IMethodBinding binding)
+	{
+		if (binding == null || binding.isRecovered() || binding.getKey() == null
+			|| !isCacheable(binding.getDeclaringClass()))
+		{
+			return false;
+		}
+		for (ITypeBinding typeArgument: binding.getTypeArguments())
+		{
+			if (!isCacheable(typeArgument))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// the getters return null if the binding has not been resolved yet
+	public static Optional<TypeName> getTypeName(ITypeBinding binding)
+	{
+		return s_typeNames.get(binding.getKey());
+	}
+
+	public static void putTypeName(ITypeBinding binding, Optional<TypeName> typeName)
+	{
+		if (s_typeNames.size() >= s_maximumEntryCount)
+		{
+			s_typeNames.clear();
+		}
+		s_typeNames.put(binding.getKey(), typeName);
+	}
+
+	public static Optional<DeclName> getMethodName(IMethodBinding binding)
+	{
+		return s_methodNames.get(binding.getKey());
+	}
+
+	public static void putMethodName(IMethodBinding binding, Optional<DeclName> methodName)
+	{
+		if (s_methodNames.size() >= s_maximumEntryCount)
+		{
+			s_methodNames.clear();
+		}
+		s_methodNames.put(binding.getKey(), methodName);
+	}
+
+	public static void clear()
+	{
+		s_typeNames.clear();
+		s_methodNames.clear();
+	}
+}
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# Indexes the bundled sample projects from scratch and writes one json file per project with the
+# throughput, peak memory, database size and phase times of the run.
+# usage: benchmark_indexing.sh [path to Sourcetrail binary] [output directory]
+
+# Determine path to script
+MY_PATH=`dirname "$0"`
+
+cd $MY_PATH/..
+
+APP_PATH="$1"
+if [ -z "$APP_PATH" ]
+then
+	APP_PATH="build/Release/app/Sourcetrail"
+fi
+
+OUTPUT_PATH="$2"
+if [ -z "$OUTPUT_PATH" ]
+then
+	OUTPUT_PATH="build/benchmark"
+fi
+
+if [ ! -x "$APP_PATH" ]
+then
+	echo "Sourcetrail binary not found: $APP_PATH"
+	exit 1
+fi
+
+mkdir -p "$OUTPUT_PATH"
+
+FAILED=0
+for PROJECT_FILE in bin/app/user/projects/*/*.srctrlprj
+do
+	PROJECT_NAME=`basename "$PROJECT_FILE" .srctrlprj`
+	echo "benchmarking $PROJECT_NAME"
+	rm -f "$OUTPUT_PATH/$PROJECT_NAME.json"
+
+	"$APP_PATH" index --full --benchmark "$OUTPUT_PATH/$PROJECT_NAME.json" --project-file "$PROJECT_FILE"
+	if [ $? -ne 0 ] || [ ! -f "$OUTPUT_PATH/$PROJECT_NAME.json" ]
+	then
+		echo "benchmarking $PROJECT_NAME failed"
+		FAILED=1
+	fi
+done
+
+exit $FAILED
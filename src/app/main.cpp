@@ -1,7 +1,20 @@
 #include "includes.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <csignal>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+
+#ifdef _WIN32
+#	include <fcntl.h>
+#	include <io.h>
+#endif
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
 
 #include "language_packages.h"
 
@@ -11,25 +24,42 @@
 #include "CommandLineParser.h"
 #include "ConsoleLogger.h"
 #include "FileLogger.h"
+#include "FileSystem.h"
+#include "JsonProgressDialogView.h"
 #include "LanguagePackageManager.h"
+#include "LanguageServerService.h"
 #include "logging.h"
 #include "LogManager.h"
 #include "MessageIndexingInterrupted.h"
 #include "MessageLoadProject.h"
 #include "MessageStatus.h"
+#include "MetricsRegistry.h"
+#include "PersistentStorage.h"
 #include "productVersion.h"
+#include "ProjectSettings.h"
 #include "QtNetworkFactory.h"
 #include "QtApplication.h"
 #include "QtCoreApplication.h"
+#include "QtMetricsServer.h"
+#include "QtQueryServer.h"
 #include "QtViewFactory.h"
+#include "QtViewUpdateBatch.h"
 #include "ResourcePaths.h"
 #include "ScopedFunctor.h"
 #include "SourceGroupFactory.h"
 #include "SourceGroupFactoryModuleCustom.h"
+#include "SqliteIndexStorage.h"
+#include "StartupProfile.h"
+#include "StorageDiff.h"
+#include "StorageGraphWriter.h"
+#include "StorageQueryExecutor.h"
+#include "TimeStamp.h"
+#include "tracing.h"
 #include "UserPaths.h"
 #include "utility.h"
 #include "utilityApp.h"
 #include "utilityQt.h"
+#include "utilityString.h"
 #include "Version.h"
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
@@ -93,8 +123,179 @@ void addLanguagePackages()
 #endif // BUILD_JAVA_LANGUAGE_PACKAGE
 }
 
+void writeIndexingReport(const FilePath& projectFilePath, const FilePath& reportFilePath)
+{
+	const FilePath dbFilePath = projectFilePath.replaceExtension(ProjectSettings::INDEX_DB_FILE_EXTENSION);
+	if (!dbFilePath.exists())
+	{
+		std::wcout << L"ERROR: No index found to write report for: " << dbFilePath.wstr() << std::endl;
+		return;
+	}
+
+	const std::vector<StorageIndexingTime> indexingTimes = SqliteIndexStorage(dbFilePath).getIndexingTimes();
+
+	std::ofstream fileStream;
+	fileStream.open(reportFilePath.str(), std::ios::out | std::ios::trunc);
+	if (!fileStream.is_open())
+	{
+		std::wcout << L"ERROR: Could not write indexing report: " << reportFilePath.wstr() << std::endl;
+		return;
+	}
+
+	fileStream << "path,duration_ms,parse_duration_ms,visit_duration_ms,peak_memory_kb,"
+				  "storage_byte_count,gc_duration_ms\n";
+	for (const StorageIndexingTime& indexingTime: indexingTimes)
+	{
+		std::string path = utility::encodeToUtf8(indexingTime.filePath);
+		path = utility::replace(path, "\"", "\"\"");
+
+		fileStream << '"' << path << "\","
+			<< indexingTime.durationMs << ','
+			<< indexingTime.parseDurationMs << ','
+			<< indexingTime.visitDurationMs << ','
+			<< indexingTime.peakMemoryKb << ','
+			<< indexingTime.storageByteCount << ','
+			<< indexingTime.garbageCollectionDurationMs << '\n';
+	}
+
+	std::wcout << L"Wrote indexing report: " << reportFilePath.wstr() << std::endl;
+}
+
+void writeBenchmarkReport(
+	const FilePath& projectFilePath, const FilePath& benchmarkFilePath, const std::string& version)
+{
+	const FilePath dbFilePath = projectFilePath.replaceExtension(ProjectSettings::INDEX_DB_FILE_EXTENSION);
+	if (!dbFilePath.exists())
+	{
+		std::wcout << L"ERROR: No index found to write benchmark for: " << dbFilePath.wstr() << std::endl;
+		return;
+	}
+
+	QJsonObject phases;
+	float indexingDuration = 0.0f;
+	int fileCount = 0;
+	int symbolCount = 0;
+	int sourceLocationCount = 0;
+	int errorCount = 0;
+	size_t peakIndexerMemoryKb = 0;
+	{
+		SqliteIndexStorage storage(dbFilePath);
+		for (const std::pair<const std::string, float>& phase: storage.getIndexingPhaseDurations())
+		{
+			phases[QString::fromStdString(phase.first)] = phase.second;
+
+			// merging and injecting run while parsing
+			if (phase.first != "merge" && phase.first != "inject")
+			{
+				indexingDuration += phase.second;
+			}
+		}
+
+		fileCount = storage.getFileCount();
+		symbolCount = storage.getNodeCount();
+		sourceLocationCount = storage.getSourceLocationCount();
+		errorCount = storage.getErrorCount();
+
+		for (const StorageIndexingTime& indexingTime: storage.getIndexingTimes())
+		{
+			peakIndexerMemoryKb = std::max(peakIndexerMemoryKb, indexingTime.peakMemoryKb);
+		}
+	}
+
+	// the caches are built whenever the project is opened, so this is measured on its own
+	{
+		const TimeStamp start = TimeStamp::now();
+		PersistentStorage storage(dbFilePath, FilePath());
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		storage.buildCaches();
+		phases["cache_build"] = TimeStamp::durationSeconds(start);
+	}
+
+	const double seconds = std::max(double(indexingDuration), 0.001);
+
+	QJsonObject benchmark;
+	benchmark["version"] = QString::fromStdString(version);
+	benchmark["project"] = QString::fromStdWString(projectFilePath.wstr());
+	benchmark["timestamp"] = QString::fromStdString(TimeStamp::now().toString());
+	benchmark["duration_s"] = indexingDuration;
+	benchmark["file_count"] = fileCount;
+	benchmark["symbol_count"] = symbolCount;
+	benchmark["source_location_count"] = sourceLocationCount;
+	benchmark["error_count"] = errorCount;
+	benchmark["files_per_s"] = fileCount / seconds;
+	benchmark["symbols_per_s"] = symbolCount / seconds;
+	benchmark["peak_memory_kb"] = double(utility::getPeakMemoryUsageKb());
+	benchmark["peak_indexer_memory_kb"] = double(peakIndexerMemoryKb);
+	benchmark["database_byte_count"] = double(FileSystem::getFileByteSize(dbFilePath));
+	benchmark["phases_s"] = phases;
+
+	std::ofstream fileStream;
+	fileStream.open(benchmarkFilePath.str(), std::ios::out | std::ios::trunc);
+	if (!fileStream.is_open())
+	{
+		std::wcout << L"ERROR: Could not write benchmark: " << benchmarkFilePath.wstr() << std::endl;
+		return;
+	}
+
+	fileStream << QJsonDocument(benchmark).toJson(QJsonDocument::Indented).toStdString();
+
+	std::wcout << L"Wrote benchmark: " << benchmarkFilePath.wstr() << std::endl;
+}
+
+void writeMetrics(const FilePath& metricsFilePath)
+{
+	std::ofstream fileStream;
+	fileStream.open(metricsFilePath.str(), std::ios::out | std::ios::trunc);
+	if (!fileStream.is_open())
+	{
+		std::wcout << L"ERROR: Could not write metrics: " << metricsFilePath.wstr() << std::endl;
+		return;
+	}
+
+	if (metricsFilePath.extension() == L".prom")
+	{
+		fileStream << MetricsRegistry::getInstance()->toPrometheusText();
+	}
+	else
+	{
+		fileStream << MetricsRegistry::getInstance()->toJson();
+	}
+
+	std::wcout << L"Wrote metrics: " << metricsFilePath.wstr() << std::endl;
+}
+
+void writeMemoryReport(const FilePath& projectFilePath, const FilePath& memoryReportFilePath)
+{
+	const FilePath dbFilePath = projectFilePath.replaceExtension(ProjectSettings::INDEX_DB_FILE_EXTENSION);
+	if (!dbFilePath.exists())
+	{
+		std::wcout << L"ERROR: No index found to write memory report for: " << dbFilePath.wstr() << std::endl;
+		return;
+	}
+
+	std::ofstream fileStream;
+	fileStream.open(memoryReportFilePath.str(), std::ios::out | std::ios::trunc);
+	if (!fileStream.is_open())
+	{
+		std::wcout << L"ERROR: Could not write memory report: " << memoryReportFilePath.wstr() << std::endl;
+		return;
+	}
+
+	// measured on a freshly opened storage, as the GUI would hold it after loading the project
+	PersistentStorage storage(dbFilePath, FilePath());
+	storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+	storage.buildCaches();
+
+	fileStream << storage.getMemoryUsage().toString();
+	fileStream << "peak process memory: " << utility::getPeakMemoryUsageKb() << " KB" << std::endl;
+
+	std::wcout << L"Wrote memory report: " << memoryReportFilePath.wstr() << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
+	StartupProfile::getInstance()->start();
+
 	QCoreApplication::addLibraryPath(".");
 
 	if (utility::getOsType() == OS_LINUX && std::getenv("SOURCETRAIL_VIA_SCRIPT") == nullptr)
@@ -164,17 +365,332 @@ int main(int argc, char *argv[])
 		{
 			std::wcout << commandLineParser.getError() << std::endl;
 		}
+		else if (commandLineParser.getQueryServerPort() > 0)
+		{
+			// the server only reads the index, so interrupting it just ends the process
+			signal(SIGINT, SIG_DFL);
+			signal(SIGTERM, SIG_DFL);
+
+			QtQueryServer queryServer(
+				commandLineParser.getProjectFilePath().replaceExtension(
+					ProjectSettings::INDEX_DB_FILE_EXTENSION),
+				size_t(commandLineParser.getQueryServerWorkerCount()));
+			if (!queryServer.startListening(
+					QString::fromStdString(commandLineParser.getQueryServerHost()),
+					quint16(commandLineParser.getQueryServerPort())))
+			{
+				std::wcout << L"ERROR: Could not start the query server" << std::endl;
+				return 1;
+			}
+
+			return qtApp.exec();
+		}
+		else if (!commandLineParser.getQueriedSymbolNames().empty())
+		{
+			// stdout carries the answers, so log messages only go to the log file
+			LogManager::getInstance()->removeLoggersByType("ConsoleLogger");
+			signal(SIGINT, SIG_DFL);
+			signal(SIGTERM, SIG_DFL);
+
+			StorageQueryExecutor executor(
+				commandLineParser.getProjectFilePath().replaceExtension(
+					ProjectSettings::INDEX_DB_FILE_EXTENSION),
+				size_t(commandLineParser.getSymbolQueryWorkerCount()));
+			if (!executor.start())
+			{
+				std::cerr << "ERROR: The project has no index that can be queried" << std::endl;
+				return 1;
+			}
+
+			// each symbol is a query of its own, so the workers answer them in parallel
+			const std::vector<std::string>& symbolNames = commandLineParser.getQueriedSymbolNames();
+			std::vector<std::string> answers(symbolNames.size());
+			size_t answerCount = 0;
+			std::mutex answersMutex;
+			std::condition_variable answersCondition;
+			for (size_t i = 0; i < symbolNames.size(); i++)
+			{
+				executor.execute(
+					"symbol",
+					{{"name", symbolNames[i]}},
+					[&, i](const StorageQueryService::Response& response) {
+						QJsonObject answer =
+							QJsonDocument::fromJson(QByteArray::fromStdString(response.body)).object();
+						answer["query"] = QString::fromStdString(symbolNames[i]);
+
+						std::lock_guard<std::mutex> lock(answersMutex);
+						answers[i] =
+							QJsonDocument(answer).toJson(QJsonDocument::Compact).toStdString();
+						answerCount++;
+						answersCondition.notify_one();
+					});
+			}
+			{
+				std::unique_lock<std::mutex> lock(answersMutex);
+				answersCondition.wait(lock, [&]() { return answerCount == answers.size(); });
+			}
+			executor.stop();
+
+			// answers keep the order of the symbols, the ones not found carry an error message
+			std::cout << "[" << utility::join(answers, ",") << "]" << std::endl;
+			return 0;
+		}
+		else if (commandLineParser.getLanguageServerRequested())
+		{
+			// stdout carries the protocol, so log messages only go to the log file
+			LogManager::getInstance()->removeLoggersByType("ConsoleLogger");
+			signal(SIGINT, SIG_DFL);
+			signal(SIGTERM, SIG_DFL);
+
+			PersistentStorage storage(
+				commandLineParser.getProjectFilePath().replaceExtension(
+					ProjectSettings::INDEX_DB_FILE_EXTENSION),
+				FilePath());
+			if (storage.isEmpty() || storage.isIncompatible())
+			{
+				std::cerr << "ERROR: The project has no index the language server can use" << std::endl;
+				return 1;
+			}
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+			storage.buildCaches();
+
+#ifdef _WIN32
+			// content lengths count the line breaks of the messages as they are sent
+			_setmode(_fileno(stdin), _O_BINARY);
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			return LanguageServerService::run(&storage, std::cin, std::cout);
+		}
+		else if (!commandLineParser.getGraphExportFormat().empty())
+		{
+			PersistentStorage storage(
+				commandLineParser.getProjectFilePath().replaceExtension(
+					ProjectSettings::INDEX_DB_FILE_EXTENSION),
+				FilePath());
+			if (storage.isEmpty() || storage.isIncompatible())
+			{
+				std::cerr << "ERROR: The project has no index to write the graph of" << std::endl;
+				return 1;
+			}
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+			const FilePath filePath = commandLineParser.getGraphExportFilePath();
+			std::ofstream fileStream;
+			if (!filePath.empty())
+			{
+				fileStream.open(filePath.str(), std::ios::out | std::ios::binary);
+				if (!fileStream.is_open())
+				{
+					std::cerr << "ERROR: Could not open \"" << filePath.str() << "\" for writing"
+							  << std::endl;
+					return 1;
+				}
+			}
+			else
+			{
+				// stdout carries the graph, so log messages only go to the log file
+				LogManager::getInstance()->removeLoggersByType("ConsoleLogger");
+			}
+
+			StorageGraphWriter::Format format;
+			StorageGraphWriter::getFormatForName(commandLineParser.getGraphExportFormat(), &format);
+			StorageGraphWriter writer(format, filePath.empty() ? &std::cout : &fileStream);
+			storage.exportGraph(commandLineParser.getGraphExportEdgeTypes(), &writer);
+
+			std::cerr << "Wrote " << writer.getNodeCount() << " nodes and " << writer.getEdgeCount()
+					  << " edges" << std::endl;
+			return 0;
+		}
+		else if (!commandLineParser.getIndexDiffOldDbFilePath().empty())
+		{
+			const FilePath oldDbFilePath = commandLineParser.getIndexDiffOldDbFilePath();
+			const FilePath newDbFilePath = commandLineParser.getIndexDiffNewDbFilePath();
+			for (const FilePath& dbFilePath: {oldDbFilePath, newDbFilePath})
+			{
+				if (!dbFilePath.exists())
+				{
+					std::cerr << "ERROR: The index database \"" << dbFilePath.str()
+							  << "\" does not exist" << std::endl;
+					return 1;
+				}
+			}
+
+			SqliteIndexStorage oldStorage(oldDbFilePath);
+			SqliteIndexStorage newStorage(newDbFilePath);
+			if (oldStorage.isIncompatible() || newStorage.isIncompatible())
+			{
+				std::cerr << "ERROR: The index databases were written by another version of "
+							 "Sourcetrail"
+						  << std::endl;
+				return 1;
+			}
+
+			const FilePath filePath = commandLineParser.getIndexDiffFilePath();
+			std::ofstream fileStream;
+			if (!filePath.empty())
+			{
+				fileStream.open(filePath.str(), std::ios::out | std::ios::binary);
+				if (!fileStream.is_open())
+				{
+					std::cerr << "ERROR: Could not open \"" << filePath.str() << "\" for writing"
+							  << std::endl;
+					return 1;
+				}
+			}
+			else
+			{
+				// stdout carries the changes, so log messages only go to the log file
+				LogManager::getInstance()->removeLoggersByType("ConsoleLogger");
+			}
+
+			const size_t changeCount = StorageDiff(&oldStorage, &newStorage)
+										   .write(filePath.empty() ? &std::cout : &fileStream);
+			std::cerr << "Wrote " << changeCount << " changes" << std::endl;
+			return 0;
+		}
+		else if (!commandLineParser.getExportDirectoryPath().empty())
+		{
+			const FilePath projectFilePath = commandLineParser.getProjectFilePath();
+			PersistentStorage storage(
+				projectFilePath.replaceExtension(ProjectSettings::INDEX_DB_FILE_EXTENSION),
+				FilePath());
+			if (storage.isEmpty() || storage.isIncompatible())
+			{
+				std::cerr << "ERROR: The project has no index that can be exported" << std::endl;
+				return 1;
+			}
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+			storage.buildCaches();
+
+			// clients open the copied project file, which the index was built for
+			const FilePath exportDirectoryPath = commandLineParser.getExportDirectoryPath();
+			FileSystem::createDirectory(exportDirectoryPath);
+			const FilePath exportProjectFilePath =
+				FilePath(exportDirectoryPath).concatenate(projectFilePath.fileName());
+			for (const FilePath& filePath:
+				 {exportProjectFilePath,
+				  exportProjectFilePath.replaceExtension(ProjectSettings::INDEX_DB_FILE_EXTENSION),
+				  exportProjectFilePath.replaceExtension(
+					  ProjectSettings::CACHE_SNAPSHOT_FILE_EXTENSION)})
+			{
+				if (filePath.recheckExists())
+				{
+					std::cerr << "ERROR: The file \"" << filePath.str() << "\" already exists"
+							  << std::endl;
+					return 1;
+				}
+			}
+
+			if (!FileSystem::copyFile(projectFilePath, exportProjectFilePath) ||
+				!storage.exportSnapshot(
+					exportProjectFilePath.replaceExtension(ProjectSettings::INDEX_DB_FILE_EXTENSION),
+					exportProjectFilePath.replaceExtension(
+						ProjectSettings::CACHE_SNAPSHOT_FILE_EXTENSION)))
+			{
+				std::cerr << "ERROR: The snapshot could not be exported" << std::endl;
+				return 1;
+			}
+
+			std::cout << "Exported the snapshot to \"" << exportDirectoryPath.str() << "\""
+					  << std::endl;
+			return 0;
+		}
 		else
 		{
-			MessageLoadProject(
+			if (!commandLineParser.getTraceFilePath().empty())
+			{
+				TimelineTracer::setEnabled(true);
+			}
+
+			// the headless app never saves its settings, so these only apply to this run
+			std::shared_ptr<ApplicationSettings> appSettings = ApplicationSettings::getInstance();
+			if (commandLineParser.getIndexerProcessCount() > 0)
+			{
+				appSettings->setIndexerThreadCount(commandLineParser.getIndexerProcessCount());
+			}
+			if (commandLineParser.getStorageMemoryBudgetMb() > 0)
+			{
+				appSettings->setStorageMemoryBudgetMb(commandLineParser.getStorageMemoryBudgetMb());
+			}
+			if (const SqliteStorageSettings* settings = commandLineParser.getIndexingStorageSettings())
+			{
+				appSettings->setIndexingStorageSettings(*settings);
+			}
+
+			if (commandLineParser.getJsonProgressRequested())
+			{
+				// stdout carries the progress, so log messages only go to the log file
+				LogManager::getInstance()->removeLoggersByType("ConsoleLogger");
+				Application::getInstance()->setIndexingDialogView(
+					std::make_shared<JsonProgressDialogView>(std::cout));
+			}
+
+			MetricsRegistry::getInstance()->getGauge(
+				"sourcetrail_peak_memory_usage_kilobytes", "Peak memory used by the process"
+			).setFunction([](){ return double(utility::getPeakMemoryUsageKb()); });
+
+			MessageLoadProject message(
 				commandLineParser.getProjectFilePath(),
 				false,
 				commandLineParser.getRefreshMode(),
 				commandLineParser.getShallowIndexingRequested()
-			).dispatch();
+			);
+			message.indexShard = commandLineParser.getIndexShard();
+			message.shardDbFilesToMerge = commandLineParser.getShardDbFilesToMerge();
+			message.indexDeltaFilePath = commandLineParser.getIndexDeltaFilePath();
+			message.indexDeltaFilesToApply = commandLineParser.getIndexDeltaFilesToApply();
+			message.dispatch();
 		}
 
-		return qtApp.exec();
+		QtMetricsServer metricsServer;
+		if (!commandLineParser.hasError() && commandLineParser.getMetricsPort() > 0)
+		{
+			metricsServer.startListening(quint16(commandLineParser.getMetricsPort()));
+		}
+
+		const int result = qtApp.exec();
+
+		if (!commandLineParser.hasError() && !commandLineParser.getIndexingReportFilePath().empty())
+		{
+			writeIndexingReport(
+				commandLineParser.getProjectFilePath(),
+				commandLineParser.getIndexingReportFilePath()
+			);
+		}
+
+		if (!commandLineParser.hasError() && !commandLineParser.getBenchmarkFilePath().empty())
+		{
+			writeBenchmarkReport(
+				commandLineParser.getProjectFilePath(),
+				commandLineParser.getBenchmarkFilePath(),
+				version.toDisplayString()
+			);
+		}
+
+		if (!commandLineParser.hasError() && !commandLineParser.getTraceFilePath().empty())
+		{
+			TimelineTracer::setEnabled(false);
+			if (!TimelineTracer::exportChromeTrace(commandLineParser.getTraceFilePath()))
+			{
+				std::wcout << L"ERROR: Could not write trace: "
+					<< commandLineParser.getTraceFilePath().wstr() << std::endl;
+			}
+		}
+
+		if (!commandLineParser.hasError() && !commandLineParser.getMetricsFilePath().empty())
+		{
+			writeMetrics(commandLineParser.getMetricsFilePath());
+		}
+
+		if (!commandLineParser.hasError() && !commandLineParser.getMemoryReportFilePath().empty())
+		{
+			writeMemoryReport(
+				commandLineParser.getProjectFilePath(),
+				commandLineParser.getMemoryReportFilePath()
+			);
+		}
+
+		return result;
 	}
 	else
 	{
@@ -190,27 +706,42 @@ int main(int argc, char *argv[])
 			}
 		}
 #endif
+		StartupProfile* startupProfile = StartupProfile::getInstance();
+
 		QtApplication qtApp(argc, argv);
 
 		setupApp(argc, argv);
+		startupProfile->finishPhase("qt application");
 
 		setupLogging();
+		startupProfile->finishPhase("logging");
 
 		qtApp.setAttribute(Qt::AA_UseHighDpiPixmaps);
 
 		QtViewFactory viewFactory;
 		QtNetworkFactory networkFactory;
 
+		std::shared_ptr<QtViewUpdateBatch> viewUpdateBatch = std::make_shared<QtViewUpdateBatch>();
+		ViewUpdateBatch::setHandler(viewUpdateBatch);
+
 		Application::createInstance(version, &viewFactory, &networkFactory);
 		ScopedFunctor f([](){
 			Application::destroyInstance();
+			ViewUpdateBatch::setHandler(nullptr);
 		});
 
-		ApplicationSettingsPrefiller::prefillPaths(ApplicationSettings::getInstance().get());
 		addLanguagePackages();
+		startupProfile->finishPhase("language packages");
 
 		utility::loadFontsFromDirectory(ResourcePaths::getFontsPath(), L".otf");
 		utility::loadFontsFromDirectory(ResourcePaths::getFontsPath(), L".ttf");
+		startupProfile->finishPhase("fonts");
+
+		// fires once the event loop handled the pending paint events of the shown window
+		QTimer::singleShot(0, [startupProfile]() {
+			startupProfile->finish("first paint");
+			Application::getInstance()->startDeferredInitialization();
+		});
 
 		if (commandLineParser.hasError())
 		{
@@ -0,0 +1,56 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+const int nameWidth = 36;
+const int valueWidth = 12;
+}	 // namespace
+
+BenchmarkRunner::BenchmarkRunner(
+	std::ostream& out, size_t repetitionCount, const std::string& filter)
+	: m_out(out), m_repetitionCount(std::max<size_t>(1, repetitionCount)), m_filter(filter)
+{
+}
+
+bool BenchmarkRunner::isSelected(const std::string& name) const
+{
+	return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+void BenchmarkRunner::run(const std::string& name, const std::function<size_t()>& benchmark)
+{
+	if (!isSelected(name))
+	{
+		return;
+	}
+
+	size_t itemCount = benchmark();
+
+	std::vector<double> durations;
+	for (size_t i = 0; i < m_repetitionCount; i++)
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		itemCount = benchmark();
+		durations.push_back(
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+				.count());
+	}
+	std::sort(durations.begin(), durations.end());
+
+	m_out << std::left << std::setw(nameWidth) << name << std::right << std::fixed
+		  << std::setprecision(3) << std::setw(valueWidth) << durations.front()
+		  << std::setw(valueWidth) << durations[durations.size() / 2] << std::setw(valueWidth)
+		  << itemCount << std::endl;
+}
+
+void BenchmarkRunner::printHeader() const
+{
+	m_out << std::left << std::setw(nameWidth) << "benchmark" << std::right
+		  << std::setw(valueWidth) << "min ms" << std::setw(valueWidth) << "median ms"
+		  << std::setw(valueWidth) << "items" << std::endl;
+}
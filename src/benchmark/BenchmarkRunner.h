@@ -0,0 +1,29 @@
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Runs named benchmarks a fixed number of times after one warm up run and prints one line with the
+// minimum and median duration per benchmark. Benchmarks return the number of processed items, which
+// gets printed as well, so differing results between two runs show up next to the timings.
+class BenchmarkRunner
+{
+public:
+	BenchmarkRunner(std::ostream& out, size_t repetitionCount, const std::string& filter);
+
+	// lets callers skip building fixtures that no selected benchmark uses
+	bool isSelected(const std::string& name) const;
+
+	void run(const std::string& name, const std::function<size_t()>& benchmark);
+
+	void printHeader() const;
+
+private:
+	std::ostream& m_out;
+	const size_t m_repetitionCount;
+	const std::string m_filter;
+};
+
+#endif	  // BENCHMARK_RUNNER_H
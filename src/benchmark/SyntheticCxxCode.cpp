@@ -0,0 +1,207 @@
+#include "SyntheticCxxCode.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+void writeFile(const FilePath& filePath, const std::string& text)
+{
+	std::ofstream fileStream(filePath.str(), std::ios::out | std::ios::binary);
+	fileStream << text;
+}
+}	 // namespace
+
+std::string SyntheticCxxCode::getShapeName(Shape shape)
+{
+	switch (shape)
+	{
+	case SHAPE_NAMESPACES:
+		return "namespaces";
+	case SHAPE_TEMPLATES:
+		return "templates";
+	case SHAPE_OVERLOADS:
+		return "overloads";
+	case SHAPE_MACROS:
+		return "macros";
+	}
+	return "";
+}
+
+SyntheticCxxCode::SyntheticCxxCode(const SyntheticCxxCodeSize& size): m_size(size) {}
+
+FilePath SyntheticCxxCode::writeTranslationUnit(Shape shape, const FilePath& directoryPath) const
+{
+	const std::string name = getShapeName(shape);
+
+	std::string header = "#pragma once\n\n";
+	std::string source = "#include \"" + name + ".h\"\n\n";
+	switch (shape)
+	{
+	case SHAPE_NAMESPACES:
+		generateNamespaces(&header, &source);
+		break;
+	case SHAPE_TEMPLATES:
+		generateTemplates(&header, &source);
+		break;
+	case SHAPE_OVERLOADS:
+		generateOverloads(&header, &source);
+		break;
+	case SHAPE_MACROS:
+		generateMacros(&header, &source);
+		break;
+	}
+
+	writeFile(directoryPath.getConcatenated(FilePath(name + ".h")), header);
+
+	const FilePath sourceFilePath = directoryPath.getConcatenated(FilePath(name + ".cpp"));
+	writeFile(sourceFilePath, source);
+	return sourceFilePath;
+}
+
+void SyntheticCxxCode::generateNamespaces(std::string* header, std::string* source) const
+{
+	const size_t count = std::max<size_t>(1, m_size.namespaceCount);
+	for (size_t i = 0; i < count; i++)
+	{
+		const std::string index = std::to_string(i);
+		for (size_t j = 0; j < m_size.namespaceDepth; j++)
+		{
+			*header += "namespace n" + index + "_" + std::to_string(j) + " {\n";
+		}
+		*header += "class Type" + index + " {\npublic:\n\tint value() const;\n\tType" + index +
+			"* next = nullptr;\n};\n";
+		*header += "int function" + index + "(const Type" + index + "* type);\n";
+		for (size_t j = 0; j < m_size.namespaceDepth; j++)
+		{
+			*header += "}\n";
+		}
+		*header += "\n";
+	}
+
+	// every function calls into the namespace of the next one by its qualified name
+	for (size_t i = 0; i < count; i++)
+	{
+		const std::string index = std::to_string(i);
+		const std::string nextIndex = std::to_string((i + 1) % count);
+		const std::string name = getQualifiedNamespaceName(i);
+		const std::string nextName = getQualifiedNamespaceName((i + 1) % count);
+
+		*source += "int " + name + "::Type" + index + "::value() const {\n\treturn " + nextName +
+			"::function" + nextIndex + "(nullptr) + (next ? next->value() : 0);\n}\n";
+		*source += "int " + name + "::function" + index + "(const " + name + "::Type" + index +
+			"* type) {\n\treturn type ? type->value() : " + index + ";\n}\n\n";
+	}
+}
+
+void SyntheticCxxCode::generateTemplates(std::string* header, std::string* source) const
+{
+	const std::vector<std::string> types = {"int", "long", "double", "Value"};
+
+	*header += "struct Value {\n\tint x = 0;\n};\n\n";
+	for (size_t i = 0; i < m_size.templateCount; i++)
+	{
+		const std::string chain = "Chain" + std::to_string(i);
+		*header += "template <typename T, int N>\nstruct " + chain +
+			" {\n\tusing Type = typename " + chain + "<T, N - 1>::Type;\n\tT value;\n" +
+			"\ttemplate <typename U>\n\tU convert(const U& u) const { return u; }\n" +
+			"\tType get() const { return " + chain + "<T, N - 1>().get(); }\n};\n";
+		*header += "template <typename T>\nstruct " + chain +
+			"<T, 0> {\n\tusing Type = T;\n\tT value;\n\tType get() const { return value; }\n};\n";
+		*header += "template <typename T>\nT use" + chain + "() {\n\t" + chain + "<T, " +
+			std::to_string(m_size.templateDepth) +
+			"> chain;\n\tchain.convert(chain.value);\n\treturn chain.get();\n}\n\n";
+	}
+
+	*source += "int instantiateAll() {\n\tint count = 0;\n";
+	for (size_t i = 0; i < m_size.templateCount; i++)
+	{
+		for (const std::string& type: types)
+		{
+			*source += "\tuseChain" + std::to_string(i) + "<" + type + ">();\n\tcount++;\n";
+		}
+	}
+	*source += "\treturn count;\n}\n";
+}
+
+void SyntheticCxxCode::generateOverloads(std::string* header, std::string* source) const
+{
+	for (size_t i = 0; i < m_size.overloadCount; i++)
+	{
+		*header += "struct Arg" + std::to_string(i) + " {\n\tint v;\n};\n";
+	}
+
+	*header += "\nclass Overloaded {\npublic:\n";
+	for (size_t i = 0; i < m_size.overloadCount; i++)
+	{
+		const std::string arg = "Arg" + std::to_string(i);
+		*header += "\tint f(const " + arg + "& a);\n\tint f(const " + arg + "& a, int b);\n";
+	}
+	*header += "};\n\n";
+	for (size_t i = 0; i < m_size.overloadCount; i++)
+	{
+		*header += "int g(Arg" + std::to_string(i) + " a);\n";
+	}
+
+	for (size_t i = 0; i < m_size.overloadCount; i++)
+	{
+		const std::string arg = "Arg" + std::to_string(i);
+		*source += "int Overloaded::f(const " + arg + "& a) { return a.v; }\n";
+		*source += "int Overloaded::f(const " + arg + "& a, int b) { return a.v + b; }\n";
+		*source += "int g(" + arg + " a) { return a.v; }\n";
+	}
+
+	// each call resolves against all overloads of its name
+	*source += "\nint callAll() {\n\tOverloaded o;\n\tint r = 0;\n";
+	for (size_t i = 0; i < m_size.overloadCount; i++)
+	{
+		const std::string index = std::to_string(i);
+		const std::string arg = "Arg" + index + "{" + index + "}";
+		*source += "\tr += o.f(" + arg + ") + o.f(" + arg + ", " + index + ") + g(" + arg + ");\n";
+	}
+	*source += "\treturn r;\n}\n";
+}
+
+void SyntheticCxxCode::generateMacros(std::string* header, std::string* source) const
+{
+	*header +=
+		"#define SYNTHETIC_PROPERTY(type, name) \\\n"
+		"\ttype m_##name; \\\n"
+		"\ttype get_##name() const { return m_##name; } \\\n"
+		"\tvoid set_##name(type value) { m_##name = value; }\n"
+		"#define SYNTHETIC_ADD(a, b) ((a) + (b))\n"
+		"#define SYNTHETIC_SUM(a, b, c) SYNTHETIC_ADD(SYNTHETIC_ADD(a, b), c)\n\n";
+
+	*header += "class Properties {\npublic:\n";
+	for (size_t i = 0; i < m_size.macroCount; i++)
+	{
+		*header += "\tSYNTHETIC_PROPERTY(int, p" + std::to_string(i) + ")\n";
+	}
+	*header += "};\n";
+
+	const size_t count = std::max<size_t>(1, m_size.macroCount);
+	*source += "int sumAll(Properties& p) {\n\tint r = 0;\n";
+	for (size_t i = 0; i < m_size.macroCount; i++)
+	{
+		const std::string index = std::to_string(i);
+		*source += "\tp.set_p" + index + "(SYNTHETIC_SUM(" + index + ", r, p.get_p" +
+			std::to_string((i + 1) % count) + "()));\n\tr = SYNTHETIC_ADD(r, p.get_p" + index +
+			"());\n";
+	}
+	*source += "\treturn r;\n}\n";
+}
+
+std::string SyntheticCxxCode::getQualifiedNamespaceName(size_t index) const
+{
+	std::string name;
+	for (size_t j = 0; j < m_size.namespaceDepth; j++)
+	{
+		if (j)
+		{
+			name += "::";
+		}
+		name += "n" + std::to_string(index) + "_" + std::to_string(j);
+	}
+	return name;
+}
@@ -0,0 +1,50 @@
+#ifndef SYNTHETIC_CXX_CODE_H
+#define SYNTHETIC_CXX_CODE_H
+
+#include <string>
+
+#include "FilePath.h"
+
+struct SyntheticCxxCodeSize
+{
+	size_t namespaceCount = 16;
+	size_t namespaceDepth = 8;
+	size_t templateCount = 16;
+	size_t templateDepth = 8;
+	size_t overloadCount = 32;
+	size_t macroCount = 64;
+};
+
+// Generates translation units of C++ code that each stress one shape of code that is costly to
+// index: deeply nested namespaces, recursive templates, overloaded functions or macro expansions.
+// The same size always yields the same code, so timings of different builds can be compared.
+class SyntheticCxxCode
+{
+public:
+	enum Shape
+	{
+		SHAPE_NAMESPACES,
+		SHAPE_TEMPLATES,
+		SHAPE_OVERLOADS,
+		SHAPE_MACROS
+	};
+
+	static std::string getShapeName(Shape shape);
+
+	SyntheticCxxCode(const SyntheticCxxCodeSize& size);
+
+	// writes a header and a source file including it, returns the path of the source file
+	FilePath writeTranslationUnit(Shape shape, const FilePath& directoryPath) const;
+
+private:
+	void generateNamespaces(std::string* header, std::string* source) const;
+	void generateTemplates(std::string* header, std::string* source) const;
+	void generateOverloads(std::string* header, std::string* source) const;
+	void generateMacros(std::string* header, std::string* source) const;
+
+	std::string getQualifiedNamespaceName(size_t index) const;
+
+	const SyntheticCxxCodeSize m_size;
+};
+
+#endif	  // SYNTHETIC_CXX_CODE_H
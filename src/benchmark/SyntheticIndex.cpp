@@ -0,0 +1,167 @@
+#include "SyntheticIndex.h"
+
+#include <algorithm>
+
+#include "FilePath.h"
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "ParseLocation.h"
+#include "ParserClientImpl.h"
+
+namespace
+{
+// a fixed linear congruential generator, std distributions differ between standard libraries
+class Random
+{
+public:
+	size_t next(size_t bound)
+	{
+		m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+		return size_t(m_state >> 33) % bound;
+	}
+
+private:
+	unsigned long long m_state = 1;
+};
+
+std::wstring getNamespaceName(size_t fileIndex)
+{
+	return L"module" + std::to_wstring(fileIndex);
+}
+}	 // namespace
+
+SyntheticIndex::SyntheticIndex(const SyntheticIndexSize& size): m_size(size)
+{
+	Random random;
+
+	const size_t classCount = m_size.fileCount * m_size.classesPerFile;
+	const size_t methodCount = classCount * m_size.methodsPerClass;
+	for (size_t i = 0; i < classCount; i++)
+	{
+		Class c;
+		c.name = L"Class" + std::to_wstring(i);
+		c.fileIndex = i / std::max<size_t>(1, m_size.classesPerFile);
+		const size_t firstClassOfFile = c.fileIndex * m_size.classesPerFile;
+		c.baseIndex = (firstClassOfFile && random.next(2)) ? random.next(firstClassOfFile) : i;
+
+		for (size_t j = 0; j < m_size.methodsPerClass; j++)
+		{
+			Method method;
+			method.name = L"method" + std::to_wstring(j);
+			for (size_t k = 0; k < m_size.callsPerMethod; k++)
+			{
+				method.calleeIndices.push_back(random.next(methodCount));
+			}
+			c.methods.push_back(method);
+		}
+		m_classes.push_back(c);
+	}
+
+	for (const Class& c: m_classes)
+	{
+		const std::wstring className = getNamespaceName(c.fileIndex) + L"::" + c.name;
+		m_symbolNames.push_back(className);
+		for (const Method& method: c.methods)
+		{
+			m_symbolNames.push_back(className + L"::" + method.name);
+		}
+	}
+}
+
+void SyntheticIndex::recordTo(IntermediateStorage* storage) const
+{
+	ParserClientImpl client(storage);
+
+	std::vector<Id> fileIds;
+	for (size_t i = 0; i < m_size.fileCount; i++)
+	{
+		const Id fileId = client.recordFile(
+			FilePath(L"/synthetic/" + getNamespaceName(i) + L".cpp"), true);
+		client.recordFileLanguage(fileId, L"cpp");
+		fileIds.push_back(fileId);
+	}
+
+	std::vector<Id> classIds;
+	std::vector<Id> methodIds;
+	for (const Class& c: m_classes)
+	{
+		NameHierarchy className(getNamespaceName(c.fileIndex), NAME_DELIMITER_CXX);
+		className.push(c.name);
+
+		const Id classId = client.recordSymbol(className);
+		client.recordSymbolKind(classId, SYMBOL_CLASS);
+		client.recordDefinitionKind(classId, DEFINITION_EXPLICIT);
+		client.recordLocation(
+			classId, ParseLocation(fileIds[c.fileIndex], 1, 7, 1, 12), ParseLocationType::TOKEN);
+		classIds.push_back(classId);
+
+		for (size_t i = 0; i < c.methods.size(); i++)
+		{
+			NameHierarchy methodName = className;
+			methodName.push(c.methods[i].name);
+
+			const Id methodId = client.recordSymbol(methodName);
+			client.recordSymbolKind(methodId, SYMBOL_METHOD);
+			client.recordDefinitionKind(methodId, DEFINITION_EXPLICIT);
+			client.recordLocation(
+				methodId,
+				ParseLocation(fileIds[c.fileIndex], i + 2, 6, i + 2, 12),
+				ParseLocationType::TOKEN);
+			methodIds.push_back(methodId);
+		}
+	}
+
+	size_t methodIndex = 0;
+	for (size_t i = 0; i < m_classes.size(); i++)
+	{
+		const Class& c = m_classes[i];
+		if (c.baseIndex != i)
+		{
+			client.recordReference(
+				REFERENCE_INHERITANCE,
+				classIds[c.baseIndex],
+				classIds[i],
+				ParseLocation(fileIds[c.fileIndex], 1, 15, 1, 20));
+		}
+
+		for (size_t j = 0; j < c.methods.size(); j++)
+		{
+			const std::vector<size_t>& calleeIndices = c.methods[j].calleeIndices;
+			for (size_t k = 0; k < calleeIndices.size(); k++)
+			{
+				client.recordReference(
+					REFERENCE_CALL,
+					methodIds[calleeIndices[k]],
+					methodIds[methodIndex],
+					ParseLocation(fileIds[c.fileIndex], j + 2, k * 10 + 20, j + 2, k * 10 + 26));
+			}
+			methodIndex++;
+		}
+	}
+}
+
+const std::vector<std::wstring>& SyntheticIndex::getSymbolNames() const
+{
+	return m_symbolNames;
+}
+
+std::wstring SyntheticIndex::getSourceText() const
+{
+	std::wstring text;
+	for (size_t i = 0; i < m_classes.size(); i++)
+	{
+		const Class& c = m_classes[i];
+		text += L"class " + c.name;
+		if (c.baseIndex != i)
+		{
+			text += L": public " + m_classes[c.baseIndex].name;
+		}
+		text += L"\n{\n";
+		for (const Method& method: c.methods)
+		{
+			text += L"\tvoid " + method.name + L"();\n";
+		}
+		text += L"};\n\n";
+	}
+	return text;
+}
@@ -0,0 +1,53 @@
+#ifndef SYNTHETIC_INDEX_H
+#define SYNTHETIC_INDEX_H
+
+#include <string>
+#include <vector>
+
+class IntermediateStorage;
+
+struct SyntheticIndexSize
+{
+	size_t fileCount = 100;
+	size_t classesPerFile = 4;
+	size_t methodsPerClass = 8;
+	size_t callsPerMethod = 4;
+};
+
+// Generates the symbols and references of an imaginary code base: every file holds a namespace with
+// classes, the classes derive from classes of earlier files and their methods call random methods.
+// The same size always yields the same index, so timings of different builds can be compared.
+class SyntheticIndex
+{
+public:
+	SyntheticIndex(const SyntheticIndexSize& size);
+
+	void recordTo(IntermediateStorage* storage) const;
+
+	// qualified names of all classes and methods
+	const std::vector<std::wstring>& getSymbolNames() const;
+
+	// a source text that declares all classes and methods
+	std::wstring getSourceText() const;
+
+private:
+	struct Method
+	{
+		std::wstring name;
+		std::vector<size_t> calleeIndices;
+	};
+
+	struct Class
+	{
+		std::wstring name;
+		size_t fileIndex;
+		size_t baseIndex;	 // equal to the own index if there is none
+		std::vector<Method> methods;
+	};
+
+	const SyntheticIndexSize m_size;
+	std::vector<Class> m_classes;
+	std::vector<std::wstring> m_symbolNames;
+};
+
+#endif	  // SYNTHETIC_INDEX_H
@@ -0,0 +1,151 @@
+#include "TimingParserClient.h"
+
+#include <chrono>
+
+class TimingParserClient::ScopedTimer
+{
+public:
+	ScopedTimer(double* durationMs)
+		: m_durationMs(durationMs), m_start(std::chrono::steady_clock::now())
+	{
+	}
+
+	~ScopedTimer()
+	{
+		*m_durationMs +=
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start)
+				.count();
+	}
+
+private:
+	double* const m_durationMs;
+	const std::chrono::steady_clock::time_point m_start;
+};
+
+TimingParserClient::TimingParserClient(std::shared_ptr<ParserClient> client): m_client(client) {}
+
+double TimingParserClient::getRecordDurationMs() const
+{
+	return m_recordDurationMs;
+}
+
+size_t TimingParserClient::getVisitDurationMs() const
+{
+	return m_visitDurationMs;
+}
+
+Id TimingParserClient::recordFile(const FilePath& filePath, bool indexed)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	return m_client->recordFile(filePath, indexed);
+}
+
+void TimingParserClient::recordFileLanguage(Id fileId, const std::wstring& languageIdentifier)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordFileLanguage(fileId, languageIdentifier);
+}
+
+Id TimingParserClient::recordSymbol(const NameHierarchy& symbolName)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	return m_client->recordSymbol(symbolName);
+}
+
+void TimingParserClient::recordSymbolKind(Id symbolId, SymbolKind symbolKind)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordSymbolKind(symbolId, symbolKind);
+}
+
+void TimingParserClient::recordAccessKind(Id symbolId, AccessKind accessKind)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordAccessKind(symbolId, accessKind);
+}
+
+void TimingParserClient::recordDefinitionKind(Id symbolId, DefinitionKind definitionKind)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordDefinitionKind(symbolId, definitionKind);
+}
+
+Id TimingParserClient::recordReference(
+	ReferenceKind referenceKind,
+	Id referencedSymbolId,
+	Id contextSymbolId,
+	const ParseLocation& location)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	return m_client->recordReference(referenceKind, referencedSymbolId, contextSymbolId, location);
+}
+
+void TimingParserClient::recordLocalSymbol(const std::wstring& name, const ParseLocation& location)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordLocalSymbol(name, location);
+}
+
+void TimingParserClient::recordLocalSymbol(
+	const ParseLocation& declarationLocation, const ParseLocation& location)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordLocalSymbol(declarationLocation, location);
+}
+
+void TimingParserClient::recordLocation(
+	Id elementId, const ParseLocation& location, ParseLocationType type)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordLocation(elementId, location, type);
+}
+
+void TimingParserClient::recordLocations(const std::vector<LocationRecord>& records)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordLocations(records);
+}
+
+void TimingParserClient::recordComment(const ParseLocation& location)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordComment(location);
+}
+
+void TimingParserClient::recordError(
+	const std::wstring& message,
+	bool fatal,
+	bool indexed,
+	const FilePath& translationUnit,
+	const ParseLocation& location)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordError(message, fatal, indexed, translationUnit, location);
+}
+
+void TimingParserClient::recordIncompleteFile(Id fileId)
+{
+	ScopedTimer timer(&m_recordDurationMs);
+	m_client->recordIncompleteFile(fileId);
+}
+
+void TimingParserClient::recordVisitDuration(size_t durationMs)
+{
+	m_visitDurationMs += durationMs;
+	m_client->recordVisitDuration(durationMs);
+}
+
+void TimingParserClient::recordGarbageCollectionDuration(size_t durationMs)
+{
+	m_client->recordGarbageCollectionDuration(durationMs);
+}
+
+bool TimingParserClient::hasContent() const
+{
+	return m_client->hasContent();
+}
+
+std::shared_ptr<MemoryArena> TimingParserClient::getMemoryArena() const
+{
+	return m_client->getMemoryArena();
+}
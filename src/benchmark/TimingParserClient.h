@@ -0,0 +1,62 @@
+#ifndef TIMING_PARSER_CLIENT_H
+#define TIMING_PARSER_CLIENT_H
+
+#include <memory>
+
+#include "ParserClient.h"
+
+// Forwards all records to another client and sums up the time they take, which tells the cost of
+// recording apart from the traversal of the parser that calls it.
+class TimingParserClient: public ParserClient
+{
+public:
+	TimingParserClient(std::shared_ptr<ParserClient> client);
+
+	double getRecordDurationMs() const;
+	size_t getVisitDurationMs() const;
+
+	Id recordFile(const FilePath& filePath, bool indexed) override;
+	void recordFileLanguage(Id fileId, const std::wstring& languageIdentifier) override;
+
+	Id recordSymbol(const NameHierarchy& symbolName) override;
+	void recordSymbolKind(Id symbolId, SymbolKind symbolKind) override;
+	void recordAccessKind(Id symbolId, AccessKind accessKind) override;
+	void recordDefinitionKind(Id symbolId, DefinitionKind definitionKind) override;
+
+	Id recordReference(
+		ReferenceKind referenceKind,
+		Id referencedSymbolId,
+		Id contextSymbolId,
+		const ParseLocation& location) override;
+
+	void recordLocalSymbol(const std::wstring& name, const ParseLocation& location) override;
+	void recordLocalSymbol(
+		const ParseLocation& declarationLocation, const ParseLocation& location) override;
+	void recordLocation(Id elementId, const ParseLocation& location, ParseLocationType type) override;
+	void recordLocations(const std::vector<LocationRecord>& records) override;
+	void recordComment(const ParseLocation& location) override;
+
+	void recordError(
+		const std::wstring& message,
+		bool fatal,
+		bool indexed,
+		const FilePath& translationUnit,
+		const ParseLocation& location) override;
+	void recordIncompleteFile(Id fileId) override;
+
+	void recordVisitDuration(size_t durationMs) override;
+	void recordGarbageCollectionDuration(size_t durationMs) override;
+
+	bool hasContent() const override;
+
+	std::shared_ptr<MemoryArena> getMemoryArena() const override;
+
+private:
+	class ScopedTimer;
+
+	std::shared_ptr<ParserClient> m_client;
+	double m_recordDurationMs = 0;
+	size_t m_visitDurationMs = 0;
+};
+
+#endif	  // TIMING_PARSER_CLIENT_H
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "BenchmarkRunner.h"
+#include "Edge.h"
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "Graph.h"
+#include "HierarchyCache.h"
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "NodeType.h"
+#include "NodeTypeSet.h"
+#include "PersistentStorage.h"
+#include "SearchIndex.h"
+#include "SqliteIndexStorage.h"
+#include "SuffixArray.h"
+#include "SyntheticIndex.h"
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+#	include "CxxParser.h"
+#	include "FileRegister.h"
+#	include "IndexerCommandCxx.h"
+#	include "IndexerStateInfo.h"
+#	include "ParserClientImpl.h"
+#	include "SyntheticCxxCode.h"
+#	include "TimingParserClient.h"
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+
+namespace
+{
+void printUsage()
+{
+	std::cout << "usage: Sourcetrail_benchmark [--files <count>]";
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	std::cout << " [--cxx-scale <factor>]";
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+	std::cout << " [--repetitions <count>] [--filter <text>]" << std::endl;
+	std::cout << "  --files        number of synthetic files, each with 4 classes of 8 methods "
+				 "(default 100)"
+			  << std::endl;
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	std::cout << "  --cxx-scale    factor for the size of the synthetic c++ code that gets parsed "
+				 "(default 1)"
+			  << std::endl;
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+	std::cout << "  --repetitions  timed runs per benchmark after one warm up run (default 5)"
+			  << std::endl;
+	std::cout << "  --filter       only runs the benchmarks whose names contain the text"
+			  << std::endl;
+}
+
+std::shared_ptr<IntermediateStorage> recordIndex(const SyntheticIndex& index)
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	index.recordTo(storage.get());
+	return storage;
+}
+
+void runSearchBenchmarks(BenchmarkRunner& runner, const SyntheticIndex& index)
+{
+	const std::vector<std::wstring>& names = index.getSymbolNames();
+
+	runner.run("search_index_build", [&]() {
+		SearchIndex searchIndex;
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			searchIndex.addNode(i + 1, names[i]);
+		}
+		searchIndex.finishSetup();
+		return names.size();
+	});
+
+	SearchIndex searchIndex;
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		searchIndex.addNode(i + 1, names[i]);
+	}
+	searchIndex.finishSetup();
+
+	// the queries don't extend each other, so no search continues from the paths of the last one
+	const std::vector<std::wstring> queries = {
+		L"mc", L"class12", L"module3::", L"meth7", L"m1c2m3", L"xyz"};
+	runner.run("search_index_search", [&]() {
+		size_t resultCount = 0;
+		for (const std::wstring& query: queries)
+		{
+			resultCount += searchIndex.search(query, NodeTypeSet::all(), 100).size();
+		}
+		return resultCount;
+	});
+}
+
+void runSuffixArrayBenchmarks(BenchmarkRunner& runner, const SyntheticIndex& index)
+{
+	const std::wstring text = index.getSourceText();
+
+	runner.run("suffix_array_build", [&]() {
+		SuffixArray array(text);
+		return text.size();
+	});
+
+	const SuffixArray array(text);
+	const std::vector<std::wstring> terms = {L"class", L"method3", L": public Class1", L"xyz"};
+	runner.run("suffix_array_search", [&]() {
+		size_t hitCount = 0;
+		for (const std::wstring& term: terms)
+		{
+			hitCount += array.searchForTerm(term).size();
+		}
+		return hitCount;
+	});
+}
+
+void runStorageBenchmarks(BenchmarkRunner& runner, const SyntheticIndex& index)
+{
+	runner.run("intermediate_storage_record", [&]() {
+		return recordIndex(index)->getStorageNodes().size();
+	});
+
+	const std::vector<std::string> storageBenchmarkNames = {
+		"sqlite_for_each_node",
+		"sqlite_for_each_edge",
+		"sqlite_for_each_source_location",
+		"hierarchy_cache_children",
+		"hierarchy_cache_visible_parents",
+		"graph_for_trail"};
+	bool storageSelected = false;
+	for (const std::string& name: storageBenchmarkNames)
+	{
+		storageSelected = storageSelected || runner.isSelected(name);
+	}
+	if (!storageSelected)
+	{
+		return;
+	}
+
+	const FilePath directoryPath(L"benchmark_data");
+	FileSystem::createDirectory(directoryPath);
+
+	const FilePath dbPath = directoryPath.getConcatenated(L"benchmark.srctrldb");
+	const FilePath bookmarkPath = directoryPath.getConcatenated(L"benchmark.srctrlbm");
+	std::shared_ptr<IntermediateStorage> intermediateStorage = recordIndex(index);
+	{
+		PersistentStorage storage(dbPath, bookmarkPath);
+		storage.setup();
+		storage.clear();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.inject(intermediateStorage.get());
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		storage.buildCaches();
+
+		std::vector<Id> methodIds;
+		for (const StorageNode& node: intermediateStorage->getStorageNodes())
+		{
+			if (NodeType::intToType(node.type) == NodeType::NODE_METHOD)
+			{
+				methodIds.push_back(storage.getNodeIdForNameHierarchy(
+					NameHierarchy::deserializeFromBinary(node.serializedName)));
+			}
+		}
+
+		SqliteIndexStorage sqliteStorage(dbPath);
+		runner.run("sqlite_for_each_node", [&]() {
+			size_t count = 0;
+			sqliteStorage.forEach<StorageNode>([&](StorageNode&&) { count++; });
+			return count;
+		});
+		runner.run("sqlite_for_each_edge", [&]() {
+			size_t count = 0;
+			sqliteStorage.forEach<StorageEdge>([&](StorageEdge&&) { count++; });
+			return count;
+		});
+		runner.run("sqlite_for_each_source_location", [&]() {
+			size_t count = 0;
+			sqliteStorage.forEach<StorageSourceLocation>([&](StorageSourceLocation&&) { count++; });
+			return count;
+		});
+
+		HierarchyCache hierarchyCache;
+		for (const StorageEdge& edge: intermediateStorage->getStorageEdges())
+		{
+			if (Edge::intToType(edge.type) == Edge::EDGE_MEMBER)
+			{
+				hierarchyCache.createConnection(
+					edge.id, edge.sourceNodeId, edge.targetNodeId, true, false, false);
+			}
+			else if (Edge::intToType(edge.type) == Edge::EDGE_INHERITANCE)
+			{
+				hierarchyCache.createInheritance(edge.id, edge.sourceNodeId, edge.targetNodeId);
+			}
+		}
+		hierarchyCache.finishSetup();
+
+		runner.run("hierarchy_cache_children", [&]() {
+			std::vector<Id> nodeIds;
+			std::vector<Id> edgeIds;
+			for (const StorageNode& node: intermediateStorage->getStorageNodes())
+			{
+				hierarchyCache.addAllChildIdsForNodeId(node.id, &nodeIds, &edgeIds);
+			}
+			return nodeIds.size();
+		});
+		runner.run("hierarchy_cache_visible_parents", [&]() {
+			std::set<Id> nodeIds;
+			std::set<Id> edgeIds;
+			for (const StorageNode& node: intermediateStorage->getStorageNodes())
+			{
+				hierarchyCache.addAllVisibleParentIdsForNodeId(node.id, &nodeIds, &edgeIds);
+			}
+			return nodeIds.size();
+		});
+
+		// trails of the callees of some methods spread over the whole index
+		runner.run("graph_for_trail", [&]() {
+			size_t nodeCount = 0;
+			for (size_t i = 0; i < methodIds.size(); i += std::max<size_t>(1, methodIds.size() / 16))
+			{
+				nodeCount += storage
+								 .getGraphForTrail(
+									 methodIds[i],
+									 0,
+									 NodeType::NODE_METHOD | NodeType::NODE_CLASS,
+									 Edge::EDGE_CALL,
+									 false,
+									 5,
+									 true)
+								 ->getNodeCount();
+			}
+			return nodeCount;
+		});
+	}
+
+	for (const FilePath& filePath: FileSystem::getFilePathsFromDirectory(directoryPath))
+	{
+		FileSystem::remove(filePath);
+	}
+	FileSystem::remove(directoryPath);
+}
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+void runCxxParserBenchmarks(BenchmarkRunner& runner, const SyntheticCxxCodeSize& size)
+{
+	const std::vector<SyntheticCxxCode::Shape> shapes = {
+		SyntheticCxxCode::SHAPE_NAMESPACES,
+		SyntheticCxxCode::SHAPE_TEMPLATES,
+		SyntheticCxxCode::SHAPE_OVERLOADS,
+		SyntheticCxxCode::SHAPE_MACROS};
+
+	bool cxxSelected = false;
+	for (SyntheticCxxCode::Shape shape: shapes)
+	{
+		cxxSelected = cxxSelected ||
+			runner.isSelected("cxx_parse_" + SyntheticCxxCode::getShapeName(shape));
+	}
+	if (!cxxSelected)
+	{
+		return;
+	}
+
+	// the parser reports canonical paths, which have to match the indexed paths
+	FilePath directoryPath(L"benchmark_cxx_data");
+	FileSystem::createDirectory(directoryPath);
+	directoryPath.makeCanonical();
+
+	const SyntheticCxxCode code(size);
+	for (SyntheticCxxCode::Shape shape: shapes)
+	{
+		const std::string name = "cxx_parse_" + SyntheticCxxCode::getShapeName(shape);
+		if (!runner.isSelected(name))
+		{
+			continue;
+		}
+
+		const FilePath sourceFilePath = code.writeTranslationUnit(shape, directoryPath);
+		const std::shared_ptr<IndexerCommandCxx> indexerCommand = std::make_shared<IndexerCommandCxx>(
+			sourceFilePath,
+			std::set<FilePath>({directoryPath}),
+			std::set<FilePathFilter>(),
+			std::set<FilePathFilter>(),
+			directoryPath,
+			std::vector<std::wstring>({L"-std=c++14"}));
+
+		// caches are left out, so every run parses and records all of the code
+		double durationMs = 0;
+		std::shared_ptr<TimingParserClient> client;
+		std::shared_ptr<IntermediateStorage> storage;
+		runner.run(name, [&]() {
+			storage = std::make_shared<IntermediateStorage>();
+			client = std::make_shared<TimingParserClient>(
+				std::make_shared<ParserClientImpl>(storage.get()));
+			CxxParser parser(
+				client,
+				std::make_shared<FileRegister>(
+					sourceFilePath, indexerCommand->getIndexedPaths(), std::set<FilePathFilter>()),
+				std::make_shared<IndexerStateInfo>());
+
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			parser.buildIndex(indexerCommand);
+			durationMs = std::chrono::duration<double, std::milli>(
+							 std::chrono::steady_clock::now() - start)
+							 .count();
+			return storage->getSourceLocationCount();
+		});
+
+		// the visit includes recording, the rest of the time is spent parsing
+		std::cout << std::fixed << std::setprecision(3) << "  parse "
+				  << durationMs - double(client->getVisitDurationMs()) << " ms, visit "
+				  << client->getVisitDurationMs() << " ms, record " << client->getRecordDurationMs()
+				  << " ms, " << storage->getStorageNodes().size() << " nodes, "
+				  << storage->getStorageEdges().size() << " edges, "
+				  << storage->getStorageOccurrences().size() << " occurrences, "
+				  << storage->getByteSize(sizeof(std::wstring)) << " bytes" << std::endl;
+	}
+
+	for (const FilePath& filePath: FileSystem::getFilePathsFromDirectory(directoryPath))
+	{
+		FileSystem::remove(filePath);
+	}
+	FileSystem::remove(directoryPath);
+}
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+}	 // namespace
+
+// Times the storage and search functions that dominate indexing and browsing on a synthetic index.
+// The index only depends on the passed size, so runs of different builds measure the same work.
+int main(int argc, char* argv[])
+{
+	SyntheticIndexSize size;
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	size_t cxxScale = 1;
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+	size_t repetitionCount = 5;
+	std::string filter;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (i + 1 < argc && arg == "--files")
+		{
+			size.fileCount = std::stoul(argv[++i]);
+		}
+#if BUILD_CXX_LANGUAGE_PACKAGE
+		else if (i + 1 < argc && arg == "--cxx-scale")
+		{
+			cxxScale = std::max<size_t>(1, std::stoul(argv[++i]));
+		}
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+		else if (i + 1 < argc && arg == "--repetitions")
+		{
+			repetitionCount = std::stoul(argv[++i]);
+		}
+		else if (i + 1 < argc && arg == "--filter")
+		{
+			filter = argv[++i];
+		}
+		else
+		{
+			printUsage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	const SyntheticIndex index(size);
+	std::cout << "synthetic index: " << size.fileCount << " files, "
+			  << index.getSymbolNames().size() << " symbols" << std::endl;
+
+	BenchmarkRunner runner(std::cout, repetitionCount, filter);
+	runner.printHeader();
+	runSearchBenchmarks(runner, index);
+	runSuffixArrayBenchmarks(runner, index);
+	runStorageBenchmarks(runner, index);
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	SyntheticCxxCodeSize cxxSize;
+	cxxSize.namespaceCount *= cxxScale;
+	cxxSize.templateCount *= cxxScale;
+	cxxSize.overloadCount *= cxxScale;
+	cxxSize.macroCount *= cxxScale;
+	runCxxParserBenchmarks(runner, cxxSize);
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+
+	return 0;
+}
@@ -10,6 +10,7 @@
 #include "FileLogger.h"
 #include "logging.h"
 #include "LogManager.h"
+#include "utilitySystemResources.h"
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
 #include "LanguagePackageCxx.h"
@@ -91,6 +92,20 @@ int main(int argc, char *argv[])
 	LOG_INFO(L"appPath: " + AppPath::getAppPath().wstr());
 	LOG_INFO(L"userDataPath: " + UserPaths::getUserDataPath().wstr());
 
+	// pinned before any indexing, so the memory of the process gets allocated on its node
+	if (processId >= 0 && appSettings->getIndexerNumaPinningEnabled() &&
+		utility::pinProcessToNumaNode(size_t(processId)))
+	{
+		LOG_INFO("Pinned indexer process " + std::to_string(processId) + " to a numa node");
+	}
+
+	// keeps the ui of the app responsive while all cpus are busy indexing
+	if (processId >= 0 && appSettings->getIndexingInteractivePriorityEnabled() &&
+		utility::lowerProcessPriority())
+	{
+		LOG_INFO("Lowered priority of indexer process " + std::to_string(processId));
+	}
+
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
 	LanguagePackageManager::getInstance()->addPackage(std::make_shared<LanguagePackageCxx>());
@@ -1,9 +1,14 @@
 #include "Application.h"
 
+#include <algorithm>
+
+#include "ActivationLatencyTracker.h"
 #include "AppPath.h"
 #include "ApplicationSettings.h"
+#include "ApplicationSettingsPrefiller.h"
 #include "ColorScheme.h"
 #include "DialogView.h"
+#include "FileContentCache.h"
 #include "FileSystem.h"
 #include "GraphViewStyle.h"
 #include "IDECommunicationController.h"
@@ -14,12 +19,16 @@
 #include "MessageFilterSearchAutocomplete.h"
 #include "MessageQueue.h"
 #include "MessageQuitApplication.h"
+#include "MessageShowStatus.h"
 #include "MessageStatus.h"
 #include "NetworkFactory.h"
 #include "ProjectSettings.h"
 #include "SharedMemoryGarbageCollector.h"
+#include "SqliteQueryProfile.h"
+#include "StartupProfile.h"
 #include "StorageCache.h"
 #include "TabId.h"
+#include "TaskLambda.h"
 #include "TaskManager.h"
 #include "TaskScheduler.h"
 #include "UpdateChecker.h"
@@ -28,6 +37,7 @@
 #include "ViewFactory.h"
 #include "logging.h"
 #include "tracing.h"
+#include "utilityApp.h"
 #include "utilityString.h"
 #include "utilityUuid.h"
 
@@ -46,7 +56,10 @@ void Application::createInstance(
 		GraphViewStyle::setImpl(viewFactory->createGraphStyleImpl());
 	}
 
+	StartupProfile* profile = StartupProfile::getInstance();
+
 	loadSettings();
+	profile->finishPhase("settings");
 
 	SharedMemoryGarbageCollector* collector = SharedMemoryGarbageCollector::createInstance();
 	if (collector)
@@ -61,23 +74,25 @@ void Application::createInstance(
 	s_instance = std::shared_ptr<Application>(new Application(hasGui));
 
 	s_instance->m_storageCache = std::make_shared<StorageCache>();
+	profile->finishPhase("schedulers");
 
 	if (hasGui)
 	{
 		s_instance->m_mainView = viewFactory->createMainView(s_instance->m_storageCache.get());
 		s_instance->m_mainView->setup();
+		profile->finishPhase("views");
 	}
 
 	if (networkFactory != nullptr)
 	{
+		// the server socket is opened by startDeferredInitialization
 		s_instance->m_ideCommunicationController = networkFactory->createIDECommunicationController(
 			s_instance->m_storageCache.get());
-		s_instance->m_ideCommunicationController->startListening();
-
 		s_instance->m_updateChecker = networkFactory->createUpdateChecker();
 	}
 
 	s_instance->startMessagingAndScheduling();
+	profile->finishPhase("messaging");
 }
 
 std::shared_ptr<Application> Application::getInstance()
@@ -112,6 +127,13 @@ void Application::loadSettings()
 	settings->load(UserPaths::getAppSettingsPath());
 
 	LogManager::getInstance()->setLoggingEnabled(settings->getLoggingEnabled());
+	ActivationLatencyTracker::getInstance()->setBudgetMs(
+		size_t(std::max(0, settings->getActivationLatencyBudgetMs())));
+	FileContentCache::getInstance()->setByteBudget(
+		size_t(std::max(0, settings->getFileContentCacheMb())) * 1024 * 1024);
+	SqliteQueryProfile::getInstance()->setEnabled(settings->getSqliteQueryProfilingEnabled());
+	SqliteQueryProfile::getInstance()->setSlowThresholdMs(
+		size_t(std::max(0, settings->getSqliteSlowQueryThresholdMs())));
 
 	loadStyle(settings->getColorSchemePath());
 }
@@ -136,6 +158,37 @@ Application::~Application()
 	{
 		collector->stop();
 	}
+
+	LOG_INFO(FileContentCache::getInstance()->getReport());
+
+	SqliteQueryProfile* queryProfile = SqliteQueryProfile::getInstance();
+	if (queryProfile->isEnabled())
+	{
+		const FilePath reportPath = UserPaths::getLogPath().concatenate(L"sqlite_query_profile.txt");
+		if (!queryProfile->writeReport(reportPath))
+		{
+			LOG_WARNING(L"Could not write the sqlite query profile to " + reportPath.wstr());
+		}
+	}
+}
+
+void Application::startDeferredInitialization()
+{
+	if (m_deferredInitializationStarted)
+	{
+		return;
+	}
+	m_deferredInitializationStarted = true;
+
+	Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([this]() {
+		if (m_ideCommunicationController)
+		{
+			m_ideCommunicationController->startListening();
+		}
+
+		// runs the java and header path detection at first launch
+		ApplicationSettingsPrefiller::prefillPaths(ApplicationSettings::getInstance().get());
+	}));
 }
 
 std::shared_ptr<const Project> Application::getCurrentProject() const
@@ -184,9 +237,19 @@ std::shared_ptr<DialogView> Application::getDialogView(DialogView::UseCase useCa
 		return m_mainView->getDialogView(useCase);
 	}
 
+	if (useCase == DialogView::UseCase::INDEXING && m_indexingDialogView)
+	{
+		return m_indexingDialogView;
+	}
+
 	return std::make_shared<DialogView>(useCase, nullptr);
 }
 
+void Application::setIndexingDialogView(std::shared_ptr<DialogView> dialogView)
+{
+	m_indexingDialogView = dialogView;
+}
+
 void Application::updateHistoryMenu(std::shared_ptr<MessageBase> message)
 {
 	m_mainView->updateHistoryMenu(message);
@@ -314,9 +377,22 @@ void Application::handleMessage(MessageLoadProject* message)
 				.dispatch();
 		}
 
-		if (message->refreshMode != REFRESH_NONE)
+		if (!message->shardDbFilesToMerge.empty())
 		{
-			refreshProject(message->refreshMode, message->shallowIndexingRequested);
+			mergeIndexShards(message->shardDbFilesToMerge);
+		}
+		else if (!message->indexDeltaFilesToApply.empty())
+		{
+			applyIndexDeltas(message->indexDeltaFilesToApply);
+		}
+		else if (message->refreshMode != REFRESH_NONE)
+		{
+			if (m_project && !message->indexDeltaFilePath.empty())
+			{
+				m_project->setIndexDeltaFilePath(message->indexDeltaFilePath);
+			}
+			refreshProject(
+				message->refreshMode, message->shallowIndexingRequested, message->indexShard);
 		}
 	}
 }
@@ -325,6 +401,16 @@ void Application::handleMessage(MessageRefresh* message)
 {
 	TRACE("app refresh");
 
+	if (message->background)
+	{
+		if (m_project && checkSharedMemory())
+		{
+			m_project->refreshInBackground(
+				getDialogView(DialogView::UseCase::INDEXING), message->changedFilePaths);
+		}
+		return;
+	}
+
 	refreshProject(
 		message->all ? REFRESH_ALL_FILES : REFRESH_UPDATED_FILES, false);
 }
@@ -346,6 +432,28 @@ void Application::handleMessage(MessageRefreshUI* message)
 	}
 }
 
+void Application::handleMessage(MessageShowMemoryReport* message)
+{
+	const MemoryUsage usage = m_storageCache->getMemoryUsage();
+
+	MessageStatus(L"Memory report:").dispatch();
+	for (const std::pair<std::string, size_t>& entry: usage.entries)
+	{
+		MessageStatus(utility::decodeFromUtf8(
+						  "  " + entry.first + ": " + utility::getByteSizeString(entry.second)))
+			.dispatch();
+	}
+	const std::string total = utility::getByteSizeString(usage.getTotalByteSize());
+	MessageStatus(
+		L"  total: " + utility::decodeFromUtf8(total) + L", peak process memory: " +
+		std::to_wstring(utility::getPeakMemoryUsageKb()) + L" KB")
+		.dispatch();
+
+	LOG_INFO("memory report:\n" + usage.toString());
+
+	MessageShowStatus().dispatch();
+}
+
 void Application::handleMessage(MessageSwitchColorScheme* message)
 {
 	MessageStatus(L"Switch color scheme: " + message->colorSchemePath.wstr()).dispatch();
@@ -410,11 +518,40 @@ void Application::loadWindow(bool showStartWindow)
 	}
 }
 
-void Application::refreshProject(RefreshMode refreshMode, bool shallowIndexingRequested)
+void Application::refreshProject(
+	RefreshMode refreshMode, bool shallowIndexingRequested, const IndexShard& shard)
+{
+	if (m_project && checkSharedMemory())
+	{
+		m_project->refresh(
+			getDialogView(DialogView::UseCase::INDEXING), refreshMode, shallowIndexingRequested, shard);
+
+		if (!m_hasGUI && !m_project->isIndexing())
+		{
+			MessageQuitApplication().dispatch();
+		}
+	}
+}
+
+void Application::mergeIndexShards(const std::vector<FilePath>& shardDbFilePaths)
+{
+	if (m_project && checkSharedMemory())
+	{
+		m_project->mergeIndexShards(
+			shardDbFilePaths, getDialogView(DialogView::UseCase::INDEXING));
+
+		if (!m_hasGUI && !m_project->isIndexing())
+		{
+			MessageQuitApplication().dispatch();
+		}
+	}
+}
+
+void Application::applyIndexDeltas(const std::vector<FilePath>& deltaFilePaths)
 {
 	if (m_project && checkSharedMemory())
 	{
-		m_project->refresh(getDialogView(DialogView::UseCase::INDEXING), refreshMode, shallowIndexingRequested);
+		m_project->applyIndexDeltas(deltaFilePaths, getDialogView(DialogView::UseCase::INDEXING));
 
 		if (!m_hasGUI && !m_project->isIndexing())
 		{
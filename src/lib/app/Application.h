@@ -11,6 +11,7 @@
 #include "MessageLoadProject.h"
 #include "MessageRefresh.h"
 #include "MessageRefreshUI.h"
+#include "MessageShowMemoryReport.h"
 #include "MessageSwitchColorScheme.h"
 #include "MessageWindowFocus.h"
 #include "Project.h"
@@ -31,6 +32,7 @@ class Application
 	, public MessageListener<MessageLoadProject>
 	, public MessageListener<MessageRefresh>
 	, public MessageListener<MessageRefreshUI>
+	, public MessageListener<MessageShowMemoryReport>
 	, public MessageListener<MessageSwitchColorScheme>
 	, public MessageListener<MessageWindowFocus>
 {
@@ -47,6 +49,10 @@ public:
 
 	~Application();
 
+	// opens the server socket for the IDE plugins and detects missing paths of the settings, which
+	// is not needed to show the window and therefore happens once it got painted
+	void startDeferredInitialization();
+
 	std::shared_ptr<const Project> getCurrentProject() const;
 	FilePath getCurrentProjectPath() const;
 	bool isProjectLoaded() const;
@@ -56,6 +62,8 @@ public:
 	int handleDialog(const std::wstring& message);
 	int handleDialog(const std::wstring& message, const std::vector<std::wstring>& options);
 	std::shared_ptr<DialogView> getDialogView(DialogView::UseCase useCase);
+	// used for indexing without a GUI instead of the silent default
+	void setIndexingDialogView(std::shared_ptr<DialogView> dialogView);
 
 	void updateHistoryMenu(std::shared_ptr<MessageBase> message);
 	void updateBookmarks(const std::vector<std::shared_ptr<Bookmark>>& bookmarks);
@@ -72,6 +80,7 @@ private:
 	void handleMessage(MessageLoadProject* message) override;
 	void handleMessage(MessageRefresh* message) override;
 	void handleMessage(MessageRefreshUI* message) override;
+	void handleMessage(MessageShowMemoryReport* message) override;
 	void handleMessage(MessageSwitchColorScheme* message) override;
 	void handleMessage(MessageWindowFocus* message) override;
 
@@ -79,7 +88,12 @@ private:
 
 	void loadWindow(bool showStartWindow);
 
-	void refreshProject(RefreshMode refreshMode, bool shallowIndexingRequested);
+	void refreshProject(
+		RefreshMode refreshMode,
+		bool shallowIndexingRequested,
+		const IndexShard& shard = IndexShard());
+	void mergeIndexShards(const std::vector<FilePath>& shardDbFilePaths);
+	void applyIndexDeltas(const std::vector<FilePath>& deltaFilePaths);
 	void updateRecentProjects(const FilePath& projectSettingsFilePath);
 
 	void logStorageStats() const;
@@ -90,11 +104,13 @@ private:
 
 	const bool m_hasGUI;
 	bool m_loadedWindow = false;
+	bool m_deferredInitializationStarted = false;
 
 	std::shared_ptr<Project> m_project;
 	std::shared_ptr<StorageCache> m_storageCache;
 
 	std::shared_ptr<MainView> m_mainView;
+	std::shared_ptr<DialogView> m_indexingDialogView;
 
 	std::shared_ptr<IDECommunicationController> m_ideCommunicationController;
 	std::shared_ptr<UpdateChecker> m_updateChecker;
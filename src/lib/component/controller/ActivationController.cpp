@@ -1,5 +1,6 @@
 #include "ActivationController.h"
 
+#include "ActivationLatencyTracker.h"
 #include "ApplicationSettings.h"
 #include "StorageAccess.h"
 
@@ -16,7 +17,7 @@
 #include "utility.h"
 
 ActivationController::ActivationController(StorageAccess* storageAccess)
-	: m_storageAccess(storageAccess)
+	: m_storageAccess(storageAccess), m_storageAccessAsync(storageAccess)
 {
 }
 
@@ -48,6 +49,7 @@ void ActivationController::handleMessage(MessageActivateFile* message)
 	if (fileId)
 	{
 		MessageActivateTokens messageActivateTokens(message);
+		ActivationLatencySpan latencySpan(messageActivateTokens.getId(), "ActivationController");
 		messageActivateTokens.tokenIds.push_back(fileId);
 		messageActivateTokens.searchMatches = m_storageAccess->getSearchMatchesForTokenIds({fileId});
 		messageActivateTokens.dispatchImmediately();
@@ -74,14 +76,22 @@ void ActivationController::handleMessage(MessageActivateFile* message)
 void ActivationController::handleMessage(MessageActivateNodes* message)
 {
 	MessageActivateTokens m(message);
+	ActivationLatencySpan latencySpan(m.getId(), "ActivationController");
+
+	// the nodes only known by name are looked up concurrently, the tokens keep the order of the nodes
+	std::vector<std::future<Id>> nodeIdsByName;
 	for (const MessageActivateNodes::ActiveNode& node: message->nodes)
 	{
-		Id nodeId = node.nodeId;
-		if (!nodeId)
+		if (!node.nodeId)
 		{
-			nodeId = m_storageAccess->getNodeIdForNameHierarchy(node.nameHierarchy);
+			nodeIdsByName.push_back(m_storageAccessAsync.getNodeIdForNameHierarchy(node.nameHierarchy));
 		}
+	}
 
+	size_t nameIndex = 0;
+	for (const MessageActivateNodes::ActiveNode& node: message->nodes)
+	{
+		const Id nodeId = node.nodeId ? node.nodeId : nodeIdsByName[nameIndex++].get();
 		if (nodeId > 0)
 		{
 			m.tokenIds.push_back(nodeId);
@@ -94,6 +104,7 @@ void ActivationController::handleMessage(MessageActivateNodes* message)
 void ActivationController::handleMessage(MessageActivateTokenIds* message)
 {
 	MessageActivateTokens m(message);
+	ActivationLatencySpan latencySpan(m.getId(), "ActivationController");
 	m.tokenIds = message->tokenIds;
 	m.searchMatches = m_storageAccess->getSearchMatchesForTokenIds(message->tokenIds);
 	m.dispatchImmediately();
@@ -14,6 +14,7 @@
 #include "MessageResetZoom.h"
 #include "MessageSearch.h"
 #include "MessageZoom.h"
+#include "StorageAccessAsync.h"
 
 class StorageAccess;
 
@@ -44,6 +45,7 @@ private:
 	void handleMessage(MessageZoom* message) override;
 
 	StorageAccess* m_storageAccess;
+	StorageAccessAsync m_storageAccessAsync;
 };
 
 #endif	  // ACTIVATION_CONTROLLER_H
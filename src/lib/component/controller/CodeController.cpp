@@ -1,7 +1,9 @@
 #include "CodeController.h"
 
 #include <memory>
+#include <set>
 
+#include "ActivationLatencyTracker.h"
 #include "Application.h"
 #include "ApplicationSettings.h"
 #include "FileInfo.h"
@@ -12,6 +14,7 @@
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
 #include "StorageAccess.h"
+#include "TaskLambda.h"
 #include "TextAccess.h"
 #include "logging.h"
 #include "tracing.h"
@@ -44,6 +47,7 @@ void CodeController::handleMessage(MessageActivateErrors* message)
 	}
 
 	m_collection = m_storageAccess->getErrorSourceLocations(errors);
+	m_referencePages = ReferencePages();
 
 	m_files = getFilesForCollection(m_collection);
 	std::sort(m_files.begin(), m_files.end(), CodeFileParams::sortById);
@@ -64,13 +68,31 @@ void CodeController::handleMessage(MessageActivateFullTextSearch* message)
 
 	saveOrRestoreViewMode(message);
 
-	m_collection = m_storageAccess->getFullTextSearchLocations(
-		message->searchTerm, message->caseSensitive);
-
 	CodeView::CodeParams params;
 	params.clearSnippets = true;
 	params.useSingleFileCache = false;
 
+	m_referencePages = ReferencePages();
+
+	// show the first page of results right away, the complete results follow when the search is done
+	bool partialResultsShown = false;
+	m_collection = m_storageAccess->getFullTextSearchLocations(
+		message->searchTerm,
+		message->caseSensitive,
+		[&](std::shared_ptr<SourceLocationCollection> partialCollection) {
+			if (partialResultsShown || message->isReplayed())
+			{
+				return;
+			}
+			partialResultsShown = true;
+
+			m_collection = partialCollection;
+			m_files = getFilesForCollection(m_collection);
+			createReferences();
+			expandVisibleFiles(params.useSingleFileCache);
+			showFiles(params, firstReferenceScrollParams(), true);
+		});
+
 	m_files = getFilesForCollection(m_collection);
 	createReferences();
 	expandVisibleFiles(params.useSingleFileCache);
@@ -182,6 +204,9 @@ void CodeController::handleMessage(MessageActivateOverview* message)
 void CodeController::handleMessage(MessageActivateTokens* message)
 {
 	TRACE("code activate");
+	// replays of undo and redo keep the id of the original activation and are not tracked
+	ActivationLatencySpan latencySpan(
+		message->isReplayed() ? 0 : message->getId(), "CodeController");
 
 	saveOrRestoreViewMode(message);
 
@@ -199,6 +224,7 @@ void CodeController::handleMessage(MessageActivateTokens* message)
 	Id declarationId = 0;	 // 0 means that no token is found.
 	if (!message->isAggregation)
 	{
+		ActivationLatencySpan storageSpan("StorageAccess::getActiveTokenIdsForId");
 		std::vector<Id> activeTokenIds;
 		for (Id tokenId: params.activeTokenIds)
 		{
@@ -214,17 +240,53 @@ void CodeController::handleMessage(MessageActivateTokens* message)
 		return;
 	}
 
-	m_collection = m_storageAccess->getSourceLocationsForTokenIds(params.activeTokenIds);
+	bool paged = false;
+	{
+		ActivationLatencySpan storageSpan("StorageAccess::getSourceLocationsPageForTokenIds");
+		paged = createReferencePages(params.activeTokenIds, declarationId);
+	}
+
+	if (!paged)
+	{
+		ActivationLatencySpan storageSpan("StorageAccess::getSourceLocationsForTokenIds");
 
-	m_files = getFilesForActiveSourceLocations(m_collection.get(), declarationId);
-	createReferences();
-	expandVisibleFiles(params.useSingleFileCache);
-	showFiles(params, definitionReferenceScrollParams(params.activeTokenIds), !message->isReplayed());
+		// symbols referenced in many files show their first files before the others are loaded
+		bool partialResultsShown = false;
+		m_collection = m_storageAccess->getSourceLocationsForTokenIds(
+			params.activeTokenIds,
+			[&](std::shared_ptr<SourceLocationCollection> partialCollection) {
+				if (partialResultsShown || message->isReplayed())
+				{
+					return;
+				}
+				partialResultsShown = true;
+
+				m_collection = partialCollection;
+				m_files = getFilesForActiveSourceLocations(m_collection.get(), declarationId);
+				createReferences();
+				expandVisibleFiles(params.useSingleFileCache);
+				showFiles(params, definitionReferenceScrollParams(params.activeTokenIds), true);
+			});
+	}
+
+	{
+		ActivationLatencySpan showSpan("CodeController::showFiles");
+		if (!paged)
+		{
+			m_files = getFilesForActiveSourceLocations(m_collection.get(), declarationId);
+			createReferences();
+		}
+		expandVisibleFiles(params.useSingleFileCache);
+		showFiles(
+			params, definitionReferenceScrollParams(params.activeTokenIds), !message->isReplayed());
+	}
 
 	// send status message
 	{
-		size_t fileCount = m_collection->getSourceLocationFileCount();
-		size_t referenceCount = m_collection->getSourceLocationCount();
+		size_t fileCount = paged ? m_referencePages.fileCount
+								 : m_collection->getSourceLocationFileCount();
+		size_t referenceCount = paged ? m_referencePages.referenceCount
+									  : m_collection->getSourceLocationCount();
 
 		std::wstring status;
 		for (const SearchMatch& match: message->getSearchMatches())
@@ -244,6 +306,7 @@ void CodeController::handleMessage(MessageActivateTokens* message)
 			status += (fileCount == 1 ? L"file" : L"files");
 		}
 
+		ActivationLatencyTracker::getInstance()->setDescription(message->getId(), status);
 		MessageStatus(status).dispatch();
 	}
 }
@@ -268,6 +331,7 @@ void CodeController::handleMessage(MessageActivateTrailEdge* message)
 	m_codeParams.activeTokenIds = message->edgeIds;
 
 	m_collection = m_storageAccess->getSourceLocationsForTokenIds(m_codeParams.activeTokenIds);
+	m_referencePages = ReferencePages();
 
 	m_files = getFilesForActiveSourceLocations(m_collection.get(), 0);
 	createReferences();
@@ -301,6 +365,17 @@ void CodeController::handleMessage(MessageChangeFileView* message)
 	showFiles(m_codeParams, message->scrollParams, !message->isReplayed());
 }
 
+void CodeController::handleMessage(MessageCodeLoadReferencePage* message)
+{
+	TRACE("code load reference page");
+
+	if (hasMoreReferencePages())
+	{
+		addReferencePage();
+		showFiles(m_codeParams, CodeScrollParams(), true);
+	}
+}
+
 void CodeController::handleMessage(MessageCodeReference* message)
 {
 	bool next = (message->type == MessageCodeReference::REFERENCE_NEXT);
@@ -363,7 +438,7 @@ void CodeController::handleMessage(MessageCodeShowDefinition* message)
 		if (!addedLocation)
 		{
 			SourceLocation* location =
-				collection->getSourceLocationFiles().begin()->second->getSourceLocations().begin()->get();
+				collection->getSourceLocationFiles().begin()->second->getSourceLocations().front();
 			filteredCollection->addSourceLocationCopy(location);
 			filteredCollection->addSourceLocationCopy(location->getOtherLocation());
 
@@ -474,6 +549,10 @@ void CodeController::handleMessage(MessageShowReference* message)
 	m_referenceIndex = message->refIndex;
 	bool replayed = message->isReplayed();
 
+	while (m_referenceIndex >= int(m_references.size()) && addReferencePage())
+	{
+	}
+
 	if (m_referenceIndex >= 0 && m_referenceIndex < m_references.size())
 	{
 		const Reference& ref = m_references[m_referenceIndex];
@@ -491,6 +570,11 @@ void CodeController::handleMessage(MessageShowReference* message)
 		{
 			MessageShowError(ref.tokenId).dispatch();
 		}
+
+		if (!replayed)
+		{
+			prefetchNeighborReferences();
+		}
 	}
 }
 
@@ -530,6 +614,7 @@ void CodeController::clear()
 	getView()->clear();
 
 	m_collection = std::make_shared<SourceLocationCollection>();
+	m_referencePages = ReferencePages();
 	m_currentFilePath = FilePath();
 	clearReferences();
 }
@@ -647,8 +732,10 @@ std::vector<CodeSnippetParams> CodeController::getSnippetsForFile(
 	std::shared_ptr<SourceLocationFile> scopeLocations =
 		m_storageAccess->getSourceLocationsOfTypeInFile(
 			activeSourceLocations->getFilePath(), LOCATION_SCOPE);
+	const std::vector<const SourceLocation*> parentScopes = getSourceLocationsOfParentScopes(
+		scopeLocations.get(), lineCount);
 	activeSourceLocations->forEachStartSourceLocation([&](SourceLocation* location) {
-		buildMergerHierarchy(location, scopeLocations.get(), fileScopedMerger, mergers);
+		buildMergerHierarchy(location, parentScopes, fileScopedMerger, mergers);
 	});
 
 	std::vector<SnippetMerger::Range> atomicRanges;
@@ -681,7 +768,7 @@ std::vector<CodeSnippetParams> CodeController::getSnippetsForFile(
 		if (params.startLineNumber > 1)
 		{
 			const SourceLocation* location = getSourceLocationOfParentScope(
-				params.startLineNumber, scopeLocations.get());
+				params.startLineNumber, parentScopes);
 			if (location && location->getTokenIds().size())
 			{
 				params.title = m_storageAccess->getNameHierarchyForNodeId(location->getTokenIds()[0])
@@ -693,7 +780,7 @@ std::vector<CodeSnippetParams> CodeController::getSnippetsForFile(
 		if (params.endLineNumber < lineCount)
 		{
 			const SourceLocation* location = getSourceLocationOfParentScope(
-				params.endLineNumber + 1, scopeLocations.get());
+				params.endLineNumber + 1, parentScopes);
 			if (location && location->getTokenIds().size())
 			{
 				params.footer = m_storageAccess
@@ -726,7 +813,7 @@ std::vector<CodeSnippetParams> CodeController::getSnippetsForFile(
 
 std::shared_ptr<SnippetMerger> CodeController::buildMergerHierarchy(
 	const SourceLocation* location,
-	const SourceLocationFile* scopeLocations,
+	const std::vector<const SourceLocation*>& parentScopes,
 	SnippetMerger& fileScopedMerger,
 	std::map<int, std::shared_ptr<SnippetMerger>>& mergers) const
 {
@@ -734,7 +821,7 @@ std::shared_ptr<SnippetMerger> CodeController::buildMergerHierarchy(
 		location->getStartLocation()->getLineNumber(), location->getEndLocation()->getLineNumber());
 
 	const SourceLocation* scopeLocation = getSourceLocationOfParentScope(
-		location->getLineNumber(), scopeLocations);
+		location->getLineNumber(), parentScopes);
 	if (!scopeLocation)
 	{
 		fileScopedMerger.addChild(currentMerger);
@@ -746,7 +833,7 @@ std::shared_ptr<SnippetMerger> CodeController::buildMergerHierarchy(
 		scopeLocation->getLocationId());
 	if (it == mergers.end())
 	{
-		nextMerger = buildMergerHierarchy(scopeLocation, scopeLocations, fileScopedMerger, mergers);
+		nextMerger = buildMergerHierarchy(scopeLocation, parentScopes, fileScopedMerger, mergers);
 		mergers[scopeLocation->getLocationId()] = nextMerger;
 	}
 	else
@@ -757,21 +844,56 @@ std::shared_ptr<SnippetMerger> CodeController::buildMergerHierarchy(
 	return currentMerger;
 }
 
-const SourceLocation* CodeController::getSourceLocationOfParentScope(
-	size_t lineNumber, const SourceLocationFile* scopeLocations) const
+std::vector<const SourceLocation*> CodeController::getSourceLocationsOfParentScopes(
+	const SourceLocationFile* scopeLocations, size_t lineCount) const
 {
-	const SourceLocation* location = nullptr;
-
-	scopeLocations->forEachStartSourceLocation([&location, lineNumber](SourceLocation* scopeLocation) {
-		if (scopeLocation->getLineNumber() < lineNumber &&
-			scopeLocation->getEndLocation()->getLineNumber() >= lineNumber &&
-			(!location || *location < *scopeLocation))
+	// a scope contains the lines after its start line up to and including its end line
+	std::vector<std::vector<const SourceLocation*>> scopesByStartLine(lineCount + 1);
+	std::vector<std::vector<const SourceLocation*>> scopesByEndLine(lineCount + 1);
+	scopeLocations->forEachStartSourceLocation([&](SourceLocation* scopeLocation) {
+		const size_t startLineNumber = scopeLocation->getLineNumber();
+		const size_t endLineNumber = scopeLocation->getEndLocation()->getLineNumber();
+		if (startLineNumber < endLineNumber)
 		{
-			location = scopeLocation;
+			if (endLineNumber >= scopesByEndLine.size())
+			{
+				scopesByStartLine.resize(endLineNumber + 1);
+				scopesByEndLine.resize(endLineNumber + 1);
+			}
+			scopesByStartLine[startLineNumber].push_back(scopeLocation);
+			scopesByEndLine[endLineNumber].push_back(scopeLocation);
 		}
 	});
 
-	return location;
+	// the innermost of all scopes containing a line is the one starting last
+	auto compare = [](const SourceLocation* a, const SourceLocation* b) { return *a < *b; };
+	std::set<const SourceLocation*, decltype(compare)> openScopes(compare);
+
+	std::vector<const SourceLocation*> parentScopes(scopesByStartLine.size(), nullptr);
+	for (size_t lineNumber = 1; lineNumber < parentScopes.size(); lineNumber++)
+	{
+		for (const SourceLocation* scopeLocation: scopesByStartLine[lineNumber - 1])
+		{
+			openScopes.insert(scopeLocation);
+		}
+		for (const SourceLocation* scopeLocation: scopesByEndLine[lineNumber - 1])
+		{
+			openScopes.erase(scopeLocation);
+		}
+
+		if (openScopes.size())
+		{
+			parentScopes[lineNumber] = *openScopes.rbegin();
+		}
+	}
+
+	return parentScopes;
+}
+
+const SourceLocation* CodeController::getSourceLocationOfParentScope(
+	size_t lineNumber, const std::vector<const SourceLocation*>& parentScopes) const
+{
+	return lineNumber < parentScopes.size() ? parentScopes[lineNumber] : nullptr;
 }
 
 std::vector<std::string> CodeController::getProjectDescription(SourceLocationFile* locationFile) const
@@ -847,6 +969,7 @@ void CodeController::clearReferences()
 {
 	m_references.clear();
 	m_referenceIndex = -1;
+	m_referencesRevision++;
 
 	clearLocalReferences();
 }
@@ -975,6 +1098,12 @@ void CodeController::iterateReference(bool next)
 
 	if (next)
 	{
+		// the next page continues the references instead of starting over
+		if (m_referenceIndex + 1 == int(m_references.size()))
+		{
+			addReferencePage();
+		}
+
 		m_referenceIndex++;
 
 		if (m_referenceIndex == m_references.size())
@@ -986,7 +1115,8 @@ void CodeController::iterateReference(bool next)
 	{
 		if (m_referenceIndex < 1)
 		{
-			m_referenceIndex = m_references.size() - 1;
+			// the last reference is not known before all pages are loaded
+			m_referenceIndex = hasMoreReferencePages() ? 0 : m_references.size() - 1;
 		}
 		else
 		{
@@ -998,6 +1128,128 @@ void CodeController::iterateReference(bool next)
 	MessageShowReference(m_referenceIndex, ref.tokenId, ref.locationId, true).dispatch();
 }
 
+bool CodeController::createReferencePages(const std::vector<Id>& tokenIds, Id declarationId)
+{
+	m_referencePages = ReferencePages();
+
+	size_t referenceCount = 0;
+	const size_t fileCount =
+		m_storageAccess->getSourceLocationFileCountForTokenIds(tokenIds, &referenceCount);
+	if (fileCount <= s_referencePageFileCount)
+	{
+		return false;
+	}
+
+	m_referencePages.tokenIds = tokenIds;
+	m_referencePages.declarationId = declarationId;
+	m_referencePages.fileCount = fileCount;
+	m_referencePages.referenceCount = referenceCount;
+
+	m_collection = std::make_shared<SourceLocationCollection>();
+	m_files.clear();
+	clearReferences();
+	addReferencePage();
+	return true;
+}
+
+bool CodeController::hasMoreReferencePages() const
+{
+	return m_referencePages.loadedFileCount < m_referencePages.fileCount;
+}
+
+bool CodeController::addReferencePage()
+{
+	if (!hasMoreReferencePages())
+	{
+		return false;
+	}
+
+	TRACE();
+
+	std::shared_ptr<SourceLocationCollection> page =
+		m_storageAccess->getSourceLocationsPageForTokenIds(
+			m_referencePages.tokenIds, &m_referencePages.cursor, s_referencePageFileCount);
+
+	// a short page is the last one, even if the files changed since they were counted
+	const size_t pageFileCount = page->getSourceLocationFileCount();
+	m_referencePages.loadedFileCount = pageFileCount < s_referencePageFileCount
+		? m_referencePages.fileCount
+		: std::min(m_referencePages.loadedFileCount + pageFileCount, m_referencePages.fileCount);
+
+	page->forEachSourceLocationFile([this](std::shared_ptr<SourceLocationFile> file) {
+		m_collection->addSourceLocationFile(file);
+	});
+
+	// files of former pages keep their order and their references keep their indices
+	utility::append(
+		m_files, getFilesForActiveSourceLocations(page.get(), m_referencePages.declarationId));
+
+	const int referenceIndex = m_referenceIndex;
+	std::vector<Reference> localReferences;
+	localReferences.swap(m_localReferences);
+	const int localReferenceIndex = m_localReferenceIndex;
+
+	createReferences();
+
+	m_referenceIndex = referenceIndex;
+	m_localReferences.swap(localReferences);
+	m_localReferenceIndex = localReferenceIndex;
+
+	return pageFileCount > 0;
+}
+
+void CodeController::prefetchNeighborReferences()
+{
+	if (m_referenceIndex < 0 || m_references.size() < 2)
+	{
+		return;
+	}
+
+	// files of the next and previous references, nearest first
+	std::vector<FilePath> filePaths;
+	const int referenceCount = int(m_references.size());
+	for (int i = 1; i <= int(s_prefetchedReferenceCount) && i < referenceCount; i++)
+	{
+		for (const int index: {m_referenceIndex + i, m_referenceIndex - i})
+		{
+			const FilePath& filePath =
+				m_references[(index + referenceCount) % referenceCount].filePath;
+			if (std::find(filePaths.begin(), filePaths.end(), filePath) == filePaths.end())
+			{
+				filePaths.push_back(filePath);
+			}
+		}
+	}
+
+	const MessageChangeFileView::FileState state = getView()->isInListMode()
+		? MessageChangeFileView::FILE_SNIPPETS
+		: MessageChangeFileView::FILE_MAXIMIZED;
+	const size_t revision = m_referencesRevision;
+
+	// one file per task, so the next step of the user does not wait for all of them
+	for (const FilePath& filePath: filePaths)
+	{
+		Task::dispatch(
+			getSchedulerId(), std::make_shared<TaskLambda>([this, filePath, state, revision]() {
+				if (revision != m_referencesRevision)
+				{
+					return;
+				}
+
+				for (CodeFileParams& file: m_files)
+				{
+					if (file.locationFile->getFilePath() == filePath)
+					{
+						TRACE("code prefetch reference");
+						prepareFileState(file, state, m_codeParams.useSingleFileCache);
+						addAllSourceLocations(file);
+						return;
+					}
+				}
+			}));
+	}
+}
+
 void CodeController::iterateLocalReference(bool next, bool updateView)
 {
 	if (!m_localReferences.size())
@@ -1164,6 +1416,8 @@ void CodeController::setFileState(
 {
 	TRACE();
 
+	prepareFileState(file, state, useSingleFileCache);
+
 	switch (state)
 	{
 	case MessageChangeFileView::FILE_MINIMIZED:
@@ -1172,27 +1426,9 @@ void CodeController::setFileState(
 
 	case MessageChangeFileView::FILE_SNIPPETS:
 		file.isMinimized = false;
-		if (!file.snippetParams.size())
-		{
-			if (file.locationFile->isWhole())
-			{
-				file.snippetParams = {
-					getSnippetParamsForWholeFile(file.locationFile, useSingleFileCache)};
-			}
-			else
-			{
-				file.snippetParams = getSnippetsForFile(file.locationFile);
-			}
-		}
 		break;
 
 	case MessageChangeFileView::FILE_MAXIMIZED:
-		if (!file.fileParams)
-		{
-			file.fileParams = std::make_shared<CodeSnippetParams>(
-				getSnippetParamsForWholeFile(file.locationFile, useSingleFileCache));
-		}
-
 		if (file.locationFile)
 		{
 			m_currentFilePath = file.locationFile->getFilePath();
@@ -1201,6 +1437,28 @@ void CodeController::setFileState(
 	}
 }
 
+void CodeController::prepareFileState(
+	CodeFileParams& file, MessageChangeFileView::FileState state, bool useSingleFileCache) const
+{
+	if (state == MessageChangeFileView::FILE_SNIPPETS && !file.snippetParams.size())
+	{
+		if (file.locationFile->isWhole())
+		{
+			file.snippetParams = {
+				getSnippetParamsForWholeFile(file.locationFile, useSingleFileCache)};
+		}
+		else
+		{
+			file.snippetParams = getSnippetsForFile(file.locationFile);
+		}
+	}
+	else if (state == MessageChangeFileView::FILE_MAXIMIZED && !file.fileParams)
+	{
+		file.fileParams = std::make_shared<CodeSnippetParams>(
+			getSnippetParamsForWholeFile(file.locationFile, useSingleFileCache));
+	}
+}
+
 bool CodeController::addAllSourceLocations()
 {
 	TRACE();
@@ -1209,57 +1467,61 @@ bool CodeController::addAllSourceLocations()
 
 	for (CodeFileParams& file: m_files)
 	{
-		for (CodeSnippetParams& snippet: file.snippetParams)
-		{
-			if (snippet.hasAllSourceLocations)
-			{
-				continue;
-			}
+		addedNewLocations |= addAllSourceLocations(file);
+	}
 
-			if (snippet.locationFile->isWhole())
-			{
-				snippet.locationFile = m_storageAccess->getSourceLocationsForFile(
-					snippet.locationFile->getFilePath());
-				if (snippet.locationFile)
-				{
-					snippet.locationFile->copySourceLocations(file.locationFile);
-				}
-			}
-			else
-			{
-				std::shared_ptr<SourceLocationFile> file =
-					m_storageAccess->getSourceLocationsForLinesInFile(
-						snippet.locationFile->getFilePath(),
-						snippet.startLineNumber,
-						snippet.endLineNumber);
-				if (file)
-				{
-					file->copySourceLocations(snippet.locationFile);
-					snippet.locationFile = file;
-				}
-			}
+	return addedNewLocations;
+}
 
-			addedNewLocations = true;
-			snippet.hasAllSourceLocations = true;
+bool CodeController::addAllSourceLocations(CodeFileParams& file)
+{
+	bool addedNewLocations = false;
+
+	for (CodeSnippetParams& snippet: file.snippetParams)
+	{
+		if (snippet.hasAllSourceLocations)
+		{
+			continue;
 		}
 
-		if (file.fileParams)
+		if (snippet.locationFile->isWhole())
 		{
-			if (file.fileParams->hasAllSourceLocations)
+			snippet.locationFile = m_storageAccess->getSourceLocationsForFile(
+				snippet.locationFile->getFilePath());
+			if (snippet.locationFile)
 			{
-				continue;
+				snippet.locationFile->copySourceLocations(file.locationFile);
 			}
-
-			file.fileParams->locationFile = m_storageAccess->getSourceLocationsForFile(
-				file.locationFile->getFilePath());
-			if (file.fileParams->locationFile)
+		}
+		else
+		{
+			std::shared_ptr<SourceLocationFile> locationFile =
+				m_storageAccess->getSourceLocationsForLinesInFile(
+					snippet.locationFile->getFilePath(),
+					snippet.startLineNumber,
+					snippet.endLineNumber);
+			if (locationFile)
 			{
-				file.fileParams->locationFile->copySourceLocations(file.locationFile);
+				locationFile->copySourceLocations(snippet.locationFile);
+				snippet.locationFile = locationFile;
 			}
+		}
 
-			addedNewLocations = true;
-			file.fileParams->hasAllSourceLocations = true;
+		addedNewLocations = true;
+		snippet.hasAllSourceLocations = true;
+	}
+
+	if (file.fileParams && !file.fileParams->hasAllSourceLocations)
+	{
+		file.fileParams->locationFile = m_storageAccess->getSourceLocationsForFile(
+			file.locationFile->getFilePath());
+		if (file.fileParams->locationFile)
+		{
+			file.fileParams->locationFile->copySourceLocations(file.locationFile);
 		}
+
+		addedNewLocations = true;
+		file.fileParams->hasAllSourceLocations = true;
 	}
 
 	return addedNewLocations;
@@ -1458,8 +1720,9 @@ void CodeController::showFiles(CodeView::CodeParams params, CodeScrollParams scr
 	{
 		addModificationTimes();
 
-		params.referenceCount = m_references.size();
-		params.referenceIndex = m_referenceIndex >= 0 ? m_referenceIndex : m_references.size();
+		params.referenceCount = std::max(m_references.size(), m_referencePages.referenceCount);
+		params.referenceIndex = m_referenceIndex >= 0 ? m_referenceIndex : params.referenceCount;
+		params.hasMoreReferenceFiles = hasMoreReferencePages();
 
 		params.localReferenceCount = m_localReferences.size();
 		params.localReferenceIndex = m_localReferenceIndex >= 0 ? m_localReferenceIndex
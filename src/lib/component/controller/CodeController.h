@@ -15,6 +15,7 @@
 #include "MessageActivateTrail.h"
 #include "MessageActivateTrailEdge.h"
 #include "MessageChangeFileView.h"
+#include "MessageCodeLoadReferencePage.h"
 #include "MessageCodeReference.h"
 #include "MessageCodeShowDefinition.h"
 #include "MessageDeactivateEdge.h"
@@ -50,6 +51,7 @@ class CodeController
 	, public MessageListener<MessageActivateTrail>
 	, public MessageListener<MessageActivateTrailEdge>
 	, public MessageListener<MessageChangeFileView>
+	, public MessageListener<MessageCodeLoadReferencePage>
 	, public MessageListener<MessageCodeReference>
 	, public MessageListener<MessageCodeShowDefinition>
 	, public MessageListener<MessageDeactivateEdge>
@@ -70,6 +72,11 @@ public:
 	Id getSchedulerId() const override;
 
 private:
+	// references before and after the shown one, whose files are prepared in advance
+	static const size_t s_prefetchedReferenceCount = 3;
+	// symbols referenced in more files load their references in pages of this many files
+	static const size_t s_referencePageFileCount = 50;
+
 	struct Reference
 	{
 		FilePath filePath;
@@ -79,6 +86,17 @@ private:
 		LocationType locationType = LOCATION_TOKEN;
 	};
 
+	// the references of a symbol loaded page by page, in the order of the file paths
+	struct ReferencePages
+	{
+		std::vector<Id> tokenIds;
+		Id declarationId = 0;
+		FilePath cursor;
+		size_t fileCount = 0;
+		size_t loadedFileCount = 0;
+		size_t referenceCount = 0;
+	};
+
 	void handleMessage(MessageActivateErrors* message) override;
 	void handleMessage(MessageActivateFullTextSearch* message) override;
 	void handleMessage(MessageActivateLegend* message) override;
@@ -88,6 +106,7 @@ private:
 	void handleMessage(MessageActivateTrail* message) override;
 	void handleMessage(MessageActivateTrailEdge* message) override;
 	void handleMessage(MessageChangeFileView* message) override;
+	void handleMessage(MessageCodeLoadReferencePage* message) override;
 	void handleMessage(MessageCodeReference* message) override;
 	void handleMessage(MessageCodeShowDefinition* message) override;
 	void handleMessage(MessageDeactivateEdge* message) override;
@@ -116,11 +135,15 @@ private:
 
 	std::shared_ptr<SnippetMerger> buildMergerHierarchy(
 		const SourceLocation* location,
-		const SourceLocationFile* scopeLocations,
+		const std::vector<const SourceLocation*>& parentScopes,
 		SnippetMerger& fileScopedMerger,
 		std::map<int, std::shared_ptr<SnippetMerger>>& mergers) const;
+
+	// innermost scope location containing each line, indexed by line number
+	std::vector<const SourceLocation*> getSourceLocationsOfParentScopes(
+		const SourceLocationFile* scopeLocations, size_t lineCount) const;
 	const SourceLocation* getSourceLocationOfParentScope(
-		size_t lineNumber, const SourceLocationFile* scopeLocations) const;
+		size_t lineNumber, const std::vector<const SourceLocation*>& parentScopes) const;
 
 	std::vector<std::string> getProjectDescription(SourceLocationFile* locationFile) const;
 
@@ -130,7 +153,13 @@ private:
 	void clearLocalReferences();
 	void createLocalReferences(const std::set<Id>& localSymbolIds);
 
+	// starts paging if the tokens are referenced in too many files, returns false otherwise
+	bool createReferencePages(const std::vector<Id>& tokenIds, Id declarationId);
+	bool hasMoreReferencePages() const;
+	bool addReferencePage();
+
 	void iterateReference(bool next);
+	void prefetchNeighborReferences();
 	void iterateLocalReference(bool next, bool updateView);
 
 	void expandVisibleFiles(bool useSingleFileCache);
@@ -139,7 +168,11 @@ private:
 		const FilePath& filePath, MessageChangeFileView::FileState state, bool useSingleFileCache);
 	void setFileState(
 		CodeFileParams& file, MessageChangeFileView::FileState state, bool useSingleFileCache);
+	// creates the snippets the state shows without showing them
+	void prepareFileState(
+		CodeFileParams& file, MessageChangeFileView::FileState state, bool useSingleFileCache) const;
 	bool addAllSourceLocations();
+	bool addAllSourceLocations(CodeFileParams& file);
 	void addModificationTimes();
 
 	CodeScrollParams firstReferenceScrollParams() const;
@@ -165,6 +198,10 @@ private:
 
 	std::vector<Reference> m_references;
 	int m_referenceIndex = -1;
+	// changes whenever the references are recreated, so pending prefetches get dropped
+	size_t m_referencesRevision = 0;
+
+	ReferencePages m_referencePages;
 
 	std::vector<Reference> m_localReferences;
 	int m_localReferenceIndex = -1;
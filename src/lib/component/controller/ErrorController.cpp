@@ -181,24 +181,25 @@ bool ErrorController::showErrors(const ErrorFilter& filter, bool scrollTo)
 {
 	ErrorView* view = getView();
 
-	ErrorFilter filterUnlimited = filter;
-	filterUnlimited.limit = 0;
-
 	std::vector<ErrorInfo> errors;
+	ErrorCountInfo errorCount;
 	if (m_tabActiveFilePath[TabId::currentTab()].empty())
 	{
-		errors = m_storageAccess->getErrorsLimited(filterUnlimited);
+		// only the displayed page is loaded, the storage counts the others
+		errors = m_storageAccess->getErrorsLimited(filter);
+		errorCount = m_storageAccess->getErrorCountForFilter(filter);
 	}
 	else
 	{
+		ErrorFilter filterUnlimited = filter;
+		filterUnlimited.limit = 0;
+		filterUnlimited.offset = 0;
+
 		errors = m_storageAccess->getErrorsForFileLimited(
-			filter, m_tabActiveFilePath[TabId::currentTab()]);
-	}
+			filterUnlimited, m_tabActiveFilePath[TabId::currentTab()]);
+		errorCount = ErrorCountInfo(errors);
 
-	ErrorCountInfo errorCount(errors);
-	if (filter.limit > 0 && errors.size() > filter.limit)
-	{
-		errors.resize(filter.limit);
+		errors = filter.filterErrors(errors);
 	}
 
 	view->addErrors(errors, errorCount, scrollTo);
@@ -1,8 +1,10 @@
 #include "GraphController.h"
 
 #include <set>
+#include <unordered_map>
 
 #include "AccessKind.h"
+#include "ActivationLatencyTracker.h"
 #include "Application.h"
 #include "ApplicationSettings.h"
 #include "BucketLayouter.h"
@@ -13,6 +15,8 @@
 #include "MessageActivateNodes.h"
 #include "MessageStatus.h"
 #include "StorageAccess.h"
+#include "TabId.h"
+#include "TaskLambda.h"
 #include "TokenComponentAccess.h"
 #include "TokenComponentFilePath.h"
 #include "TokenComponentInheritanceChain.h"
@@ -22,11 +26,121 @@
 #include "utility.h"
 #include "utilityString.h"
 
+namespace
+{
+// properties of a top level node that decide which bundles of bundleNodes it belongs to
+enum NodeBundleFlag
+{
+	NODE_BUNDLE_DEFINED = 1 << 0,
+	NODE_BUNDLE_REFERENCED = 1 << 1,
+	NODE_BUNDLE_REFERENCING = 1 << 2,
+	NODE_BUNDLE_LAYOUT_VERTICAL = 1 << 3,
+	NODE_BUNDLE_FILE = 1 << 4,
+	NODE_BUNDLE_BUILTIN = 1 << 5,
+	NODE_BUNDLE_IMPORT_EDGE = 1 << 6,
+	NODE_BUNDLE_SPECIALIZATION_EDGE = 1 << 7,
+	NODE_BUNDLE_INHERITANCE_EDGE = 1 << 8
+};
+
+struct NodeBundleCriterion
+{
+	int requiredFlags;
+	int excludedFlags;
+	size_t minCount;
+	bool countConnectedNodes;
+	const wchar_t* name;
+
+	bool matches(int flags) const
+	{
+		return (flags & requiredFlags) == requiredFlags && !(flags & excludedFlags);
+	}
+};
+
+// applied in this order, a node is bundled by the first matching criterion that forms a bundle
+const NodeBundleCriterion nodeBundleCriteria[] = {
+	{NODE_BUNDLE_FILE | NODE_BUNDLE_IMPORT_EDGE, 0, 1, false, L"Importing Files"},
+	{NODE_BUNDLE_REFERENCING,
+	 NODE_BUNDLE_DEFINED | NODE_BUNDLE_LAYOUT_VERTICAL,
+	 2,
+	 true,
+	 L"Non-indexed Symbols"},
+	{NODE_BUNDLE_REFERENCED,
+	 NODE_BUNDLE_DEFINED | NODE_BUNDLE_LAYOUT_VERTICAL,
+	 2,
+	 true,
+	 L"Non-indexed Symbols"},
+	{NODE_BUNDLE_DEFINED | NODE_BUNDLE_REFERENCED | NODE_BUNDLE_BUILTIN,
+	 0,
+	 3,
+	 false,
+	 L"Built-in Types"},
+	{NODE_BUNDLE_DEFINED | NODE_BUNDLE_REFERENCING,
+	 NODE_BUNDLE_LAYOUT_VERTICAL,
+	 10,
+	 false,
+	 L"Referencing Symbols"},
+	{NODE_BUNDLE_DEFINED | NODE_BUNDLE_REFERENCED,
+	 NODE_BUNDLE_LAYOUT_VERTICAL,
+	 10,
+	 false,
+	 L"Referenced Symbols"},
+	{NODE_BUNDLE_REFERENCING | NODE_BUNDLE_LAYOUT_VERTICAL | NODE_BUNDLE_SPECIALIZATION_EDGE,
+	 0,
+	 5,
+	 false,
+	 L"Specializing Symbols"},
+	{NODE_BUNDLE_REFERENCING | NODE_BUNDLE_LAYOUT_VERTICAL | NODE_BUNDLE_INHERITANCE_EDGE,
+	 0,
+	 5,
+	 false,
+	 L"Derived Symbols"},
+	{NODE_BUNDLE_REFERENCED | NODE_BUNDLE_LAYOUT_VERTICAL | NODE_BUNDLE_INHERITANCE_EDGE,
+	 0,
+	 5,
+	 false,
+	 L"Base Symbols"}};
+
+int getNodeBundleFlags(const DummyNode* node)
+{
+	const DummyNode::BundleInfo& info = node->bundleInfo;
+	int flags = (info.isDefined ? NODE_BUNDLE_DEFINED : 0) |
+		(info.isReferenced ? NODE_BUNDLE_REFERENCED : 0) |
+		(info.isReferencing ? NODE_BUNDLE_REFERENCING : 0) |
+		(info.layoutVertical ? NODE_BUNDLE_LAYOUT_VERTICAL : 0) |
+		(node->data->getType().isFile() ? NODE_BUNDLE_FILE : 0) |
+		(node->data->getType().isBuiltin() ? NODE_BUNDLE_BUILTIN : 0);
+
+	node->data->forEachEdge([&flags](Edge* e) {
+		if (e->isType(Edge::EDGE_IMPORT))
+		{
+			flags |= NODE_BUNDLE_IMPORT_EDGE;
+		}
+		else if (e->isType(Edge::EDGE_TEMPLATE_SPECIALIZATION))
+		{
+			flags |= NODE_BUNDLE_SPECIALIZATION_EDGE;
+		}
+		else if (e->isType(Edge::EDGE_INHERITANCE))
+		{
+			flags |= NODE_BUNDLE_INHERITANCE_EDGE;
+		}
+	});
+	return flags;
+}
+}	 // namespace
+
 GraphController::GraphController(StorageAccess* storageAccess)
-	: m_storageAccess(storageAccess), m_useBezierEdges(false)
+	: m_storageAccess(storageAccess)
+	, m_useBezierEdges(false)
+	, m_graphCache(20)
+	, m_trailStopRequested(false)
 {
 }
 
+void GraphController::stopTrail()
+{
+	m_trailStopRequested = true;
+}
+
 Id GraphController::getSchedulerId() const
 {
 	return Controller::getTabId();
@@ -76,10 +190,22 @@ void GraphController::handleMessage(MessageActivateOverview* message)
 	}
 	else
 	{
-		createDummyGraphAndSetActiveAndVisibility(
-			std::vector<Id>(), m_storageAccess->getGraphForAll(), false);
+		// without the counts all nodes of the overview are loaded to bundle them
+		const std::map<NodeType::Type, size_t> nodeCounts = m_storageAccess->getOverviewNodeCounts();
+		if (nodeCounts.size())
+		{
+			createDummyGraphAndSetActiveAndVisibility(
+				std::vector<Id>(), std::make_shared<Graph>(), false);
+
+			bundleNodeCountsByType(nodeCounts);
+		}
+		else
+		{
+			createDummyGraphAndSetActiveAndVisibility(
+				std::vector<Id>(), m_storageAccess->getGraphForAll(), false);
 
-		bundleNodesByType();
+			bundleNodesByType();
+		}
 
 		layoutNesting();
 		assignBundleIds();
@@ -94,6 +220,9 @@ void GraphController::handleMessage(MessageActivateOverview* message)
 void GraphController::handleMessage(MessageActivateTokens* message)
 {
 	TRACE("graph activate");
+	// replays of undo and redo keep the id of the original activation and are not tracked
+	ActivationLatencySpan latencySpan(
+		message->isReplayed() ? 0 : message->getId(), "GraphController");
 
 	if (message->isEdge || message->keepContent())
 	{
@@ -137,10 +266,28 @@ void GraphController::handleMessage(MessageActivateTokens* message)
 	}
 
 	std::vector<Id> tokenIds = utility::concat(m_activeNodeIds, m_activeEdgeIds);
+	const std::vector<Id> expandedNodeIds = getExpandedNodeIds();
+
+	GraphCache::Key cacheKey;
+	cacheKey.nodeIds = m_activeNodeIds;
+	cacheKey.edgeIds = m_activeEdgeIds;
+	cacheKey.expandedNodeIds = expandedNodeIds;
+	cacheKey.parameters = getGraphCacheParameters(
+		{message->isAggregation, message->isFromSearch});
+
+	GraphView::GraphParams cachedParams;
+	if (getGraphFromCache(cacheKey, &cachedParams))
+	{
+		buildGraph(message, cachedParams);
+		return;
+	}
 
 	bool isNamespace = false;
-	std::shared_ptr<Graph> graph = m_storageAccess->getGraphForActiveTokenIds(
-		tokenIds, getExpandedNodeIds(), &isNamespace);
+	std::shared_ptr<Graph> graph;
+	{
+		ActivationLatencySpan storageSpan("StorageAccess::getGraphForActiveTokenIds");
+		graph = m_storageAccess->getGraphForActiveTokenIds(tokenIds, expandedNodeIds, &isNamespace);
+	}
 
 	createDummyGraphAndSetActiveAndVisibility(tokenIds, graph, !message->isFromSearch);
 
@@ -204,6 +351,7 @@ void GraphController::handleMessage(MessageActivateTokens* message)
 	GraphView::GraphParams params;
 	params.centerActiveNode = !isNamespace;
 	params.scrollToTop = isNamespace;
+	addGraphToCache(cacheKey, params);
 	buildGraph(message, params);
 }
 
@@ -215,6 +363,54 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 
 	m_activeEdgeIds.clear();
 
+	GraphCache::Key cacheKey;
+	cacheKey.nodeIds = {message->originId, message->targetId};
+	cacheKey.nodeTypes = message->nodeTypes;
+	cacheKey.edgeTypes = message->edgeTypes;
+	cacheKey.parameters = getGraphCacheParameters(
+		{message->nodeNonIndexed,
+		 int(message->depth),
+		 message->custom,
+		 message->horizontalLayout});
+
+	GraphView::GraphParams cachedParams;
+	if (getGraphFromCache(cacheKey, &cachedParams))
+	{
+		m_activeNodeIds = {message->originId ? message->originId : message->targetId};
+
+		MessageStatus(L"Displaying graph", false, true).dispatch();
+
+		cachedParams.centerActiveNode = message->isLast();
+		buildGraph(message, cachedParams);
+		return;
+	}
+
+	// custom trails without target show the levels traversed so far, until they are complete or
+	// the user keeps the current result
+	std::function<bool(std::shared_ptr<Graph>)> partialResultsCallback;
+	bool trailStopped = false;
+	if (message->custom && !(message->originId && message->targetId) && !message->isReplayed())
+	{
+		m_trailStopRequested = false;
+		partialResultsCallback = [this, message, &trailStopped](std::shared_ptr<Graph> partial) {
+			if (!m_trailStopRequested && partial->getNodeCount() <= s_maxPartialTrailNodeCount)
+			{
+				layoutTrailGraph(message, partial);
+
+				MessageStatus(L"Displaying partial graph", false, true).dispatch();
+
+				GraphView::GraphParams params;
+				params.animatedTransition = false;
+				params.centerActiveNode = message->isLast();
+				params.isPartialTrail = true;
+				buildGraph(message, params);
+			}
+
+			trailStopped = m_trailStopRequested;
+			return !trailStopped;
+		};
+	}
+
 	std::shared_ptr<Graph> graph = m_storageAccess->getGraphForTrail(
 		message->originId,
 		message->targetId,
@@ -222,7 +418,8 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 		message->edgeTypes,
 		message->nodeNonIndexed,
 		message->depth,
-		true /* !message->custom || (message->originId && message->targetId) */);
+		true /* !message->custom || (message->originId && message->targetId) */,
+		partialResultsCallback);
 
 	// remove non-indexed files from include graph if indexed file is origin
 	if (!message->custom && message->edgeTypes & Edge::EDGE_INCLUDE)
@@ -245,8 +442,11 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 		}
 	}
 
+	bool trailFound = true;
 	if (message->originId && message->targetId && !graph->getNodeById(message->targetId))
 	{
+		trailFound = false;
+
 		MessageStatus(L"No trail graph found.", true).dispatch();
 
 		Application::getInstance()->handleDialog(
@@ -272,6 +472,24 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 		}
 	}
 
+	layoutTrailGraph(message, graph);
+
+	MessageStatus(
+		trailStopped ? L"Displaying graph, stopped the trail" : L"Displaying graph", false, true)
+		.dispatch();
+
+	GraphView::GraphParams params;
+	params.centerActiveNode = message->isLast();
+	// trails are only cached complete, running a stopped one again traverses all levels
+	if (trailFound && !trailStopped)
+	{
+		addGraphToCache(cacheKey, params);
+	}
+	buildGraph(message, params);
+}
+
+void GraphController::layoutTrailGraph(MessageActivateTrail* message, std::shared_ptr<Graph> graph)
+{
 	createDummyGraph(graph);
 	m_graph->setTrailMode(message->horizontalLayout ? Graph::TRAIL_HORIZONTAL : Graph::TRAIL_VERTICAL);
 	m_graph->setHasTrailOrigin(message->originId);
@@ -298,12 +516,6 @@ void GraphController::handleMessage(MessageActivateTrail* message)
 			targetNode->active = true;
 		}
 	}
-
-	MessageStatus(L"Displaying graph", false, true).dispatch();
-
-	GraphView::GraphParams params;
-	params.centerActiveNode = message->isLast();
-	buildGraph(message, params);
 }
 
 void GraphController::handleMessage(MessageActivateTrailEdge* message)
@@ -345,6 +557,29 @@ void GraphController::handleMessage(MessageScrollGraph* message)
 void GraphController::handleMessage(MessageFocusIn* message)
 {
 	getView()->focusTokenIds(message->tokenIds);
+
+	if (message->tokenIds.size() != 1 || !m_graph)
+	{
+		return;
+	}
+
+	// the tooltip of the hovered token shows up after a delay, its neighbours are hovered next
+	std::vector<Id> tokenIds = message->tokenIds;
+	if (Node* node = m_graph->getNodeById(tokenIds.front()))
+	{
+		node->forEachEdge([&tokenIds, node](Edge* edge) {
+			if (tokenIds.size() <= s_maxPrefetchedTooltipCount && !edge->isType(Edge::EDGE_MEMBER))
+			{
+				tokenIds.push_back(
+					edge->getFrom() == node ? edge->getTo()->getId() : edge->getFrom()->getId());
+			}
+		});
+	}
+
+	StorageAccess* storageAccess = m_storageAccess;
+	Task::dispatch(TabId::background(), std::make_shared<TaskLambda>([storageAccess, tokenIds]() {
+		storageAccess->prefetchTooltipInfosForTokenIds(tokenIds, TOOLTIP_ORIGIN_GRAPH);
+	}));
 }
 
 void GraphController::handleMessage(MessageFocusOut* message)
@@ -373,7 +608,11 @@ void GraphController::handleMessage(MessageGraphNodeBundleSplit* message)
 			}
 
 			std::vector<std::shared_ptr<DummyNode>> nodes;
-			if (node->isBundleNode())
+			if (node->isBundleNode() && node->bundledNodes.empty() && node->bundledNodeCount)
+			{
+				nodes = loadOverviewBundle(node->bundledNodeType);
+			}
+			else if (node->isBundleNode())
 			{
 				nodes = std::vector<std::shared_ptr<DummyNode>>(
 					node->bundledNodes.begin(), node->bundledNodes.end());
@@ -512,7 +751,7 @@ void GraphController::handleMessage(MessageGraphNodeExpand* message)
 
 		setActiveAndVisibility(utility::concat(m_activeNodeIds, m_activeEdgeIds));
 
-		layoutNesting();
+		layoutNesting(true);
 		layoutGraph();
 
 		buildGraph(message, GraphView::GraphParams());
@@ -1155,90 +1394,9 @@ void GraphController::bundleNodes()
 		return;
 	}
 
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return data->getType().isFile() && data->findEdgeOfType(Edge::EDGE_IMPORT);
-		},
-		1,
-		false,
-		L"Importing Files");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return !info.isDefined && info.isReferencing && !info.layoutVertical;
-		},
-		2,
-		true,
-		L"Non-indexed Symbols");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return !info.isDefined && info.isReferenced && !info.layoutVertical;
-		},
-		2,
-		true,
-		L"Non-indexed Symbols");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return info.isDefined && info.isReferenced && data->getType().isBuiltin();
-		},
-		3,
-		false,
-		L"Built-in Types");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return info.isDefined && info.isReferencing && !info.layoutVertical;
-		},
-		10,
-		false,
-		L"Referencing Symbols");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return info.isDefined && info.isReferenced && !info.layoutVertical;
-		},
-		10,
-		false,
-		L"Referenced Symbols");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return info.isReferencing && info.layoutVertical &&
-				data->findEdgeOfType(Edge::EDGE_TEMPLATE_SPECIALIZATION);
-		},
-		5,
-		false,
-		L"Specializing Symbols");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return info.isReferencing && info.layoutVertical &&
-				data->findEdgeOfType(Edge::EDGE_INHERITANCE);
-		},
-		5,
-		false,
-		L"Derived Symbols");
-
-	bundleNodesAndEdgesMatching(
-		[](const DummyNode::BundleInfo& info, const Node* data) {
-			return info.isReferenced && info.layoutVertical &&
-				data->findEdgeOfType(Edge::EDGE_INHERITANCE);
-		},
-		5,
-		false,
-		L"Base Symbols");
-}
-
-void GraphController::bundleNodesAndEdgesMatching(
-	std::function<bool(const DummyNode::BundleInfo&, const Node* data)> matcher,
-	size_t count,
-	bool countConnectedNodes,
-	const std::wstring& name)
-{
-	std::vector<size_t> matchedNodeIndices;
-	size_t connectedNodeCount = 0;
+	// every node is put into the buckets of all criteria it matches in one pass
+	const size_t criterionCount = sizeof(nodeBundleCriteria) / sizeof(NodeBundleCriterion);
+	std::vector<std::vector<size_t>> buckets(criterionCount);
 	for (size_t i = 0; i < m_dummyNodes.size(); i++)
 	{
 		const DummyNode* node = m_dummyNodes[i].get();
@@ -1247,42 +1405,107 @@ void GraphController::bundleNodesAndEdgesMatching(
 			continue;
 		}
 
-		if (matcher(node->bundleInfo, node->data))
+		const int flags = getNodeBundleFlags(node);
+		for (size_t j = 0; j < criterionCount; j++)
 		{
-			matchedNodeIndices.push_back(i);
+			if (nodeBundleCriteria[j].matches(flags))
+			{
+				buckets[j].push_back(i);
+			}
+		}
+	}
+
+	// the edges are looked up by the ids of their nodes while bundling
+	std::unordered_map<Id, std::vector<size_t>> nodeEdgeIndices;
+	for (size_t i = 0; i < m_dummyEdges.size(); i++)
+	{
+		const DummyEdge* edge = m_dummyEdges[i].get();
+		nodeEdgeIndices[edge->ownerId].push_back(i);
+		if (edge->targetId != edge->ownerId)
+		{
+			nodeEdgeIndices[edge->targetId].push_back(i);
+		}
+	}
 
-			if (countConnectedNodes)
+	std::vector<bool> bundled(m_dummyNodes.size(), false);
+	std::vector<std::shared_ptr<DummyNode>> bundleNodes;
+	size_t nodeCount = m_dummyNodes.size();
+	for (size_t j = 0; j < criterionCount; j++)
+	{
+		const NodeBundleCriterion& criterion = nodeBundleCriteria[j];
+
+		std::vector<size_t> matchedNodeIndices;
+		size_t connectedNodeCount = 0;
+		for (size_t i: buckets[j])
+		{
+			if (!bundled[i])
 			{
-				connectedNodeCount += node->getConnectedSubNodes().size();
+				matchedNodeIndices.push_back(i);
+
+				if (criterion.countConnectedNodes)
+				{
+					connectedNodeCount += m_dummyNodes[i]->getConnectedSubNodes().size();
+				}
 			}
 		}
+
+		const size_t matchedNodeCount =
+			criterion.countConnectedNodes ? connectedNodeCount : matchedNodeIndices.size();
+		if (!matchedNodeIndices.size() || matchedNodeCount < criterion.minCount ||
+			matchedNodeIndices.size() == nodeCount)
+		{
+			continue;
+		}
+
+		std::shared_ptr<DummyNode> bundleNode = bundleNodesAndEdges(
+			matchedNodeIndices, criterion.name, &nodeEdgeIndices);
+		if (criterion.countConnectedNodes)
+		{
+			bundleNode->bundledNodeCount = connectedNodeCount;
+		}
+		bundleNodes.push_back(bundleNode);
+
+		for (size_t i: matchedNodeIndices)
+		{
+			bundled[i] = true;
+		}
+		nodeCount = nodeCount - matchedNodeIndices.size() + 1;
 	}
 
-	size_t matchedNodeCount = countConnectedNodes ? connectedNodeCount : matchedNodeIndices.size();
-	if (!matchedNodeIndices.size() || matchedNodeCount < count ||
-		matchedNodeIndices.size() == m_dummyNodes.size())
+	if (bundleNodes.empty())
 	{
 		return;
 	}
 
+	std::vector<std::shared_ptr<DummyNode>> nodes;
+	nodes.reserve(nodeCount);
+	for (size_t i = 0; i < m_dummyNodes.size(); i++)
+	{
+		if (!bundled[i])
+		{
+			nodes.push_back(m_dummyNodes[i]);
+		}
+	}
+	nodes.insert(nodes.end(), bundleNodes.begin(), bundleNodes.end());
+	m_dummyNodes = std::move(nodes);
+}
+
+std::shared_ptr<DummyNode> GraphController::bundleNodesAndEdges(
+	const std::vector<size_t>& nodeIndices,
+	const std::wstring& name,
+	std::unordered_map<Id, std::vector<size_t>>* nodeEdgeIndices)
+{
 	std::shared_ptr<DummyNode> bundleNode = std::make_shared<DummyNode>(DummyNode::DUMMY_BUNDLE);
 	bundleNode->name = name;
 	bundleNode->visible = true;
 
-	for (int i = matchedNodeIndices.size() - 1; i >= 0; i--)
+	for (int i = nodeIndices.size() - 1; i >= 0; i--)
 	{
-		std::shared_ptr<DummyNode> node = m_dummyNodes[matchedNodeIndices[i]];
+		std::shared_ptr<DummyNode> node = m_dummyNodes[nodeIndices[i]];
 		node->visible = false;
 
 		bundleNode->bundledNodes.insert(node);
 		bundleNode->bundledNodeCount += node->getBundledNodeCount();
-
-		m_dummyNodes.erase(m_dummyNodes.begin() + matchedNodeIndices[i]);
-	}
-
-	if (countConnectedNodes)
-	{
-		bundleNode->bundledNodeCount = connectedNodeCount;
 	}
 
 	DummyNode* firstNode = bundleNode->bundledNodes.begin()->get();
@@ -1292,46 +1515,39 @@ void GraphController::bundleNodesAndEdgesMatching(
 	bundleNode->bundleInfo.layoutVertical = firstNode->bundleInfo.layoutVertical;
 	bundleNode->bundleInfo.isReferenced = firstNode->bundleInfo.isReferenced;
 	bundleNode->bundleInfo.isReferencing = firstNode->bundleInfo.isReferencing;
-	m_dummyNodes.push_back(bundleNode);
 
 	if (m_dummyEdges.size() == 0)
 	{
-		return;
+		return bundleNode;
 	}
 
+	// the edges to each node outside of the bundle are merged into one edge
 	std::vector<std::shared_ptr<DummyEdge>> bundleEdges;
-	std::vector<const DummyNode*> bundledNodes = bundleNode->getAllBundledNodes();
-	for (const DummyNode* node: bundledNodes)
+	std::unordered_map<Id, DummyEdge*> bundleEdgesByOwnerId;
+	for (const DummyNode* node: bundleNode->getAllBundledNodes())
 	{
-		for (const std::shared_ptr<DummyEdge>& edge: m_dummyEdges)
+		const Id nodeId = node->data->getId();
+		auto it = nodeEdgeIndices->find(nodeId);
+		if (it == nodeEdgeIndices->end())
 		{
-			bool owner = (edge->ownerId == node->data->getId());
-			bool target = (edge->targetId == node->data->getId());
-
-			if (!owner && !target)
-			{
-				continue;
-			}
+			continue;
+		}
 
-			DummyEdge* bundleEdgePtr = nullptr;
-			for (const std::shared_ptr<DummyEdge>& bundleEdge: bundleEdges)
-			{
-				if ((owner && bundleEdge->ownerId == edge->targetId) ||
-					(target && bundleEdge->ownerId == edge->ownerId))
-				{
-					bundleEdgePtr = bundleEdge.get();
-					break;
-				}
-			}
+		for (size_t edgeIndex: it->second)
+		{
+			DummyEdge* edge = m_dummyEdges[edgeIndex].get();
+			const bool owner = (edge->ownerId == nodeId);
 
+			const Id ownerId = (owner ? edge->targetId : edge->ownerId);
+			DummyEdge*& bundleEdgePtr = bundleEdgesByOwnerId[ownerId];
 			if (!bundleEdgePtr)
 			{
 				std::shared_ptr<DummyEdge> bundleEdge = std::make_shared<DummyEdge>();
 				bundleEdge->visible = true;
-				bundleEdge->ownerId = (owner ? edge->targetId : edge->ownerId);
+				bundleEdge->ownerId = ownerId;
 				bundleEdge->targetId = bundleNode->tokenId;
 				bundleEdges.push_back(bundleEdge);
-				bundleEdgePtr = bundleEdges.back().get();
+				bundleEdgePtr = bundleEdge.get();
 			}
 
 			bundleEdgePtr->weight += edge->getWeight();
@@ -1340,7 +1556,14 @@ void GraphController::bundleNodesAndEdgesMatching(
 		}
 	}
 
-	m_dummyEdges.insert(m_dummyEdges.end(), bundleEdges.begin(), bundleEdges.end());
+	for (const std::shared_ptr<DummyEdge>& bundleEdge: bundleEdges)
+	{
+		(*nodeEdgeIndices)[bundleEdge->ownerId].push_back(m_dummyEdges.size());
+		(*nodeEdgeIndices)[bundleEdge->targetId].push_back(m_dummyEdges.size());
+		m_dummyEdges.push_back(bundleEdge);
+	}
+
+	return bundleNode;
 }
 
 std::shared_ptr<DummyNode> GraphController::bundleNodesMatching(
@@ -1469,6 +1692,75 @@ void GraphController::bundleNodesByType()
 	}
 }
 
+void GraphController::bundleNodeCountsByType(const std::map<NodeType::Type, size_t>& nodeCounts)
+{
+	TRACE();
+
+	bool hasNonFileBundle = false;
+
+	for (const NodeType& nodeType: NodeType::getOverviewBundleNodeTypesOrdered())
+	{
+		Tree<NodeType::BundleInfo> bundleInfoTree = nodeType.getOverviewBundleTree();
+		auto it = nodeCounts.find(nodeType.getType());
+		if (it != nodeCounts.end() && bundleInfoTree.data.isValid())
+		{
+			m_dummyNodes.push_back(
+				createOverviewBundle(nodeType, bundleInfoTree.data.bundleName, it->second));
+
+			if (nodeType.getType() != NodeType::NODE_FILE)
+			{
+				hasNonFileBundle = true;
+			}
+		}
+	}
+
+	auto it = nodeCounts.find(NodeType::NODE_SYMBOL);
+	if (it != nodeCounts.end() && !hasNonFileBundle)
+	{
+		m_dummyNodes.push_back(createOverviewBundle(NodeType::NODE_SYMBOL, L"Symbols", it->second));
+	}
+}
+
+std::shared_ptr<DummyNode> GraphController::createOverviewBundle(
+	const NodeType& type, const std::wstring& name, size_t nodeCount) const
+{
+	std::shared_ptr<DummyNode> bundleNode = std::make_shared<DummyNode>(DummyNode::DUMMY_BUNDLE);
+	bundleNode->name = name;
+	bundleNode->visible = true;
+	bundleNode->bundledNodeType = type;
+	bundleNode->bundledNodeCount = nodeCount;
+
+	// Use the type as there is no first node yet and make first bit 1
+	bundleNode->tokenId = ~(~Id(0) >> 1) + NodeType::typeToInt(type.getType());
+	return bundleNode;
+}
+
+std::vector<std::shared_ptr<DummyNode>> GraphController::loadOverviewBundle(const NodeType& type)
+{
+	TRACE();
+
+	// the bundles of the overview do not refer to the graph, so they stay valid
+	std::vector<std::shared_ptr<DummyNode>> bundleNodes = m_dummyNodes;
+	createDummyGraph(m_storageAccess->getGraphForOverviewNodeType(type));
+	std::list<std::shared_ptr<DummyNode>> loadedNodes(m_dummyNodes.begin(), m_dummyNodes.end());
+	m_dummyNodes = bundleNodes;
+
+	// sorted like the nodes of a split bundle
+	DummyNode::BundledNodesSet nodes;
+	for (const Tree<NodeType::BundleInfo>& childBundleInfoTree: type.getOverviewBundleTree().children)
+	{
+		std::shared_ptr<DummyNode> childBundle = bundleByType(
+			loadedNodes, type, childBundleInfoTree, true);
+		if (childBundle)
+		{
+			nodes.insert(childBundle);
+		}
+	}
+	nodes.insert(loadedNodes.begin(), loadedNodes.end());
+
+	return std::vector<std::shared_ptr<DummyNode>>(nodes.begin(), nodes.end());
+}
+
 void GraphController::addCharacterIndex()
 {
 	// Remove index characters from last time
@@ -1844,7 +2136,7 @@ void GraphController::groupTrailNodes(GroupType groupType)
 	}
 }
 
-void GraphController::layoutNesting()
+void GraphController::layoutNesting(bool onlyChangedNodes)
 {
 	TRACE();
 
@@ -1852,12 +2144,18 @@ void GraphController::layoutNesting()
 
 	for (const std::shared_ptr<DummyNode>& node: m_dummyNodes)
 	{
-		layoutNestingRecursive(node.get());
-	}
+		// the nesting of a node only depends on its own subtree, except for group nodes which
+		// layout their content along the edges
+		if (onlyChangedNodes && !node->isGroupNode() && node->nestingSignature &&
+			node->nestingSignature == node->getNestingSignature())
+		{
+			continue;
+		}
 
-	for (const std::shared_ptr<DummyNode>& node: m_dummyNodes)
-	{
+		layoutNestingRecursive(node.get());
 		layoutToGrid(node.get());
+
+		node->nestingSignature = node->getNestingSignature();
 	}
 }
 
@@ -2316,7 +2614,7 @@ void GraphController::relayoutGraph(
 			group->name = groupName;
 		}
 
-		layoutNesting();
+		layoutNesting(true);
 		layoutList();
 	}
 	else
@@ -2326,7 +2624,7 @@ void GraphController::relayoutGraph(
 			groupNodesByParents(getView()->getGrouping());
 		}
 
-		layoutNesting();
+		layoutNesting(true);
 
 		if (showsTrail)
 		{
@@ -2354,6 +2652,57 @@ void GraphController::buildGraph(MessageBase* message, GraphView::GraphParams pa
 	}
 }
 
+std::vector<int> GraphController::getGraphCacheParameters(std::vector<int> parameters) const
+{
+	// layouts depend on the view and the settings as well
+	const Vec2i viewSize = getView()->getViewSize();
+	parameters.push_back(int(getView()->getGrouping()));
+	parameters.push_back(viewSize.x);
+	parameters.push_back(viewSize.y);
+	parameters.push_back(ApplicationSettings::getInstance()->getShowBuiltinTypesInGraph());
+	return parameters;
+}
+
+bool GraphController::getGraphFromCache(const GraphCache::Key& key, GraphView::GraphParams* params)
+{
+	GraphCache::Entry entry;
+	if (!m_graphCache.getEntry(key, m_storageAccess->getContentVersion(), &entry))
+	{
+		return false;
+	}
+
+	m_graph = entry.graph;
+	m_dummyNodes = entry.dummyNodes;
+	m_dummyEdges = entry.dummyEdges;
+	m_dummyGraphNodes = entry.dummyGraphNodes;
+	m_topLevelAncestorIds = entry.topLevelAncestorIds;
+	m_useBezierEdges = entry.useBezierEdges;
+	m_showsLegend = false;
+
+	*params = entry.params;
+	return true;
+}
+
+void GraphController::addGraphToCache(
+	const GraphCache::Key& key, const GraphView::GraphParams& params)
+{
+	if (!m_graph)
+	{
+		return;
+	}
+
+	GraphCache::Entry entry;
+	entry.graph = m_graph;
+	entry.dummyNodes = m_dummyNodes;
+	entry.dummyEdges = m_dummyEdges;
+	entry.dummyGraphNodes = m_dummyGraphNodes;
+	entry.topLevelAncestorIds = m_topLevelAncestorIds;
+	entry.useBezierEdges = m_useBezierEdges;
+	entry.params = params;
+
+	m_graphCache.addEntry(key, m_storageAccess->getContentVersion(), entry);
+}
+
 void GraphController::forEachDummyNodeRecursive(std::function<void(DummyNode*)> func)
 {
 	for (const std::shared_ptr<DummyNode>& node: m_dummyNodes)
@@ -1,7 +1,10 @@
 #ifndef GRAPH_CONTROLLER_H
 #define GRAPH_CONTROLLER_H
 
+#include <atomic>
 #include <list>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "MessageActivateErrors.h"
@@ -26,6 +29,7 @@
 #include "Controller.h"
 #include "DummyEdge.h"
 #include "DummyNode.h"
+#include "GraphCache.h"
 #include "GraphView.h"
 #include "Node.h"
 
@@ -58,7 +62,14 @@ public:
 
 	Id getSchedulerId() const override;
 
+	// keeps the levels of the custom trail traversed so far, called by the view while it shows them
+	void stopTrail();
+
 private:
+	static const size_t s_maxPrefetchedTooltipCount = 8;
+	// larger partial trails are not shown, the complete one asks before it gets layouted
+	static const size_t s_maxPartialTrailNodeCount = 1000;
+
 	void handleMessage(MessageActivateErrors* message) override;
 	void handleMessage(MessageActivateFullTextSearch* message) override;
 	void handleMessage(MessageActivateLegend* message) override;
@@ -104,11 +115,12 @@ private:
 	void hideBuiltinTypes();
 
 	void bundleNodes();
-	void bundleNodesAndEdgesMatching(
-		std::function<bool(const DummyNode::BundleInfo&, const Node*)> matcher,
-		size_t count,
-		bool countConnectedNodes,
-		const std::wstring& name);
+	// bundles the nodes at the indices and merges their edges, the new edges are added to the
+	// edge indices of their nodes
+	std::shared_ptr<DummyNode> bundleNodesAndEdges(
+		const std::vector<size_t>& nodeIndices,
+		const std::wstring& name,
+		std::unordered_map<Id, std::vector<size_t>>* nodeEdgeIndices);
 	std::shared_ptr<DummyNode> bundleNodesMatching(
 		std::list<std::shared_ptr<DummyNode>>& nodes,
 		std::function<bool(const DummyNode*)> matcher,
@@ -119,6 +131,11 @@ private:
 		const Tree<NodeType::BundleInfo>& bundleInfoTree,
 		const bool considerInvisibleNodes);
 	void bundleNodesByType();
+	// bundles for the counted nodes of the overview, which are loaded once their bundle is split
+	void bundleNodeCountsByType(const std::map<NodeType::Type, size_t>& nodeCounts);
+	std::shared_ptr<DummyNode> createOverviewBundle(
+		const NodeType& type, const std::wstring& name, size_t nodeCount) const;
+	std::vector<std::shared_ptr<DummyNode>> loadOverviewBundle(const NodeType& type);
 
 	void addCharacterIndex();
 	bool hasCharacterIndex() const;
@@ -127,7 +144,7 @@ private:
 	DummyNode* groupAllNodes(GroupType groupType, Id groupNodeId);
 	void groupTrailNodes(GroupType groupType);
 
-	void layoutNesting();
+	void layoutNesting(bool onlyChangedNodes = false);
 	void extendEqualFunctionNames(const std::vector<std::shared_ptr<DummyNode>>& nodes) const;
 	Vec4i layoutNestingRecursive(DummyNode* node, int relayoutAccessMaxWidth = -1) const;
 	void addExpandToggleNode(DummyNode* node) const;
@@ -136,6 +153,7 @@ private:
 	void layoutGraph(bool getSortedNodes = false);
 	void layoutList();
 	void layoutTrail(bool horizontal, bool hasOrigin);
+	void layoutTrailGraph(MessageActivateTrail* message, std::shared_ptr<Graph> graph);
 
 	void assignBundleIds();
 
@@ -149,6 +167,10 @@ private:
 		const std::wstring& groupName);
 	void buildGraph(MessageBase* message, GraphView::GraphParams params);
 
+	std::vector<int> getGraphCacheParameters(std::vector<int> parameters) const;
+	bool getGraphFromCache(const GraphCache::Key& key, GraphView::GraphParams* params);
+	void addGraphToCache(const GraphCache::Key& key, const GraphView::GraphParams& params);
+
 	void forEachDummyNodeRecursive(std::function<void(DummyNode*)> func);
 	void forEachDummyEdge(std::function<void(DummyEdge*)> func);
 
@@ -170,6 +192,10 @@ private:
 
 	bool m_useBezierEdges = false;
 	bool m_showsLegend = false;
+
+	GraphCache m_graphCache;
+
+	std::atomic<bool> m_trailStopRequested;
 };
 
 #endif	  // GRAPH_CONTROLLER_H
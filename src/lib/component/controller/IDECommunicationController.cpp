@@ -1,15 +1,19 @@
 #include "IDECommunicationController.h"
 
+#include "ApplicationSettings.h"
 #include "FileSystem.h"
 #include "MessageActivateWindow.h"
 #include "MessagePingReceived.h"
 #include "MessageProjectNew.h"
+#include "MessageRefresh.h"
 #include "MessageStatus.h"
 #include "MessageTabOpenWith.h"
 #include "logging.h"
+#include "utilityString.h"
 
 #include "SourceLocationFile.h"
 #include "StorageAccess.h"
+#include "StorageQueryService.h"
 
 IDECommunicationController::IDECommunicationController(StorageAccess* storageAccess)
 	: m_storageAccess(storageAccess), m_enabled(true)
@@ -35,7 +39,17 @@ void IDECommunicationController::handleIncomingMessage(const std::wstring& messa
 	}
 	else if (type == NetworkProtocolHelper::MESSAGE_TYPE::SET_ACTIVE_TOKEN)
 	{
-		handleSetActiveTokenMessage(NetworkProtocolHelper::parseSetActiveTokenMessage(message));
+		NetworkProtocolHelper::SetActiveTokenMessage tokenMessage =
+			NetworkProtocolHelper::parseSetActiveTokenMessage(message);
+		if (tokenMessage.valid)
+		{
+			const bool scheduled = m_pendingTokenMessage.valid;
+			m_pendingTokenMessage = tokenMessage;
+			if (!scheduled)
+			{
+				scheduleTokenActivation();
+			}
+		}
 	}
 	else if (type == NetworkProtocolHelper::MESSAGE_TYPE::CREATE_CDB_MESSAGE)
 	{
@@ -45,6 +59,14 @@ void IDECommunicationController::handleIncomingMessage(const std::wstring& messa
 	{
 		handlePing(NetworkProtocolHelper::parsePingMessage(message));
 	}
+	else if (type == NetworkProtocolHelper::MESSAGE_TYPE::FILE_SAVED)
+	{
+		handleFileSavedMessage(NetworkProtocolHelper::parseFileSavedMessage(message));
+	}
+	else if (type == NetworkProtocolHelper::MESSAGE_TYPE::QUERY_SYMBOLS)
+	{
+		handleQuerySymbolsMessage(NetworkProtocolHelper::parseQuerySymbolsMessage(message));
+	}
 	else
 	{
 		handleCreateProjectMessage(NetworkProtocolHelper::parseCreateProjectMessage(message));
@@ -70,6 +92,38 @@ void IDECommunicationController::sendUpdatePing()
 	sendMessage(NetworkProtocolHelper::buildPingMessage());
 }
 
+void IDECommunicationController::activatePendingToken()
+{
+	NetworkProtocolHelper::SetActiveTokenMessage message = m_pendingTokenMessage;
+	m_pendingTokenMessage = NetworkProtocolHelper::SetActiveTokenMessage();
+
+	if (message.valid && m_enabled)
+	{
+		handleSetActiveTokenMessage(message);
+	}
+}
+
+void IDECommunicationController::indexSavedFiles()
+{
+	std::set<FilePath> filePaths;
+	filePaths.swap(m_savedFilePaths);
+
+	if (!filePaths.empty() && m_enabled)
+	{
+		MessageRefresh().refreshChangedFiles(filePaths).dispatch();
+	}
+}
+
+void IDECommunicationController::scheduleTokenActivation()
+{
+	activatePendingToken();
+}
+
+void IDECommunicationController::scheduleSavedFileIndexing()
+{
+	indexSavedFiles();
+}
+
 void IDECommunicationController::handleSetActiveTokenMessage(
 	const NetworkProtocolHelper::SetActiveTokenMessage& message)
 {
@@ -173,6 +227,35 @@ void IDECommunicationController::handlePing(const NetworkProtocolHelper::PingMes
 	}
 }
 
+void IDECommunicationController::handleFileSavedMessage(
+	const NetworkProtocolHelper::FileSavedMessage& message)
+{
+	if (!message.valid || !ApplicationSettings::getInstance()->getIdeSavedFileIndexingEnabled())
+	{
+		return;
+	}
+
+	// files outside of the project are found to be unchanged by the refresh
+	m_savedFilePaths.insert(message.filePath);
+	scheduleSavedFileIndexing();
+}
+
+void IDECommunicationController::handleQuerySymbolsMessage(
+	const NetworkProtocolHelper::QuerySymbolsMessage& message)
+{
+	if (!message.valid)
+	{
+		LOG_ERROR("Can't query symbols, message is invalid");
+		return;
+	}
+
+	// answered right away without touching the views, scripts use the plugin port headless
+	const StorageQueryService::Response response = StorageQueryService(m_storageAccess).answer(
+		"symbols", {{"names", utility::encodeToUtf8(utility::join(message.names, L"\n"))}});
+
+	sendMessage(NetworkProtocolHelper::buildSymbolsMessage(utility::decodeFromUtf8(response.body)));
+}
+
 void IDECommunicationController::handleMessage(MessageWindowFocus* message)
 {
 	if (message->focusIn)
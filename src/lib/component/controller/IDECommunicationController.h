@@ -1,6 +1,7 @@
 #ifndef IDE_COMMUNICATION_CONTROLLER_H
 #define IDE_COMMUNICATION_CONTROLLER_H
 
+#include <set>
 #include <string>
 
 #include "Controller.h"
@@ -39,11 +40,26 @@ public:
 protected:
 	void sendUpdatePing();
 
+	// handles the latest set active token message received since the last activation
+	void activatePendingToken();
+
+	// refreshes the files saved in the plugin since the last refresh
+	void indexSavedFiles();
+
 private:
+	// activates right away, implementations may wait for further cursor moves of the plugin and
+	// only activate the last position
+	virtual void scheduleTokenActivation();
+
+	// indexes right away, implementations may wait for further saves and index them together
+	virtual void scheduleSavedFileIndexing();
+
 	void handleSetActiveTokenMessage(const NetworkProtocolHelper::SetActiveTokenMessage& message);
 	void handleCreateProjectMessage(const NetworkProtocolHelper::CreateProjectMessage& message);
 	void handleCreateCDBProjectMessage(const NetworkProtocolHelper::CreateCDBProjectMessage& message);
 	void handlePing(const NetworkProtocolHelper::PingMessage& message);
+	void handleFileSavedMessage(const NetworkProtocolHelper::FileSavedMessage& message);
+	void handleQuerySymbolsMessage(const NetworkProtocolHelper::QuerySymbolsMessage& message);
 
 	virtual void handleMessage(MessageWindowFocus* message);
 	virtual void handleMessage(MessageIDECreateCDB* message);
@@ -54,6 +70,8 @@ private:
 	StorageAccess* m_storageAccess;
 
 	bool m_enabled;
+	NetworkProtocolHelper::SetActiveTokenMessage m_pendingTokenMessage;
+	std::set<FilePath> m_savedFilePaths;
 };
 
 #endif	  // IDE_COMMUNICATION_CONTROLLER_H
@@ -28,11 +28,34 @@ void ScreenSearchController::foundMatches(ScreenSearchResponder* responder, size
 			i++;
 		}
 
+		const bool hadActiveMatch = m_matchIndex < m_matches.size();
 		m_matches.insert(m_matches.begin() + i, newMatches.begin(), newMatches.end());
-		m_matchIndex = m_matches.size();
+
+		// the first match found gets activated right away, while other responders still search
+		if (!hadActiveMatch)
+		{
+			m_matchIndex = i;
+			responder->activateMatch(0);
+		}
+		else if (i <= m_matchIndex)
+		{
+			m_matchIndex += matchCount;
+		}
 	}
 
-	getView<ScreenSearchView>()->setMatchCount(m_matches.size());
+	size_t totalMatchCount = 0;
+	size_t matchIndex = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_matchMutex);
+		totalMatchCount = m_matches.size();
+		matchIndex = m_matchIndex;
+	}
+
+	getView<ScreenSearchView>()->setMatchCount(totalMatchCount);
+	if (matchIndex < totalMatchCount)
+	{
+		getView<ScreenSearchView>()->setMatchIndex(matchIndex + 1);
+	}
 }
 
 void ScreenSearchController::addResponder(ScreenSearchResponder* responder)
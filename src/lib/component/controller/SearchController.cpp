@@ -1,5 +1,7 @@
 #include "SearchController.h"
 
+#include <algorithm>
+
 #include "MessageTabState.h"
 #include "SearchView.h"
 #include "StorageAccess.h"
@@ -59,9 +61,38 @@ void SearchController::handleMessage(MessageSearchAutocomplete* message)
 		return;
 	}
 
+	const size_t requestId = message->requestId;
+	const std::function<bool()> isCancelled = [requestId]() {
+		return requestId != MessageSearchAutocomplete::getLatestRequestId();
+	};
+
 	LOG_INFO(L"autocomplete string: \"" + message->query + L"\"");
-	view->setAutocompletionList(m_storageAccess->getAutocompletionMatches(
-		message->query, message->acceptedNodeTypes, true));
+	const std::vector<SearchMatch> matches = m_storageAccess->getAutocompletionMatches(
+		message->query, message->acceptedNodeTypes, true, isCancelled);
+
+	// only the result of the newest request reaches the view
+	if (isCancelled())
+	{
+		LOG_INFO(L"autocomplete string: \"" + message->query + L"\" was superseded");
+		return;
+	}
+
+	// the first matches open the list right away, the rest is appended in batches that are
+	// dropped once a newer request arrives
+	const size_t firstBatchSize = 100;
+	const size_t batchSize = 500;
+
+	size_t endIdx = std::min(firstBatchSize, matches.size());
+	view->setAutocompletionList(
+		std::vector<SearchMatch>(matches.begin(), matches.begin() + endIdx));
+
+	while (endIdx < matches.size() && !isCancelled())
+	{
+		const size_t startIdx = endIdx;
+		endIdx = std::min(startIdx + batchSize, matches.size());
+		view->appendAutocompletionList(
+			std::vector<SearchMatch>(matches.begin() + startIdx, matches.begin() + endIdx));
+	}
 }
 
 SearchView* SearchController::getView()
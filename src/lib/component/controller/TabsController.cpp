@@ -1,6 +1,9 @@
 #include "TabsController.h"
 
+#include <algorithm>
+
 #include "Application.h"
+#include "ApplicationSettings.h"
 #include "MessageFind.h"
 #include "MessageIndexingFinished.h"
 #include "MessageScrollToLine.h"
@@ -47,10 +50,8 @@ void TabsController::addTab(Id tabId, SearchMatch match)
 {
 	std::lock_guard<std::mutex> lock(m_tabsMutex);
 
-	TaskManager::createScheduler(tabId)->startSchedulerLoopThreaded();
-
-	m_tabs.emplace(
-		tabId, std::make_shared<Tab>(tabId, m_viewFactory, m_storageAccess, m_screenSearchSender));
+	createTab(tabId);
+	m_recentTabIds.push_back(tabId);
 
 	if (match.isValid())
 	{
@@ -74,22 +75,46 @@ void TabsController::addTab(Id tabId, SearchMatch match)
 
 	m_scrollToLine = std::make_tuple(0, FilePath(), 0);
 	m_isCreatingTab = false;
+
+	releaseTabs(tabId);
 }
 
 void TabsController::showTab(Id tabId)
 {
 	std::lock_guard<std::mutex> lock(m_tabsMutex);
 
-	auto it = m_tabs.find(tabId);
-	if (it != m_tabs.end())
+	const bool isReleased = m_releasedTabIds.find(tabId) != m_releasedTabIds.end();
+	if (isReleased || m_tabs.find(tabId) != m_tabs.end())
 	{
+		m_recentTabIds.erase(
+			std::remove(m_recentTabIds.begin(), m_recentTabIds.end(), tabId), m_recentTabIds.end());
+		m_recentTabIds.push_back(tabId);
+	}
+
+	if (m_releasingTabIds.find(tabId) != m_releasingTabIds.end())
+	{
+		// restored once the views of the tab are destroyed
 		TabId::setCurrentTabId(tabId);
-		it->second->setParentLayout(m_mainLayout);
 	}
 	else
 	{
-		TabId::setCurrentTabId(0);
-		m_mainLayout->showOriginalViews();
+		if (isReleased)
+		{
+			restoreTab(tabId);
+		}
+
+		auto it = m_tabs.find(tabId);
+		if (it != m_tabs.end())
+		{
+			TabId::setCurrentTabId(tabId);
+			it->second->setParentLayout(m_mainLayout);
+			releaseTabs(tabId);
+		}
+		else
+		{
+			TabId::setCurrentTabId(0);
+			m_mainLayout->showOriginalViews();
+		}
 	}
 
 	Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([this]() {
@@ -99,18 +124,30 @@ void TabsController::showTab(Id tabId)
 
 void TabsController::removeTab(Id tabId)
 {
-	// use app task scheduler thread to stop running tasks of tab
-	Task::dispatch(TabId::background(), std::make_shared<TaskLambda>([tabId, this]() {
-					   m_screenSearchSender->clearMatches();
+	bool isReleased = false;
+	{
+		std::lock_guard<std::mutex> lock(m_tabsMutex);
 
-					   TaskScheduler* scheduler = TaskManager::getScheduler(tabId).get();
-					   scheduler->terminateRunningTasks();
-					   scheduler->stopSchedulerLoop();
+		isReleased = m_releasedTabIds.erase(tabId);
+		m_tabMatches.erase(tabId);
+		m_recentTabIds.erase(
+			std::remove(m_recentTabIds.begin(), m_recentTabIds.end(), tabId), m_recentTabIds.end());
 
-					   TaskManager::destroyScheduler(tabId);
+		if (m_releasingTabIds.find(tabId) != m_releasingTabIds.end())
+		{
+			// the release destroys the tab
+			return;
+		}
+	}
 
-					   getView()->destroyTab(tabId);
-				   }));
+	if (isReleased)
+	{
+		// the scheduler of the tab was already destroyed with its views
+		getView()->destroyTab(tabId);
+		return;
+	}
+
+	destroyTabScheduler(tabId, true);
 }
 
 void TabsController::destroyTab(Id tabId)
@@ -120,6 +157,16 @@ void TabsController::destroyTab(Id tabId)
 	// destroy the tab on the qt thread to allow view destruction
 	m_tabs.erase(tabId);
 
+	if (m_releasingTabIds.erase(tabId) && m_releasedTabIds.find(tabId) != m_releasedTabIds.end())
+	{
+		if (TabId::currentTab() == tabId)
+		{
+			restoreTab(tabId);
+			m_tabs[tabId]->setParentLayout(m_mainLayout);
+		}
+		return;
+	}
+
 	if (m_tabs.empty() && Application::getInstance()->isProjectLoaded() && !m_isCreatingTab)
 	{
 		MessageTabOpen().dispatch();
@@ -138,6 +185,84 @@ TabsView* TabsController::getView() const
 	return Controller::getView<TabsView>();
 }
 
+void TabsController::createTab(Id tabId)
+{
+	TaskManager::createScheduler(tabId)->startSchedulerLoopThreaded();
+
+	m_tabs.emplace(
+		tabId, std::make_shared<Tab>(tabId, m_viewFactory, m_storageAccess, m_screenSearchSender));
+}
+
+void TabsController::destroyTabScheduler(Id tabId, bool clearMatches)
+{
+	// use app task scheduler thread to stop running tasks of tab
+	Task::dispatch(TabId::background(), std::make_shared<TaskLambda>([tabId, clearMatches, this]() {
+					   if (clearMatches)
+					   {
+						   m_screenSearchSender->clearMatches();
+					   }
+
+					   TaskScheduler* scheduler = TaskManager::getScheduler(tabId).get();
+					   scheduler->terminateRunningTasks();
+					   scheduler->stopSchedulerLoop();
+
+					   TaskManager::destroyScheduler(tabId);
+
+					   getView()->destroyTab(tabId);
+				   }));
+}
+
+void TabsController::releaseTabs(Id keptTabId)
+{
+	const int liveTabCount = ApplicationSettings::getInstance()->getLiveTabCount();
+	if (liveTabCount <= 0)
+	{
+		return;
+	}
+
+	size_t releasableCount = m_tabs.size() - m_releasingTabIds.size();
+	for (Id tabId: m_recentTabIds)
+	{
+		if (releasableCount <= size_t(liveTabCount))
+		{
+			break;
+		}
+
+		if (tabId == keptTabId || tabId == TabId::currentTab() ||
+			m_releasedTabIds.find(tabId) != m_releasedTabIds.end())
+		{
+			continue;
+		}
+
+		// the tab is shown with its last search matches again, its history is not kept
+		m_releasedTabIds.insert(tabId);
+		m_releasingTabIds.insert(tabId);
+		releasableCount--;
+
+		destroyTabScheduler(tabId, false);
+	}
+}
+
+void TabsController::restoreTab(Id tabId)
+{
+	m_releasedTabIds.erase(tabId);
+	createTab(tabId);
+
+	const std::vector<SearchMatch>& matches = m_tabMatches[tabId];
+	if (matches.size())
+	{
+		MessageSearch msg(matches, NodeTypeSet::all());
+		msg.setSchedulerId(tabId);
+		msg.dispatch();
+	}
+	else
+	{
+		MessageFind msg;
+		msg.setSchedulerId(tabId);
+		msg.dispatch();
+	}
+}
+
 void TabsController::handleMessage(MessageActivateErrors* message)
 {
 	if (m_tabs.empty() && Application::getInstance()->isProjectLoaded())
@@ -223,5 +348,10 @@ void TabsController::handleMessage(MessageTabSelect* message)
 
 void TabsController::handleMessage(MessageTabState* message)
 {
+	{
+		std::lock_guard<std::mutex> lock(m_tabsMutex);
+		m_tabMatches[message->tabId] = message->searchMatches;
+	}
+
 	getView()->updateTab(message->tabId, message->searchMatches);
 }
@@ -1,6 +1,11 @@
 #ifndef TABS_CONTROLLER_H
 #define TABS_CONTROLLER_H
 
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
 #include "MessageActivateErrors.h"
 #include "MessageIndexingFinished.h"
 #include "MessageListener.h"
@@ -57,6 +62,14 @@ private:
 
 	TabsView* getView() const;
 
+	void createTab(Id tabId);
+	void destroyTabScheduler(Id tabId, bool clearMatches);
+
+	// releases the views of the least recently shown tabs above the live tab count, which are
+	// created again with their last search matches when shown
+	void releaseTabs(Id keptTabId);
+	void restoreTab(Id tabId);
+
 	ViewLayout* m_mainLayout;
 	const ViewFactory* m_viewFactory;
 	StorageAccess* m_storageAccess;
@@ -65,6 +78,11 @@ private:
 	std::map<Id, std::shared_ptr<Tab>> m_tabs;
 	std::mutex m_tabsMutex;
 
+	std::map<Id, std::vector<SearchMatch>> m_tabMatches;
+	std::vector<Id> m_recentTabIds;	   // least recently shown first
+	std::set<Id> m_releasedTabIds;
+	std::set<Id> m_releasingTabIds;	   // still in m_tabs until the tab is destroyed
+
 	bool m_isCreatingTab;
 	std::tuple<Id, FilePath, size_t> m_scrollToLine;
 };
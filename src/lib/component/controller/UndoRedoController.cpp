@@ -1,5 +1,7 @@
 #include "UndoRedoController.h"
 
+#include <set>
+
 #include "MessageFlushUpdates.h"
 #include "MessageSearch.h"
 #include "utility.h"
@@ -668,6 +670,21 @@ void UndoRedoController::updateHistory()
 	}
 
 	getView()->updateHistory(historyListMatches, currentIndex - m_historyOffset);
+
+	// the history is listed from the most recent activation on
+	std::vector<Id> recentNodeIds;
+	std::set<Id> addedNodeIds;
+	for (const SearchMatch& match: historyListMatches)
+	{
+		for (Id tokenId: match.tokenIds)
+		{
+			if (addedNodeIds.insert(tokenId).second)
+			{
+				recentNodeIds.push_back(tokenId);
+			}
+		}
+	}
+	m_storageAccess->setRecentNodeIds(recentNodeIds);
 }
 
 void UndoRedoController::dump() const
@@ -276,6 +276,17 @@ void BucketLayouter::createBuckets(
 		getBucket(0, 0)->addNode(nodes[0]);
 	}
 
+	// resolve the top most nodes of all tokens at once instead of searching them for each edge
+	m_topMostNodes.clear();
+	for (const std::shared_ptr<DummyNode>& node: nodes)
+	{
+		if (node->visible)
+		{
+			m_topMostNodes.emplace(node->tokenId, node);
+		}
+		addTopMostDummyNodesRecursive(node->subNodes, node);
+	}
+
 	std::deque<std::shared_ptr<DummyEdge>> remainingEdges(edges.begin(), edges.end());
 	size_t skipCount = 0;
 	bool force = false;
@@ -290,10 +301,8 @@ void BucketLayouter::createBuckets(
 		std::shared_ptr<DummyEdge> edge = remainingEdges.front();
 		remainingEdges.pop_front();
 
-		std::shared_ptr<DummyNode> owner = findTopMostDummyNodeRecursive(
-			nodes, edge->ownerId, nullptr);
-		std::shared_ptr<DummyNode> target = findTopMostDummyNodeRecursive(
-			nodes, edge->targetId, nullptr);
+		std::shared_ptr<DummyNode> owner = getTopMostDummyNode(edge->ownerId);
+		std::shared_ptr<DummyNode> target = getTopMostDummyNode(edge->targetId);
 
 		bool horizontal = true;
 
@@ -497,23 +506,27 @@ std::vector<std::shared_ptr<DummyNode>> BucketLayouter::getSortedNodes()
 	return sortedNodes;
 }
 
-std::shared_ptr<DummyNode> BucketLayouter::findTopMostDummyNodeRecursive(
-	std::vector<std::shared_ptr<DummyNode>>& nodes, Id tokenId, std::shared_ptr<DummyNode> top)
+void BucketLayouter::addTopMostDummyNodesRecursive(
+	const std::vector<std::shared_ptr<DummyNode>>& nodes, const std::shared_ptr<DummyNode>& top)
 {
 	for (const std::shared_ptr<DummyNode>& node: nodes)
 	{
-		std::shared_ptr<DummyNode> t = (top ? top : node);
-
-		if (node->visible && node->tokenId == tokenId)
+		// the first top most node containing a visible node of the token wins
+		if (node->visible)
 		{
-			return t;
+			m_topMostNodes.emplace(node->tokenId, top);
 		}
 
-		std::shared_ptr<DummyNode> result = findTopMostDummyNodeRecursive(node->subNodes, tokenId, t);
-		if (result != nullptr)
-		{
-			return result;
-		}
+		addTopMostDummyNodesRecursive(node->subNodes, top);
+	}
+}
+
+std::shared_ptr<DummyNode> BucketLayouter::getTopMostDummyNode(Id tokenId) const
+{
+	auto it = m_topMostNodes.find(tokenId);
+	if (it != m_topMostNodes.end())
+	{
+		return it->second;
 	}
 
 	return nullptr;
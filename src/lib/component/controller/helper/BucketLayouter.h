@@ -54,8 +54,9 @@ public:
 	std::vector<std::shared_ptr<DummyNode>> getSortedNodes();
 
 private:
-	std::shared_ptr<DummyNode> findTopMostDummyNodeRecursive(
-		std::vector<std::shared_ptr<DummyNode>>& nodes, Id tokenId, std::shared_ptr<DummyNode> top);
+	void addTopMostDummyNodesRecursive(
+		const std::vector<std::shared_ptr<DummyNode>>& nodes, const std::shared_ptr<DummyNode>& top);
+	std::shared_ptr<DummyNode> getTopMostDummyNode(Id tokenId) const;
 
 	Bucket* getBucket(int i, int j);
 	Bucket* getBucket(std::shared_ptr<DummyNode> node);
@@ -69,6 +70,8 @@ private:
 	int m_j2;
 
 	DummyNode* m_activeParentNode = nullptr;
+
+	std::map<Id, std::shared_ptr<DummyNode>> m_topMostNodes;
 };
 
 #endif	  // BUCKET_LAYOUTER_H
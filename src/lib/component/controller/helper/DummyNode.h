@@ -115,6 +115,7 @@ public:
 		, accessKind(ACCESS_NONE)
 		, invisibleSubNodeCount(0)
 		, bundleId(0)
+		, nestingSignature(0)
 		, bundledNodeCount(0)
 		, bundledNodeType(NodeType::NODE_SYMBOL)
 		, qualifierName(NAME_DELIMITER_UNKNOWN)
@@ -443,6 +444,43 @@ public:
 		return nullptr;
 	}
 
+	// hash of all the state the nesting layout of this node and its sub nodes depends on
+	size_t getNestingSignature() const
+	{
+		size_t signature = 0;
+		addToNestingSignature(&signature);
+		return signature;
+	}
+
+	void addToNestingSignature(size_t* signature) const
+	{
+		// expand toggle nodes get recreated from the state of their parent node during nesting
+		if (isExpandToggleNode())
+		{
+			return;
+		}
+
+		auto combine = [signature](size_t value) {
+			*signature ^= value + 0x9e3779b9 + (*signature << 6) + (*signature >> 2);
+		};
+
+		combine(type);
+		combine(
+			size_t(visible) | size_t(hidden) << 1 | size_t(childVisible) << 2 |
+			size_t(active) << 3 | size_t(connected) << 4 | size_t(expanded) << 5);
+		combine(tokenId);
+		combine(std::hash<std::wstring>()(name));
+		combine(accessKind);
+		combine(size_t(fontSizeDiff));
+		combine(data ? data->getChildCount() : 0);
+
+		for (const std::shared_ptr<DummyNode>& subNode: subNodes)
+		{
+			subNode->addToNestingSignature(signature);
+		}
+		combine(~size_t(0));
+	}
+
 	std::vector<BundleInfo> getBundleInfos() const
 	{
 		std::vector<BundleInfo> bundleInfos;
@@ -488,6 +526,7 @@ public:
 
 	// Layout
 	Vec2i columnSize;
+	size_t nestingSignature;	// signature of the last nesting layout, 0 if never layouted
 
 	// BundleNode
 	BundledNodesSet bundledNodes;
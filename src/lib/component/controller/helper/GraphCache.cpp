@@ -0,0 +1,148 @@
+#include "GraphCache.h"
+
+#include <functional>
+#include <tuple>
+
+#include "Graph.h"
+
+bool GraphCache::Key::operator<(const Key& other) const
+{
+	return std::tie(nodeIds, edgeIds, expandedNodeIds, nodeTypes, edgeTypes, parameters) <
+		std::tie(
+			   other.nodeIds,
+			   other.edgeIds,
+			   other.expandedNodeIds,
+			   other.nodeTypes,
+			   other.edgeTypes,
+			   other.parameters);
+}
+
+GraphCache::GraphCache(size_t maxSize): m_maxSize(maxSize), m_contentVersion(0) {}
+
+bool GraphCache::getEntry(const Key& key, size_t contentVersion, Entry* entry)
+{
+	setContentVersion(contentVersion);
+
+	auto it = m_map.find(key);
+	if (it == m_map.end())
+	{
+		return false;
+	}
+
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	*entry = copyEntry(it->second->second);
+	return true;
+}
+
+void GraphCache::addEntry(const Key& key, size_t contentVersion, const Entry& entry)
+{
+	setContentVersion(contentVersion);
+
+	if (!m_maxSize)
+	{
+		return;
+	}
+
+	auto it = m_map.find(key);
+	if (it != m_map.end())
+	{
+		m_entries.erase(it->second);
+		m_map.erase(it);
+	}
+	else if (m_map.size() >= m_maxSize)
+	{
+		m_map.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+
+	m_entries.emplace_front(key, copyEntry(entry));
+	m_map.emplace(key, m_entries.begin());
+}
+
+size_t GraphCache::getSize() const
+{
+	return m_map.size();
+}
+
+void GraphCache::clear()
+{
+	m_map.clear();
+	m_entries.clear();
+}
+
+GraphCache::Entry GraphCache::copyEntry(const Entry& entry)
+{
+	Entry copy;
+	copy.topLevelAncestorIds = entry.topLevelAncestorIds;
+	copy.useBezierEdges = entry.useBezierEdges;
+	copy.params = entry.params;
+
+	copy.graph = std::make_shared<Graph>();
+	copy.graph->setTrailMode(entry.graph->getTrailMode());
+	copy.graph->setHasTrailOrigin(entry.graph->hasTrailOrigin());
+	entry.graph->forEachNode([&copy](Node* node) { copy.graph->addNodeAsPlainCopy(node); });
+	entry.graph->forEachEdge([&copy](Edge* edge) { copy.graph->addEdgeAsPlainCopy(edge); });
+
+	// dummy nodes may be referenced from several places, which all need to share the same copy
+	std::map<const DummyNode*, std::shared_ptr<DummyNode>> copiedNodes;
+	std::function<std::shared_ptr<DummyNode>(const std::shared_ptr<DummyNode>&)> copyNode =
+		[&copy, &copiedNodes, &copyNode](const std::shared_ptr<DummyNode>& node) {
+			auto it = copiedNodes.find(node.get());
+			if (it != copiedNodes.end())
+			{
+				return it->second;
+			}
+
+			std::shared_ptr<DummyNode> nodeCopy = std::make_shared<DummyNode>(*node);
+			copiedNodes.emplace(node.get(), nodeCopy);
+
+			if (node->data)
+			{
+				nodeCopy->data = copy.graph->getNodeById(node->data->getId());
+			}
+
+			for (std::shared_ptr<DummyNode>& subNode: nodeCopy->subNodes)
+			{
+				subNode = copyNode(subNode);
+			}
+
+			nodeCopy->bundledNodes.clear();
+			for (const std::shared_ptr<DummyNode>& bundledNode: node->bundledNodes)
+			{
+				nodeCopy->bundledNodes.insert(copyNode(bundledNode));
+			}
+
+			return nodeCopy;
+		};
+
+	for (const std::shared_ptr<DummyNode>& node: entry.dummyNodes)
+	{
+		copy.dummyNodes.push_back(copyNode(node));
+	}
+
+	for (const std::pair<const Id, std::shared_ptr<DummyNode>>& p: entry.dummyGraphNodes)
+	{
+		copy.dummyGraphNodes.emplace(p.first, copyNode(p.second));
+	}
+
+	for (const std::shared_ptr<DummyEdge>& edge: entry.dummyEdges)
+	{
+		std::shared_ptr<DummyEdge> edgeCopy = std::make_shared<DummyEdge>(*edge);
+		if (edge->data)
+		{
+			edgeCopy->data = copy.graph->getEdgeById(edge->data->getId());
+		}
+		copy.dummyEdges.push_back(edgeCopy);
+	}
+
+	return copy;
+}
+
+void GraphCache::setContentVersion(size_t contentVersion)
+{
+	if (contentVersion != m_contentVersion)
+	{
+		clear();
+		m_contentVersion = contentVersion;
+	}
+}
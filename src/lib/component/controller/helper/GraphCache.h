@@ -0,0 +1,70 @@
+#ifndef GRAPH_CACHE_H
+#define GRAPH_CACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "DummyEdge.h"
+#include "DummyNode.h"
+#include "Edge.h"
+#include "GraphView.h"
+#include "NodeType.h"
+#include "types.h"
+
+class Graph;
+
+// Recently shown graphs of the GraphController together with their bundled and layouted dummy
+// nodes and edges. The controller keeps changing its graph and dummy nodes after showing them,
+// so entries are copied when they are added and again when they are retrieved.
+class GraphCache
+{
+public:
+	struct Key
+	{
+		bool operator<(const Key& other) const;
+
+		std::vector<Id> nodeIds;
+		std::vector<Id> edgeIds;
+		std::vector<Id> expandedNodeIds;
+		NodeType::TypeMask nodeTypes = 0;
+		Edge::TypeMask edgeTypes = 0;
+		std::vector<int> parameters;	// everything else the graph or its layout depends on
+	};
+
+	struct Entry
+	{
+		std::shared_ptr<Graph> graph;
+		std::vector<std::shared_ptr<DummyNode>> dummyNodes;
+		std::vector<std::shared_ptr<DummyEdge>> dummyEdges;
+		std::map<Id, std::shared_ptr<DummyNode>> dummyGraphNodes;
+		std::map<Id, Id> topLevelAncestorIds;
+		bool useBezierEdges = false;
+		GraphView::GraphParams params;
+	};
+
+	GraphCache(size_t maxSize);
+
+	// entries added for another content version of the storage are dropped
+	bool getEntry(const Key& key, size_t contentVersion, Entry* entry);
+	void addEntry(const Key& key, size_t contentVersion, const Entry& entry);
+
+	size_t getSize() const;
+	void clear();
+
+private:
+	typedef std::list<std::pair<Key, Entry>> EntryList;
+
+	static Entry copyEntry(const Entry& entry);
+
+	void setContentVersion(size_t contentVersion);
+
+	const size_t m_maxSize;
+	size_t m_contentVersion;
+
+	EntryList m_entries;	// most recently used in front
+	std::map<Key, EntryList::iterator> m_map;
+};
+
+#endif	  // GRAPH_CACHE_H
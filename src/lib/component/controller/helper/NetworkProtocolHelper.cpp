@@ -16,6 +16,30 @@ std::wstring NetworkProtocolHelper::s_createProjectPrefix = L"createProject";
 std::wstring NetworkProtocolHelper::s_createCDBProjectPrefix = L"createCDBProject";
 std::wstring NetworkProtocolHelper::s_createCDBPrefix = L"createCDB";
 std::wstring NetworkProtocolHelper::s_pingPrefix = L"ping";
+std::wstring NetworkProtocolHelper::s_fileSavedPrefix = L"fileSaved";
+std::wstring NetworkProtocolHelper::s_querySymbolsPrefix = L"querySymbols";
+std::wstring NetworkProtocolHelper::s_symbolsPrefix = L"symbols";
+
+std::vector<std::wstring> NetworkProtocolHelper::takeCompleteMessages(std::string* receivedData)
+{
+	// the token is plain ascii, so it never matches within a multi byte character
+	const std::string endOfMessageToken = utility::encodeToUtf8(s_endOfMessageToken);
+
+	std::vector<std::wstring> messages;
+	size_t messageStart = 0;
+	size_t pos = receivedData->find(endOfMessageToken);
+	while (pos != std::string::npos)
+	{
+		const size_t messageEnd = pos + endOfMessageToken.size();
+		messages.push_back(utility::decodeFromUtf8(
+			receivedData->substr(messageStart, messageEnd - messageStart)));
+		messageStart = messageEnd;
+		pos = receivedData->find(endOfMessageToken, messageStart);
+	}
+	receivedData->erase(0, messageStart);
+
+	return messages;
+}
 
 NetworkProtocolHelper::MESSAGE_TYPE NetworkProtocolHelper::getMessageType(const std::wstring& message)
 {
@@ -39,6 +63,14 @@ NetworkProtocolHelper::MESSAGE_TYPE NetworkProtocolHelper::getMessageType(const
 		{
 			return MESSAGE_TYPE::PING;
 		}
+		else if (subMessages[0] == s_fileSavedPrefix)
+		{
+			return MESSAGE_TYPE::FILE_SAVED;
+		}
+		else if (subMessages[0] == s_querySymbolsPrefix)
+		{
+			return MESSAGE_TYPE::QUERY_SYMBOLS;
+		}
 		else
 		{
 			return MESSAGE_TYPE::UNKNOWN;
@@ -220,6 +252,66 @@ NetworkProtocolHelper::PingMessage NetworkProtocolHelper::parsePingMessage(const
 	return pingMessage;
 }
 
+NetworkProtocolHelper::FileSavedMessage NetworkProtocolHelper::parseFileSavedMessage(
+	const std::wstring& message)
+{
+	std::vector<std::wstring> subMessages = divideMessage(message);
+
+	NetworkProtocolHelper::FileSavedMessage networkMessage;
+
+	if (!subMessages.empty())
+	{
+		if (subMessages[0] == s_fileSavedPrefix)
+		{
+			if (subMessages.size() != 3)
+			{
+				LOG_ERROR("Failed to parse fileSaved message, invalid token count");
+			}
+			else if (!subMessages[1].empty())
+			{
+				networkMessage.filePath = FilePath(subMessages[1]);
+				networkMessage.valid = true;
+			}
+		}
+		else
+		{
+			LOG_ERROR(
+				L"Failed to parse message, invalid type token: " + subMessages[0] + L". Expected " +
+				s_fileSavedPrefix);
+		}
+	}
+
+	return networkMessage;
+}
+
+NetworkProtocolHelper::QuerySymbolsMessage NetworkProtocolHelper::parseQuerySymbolsMessage(
+	const std::wstring& message)
+{
+	NetworkProtocolHelper::QuerySymbolsMessage networkMessage;
+
+	const std::wstring prefix = s_querySymbolsPrefix + s_divider;
+	const size_t endPos = message.rfind(s_endOfMessageToken);
+	if (message.compare(0, prefix.size(), prefix) != 0 || endPos == std::wstring::npos ||
+		endPos < prefix.size())
+	{
+		LOG_ERROR(L"Failed to parse message, expected " + s_querySymbolsPrefix);
+		return networkMessage;
+	}
+
+	for (const std::wstring& name: utility::splitToVector(
+			 message.substr(prefix.size(), endPos - prefix.size()), L'\n'))
+	{
+		const std::wstring trimmedName = utility::trim(name);
+		if (!trimmedName.empty())
+		{
+			networkMessage.names.push_back(trimmedName);
+		}
+	}
+	networkMessage.valid = !networkMessage.names.empty();
+
+	return networkMessage;
+}
+
 std::wstring NetworkProtocolHelper::buildSetIDECursorMessage(
 	const FilePath& fileLocation, const unsigned int row, const unsigned int column)
 {
@@ -259,6 +351,18 @@ std::wstring NetworkProtocolHelper::buildPingMessage()
 	return messageStream.str();
 }
 
+std::wstring NetworkProtocolHelper::buildSymbolsMessage(const std::wstring& symbolsJson)
+{
+	std::wstringstream messageStream;
+
+	messageStream << s_symbolsPrefix;
+	messageStream << s_divider;
+	messageStream << symbolsJson;
+	messageStream << s_endOfMessageToken;
+
+	return messageStream.str();
+}
+
 std::vector<std::wstring> NetworkProtocolHelper::divideMessage(const std::wstring& message)
 {
 	std::vector<std::wstring> result;
@@ -43,26 +43,55 @@ public:
 		bool valid;
 	};
 
+	struct FileSavedMessage
+	{
+	public:
+		FileSavedMessage(): filePath(L""), valid(false) {}
+
+		FilePath filePath;
+		bool valid;
+	};
+
+	struct QuerySymbolsMessage
+	{
+	public:
+		QuerySymbolsMessage(): valid(false) {}
+
+		std::vector<std::wstring> names;
+		bool valid;
+	};
+
 	enum MESSAGE_TYPE
 	{
 		UNKNOWN = 0,
 		SET_ACTIVE_TOKEN,
 		CREATE_PROJECT,
 		CREATE_CDB_MESSAGE,
-		PING
+		PING,
+		FILE_SAVED,
+		QUERY_SYMBOLS
 	};
 
+	// Takes all messages ending with the end of message token out of the utf-8 encoded data
+	// received so far and leaves the incomplete rest, so one connection can carry many messages.
+	static std::vector<std::wstring> takeCompleteMessages(std::string* receivedData);
+
 	static MESSAGE_TYPE getMessageType(const std::wstring& message);
 
 	static SetActiveTokenMessage parseSetActiveTokenMessage(const std::wstring& message);
 	static CreateProjectMessage parseCreateProjectMessage(const std::wstring& message);
 	static CreateCDBProjectMessage parseCreateCDBProjectMessage(const std::wstring& message);
 	static PingMessage parsePingMessage(const std::wstring& message);
+	static FileSavedMessage parseFileSavedMessage(const std::wstring& message);
+
+	// the qualified names are separated by newlines, as template names may contain the divider
+	static QuerySymbolsMessage parseQuerySymbolsMessage(const std::wstring& message);
 
 	static std::wstring buildSetIDECursorMessage(
 		const FilePath& fileLocation, const unsigned int row, const unsigned int column);
 	static std::wstring buildCreateCDBMessage();
 	static std::wstring buildPingMessage();
+	static std::wstring buildSymbolsMessage(const std::wstring& symbolsJson);
 
 private:
 	static std::vector<std::wstring> divideMessage(const std::wstring& message);
@@ -76,6 +105,9 @@ private:
 	static std::wstring s_createCDBProjectPrefix;
 	static std::wstring s_createCDBPrefix;
 	static std::wstring s_pingPrefix;
+	static std::wstring s_fileSavedPrefix;
+	static std::wstring s_querySymbolsPrefix;
+	static std::wstring s_symbolsPrefix;
 };
 
 #endif	  // NETWORK_PROTOCOL_HELPER_H
\ No newline at end of file
@@ -10,7 +10,8 @@ void SnippetMerger::addChild(std::shared_ptr<SnippetMerger> child)
 	m_children.push_back(child);
 }
 
-std::deque<SnippetMerger::Range> SnippetMerger::merge(std::vector<SnippetMerger::Range> atomicRanges) const
+std::deque<SnippetMerger::Range> SnippetMerger::merge(
+	const std::vector<SnippetMerger::Range>& atomicRanges) const
 {
 	const int snippetExpandRange = ApplicationSettings::getInstance()->getCodeSnippetExpandRange();
 	std::deque<Range> merged;
@@ -61,18 +62,31 @@ SnippetMerger::Range SnippetMerger::getExpandedRegardingAtomicRanges(
 {
 	const int rangeStartThreshold = range.start.row - snippetExpandRange;
 	const int rangeEndThreshold = range.end.row + snippetExpandRange;
-	for (size_t i = 0; i < atomicRanges.size(); i++)
+
+	// atomic ranges don't overlap, so only the last one starting before a threshold can contain it
+	if (!range.start.strong)
 	{
-		if ((!range.start.strong) && (atomicRanges[i].end.row >= rangeStartThreshold) &&
-			(atomicRanges[i].start.row < rangeStartThreshold))
+		auto it = std::lower_bound(
+			atomicRanges.begin(),
+			atomicRanges.end(),
+			rangeStartThreshold,
+			[](const Range& atomicRange, int row) { return atomicRange.start.row < row; });
+		if (it != atomicRanges.begin() && (--it)->end.row >= rangeStartThreshold)
 		{
-			range.start.row = std::min(range.start.row, atomicRanges[i].start.row);
+			range.start.row = std::min(range.start.row, it->start.row);
 			range.start.strong = true;
 		}
-		if ((!range.end.strong) && (atomicRanges[i].start.row <= rangeEndThreshold) &&
-			(atomicRanges[i].end.row > rangeEndThreshold))
+	}
+	if (!range.end.strong)
+	{
+		auto it = std::upper_bound(
+			atomicRanges.begin(),
+			atomicRanges.end(),
+			rangeEndThreshold,
+			[](int row, const Range& atomicRange) { return row < atomicRange.start.row; });
+		if (it != atomicRanges.begin() && (--it)->end.row > rangeEndThreshold)
 		{
-			range.end.row = std::max(range.end.row, atomicRanges[i].end.row);
+			range.end.row = std::max(range.end.row, it->end.row);
 			range.end.strong = true;
 		}
 	}
@@ -16,26 +16,32 @@ public:
 	};
 	struct Range
 	{
+		// expects ranges sorted by start row, the result is sorted and free of overlaps
 		template <template <class, class> class ContainerType>
 		static ContainerType<Range, std::allocator<Range>> mergeAdjacent(
-			ContainerType<Range, std::allocator<Range>> ranges, int rowDifference = 1)
+			const ContainerType<Range, std::allocator<Range>>& ranges, int rowDifference = 1)
 		{
-			for (size_t i = 0; i + 1 < ranges.size(); i++)
+			ContainerType<Range, std::allocator<Range>> merged;
+			for (const Range& range: ranges)
 			{
-				const Range first = ranges[i];
-				const Range second = ranges[i + 1];
-				if (first.end.row + rowDifference >= second.start.row)
+				if (merged.size() && merged.back().end.row + rowDifference >= range.start.row)
 				{
-					ranges.erase(ranges.begin() + i, ranges.begin() + i + 2);
-					ranges.insert(
-						ranges.begin() + i,
-						Range(
-							first.start.row < second.start.row ? first.start : second.start,
-							first.end.row > second.end.row ? first.end : second.end));
-					i--;
+					Range& last = merged.back();
+					if (range.start.row <= last.start.row)
+					{
+						last.start = range.start;
+					}
+					if (range.end.row >= last.end.row)
+					{
+						last.end = range.end;
+					}
+				}
+				else
+				{
+					merged.push_back(range);
 				}
 			}
-			return ranges;
+			return merged;
 		}
 
 		Range(Border start, Border end): start(start), end(end) {}
@@ -45,7 +51,8 @@ public:
 
 	SnippetMerger(int startRow, int endRow);
 	void addChild(std::shared_ptr<SnippetMerger> child);
-	std::deque<Range> merge(std::vector<SnippetMerger::Range> atomicRanges) const;
+	// atomic ranges need to be sorted and free of overlaps, as returned by Range::mergeAdjacent
+	std::deque<Range> merge(const std::vector<SnippetMerger::Range>& atomicRanges) const;
 
 private:
 	Range getExpandedRegardingAtomicRanges(
@@ -1,5 +1,6 @@
 #include "TrailLayouter.h"
 
+#include <algorithm>
 #include <iostream>
 
 TrailLayouter::TrailLayouter(LayoutDirection dir): m_direction(dir), m_rootNode(nullptr) {}
@@ -17,7 +18,10 @@ void TrailLayouter::layoutGraph(
 	}
 
 	removeDeadEnds();
-	makeAcyclicRecursive(m_rootNode, std::set<TrailNode*>());
+
+	std::set<TrailNode*> predecessors;
+	std::set<TrailNode*> visitedNodes;
+	makeAcyclicRecursive(m_rootNode, &predecessors, &visitedNodes);
 
 	assignLongestPathLevels();
 	assignRemainingLevels();
@@ -138,20 +142,24 @@ void TrailLayouter::removeDeadEnds()
 	}
 }
 
-void TrailLayouter::makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> predecessors)
+void TrailLayouter::makeAcyclicRecursive(
+	TrailNode* node, std::set<TrailNode*>* predecessors, std::set<TrailNode*>* visitedNodes)
 {
-	predecessors.insert(node);
+	// switching the edges back to predecessors of a depth first search removes all cycles, so
+	// nodes reached on several paths only need to be processed once
+	predecessors->insert(node);
+	visitedNodes->insert(node);
 
 	std::set<TrailEdge*> edgesToSwitch;
 	for (TrailEdge* edge: node->outgoingEdges)
 	{
-		if (predecessors.find(edge->target) != predecessors.end())
+		if (predecessors->find(edge->target) != predecessors->end())
 		{
 			edgesToSwitch.insert(edge);
 		}
-		else
+		else if (visitedNodes->find(edge->target) == visitedNodes->end())
 		{
-			makeAcyclicRecursive(edge->target, predecessors);
+			makeAcyclicRecursive(edge->target, predecessors, visitedNodes);
 		}
 	}
 
@@ -159,6 +167,8 @@ void TrailLayouter::makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> p
 	{
 		switchEdge(edge);
 	}
+
+	predecessors->erase(node);
 }
 
 void TrailLayouter::assignLongestPathLevels()
@@ -703,17 +713,17 @@ void TrailLayouter::addEdge(
 	edge->origin = origin->second;
 	edge->target = target->second;
 
-	for (std::shared_ptr<TrailEdge>& e: m_allEdges)
+	// edges between the same nodes in either direction are merged
+	const std::pair<TrailNode*, TrailNode*> nodePair = std::minmax(edge->origin, edge->target);
+	auto it = m_edgesByNodes.find(nodePair);
+	if (it != m_edgesByNodes.end())
 	{
-		if ((e->origin == edge->origin && e->target == edge->target) ||
-			(e->origin == edge->target && e->target == edge->origin))
-		{
-			e->dummyEdges.push_back(dummyEdge.get());
-			return;
-		}
+		it->second->dummyEdges.push_back(dummyEdge.get());
+		return;
 	}
 
 	edge->dummyEdges.push_back(dummyEdge.get());
+	m_edgesByNodes.emplace(nodePair, edge.get());
 
 	edge->origin->outgoingEdges.insert(edge.get());
 	edge->target->incomingEdges.insert(edge.get());
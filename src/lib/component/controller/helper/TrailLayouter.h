@@ -63,7 +63,8 @@ private:
 		const std::map<Id, Id>& topLevelAncestorIds);
 
 	void removeDeadEnds();
-	void makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> predecessors);
+	void makeAcyclicRecursive(
+		TrailNode* node, std::set<TrailNode*>* predecessors, std::set<TrailNode*>* visitedNodes);
 
 	void assignLongestPathLevels();
 	void assignRemainingLevels();
@@ -89,6 +90,7 @@ private:
 
 	std::vector<std::shared_ptr<TrailNode>> m_allNodes;
 	std::vector<std::shared_ptr<TrailEdge>> m_allEdges;
+	std::map<std::pair<TrailNode*, TrailNode*>, TrailEdge*> m_edgesByNodes;
 
 	std::map<Id, TrailNode*> m_nodesById;
 	TrailNode* m_rootNode;
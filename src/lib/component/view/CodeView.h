@@ -37,6 +37,8 @@ public:
 		size_t referenceIndex = 0;
 		size_t localReferenceCount = 0;
 		size_t localReferenceIndex = 0;
+		// the files of further references get loaded when the list is scrolled to its end
+		bool hasMoreReferenceFiles = false;
 
 		std::vector<Id> activeTokenIds;
 		std::vector<Id> activeLocationIds;
@@ -69,7 +69,8 @@ DatabasePolicy DialogView::finishedIndexingDialog(
 	float time,
 	ErrorCountInfo errorInfo,
 	bool interrupted,
-	bool shallow)
+	bool shallow,
+	const std::vector<StorageIndexingTime>& slowestFiles)
 {
 	return DATABASE_POLICY_KEEP;	// used in non-gui mode
 }
@@ -7,6 +7,7 @@
 
 #include "ErrorCountInfo.h"
 #include "RefreshInfo.h"
+#include "StorageIndexingTime.h"
 
 class Project;
 class StorageAccess;
@@ -72,7 +73,8 @@ public:
 		float time,
 		ErrorCountInfo errorInfo,
 		bool interrupted,
-		bool shallow);
+		bool shallow,
+		const std::vector<StorageIndexingTime>& slowestFiles);
 
 	int confirm(const std::wstring& message);
 	virtual int confirm(const std::wstring& message, const std::vector<std::wstring>& options);
@@ -29,6 +29,8 @@ public:
 		bool isIndexedList = false;
 		bool bezierEdges = false;
 		bool disableInteraction = false;
+		// more levels of the trail are traversed, the view offers to stop there
+		bool isPartialTrail = false;
 	};
 
 	GraphView(ViewLayout* viewLayout);
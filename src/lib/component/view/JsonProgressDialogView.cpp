@@ -0,0 +1,156 @@
+#include "JsonProgressDialogView.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+const size_t JsonProgressDialogView::s_minProgressIntervalMs = 500;
+
+JsonProgressDialogView::JsonProgressDialogView(std::ostream& out)
+	: DialogView(UseCase::INDEXING, nullptr), m_out(out), m_startTime(TimeStamp::now())
+{
+}
+
+void JsonProgressDialogView::showUnknownProgressDialog(
+	const std::wstring& title, const std::wstring& message)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	startPhase(title, message);
+}
+
+void JsonProgressDialogView::showProgressDialog(
+	const std::wstring& title, const std::wstring& message, size_t progress)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	startPhase(title, message);
+}
+
+void JsonProgressDialogView::updateIndexingDialog(
+	size_t startedFileCount,
+	size_t finishedFileCount,
+	size_t totalFileCount,
+	const std::vector<FilePath>& sourcePaths)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	startPhase(L"Indexing", L"Indexing Files");
+	updateProgress(startedFileCount, finishedFileCount, totalFileCount);
+}
+
+void JsonProgressDialogView::updateCustomIndexingDialog(
+	size_t startedFileCount,
+	size_t finishedFileCount,
+	size_t totalFileCount,
+	const std::vector<FilePath>& sourcePaths)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	startPhase(L"Indexing", L"Running Custom Commands");
+	updateProgress(startedFileCount, finishedFileCount, totalFileCount);
+}
+
+DatabasePolicy JsonProgressDialogView::finishedIndexingDialog(
+	size_t indexedFileCount,
+	size_t totalIndexedFileCount,
+	size_t completedFileCount,
+	size_t totalFileCount,
+	float time,
+	ErrorCountInfo errorInfo,
+	bool interrupted,
+	bool shallow,
+	const std::vector<StorageIndexingTime>& slowestFiles)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	startPhase(L"", L"");
+
+	QJsonObject object;
+	object["indexed_files"] = double(indexedFileCount);
+	object["total_indexed_files"] = double(totalIndexedFileCount);
+	object["completed_files"] = double(completedFileCount);
+	object["total_files"] = double(totalFileCount);
+	object["duration_s"] = double(time);
+	object["errors"] = double(errorInfo.total);
+	object["fatal_errors"] = double(errorInfo.fatal);
+	object["interrupted"] = interrupted;
+	object["shallow"] = shallow;
+	write("finished", object);
+
+	return DialogView::finishedIndexingDialog(
+		indexedFileCount,
+		totalIndexedFileCount,
+		completedFileCount,
+		totalFileCount,
+		time,
+		errorInfo,
+		interrupted,
+		shallow,
+		slowestFiles);
+}
+
+void JsonProgressDialogView::startPhase(const std::wstring& phase, const std::wstring& step)
+{
+	if (phase == m_phase && step == m_step)
+	{
+		return;
+	}
+
+	if (!m_phase.empty())
+	{
+		QJsonObject object;
+		object["phase"] = QString::fromStdWString(m_phase);
+		object["step"] = QString::fromStdWString(m_step);
+		object["duration_s"] = TimeStamp::durationSeconds(m_phaseStartTime);
+		write("phase_finished", object);
+	}
+
+	m_phase = phase;
+	m_step = step;
+	m_phaseStartTime = TimeStamp::now();
+
+	if (!m_phase.empty())
+	{
+		QJsonObject object;
+		object["phase"] = QString::fromStdWString(m_phase);
+		object["step"] = QString::fromStdWString(m_step);
+		write("phase", object);
+	}
+}
+
+void JsonProgressDialogView::updateProgress(
+	size_t startedFileCount, size_t finishedFileCount, size_t totalFileCount)
+{
+	const TimeStamp now = TimeStamp::now();
+	if (!m_filesStarted)
+	{
+		m_filesStarted = true;
+		m_filesStartTime = now;
+	}
+	else if (
+		finishedFileCount == m_lastFinishedFileCount ||
+		(finishedFileCount < totalFileCount &&
+		 now.deltaMS(m_lastProgressTime) < s_minProgressIntervalMs))
+	{
+		// the last update of all files is always written
+		return;
+	}
+	m_lastProgressTime = now;
+	m_lastFinishedFileCount = finishedFileCount;
+
+	const double seconds = TimeStamp::durationSeconds(m_filesStartTime);
+	const double filesPerSecond = seconds > 0 ? double(finishedFileCount) / seconds : 0;
+
+	QJsonObject object;
+	object["started_files"] = double(startedFileCount);
+	object["finished_files"] = double(finishedFileCount);
+	object["total_files"] = double(totalFileCount);
+	object["files_per_s"] = filesPerSecond;
+	if (filesPerSecond > 0 && totalFileCount >= finishedFileCount)
+	{
+		object["eta_s"] = double(totalFileCount - finishedFileCount) / filesPerSecond;
+	}
+	write("progress", object);
+}
+
+void JsonProgressDialogView::write(const std::string& event, QJsonObject object)
+{
+	object["event"] = QString::fromStdString(event);
+	object["time_s"] = TimeStamp::durationSeconds(m_startTime);
+	m_out << QJsonDocument(object).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+}
@@ -0,0 +1,68 @@
+#ifndef JSON_PROGRESS_DIALOG_VIEW_H
+#define JSON_PROGRESS_DIALOG_VIEW_H
+
+#include <mutex>
+#include <ostream>
+
+#include "DialogView.h"
+#include "TimeStamp.h"
+
+class QJsonObject;
+
+// Reports the progress of indexing without a GUI as one json object per line, for scripts driving
+// the index command. Each line has an "event" of phase, phase_finished, progress or finished and
+// the seconds since the start of indexing as "time_s".
+class JsonProgressDialogView: public DialogView
+{
+public:
+	JsonProgressDialogView(std::ostream& out);
+
+	void showUnknownProgressDialog(const std::wstring& title, const std::wstring& message) override;
+	void showProgressDialog(
+		const std::wstring& title, const std::wstring& message, size_t progress) override;
+
+	void updateIndexingDialog(
+		size_t startedFileCount,
+		size_t finishedFileCount,
+		size_t totalFileCount,
+		const std::vector<FilePath>& sourcePaths) override;
+	void updateCustomIndexingDialog(
+		size_t startedFileCount,
+		size_t finishedFileCount,
+		size_t totalFileCount,
+		const std::vector<FilePath>& sourcePaths) override;
+
+	DatabasePolicy finishedIndexingDialog(
+		size_t indexedFileCount,
+		size_t totalIndexedFileCount,
+		size_t completedFileCount,
+		size_t totalFileCount,
+		float time,
+		ErrorCountInfo errorInfo,
+		bool interrupted,
+		bool shallow,
+		const std::vector<StorageIndexingTime>& slowestFiles) override;
+
+private:
+	static const size_t s_minProgressIntervalMs;
+
+	// needs to be called with the mutex locked
+	void startPhase(const std::wstring& phase, const std::wstring& step);
+	void updateProgress(size_t startedFileCount, size_t finishedFileCount, size_t totalFileCount);
+	void write(const std::string& event, QJsonObject object);
+
+	std::ostream& m_out;
+	std::mutex m_mutex;
+
+	const TimeStamp m_startTime;
+	std::wstring m_phase;
+	std::wstring m_step;
+	TimeStamp m_phaseStartTime;
+
+	TimeStamp m_lastProgressTime;
+	size_t m_lastFinishedFileCount = 0;
+	TimeStamp m_filesStartTime;
+	bool m_filesStarted = false;
+};
+
+#endif	  // JSON_PROGRESS_DIALOG_VIEW_H
@@ -22,6 +22,8 @@ public:
 	virtual void findFulltext() = 0;
 
 	virtual void setAutocompletionList(const std::vector<SearchMatch>& autocompletionList) = 0;
+	// adds further matches of the request whose first matches were set last
+	virtual void appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList) = 0;
 
 protected:
 	SearchController* getController();
@@ -0,0 +1,377 @@
+#include "AdjacencyCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "MemoryUsage.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
+#include "utility.h"
+#include "utilityBinary.h"
+
+namespace
+{
+const int32_t unknownNodeType = -1;
+}	 // namespace
+
+const uint32_t AdjacencyCache::s_serializationVersion = 1;
+const size_t AdjacencyCache::s_minParallelNodeCount = 10000;
+
+void AdjacencyCache::clear()
+{
+	m_nodeIds.clear();
+	m_nodeTypes.clear();
+	m_edges.clear();
+	m_outgoing = Rows();
+	m_incoming = Rows();
+}
+
+bool AdjacencyCache::isEmpty() const
+{
+	return m_nodeIds.empty();
+}
+
+size_t AdjacencyCache::getByteSize() const
+{
+	size_t byteSize = utility::getByteSize(m_nodeIds) + utility::getByteSize(m_nodeTypes) +
+		utility::getByteSize(m_edges);
+	for (const Rows* rows: {&m_outgoing, &m_incoming})
+	{
+		byteSize += utility::getByteSize(rows->offsets) + utility::getByteSize(rows->edgeIndices) +
+			utility::getByteSize(rows->edgeTypes);
+	}
+	return byteSize;
+}
+
+void AdjacencyCache::build(
+	const std::vector<std::pair<Id, int>>& nodeTypes, std::vector<StorageEdge> edges)
+{
+	clear();
+
+	for (const std::pair<Id, int>& nodeType: nodeTypes)
+	{
+		m_nodeIds.push_back(uint64_t(nodeType.first));
+	}
+	for (const StorageEdge& edge: edges)
+	{
+		m_nodeIds.push_back(uint64_t(edge.sourceNodeId));
+		m_nodeIds.push_back(uint64_t(edge.targetNodeId));
+	}
+	std::sort(m_nodeIds.begin(), m_nodeIds.end());
+	m_nodeIds.erase(std::unique(m_nodeIds.begin(), m_nodeIds.end()), m_nodeIds.end());
+
+	m_nodeTypes.assign(m_nodeIds.size(), unknownNodeType);
+	for (const std::pair<Id, int>& nodeType: nodeTypes)
+	{
+		m_nodeTypes[getNodeIndex(nodeType.first)] = int32_t(nodeType.second);
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const StorageEdge& a, const StorageEdge& b) {
+		return a.id < b.id;
+	});
+	m_edges.reserve(edges.size());
+	for (const StorageEdge& edge: edges)
+	{
+		m_edges.push_back(
+			{uint64_t(edge.id),
+			 uint64_t(edge.sourceNodeId),
+			 uint64_t(edge.targetNodeId),
+			 int32_t(edge.type)});
+	}
+
+	std::vector<uint32_t> sourceIndices;
+	std::vector<uint32_t> targetIndices;
+	sourceIndices.reserve(m_edges.size());
+	targetIndices.reserve(m_edges.size());
+	for (const EdgeRecord& edge: m_edges)
+	{
+		sourceIndices.push_back(uint32_t(getNodeIndex(Id(edge.sourceId))));
+		targetIndices.push_back(uint32_t(getNodeIndex(Id(edge.targetId))));
+	}
+
+	m_outgoing = buildRows(m_edges, sourceIndices, m_nodeIds.size());
+	m_incoming = buildRows(m_edges, targetIndices, m_nodeIds.size());
+}
+
+void AdjacencyCache::build(
+	const AdjacencyCache& cache,
+	const std::set<Id>& skippedIds,
+	std::vector<std::pair<Id, int>> nodeTypes,
+	std::vector<StorageEdge> edges)
+{
+	for (size_t i = 0; i < cache.m_nodeIds.size(); i++)
+	{
+		if (cache.m_nodeTypes[i] != unknownNodeType &&
+			skippedIds.find(Id(cache.m_nodeIds[i])) == skippedIds.end())
+		{
+			nodeTypes.emplace_back(Id(cache.m_nodeIds[i]), int(cache.m_nodeTypes[i]));
+		}
+	}
+
+	for (const EdgeRecord& edge: cache.m_edges)
+	{
+		if (skippedIds.find(Id(edge.id)) == skippedIds.end())
+		{
+			edges.emplace_back(Id(edge.id), int(edge.type), Id(edge.sourceId), Id(edge.targetId));
+		}
+	}
+
+	build(nodeTypes, std::move(edges));
+}
+
+bool AdjacencyCache::getNodeType(Id nodeId, int* type) const
+{
+	const size_t index = getNodeIndex(nodeId);
+	if (index == m_nodeIds.size() || m_nodeTypes[index] == unknownNodeType)
+	{
+		return false;
+	}
+
+	*type = m_nodeTypes[index];
+	return true;
+}
+
+bool AdjacencyCache::getEdgeById(Id edgeId, StorageEdge* edge) const
+{
+	auto it = std::lower_bound(
+		m_edges.begin(), m_edges.end(), uint64_t(edgeId), [](const EdgeRecord& record, uint64_t id) {
+			return record.id < id;
+		});
+	if (it == m_edges.end() || it->id != edgeId)
+	{
+		return false;
+	}
+
+	*edge = StorageEdge(Id(it->id), int(it->type), Id(it->sourceId), Id(it->targetId));
+	return true;
+}
+
+void AdjacencyCache::forEachNode(const std::function<void(Id nodeId, int type)>& func) const
+{
+	for (size_t i = 0; i < m_nodeIds.size(); i++)
+	{
+		if (m_nodeTypes[i] != unknownNodeType)
+		{
+			func(Id(m_nodeIds[i]), m_nodeTypes[i]);
+		}
+	}
+}
+
+void AdjacencyCache::forEachEdge(const std::function<void(const StorageEdge&)>& func) const
+{
+	for (const EdgeRecord& edge: m_edges)
+	{
+		func(StorageEdge(Id(edge.id), int(edge.type), Id(edge.sourceId), Id(edge.targetId)));
+	}
+}
+
+std::vector<StorageEdge> AdjacencyCache::getEdgesBySourceIds(
+	const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes) const
+{
+	return getEdges(m_outgoing, nodeIds, edgeTypes);
+}
+
+std::vector<StorageEdge> AdjacencyCache::getEdgesByTargetIds(
+	const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes) const
+{
+	return getEdges(m_incoming, nodeIds, edgeTypes);
+}
+
+std::string AdjacencyCache::serialize() const
+{
+	std::string data;
+	const uint32_t header[] = {s_serializationVersion, uint32_t(sizeof(EdgeRecord))};
+	data.append(reinterpret_cast<const char*>(header), sizeof(header));
+
+	utility::appendBinaryData(data, m_nodeIds);
+	utility::appendBinaryData(data, m_nodeTypes);
+	utility::appendBinaryData(data, m_edges);
+	for (const Rows* rows: {&m_outgoing, &m_incoming})
+	{
+		utility::appendBinaryData(data, rows->offsets);
+		utility::appendBinaryData(data, rows->edgeIndices);
+		utility::appendBinaryData(data, rows->edgeTypes);
+	}
+	return data;
+}
+
+bool AdjacencyCache::deserialize(const std::string& data)
+{
+	clear();
+
+	uint32_t header[2] = {0, 0};
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(header, data.data(), sizeof(header));
+	if (header[0] != s_serializationVersion || header[1] != sizeof(EdgeRecord))
+	{
+		return false;
+	}
+
+	size_t position = sizeof(header);
+	AdjacencyCache cache;
+	if (!utility::readBinaryData(data, position, cache.m_nodeIds) ||
+		!utility::readBinaryData(data, position, cache.m_nodeTypes) ||
+		!utility::readBinaryData(data, position, cache.m_edges) ||
+		cache.m_nodeTypes.size() != cache.m_nodeIds.size())
+	{
+		return false;
+	}
+
+	for (Rows* rows: {&cache.m_outgoing, &cache.m_incoming})
+	{
+		if (!utility::readBinaryData(data, position, rows->offsets) ||
+			!utility::readBinaryData(data, position, rows->edgeIndices) ||
+			!utility::readBinaryData(data, position, rows->edgeTypes) ||
+			rows->offsets.size() != cache.m_nodeIds.size() + 1 ||
+			rows->edgeTypes.size() != cache.m_nodeIds.size() || rows->offsets.front() != 0 ||
+			rows->offsets.back() != rows->edgeIndices.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 1; i < rows->offsets.size(); i++)
+		{
+			if (rows->offsets[i] < rows->offsets[i - 1])
+			{
+				return false;
+			}
+		}
+
+		for (uint32_t edgeIndex: rows->edgeIndices)
+		{
+			if (edgeIndex >= cache.m_edges.size())
+			{
+				return false;
+			}
+		}
+	}
+
+	if (position != data.size())
+	{
+		return false;
+	}
+
+	*this = std::move(cache);
+	return true;
+}
+
+AdjacencyCache::Rows AdjacencyCache::buildRows(
+	const std::vector<EdgeRecord>& edges,
+	const std::vector<uint32_t>& nodeIndices,
+	size_t nodeCount)
+{
+	Rows rows;
+	rows.offsets.assign(nodeCount + 1, 0);
+	rows.edgeTypes.assign(nodeCount, 0);
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		rows.offsets[nodeIndices[i] + 1]++;
+		rows.edgeTypes[nodeIndices[i]] |= Edge::intToType(edges[i].type);
+	}
+	for (size_t i = 1; i < rows.offsets.size(); i++)
+	{
+		rows.offsets[i] += rows.offsets[i - 1];
+	}
+
+	// filling the rows in the order of type and id leaves each row ordered the same way
+	std::vector<uint32_t> order(edges.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		order[i] = uint32_t(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&edges](uint32_t a, uint32_t b) {
+		return edges[a].type < edges[b].type;
+	});
+
+	std::vector<uint32_t> positions(rows.offsets.begin(), rows.offsets.end() - 1);
+	rows.edgeIndices.resize(edges.size());
+	for (uint32_t edgeIndex: order)
+	{
+		rows.edgeIndices[positions[nodeIndices[edgeIndex]]++] = edgeIndex;
+	}
+
+	return rows;
+}
+
+size_t AdjacencyCache::getNodeIndex(Id nodeId) const
+{
+	auto it = std::lower_bound(m_nodeIds.begin(), m_nodeIds.end(), uint64_t(nodeId));
+	if (it == m_nodeIds.end() || *it != uint64_t(nodeId))
+	{
+		return m_nodeIds.size();
+	}
+	return size_t(it - m_nodeIds.begin());
+}
+
+std::vector<StorageEdge> AdjacencyCache::getEdges(
+	const Rows& rows, std::vector<Id> nodeIds, Edge::TypeMask edgeTypes) const
+{
+	std::sort(nodeIds.begin(), nodeIds.end());
+	nodeIds.erase(std::unique(nodeIds.begin(), nodeIds.end()), nodeIds.end());
+
+	std::vector<uint32_t> edgeIndices;
+	if (nodeIds.size() < s_minParallelNodeCount)
+	{
+		addEdges(rows, nodeIds, edgeTypes, &edgeIndices);
+	}
+	else
+	{
+		std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+		const std::vector<std::vector<Id>> parts = utility::splitToEqualySizedParts(
+			nodeIds, threadPool->getWorkerCount());
+
+		std::vector<std::vector<uint32_t>> partEdgeIndices(parts.size());
+		threadPool->parallelFor(
+			parts.size(),
+			[&](size_t i) { addEdges(rows, parts[i], edgeTypes, &partEdgeIndices[i]); },
+			ThreadPool::PRIORITY_INTERACTIVE);
+		for (size_t i = 0; i < parts.size(); i++)
+		{
+			std::move(
+				partEdgeIndices[i].begin(),
+				partEdgeIndices[i].end(),
+				std::back_inserter(edgeIndices));
+		}
+	}
+
+	// each edge has a single source and target, so no edge is added twice
+	std::sort(edgeIndices.begin(), edgeIndices.end());
+
+	std::vector<StorageEdge> edges;
+	edges.reserve(edgeIndices.size());
+	for (uint32_t edgeIndex: edgeIndices)
+	{
+		const EdgeRecord& edge = m_edges[edgeIndex];
+		edges.emplace_back(Id(edge.id), int(edge.type), Id(edge.sourceId), Id(edge.targetId));
+	}
+	return edges;
+}
+
+void AdjacencyCache::addEdges(
+	const Rows& rows,
+	const std::vector<Id>& nodeIds,
+	Edge::TypeMask edgeTypes,
+	std::vector<uint32_t>* edgeIndices) const
+{
+	for (Id nodeId: nodeIds)
+	{
+		const size_t nodeIndex = getNodeIndex(nodeId);
+		if (nodeIndex == m_nodeIds.size() || !(rows.edgeTypes[nodeIndex] & edgeTypes))
+		{
+			continue;
+		}
+
+		for (uint32_t i = rows.offsets[nodeIndex]; i < rows.offsets[nodeIndex + 1]; i++)
+		{
+			const uint32_t edgeIndex = rows.edgeIndices[i];
+			if (Edge::intToType(m_edges[edgeIndex].type) & edgeTypes)
+			{
+				edgeIndices->push_back(edgeIndex);
+			}
+		}
+	}
+}
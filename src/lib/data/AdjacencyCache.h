@@ -0,0 +1,98 @@
+#ifndef ADJACENCY_CACHE_H
+#define ADJACENCY_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Edge.h"
+#include "StorageEdge.h"
+#include "types.h"
+
+// All edges of the storage in compressed sparse row layout, once by their source node and once by
+// their target node. The edges of a node are ordered by their type and each row knows the types it
+// contains, so lookups that only accept some edge types skip the other rows. Nodes are referred to
+// by their position within the sorted node ids.
+class AdjacencyCache
+{
+public:
+	void clear();
+	bool isEmpty() const;
+	size_t getByteSize() const;
+
+	void build(const std::vector<std::pair<Id, int>>& nodeTypes, std::vector<StorageEdge> edges);
+	// builds from the nodes and edges of the other cache except the skipped ids together with the
+	// given ones
+	void build(
+		const AdjacencyCache& cache,
+		const std::set<Id>& skippedIds,
+		std::vector<std::pair<Id, int>> nodeTypes,
+		std::vector<StorageEdge> edges);
+
+	// returns false for nodes without edges that were not passed to build
+	bool getNodeType(Id nodeId, int* type) const;
+
+	// returns false if no edge has the id
+	bool getEdgeById(Id edgeId, StorageEdge* edge) const;
+
+	// edges are ordered by their id, like the edges read from the database
+	std::vector<StorageEdge> getEdgesBySourceIds(
+		const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes) const;
+	std::vector<StorageEdge> getEdgesByTargetIds(
+		const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes) const;
+
+	// in the order of their ids, nodes that were only known as ends of edges are skipped
+	void forEachNode(const std::function<void(Id nodeId, int type)>& func) const;
+
+	// in the order of their ids
+	void forEachEdge(const std::function<void(const StorageEdge&)>& func) const;
+
+	// the serialized data is only meant to be read by the same build on the same platform
+	std::string serialize() const;
+	bool deserialize(const std::string& data);
+
+private:
+	struct EdgeRecord
+	{
+		uint64_t id;
+		uint64_t sourceId;
+		uint64_t targetId;
+		int32_t type;
+	};
+
+	struct Rows
+	{
+		std::vector<uint32_t> offsets;	  // node count + 1 entries
+		std::vector<uint32_t> edgeIndices;
+		std::vector<Edge::TypeMask> edgeTypes;	  // types contained in each row
+	};
+
+	static const uint32_t s_serializationVersion;
+	static const size_t s_minParallelNodeCount;
+
+	static Rows buildRows(
+		const std::vector<EdgeRecord>& edges,
+		const std::vector<uint32_t>& nodeIndices,
+		size_t nodeCount);
+
+	size_t getNodeIndex(Id nodeId) const;	 // node count if unknown
+
+	std::vector<StorageEdge> getEdges(
+		const Rows& rows, std::vector<Id> nodeIds, Edge::TypeMask edgeTypes) const;
+	void addEdges(
+		const Rows& rows,
+		const std::vector<Id>& nodeIds,
+		Edge::TypeMask edgeTypes,
+		std::vector<uint32_t>* edgeIndices) const;
+
+	std::vector<uint64_t> m_nodeIds;
+	std::vector<int32_t> m_nodeTypes;
+	std::vector<EdgeRecord> m_edges;	// sorted by id
+	Rows m_outgoing;
+	Rows m_incoming;
+};
+
+#endif	  // ADJACENCY_CACHE_H
@@ -0,0 +1,106 @@
+#include "AggregationCache.h"
+
+#include <algorithm>
+
+#include "AdjacencyCache.h"
+#include "HierarchyCache.h"
+#include "MemoryUsage.h"
+
+void AggregationCache::clear()
+{
+	m_isBuilt = false;
+	m_nodeIds.clear();
+	m_offsets.clear();
+	m_edges.clear();
+	m_uncoveredNodeIds.clear();
+}
+
+bool AggregationCache::isEmpty() const
+{
+	return !m_isBuilt;
+}
+
+size_t AggregationCache::getByteSize() const
+{
+	return utility::getByteSize(m_nodeIds) + utility::getByteSize(m_offsets) +
+		utility::getByteSize(m_edges) + utility::getByteSize(m_uncoveredNodeIds);
+}
+
+void AggregationCache::build(
+	const AdjacencyCache& adjacencyCache, const HierarchyCache& hierarchyCache)
+{
+	clear();
+
+	struct Record
+	{
+		uint64_t nodeId;
+		AggregatedEdge edge;
+	};
+
+	std::vector<Record> records;
+	adjacencyCache.forEachEdge([&records, &hierarchyCache](const StorageEdge& edge) {
+		const Id sourceParentId = hierarchyCache.getLastVisibleParentNodeId(edge.sourceNodeId);
+		const Id targetParentId = hierarchyCache.getLastVisibleParentNodeId(edge.targetNodeId);
+		if (sourceParentId == targetParentId)
+		{
+			return;
+		}
+
+		if (edge.sourceNodeId != sourceParentId)
+		{
+			records.push_back({sourceParentId, {targetParentId, edge.id, true}});
+		}
+		if (edge.targetNodeId != targetParentId)
+		{
+			records.push_back({targetParentId, {sourceParentId, edge.id, false}});
+		}
+	});
+
+	// the edges arrive ordered by id, so the rows keep that order
+	std::stable_sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+		return a.nodeId < b.nodeId;
+	});
+
+	m_edges.reserve(records.size());
+	for (const Record& record: records)
+	{
+		if (m_nodeIds.empty() || m_nodeIds.back() != record.nodeId)
+		{
+			m_nodeIds.push_back(record.nodeId);
+			m_offsets.push_back(uint32_t(m_edges.size()));
+		}
+		m_edges.push_back(record.edge);
+	}
+	m_offsets.push_back(uint32_t(m_edges.size()));
+
+	for (Id nodeId: hierarchyCache.getLastVisibleParentIdsOfInvisibleChildren())
+	{
+		m_uncoveredNodeIds.push_back(nodeId);
+	}
+	std::sort(m_uncoveredNodeIds.begin(), m_uncoveredNodeIds.end());
+	m_uncoveredNodeIds.erase(
+		std::unique(m_uncoveredNodeIds.begin(), m_uncoveredNodeIds.end()),
+		m_uncoveredNodeIds.end());
+
+	m_isBuilt = true;
+}
+
+bool AggregationCache::getAggregatedEdges(Id nodeId, std::vector<AggregatedEdge>* edges) const
+{
+	if (!m_isBuilt ||
+		std::binary_search(m_uncoveredNodeIds.begin(), m_uncoveredNodeIds.end(), uint64_t(nodeId)))
+	{
+		return false;
+	}
+
+	auto it = std::lower_bound(m_nodeIds.begin(), m_nodeIds.end(), uint64_t(nodeId));
+	if (it != m_nodeIds.end() && *it == nodeId)
+	{
+		const size_t index = it - m_nodeIds.begin();
+		edges->insert(
+			edges->end(),
+			m_edges.begin() + m_offsets[index],
+			m_edges.begin() + m_offsets[index + 1]);
+	}
+	return true;
+}
@@ -0,0 +1,44 @@
+#ifndef AGGREGATION_CACHE_H
+#define AGGREGATION_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "types.h"
+
+class AdjacencyCache;
+class HierarchyCache;
+
+// Edges between nodes of different last visible parents, stored with the last visible parent of the
+// end that is a child of it and the last visible parent of the other end. For a node that is its
+// own last visible parent this gives the edges of all its children, grandchildren and so on that
+// leave it, which is what aggregation edges are built from. Nodes with invisible children in their
+// hierarchy are not covered, their children do not all share their last visible parent.
+class AggregationCache
+{
+public:
+	struct AggregatedEdge
+	{
+		uint64_t parentId;	  // last visible parent of the other end
+		uint64_t edgeId;
+		bool forward;	 // the edge starts at the child
+	};
+
+	void clear();
+	bool isEmpty() const;
+	size_t getByteSize() const;
+
+	void build(const AdjacencyCache& adjacencyCache, const HierarchyCache& hierarchyCache);
+
+	// false if the node is not covered, then its edges have to be collected from its children
+	bool getAggregatedEdges(Id nodeId, std::vector<AggregatedEdge>* edges) const;
+
+private:
+	bool m_isBuilt = false;
+	std::vector<uint64_t> m_nodeIds;
+	std::vector<uint32_t> m_offsets;	// node count + 1 entries
+	std::vector<AggregatedEdge> m_edges;
+	std::vector<uint64_t> m_uncoveredNodeIds;
+};
+
+#endif	  // AGGREGATION_CACHE_H
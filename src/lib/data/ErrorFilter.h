@@ -5,7 +5,13 @@
 
 struct ErrorFilter
 {
-	ErrorFilter(): error(true), fatal(true), unindexedError(true), unindexedFatal(true), limit(1000)
+	ErrorFilter()
+		: error(true)
+		, fatal(true)
+		, unindexedError(true)
+		, unindexedFatal(true)
+		, limit(1000)
+		, offset(0)
 	{
 	}
 
@@ -26,10 +32,17 @@ struct ErrorFilter
 	{
 		std::vector<ErrorInfo> filteredErrors;
 
+		size_t skippedCount = 0;
 		for (const ErrorInfo& error: errors)
 		{
 			if (filter(error))
 			{
+				if (skippedCount < offset)
+				{
+					skippedCount++;
+					continue;
+				}
+
 				filteredErrors.push_back(error);
 
 				if (limit > 0 && filteredErrors.size() >= limit)
@@ -46,7 +59,7 @@ struct ErrorFilter
 	{
 		return error == other.error && fatal == other.fatal &&
 			unindexedError == other.unindexedError && unindexedFatal == other.unindexedFatal &&
-			limit == other.limit;
+			limit == other.limit && offset == other.offset;
 	}
 
 	bool error;
@@ -56,6 +69,7 @@ struct ErrorFilter
 	bool unindexedFatal;
 
 	size_t limit;
+	size_t offset;	  // number of passing errors skipped before the limit applies
 };
 
 #endif	  // ERROR_FILTER_H
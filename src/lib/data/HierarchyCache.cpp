@@ -1,196 +1,199 @@
 #include "HierarchyCache.h"
 
-HierarchyCache::HierarchyNode::HierarchyNode(Id nodeId)
-	: m_nodeId(nodeId), m_edgeId(0), m_parent(nullptr), m_isVisible(true), m_isImplicit(false)
-{
-}
+#include <algorithm>
 
-Id HierarchyCache::HierarchyNode::getNodeId() const
-{
-	return m_nodeId;
-}
+#include "MemoryUsage.h"
 
-Id HierarchyCache::HierarchyNode::getEdgeId() const
-{
-	return m_edgeId;
-}
+const uint32_t HierarchyCache::s_noIndex = ~uint32_t(0);
 
-void HierarchyCache::HierarchyNode::setEdgeId(Id edgeId)
+void HierarchyCache::clear()
 {
-	m_edgeId = edgeId;
-}
+	m_connections.clear();
+	m_inheritances.clear();
 
-HierarchyCache::HierarchyNode* HierarchyCache::HierarchyNode::getParent() const
-{
-	return m_parent;
-}
+	m_nodeIds.clear();
+	m_parents.clear();
+	m_edgeIds.clear();
+	m_flags.clear();
 
-void HierarchyCache::HierarchyNode::setParent(HierarchyNode* parent)
-{
-	m_parent = parent;
-}
+	m_childOffsets.clear();
+	m_children.clear();
+	m_nonImplicitChildCounts.clear();
 
-void HierarchyCache::HierarchyNode::addBase(HierarchyNode* base, Id edgeId)
-{
-	m_bases.push_back(base);
-	m_baseEdgeIds.push_back(edgeId);
+	m_baseOffsets.clear();
+	m_bases.clear();
+	m_baseEdgeIds.clear();
 }
 
-void HierarchyCache::HierarchyNode::addChild(HierarchyNode* child)
+size_t HierarchyCache::getByteSize() const
 {
-	m_children.push_back(child);
+	return utility::getByteSize(m_connections) + utility::getByteSize(m_inheritances) +
+		utility::getByteSize(m_nodeIds) + utility::getByteSize(m_parents) +
+		utility::getByteSize(m_edgeIds) + utility::getByteSize(m_flags) +
+		utility::getByteSize(m_childOffsets) + utility::getByteSize(m_children) +
+		utility::getByteSize(m_nonImplicitChildCounts) + utility::getByteSize(m_baseOffsets) +
+		utility::getByteSize(m_bases) + utility::getByteSize(m_baseEdgeIds);
 }
 
-size_t HierarchyCache::HierarchyNode::getChildrenCount() const
-{
-	return m_children.size();
-}
-
-size_t HierarchyCache::HierarchyNode::getNonImplicitChildrenCount() const
+void HierarchyCache::createConnection(
+	Id edgeId, Id fromId, Id toId, bool sourceVisible, bool sourceImplicit, bool targetImplicit)
 {
-	size_t count = 0;
-	for (const HierarchyNode* child: m_children)
+	if (fromId == toId)
 	{
-		if (!child->isImplicit())
-		{
-			count++;
-		}
+		return;
 	}
-	return count;
+
+	m_connections.push_back({edgeId, fromId, toId, sourceVisible, sourceImplicit, targetImplicit});
 }
 
-void HierarchyCache::HierarchyNode::addChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const
+void HierarchyCache::createInheritance(Id edgeId, Id fromId, Id toId)
 {
-	for (const HierarchyNode* child: m_children)
+	if (fromId == toId)
 	{
-		nodeIds->push_back(child->getNodeId());
-		edgeIds->push_back(child->getEdgeId());
+		return;
 	}
+
+	m_inheritances.push_back({edgeId, fromId, toId});
 }
 
-void HierarchyCache::HierarchyNode::addNonImplicitChildIds(
-	std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const
+void HierarchyCache::finishSetup()
 {
-	for (const HierarchyNode* child: m_children)
+	for (const Connection& connection: m_connections)
 	{
-		if (!child->isImplicit())
-		{
-			nodeIds->push_back(child->getNodeId());
-			edgeIds->push_back(child->getEdgeId());
-		}
+		m_nodeIds.push_back(connection.fromId);
+		m_nodeIds.push_back(connection.toId);
 	}
-}
-
-void HierarchyCache::HierarchyNode::addChildIdsRecursive(std::set<Id>* nodeIds, std::set<Id>* edgeIds) const
-{
-	for (const HierarchyNode* child: m_children)
+	for (const Inheritance& inheritance: m_inheritances)
 	{
-		nodeIds->insert(child->getNodeId());
-		edgeIds->insert(child->getEdgeId());
-
-		child->addChildIdsRecursive(nodeIds, edgeIds);
+		m_nodeIds.push_back(inheritance.fromId);
+		m_nodeIds.push_back(inheritance.toId);
 	}
-}
+	std::sort(m_nodeIds.begin(), m_nodeIds.end());
+	m_nodeIds.erase(std::unique(m_nodeIds.begin(), m_nodeIds.end()), m_nodeIds.end());
+
+	const size_t nodeCount = m_nodeIds.size();
+	m_parents.assign(nodeCount, s_noIndex);
+	m_edgeIds.assign(nodeCount, 0);
+	m_flags.assign(nodeCount, NODE_VISIBLE);
+	m_childOffsets.assign(nodeCount + 1, 0);
+	m_baseOffsets.assign(nodeCount + 1, 0);
+
+	// later connections override the flags set by earlier ones
+	std::vector<uint32_t> fromIndices;
+	fromIndices.reserve(m_connections.size());
+	for (const Connection& connection: m_connections)
+	{
+		const uint32_t from = getIndex(connection.fromId);
+		const uint32_t to = getIndex(connection.toId);
 
-bool HierarchyCache::HierarchyNode::isVisible() const
-{
-	return m_isVisible;
-}
+		m_parents[to] = from;
+		m_edgeIds[to] = connection.edgeId;
 
-void HierarchyCache::HierarchyNode::setIsVisible(bool isVisible)
-{
-	m_isVisible = isVisible;
-}
+		m_flags[from] = uint8_t(
+			(connection.sourceVisible ? NODE_VISIBLE : 0) |
+			(connection.sourceImplicit ? NODE_IMPLICIT : 0));
+		m_flags[to] = uint8_t(
+			(m_flags[to] & NODE_VISIBLE) | (connection.targetImplicit ? NODE_IMPLICIT : 0));
 
-bool HierarchyCache::HierarchyNode::isImplicit() const
-{
-	return m_isImplicit;
-}
-
-void HierarchyCache::HierarchyNode::setIsImplicit(bool isImplicit)
-{
-	m_isImplicit = isImplicit;
-}
+		m_childOffsets[from + 1]++;
+		fromIndices.push_back(from);
+	}
 
-void HierarchyCache::HierarchyNode::addInheritanceEdgesRecursive(
-	Id startId,
-	std::vector<Id> inheritanceEdgeIds,
-	const std::set<Id>& nodeIds,
-	std::vector<std::tuple<Id, Id, std::vector<Id>>>* inheritanceEdges)
-{
-	for (size_t i = 0; i < m_bases.size(); i++)
+	for (size_t i = 1; i <= nodeCount; i++)
 	{
-		HierarchyNode* base = m_bases[i];
-		Id baseId = base->getNodeId();
+		m_childOffsets[i] += m_childOffsets[i - 1];
+	}
 
-		std::vector<Id> inheritanceEdgeIds2 = inheritanceEdgeIds;
-		inheritanceEdgeIds2.push_back(m_baseEdgeIds[i]);
+	// children keep the order of their connections
+	std::vector<uint32_t> positions(m_childOffsets.begin(), m_childOffsets.end() - 1);
+	m_children.resize(m_connections.size());
+	for (size_t i = 0; i < m_connections.size(); i++)
+	{
+		m_children[positions[fromIndices[i]]++] = getIndex(m_connections[i].toId);
+	}
 
-		if (nodeIds.find(baseId) != nodeIds.end())
+	m_nonImplicitChildCounts.assign(nodeCount, 0);
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		for (uint32_t j = m_childOffsets[i]; j < m_childOffsets[i + 1]; j++)
 		{
-			std::vector<Id> inheritanceEdgeIds3 = inheritanceEdgeIds2;
-
-			inheritanceEdges->push_back(std::make_tuple<Id, Id, std::vector<Id>>(
-				std::forward<Id>(startId),
-				std::forward<Id>(baseId),
-				std::forward<std::vector<Id>>(inheritanceEdgeIds3)));
+			if (!isImplicit(m_children[j]))
+			{
+				m_nonImplicitChildCounts[i]++;
+			}
 		}
+	}
 
-		base->addInheritanceEdgesRecursive(startId, inheritanceEdgeIds2, nodeIds, inheritanceEdges);
+	for (const Inheritance& inheritance: m_inheritances)
+	{
+		m_baseOffsets[getIndex(inheritance.fromId) + 1]++;
+	}
+	for (size_t i = 1; i <= nodeCount; i++)
+	{
+		m_baseOffsets[i] += m_baseOffsets[i - 1];
 	}
-}
 
+	positions.assign(m_baseOffsets.begin(), m_baseOffsets.end() - 1);
+	m_bases.resize(m_inheritances.size());
+	m_baseEdgeIds.resize(m_inheritances.size());
+	for (const Inheritance& inheritance: m_inheritances)
+	{
+		const uint32_t position = positions[getIndex(inheritance.fromId)]++;
+		m_bases[position] = getIndex(inheritance.toId);
+		m_baseEdgeIds[position] = inheritance.edgeId;
+	}
 
-void HierarchyCache::clear()
-{
-	m_nodes.clear();
+	std::vector<Connection>().swap(m_connections);
+	std::vector<Inheritance>().swap(m_inheritances);
 }
 
-void HierarchyCache::createConnection(
-	Id edgeId, Id fromId, Id toId, bool sourceVisible, bool sourceImplicit, bool targetImplicit)
+void HierarchyCache::forEachConnection(const std::function<void(
+											Id edgeId,
+											Id fromId,
+											Id toId,
+											bool sourceVisible,
+											bool sourceImplicit,
+											bool targetImplicit)>& func) const
 {
-	if (fromId == toId)
+	// a node with several parents only keeps the connection that set its parent
+	for (uint32_t index = 0; index < m_nodeIds.size(); index++)
 	{
-		return;
+		for (uint32_t i = m_childOffsets[index]; i < m_childOffsets[index + 1]; i++)
+		{
+			const uint32_t childIndex = m_children[i];
+			if (m_parents[childIndex] == index)
+			{
+				func(
+					m_edgeIds[childIndex],
+					m_nodeIds[index],
+					m_nodeIds[childIndex],
+					isVisible(index),
+					isImplicit(index),
+					isImplicit(childIndex));
+			}
+		}
 	}
-
-	HierarchyNode* from = createNode(fromId);
-	HierarchyNode* to = createNode(toId);
-
-	from->addChild(to);
-	to->setParent(from);
-
-	from->setIsVisible(sourceVisible);
-	from->setIsImplicit(sourceImplicit);
-
-	to->setEdgeId(edgeId);
-	to->setIsImplicit(targetImplicit);
 }
 
-void HierarchyCache::createInheritance(Id edgeId, Id fromId, Id toId)
+void HierarchyCache::forEachInheritance(
+	const std::function<void(Id edgeId, Id fromId, Id toId)>& func) const
 {
-	if (fromId == toId)
+	for (uint32_t index = 0; index < m_nodeIds.size(); index++)
 	{
-		return;
+		for (uint32_t i = m_baseOffsets[index]; i < m_baseOffsets[index + 1]; i++)
+		{
+			func(m_baseEdgeIds[i], m_nodeIds[index], m_nodeIds[m_bases[i]]);
+		}
 	}
-
-	HierarchyNode* from = createNode(fromId);
-	HierarchyNode* to = createNode(toId);
-
-	from->addBase(to, edgeId);
 }
 
 Id HierarchyCache::getLastVisibleParentNodeId(Id nodeId) const
 {
-	HierarchyNode* node = nullptr;
-	HierarchyNode* parent = getNode(nodeId);
-
-	while (parent && parent->isVisible())
+	uint32_t index = getIndex(nodeId);
+	while (index != s_noIndex && isVisible(index))
 	{
-		node = parent;
-		parent = node->getParent();
-
-		nodeId = node->getNodeId();
+		nodeId = m_nodeIds[index];
+		index = m_parents[index];
 	}
 
 	return nodeId;
@@ -198,18 +201,12 @@ Id HierarchyCache::getLastVisibleParentNodeId(Id nodeId) const
 
 size_t HierarchyCache::getIndexOfLastVisibleParentNode(Id nodeId) const
 {
-	HierarchyNode* node = nullptr;
-	HierarchyNode* parent = getNode(nodeId);
-
 	size_t idx = 0;
 	bool visible = false;
 
-	while (parent)
+	for (uint32_t index = getIndex(nodeId); index != s_noIndex; index = m_parents[index])
 	{
-		node = parent;
-		parent = node->getParent();
-
-		if (node->isVisible() && !idx)
+		if (isVisible(index) && !idx)
 		{
 			visible = true;
 		}
@@ -222,120 +219,155 @@ size_t HierarchyCache::getIndexOfLastVisibleParentNode(Id nodeId) const
 	return idx;
 }
 
+Id HierarchyCache::getRootNodeId(Id nodeId) const
+{
+	for (uint32_t index = getIndex(nodeId); index != s_noIndex; index = m_parents[index])
+	{
+		nodeId = m_nodeIds[index];
+	}
+
+	return nodeId;
+}
+
 void HierarchyCache::addAllVisibleParentIdsForNodeId(
 	Id nodeId, std::set<Id>* nodeIds, std::set<Id>* edgeIds) const
 {
-	HierarchyNode* node = getNode(nodeId);
 	Id edgeId = 0;
-	while (node && node->isVisible())
+	for (uint32_t index = getIndex(nodeId); index != s_noIndex && isVisible(index);
+		 index = m_parents[index])
 	{
 		if (edgeId)
 		{
 			edgeIds->insert(edgeId);
 		}
 
-		nodeIds->insert(node->getNodeId());
-		edgeId = node->getEdgeId();
-
-		node = node->getParent();
+		nodeIds->insert(m_nodeIds[index]);
+		edgeId = m_edgeIds[index];
 	}
 }
 
-void HierarchyCache::addAllChildIdsForNodeId(Id nodeId, std::set<Id>* nodeIds, std::set<Id>* edgeIds) const
+void HierarchyCache::addAllChildIdsForNodeId(
+	Id nodeId, std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (node && node->isVisible())
+	const uint32_t index = getIndex(nodeId);
+	if (index == s_noIndex || !isVisible(index))
 	{
-		node->addChildIdsRecursive(nodeIds, edgeIds);
+		return;
 	}
+
+	std::vector<uint32_t> childIndices;
+	std::vector<uint32_t> indicesToProcess = {index};
+	while (indicesToProcess.size())
+	{
+		const uint32_t parentIndex = indicesToProcess.back();
+		indicesToProcess.pop_back();
+
+		for (uint32_t i = m_childOffsets[parentIndex]; i < m_childOffsets[parentIndex + 1]; i++)
+		{
+			childIndices.push_back(m_children[i]);
+			indicesToProcess.push_back(m_children[i]);
+		}
+	}
+
+	// indices follow the order of the ids, so sorting them sorts the node ids as well
+	std::sort(childIndices.begin(), childIndices.end());
+	childIndices.erase(std::unique(childIndices.begin(), childIndices.end()), childIndices.end());
+
+	std::vector<Id> childEdgeIds;
+	childEdgeIds.reserve(childIndices.size());
+	for (uint32_t childIndex: childIndices)
+	{
+		nodeIds->push_back(m_nodeIds[childIndex]);
+		childEdgeIds.push_back(m_edgeIds[childIndex]);
+	}
+
+	std::sort(childEdgeIds.begin(), childEdgeIds.end());
+	childEdgeIds.erase(std::unique(childEdgeIds.begin(), childEdgeIds.end()), childEdgeIds.end());
+	edgeIds->insert(edgeIds->end(), childEdgeIds.begin(), childEdgeIds.end());
 }
 
 void HierarchyCache::addFirstChildIdsForNodeId(
 	Id nodeId, std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (node)
+	const uint32_t index = getIndex(nodeId);
+	if (index == s_noIndex)
 	{
-		if (node->isImplicit())
-		{
-			node->addChildIds(nodeIds, edgeIds);
-		}
-		else
+		return;
+	}
+
+	const bool addImplicitChildren = isImplicit(index);
+	for (uint32_t i = m_childOffsets[index]; i < m_childOffsets[index + 1]; i++)
+	{
+		const uint32_t childIndex = m_children[i];
+		if (addImplicitChildren || !isImplicit(childIndex))
 		{
-			node->addNonImplicitChildIds(nodeIds, edgeIds);
+			nodeIds->push_back(m_nodeIds[childIndex]);
+			edgeIds->push_back(m_edgeIds[childIndex]);
 		}
 	}
 }
 
 size_t HierarchyCache::getFirstChildIdsCountForNodeId(Id nodeId) const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (node)
+	const uint32_t index = getIndex(nodeId);
+	if (index == s_noIndex)
 	{
-		if (node->isImplicit())
-		{
-			return node->getChildrenCount();
-		}
-		else
-		{
-			return node->getNonImplicitChildrenCount();
-		}
+		return 0;
+	}
+
+	if (isImplicit(index))
+	{
+		return m_childOffsets[index + 1] - m_childOffsets[index];
 	}
-	return 0;
+	return m_nonImplicitChildCounts[index];
 }
 
 bool HierarchyCache::isChildOfVisibleNodeOrInvisible(Id nodeId) const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (!node)
+	const uint32_t index = getIndex(nodeId);
+	if (index == s_noIndex)
 	{
 		return false;
 	}
 
-	if (!node->isVisible())
-	{
-		return true;
-	}
-
-	if (node->getParent() && node->getParent()->isVisible())
+	if (!isVisible(index))
 	{
 		return true;
 	}
 
-	return false;
+	return m_parents[index] != s_noIndex && isVisible(m_parents[index]);
 }
 
 bool HierarchyCache::nodeHasChildren(Id nodeId) const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (node)
-	{
-		return node->getChildrenCount();
-	}
-
-	return false;
+	const uint32_t index = getIndex(nodeId);
+	return index != s_noIndex && m_childOffsets[index + 1] > m_childOffsets[index];
 }
 
-bool HierarchyCache::nodeIsVisible(Id nodeId) const
+std::vector<Id> HierarchyCache::getLastVisibleParentIdsOfInvisibleChildren() const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (node)
+	std::vector<Id> nodeIds;
+	for (uint32_t index = 0; index < m_nodeIds.size(); index++)
 	{
-		return node->isVisible();
+		const uint32_t parentIndex = m_parents[index];
+		if (!isVisible(index) && parentIndex != s_noIndex && isVisible(parentIndex))
+		{
+			nodeIds.push_back(getLastVisibleParentNodeId(m_nodeIds[parentIndex]));
+		}
 	}
+	return nodeIds;
+}
 
-	return false;
+bool HierarchyCache::nodeIsVisible(Id nodeId) const
+{
+	const uint32_t index = getIndex(nodeId);
+	return index != s_noIndex && isVisible(index);
 }
 
 bool HierarchyCache::nodeIsImplicit(Id nodeId) const
 {
-	HierarchyNode* node = getNode(nodeId);
-	if (node)
-	{
-		return node->isImplicit();
-	}
-
-	return false;
+	const uint32_t index = getIndex(nodeId);
+	return index != s_noIndex && isImplicit(index);
 }
 
 std::vector<std::tuple<Id, Id, std::vector<Id>>> HierarchyCache::getInheritanceEdgesForNodeId(
@@ -343,37 +375,59 @@ std::vector<std::tuple<Id, Id, std::vector<Id>>> HierarchyCache::getInheritanceE
 {
 	std::vector<std::tuple<Id, Id, std::vector<Id>>> inheritanceEdges;
 
-	HierarchyNode* node = getNode(nodeId);
-	if (node)
+	const uint32_t index = getIndex(nodeId);
+	if (index != s_noIndex)
 	{
 		std::vector<Id> inheritanceEdgeIds;
-		node->addInheritanceEdgesRecursive(
-			node->getNodeId(), inheritanceEdgeIds, nodeIds, &inheritanceEdges);
+		addInheritanceEdgesRecursive(
+			nodeId, index, &inheritanceEdgeIds, nodeIds, &inheritanceEdges);
 	}
 
 	return inheritanceEdges;
 }
 
-HierarchyCache::HierarchyNode* HierarchyCache::getNode(Id nodeId) const
+uint32_t HierarchyCache::getIndex(Id nodeId) const
 {
-	auto it = m_nodes.find(nodeId);
-
-	if (it != m_nodes.end())
+	auto it = std::lower_bound(m_nodeIds.begin(), m_nodeIds.end(), nodeId);
+	if (it == m_nodeIds.end() || *it != nodeId)
 	{
-		return it->second.get();
+		return s_noIndex;
 	}
+	return uint32_t(it - m_nodeIds.begin());
+}
 
-	return nullptr;
+bool HierarchyCache::isVisible(uint32_t index) const
+{
+	return m_flags[index] & NODE_VISIBLE;
 }
 
-HierarchyCache::HierarchyNode* HierarchyCache::createNode(Id nodeId)
+bool HierarchyCache::isImplicit(uint32_t index) const
 {
-	auto it = m_nodes.find(nodeId);
+	return m_flags[index] & NODE_IMPLICIT;
+}
 
-	if (it == m_nodes.end())
+void HierarchyCache::addInheritanceEdgesRecursive(
+	Id startId,
+	uint32_t index,
+	std::vector<Id>* inheritanceEdgeIds,
+	const std::set<Id>& nodeIds,
+	std::vector<std::tuple<Id, Id, std::vector<Id>>>* inheritanceEdges) const
+{
+	for (uint32_t i = m_baseOffsets[index]; i < m_baseOffsets[index + 1]; i++)
 	{
-		it = m_nodes.emplace(nodeId, std::make_unique<HierarchyNode>(nodeId)).first;
-	}
+		const uint32_t baseIndex = m_bases[i];
+		const Id baseId = m_nodeIds[baseIndex];
+
+		inheritanceEdgeIds->push_back(m_baseEdgeIds[i]);
 
-	return it->second.get();
+		if (nodeIds.find(baseId) != nodeIds.end())
+		{
+			inheritanceEdges->emplace_back(startId, baseId, *inheritanceEdgeIds);
+		}
+
+		addInheritanceEdgesRecursive(
+			startId, baseIndex, inheritanceEdgeIds, nodeIds, inheritanceEdges);
+
+		inheritanceEdgeIds->pop_back();
+	}
 }
@@ -1,34 +1,56 @@
 #ifndef HIERARCHY_CACHE_H
 #define HIERARCHY_CACHE_H
 
-#include <map>
-#include <memory>
+#include <cstdint>
+#include <functional>
 #include <set>
+#include <tuple>
 #include <vector>
 
 #include "types.h"
 
+// Member and inheritance hierarchy of all nodes. Nodes are referred to by their index within the
+// sorted node ids, the children and bases of all nodes are packed into single arrays with an offset
+// range per node. All connections are collected first and only become visible after finishSetup.
 class HierarchyCache
 {
 public:
 	void clear();
+	size_t getByteSize() const;
 
 	void createConnection(
 		Id edgeId, Id fromId, Id toId, bool sourceVisible, bool sourceImplicit, bool targetImplicit);
 	void createInheritance(Id edgeId, Id fromId, Id toId);
+	void finishSetup();
+
+	// the connections and inheritances of finished setup, ordered like they were created
+	void forEachConnection(const std::function<void(
+							   Id edgeId,
+							   Id fromId,
+							   Id toId,
+							   bool sourceVisible,
+							   bool sourceImplicit,
+							   bool targetImplicit)>& func) const;
+	void forEachInheritance(const std::function<void(Id edgeId, Id fromId, Id toId)>& func) const;
 
 	Id getLastVisibleParentNodeId(Id nodeId) const;
 	size_t getIndexOfLastVisibleParentNode(Id nodeId) const;
+	// the outermost parent, visible or not, or the node itself if it has no parent
+	Id getRootNodeId(Id nodeId) const;
 
 	void addAllVisibleParentIdsForNodeId(Id nodeId, std::set<Id>* nodeIds, std::set<Id>* edgeIds) const;
 
-	void addAllChildIdsForNodeId(Id nodeId, std::set<Id>* nodeIds, std::set<Id>* edgeIds) const;
+	// appends sorted unique ids of all children, grandchildren and so on
+	void addAllChildIdsForNodeId(Id nodeId, std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const;
 	void addFirstChildIdsForNodeId(Id nodeId, std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const;
 
 	size_t getFirstChildIdsCountForNodeId(Id nodeId) const;
 
 	bool isChildOfVisibleNodeOrInvisible(Id nodeId) const;
 
+	// last visible parents of the nodes that are not visible but have a visible parent
+	std::vector<Id> getLastVisibleParentIdsOfInvisibleChildren() const;
+
 	bool nodeHasChildren(Id nodeId) const;
 	bool nodeIsVisible(Id nodeId) const;
 	bool nodeIsImplicit(Id nodeId) const;
@@ -37,61 +59,58 @@ public:
 		Id nodeId, const std::set<Id>& nodeIds) const;
 
 private:
-	class HierarchyNode
+	enum NodeFlag : uint8_t
 	{
-	public:
-		HierarchyNode(Id nodeId);
-
-		Id getNodeId() const;
-
-		Id getEdgeId() const;
-		void setEdgeId(Id edgeId);
-
-		HierarchyNode* getParent() const;
-		void setParent(HierarchyNode* parent);
-
-		void addBase(HierarchyNode* base, Id edgeId);
-
-		void addChild(HierarchyNode* child);
-
-		size_t getChildrenCount() const;
-		size_t getNonImplicitChildrenCount() const;
-
-		void addChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const;
-		void addNonImplicitChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const;
-		void addChildIdsRecursive(std::set<Id>* nodeIds, std::set<Id>* edgeIds) const;
+		NODE_VISIBLE = 1 << 0,
+		NODE_IMPLICIT = 1 << 1
+	};
 
-		bool isVisible() const;
-		void setIsVisible(bool isVisible);
+	struct Connection
+	{
+		Id edgeId;
+		Id fromId;
+		Id toId;
+		bool sourceVisible;
+		bool sourceImplicit;
+		bool targetImplicit;
+	};
 
-		bool isImplicit() const;
-		void setIsImplicit(bool isImplicit);
+	struct Inheritance
+	{
+		Id edgeId;
+		Id fromId;
+		Id toId;
+	};
 
-		void addInheritanceEdgesRecursive(
-			Id startId,
-			std::vector<Id> inheritanceEdgeIds,
-			const std::set<Id>& nodeIds,
-			std::vector<std::tuple<Id, Id, std::vector<Id>>>* inheritanceEdges);
+	static const uint32_t s_noIndex;
 
-	private:
-		const Id m_nodeId;
-		Id m_edgeId;
+	uint32_t getIndex(Id nodeId) const;	   // s_noIndex if unknown
 
-		HierarchyNode* m_parent;
+	bool isVisible(uint32_t index) const;
+	bool isImplicit(uint32_t index) const;
 
-		std::vector<HierarchyNode*> m_bases;
-		std::vector<Id> m_baseEdgeIds;
+	void addInheritanceEdgesRecursive(
+		Id startId,
+		uint32_t index,
+		std::vector<Id>* inheritanceEdgeIds,
+		const std::set<Id>& nodeIds,
+		std::vector<std::tuple<Id, Id, std::vector<Id>>>* inheritanceEdges) const;
 
-		std::vector<HierarchyNode*> m_children;
+	std::vector<Connection> m_connections;
+	std::vector<Inheritance> m_inheritances;
 
-		bool m_isVisible;
-		bool m_isImplicit;
-	};
+	std::vector<Id> m_nodeIds;
+	std::vector<uint32_t> m_parents;
+	std::vector<Id> m_edgeIds;	  // edge from the parent
+	std::vector<uint8_t> m_flags;
 
-	HierarchyNode* getNode(Id nodeId) const;
-	HierarchyNode* createNode(Id nodeId);
+	std::vector<uint32_t> m_childOffsets;	 // node count + 1 entries
+	std::vector<uint32_t> m_children;
+	std::vector<uint32_t> m_nonImplicitChildCounts;
 
-	std::map<Id, std::unique_ptr<HierarchyNode>> m_nodes;
+	std::vector<uint32_t> m_baseOffsets;	// node count + 1 entries
+	std::vector<uint32_t> m_bases;
+	std::vector<Id> m_baseEdgeIds;
 };
 
 #endif	  // HIERARCHY_CACHE_H
@@ -0,0 +1,303 @@
+#include "IndexReplica.h"
+
+#include <algorithm>
+
+#include "MemoryUsage.h"
+
+void IndexReplica::clear()
+{
+	*this = IndexReplica();
+}
+
+bool IndexReplica::isEmpty() const
+{
+	return m_nodeIds.empty() && m_locationIds.empty();
+}
+
+size_t IndexReplica::getByteSize() const
+{
+	size_t byteSize = utility::getByteSize(m_nodeIds) + utility::getByteSize(m_nodeTypes) +
+		utility::getByteSize(m_nodeNameOffsets) + m_nodeNames.capacity();
+	byteSize += utility::getByteSize(m_locationIds) + utility::getByteSize(m_locationFileIndices) +
+		utility::getByteSize(m_locationTypes);
+	for (const std::vector<uint32_t>* column:
+		 {&m_startLines, &m_startColumns, &m_endLines, &m_endColumns})
+	{
+		byteSize += utility::getByteSize(*column);
+	}
+	byteSize += utility::getByteSize(m_fileIds) + utility::getByteSize(m_fileOffsets) +
+		utility::getByteSize(m_fileLocationIndices);
+	byteSize += utility::getByteSize(m_locationOccurrenceOffsets) +
+		utility::getByteSize(m_locationElementIds) + utility::getByteSize(m_elementIds) +
+		utility::getByteSize(m_elementOffsets) + utility::getByteSize(m_elementLocationIds);
+	return byteSize;
+}
+
+void IndexReplica::build(
+	std::vector<StorageNode> nodes,
+	std::vector<StorageSourceLocation> sourceLocations,
+	std::vector<StorageOccurrence> occurrences)
+{
+	clear();
+
+	std::sort(nodes.begin(), nodes.end(), [](const StorageNode& a, const StorageNode& b) {
+		return a.id < b.id;
+	});
+	m_nodeIds.reserve(nodes.size());
+	m_nodeTypes.reserve(nodes.size());
+	m_nodeNameOffsets.reserve(nodes.size() + 1);
+	m_nodeNameOffsets.push_back(0);
+	for (const StorageNode& node: nodes)
+	{
+		m_nodeIds.push_back(uint64_t(node.id));
+		m_nodeTypes.push_back(int32_t(node.type));
+		m_nodeNames += node.serializedName;
+		m_nodeNameOffsets.push_back(uint64_t(m_nodeNames.size()));
+	}
+	nodes.clear();
+	m_nodeNames.shrink_to_fit();
+
+	std::sort(
+		sourceLocations.begin(),
+		sourceLocations.end(),
+		[](const StorageSourceLocation& a, const StorageSourceLocation& b) { return a.id < b.id; });
+	for (const StorageSourceLocation& location: sourceLocations)
+	{
+		m_fileIds.push_back(uint64_t(location.fileNodeId));
+	}
+	std::sort(m_fileIds.begin(), m_fileIds.end());
+	m_fileIds.erase(std::unique(m_fileIds.begin(), m_fileIds.end()), m_fileIds.end());
+
+	const size_t locationCount = sourceLocations.size();
+	m_locationIds.reserve(locationCount);
+	m_locationFileIndices.reserve(locationCount);
+	m_startLines.reserve(locationCount);
+	m_startColumns.reserve(locationCount);
+	m_endLines.reserve(locationCount);
+	m_endColumns.reserve(locationCount);
+	m_locationTypes.reserve(locationCount);
+	m_fileOffsets.assign(m_fileIds.size() + 1, 0);
+	for (const StorageSourceLocation& location: sourceLocations)
+	{
+		const uint32_t fileIndex = uint32_t(getIndex(m_fileIds, location.fileNodeId));
+		m_locationIds.push_back(uint64_t(location.id));
+		m_locationFileIndices.push_back(fileIndex);
+		m_startLines.push_back(uint32_t(location.startLine));
+		m_startColumns.push_back(uint32_t(location.startCol));
+		m_endLines.push_back(uint32_t(location.endLine));
+		m_endColumns.push_back(uint32_t(location.endCol));
+		m_locationTypes.push_back(uint8_t(location.type));
+		m_fileOffsets[fileIndex + 1]++;
+	}
+	sourceLocations.clear();
+
+	// rows of files are filled in order of the location ids, which keeps each of them sorted
+	for (size_t i = 1; i < m_fileOffsets.size(); i++)
+	{
+		m_fileOffsets[i] += m_fileOffsets[i - 1];
+	}
+	m_fileLocationIndices.resize(locationCount);
+	{
+		std::vector<uint32_t> nextIndices(m_fileOffsets.begin(), m_fileOffsets.end() - 1);
+		for (uint32_t i = 0; i < locationCount; i++)
+		{
+			m_fileLocationIndices[nextIndices[m_locationFileIndices[i]]++] = i;
+		}
+	}
+
+	std::sort(
+		occurrences.begin(),
+		occurrences.end(),
+		[](const StorageOccurrence& a, const StorageOccurrence& b) {
+			if (a.sourceLocationId != b.sourceLocationId)
+			{
+				return a.sourceLocationId < b.sourceLocationId;
+			}
+			return a.elementId < b.elementId;
+		});
+	occurrences.erase(
+		std::unique(
+			occurrences.begin(),
+			occurrences.end(),
+			[](const StorageOccurrence& a, const StorageOccurrence& b) {
+				return a.sourceLocationId == b.sourceLocationId && a.elementId == b.elementId;
+			}),
+		occurrences.end());
+
+	m_locationOccurrenceOffsets.assign(locationCount + 1, 0);
+	m_locationElementIds.reserve(occurrences.size());
+	for (const StorageOccurrence& occurrence: occurrences)
+	{
+		const size_t locationIndex = getIndex(m_locationIds, occurrence.sourceLocationId);
+		if (locationIndex != locationCount)
+		{
+			m_locationElementIds.push_back(uint64_t(occurrence.elementId));
+			m_locationOccurrenceOffsets[locationIndex + 1]++;
+		}
+	}
+	for (size_t i = 1; i < m_locationOccurrenceOffsets.size(); i++)
+	{
+		m_locationOccurrenceOffsets[i] += m_locationOccurrenceOffsets[i - 1];
+	}
+
+	std::sort(occurrences.begin(), occurrences.end());
+	m_elementOffsets.push_back(0);
+	m_elementLocationIds.reserve(occurrences.size());
+	for (const StorageOccurrence& occurrence: occurrences)
+	{
+		if (m_elementIds.empty() || m_elementIds.back() != uint64_t(occurrence.elementId))
+		{
+			m_elementIds.push_back(uint64_t(occurrence.elementId));
+			m_elementOffsets.push_back(m_elementOffsets.back());
+		}
+		m_elementLocationIds.push_back(uint64_t(occurrence.sourceLocationId));
+		m_elementOffsets.back()++;
+	}
+}
+
+bool IndexReplica::getNodeById(Id nodeId, StorageNode* node) const
+{
+	const size_t index = getIndex(m_nodeIds, nodeId);
+	if (index == m_nodeIds.size())
+	{
+		return false;
+	}
+
+	*node = StorageNode(
+		nodeId,
+		int(m_nodeTypes[index]),
+		m_nodeNames.substr(
+			size_t(m_nodeNameOffsets[index]),
+			size_t(m_nodeNameOffsets[index + 1] - m_nodeNameOffsets[index])));
+	return true;
+}
+
+std::vector<StorageNode> IndexReplica::getNodesByIds(const std::vector<Id>& nodeIds) const
+{
+	std::vector<StorageNode> nodes;
+	StorageNode node;
+	for (Id nodeId: getSortedIds(nodeIds))
+	{
+		if (getNodeById(nodeId, &node))
+		{
+			nodes.push_back(std::move(node));
+		}
+	}
+	return nodes;
+}
+
+bool IndexReplica::getSourceLocationById(Id locationId, StorageSourceLocation* location) const
+{
+	const size_t index = getIndex(m_locationIds, locationId);
+	if (index == m_locationIds.size())
+	{
+		return false;
+	}
+
+	*location = getSourceLocation(index);
+	return true;
+}
+
+std::vector<StorageSourceLocation> IndexReplica::getSourceLocationsByIds(
+	const std::vector<Id>& locationIds) const
+{
+	std::vector<StorageSourceLocation> locations;
+	for (Id locationId: getSortedIds(locationIds))
+	{
+		const size_t index = getIndex(m_locationIds, locationId);
+		if (index != m_locationIds.size())
+		{
+			locations.push_back(getSourceLocation(index));
+		}
+	}
+	return locations;
+}
+
+std::vector<StorageSourceLocation> IndexReplica::getSourceLocationsForFileId(Id fileId) const
+{
+	std::vector<StorageSourceLocation> locations;
+	const size_t fileIndex = getIndex(m_fileIds, fileId);
+	if (fileIndex == m_fileIds.size())
+	{
+		return locations;
+	}
+
+	locations.reserve(m_fileOffsets[fileIndex + 1] - m_fileOffsets[fileIndex]);
+	for (uint32_t i = m_fileOffsets[fileIndex]; i < m_fileOffsets[fileIndex + 1]; i++)
+	{
+		locations.push_back(getSourceLocation(m_fileLocationIndices[i]));
+	}
+	return locations;
+}
+
+std::vector<StorageOccurrence> IndexReplica::getOccurrencesForElementIds(
+	const std::vector<Id>& elementIds) const
+{
+	std::vector<StorageOccurrence> occurrences;
+	for (Id elementId: getSortedIds(elementIds))
+	{
+		const size_t index = getIndex(m_elementIds, elementId);
+		if (index == m_elementIds.size())
+		{
+			continue;
+		}
+
+		for (uint32_t i = m_elementOffsets[index]; i < m_elementOffsets[index + 1]; i++)
+		{
+			occurrences.emplace_back(elementId, Id(m_elementLocationIds[i]));
+		}
+	}
+	return occurrences;
+}
+
+std::vector<StorageOccurrence> IndexReplica::getOccurrencesForLocationIds(
+	const std::vector<Id>& locationIds) const
+{
+	std::vector<StorageOccurrence> occurrences;
+	for (Id locationId: getSortedIds(locationIds))
+	{
+		const size_t index = getIndex(m_locationIds, locationId);
+		if (index == m_locationIds.size())
+		{
+			continue;
+		}
+
+		for (uint32_t i = m_locationOccurrenceOffsets[index];
+			 i < m_locationOccurrenceOffsets[index + 1];
+			 i++)
+		{
+			occurrences.emplace_back(Id(m_locationElementIds[i]), locationId);
+		}
+	}
+	return occurrences;
+}
+
+std::vector<Id> IndexReplica::getSortedIds(const std::vector<Id>& ids)
+{
+	std::vector<Id> sortedIds = ids;
+	std::sort(sortedIds.begin(), sortedIds.end());
+	sortedIds.erase(std::unique(sortedIds.begin(), sortedIds.end()), sortedIds.end());
+	return sortedIds;
+}
+
+size_t IndexReplica::getIndex(const std::vector<uint64_t>& ids, Id id)
+{
+	auto it = std::lower_bound(ids.begin(), ids.end(), uint64_t(id));
+	if (it == ids.end() || *it != uint64_t(id))
+	{
+		return ids.size();
+	}
+	return size_t(it - ids.begin());
+}
+
+StorageSourceLocation IndexReplica::getSourceLocation(size_t index) const
+{
+	return StorageSourceLocation(
+		Id(m_locationIds[index]),
+		Id(m_fileIds[m_locationFileIndices[index]]),
+		m_startLines[index],
+		m_startColumns[index],
+		m_endLines[index],
+		m_endColumns[index],
+		int(m_locationTypes[index]));
+}
@@ -0,0 +1,74 @@
+#ifndef INDEX_REPLICA_H
+#define INDEX_REPLICA_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StorageNode.h"
+#include "StorageOccurrence.h"
+#include "StorageSourceLocation.h"
+#include "types.h"
+
+// Copy of the node, source_location and occurrence tables of the index in sorted columns, so
+// browsing reads them without going through SQLite. Rows are found by binary search on their ids,
+// the locations of a file and the occurrences of an element or of a location are contiguous. The
+// edges are not part of it, the AdjacencyCache keeps them already.
+class IndexReplica
+{
+public:
+	void clear();
+	bool isEmpty() const;
+	size_t getByteSize() const;
+
+	void build(
+		std::vector<StorageNode> nodes,
+		std::vector<StorageSourceLocation> sourceLocations,
+		std::vector<StorageOccurrence> occurrences);
+
+	// unknown ids are skipped, results are ordered by id
+	bool getNodeById(Id nodeId, StorageNode* node) const;
+	std::vector<StorageNode> getNodesByIds(const std::vector<Id>& nodeIds) const;
+
+	bool getSourceLocationById(Id locationId, StorageSourceLocation* location) const;
+	std::vector<StorageSourceLocation> getSourceLocationsByIds(
+		const std::vector<Id>& locationIds) const;
+	std::vector<StorageSourceLocation> getSourceLocationsForFileId(Id fileId) const;
+
+	std::vector<StorageOccurrence> getOccurrencesForElementIds(
+		const std::vector<Id>& elementIds) const;
+	std::vector<StorageOccurrence> getOccurrencesForLocationIds(
+		const std::vector<Id>& locationIds) const;
+
+private:
+	static std::vector<Id> getSortedIds(const std::vector<Id>& ids);
+	static size_t getIndex(const std::vector<uint64_t>& ids, Id id);	// ids size if unknown
+
+	StorageSourceLocation getSourceLocation(size_t index) const;
+
+	std::vector<uint64_t> m_nodeIds;
+	std::vector<int32_t> m_nodeTypes;
+	std::vector<uint64_t> m_nodeNameOffsets;	// node count + 1 entries
+	std::string m_nodeNames;
+
+	std::vector<uint64_t> m_locationIds;
+	std::vector<uint32_t> m_locationFileIndices;
+	std::vector<uint32_t> m_startLines;
+	std::vector<uint32_t> m_startColumns;
+	std::vector<uint32_t> m_endLines;
+	std::vector<uint32_t> m_endColumns;
+	std::vector<uint8_t> m_locationTypes;
+
+	std::vector<uint64_t> m_fileIds;
+	std::vector<uint32_t> m_fileOffsets;	// file count + 1 entries
+	std::vector<uint32_t> m_fileLocationIndices;
+
+	std::vector<uint32_t> m_locationOccurrenceOffsets;	  // location count + 1 entries
+	std::vector<uint64_t> m_locationElementIds;
+
+	std::vector<uint64_t> m_elementIds;
+	std::vector<uint32_t> m_elementOffsets;	   // element count + 1 entries
+	std::vector<uint64_t> m_elementLocationIds;
+};
+
+#endif	  // INDEX_REPLICA_H
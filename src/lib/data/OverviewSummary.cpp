@@ -0,0 +1,132 @@
+#include "OverviewSummary.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "AdjacencyCache.h"
+#include "HierarchyCache.h"
+#include "MemoryUsage.h"
+
+void OverviewSummary::clear()
+{
+	m_isBuilt = false;
+	m_nodeIds.clear();
+	m_nodeTypes.clear();
+	m_edges.clear();
+}
+
+bool OverviewSummary::isEmpty() const
+{
+	return !m_isBuilt;
+}
+
+size_t OverviewSummary::getByteSize() const
+{
+	return utility::getByteSize(m_nodeIds) + utility::getByteSize(m_nodeTypes) +
+		utility::getByteSize(m_edges);
+}
+
+void OverviewSummary::build(
+	const AdjacencyCache& adjacencyCache,
+	const HierarchyCache& hierarchyCache,
+	const std::function<bool(Id nodeId, NodeType type)>& isOverviewNode)
+{
+	clear();
+
+	// the nodes arrive ordered by id
+	adjacencyCache.forEachNode([&](Id nodeId, int type) {
+		const NodeType nodeType(NodeType::intToType(type));
+		if (isOverviewNode(nodeId, nodeType))
+		{
+			m_nodeIds.push_back(nodeId);
+			m_nodeTypes.push_back(type);
+		}
+	});
+
+	std::vector<SummaryEdge> edges;
+	adjacencyCache.forEachEdge([&](const StorageEdge& edge) {
+		if (Edge::intToType(edge.type) == Edge::EDGE_MEMBER)
+		{
+			return;
+		}
+
+		const Id sourceId = hierarchyCache.getRootNodeId(edge.sourceNodeId);
+		const Id targetId = hierarchyCache.getRootNodeId(edge.targetNodeId);
+		if (sourceId != targetId && containsNode(sourceId) && containsNode(targetId))
+		{
+			edges.push_back({sourceId, targetId, 1});
+		}
+	});
+
+	std::sort(edges.begin(), edges.end(), [](const SummaryEdge& a, const SummaryEdge& b) {
+		return std::tie(a.sourceId, a.targetId) < std::tie(b.sourceId, b.targetId);
+	});
+	for (const SummaryEdge& edge: edges)
+	{
+		if (m_edges.empty() || m_edges.back().sourceId != edge.sourceId ||
+			m_edges.back().targetId != edge.targetId)
+		{
+			m_edges.push_back(edge);
+		}
+		else
+		{
+			m_edges.back().weight++;
+		}
+	}
+
+	m_isBuilt = true;
+}
+
+std::map<NodeType::Type, size_t> OverviewSummary::getNodeCounts() const
+{
+	std::map<NodeType::Type, size_t> counts;
+	for (int32_t type: m_nodeTypes)
+	{
+		counts[NodeType::intToType(type)]++;
+	}
+	return counts;
+}
+
+std::vector<Id> OverviewSummary::getNodeIds() const
+{
+	return std::vector<Id>(m_nodeIds.begin(), m_nodeIds.end());
+}
+
+std::vector<Id> OverviewSummary::getNodeIdsOfType(NodeType::Type type) const
+{
+	std::vector<Id> nodeIds;
+	for (size_t i = 0; i < m_nodeIds.size(); i++)
+	{
+		if (NodeType::intToType(m_nodeTypes[i]) == type)
+		{
+			nodeIds.push_back(m_nodeIds[i]);
+		}
+	}
+	return nodeIds;
+}
+
+const std::vector<OverviewSummary::SummaryEdge>& OverviewSummary::getEdges() const
+{
+	return m_edges;
+}
+
+uint32_t OverviewSummary::getEdgeWeight(Id sourceId, Id targetId) const
+{
+	auto it = std::lower_bound(
+		m_edges.begin(),
+		m_edges.end(),
+		std::make_tuple(uint64_t(sourceId), uint64_t(targetId)),
+		[](const SummaryEdge& edge, const std::tuple<uint64_t, uint64_t>& key) {
+			return std::tie(edge.sourceId, edge.targetId) < key;
+		});
+	if (it == m_edges.end() || it->sourceId != sourceId || it->targetId != targetId)
+	{
+		return 0;
+	}
+	return it->weight;
+}
+
+bool OverviewSummary::containsNode(Id nodeId) const
+{
+	return std::binary_search(m_nodeIds.begin(), m_nodeIds.end(), uint64_t(nodeId));
+}
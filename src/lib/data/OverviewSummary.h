@@ -0,0 +1,55 @@
+#ifndef OVERVIEW_SUMMARY_H
+#define OVERVIEW_SUMMARY_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "NodeType.h"
+#include "types.h"
+
+class AdjacencyCache;
+class HierarchyCache;
+
+// The nodes shown by the overview of all symbols together with the number of edges between the
+// hierarchies of the outermost ones, e.g. between two top level namespaces or two files. Built
+// from the other caches once the storage is indexed, so the overview only needs to know how many
+// nodes of each type there are and loads the nodes of one type when their bundle is opened.
+class OverviewSummary
+{
+public:
+	struct SummaryEdge
+	{
+		uint64_t sourceId;
+		uint64_t targetId;
+		uint32_t weight;	// number of edges between the children, grandchildren and so on
+	};
+
+	void clear();
+	bool isEmpty() const;
+	size_t getByteSize() const;
+
+	void build(
+		const AdjacencyCache& adjacencyCache,
+		const HierarchyCache& hierarchyCache,
+		const std::function<bool(Id nodeId, NodeType type)>& isOverviewNode);
+
+	std::map<NodeType::Type, size_t> getNodeCounts() const;
+	std::vector<Id> getNodeIds() const;
+	std::vector<Id> getNodeIdsOfType(NodeType::Type type) const;
+
+	// ordered by source and target, edges of the member hierarchy are not counted
+	const std::vector<SummaryEdge>& getEdges() const;
+	uint32_t getEdgeWeight(Id sourceId, Id targetId) const;
+
+private:
+	bool containsNode(Id nodeId) const;
+
+	bool m_isBuilt = false;
+	std::vector<uint64_t> m_nodeIds;	// sorted
+	std::vector<int32_t> m_nodeTypes;
+	std::vector<SummaryEdge> m_edges;
+};
+
+#endif	  // OVERVIEW_SUMMARY_H
@@ -1,5 +1,8 @@
 #include "TaskFinishParsing.h"
 
+#include <algorithm>
+#include <map>
+
 #include "Blackboard.h"
 #include "DialogView.h"
 #include "MessageIndexingFinished.h"
@@ -10,8 +13,10 @@
 #include "utilityString.h"
 
 TaskFinishParsing::TaskFinishParsing(
-	std::shared_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView)
-	: m_storage(storage), m_dialogView(dialogView)
+	std::shared_ptr<PersistentStorage> storage,
+	std::shared_ptr<DialogView> dialogView,
+	bool canonicalizeIds)
+	: m_storage(storage), m_dialogView(dialogView), m_canonicalizeIds(canonicalizeIds)
 {
 }
 
@@ -25,6 +30,14 @@ void TaskFinishParsing::terminate()
 
 void TaskFinishParsing::doEnter(std::shared_ptr<Blackboard> blackboard)
 {
+	// once all storages are injected and before the read mode derives data from the ids, the
+	// vacuum of doUpdate then writes the rows in the order of their ids
+	if (m_canonicalizeIds)
+	{
+		m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Assigning stable ids");
+		m_storage->canonicalizeIds();
+	}
+
 	m_storage->setMode(SqliteIndexStorage::STORAGE_MODE_READ);
 }
 
@@ -32,8 +45,14 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 {
 	TimeStamp start = TimeStamp::now();
 
+	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building fulltext search index");
+	m_storage->updateFullTextSearchIndex();
+	m_storage->clearSearchIndexData();
+
 	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Optimizing database");
 	m_storage->optimizeMemory();
+	// the database file gets swapped in after indexing, so nothing may be left in its wal
+	m_storage->checkpoint();
 	m_dialogView->hideUnknownProgressDialog();
 
 	float time = TimeStamp::durationSeconds(start);
@@ -52,6 +71,23 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 		time += indexTime;
 	}
 
+	// kept in the index for benchmarks, merging and injecting overlap with parsing
+	std::map<std::string, float> phaseDurations = {{"finish", TimeStamp::durationSeconds(start)}};
+	const std::vector<std::pair<std::string, std::string>> phaseKeys = {
+		{"clear", "clear_time"},
+		{"parse", "index_time"},
+		{"merge", "merge_time"},
+		{"inject", "inject_time"}};
+	for (const std::pair<std::string, std::string>& phaseKey: phaseKeys)
+	{
+		float duration = 0;
+		if (blackboard->exists(phaseKey.second) && blackboard->get(phaseKey.second, duration))
+		{
+			phaseDurations[phaseKey.first] = duration;
+		}
+	}
+	m_storage->setIndexingPhaseDurations(phaseDurations);
+
 	int indexedSourceFileCount = 0;
 	blackboard->get("indexed_source_file_count", indexedSourceFileCount);
 
@@ -79,6 +115,17 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 	}
 	MessageStatus(status, false, false).dispatch();
 
+	std::vector<StorageIndexingTime> slowestFiles = m_storage->getIndexingTimes();
+	const size_t slowestFileCount = std::min<size_t>(slowestFiles.size(), 5);
+	std::partial_sort(
+		slowestFiles.begin(),
+		slowestFiles.begin() + slowestFileCount,
+		slowestFiles.end(),
+		[](const StorageIndexingTime& a, const StorageIndexingTime& b) {
+			return a.durationMs > b.durationMs;
+		});
+	slowestFiles.resize(slowestFileCount);
+
 	StorageStats stats = m_storage->getStorageStats();
 	DatabasePolicy policy = m_dialogView->finishedIndexingDialog(
 		indexedSourceFileCount,
@@ -88,7 +135,8 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 		time,
 		errorInfo,
 		interruptedIndexing,
-		shallowIndexing);
+		shallowIndexing,
+		slowestFiles);
 
 	MessageIndexingStatus(false).dispatch();
 
@@ -13,7 +13,10 @@ class StorageAccess;
 class TaskFinishParsing: public Task
 {
 public:
-	TaskFinishParsing(std::shared_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView);
+	TaskFinishParsing(
+		std::shared_ptr<PersistentStorage> storage,
+		std::shared_ptr<DialogView> dialogView,
+		bool canonicalizeIds = false);
 
 	void terminate() override;
 
@@ -25,6 +28,7 @@ private:
 
 	std::shared_ptr<PersistentStorage> m_storage;
 	std::shared_ptr<DialogView> m_dialogView;
+	const bool m_canonicalizeIds;
 };
 
 #endif	  // TASK_FINISH_PARSING_H
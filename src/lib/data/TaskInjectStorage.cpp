@@ -1,31 +1,105 @@
 #include "TaskInjectStorage.h"
 
+#include "Blackboard.h"
+#include "IndexingCheckpoint.h"
+#include "IndexingThrottle.h"
+#include "MetricsRegistry.h"
 #include "Storage.h"
 #include "StorageProvider.h"
 
+// storages that are injected in quick succession share one transaction, which is committed once
+// no storage is waiting or the group took longer than this
+const size_t TaskInjectStorage::s_maxInjectionGroupDurationMs = 1000;
+
 TaskInjectStorage::TaskInjectStorage(
-	std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target)
-	: m_storageProvider(storageProvider), m_target(target)
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::weak_ptr<Storage> target,
+	std::shared_ptr<Storage> deltaTarget,
+	std::shared_ptr<IndexingCheckpoint> checkpoint,
+	bool yieldsToUser)
+	: m_storageProvider(storageProvider)
+	, m_target(target)
+	, m_deltaTarget(deltaTarget)
+	, m_checkpoint(checkpoint)
+	, m_yieldsToUser(yieldsToUser)
+	, m_injectionGroupStarted(false)
+{
+}
+
+TaskInjectStorage::~TaskInjectStorage()
 {
+	finishInjectionGroup(m_target.lock());
 }
 
 void TaskInjectStorage::doEnter(std::shared_ptr<Blackboard> blackboard) {}
 
 Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
-	if (m_storageProvider->getStorageCount() > 0)
+	std::shared_ptr<Storage> target = m_target.lock();
+	if (target && m_storageProvider->getStorageCount() > 0)
 	{
+		if (m_yieldsToUser && !IndexingThrottle::getInstance()->canInject())
+		{
+			// committing releases the index while the user browses
+			finishInjectionGroup(target);
+			return STATE_FAILURE;
+		}
+
 		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeLargestStorage();
 		if (source)
 		{
-			if (std::shared_ptr<Storage> target = m_target.lock())
+			if (!m_injectionGroupStarted)
+			{
+				target->startInjectionGroup();
+				if (m_deltaTarget)
+				{
+					m_deltaTarget->startInjectionGroup();
+				}
+				m_injectionGroupStarted = true;
+				m_injectionGroupStart = TimeStamp::now();
+			}
+
+			const TimeStamp injectionStart = TimeStamp::now();
+			target->inject(source.get());
+			if (m_deltaTarget)
+			{
+				m_deltaTarget->inject(source.get());
+			}
+			if (m_checkpoint)
+			{
+				for (const StorageIndexingTime& indexingTime: source->getIndexingTimes())
+				{
+					m_injectedSourceFilePaths.push_back(FilePath(indexingTime.filePath));
+				}
+			}
+			const float duration = TimeStamp::durationSeconds(injectionStart);
+			static MetricHistogram& injectDurationHistogram =
+				MetricsRegistry::getInstance()->getHistogram(
+					"sourcetrail_indexing_inject_duration_seconds",
+					"Duration of injecting a storage into the index");
+			static MetricGauge& queuedStorageGauge = MetricsRegistry::getInstance()->getGauge(
+				"sourcetrail_indexing_queued_storages",
+				"Indexed storages waiting to be merged or injected");
+			injectDurationHistogram.observe(duration);
+			if (m_yieldsToUser)
+			{
+				IndexingThrottle::getInstance()->addInjectionDuration(size_t(duration * 1000));
+			}
+			queuedStorageGauge.set(double(m_storageProvider->getStorageCount()));
+
+			blackboard->update<float>(
+				"inject_time",
+				[duration](float currentDuration) { return currentDuration + duration; });
+
+			if (TimeStamp::now().deltaMS(m_injectionGroupStart) >= s_maxInjectionGroupDurationMs)
 			{
-				target->inject(source.get());
-				return STATE_SUCCESS;
+				finishInjectionGroup(target);
 			}
+			return STATE_SUCCESS;
 		}
 	}
 
+	finishInjectionGroup(target);
 	return STATE_FAILURE;
 }
 
@@ -37,3 +111,25 @@ void TaskInjectStorage::handleMessage(MessageIndexingInterrupted* message)
 {
 	m_storageProvider->clear();
 }
+
+void TaskInjectStorage::finishInjectionGroup(std::shared_ptr<Storage> target)
+{
+	if (m_injectionGroupStarted)
+	{
+		if (target)
+		{
+			target->finishInjectionGroup();
+		}
+		if (m_deltaTarget)
+		{
+			m_deltaTarget->finishInjectionGroup();
+		}
+		m_injectionGroupStarted = false;
+
+		if (m_checkpoint && target)
+		{
+			m_checkpoint->addCompletedSourceFilePaths(m_injectedSourceFilePaths);
+		}
+		m_injectedSourceFilePaths.clear();
+	}
+}
@@ -3,10 +3,13 @@
 
 #include <vector>
 
+#include "FilePath.h"
 #include "MessageIndexingInterrupted.h"
 #include "MessageListener.h"
 #include "Task.h"
+#include "TimeStamp.h"
 
+class IndexingCheckpoint;
 class Storage;
 class StorageProvider;
 
@@ -15,9 +18,20 @@ class TaskInjectStorage
 	, public MessageListener<MessageIndexingInterrupted>
 {
 public:
-	TaskInjectStorage(std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target);
+	// the delta target receives all storages injected into the target as well, the checkpoint gets
+	// the source files of the injected storages once they are committed. A task that yields to the
+	// user fails without injecting while the IndexingThrottle asks for it.
+	TaskInjectStorage(
+		std::shared_ptr<StorageProvider> storageProvider,
+		std::weak_ptr<Storage> target,
+		std::shared_ptr<Storage> deltaTarget = nullptr,
+		std::shared_ptr<IndexingCheckpoint> checkpoint = nullptr,
+		bool yieldsToUser = false);
+	~TaskInjectStorage() override;
 
 private:
+	static const size_t s_maxInjectionGroupDurationMs;
+
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
 	TaskState doUpdate(std::shared_ptr<Blackboard> blackboard) override;
 	void doExit(std::shared_ptr<Blackboard> blackboard) override;
@@ -25,8 +39,17 @@ private:
 
 	void handleMessage(MessageIndexingInterrupted* message) override;
 
+	void finishInjectionGroup(std::shared_ptr<Storage> target);
+
 	std::shared_ptr<StorageProvider> m_storageProvider;
 	std::weak_ptr<Storage> m_target;
+	std::shared_ptr<Storage> m_deltaTarget;
+	std::shared_ptr<IndexingCheckpoint> m_checkpoint;
+	const bool m_yieldsToUser;
+
+	bool m_injectionGroupStarted;
+	std::vector<FilePath> m_injectedSourceFilePaths;
+	TimeStamp m_injectionGroupStart;
 };
 
 #endif	  // TASK_INJECT_STORAGE_H
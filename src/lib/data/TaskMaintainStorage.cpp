@@ -0,0 +1,210 @@
+#include "TaskMaintainStorage.h"
+
+#include <chrono>
+#include <thread>
+
+#include "Blackboard.h"
+#include "PersistentStorage.h"
+#include "SqliteIndexStorage.h"
+#include "TaskManager.h"
+#include "TaskScheduler.h"
+#include "ThreadPool.h"
+#include "UserActivity.h"
+#include "logging.h"
+
+const double TaskMaintainStorage::s_minFreePageRatio = 0.05;
+const double TaskMaintainStorage::s_minRebuildFreePageRatio = 0.25;
+const size_t TaskMaintainStorage::s_vacuumPageCount = 1024;
+
+TaskMaintainStorage::TaskMaintainStorage(
+	std::weak_ptr<PersistentStorage> storage,
+	const SqliteStorageSettings& settings,
+	size_t idleMs,
+	bool rebuildIndices)
+	: m_storage(storage), m_settings(settings), m_idleMs(idleMs), m_rebuildIndices(rebuildIndices)
+{
+}
+
+void TaskMaintainStorage::terminate()
+{
+	interruptStep();
+}
+
+void TaskMaintainStorage::doEnter(std::shared_ptr<Blackboard> blackboard)
+{
+	if (std::shared_ptr<PersistentStorage> storage = m_storage.lock())
+	{
+		m_dbFilePath = storage->getIndexDbFilePath();
+	}
+}
+
+Task::TaskState TaskMaintainStorage::doUpdate(std::shared_ptr<Blackboard> blackboard)
+{
+	if (m_runningStep != STEP_NONE)
+	{
+		if (m_stepResult.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready)
+		{
+			if (!canRun(blackboard))
+			{
+				interruptStep();
+			}
+			return STATE_HOLD;
+		}
+		finishStep();
+	}
+
+	if (m_storage.expired() || m_dbFilePath.empty())
+	{
+		return STATE_SUCCESS;
+	}
+
+	if (!canRun(blackboard))
+	{
+		// a refresh replaces the database file, so the connection is not kept while waiting
+		m_connection.reset();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		return STATE_HOLD;
+	}
+
+	if (!m_connection)
+	{
+		try
+		{
+			m_connection = std::make_shared<SqliteIndexStorage>(m_dbFilePath);
+			m_connection->applySettings(m_settings);
+		}
+		catch (CppSQLite3Exception& e)
+		{
+			LOG_ERROR(
+				"Unable to open index database for maintenance: " + std::string(e.errorMessage()));
+			return STATE_FAILURE;
+		}
+
+		LOG_INFO(
+			"Index database has " + std::to_string(m_connection->getFreePageCount()) + " of " +
+			std::to_string(m_connection->getPageCount()) + " pages free");
+	}
+
+	const StepType step = getNextStep();
+	if (step == STEP_NONE)
+	{
+		m_connection.reset();
+		return STATE_SUCCESS;
+	}
+
+	startStep(step);
+	return STATE_HOLD;
+}
+
+void TaskMaintainStorage::doExit(std::shared_ptr<Blackboard> blackboard)
+{
+	m_connection.reset();
+}
+
+void TaskMaintainStorage::doReset(std::shared_ptr<Blackboard> blackboard) {}
+
+bool TaskMaintainStorage::canRun(std::shared_ptr<Blackboard> blackboard) const
+{
+	Id schedulerId = 0;
+	if (blackboard->get("scheduler_id", schedulerId))
+	{
+		// the queue includes this task
+		std::shared_ptr<TaskScheduler> scheduler = TaskManager::getScheduler(schedulerId);
+		if (scheduler && scheduler->getTaskCount() > 1)
+		{
+			return false;
+		}
+	}
+
+	return !m_storage.expired() && UserActivity::getIdleMs() >= m_idleMs;
+}
+
+TaskMaintainStorage::StepType TaskMaintainStorage::getNextStep() const
+{
+	const size_t pageCount = m_connection->getPageCount();
+	const size_t freePageCount = m_connection->getFreePageCount();
+	const double freePageRatio = pageCount ? double(freePageCount) / double(pageCount) : 0.0;
+
+	// rebuilding leaves the pages of the old indices free, so it goes before the vacuum
+	if (m_rebuildIndices && !m_reindexDone && freePageRatio >= s_minRebuildFreePageRatio)
+	{
+		return STEP_REINDEX;
+	}
+
+	if (!m_analyzeDone && !m_connection->hasCurrentStatistics())
+	{
+		return STEP_ANALYZE;
+	}
+
+	if (!m_vacuumDone && freePageCount > 0 && m_connection->hasIncrementalVacuum() &&
+		(m_vacuumStarted || freePageRatio >= s_minFreePageRatio))
+	{
+		return STEP_VACUUM;
+	}
+
+	return STEP_NONE;
+}
+
+void TaskMaintainStorage::startStep(StepType step)
+{
+	m_runningStep = step;
+	m_stepFreePageCount = m_connection->getFreePageCount();
+	m_stepInterrupted = false;
+	m_stepSucceeded = std::make_shared<bool>(false);
+
+	std::shared_ptr<SqliteIndexStorage> connection = m_connection;
+	std::shared_ptr<bool> succeeded = m_stepSucceeded;
+	m_stepResult = TaskManager::getThreadPool()->runBlocking([connection, step, succeeded]() {
+		switch (step)
+		{
+		case STEP_REINDEX:
+			*succeeded = connection->reindex();
+			break;
+		case STEP_ANALYZE:
+			*succeeded = connection->analyze();
+			break;
+		case STEP_VACUUM:
+			*succeeded = connection->incrementalVacuum(s_vacuumPageCount);
+			break;
+		case STEP_NONE:
+			break;
+		}
+	});
+}
+
+void TaskMaintainStorage::finishStep()
+{
+	m_stepResult.get();
+
+	// interrupted steps run again once the user is idle, failed ones are not tried again
+	if (*m_stepSucceeded || !m_stepInterrupted)
+	{
+		switch (m_runningStep)
+		{
+		case STEP_REINDEX:
+			m_reindexDone = true;
+			break;
+		case STEP_ANALYZE:
+			m_analyzeDone = true;
+			break;
+		case STEP_VACUUM:
+			m_vacuumStarted = true;
+			m_vacuumDone = !*m_stepSucceeded ||
+				m_connection->getFreePageCount() >= m_stepFreePageCount;
+			break;
+		case STEP_NONE:
+			break;
+		}
+	}
+
+	m_runningStep = STEP_NONE;
+}
+
+void TaskMaintainStorage::interruptStep()
+{
+	if (m_runningStep != STEP_NONE && m_connection)
+	{
+		m_stepInterrupted = true;
+		m_connection->interrupt();
+	}
+}
@@ -0,0 +1,75 @@
+#ifndef TASK_MAINTAIN_STORAGE_H
+#define TASK_MAINTAIN_STORAGE_H
+
+#include <future>
+#include <memory>
+
+#include "FilePath.h"
+#include "SqliteStorageSettings.h"
+#include "Task.h"
+
+class PersistentStorage;
+class SqliteIndexStorage;
+
+// Runs ANALYZE, rebuilds the indices and releases free pages of the index database while the user
+// is idle and no other task of the scheduler is queued. The work happens on its own connection in
+// steps on a thread of the pool, a step gets interrupted by any input of the user and is started
+// again once the user is idle again. The task ends once nothing is left to do or the storage got
+// replaced.
+class TaskMaintainStorage: public Task
+{
+public:
+	TaskMaintainStorage(
+		std::weak_ptr<PersistentStorage> storage,
+		const SqliteStorageSettings& settings,
+		size_t idleMs,
+		bool rebuildIndices);
+
+	void terminate() override;
+
+private:
+	enum StepType
+	{
+		STEP_NONE,
+		STEP_REINDEX,
+		STEP_ANALYZE,
+		STEP_VACUUM
+	};
+
+	// share of free pages from which they get released and the indices get rebuilt
+	static const double s_minFreePageRatio;
+	static const double s_minRebuildFreePageRatio;
+	static const size_t s_vacuumPageCount;	  // released per step, so interruptions are cheap
+
+	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
+	TaskState doUpdate(std::shared_ptr<Blackboard> blackboard) override;
+	void doExit(std::shared_ptr<Blackboard> blackboard) override;
+	void doReset(std::shared_ptr<Blackboard> blackboard) override;
+
+	bool canRun(std::shared_ptr<Blackboard> blackboard) const;
+	StepType getNextStep() const;
+	void startStep(StepType step);
+	void finishStep();
+	void interruptStep();
+
+	std::weak_ptr<PersistentStorage> m_storage;
+	const SqliteStorageSettings m_settings;
+	const size_t m_idleMs;
+	const bool m_rebuildIndices;
+
+	FilePath m_dbFilePath;
+	std::shared_ptr<SqliteIndexStorage> m_connection;	 // only open while steps run
+
+	bool m_reindexDone = false;
+	bool m_analyzeDone = false;
+	bool m_vacuumStarted = false;
+	bool m_vacuumDone = false;
+
+	StepType m_runningStep = STEP_NONE;
+	size_t m_stepFreePageCount = 0;
+	bool m_stepInterrupted = false;
+	std::shared_ptr<bool> m_stepSucceeded;
+	std::future<void> m_stepResult;
+};
+
+#endif	  // TASK_MAINTAIN_STORAGE_H
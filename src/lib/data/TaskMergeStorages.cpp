@@ -1,6 +1,16 @@
 #include "TaskMergeStorages.h"
 
+#include "Blackboard.h"
+#include "MetricsRegistry.h"
 #include "StorageProvider.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
+#include "TimeStamp.h"
+#include "utility.h"
+
+// merged storages stay small enough to be injected while indexing continues, instead of growing
+// into one storage that is left for injection after the last file was indexed
+const size_t TaskMergeStorages::s_maxMergedSourceLocationCount = 250000;
 
 TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider)
 	: m_storageProvider(storageProvider)
@@ -13,24 +23,48 @@ Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> blackboa
 {
 	if (m_storageProvider->getStorageCount() > 2)	 // largest storage won't be touched here
 	{
-		std::shared_ptr<IntermediateStorage> target = m_storageProvider->consumeSecondLargestStorage();
-		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeSecondLargestStorage();
-		if (target && source)
+		const std::vector<std::shared_ptr<IntermediateStorage>> storages =
+			m_storageProvider->consumeAllButLargestStorage(s_maxMergedSourceLocationCount);
+
+		if (storages.size() > 1)
 		{
-			target->inject(source.get());
-			m_storageProvider->insert(target);
+			const TimeStamp start = TimeStamp::now();
+
+			// every part starts with one of the largest storages, because parts are filled
+			// round-robin. Each part is merged by a worker of the pool and every element gets
+			// copied twice at most, instead of once per pairwise merge.
+			std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+			const std::vector<std::vector<std::shared_ptr<IntermediateStorage>>> parts =
+				utility::splitToEqualySizedParts(
+					storages, std::min<size_t>(threadPool->getWorkerCount(), storages.size() / 2));
+
+			std::vector<std::shared_ptr<IntermediateStorage>> mergedParts(parts.size());
+			threadPool->parallelFor(
+				parts.size(),
+				[&parts, &mergedParts](size_t i) { mergedParts[i] = mergeStorages(parts[i]); },
+				ThreadPool::PRIORITY_INDEXING);
+
+			m_storageProvider->insert(mergeStorages(mergedParts));
+
+			const float duration = TimeStamp::durationSeconds(start);
+			static MetricHistogram& mergeDurationHistogram =
+				MetricsRegistry::getInstance()->getHistogram(
+					"sourcetrail_indexing_merge_duration_seconds",
+					"Duration of merging a group of indexed storages");
+			static MetricCounter& mergedStorageCounter = MetricsRegistry::getInstance()->getCounter(
+				"sourcetrail_indexing_merged_storages_total", "Indexed storages merged into others");
+			mergeDurationHistogram.observe(duration);
+			mergedStorageCounter.add(storages.size());
+
+			blackboard->update<float>(
+				"merge_time",
+				[duration](float currentDuration) { return currentDuration + duration; });
 			return STATE_SUCCESS;
 		}
-		else
+
+		for (const std::shared_ptr<IntermediateStorage>& storage: storages)
 		{
-			if (target)
-			{
-				m_storageProvider->insert(target);
-			}
-			if (source)
-			{
-				m_storageProvider->insert(source);
-			}
+			m_storageProvider->insert(storage);
 		}
 	}
 
@@ -40,3 +74,14 @@ Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> blackboa
 void TaskMergeStorages::doExit(std::shared_ptr<Blackboard> blackboard) {}
 
 void TaskMergeStorages::doReset(std::shared_ptr<Blackboard> blackboard) {}
+
+std::shared_ptr<IntermediateStorage> TaskMergeStorages::mergeStorages(
+	const std::vector<std::shared_ptr<IntermediateStorage>>& storages)
+{
+	std::shared_ptr<IntermediateStorage> target = storages.front();
+	for (size_t i = 1; i < storages.size(); i++)
+	{
+		target->inject(storages[i].get());
+	}
+	return target;
+}
@@ -1,10 +1,12 @@
 #ifndef TASK_MERGE_STORAGES_H
 #define TASK_MERGE_STORAGES_H
 
+#include <memory>
 #include <vector>
 
 #include "Task.h"
 
+class IntermediateStorage;
 class StorageProvider;
 
 class TaskMergeStorages: public Task
@@ -13,11 +15,17 @@ public:
 	TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider);
 
 private:
+	static const size_t s_maxMergedSourceLocationCount;
+
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
 	TaskState doUpdate(std::shared_ptr<Blackboard> blackboard) override;
 	void doExit(std::shared_ptr<Blackboard> blackboard) override;
 	void doReset(std::shared_ptr<Blackboard> blackboard) override;
 
+	// merges all storages into the first one, which is expected to be the largest
+	static std::shared_ptr<IntermediateStorage> mergeStorages(
+		const std::vector<std::shared_ptr<IntermediateStorage>>& storages);
+
 	std::shared_ptr<StorageProvider> m_storageProvider;
 };
 
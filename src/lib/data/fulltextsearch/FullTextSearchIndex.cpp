@@ -1,10 +1,19 @@
 #include "FullTextSearchIndex.h"
+
+#include <algorithm>
 #include <limits>
 
+#include "MemoryUsage.h"
 #include "logging.h"
 #include "tracing.h"
 
 void FullTextSearchIndex::addFile(Id fileId, const std::wstring& fileContent)
+{
+	addFile(fileId, fileContent, "");
+}
+
+void FullTextSearchIndex::addFile(
+	Id fileId, const std::wstring& fileContent, const std::string& serializedArrays)
 {
 	if (fileContent.empty())
 	{
@@ -16,11 +25,12 @@ void FullTextSearchIndex::addFile(Id fileId, const std::wstring& fileContent)
 		LOG_ERROR("file too big not added to fulltextsearch index");
 	}
 
-	FullTextSearchFile fts_file(fileId, SuffixArray(fileContent));
+	FullTextSearchFile fts_file(
+		fileId, SuffixArray(fileContent, serializedArrays), buildLineStarts(fileContent));
 
 	{
 		std::lock_guard<std::mutex> lock(m_filesMutex);
-		m_files.push_back(fts_file);
+		m_files.push_back(std::move(fts_file));
 	}
 }
 
@@ -39,7 +49,13 @@ std::vector<FullTextSearchResult> FullTextSearchIndex::searchForTerm(const std::
 			std::sort(hit.positions.begin(), hit.positions.end());
 			if (!hit.positions.empty())
 			{
-				ret.push_back(hit);
+				hit.locations.reserve(hit.positions.size());
+				for (int position: hit.positions)
+				{
+					hit.locations.push_back(
+						getParseLocation(f.fileId, f.lineStarts, position, int(term.size())));
+				}
+				ret.push_back(std::move(hit));
 			}
 		}
 	}
@@ -53,8 +69,63 @@ size_t FullTextSearchIndex::fileCount() const
 	return m_files.size();
 }
 
+size_t FullTextSearchIndex::getByteSize() const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+	size_t byteSize = utility::getByteSize(m_files);
+	for (const FullTextSearchFile& file: m_files)
+	{
+		byteSize += file.array.getByteSize() + utility::getByteSize(file.lineStarts);
+	}
+	return byteSize;
+}
+
+std::vector<Id> FullTextSearchIndex::getFileIds() const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	std::vector<Id> fileIds;
+	fileIds.reserve(m_files.size());
+	for (const FullTextSearchFile& f: m_files)
+	{
+		fileIds.push_back(f.fileId);
+	}
+	return fileIds;
+}
+
 void FullTextSearchIndex::clear()
 {
 	std::lock_guard<std::mutex> lock(m_filesMutex);
 	m_files.clear();
 }
+
+std::vector<int> FullTextSearchIndex::buildLineStarts(const std::wstring& fileContent)
+{
+	std::vector<int> lineStarts(1, 0);
+	for (size_t i = 0; i < fileContent.size(); i++)
+	{
+		if (fileContent[i] == L'\n')
+		{
+			lineStarts.push_back(int(i + 1));
+		}
+	}
+	return lineStarts;
+}
+
+ParseLocation FullTextSearchIndex::getParseLocation(
+	Id fileId, const std::vector<int>& lineStarts, int position, int length)
+{
+	const int endPosition = position + std::max(length, 1) - 1;
+
+	const size_t startLine = std::upper_bound(lineStarts.begin(), lineStarts.end(), position) -
+		lineStarts.begin();
+	const size_t endLine = std::upper_bound(lineStarts.begin(), lineStarts.end(), endPosition) -
+		lineStarts.begin();
+
+	return ParseLocation(
+		fileId,
+		startLine,
+		position - lineStarts[startLine - 1] + 1,
+		endLine,
+		endPosition - lineStarts[endLine - 1] + 1);
+}
@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "ParseLocation.h"
 #include "SuffixArray.h"
 #include "types.h"
 
@@ -15,26 +16,36 @@ struct FullTextSearchResult
 {
 	Id fileId;
 	std::vector<int> positions;
+	std::vector<ParseLocation> locations;	 // line and column of each position, 1-based
 };
 
 struct FullTextSearchFile
 {
-	FullTextSearchFile(Id fileId, SuffixArray array): fileId(fileId), array(array) {};
+	FullTextSearchFile(Id fileId, SuffixArray array, std::vector<int> lineStarts)
+		: fileId(fileId), array(std::move(array)), lineStarts(std::move(lineStarts)) {};
 	Id fileId;
 	SuffixArray array;
+	std::vector<int> lineStarts;
 };
 
 class FullTextSearchIndex
 {
 public:
 	void addFile(Id fileId, const std::wstring& file);
+	void addFile(Id fileId, const std::wstring& file, const std::string& serializedArrays);
 	std::vector<FullTextSearchResult> searchForTerm(const std::wstring& term) const;
 
 	size_t fileCount() const;
+	size_t getByteSize() const;
+	std::vector<Id> getFileIds() const;
 
 	void clear();
 
 private:
+	static std::vector<int> buildLineStarts(const std::wstring& fileContent);
+	static ParseLocation getParseLocation(
+		Id fileId, const std::vector<int>& lineStarts, int position, int length);
+
 	mutable std::mutex m_filesMutex;
 	std::vector<FullTextSearchFile> m_files;
 };
@@ -0,0 +1,223 @@
+#include "FullTextSearchRegex.h"
+
+#include <cwctype>
+
+namespace
+{
+bool isQuantifier(wchar_t c)
+{
+	return c == L'*' || c == L'+' || c == L'?' || c == L'{';
+}
+
+// returns the position after the quantifier starting at pos, including a lazy modifier
+size_t skipQuantifier(const std::wstring& pattern, size_t pos)
+{
+	if (pattern[pos] == L'{')
+	{
+		while (pos < pattern.size() && pattern[pos] != L'}')
+		{
+			pos++;
+		}
+	}
+	pos++;
+
+	if (pos < pattern.size() && pattern[pos] == L'?')
+	{
+		pos++;
+	}
+	return pos;
+}
+
+// skips a group or character class starting at pos, returns the position after it
+size_t skipBracket(const std::wstring& pattern, size_t pos)
+{
+	if (pattern[pos] == L'[')
+	{
+		size_t i = pos + 1;
+		if (i < pattern.size() && pattern[i] == L'^')
+		{
+			i++;
+		}
+		for (; i < pattern.size(); i++)
+		{
+			if (pattern[i] == L'\\')
+			{
+				i++;
+			}
+			else if (pattern[i] == L']')
+			{
+				return i + 1;
+			}
+		}
+		return pattern.size();
+	}
+
+	int depth = 0;
+	for (size_t i = pos; i < pattern.size(); i++)
+	{
+		if (pattern[i] == L'\\')
+		{
+			i++;
+		}
+		else if (pattern[i] == L'[')
+		{
+			i = skipBracket(pattern, i) - 1;
+		}
+		else if (pattern[i] == L'(')
+		{
+			depth++;
+		}
+		else if (pattern[i] == L')')
+		{
+			depth--;
+			if (depth == 0)
+			{
+				return i + 1;
+			}
+		}
+	}
+	return pattern.size();
+}
+
+bool hasTopLevelAlternation(const std::wstring& pattern)
+{
+	for (size_t i = 0; i < pattern.size(); i++)
+	{
+		if (pattern[i] == L'\\')
+		{
+			i++;
+		}
+		else if (pattern[i] == L'(' || pattern[i] == L'[')
+		{
+			i = skipBracket(pattern, i) - 1;
+		}
+		else if (pattern[i] == L'|')
+		{
+			return true;
+		}
+	}
+	return false;
+}
+}	 // namespace
+
+bool FullTextSearchRegex::isRegexTerm(const std::wstring& term)
+{
+	return term.size() > 2 && term.front() == L'/' && term.back() == L'/';
+}
+
+std::wstring FullTextSearchRegex::getPattern(const std::wstring& term)
+{
+	if (!isRegexTerm(term))
+	{
+		return term;
+	}
+	return term.substr(1, term.size() - 2);
+}
+
+std::wstring FullTextSearchRegex::getRequiredLiteral(const std::wstring& pattern)
+{
+	if (hasTopLevelAlternation(pattern))
+	{
+		return L"";
+	}
+
+	std::wstring longest;
+	std::wstring current;
+
+	auto finishCurrent = [&]() {
+		if (current.size() > longest.size())
+		{
+			longest = current;
+		}
+		current.clear();
+	};
+
+	size_t i = 0;
+	while (i < pattern.size())
+	{
+		const wchar_t c = pattern[i];
+		wchar_t literal = 0;
+		size_t next = i + 1;
+
+		if (c == L'\\')
+		{
+			if (i + 1 >= pattern.size())
+			{
+				break;
+			}
+
+			const wchar_t escaped = pattern[i + 1];
+			next = i + 2;
+			if (escaped == L'b' || escaped == L'B')
+			{
+				// zero width assertions don't interrupt a literal
+				i = next;
+				continue;
+			}
+			else if (std::iswalnum(escaped))
+			{
+				// character classes and escape sequences like \w, \d, \n, \x41
+				finishCurrent();
+				i = next;
+				if (i < pattern.size() && isQuantifier(pattern[i]))
+				{
+					i = skipQuantifier(pattern, i);
+				}
+				continue;
+			}
+			literal = escaped;
+		}
+		else if (c == L'^' || c == L'$')
+		{
+			i = next;
+			continue;
+		}
+		else if (c == L'(' || c == L'[')
+		{
+			finishCurrent();
+			i = skipBracket(pattern, i);
+			if (i < pattern.size() && isQuantifier(pattern[i]))
+			{
+				i = skipQuantifier(pattern, i);
+			}
+			continue;
+		}
+		else if (c == L'.')
+		{
+			finishCurrent();
+			i = next;
+			if (i < pattern.size() && isQuantifier(pattern[i]))
+			{
+				i = skipQuantifier(pattern, i);
+			}
+			continue;
+		}
+		else if (c == L'|' || c == L')' || c == L']' || isQuantifier(c) || c == L'}')
+		{
+			finishCurrent();
+			i = next;
+			continue;
+		}
+		else
+		{
+			literal = c;
+		}
+
+		if (next < pattern.size() && isQuantifier(pattern[next]))
+		{
+			if (pattern[next] == L'+')
+			{
+				current.push_back(literal);
+			}
+			finishCurrent();
+			i = skipQuantifier(pattern, next);
+			continue;
+		}
+
+		current.push_back(literal);
+		i = next;
+	}
+	finishCurrent();
+
+	return longest;
+}
@@ -0,0 +1,20 @@
+#ifndef FULLTEXTSEARCH_REGEX_H
+#define FULLTEXTSEARCH_REGEX_H
+
+#include <string>
+
+// A fulltext search term written as "/pattern/" is searched as ECMAScript regular expression, e.g.
+// "/\bfoo\b/" finds whole words only. Every match has to lie within a single line. If the pattern
+// contains a literal that is part of every match, the suffix arrays are used to find candidate
+// lines and only those lines are matched against the expression.
+class FullTextSearchRegex
+{
+public:
+	static bool isRegexTerm(const std::wstring& term);
+	static std::wstring getPattern(const std::wstring& term);
+
+	// returns the longest literal every match of the pattern contains, empty if there is none
+	static std::wstring getRequiredLiteral(const std::wstring& pattern);
+};
+
+#endif	  // FULLTEXTSEARCH_REGEX_H
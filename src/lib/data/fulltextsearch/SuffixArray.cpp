@@ -1,188 +1,388 @@
 #include "SuffixArray.h"
 
 #include <algorithm>
+#include <cstring>
+#include <cwctype>
 #include <iostream>
 
-struct suffix
+#include "MemoryUsage.h"
+
+namespace
+{
+// Encodes every wchar_t on its own, so each character of the text maps to exactly one lead byte.
+// Surrogates (on platforms with 16 bit wchar_t) are encoded like any other code unit.
+std::string encodeLowerCase(const std::wstring& text)
 {
-	int index;
-	int rank[2];
-};
+	std::string encoded;
+	encoded.reserve(text.size());
+
+	for (wchar_t c: text)
+	{
+		const uint32_t v = static_cast<uint32_t>(std::towlower(c)) & 0x1FFFFF;
+		if (v < 0x80)
+		{
+			encoded.push_back(static_cast<char>(v));
+		}
+		else if (v < 0x800)
+		{
+			encoded.push_back(static_cast<char>(0xC0 | (v >> 6)));
+			encoded.push_back(static_cast<char>(0x80 | (v & 0x3F)));
+		}
+		else if (v < 0x10000)
+		{
+			encoded.push_back(static_cast<char>(0xE0 | (v >> 12)));
+			encoded.push_back(static_cast<char>(0x80 | ((v >> 6) & 0x3F)));
+			encoded.push_back(static_cast<char>(0x80 | (v & 0x3F)));
+		}
+		else
+		{
+			encoded.push_back(static_cast<char>(0xF0 | (v >> 18)));
+			encoded.push_back(static_cast<char>(0x80 | ((v >> 12) & 0x3F)));
+			encoded.push_back(static_cast<char>(0x80 | ((v >> 6) & 0x3F)));
+			encoded.push_back(static_cast<char>(0x80 | (v & 0x3F)));
+		}
+	}
 
-int SuffixArray::cmp(const struct suffix& a, const struct suffix& b)
+	return encoded;
+}
+
+bool isLeadByte(char c)
 {
-	return (a.rank[0] == b.rank[0]) ? (a.rank[1] < b.rank[1] ? 1 : 0)
-									: (a.rank[0] < b.rank[0] ? 1 : 0);
+	return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
 }
 
-SuffixArray::SuffixArray(const std::wstring& text): m_text(text)
+void getBuckets(const int* s, int n, int k, std::vector<int>& buckets, bool end)
 {
-	std::transform(m_text.begin(), m_text.end(), m_text.begin(), ::towlower);
-	m_array = buildSuffixArray();
-	m_lcp = buildLCP();
+	std::fill(buckets.begin(), buckets.end(), 0);
+	for (int i = 0; i < n; i++)
+	{
+		buckets[s[i]]++;
+	}
+
+	int sum = 0;
+	for (int i = 0; i <= k; i++)
+	{
+		sum += buckets[i];
+		buckets[i] = end ? sum : sum - buckets[i];
+	}
 }
 
-void SuffixArray::printArray() const
+void induceL(
+	const std::vector<bool>& sType, int* sa, const int* s, std::vector<int>& buckets, int n, int k)
 {
-	std::cout << "Suffix Array : \n";
-	printArr(m_array);
-	for (size_t i = 0; i < m_array.size(); i++)
+	getBuckets(s, n, k, buckets, false);
+	for (int i = 0; i < n; i++)
 	{
-		std::wstring suffix = m_text.substr(m_array[i]);
-		std::wcout << i << ": \"" << suffix << "\"" << std::endl;
+		const int j = sa[i] - 1;
+		if (j >= 0 && !sType[j])
+		{
+			sa[buckets[s[j]]++] = j;
+		}
 	}
 }
 
-void SuffixArray::printLCP() const
+void induceS(
+	const std::vector<bool>& sType, int* sa, const int* s, std::vector<int>& buckets, int n, int k)
 {
-	std::cout << "\nLCP Array : \n";
-	printArr(m_lcp);
-	for (size_t i = 0; i < m_array.size(); i++)
+	getBuckets(s, n, k, buckets, true);
+	for (int i = n - 1; i >= 0; i--)
 	{
-		std::wstring prefix = m_text.substr(m_array[i], m_lcp[i]);
-		std::wcout << i << ": \"" << prefix << "\"" << std::endl;
+		const int j = sa[i] - 1;
+		if (j >= 0 && sType[j])
+		{
+			sa[--buckets[s[j]]] = j;
+		}
 	}
 }
 
-std::vector<int> SuffixArray::buildLCP()
+// SA-IS by Nong, Zhang and Chan. Requires s[n - 1] to be a unique sentinel 0 and all other
+// values to be in range [1, k].
+void buildSuffixArrayInducedSorting(const int* s, int* sa, int n, int k)
 {
-	const int n = m_array.size();
+	std::vector<bool> sType(n, false);
+	sType[n - 1] = true;
+	for (int i = n - 3; i >= 0; i--)
+	{
+		sType[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && sType[i + 1]);
+	}
 
-	std::vector<int> lcp(n, 0);
-	std::vector<int> invSuff(n, 0);
+	auto isLMS = [&sType](int i) { return i > 0 && sType[i] && !sType[i - 1]; };
 
-	for (int i = 0; i < n; i++)
+	std::vector<int> buckets(k + 1);
+
+	// stage 1: sort all LMS substrings
+	getBuckets(s, n, k, buckets, true);
+	std::fill(sa, sa + n, -1);
+	for (int i = 1; i < n; i++)
 	{
-		invSuff[m_array[i]] = i;
+		if (isLMS(i))
+		{
+			sa[--buckets[s[i]]] = i;
+		}
 	}
+	induceL(sType, sa, s, buckets, n, k);
+	induceS(sType, sa, s, buckets, n, k);
 
-	int k = 0;
-
+	int n1 = 0;
 	for (int i = 0; i < n; i++)
 	{
-		if (invSuff[i] == n - 1)
+		if (isLMS(sa[i]))
 		{
-			k = 0;
-			continue;
+			sa[n1++] = sa[i];
 		}
+	}
 
-		int j = m_array[invSuff[i] + 1];
+	// name the sorted LMS substrings
+	std::fill(sa + n1, sa + n, -1);
+	int name = 0;
+	int prev = -1;
+	for (int i = 0; i < n1; i++)
+	{
+		const int pos = sa[i];
+		bool diff = false;
+		for (int d = 0; d < n; d++)
+		{
+			if (prev == -1 || s[pos + d] != s[prev + d] || sType[pos + d] != sType[prev + d])
+			{
+				diff = true;
+				break;
+			}
+			else if (d > 0 && (isLMS(pos + d) || isLMS(prev + d)))
+			{
+				break;
+			}
+		}
 
-		while (i + k < n && j + k < n && m_text[i + k] == m_text[j + k])
+		if (diff)
 		{
-			k++;
+			name++;
+			prev = pos;
 		}
+		sa[n1 + pos / 2] = name - 1;
+	}
 
-		lcp[invSuff[i]] = k;
+	for (int i = n - 1, j = n - 1; i >= n1; i--)
+	{
+		if (sa[i] >= 0)
+		{
+			sa[j--] = sa[i];
+		}
+	}
 
-		if (k > 0)
+	// stage 2: sort the reduced string, recursing if names are not unique yet
+	int* sa1 = sa;
+	int* s1 = sa + n - n1;
+	if (name < n1)
+	{
+		buildSuffixArrayInducedSorting(s1, sa1, n1, name - 1);
+	}
+	else
+	{
+		for (int i = 0; i < n1; i++)
 		{
-			k--;
+			sa1[s1[i]] = i;
 		}
 	}
 
-	return lcp;
+	// stage 3: induce the final array from the sorted LMS suffixes
+	getBuckets(s, n, k, buckets, true);
+	for (int i = 1, j = 0; i < n; i++)
+	{
+		if (isLMS(i))
+		{
+			s1[j++] = i;
+		}
+	}
+	for (int i = 0; i < n1; i++)
+	{
+		sa1[i] = s1[sa1[i]];
+	}
+	std::fill(sa + n1, sa + n, -1);
+	for (int i = n1 - 1; i >= 0; i--)
+	{
+		const int j = sa[i];
+		sa[i] = -1;
+		sa[--buckets[s[j]]] = j;
+	}
+	induceL(sType, sa, s, buckets, n, k);
+	induceS(sType, sa, s, buckets, n, k);
 }
+}	 // namespace
 
-std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm) const
+const int32_t SuffixArray::s_serializationVersion = 2;
+const size_t SuffixArray::s_charIndexSampleRate = 256;
+
+SuffixArray::SuffixArray(const std::wstring& text): m_text(encodeLowerCase(text))
 {
-	std::wstring term = searchTerm;
-	std::transform(term.begin(), term.end(), term.begin(), ::towlower);
+	m_array = buildSuffixArray();
+	buildCharIndexSamples();
+}
 
-	const int termLength = term.length();
-	const int textLength = m_text.length();
-	int l = -1;
-	int r = textLength;
-	int m;
+SuffixArray::SuffixArray(const std::wstring& text, const std::string& serializedArrays)
+	: m_text(encodeLowerCase(text))
+{
+	if (!deserialize(serializedArrays))
+	{
+		m_array = buildSuffixArray();
+	}
+	buildCharIndexSamples();
+}
 
-	std::vector<int> matches;
-	int compareResult;
-	while (l + 1 < r)
+std::string SuffixArray::serialize() const
+{
+	const size_t arrayBytes = m_array.size() * sizeof(int32_t);
+
+	std::string data(sizeof(int32_t) + arrayBytes, '\0');
+	std::memcpy(&data[0], &s_serializationVersion, sizeof(int32_t));
+	if (arrayBytes)
 	{
-		m = (l + r + 1) / 2;
-		compareResult = term.compare(m_text.substr(m_array[m], termLength));
-		if (compareResult < 0)
-		{
-			r = m;
-		}
-		else if (compareResult > 0)
-		{
-			l = m;
-		}
-		else
-		{
-			matches.push_back(m_array[m]);
-			for (int lower = m - 1; lower >= 0 && m_lcp[lower] >= termLength; lower--)
-			{
-				matches.push_back(m_array[lower]);
-			}
-			for (int higher = m + 1; higher < textLength && m_lcp[higher - 1] >= termLength; higher++)
-			{
-				matches.push_back(m_array[higher]);
-			}
-			break;
-		}
+		std::memcpy(&data[sizeof(int32_t)], m_array.data(), arrayBytes);
 	}
+	return data;
+}
 
+std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm) const
+{
+	const std::string term = encodeLowerCase(searchTerm);
+	if (term.empty())
+	{
+		return {};
+	}
+
+	// find range of suffixes starting with term
+	auto first = std::lower_bound(
+		m_array.begin(), m_array.end(), term, [this](int suffixIndex, const std::string& t) {
+			return compareSuffix(suffixIndex, t) < 0;
+		});
+	auto last = std::upper_bound(
+		first, m_array.end(), term, [this](const std::string& t, int suffixIndex) {
+			return compareSuffix(suffixIndex, t) > 0;
+		});
+
+	std::vector<int> matches(first, last);
 	std::sort(matches.begin(), matches.end());
 
+	for (int& match: matches)
+	{
+		match = getCharIndex(match);
+	}
+
 	return matches;
 }
 
-std::vector<int> SuffixArray::buildSuffixArray()
+size_t SuffixArray::getByteSize() const
 {
-	const int n = m_text.length();
-	std::vector<suffix> suffixes;
-	suffixes.reserve(n);
+	return utility::getByteSize(m_text) + utility::getByteSize(m_array) +
+		utility::getByteSize(m_charIndexSamples);
+}
 
-	suffix s;
-	for (int i = 0; i < n; i++)
+void SuffixArray::printArray() const
+{
+	std::cout << "Suffix Array : \n";
+	for (size_t i = 0; i < m_array.size(); i++)
+	{
+		std::cout << i << ": " << m_array[i] << " \"" << m_text.substr(m_array[i]) << "\""
+				  << std::endl;
+	}
+}
+
+bool SuffixArray::deserialize(const std::string& serializedArrays)
+{
+	const size_t n = m_text.length();
+	if (n == 0 || serializedArrays.size() != sizeof(int32_t) + n * sizeof(int32_t))
 	{
-		s.index = i;
-		s.rank[0] = m_text[i];
-		s.rank[1] = ((i + 1) < n) ? (m_text[i + 1]) : -1;
-		suffixes.push_back(s);
+		return false;
 	}
 
-	std::sort(suffixes.begin(), suffixes.end(), SuffixArray::cmp);
+	int32_t version = 0;
+	std::memcpy(&version, serializedArrays.data(), sizeof(int32_t));
+	if (version != s_serializationVersion)
+	{
+		return false;
+	}
+
+	m_array.resize(n);
+	std::memcpy(m_array.data(), serializedArrays.data() + sizeof(int32_t), n * sizeof(int32_t));
 
-	std::vector<int> ind(n, 0);
-	for (int k = 4; k < 2 * n; k = k * 2)
+	for (int index: m_array)
 	{
-		int rank = 0;
-		int prev_rank = suffixes[0].rank[0];
-		suffixes[0].rank[0] = rank;
-		ind[suffixes[0].index] = 0;
+		if (index < 0 || size_t(index) >= n)
+		{
+			m_array.clear();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SuffixArray::buildCharIndexSamples()
+{
+	m_charIndexSamples.clear();
+	m_charIndexSamples.reserve(m_text.size() / s_charIndexSampleRate + 1);
 
-		for (int i = 1; i < n; i++)
+	int charCount = 0;
+	for (size_t i = 0; i < m_text.size(); i++)
+	{
+		if (i % s_charIndexSampleRate == 0)
 		{
-			if (suffixes[i].rank[0] == prev_rank && suffixes[i].rank[1] == suffixes[i - 1].rank[1])
-			{
-				prev_rank = suffixes[i].rank[0];
-				suffixes[i].rank[0] = rank;
-			}
-			else
-			{
-				prev_rank = suffixes[i].rank[0];
-				suffixes[i].rank[0] = ++rank;
-			}
-			ind[suffixes[i].index] = i;
+			m_charIndexSamples.push_back(charCount);
 		}
 
-		for (int i = 0; i < n; i++)
+		if (isLeadByte(m_text[i]))
 		{
-			int nextindex = suffixes[i].index + k / 2;
-			suffixes[i].rank[1] = (nextindex < n) ? suffixes[ind[nextindex]].rank[0] : -1;
+			charCount++;
 		}
+	}
+}
 
-		std::sort(suffixes.begin(), suffixes.end(), cmp);
+int SuffixArray::getCharIndex(int byteIndex) const
+{
+	const size_t sample = byteIndex / s_charIndexSampleRate;
+
+	int charIndex = m_charIndexSamples[sample];
+	for (size_t i = sample * s_charIndexSampleRate; i < size_t(byteIndex); i++)
+	{
+		if (isLeadByte(m_text[i]))
+		{
+			charIndex++;
+		}
 	}
+	return charIndex;
+}
 
-	std::vector<int> suffixArr;
+int SuffixArray::compareSuffix(int suffixIndex, const std::string& term) const
+{
+	const size_t suffixLength = m_text.size() - suffixIndex;
+	const size_t length = std::min(suffixLength, term.size());
+
+	const int result = std::memcmp(m_text.data() + suffixIndex, term.data(), length);
+	if (result != 0)
+	{
+		return result;
+	}
+	return suffixLength < term.size() ? -1 : 0;
+}
+
+std::vector<int> SuffixArray::buildSuffixArray() const
+{
+	const int n = m_text.length();
+	if (n == 0)
+	{
+		return {};
+	}
+
+	// shift all bytes by one to make room for the sentinel
+	std::vector<int> s(n + 1);
 	for (int i = 0; i < n; i++)
 	{
-		suffixArr.push_back(suffixes[i].index);
+		s[i] = static_cast<unsigned char>(m_text[i]) + 1;
 	}
+	s[n] = 0;
+
+	std::vector<int> sa(n + 1);
+	buildSuffixArrayInducedSorting(s.data(), sa.data(), n + 1, 256);
 
-	return suffixArr;
+	// first suffix is the sentinel
+	return std::vector<int>(sa.begin() + 1, sa.end());
 }
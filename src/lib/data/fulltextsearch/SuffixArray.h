@@ -1,36 +1,45 @@
 #ifndef SUFFIX_ARRAY_H
 #define SUFFIX_ARRAY_H
 
-#include <iostream>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+// Suffix array over the lowercased text of a file. The text is kept as a compact utf-8 like byte
+// buffer (one lead byte per wchar_t) and the array is built in linear time using SA-IS. Results of
+// searchForTerm are character positions within the original text.
 class SuffixArray
 {
 public:
 	SuffixArray(const std::wstring& text);
+
+	// uses previously serialized arrays, falls back to building them if they don't match the text
+	SuffixArray(const std::wstring& text, const std::string& serializedArrays);
+
+	std::string serialize() const;
+
 	std::vector<int> searchForTerm(const std::wstring& searchTerm) const;
-	static int cmp(const struct suffix& a, const struct suffix& b);
+
+	size_t getByteSize() const;
 
 	void printArray() const;
-	void printLCP() const;
 
 private:
-	template <typename T>
-	void printArr(std::vector<T> arr) const
-	{
-		for (size_t i = 0; i < arr.size(); i++)
-		{
-			std::cout << arr[i] << " ";
-		}
-		std::cout << std::endl;
-	}
-
-	std::vector<int> buildLCP();
-	std::vector<int> buildSuffixArray();
+	static const int32_t s_serializationVersion;
+	static const size_t s_charIndexSampleRate;
+
+	bool deserialize(const std::string& serializedArrays);
+
+	void buildCharIndexSamples();
+	int getCharIndex(int byteIndex) const;
+
+	int compareSuffix(int suffixIndex, const std::string& term) const;
+
+	std::vector<int> buildSuffixArray() const;
+
+	std::string m_text;
 	std::vector<int> m_array;
-	std::vector<int> m_lcp;
-	std::wstring m_text;
+	std::vector<int> m_charIndexSamples;
 };
 
 #endif	  // SUFFIX_ARRAY_H
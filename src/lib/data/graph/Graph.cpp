@@ -1,34 +1,60 @@
 #include "Graph.h"
 
+#include <algorithm>
+
 #include "logging.h"
 
+namespace
+{
+template <typename TokenType>
+typename std::vector<TokenType*>::const_iterator findById(
+	const std::vector<TokenType*>& tokens, Id id)
+{
+	return std::lower_bound(tokens.begin(), tokens.end(), id, [](const TokenType* token, Id id) {
+		return token->getId() < id;
+	});
+}
+
+template <typename TokenType>
+TokenType* getById(const std::vector<TokenType*>& tokens, Id id)
+{
+	auto it = findById(tokens, id);
+	if (it != tokens.end() && (*it)->getId() == id)
+	{
+		return *it;
+	}
+	return nullptr;
+}
+}	 // namespace
+
 Graph::Graph(): m_trailMode(TRAIL_NONE) {}
 
 Graph::~Graph()
 {
-	m_edges.clear();
-	m_nodes.clear();
+	clear();
 }
 
 void Graph::clear()
 {
 	m_edges.clear();
 	m_nodes.clear();
+	m_edgePool.clear();
+	m_nodePool.clear();
 }
 
 void Graph::forEachNode(std::function<void(Node*)> func) const
 {
-	for (const std::pair<Id, std::shared_ptr<Node>>& node: m_nodes)
+	for (Node* node: m_nodes)
 	{
-		func(node.second.get());
+		func(node);
 	}
 }
 
 void Graph::forEachEdge(std::function<void(Edge*)> func) const
 {
-	for (const std::pair<Id, std::shared_ptr<Edge>>& edge: m_edges)
+	for (Edge* edge: m_edges)
 	{
-		func(edge.second.get());
+		func(edge);
 	}
 }
 
@@ -46,10 +72,8 @@ Node* Graph::createNode(Id id, NodeType type, NameHierarchy nameHierarchy, Defin
 		return n;
 	}
 
-	std::shared_ptr<Node> node = std::make_shared<Node>(
-		id, type, std::move(nameHierarchy), definitionKind);
-	m_nodes.emplace(node->getId(), node);
-	return node.get();
+	m_nodePool.emplace_back(id, type, std::move(nameHierarchy), definitionKind);
+	return addNode(&m_nodePool.back());
 }
 
 Edge* Graph::createEdge(Id id, Edge::EdgeType type, Node* from, Node* to)
@@ -66,9 +90,8 @@ Edge* Graph::createEdge(Id id, Edge::EdgeType type, Node* from, Node* to)
 		return nullptr;
 	}
 
-	std::shared_ptr<Edge> edge = std::make_shared<Edge>(id, type, from, to);
-	m_edges.emplace(edge->getId(), edge);
-	return edge.get();
+	m_edgePool.emplace_back(id, type, from, to);
+	return addEdge(&m_edgePool.back());
 }
 
 size_t Graph::getNodeCount() const
@@ -83,38 +106,27 @@ size_t Graph::getEdgeCount() const
 
 Node* Graph::getNodeById(Id id) const
 {
-	std::map<Id, std::shared_ptr<Node>>::const_iterator it = m_nodes.find(id);
-	if (it != m_nodes.end())
-	{
-		return it->second.get();
-	}
-	return nullptr;
+	return getById(m_nodes, id);
 }
 
 Edge* Graph::getEdgeById(Id id) const
 {
-	std::map<Id, std::shared_ptr<Edge>>::const_iterator it = m_edges.find(id);
-	if (it != m_edges.end())
-	{
-		return it->second.get();
-	}
-	return nullptr;
+	return getById(m_edges, id);
 }
 
-const std::map<Id, std::shared_ptr<Node>>& Graph::getNodes() const
+const std::vector<Node*>& Graph::getNodes() const
 {
 	return m_nodes;
 }
 
-const std::map<Id, std::shared_ptr<Edge>>& Graph::getEdges() const
+const std::vector<Edge*>& Graph::getEdges() const
 {
 	return m_edges;
 }
 
 void Graph::removeNode(Node* node)
 {
-	std::map<Id, std::shared_ptr<Node>>::const_iterator it = m_nodes.find(node->getId());
-	if (it == m_nodes.end())
+	if (!getNodeById(node->getId()))
 	{
 		LOG_WARNING("Node was not found in the graph.");
 		return;
@@ -146,15 +158,15 @@ void Graph::removeNode(Node* node)
 		LOG_ERROR("Node still has edges.");
 	}
 
-	m_nodes.erase(it);
+	m_nodes.erase(findById(m_nodes, node->getId()));
 }
 
 void Graph::removeEdge(Edge* edge)
 {
-	std::map<Id, std::shared_ptr<Edge>>::const_iterator it = m_edges.find(edge->getId());
-	if (it == m_edges.end())
+	if (!getEdgeById(edge->getId()))
 	{
 		LOG_WARNING("Edge was not found in the graph.");
+		return;
 	}
 
 	if (edge->getType() == Edge::EDGE_MEMBER)
@@ -163,19 +175,16 @@ void Graph::removeEdge(Edge* edge)
 		return;
 	}
 
-	m_edges.erase(it);
+	removeEdgeInternal(getEdgeById(edge->getId()));
 }
 
 Node* Graph::findNode(std::function<bool(Node*)> func) const
 {
-	std::map<Id, std::shared_ptr<Node>>::const_iterator it = find_if(
-		m_nodes.begin(), m_nodes.end(), [&func](const std::pair<Id, std::shared_ptr<Node>>& n) {
-			return func(n.second.get());
-		});
+	auto it = find_if(m_nodes.begin(), m_nodes.end(), [&func](Node* n) { return func(n); });
 
 	if (it != m_nodes.end())
 	{
-		return it->second.get();
+		return *it;
 	}
 
 	return nullptr;
@@ -183,14 +192,11 @@ Node* Graph::findNode(std::function<bool(Node*)> func) const
 
 Edge* Graph::findEdge(std::function<bool(Edge*)> func) const
 {
-	std::map<Id, std::shared_ptr<Edge>>::const_iterator it = find_if(
-		m_edges.begin(), m_edges.end(), [func](const std::pair<Id, std::shared_ptr<Edge>>& e) {
-			return func(e.second.get());
-		});
+	auto it = find_if(m_edges.begin(), m_edges.end(), [&func](Edge* e) { return func(e); });
 
 	if (it != m_edges.end())
 	{
-		return it->second.get();
+		return *it;
 	}
 
 	return nullptr;
@@ -221,9 +227,8 @@ Node* Graph::addNodeAsPlainCopy(Node* node)
 		return n;
 	}
 
-	std::shared_ptr<Node> copy = std::make_shared<Node>(*node);
-	m_nodes.emplace(copy->getId(), copy);
-	return copy.get();
+	m_nodePool.emplace_back(*node);
+	return addNode(&m_nodePool.back());
 }
 
 Edge* Graph::addEdgeAsPlainCopy(Edge* edge)
@@ -237,9 +242,8 @@ Edge* Graph::addEdgeAsPlainCopy(Edge* edge)
 	Node* from = addNodeAsPlainCopy(edge->getFrom());
 	Node* to = addNodeAsPlainCopy(edge->getTo());
 
-	std::shared_ptr<Edge> copy = std::make_shared<Edge>(*edge, from, to);
-	m_edges.emplace(copy->getId(), copy);
-	return copy.get();
+	m_edgePool.emplace_back(*edge, from, to);
+	return addEdge(&m_edgePool.back());
 }
 
 Node* Graph::addNodeAndAllChildrenAsPlainCopy(Node* node)
@@ -325,13 +329,28 @@ void Graph::printBasic(std::wostream& ostream) const
 
 void Graph::removeEdgeInternal(Edge* edge)
 {
-	std::map<Id, std::shared_ptr<Edge>>::const_iterator it = m_edges.find(edge->getId());
-	if (it != m_edges.end() && it->second.get() == edge)
+	auto it = findById(m_edges, edge->getId());
+	if (it != m_edges.end() && *it == edge)
 	{
+		edge->getFrom()->removeEdge(edge);
+		edge->getTo()->removeEdge(edge);
 		m_edges.erase(it);
 	}
 }
 
+Node* Graph::addNode(Node* node)
+{
+	// ids mostly arrive in ascending order from the storage, which makes this an append
+	m_nodes.insert(findById(m_nodes, node->getId()), node);
+	return node;
+}
+
+Edge* Graph::addEdge(Edge* edge)
+{
+	m_edges.insert(findById(m_edges, edge->getId()), edge);
+	return edge;
+}
+
 std::wostream& operator<<(std::wostream& ostream, const Graph& graph)
 {
 	graph.print(ostream);
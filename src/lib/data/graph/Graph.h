@@ -2,12 +2,14 @@
 #define GRAPH_H
 
 #include <deque>
-#include <map>
 #include <memory>
+#include <vector>
 
 #include "Edge.h"
 #include "Node.h"
 
+// Keeps its nodes and edges in pools and finds them through arrays sorted by id. Removed nodes and
+// edges are only destroyed when the graph is cleared.
 class Graph
 {
 public:
@@ -36,8 +38,9 @@ public:
 	Node* getNodeById(Id id) const;
 	Edge* getEdgeById(Id id) const;
 
-	const std::map<Id, std::shared_ptr<Node>>& getNodes() const;
-	const std::map<Id, std::shared_ptr<Edge>>& getEdges() const;
+	// sorted by id
+	const std::vector<Node*>& getNodes() const;
+	const std::vector<Edge*>& getEdges() const;
 
 	void removeNode(Node* node);
 	void removeEdge(Edge* edge);
@@ -71,8 +74,15 @@ private:
 
 	void removeEdgeInternal(Edge* edge);
 
-	std::map<Id, std::shared_ptr<Node>> m_nodes;
-	std::map<Id, std::shared_ptr<Edge>> m_edges;
+	Node* addNode(Node* node);
+	Edge* addEdge(Edge* edge);
+
+	// edges detach from their nodes when destroyed, so they are declared after the nodes
+	std::deque<Node> m_nodePool;
+	std::deque<Edge> m_edgePool;
+
+	std::vector<Node*> m_nodes;
+	std::vector<Edge*> m_edges;
 
 	TrailMode m_trailMode;
 	bool m_hasTrailOrigin;
@@ -9,6 +9,15 @@
 #include "TokenComponentConst.h"
 #include "TokenComponentStatic.h"
 
+namespace
+{
+std::vector<Edge*>::const_iterator findEdgeById(const std::vector<Edge*>& edges, Id id)
+{
+	return std::lower_bound(
+		edges.begin(), edges.end(), id, [](const Edge* edge, Id id) { return edge->getId() < id; });
+}
+}	 // namespace
+
 Node::Node(Id id, NodeType type, NameHierarchy nameHierarchy, DefinitionKind definitionKind)
 	: Token(id)
 	, m_type(type)
@@ -98,13 +107,18 @@ size_t Node::getEdgeCount() const
 
 void Node::addEdge(Edge* edge)
 {
-	m_edges.emplace(edge->getId(), edge);
+	auto it = findEdgeById(m_edges, edge->getId());
+	if (it == m_edges.end() || (*it)->getId() != edge->getId())
+	{
+		m_edges.insert(it, edge);
+	}
 }
 
 void Node::removeEdge(Edge* edge)
 {
-	auto it = m_edges.find(edge->getId());
-	if (it != m_edges.end())
+	// edges removed from their graph stay alive until the graph is cleared and detach again then
+	auto it = findEdgeById(m_edges, edge->getId());
+	if (it != m_edges.end() && *it == edge)
 	{
 		m_edges.erase(it);
 	}
@@ -149,12 +163,11 @@ bool Node::isParentOf(const Node* node) const
 
 Edge* Node::findEdge(std::function<bool(Edge*)> func) const
 {
-	auto it = find_if(
-		m_edges.begin(), m_edges.end(), [func](std::pair<Id, Edge*> p) { return func(p.second); });
+	auto it = find_if(m_edges.begin(), m_edges.end(), [&func](Edge* e) { return func(e); });
 
 	if (it != m_edges.end())
 	{
-		return it->second;
+		return *it;
 	}
 
 	return nullptr;
@@ -167,17 +180,17 @@ Edge* Node::findEdgeOfType(Edge::TypeMask mask) const
 
 Edge* Node::findEdgeOfType(Edge::TypeMask mask, std::function<bool(Edge*)> func) const
 {
-	auto it = find_if(m_edges.begin(), m_edges.end(), [mask, func](std::pair<Id, Edge*> p) {
-		if (p.second->isType(mask))
+	auto it = find_if(m_edges.begin(), m_edges.end(), [mask, &func](Edge* e) {
+		if (e->isType(mask))
 		{
-			return func(p.second);
+			return func(e);
 		}
 		return false;
 	});
 
 	if (it != m_edges.end())
 	{
-		return it->second;
+		return *it;
 	}
 
 	return nullptr;
@@ -185,17 +198,17 @@ Edge* Node::findEdgeOfType(Edge::TypeMask mask, std::function<bool(Edge*)> func)
 
 Node* Node::findChildNode(std::function<bool(Node*)> func) const
 {
-	auto it = find_if(m_edges.begin(), m_edges.end(), [&func](std::pair<Id, Edge*> p) {
-		if (p.second->getType() == Edge::EDGE_MEMBER)
+	auto it = find_if(m_edges.begin(), m_edges.end(), [&func](Edge* e) {
+		if (e->getType() == Edge::EDGE_MEMBER)
 		{
-			return func(p.second->getTo());
+			return func(e->getTo());
 		}
 		return false;
 	});
 
 	if (it != m_edges.end())
 	{
-		return it->second->getTo();
+		return (*it)->getTo();
 	}
 
 	return nullptr;
@@ -203,17 +216,21 @@ Node* Node::findChildNode(std::function<bool(Node*)> func) const
 
 void Node::forEachEdge(std::function<void(Edge*)> func) const
 {
-	for_each(m_edges.begin(), m_edges.end(), [func](std::pair<Id, Edge*> p) { func(p.second); });
+	for (Edge* edge: m_edges)
+	{
+		func(edge);
+	}
 }
 
 void Node::forEachEdgeOfType(Edge::TypeMask mask, std::function<void(Edge*)> func) const
 {
-	for_each(m_edges.begin(), m_edges.end(), [mask, func](std::pair<Id, Edge*> p) {
-		if (p.second->isType(mask))
+	for (Edge* edge: m_edges)
+	{
+		if (edge->isType(mask))
 		{
-			func(p.second);
+			func(edge);
 		}
-	});
+	}
 }
 
 void Node::forEachChildNode(std::function<void(Node*)> func) const
@@ -96,3 +96,16 @@ size_t CombinedIndexerCommandProvider::size() const
 	}
 	return size;
 }
+
+size_t CombinedIndexerCommandProvider::getClusterKey(const FilePath& filePath) const
+{
+	for (const std::shared_ptr<IndexerCommandProvider>& provider: m_providers)
+	{
+		const size_t key = provider->getClusterKey(filePath);
+		if (key)
+		{
+			return key;
+		}
+	}
+	return 0;
+}
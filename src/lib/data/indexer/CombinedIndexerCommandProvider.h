@@ -17,6 +17,7 @@ public:
 
 	void clear() override;
 	size_t size() const override;
+	size_t getClusterKey(const FilePath& filePath) const override;
 
 private:
 	std::vector<std::shared_ptr<IndexerCommandProvider>> m_providers;
@@ -1,13 +1,17 @@
 #ifndef INDEXER_H
 #define INDEXER_H
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "IndexerBase.h"
 #include "IndexerCommand.h"
 #include "IndexerStateInfo.h"
 #include "ParserClientImpl.h"
+#include "TimeStamp.h"
 #include "logging.h"
+#include "utilityApp.h"
 
 template <typename T>
 class Indexer: public IndexerBase
@@ -16,7 +20,13 @@ public:
 	Indexer();
 	IndexerCommandType getSupportedIndexerCommandType() const override;
 	std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
+	std::vector<std::shared_ptr<IntermediateStorage>> indexBatch(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands) override;
 	void interrupt() override;
+	void setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths) override;
+	void setErrorClaimFunction(
+		std::function<bool(const std::string& errorKey, const FilePath& translationUnit)>
+			claimError) override;
 
 private:
 	virtual void doIndex(
@@ -24,6 +34,19 @@ private:
 		std::shared_ptr<ParserClientImpl> parserClient,
 		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo) = 0;
 
+	// indexes each command on its own by default
+	virtual void doIndexBatch(
+		const std::vector<std::shared_ptr<T>>& indexerCommands,
+		const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo);
+
+	std::shared_ptr<T> castIndexerCommand(std::shared_ptr<IndexerCommand> indexerCommand) const;
+	void finishStorage(
+		std::shared_ptr<T> indexerCommand,
+		std::shared_ptr<IntermediateStorage> storage,
+		std::shared_ptr<ParserClientImpl> parserClient,
+		size_t durationMs) const;
+
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
 };
 
@@ -46,41 +69,138 @@ void Indexer<T>::interrupt()
 	m_indexerStateInfo->indexingInterrupted = true;
 }
 
+template <typename T>
+void Indexer<T>::setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths)
+{
+	m_indexerStateInfo->alreadyIndexedFilePaths = filePaths;
+}
+
+template <typename T>
+void Indexer<T>::setErrorClaimFunction(
+	std::function<bool(const std::string& errorKey, const FilePath& translationUnit)> claimError)
+{
+	m_indexerStateInfo->claimError = claimError;
+}
+
 template <typename T>
 std::shared_ptr<IntermediateStorage> Indexer<T>::index(std::shared_ptr<IndexerCommand> indexerCommand)
 {
-	std::shared_ptr<T> castCommand = std::dynamic_pointer_cast<T>(indexerCommand);
+	std::shared_ptr<T> castCommand = castIndexerCommand(indexerCommand);
 	if (!castCommand)
 	{
-		LOG_ERROR(
-			"Trying to process " +
-			indexerCommandTypeToString(indexerCommand->getIndexerCommandType()) +
-			" indexer command with indexer that supports \"" +
-			indexerCommandTypeToString(getSupportedIndexerCommandType()) + "\".");
-
 		return nullptr;
 	}
 
 	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 	std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(storage.get());
 
+	const TimeStamp start = TimeStamp::now();
+
 	doIndex(castCommand, parserClient, m_indexerStateInfo);
 
-	if (storage->hasFatalErrors())
+	finishStorage(castCommand, storage, parserClient, TimeStamp::now().deltaMS(start));
+
+	if (m_indexerStateInfo->indexingInterrupted)
 	{
-		storage->setAllFilesIncomplete();
+		return nullptr;
 	}
-	else
+
+	return storage;
+}
+
+template <typename T>
+std::vector<std::shared_ptr<IntermediateStorage>> Indexer<T>::indexBatch(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands)
+{
+	std::vector<std::shared_ptr<T>> castCommands;
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	std::vector<std::shared_ptr<ParserClientImpl>> parserClients;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
 	{
-		storage->setFilesWithErrorsIncomplete();
+		std::shared_ptr<T> castCommand = castIndexerCommand(indexerCommand);
+		if (!castCommand)
+		{
+			return std::vector<std::shared_ptr<IntermediateStorage>>(indexerCommands.size());
+		}
+
+		castCommands.push_back(castCommand);
+		storages.push_back(std::make_shared<IntermediateStorage>());
+		parserClients.push_back(std::make_shared<ParserClientImpl>(storages.back().get()));
+	}
+
+	const TimeStamp start = TimeStamp::now();
+
+	doIndexBatch(castCommands, parserClients, m_indexerStateInfo);
+
+	// the files of a batch are indexed together, so each of them gets an equal share of the time
+	const size_t durationMs = TimeStamp::now().deltaMS(start) / std::max<size_t>(1, storages.size());
+	for (size_t i = 0; i < storages.size(); i++)
+	{
+		finishStorage(castCommands[i], storages[i], parserClients[i], durationMs);
 	}
 
 	if (m_indexerStateInfo->indexingInterrupted)
 	{
-		return nullptr;
+		return std::vector<std::shared_ptr<IntermediateStorage>>(indexerCommands.size());
 	}
 
-	return storage;
+	return storages;
+}
+
+template <typename T>
+void Indexer<T>::doIndexBatch(
+	const std::vector<std::shared_ptr<T>>& indexerCommands,
+	const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo)
+{
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		doIndex(indexerCommands[i], parserClients[i], m_indexerStateInfo);
+	}
+}
+
+template <typename T>
+std::shared_ptr<T> Indexer<T>::castIndexerCommand(
+	std::shared_ptr<IndexerCommand> indexerCommand) const
+{
+	std::shared_ptr<T> castCommand = std::dynamic_pointer_cast<T>(indexerCommand);
+	if (!castCommand)
+	{
+		LOG_ERROR(
+			"Trying to process " +
+			indexerCommandTypeToString(indexerCommand->getIndexerCommandType()) +
+			" indexer command with indexer that supports \"" +
+			indexerCommandTypeToString(getSupportedIndexerCommandType()) + "\".");
+	}
+	return castCommand;
+}
+
+template <typename T>
+void Indexer<T>::finishStorage(
+	std::shared_ptr<T> indexerCommand,
+	std::shared_ptr<IntermediateStorage> storage,
+	std::shared_ptr<ParserClientImpl> parserClient,
+	size_t durationMs) const
+{
+	const size_t visitDurationMs = std::min(durationMs, parserClient->getVisitDurationMs());
+	storage->addIndexingTimes({StorageIndexingTime(
+		indexerCommand->getSourceFilePath().wstr(),
+		durationMs,
+		durationMs - visitDurationMs,
+		visitDurationMs,
+		utility::getPeakMemoryUsageKb(),
+		storage->getByteSize(sizeof(std::wstring)),
+		std::min(durationMs, parserClient->getGarbageCollectionDurationMs()))});
+
+	if (storage->hasFatalErrors())
+	{
+		storage->setAllFilesIncomplete();
+	}
+	else
+	{
+		storage->setFilesWithErrorsIncomplete();
+		storage->setFilesIncomplete(parserClient->getIncompleteFileIds());
+	}
 }
 
 #endif	  // INDEXER_H
@@ -1,3 +1,19 @@
 #include "IndexerBase.h"
 
 IndexerBase::IndexerBase() {}
+
+size_t IndexerBase::getBatchSize(IndexerCommandType type) const
+{
+	return 1;
+}
+
+std::vector<std::shared_ptr<IntermediateStorage>> IndexerBase::indexBatch(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands)
+{
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		storages.push_back(index(indexerCommand));
+	}
+	return storages;
+}
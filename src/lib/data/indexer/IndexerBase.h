@@ -1,11 +1,15 @@
 #ifndef INDEXER_BASE_H
 #define INDEXER_BASE_H
 
+#include <functional>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "IndexerCommandType.h"
 
+class FilePath;
 class FileRegister;
 class IndexerCommand;
 class IntermediateStorage;
@@ -20,6 +24,22 @@ public:
 	virtual std::shared_ptr<IntermediateStorage> index(
 		std::shared_ptr<IndexerCommand> indexerCommand) = 0;
 	virtual void interrupt() = 0;
+
+	// number of commands of that type that should be passed to indexBatch at once
+	virtual size_t getBatchSize(IndexerCommandType type) const;
+
+	// returns one storage per command, indexes each command on its own by default
+	virtual std::vector<std::shared_ptr<IntermediateStorage>> indexBatch(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands);
+
+	// declarations in these files are not visited again by the next call to index
+	virtual void setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths) = 0;
+
+	// errors the function returns false for are not recorded, they were recorded by another
+	// translation unit already
+	virtual void setErrorClaimFunction(
+		std::function<bool(const std::string& errorKey, const FilePath& translationUnit)>
+			claimError) = 0;
 };
 
 #endif	  // INDEXER_BASE_H
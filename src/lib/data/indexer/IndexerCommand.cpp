@@ -20,6 +20,11 @@ size_t IndexerCommand::getByteSize(size_t stringSize) const
 	return utility::encodeToUtf8(m_sourceFilePath.wstr()).size();
 }
 
+std::wstring IndexerCommand::getPreprocessorContextKey() const
+{
+	return L"";
+}
+
 const FilePath& IndexerCommand::getSourceFilePath() const
 {
 	return m_sourceFilePath;
@@ -23,6 +23,10 @@ public:
 
 	virtual size_t getByteSize(size_t stringSize) const;
 
+	// commands with the same non empty key see the same headers the same way, except for macros
+	// defined in the source file itself
+	virtual std::wstring getPreprocessorContextKey() const;
+
 	const FilePath& getSourceFilePath() const;
 
 protected:
@@ -24,6 +24,7 @@ IndexerCommandCustom::IndexerCommandCustom(
 	, m_databaseFilePath(databaseFilePath)
 	, m_databaseVersion(databaseVersion)
 	, m_runInParallel(runInParallel)
+	, m_executionOrder(0)
 {
 }
 
@@ -42,6 +43,7 @@ IndexerCommandCustom::IndexerCommandCustom(
 	, m_databaseFilePath(databaseFilePath)
 	, m_databaseVersion(databaseVersion)
 	, m_runInParallel(runInParallel)
+	, m_executionOrder(0)
 {
 }
 
@@ -87,6 +89,16 @@ bool IndexerCommandCustom::getRunInParallel() const
 	return m_runInParallel;
 }
 
+int IndexerCommandCustom::getExecutionOrder() const
+{
+	return m_executionOrder;
+}
+
+void IndexerCommandCustom::setExecutionOrder(int executionOrder)
+{
+	m_executionOrder = executionOrder;
+}
+
 QJsonObject IndexerCommandCustom::doSerialize() const
 {
 	QJsonObject jsonObject = IndexerCommand::doSerialize();
@@ -97,6 +109,9 @@ QJsonObject IndexerCommandCustom::doSerialize() const
 	{
 		jsonObject["run_in_parallel"] = m_runInParallel;
 	}
+	{
+		jsonObject["execution_order"] = m_executionOrder;
+	}
 
 	return jsonObject;
 }
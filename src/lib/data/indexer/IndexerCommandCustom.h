@@ -37,6 +37,9 @@ public:
 	std::wstring getCustomCommand() const;
 	bool getRunInParallel() const;
 
+	int getExecutionOrder() const;
+	void setExecutionOrder(int executionOrder);
+
 protected:
 	QJsonObject doSerialize() const override;
 
@@ -47,6 +50,7 @@ private:
 	FilePath m_databaseFilePath;
 	std::wstring m_databaseVersion;
 	bool m_runInParallel;
+	int m_executionOrder;
 };
 
 #endif	  // INDEXER_COMMAND_CXXL_H
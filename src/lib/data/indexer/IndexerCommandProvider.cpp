@@ -1,6 +1,55 @@
 #include "IndexerCommandProvider.h"
 
+#include <algorithm>
+#include <map>
+
+#include "FilePath.h"
+
 bool IndexerCommandProvider::empty() const
 {
 	return size() == 0;
 }
+
+size_t IndexerCommandProvider::getClusterKey(const FilePath& filePath) const
+{
+	return 0;
+}
+
+std::vector<FilePath> IndexerCommandProvider::clusterSourceFilePaths(
+	const std::vector<FilePath>& filePaths, size_t windowSize) const
+{
+	std::vector<FilePath> clusteredFilePaths;
+	clusteredFilePaths.reserve(filePaths.size());
+
+	for (size_t start = 0; start < filePaths.size(); start += windowSize)
+	{
+		const size_t end = std::min(start + windowSize, filePaths.size());
+
+		// clusters are ordered by their first path
+		std::map<size_t, size_t> clusterIndices;
+		std::vector<std::vector<FilePath>> clusters;
+		for (size_t i = start; i < end; i++)
+		{
+			const size_t key = getClusterKey(filePaths[i]);
+			if (!key)
+			{
+				clusters.push_back({filePaths[i]});
+				continue;
+			}
+
+			auto it = clusterIndices.emplace(key, clusters.size()).first;
+			if (it->second == clusters.size())
+			{
+				clusters.emplace_back();
+			}
+			clusters[it->second].push_back(filePaths[i]);
+		}
+
+		for (const std::vector<FilePath>& cluster: clusters)
+		{
+			clusteredFilePaths.insert(clusteredFilePaths.end(), cluster.begin(), cluster.end());
+		}
+	}
+
+	return clusteredFilePaths;
+}
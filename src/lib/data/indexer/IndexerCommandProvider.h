@@ -18,6 +18,14 @@ public:
 	virtual void clear() = 0;
 	virtual size_t size() const = 0;
 	bool empty() const;
+
+	// commands with the same non zero key share their compiler flags
+	virtual size_t getClusterKey(const FilePath& filePath) const;
+
+	// moves the paths of commands with the same cluster key next to each other, paths are only
+	// moved within windows of the given size to roughly keep the order of the paths
+	std::vector<FilePath> clusterSourceFilePaths(
+		const std::vector<FilePath>& filePaths, size_t windowSize) const;
 };
 
 #endif	  // INDEXER_COMMAND_PROVIDER_H
@@ -30,6 +30,39 @@ std::shared_ptr<IntermediateStorage> IndexerComposite::index(std::shared_ptr<Ind
 	return std::shared_ptr<IntermediateStorage>();
 }
 
+size_t IndexerComposite::getBatchSize(IndexerCommandType type) const
+{
+	auto it = m_indexers.find(type);
+	if (it != m_indexers.end())
+	{
+		return it->second->getBatchSize(type);
+	}
+	return 1;
+}
+
+std::vector<std::shared_ptr<IntermediateStorage>> IndexerComposite::indexBatch(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands)
+{
+	if (!indexerCommands.empty())
+	{
+		const IndexerCommandType type = indexerCommands.front()->getIndexerCommandType();
+
+		bool sameType = true;
+		for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+		{
+			sameType = sameType && indexerCommand->getIndexerCommandType() == type;
+		}
+
+		auto it = m_indexers.find(type);
+		if (sameType && it != m_indexers.end())
+		{
+			return it->second->indexBatch(indexerCommands);
+		}
+	}
+
+	return IndexerBase::indexBatch(indexerCommands);
+}
+
 void IndexerComposite::interrupt()
 {
 	for (auto& it: m_indexers)
@@ -37,3 +70,20 @@ void IndexerComposite::interrupt()
 		it.second->interrupt();
 	}
 }
+
+void IndexerComposite::setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths)
+{
+	for (auto& it: m_indexers)
+	{
+		it.second->setAlreadyIndexedFilePaths(filePaths);
+	}
+}
+
+void IndexerComposite::setErrorClaimFunction(
+	std::function<bool(const std::string& errorKey, const FilePath& translationUnit)> claimError)
+{
+	for (auto& it: m_indexers)
+	{
+		it.second->setErrorClaimFunction(claimError);
+	}
+}
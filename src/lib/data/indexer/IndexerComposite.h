@@ -17,7 +17,15 @@ public:
 
 	std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
 
+	size_t getBatchSize(IndexerCommandType type) const override;
+	std::vector<std::shared_ptr<IntermediateStorage>> indexBatch(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands) override;
+
 	void interrupt() override;
+	void setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths) override;
+	void setErrorClaimFunction(
+		std::function<bool(const std::string& errorKey, const FilePath& translationUnit)>
+			claimError) override;
 
 private:
 	std::map<IndexerCommandType, std::shared_ptr<IndexerBase>> m_indexers;
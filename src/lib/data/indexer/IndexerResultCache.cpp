@@ -0,0 +1,134 @@
+#include "IndexerResultCache.h"
+
+#include "ApplicationSettings.h"
+#include "FileSystem.h"
+#include "IndexerCommand.h"
+#include "IntermediateStorage.h"
+#include "PersistentStorage.h"
+#include "TextAccess.h"
+#include "TextLayoutMapping.h"
+#include "Version.h"
+#include "logging.h"
+#include "utilityString.h"
+#include "utilityUuid.h"
+
+std::string IndexerResultCache::getKey(std::shared_ptr<const IndexerCommand> indexerCommand)
+{
+	// settings that change what the indexers record are part of the key as well
+	const ApplicationSettings* settings = ApplicationSettings::getInstance().get();
+	std::string content = Version::getApplicationVersion().toString() + "\n" +
+		std::to_string(settings->getCxxBraceRecordingEnabled()) +
+		std::to_string(settings->getCxxCommentRecordingEnabled()) + "\n" +
+		utility::encodeToUtf8(IndexerCommand::serialize(indexerCommand)) + "\n" +
+		TextAccess::createFromFile(indexerCommand->getSourceFilePath())->getText();
+	return TextLayoutMapping::getContentHash(content);
+}
+
+IndexerResultCache::IndexerResultCache(const FilePath& cacheDirectoryPath)
+	: m_cacheDirectoryPath(cacheDirectoryPath)
+{
+}
+
+const FilePath& IndexerResultCache::getCacheDirectoryPath() const
+{
+	return m_cacheDirectoryPath;
+}
+
+std::shared_ptr<IntermediateStorage> IndexerResultCache::load(
+	std::shared_ptr<const IndexerCommand> indexerCommand) const
+{
+	// a broken entry just means that the translation unit gets indexed again
+	try
+	{
+		return doLoad(indexerCommand);
+	}
+	catch (...)
+	{
+		LOG_WARNING(
+			L"Failed to load cached index of " + indexerCommand->getSourceFilePath().wstr());
+	}
+	return nullptr;
+}
+
+void IndexerResultCache::store(
+	std::shared_ptr<const IndexerCommand> indexerCommand,
+	std::shared_ptr<IntermediateStorage> storage) const
+{
+	try
+	{
+		doStore(indexerCommand, storage);
+	}
+	catch (...)
+	{
+		LOG_WARNING(
+			L"Failed to store index of " + indexerCommand->getSourceFilePath().wstr() +
+			L" in cache " + m_cacheDirectoryPath.wstr());
+	}
+}
+
+std::shared_ptr<IntermediateStorage> IndexerResultCache::doLoad(
+	std::shared_ptr<const IndexerCommand> indexerCommand) const
+{
+	const FilePath entryFilePath = getEntryFilePath(getKey(indexerCommand));
+	if (!entryFilePath.exists())
+	{
+		return nullptr;
+	}
+
+	PersistentStorage entryStorage(entryFilePath, FilePath());
+	entryStorage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+	if (entryStorage.isEmpty() || entryStorage.isIncompatible())
+	{
+		return nullptr;
+	}
+
+	for (const auto& p: entryStorage.getFileContentHashesForAllFiles())
+	{
+		if (!p.first.exists() ||
+			TextLayoutMapping::getContentHash(TextAccess::createFromFile(p.first)->getText()) !=
+				p.second)
+		{
+			LOG_INFO(
+				L"Cached index of " + indexerCommand->getSourceFilePath().wstr() +
+				L" is outdated, changed file: " + p.first.wstr());
+			return nullptr;
+		}
+	}
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	storage->inject(&entryStorage);
+	return storage;
+}
+
+void IndexerResultCache::doStore(
+	std::shared_ptr<const IndexerCommand> indexerCommand,
+	std::shared_ptr<IntermediateStorage> storage) const
+{
+	const FilePath entryFilePath = getEntryFilePath(getKey(indexerCommand));
+	const FilePath tempEntryFilePath = m_cacheDirectoryPath.getConcatenated(
+		entryFilePath.fileName() + L"." + utility::decodeFromUtf8(utility::getUuidString()) +
+		L".tmp");
+
+	FileSystem::createDirectory(m_cacheDirectoryPath);
+	{
+		PersistentStorage entryStorage(tempEntryFilePath, FilePath());
+		entryStorage.setup();
+		entryStorage.updateVersion();
+		entryStorage.inject(storage.get());
+	}
+
+	// another process may have stored the same entry meanwhile, which is just as good
+	if (!FileSystem::rename(tempEntryFilePath, entryFilePath))
+	{
+		FileSystem::remove(tempEntryFilePath);
+	}
+	else
+	{
+		LOG_INFO(L"Stored index of " + indexerCommand->getSourceFilePath().wstr() + L" in cache");
+	}
+}
+
+FilePath IndexerResultCache::getEntryFilePath(const std::string& key) const
+{
+	return m_cacheDirectoryPath.getConcatenated(utility::decodeFromUtf8(key) + L".srctrldb");
+}
@@ -0,0 +1,46 @@
+#ifndef INDEXER_RESULT_CACHE_H
+#define INDEXER_RESULT_CACHE_H
+
+#include <memory>
+#include <string>
+
+#include "FilePath.h"
+
+class IndexerCommand;
+class IntermediateStorage;
+
+// Keeps the indexed data of translation units in a directory, so indexing can skip parsing a
+// translation unit that was already indexed with the same command, on this or on any other machine
+// that shares the directory. Each entry is a small index database named by the hash of the command,
+// the source file and the indexer settings. An entry is only used if all files it indexed still
+// have the content they had while indexing, which covers the headers resolved from the includes.
+class IndexerResultCache
+{
+public:
+	static std::string getKey(std::shared_ptr<const IndexerCommand> indexerCommand);
+
+	IndexerResultCache(const FilePath& cacheDirectoryPath);
+
+	const FilePath& getCacheDirectoryPath() const;
+
+	// returns nullptr if there is no valid entry for the command
+	std::shared_ptr<IntermediateStorage> load(
+		std::shared_ptr<const IndexerCommand> indexerCommand) const;
+
+	// entries are written to a temporary file first, so other processes never read half of one
+	void store(
+		std::shared_ptr<const IndexerCommand> indexerCommand,
+		std::shared_ptr<IntermediateStorage> storage) const;
+
+private:
+	std::shared_ptr<IntermediateStorage> doLoad(
+		std::shared_ptr<const IndexerCommand> indexerCommand) const;
+	void doStore(
+		std::shared_ptr<const IndexerCommand> indexerCommand,
+		std::shared_ptr<IntermediateStorage> storage) const;
+	FilePath getEntryFilePath(const std::string& key) const;
+
+	const FilePath m_cacheDirectoryPath;
+};
+
+#endif	  // INDEXER_RESULT_CACHE_H
@@ -1,10 +1,20 @@
 #ifndef INDEXER_STATE_INFO_H
 #define INDEXER_STATE_INFO_H
 
+#include <functional>
+#include <set>
+#include <string>
+
+#include "FilePath.h"
+
 struct IndexerStateInfo
 {
 public:
 	bool indexingInterrupted;
+	std::set<FilePath> alreadyIndexedFilePaths;
+
+	// returns false for errors another translation unit recorded in this indexing run already
+	std::function<bool(const std::string& errorKey, const FilePath& translationUnit)> claimError;
 };
 
 #endif	  // INDEXER_STATE_INFO_H
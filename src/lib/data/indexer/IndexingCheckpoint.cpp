@@ -0,0 +1,89 @@
+#include "IndexingCheckpoint.h"
+
+#include <fstream>
+
+#include "FileSystem.h"
+#include "logging.h"
+#include "utilityString.h"
+
+FilePath IndexingCheckpoint::getFilePath(const FilePath& tempIndexDbFilePath)
+{
+	return FilePath(tempIndexDbFilePath.wstr() + L"_checkpoint");
+}
+
+IndexingCheckpoint::IndexingCheckpoint(const FilePath& filePath): m_filePath(filePath) {}
+
+bool IndexingCheckpoint::exists() const
+{
+	return m_filePath.exists();
+}
+
+void IndexingCheckpoint::start(const std::string& revision)
+{
+	std::ofstream fileStream(m_filePath.str(), std::ios::out | std::ios::trunc);
+	fileStream << revision << '\n';
+	if (!fileStream)
+	{
+		LOG_WARNING(L"Unable to write indexing checkpoint \"" + m_filePath.wstr() + L"\"");
+	}
+}
+
+void IndexingCheckpoint::addCompletedSourceFilePaths(const std::vector<FilePath>& filePaths)
+{
+	if (filePaths.empty())
+	{
+		return;
+	}
+
+	std::string content;
+	for (const FilePath& filePath: filePaths)
+	{
+		content += utility::encodeToUtf8(filePath.wstr()) + '\n';
+	}
+
+	std::ofstream fileStream(m_filePath.str(), std::ios::out | std::ios::app);
+	fileStream << content;
+	fileStream.flush();
+}
+
+void IndexingCheckpoint::remove()
+{
+	if (exists())
+	{
+		FileSystem::remove(m_filePath);
+	}
+}
+
+std::string IndexingCheckpoint::getRevision() const
+{
+	const std::vector<std::string> lines = readLines();
+	return lines.empty() ? "" : lines.front();
+}
+
+std::set<FilePath> IndexingCheckpoint::getCompletedSourceFilePaths() const
+{
+	std::set<FilePath> filePaths;
+
+	const std::vector<std::string> lines = readLines();
+	for (size_t i = 1; i < lines.size(); i++)
+	{
+		if (!lines[i].empty())
+		{
+			filePaths.insert(FilePath(utility::decodeFromUtf8(lines[i])));
+		}
+	}
+	return filePaths;
+}
+
+std::vector<std::string> IndexingCheckpoint::readLines() const
+{
+	std::vector<std::string> lines;
+
+	std::ifstream fileStream(m_filePath.str());
+	std::string line;
+	while (std::getline(fileStream, line))
+	{
+		lines.push_back(line);
+	}
+	return lines;
+}
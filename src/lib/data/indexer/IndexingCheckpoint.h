@@ -0,0 +1,37 @@
+#ifndef INDEXING_CHECKPOINT_H
+#define INDEXING_CHECKPOINT_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+
+// Lists the source files whose indexed data was committed to the temp database of an indexing
+// run, next to that database. A run that was killed can keep the temp database and only has to
+// index the remaining files. Files are only added after the transaction containing them was
+// committed, so the list never names data that is missing from the database.
+class IndexingCheckpoint
+{
+public:
+	static FilePath getFilePath(const FilePath& tempIndexDbFilePath);
+
+	IndexingCheckpoint(const FilePath& filePath);
+
+	bool exists() const;
+
+	// starts an empty list for the run that writes the database with this revision
+	void start(const std::string& revision);
+	void addCompletedSourceFilePaths(const std::vector<FilePath>& filePaths);
+	void remove();
+
+	std::string getRevision() const;
+	std::set<FilePath> getCompletedSourceFilePaths() const;
+
+private:
+	std::vector<std::string> readLines() const;
+
+	const FilePath m_filePath;
+};
+
+#endif	  // INDEXING_CHECKPOINT_H
@@ -0,0 +1,54 @@
+#include "IndexingThrottle.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "UserActivity.h"
+
+const size_t IndexingThrottle::s_userIdleMs = 2000;
+const double IndexingThrottle::s_activeInjectionShare = 0.2;
+
+IndexingThrottle* IndexingThrottle::getInstance()
+{
+	static std::shared_ptr<IndexingThrottle> instance = std::make_shared<IndexingThrottle>();
+	return instance.get();
+}
+
+IndexingThrottle::IndexingThrottle()
+	: m_enabled(false), m_injectionBucket(100, s_activeInjectionShare * 1000)
+{
+}
+
+void IndexingThrottle::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+bool IndexingThrottle::isThrottling() const
+{
+	return m_enabled && UserActivity::getIdleMs() < s_userIdleMs;
+}
+
+bool IndexingThrottle::canInject()
+{
+	if (!isThrottling())
+	{
+		m_injectionBucket.fill();
+		return true;
+	}
+	return m_injectionBucket.hasTokens();
+}
+
+void IndexingThrottle::addInjectionDuration(size_t durationMs)
+{
+	m_injectionBucket.consume(double(durationMs));
+}
+
+size_t IndexingThrottle::getAllowedIndexerCount(size_t indexerCount) const
+{
+	if (!isThrottling())
+	{
+		return indexerCount;
+	}
+	return std::max<size_t>(1, indexerCount / 2);
+}
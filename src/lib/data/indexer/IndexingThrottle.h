@@ -0,0 +1,39 @@
+#ifndef INDEXING_THROTTLE_H
+#define INDEXING_THROTTLE_H
+
+#include <atomic>
+#include <cstddef>
+
+#include "TokenBucket.h"
+
+// Keeps browsing responsive while the gui indexes. As long as the user interacts with the app,
+// injecting storages only takes a share of the time, metered by a bucket of milliseconds that
+// injections consume, and only part of the indexers start new files. Once the user has been idle
+// for a while, indexing runs at full speed again.
+class IndexingThrottle
+{
+public:
+	static IndexingThrottle* getInstance();
+
+	IndexingThrottle();
+
+	void setEnabled(bool enabled);
+
+	// enabled and the user was active recently
+	bool isThrottling() const;
+
+	// false if injecting should yield the index to the user for now
+	bool canInject();
+	void addInjectionDuration(size_t durationMs);
+
+	size_t getAllowedIndexerCount(size_t indexerCount) const;
+
+private:
+	static const size_t s_userIdleMs;
+	static const double s_activeInjectionShare;
+
+	std::atomic<bool> m_enabled;
+	TokenBucket m_injectionBucket;
+};
+
+#endif	  // INDEXING_THROTTLE_H
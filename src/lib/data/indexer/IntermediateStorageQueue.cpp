@@ -0,0 +1,26 @@
+#include "IntermediateStorageQueue.h"
+
+void IntermediateStorageQueue::push(std::shared_ptr<IntermediateStorage> storage)
+{
+	std::lock_guard<std::mutex> lock(m_storagesMutex);
+	m_storages.push_back(std::move(storage));
+}
+
+std::shared_ptr<IntermediateStorage> IntermediateStorageQueue::pop()
+{
+	std::lock_guard<std::mutex> lock(m_storagesMutex);
+	if (m_storages.empty())
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<IntermediateStorage> storage = std::move(m_storages.front());
+	m_storages.pop_front();
+	return storage;
+}
+
+size_t IntermediateStorageQueue::getSize() const
+{
+	std::lock_guard<std::mutex> lock(m_storagesMutex);
+	return m_storages.size();
+}
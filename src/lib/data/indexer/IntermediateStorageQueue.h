@@ -0,0 +1,27 @@
+#ifndef INTERMEDIATE_STORAGE_QUEUE_H
+#define INTERMEDIATE_STORAGE_QUEUE_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+class IntermediateStorage;
+
+// Hands the storages of an indexer thread to the app within the same process. Unlike the shared
+// memory of indexer processes, the storages are moved instead of being copied twice.
+class IntermediateStorageQueue
+{
+public:
+	void push(std::shared_ptr<IntermediateStorage> storage);
+
+	// returns empty shared_ptr if no storages available
+	std::shared_ptr<IntermediateStorage> pop();
+
+	size_t getSize() const;
+
+private:
+	std::deque<std::shared_ptr<IntermediateStorage>> m_storages;
+	mutable std::mutex m_storagesMutex;
+};
+
+#endif	  // INTERMEDIATE_STORAGE_QUEUE_H
@@ -1,36 +1,32 @@
 #include "TaskBuildIndex.h"
 
-#include "AppPath.h"
 #include "Blackboard.h"
 #include "DialogView.h"
-#include "FileLogger.h"
+#include "IndexerProcessPool.h"
+#include "IndexingThrottle.h"
+#include "IntermediateStorageQueue.h"
 #include "InterprocessIndexer.h"
 #include "MessageIndexingStatus.h"
 #include "MessageStatus.h"
+#include "MetricsRegistry.h"
 #include "ParserClientImpl.h"
 #include "StorageProvider.h"
 #include "TimeStamp.h"
-#include "UserPaths.h"
 #include "utilityApp.h"
 
-
-#if _WIN32
-const std::wstring TaskBuildIndex::s_processName(L"sourcetrail_indexer.exe");
-#else
-const std::wstring TaskBuildIndex::s_processName(L"sourcetrail_indexer");
-#endif
-
 TaskBuildIndex::TaskBuildIndex(
 	size_t processCount,
 	std::shared_ptr<StorageProvider> storageProvider,
 	std::shared_ptr<DialogView> dialogView,
 	const std::string& appUUID,
-	bool multiProcessIndexing)
+	std::shared_ptr<IndexerProcessPool> processPool)
 	: m_storageProvider(storageProvider)
 	, m_dialogView(dialogView)
 	, m_appUUID(appUUID)
-	, m_multiProcessIndexing(multiProcessIndexing)
-	, m_interprocessIndexingStatusManager(appUUID, 0, true)
+	, m_processPool(processPool)
+	, m_interprocessIndexingStatusManager(appUUID, 0, !processPool)
+	, m_statusRevision(0)
+	, m_allowedIndexerCount(0)
 	, m_indexerCommandQueueStopped(false)
 	, m_processCount(processCount)
 	, m_interrupted(false)
@@ -46,14 +42,15 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 	m_indexingFileCount = 0;
 	updateIndexingDialog(blackboard, std::vector<FilePath>());
 
-	std::wstring logFilePath;
-	Logger* logger = LogManager::getInstance()->getLoggerByType("FileLogger");
-	if (logger)
+	if (m_processPool)
 	{
-		logFilePath = dynamic_cast<FileLogger*>(logger)->getLogFilePath().wstr();
+		// the processes of the pool are already running and pick up the queued commands
+		m_interprocessIntermediateStorageManagers = m_processPool->getIntermediateStorageManagers();
+		blackboard->set<bool>("indexer_threads_started", true);
+		return;
 	}
 
-	// start indexer processes
+	// start indexer threads
 	for (unsigned int i = 0; i < m_processCount; i++)
 	{
 		{
@@ -63,19 +60,12 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 
 		const int processId = i + 1;	// 0 remains reserved for the main process
 
-		m_interprocessIntermediateStorageManagers.push_back(
-			std::make_shared<InterprocessIntermediateStorageManager>(m_appUUID, processId, true));
+		std::shared_ptr<IntermediateStorageQueue> storageQueue =
+			std::make_shared<IntermediateStorageQueue>();
+		m_intermediateStorageQueues.push_back(storageQueue);
 
-		if (m_multiProcessIndexing)
-		{
-			m_processThreads.push_back(
-				new std::thread(&TaskBuildIndex::runIndexerProcess, this, processId, logFilePath));
-		}
-		else
-		{
-			m_processThreads.push_back(
-				new std::thread(&TaskBuildIndex::runIndexerThread, this, processId));
-		}
+		m_processThreads.push_back(
+			new std::thread(&TaskBuildIndex::runIndexerThread, this, processId, storageQueue));
 	}
 
 	blackboard->set<bool>("indexer_threads_started", true);
@@ -84,12 +74,47 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
 	size_t runningThreadCount = 0;
+	if (m_processPool)
+	{
+		if (!m_processPool->getRunningProcessCount())
+		{
+			setInterrupted();
+		}
+		else if (!m_processPool->isIdle())
+		{
+			runningThreadCount = 1;
+		}
+	}
+	else
 	{
 		std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
 		runningThreadCount = m_runningThreadCount;
 	}
 
-	blackboard->get<bool>("indexer_command_queue_stopped", m_indexerCommandQueueStopped);
+	static MetricGauge& runningIndexerGauge = MetricsRegistry::getInstance()->getGauge(
+		"sourcetrail_indexing_running_indexers", "Indexer threads or processes that are busy");
+	runningIndexerGauge.set(double(runningThreadCount));
+
+	const size_t indexerCount = m_processPool ? m_processPool->getProcessCount() : m_processCount;
+	const size_t allowedIndexerCount =
+		IndexingThrottle::getInstance()->getAllowedIndexerCount(indexerCount);
+	if (allowedIndexerCount != m_allowedIndexerCount)
+	{
+		m_allowedIndexerCount = allowedIndexerCount;
+		m_interprocessIndexingStatusManager.setAllowedIndexerCount(
+			allowedIndexerCount < indexerCount ? allowedIndexerCount : 0);
+	}
+
+	bool indexerCommandQueueStopped = false;
+	blackboard->get<bool>("indexer_command_queue_stopped", indexerCommandQueueStopped);
+	if (indexerCommandQueueStopped && !m_indexerCommandQueueStopped)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
+			m_indexerCommandQueueStopped = true;
+		}
+		m_indexerThreadsCondition.notify_all();
+	}
 
 	const std::vector<FilePath> indexingFiles =
 		m_interprocessIndexingStatusManager.getCurrentlyIndexedSourceFilePaths();
@@ -115,7 +140,10 @@ Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
 		updateIndexingDialog(blackboard, std::vector<FilePath>());
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	// indexers notify when they start or finish a file, become idle or quit, so the timeout only
+	// matters for crashed processes
+	m_statusRevision = m_interprocessIndexingStatusManager.waitForStatusChange(
+		m_statusRevision, 250);
 
 	return STATE_RUNNING;
 }
@@ -129,6 +157,15 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard)
 	}
 	m_processThreads.clear();
 
+	if (m_processPool)
+	{
+		// interrupted processes quit, wait for them so the next run starts from a clean state
+		while (m_processPool->getRunningProcessCount() && !m_processPool->isIdle())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
+	}
+
 	if (!m_interrupted)
 	{
 		while (fetchIntermediateStorages(blackboard))
@@ -137,12 +174,35 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard)
 
 	std::vector<FilePath> crashedFiles =
 		m_interprocessIndexingStatusManager.getCrashedSourceFilePaths();
-	if (!crashedFiles.empty())
+	const std::vector<FilePath> isolatedFiles =
+		m_interprocessIndexingStatusManager.getIsolatedSourceFilePaths();
+	const std::vector<FilePath> memoryExceededFiles =
+		m_interprocessIndexingStatusManager.getMemoryExceededSourceFilePaths();
+	if (!crashedFiles.empty() || !isolatedFiles.empty() || !memoryExceededFiles.empty())
 	{
 		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 		std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(
 			storage.get());
 
+		const std::set<FilePath> memoryExceededFileSet(
+			memoryExceededFiles.begin(), memoryExceededFiles.end());
+		for (const FilePath& path: isolatedFiles)
+		{
+			const bool exceeded = memoryExceededFileSet.find(path) != memoryExceededFileSet.end();
+			Id fileId = parserClient->recordFile(path.getCanonical(), false);
+			parserClient->recordError(
+				exceeded ? L"The translation unit exceeded the memory limit of indexer processes, "
+						   L"also when it was indexed again in a separate process with a larger "
+						   L"limit. Please check the project setup or raise the memory limits."
+						 : L"The translation unit exceeded the memory limit of indexer processes "
+						   L"and was indexed again in a separate process with a larger limit.",
+				exceeded,
+				true,
+				path,
+				ParseLocation(fileId, 1, 1));
+			LOG_INFO(L"translation unit exceeding memory limit: " + path.wstr());
+		}
+
 		for (const FilePath& path: crashedFiles)
 		{
 			Id fileId = parserClient->recordFile(path.getCanonical(), false);
@@ -161,6 +221,15 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard)
 		m_storageProvider->insert(storage);
 	}
 
+	m_interprocessIndexingStatusManager.setAllowedIndexerCount(0);
+
+	if (m_processPool)
+	{
+		m_processPool->clear();
+		// lets the pool bring up the processes that quit on interruption right away
+		m_interprocessIndexingStatusManager.setIndexingInterrupted(false);
+	}
+
 	blackboard->set<bool>("indexer_threads_stopped", true);
 }
 
@@ -168,7 +237,7 @@ void TaskBuildIndex::doReset(std::shared_ptr<Blackboard> blackboard) {}
 
 void TaskBuildIndex::terminate()
 {
-	m_interrupted = true;
+	setInterrupted();
 	utility::killRunningProcesses();
 }
 
@@ -177,61 +246,27 @@ void TaskBuildIndex::handleMessage(MessageIndexingInterrupted* message)
 	LOG_INFO("sending indexer interrupt command.");
 
 	m_interprocessIndexingStatusManager.setIndexingInterrupted(true);
-	m_interrupted = true;
+	setInterrupted();
 
 	m_dialogView->showUnknownProgressDialog(
 		L"Interrupting Indexing", L"Waiting for indexer\nthreads to finish");
 }
 
-void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFilePath)
-{
-	const FilePath indexerProcessPath = AppPath::getAppPath().concatenate(s_processName);
-	if (!indexerProcessPath.exists())
-	{
-		m_interrupted = true;
-		LOG_ERROR(
-			L"Cannot start indexer process because executable is missing at \"" +
-			indexerProcessPath.wstr() + L"\"");
-		return;
-	}
-
-	const std::wstring commandPath = L"\"" + indexerProcessPath.wstr() + L"\"";
-	std::vector<std::wstring> commandArguments;
-	commandArguments.push_back(std::to_wstring(processId));
-	commandArguments.push_back(utility::decodeFromUtf8(m_appUUID));
-	commandArguments.push_back(L"\"" + AppPath::getAppPath().getAbsolute().wstr() + L"\"");
-	commandArguments.push_back(L"\"" + UserPaths::getUserDataPath().getAbsolute().wstr() + L"\"");
-
-	if (!logFilePath.empty())
-	{
-		commandArguments.push_back(L"\"" + logFilePath + L"\"");
-	}
-
-	int result = 1;
-	while ((!m_indexerCommandQueueStopped || result != 0) && !m_interrupted)
-	{
-		result = utility::executeProcessAndGetExitCode(commandPath, commandArguments, FilePath(), -1);
-
-		LOG_INFO_STREAM(<< "Indexer process " << processId << " returned with " + std::to_string(result));
-	}
-
-	{
-		std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
-		m_runningThreadCount--;
-	}
-}
-
-void TaskBuildIndex::runIndexerThread(int processId)
+void TaskBuildIndex::runIndexerThread(
+	int processId, std::shared_ptr<IntermediateStorageQueue> storageQueue)
 {
 	do
 	{
-		InterprocessIndexer indexer(m_appUUID, processId);
+		InterprocessIndexer indexer(m_appUUID, processId, storageQueue);
 		indexer.work();	   // this will only return if there are no indexer commands left in the queue
 		if (!m_interrupted)
 		{
 			// sleeping if interrupted may result in a crash due to objects that are already
 			// destroyed after waking up again
-			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			std::unique_lock<std::mutex> lock(m_runningThreadCountMutex);
+			m_indexerThreadsCondition.wait_for(lock, std::chrono::milliseconds(200), [this]() {
+				return m_indexerCommandQueueStopped || m_interrupted;
+			});
 		}
 	} while (!m_indexerCommandQueueStopped && !m_interrupted);
 
@@ -239,16 +274,40 @@ void TaskBuildIndex::runIndexerThread(int processId)
 		std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
 		m_runningThreadCount--;
 	}
+	m_indexerThreadsCondition.notify_all();
+	m_interprocessIndexingStatusManager.notifyStatusChange();
+}
+
+void TaskBuildIndex::setInterrupted()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
+		m_interrupted = true;
+	}
+	m_indexerThreadsCondition.notify_all();
+	m_interprocessIndexingStatusManager.notifyStatusChange();
 }
 
 bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> blackboard)
 {
+	static MetricGauge& queuedStorageGauge = MetricsRegistry::getInstance()->getGauge(
+		"sourcetrail_indexing_queued_storages", "Indexed storages waiting to be merged or injected");
+	static MetricCounter& fetchedStorageCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_indexing_fetched_storages_total", "Storages fetched from the indexers");
+	static MetricCounter& queueFullCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_indexing_queue_full_waits_total",
+		"Times fetching storages waited because too many were queued");
+
 	int poppedStorageCount = 0;
+	queuedStorageGauge.set(double(m_storageProvider->getStorageCount()));
 
-	int providerStorageCount = m_storageProvider->getStorageCount();
-	if (providerStorageCount > 10)
+	// indexer processes wait as well while their storages are not fetched
+	if (!m_storageProvider->canInsertStorage())
 	{
-		LOG_INFO_STREAM(<< "waiting, too many storages queued: " << providerStorageCount);
+		queueFullCounter.add();
+
+		LOG_INFO_STREAM(
+			<< "waiting, too many storages queued: " << m_storageProvider->getStorageCount());
 
 		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
@@ -259,29 +318,25 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 	do
 	{
 		Id finishedProcessId = m_interprocessIndexingStatusManager.getNextFinishedProcessId();
-		if (!finishedProcessId ||
-			finishedProcessId > m_interprocessIntermediateStorageManagers.size())
+		if (!finishedProcessId)
 		{
 			break;
 		}
 
-		std::shared_ptr<InterprocessIntermediateStorageManager> storageManager =
-			m_interprocessIntermediateStorageManagers[finishedProcessId - 1];
-
-		int storageCount = storageManager->getIntermediateStorageCount();
-		if (!storageCount)
+		std::shared_ptr<IntermediateStorage> storage = popIntermediateStorage(finishedProcessId);
+		if (!storage)
 		{
 			break;
 		}
 
-		LOG_INFO_STREAM(<< storageManager->getProcessId() << " - storage count: " << storageCount);
-		m_storageProvider->insert(storageManager->popIntermediateStorage());
+		m_storageProvider->insert(storage);
 		poppedStorageCount++;
 	} while (TimeStamp::now().deltaMS(t) <
 			 500);	  // don't process all storages at once to allow for status updates in-between
 
 	if (poppedStorageCount > 0)
 	{
+		fetchedStorageCounter.add(poppedStorageCount);
 		blackboard->update<int>(
 			"indexed_source_file_count", [=](int count) { return count + poppedStorageCount; });
 		return true;
@@ -290,6 +345,32 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 	return false;
 }
 
+std::shared_ptr<IntermediateStorage> TaskBuildIndex::popIntermediateStorage(Id processId)
+{
+	if (processId <= m_intermediateStorageQueues.size())
+	{
+		LOG_INFO_STREAM(
+			<< processId << " - storage count: "
+			<< m_intermediateStorageQueues[processId - 1]->getSize());
+		return m_intermediateStorageQueues[processId - 1]->pop();
+	}
+
+	if (processId <= m_interprocessIntermediateStorageManagers.size())
+	{
+		std::shared_ptr<InterprocessIntermediateStorageManager> storageManager =
+			m_interprocessIntermediateStorageManagers[processId - 1];
+
+		const int storageCount = storageManager->getIntermediateStorageCount();
+		if (storageCount)
+		{
+			LOG_INFO_STREAM(<< processId << " - storage count: " << storageCount);
+			return storageManager->popIntermediateStorage();
+		}
+	}
+
+	return nullptr;
+}
+
 void TaskBuildIndex::updateIndexingDialog(
 	std::shared_ptr<Blackboard> blackboard, const std::vector<FilePath>& sourcePaths)
 {
@@ -1,6 +1,7 @@
 #ifndef TASK_BUILD_INDEX_H
 #define TASK_BUILD_INDEX_H
 
+#include <condition_variable>
 #include <thread>
 
 #include "MessageIndexingInterrupted.h"
@@ -12,6 +13,8 @@
 #include "InterprocessIntermediateStorageManager.h"
 
 class DialogView;
+class IndexerProcessPool;
+class IntermediateStorageQueue;
 class StorageProvider;
 class IndexerCommandList;
 
@@ -25,7 +28,7 @@ public:
 		std::shared_ptr<StorageProvider> storageProvider,
 		std::shared_ptr<DialogView> dialogView,
 		const std::string& appUUID,
-		bool multiProcessIndexing);
+		std::shared_ptr<IndexerProcessPool> processPool);
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -36,21 +39,24 @@ protected:
 
 	void handleMessage(MessageIndexingInterrupted* message) override;
 
-	void runIndexerProcess(int processId, const std::wstring& logFilePath);
-	void runIndexerThread(int processId);
+	void runIndexerThread(int processId, std::shared_ptr<IntermediateStorageQueue> storageQueue);
+	void setInterrupted();
 	bool fetchIntermediateStorages(std::shared_ptr<Blackboard> blackboard);
+	std::shared_ptr<IntermediateStorage> popIntermediateStorage(Id processId);
 	void updateIndexingDialog(
 		std::shared_ptr<Blackboard> blackboard, const std::vector<FilePath>& sourcePaths);
 
-	static const std::wstring s_processName;
-
 	std::shared_ptr<IndexerCommandList> m_indexerCommandList;
 	std::shared_ptr<StorageProvider> m_storageProvider;
 	std::shared_ptr<DialogView> m_dialogView;
 	const std::string m_appUUID;
-	bool m_multiProcessIndexing;
+
+	// indexes in processes of the pool if set, otherwise in threads of this process
+	std::shared_ptr<IndexerProcessPool> m_processPool;
 
 	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
+	size_t m_statusRevision;
+	size_t m_allowedIndexerCount;
 	bool m_indexerCommandQueueStopped;
 	size_t m_processCount;
 	bool m_interrupted;
@@ -60,9 +66,14 @@ protected:
 	std::vector<std::thread*> m_processThreads;
 	std::vector<std::shared_ptr<InterprocessIntermediateStorageManager>>
 		m_interprocessIntermediateStorageManagers;
+	// indexer threads hand over their storages without copying them through shared memory
+	std::vector<std::shared_ptr<IntermediateStorageQueue>> m_intermediateStorageQueues;
 
 	size_t m_runningThreadCount;
 	std::mutex m_runningThreadCountMutex;
+
+	// wakes the indexer threads when indexing stops
+	std::condition_variable m_indexerThreadsCondition;
 };
 
 #endif	  // TASK_PARSE_H
@@ -7,18 +7,51 @@
 #include "FileSystem.h"
 #include "IndexerCommandCustom.h"
 #include "IndexerCommandProvider.h"
+#include "IntermediateStorage.h"
 #include "MessageIndexingStatus.h"
 #include "MessageShowStatus.h"
 #include "MessageStatus.h"
+#include "ParserClientImpl.h"
 #include "PersistentStorage.h"
+#include "RecordStreamDecoder.h"
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
+#include "TaskManager.h"
 #include "TextAccess.h"
+#include "ThreadPool.h"
 #include "utility.h"
 #include "utilityApp.h"
 #include "utilityFile.h"
 #include "utilityString.h"
 
+namespace
+{
+// streaming commands pass their records to this process instead of writing a database
+bool getStreamsRecords(const IndexerCommandCustom& indexerCommand)
+{
+#if BUILD_PYTHON_LANGUAGE_PACKAGE
+	return indexerCommand.getIndexerCommandType() == INDEXER_COMMAND_PYTHON &&
+		ApplicationSettings::getInstance()->getPythonRecordStreamingEnabled();
+#else
+	return false;
+#endif	  // BUILD_PYTHON_LANGUAGE_PACKAGE
+}
+
+// copies the source database within sqlite and only loads it for injection if that is not possible
+void injectDatabase(PersistentStorage& targetStorage, const FilePath& sourceDatabaseFilePath)
+{
+	if (!targetStorage.injectDatabase(sourceDatabaseFilePath))
+	{
+		LOG_INFO(L"Injecting database \"" + sourceDatabaseFilePath.wstr() + L"\" row by row");
+
+		PersistentStorage sourceStorage(sourceDatabaseFilePath, FilePath());
+		sourceStorage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		sourceStorage.buildCaches();
+		targetStorage.inject(&sourceStorage);
+	}
+}
+}	 // namespace
+
 TaskExecuteCustomCommands::TaskExecuteCustomCommands(
 	std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
 	std::shared_ptr<PersistentStorage> storage,
@@ -60,19 +93,10 @@ void TaskExecuteCustomCommands::doEnter(std::shared_ptr<Blackboard> blackboard)
 				}
 #endif	  // BUILD_PYTHON_LANGUAGE_PACKAGE
 
-				if (indexerCommand->getRunInParallel())
-				{
-					m_parallelCommands.push_back(indexerCommand);
-				}
-				else
-				{
-					m_serialCommands.push_back(indexerCommand);
-				}
+				m_commandsByExecutionOrder[indexerCommand->getExecutionOrder()].push_back(
+					indexerCommand);
 			}
 		}
-		// reverse because we pull elements from the back of these vectors
-		std::reverse(m_parallelCommands.begin(), m_parallelCommands.end());
-		std::reverse(m_serialCommands.begin(), m_serialCommands.end());
 	}
 }
 
@@ -85,43 +109,52 @@ Task::TaskState TaskExecuteCustomCommands::doUpdate(std::shared_ptr<Blackboard>
 
 	m_dialogView->updateCustomIndexingDialog(0, 0, m_indexerCommandProvider->size(), {});
 
-	std::vector<std::shared_ptr<std::thread>> indexerThreads;
-	for (size_t i = 1 /*this method is counting as the first thread*/; i < m_indexerThreadCount; i++)
+	// commands of a lower execution order finish before the next ones start
+	for (const auto& it: m_commandsByExecutionOrder)
 	{
-		indexerThreads.push_back(std::make_shared<std::thread>(
-			&TaskExecuteCustomCommands::executeParallelIndexerCommands, this, i, blackboard));
-	}
+		if (m_interrupted)
+		{
+			break;
+		}
 
-	while (!m_interrupted && !m_serialCommands.empty())
-	{
-		std::shared_ptr<IndexerCommandCustom> indexerCommand = m_serialCommands.back();
-		m_serialCommands.pop_back();
-		runIndexerCommand(indexerCommand, blackboard);
-	}
+		for (const std::shared_ptr<IndexerCommandCustom>& indexerCommand: it.second)
+		{
+			if (indexerCommand->getRunInParallel())
+			{
+				m_parallelCommands.push_back(indexerCommand);
+			}
+			else
+			{
+				m_serialCommands.push_back(indexerCommand);
+			}
+		}
+		// reverse because we pull elements from the back of these vectors
+		std::reverse(m_parallelCommands.begin(), m_parallelCommands.end());
+		std::reverse(m_serialCommands.begin(), m_serialCommands.end());
 
-	executeParallelIndexerCommands(0, blackboard);
+		executeCommands(blackboard);
 
-	for (std::shared_ptr<std::thread> indexerThread: indexerThreads)
-	{
-		indexerThread->join();
+		m_serialCommands.clear();
+		m_parallelCommands.clear();
 	}
-	indexerThreads.clear();
 
 	{
+		const FilePath mergedDatabaseFilePath = mergeSourceDatabases();
+
 		PersistentStorage targetStorage(m_targetDatabaseFilePath, FilePath());
 		targetStorage.setup();
 		targetStorage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
 		targetStorage.buildCaches();
-		for (const FilePath& sourceDatabaseFilePath: m_sourceDatabaseFilePaths)
+		if (!mergedDatabaseFilePath.empty())
 		{
-			{
-				PersistentStorage sourceStorage(sourceDatabaseFilePath, FilePath());
-				sourceStorage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
-				sourceStorage.buildCaches();
-				targetStorage.inject(&sourceStorage);
-			}
-			FileSystem::remove(sourceDatabaseFilePath);
+			injectDatabase(targetStorage, mergedDatabaseFilePath);
+			FileSystem::remove(mergedDatabaseFilePath);
 		}
+		for (const std::shared_ptr<IntermediateStorage>& streamedStorage: m_streamedStorages)
+		{
+			targetStorage.inject(streamedStorage.get());
+		}
+		m_streamedStorages.clear();
 
 		if (m_hasPythonCommands &&
 			ApplicationSettings::getInstance()->getPythonPostProcessingEnabled())
@@ -155,6 +188,66 @@ void TaskExecuteCustomCommands::handleMessage(MessageIndexingInterrupted* messag
 		L"Interrupting Indexing", L"Waiting for running\ncommand to finish");
 }
 
+void TaskExecuteCustomCommands::executeCommands(std::shared_ptr<Blackboard> blackboard)
+{
+	// the threads wait for the processes of the commands, so they do not take workers of the pool
+	std::vector<std::future<void>> indexerThreads;
+	for (size_t i = 1 /*this method is counting as the first thread*/; i < m_indexerThreadCount; i++)
+	{
+		indexerThreads.push_back(TaskManager::getThreadPool()->runBlocking(
+			[this, i, blackboard]() { executeParallelIndexerCommands(int(i), blackboard); }));
+	}
+
+	while (!m_interrupted && !m_serialCommands.empty())
+	{
+		std::shared_ptr<IndexerCommandCustom> indexerCommand = m_serialCommands.back();
+		m_serialCommands.pop_back();
+		runIndexerCommand(indexerCommand, blackboard);
+	}
+
+	executeParallelIndexerCommands(0, blackboard);
+
+	for (std::future<void>& indexerThread: indexerThreads)
+	{
+		indexerThread.wait();
+	}
+}
+
+FilePath TaskExecuteCustomCommands::mergeSourceDatabases()
+{
+	std::vector<FilePath> databaseFilePaths = utility::toVector(m_sourceDatabaseFilePaths);
+
+	// merges pairs of databases in parallel until one is left, so each round halves the number of
+	// databases instead of injecting them into the target one after another
+	while (databaseFilePaths.size() > 1)
+	{
+		LOG_INFO("Merging " + std::to_string(databaseFilePaths.size()) + " temporary databases");
+
+		std::vector<FilePath> mergedDatabaseFilePaths;
+		for (size_t i = 0; i < databaseFilePaths.size(); i += 2)
+		{
+			mergedDatabaseFilePaths.push_back(databaseFilePaths[i]);
+		}
+
+		TaskManager::getThreadPool()->parallelFor(
+			databaseFilePaths.size() / 2,
+			[&databaseFilePaths](size_t i) {
+				const FilePath& sourceFilePath = databaseFilePaths[2 * i + 1];
+				{
+					PersistentStorage targetStorage(databaseFilePaths[2 * i], FilePath());
+					targetStorage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+					targetStorage.buildCaches();
+					injectDatabase(targetStorage, sourceFilePath);
+				}
+				FileSystem::remove(sourceFilePath);
+			},
+			ThreadPool::PRIORITY_INDEXING);
+		databaseFilePaths = mergedDatabaseFilePaths;
+	}
+
+	return databaseFilePaths.empty() ? FilePath() : databaseFilePaths.front();
+}
+
 void TaskExecuteCustomCommands::executeParallelIndexerCommands(
 	int threadId, std::shared_ptr<Blackboard> blackboard)
 {
@@ -171,7 +264,7 @@ void TaskExecuteCustomCommands::executeParallelIndexerCommands(
 			m_parallelCommands.pop_back();
 		}
 
-		if (threadId != 0)
+		if (threadId != 0 && !getStreamsRecords(*indexerCommand))
 		{
 			FilePath databaseFilePath = indexerCommand->getDatabaseFilePath();
 			databaseFilePath = databaseFilePath.getParentDirectory().concatenate(
@@ -232,8 +325,32 @@ void TaskExecuteCustomCommands::runIndexerCommand(
 		m_storage->beforeErrorRecording();
 
 		std::wstring errorMessage;
-		const int result = utility::executeProcessAndGetExitCode(
-			command, {}, m_projectDirectory, -1, true, &errorMessage);
+		int result = 0;
+		if (getStreamsRecords(*indexerCommand))
+		{
+			std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+			RecordStreamDecoder decoder(std::make_shared<ParserClientImpl>(storage.get()));
+
+			result = utility::executeProcessAndReadOutput(
+				command,
+				{},
+				m_projectDirectory,
+				[&decoder](const char* buffer, size_t size) { decoder.decodeChunk(buffer, size); },
+				&errorMessage);
+
+			if (!decoder.finish() && errorMessage.empty())
+			{
+				errorMessage = L"Indexer sent an incomplete record stream.";
+			}
+
+			std::lock_guard<std::mutex> lock(m_streamedStoragesMutex);
+			m_streamedStorages.push_back(storage);
+		}
+		else
+		{
+			result = utility::executeProcessAndGetExitCode(
+				command, {}, m_projectDirectory, -1, true, &errorMessage);
+		}
 
 		m_storage->afterErrorRecording();
 
@@ -290,8 +407,9 @@ void TaskExecuteCustomCommands::runPythonPostProcessing(PersistentStorage& stora
 	{
 		for (const StorageNode& node: storage.getStorageNodes())
 		{
-			nodeNameToStorageNodes[NameHierarchy::deserialize(node.serializedName).back().getName()]
-				.push_back(node);
+			nodeNameToStorageNodes
+				[NameHierarchy::deserializeFromBinary(node.serializedName).back().getName()]
+					.push_back(node);
 		}
 	}
 
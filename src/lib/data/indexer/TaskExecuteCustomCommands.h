@@ -1,6 +1,7 @@
 #ifndef TASK_EXECUTE_CUSTOM_COMMANDS_H
 #define TASK_EXECUTE_CUSTOM_COMMANDS_H
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -13,6 +14,7 @@
 class DialogView;
 class IndexerCommandCustom;
 class IndexerCommandProvider;
+class IntermediateStorage;
 class PersistentStorage;
 
 class TaskExecuteCustomCommands
@@ -35,6 +37,11 @@ private:
 
 	void handleMessage(MessageIndexingInterrupted* message) override;
 
+	// runs the serial commands and then the parallel ones on all indexer threads
+	void executeCommands(std::shared_ptr<Blackboard> blackboard);
+	// merges the databases written by the indexer threads into one and returns its path
+	FilePath mergeSourceDatabases();
+
 	void executeParallelIndexerCommands(int threadId, std::shared_ptr<Blackboard> blackboard);
 	void runIndexerCommand(
 		std::shared_ptr<IndexerCommandCustom> indexerCommand, std::shared_ptr<Blackboard> blackboard);
@@ -50,6 +57,7 @@ private:
 	TimeStamp m_start;
 	bool m_interrupted = false;
 	size_t m_indexerCommandCount;
+	std::map<int, std::vector<std::shared_ptr<IndexerCommandCustom>>> m_commandsByExecutionOrder;
 	std::vector<std::shared_ptr<IndexerCommandCustom>> m_serialCommands;
 	std::vector<std::shared_ptr<IndexerCommandCustom>> m_parallelCommands;
 	std::mutex m_parallelCommandsMutex;
@@ -57,6 +65,8 @@ private:
 	bool m_hasPythonCommands;
 	std::set<FilePath> m_sourceDatabaseFilePaths;
 	std::mutex m_sourceDatabaseFilePathsMutex;
+	std::vector<std::shared_ptr<IntermediateStorage>> m_streamedStorages;
+	std::mutex m_streamedStoragesMutex;
 };
 
 #endif	  // TASK_EXECUTE_CUSTOM_COMMANDS_H
@@ -6,22 +6,36 @@
 #include "logging.h"
 #include "utilityFile.h"
 
+namespace
+{
+const size_t clusterWindowSize = 256;
+}	 // namespace
+
 TaskFillIndexerCommandsQueue::TaskFillIndexerCommandsQueue(
 	const std::string& appUUID,
 	std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-	size_t maximumQueueSize)
+	size_t maximumQueueSize,
+	std::map<std::wstring, size_t> previousIndexingTimesMs,
+	std::shared_ptr<IndexerProcessPool> processPool)
 	: m_indexerCommandProvider(std::move(indexerCommandProvider))
-	, m_indexerCommandManager(appUUID, 0, true)
+	, m_processPool(processPool)
+	, m_indexerCommandManager(appUUID, 0, !processPool)
 	, m_maximumQueueSize(maximumQueueSize)
+	, m_previousIndexingTimesMs(std::move(previousIndexingTimesMs))
 {
 }
 
 void TaskFillIndexerCommandsQueue::doEnter(std::shared_ptr<Blackboard> blackboard)
 {
 	{
+		// all indexer processes pull from the same shared queue, so handing out the most
+		// expensive translation units first keeps single long ones from ending up last. Within
+		// that order commands sharing their compiler flags are handed out next to each other.
 		std::lock_guard<std::mutex> lock(m_commandsMutex);
-		for (const FilePath& filePath:
-			 utility::partitionFilePathsBySize(m_indexerCommandProvider->getAllSourceFilePaths(), 2))
+		for (const FilePath& filePath: m_indexerCommandProvider->clusterSourceFilePaths(
+				 utility::orderFilePathsByPredictedCost(
+					 m_indexerCommandProvider->getAllSourceFilePaths(), m_previousIndexingTimesMs),
+				 clusterWindowSize))
 		{
 			m_filePathQueue.emplace(filePath);
 		}
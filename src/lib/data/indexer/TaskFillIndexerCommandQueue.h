@@ -1,6 +1,7 @@
 #ifndef TASK_FILL_INDEXER_COMMAND_QUEUE_H
 #define TASK_FILL_INDEXER_COMMAND_QUEUE_H
 
+#include <map>
 #include <queue>
 
 #include "MessageIndexingInterrupted.h"
@@ -10,6 +11,7 @@
 #include "InterprocessIndexerCommandManager.h"
 
 class IndexerCommandProvider;
+class IndexerProcessPool;
 
 class TaskFillIndexerCommandsQueue
 	: public Task
@@ -19,7 +21,9 @@ public:
 	TaskFillIndexerCommandsQueue(
 		const std::string& appUUID,
 		std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-		size_t maximumQueueSize);
+		size_t maximumQueueSize,
+		std::map<std::wstring, size_t> previousIndexingTimesMs = {},
+		std::shared_ptr<IndexerProcessPool> processPool = nullptr);
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -34,9 +38,12 @@ protected:
 
 private:
 	std::unique_ptr<IndexerCommandProvider> m_indexerCommandProvider;
+	// the queue is owned by the pool if there is one, so its processes outlive this task
+	std::shared_ptr<IndexerProcessPool> m_processPool;
 	InterprocessIndexerCommandManager m_indexerCommandManager;
 
 	const size_t m_maximumQueueSize;
+	const std::map<std::wstring, size_t> m_previousIndexingTimesMs;
 
 	std::queue<FilePath> m_filePathQueue;
 	std::mutex m_commandsMutex;
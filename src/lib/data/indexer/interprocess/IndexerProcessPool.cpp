@@ -0,0 +1,176 @@
+#include "IndexerProcessPool.h"
+
+#include <chrono>
+
+#include "AppPath.h"
+#include "FileLogger.h"
+#include "TimeStamp.h"
+#include "UserPaths.h"
+#include "logging.h"
+#include "utilityApp.h"
+#include "utilityString.h"
+
+#if _WIN32
+const std::wstring IndexerProcessPool::s_processName(L"sourcetrail_indexer.exe");
+#else
+const std::wstring IndexerProcessPool::s_processName(L"sourcetrail_indexer");
+#endif
+
+IndexerProcessPool::IndexerProcessPool(const std::string& appUUID, size_t processCount)
+	: m_appUUID(appUUID)
+	, m_interprocessIndexerCommandManager(appUUID, 0, true)
+	, m_interprocessIndexingStatusManager(appUUID, 0, true)
+	, m_stopped(false)
+	, m_runningProcessCount(0)
+{
+	for (size_t i = 0; i < processCount; i++)
+	{
+		const Id processId = i + 1;	   // 0 remains reserved for the main process
+		m_interprocessIntermediateStorageManagers.push_back(
+			std::make_shared<InterprocessIntermediateStorageManager>(appUUID, processId, true));
+	}
+
+	std::wstring logFilePath;
+	Logger* logger = LogManager::getInstance()->getLoggerByType("FileLogger");
+	if (logger)
+	{
+		logFilePath = dynamic_cast<FileLogger*>(logger)->getLogFilePath().wstr();
+	}
+
+	m_interprocessIndexingStatusManager.updateWorkerPoolHeartbeat();
+	m_heartbeatThread = std::thread(&IndexerProcessPool::runHeartbeat, this);
+
+	m_runningProcessCount = processCount;
+	for (size_t i = 0; i < processCount; i++)
+	{
+		m_processThreads.emplace_back(&IndexerProcessPool::runIndexerProcess, this, i + 1, logFilePath);
+	}
+
+	LOG_INFO("Started indexer process pool with " + std::to_string(processCount) + " processes.");
+}
+
+IndexerProcessPool::~IndexerProcessPool()
+{
+	m_stopped = true;
+	m_heartbeatThread.join();
+	m_interprocessIndexingStatusManager.stopWorkerPool();
+
+	// idle processes notice the stopped pool within a few hundred milliseconds
+	const TimeStamp start = TimeStamp::now();
+	while (m_runningProcessCount > 0 && TimeStamp::now().deltaMS(start) < 5000)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+
+	if (m_runningProcessCount > 0)
+	{
+		LOG_WARNING("Killing indexer processes that did not shut down in time.");
+		utility::killRunningProcesses();
+	}
+
+	for (std::thread& processThread: m_processThreads)
+	{
+		processThread.join();
+	}
+
+	LOG_INFO("Stopped indexer process pool.");
+}
+
+size_t IndexerProcessPool::getProcessCount() const
+{
+	return m_interprocessIntermediateStorageManagers.size();
+}
+
+size_t IndexerProcessPool::getRunningProcessCount() const
+{
+	return m_runningProcessCount;
+}
+
+bool IndexerProcessPool::isIdle()
+{
+	// order matters: processes are marked busy before they fetch a command, and queue an isolated
+	// retry before they are unmarked
+	return m_interprocessIndexerCommandManager.indexerCommandCount() == 0 &&
+		m_interprocessIndexingStatusManager.getBusyProcessCount() == 0 &&
+		m_interprocessIndexerCommandManager.isolatedIndexerCommandCount() == 0;
+}
+
+void IndexerProcessPool::clear()
+{
+	m_interprocessIndexerCommandManager.clearIndexerCommands();
+	m_interprocessIndexingStatusManager.clearIndexingStatus();
+
+	for (const std::shared_ptr<InterprocessIntermediateStorageManager>& storageManager:
+		 m_interprocessIntermediateStorageManagers)
+	{
+		while (storageManager->getIntermediateStorageCount() > 0)
+		{
+			storageManager->popIntermediateStorage();
+		}
+	}
+}
+
+const std::vector<std::shared_ptr<InterprocessIntermediateStorageManager>>& IndexerProcessPool::
+	getIntermediateStorageManagers() const
+{
+	return m_interprocessIntermediateStorageManagers;
+}
+
+void IndexerProcessPool::runIndexerProcess(Id processId, const std::wstring& logFilePath)
+{
+	const FilePath indexerProcessPath = AppPath::getAppPath().concatenate(s_processName);
+	if (!indexerProcessPath.exists())
+	{
+		LOG_ERROR(
+			L"Cannot start indexer process because executable is missing at \"" +
+			indexerProcessPath.wstr() + L"\"");
+		m_runningProcessCount--;
+		return;
+	}
+
+	const std::wstring commandPath = L"\"" + indexerProcessPath.wstr() + L"\"";
+	std::vector<std::wstring> commandArguments;
+	commandArguments.push_back(std::to_wstring(processId));
+	commandArguments.push_back(utility::decodeFromUtf8(m_appUUID));
+	commandArguments.push_back(L"\"" + AppPath::getAppPath().getAbsolute().wstr() + L"\"");
+	commandArguments.push_back(L"\"" + UserPaths::getUserDataPath().getAbsolute().wstr() + L"\"");
+
+	if (!logFilePath.empty())
+	{
+		commandArguments.push_back(L"\"" + logFilePath + L"\"");
+	}
+
+	while (!m_stopped)
+	{
+		if (m_interprocessIndexingStatusManager.getIndexingInterrupted())
+		{
+			// processes quit on interruption and are started again with the next indexing run
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			continue;
+		}
+
+		const int result = utility::executeProcessAndGetExitCode(
+			commandPath, commandArguments, FilePath(), -1);
+
+		LOG_INFO_STREAM(<< "Indexer process " << processId << " returned with " + std::to_string(result));
+
+		// a crashed process cannot unmark itself
+		m_interprocessIndexingStatusManager.setProcessBusy(processId, false);
+
+		if (!m_stopped)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		}
+	}
+
+	m_runningProcessCount--;
+}
+
+void IndexerProcessPool::runHeartbeat()
+{
+	while (!m_stopped)
+	{
+		m_interprocessIndexingStatusManager.updateWorkerPoolHeartbeat();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+	}
+}
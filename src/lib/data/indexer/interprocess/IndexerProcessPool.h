@@ -0,0 +1,58 @@
+#ifndef INDEXER_PROCESS_POOL_H
+#define INDEXER_PROCESS_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "InterprocessIndexerCommandManager.h"
+#include "InterprocessIndexingStatusManager.h"
+#include "InterprocessIntermediateStorageManager.h"
+
+// Keeps indexer processes running while a project is open, so refreshes with only a few changed
+// files don't pay for starting up a process and its language runtimes again. The pool owns the
+// shared memory the processes work on and restarts a process only after it crashed or recycled
+// itself for exceeding the memory limit.
+class IndexerProcessPool
+{
+public:
+	IndexerProcessPool(const std::string& appUUID, size_t processCount);
+	~IndexerProcessPool();
+
+	IndexerProcessPool(const IndexerProcessPool&) = delete;
+	IndexerProcessPool& operator=(const IndexerProcessPool&) = delete;
+
+	size_t getProcessCount() const;
+	size_t getRunningProcessCount() const;
+
+	// no commands queued and no process working on one
+	bool isIdle();
+
+	// drops results and status left over from an interrupted indexing run
+	void clear();
+
+	const std::vector<std::shared_ptr<InterprocessIntermediateStorageManager>>&
+		getIntermediateStorageManagers() const;
+
+private:
+	static const std::wstring s_processName;
+
+	void runIndexerProcess(Id processId, const std::wstring& logFilePath);
+	void runHeartbeat();
+
+	const std::string m_appUUID;
+
+	InterprocessIndexerCommandManager m_interprocessIndexerCommandManager;
+	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
+	std::vector<std::shared_ptr<InterprocessIntermediateStorageManager>>
+		m_interprocessIntermediateStorageManagers;
+
+	std::atomic<bool> m_stopped;
+	std::atomic<size_t> m_runningProcessCount;
+
+	std::vector<std::thread> m_processThreads;
+	std::thread m_heartbeatThread;
+};
+
+#endif	  // INDEXER_PROCESS_POOL_H
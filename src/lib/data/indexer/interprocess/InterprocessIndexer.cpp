@@ -1,19 +1,33 @@
 #include "InterprocessIndexer.h"
 
+#include <algorithm>
+#include <atomic>
+
+#include "ApplicationSettings.h"
 #include "FileRegister.h"
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
+#include "IndexerResultCache.h"
+#include "IntermediateStorage.h"
+#include "IntermediateStorageQueue.h"
 #include "LanguagePackageManager.h"
 #include "ScopedFunctor.h"
 #include "logging.h"
+#include "utilityApp.h"
 
-InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
+InterprocessIndexer::InterprocessIndexer(
+	const std::string& uuid, Id processId, std::shared_ptr<IntermediateStorageQueue> storageQueue)
 	: m_interprocessIndexerCommandManager(uuid, processId, false)
 	, m_interprocessIndexingStatusManager(uuid, processId, false)
-	, m_interprocessIntermediateStorageManager(uuid, processId, false)
+	, m_storageQueue(storageQueue)
 	, m_uuid(uuid)
 	, m_processId(processId)
 {
+	if (!m_storageQueue)
+	{
+		m_interprocessIntermediateStorageManager =
+			std::make_shared<InterprocessIntermediateStorageManager>(uuid, processId, false);
+	}
 }
 
 void InterprocessIndexer::work()
@@ -22,15 +36,36 @@ void InterprocessIndexer::work()
 	std::shared_ptr<std::thread> updaterThread;
 	std::shared_ptr<IndexerBase> indexer;
 
+	// memory that the file currently being indexed may take up, 0 if it is not watched
+	std::atomic<size_t> fileMemoryLimitKb(0);
+	std::atomic<bool> fileMemoryLimitExceeded(false);
+
 	try
 	{
 		LOG_INFO_STREAM(<< m_processId << " starting up indexer");
 		indexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
 
 		updaterThread = std::make_shared<std::thread>([&]() {
+			size_t statusRevision = 0;
 			while (updaterThreadRunning)
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+				// setting the interrupt flag wakes up the wait right away
+				statusRevision = m_interprocessIndexingStatusManager.waitForStatusChange(
+					statusRevision, fileMemoryLimitKb ? 250 : 1000);
+
+				const size_t memoryLimitKb = fileMemoryLimitKb;
+				if (memoryLimitKb && !fileMemoryLimitExceeded &&
+					utility::getMemoryUsageKb() > memoryLimitKb)
+				{
+					LOG_WARNING_STREAM(
+						<< m_processId << " exceeded memory limit of " << memoryLimitKb
+						<< " KB, interrupting indexer");
+					fileMemoryLimitExceeded = true;
+					if (indexer)
+					{
+						indexer->interrupt();
+					}
+				}
 
 				if (m_interprocessIndexingStatusManager.getIndexingInterrupted())
 				{
@@ -46,6 +81,7 @@ void InterprocessIndexer::work()
 
 		ScopedFunctor threadStopper([&]() {
 			updaterThreadRunning = false;
+			m_interprocessIndexingStatusManager.notifyStatusChange();
 			if (updaterThread)
 			{
 				updaterThread->join();
@@ -53,20 +89,107 @@ void InterprocessIndexer::work()
 			}
 		});
 
-		while (std::shared_ptr<IndexerCommand> indexerCommand =
-				   m_interprocessIndexerCommandManager.popIndexerCommand())
+		const int memoryLimitMb = ApplicationSettings::getInstance()->getIndexerProcessMemoryLimitMb();
+		const size_t memoryLimitKb = memoryLimitMb > 0 ? size_t(memoryLimitMb) * 1024 : 0;
+		const int isolatedMemoryLimitMb =
+			ApplicationSettings::getInstance()->getIsolatedIndexerProcessMemoryLimitMb();
+		const size_t isolatedMemoryLimitKb = std::max(
+			memoryLimitKb, isolatedMemoryLimitMb > 0 ? size_t(isolatedMemoryLimitMb) * 1024 : 0);
+
+		// indexer threads share the memory of the app, so the limits only apply to the processes of
+		// a pool, which are recycled after exceeding them
+		const bool watchesMemory = memoryLimitKb &&
+			m_interprocessIndexingStatusManager.isWorkerPoolAlive();
+		bool hasIndexed = false;
+		const bool skipIndexedHeaders = ApplicationSettings::getInstance()->getSkipIndexedHeadersEnabled();
+
+		std::shared_ptr<IndexerResultCache> resultCache;
+		const FilePath resultCachePath = ApplicationSettings::getInstance()->getIndexerResultCachePath();
+		if (!resultCachePath.empty())
+		{
+			resultCache = std::make_shared<IndexerResultCache>(resultCachePath);
+		}
+
+		// cached results are reused by later runs, so they have to contain all of their errors
+		if (!resultCache)
+		{
+			indexer->setErrorClaimFunction(
+				[this](const std::string& errorKey, const FilePath& translationUnit) {
+					return m_interprocessIndexingStatusManager.claimError(errorKey, translationUnit);
+				});
+		}
+
+		size_t statusRevision = 0;
+		while (updaterThreadRunning)
 		{
+			// leaves the cpus to the ui while the user interacts with the app, but doesn't keep
+			// from noticing that nothing is left to index
+			const size_t allowedIndexerCount =
+				m_interprocessIndexingStatusManager.getAllowedIndexerCount();
+			if (allowedIndexerCount && m_processId > allowedIndexerCount &&
+				m_interprocessIndexerCommandManager.indexerCommandCount() > 0)
+			{
+				statusRevision = m_interprocessIndexingStatusManager.waitForStatusChange(
+					statusRevision, 200);
+				continue;
+			}
+
+			m_interprocessIndexingStatusManager.setProcessBusy(m_processId, true);
+
+			// files that exceeded the limit are retried by a process that did not index anything
+			// yet, which quits afterwards
+			std::shared_ptr<IndexerCommand> indexerCommand;
+			if (watchesMemory && !hasIndexed)
+			{
+				indexerCommand = m_interprocessIndexerCommandManager.popIsolatedIndexerCommand();
+			}
+			const bool isolated = indexerCommand != nullptr;
+			if (!indexerCommand)
+			{
+				indexerCommand = m_interprocessIndexerCommandManager.popIndexerCommand();
+			}
+			if (!indexerCommand)
+			{
+				m_interprocessIndexingStatusManager.setProcessBusy(m_processId, false);
+
+				// processes of a pool stay alive for the next indexing run
+				if (!m_interprocessIndexingStatusManager.isWorkerPoolAlive())
+				{
+					break;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				continue;
+			}
+
 			LOG_INFO_STREAM(
-				<< m_processId << " fetched indexer command for \""
-				<< indexerCommand->getSourceFilePath().str() << "\"");
+				<< m_processId << " fetched " << (isolated ? "isolated " : "")
+				<< "indexer command for \"" << indexerCommand->getSourceFilePath().str() << "\"");
+			hasIndexed = true;
+
+			std::vector<std::shared_ptr<IndexerCommand>> indexerCommands = {indexerCommand};
+			const size_t batchSize = isolated
+				? 1
+				: indexer->getBatchSize(indexerCommand->getIndexerCommandType());
+			if (batchSize > 1)
+			{
+				for (const std::shared_ptr<IndexerCommand>& command:
+					 m_interprocessIndexerCommandManager.popIndexerCommands(
+						 indexerCommand->getIndexerCommandType(), batchSize - 1))
+				{
+					indexerCommands.push_back(command);
+				}
+				LOG_INFO_STREAM(
+					<< m_processId << " fetched batch of " << indexerCommands.size()
+					<< " indexer commands");
+			}
 			LOG_INFO_STREAM(
 				<< m_processId << " indexer commands left: "
 				<< m_interprocessIndexerCommandManager.indexerCommandCount());
 
 			while (updaterThreadRunning)
 			{
-				const size_t storageCount =
-					m_interprocessIntermediateStorageManager.getIntermediateStorageCount();
+				const size_t storageCount = getIntermediateStorageCount();
 				if (storageCount < 2)
 				{
 					break;
@@ -82,24 +205,110 @@ void InterprocessIndexer::work()
 				break;
 			}
 
+			if (indexerCommands.size() > 1)
+			{
+				indexBatch(indexer, indexerCommands, resultCache);
+
+				if (memoryLimitKb && utility::getPeakMemoryUsageKb() > memoryLimitKb &&
+					m_interprocessIndexingStatusManager.isWorkerPoolAlive())
+				{
+					LOG_INFO_STREAM(
+						<< m_processId << " exceeded memory limit, restarting indexer process");
+					break;
+				}
+				continue;
+			}
+
 			LOG_INFO_STREAM(<< m_processId << " updating indexer status with currently indexed filepath");
 			m_interprocessIndexingStatusManager.startIndexingSourceFile(
 				indexerCommand->getSourceFilePath());
 
-			LOG_INFO_STREAM(<< m_processId << " starting to index current file");
-			std::shared_ptr<IntermediateStorage> result = indexer->index(indexerCommand);
+			const std::wstring contextKey = skipIndexedHeaders
+				? indexerCommand->getPreprocessorContextKey()
+				: L"";
+			std::set<FilePath> indexedHeaderFilePaths;
+			if (!contextKey.empty())
+			{
+				indexedHeaderFilePaths = m_interprocessIndexingStatusManager.getIndexedHeaderFilePaths(
+					contextKey);
+			}
+			indexer->setAlreadyIndexedFilePaths(indexedHeaderFilePaths);
+
+			std::shared_ptr<IntermediateStorage> result;
+			if (resultCache)
+			{
+				result = resultCache->load(indexerCommand);
+			}
 
 			if (result)
 			{
-				LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
-				m_interprocessIntermediateStorageManager.pushIntermediateStorage(result);
+				LOG_INFO_STREAM(<< m_processId << " using cached index of current file");
+			}
+			else
+			{
+				LOG_INFO_STREAM(<< m_processId << " starting to index current file");
+				if (watchesMemory)
+				{
+					fileMemoryLimitKb = isolated ? isolatedMemoryLimitKb : memoryLimitKb;
+				}
+				result = indexer->index(indexerCommand);
+				fileMemoryLimitKb = 0;
+
+				if (fileMemoryLimitExceeded)
+				{
+					handleMemoryLimitExceeded(indexerCommand, isolated);
+					break;
+				}
+
+				// results without the skipped headers or of interrupted indexing are incomplete
+				if (result && resultCache && indexedHeaderFilePaths.empty() && updaterThreadRunning)
+				{
+					resultCache->store(indexerCommand, result);
+				}
+			}
+
+			if (result && !contextKey.empty())
+			{
+				std::set<FilePath> newHeaderFilePaths;
+				for (const StorageFile& file: result->getStorageFiles())
+				{
+					const FilePath filePath(file.filePath);
+					if (file.indexed && file.complete &&
+						filePath != indexerCommand->getSourceFilePath() &&
+						indexedHeaderFilePaths.find(filePath) == indexedHeaderFilePaths.end())
+					{
+						newHeaderFilePaths.insert(filePath);
+					}
+				}
+				m_interprocessIndexingStatusManager.addIndexedHeaderFilePaths(
+					contextKey, newHeaderFilePaths);
+			}
+
+			if (result)
+			{
+				pushIntermediateStorage(result);
 			}
 
 			LOG_INFO_STREAM(<< m_processId << " finalizing indexer status for current file");
 			m_interprocessIndexingStatusManager.finishIndexingSourceFile();
 
 			LOG_INFO_STREAM(<< m_processId << " all done");
+
+			if (isolated)
+			{
+				LOG_INFO_STREAM(<< m_processId << " finished isolated file, restarting indexer process");
+				break;
+			}
+
+			if (memoryLimitKb && utility::getPeakMemoryUsageKb() > memoryLimitKb &&
+				m_interprocessIndexingStatusManager.isWorkerPoolAlive())
+			{
+				LOG_INFO_STREAM(<< m_processId << " exceeded memory limit, restarting indexer process");
+				break;
+			}
 		}
+
+		m_interprocessIndexingStatusManager.setProcessBusy(m_processId, false);
 	}
 	catch (boost::interprocess::interprocess_exception& e)
 	{
@@ -118,3 +327,118 @@ void InterprocessIndexer::work()
 
 	LOG_INFO_STREAM(<< m_processId << " shutting down indexer");
 }
+
+size_t InterprocessIndexer::getIntermediateStorageCount()
+{
+	if (m_storageQueue)
+	{
+		return m_storageQueue->getSize();
+	}
+	return m_interprocessIntermediateStorageManager->getIntermediateStorageCount();
+}
+
+void InterprocessIndexer::pushIntermediateStorage(
+	const std::shared_ptr<IntermediateStorage>& storage)
+{
+	if (m_storageQueue)
+	{
+		LOG_INFO_STREAM(<< m_processId << " handing index over to app");
+		m_storageQueue->push(storage);
+		return;
+	}
+
+	LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
+	m_interprocessIntermediateStorageManager->pushIntermediateStorage(storage);
+}
+
+void InterprocessIndexer::handleMemoryLimitExceeded(
+	std::shared_ptr<IndexerCommand> indexerCommand, bool isolated)
+{
+	const FilePath& sourceFilePath = indexerCommand->getSourceFilePath();
+	if (isolated)
+	{
+		LOG_ERROR_STREAM(
+			<< m_processId << " exceeded memory limit of isolated process for \""
+			<< sourceFilePath.str() << "\"");
+		m_interprocessIndexingStatusManager.addMemoryExceededSourceFilePath(sourceFilePath);
+	}
+	else
+	{
+		LOG_WARNING_STREAM(
+			<< m_processId << " exceeded memory limit for \"" << sourceFilePath.str()
+			<< "\", retrying in isolated process");
+		m_interprocessIndexingStatusManager.addIsolatedSourceFilePath(sourceFilePath);
+		m_interprocessIndexerCommandManager.pushIsolatedIndexerCommand(indexerCommand);
+	}
+
+	// the process quits without a result for the file and gets restarted with a fresh heap
+	m_interprocessIndexingStatusManager.finishIndexingSourceFile();
+}
+
+void InterprocessIndexer::indexBatch(
+	std::shared_ptr<IndexerBase> indexer,
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands,
+	std::shared_ptr<IndexerResultCache> resultCache)
+{
+	std::vector<FilePath> sourceFilePaths;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		sourceFilePaths.push_back(indexerCommand->getSourceFilePath());
+	}
+
+	LOG_INFO_STREAM(<< m_processId << " updating indexer status with currently indexed filepaths");
+	m_interprocessIndexingStatusManager.startIndexingSourceFiles(sourceFilePaths);
+
+	indexer->setAlreadyIndexedFilePaths({});
+
+	// only the commands without a cached index are left in the batch
+	std::vector<std::shared_ptr<IntermediateStorage>> results;
+	std::vector<std::shared_ptr<IndexerCommand>> uncachedIndexerCommands;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		std::shared_ptr<IntermediateStorage> result = resultCache
+			? resultCache->load(indexerCommand)
+			: nullptr;
+		if (result)
+		{
+			results.push_back(result);
+		}
+		else
+		{
+			uncachedIndexerCommands.push_back(indexerCommand);
+		}
+	}
+
+	if (!uncachedIndexerCommands.empty())
+	{
+		LOG_INFO_STREAM(<< m_processId << " starting to index current batch");
+		std::vector<std::shared_ptr<IntermediateStorage>> batchResults = indexer->indexBatch(
+			uncachedIndexerCommands);
+
+		// results are in order of the commands
+		for (size_t i = 0; i < batchResults.size(); i++)
+		{
+			if (batchResults[i] && resultCache && i < uncachedIndexerCommands.size())
+			{
+				resultCache->store(uncachedIndexerCommands[i], batchResults[i]);
+			}
+			results.push_back(batchResults[i]);
+		}
+	}
+
+	for (const std::shared_ptr<IntermediateStorage>& result: results)
+	{
+		if (result)
+		{
+			pushIntermediateStorage(result);
+		}
+	}
+
+	LOG_INFO_STREAM(<< m_processId << " finalizing indexer status for current batch");
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		m_interprocessIndexingStatusManager.finishIndexingSourceFile();
+	}
+
+	LOG_INFO_STREAM(<< m_processId << " all done");
+}
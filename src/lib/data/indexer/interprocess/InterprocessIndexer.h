@@ -1,21 +1,47 @@
 #ifndef INTERPROCESS_INDEXER_H
 #define INTERPROCESS_INDEXER_H
 
+#include <memory>
+#include <vector>
+
 #include "InterprocessIndexerCommandManager.h"
 #include "InterprocessIndexingStatusManager.h"
 #include "InterprocessIntermediateStorageManager.h"
 
+class IndexerBase;
+class IndexerCommand;
+class IndexerResultCache;
+class IntermediateStorage;
+class IntermediateStorageQueue;
+
 class InterprocessIndexer
 {
 public:
-	InterprocessIndexer(const std::string& uuid, Id processId);
+	// indexer threads of the app pass the queue to hand over their storages without shared memory
+	InterprocessIndexer(
+		const std::string& uuid,
+		Id processId,
+		std::shared_ptr<IntermediateStorageQueue> storageQueue = nullptr);
 
 	void work();
 
 private:
+	// drops the result of a file that exceeded the memory limit, and queues it for an isolated
+	// process unless this already was one
+	void handleMemoryLimitExceeded(std::shared_ptr<IndexerCommand> indexerCommand, bool isolated);
+
+	size_t getIntermediateStorageCount();
+	void pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& storage);
+
+	void indexBatch(
+		std::shared_ptr<IndexerBase> indexer,
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands,
+		std::shared_ptr<IndexerResultCache> resultCache);
+
 	InterprocessIndexerCommandManager m_interprocessIndexerCommandManager;
 	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
-	InterprocessIntermediateStorageManager m_interprocessIntermediateStorageManager;
+	std::shared_ptr<InterprocessIntermediateStorageManager> m_interprocessIntermediateStorageManager;
+	std::shared_ptr<IntermediateStorageQueue> m_storageQueue;
 
 	const std::string m_uuid;
 	const Id m_processId;
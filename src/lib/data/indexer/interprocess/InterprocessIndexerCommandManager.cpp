@@ -6,6 +6,8 @@
 const char* InterprocessIndexerCommandManager::s_sharedMemoryNamePrefix = "icmd_";
 
 const char* InterprocessIndexerCommandManager::s_indexerCommandsKeyName = "indexer_commands";
+const char* InterprocessIndexerCommandManager::s_isolatedIndexerCommandsKeyName =
+	"isolated_indexer_commands";
 
 InterprocessIndexerCommandManager::InterprocessIndexerCommandManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
@@ -18,6 +20,64 @@ InterprocessIndexerCommandManager::~InterprocessIndexerCommandManager() {}
 
 void InterprocessIndexerCommandManager::pushIndexerCommands(
 	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands)
+{
+	pushIndexerCommands(indexerCommands, s_indexerCommandsKeyName);
+}
+
+std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCommand()
+{
+	return popIndexerCommand(s_indexerCommandsKeyName);
+}
+
+std::vector<std::shared_ptr<IndexerCommand>> InterprocessIndexerCommandManager::popIndexerCommands(
+	IndexerCommandType type, size_t maxCount)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	std::vector<std::shared_ptr<IndexerCommand>> commands;
+
+	SharedMemory::Queue<SharedIndexerCommand>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+			s_indexerCommandsKeyName);
+	while (queue && queue->size() && commands.size() < maxCount &&
+		   queue->front().getIndexerCommandType() == type)
+	{
+		commands.push_back(SharedIndexerCommand::fromShared(queue->front()));
+		queue->pop_front();
+	}
+
+	return commands;
+}
+
+void InterprocessIndexerCommandManager::pushIsolatedIndexerCommand(
+	std::shared_ptr<IndexerCommand> indexerCommand)
+{
+	pushIndexerCommands({indexerCommand}, s_isolatedIndexerCommandsKeyName);
+}
+
+std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIsolatedIndexerCommand()
+{
+	return popIndexerCommand(s_isolatedIndexerCommandsKeyName);
+}
+
+size_t InterprocessIndexerCommandManager::isolatedIndexerCommandCount()
+{
+	return indexerCommandCount(s_isolatedIndexerCommandsKeyName);
+}
+
+void InterprocessIndexerCommandManager::clearIndexerCommands()
+{
+	clearIndexerCommands(s_indexerCommandsKeyName);
+	clearIndexerCommands(s_isolatedIndexerCommandsKeyName);
+}
+
+size_t InterprocessIndexerCommandManager::indexerCommandCount()
+{
+	return indexerCommandCount(s_indexerCommandsKeyName);
+}
+
+void InterprocessIndexerCommandManager::pushIndexerCommands(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, const char* keyName)
 {
 	size_t size = 0;
 	{
@@ -43,8 +103,7 @@ void InterprocessIndexerCommandManager::pushIndexerCommands(
 	}
 
 	SharedMemory::Queue<SharedIndexerCommand>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
-			s_indexerCommandsKeyName);
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(keyName);
 	if (!queue)
 	{
 		return;
@@ -60,13 +119,13 @@ void InterprocessIndexerCommandManager::pushIndexerCommands(
 	LOG_INFO(access.logString());
 }
 
-std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCommand()
+std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCommand(
+	const char* keyName)
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
 	SharedMemory::Queue<SharedIndexerCommand>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
-			s_indexerCommandsKeyName);
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(keyName);
 	if (!queue || !queue->size())
 	{
 		return nullptr;
@@ -79,13 +138,12 @@ std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCom
 	return command;
 }
 
-void InterprocessIndexerCommandManager::clearIndexerCommands()
+void InterprocessIndexerCommandManager::clearIndexerCommands(const char* keyName)
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
 	SharedMemory::Queue<SharedIndexerCommand>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
-			s_indexerCommandsKeyName);
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(keyName);
 	if (!queue)
 	{
 		return;
@@ -94,13 +152,12 @@ void InterprocessIndexerCommandManager::clearIndexerCommands()
 	queue->clear();
 }
 
-size_t InterprocessIndexerCommandManager::indexerCommandCount()
+size_t InterprocessIndexerCommandManager::indexerCommandCount(const char* keyName)
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
 	SharedMemory::Queue<SharedIndexerCommand>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
-			s_indexerCommandsKeyName);
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(keyName);
 	if (!queue)
 	{
 		return 0;
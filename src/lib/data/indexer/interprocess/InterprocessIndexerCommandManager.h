@@ -15,12 +15,29 @@ public:
 	void pushIndexerCommands(const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands);
 	std::shared_ptr<IndexerCommand> popIndexerCommand();
 
+	// pops commands from the front of the queue as long as they are of the given type
+	std::vector<std::shared_ptr<IndexerCommand>> popIndexerCommands(
+		IndexerCommandType type, size_t maxCount);
+
+	// commands of files that exceeded the memory limit of a process, each of them is retried by a
+	// freshly started process with a larger allowance
+	void pushIsolatedIndexerCommand(std::shared_ptr<IndexerCommand> indexerCommand);
+	std::shared_ptr<IndexerCommand> popIsolatedIndexerCommand();
+	size_t isolatedIndexerCommandCount();
+
 	void clearIndexerCommands();
 	size_t indexerCommandCount();
 
 private:
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_indexerCommandsKeyName;
+	static const char* s_isolatedIndexerCommandsKeyName;
+
+	void pushIndexerCommands(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, const char* keyName);
+	std::shared_ptr<IndexerCommand> popIndexerCommand(const char* keyName);
+	void clearIndexerCommands(const char* keyName);
+	size_t indexerCommandCount(const char* keyName);
 };
 
 #endif	  // INTERPROCESS_INDEXER_COMMAND_MANAGER_H
@@ -3,6 +3,12 @@
 #include "logging.h"
 #include "utilityString.h"
 
+namespace
+{
+// maps the key of each claimed error to the translation unit that claimed it
+using ClaimedErrors = SharedMemory::Map<SharedMemory::String, SharedMemory::String>;
+}	 // namespace
+
 const char* InterprocessIndexingStatusManager::s_sharedMemoryNamePrefix = "ists_";
 
 const char* InterprocessIndexingStatusManager::s_indexingFilesKeyName = "indexing_files";
@@ -11,6 +17,18 @@ const char* InterprocessIndexingStatusManager::s_crashedFilesKeyName = "crashed_
 const char* InterprocessIndexingStatusManager::s_finishedProcessIdsKeyName = "finished_process_ids";
 const char* InterprocessIndexingStatusManager::s_indexingInterruptedKeyName =
 	"indexing_interrupted_flag";
+const char* InterprocessIndexingStatusManager::s_busyProcessIdsKeyName = "busy_process_ids";
+const char* InterprocessIndexingStatusManager::s_workerPoolHeartbeatKeyName = "worker_pool_heartbeat";
+const char* InterprocessIndexingStatusManager::s_indexedHeaderFilesKeyName = "indexed_header_files";
+const char* InterprocessIndexingStatusManager::s_claimedErrorsKeyName = "claimed_errors";
+const char* InterprocessIndexingStatusManager::s_statusRevisionKeyName = "status_revision";
+const char* InterprocessIndexingStatusManager::s_isolatedFilesKeyName = "isolated_files";
+const char* InterprocessIndexingStatusManager::s_memoryExceededFilesKeyName =
+	"memory_exceeded_files";
+const char* InterprocessIndexingStatusManager::s_allowedIndexerCountKeyName =
+	"allowed_indexer_count";
+
+const time_t InterprocessIndexingStatusManager::s_workerPoolTimeoutSeconds = 10;
 
 InterprocessIndexingStatusManager::InterprocessIndexingStatusManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
@@ -85,6 +103,34 @@ void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath&
 		it = currentFilesPtr->insert(std::pair<Id, SharedMemory::String>(getProcessId(), str)).first;
 		it->second = str;
 	}
+
+	notifyStatusChange(access);
+}
+
+void InterprocessIndexingStatusManager::startIndexingSourceFiles(
+	const std::vector<FilePath>& filePaths)
+{
+	if (filePaths.empty())
+	{
+		return;
+	}
+
+	startIndexingSourceFile(filePaths.front());
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Queue<SharedMemory::String>* indexingFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
+			s_indexingFilesKeyName);
+	if (indexingFilesPtr)
+	{
+		for (size_t i = 1; i < filePaths.size(); i++)
+		{
+			SharedMemory::String fileStr(access.getAllocator());
+			fileStr = utility::encodeToUtf8(filePaths[i].wstr()).c_str();
+			indexingFilesPtr->push_back(fileStr);
+		}
+	}
 }
 
 void InterprocessIndexingStatusManager::finishIndexingSourceFile()
@@ -105,6 +151,8 @@ void InterprocessIndexingStatusManager::finishIndexingSourceFile()
 	{
 		finishedProcessIdsPtr->push_back(m_processId);
 	}
+
+	notifyStatusChange(access);
 }
 
 void InterprocessIndexingStatusManager::setIndexingInterrupted(bool interrupted)
@@ -116,6 +164,8 @@ void InterprocessIndexingStatusManager::setIndexingInterrupted(bool interrupted)
 	{
 		*indexingInterruptedPtr = interrupted;
 	}
+
+	notifyStatusChange(access);
 }
 
 bool InterprocessIndexingStatusManager::getIndexingInterrupted()
@@ -131,6 +181,305 @@ bool InterprocessIndexingStatusManager::getIndexingInterrupted()
 	return false;
 }
 
+void InterprocessIndexingStatusManager::setProcessBusy(Id processId, bool busy)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Set<Id>* busyProcessIdsPtr = access.accessValueWithAllocator<SharedMemory::Set<Id>>(
+		s_busyProcessIdsKeyName);
+	if (busyProcessIdsPtr)
+	{
+		if (busy)
+		{
+			busyProcessIdsPtr->insert(processId);
+		}
+		else
+		{
+			busyProcessIdsPtr->erase(processId);
+		}
+	}
+
+	notifyStatusChange(access);
+}
+
+size_t InterprocessIndexingStatusManager::getBusyProcessCount()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Set<Id>* busyProcessIdsPtr = access.accessValueWithAllocator<SharedMemory::Set<Id>>(
+		s_busyProcessIdsKeyName);
+	if (busyProcessIdsPtr)
+	{
+		return busyProcessIdsPtr->size();
+	}
+
+	return 0;
+}
+
+void InterprocessIndexingStatusManager::updateWorkerPoolHeartbeat()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	time_t* heartbeatPtr = access.accessValue<time_t>(s_workerPoolHeartbeatKeyName);
+	if (heartbeatPtr)
+	{
+		*heartbeatPtr = std::time(nullptr);
+	}
+}
+
+void InterprocessIndexingStatusManager::stopWorkerPool()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	time_t* heartbeatPtr = access.accessValue<time_t>(s_workerPoolHeartbeatKeyName);
+	if (heartbeatPtr)
+	{
+		*heartbeatPtr = 0;
+	}
+
+	notifyStatusChange(access);
+}
+
+bool InterprocessIndexingStatusManager::isWorkerPoolAlive()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	time_t* heartbeatPtr = access.accessValue<time_t>(s_workerPoolHeartbeatKeyName);
+	if (heartbeatPtr && *heartbeatPtr)
+	{
+		// also stops waiting if the app went away without shutting down the pool
+		return std::time(nullptr) - *heartbeatPtr < s_workerPoolTimeoutSeconds;
+	}
+
+	return false;
+}
+
+void InterprocessIndexingStatusManager::addIndexedHeaderFilePaths(
+	const std::wstring& contextKey, const std::set<FilePath>& filePaths)
+{
+	if (filePaths.empty())
+	{
+		return;
+	}
+
+	std::vector<std::string> entries;
+	size_t estimatedSize = 0;
+	for (const FilePath& filePath: filePaths)
+	{
+		entries.push_back(utility::encodeToUtf8(contextKey + L'|' + filePath.wstr()));
+		estimatedSize += sizeof(SharedMemory::String) + entries.back().size();
+	}
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	const size_t overestimationMultiplier = 3;
+	estimatedSize *= overestimationMultiplier;
+	while (access.getFreeMemorySize() < estimatedSize)
+	{
+		access.growMemory(access.getMemorySize());
+	}
+
+	SharedMemory::Vector<SharedMemory::String>* indexedHeaderFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(
+			s_indexedHeaderFilesKeyName);
+	if (indexedHeaderFilesPtr)
+	{
+		for (const std::string& entry: entries)
+		{
+			SharedMemory::String str(access.getAllocator());
+			str = entry.c_str();
+			indexedHeaderFilesPtr->push_back(str);
+		}
+	}
+}
+
+std::set<FilePath> InterprocessIndexingStatusManager::getIndexedHeaderFilePaths(
+	const std::wstring& contextKey)
+{
+	std::set<FilePath> filePaths;
+
+	const std::string prefix = utility::encodeToUtf8(contextKey + L'|');
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Vector<SharedMemory::String>* indexedHeaderFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(
+			s_indexedHeaderFilesKeyName);
+	if (indexedHeaderFilesPtr)
+	{
+		for (const SharedMemory::String& entry: *indexedHeaderFilesPtr)
+		{
+			if (entry.size() > prefix.size() && entry.compare(0, prefix.size(), prefix.c_str()) == 0)
+			{
+				filePaths.insert(FilePath(utility::decodeFromUtf8(entry.c_str() + prefix.size())));
+			}
+		}
+	}
+
+	return filePaths;
+}
+
+bool InterprocessIndexingStatusManager::claimError(
+	const std::string& errorKey, const FilePath& translationUnit)
+{
+	const std::string translationUnitString = utility::encodeToUtf8(translationUnit.wstr());
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	const size_t overestimationMultiplier = 3;
+	const size_t estimatedSize = (2 * sizeof(SharedMemory::String) + errorKey.size() +
+								  translationUnitString.size()) *
+		overestimationMultiplier;
+	while (access.getFreeMemorySize() < estimatedSize)
+	{
+		access.growMemory(access.getMemorySize());
+	}
+
+	ClaimedErrors* claimedErrorsPtr = access.accessValueWithAllocator<ClaimedErrors>(
+		s_claimedErrorsKeyName);
+	if (!claimedErrorsPtr)
+	{
+		return true;
+	}
+
+	SharedMemory::String key(access.getAllocator());
+	key = errorKey.c_str();
+
+	auto it = claimedErrorsPtr->find(key);
+	if (it != claimedErrorsPtr->end())
+	{
+		// a translation unit retried after exceeding the memory limit records its errors again
+		return translationUnitString == it->second.c_str();
+	}
+
+	SharedMemory::String value(access.getAllocator());
+	value = translationUnitString.c_str();
+	claimedErrorsPtr->insert(std::make_pair(key, value));
+	return true;
+}
+
+void InterprocessIndexingStatusManager::addIsolatedSourceFilePath(const FilePath& filePath)
+{
+	addSourceFilePath(filePath, s_isolatedFilesKeyName);
+}
+
+std::vector<FilePath> InterprocessIndexingStatusManager::getIsolatedSourceFilePaths()
+{
+	return getSourceFilePaths(s_isolatedFilesKeyName);
+}
+
+void InterprocessIndexingStatusManager::addMemoryExceededSourceFilePath(const FilePath& filePath)
+{
+	addSourceFilePath(filePath, s_memoryExceededFilesKeyName);
+}
+
+std::vector<FilePath> InterprocessIndexingStatusManager::getMemoryExceededSourceFilePaths()
+{
+	return getSourceFilePaths(s_memoryExceededFilesKeyName);
+}
+
+void InterprocessIndexingStatusManager::clearIndexingStatus()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Queue<SharedMemory::String>* indexingFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
+			s_indexingFilesKeyName);
+	if (indexingFilesPtr)
+	{
+		indexingFilesPtr->clear();
+	}
+
+	SharedMemory::Vector<SharedMemory::String>* crashedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(
+			s_crashedFilesKeyName);
+	if (crashedFilesPtr)
+	{
+		crashedFilesPtr->clear();
+	}
+
+	SharedMemory::Map<Id, SharedMemory::String>* currentFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(
+			s_currentFilesKeyName);
+	if (currentFilesPtr)
+	{
+		currentFilesPtr->clear();
+	}
+
+	SharedMemory::Queue<Id>* finishedProcessIdsPtr =
+		access.accessValueWithAllocator<SharedMemory::Queue<Id>>(s_finishedProcessIdsKeyName);
+	if (finishedProcessIdsPtr)
+	{
+		finishedProcessIdsPtr->clear();
+	}
+
+	SharedMemory::Vector<SharedMemory::String>* indexedHeaderFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(
+			s_indexedHeaderFilesKeyName);
+	if (indexedHeaderFilesPtr)
+	{
+		indexedHeaderFilesPtr->clear();
+	}
+
+	ClaimedErrors* claimedErrorsPtr = access.accessValueWithAllocator<ClaimedErrors>(
+		s_claimedErrorsKeyName);
+	if (claimedErrorsPtr)
+	{
+		claimedErrorsPtr->clear();
+	}
+
+	for (const char* keyName: {s_isolatedFilesKeyName, s_memoryExceededFilesKeyName})
+	{
+		SharedMemory::Vector<SharedMemory::String>* filesPtr =
+			access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(keyName);
+		if (filesPtr)
+		{
+			filesPtr->clear();
+		}
+	}
+}
+
+void InterprocessIndexingStatusManager::setAllowedIndexerCount(size_t count)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	size_t* countPtr = access.accessValue<size_t>(s_allowedIndexerCountKeyName);
+	if (countPtr)
+	{
+		*countPtr = count;
+	}
+
+	notifyStatusChange(access);
+}
+
+size_t InterprocessIndexingStatusManager::getAllowedIndexerCount()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	size_t* countPtr = access.accessValue<size_t>(s_allowedIndexerCountKeyName);
+	return countPtr ? *countPtr : 0;
+}
+
+size_t InterprocessIndexingStatusManager::waitForStatusChange(size_t revision, size_t timeoutMS)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	size_t* revisionPtr = access.accessValue<size_t>(s_statusRevisionKeyName);
+	if (revisionPtr && *revisionPtr == revision)
+	{
+		access.waitForChange(timeoutMS);
+		revisionPtr = access.accessValue<size_t>(s_statusRevisionKeyName);
+	}
+
+	return revisionPtr ? *revisionPtr : revision;
+}
+
+void InterprocessIndexingStatusManager::notifyStatusChange()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+	notifyStatusChange(access);
+}
+
 Id InterprocessIndexingStatusManager::getNextFinishedProcessId()
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
@@ -202,3 +551,58 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 
 	return crashedFiles;
 }
+
+void InterprocessIndexingStatusManager::notifyStatusChange(SharedMemory::ScopedAccess& access)
+{
+	size_t* revisionPtr = access.accessValue<size_t>(s_statusRevisionKeyName);
+	if (revisionPtr)
+	{
+		(*revisionPtr)++;
+	}
+
+	access.notifyChange();
+}
+
+void InterprocessIndexingStatusManager::addSourceFilePath(
+	const FilePath& filePath, const char* keyName)
+{
+	const std::string filePathString = utility::encodeToUtf8(filePath.wstr());
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	const size_t overestimationMultiplier = 3;
+	const size_t estimatedSize = (sizeof(SharedMemory::String) + filePathString.size()) *
+		overestimationMultiplier;
+	while (access.getFreeMemorySize() < estimatedSize)
+	{
+		access.growMemory(access.getMemorySize());
+	}
+
+	SharedMemory::Vector<SharedMemory::String>* filesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(keyName);
+	if (filesPtr)
+	{
+		SharedMemory::String str(access.getAllocator());
+		str = filePathString.c_str();
+		filesPtr->push_back(str);
+	}
+}
+
+std::vector<FilePath> InterprocessIndexingStatusManager::getSourceFilePaths(const char* keyName)
+{
+	std::vector<FilePath> filePaths;
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Vector<SharedMemory::String>* filesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(keyName);
+	if (filesPtr)
+	{
+		for (const SharedMemory::String& filePath: *filesPtr)
+		{
+			filePaths.push_back(FilePath(utility::decodeFromUtf8(filePath.c_str())));
+		}
+	}
+
+	return filePaths;
+}
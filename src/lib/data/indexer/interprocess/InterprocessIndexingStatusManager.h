@@ -1,6 +1,7 @@
 #ifndef INTERPROCESS_INDEXING_STATUS_MANAGER_H
 #define INTERPROCESS_INDEXING_STATUS_MANAGER_H
 
+#include <ctime>
 #include <set>
 
 #include "BaseInterprocessDataManager.h"
@@ -15,9 +16,50 @@ public:
 	void startIndexingSourceFile(const FilePath& filePath);
 	void finishIndexingSourceFile();
 
+	// files indexed together, a crash of the process is attributed to the first of them
+	void startIndexingSourceFiles(const std::vector<FilePath>& filePaths);
+
 	void setIndexingInterrupted(bool interrupted);
 	bool getIndexingInterrupted();
 
+	// a process counts as busy from before fetching a command until its queue turned out empty
+	void setProcessBusy(Id processId, bool busy);
+	size_t getBusyProcessCount();
+
+	// indexer processes keep waiting for new commands as long as the pool updates its heartbeat
+	void updateWorkerPoolHeartbeat();
+	void stopWorkerPool();
+	bool isWorkerPoolAlive();
+
+	// headers indexed without errors by a finished translation unit, other translation units with
+	// the same preprocessor context key don't need to visit their declarations again
+	void addIndexedHeaderFilePaths(const std::wstring& contextKey, const std::set<FilePath>& filePaths);
+	std::set<FilePath> getIndexedHeaderFilePaths(const std::wstring& contextKey);
+
+	// an error shared by many translation units is only recorded by the first one claiming it,
+	// returns false if another translation unit claimed it before in this indexing run
+	bool claimError(const std::string& errorKey, const FilePath& translationUnit);
+
+	// files that exceeded the memory limit of an indexer process and are retried in an isolated
+	// one, and files that exceeded the larger allowance of the isolated process as well
+	void addIsolatedSourceFilePath(const FilePath& filePath);
+	std::vector<FilePath> getIsolatedSourceFilePaths();
+	void addMemoryExceededSourceFilePath(const FilePath& filePath);
+	std::vector<FilePath> getMemoryExceededSourceFilePaths();
+
+	// drops the status left over from the previous indexing run
+	void clearIndexingStatus();
+
+	// indexers with a higher process id don't start new files while the user interacts with the
+	// app, 0 allows all of them
+	void setAllowedIndexerCount(size_t count);
+	size_t getAllowedIndexerCount();
+
+	// every change of the status that the app reacts to increases the revision and wakes the
+	// processes waiting for it, returns the revision after waiting at most timeoutMS
+	size_t waitForStatusChange(size_t revision, size_t timeoutMS);
+	void notifyStatusChange();
+
 	Id getNextFinishedProcessId();
 
 	std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
@@ -26,11 +68,26 @@ public:
 private:
 	static const char* s_sharedMemoryNamePrefix;
 
+	void notifyStatusChange(SharedMemory::ScopedAccess& access);
+
+	void addSourceFilePath(const FilePath& filePath, const char* keyName);
+	std::vector<FilePath> getSourceFilePaths(const char* keyName);
+
 	static const char* s_indexingFilesKeyName;
 	static const char* s_currentFilesKeyName;
 	static const char* s_crashedFilesKeyName;
 	static const char* s_finishedProcessIdsKeyName;
 	static const char* s_indexingInterruptedKeyName;
+	static const char* s_busyProcessIdsKeyName;
+	static const char* s_workerPoolHeartbeatKeyName;
+	static const char* s_indexedHeaderFilesKeyName;
+	static const char* s_claimedErrorsKeyName;
+	static const char* s_statusRevisionKeyName;
+	static const char* s_isolatedFilesKeyName;
+	static const char* s_memoryExceededFilesKeyName;
+	static const char* s_allowedIndexerCountKeyName;
+
+	static const time_t s_workerPoolTimeoutSeconds;
 };
 
 #endif	  // INTERPROCESS_INDEXING_STATUS_MANAGER_H
@@ -1,6 +1,9 @@
 #include "InterprocessIntermediateStorageManager.h"
 
+#include <algorithm>
+
 #include "IntermediateStorage.h"
+#include "MetricsRegistry.h"
 #include "SharedIntermediateStorage.h"
 #include "logging.h"
 
@@ -8,6 +11,10 @@ const char* InterprocessIntermediateStorageManager::s_sharedMemoryNamePrefix = "
 
 const char* InterprocessIntermediateStorageManager::s_intermediatStoragesKeyName =
 	"intermediate_storages";
+const char* InterprocessIntermediateStorageManager::s_predictedStorageSizeKeyName =
+	"predicted_storage_size";
+const char* InterprocessIntermediateStorageManager::s_growCountKeyName = "grow_count";
+const char* InterprocessIntermediateStorageManager::s_grownBytesKeyName = "grown_bytes";
 
 InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
@@ -17,41 +24,56 @@ InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 		  instanceUuid,
 		  processId,
 		  isOwner)
-	, m_insertsWithoutGrowth(0)
 {
 }
 
 void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 	const std::shared_ptr<IntermediateStorage>& intermediateStorage)
 {
-	const size_t requiredInsertsToShrink = 10;
-
-	const size_t overestimationMultiplier = 2;
-	const size_t requiredSize = (intermediateStorage->getByteSize(sizeof(SharedMemory::String)) +
-								 sizeof(SharedIntermediateStorage)) *
-			overestimationMultiplier +
-		1048576 /* 1 MB */;
+	// the exact size is known up front, the overhead covers the queue and segment bookkeeping
+	const size_t storageSize = SharedIntermediateStorage::getByteSize(*intermediateStorage) +
+		sizeof(SharedIntermediateStorage);
+	const size_t requiredSize = storageSize + 65536 /* 64 KB */;
 
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
+	// the segment belongs to this producer and outlives restarts of its process, so it remembers
+	// the size of recent storages, decaying to not stay large after a single huge one
+	size_t predictedSize = 0;
+	if (size_t* predictedSizePtr = access.accessValue<size_t>(s_predictedStorageSizeKeyName))
+	{
+		predictedSize = std::max(storageSize, *predictedSizePtr - *predictedSizePtr / 4);
+		*predictedSizePtr = predictedSize;
+	}
+
 	const size_t freeMemory = access.getFreeMemorySize();
 	if (freeMemory < requiredSize)
 	{
-		const size_t requiredGrowth = requiredSize - freeMemory;
+		// leaves room for the next storage, which gets queued while the app fetches this one,
+		// and growing at least by the current size keeps the number of remaps logarithmic
+		const size_t requiredGrowth = std::max(
+			requiredSize + predictedSize - freeMemory, access.getMemorySize());
 
 		LOG_INFO_STREAM(
-			<< "grow memory - est: " << requiredSize << " size: " << access.getMemorySize()
-			<< " free: " << access.getFreeMemorySize() << " alloc: " << requiredGrowth);
-
-		access.growMemory(requiredGrowth);
-
-		LOG_INFO("growing memory succeeded");
-
-		m_insertsWithoutGrowth = 0;
-	}
-	else
-	{
-		m_insertsWithoutGrowth++;
+			<< "grow memory - req: " << requiredSize << " size: " << access.getMemorySize()
+			<< " free: " << freeMemory << " alloc: " << requiredGrowth);
+
+		if (access.growMemory(requiredGrowth))
+		{
+			LOG_INFO("growing memory succeeded");
+
+			size_t* growCountPtr = access.accessValue<size_t>(s_growCountKeyName);
+			size_t* grownBytesPtr = access.accessValue<size_t>(s_grownBytesKeyName);
+			if (growCountPtr && grownBytesPtr)
+			{
+				(*growCountPtr)++;
+				*grownBytesPtr += requiredGrowth;
+			}
+		}
+		else
+		{
+			LOG_ERROR_STREAM(<< "growing memory failed - size: " << access.getMemorySize());
+		}
 	}
 
 	SharedMemory::Queue<SharedIntermediateStorage>* queue =
@@ -63,30 +85,7 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 	}
 
 	queue->push_back(SharedIntermediateStorage(access.getAllocator()));
-	SharedIntermediateStorage& storage = queue->back();
-
-	storage.setStorageNodes(intermediateStorage->getStorageNodes());
-	storage.setStorageFiles(intermediateStorage->getStorageFiles());
-	storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
-	storage.setStorageEdges(intermediateStorage->getStorageEdges());
-	storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
-	storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
-	storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
-	storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
-	storage.setStorageErrors(intermediateStorage->getErrors());
-
-	storage.setNextId(intermediateStorage->getNextId());
-
-	if (m_insertsWithoutGrowth >= requiredInsertsToShrink)
-	{
-		m_insertsWithoutGrowth = 0;
-
-		LOG_INFO("shrinking shared memory");
-		access.shrinkToFitMemory();
-		LOG_INFO_STREAM(
-			<< "shrunk memory - size: " << access.getMemorySize()
-			<< " free: " << access.getFreeMemorySize());
-	}
+	queue->back().write(*intermediateStorage);
 
 	LOG_INFO(access.logString());
 }
@@ -103,25 +102,28 @@ std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::pop
 		return nullptr;
 	}
 
-	SharedIntermediateStorage& sharedIntermediateStorage = queue->front();
-
-	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-
-	storage->setStorageNodes(sharedIntermediateStorage.getStorageNodes());
-	storage->setStorageFiles(sharedIntermediateStorage.getStorageFiles());
-	storage->setStorageSymbols(sharedIntermediateStorage.getStorageSymbols());
-	storage->setStorageEdges(sharedIntermediateStorage.getStorageEdges());
-	storage->setStorageLocalSymbols(sharedIntermediateStorage.getStorageLocalSymbols());
-	storage->setStorageSourceLocations(sharedIntermediateStorage.getStorageSourceLocations());
-	storage->setStorageOccurrences(sharedIntermediateStorage.getStorageOccurrences());
-	storage->setComponentAccesses(sharedIntermediateStorage.getStorageComponentAccesses());
-	storage->setErrors(sharedIntermediateStorage.getStorageErrors());
-
-	storage->setNextId(sharedIntermediateStorage.getNextId());
+	std::shared_ptr<IntermediateStorage> storage = queue->front().read();
 
 	queue->pop_front();
 	LOG_INFO(access.logString());
 
+	static MetricCounter& growCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_shared_memory_grow_events_total",
+		"Times an indexer grew its shared memory segment for indexed storages");
+	static MetricCounter& grownBytesCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_shared_memory_grown_bytes_total",
+		"Bytes the indexers grew their shared memory segments by");
+
+	const size_t* growCountPtr = access.accessValue<size_t>(s_growCountKeyName);
+	const size_t* grownBytesPtr = access.accessValue<size_t>(s_grownBytesKeyName);
+	if (growCountPtr && grownBytesPtr && *growCountPtr > m_reportedGrowCount)
+	{
+		growCounter.add(*growCountPtr - m_reportedGrowCount);
+		grownBytesCounter.add(*grownBytesPtr - m_reportedGrownBytes);
+		m_reportedGrowCount = *growCountPtr;
+		m_reportedGrownBytes = *grownBytesPtr;
+	}
+
 	return storage;
 }
 
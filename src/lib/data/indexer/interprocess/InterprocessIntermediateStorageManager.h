@@ -19,8 +19,13 @@ public:
 private:
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_intermediatStoragesKeyName;
+	static const char* s_predictedStorageSizeKeyName;
+	static const char* s_growCountKeyName;
+	static const char* s_grownBytesKeyName;
 
-	size_t m_insertsWithoutGrowth;
+	// grow events of the segment the app already added to its metrics
+	size_t m_reportedGrowCount = 0;
+	size_t m_reportedGrownBytes = 0;
 };
 
 #endif	  // INTERPROCESS_INTERMEDIATE_STORAGE_MANAGER_H
@@ -21,6 +21,7 @@ void SharedIndexerCommand::fromLocal(IndexerCommand* indexerCommand)
 		setIncludeFilters(cmd->getIncludeFilters());
 		setWorkingDirectory(cmd->getWorkingDirectory());
 		setCompilerFlags(cmd->getCompilerFlags());
+		setShallow(cmd->isShallow());
 		return;
 	}
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -49,13 +50,17 @@ std::shared_ptr<IndexerCommand> SharedIndexerCommand::fromShared(const SharedInd
 	{
 #if BUILD_CXX_LANGUAGE_PACKAGE
 	case CXX:
-		return std::make_shared<IndexerCommandCxx>(
+	{
+		std::shared_ptr<IndexerCommandCxx> command = std::make_shared<IndexerCommandCxx>(
 			indexerCommand.getSourceFilePath(),
 			indexerCommand.getIndexedPaths(),
 			indexerCommand.getExcludeFilters(),
 			indexerCommand.getIncludeFilters(),
 			indexerCommand.getWorkingDirectory(),
 			indexerCommand.getCompilerFlags());
+		command->setShallow(indexerCommand.getShallow());
+		return command;
+	}
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 #if BUILD_JAVA_LANGUAGE_PACKAGE
 	case JAVA:
@@ -83,6 +88,7 @@ SharedIndexerCommand::SharedIndexerCommand(SharedMemory::Allocator* allocator)
 	, m_includeFilters(allocator)
 	, m_workingDirectory("", allocator)
 	, m_compilerFlags(allocator)
+	, m_shallow(false)
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 #if BUILD_JAVA_LANGUAGE_PACKAGE
 	, m_languageStandard("", allocator)
@@ -213,6 +219,16 @@ void SharedIndexerCommand::setCompilerFlags(const std::vector<std::wstring>& com
 	}
 }
 
+bool SharedIndexerCommand::getShallow() const
+{
+	return m_shallow;
+}
+
+void SharedIndexerCommand::setShallow(bool shallow)
+{
+	m_shallow = shallow;
+}
+
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 
 #if BUILD_JAVA_LANGUAGE_PACKAGE
@@ -255,6 +271,24 @@ void SharedIndexerCommand::setClassPaths(const std::vector<FilePath>& classPaths
 
 #endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
 
+IndexerCommandType SharedIndexerCommand::getIndexerCommandType() const
+{
+	switch (getType())
+	{
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	case CXX:
+		return INDEXER_COMMAND_CXX;
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+#if BUILD_JAVA_LANGUAGE_PACKAGE
+	case JAVA:
+		return INDEXER_COMMAND_JAVA;
+#endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
+	default:
+		break;
+	}
+	return INDEXER_COMMAND_UNKNOWN;
+}
+
 SharedIndexerCommand::Type SharedIndexerCommand::getType() const
 {
 	return m_type;
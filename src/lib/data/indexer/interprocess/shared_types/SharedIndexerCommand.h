@@ -7,6 +7,7 @@
 
 #include "FilePath.h"
 #include "FilePathFilter.h"
+#include "IndexerCommandType.h"
 #include "SharedMemory.h"
 
 class IndexerCommand;
@@ -20,6 +21,8 @@ public:
 	SharedIndexerCommand(SharedMemory::Allocator* allocator);
 	~SharedIndexerCommand();
 
+	IndexerCommandType getIndexerCommandType() const;
+
 	FilePath getSourceFilePath() const;
 	void setSourceFilePath(const FilePath& filePath);
 
@@ -40,6 +43,9 @@ public:
 	std::vector<std::wstring> getCompilerFlags() const;
 	void setCompilerFlags(const std::vector<std::wstring>& compilerFlags);
 
+	bool getShallow() const;
+	void setShallow(bool shallow);
+
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 #if BUILD_JAVA_LANGUAGE_PACKAGE
 
@@ -77,6 +83,7 @@ private:
 	SharedMemory::Vector<SharedMemory::String> m_includeFilters;
 	SharedMemory::String m_workingDirectory;
 	SharedMemory::Vector<SharedMemory::String> m_compilerFlags;
+	bool m_shallow;
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 
 #if BUILD_JAVA_LANGUAGE_PACKAGE
@@ -1,234 +1,435 @@
 #include "SharedIntermediateStorage.h"
 
-SharedIntermediateStorage::SharedIntermediateStorage(SharedMemory::Allocator* allocator)
-	: m_storageFiles(allocator)
-	, m_storageSymbols(allocator)
-	, m_storageOccurrences(allocator)
-	, m_storageComponentAccesses(allocator)
-	, m_storageNodes(allocator)
-	, m_storageEdges(allocator)
-	, m_storageLocalSymbols(allocator)
-	, m_storageSourceLocations(allocator)
-	, m_storageErrors(allocator)
-	, m_allocator(allocator)
-	, m_nextId(1)
-{
-}
+#include <cstring>
+#include <type_traits>
 
-SharedIntermediateStorage::~SharedIntermediateStorage() {}
+#include "IntermediateStorage.h"
+#include "StorageField.h"
+#include "logging.h"
 
-std::vector<StorageFile> SharedIntermediateStorage::getStorageFiles() const
+namespace
+{
+// Counts the bytes only if no buffer is given, so the same code computes the size and writes.
+class BinaryWriter
 {
-	std::vector<StorageFile> result;
-	result.reserve(m_storageFiles.size());
+public:
+	BinaryWriter(char* data = nullptr): m_data(data), m_size(0) {}
 
-	for (unsigned int i = 0; i < m_storageFiles.size(); i++)
+	template <typename T>
+	void writeValue(const T& value)
 	{
-		result.emplace_back(fromShared(m_storageFiles[i]));
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values are written directly");
+		writeBytes(&value, sizeof(T));
 	}
 
-	return result;
-}
+	template <typename CharType>
+	void writeString(const std::basic_string<CharType>& value)
+	{
+		writeValue<size_t>(value.size());
+		writeBytes(value.data(), value.size() * sizeof(CharType));
+	}
 
-void SharedIntermediateStorage::setStorageFiles(const std::vector<StorageFile>& storageFiles)
-{
-	m_storageFiles.clear();
+	// the fields of a storage type in their order
+	template <typename StorageType>
+	void writeFields(const StorageType& value)
+	{
+		utility::forEachStorageField<StorageType>(
+			[&](size_t, const auto& field) { writeField(value.*(field.member)); });
+	}
 
-	for (unsigned int i = 0; i < storageFiles.size(); i++)
+	size_t getSize() const
 	{
-		m_storageFiles.push_back(toShared(storageFiles[i], m_allocator));
+		return m_size;
 	}
-}
 
-std::vector<StorageNode> SharedIntermediateStorage::getStorageNodes() const
-{
-	std::vector<StorageNode> result;
-	result.reserve(m_storageNodes.size());
+private:
+	template <typename T>
+	void writeField(const T& value)
+	{
+		writeValue(value);
+	}
 
-	for (unsigned int i = 0; i < m_storageNodes.size(); i++)
+	template <typename CharType>
+	void writeField(const std::basic_string<CharType>& value)
 	{
-		result.emplace_back(fromShared(m_storageNodes[i]));
+		writeString(value);
 	}
 
-	return result;
-}
+	void writeBytes(const void* bytes, size_t byteCount)
+	{
+		if (m_data && byteCount)
+		{
+			std::memcpy(m_data + m_size, bytes, byteCount);
+		}
+		m_size += byteCount;
+	}
 
-void SharedIntermediateStorage::setStorageNodes(const std::vector<StorageNode>& storageNodes)
+	char* m_data;
+	size_t m_size;
+};
+
+class BinaryReader
 {
-	m_storageNodes.clear();
+public:
+	BinaryReader(const char* data, size_t size): m_data(data), m_size(size), m_position(0), m_failed(false)
+	{
+	}
 
-	for (unsigned int i = 0; i < storageNodes.size(); i++)
+	template <typename T>
+	T readValue()
 	{
-		m_storageNodes.push_back(toShared(storageNodes[i], m_allocator));
+		T value = T();
+		readBytes(&value, sizeof(T));
+		return value;
 	}
-}
 
-std::vector<StorageSymbol> SharedIntermediateStorage::getStorageSymbols() const
-{
-	std::vector<StorageSymbol> result;
-	result.reserve(m_storageSymbols.size());
+	template <typename CharType>
+	std::basic_string<CharType> readString()
+	{
+		const size_t length = readCount(sizeof(CharType));
+		std::basic_string<CharType> value(length, CharType());
+		readBytes(&value[0], length * sizeof(CharType));
+		return value;
+	}
 
-	for (unsigned int i = 0; i < m_storageSymbols.size(); i++)
+	// checks the count against the remaining data before anything gets allocated for it
+	size_t readCount(size_t minElementSize)
 	{
-		result.emplace_back(fromShared(m_storageSymbols[i]));
+		const size_t count = readValue<size_t>();
+		if (m_failed || (minElementSize && count > (m_size - m_position) / minElementSize))
+		{
+			m_failed = true;
+			return 0;
+		}
+		return count;
 	}
 
-	return result;
-}
+	template <typename StorageType>
+	void readFields(StorageType* value)
+	{
+		utility::forEachStorageField<StorageType>(
+			[&](size_t, const auto& field) { readField(&(value->*(field.member))); });
+	}
 
-void SharedIntermediateStorage::setStorageSymbols(const std::vector<StorageSymbol>& storageSymbols)
-{
-	m_storageSymbols.clear();
+	bool hasFailed() const
+	{
+		return m_failed;
+	}
 
-	for (unsigned int i = 0; i < storageSymbols.size(); i++)
+	bool isAtEnd() const
 	{
-		m_storageSymbols.push_back(toShared(storageSymbols[i], m_allocator));
+		return m_position == m_size;
 	}
-}
 
-std::vector<StorageEdge> SharedIntermediateStorage::getStorageEdges() const
-{
-	std::vector<StorageEdge> result;
-	result.reserve(m_storageEdges.size());
+private:
+	template <typename T>
+	void readField(T* value)
+	{
+		*value = readValue<T>();
+	}
 
-	for (unsigned int i = 0; i < m_storageEdges.size(); i++)
+	template <typename CharType>
+	void readField(std::basic_string<CharType>* value)
 	{
-		result.emplace_back(fromShared(m_storageEdges[i]));
+		*value = readString<CharType>();
 	}
 
-	return result;
-}
+	void readBytes(void* bytes, size_t byteCount)
+	{
+		if (m_failed || byteCount > m_size - m_position)
+		{
+			m_failed = true;
+			return;
+		}
+
+		if (byteCount)
+		{
+			std::memcpy(bytes, m_data + m_position, byteCount);
+		}
+		m_position += byteCount;
+	}
+
+	const char* m_data;
+	const size_t m_size;
+	size_t m_position;
+	bool m_failed;
+};
 
-void SharedIntermediateStorage::setStorageEdges(const std::vector<StorageEdge>& storageEdges)
+void writeStorage(const IntermediateStorage& storage, int formatVersion, BinaryWriter& writer)
 {
-	m_storageEdges.clear();
+	writer.writeValue<int>(formatVersion);
+	writer.writeValue<size_t>(sizeof(wchar_t));
+	writer.writeValue<Id>(storage.getNextId());
 
-	for (unsigned int i = 0; i < storageEdges.size(); i++)
+	writer.writeValue<size_t>(storage.getStorageNodes().size());
+	for (const StorageNode& node: storage.getStorageNodes())
 	{
-		m_storageEdges.push_back(toShared(storageEdges[i], m_allocator));
+		writer.writeFields(node);
 	}
-}
 
-std::set<StorageLocalSymbol> SharedIntermediateStorage::getStorageLocalSymbols() const
-{
-	std::set<StorageLocalSymbol> result;
+	writer.writeValue<size_t>(storage.getStorageFiles().size());
+	for (const StorageFile& file: storage.getStorageFiles())
+	{
+		writer.writeValue<Id>(file.id);
+		writer.writeString(file.filePath);
+		writer.writeString(file.languageIdentifier);
+		writer.writeString(file.modificationTime);
+		writer.writeValue<bool>(file.indexed);
+		writer.writeValue<bool>(file.complete);
+	}
 
-	for (unsigned int i = 0; i < m_storageLocalSymbols.size(); i++)
+	writer.writeValue<size_t>(storage.getStorageSymbols().size());
+	for (const StorageSymbol& symbol: storage.getStorageSymbols())
 	{
-		result.emplace(fromShared(m_storageLocalSymbols[i]));
+		writer.writeFields(symbol);
 	}
 
-	return result;
-}
+	writer.writeValue<size_t>(storage.getStorageEdges().size());
+	for (const StorageEdge& edge: storage.getStorageEdges())
+	{
+		writer.writeFields(edge);
+	}
 
-void SharedIntermediateStorage::setStorageLocalSymbols(
-	const std::set<StorageLocalSymbol>& storageLocalSymbols)
-{
-	m_storageLocalSymbols.clear();
+	writer.writeValue<size_t>(storage.getStorageLocalSymbols().size());
+	for (const StorageLocalSymbol& localSymbol: storage.getStorageLocalSymbols())
+	{
+		writer.writeFields(localSymbol);
+	}
 
-	for (const StorageLocalSymbol& localSymbol: storageLocalSymbols)
+	writer.writeValue<size_t>(storage.getStorageSourceLocations().size());
+	for (const StorageSourceLocation& location: storage.getStorageSourceLocations())
 	{
-		m_storageLocalSymbols.push_back(toShared(localSymbol, m_allocator));
+		writer.writeFields(location);
 	}
-}
 
-std::set<StorageSourceLocation> SharedIntermediateStorage::getStorageSourceLocations() const
-{
-	std::set<StorageSourceLocation> result;
+	writer.writeValue<size_t>(storage.getStorageOccurrences().size());
+	for (const StorageOccurrence& occurrence: storage.getStorageOccurrences())
+	{
+		writer.writeFields(occurrence);
+	}
 
-	for (unsigned int i = 0; i < m_storageSourceLocations.size(); i++)
+	writer.writeValue<size_t>(storage.getComponentAccesses().size());
+	for (const StorageComponentAccess& access: storage.getComponentAccesses())
 	{
-		result.emplace(fromShared(m_storageSourceLocations[i]));
+		writer.writeFields(access);
 	}
 
-	return result;
-}
+	writer.writeValue<size_t>(storage.getElementComponents().size());
+	for (const StorageElementComponent& component: storage.getElementComponents())
+	{
+		writer.writeValue<Id>(component.elementId);
+		writer.writeValue<int>(component.type);
+		writer.writeString(component.data);
+	}
 
-void SharedIntermediateStorage::setStorageSourceLocations(
-	const std::set<StorageSourceLocation>& storageSourceLocations)
-{
-	m_storageSourceLocations.clear();
+	const std::vector<StorageIndexingTime> indexingTimes = storage.getIndexingTimes();
+	writer.writeValue<size_t>(indexingTimes.size());
+	for (const StorageIndexingTime& indexingTime: indexingTimes)
+	{
+		writer.writeString(indexingTime.filePath);
+		writer.writeValue<size_t>(indexingTime.durationMs);
+		writer.writeValue<size_t>(indexingTime.parseDurationMs);
+		writer.writeValue<size_t>(indexingTime.visitDurationMs);
+		writer.writeValue<size_t>(indexingTime.peakMemoryKb);
+		writer.writeValue<size_t>(indexingTime.storageByteCount);
+		writer.writeValue<size_t>(indexingTime.garbageCollectionDurationMs);
+	}
 
-	for (const StorageSourceLocation& sourceLocation: storageSourceLocations)
+	writer.writeValue<size_t>(storage.getErrors().size());
+	for (const StorageError& error: storage.getErrors())
 	{
-		m_storageSourceLocations.push_back(toShared(sourceLocation, m_allocator));
+		writer.writeValue<Id>(error.id);
+		writer.writeString(error.message);
+		writer.writeString(error.translationUnit);
+		writer.writeValue<bool>(error.fatal);
+		writer.writeValue<bool>(error.indexed);
 	}
 }
 
-std::set<StorageOccurrence> SharedIntermediateStorage::getStorageOccurrences() const
+std::shared_ptr<IntermediateStorage> readStorage(int formatVersion, BinaryReader& reader)
 {
-	std::set<StorageOccurrence> result;
+	if (reader.readValue<int>() != formatVersion || reader.readValue<size_t>() != sizeof(wchar_t))
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	storage->setNextId(reader.readValue<Id>());
 
-	for (unsigned int i = 0; i < m_storageOccurrences.size(); i++)
 	{
-		result.emplace(fromShared(m_storageOccurrences[i]));
+		std::vector<StorageNode> nodes(reader.readCount(sizeof(Id)));
+		for (StorageNode& node: nodes)
+		{
+			reader.readFields(&node);
+		}
+		storage->setStorageNodes(std::move(nodes));
 	}
 
-	return result;
-}
+	{
+		std::vector<StorageFile> files(reader.readCount(sizeof(Id)));
+		for (StorageFile& file: files)
+		{
+			file.id = reader.readValue<Id>();
+			file.filePath = reader.readString<wchar_t>();
+			file.languageIdentifier = reader.readString<wchar_t>();
+			file.modificationTime = reader.readString<char>();
+			file.indexed = reader.readValue<bool>();
+			file.complete = reader.readValue<bool>();
+		}
+		storage->setStorageFiles(std::move(files));
+	}
 
-void SharedIntermediateStorage::setStorageOccurrences(const std::set<StorageOccurrence>& storageOccurences)
-{
-	m_storageOccurrences.clear();
+	{
+		std::vector<StorageSymbol> symbols(reader.readCount(sizeof(Id)));
+		for (StorageSymbol& symbol: symbols)
+		{
+			reader.readFields(&symbol);
+		}
+		storage->setStorageSymbols(std::move(symbols));
+	}
 
-	for (const StorageOccurrence& occurrence: storageOccurences)
 	{
-		m_storageOccurrences.push_back(toShared(occurrence, m_allocator));
+		std::vector<StorageEdge> edges(reader.readCount(sizeof(Id)));
+		for (StorageEdge& edge: edges)
+		{
+			reader.readFields(&edge);
+		}
+		storage->setStorageEdges(std::move(edges));
 	}
-}
 
-std::set<StorageComponentAccess> SharedIntermediateStorage::getStorageComponentAccesses() const
-{
-	std::set<StorageComponentAccess> result;
+	{
+		std::vector<StorageLocalSymbol> localSymbols(reader.readCount(sizeof(Id)));
+		for (StorageLocalSymbol& localSymbol: localSymbols)
+		{
+			reader.readFields(&localSymbol);
+		}
+		storage->setStorageLocalSymbols(std::move(localSymbols));
+	}
 
-	for (unsigned int i = 0; i < m_storageComponentAccesses.size(); i++)
 	{
-		result.emplace(fromShared(m_storageComponentAccesses[i]));
+		std::vector<StorageSourceLocation> locations(reader.readCount(sizeof(Id)));
+		for (StorageSourceLocation& location: locations)
+		{
+			reader.readFields(&location);
+		}
+		storage->setStorageSourceLocations(std::move(locations));
 	}
 
-	return result;
-}
+	{
+		std::vector<StorageOccurrence> occurrences(reader.readCount(sizeof(Id)));
+		for (StorageOccurrence& occurrence: occurrences)
+		{
+			reader.readFields(&occurrence);
+		}
+		storage->setStorageOccurrences(std::move(occurrences));
+	}
 
-void SharedIntermediateStorage::setStorageComponentAccesses(
-	const std::set<StorageComponentAccess>& storageComponentAccesses)
-{
-	m_storageComponentAccesses.clear();
+	{
+		std::vector<StorageComponentAccess> accesses(reader.readCount(sizeof(Id)));
+		for (StorageComponentAccess& access: accesses)
+		{
+			reader.readFields(&access);
+		}
+		storage->setComponentAccesses(std::move(accesses));
+	}
 
-	for (const StorageComponentAccess& componentAccess: storageComponentAccesses)
 	{
-		m_storageComponentAccesses.push_back(toShared(componentAccess, m_allocator));
+		std::vector<StorageElementComponent> components(reader.readCount(sizeof(Id)));
+		for (StorageElementComponent& component: components)
+		{
+			component.elementId = reader.readValue<Id>();
+			component.type = reader.readValue<int>();
+			component.data = reader.readString<wchar_t>();
+		}
+		storage->setElementComponents(std::move(components));
 	}
-}
 
-std::vector<StorageError> SharedIntermediateStorage::getStorageErrors() const
-{
-	std::vector<StorageError> result;
-	result.reserve(m_storageErrors.size());
+	{
+		std::vector<StorageIndexingTime> indexingTimes(reader.readCount(sizeof(size_t)));
+		for (StorageIndexingTime& indexingTime: indexingTimes)
+		{
+			indexingTime.filePath = reader.readString<wchar_t>();
+			indexingTime.durationMs = reader.readValue<size_t>();
+			indexingTime.parseDurationMs = reader.readValue<size_t>();
+			indexingTime.visitDurationMs = reader.readValue<size_t>();
+			indexingTime.peakMemoryKb = reader.readValue<size_t>();
+			indexingTime.storageByteCount = reader.readValue<size_t>();
+			indexingTime.garbageCollectionDurationMs = reader.readValue<size_t>();
+		}
+		storage->addIndexingTimes(indexingTimes);
+	}
 
-	for (unsigned int i = 0; i < m_storageErrors.size(); i++)
 	{
-		result.emplace_back(fromShared(m_storageErrors[i]));
+		std::vector<StorageError> errors(reader.readCount(sizeof(Id)));
+		for (StorageError& error: errors)
+		{
+			error.id = reader.readValue<Id>();
+			error.message = reader.readString<wchar_t>();
+			error.translationUnit = reader.readString<wchar_t>();
+			error.fatal = reader.readValue<bool>();
+			error.indexed = reader.readValue<bool>();
+		}
+		storage->setErrors(std::move(errors));
 	}
 
-	return result;
+	if (reader.hasFailed() || !reader.isAtEnd())
+	{
+		return nullptr;
+	}
+
+	return storage;
 }
+}	 // namespace
+
+const int SharedIntermediateStorage::s_formatVersion = 4;
 
-void SharedIntermediateStorage::setStorageErrors(const std::vector<StorageError>& errors)
+size_t SharedIntermediateStorage::getByteSize(const IntermediateStorage& storage)
 {
-	m_storageErrors.clear();
+	BinaryWriter writer;
+	writeStorage(storage, s_formatVersion, writer);
+	return writer.getSize();
+}
 
-	for (unsigned int i = 0; i < errors.size(); i++)
-	{
-		m_storageErrors.push_back(toShared(errors[i], m_allocator));
-	}
+std::string SharedIntermediateStorage::serialize(const IntermediateStorage& storage)
+{
+	std::string data(getByteSize(storage), '\0');
+
+	BinaryWriter writer(&data[0]);
+	writeStorage(storage, s_formatVersion, writer);
+	return data;
 }
 
-Id SharedIntermediateStorage::getNextId() const
+std::shared_ptr<IntermediateStorage> SharedIntermediateStorage::deserialize(const std::string& data)
 {
-	return m_nextId;
+	BinaryReader reader(data.data(), data.size());
+	return readStorage(s_formatVersion, reader);
+}
+
+SharedIntermediateStorage::SharedIntermediateStorage(SharedMemory::Allocator* allocator)
+	: m_data(allocator)
+{
+}
+
+void SharedIntermediateStorage::write(const IntermediateStorage& storage)
+{
+	m_data.resize(getByteSize(storage));
+
+	BinaryWriter writer(m_data.data());
+	writeStorage(storage, s_formatVersion, writer);
+}
+
+std::shared_ptr<IntermediateStorage> SharedIntermediateStorage::read() const
+{
+	BinaryReader reader(m_data.data(), m_data.size());
+	std::shared_ptr<IntermediateStorage> storage = readStorage(s_formatVersion, reader);
+	if (!storage)
+	{
+		LOG_ERROR("Intermediate storage in shared memory is malformed and was skipped.");
+	}
+	return storage;
 }
 
-void SharedIntermediateStorage::setNextId(const Id nextId)
+size_t SharedIntermediateStorage::getDataSize() const
 {
-	m_nextId = nextId;
+	return m_data.size();
 }
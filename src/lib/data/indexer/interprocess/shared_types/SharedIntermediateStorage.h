@@ -1,62 +1,41 @@
 #ifndef SHARED_INTERMEDIATE_STORAGE_H
 #define SHARED_INTERMEDIATE_STORAGE_H
 
-#include <set>
-#include <vector>
+#include <memory>
+#include <string>
 
 #include "SharedMemory.h"
-#include "SharedStorageTypes.h"
 
+class IntermediateStorage;
+
+// Holds an IntermediateStorage as a single flat binary block in shared memory. The block only
+// contains counts, plain values and inline string data, so it has no pointers and can be mapped at
+// any address. Both ends are the same build, so values are stored in their native layout.
 class SharedIntermediateStorage
 {
 public:
-	SharedIntermediateStorage(SharedMemory::Allocator* allocator);
-	~SharedIntermediateStorage();
-
-	std::vector<StorageNode> getStorageNodes() const;
-	void setStorageNodes(const std::vector<StorageNode>& storageNodes);
-
-	std::vector<StorageFile> getStorageFiles() const;
-	void setStorageFiles(const std::vector<StorageFile>& storageFiles);
+	// size of the block written for the storage, allows growing the shared memory exactly once
+	static size_t getByteSize(const IntermediateStorage& storage);
 
-	std::vector<StorageSymbol> getStorageSymbols() const;
-	void setStorageSymbols(const std::vector<StorageSymbol>& storageSymbols);
+	// the same block as a plain buffer, e.g. for keeping a storage in a file for a while
+	static std::string serialize(const IntermediateStorage& storage);
 
-	std::vector<StorageEdge> getStorageEdges() const;
-	void setStorageEdges(const std::vector<StorageEdge>& storageEdges);
+	// returns empty shared_ptr if the block is malformed
+	static std::shared_ptr<IntermediateStorage> deserialize(const std::string& data);
 
-	std::set<StorageLocalSymbol> getStorageLocalSymbols() const;
-	void setStorageLocalSymbols(const std::set<StorageLocalSymbol>& storageLocalSymbols);
-
-	std::set<StorageSourceLocation> getStorageSourceLocations() const;
-	void setStorageSourceLocations(const std::set<StorageSourceLocation>& storageSourceLocations);
-
-	std::set<StorageOccurrence> getStorageOccurrences() const;
-	void setStorageOccurrences(const std::set<StorageOccurrence>& storageOccurences);
+	SharedIntermediateStorage(SharedMemory::Allocator* allocator);
 
-	std::set<StorageComponentAccess> getStorageComponentAccesses() const;
-	void setStorageComponentAccesses(const std::set<StorageComponentAccess>& storageComponentAccesses);
+	void write(const IntermediateStorage& storage);
 
-	std::vector<StorageError> getStorageErrors() const;
-	void setStorageErrors(const std::vector<StorageError>& errors);
+	// returns empty shared_ptr if the block is malformed
+	std::shared_ptr<IntermediateStorage> read() const;
 
-	Id getNextId() const;
-	void setNextId(const Id nextId);
+	size_t getDataSize() const;
 
 private:
-	SharedMemory::Vector<SharedStorageFile> m_storageFiles;
-	SharedMemory::Vector<SharedStorageSymbol> m_storageSymbols;
-	SharedMemory::Vector<SharedStorageOccurrence> m_storageOccurrences;
-	SharedMemory::Vector<SharedStorageComponentAccess> m_storageComponentAccesses;
-	SharedMemory::Vector<SharedStorageNode> m_storageNodes;
-	SharedMemory::Vector<SharedStorageEdge> m_storageEdges;
-	SharedMemory::Vector<SharedStorageLocalSymbol> m_storageLocalSymbols;
-	SharedMemory::Vector<SharedStorageSourceLocation> m_storageSourceLocations;
-	SharedMemory::Vector<SharedStorageError> m_storageErrors;
-
-	SharedMemory::Allocator* m_allocator;
-
-	int m_nextId;
+	static const int s_formatVersion;
+
+	SharedMemory::Vector<char> m_data;
 };
 
 #endif	  // SHARED_INTERMEDIATE_STORAGE_H
@@ -1,21 +1,35 @@
 #include "SourceLocation.h"
 
+#include <algorithm>
+
 #include "SourceLocationFile.h"
 
+bool SourceLocationTokenIds::contains(Id id) const
+{
+	return std::find(begin(), end(), id) != end();
+}
+
+std::vector<Id> SourceLocationTokenIds::toVector() const
+{
+	return std::vector<Id>(begin(), end());
+}
+
 SourceLocation::SourceLocation(
 	SourceLocationFile* file,
 	LocationType type,
 	Id locationId,
-	std::vector<Id> tokenIds,
+	uint32_t tokenIdOffset,
+	uint32_t tokenIdCount,
 	size_t lineNumber,
 	size_t columnNumber,
 	bool isStart)
 	: m_file(file)
 	, m_type(type)
 	, m_locationId(locationId)
-	, m_tokenIds(tokenIds)
-	, m_lineNumber(lineNumber)
-	, m_columnNumber(columnNumber)
+	, m_tokenIdOffset(tokenIdOffset)
+	, m_tokenIdCount(tokenIdCount)
+	, m_lineNumber(uint32_t(lineNumber))
+	, m_columnNumber(uint32_t(columnNumber))
 	, m_other(nullptr)
 	, m_isStart(isStart)
 {
@@ -25,20 +39,23 @@ SourceLocation::SourceLocation(SourceLocation* other, size_t lineNumber, size_t
 	: m_file(other->m_file)
 	, m_type(other->m_type)
 	, m_locationId(other->m_locationId)
-	, m_tokenIds(other->m_tokenIds)
-	, m_lineNumber(lineNumber)
-	, m_columnNumber(columnNumber)
+	, m_tokenIdOffset(other->m_tokenIdOffset)
+	, m_tokenIdCount(other->m_tokenIdCount)
+	, m_lineNumber(uint32_t(lineNumber))
+	, m_columnNumber(uint32_t(columnNumber))
 	, m_other(other)
 	, m_isStart(!other->m_isStart)
 {
 	other->setOtherLocation(this);
 }
 
-SourceLocation::SourceLocation(const SourceLocation* other, SourceLocationFile* file)
+SourceLocation::SourceLocation(
+	const SourceLocation* other, SourceLocationFile* file, uint32_t tokenIdOffset)
 	: m_file(file)
 	, m_type(other->m_type)
 	, m_locationId(other->m_locationId)
-	, m_tokenIds(other->m_tokenIds)
+	, m_tokenIdOffset(tokenIdOffset)
+	, m_tokenIdCount(other->m_tokenIdCount)
 	, m_lineNumber(other->m_lineNumber)
 	, m_columnNumber(other->m_columnNumber)
 	, m_other(nullptr)
@@ -46,8 +63,6 @@ SourceLocation::SourceLocation(const SourceLocation* other, SourceLocationFile*
 {
 }
 
-SourceLocation::~SourceLocation() {}
-
 bool SourceLocation::operator==(const SourceLocation& rhs) const
 {
 	return (
@@ -128,9 +143,9 @@ Id SourceLocation::getLocationId() const
 	return m_locationId;
 }
 
-const std::vector<Id>& SourceLocation::getTokenIds() const
+SourceLocationTokenIds SourceLocation::getTokenIds() const
 {
-	return m_tokenIds;
+	return m_file->getTokenIds(m_tokenIdOffset, m_tokenIdCount);
 }
 
 LocationType SourceLocation::getType() const
@@ -1,6 +1,7 @@
 #ifndef SOURCE_LOCATION_H
 #define SOURCE_LOCATION_H
 
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -11,6 +12,43 @@
 class FilePath;
 class SourceLocationFile;
 
+// view of the token ids of a location, which stays valid until locations are added to its file
+class SourceLocationTokenIds
+{
+public:
+	SourceLocationTokenIds(const Id* data, size_t size): m_data(data), m_size(size) {}
+
+	const Id* begin() const
+	{
+		return m_data;
+	}
+	const Id* end() const
+	{
+		return m_data + m_size;
+	}
+	size_t size() const
+	{
+		return m_size;
+	}
+	bool empty() const
+	{
+		return !m_size;
+	}
+	Id operator[](size_t index) const
+	{
+		return m_data[index];
+	}
+
+	bool contains(Id id) const;
+	std::vector<Id> toVector() const;
+
+private:
+	const Id* m_data;
+	size_t m_size;
+};
+
+// Locations are created by their SourceLocationFile, which keeps them and the token ids of all of
+// them in pooled storage.
 class SourceLocation
 {
 public:
@@ -18,13 +56,13 @@ public:
 		SourceLocationFile* file,
 		LocationType type,
 		Id locationId,
-		std::vector<Id> tokenIds,
+		uint32_t tokenIdOffset,
+		uint32_t tokenIdCount,
 		size_t lineNumber,
 		size_t columnNumber,
 		bool isStart);
 	SourceLocation(SourceLocation* other, size_t lineNumber, size_t columnNumber);
-	SourceLocation(const SourceLocation* other, SourceLocationFile* file);
-	virtual ~SourceLocation();
+	SourceLocation(const SourceLocation* other, SourceLocationFile* file, uint32_t tokenIdOffset);
 
 	bool operator==(const SourceLocation& rhs) const;
 	bool operator<(const SourceLocation& rhs) const;
@@ -35,7 +73,7 @@ public:
 	SourceLocationFile* getSourceLocationFile() const;
 
 	Id getLocationId() const;
-	const std::vector<Id>& getTokenIds() const;
+	SourceLocationTokenIds getTokenIds() const;
 	LocationType getType() const;
 
 	size_t getColumnNumber() const;
@@ -55,15 +93,18 @@ public:
 	bool isFullTextSearchMatch() const;
 
 private:
+	friend class SourceLocationFile;
+
 	SourceLocationFile* m_file;
 
 	LocationType m_type;
 
 	const Id m_locationId;
-	const std::vector<Id> m_tokenIds;
+	const uint32_t m_tokenIdOffset;	   // in the token ids of the file
+	const uint32_t m_tokenIdCount;
 
-	const size_t m_lineNumber;
-	const size_t m_columnNumber;
+	const uint32_t m_lineNumber;
+	const uint32_t m_columnNumber;
 
 	SourceLocation* m_other;
 	const bool m_isStart;
@@ -1,5 +1,7 @@
 #include "SourceLocationFile.h"
 
+#include <algorithm>
+
 SourceLocationFile::SourceLocationFile(
 	const FilePath& filePath, const std::wstring& language, bool isWhole, bool isComplete, bool isIndexed)
 	: m_filePath(filePath)
@@ -7,9 +9,46 @@ SourceLocationFile::SourceLocationFile(
 	, m_isWhole(isWhole)
 	, m_isComplete(isComplete)
 	, m_isIndexed(isIndexed)
+	, m_locationsSorted(true)
 {
 }
 
+SourceLocationFile::SourceLocationFile(const SourceLocationFile& other)
+	: m_filePath(other.m_filePath)
+	, m_language(other.m_language)
+	, m_isWhole(other.m_isWhole)
+	, m_isComplete(other.m_isComplete)
+	, m_isIndexed(other.m_isIndexed)
+	, m_tokenIds(other.m_tokenIds)
+	, m_locationsSorted(true)
+{
+	std::unordered_map<const SourceLocation*, SourceLocation*> copies;
+	for (const SourceLocation& location: other.m_locationPool)
+	{
+		m_locationPool.emplace_back(&location, this, location.m_tokenIdOffset);
+		copies.emplace(&location, &m_locationPool.back());
+	}
+
+	for (const SourceLocation& location: other.m_locationPool)
+	{
+		auto it = copies.find(location.getOtherLocation());
+		if (it != copies.end())
+		{
+			copies[&location]->setOtherLocation(it->second);
+		}
+	}
+
+	for (const SourceLocation* location: other.getSourceLocations())
+	{
+		m_locations.push_back(copies[location]);
+	}
+
+	for (const std::pair<const Id, SourceLocation*>& p: other.m_locationIndex)
+	{
+		m_locationIndex.emplace(p.first, copies[p.second]);
+	}
+}
+
 SourceLocationFile::~SourceLocationFile() {}
 
 const FilePath& SourceLocationFile::getFilePath() const
@@ -57,9 +96,17 @@ bool SourceLocationFile::isIndexed() const
 	return m_isIndexed;
 }
 
-const std::multiset<std::shared_ptr<SourceLocation>, SourceLocationFile::LocationComp>& SourceLocationFile::
-	getSourceLocations() const
+const std::vector<SourceLocation*>& SourceLocationFile::getSourceLocations() const
 {
+	std::lock_guard<std::mutex> lock(m_locationsMutex);
+	if (!m_locationsSorted)
+	{
+		std::stable_sort(
+			m_locations.begin(),
+			m_locations.end(),
+			[](const SourceLocation* lhs, const SourceLocation* rhs) { return *lhs < *rhs; });
+		m_locationsSorted = true;
+	}
 	return m_locations;
 }
 
@@ -71,7 +118,7 @@ size_t SourceLocationFile::getSourceLocationCount() const
 size_t SourceLocationFile::getUnscopedStartLocationCount() const
 {
 	size_t count = 0;
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (const SourceLocation* location: m_locations)
 	{
 		if (location->isStartLocation() && !location->isScopeLocation())
 		{
@@ -84,26 +131,37 @@ size_t SourceLocationFile::getUnscopedStartLocationCount() const
 SourceLocation* SourceLocationFile::addSourceLocation(
 	LocationType type,
 	Id locationId,
-	std::vector<Id> tokenIds,
+	const std::vector<Id>& tokenIds,
 	size_t startLineNumber,
 	size_t startColumnNumber,
 	size_t endLineNumber,
 	size_t endColumnNumber)
 {
-	std::shared_ptr<SourceLocation> start = std::make_shared<SourceLocation>(
-		this, type, locationId, tokenIds, startLineNumber, startColumnNumber, true);
-	std::shared_ptr<SourceLocation> end = std::make_shared<SourceLocation>(
-		start.get(), endLineNumber, endColumnNumber);
-
-	m_locations.insert(start);
-	m_locations.insert(end);
+	const uint32_t tokenIdOffset = addTokenIds(
+		SourceLocationTokenIds(tokenIds.data(), tokenIds.size()));
+
+	m_locationPool.emplace_back(
+		this,
+		type,
+		locationId,
+		tokenIdOffset,
+		uint32_t(tokenIds.size()),
+		startLineNumber,
+		startColumnNumber,
+		true);
+	SourceLocation* start = &m_locationPool.back();
+	m_locationPool.emplace_back(start, endLineNumber, endColumnNumber);
+	SourceLocation* end = &m_locationPool.back();
+
+	addLocation(start);
+	addLocation(end);
 
 	if (start->getLocationId())
 	{
-		m_locationIndex.emplace(start->getLocationId(), start.get());
+		m_locationIndex.emplace(start->getLocationId(), start);
 	}
 
-	return start.get();
+	return start;
 }
 
 SourceLocation* SourceLocationFile::addSourceLocationCopy(const SourceLocation* location)
@@ -124,22 +182,24 @@ SourceLocation* SourceLocationFile::addSourceLocationCopy(const SourceLocation*
 		}
 	}
 
-	std::shared_ptr<SourceLocation> copy = std::make_shared<SourceLocation>(location, this);
-	m_locations.insert(copy);
+	const uint32_t tokenIdOffset = addTokenIds(location->getTokenIds());
+	m_locationPool.emplace_back(location, this, tokenIdOffset);
+	SourceLocation* copy = &m_locationPool.back();
+	addLocation(copy);
 
 	if (copy->getLocationId())
 	{
-		m_locationIndex.emplace(copy->getLocationId(), copy.get());
+		m_locationIndex.emplace(copy->getLocationId(), copy);
 	}
 
 	// If the old location was added before, then link them with each other.
 	if (oldLocation)
 	{
-		oldLocation->setOtherLocation(copy.get());
+		oldLocation->setOtherLocation(copy);
 		copy->setOtherLocation(oldLocation);
 	}
 
-	return copy.get();
+	return copy;
 }
 
 void SourceLocationFile::copySourceLocations(std::shared_ptr<SourceLocationFile> file)
@@ -149,7 +209,7 @@ void SourceLocationFile::copySourceLocations(std::shared_ptr<SourceLocationFile>
 
 SourceLocation* SourceLocationFile::getSourceLocationById(Id locationId) const
 {
-	std::map<Id, SourceLocation*>::const_iterator it = m_locationIndex.find(locationId);
+	std::unordered_map<Id, SourceLocation*>::const_iterator it = m_locationIndex.find(locationId);
 
 	if (it != m_locationIndex.end())
 	{
@@ -159,32 +219,37 @@ SourceLocation* SourceLocationFile::getSourceLocationById(Id locationId) const
 	return nullptr;
 }
 
+SourceLocationTokenIds SourceLocationFile::getTokenIds(uint32_t offset, uint32_t count) const
+{
+	return SourceLocationTokenIds(m_tokenIds.data() + offset, count);
+}
+
 void SourceLocationFile::forEachSourceLocation(std::function<void(SourceLocation*)> func) const
 {
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (SourceLocation* location: getSourceLocations())
 	{
-		func(location.get());
+		func(location);
 	}
 }
 
 void SourceLocationFile::forEachStartSourceLocation(std::function<void(SourceLocation*)> func) const
 {
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (SourceLocation* location: getSourceLocations())
 	{
 		if (location->isStartLocation())
 		{
-			func(location.get());
+			func(location);
 		}
 	}
 }
 
 void SourceLocationFile::forEachEndSourceLocation(std::function<void(SourceLocation*)> func) const
 {
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (SourceLocation* location: getSourceLocations())
 	{
 		if (location->isEndLocation())
 		{
-			func(location.get());
+			func(location);
 		}
 	}
 }
@@ -195,12 +260,12 @@ std::shared_ptr<SourceLocationFile> SourceLocationFile::getFilteredByLines(
 	std::shared_ptr<SourceLocationFile> ret = std::make_shared<SourceLocationFile>(
 		getFilePath(), getLanguage(), false, isComplete(), isIndexed());
 
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (SourceLocation* location: getSourceLocations())
 	{
 		if (location->getLineNumber() >= firstLineNumber &&
 			location->getLineNumber() <= lastLineNumber)
 		{
-			ret->addSourceLocationCopy(location.get());
+			ret->addSourceLocationCopy(location);
 		}
 	}
 
@@ -212,11 +277,11 @@ std::shared_ptr<SourceLocationFile> SourceLocationFile::getFilteredByType(Locati
 	std::shared_ptr<SourceLocationFile> ret = std::make_shared<SourceLocationFile>(
 		getFilePath(), getLanguage(), false, isComplete(), isIndexed());
 
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (SourceLocation* location: getSourceLocations())
 	{
 		if (location->getType() == type)
 		{
-			ret->addSourceLocationCopy(location.get());
+			ret->addSourceLocationCopy(location);
 		}
 	}
 
@@ -235,17 +300,43 @@ std::shared_ptr<SourceLocationFile> SourceLocationFile::getFilteredByTypes(
 	std::shared_ptr<SourceLocationFile> ret = std::make_shared<SourceLocationFile>(
 		getFilePath(), getLanguage(), isWhole(), isComplete(), isIndexed());
 
-	for (const std::shared_ptr<SourceLocation>& location: m_locations)
+	for (SourceLocation* location: getSourceLocations())
 	{
 		if ((1 << location->getType()) & typeMask)
 		{
-			ret->addSourceLocationCopy(location.get());
+			ret->addSourceLocationCopy(location);
 		}
 	}
 
 	return ret;
 }
 
+void SourceLocationFile::addLocation(SourceLocation* location)
+{
+	std::lock_guard<std::mutex> lock(m_locationsMutex);
+	if (m_locationsSorted && !m_locations.empty() && *location < *m_locations.back())
+	{
+		m_locationsSorted = false;
+	}
+	m_locations.push_back(location);
+}
+
+uint32_t SourceLocationFile::addTokenIds(SourceLocationTokenIds tokenIds)
+{
+	const uint32_t offset = uint32_t(m_tokenIds.size());
+	if (tokenIds.begin() >= m_tokenIds.data() && tokenIds.end() <= m_tokenIds.data() + offset)
+	{
+		// the ids of a location of this file are moved when the array grows
+		const std::vector<Id> ids = tokenIds.toVector();
+		m_tokenIds.insert(m_tokenIds.end(), ids.begin(), ids.end());
+	}
+	else
+	{
+		m_tokenIds.insert(m_tokenIds.end(), tokenIds.begin(), tokenIds.end());
+	}
+	return offset;
+}
+
 std::wostream& operator<<(std::wostream& ostream, const SourceLocationFile& file)
 {
 	ostream << L"file \"" << file.getFilePath().wstr() << L"\"";
@@ -1,35 +1,33 @@
 #ifndef SOURCE_LOCATION_FILE_H
 #define SOURCE_LOCATION_FILE_H
 
+#include <deque>
 #include <functional>
-#include <map>
 #include <memory>
+#include <mutex>
 #include <ostream>
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "FilePath.h"
 #include "LocationType.h"
 #include "SourceLocation.h"
 #include "types.h"
 
+// Keeps its locations in a pool and the token ids of all of them in one array. The locations are
+// sorted by position lazily, so files read in order from the database are never sorted at all.
 class SourceLocationFile
 {
 public:
-	struct LocationComp
-	{
-		bool operator()(
-			const std::shared_ptr<SourceLocation>& lhs, const std::shared_ptr<SourceLocation>& rhs) const
-		{
-			return *(lhs.get()) < *(rhs.get());
-		}
-	};
-
 	SourceLocationFile(
 		const FilePath& filePath,
 		const std::wstring& language,
 		bool isWhole,
 		bool isComplete,
 		bool isIndexed);
+	// copies all locations, which then belong to the new file
+	SourceLocationFile(const SourceLocationFile& other);
+	SourceLocationFile& operator=(const SourceLocationFile&) = delete;
 	virtual ~SourceLocationFile();
 
 	const FilePath& getFilePath() const;
@@ -46,7 +44,8 @@ public:
 	void setIsIndexed(bool isIndexed);
 	bool isIndexed() const;
 
-	const std::multiset<std::shared_ptr<SourceLocation>, LocationComp>& getSourceLocations() const;
+	// locations at equal positions keep the order in which they were added
+	const std::vector<SourceLocation*>& getSourceLocations() const;
 
 	size_t getSourceLocationCount() const;
 	size_t getUnscopedStartLocationCount() const;
@@ -54,7 +53,7 @@ public:
 	SourceLocation* addSourceLocation(
 		LocationType type,
 		Id locationId,
-		std::vector<Id> tokenIds,
+		const std::vector<Id>& tokenIds,
 		size_t startLineNumber,
 		size_t startColumnNumber,
 		size_t endLineNumber,
@@ -65,6 +64,8 @@ public:
 
 	SourceLocation* getSourceLocationById(Id locationId) const;
 
+	SourceLocationTokenIds getTokenIds(uint32_t offset, uint32_t count) const;
+
 	void forEachSourceLocation(std::function<void(SourceLocation*)> func) const;
 	void forEachStartSourceLocation(std::function<void(SourceLocation*)> func) const;
 	void forEachEndSourceLocation(std::function<void(SourceLocation*)> func) const;
@@ -81,8 +82,17 @@ private:
 	bool m_isComplete;
 	bool m_isIndexed;
 
-	std::multiset<std::shared_ptr<SourceLocation>, LocationComp> m_locations;
-	std::map<Id, SourceLocation*> m_locationIndex;
+	void addLocation(SourceLocation* location);
+	uint32_t addTokenIds(SourceLocationTokenIds tokenIds);
+
+	std::deque<SourceLocation> m_locationPool;
+	std::vector<Id> m_tokenIds;
+
+	mutable std::vector<SourceLocation*> m_locations;
+	mutable bool m_locationsSorted;
+	mutable std::mutex m_locationsMutex;
+
+	std::unordered_map<Id, SourceLocation*> m_locationIndex;
 };
 
 std::wostream& operator<<(std::wostream& ostream, const SourceLocationFile& base);
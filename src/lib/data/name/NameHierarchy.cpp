@@ -2,6 +2,8 @@
 
 #include <sstream>
 
+#include <boost/locale/encoding_utf.hpp>
+
 #include "logging.h"
 #include "utilityString.h"
 
@@ -11,6 +13,19 @@ const std::wstring META_DELIMITER = L"\tm";
 const std::wstring NAME_DELIMITER = L"\tn";
 const std::wstring PART_DELIMITER = L"\ts";
 const std::wstring SIGNATURE_DELIMITER = L"\tp";
+
+void appendBinaryField(std::string& data, const std::wstring& field)
+{
+	const std::string utf8 = utility::encodeToUtf8(field);
+	size_t sizeWithOne = utf8.size() + 1;
+	while (sizeWithOne >= 0x80)
+	{
+		data.push_back(static_cast<char>((sizeWithOne & 0x7F) | 0x80));
+		sizeWithOne >>= 7;
+	}
+	data.push_back(static_cast<char>(sizeWithOne));
+	data.append(utf8);
+}
 }	 // namespace
 
 std::wstring NameHierarchy::serialize(const NameHierarchy& nameHierarchy)
@@ -40,15 +55,97 @@ std::wstring NameHierarchy::serializeRange(const NameHierarchy& nameHierarchy, s
 
 NameHierarchy NameHierarchy::deserialize(const std::wstring& serializedName)
 {
-	size_t mpos = serializedName.find(META_DELIMITER);
-	if (mpos == std::wstring::npos)
+	NameHierarchy nameHierarchy(NAME_DELIMITER_UNKNOWN);
+	if (!deserializeElements(serializedName, &nameHierarchy))
 	{
 		LOG_ERROR(L"unable to deserialize name hierarchy: " + serializedName);	  // todo: obfuscate
 																				  // serializedName!
 		return NameHierarchy(NAME_DELIMITER_UNKNOWN);
 	}
 
-	NameHierarchy nameHierarchy(serializedName.substr(0, mpos));
+	fixDuplicateMainDefinition(&nameHierarchy);
+	return nameHierarchy;
+}
+
+std::string NameHierarchy::serializeToBinary(const NameHierarchy& nameHierarchy)
+{
+	return serializeRangeToBinary(nameHierarchy, 0, nameHierarchy.size());
+}
+
+std::string NameHierarchy::serializeRangeToBinary(
+	const NameHierarchy& nameHierarchy, size_t first, size_t last)
+{
+	std::string data;
+	appendBinaryField(data, nameHierarchy.getDelimiter());
+	for (size_t i = first; i < last && i < nameHierarchy.size(); i++)
+	{
+		appendBinaryField(data, nameHierarchy[i].getName());
+		appendBinaryField(data, nameHierarchy[i].getSignature().getPrefix());
+		appendBinaryField(data, nameHierarchy[i].getSignature().getPostfix());
+	}
+	return data;
+}
+
+NameHierarchy NameHierarchy::deserializeFromBinary(const std::string& serializedName)
+{
+	NameHierarchy nameHierarchy(NAME_DELIMITER_UNKNOWN);
+	if (!deserializeBinaryElements(serializedName, &nameHierarchy))
+	{
+		LOG_ERROR("unable to deserialize binary name hierarchy");
+		return NameHierarchy(NAME_DELIMITER_UNKNOWN);
+	}
+
+	fixDuplicateMainDefinition(&nameHierarchy);
+	return nameHierarchy;
+}
+
+std::string NameHierarchy::convertSerializedToBinary(const std::wstring& serializedName)
+{
+	NameHierarchy nameHierarchy(NAME_DELIMITER_UNKNOWN);
+	if (!deserializeElements(serializedName, &nameHierarchy))
+	{
+		LOG_ERROR(L"unable to convert name hierarchy: " + serializedName);
+	}
+	return serializeToBinary(nameHierarchy);
+}
+
+std::wstring NameHierarchy::convertBinaryToSerialized(const std::string& serializedName)
+{
+	NameHierarchy nameHierarchy(NAME_DELIMITER_UNKNOWN);
+	if (!deserializeBinaryElements(serializedName, &nameHierarchy))
+	{
+		LOG_ERROR("unable to convert binary name hierarchy");
+	}
+	return serialize(nameHierarchy);
+}
+
+bool NameHierarchy::deserializeBinaryElements(
+	const std::string& serializedName, NameHierarchy* nameHierarchy)
+{
+	BinaryReader reader(serializedName);
+	nameHierarchy->setDelimiter(reader.getDelimiter().decode());
+
+	BinaryReader::Field name;
+	BinaryReader::Field prefix;
+	BinaryReader::Field postfix;
+	while (reader.readElement(&name, &prefix, &postfix))
+	{
+		nameHierarchy->push(NameElement(name.decode(), prefix.decode(), postfix.decode()));
+	}
+
+	return reader.isValid();
+}
+
+bool NameHierarchy::deserializeElements(
+	const std::wstring& serializedName, NameHierarchy* nameHierarchy)
+{
+	size_t mpos = serializedName.find(META_DELIMITER);
+	if (mpos == std::wstring::npos)
+	{
+		return false;
+	}
+
+	nameHierarchy->setDelimiter(serializedName.substr(0, mpos));
 
 	size_t npos = mpos + META_DELIMITER.size();
 	while (npos != std::wstring::npos && npos < serializedName.size())
@@ -57,10 +154,7 @@ NameHierarchy NameHierarchy::deserialize(const std::wstring& serializedName)
 		size_t spos = serializedName.find(PART_DELIMITER, npos);
 		if (spos == std::wstring::npos)
 		{
-			LOG_ERROR(
-				L"unable to deserialize name hierarchy: " +
-				serializedName);	// todo: obfuscate serializedName!
-			return NameHierarchy(NAME_DELIMITER_UNKNOWN);
+			return false;
 		}
 
 		std::wstring name = serializedName.substr(npos, spos - npos);
@@ -70,10 +164,7 @@ NameHierarchy NameHierarchy::deserialize(const std::wstring& serializedName)
 		size_t ppos = serializedName.find(SIGNATURE_DELIMITER, spos);
 		if (ppos == std::wstring::npos)
 		{
-			LOG_ERROR(
-				L"unable to deserialize name hierarchy: " +
-				serializedName);	// todo: obfuscate serializedName!
-			return NameHierarchy(NAME_DELIMITER_UNKNOWN);
+			return false;
 		}
 
 		std::wstring prefix = serializedName.substr(spos, ppos - spos);
@@ -91,20 +182,97 @@ NameHierarchy NameHierarchy::deserialize(const std::wstring& serializedName)
 			npos += NAME_DELIMITER.size();
 		}
 
-		nameHierarchy.push(NameElement(std::move(name), std::move(prefix), std::move(postfix)));
+		nameHierarchy->push(NameElement(std::move(name), std::move(prefix), std::move(postfix)));
 	}
 
+	return true;
+}
+
+void NameHierarchy::fixDuplicateMainDefinition(NameHierarchy* nameHierarchy)
+{
 	// TODO: replace duplicate main definition fix with better solution
-	if (nameHierarchy.size() == 1 && nameHierarchy.back().hasSignature() &&
-		!nameHierarchy.back().getName().empty() && nameHierarchy.back().getName()[0] == '.' &&
-		utility::isPrefix<std::wstring>(L".:main:.", nameHierarchy.back().getName()))
+	if (nameHierarchy->size() == 1 && nameHierarchy->back().hasSignature() &&
+		!nameHierarchy->back().getName().empty() && nameHierarchy->back().getName()[0] == '.' &&
+		utility::isPrefix<std::wstring>(L".:main:.", nameHierarchy->back().getName()))
 	{
-		NameElement::Signature sig = nameHierarchy.back().getSignature();
-		nameHierarchy.pop();
-		nameHierarchy.push(NameElement(L"main", sig.getPrefix(), sig.getPostfix()));
+		NameElement::Signature sig = nameHierarchy->back().getSignature();
+		nameHierarchy->pop();
+		nameHierarchy->push(NameElement(L"main", sig.getPrefix(), sig.getPostfix()));
 	}
+}
 
-	return nameHierarchy;
+NameHierarchy::BinaryReader::BinaryReader(const std::string& serializedName)
+	: m_position(serializedName.data())
+	, m_end(serializedName.data() + serializedName.size())
+	, m_valid(true)
+{
+	m_valid = readField(&m_delimiter);
+}
+
+bool NameHierarchy::BinaryReader::isValid() const
+{
+	return m_valid;
+}
+
+const NameHierarchy::BinaryReader::Field& NameHierarchy::BinaryReader::getDelimiter() const
+{
+	return m_delimiter;
+}
+
+bool NameHierarchy::BinaryReader::readElement(Field* name, Field* prefix, Field* postfix)
+{
+	if (!m_valid || m_position == m_end)
+	{
+		return false;
+	}
+
+	m_valid = readField(name) && readField(prefix) && readField(postfix);
+	return m_valid;
+}
+
+bool NameHierarchy::BinaryReader::readField(Field* field)
+{
+	size_t sizeWithOne = 0;
+	for (size_t shift = 0;; shift += 7)
+	{
+		if (m_position == m_end || shift > 56)
+		{
+			return false;
+		}
+
+		const unsigned char byte = static_cast<unsigned char>(*m_position++);
+		sizeWithOne |= size_t(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			break;
+		}
+	}
+
+	if (sizeWithOne == 0 || sizeWithOne - 1 > size_t(m_end - m_position))
+	{
+		return false;
+	}
+
+	field->data = m_position;
+	field->size = sizeWithOne - 1;
+	m_position += field->size;
+	return true;
+}
+
+std::wstring NameHierarchy::BinaryReader::Field::decode() const
+{
+	// most names are ASCII, which maps to the wide string without conversion
+	bool isAscii = true;
+	for (size_t i = 0; i < size; i++)
+	{
+		isAscii &= static_cast<unsigned char>(data[i]) < 0x80;
+	}
+
+	if (isAscii)
+	{
+		return std::wstring(data, data + size);
+	}
+	return boost::locale::conv::utf_to_utf<wchar_t>(data, data + size);
 }
 
 const std::wstring& NameHierarchy::getDelimiter() const
@@ -10,10 +10,53 @@
 class NameHierarchy
 {
 public:
+	// Reads the binary serialization without allocating. The binary serialization is the delimiter
+	// followed by name, signature prefix and signature postfix of each element. Each of these is
+	// UTF-8 preceded by its byte count plus one as varint, so the data contains no zero bytes and
+	// the serialization of a parent is a byte prefix of the serializations of its children.
+	class BinaryReader
+	{
+	public:
+		struct Field
+		{
+			std::wstring decode() const;
+
+			const char* data = nullptr;
+			size_t size = 0;
+		};
+
+		BinaryReader(const std::string& serializedName);
+
+		// false if the data is malformed, which is only known after reading all elements
+		bool isValid() const;
+		const Field& getDelimiter() const;
+
+		// returns false after the last element
+		bool readElement(Field* name, Field* prefix, Field* postfix);
+
+	private:
+		bool readField(Field* field);
+
+		const char* m_position;
+		const char* m_end;
+		Field m_delimiter;
+		bool m_valid;
+	};
+
 	static std::wstring serialize(const NameHierarchy& nameHierarchy);
 	static std::wstring serializeRange(const NameHierarchy& nameHierarchy, size_t first, size_t last);
 	static NameHierarchy deserialize(const std::wstring& serializedName);
 
+	// binary serialization used for the names of stored nodes
+	static std::string serializeToBinary(const NameHierarchy& nameHierarchy);
+	static std::string serializeRangeToBinary(
+		const NameHierarchy& nameHierarchy, size_t first, size_t last);
+	static NameHierarchy deserializeFromBinary(const std::string& serializedName);
+
+	// keep the names exactly as serialized, which deserializing adjusts for duplicate main functions
+	static std::string convertSerializedToBinary(const std::wstring& serializedName);
+	static std::wstring convertBinaryToSerialized(const std::string& serializedName);
+
 	NameHierarchy(std::wstring delimiter);
 	NameHierarchy(std::wstring name, std::wstring delimiter);
 	NameHierarchy(const std::vector<std::wstring>& names, std::wstring delimiter);
@@ -55,6 +98,11 @@ public:
 	NameElement::Signature getSignature() const;
 
 private:
+	static bool deserializeElements(const std::wstring& serializedName, NameHierarchy* nameHierarchy);
+	static bool deserializeBinaryElements(
+		const std::string& serializedName, NameHierarchy* nameHierarchy);
+	static void fixDuplicateMainDefinition(NameHierarchy* nameHierarchy);
+
 	std::vector<NameElement> m_elements;
 	std::wstring m_delimiter;
 };
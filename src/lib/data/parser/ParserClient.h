@@ -1,7 +1,9 @@
 #ifndef PARSER_CLIENT_H
 #define PARSER_CLIENT_H
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "AccessKind.h"
 #include "DefinitionKind.h"
@@ -11,9 +13,18 @@
 #include "SymbolKind.h"
 #include "types.h"
 
+class MemoryArena;
+
 class ParserClient
 {
 public:
+	struct LocationRecord
+	{
+		Id elementId;
+		ParseLocation location;
+		ParseLocationType type;
+	};
+
 	virtual ~ParserClient() = default;
 
 	virtual Id recordFile(const FilePath& filePath, bool indexed) = 0;
@@ -31,7 +42,12 @@ public:
 		const ParseLocation& location) = 0;
 
 	virtual void recordLocalSymbol(const std::wstring& name, const ParseLocation& location) = 0;
+	// the local symbol is identified by the file and start of its declaration location
+	virtual void recordLocalSymbol(
+		const ParseLocation& declarationLocation, const ParseLocation& location) = 0;
 	virtual void recordLocation(Id elementId, const ParseLocation& location, ParseLocationType type) = 0;
+	// same as recordLocation for each record, used by the ParserLocationBuffer
+	virtual void recordLocations(const std::vector<LocationRecord>& records) = 0;
 	virtual void recordComment(const ParseLocation& location) = 0;
 
 	virtual void recordError(
@@ -40,8 +56,19 @@ public:
 		bool indexed,
 		const FilePath& translationUnit,
 		const ParseLocation& location) = 0;
+	// marks the file incomplete like a recorded error in it does, for errors that are not recorded
+	virtual void recordIncompleteFile(Id fileId) = 0;
+
+	// time spent traversing the parsed translation unit, the rest of the indexing time is parsing
+	virtual void recordVisitDuration(size_t durationMs) = 0;
+
+	// time the runtime of the indexer spent collecting garbage while indexing
+	virtual void recordGarbageCollectionDuration(size_t durationMs) = 0;
 
 	virtual bool hasContent() const = 0;
+
+	// arena for data that lives as long as the currently indexed command
+	virtual std::shared_ptr<MemoryArena> getMemoryArena() const = 0;
 };
 
 #endif	  // PARSER_CLIENT_H
@@ -4,7 +4,12 @@
 #include "Node.h"
 #include "ParseLocation.h"
 
-ParserClientImpl::ParserClientImpl(IntermediateStorage* const storage): m_storage(storage) {}
+ParserClientImpl::ParserClientImpl(IntermediateStorage* const storage)
+	: m_storage(storage)
+	, m_fileIdMap(
+		  0, std::hash<std::wstring>(), std::equal_to<std::wstring>(), storage->getMemoryArena().get())
+{
+}
 
 Id ParserClientImpl::recordFile(const FilePath& filePath, bool indexed)
 {
@@ -61,11 +66,43 @@ void ParserClientImpl::recordLocalSymbol(const std::wstring& name, const ParseLo
 	addSourceLocation(localSymbolId, location, LOCATION_LOCAL_SYMBOL);
 }
 
+void ParserClientImpl::recordLocalSymbol(
+	const ParseLocation& declarationLocation, const ParseLocation& location)
+{
+	const Id localSymbolId = m_storage->addLocalSymbol(StorageLocalSymbolData(
+		declarationLocation.fileId,
+		declarationLocation.startLineNumber,
+		declarationLocation.startColumnNumber));
+	addSourceLocation(localSymbolId, location, LOCATION_LOCAL_SYMBOL);
+}
+
 void ParserClientImpl::recordLocation(Id elementId, const ParseLocation& location, ParseLocationType type)
 {
 	addSourceLocation(elementId, location, parseLocationTypeToLocationType(type));
 }
 
+void ParserClientImpl::recordLocations(const std::vector<LocationRecord>& records)
+{
+	std::vector<StorageOccurrence> occurrences;
+	occurrences.reserve(records.size());
+	for (const LocationRecord& record: records)
+	{
+		if (record.location.isValid())
+		{
+			const Id sourceLocationId = m_storage->addSourceLocation(StorageSourceLocationData(
+				record.location.fileId,
+				record.location.startLineNumber,
+				record.location.startColumnNumber,
+				record.location.endLineNumber,
+				record.location.endColumnNumber,
+				locationTypeToInt(parseLocationTypeToLocationType(record.type))));
+
+			occurrences.emplace_back(record.elementId, sourceLocationId);
+		}
+	}
+	m_storage->addOccurrences(occurrences);
+}
+
 void ParserClientImpl::recordComment(const ParseLocation& location)
 {
 	if (!location.isValid())
@@ -98,11 +135,56 @@ void ParserClientImpl::recordError(
 	}
 }
 
+void ParserClientImpl::recordIncompleteFile(Id fileId)
+{
+	m_incompleteFileIds.insert(fileId);
+}
+
+const std::set<Id>& ParserClientImpl::getIncompleteFileIds() const
+{
+	return m_incompleteFileIds;
+}
+
+void ParserClientImpl::recordVisitDuration(size_t durationMs)
+{
+	m_visitDurationMs += durationMs;
+}
+
+size_t ParserClientImpl::getVisitDurationMs() const
+{
+	return m_visitDurationMs;
+}
+
+void ParserClientImpl::recordGarbageCollectionDuration(size_t durationMs)
+{
+	m_garbageCollectionDurationMs += durationMs;
+}
+
+size_t ParserClientImpl::getGarbageCollectionDurationMs() const
+{
+	return m_garbageCollectionDurationMs;
+}
+
+void ParserClientImpl::setAllFilesIncomplete()
+{
+	m_storage->setAllFilesIncomplete();
+}
+
 bool ParserClientImpl::hasContent() const
 {
 	return m_storage->getByteSize(1) > 0;
 }
 
+std::shared_ptr<MemoryArena> ParserClientImpl::getMemoryArena() const
+{
+	return m_storage->getMemoryArena();
+}
+
+IntermediateStorage* ParserClientImpl::getStorage() const
+{
+	return m_storage;
+}
+
 NodeType ParserClientImpl::symbolKindToNodeType(SymbolKind symbolKind) const
 {
 	switch (symbolKind)
@@ -207,7 +289,7 @@ Id ParserClientImpl::addNodeHierarchy(const NameHierarchy& nameHierarchy)
 	{
 		std::pair<Id, bool> ret = m_storage->addNode(StorageNodeData(
 			NodeType::typeToInt(NodeType::NODE_SYMBOL),
-			NameHierarchy::serializeRange(nameHierarchy, 0, i)));
+			NameHierarchy::serializeRangeToBinary(nameHierarchy, 0, i)));
 
 		if (!firstNodeId)
 		{
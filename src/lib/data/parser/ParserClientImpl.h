@@ -2,6 +2,7 @@
 #define PARSER_CLIENT_IMPL_H
 
 #include <set>
+#include <unordered_map>
 
 #include "DefinitionKind.h"
 #include "IntermediateStorage.h"
@@ -29,7 +30,10 @@ public:
 		const ParseLocation& location) override;
 
 	void recordLocalSymbol(const std::wstring& name, const ParseLocation& location) override;
+	void recordLocalSymbol(
+		const ParseLocation& declarationLocation, const ParseLocation& location) override;
 	void recordLocation(Id elementId, const ParseLocation& location, ParseLocationType type) override;
+	void recordLocations(const std::vector<LocationRecord>& records) override;
 	void recordComment(const ParseLocation& location) override;
 
 	void recordError(
@@ -38,9 +42,24 @@ public:
 		bool indexed,
 		const FilePath& translationUnit,
 		const ParseLocation& location) override;
+	void recordIncompleteFile(Id fileId) override;
+	const std::set<Id>& getIncompleteFileIds() const;
+
+	void recordVisitDuration(size_t durationMs) override;
+	size_t getVisitDurationMs() const;
+
+	void recordGarbageCollectionDuration(size_t durationMs) override;
+	size_t getGarbageCollectionDurationMs() const;
+
+	// lets a refresh of the incomplete files index them again in depth
+	void setAllFilesIncomplete();
 
 	bool hasContent() const override;
 
+	std::shared_ptr<MemoryArena> getMemoryArena() const override;
+
+	IntermediateStorage* getStorage() const;
+
 private:
 	NodeType symbolKindToNodeType(SymbolKind symbolType) const;
 	Edge::EdgeType referenceKindToEdgeType(ReferenceKind referenceKind) const;
@@ -55,7 +74,16 @@ private:
 	void addSourceLocation(Id elementId, const ParseLocation& location, LocationType type);
 
 	IntermediateStorage* const m_storage;
-	std::map<std::wstring, Id> m_fileIdMap;
+	std::unordered_map<
+		std::wstring,
+		Id,
+		std::hash<std::wstring>,
+		std::equal_to<std::wstring>,
+		ArenaAllocator<std::pair<const std::wstring, Id>>>
+		m_fileIdMap;
+	std::set<Id> m_incompleteFileIds;
+	size_t m_visitDurationMs = 0;
+	size_t m_garbageCollectionDurationMs = 0;
 };
 
 #endif	  // PARSER_CLIENT_IMPL_H
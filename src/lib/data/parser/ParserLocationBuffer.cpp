@@ -0,0 +1,50 @@
+#include "ParserLocationBuffer.h"
+
+#include <algorithm>
+#include <tuple>
+
+const size_t ParserLocationBuffer::s_maxRecordCount = 8192;
+
+ParserLocationBuffer::ParserLocationBuffer(std::shared_ptr<ParserClient> client): m_client(client)
+{
+	m_records.reserve(s_maxRecordCount);
+}
+
+ParserLocationBuffer::~ParserLocationBuffer()
+{
+	flush();
+}
+
+void ParserLocationBuffer::flush()
+{
+	if (m_records.empty())
+	{
+		return;
+	}
+
+	typedef ParserClient::LocationRecord Record;
+	auto toTuple = [](const Record& record) {
+		return std::make_tuple(
+			record.location.fileId,
+			record.location.startLineNumber,
+			record.location.startColumnNumber,
+			record.location.endLineNumber,
+			record.location.endColumnNumber,
+			record.type,
+			record.elementId);
+	};
+
+	// sorting by location keeps records that share a source location next to each other
+	std::sort(m_records.begin(), m_records.end(), [&toTuple](const Record& a, const Record& b) {
+		return toTuple(a) < toTuple(b);
+	});
+	m_records.erase(
+		std::unique(
+			m_records.begin(),
+			m_records.end(),
+			[&toTuple](const Record& a, const Record& b) { return toTuple(a) == toTuple(b); }),
+		m_records.end());
+
+	m_client->recordLocations(m_records);
+	m_records.clear();
+}
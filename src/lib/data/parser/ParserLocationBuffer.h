@@ -0,0 +1,40 @@
+#ifndef PARSER_LOCATION_BUFFER_H
+#define PARSER_LOCATION_BUFFER_H
+
+#include <memory>
+#include <vector>
+
+#include "ParserClient.h"
+
+// Collects the locations a parser records while visiting a file and passes them on to the
+// ParserClient in batches, so recording a location is a plain append instead of a virtual call
+// with storage lookups. Identical records are passed on only once per batch. Each parser uses its
+// own buffer, which is flushed when full, on flush and on destruction.
+class ParserLocationBuffer
+{
+public:
+	ParserLocationBuffer(std::shared_ptr<ParserClient> client);
+	~ParserLocationBuffer();
+
+	ParserLocationBuffer(const ParserLocationBuffer&) = delete;
+	ParserLocationBuffer& operator=(const ParserLocationBuffer&) = delete;
+
+	void recordLocation(Id elementId, const ParseLocation& location, ParseLocationType type)
+	{
+		m_records.push_back({elementId, location, type});
+		if (m_records.size() >= s_maxRecordCount)
+		{
+			flush();
+		}
+	}
+
+	void flush();
+
+private:
+	static const size_t s_maxRecordCount;
+
+	std::shared_ptr<ParserClient> m_client;
+	std::vector<ParserClient::LocationRecord> m_records;
+};
+
+#endif	  // PARSER_LOCATION_BUFFER_H
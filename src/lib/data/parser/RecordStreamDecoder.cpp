@@ -0,0 +1,364 @@
+#include "RecordStreamDecoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "FilePath.h"
+#include "NameHierarchy.h"
+#include "ParseLocation.h"
+#include "ParserClient.h"
+#include "ReferenceKind.h"
+#include "logging.h"
+#include "utilityString.h"
+
+namespace
+{
+// has to match the record kinds of RecordChannel.java
+enum RecordKind
+{
+	RECORD_NAME = 0,
+	RECORD_SYMBOL = 1,
+	RECORD_SYMBOL_WITH_LOCATION = 2,
+	RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE = 3,
+	RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE = 4,
+	RECORD_REFERENCE = 5,
+	RECORD_QUALIFIER_LOCATION = 6,
+	RECORD_LOCAL_SYMBOL = 7,
+	RECORD_COMMENT = 8,
+	RECORD_ERROR = 9,
+	RECORD_FILE = 10
+};
+
+const size_t intSize = sizeof(int32_t);
+const size_t locationSize = 4 * intSize;
+
+int readIntAt(const char* buffer, size_t offset)
+{
+	int32_t value = 0;
+	std::memcpy(&value, buffer + offset, sizeof(value));
+	return value;
+}
+
+// size of the string starting at offset including its length, 0 if it is not complete yet
+size_t getStringSize(const char* buffer, size_t size, size_t offset)
+{
+	if (offset + intSize > size)
+	{
+		return 0;
+	}
+	const size_t stringSize = intSize + size_t(std::max(0, readIntAt(buffer, offset)));
+	return offset + stringSize <= size ? stringSize : 0;
+}
+
+// size of the record at the start of the buffer including its kind, 0 if it is not complete yet
+size_t getRecordSize(const char* buffer, size_t size, int& recordKind)
+{
+	if (size < intSize)
+	{
+		return 0;
+	}
+
+	recordKind = readIntAt(buffer, 0);
+
+	size_t recordSize = intSize;
+	switch (recordKind)
+	{
+	case RECORD_NAME:
+	{
+		const size_t stringSize = getStringSize(buffer, size, 2 * intSize);
+		if (!stringSize)
+		{
+			return 0;
+		}
+		recordSize += intSize + stringSize;
+		break;
+	}
+	case RECORD_SYMBOL:
+		recordSize += 4 * intSize;
+		break;
+	case RECORD_SYMBOL_WITH_LOCATION:
+		recordSize += 4 * intSize + locationSize;
+		break;
+	case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE:
+		recordSize += 4 * intSize + 2 * locationSize;
+		break;
+	case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE:
+		recordSize += 4 * intSize + 3 * locationSize;
+		break;
+	case RECORD_REFERENCE:
+		recordSize += 3 * intSize + locationSize;
+		break;
+	case RECORD_QUALIFIER_LOCATION:
+	case RECORD_LOCAL_SYMBOL:
+		recordSize += intSize + locationSize;
+		break;
+	case RECORD_COMMENT:
+		recordSize += locationSize;
+		break;
+	case RECORD_ERROR:
+	{
+		const size_t stringSize = getStringSize(buffer, size, intSize);
+		if (!stringSize)
+		{
+			return 0;
+		}
+		recordSize += stringSize + 2 * intSize + locationSize;
+		break;
+	}
+	case RECORD_FILE:
+	{
+		const size_t pathSize = getStringSize(buffer, size, intSize);
+		if (!pathSize)
+		{
+			return 0;
+		}
+		const size_t languageSize = getStringSize(buffer, size, intSize + pathSize);
+		if (!languageSize)
+		{
+			return 0;
+		}
+		recordSize += pathSize + languageSize + intSize;
+		break;
+	}
+	default:
+		// unknown records cannot be skipped, the caller reports them
+		return size;
+	}
+
+	return recordSize <= size ? recordSize : 0;
+}
+
+// reads the values of a record that is known to be complete
+class RecordReader
+{
+public:
+	RecordReader(const char* buffer): m_buffer(buffer), m_offset(0) {}
+
+	int readInt()
+	{
+		const int value = readIntAt(m_buffer, m_offset);
+		m_offset += intSize;
+		return value;
+	}
+
+	std::string readString()
+	{
+		const size_t length = size_t(std::max(0, readInt()));
+		std::string str(m_buffer + m_offset, length);
+		m_offset += length;
+		return str;
+	}
+
+	ParseLocation readLocation(Id fileId)
+	{
+		const int beginLine = readInt();
+		const int beginColumn = readInt();
+		const int endLine = readInt();
+		const int endColumn = readInt();
+		return ParseLocation(fileId, beginLine, beginColumn, endLine, endColumn);
+	}
+
+private:
+	const char* m_buffer;
+	size_t m_offset;
+};
+}	 // namespace
+
+RecordStreamDecoder::RecordStreamDecoder(std::shared_ptr<ParserClient> client)
+	: m_client(client), m_locationBuffer(client), m_currentFileId(0), m_failed(false)
+{
+}
+
+void RecordStreamDecoder::startFile(Id fileId)
+{
+	m_currentFileId = fileId;
+	m_names.clear();
+	m_nameSymbolIds.clear();
+}
+
+size_t RecordStreamDecoder::decode(const char* buffer, size_t size)
+{
+	size_t offset = 0;
+	while (!m_failed && offset < size)
+	{
+		int recordKind = 0;
+		const size_t recordSize = getRecordSize(buffer + offset, size - offset, recordKind);
+		if (!recordSize)
+		{
+			break;
+		}
+
+		RecordReader reader(buffer + offset);
+		reader.readInt();
+
+		switch (recordKind)
+		{
+		case RECORD_NAME:
+		{
+			const size_t nameId = size_t(reader.readInt());
+			std::string name = reader.readString();
+			if (nameId >= m_names.size())
+			{
+				m_names.resize(nameId + 1);
+				m_nameSymbolIds.resize(nameId + 1, 0);
+			}
+			m_names[nameId] = std::move(name);
+			m_nameSymbolIds[nameId] = 0;
+			break;
+		}
+		case RECORD_SYMBOL:
+		{
+			const Id symbolId = getOrCreateSymbolId(reader.readInt());
+			m_client->recordSymbolKind(symbolId, intToSymbolKind(reader.readInt()));
+			m_client->recordAccessKind(symbolId, intToAccessKind(reader.readInt()));
+			m_client->recordDefinitionKind(symbolId, intToDefinitionKind(reader.readInt()));
+			break;
+		}
+		case RECORD_SYMBOL_WITH_LOCATION:
+		case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE:
+		case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE:
+		{
+			const Id symbolId = getOrCreateSymbolId(reader.readInt());
+			m_client->recordSymbolKind(symbolId, intToSymbolKind(reader.readInt()));
+			m_locationBuffer.recordLocation(
+				symbolId, reader.readLocation(m_currentFileId), ParseLocationType::TOKEN);
+			if (recordKind != RECORD_SYMBOL_WITH_LOCATION)
+			{
+				m_locationBuffer.recordLocation(
+					symbolId, reader.readLocation(m_currentFileId), ParseLocationType::SCOPE);
+			}
+			if (recordKind == RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE)
+			{
+				m_locationBuffer.recordLocation(
+					symbolId, reader.readLocation(m_currentFileId), ParseLocationType::SIGNATURE);
+			}
+			m_client->recordAccessKind(symbolId, intToAccessKind(reader.readInt()));
+			m_client->recordDefinitionKind(symbolId, intToDefinitionKind(reader.readInt()));
+			break;
+		}
+		case RECORD_REFERENCE:
+		{
+			const ReferenceKind referenceKind = intToReferenceKind(reader.readInt());
+			const Id referencedSymbolId = getOrCreateSymbolId(reader.readInt());
+			const Id contextSymbolId = getOrCreateSymbolId(reader.readInt());
+			m_client->recordReference(
+				referenceKind,
+				referencedSymbolId,
+				contextSymbolId,
+				reader.readLocation(m_currentFileId));
+			break;
+		}
+		case RECORD_QUALIFIER_LOCATION:
+		{
+			const Id symbolId = getOrCreateSymbolId(reader.readInt());
+			m_locationBuffer.recordLocation(
+				symbolId, reader.readLocation(m_currentFileId), ParseLocationType::QUALIFIER);
+			break;
+		}
+		case RECORD_LOCAL_SYMBOL:
+		{
+			const size_t nameId = size_t(reader.readInt());
+			const std::string name = nameId < m_names.size() ? m_names[nameId] : "";
+			m_client->recordLocalSymbol(
+				NameHierarchy::deserialize(utility::decodeFromUtf8(name)).getQualifiedName(),
+				reader.readLocation(m_currentFileId));
+			break;
+		}
+		case RECORD_COMMENT:
+		{
+			m_client->recordComment(reader.readLocation(m_currentFileId));
+			break;
+		}
+		case RECORD_ERROR:
+		{
+			const std::wstring message = utility::decodeFromUtf8(reader.readString());
+			const bool fatal = reader.readInt();
+			const bool indexed = reader.readInt();
+			const ParseLocation location = reader.readLocation(m_currentFileId);
+			m_client->recordError(
+				message,
+				fatal,
+				indexed,
+				FilePath(),
+				ParseLocation(
+					m_currentFileId, location.startLineNumber, location.startColumnNumber));
+			break;
+		}
+		case RECORD_FILE:
+		{
+			const FilePath filePath(utility::decodeFromUtf8(reader.readString()));
+			const std::wstring language = utility::decodeFromUtf8(reader.readString());
+			const bool indexed = reader.readInt();
+			m_currentFileId = m_client->recordFile(filePath, indexed);
+			if (!language.empty())
+			{
+				m_client->recordFileLanguage(m_currentFileId, language);
+			}
+			break;
+		}
+		default:
+			LOG_ERROR("received unknown record kind " + std::to_string(recordKind));
+			m_failed = true;
+			return offset;
+		}
+
+		offset += recordSize;
+	}
+	return offset;
+}
+
+void RecordStreamDecoder::decodeChunk(const char* buffer, size_t size)
+{
+	if (m_pendingBytes.empty())
+	{
+		const size_t decodedSize = decode(buffer, size);
+		m_pendingBytes.assign(buffer + decodedSize, size - decodedSize);
+		return;
+	}
+
+	m_pendingBytes.append(buffer, size);
+	const size_t decodedSize = decode(m_pendingBytes.data(), m_pendingBytes.size());
+	m_pendingBytes.erase(0, decodedSize);
+}
+
+bool RecordStreamDecoder::finish()
+{
+	flush();
+	if (!m_pendingBytes.empty())
+	{
+		LOG_ERROR(
+			"record stream ended within a record, " + std::to_string(m_pendingBytes.size()) +
+			" bytes were dropped");
+		m_pendingBytes.clear();
+		return false;
+	}
+	return !m_failed;
+}
+
+void RecordStreamDecoder::flush()
+{
+	m_locationBuffer.flush();
+}
+
+bool RecordStreamDecoder::failed() const
+{
+	return m_failed;
+}
+
+Id RecordStreamDecoder::getOrCreateSymbolId(size_t nameId)
+{
+	if (nameId >= m_names.size())
+	{
+		LOG_ERROR("received unknown name id " + std::to_string(nameId));
+		return 0;
+	}
+
+	Id& symbolId = m_nameSymbolIds[nameId];
+	if (!symbolId)
+	{
+		symbolId = m_client->recordSymbol(
+			NameHierarchy::deserialize(utility::decodeFromUtf8(m_names[nameId])));
+	}
+	return symbolId;
+}
@@ -0,0 +1,53 @@
+#ifndef RECORD_STREAM_DECODER_H
+#define RECORD_STREAM_DECODER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ParserLocationBuffer.h"
+#include "types.h"
+
+class ParserClient;
+
+// Decodes the binary records of an indexer that runs outside of the native code and passes them to
+// a ParserClient. The format is the one written by RecordChannel.java: every record starts with its
+// kind, all values are 32 bit integers in native byte order and each name is sent once and referenced
+// by its id afterwards. Out-of-process indexers additionally send file records, which set the file
+// the following locations refer to.
+class RecordStreamDecoder
+{
+public:
+	RecordStreamDecoder(std::shared_ptr<ParserClient> client);
+
+	// forgets all names and makes the following locations refer to the passed file
+	void startFile(Id fileId);
+
+	// decodes all complete records of the buffer and returns the number of bytes they took
+	size_t decode(const char* buffer, size_t size);
+
+	// appends data received from a stream, records split between two chunks are decoded with the
+	// second one
+	void decodeChunk(const char* buffer, size_t size);
+
+	// returns false if the stream ended within a record
+	bool finish();
+
+	void flush();
+
+	bool failed() const;
+
+private:
+	Id getOrCreateSymbolId(size_t nameId);
+
+	std::shared_ptr<ParserClient> m_client;
+	ParserLocationBuffer m_locationBuffer;
+	Id m_currentFileId;
+	bool m_failed;
+
+	std::vector<std::string> m_names;
+	std::vector<Id> m_nameSymbolIds;
+	std::string m_pendingBytes;
+};
+
+#endif	  // RECORD_STREAM_DECODER_H
@@ -5,8 +5,8 @@
 #include "PersistentStorage.h"
 
 TaskParseWrapper::TaskParseWrapper(
-	std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView)
-	: m_storage(storage), m_dialogView(dialogView)
+	std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView, bool bulkWrite)
+	: m_storage(storage), m_dialogView(dialogView), m_bulkWrite(bulkWrite)
 {
 }
 
@@ -24,7 +24,9 @@ void TaskParseWrapper::doEnter(std::shared_ptr<Blackboard> blackboard)
 	{
 		if (std::shared_ptr<PersistentStorage> storage = m_storage.lock())
 		{
-			storage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+			storage->setMode(
+				m_bulkWrite ? SqliteIndexStorage::STORAGE_MODE_BULK_WRITE
+							: SqliteIndexStorage::STORAGE_MODE_WRITE);
 		}
 	}
 }
@@ -15,7 +15,11 @@ class PersistentStorage;
 class TaskParseWrapper: public TaskDecorator
 {
 public:
-	TaskParseWrapper(std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView);
+	// bulkWrite: storage starts out empty, so all database indices can be built after parsing
+	TaskParseWrapper(
+		std::weak_ptr<PersistentStorage> storage,
+		std::shared_ptr<DialogView> dialogView,
+		bool bulkWrite = false);
 
 private:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -25,6 +29,7 @@ private:
 
 	std::weak_ptr<PersistentStorage> m_storage;
 	std::shared_ptr<DialogView> m_dialogView;
+	const bool m_bulkWrite;
 
 	TimeStamp m_start;
 };
@@ -1,12 +1,41 @@
 #include "SearchIndex.h"
 
 #include <algorithm>
+#include <cstring>
 #include <ctype.h>
+#include <atomic>
 #include <iterator>
 
+#include "MemoryUsage.h"
+#include "MetricsRegistry.h"
+#include "ScopedFunctor.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
+#include "TimeStamp.h"
+#include "UnorderedCache.h"
 #include "utility.h"
+#include "utilityBinary.h"
 #include "utilityString.h"
 
+const uint32_t SearchIndex::s_serializationVersion = 2;
+const size_t SearchIndex::s_minParallelSearchNodeCount = 100000;
+const size_t SearchIndex::s_maxCachedPathCount = 100000;
+const size_t SearchIndex::s_maxScoredTextCacheSize = 20000;
+const int SearchIndex::s_maxReferenceBonus = 8;
+
+namespace
+{
+MetricCounter& getCacheCounter(const std::string& cache, bool hit)
+{
+	return MetricsRegistry::getInstance()->getCounter(
+		hit ? "sourcetrail_search_cache_hits_total" : "sourcetrail_search_cache_misses_total",
+		hit ? "Searches answered from a cache" : "Searches not answered from a cache",
+		"cache=\"" + cache + "\"");
+}
+}	 // namespace
+const int SearchIndex::s_maxRecencyBonus = 10;
+const size_t SearchIndex::s_recentIdsPerRecencyStep = 5;
+
 SearchIndex::SearchIndex()
 {
 	clear();
@@ -14,99 +43,196 @@ SearchIndex::SearchIndex()
 
 SearchIndex::~SearchIndex() {}
 
-void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
+void SearchIndex::addNode(Id id, std::wstring name, NodeType type, uint32_t referenceCount)
 {
-	SearchNode* currentNode = m_root;
+	m_pendingNodes.push_back(
+		{uint32_t(m_pendingText.size()), uint32_t(name.size()), id, type.getType(), referenceCount});
+	m_pendingText.append(name);
+}
+
+void SearchIndex::addNodes(const SearchIndex& index, const std::set<Id>& skippedIds)
+{
+	const bool sorted = m_sortedPendingNodeCount == m_pendingNodes.size();
 
-	while (name.size() > 0)
+	// the names are visited in sorted order
+	if (!index.m_nodes.empty())
 	{
-		currentNode->containedTypes.add(type);
+		std::wstring name;
+		addNodesRecursive(index, 0, skippedIds, &name);
+	}
 
-		auto it = currentNode->edges.find(name[0]);
-		if (it != currentNode->edges.end())
-		{
-			SearchEdge* currentEdge = it->second;
-			const std::wstring& edgeString = currentEdge->s;
+	if (sorted)
+	{
+		m_sortedPendingNodeCount = m_pendingNodes.size();
+	}
+}
 
-			size_t matchCount = 1;
-			for (size_t j = 1; j < edgeString.size() && j < name.size(); j++)
-			{
-				if (edgeString[j] != name[j])
-				{
-					break;
-				}
-				matchCount++;
-			}
+void SearchIndex::finishSetup()
+{
+	const auto compare = [this](const PendingNode& a, const PendingNode& b) {
+		return m_pendingText.compare(
+				   a.textBegin, a.textLength, m_pendingText, b.textBegin, b.textLength) < 0;
+	};
+	const auto sortedEnd = m_pendingNodes.begin() + m_sortedPendingNodeCount;
+	std::stable_sort(sortedEnd, m_pendingNodes.end(), compare);
+	std::inplace_merge(m_pendingNodes.begin(), sortedEnd, m_pendingNodes.end(), compare);
+	m_sortedPendingNodeCount = 0;
 
-			if (matchCount < edgeString.size())
-			{
-				// split current edge
-				m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-				SearchNode* n = m_nodes.back().get();
+	m_nodes.clear();
+	m_elements.clear();
+	m_text.clear();
+	m_nodes.emplace_back();
+	buildNodeRecursive(0, 0, m_pendingNodes.size(), 0);
 
-				m_edges.push_back(std::make_unique<SearchEdge>(
-					currentEdge->target, edgeString.substr(matchCount)));
-				SearchEdge* e = m_edges.back().get();
+	m_pendingNodes.clear();
+	m_pendingNodes.shrink_to_fit();
+	m_pendingText.clear();
+	m_pendingText.shrink_to_fit();
 
-				n->edges.emplace(e->s[0], e);
+	populateGatesAndTypes();
 
-				currentEdge->s = edgeString.substr(0, matchCount);
-				currentEdge->target = n;
-			}
+	std::lock_guard<std::mutex> lock(m_cachedPathsMutex);
+	m_cachedPaths.reset();
+}
 
-			name = name.substr(matchCount);
-			currentNode = currentEdge->target;
-		}
-		else
+void SearchIndex::clear()
+{
+	m_nodes.assign(1, SearchNode());
+	m_elements.clear();
+	m_text.clear();
+	m_gates.assign(1, 0);
+	m_containedTypes.assign(1, NodeTypeSet());
+	m_maxReferenceBonuses.assign(1, 0);
+
+	m_pendingNodes.clear();
+	m_pendingText.clear();
+	m_sortedPendingNodeCount = 0;
+
+	std::lock_guard<std::mutex> lock(m_cachedPathsMutex);
+	m_cachedPaths.reset();
+}
+
+void SearchIndex::setRecentIds(const std::vector<Id>& ids)
+{
+	std::shared_ptr<std::map<Id, int>> recencyBonuses = std::make_shared<std::map<Id, int>>();
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		const int bonus = s_maxRecencyBonus - int(i / s_recentIdsPerRecencyStep);
+		if (bonus <= 0)
 		{
-			m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-			SearchNode* n = m_nodes.back().get();
+			break;
+		}
+		recencyBonuses->emplace(ids[i], bonus);
+	}
 
-			m_edges.push_back(std::make_unique<SearchEdge>(n, std::move(name)));
-			SearchEdge* e = m_edges.back().get();
+	std::lock_guard<std::mutex> lock(m_recencyBonusesMutex);
+	m_recencyBonuses = recencyBonuses;
+}
 
-			currentNode->edges.emplace(e->s[0], e);
-			currentNode = n;
+NodeTypeSet SearchIndex::getContainedNodeTypes() const
+{
+	return m_containedTypes[0];
+}
 
-			name.clear();
+size_t SearchIndex::getByteSize() const
+{
+	size_t byteSize = utility::getByteSize(m_nodes) + utility::getByteSize(m_elements) +
+		utility::getByteSize(m_text) + utility::getByteSize(m_gates) +
+		utility::getByteSize(m_containedTypes) + utility::getByteSize(m_maxReferenceBonuses) +
+		utility::getByteSize(m_pendingNodes) + utility::getByteSize(m_pendingText);
+
+	std::lock_guard<std::mutex> lock(m_cachedPathsMutex);
+	if (m_cachedPaths)
+	{
+		byteSize += utility::getByteSize(*m_cachedPaths);
+		for (const SearchPath& path: *m_cachedPaths)
+		{
+			byteSize += utility::getByteSize(path.text) + utility::getByteSize(path.indices);
 		}
 	}
+	return byteSize;
+}
 
-	currentNode->elementIds.emplace(id, type);
+std::string SearchIndex::serialize() const
+{
+	std::string data;
+	const uint32_t header[] = {s_serializationVersion, uint32_t(sizeof(wchar_t))};
+	data.append(reinterpret_cast<const char*>(header), sizeof(header));
+
+	utility::appendBinaryData(data, m_nodes);
+	utility::appendBinaryData(data, m_elements);
+	utility::appendBinaryData(data, std::vector<wchar_t>(m_text.begin(), m_text.end()));
+	return data;
 }
 
-void SearchIndex::finishSetup()
+bool SearchIndex::deserialize(const std::string& data)
 {
-	for (auto& p: m_root->edges)
+	clear();
+
+	uint32_t header[2] = {0, 0};
+	if (data.size() < sizeof(header))
 	{
-		populateEdgeGate(p.second);
+		return false;
+	}
+	std::memcpy(header, data.data(), sizeof(header));
+	if (header[0] != s_serializationVersion || header[1] != sizeof(wchar_t))
+	{
+		return false;
 	}
-}
 
-void SearchIndex::clear()
-{
-	m_nodes.clear();
-	m_edges.clear();
+	size_t position = sizeof(header);
+	std::vector<SearchNode> nodes;
+	std::vector<SearchElement> elements;
+	std::vector<wchar_t> text;
+	if (!utility::readBinaryData(data, position, nodes) ||
+		!utility::readBinaryData(data, position, elements) ||
+		!utility::readBinaryData(data, position, text) || position != data.size() || nodes.empty())
+	{
+		return false;
+	}
 
-	m_nodes.push_back(std::make_unique<SearchNode>(NodeTypeSet()));
+	// children always follow their parent, which populateGatesAndTypes relies on
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		const SearchNode& node = nodes[i];
+		if ((node.childCount && (node.firstChild <= i || node.firstChild > nodes.size() ||
+								 node.childCount > nodes.size() - node.firstChild)) ||
+			node.textBegin > text.size() || node.textLength > text.size() - node.textBegin ||
+			node.firstElement > elements.size() ||
+			node.elementCount > elements.size() - node.firstElement)
+		{
+			return false;
+		}
+	}
+
+	m_nodes = std::move(nodes);
+	m_elements = std::move(elements);
+	m_text.assign(text.begin(), text.end());
 
-	m_root = m_nodes.back().get();
+	populateGatesAndTypes();
+	return true;
 }
 
 std::vector<SearchResult> SearchIndex::search(
 	const std::wstring& query,
 	NodeTypeSet acceptedNodeTypes,
 	size_t maxResultCount,
-	size_t maxBestScoredResultsLength) const
+	size_t maxBestScoredResultsLength,
+	const std::function<bool()>& isCancelled) const
 {
+	static MetricHistogram& searchDurationHistogram = MetricsRegistry::getInstance()->getHistogram(
+		"sourcetrail_search_duration_seconds", "Duration of searching the index");
+	const TimeStamp start = TimeStamp::now();
+	ScopedFunctor observeDuration(
+		[&start]() { searchDurationHistogram.observe(TimeStamp::durationSeconds(start)); });
+
 	// find paths containing query
-	std::vector<SearchPath> paths;
-	searchRecursive(
-		SearchPath(L"", {}, m_root), utility::toLowerCase(query), acceptedNodeTypes, &paths);
+	const std::vector<SearchPath> paths = findPaths(
+		utility::toLowerCase(query), acceptedNodeTypes, isCancelled);
 
 	// create scored search results
 	std::multiset<SearchResult> searchResults = createScoredResults(
-		paths, acceptedNodeTypes, maxResultCount * 3);
+		paths, acceptedNodeTypes, maxResultCount * 3, isCancelled);
 
 	// find maximum length for best scores
 	std::multiset<size_t> resultLengths;
@@ -123,16 +249,30 @@ std::vector<SearchResult> SearchIndex::search(
 	}
 
 	// find best scores
-	std::map<std::wstring, SearchResult> scoresCache;
 	std::multiset<SearchResult> bestResults;
 	for (const SearchResult& result: searchResults)
 	{
+		if (isCancelled && isCancelled())
+		{
+			return {};
+		}
+
 		if (!maxResultLength || result.text.size() <= maxResultLength)
 		{
-			bestResults.insert(bestScoredResult(result, &scoresCache, maxBestScoredResultsLength));
+			// only the text score gets improved by moving the matched indices
+			SearchResult bestResult = bestScoredResult(
+				result, maxBestScoredResultsLength, isCancelled);
+			bestResult.score += result.scoreBonus;
+			bestResult.scoreBonus = result.scoreBonus;
+			bestResults.insert(std::move(bestResult));
 		}
 	}
 
+	if (isCancelled && isCancelled())
+	{
+		return {};
+	}
+
 	// narrow down to max result count
 	auto it = bestResults.end();
 	if (maxResultCount && bestResults.size() > maxResultCount)
@@ -144,93 +284,497 @@ std::vector<SearchResult> SearchIndex::search(
 	return std::vector<SearchResult>(bestResults.begin(), it);
 }
 
-void SearchIndex::populateEdgeGate(SearchEdge* e)
+SearchIndex::GateMask SearchIndex::getGateMask(wchar_t lowerCaseChar)
 {
-	for (auto& p: e->target->edges)
+	// letters and digits get a bit of their own, all other characters share the remaining bits
+	if (lowerCaseChar >= L'a' && lowerCaseChar <= L'z')
 	{
-		SearchEdge* targetEdge = p.second;
-		populateEdgeGate(targetEdge);
-		utility::append(e->gate, targetEdge->gate);
+		return GateMask(1) << (lowerCaseChar - L'a');
 	}
+	if (lowerCaseChar >= L'0' && lowerCaseChar <= L'9')
+	{
+		return GateMask(1) << (26 + lowerCaseChar - L'0');
+	}
+	return GateMask(1) << (36 + size_t(lowerCaseChar) % 28);
+}
 
-	for (const wchar_t& c: e->s)
+SearchIndex::GateMask SearchIndex::getGateMask(const std::wstring& lowerCaseText)
+{
+	GateMask gate = 0;
+	for (const wchar_t& c: lowerCaseText)
 	{
-		e->gate.insert(towlower(c));
+		gate |= getGateMask(c);
 	}
+	return gate;
 }
 
-void SearchIndex::searchRecursive(
-	const SearchPath& path,
-	const std::wstring& remainingQuery,
+int SearchIndex::getReferenceBonus(uint32_t referenceCount)
+{
+	// grows logarithmically, so widely used symbols don't outweigh a much better match
+	int bonus = 0;
+	while (referenceCount > 1 && bonus < s_maxReferenceBonus)
+	{
+		referenceCount >>= 1;
+		bonus++;
+	}
+	return bonus;
+}
+
+void SearchIndex::addNodesRecursive(
+	const SearchIndex& index, uint32_t nodeIndex, const std::set<Id>& skippedIds, std::wstring* name)
+{
+	const SearchNode& node = index.m_nodes[nodeIndex];
+	name->append(index.m_text, node.textBegin, node.textLength);
+
+	for (uint32_t i = node.firstElement; i < node.firstElement + node.elementCount; i++)
+	{
+		const SearchElement& element = index.m_elements[i];
+		if (skippedIds.find(Id(element.id)) == skippedIds.end())
+		{
+			addNode(
+				Id(element.id), *name, NodeType(NodeType::Type(element.type)), element.referenceCount);
+		}
+	}
+
+	for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++)
+	{
+		addNodesRecursive(index, i, skippedIds, name);
+	}
+
+	name->resize(name->size() - node.textLength);
+}
+
+void SearchIndex::buildNodeRecursive(
+	uint32_t nodeIndex, size_t beginIndex, size_t endIndex, size_t depth)
+{
+	// the names ending at this node are sorted in front of the longer ones
+	size_t childBeginIndex = beginIndex;
+	while (childBeginIndex < endIndex && m_pendingNodes[childBeginIndex].textLength == depth)
+	{
+		childBeginIndex++;
+	}
+
+	std::vector<PendingNode> elements(
+		m_pendingNodes.begin() + beginIndex, m_pendingNodes.begin() + childBeginIndex);
+	std::stable_sort(elements.begin(), elements.end(), [](const PendingNode& a, const PendingNode& b) {
+		return a.id < b.id;
+	});
+
+	m_nodes[nodeIndex].firstElement = uint32_t(m_elements.size());
+	for (size_t i = 0; i < elements.size(); i++)
+	{
+		// an id added several times keeps the type it was added with first
+		if (i == 0 || elements[i].id != elements[i - 1].id)
+		{
+			m_elements.push_back(
+				{uint64_t(elements[i].id), elements[i].type, elements[i].referenceCount});
+		}
+	}
+	m_nodes[nodeIndex].elementCount = uint32_t(m_elements.size()) - m_nodes[nodeIndex].firstElement;
+
+	std::vector<std::pair<size_t, size_t>> childRanges;
+	for (size_t i = childBeginIndex; i < endIndex;)
+	{
+		const wchar_t c = m_pendingText[m_pendingNodes[i].textBegin + depth];
+		size_t j = i + 1;
+		while (j < endIndex && m_pendingText[m_pendingNodes[j].textBegin + depth] == c)
+		{
+			j++;
+		}
+		childRanges.emplace_back(i, j);
+		i = j;
+	}
+
+	if (childRanges.empty())
+	{
+		return;
+	}
+
+	const uint32_t firstChild = uint32_t(m_nodes.size());
+	m_nodes[nodeIndex].firstChild = firstChild;
+	m_nodes[nodeIndex].childCount = uint32_t(childRanges.size());
+	m_nodes.resize(m_nodes.size() + childRanges.size());
+
+	for (size_t i = 0; i < childRanges.size(); i++)
+	{
+		// the names of a range are sorted, so the first and last one share the longest prefix
+		const PendingNode& first = m_pendingNodes[childRanges[i].first];
+		const PendingNode& last = m_pendingNodes[childRanges[i].second - 1];
+
+		size_t prefixLength = depth + 1;
+		while (prefixLength < first.textLength && prefixLength < last.textLength &&
+			   m_pendingText[first.textBegin + prefixLength] ==
+				   m_pendingText[last.textBegin + prefixLength])
+		{
+			prefixLength++;
+		}
+
+		SearchNode& child = m_nodes[firstChild + i];
+		child.textBegin = uint32_t(m_text.size());
+		child.textLength = uint32_t(prefixLength - depth);
+		m_text.append(m_pendingText, first.textBegin + depth, prefixLength - depth);
+
+		buildNodeRecursive(
+			firstChild + uint32_t(i), childRanges[i].first, childRanges[i].second, prefixLength);
+	}
+}
+
+void SearchIndex::populateGatesAndTypes()
+{
+	m_gates.assign(m_nodes.size(), 0);
+	m_containedTypes.assign(m_nodes.size(), NodeTypeSet());
+	m_maxReferenceBonuses.assign(m_nodes.size(), 0);
+
+	// children are stored behind their parent, so they are done before it
+	for (size_t i = m_nodes.size(); i > 0; i--)
+	{
+		const SearchNode& node = m_nodes[i - 1];
+		GateMask& gate = m_gates[i - 1];
+		NodeTypeSet& containedTypes = m_containedTypes[i - 1];
+		int& maxReferenceBonus = m_maxReferenceBonuses[i - 1];
+
+		for (size_t j = node.textBegin; j < node.textBegin + node.textLength; j++)
+		{
+			gate |= getGateMask(utility::toLowerCase(m_text[j]));
+		}
+
+		for (size_t j = node.firstElement; j < node.firstElement + node.elementCount; j++)
+		{
+			containedTypes.add(NodeType(NodeType::Type(m_elements[j].type)));
+			maxReferenceBonus = std::max(
+				maxReferenceBonus, getReferenceBonus(m_elements[j].referenceCount));
+		}
+
+		for (size_t j = node.firstChild; j < node.firstChild + node.childCount; j++)
+		{
+			gate |= m_gates[j];
+			containedTypes.add(m_containedTypes[j]);
+			maxReferenceBonus = std::max(maxReferenceBonus, m_maxReferenceBonuses[j]);
+		}
+	}
+}
+
+int SearchIndex::getScoreBonus(
+	const SearchElement& element, const std::map<Id, int>* recencyBonuses) const
+{
+	int bonus = getReferenceBonus(element.referenceCount);
+	if (recencyBonuses)
+	{
+		auto it = recencyBonuses->find(Id(element.id));
+		if (it != recencyBonuses->end())
+		{
+			bonus += it->second;
+		}
+	}
+	return bonus;
+}
+
+std::vector<SearchIndex::SearchPath> SearchIndex::findPaths(
+	const std::wstring& lowerQuery,
 	NodeTypeSet acceptedNodeTypes,
-	std::vector<SearchIndex::SearchPath>* results) const
+	const std::function<bool()>& isCancelled) const
 {
-	for (const auto& p: path.node->edges)
+	if (lowerQuery.empty())
 	{
-		const SearchEdge* currentEdge = p.second;
+		std::vector<SearchPath> paths;
+		searchRecursive(SearchPath(L"", {}, 0), lowerQuery, acceptedNodeTypes, isCancelled, &paths);
+		return paths;
+	}
 
-		if (!acceptedNodeTypes.intersectsWith(currentEdge->target->containedTypes))
+	std::shared_ptr<const std::vector<SearchPath>> cachedPaths;
+	std::wstring cachedQuery;
+	{
+		std::lock_guard<std::mutex> lock(m_cachedPathsMutex);
+		if (m_cachedPaths && m_cachedNodeTypes == acceptedNodeTypes &&
+			utility::isPrefix(m_cachedQuery, lowerQuery))
 		{
-			continue;
+			cachedPaths = m_cachedPaths;
+			cachedQuery = m_cachedQuery;
 		}
+	}
 
-		// test if s passes the edge's gate.
-		bool passesGate = true;
-		for (const wchar_t& c: remainingQuery)
+	static MetricCounter& pathCacheHitCounter = getCacheCounter("paths", true);
+	static MetricCounter& pathCacheMissCounter = getCacheCounter("paths", false);
+	(cachedPaths ? pathCacheHitCounter : pathCacheMissCounter).add();
+
+	std::vector<SearchPath> paths;
+	if (cachedPaths && cachedQuery.size() == lowerQuery.size())
+	{
+		paths = *cachedPaths;
+	}
+	else if (cachedPaths)
+	{
+		// matching is greedy, so the longer query matches the same characters as the cached one
+		// and continues right behind the last of them
+		const std::wstring remainingQuery = lowerQuery.substr(cachedQuery.size());
+		for (const SearchPath& path: *cachedPaths)
+		{
+			continueTask({path, remainingQuery}, acceptedNodeTypes, isCancelled, &paths);
+		}
+	}
+	else if (m_nodes.size() >= s_minParallelSearchNodeCount)
+	{
+		paths = findPathsParallel(lowerQuery, acceptedNodeTypes, isCancelled);
+	}
+	else
+	{
+		searchRecursive(SearchPath(L"", {}, 0), lowerQuery, acceptedNodeTypes, isCancelled, &paths);
+	}
+
+	// paths of a cancelled search are incomplete
+	if (isCancelled && isCancelled())
+	{
+		return {};
+	}
+
+	if (paths.size() <= s_maxCachedPathCount)
+	{
+		std::lock_guard<std::mutex> lock(m_cachedPathsMutex);
+		m_cachedQuery = lowerQuery;
+		m_cachedNodeTypes = acceptedNodeTypes;
+		m_cachedPaths = std::make_shared<const std::vector<SearchPath>>(paths);
+	}
+
+	return paths;
+}
+
+std::vector<SearchIndex::SearchPath> SearchIndex::findPathsParallel(
+	const std::wstring& lowerQuery,
+	NodeTypeSet acceptedNodeTypes,
+	const std::function<bool()>& isCancelled) const
+{
+	std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+	const size_t threadCount = threadPool->getWorkerCount();
+
+	// expand the upper levels until there are enough subtrees to keep all threads busy, the order
+	// of the tasks stays the order of a sequential search
+	std::vector<SearchTask> tasks = {{SearchPath(L"", {}, 0), lowerQuery}};
+	for (size_t depth = 0; depth < 3 && tasks.size() < threadCount * 8; depth++)
+	{
+		std::vector<SearchTask> nextTasks;
+		for (const SearchTask& task: tasks)
 		{
-			if (currentEdge->gate.find(c) == currentEdge->gate.end())
+			if (task.remainingQuery.empty())
 			{
-				passesGate = false;
-				break;
+				nextTasks.push_back(task);
+				continue;
+			}
+
+			const GateMask queryGate = getGateMask(task.remainingQuery);
+			const SearchNode& node = m_nodes[task.path.nodeIndex];
+			for (uint32_t childIndex = node.firstChild;
+				 childIndex < node.firstChild + node.childCount;
+				 childIndex++)
+			{
+				SearchTask childTask {SearchPath(L"", {}, 0), L""};
+				if (enterChild(
+						task.path,
+						childIndex,
+						task.remainingQuery,
+						queryGate,
+						acceptedNodeTypes,
+						&childTask))
+				{
+					nextTasks.push_back(std::move(childTask));
+				}
 			}
 		}
+		tasks = std::move(nextTasks);
+	}
 
-		if (!passesGate)
+	std::vector<std::vector<SearchPath>> taskPaths(tasks.size());
+	std::atomic<size_t> nextTaskIndex(0);
+	auto processTasks = [&]() {
+		for (size_t i = nextTaskIndex++; i < tasks.size(); i = nextTaskIndex++)
 		{
-			continue;
+			if (tasks[i].remainingQuery.empty())
+			{
+				taskPaths[i].push_back(tasks[i].path);
+			}
+			else
+			{
+				searchRecursive(
+					tasks[i].path,
+					tasks[i].remainingQuery,
+					acceptedNodeTypes,
+					isCancelled,
+					&taskPaths[i]);
+			}
 		}
+	};
+
+	threadPool->parallelFor(
+		std::min(threadCount, tasks.size()),
+		[&](size_t) { processTasks(); },
+		ThreadPool::PRIORITY_INTERACTIVE);
+
+	std::vector<SearchPath> paths;
+	for (std::vector<SearchPath>& currentPaths: taskPaths)
+	{
+		std::move(currentPaths.begin(), currentPaths.end(), std::back_inserter(paths));
+	}
+	return paths;
+}
 
-		// consume characters for edge
-		const std::wstring& edgeString = currentEdge->s;
-		SearchPath currentPath {path.text + edgeString, path.indices, currentEdge->target};
+bool SearchIndex::enterChild(
+	const SearchPath& path,
+	uint32_t childIndex,
+	const std::wstring& remainingQuery,
+	GateMask queryGate,
+	NodeTypeSet acceptedNodeTypes,
+	SearchTask* task) const
+{
+	if (!acceptedNodeTypes.intersectsWith(m_containedTypes[childIndex]))
+	{
+		return false;
+	}
 
-		size_t j = 0;
-		for (size_t i = 0; i < edgeString.size() && j < remainingQuery.size(); i++)
+	// test if the remaining query passes the gate, characters sharing a bit may still let
+	// subtrees pass that don't contain them
+	if ((m_gates[childIndex] & queryGate) != queryGate)
+	{
+		return false;
+	}
+
+	// consume characters for edge
+	const SearchNode& child = m_nodes[childIndex];
+	const wchar_t* edgeString = m_text.data() + child.textBegin;
+	task->path = SearchPath(path.text, path.indices, childIndex);
+	task->path.text.append(edgeString, child.textLength);
+
+	size_t j = 0;
+	for (size_t i = 0; i < child.textLength && j < remainingQuery.size(); i++)
+	{
+		if (utility::toLowerCase(edgeString[i]) == remainingQuery[j])
 		{
-			if (towlower(edgeString[i]) == remainingQuery[j])
-			{
-				currentPath.indices.push_back(path.text.size() + i);
-				j++;
-			}
+			task->path.indices.push_back(path.text.size() + i);
+			j++;
 		}
+	}
+
+	task->remainingQuery = remainingQuery.substr(j);
+	return true;
+}
 
-		if (j == remainingQuery.size())
+void SearchIndex::continueTask(
+	const SearchTask& task,
+	NodeTypeSet acceptedNodeTypes,
+	const std::function<bool()>& isCancelled,
+	std::vector<SearchIndex::SearchPath>* results) const
+{
+	SearchPath currentPath = task.path;
+
+	size_t j = 0;
+	for (size_t i = (currentPath.indices.empty() ? 0 : currentPath.indices.back() + 1);
+		 i < currentPath.text.size() && j < task.remainingQuery.size();
+		 i++)
+	{
+		if (utility::toLowerCase(currentPath.text[i]) == task.remainingQuery[j])
+		{
+			currentPath.indices.push_back(i);
+			j++;
+		}
+	}
+
+	if (j == task.remainingQuery.size())
+	{
+		results->push_back(std::move(currentPath));
+	}
+	else
+	{
+		searchRecursive(
+			currentPath, task.remainingQuery.substr(j), acceptedNodeTypes, isCancelled, results);
+	}
+}
+
+void SearchIndex::searchRecursive(
+	const SearchPath& path,
+	const std::wstring& remainingQuery,
+	NodeTypeSet acceptedNodeTypes,
+	const std::function<bool()>& isCancelled,
+	std::vector<SearchIndex::SearchPath>* results) const
+{
+	if (isCancelled && isCancelled())
+	{
+		return;
+	}
+
+	const GateMask queryGate = getGateMask(remainingQuery);
+
+	const SearchNode& node = m_nodes[path.nodeIndex];
+	for (uint32_t childIndex = node.firstChild; childIndex < node.firstChild + node.childCount;
+		 childIndex++)
+	{
+		SearchTask task {SearchPath(L"", {}, 0), L""};
+		if (!enterChild(path, childIndex, remainingQuery, queryGate, acceptedNodeTypes, &task))
+		{
+			continue;
+		}
+
+		if (task.remainingQuery.empty())
 		{
-			results->push_back(std::move(currentPath));
+			results->push_back(std::move(task.path));
 		}
 		else
 		{
-			searchRecursive(currentPath, remainingQuery.substr(j), acceptedNodeTypes, results);
+			searchRecursive(task.path, task.remainingQuery, acceptedNodeTypes, isCancelled, results);
 		}
 	}
 }
 
 std::multiset<SearchResult> SearchIndex::createScoredResults(
-	const std::vector<SearchPath>& paths, NodeTypeSet acceptedNodeTypes, size_t maxResultCount) const
+	const std::vector<SearchPath>& paths,
+	NodeTypeSet acceptedNodeTypes,
+	size_t maxResultCount,
+	const std::function<bool()>& isCancelled) const
 {
-	// score and order initial paths
-	std::multimap<int, SearchPath, std::greater<int>> scoredPaths;
-	for (const SearchPath& path: paths)
+	std::shared_ptr<const std::map<Id, int>> recencyBonuses;
+	{
+		std::lock_guard<std::mutex> lock(m_recencyBonusesMutex);
+		recencyBonuses = m_recencyBonuses;
+	}
+
+	// score and order initial paths, paths are only sorted as far as they are needed for results.
+	// The highest reference bonus within a subtree is added, so subtrees containing widely used
+	// symbols are taken before the result count is reached.
+	std::vector<std::pair<int, size_t>> scoredPaths;
+	scoredPaths.reserve(paths.size());
+	for (size_t i = 0; i < paths.size(); i++)
 	{
-		scoredPaths.emplace(scoreText(path.text, path.indices), path);
+		scoredPaths.emplace_back(
+			scoreText(paths[i].text, paths[i].indices) +
+				m_maxReferenceBonuses[paths[i].nodeIndex],
+			i);
 	}
 
+	const auto isScoredHigher = [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) {
+		return a.first > b.first || (a.first == b.first && a.second < b.second);
+	};
+
+	size_t sortedPathCount = 0;
+	const size_t sortedPathChunkSize = (maxResultCount ? maxResultCount : scoredPaths.size());
+
 	// score paths and subpaths
 	std::multiset<SearchResult> searchResults;
-	for (const std::pair<int, SearchPath>& p: scoredPaths)
+	for (size_t pathIndex = 0; pathIndex < scoredPaths.size(); pathIndex++)
 	{
+		if (isCancelled && isCancelled())
+		{
+			return {};
+		}
+
+		if (pathIndex == sortedPathCount)
+		{
+			sortedPathCount = std::min(scoredPaths.size(), sortedPathCount + sortedPathChunkSize);
+			std::partial_sort(
+				scoredPaths.begin() + pathIndex,
+				scoredPaths.begin() + sortedPathCount,
+				scoredPaths.end(),
+				isScoredHigher);
+		}
+
 		std::vector<SearchPath> currentPaths;
-		currentPaths.push_back(p.second);
+		currentPaths.push_back(paths[scoredPaths[pathIndex].second]);
 
 		while (!currentPaths.empty())
 		{
@@ -238,25 +782,31 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(
 
 			for (const SearchPath& path: currentPaths)
 			{
-				if (!path.node->elementIds.empty() &&
-					(acceptedNodeTypes.intersectsWith(path.node->containedTypes)))
+				const SearchNode& node = m_nodes[path.nodeIndex];
+				if (node.elementCount &&
+					(acceptedNodeTypes.intersectsWith(m_containedTypes[path.nodeIndex])))
 				{
 					std::vector<Id> elementIds;
-					for (const auto& p: path.node->elementIds)
+					int scoreBonus = 0;
+					for (uint32_t i = node.firstElement; i < node.firstElement + node.elementCount; i++)
 					{
-						if (acceptedNodeTypes.contains(p.second))
+						if (acceptedNodeTypes.contains(NodeType(NodeType::Type(m_elements[i].type))))
 						{
-							elementIds.push_back(p.first);
+							elementIds.push_back(Id(m_elements[i].id));
+							scoreBonus = std::max(
+								scoreBonus, getScoreBonus(m_elements[i], recencyBonuses.get()));
 						}
 					}
 
 					if (!elementIds.empty())
 					{
-						searchResults.emplace(
+						SearchResult result(
 							path.text,
 							std::move(elementIds),
 							path.indices,
 							scoreText(path.text, path.indices));
+						result.scoreBonus = scoreBonus;
+						searchResults.insert(std::move(result));
 
 						if (maxResultCount && searchResults.size() >= maxResultCount)
 						{
@@ -265,10 +815,10 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(
 					}
 				}
 
-				for (auto p: path.node->edges)
+				for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++)
 				{
-					const SearchEdge* edge = p.second;
-					nextPaths.emplace_back(path.text + edge->s, path.indices, edge->target);
+					nextPaths.emplace_back(path.text, path.indices, i);
+					nextPaths.back().text.append(m_text, m_nodes[i].textBegin, m_nodes[i].textLength);
 				}
 			}
 
@@ -279,47 +829,75 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(
 	return searchResults;
 }
 
+size_t SearchIndex::ScoredTextKeyHasher::operator()(const ScoredTextKey& key) const
+{
+	size_t hash = std::hash<std::wstring>()(key.text) ^ std::hash<int>()(key.score);
+	for (size_t index: key.indices)
+	{
+		hash = hash * 31 + index;
+	}
+	return hash;
+}
+
 SearchResult SearchIndex::bestScoredResult(
 	SearchResult result,
-	std::map<std::wstring, SearchResult>* scoresCache,
-	size_t maxBestScoredResultsLength)
+	size_t maxBestScoredResultsLength,
+	const std::function<bool()>& isCancelled)
 {
-	const std::wstring text = result.text;
-
-	if (maxBestScoredResultsLength && result.text.size() > maxBestScoredResultsLength)
+	if (isCancelled && isCancelled())
 	{
-		if (result.indices.back() >= maxBestScoredResultsLength)
-		{
-			return result;
-		}
+		return result;
+	}
 
-		result.text = result.text.substr(0, maxBestScoredResultsLength);
+	if (maxBestScoredResultsLength && result.text.size() > maxBestScoredResultsLength &&
+		result.indices.back() >= maxBestScoredResultsLength)
+	{
+		return result;
 	}
 
-	auto it = scoresCache->find(result.text);
-	if (it != scoresCache->end())
+	static std::mutex cacheMutex;
+	static UnorderedCache<ScoredTextKey, SearchResult, ScoredTextKeyHasher> cache(
+		[](const ScoredTextKey& key) {
+			return calculateBestScoredResult(SearchResult(key.text, {}, key.indices, key.score));
+		},
+		s_maxScoredTextCacheSize);
+
+	ScoredTextKey key;
+	key.text = maxBestScoredResultsLength ? result.text.substr(0, maxBestScoredResultsLength)
+										  : result.text;
+	key.indices = result.indices;
+	key.score = result.score;
+
+	static MetricCounter& scoreCacheHitCounter = getCacheCounter("scores", true);
+	static MetricCounter& scoreCacheMissCounter = getCacheCounter("scores", false);
+
+	SearchResult cachedResult = result;
 	{
-		// std::cout << "cached: " << it->first << " " << it->second.score << std::endl;
-		SearchResult cachedResult = it->second;
-		cachedResult.text = text;
-		cachedResult.elementIds = result.elementIds;
-		return cachedResult;
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		const size_t hitCount = cache.getHitCount();
+		cachedResult = cache.getValue(key);
+		(cache.getHitCount() != hitCount ? scoreCacheHitCounter : scoreCacheMissCounter).add();
 	}
 
+	cachedResult.text = std::move(result.text);
+	cachedResult.elementIds = std::move(result.elementIds);
+	return cachedResult;
+}
+
+SearchResult SearchIndex::calculateBestScoredResult(SearchResult result)
+{
+	// shared prefixes of the text get scored once while moving the matched indices
+	std::map<std::wstring, SearchResult> scoresCache;
+
 	const std::vector<size_t> indices = result.indices;
 	bestScoredResultRecursive(
 		utility::toLowerCase(result.text),
 		indices,
 		indices.back(),
 		indices.size() - 1,
-		scoresCache,
+		&scoresCache,
 		&result);
 
-	// std::cout << "save: " << result.text << " " << result.score << std::endl;
-	scoresCache->emplace(result.text, result);
-
-	result.text = text;
-
 	return result;
 }
 
@@ -461,10 +1039,10 @@ int SearchIndex::scoreText(const std::wstring& text, const std::vector<size_t>&
 			noLetterScore += noLetterBonus;
 		}
 		// camel case
-		else if (iswupper(text[index]))
+		else if (utility::isUpperCase(text[index]))
 		{
-			bool prevIsLower = (index > 0 && iswlower(text[index - 1]));
-			bool nextIsLower = (index + 1 < text.size() && iswlower(text[index + 1]));
+			bool prevIsLower = (index > 0 && utility::isLowerCase(text[index - 1]));
+			bool nextIsLower = (index + 1 < text.size() && utility::isLowerCase(text[index + 1]));
 
 			if (prevIsLower || nextIsLower)
 			{
@@ -517,7 +1095,7 @@ SearchResult SearchIndex::rescoreText(
 
 		for (size_t i = 0; i < textSize && idx < indices.size(); i++)
 		{
-			if (towlower(text[i]) == towlower(fulltext[indices[idx]]))
+			if (utility::toLowerCase(text[i]) == utility::toLowerCase(fulltext[indices[idx]]))
 			{
 				textIndices.push_back(i);
 				idx++;
@@ -535,8 +1113,7 @@ SearchResult SearchIndex::rescoreText(
 	result.score = scoreText(text, textIndices);
 	result.indices = textIndices;
 
-	std::map<std::wstring, SearchResult> scoresCache;
-	result = bestScoredResult(result, &scoresCache, maxBestScoredResultsLength);
+	result = bestScoredResult(result, maxBestScoredResultsLength);
 
 	for (size_t i = 0; i < result.indices.size(); i++)
 	{
@@ -1,8 +1,11 @@
 #ifndef SEARCH_INDEX_H
 #define SEARCH_INDEX_H
 
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -31,74 +34,185 @@ struct SearchResult
 	std::vector<Id> elementIds;
 	std::vector<size_t> indices;
 	int score;
+	int scoreBonus = 0;	   // already contained in the score, not derived from the matched text
 };
 
+// Compact radix tree over the added names. All nodes live in one array with the children of a node
+// stored next to each other and sorted by their first character. Each node knows the lowercase
+// characters within its subtree as a bitmask gate, so searches skip subtrees that can't match.
+// Besides matching the query, results are ranked up by the number of references to their elements
+// and by how recently their elements were active.
 class SearchIndex
 {
 public:
 	SearchIndex();
 	virtual ~SearchIndex();
 
-	void addNode(Id id, std::wstring name, NodeType type = NodeType::NODE_SYMBOL);
+	// nodes are collected and only become searchable once finishSetup was called
+	void addNode(
+		Id id,
+		std::wstring name,
+		NodeType type = NodeType::NODE_SYMBOL,
+		uint32_t referenceCount = 0);
+	// adds the nodes of the other index except the skipped ids, which is cheaper than adding them
+	// one by one because they are already sorted
+	void addNodes(const SearchIndex& index, const std::set<Id>& skippedIds);
 	void finishSetup();
 	void clear();
 
-	// maxResultCount == 0 means "no restriction".
+	// most recently active ids first, replaces the previously set ids
+	void setRecentIds(const std::vector<Id>& ids);
+
+	NodeTypeSet getContainedNodeTypes() const;
+
+	// heap bytes of the tree, the pending nodes and the paths kept for the last query
+	size_t getByteSize() const;
+
+	// the serialized data is only meant to be read by the same build on the same platform
+	std::string serialize() const;
+	bool deserialize(const std::string& data);
+
+	// maxResultCount == 0 means "no restriction". The paths found for the last query are kept, so
+	// a query that extends it only continues from them. The search stops with no results as soon as
+	// isCancelled returns true.
 	std::vector<SearchResult> search(
 		const std::wstring& query,
 		NodeTypeSet acceptedNodeTypes,
 		size_t maxResultCount,
-		size_t maxBestScoredResultsLength = 0) const;
+		size_t maxBestScoredResultsLength = 0,
+		const std::function<bool()>& isCancelled = nullptr) const;
 
 private:
-	struct SearchEdge;
+	typedef uint64_t GateMask;
 
 	struct SearchNode
 	{
-		SearchNode(NodeTypeSet containedTypes): containedTypes(containedTypes) {}
-
-		std::map<Id, NodeType> elementIds;
-		NodeTypeSet containedTypes;
-		std::map<wchar_t, SearchEdge*> edges;
+		uint32_t firstChild = 0;
+		uint32_t childCount = 0;
+		uint32_t textBegin = 0;	   // text of the edge leading to this node
+		uint32_t textLength = 0;
+		uint32_t firstElement = 0;
+		uint32_t elementCount = 0;
 	};
 
-	struct SearchEdge
+	struct SearchElement
 	{
-		SearchEdge(SearchNode* target, std::wstring s): target(target), s(std::move(s)) {}
+		uint64_t id;
+		NodeType::TypeMask type;
+		uint32_t referenceCount;
+	};
 
-		SearchNode* target;
-		std::wstring s;
-		std::set<wchar_t> gate;
+	struct PendingNode
+	{
+		uint32_t textBegin;
+		uint32_t textLength;
+		Id id;
+		NodeType::TypeMask type;
+		uint32_t referenceCount;
 	};
 
 	struct SearchPath
 	{
-		SearchPath(std::wstring text, std::vector<size_t> indices, SearchNode* node)
-			: text(std::move(text)), indices(std::move(indices)), node(node)
+		SearchPath(std::wstring text, std::vector<size_t> indices, uint32_t nodeIndex)
+			: text(std::move(text)), indices(std::move(indices)), nodeIndex(nodeIndex)
 		{
 		}
 
 		std::wstring text;
 		std::vector<size_t> indices;
-		SearchNode* node;
+		uint32_t nodeIndex;
 	};
 
-	void populateEdgeGate(SearchEdge* e);
+	struct SearchTask
+	{
+		SearchPath path;
+		std::wstring remainingQuery;	// empty if the path already matches the query
+	};
+
+	static const uint32_t s_serializationVersion;
+	static const size_t s_minParallelSearchNodeCount;
+	static const size_t s_maxCachedPathCount;
+	static const int s_maxReferenceBonus;
+	static const int s_maxRecencyBonus;
+	static const size_t s_recentIdsPerRecencyStep;
+
+	static GateMask getGateMask(wchar_t lowerCaseChar);
+	static int getReferenceBonus(uint32_t referenceCount);
+	static GateMask getGateMask(const std::wstring& lowerCaseText);
+
+	void addNodesRecursive(
+		const SearchIndex& index,
+		uint32_t nodeIndex,
+		const std::set<Id>& skippedIds,
+		std::wstring* name);
+	void buildNodeRecursive(uint32_t nodeIndex, size_t beginIndex, size_t endIndex, size_t depth);
+	void populateGatesAndTypes();
+
+	int getScoreBonus(
+		const SearchElement& element, const std::map<Id, int>* recencyBonuses) const;
+
+	std::vector<SearchPath> findPaths(
+		const std::wstring& lowerQuery,
+		NodeTypeSet acceptedNodeTypes,
+		const std::function<bool()>& isCancelled) const;
+	std::vector<SearchPath> findPathsParallel(
+		const std::wstring& lowerQuery,
+		NodeTypeSet acceptedNodeTypes,
+		const std::function<bool()>& isCancelled) const;
+
+	// consumes the characters of the edge leading to the child, returns false if the child can't
+	// contain a match
+	bool enterChild(
+		const SearchPath& path,
+		uint32_t childIndex,
+		const std::wstring& remainingQuery,
+		GateMask queryGate,
+		NodeTypeSet acceptedNodeTypes,
+		SearchTask* task) const;
+	void continueTask(
+		const SearchTask& task,
+		NodeTypeSet acceptedNodeTypes,
+		const std::function<bool()>& isCancelled,
+		std::vector<SearchIndex::SearchPath>* results) const;
 	void searchRecursive(
 		const SearchPath& path,
 		const std::wstring& remainingQuery,
 		NodeTypeSet acceptedNodeTypes,
+		const std::function<bool()>& isCancelled,
 		std::vector<SearchIndex::SearchPath>* results) const;
 
 	std::multiset<SearchResult> createScoredResults(
 		const std::vector<SearchPath>& paths,
 		NodeTypeSet acceptedNodeTypes,
-		size_t maxResultCount) const;
+		size_t maxResultCount,
+		const std::function<bool()>& isCancelled) const;
+
+	struct ScoredTextKey
+	{
+		bool operator==(const ScoredTextKey& other) const
+		{
+			return score == other.score && indices == other.indices && text == other.text;
+		}
+
+		std::wstring text;
+		std::vector<size_t> indices;
+		int score;
+	};
 
+	struct ScoredTextKeyHasher
+	{
+		size_t operator()(const ScoredTextKey& key) const;
+	};
+
+	static const size_t s_maxScoredTextCacheSize;
+
+	// the result keeps its score if the search got cancelled. Best scores are kept in a cache shared
+	// by all indices, so following queries and rescoring the same text don't score it again.
 	static SearchResult bestScoredResult(
 		SearchResult result,
-		std::map<std::wstring, SearchResult>* scoresCache,
-		size_t maxBestScoredResultsLength);
+		size_t maxBestScoredResultsLength,
+		const std::function<bool()>& isCancelled = nullptr);
+	static SearchResult calculateBestScoredResult(SearchResult result);
 	static void bestScoredResultRecursive(
 		const std::wstring& lowerText,
 		const std::vector<size_t>& indices,
@@ -119,9 +233,26 @@ public:
 	static bool isNoLetter(const wchar_t c);
 
 private:
-	std::vector<std::unique_ptr<SearchNode>> m_nodes;
-	std::vector<std::unique_ptr<SearchEdge>> m_edges;
-	SearchNode* m_root;
+	std::vector<SearchNode> m_nodes;	// root is the first node
+	std::vector<SearchElement> m_elements;
+	std::wstring m_text;
+
+	// derived from the nodes and elements, not serialized
+	std::vector<GateMask> m_gates;
+	std::vector<NodeTypeSet> m_containedTypes;
+	std::vector<int> m_maxReferenceBonuses;	   // highest bonus within the subtree
+
+	std::vector<PendingNode> m_pendingNodes;
+	std::wstring m_pendingText;
+	size_t m_sortedPendingNodeCount = 0;	// leading pending nodes that are sorted already
+
+	mutable std::mutex m_cachedPathsMutex;
+	mutable std::wstring m_cachedQuery;
+	mutable NodeTypeSet m_cachedNodeTypes;
+	mutable std::shared_ptr<const std::vector<SearchPath>> m_cachedPaths;
+
+	mutable std::mutex m_recencyBonusesMutex;
+	std::shared_ptr<const std::map<Id, int>> m_recencyBonuses;
 };
 
 #endif	  // SEARCH_INDEX_H
@@ -74,6 +74,7 @@ struct SearchMatch
 	std::vector<size_t> indices;
 
 	int score = 0;
+	int scoreBonus = 0;	   // part of the score that doesn't depend on the matched text
 	bool hasChildren = false;
 };
 
@@ -0,0 +1,235 @@
+#include "FileContentCache.h"
+
+#include <tuple>
+
+#include "TextAccess.h"
+#include "TextCodec.h"
+
+bool FileContentCache::Key::operator<(const Key& other) const
+{
+	return std::tie(fileId, revision, modificationTime) <
+		std::tie(other.fileId, other.revision, other.modificationTime);
+}
+
+size_t FileContentCache::DecodedContent::getByteSize() const
+{
+	size_t byteSize = codecName.size() + lines.size() * sizeof(std::wstring);
+	for (const std::wstring& line: lines)
+	{
+		byteSize += line.size() * sizeof(wchar_t);
+	}
+	return byteSize;
+}
+
+FileContentCache* FileContentCache::getInstance()
+{
+	static std::shared_ptr<FileContentCache> instance = std::make_shared<FileContentCache>();
+	return instance.get();
+}
+
+std::string FileContentCache::getConsumerName(Consumer consumer)
+{
+	switch (consumer)
+	{
+	case CONSUMER_CODE_VIEW:
+		return "code view";
+	case CONSUMER_TOOLTIP:
+		return "tooltip";
+	case CONSUMER_FULLTEXT_SEARCH:
+		return "fulltext search";
+	case CONSUMER_REFRESH:
+		return "refresh";
+	case CONSUMER_COUNT:
+		break;
+	}
+	return "";
+}
+
+std::shared_ptr<const FileContentCache::DecodedContent> FileContentCache::decode(
+	const TextAccess& text, const TextCodec& codec)
+{
+	std::shared_ptr<DecodedContent> decodedContent = std::make_shared<DecodedContent>();
+	decodedContent->codecName = codec.getName();
+
+	const unsigned int lineCount = text.getLineCount();
+	decodedContent->lines.reserve(lineCount);
+	for (unsigned int lineNumber = 1; lineNumber <= lineCount; lineNumber++)
+	{
+		decodedContent->lines.push_back(codec.decode(text.getLine(lineNumber)));
+	}
+	return decodedContent;
+}
+
+FileContentCache::FileContentCache()
+	: m_byteBudget(64 * 1024 * 1024), m_byteSize(0), m_consumerStats(CONSUMER_COUNT)
+{
+}
+
+size_t FileContentCache::getByteBudget() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_byteBudget;
+}
+
+void FileContentCache::setByteBudget(size_t byteBudget)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_byteBudget = byteBudget;
+	dropEntriesAboveBudget();
+}
+
+std::shared_ptr<TextAccess> FileContentCache::getText(
+	const Key& key,
+	Consumer consumer,
+	const std::function<std::shared_ptr<TextAccess>()>& loadText)
+{
+	const EntryKey entryKey(key, "");
+
+	Entry entry;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const bool hit = getEntry(entryKey, &entry);
+		countAccess(consumer, hit);
+		if (hit)
+		{
+			return entry.text;
+		}
+	}
+
+	// loaded without holding the lock, a content loaded twice meanwhile is added once
+	entry.key = entryKey;
+	entry.text = loadText();
+	entry.byteSize = entry.text->getByteSize();
+	addEntry(entry);
+	return entry.text;
+}
+
+std::shared_ptr<const FileContentCache::DecodedContent> FileContentCache::getDecodedContent(
+	const Key& key,
+	const TextCodec& codec,
+	Consumer consumer,
+	const std::function<std::shared_ptr<TextAccess>()>& loadText)
+{
+	const EntryKey entryKey(key, codec.getName());
+	const EntryKey textEntryKey(key, "");
+
+	Entry entry;
+	Entry textEntry;
+	bool hasText = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const bool hit = getEntry(entryKey, &entry);
+		countAccess(consumer, hit);
+		if (hit)
+		{
+			return entry.decodedContent;
+		}
+		hasText = getEntry(textEntryKey, &textEntry);
+	}
+
+	if (!hasText)
+	{
+		textEntry.key = textEntryKey;
+		textEntry.text = loadText();
+		textEntry.byteSize = textEntry.text->getByteSize();
+		addEntry(textEntry);
+	}
+
+	entry.key = entryKey;
+	entry.decodedContent = decode(*textEntry.text, codec);
+	entry.byteSize = entry.decodedContent->getByteSize();
+	addEntry(entry);
+	return entry.decodedContent;
+}
+
+size_t FileContentCache::getByteSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_byteSize;
+}
+
+size_t FileContentCache::getEntryCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size();
+}
+
+FileContentCache::ConsumerStats FileContentCache::getConsumerStats(Consumer consumer) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_consumerStats[consumer];
+}
+
+std::string FileContentCache::getReport() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::string report = "File content cache: " + std::to_string(m_entries.size()) + " entries, " +
+		std::to_string(m_byteSize / 1024) + " of " + std::to_string(m_byteBudget / 1024) + " kB";
+	for (size_t i = 0; i < CONSUMER_COUNT; i++)
+	{
+		const ConsumerStats& stats = m_consumerStats[i];
+		report += "\n\t" + getConsumerName(Consumer(i)) + ": " + std::to_string(stats.hitCount) +
+			" hits, " + std::to_string(stats.missCount) + " misses";
+	}
+	return report;
+}
+
+void FileContentCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+	m_entryIndex.clear();
+	m_byteSize = 0;
+	m_consumerStats = std::vector<ConsumerStats>(CONSUMER_COUNT);
+}
+
+bool FileContentCache::getEntry(const EntryKey& key, Entry* entry)
+{
+	auto it = m_entryIndex.find(key);
+	if (it == m_entryIndex.end())
+	{
+		return false;
+	}
+
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+	*entry = m_entries.front();
+	return true;
+}
+
+void FileContentCache::addEntry(Entry entry)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (entry.byteSize > m_byteBudget || m_entryIndex.find(entry.key) != m_entryIndex.end())
+	{
+		return;
+	}
+
+	m_byteSize += entry.byteSize;
+	m_entries.push_front(std::move(entry));
+	m_entryIndex.emplace(m_entries.front().key, m_entries.begin());
+	dropEntriesAboveBudget();
+}
+
+void FileContentCache::countAccess(Consumer consumer, bool hit)
+{
+	ConsumerStats& stats = m_consumerStats[consumer];
+	if (hit)
+	{
+		stats.hitCount++;
+	}
+	else
+	{
+		stats.missCount++;
+	}
+}
+
+void FileContentCache::dropEntriesAboveBudget()
+{
+	while (m_byteSize > m_byteBudget && !m_entries.empty())
+	{
+		m_byteSize -= m_entries.back().byteSize;
+		m_entryIndex.erase(m_entries.back().key);
+		m_entries.pop_back();
+	}
+}
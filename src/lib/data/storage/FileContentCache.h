@@ -0,0 +1,114 @@
+#ifndef FILE_CONTENT_CACHE_H
+#define FILE_CONTENT_CACHE_H
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+class TextAccess;
+class TextCodec;
+
+// Stored contents of files with their line offsets and their decoded lines, shared by all storages
+// of the process. Contents are keyed by the id of the file and the content version of its storage,
+// so contents of a replaced storage are never returned and just get dropped once the byte budget
+// is exceeded, least recently used first. Hits and misses are counted for each consumer.
+class FileContentCache
+{
+public:
+	enum Consumer
+	{
+		CONSUMER_CODE_VIEW,
+		CONSUMER_TOOLTIP,
+		CONSUMER_FULLTEXT_SEARCH,
+		CONSUMER_REFRESH,
+		CONSUMER_COUNT
+	};
+
+	struct Key
+	{
+		Id fileId = 0;
+		size_t revision = 0;	// content version of the storage
+		std::string modificationTime;	 // changes when the content is replaced within a revision
+
+		bool operator<(const Key& other) const;
+	};
+
+	// lines decoded with the codec, they keep their line endings like TextAccess::getLine
+	struct DecodedContent
+	{
+		std::string codecName;
+		std::vector<std::wstring> lines;
+
+		size_t getByteSize() const;
+	};
+
+	struct ConsumerStats
+	{
+		size_t hitCount = 0;
+		size_t missCount = 0;
+	};
+
+	static FileContentCache* getInstance();
+
+	static std::string getConsumerName(Consumer consumer);
+	static std::shared_ptr<const DecodedContent> decode(
+		const TextAccess& text, const TextCodec& codec);
+
+	FileContentCache();
+
+	size_t getByteBudget() const;
+	// contents larger than the budget are not kept, 0 disables the cache
+	void setByteBudget(size_t byteBudget);
+
+	std::shared_ptr<TextAccess> getText(
+		const Key& key,
+		Consumer consumer,
+		const std::function<std::shared_ptr<TextAccess>()>& loadText);
+	std::shared_ptr<const DecodedContent> getDecodedContent(
+		const Key& key,
+		const TextCodec& codec,
+		Consumer consumer,
+		const std::function<std::shared_ptr<TextAccess>()>& loadText);
+
+	size_t getByteSize() const;
+	size_t getEntryCount() const;
+	ConsumerStats getConsumerStats(Consumer consumer) const;
+	std::string getReport() const;
+
+	void clear();
+
+private:
+	// decoded contents are stored with the name of their codec, the text with an empty name
+	typedef std::pair<Key, std::string> EntryKey;
+
+	struct Entry
+	{
+		EntryKey key;
+		std::shared_ptr<TextAccess> text;
+		std::shared_ptr<const DecodedContent> decodedContent;
+		size_t byteSize = 0;
+	};
+
+	typedef std::list<Entry> EntryList;
+
+	// returns false if the entry is not cached, moves it to the front otherwise
+	bool getEntry(const EntryKey& key, Entry* entry);
+	void addEntry(Entry entry);
+	void countAccess(Consumer consumer, bool hit);
+	void dropEntriesAboveBudget();
+
+	mutable std::mutex m_mutex;
+	size_t m_byteBudget;
+	size_t m_byteSize;
+	EntryList m_entries;	// most recently used in front
+	std::map<EntryKey, EntryList::iterator> m_entryIndex;
+	std::vector<ConsumerStats> m_consumerStats;
+};
+
+#endif	  // FILE_CONTENT_CACHE_H
@@ -0,0 +1,502 @@
+#include "FileReachabilityIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "utilityBinary.h"
+
+namespace
+{
+const uint32_t s_unvisited = std::numeric_limits<uint32_t>::max();
+
+template <typename T>
+size_t getVectorByteSize(const std::vector<T>& values)
+{
+	return values.capacity() * sizeof(T);
+}
+}	 // namespace
+
+const uint32_t FileReachabilityIndex::s_serializationVersion = 1;
+
+FileReachabilityIndex::FileReachabilityIndex(std::vector<std::pair<uint64_t, uint64_t>> references)
+{
+	std::sort(references.begin(), references.end());
+	references.erase(std::unique(references.begin(), references.end()), references.end());
+	m_referenceCount = references.size();
+
+	std::vector<uint64_t> ids;
+	ids.reserve(references.size() * 2);
+	for (const std::pair<uint64_t, uint64_t>& reference: references)
+	{
+		ids.push_back(reference.first);
+		ids.push_back(reference.second);
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+	const auto getIndex = [&ids](uint64_t id) {
+		return uint32_t(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+	};
+
+	// the references are sorted by the referencing file, so they already form its rows
+	const uint32_t fileCount = uint32_t(ids.size());
+	std::vector<uint32_t> offsets(fileCount + 1, 0);
+	std::vector<uint32_t> targets;
+	targets.reserve(references.size());
+	for (const std::pair<uint64_t, uint64_t>& reference: references)
+	{
+		offsets[getIndex(reference.first) + 1]++;
+		targets.push_back(getIndex(reference.second));
+	}
+	for (uint32_t i = 0; i < fileCount; i++)
+	{
+		offsets[i + 1] += offsets[i];
+	}
+
+	// strongly connected components by tarjan's algorithm, with a stack instead of recursion
+	std::vector<uint32_t> fileComponents(fileCount, s_unvisited);
+	std::vector<uint32_t> indices(fileCount, s_unvisited);
+	std::vector<uint32_t> lowLinks(fileCount, 0);
+	std::vector<uint8_t> onStack(fileCount, 0);
+	std::vector<uint32_t> stack;
+	std::vector<std::pair<uint32_t, uint32_t>> callStack;	 // file and its next reference
+	uint32_t nextIndex = 0;
+	uint32_t componentCount = 0;
+	for (uint32_t root = 0; root < fileCount; root++)
+	{
+		if (indices[root] != s_unvisited)
+		{
+			continue;
+		}
+
+		indices[root] = lowLinks[root] = nextIndex++;
+		stack.push_back(root);
+		onStack[root] = 1;
+		callStack.emplace_back(root, offsets[root]);
+
+		while (!callStack.empty())
+		{
+			const uint32_t file = callStack.back().first;
+			if (callStack.back().second < offsets[file + 1])
+			{
+				const uint32_t target = targets[callStack.back().second++];
+				if (indices[target] == s_unvisited)
+				{
+					indices[target] = lowLinks[target] = nextIndex++;
+					stack.push_back(target);
+					onStack[target] = 1;
+					callStack.emplace_back(target, offsets[target]);
+				}
+				else if (onStack[target])
+				{
+					lowLinks[file] = std::min(lowLinks[file], indices[target]);
+				}
+				continue;
+			}
+
+			callStack.pop_back();
+			if (!callStack.empty())
+			{
+				uint32_t& parentLowLink = lowLinks[callStack.back().first];
+				parentLowLink = std::min(parentLowLink, lowLinks[file]);
+			}
+
+			if (lowLinks[file] == indices[file])
+			{
+				uint32_t member = 0;
+				do
+				{
+					member = stack.back();
+					stack.pop_back();
+					onStack[member] = 0;
+					fileComponents[member] = componentCount;
+				} while (member != file);
+				componentCount++;
+			}
+		}
+	}
+
+	m_files.reserve(fileCount);
+	m_componentOffsets.assign(componentCount + 1, 0);
+	for (uint32_t i = 0; i < fileCount; i++)
+	{
+		m_files.push_back({ids[i], fileComponents[i]});
+		m_componentOffsets[fileComponents[i] + 1]++;
+	}
+	for (uint32_t i = 0; i < componentCount; i++)
+	{
+		m_componentOffsets[i + 1] += m_componentOffsets[i];
+	}
+	m_componentFileIds.resize(fileCount);
+	{
+		std::vector<uint32_t> nextPositions(m_componentOffsets.begin(), m_componentOffsets.end() - 1);
+		for (uint32_t i = 0; i < fileCount; i++)
+		{
+			m_componentFileIds[nextPositions[fileComponents[i]]++] = ids[i];
+		}
+	}
+
+	m_componentCyclic.assign(componentCount, 0);
+	for (uint32_t i = 0; i < componentCount; i++)
+	{
+		if (m_componentOffsets[i + 1] - m_componentOffsets[i] > 1)
+		{
+			m_componentCyclic[i] = 1;
+		}
+	}
+
+	// references between the components, which form an acyclic graph
+	std::vector<std::pair<uint32_t, uint32_t>> componentReferences;
+	for (uint32_t file = 0; file < fileCount; file++)
+	{
+		for (uint32_t i = offsets[file]; i < offsets[file + 1]; i++)
+		{
+			const uint32_t source = fileComponents[file];
+			const uint32_t target = fileComponents[targets[i]];
+			if (source != target)
+			{
+				componentReferences.emplace_back(source, target);
+			}
+			else if (file == targets[i])
+			{
+				m_componentCyclic[source] = 1;
+			}
+		}
+	}
+
+	const auto buildRows = [componentCount](std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+											std::vector<uint32_t>& rowOffsets,
+											std::vector<uint32_t>& rowTargets) {
+		std::sort(pairs.begin(), pairs.end());
+		pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+		rowOffsets.assign(componentCount + 1, 0);
+		rowTargets.clear();
+		rowTargets.reserve(pairs.size());
+		for (const std::pair<uint32_t, uint32_t>& p: pairs)
+		{
+			rowOffsets[p.first + 1]++;
+			rowTargets.push_back(p.second);
+		}
+		for (uint32_t i = 0; i < componentCount; i++)
+		{
+			rowOffsets[i + 1] += rowOffsets[i];
+		}
+	};
+
+	std::vector<uint32_t> rowOffsets;
+	std::vector<uint32_t> rowTargets;
+	buildRows(componentReferences, rowOffsets, rowTargets);
+	m_referenced = buildLabels(componentCount, rowOffsets, rowTargets);
+
+	for (std::pair<uint32_t, uint32_t>& p: componentReferences)
+	{
+		std::swap(p.first, p.second);
+	}
+	buildRows(componentReferences, rowOffsets, rowTargets);
+	m_referencing = buildLabels(componentCount, rowOffsets, rowTargets);
+}
+
+void FileReachabilityIndex::clear()
+{
+	*this = FileReachabilityIndex();
+}
+
+size_t FileReachabilityIndex::getReferenceCount() const
+{
+	return size_t(m_referenceCount);
+}
+
+size_t FileReachabilityIndex::getByteSize() const
+{
+	size_t size = getVectorByteSize(m_files) + getVectorByteSize(m_componentOffsets) +
+		getVectorByteSize(m_componentFileIds) + getVectorByteSize(m_componentCyclic);
+	for (const Labels* labels: {&m_referenced, &m_referencing})
+	{
+		size += getVectorByteSize(labels->components) + getVectorByteSize(labels->positions) +
+			getVectorByteSize(labels->offsets) + getVectorByteSize(labels->intervals);
+	}
+	return size;
+}
+
+FileReachabilityIndex::IdSet FileReachabilityIndex::getReferenced(const IdSet& ids) const
+{
+	return getReached(m_referenced, ids);
+}
+
+FileReachabilityIndex::IdSet FileReachabilityIndex::getReferencing(const IdSet& ids) const
+{
+	return getReached(m_referencing, ids);
+}
+
+FileReachabilityIndex FileReachabilityIndex::withIds(
+	const std::function<uint64_t(uint64_t)>& getId) const
+{
+	FileReachabilityIndex index = *this;
+	for (File& file: index.m_files)
+	{
+		file.id = getId(file.id);
+	}
+	std::sort(index.m_files.begin(), index.m_files.end(), [](const File& a, const File& b) {
+		return a.id < b.id;
+	});
+	for (uint64_t& id: index.m_componentFileIds)
+	{
+		id = getId(id);
+	}
+	return index;
+}
+
+std::string FileReachabilityIndex::serialize() const
+{
+	std::string data;
+	const uint32_t header[] = {s_serializationVersion, uint32_t(sizeof(File))};
+	data.append(reinterpret_cast<const char*>(header), sizeof(header));
+
+	utility::appendBinaryData(data, std::vector<uint64_t>({m_referenceCount}));
+	utility::appendBinaryData(data, m_files);
+	utility::appendBinaryData(data, m_componentOffsets);
+	utility::appendBinaryData(data, m_componentFileIds);
+	utility::appendBinaryData(data, m_componentCyclic);
+	appendLabels(data, m_referenced);
+	appendLabels(data, m_referencing);
+	return data;
+}
+
+bool FileReachabilityIndex::deserialize(const std::string& data)
+{
+	clear();
+
+	uint32_t header[2] = {0, 0};
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(header, data.data(), sizeof(header));
+	if (header[0] != s_serializationVersion || header[1] != sizeof(File))
+	{
+		return false;
+	}
+
+	size_t position = sizeof(header);
+	FileReachabilityIndex index;
+	std::vector<uint64_t> referenceCount;
+	if (!utility::readBinaryData(data, position, referenceCount) || referenceCount.size() != 1 ||
+		!utility::readBinaryData(data, position, index.m_files) ||
+		!utility::readBinaryData(data, position, index.m_componentOffsets) ||
+		!utility::readBinaryData(data, position, index.m_componentFileIds) ||
+		!utility::readBinaryData(data, position, index.m_componentCyclic))
+	{
+		return false;
+	}
+	index.m_referenceCount = referenceCount.front();
+
+	const size_t componentCount = index.m_componentCyclic.size();
+	if (index.m_componentOffsets.size() != componentCount + 1 ||
+		index.m_componentOffsets.front() != 0 ||
+		index.m_componentOffsets.back() != index.m_componentFileIds.size() ||
+		index.m_files.size() != index.m_componentFileIds.size())
+	{
+		return false;
+	}
+	for (size_t i = 1; i < index.m_componentOffsets.size(); i++)
+	{
+		if (index.m_componentOffsets[i] < index.m_componentOffsets[i - 1])
+		{
+			return false;
+		}
+	}
+	for (size_t i = 0; i < index.m_files.size(); i++)
+	{
+		if (index.m_files[i].component >= componentCount ||
+			(i && index.m_files[i].id <= index.m_files[i - 1].id))
+		{
+			return false;
+		}
+	}
+
+	if (!readLabels(data, position, componentCount, index.m_referenced) ||
+		!readLabels(data, position, componentCount, index.m_referencing) ||
+		position != data.size())
+	{
+		return false;
+	}
+
+	*this = std::move(index);
+	return true;
+}
+
+FileReachabilityIndex::Labels FileReachabilityIndex::buildLabels(
+	size_t componentCount, const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& targets)
+{
+	Labels labels;
+	labels.positions.assign(componentCount, s_unvisited);
+	labels.components.reserve(componentCount);
+
+	// traversing from the components nobody references keeps the ranges of their subtrees whole
+	std::vector<uint8_t> referenced(componentCount, 0);
+	for (const uint32_t target: targets)
+	{
+		referenced[target] = 1;
+	}
+
+	// each component gets its intervals once all components it references got their positions
+	std::vector<std::vector<Interval>> componentIntervals(componentCount);
+	std::vector<std::pair<uint32_t, uint32_t>> callStack;	 // component and its next reference
+	for (uint32_t root = 0; root < componentCount; root++)
+	{
+		if (referenced[root])
+		{
+			continue;
+		}
+
+		callStack.emplace_back(root, offsets[root]);
+		while (!callStack.empty())
+		{
+			const uint32_t component = callStack.back().first;
+			if (callStack.back().second < offsets[component + 1])
+			{
+				// the graph is acyclic, so a component without position is not on the stack yet
+				const uint32_t target = targets[callStack.back().second++];
+				if (labels.positions[target] == s_unvisited)
+				{
+					callStack.emplace_back(target, offsets[target]);
+				}
+				continue;
+			}
+			callStack.pop_back();
+
+			std::vector<Interval> intervals;
+			for (uint32_t i = offsets[component]; i < offsets[component + 1]; i++)
+			{
+				const uint32_t target = targets[i];
+				intervals.push_back({labels.positions[target], labels.positions[target]});
+				intervals.insert(
+					intervals.end(),
+					componentIntervals[target].begin(),
+					componentIntervals[target].end());
+			}
+			std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+				return a.first < b.first;
+			});
+
+			std::vector<Interval>& merged = componentIntervals[component];
+			for (const Interval& interval: intervals)
+			{
+				if (!merged.empty() && interval.first <= merged.back().last + 1)
+				{
+					merged.back().last = std::max(merged.back().last, interval.last);
+				}
+				else
+				{
+					merged.push_back(interval);
+				}
+			}
+
+			labels.positions[component] = uint32_t(labels.components.size());
+			labels.components.push_back(component);
+		}
+	}
+
+	labels.offsets.assign(componentCount + 1, 0);
+	for (size_t i = 0; i < componentCount; i++)
+	{
+		labels.offsets[i + 1] = labels.offsets[i] + uint32_t(componentIntervals[i].size());
+	}
+	labels.intervals.reserve(labels.offsets.back());
+	for (std::vector<Interval>& intervals: componentIntervals)
+	{
+		labels.intervals.insert(labels.intervals.end(), intervals.begin(), intervals.end());
+		std::vector<Interval>().swap(intervals);
+	}
+	return labels;
+}
+
+void FileReachabilityIndex::appendLabels(std::string& data, const Labels& labels)
+{
+	utility::appendBinaryData(data, labels.components);
+	utility::appendBinaryData(data, labels.positions);
+	utility::appendBinaryData(data, labels.offsets);
+	utility::appendBinaryData(data, labels.intervals);
+}
+
+bool FileReachabilityIndex::readLabels(
+	const std::string& data, size_t& position, size_t componentCount, Labels& labels)
+{
+	if (!utility::readBinaryData(data, position, labels.components) ||
+		!utility::readBinaryData(data, position, labels.positions) ||
+		!utility::readBinaryData(data, position, labels.offsets) ||
+		!utility::readBinaryData(data, position, labels.intervals) ||
+		labels.components.size() != componentCount || labels.positions.size() != componentCount ||
+		labels.offsets.size() != componentCount + 1 || labels.offsets.front() != 0 ||
+		labels.offsets.back() != labels.intervals.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < componentCount; i++)
+	{
+		if (labels.components[i] >= componentCount || labels.positions[i] >= componentCount ||
+			labels.offsets[i + 1] < labels.offsets[i])
+		{
+			return false;
+		}
+	}
+	for (const Interval& interval: labels.intervals)
+	{
+		if (interval.first > interval.last || interval.last >= componentCount)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FileReachabilityIndex::IdSet FileReachabilityIndex::getReached(
+	const Labels& labels, const IdSet& ids) const
+{
+	IdSet reachedIds;
+	const auto addComponent = [this, &reachedIds](uint32_t component) {
+		reachedIds.insert(
+			m_componentFileIds.begin() + m_componentOffsets[component],
+			m_componentFileIds.begin() + m_componentOffsets[component + 1]);
+	};
+
+	std::vector<Interval> intervals;
+	for (const uint64_t id: ids)
+	{
+		auto it = std::lower_bound(
+			m_files.begin(), m_files.end(), id, [](const File& file, uint64_t fileId) {
+				return file.id < fileId;
+			});
+		if (it == m_files.end() || it->id != id)
+		{
+			continue;
+		}
+
+		const uint32_t component = it->component;
+		if (m_componentCyclic[component])
+		{
+			addComponent(component);
+		}
+		intervals.insert(
+			intervals.end(),
+			labels.intervals.begin() + labels.offsets[component],
+			labels.intervals.begin() + labels.offsets[component + 1]);
+	}
+
+	std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+		return a.first < b.first;
+	});
+	uint32_t nextPosition = 0;
+	for (const Interval& interval: intervals)
+	{
+		for (uint32_t p = std::max(interval.first, nextPosition); p <= interval.last; p++)
+		{
+			addComponent(labels.components[p]);
+		}
+		nextPosition = std::max(nextPosition, interval.last + 1);
+	}
+
+	return reachedIds;
+}
@@ -0,0 +1,83 @@
+#ifndef FILE_REACHABILITY_INDEX_H
+#define FILE_REACHABILITY_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Transitive closure of the includes and imports between files, compressed by interval labeling.
+// Files that reference each other in a cycle share a component. The components are numbered in
+// depth first post order of the acyclic graph between them, so the components reachable from one
+// mostly form a few ranges of numbers, which are stored instead of the reachable files themselves.
+// The closure is computed once, each query then only enumerates the ranges of the given files.
+class FileReachabilityIndex
+{
+public:
+	typedef std::unordered_set<uint64_t> IdSet;
+
+	FileReachabilityIndex() = default;
+	// each pair is a referencing file followed by the file it references
+	explicit FileReachabilityIndex(std::vector<std::pair<uint64_t, uint64_t>> references);
+
+	void clear();
+	size_t getReferenceCount() const;
+	size_t getByteSize() const;
+
+	// the given files are only part of the result if they are referenced by one of them
+	IdSet getReferenced(const IdSet& ids) const;
+	IdSet getReferencing(const IdSet& ids) const;
+
+	// the same closure for files with other ids, e.g. the ids of a FilePathTable
+	FileReachabilityIndex withIds(const std::function<uint64_t(uint64_t)>& getId) const;
+
+	// the serialized data is only meant to be read by the same build on the same platform
+	std::string serialize() const;
+	bool deserialize(const std::string& data);
+
+private:
+	struct File
+	{
+		uint64_t id;
+		uint32_t component;
+	};
+
+	struct Interval
+	{
+		uint32_t first;
+		uint32_t last;
+	};
+
+	// ranges of positions in the post order of the components in one direction of the references
+	struct Labels
+	{
+		std::vector<uint32_t> components;	 // component at each position
+		std::vector<uint32_t> positions;	 // position of each component
+		std::vector<uint32_t> offsets;	  // component count + 1 entries
+		std::vector<Interval> intervals;
+	};
+
+	static const uint32_t s_serializationVersion;
+
+	static Labels buildLabels(
+		size_t componentCount,
+		const std::vector<uint32_t>& offsets,
+		const std::vector<uint32_t>& targets);
+	static void appendLabels(std::string& data, const Labels& labels);
+	static bool readLabels(
+		const std::string& data, size_t& position, size_t componentCount, Labels& labels);
+
+	IdSet getReached(const Labels& labels, const IdSet& ids) const;
+
+	std::vector<File> m_files;	  // sorted by id
+	std::vector<uint32_t> m_componentOffsets;	 // component count + 1 entries
+	std::vector<uint64_t> m_componentFileIds;
+	std::vector<uint8_t> m_componentCyclic;	   // components that reach themselves
+	Labels m_referenced;
+	Labels m_referencing;
+	uint64_t m_referenceCount = 0;
+};
+
+#endif	  // FILE_REACHABILITY_INDEX_H
@@ -0,0 +1,59 @@
+#include "FileReferenceGraph.h"
+
+namespace
+{
+std::vector<std::pair<uint64_t, uint64_t>> toIndexReferences(
+	const std::vector<std::pair<FileReferenceGraph::Id, FileReferenceGraph::Id>>& references)
+{
+	std::vector<std::pair<uint64_t, uint64_t>> indexReferences;
+	indexReferences.reserve(references.size());
+	for (const std::pair<FileReferenceGraph::Id, FileReferenceGraph::Id>& reference: references)
+	{
+		indexReferences.emplace_back(reference.first, reference.second);
+	}
+	return indexReferences;
+}
+}	 // namespace
+
+FileReferenceGraph::FileReferenceGraph(const std::vector<std::pair<Id, Id>>& references)
+	: m_index(toIndexReferences(references))
+{
+}
+
+FileReferenceGraph FileReferenceGraph::fromIndex(FileReachabilityIndex index)
+{
+	FileReferenceGraph graph;
+	graph.m_index = std::move(index);
+	return graph;
+}
+
+FileReferenceGraph::IdSet FileReferenceGraph::getReferenced(const IdSet& ids) const
+{
+	return fromIndexIds(m_index.getReferenced(toIndexIds(ids)));
+}
+
+FileReferenceGraph::IdSet FileReferenceGraph::getReferencing(const IdSet& ids) const
+{
+	return fromIndexIds(m_index.getReferencing(toIndexIds(ids)));
+}
+
+size_t FileReferenceGraph::getReferenceCount() const
+{
+	return m_index.getReferenceCount();
+}
+
+FileReachabilityIndex::IdSet FileReferenceGraph::toIndexIds(const IdSet& ids)
+{
+	return FileReachabilityIndex::IdSet(ids.begin(), ids.end());
+}
+
+FileReferenceGraph::IdSet FileReferenceGraph::fromIndexIds(const FileReachabilityIndex::IdSet& ids)
+{
+	IdSet result;
+	result.reserve(ids.size());
+	for (const uint64_t id: ids)
+	{
+		result.insert(Id(id));
+	}
+	return result;
+}
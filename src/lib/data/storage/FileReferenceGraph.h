@@ -0,0 +1,40 @@
+#ifndef FILE_REFERENCE_GRAPH_H
+#define FILE_REFERENCE_GRAPH_H
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "FilePathTable.h"
+#include "FileReachabilityIndex.h"
+
+// Includes and imports between files, keyed by the ids of the FilePathTable. Built once, the graph
+// answers any number of queries for the files that reference or are referenced by a set of files
+// directly or indirectly, without reading the storage again.
+class FileReferenceGraph
+{
+public:
+	typedef FilePathTable::Id Id;
+	typedef std::unordered_set<Id> IdSet;
+
+	// each pair is a referencing file followed by the file it references
+	explicit FileReferenceGraph(const std::vector<std::pair<Id, Id>>& references);
+	// the index has to be keyed by the ids of the FilePathTable already
+	static FileReferenceGraph fromIndex(FileReachabilityIndex index);
+
+	// the given files are only part of the result if they are referenced by one of them
+	IdSet getReferenced(const IdSet& ids) const;
+	IdSet getReferencing(const IdSet& ids) const;
+
+	size_t getReferenceCount() const;
+
+private:
+	FileReferenceGraph() = default;
+
+	static FileReachabilityIndex::IdSet toIndexIds(const IdSet& ids);
+	static IdSet fromIndexIds(const FileReachabilityIndex::IdSet& ids);
+
+	FileReachabilityIndex m_index;
+};
+
+#endif	  // FILE_REFERENCE_GRAPH_H
@@ -1,9 +1,40 @@
 #include "IntermediateStorage.h"
 
+#include <algorithm>
+#include <functional>
+#include <set>
+
 #include "LocationType.h"
 #include "utility.h"
 
-IntermediateStorage::IntermediateStorage(): m_nextId(1) {}
+namespace
+{
+void hashCombine(size_t& seed, size_t value)
+{
+	seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+}	 // namespace
+
+IntermediateStorage::IntermediateStorage(): IntermediateStorage(std::make_shared<MemoryArena>()) {}
+
+IntermediateStorage::IntermediateStorage(std::shared_ptr<MemoryArena> arena)
+	: m_arena(arena)
+	, m_nodesIndex(0, std::hash<std::string>(), std::equal_to<std::string>(), m_arena.get())
+	, m_nodeIdIndex(0, std::hash<Id>(), std::equal_to<Id>(), m_arena.get())
+	, m_filesIndex(0, std::hash<std::wstring>(), std::equal_to<std::wstring>(), m_arena.get())
+	, m_filesIdIndex(0, std::hash<Id>(), std::equal_to<Id>(), m_arena.get())
+	, m_edgesIndex(0, EdgeDataHash(), EquivalentByLess(), m_arena.get())
+	, m_localSymbolsIndex(0, LocalSymbolDataHash(), EquivalentByLess(), m_arena.get())
+	, m_sourceLocationsIndex(0, SourceLocationDataHash(), EquivalentByLess(), m_arena.get())
+	, m_errorsIndex(0, ErrorDataHash(), EquivalentByLess(), m_arena.get())
+	, m_nextId(1)
+{
+}
+
+std::shared_ptr<MemoryArena> IntermediateStorage::getMemoryArena() const
+{
+	return m_arena;
+}
 
 void IntermediateStorage::clear()
 {
@@ -20,20 +51,34 @@ void IntermediateStorage::clear()
 	m_edgesIndex.clear();
 	m_edges.clear();
 
+	m_localSymbolsIndex.clear();
 	m_localSymbols.clear();
+	m_localSymbolsSorted = true;
+
+	m_sourceLocationsIndex.clear();
 	m_sourceLocations.clear();
+	m_sourceLocationsSorted = true;
+
 	m_occurrences.clear();
+	m_occurrencesSorted = true;
+
 	m_componentAccesses.clear();
+	m_componentAccessesSorted = true;
+
+	m_elementComponents.clear();
+	m_elementComponentsSorted = true;
 
 	m_errorsIndex.clear();
 	m_errors.clear();
 
+	m_indexingTimes.clear();
+
 	m_nextId = 1;
 }
 
 size_t IntermediateStorage::getByteSize(size_t stringSize) const
 {
-	unsigned int byteSize = 0;
+	size_t byteSize = 0;
 
 	for (const StorageFile& storageFile: getStorageFiles())
 	{
@@ -107,9 +152,19 @@ void IntermediateStorage::setFilesWithErrorsIncomplete()
 		}
 	}
 
+	setFilesIncomplete(errorFileIds);
+}
+
+void IntermediateStorage::setFilesIncomplete(const std::set<Id>& fileIds)
+{
+	if (fileIds.empty())
+	{
+		return;
+	}
+
 	for (StorageFile& file: m_files)
 	{
-		if (errorFileIds.find(file.id) != errorFileIds.end())
+		if (fileIds.find(file.id) != fileIds.end())
 		{
 			file.complete = false;
 		}
@@ -118,7 +173,7 @@ void IntermediateStorage::setFilesWithErrorsIncomplete()
 
 std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData)
 {
-	auto it = m_nodesIndex.find(nodeData);
+	auto it = m_nodesIndex.find(nodeData.serializedName);
 	if (it != m_nodesIndex.end())
 	{
 		StorageNode& storedNode = m_nodes[it->second];
@@ -131,7 +186,7 @@ std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData
 
 	Id nodeId = m_nextId++;
 	m_nodes.emplace_back(nodeId, nodeData);
-	m_nodesIndex.emplace(nodeData, m_nodes.size() - 1);
+	m_nodesIndex.emplace(nodeData.serializedName, m_nodes.size() - 1);
 	m_nodeIdIndex.emplace(nodeId, m_nodes.size() - 1);
 	return std::make_pair(nodeId, true);
 }
@@ -168,7 +223,7 @@ void IntermediateStorage::addSymbols(const std::vector<StorageSymbol>& symbols)
 
 void IntermediateStorage::addFile(const StorageFile& file)
 {
-	auto it = m_filesIndex.find(file);
+	auto it = m_filesIndex.find(file.filePath);
 	if (it != m_filesIndex.end())
 	{
 		StorageFile& storedFile = m_files[it->second];
@@ -190,7 +245,7 @@ void IntermediateStorage::addFile(const StorageFile& file)
 	}
 	else
 	{
-		m_filesIndex.emplace(file, m_files.size());
+		m_filesIndex.emplace(file.filePath, m_files.size());
 		m_filesIdIndex.emplace(file.id, m_files.size());
 		m_files.emplace_back(file);
 	}
@@ -232,18 +287,20 @@ std::vector<Id> IntermediateStorage::addEdges(const std::vector<StorageEdge>& ed
 
 Id IntermediateStorage::addLocalSymbol(const StorageLocalSymbolData& localSymbolData)
 {
-	auto it = m_localSymbols.find(StorageLocalSymbol(0, localSymbolData));
-	if (it != m_localSymbols.end())
+	auto it = m_localSymbolsIndex.find(localSymbolData);
+	if (it != m_localSymbolsIndex.end())
 	{
-		return it->id;
+		return m_localSymbols[it->second].id;
 	}
 
 	Id localSymbolId = m_nextId++;
-	m_localSymbols.emplace(localSymbolId, localSymbolData);
+	m_localSymbolsIndex.emplace(localSymbolData, m_localSymbols.size());
+	m_localSymbols.emplace_back(localSymbolId, localSymbolData);
+	m_localSymbolsSorted = false;
 	return localSymbolId;
 }
 
-std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> IntermediateStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	std::vector<Id> symbolIds;
 	symbolIds.reserve(symbols.size());
@@ -256,14 +313,16 @@ std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocal
 
 Id IntermediateStorage::addSourceLocation(const StorageSourceLocationData& sourceLocationData)
 {
-	auto it = m_sourceLocations.find(StorageSourceLocation(0, sourceLocationData));
-	if (it != m_sourceLocations.end())
+	auto it = m_sourceLocationsIndex.find(sourceLocationData);
+	if (it != m_sourceLocationsIndex.end())
 	{
-		return it->id;
+		return m_sourceLocations[it->second].id;
 	}
 
 	Id sourceLocationId = m_nextId++;
-	m_sourceLocations.emplace(sourceLocationId, sourceLocationData);
+	m_sourceLocationsIndex.emplace(sourceLocationData, m_sourceLocations.size());
+	m_sourceLocations.emplace_back(sourceLocationId, sourceLocationData);
+	m_sourceLocationsSorted = false;
 	return sourceLocationId;
 }
 
@@ -280,32 +339,39 @@ std::vector<Id> IntermediateStorage::addSourceLocations(const std::vector<Storag
 
 void IntermediateStorage::addOccurrence(const StorageOccurrence& occurrence)
 {
-	m_occurrences.emplace(occurrence);
+	m_occurrences.push_back(occurrence);
+	m_occurrencesSorted = false;
 }
 
 void IntermediateStorage::addOccurrences(const std::vector<StorageOccurrence>& occurrences)
 {
-	m_occurrences.insert(occurrences.begin(), occurrences.end());
+	m_occurrences.insert(m_occurrences.end(), occurrences.begin(), occurrences.end());
+	m_occurrencesSorted = false;
 }
 
 void IntermediateStorage::addComponentAccess(const StorageComponentAccess& componentAccess)
 {
-	m_componentAccesses.emplace(componentAccess);
+	m_componentAccesses.push_back(componentAccess);
+	m_componentAccessesSorted = false;
 }
 
 void IntermediateStorage::addComponentAccesses(const std::vector<StorageComponentAccess>& componentAccesses)
 {
-	m_componentAccesses.insert(componentAccesses.begin(), componentAccesses.end());
+	m_componentAccesses.insert(
+		m_componentAccesses.end(), componentAccesses.begin(), componentAccesses.end());
+	m_componentAccessesSorted = false;
 }
 
 void IntermediateStorage::addElementComponent(const StorageElementComponent& component)
 {
-	m_elementComponents.emplace(component);
+	m_elementComponents.push_back(component);
+	m_elementComponentsSorted = false;
 }
 
 void IntermediateStorage::addElementComponents(const std::vector<StorageElementComponent>& components)
 {
-	m_elementComponents.insert(components.begin(), components.end());
+	m_elementComponents.insert(m_elementComponents.end(), components.begin(), components.end());
+	m_elementComponentsSorted = false;
 }
 
 Id IntermediateStorage::addError(const StorageErrorData& errorData)
@@ -342,28 +408,44 @@ const std::vector<StorageEdge>& IntermediateStorage::getStorageEdges() const
 	return m_edges;
 }
 
-const std::set<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const
+// the indices of local symbols and source locations only refer to their position while recording,
+// so they are invalidated by sorting and get rebuilt when needed again
+
+const std::vector<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const
 {
+	if (!m_localSymbolsSorted)
+	{
+		sortUnique(m_localSymbols, m_localSymbolsSorted);
+		rebuildLocalSymbolsIndex();
+	}
 	return m_localSymbols;
 }
 
-const std::set<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const
+const std::vector<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const
 {
+	if (!m_sourceLocationsSorted)
+	{
+		sortUnique(m_sourceLocations, m_sourceLocationsSorted);
+		rebuildSourceLocationsIndex();
+	}
 	return m_sourceLocations;
 }
 
-const std::set<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const
+const std::vector<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const
 {
+	sortUnique(m_occurrences, m_occurrencesSorted);
 	return m_occurrences;
 }
 
-const std::set<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const
+const std::vector<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const
 {
+	sortUnique(m_componentAccesses, m_componentAccessesSorted);
 	return m_componentAccesses;
 }
 
-const std::set<StorageElementComponent>& IntermediateStorage::getElementComponents() const
+const std::vector<StorageElementComponent>& IntermediateStorage::getElementComponents() const
 {
+	sortUnique(m_elementComponents, m_elementComponentsSorted);
 	return m_elementComponents;
 }
 
@@ -372,6 +454,16 @@ const std::vector<StorageError>& IntermediateStorage::getErrors() const
 	return m_errors;
 }
 
+void IntermediateStorage::addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes)
+{
+	m_indexingTimes.insert(m_indexingTimes.end(), indexingTimes.begin(), indexingTimes.end());
+}
+
+std::vector<StorageIndexingTime> IntermediateStorage::getIndexingTimes() const
+{
+	return m_indexingTimes;
+}
+
 void IntermediateStorage::setStorageNodes(std::vector<StorageNode> storageNodes)
 {
 	m_nodes = std::move(storageNodes);
@@ -380,7 +472,7 @@ void IntermediateStorage::setStorageNodes(std::vector<StorageNode> storageNodes)
 	m_nodeIdIndex.clear();
 	for (size_t i = 0; i < m_nodes.size(); i++)
 	{
-		m_nodesIndex.emplace(m_nodes[i], i);
+		m_nodesIndex.emplace(m_nodes[i].serializedName, i);
 		m_nodeIdIndex.emplace(m_nodes[i].id, i);
 	}
 }
@@ -393,7 +485,7 @@ void IntermediateStorage::setStorageFiles(std::vector<StorageFile> storageFiles)
 	m_filesIdIndex.clear();
 	for (size_t i = 0; i < m_files.size(); i++)
 	{
-		m_filesIndex.emplace(m_files[i], i);
+		m_filesIndex.emplace(m_files[i].filePath, i);
 		m_filesIdIndex.emplace(m_files[i].id, i);
 	}
 }
@@ -414,29 +506,39 @@ void IntermediateStorage::setStorageEdges(std::vector<StorageEdge> storageEdges)
 	}
 }
 
-void IntermediateStorage::setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols)
+void IntermediateStorage::setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols)
 {
 	m_localSymbols = std::move(storageLocalSymbols);
+	m_localSymbolsSorted = false;
+	sortUnique(m_localSymbols, m_localSymbolsSorted);
+	rebuildLocalSymbolsIndex();
 }
 
-void IntermediateStorage::setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations)
+void IntermediateStorage::setStorageSourceLocations(
+	std::vector<StorageSourceLocation> storageSourceLocations)
 {
 	m_sourceLocations = std::move(storageSourceLocations);
+	m_sourceLocationsSorted = false;
+	sortUnique(m_sourceLocations, m_sourceLocationsSorted);
+	rebuildSourceLocationsIndex();
 }
 
-void IntermediateStorage::setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences)
+void IntermediateStorage::setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences)
 {
 	m_occurrences = std::move(storageOccurrences);
+	m_occurrencesSorted = false;
 }
 
-void IntermediateStorage::setComponentAccesses(std::set<StorageComponentAccess> componentAccesses)
+void IntermediateStorage::setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses)
 {
 	m_componentAccesses = std::move(componentAccesses);
+	m_componentAccessesSorted = false;
 }
 
-void IntermediateStorage::setElementComponents(std::set<StorageElementComponent> components)
+void IntermediateStorage::setElementComponents(std::vector<StorageElementComponent> components)
 {
 	m_elementComponents = std::move(components);
+	m_elementComponentsSorted = false;
 }
 
 void IntermediateStorage::setErrors(std::vector<StorageError> errors)
@@ -459,3 +561,75 @@ void IntermediateStorage::setNextId(const Id nextId)
 {
 	m_nextId = nextId;
 }
+
+void IntermediateStorage::rebuildLocalSymbolsIndex() const
+{
+	m_localSymbolsIndex.clear();
+	for (size_t i = 0; i < m_localSymbols.size(); i++)
+	{
+		m_localSymbolsIndex.emplace(m_localSymbols[i], i);
+	}
+}
+
+void IntermediateStorage::rebuildSourceLocationsIndex() const
+{
+	m_sourceLocationsIndex.clear();
+	for (size_t i = 0; i < m_sourceLocations.size(); i++)
+	{
+		m_sourceLocationsIndex.emplace(m_sourceLocations[i], i);
+	}
+}
+
+template <typename T>
+void IntermediateStorage::sortUnique(std::vector<T>& elements, bool& isSorted)
+{
+	if (isSorted)
+	{
+		return;
+	}
+
+	// stable, so the first one added wins among equivalent elements, just like std::set::insert
+	std::stable_sort(elements.begin(), elements.end());
+	elements.erase(
+		std::unique(elements.begin(), elements.end(), EquivalentByLess()), elements.end());
+	isSorted = true;
+}
+
+size_t IntermediateStorage::EdgeDataHash::operator()(const StorageEdgeData& data) const
+{
+	size_t seed = std::hash<int>()(data.type);
+	hashCombine(seed, std::hash<Id>()(data.sourceNodeId));
+	hashCombine(seed, std::hash<Id>()(data.targetNodeId));
+	return seed;
+}
+
+size_t IntermediateStorage::LocalSymbolDataHash::operator()(
+	const StorageLocalSymbolData& data) const
+{
+	size_t seed = std::hash<Id>()(data.fileNodeId);
+	hashCombine(seed, std::hash<size_t>()(data.startLine));
+	hashCombine(seed, std::hash<size_t>()(data.startCol));
+	hashCombine(seed, std::hash<std::wstring>()(data.name));
+	return seed;
+}
+
+size_t IntermediateStorage::SourceLocationDataHash::operator()(
+	const StorageSourceLocationData& data) const
+{
+	size_t seed = std::hash<Id>()(data.fileNodeId);
+	hashCombine(seed, std::hash<size_t>()(data.startLine));
+	hashCombine(seed, std::hash<size_t>()(data.startCol));
+	hashCombine(seed, std::hash<size_t>()(data.endLine));
+	hashCombine(seed, std::hash<size_t>()(data.endCol));
+	hashCombine(seed, std::hash<int>()(data.type));
+	return seed;
+}
+
+size_t IntermediateStorage::ErrorDataHash::operator()(const StorageErrorData& data) const
+{
+	size_t seed = std::hash<std::wstring>()(data.message);
+	hashCombine(seed, std::hash<std::wstring>()(data.translationUnit));
+	hashCombine(seed, std::hash<bool>()(data.fatal));
+	hashCombine(seed, std::hash<bool>()(data.indexed));
+	return seed;
+}
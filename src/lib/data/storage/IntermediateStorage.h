@@ -1,16 +1,21 @@
 #ifndef INTERMEDIATE_STORAGE_H
 #define INTERMEDIATE_STORAGE_H
 
-#include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 
+#include "MemoryArena.h"
 #include "Storage.h"
 
 class IntermediateStorage: public Storage
 {
 public:
 	IntermediateStorage();
+	IntermediateStorage(std::shared_ptr<MemoryArena> arena);
+
+	// arena that holds the lookup indices, it lives as long as the storage or any of its copies
+	std::shared_ptr<MemoryArena> getMemoryArena() const;
 
 	void clear();
 
@@ -20,6 +25,7 @@ public:
 	bool hasFatalErrors() const;
 	void setAllFilesIncomplete();
 	void setFilesWithErrorsIncomplete();
+	void setFilesIncomplete(const std::set<Id>& fileIds);
 
 	std::pair<Id, bool> addNode(const StorageNodeData& nodeData) override;
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes) override;
@@ -31,7 +37,7 @@ public:
 	Id addEdge(const StorageEdgeData& edgeData) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& localSymbolData) override;
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 	Id addSourceLocation(const StorageSourceLocationData& sourceLocationData) override;
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
 	void addOccurrence(const StorageOccurrence& occurrence) override;
@@ -46,53 +52,120 @@ public:
 	const std::vector<StorageFile>& getStorageFiles() const override;
 	const std::vector<StorageSymbol>& getStorageSymbols() const override;
 	const std::vector<StorageEdge>& getStorageEdges() const override;
-	const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-	const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-	const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-	const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-	const std::set<StorageElementComponent>& getElementComponents() const override;
+	const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+	const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+	const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+	const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+	const std::vector<StorageElementComponent>& getElementComponents() const override;
 	const std::vector<StorageError>& getErrors() const override;
 
+	void addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes) override;
+	std::vector<StorageIndexingTime> getIndexingTimes() const override;
+
 	void setStorageNodes(std::vector<StorageNode> storageNodes);
 	void setStorageFiles(std::vector<StorageFile> storageFiles);
 	void setStorageSymbols(std::vector<StorageSymbol> storageSymbols);
 	void setStorageEdges(std::vector<StorageEdge> storageEdges);
-	void setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols);
-	void setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations);
-	void setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences);
-	void setComponentAccesses(std::set<StorageComponentAccess> componentAccesses);
-	void setElementComponents(std::set<StorageElementComponent> components);
+	void setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols);
+	void setStorageSourceLocations(std::vector<StorageSourceLocation> storageSourceLocations);
+	void setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences);
+	void setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses);
+	void setElementComponents(std::vector<StorageElementComponent> components);
 	void setErrors(std::vector<StorageError> errors);
 
 	Id getNextId() const;
 	void setNextId(const Id nextId);
 
 private:
-	std::map<StorageNodeData, size_t> m_nodesIndex;
-	std::map<Id, size_t> m_nodeIdIndex;
+	// equality as defined by operator<, which is what the former std::set/std::map indices used
+	struct EquivalentByLess
+	{
+		template <typename T>
+		bool operator()(const T& a, const T& b) const
+		{
+			return !(a < b) && !(b < a);
+		}
+	};
+
+	struct EdgeDataHash
+	{
+		size_t operator()(const StorageEdgeData& data) const;
+	};
+
+	struct LocalSymbolDataHash
+	{
+		size_t operator()(const StorageLocalSymbolData& data) const;
+	};
+
+	struct SourceLocationDataHash
+	{
+		size_t operator()(const StorageSourceLocationData& data) const;
+	};
+
+	struct ErrorDataHash
+	{
+		size_t operator()(const StorageErrorData& data) const;
+	};
+
+	// sorts and removes duplicates of elements that are only appended while recording
+	template <typename T>
+	static void sortUnique(std::vector<T>& elements, bool& isSorted);
+
+	void rebuildLocalSymbolsIndex() const;
+	void rebuildSourceLocationsIndex() const;
+
+	template <
+		typename KeyType,
+		typename HashType = std::hash<KeyType>,
+		typename EqualType = std::equal_to<KeyType>>
+	using ArenaIndex = std::unordered_map<
+		KeyType,
+		size_t,
+		HashType,
+		EqualType,
+		ArenaAllocator<std::pair<const KeyType, size_t>>>;
+
+	// declared first, so the arena is destroyed after all indices allocating from it
+	std::shared_ptr<MemoryArena> m_arena;
+
+	ArenaIndex<std::string> m_nodesIndex;	  // nodes are unique by name
+	ArenaIndex<Id> m_nodeIdIndex;
 	std::vector<StorageNode> m_nodes;
 
-	std::map<StorageFile, size_t> m_filesIndex;	   // this is used to prevent duplicates (unique)
-	std::map<Id, size_t> m_filesIdIndex;
+	ArenaIndex<std::wstring> m_filesIndex;	  // files are unique by path
+	ArenaIndex<Id> m_filesIdIndex;
 	std::vector<StorageFile> m_files;
 
 	std::vector<StorageSymbol> m_symbols;
 
-	std::map<StorageEdgeData, size_t> m_edgesIndex;
+	ArenaIndex<StorageEdgeData, EdgeDataHash, EquivalentByLess> m_edgesIndex;
 	std::vector<StorageEdge> m_edges;
 
-	std::set<StorageLocalSymbol> m_localSymbols;
+	mutable ArenaIndex<StorageLocalSymbolData, LocalSymbolDataHash, EquivalentByLess>
+		m_localSymbolsIndex;
+	mutable std::vector<StorageLocalSymbol> m_localSymbols;
+	mutable bool m_localSymbolsSorted = true;
 
-	std::set<StorageSourceLocation> m_sourceLocations;
+	mutable ArenaIndex<StorageSourceLocationData, SourceLocationDataHash, EquivalentByLess>
+		m_sourceLocationsIndex;
+	mutable std::vector<StorageSourceLocation> m_sourceLocations;
+	mutable bool m_sourceLocationsSorted = true;
 
-	std::set<StorageOccurrence> m_occurrences;
+	mutable std::vector<StorageOccurrence> m_occurrences;
+	mutable bool m_occurrencesSorted = true;
 
-	std::set<StorageComponentAccess> m_componentAccesses;
-	std::set<StorageElementComponent> m_elementComponents;
+	mutable std::vector<StorageComponentAccess> m_componentAccesses;
+	mutable bool m_componentAccessesSorted = true;
 
-	std::map<StorageErrorData, size_t> m_errorsIndex;	 // this is used to prevent duplicates (unique)
+	mutable std::vector<StorageElementComponent> m_elementComponents;
+	mutable bool m_elementComponentsSorted = true;
+
+	// this is used to prevent duplicates (unique)
+	ArenaIndex<StorageErrorData, ErrorDataHash, EquivalentByLess> m_errorsIndex;
 	std::vector<StorageError> m_errors;
 
+	std::vector<StorageIndexingTime> m_indexingTimes;
+
 	Id m_nextId;
 };
 
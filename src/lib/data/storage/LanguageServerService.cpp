@@ -0,0 +1,597 @@
+#include "LanguageServerService.h"
+
+#include <map>
+#include <set>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUrl>
+
+#include "Edge.h"
+#include "Graph.h"
+#include "NodeTypeSet.h"
+#include "SearchMatch.h"
+#include "SourceLocation.h"
+#include "SourceLocationCollection.h"
+#include "SourceLocationFile.h"
+#include "StorageAccess.h"
+#include "logging.h"
+#include "utilityString.h"
+
+namespace
+{
+const int s_parseError = -32700;
+const int s_methodNotFound = -32601;
+const size_t s_maxWorkspaceSymbolCount = 100;
+
+QString toUri(const FilePath& filePath)
+{
+	return QUrl::fromLocalFile(QString::fromStdWString(filePath.wstr())).toString();
+}
+
+FilePath fromUri(const QString& uri)
+{
+	return FilePath(QUrl(uri).toLocalFile().toStdWString());
+}
+
+QJsonObject toPosition(size_t line, size_t character)
+{
+	QJsonObject position;
+	position["line"] = int(line);
+	position["character"] = int(character);
+	return position;
+}
+
+// the index counts lines and columns from 1 and includes the end column, the protocol counts from
+// 0 and excludes the end
+QJsonObject toRange(const SourceLocation* startLocation)
+{
+	const SourceLocation* endLocation = startLocation->getEndLocation();
+	if (!endLocation)
+	{
+		endLocation = startLocation;
+	}
+
+	QJsonObject range;
+	range["start"] = toPosition(
+		startLocation->getLineNumber() - 1, startLocation->getColumnNumber() - 1);
+	range["end"] = toPosition(endLocation->getLineNumber() - 1, endLocation->getColumnNumber());
+	return range;
+}
+
+QJsonObject toLocation(const SourceLocation* startLocation)
+{
+	QJsonObject location;
+	location["uri"] = toUri(startLocation->getFilePath());
+	location["range"] = toRange(startLocation);
+	return location;
+}
+
+bool isInside(const SourceLocation* location, const SourceLocation* scopeLocation)
+{
+	const SourceLocation* scopeEndLocation = scopeLocation->getEndLocation();
+	if (!scopeEndLocation || location->getFilePath() != scopeLocation->getFilePath())
+	{
+		return false;
+	}
+
+	return std::make_pair(scopeLocation->getLineNumber(), scopeLocation->getColumnNumber()) <=
+		std::make_pair(location->getLineNumber(), location->getColumnNumber()) &&
+		std::make_pair(location->getLineNumber(), location->getColumnNumber()) <=
+		std::make_pair(scopeEndLocation->getLineNumber(), scopeEndLocation->getColumnNumber());
+}
+
+bool isTokenLocation(const SourceLocation* location)
+{
+	return location->getType() == LOCATION_TOKEN || location->getType() == LOCATION_QUALIFIER ||
+		location->getType() == LOCATION_UNSOLVED;
+}
+
+int toSymbolKind(const NodeType& nodeType)
+{
+	switch (nodeType.getType())
+	{
+	case NodeType::NODE_FILE:
+		return 1;
+	case NodeType::NODE_MODULE:
+		return 2;
+	case NodeType::NODE_NAMESPACE:
+		return 3;
+	case NodeType::NODE_PACKAGE:
+		return 4;
+	case NodeType::NODE_CLASS:
+	case NodeType::NODE_TYPEDEF:
+		return 5;
+	case NodeType::NODE_METHOD:
+		return 6;
+	case NodeType::NODE_FIELD:
+		return 8;
+	case NodeType::NODE_ENUM:
+		return 10;
+	case NodeType::NODE_INTERFACE:
+	case NodeType::NODE_ANNOTATION:
+		return 11;
+	case NodeType::NODE_FUNCTION:
+		return 12;
+	case NodeType::NODE_GLOBAL_VARIABLE:
+		return 13;
+	case NodeType::NODE_MACRO:
+		return 14;
+	case NodeType::NODE_ENUM_CONSTANT:
+		return 22;
+	case NodeType::NODE_STRUCT:
+	case NodeType::NODE_UNION:
+		return 23;
+	case NodeType::NODE_TYPE_PARAMETER:
+		return 26;
+	default:
+		return 19;
+	}
+}
+
+std::string toMessage(const QJsonObject& object)
+{
+	return QJsonDocument(object).toJson(QJsonDocument::Compact).toStdString();
+}
+
+std::string createErrorMessage(const QJsonValue& id, int code, const std::string& error)
+{
+	QJsonObject errorObject;
+	errorObject["code"] = code;
+	errorObject["message"] = QString::fromStdString(error);
+
+	QJsonObject message;
+	message["jsonrpc"] = "2.0";
+	message["id"] = id;
+	message["error"] = errorObject;
+	return toMessage(message);
+}
+}	 // namespace
+
+bool LanguageServerService::readMessage(std::istream& in, std::string* content)
+{
+	size_t contentLength = 0;
+	bool hasContentLength = false;
+
+	// headers end with an empty line, all but Content-Length are ignored
+	std::string line;
+	while (std::getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+
+		if (line.empty())
+		{
+			if (hasContentLength)
+			{
+				break;
+			}
+			continue;
+		}
+
+		const std::string header = "content-length:";
+		if (utility::toLowerCase(line.substr(0, header.size())) == header)
+		{
+			try
+			{
+				contentLength = std::stoul(utility::trim(line.substr(header.size())));
+				hasContentLength = true;
+			}
+			catch (std::exception&)
+			{
+				LOG_WARNING("Ignoring invalid language server header: " + line);
+			}
+		}
+	}
+
+	if (!hasContentLength)
+	{
+		return false;
+	}
+
+	content->resize(contentLength);
+	in.read(&(*content)[0], std::streamsize(contentLength));
+	return size_t(in.gcount()) == contentLength;
+}
+
+void LanguageServerService::writeMessage(std::ostream& out, const std::string& content)
+{
+	out << "Content-Length: " << content.size() << "\r\n\r\n" << content;
+	out.flush();
+}
+
+int LanguageServerService::run(const StorageAccess* storageAccess, std::istream& in, std::ostream& out)
+{
+	LanguageServerService service(storageAccess);
+
+	std::string content;
+	while (!service.hasReceivedExit() && readMessage(in, &content))
+	{
+		const std::string response = service.answer(content);
+		if (!response.empty())
+		{
+			writeMessage(out, response);
+		}
+	}
+
+	// the client ends the server with shutdown followed by exit, anything else is an error
+	return service.hasReceivedShutdown() ? 0 : 1;
+}
+
+LanguageServerService::LanguageServerService(const StorageAccess* storageAccess)
+	: m_storageAccess(storageAccess)
+{
+}
+
+std::string LanguageServerService::answer(const std::string& content)
+{
+	const QJsonDocument document = QJsonDocument::fromJson(QByteArray::fromStdString(content));
+	if (!document.isObject())
+	{
+		return createErrorMessage(QJsonValue(), s_parseError, "The message is no json object");
+	}
+
+	const QJsonObject message = document.object();
+	const std::string method = message["method"].toString().toStdString();
+	if (method == "exit")
+	{
+		m_receivedExit = true;
+		return "";
+	}
+
+	// notifications like initialized or the changes of open documents don't need an answer
+	if (!message.contains("id"))
+	{
+		return "";
+	}
+
+	QJsonValue result;
+	if (method == "shutdown")
+	{
+		m_receivedShutdown = true;
+	}
+	else
+	{
+		result = answerRequest(method, message["params"].toObject());
+		if (result.isUndefined())
+		{
+			return createErrorMessage(
+				message["id"], s_methodNotFound, "Unsupported method \"" + method + "\"");
+		}
+	}
+
+	QJsonObject response;
+	response["jsonrpc"] = "2.0";
+	response["id"] = message["id"];
+	response["result"] = result;
+	return toMessage(response);
+}
+
+bool LanguageServerService::hasReceivedShutdown() const
+{
+	return m_receivedShutdown;
+}
+
+bool LanguageServerService::hasReceivedExit() const
+{
+	return m_receivedExit;
+}
+
+QJsonValue LanguageServerService::answerRequest(
+	const std::string& method, const QJsonObject& params) const
+{
+	if (method == "initialize")
+	{
+		QJsonObject capabilities;
+		capabilities["textDocumentSync"] = 0;
+		capabilities["definitionProvider"] = true;
+		capabilities["referencesProvider"] = true;
+		capabilities["workspaceSymbolProvider"] = true;
+		capabilities["callHierarchyProvider"] = true;
+
+		QJsonObject serverInfo;
+		serverInfo["name"] = "Sourcetrail";
+
+		QJsonObject result;
+		result["capabilities"] = capabilities;
+		result["serverInfo"] = serverInfo;
+		return result;
+	}
+	else if (method == "textDocument/definition")
+	{
+		return answerDefinition(params);
+	}
+	else if (method == "textDocument/references")
+	{
+		return answerReferences(params);
+	}
+	else if (method == "workspace/symbol")
+	{
+		return answerWorkspaceSymbol(params);
+	}
+	else if (method == "textDocument/prepareCallHierarchy")
+	{
+		return answerPrepareCallHierarchy(params);
+	}
+	else if (method == "callHierarchy/incomingCalls")
+	{
+		return answerCalls(params, true);
+	}
+	else if (method == "callHierarchy/outgoingCalls")
+	{
+		return answerCalls(params, false);
+	}
+
+	return QJsonValue(QJsonValue::Undefined);
+}
+
+QJsonValue LanguageServerService::answerDefinition(const QJsonObject& params) const
+{
+	QJsonArray locations;
+	for (Id nodeId: getNodeIdsAtPosition(params))
+	{
+		for (const QJsonValue& location: getDefinitionLocations(nodeId))
+		{
+			locations.append(location);
+		}
+	}
+	return locations;
+}
+
+QJsonValue LanguageServerService::answerReferences(const QJsonObject& params) const
+{
+	QJsonArray locations;
+	for (Id nodeId: getNodeIdsAtPosition(params))
+	{
+		for (const QJsonValue& location: getReferenceLocations(nodeId))
+		{
+			locations.append(location);
+		}
+	}
+	return locations;
+}
+
+QJsonValue LanguageServerService::answerWorkspaceSymbol(const QJsonObject& params) const
+{
+	QJsonArray symbols;
+
+	const std::wstring query = params["query"].toString().toStdWString();
+	if (query.empty())
+	{
+		return symbols;
+	}
+
+	// matched with the symbol search index, like the search box of the GUI does
+	for (const SearchMatch& match: m_storageAccess->getAutocompletionMatches(
+			 query, NodeTypeSet::all(), false, []() { return false; }))
+	{
+		if (size_t(symbols.size()) >= s_maxWorkspaceSymbolCount)
+		{
+			break;
+		}
+		if (match.tokenIds.empty() || match.tokenNames.empty())
+		{
+			continue;
+		}
+
+		const QJsonArray locations = getDefinitionLocations(match.tokenIds.front());
+		if (locations.isEmpty())
+		{
+			continue;
+		}
+
+		const NameHierarchy& nameHierarchy = match.tokenNames.front();
+
+		QJsonObject symbol;
+		symbol["name"] = QString::fromStdWString(nameHierarchy.getRawName());
+		symbol["kind"] = toSymbolKind(match.nodeType);
+		symbol["location"] = locations.first();
+		if (nameHierarchy.size() > 1)
+		{
+			symbol["containerName"] = QString::fromStdWString(
+				nameHierarchy.getRange(0, nameHierarchy.size() - 1).getQualifiedName());
+		}
+		symbols.append(symbol);
+	}
+	return symbols;
+}
+
+QJsonValue LanguageServerService::answerPrepareCallHierarchy(const QJsonObject& params) const
+{
+	QJsonArray items;
+	for (Id nodeId: getNodeIdsAtPosition(params))
+	{
+		if (m_storageAccess->getNodeTypeForNodeWithId(nodeId).isCallable())
+		{
+			const QJsonObject item = getCallHierarchyItem(nodeId);
+			if (!item.isEmpty())
+			{
+				items.append(item);
+			}
+		}
+	}
+	return items;
+}
+
+QJsonValue LanguageServerService::answerCalls(const QJsonObject& params, bool incoming) const
+{
+	QJsonArray calls;
+
+	// the id was passed along as data of the item by prepareCallHierarchy
+	const Id nodeId = Id(params["item"].toObject().value("data").toObject().value("id").toDouble());
+	if (!nodeId)
+	{
+		return calls;
+	}
+
+	std::shared_ptr<Graph> graph = m_storageAccess->getGraphForTrail(
+		incoming ? 0 : nodeId,
+		incoming ? nodeId : 0,
+		0,
+		Edge::EDGE_CALL | Edge::EDGE_OVERRIDE,
+		false,
+		1,
+		true);
+
+	// protocol ranges of calls are within the caller, which is the item for outgoing calls
+	std::map<Id, std::vector<Id>> otherNodeIdToEdgeIds;
+	graph->forEachEdge([&](Edge* edge) {
+		if (incoming && edge->getTo()->getId() == nodeId)
+		{
+			otherNodeIdToEdgeIds[edge->getFrom()->getId()].push_back(edge->getId());
+		}
+		else if (!incoming && edge->getFrom()->getId() == nodeId)
+		{
+			otherNodeIdToEdgeIds[edge->getTo()->getId()].push_back(edge->getId());
+		}
+	});
+
+	for (const std::pair<const Id, std::vector<Id>>& p: otherNodeIdToEdgeIds)
+	{
+		const QJsonObject item = getCallHierarchyItem(p.first);
+		if (item.isEmpty())
+		{
+			continue;
+		}
+
+		QJsonObject call;
+		call[incoming ? "from" : "to"] = item;
+		call["fromRanges"] = getEdgeRanges(p.second);
+		calls.append(call);
+	}
+	return calls;
+}
+
+std::vector<Id> LanguageServerService::getNodeIdsAtPosition(const QJsonObject& params) const
+{
+	const FilePath filePath = fromUri(params["textDocument"].toObject().value("uri").toString());
+	const QJsonObject position = params["position"].toObject();
+	const size_t line = size_t(position["line"].toInt()) + 1;
+	const size_t column = size_t(position["character"].toInt()) + 1;
+
+	std::vector<Id> locationIds;
+	m_storageAccess->getSourceLocationsForLinesInFile(filePath, line, line)
+		->forEachStartSourceLocation([&](SourceLocation* startLocation) {
+			const SourceLocation* endLocation = startLocation->getEndLocation();
+
+			// a cursor right behind a token still belongs to it
+			if (isTokenLocation(startLocation) && endLocation &&
+				startLocation->getLineNumber() == endLocation->getLineNumber() &&
+				startLocation->getColumnNumber() <= column &&
+				endLocation->getColumnNumber() + 1 >= column)
+			{
+				locationIds.push_back(startLocation->getLocationId());
+			}
+		});
+
+	if (locationIds.empty())
+	{
+		return {};
+	}
+
+	// edges of the tokens are resolved to the symbols they point to
+	return m_storageAccess->getNodeIdsForLocationIds(locationIds);
+}
+
+QJsonArray LanguageServerService::getDefinitionLocations(Id nodeId) const
+{
+	std::vector<const SourceLocation*> scopeLocations;
+	std::vector<const SourceLocation*> tokenLocations;
+
+	std::shared_ptr<SourceLocationCollection> collection =
+		m_storageAccess->getSourceLocationsForTokenIds({nodeId});
+	collection->forEachSourceLocation([&](SourceLocation* location) {
+		if (!location->isStartLocation() || !location->getTokenIds().contains(nodeId))
+		{
+			return;
+		}
+
+		if (location->getType() == LOCATION_SCOPE)
+		{
+			scopeLocations.push_back(location);
+		}
+		else if (isTokenLocation(location))
+		{
+			tokenLocations.push_back(location);
+		}
+	});
+
+	QJsonArray definitions;
+	for (const SourceLocation* tokenLocation: tokenLocations)
+	{
+		for (const SourceLocation* scopeLocation: scopeLocations)
+		{
+			if (isInside(tokenLocation, scopeLocation))
+			{
+				definitions.append(toLocation(tokenLocation));
+				break;
+			}
+		}
+	}
+
+	if (definitions.isEmpty())
+	{
+		for (const SourceLocation* tokenLocation: tokenLocations)
+		{
+			definitions.append(toLocation(tokenLocation));
+		}
+	}
+	return definitions;
+}
+
+QJsonArray LanguageServerService::getReferenceLocations(Id nodeId) const
+{
+	Id declarationId = 0;
+	const std::vector<Id> tokenIds = m_storageAccess->getActiveTokenIdsForId(nodeId, &declarationId);
+
+	QJsonArray references;
+	m_storageAccess->getSourceLocationsForTokenIds(tokenIds)->forEachSourceLocation(
+		[&](SourceLocation* location) {
+			if (location->isStartLocation() && isTokenLocation(location))
+			{
+				references.append(toLocation(location));
+			}
+		});
+	return references;
+}
+
+QJsonArray LanguageServerService::getEdgeRanges(const std::vector<Id>& edgeIds) const
+{
+	QJsonArray ranges;
+	m_storageAccess->getSourceLocationsForTokenIds(edgeIds)->forEachSourceLocation(
+		[&](SourceLocation* location) {
+			if (location->isStartLocation() && isTokenLocation(location))
+			{
+				ranges.append(toRange(location));
+			}
+		});
+	return ranges;
+}
+
+QJsonObject LanguageServerService::getCallHierarchyItem(Id nodeId) const
+{
+	const QJsonArray locations = getDefinitionLocations(nodeId);
+	if (locations.isEmpty())
+	{
+		return QJsonObject();
+	}
+
+	const QJsonObject location = locations.first().toObject();
+	const NameHierarchy nameHierarchy = m_storageAccess->getNameHierarchyForNodeId(nodeId);
+
+	QJsonObject data;
+	data["id"] = double(nodeId);
+
+	QJsonObject item;
+	item["name"] = QString::fromStdWString(nameHierarchy.getRawName());
+	item["detail"] = QString::fromStdWString(nameHierarchy.getQualifiedName());
+	item["kind"] = toSymbolKind(m_storageAccess->getNodeTypeForNodeWithId(nodeId));
+	item["uri"] = location["uri"];
+	item["range"] = location["range"];
+	item["selectionRange"] = location["range"];
+	item["data"] = data;
+	return item;
+}
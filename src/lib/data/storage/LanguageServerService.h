@@ -0,0 +1,69 @@
+#ifndef LANGUAGE_SERVER_SERVICE_H
+#define LANGUAGE_SERVER_SERVICE_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+class QJsonArray;
+class QJsonObject;
+class QJsonValue;
+class StorageAccess;
+
+// Answers the messages of a language server protocol client with the index of a project, so
+// editors can navigate the code without compiling it themselves. Supported requests are
+// initialize, shutdown, textDocument/definition, textDocument/references, workspace/symbol,
+// textDocument/prepareCallHierarchy, callHierarchy/incomingCalls and callHierarchy/outgoingCalls.
+// Positions are looked up in the index, edits of open documents are not taken into account.
+class LanguageServerService
+{
+public:
+	// reads the content of the next message framed with a Content-Length header, returns false at
+	// the end of the stream
+	static bool readMessage(std::istream& in, std::string* content);
+	static void writeMessage(std::ostream& out, const std::string& content);
+
+	// answers all messages of the stream until it ends or the client sends exit, returns the exit
+	// code the protocol asks for
+	static int run(const StorageAccess* storageAccess, std::istream& in, std::ostream& out);
+
+	LanguageServerService(const StorageAccess* storageAccess);
+
+	// returns the json content of the response, which is empty for notifications
+	std::string answer(const std::string& content);
+
+	bool hasReceivedShutdown() const;
+	bool hasReceivedExit() const;
+
+private:
+	QJsonValue answerRequest(const std::string& method, const QJsonObject& params) const;
+
+	QJsonValue answerDefinition(const QJsonObject& params) const;
+	QJsonValue answerReferences(const QJsonObject& params) const;
+	QJsonValue answerWorkspaceSymbol(const QJsonObject& params) const;
+	QJsonValue answerPrepareCallHierarchy(const QJsonObject& params) const;
+	QJsonValue answerCalls(const QJsonObject& params, bool incoming) const;
+
+	// ids of the symbols whose tokens contain the position of a textDocument/* request
+	std::vector<Id> getNodeIdsAtPosition(const QJsonObject& params) const;
+
+	// the name tokens of a symbol within its definitions, or all of its declarations if the
+	// project does not define it
+	QJsonArray getDefinitionLocations(Id nodeId) const;
+	// the tokens of a symbol and of all edges pointing to it, like the code view shows them
+	QJsonArray getReferenceLocations(Id nodeId) const;
+	// the ranges of the tokens of the given edges
+	QJsonArray getEdgeRanges(const std::vector<Id>& edgeIds) const;
+
+	// returns an empty object if the symbol has no location in the project
+	QJsonObject getCallHierarchyItem(Id nodeId) const;
+
+	const StorageAccess* m_storageAccess;
+	bool m_receivedShutdown = false;
+	bool m_receivedExit = false;
+};
+
+#endif	  // LANGUAGE_SERVER_SERVICE_H
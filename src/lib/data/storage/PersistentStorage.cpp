@@ -1,13 +1,23 @@
 #include "PersistentStorage.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <queue>
+#include <regex>
+#include <future>
 #include <sstream>
+#include <unordered_set>
 
 #include "AccessKind.h"
 #include "ApplicationSettings.h"
 #include "ElementComponentKind.h"
 #include "FileInfo.h"
+#include "FileSystem.h"
 #include "FilePath.h"
+#include "FilePathTable.h"
+#include "FullTextSearchRegex.h"
 #include "Graph.h"
 #include "MessageErrorCountUpdate.h"
 #include "MessageStatus.h"
@@ -15,22 +25,54 @@
 #include "ParseLocation.h"
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
+#include "StorageGraphWriter.h"
+#include "TaskManager.h"
 #include "TextAccess.h"
 #include "TextCodec.h"
+#include "TextLayoutMapping.h"
+#include "ThreadPool.h"
 #include "TimeStamp.h"
 #include "TokenComponentAccess.h"
 #include "TokenComponentAggregation.h"
 #include "TokenComponentFilePath.h"
 #include "TokenComponentInheritanceChain.h"
 #include "TokenComponentIsAmbiguous.h"
-#include "UnorderedCache.h"
 #include "logging.h"
 #include "tracing.h"
 #include "utility.h"
-#include "utilityApp.h"
+#include "utilityString.h"
+
+const std::string PersistentStorage::s_symbolShardListName = "symbol_shards";
+const size_t PersistentStorage::s_maxTrailFrontierSize = 50000;
+const size_t PersistentStorage::s_maxActiveChildCount = 100;
+const size_t PersistentStorage::s_partialTrailIntervalMs = 200;
+const size_t PersistentStorage::s_maxSearchNameCandidateCount = 50000;
+const size_t PersistentStorage::s_maxLocationElementIdsFileCount = 8;
+
+namespace
+{
+// versions are unique over all storages, so swapping the storage changes the version as well
+std::atomic<size_t> nextContentVersion(1);
+}	 // namespace
+
+// breadth first search from one end of a trail, either along the edges or against them
+struct PersistentStorage::TrailSearch
+{
+	Id startId = 0;
+	Id goalId = 0;
+	bool forward = true;
+	bool capped = false;
+	size_t depth = 0;
+	std::vector<Id> frontier;
+	std::map<Id, size_t> depths;
+	std::map<Id, std::vector<std::pair<Id, Id>>> parents;	 // parent node id and edge id
+};
 
 PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath)
-	: m_sqliteIndexStorage(dbPath), m_sqliteBookmarkStorage(bookmarkPath)
+	: m_sqliteIndexStorage(dbPath)
+	, m_sqliteBookmarkStorage(bookmarkPath)
+	, m_readStoragePoolEnabled(false)
+	, m_contentVersion(nextContentVersion++)
 {
 	m_commandIndex.addNode(0, SearchMatch::getCommandName(SearchMatch::COMMAND_ALL));
 	m_commandIndex.addNode(0, SearchMatch::getCommandName(SearchMatch::COMMAND_ERROR));
@@ -45,6 +87,18 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 	}
 
 	m_commandIndex.finishSetup();
+
+	// taken once, the caches of a storage are built for one mode only
+	m_lowMemoryMode = ApplicationSettings::getInstance()->getLowMemoryModeEnabled();
+}
+
+PersistentStorage::~PersistentStorage()
+{
+	// the replica is built with this storage, which has to outlive it
+	if (m_indexReplicaBuild.valid())
+	{
+		m_indexReplicaBuild.wait();
+	}
 }
 
 std::pair<Id, bool> PersistentStorage::addNode(const StorageNodeData& data)
@@ -105,7 +159,7 @@ Id PersistentStorage::addLocalSymbol(const StorageLocalSymbolData& data)
 	return m_sqliteIndexStorage.addLocalSymbol(data);
 }
 
-std::vector<Id> PersistentStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> PersistentStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	return m_sqliteIndexStorage.addLocalSymbols(symbols);
 }
@@ -182,73 +236,86 @@ void PersistentStorage::removeElementsWithoutOccurrences(const std::vector<Id>&
 
 const std::vector<StorageNode>& PersistentStorage::getStorageNodes() const
 {
-	return m_storageData.nodes = m_sqliteIndexStorage.getAll<StorageNode>();
+	return m_storageData.nodes = getReadIndexStorage()->getAll<StorageNode>();
 }
 
 const std::vector<StorageFile>& PersistentStorage::getStorageFiles() const
 {
-	return m_storageData.files = m_sqliteIndexStorage.getAll<StorageFile>();
+	return m_storageData.files = getReadIndexStorage()->getAll<StorageFile>();
 }
 
 const std::vector<StorageSymbol>& PersistentStorage::getStorageSymbols() const
 {
-	return m_storageData.symbols = m_sqliteIndexStorage.getAll<StorageSymbol>();
+	return m_storageData.symbols = getReadIndexStorage()->getAll<StorageSymbol>();
 }
 
 const std::vector<StorageEdge>& PersistentStorage::getStorageEdges() const
 {
-	return m_storageData.edges = m_sqliteIndexStorage.getAll<StorageEdge>();
+	return m_storageData.edges = getReadIndexStorage()->getAll<StorageEdge>();
 }
 
-const std::set<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const
+const std::vector<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const
 {
-	return m_storageData.locals = utility::toSet(m_sqliteIndexStorage.getAll<StorageLocalSymbol>());
+	return m_storageData.locals = getReadIndexStorage()->getAll<StorageLocalSymbol>();
 }
 
-const std::set<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const
+const std::vector<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const
 {
-	return m_storageData.locations = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageSourceLocation>());
+	return m_storageData.locations = getReadIndexStorage()->getAll<StorageSourceLocation>();
 }
 
-const std::set<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const
+const std::vector<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const
 {
-	return m_storageData.occurrences = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageOccurrence>());
+	return m_storageData.occurrences = getReadIndexStorage()->getAll<StorageOccurrence>();
 }
 
-const std::set<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const
+const std::vector<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const
 {
-	return m_storageData.accesses = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageComponentAccess>());
+	return m_storageData.accesses = getReadIndexStorage()->getAll<StorageComponentAccess>();
 }
 
-const std::set<StorageElementComponent>& PersistentStorage::getElementComponents() const
+const std::vector<StorageElementComponent>& PersistentStorage::getElementComponents() const
 {
-	return m_storageData.components = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageElementComponent>());
+	return m_storageData.components = getReadIndexStorage()->getAll<StorageElementComponent>();
 }
 
 const std::vector<StorageError>& PersistentStorage::getErrors() const
 {
 	std::vector<StorageError> errors;
-	for (const StorageError& error: m_sqliteIndexStorage.getAll<StorageError>())
+	for (const StorageError& error: getReadIndexStorage()->getAll<StorageError>())
 	{
 		errors.emplace_back(error);
 	}
 	return m_storageData.errors = errors;
 }
 
+void PersistentStorage::addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes)
+{
+	m_sqliteIndexStorage.addIndexingTimes(indexingTimes);
+}
+
+std::vector<StorageIndexingTime> PersistentStorage::getIndexingTimes() const
+{
+	return getReadIndexStorage()->getIndexingTimes();
+}
+
 void PersistentStorage::startInjection()
 {
+	dropIndexReplica();
 	beforeErrorRecording();
 
-	m_sqliteIndexStorage.beginTransaction();
+	if (!m_injectionGroupStarted)
+	{
+		m_sqliteIndexStorage.beginTransaction();
+	}
 }
 
 void PersistentStorage::finishInjection()
 {
-	m_sqliteIndexStorage.commitTransaction();
+	if (!m_injectionGroupStarted)
+	{
+		m_sqliteIndexStorage.commitTransaction();
+	}
 
 	afterErrorRecording();
 }
@@ -260,6 +327,55 @@ void PersistentStorage::rollbackInjection()
 	afterErrorRecording();
 }
 
+bool PersistentStorage::injectDatabase(const FilePath& dbFilePath)
+{
+	beforeErrorRecording();
+	const bool success = m_sqliteIndexStorage.injectDatabase(dbFilePath);
+	afterErrorRecording();
+	return success;
+}
+
+void PersistentStorage::startInjectionGroup()
+{
+	if (!m_injectionGroupStarted)
+	{
+		m_sqliteIndexStorage.beginTransaction();
+		m_injectionGroupStarted = true;
+	}
+}
+
+void PersistentStorage::finishInjectionGroup()
+{
+	if (m_injectionGroupStarted)
+	{
+		m_sqliteIndexStorage.commitTransaction();
+		m_injectionGroupStarted = false;
+	}
+}
+
+void PersistentStorage::startRefreshTransaction()
+{
+	m_sqliteIndexStorage.beginTransaction();
+	m_sqliteIndexStorage.startRecordingChanges();
+}
+
+std::vector<Id> PersistentStorage::finishRefreshTransaction(bool keepChanges)
+{
+	std::vector<Id> changedElementIds;
+	if (keepChanges)
+	{
+		changedElementIds = m_sqliteIndexStorage.getRecordedChangedElementIds();
+		m_sqliteIndexStorage.stopRecordingChanges();
+		m_sqliteIndexStorage.commitTransaction();
+	}
+	else
+	{
+		m_sqliteIndexStorage.stopRecordingChanges();
+		m_sqliteIndexStorage.rollbackTransaction();
+	}
+	return changedElementIds;
+}
+
 void PersistentStorage::beforeErrorRecording()
 {
 	m_preInjectionErrorCount = m_sqliteIndexStorage.getErrorCount();
@@ -286,9 +402,63 @@ void PersistentStorage::afterErrorRecording()
 
 void PersistentStorage::setMode(const SqliteIndexStorage::StorageModeType mode)
 {
+	if (mode != SqliteIndexStorage::STORAGE_MODE_READ)
+	{
+		dropIndexReplica();
+	}
 	m_sqliteIndexStorage.setMode(mode);
 }
 
+void PersistentStorage::applyStorageSettings(
+	const SqliteStorageSettings& indexSettings, const SqliteStorageSettings& bookmarkSettings)
+{
+	m_sqliteIndexStorage.applySettings(indexSettings);
+	m_sqliteBookmarkStorage.applySettings(bookmarkSettings);
+
+	m_indexStorageSettings = indexSettings;
+	m_readStoragePoolEnabled = utility::toUpperCase(indexSettings.journalMode) == "WAL";
+}
+
+void PersistentStorage::checkpoint()
+{
+	// leaving wal mode fails while other connections are open
+	m_readStoragePoolEnabled = false;
+	if (m_readStoragePool)
+	{
+		m_readStoragePool->clear();
+	}
+
+	m_sqliteIndexStorage.checkpoint();
+}
+
+void PersistentStorage::setReadConnectionCount(size_t count)
+{
+	m_readStoragePool.reset();
+	if (count > 0)
+	{
+		m_readStoragePool = std::make_unique<SqliteIndexStoragePool>(
+			m_sqliteIndexStorage.getDbFilePath(), count, m_indexStorageSettings);
+	}
+}
+
+SqliteIndexStoragePool::ScopedStorage PersistentStorage::getReadIndexStorage() const
+{
+	if (m_readStoragePool && m_readStoragePoolEnabled && !m_sqliteIndexStorage.isInTransaction())
+	{
+		SqliteIndexStoragePool::ScopedStorage storage = m_readStoragePool->acquire();
+		if (storage)
+		{
+			return storage;
+		}
+	}
+	return SqliteIndexStoragePool::ScopedStorage(&m_sqliteIndexStorage);
+}
+
+void PersistentStorage::setCacheSnapshotFilePath(const FilePath& filePath)
+{
+	m_cacheSnapshotFilePath = filePath;
+}
+
 FilePath PersistentStorage::getIndexDbFilePath() const
 {
 	return m_sqliteIndexStorage.getDbFilePath();
@@ -301,17 +471,17 @@ FilePath PersistentStorage::getBookmarkDbFilePath() const
 
 bool PersistentStorage::isEmpty() const
 {
-	return m_sqliteIndexStorage.isEmpty();
+	return getReadIndexStorage()->isEmpty();
 }
 
 bool PersistentStorage::isIncompatible() const
 {
-	return m_sqliteIndexStorage.isIncompatible();
+	return getReadIndexStorage()->isIncompatible();
 }
 
 std::string PersistentStorage::getProjectSettingsText() const
 {
-	return m_sqliteIndexStorage.getProjectSettingsText();
+	return getReadIndexStorage()->getProjectSettingsText();
 }
 
 void PersistentStorage::setProjectSettingsText(std::string text)
@@ -319,8 +489,44 @@ void PersistentStorage::setProjectSettingsText(std::string text)
 	m_sqliteIndexStorage.setProjectSettingsText(text);
 }
 
+std::string PersistentStorage::getRevision() const
+{
+	return getReadIndexStorage()->getRevision();
+}
+
+void PersistentStorage::setRevision(const std::string& revision)
+{
+	m_sqliteIndexStorage.setRevision(revision);
+}
+
+std::string PersistentStorage::getDeltaBaseRevision() const
+{
+	return getReadIndexStorage()->getDeltaBaseRevision();
+}
+
+void PersistentStorage::setDeltaBaseRevision(const std::string& revision)
+{
+	m_sqliteIndexStorage.setDeltaBaseRevision(revision);
+}
+
+std::vector<FilePath> PersistentStorage::getDeltaClearedFilePaths() const
+{
+	return getReadIndexStorage()->getDeltaClearedFilePaths();
+}
+
+void PersistentStorage::setDeltaClearedFilePaths(const std::vector<FilePath>& filePaths)
+{
+	m_sqliteIndexStorage.setDeltaClearedFilePaths(filePaths);
+}
+
+void PersistentStorage::setIndexingPhaseDurations(const std::map<std::string, float>& durations)
+{
+	m_sqliteIndexStorage.setIndexingPhaseDurations(durations);
+}
+
 void PersistentStorage::setup()
 {
+	m_sqliteIndexStorage.migrateIfNecessary();
 	m_sqliteIndexStorage.setup();
 	m_sqliteBookmarkStorage.setup();
 
@@ -345,7 +551,19 @@ void PersistentStorage::clear()
 
 void PersistentStorage::clearCaches()
 {
-	m_symbolIndex.clear();
+	// stored file contents of older content versions age out of the FileContentCache
+	m_contentVersion = nextContentVersion++;
+
+	{
+		std::lock_guard<std::mutex> lock(m_locationElementIdsMutex);
+		m_locationElementIds.clear();
+	}
+	dropIndexReplica();
+
+	{
+		std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+		m_symbolIndexShards.clear();
+	}
 	m_fileIndex.clear();
 
 	m_fileNodeIds.clear();
@@ -357,6 +575,11 @@ void PersistentStorage::clearCaches()
 	m_symbolDefinitionKinds.clear();
 
 	m_hierarchyCache.clear();
+	m_adjacencyCache.clear();
+	m_aggregationCache.clear();
+	m_fileReachabilityIndex.clear();
+	m_hasFileReachabilityIndex = false;
+	m_overviewSummary.clear();
 	m_fullTextSearchIndex.clear();
 	m_fullTextSearchCodec = "";
 }
@@ -364,25 +587,73 @@ void PersistentStorage::clearCaches()
 std::set<FilePath> PersistentStorage::getReferenced(const std::set<FilePath>& filePaths) const
 {
 	TRACE();
-	std::set<FilePath> referenced;
 
-	utility::append(referenced, getReferencedByIncludes(filePaths));
-	utility::append(referenced, getReferencedByImports(filePaths));
+	FileReferenceGraph::IdSet ids;
+	for (const FilePath& filePath: filePaths)
+	{
+		ids.insert(FilePathTable::getInstance()->getId(filePath));
+	}
 
+	std::set<FilePath> referenced;
+	for (const FilePathTable::Id id: getFileReferenceGraph().getReferenced(ids))
+	{
+		referenced.insert(FilePathTable::getInstance()->getPath(id));
+	}
 	return referenced;
 }
 
 std::set<FilePath> PersistentStorage::getReferencing(const std::set<FilePath>& filePaths) const
 {
 	TRACE();
-	std::set<FilePath> referencing;
 
-	utility::append(referencing, getReferencingByIncludes(filePaths));
-	utility::append(referencing, getReferencingByImports(filePaths));
+	FileReferenceGraph::IdSet ids;
+	for (const FilePath& filePath: filePaths)
+	{
+		ids.insert(FilePathTable::getInstance()->getId(filePath));
+	}
 
+	std::set<FilePath> referencing;
+	for (const FilePathTable::Id id: getFileReferenceGraph().getReferencing(ids))
+	{
+		referencing.insert(FilePathTable::getInstance()->getPath(id));
+	}
 	return referencing;
 }
 
+FileReferenceGraph PersistentStorage::getFileReferenceGraph() const
+{
+	TRACE();
+
+	FilePathTable* pathTable = FilePathTable::getInstance();
+	const auto getPathId = [this, pathTable](uint64_t fileNodeId) {
+		return uint64_t(pathTable->getId(getFileNodePath(Id(fileNodeId))));
+	};
+
+	if (m_hasFileReachabilityIndex)
+	{
+		return FileReferenceGraph::fromIndex(m_fileReachabilityIndex.withIds(getPathId));
+	}
+	return FileReferenceGraph::fromIndex(
+		FileReachabilityIndex(getFileReferences()).withIds(getPathId));
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> PersistentStorage::getFileReferences() const
+{
+	std::vector<std::pair<uint64_t, uint64_t>> references;
+	auto addReferences = [&references](const std::unordered_map<Id, std::set<Id>>& referencingMap) {
+		for (const auto& it: referencingMap)
+		{
+			for (const Id referencingFileNodeId: it.second)
+			{
+				references.emplace_back(uint64_t(referencingFileNodeId), uint64_t(it.first));
+			}
+		}
+	};
+	addReferences(getFileIdToIncludingFileIdMap());
+	addReferences(getFileIdToImportingFileIdMap());
+	return references;
+}
+
 void PersistentStorage::clearAllErrors()
 {
 	TRACE();
@@ -403,6 +674,7 @@ void PersistentStorage::clearFileElements(
 
 	if (!fileNodeIds.empty())
 	{
+		dropIndexReplica();
 		m_sqliteIndexStorage.beginTransaction();
 		m_sqliteIndexStorage.removeElementsWithLocationInFiles(fileNodeIds, updateStatusCallback);
 		m_sqliteIndexStorage.removeElements(fileNodeIds);
@@ -417,7 +689,7 @@ std::vector<FileInfo> PersistentStorage::getFileInfoForAllFiles() const
 
 	std::vector<FileInfo> fileInfos;
 
-	m_sqliteIndexStorage.forEach<StorageFile>([&](StorageFile&& file) {
+	getReadIndexStorage()->forEach<StorageFile>([&](StorageFile&& file) {
 		boost::posix_time::ptime modificationTime = boost::posix_time::not_a_date_time;
 		if (file.modificationTime != "not-a-date-time")
 		{
@@ -463,10 +735,239 @@ void PersistentStorage::buildCaches()
 
 	clearCaches();
 
+	// the search index is kept within the database and is only read on demand
+	StorageCacheSnapshot snapshot;
+	if (!m_cacheSnapshotFilePath.empty() &&
+		snapshot.load(m_cacheSnapshotFilePath, getCacheSnapshotStamp()))
+	{
+		LOG_INFO(L"Loading caches from snapshot \"" + m_cacheSnapshotFilePath.wstr() + L"\"");
+		loadCacheSnapshot(snapshot);
+		buildSearchIndex();
+		return;
+	}
+
 	buildFilePathMaps();
+	buildSymbolDefinitionKindMap();
+
+	// the phases after the file path maps are independent, each one getting a read connection of
+	// its own runs in parallel to the search index, which may write to the database
+	std::vector<StorageCacheSnapshot::HierarchyEdge> hierarchyEdges;
+	const std::vector<std::function<void(const SqliteIndexStoragePool::ScopedStorage&)>> phases = {
+		[this](const SqliteIndexStoragePool::ScopedStorage& storage) {
+			buildMemberEdgeIdOrderMap(storage);
+		},
+		[this, &hierarchyEdges](const SqliteIndexStoragePool::ScopedStorage& storage) {
+			hierarchyEdges = getHierarchyEdges(storage);
+			buildHierarchyCache(hierarchyEdges);
+		},
+		[this](const SqliteIndexStoragePool::ScopedStorage& storage) {
+			buildAdjacencyCache(storage);
+		}};
+
+	std::vector<std::future<void>> jobs;
+	std::vector<size_t> remainingPhaseIndices;
+	for (size_t i = 0; i < phases.size(); i++)
+	{
+		std::shared_ptr<SqliteIndexStoragePool::ScopedStorage> storage =
+			std::make_shared<SqliteIndexStoragePool::ScopedStorage>(getReadIndexStorage());
+		if (storage->isPooled())
+		{
+			jobs.push_back(TaskManager::getThreadPool()->runBlocking(
+				[phase = phases[i], storage]() { phase(*storage); }));
+		}
+		else
+		{
+			remainingPhaseIndices.push_back(i);
+		}
+	}
+
 	buildSearchIndex();
-	buildMemberEdgeIdOrderMap();
-	buildHierarchyCache();
+
+	const SqliteIndexStoragePool::ScopedStorage storage(&m_sqliteIndexStorage);
+	for (size_t i: remainingPhaseIndices)
+	{
+		phases[i](storage);
+	}
+	for (std::future<void>& job: jobs)
+	{
+		job.wait();
+	}
+
+	buildAggregationCache();
+	buildFileReachabilityIndex();
+	buildOverviewSummary();
+
+	// saved last, the search index may have been stored to the database before
+	if (!m_cacheSnapshotFilePath.empty())
+	{
+		createCacheSnapshot(hierarchyEdges).save(m_cacheSnapshotFilePath, getCacheSnapshotStamp());
+	}
+}
+
+void PersistentStorage::buildCaches(
+	const PersistentStorage& previousStorage, const std::vector<Id>& changedElementIds)
+{
+	TRACE();
+
+	// the refresh cleared the stored search index, shards that were not loaded before are gone
+	SymbolIndexShards previousShards;
+	std::vector<Id> recentNodeIds;
+	{
+		std::lock_guard<std::mutex> lock(previousStorage.m_symbolIndexShardsMutex);
+		previousShards = previousStorage.m_symbolIndexShards;
+		recentNodeIds = previousStorage.m_recentNodeIds;
+	}
+	const bool canTakeCaches = !previousStorage.m_adjacencyCache.isEmpty() &&
+		!previousShards.empty() &&
+		std::all_of(
+			previousShards.begin(),
+			previousShards.end(),
+			[](const std::shared_ptr<SymbolIndexShard>& shard) { return shard->loaded; });
+	if (!canTakeCaches)
+	{
+		buildCaches();
+		return;
+	}
+
+	LOG_INFO(
+		"Taking the caches of the previous storage, " + std::to_string(changedElementIds.size()) +
+		" elements changed");
+
+	clearCaches();
+
+	const std::set<Id> changedIds(changedElementIds.begin(), changedElementIds.end());
+	const SqliteIndexStoragePool::ScopedStorage storage(&m_sqliteIndexStorage);
+
+	// files are few compared to the symbols, so they are all read again
+	buildFilePathMaps();
+
+	m_symbolDefinitionKinds = previousStorage.m_symbolDefinitionKinds;
+	for (Id id: changedElementIds)
+	{
+		m_symbolDefinitionKinds.erase(id);
+	}
+	for (const StorageSymbol& symbol: storage->getAllByIds<StorageSymbol>(changedElementIds))
+	{
+		m_symbolDefinitionKinds.emplace(symbol.id, intToDefinitionKind(symbol.definitionKind));
+	}
+
+	buildMemberEdgeIdOrderMap(storage);
+
+	// the kept edges neither are nor touch a changed element, all others are read again
+	const auto isChanged = [&changedIds](Id id) { return changedIds.find(id) != changedIds.end(); };
+	std::vector<StorageCacheSnapshot::HierarchyEdge> hierarchyEdges;
+	previousStorage.m_hierarchyCache.forEachConnection(
+		[&](Id edgeId,
+			Id fromId,
+			Id toId,
+			bool sourceVisible,
+			bool sourceImplicit,
+			bool targetImplicit) {
+			if (!isChanged(edgeId) && !isChanged(fromId) && !isChanged(toId))
+			{
+				hierarchyEdges.push_back(
+					{uint64_t(edgeId),
+					 uint64_t(fromId),
+					 uint64_t(toId),
+					 (sourceVisible ? StorageCacheSnapshot::EDGE_SOURCE_VISIBLE : 0u) |
+						 (sourceImplicit ? StorageCacheSnapshot::EDGE_SOURCE_IMPLICIT : 0u) |
+						 (targetImplicit ? StorageCacheSnapshot::EDGE_TARGET_IMPLICIT : 0u)});
+			}
+		});
+	previousStorage.m_hierarchyCache.forEachInheritance([&](Id edgeId, Id fromId, Id toId) {
+		if (!isChanged(edgeId) && !isChanged(fromId) && !isChanged(toId))
+		{
+			hierarchyEdges.push_back(
+				{uint64_t(edgeId),
+				 uint64_t(fromId),
+				 uint64_t(toId),
+				 StorageCacheSnapshot::EDGE_INHERITANCE});
+		}
+	});
+	utility::append(hierarchyEdges, getHierarchyEdges(storage, &changedElementIds));
+	buildHierarchyCache(hierarchyEdges);
+
+	std::vector<std::pair<Id, int>> nodeTypes;
+	storage->forEachRowByIds<Id, int>(
+		changedElementIds, "SELECT id, type FROM node WHERE id IN", [&nodeTypes](Id id, int type) {
+			nodeTypes.emplace_back(id, type);
+		});
+	m_adjacencyCache.build(
+		previousStorage.m_adjacencyCache,
+		changedIds,
+		nodeTypes,
+		storage->getAllByIds<StorageEdge>(changedElementIds));
+	buildAggregationCache();
+	buildFileReachabilityIndex();
+	buildOverviewSummary();
+
+	buildFileIndex();
+
+	// changed edges also changed their targets, so these get their reference counts again
+	std::unordered_map<Id, uint32_t> referenceCounts;
+	storage->forEachRowByIds<Id, int>(
+		changedElementIds,
+		"SELECT target_node_id, type FROM edge WHERE target_node_id IN",
+		[&referenceCounts](Id targetNodeId, int edgeType) {
+			if (Edge::intToType(edgeType) != Edge::EDGE_MEMBER)
+			{
+				referenceCounts[targetNodeId]++;
+			}
+		});
+
+	SymbolIndexShardMap shards;
+	for (const std::shared_ptr<SymbolIndexShard>& previousShard: previousShards)
+	{
+		std::shared_ptr<SymbolIndexShard> shard = std::make_shared<SymbolIndexShard>();
+		shard->name = previousShard->name;
+		shard->loaded = true;
+		shard->index.addNodes(previousShard->index, changedIds);
+		shards.emplace(shard->name, shard);
+	}
+	storage->forEachRowByIds<Id, int, SqliteIndexStorage::ColumnText>(
+		changedElementIds,
+		"SELECT id, type, serialized_name FROM node WHERE id IN",
+		[&](Id nodeId, int nodeType, const SqliteIndexStorage::ColumnText& serializedName) {
+			auto referenceIt = referenceCounts.find(nodeId);
+			addSymbolToIndexShards(
+				nodeId,
+				nodeType,
+				serializedName.str(),
+				referenceIt != referenceCounts.end() ? referenceIt->second : 0,
+				&shards);
+		});
+
+	{
+		std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+		m_recentNodeIds = recentNodeIds;
+	}
+	const SymbolIndexShards builtShards = storeSymbolIndexShards(shards);
+	{
+		std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+		m_symbolIndexShards = builtShards;
+	}
+
+	if (!m_cacheSnapshotFilePath.empty())
+	{
+		createCacheSnapshot(hierarchyEdges).save(m_cacheSnapshotFilePath, getCacheSnapshotStamp());
+	}
+}
+
+void PersistentStorage::loadSearchIndex() const
+{
+	getLoadedSymbolIndexShards(NodeTypeSet::all());
+}
+
+void PersistentStorage::clearSearchIndexData()
+{
+	m_sqliteIndexStorage.clearSearchIndexData();
+}
+
+void PersistentStorage::canonicalizeIds()
+{
+	TRACE();
+
+	m_sqliteIndexStorage.canonicalizeIds();
 }
 
 void PersistentStorage::optimizeMemory()
@@ -474,11 +975,97 @@ void PersistentStorage::optimizeMemory()
 	TRACE();
 
 	m_sqliteIndexStorage.setTime();
+	m_sqliteIndexStorage.removeUnreferencedFileContents();
 	m_sqliteIndexStorage.optimizeMemory();
 
 	m_sqliteBookmarkStorage.optimizeMemory();
 }
 
+bool PersistentStorage::exportSnapshot(
+	const FilePath& dbFilePath, const FilePath& cacheSnapshotFilePath)
+{
+	TRACE();
+
+	// the search index got stored by buildCaches, the fulltext data is added here
+	updateFullTextSearchIndex();
+
+	checkpoint();
+	if (!FileSystem::copyFile(getIndexDbFilePath(), dbFilePath))
+	{
+		LOG_ERROR(L"Could not copy the index database to \"" + dbFilePath.wstr() + L"\"");
+		return false;
+	}
+
+	const std::string stamp = TimeStamp::now().toString() + " " +
+		StorageCacheSnapshot::getDatabaseStamp(getIndexDbFilePath());
+	{
+		SqliteIndexStorage snapshotStorage(dbFilePath);
+		snapshotStorage.setSnapshotStamp(stamp);
+		// rewrites all tables in rowid order and drops the free pages
+		snapshotStorage.optimizeMemory();
+	}
+
+	return createCacheSnapshot(getHierarchyEdges(getReadIndexStorage()))
+		.save(cacheSnapshotFilePath, "snapshot " + stamp);
+}
+
+void PersistentStorage::exportGraph(Edge::TypeMask edgeTypes, StorageGraphWriter* writer) const
+{
+	TRACE();
+
+	std::string typeList;
+	for (Edge::TypeMask mask = 1; mask <= Edge::EDGE_MAX_VALUE; mask *= 2)
+	{
+		if (edgeTypes & mask)
+		{
+			typeList += (typeList.empty() ? "" : ",") +
+				std::to_string(Edge::typeToInt(Edge::intToType(mask)));
+		}
+	}
+
+	writer->writeHeader();
+	if (!typeList.empty())
+	{
+		SqliteIndexStoragePool::ScopedStorage storage = getReadIndexStorage();
+		const std::string edgeQuery = "FROM edge WHERE type IN (" + typeList + ");";
+
+		// only the ids of the connected nodes are kept, the rows are written as they are read
+		std::unordered_set<Id> nodeIds;
+		storage->forEachRow<Id, Id>(
+			"SELECT source_node_id, target_node_id " + edgeQuery,
+			[&nodeIds](Id sourceNodeId, Id targetNodeId) {
+				nodeIds.insert(sourceNodeId);
+				nodeIds.insert(targetNodeId);
+			});
+
+		storage->forEachRow<Id, int, SqliteIndexStorage::ColumnText>(
+			"SELECT id, type, serialized_name FROM node;",
+			[&](Id nodeId, int nodeType, const SqliteIndexStorage::ColumnText& serializedName) {
+				if (nodeIds.find(nodeId) != nodeIds.end())
+				{
+					const NameHierarchy nameHierarchy = NameHierarchy::deserializeFromBinary(
+						serializedName.str());
+					writer->writeNode(
+						nodeId,
+						NodeType(NodeType::intToType(nodeType)),
+						nameHierarchy.getQualifiedName());
+				}
+			});
+
+		storage->forEachRow<Id, int, Id, Id>(
+			"SELECT id, type, source_node_id, target_node_id " + edgeQuery,
+			[writer](Id edgeId, int edgeType, Id sourceNodeId, Id targetNodeId) {
+				writer->writeEdge(edgeId, Edge::intToType(edgeType), sourceNodeId, targetNodeId);
+			});
+	}
+	writer->writeFooter();
+}
+
+size_t PersistentStorage::getContentVersion() const
+{
+	return m_contentVersion;
+}
+
 Id PersistentStorage::getNodeIdForFileNode(const FilePath& filePath) const
 {
 	return getFileNodeId(filePath);
@@ -486,19 +1073,34 @@ Id PersistentStorage::getNodeIdForFileNode(const FilePath& filePath) const
 
 Id PersistentStorage::getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const
 {
-	return m_sqliteIndexStorage.getNodeBySerializedName(NameHierarchy::serialize(nameHierarchy)).id;
+	return m_sqliteIndexStorage
+		.getNodeBySerializedName(NameHierarchy::serializeToBinary(nameHierarchy))
+		.id;
 }
 
 std::vector<Id> PersistentStorage::getNodeIdsForNameHierarchies(
 	const std::vector<NameHierarchy> nameHierarchies) const
 {
-	std::vector<Id> nodeIds;
+	std::vector<std::string> serializedNames;
 	for (const NameHierarchy& name: nameHierarchies)
 	{
-		Id nodeId = getNodeIdForNameHierarchy(name);
-		if (nodeId)
+		serializedNames.push_back(NameHierarchy::serializeToBinary(name));
+	}
+
+	// the nodes are looked up in batches, the ids are returned in the order of the names
+	std::unordered_map<std::string, Id> nameToId;
+	for (const StorageNode& node: m_sqliteIndexStorage.getNodesBySerializedNames(serializedNames))
+	{
+		nameToId.emplace(node.serializedName, node.id);
+	}
+
+	std::vector<Id> nodeIds;
+	for (const std::string& serializedName: serializedNames)
+	{
+		auto it = nameToId.find(serializedName);
+		if (it != nameToId.end())
 		{
-			nodeIds.push_back(nodeId);
+			nodeIds.push_back(it->second);
 		}
 	}
 	return nodeIds;
@@ -508,8 +1110,8 @@ NameHierarchy PersistentStorage::getNameHierarchyForNodeId(Id nodeId) const
 {
 	TRACE();
 
-	return NameHierarchy::deserialize(
-		m_sqliteIndexStorage.getFirstById<StorageNode>(nodeId).serializedName);
+	return NameHierarchy::deserializeFromBinary(
+		getStorageNodeById(nodeId).serializedName);
 }
 
 std::vector<NameHierarchy> PersistentStorage::getNameHierarchiesForNodeIds(
@@ -518,9 +1120,9 @@ std::vector<NameHierarchy> PersistentStorage::getNameHierarchiesForNodeIds(
 	TRACE();
 
 	std::vector<NameHierarchy> nameHierarchies;
-	for (const StorageNode& storageNode: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+	for (const StorageNode& storageNode: getStorageNodesByIds(nodeIds))
 	{
-		nameHierarchies.push_back(NameHierarchy::deserialize(storageNode.serializedName));
+		nameHierarchies.push_back(NameHierarchy::deserializeFromBinary(storageNode.serializedName));
 	}
 	return nameHierarchies;
 }
@@ -530,10 +1132,24 @@ std::map<Id, std::pair<Id, NameHierarchy>> PersistentStorage::getNodeIdToParentF
 {
 	std::map<Id, std::pair<Id, NameHierarchy>> nodeIdToParentFileMap;
 
-	std::shared_ptr<SourceLocationCollection> locations =
-		m_sqliteIndexStorage.getSourceLocationsForElementIds(nodeIds);
-
-	// prefer scope locations if available
+	std::map<Id, Id> fileNodeIds;
+	if (getReadIndexStorage()->getFileNodeIdsOfNodes(nodeIds, &fileNodeIds))
+	{
+		for (const std::pair<Id, Id>& p: fileNodeIds)
+		{
+			nodeIdToParentFileMap.emplace(
+				p.first,
+				std::make_pair(
+					p.second,
+					NameHierarchy(getFileNodePath(p.second).wstr(), NAME_DELIMITER_FILE)));
+		}
+		return nodeIdToParentFileMap;
+	}
+
+	std::shared_ptr<SourceLocationCollection> locations =
+		getReadIndexStorage()->getSourceLocationsForElementIds(nodeIds);
+
+	// prefer scope locations if available
 	locations->forEachSourceLocation([this, &nodeIdToParentFileMap](SourceLocation* location) {
 		if (location->isStartLocation() && location->isScopeLocation())
 		{
@@ -573,16 +1189,25 @@ std::map<Id, std::pair<Id, NameHierarchy>> PersistentStorage::getNodeIdToParentF
 
 NodeType PersistentStorage::getNodeTypeForNodeWithId(Id nodeId) const
 {
-	return NodeType::intToType(m_sqliteIndexStorage.getFirstById<StorageNode>(nodeId).type);
+	return NodeType::intToType(getStorageNodeById(nodeId).type);
 }
 
 StorageEdge PersistentStorage::getEdgeById(Id edgeId) const
 {
-	return m_sqliteIndexStorage.getEdgeById(edgeId);
+	if (m_adjacencyCache.isEmpty())
+	{
+		return getReadIndexStorage()->getEdgeById(edgeId);
+	}
+
+	StorageEdge edge;
+	m_adjacencyCache.getEdgeById(edgeId, &edge);
+	return edge;
 }
 
 std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLocations(
-	const std::wstring& searchTerm, bool caseSensitive) const
+	const std::wstring& searchTerm,
+	bool caseSensitive,
+	std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback) const
 {
 	TRACE();
 
@@ -611,81 +1236,231 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLo
 		true)
 		.dispatch();
 
+	const bool isRegex = FullTextSearchRegex::isRegexTerm(searchTerm);
+
+	std::wregex regex;
+	std::vector<FullTextSearchResult> fileResults;
+	if (isRegex)
+	{
+		try
+		{
+			regex = std::wregex(
+				FullTextSearchRegex::getPattern(searchTerm),
+				caseSensitive ? std::regex_constants::ECMAScript
+							  : std::regex_constants::ECMAScript | std::regex_constants::icase);
+		}
+		catch (std::regex_error& e)
+		{
+			LOG_WARNING(std::string("Invalid regular expression for fulltext search: ") + e.what());
+			MessageStatus(
+				L"Invalid regular expression for fulltext search: " + searchTerm, true, false)
+				.dispatch();
+			return collection;
+		}
+
+		// candidate lines contain the literal part of the pattern, otherwise all lines are checked
+		const std::wstring literal = FullTextSearchRegex::getRequiredLiteral(
+			FullTextSearchRegex::getPattern(searchTerm));
+		if (literal.empty())
+		{
+			for (Id fileId: m_fullTextSearchIndex.getFileIds())
+			{
+				FullTextSearchResult fileResult;
+				fileResult.fileId = fileId;
+				fileResults.push_back(fileResult);
+			}
+		}
+		else
+		{
+			fileResults = m_fullTextSearchIndex.searchForTerm(literal);
+		}
+	}
+	else
 	{
-		std::vector<std::shared_ptr<std::thread>> threads;
-		std::mutex collectionMutex;
-		for (std::vector<FullTextSearchResult> fileResults: utility::splitToEqualySizedParts(
-				 m_fullTextSearchIndex.searchForTerm(searchTerm), utility::getIdealThreadCount()))
-		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[this,
-				 &searchTerm,
-				 &caseSensitive,
-				 &codec,
-				 /*no ref here!*/ fileResults,
-				 &collection,
-				 &collectionMutex]() {
-					const int termLength = searchTerm.length();
-					for (const FullTextSearchResult& fileResult: fileResults)
+		fileResults = m_fullTextSearchIndex.searchForTerm(searchTerm);
+	}
+
+	// returns the matches within the file of the given result that fulfill all search criteria
+	const std::function<std::vector<ParseLocation>(const FullTextSearchResult&, const FilePath&)>
+		verifyFileResult = [&](const FullTextSearchResult& fileResult, const FilePath& filePath) {
+			std::vector<ParseLocation> locations;
+
+			if (isRegex)
+			{
+				std::shared_ptr<const FileContentCache::DecodedContent> fileContent =
+					getDecodedFileContent(
+						filePath, codec, FileContentCache::CONSUMER_FULLTEXT_SEARCH);
+
+				std::vector<size_t> lineNumbers;
+				if (fileResult.locations.empty())
+				{
+					for (size_t i = 1; i <= fileContent->lines.size(); i++)
 					{
-						const FilePath filePath = getFileNodePath(fileResult.fileId);
-						std::shared_ptr<TextAccess> fileContent = getFileContent(filePath, false);
+						lineNumbers.push_back(i);
+					}
+				}
+				for (const ParseLocation& location: fileResult.locations)
+				{
+					if (lineNumbers.empty() || lineNumbers.back() != location.startLineNumber)
+					{
+						lineNumbers.push_back(location.startLineNumber);
+					}
+				}
 
-						int charsTotal = 0;
-						int lineNumber = 1;
-						std::wstring line = codec.decode(fileContent->getLine(lineNumber));
+				for (size_t lineNumber: lineNumbers)
+				{
+					if (lineNumber < 1 || lineNumber > fileContent->lines.size())
+					{
+						continue;
+					}
 
-						for (int pos: fileResult.positions)
+					std::wstring line = fileContent->lines[lineNumber - 1];
+					if (!line.empty() && line.back() == L'\n')
+					{
+						line.pop_back();
+					}
+
+					for (std::wsregex_iterator it(line.begin(), line.end(), regex), end; it != end;
+						 it++)
+					{
+						if (it->length() > 0)
 						{
-							while (charsTotal + (int)line.length() <= pos)
-							{
-								charsTotal += line.length();
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
+							locations.emplace_back(
+								fileResult.fileId,
+								lineNumber,
+								it->position() + 1,
+								lineNumber,
+								it->position() + it->length());
+						}
+					}
+				}
+			}
+			else if (caseSensitive)
+			{
+				// only case-sensitive search needs the original text of matched lines
+				std::shared_ptr<const FileContentCache::DecodedContent> fileContent =
+					getDecodedFileContent(
+						filePath, codec, FileContentCache::CONSUMER_FULLTEXT_SEARCH);
 
-							ParseLocation location;
-							location.startLineNumber = lineNumber;
-							location.startColumnNumber = pos - charsTotal + 1;
+				for (const ParseLocation& location: fileResult.locations)
+				{
+					if (location.startLineNumber < 1 ||
+						location.startLineNumber > fileContent->lines.size())
+					{
+						continue;
+					}
 
-							if (caseSensitive &&
-								line.substr(location.startColumnNumber - 1, termLength) != searchTerm)
-							{
-								continue;
-							}
-							while ((charsTotal + (int)line.length()) < pos + termLength)
-							{
-								charsTotal += line.length();
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
-							location.endLineNumber = lineNumber;
-							location.endColumnNumber = pos + termLength - charsTotal;
+					const std::wstring& decodedLine =
+						fileContent->lines[location.startLineNumber - 1];
+					if (location.startColumnNumber <= decodedLine.size() &&
+						decodedLine.substr(location.startColumnNumber - 1, searchTerm.length()) ==
+							searchTerm)
+					{
+						locations.push_back(location);
+					}
+				}
+			}
+			else
+			{
+				locations = fileResult.locations;
+			}
 
-							{
-								std::lock_guard<std::mutex> lock(collectionMutex);
-								// Set first bit to 1 to avoid collisions
-								const Id locationId = ~(~Id(0) >> 1) +
-									collection->getSourceLocationCount() + 1;
-								collection->addSourceLocation(
-									LOCATION_FULLTEXT_SEARCH,
-									locationId,
-									std::vector<Id>(),
-									filePath,
-									location.startLineNumber,
-									location.startColumnNumber,
-									location.endLineNumber,
-									location.endColumnNumber);
-							}
+			return locations;
+		};
+
+	{
+		// workers take pages of files and hand back one collection per page
+		const size_t filesPerPage = 64;
+		const size_t pageCount = (fileResults.size() + filesPerPage - 1) / filesPerPage;
+		std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+		const size_t threadCount = std::min<size_t>(threadPool->getWorkerCount(), pageCount);
+
+		std::atomic<size_t> nextPageIndex(0);
+		// Set first bit to 1 to avoid collisions
+		std::atomic<Id> nextLocationId(~(~Id(0) >> 1) + 1);
+
+		std::mutex pagesMutex;
+		std::condition_variable pagesCondition;
+		std::deque<std::shared_ptr<SourceLocationCollection>> pages;
+		size_t runningThreadCount = threadCount;
+
+		std::vector<std::future<void>> jobs;
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			jobs.push_back(threadPool->run([&]() {
+				for (size_t pageIndex = nextPageIndex++; pageIndex < pageCount;
+					 pageIndex = nextPageIndex++)
+				{
+					std::shared_ptr<SourceLocationCollection> page =
+						std::make_shared<SourceLocationCollection>();
+
+					const size_t pageEnd = std::min(
+						(pageIndex + 1) * filesPerPage, fileResults.size());
+					for (size_t j = pageIndex * filesPerPage; j < pageEnd; j++)
+					{
+						const FullTextSearchResult& fileResult = fileResults[j];
+						const FilePath filePath = getFileNodePath(fileResult.fileId);
+
+						for (const ParseLocation& location: verifyFileResult(fileResult, filePath))
+						{
+							page->addSourceLocation(
+								LOCATION_FULLTEXT_SEARCH,
+								nextLocationId++,
+								std::vector<Id>(),
+								filePath,
+								location.startLineNumber,
+								location.startColumnNumber,
+								location.endLineNumber,
+								location.endColumnNumber);
 						}
 					}
-				});
-			threads.push_back(thread);
+
+					{
+						std::lock_guard<std::mutex> lock(pagesMutex);
+						pages.push_back(page);
+					}
+					pagesCondition.notify_one();
+				}
+
+				{
+					std::lock_guard<std::mutex> lock(pagesMutex);
+					runningThreadCount--;
+				}
+				pagesCondition.notify_one();
+			}, ThreadPool::PRIORITY_INTERACTIVE));
+		}
+
+		while (true)
+		{
+			std::shared_ptr<SourceLocationCollection> page;
+			{
+				std::unique_lock<std::mutex> lock(pagesMutex);
+				pagesCondition.wait(
+					lock, [&]() { return !pages.empty() || runningThreadCount == 0; });
+
+				if (pages.empty())
+				{
+					break;
+				}
+
+				page = pages.front();
+				pages.pop_front();
+			}
+
+			// each file is part of exactly one page, so files can be shared instead of copied
+			page->forEachSourceLocationFile([&collection](std::shared_ptr<SourceLocationFile> file) {
+				collection->addSourceLocationFile(file);
+			});
+
+			if (partialResultsCallback && page->getSourceLocationCount())
+			{
+				partialResultsCallback(collection);
+			}
 		}
 
-		for (std::shared_ptr<std::thread> thread: threads)
+		for (std::future<void>& job: jobs)
 		{
-			thread->join();
+			job.wait();
 		}
 	}
 
@@ -704,7 +1479,10 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLo
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
-	const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const
+	const std::wstring& query,
+	NodeTypeSet acceptedNodeTypes,
+	bool acceptCommands,
+	std::function<bool()> isCancelled) const
 {
 	TRACE();
 
@@ -721,12 +1499,13 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
 			 .isEmpty())
 	{
 		matches = getAutocompletionSymbolMatches(
-			query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength);
+			query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength, isCancelled);
 	}
 
 	if (acceptedNodeTypes.containsMatching([](const NodeType& type) { return type.isFile(); }))
 	{
-		utility::append(matches, getAutocompletionFileMatches(query, maxResultsCount));
+		utility::append(
+			matches, getAutocompletionFileMatches(query, maxResultsCount, isCancelled));
 	}
 
 	if (acceptCommands)
@@ -734,6 +1513,11 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
 		utility::append(matches, getAutocompletionCommandMatches(query, acceptedNodeTypes));
 	}
 
+	if (isCancelled && isCancelled())
+	{
+		return {};
+	}
+
 	// Rescore search matches to check if better score is achieved with higher indices
 	std::vector<SearchMatch> rescoredMatches;
 	rescoredMatches.reserve(matches.size());
@@ -744,9 +1528,13 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
 		if (!match.subtext.empty() && match.indices.size())
 		{
 			SearchResult newResult = SearchIndex::rescoreText(
-				match.name, match.text, match.indices, match.score, maxBestScoredResultsLength);
+				match.name,
+				match.text,
+				match.indices,
+				match.score - match.scoreBonus,
+				maxBestScoredResultsLength);
 
-			match.score = newResult.score;
+			match.score = newResult.score + match.scoreBonus;
 			match.indices = std::move(newResult.indices);
 		}
 
@@ -802,11 +1590,39 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 	const std::wstring& query,
 	const NodeTypeSet& acceptedNodeTypes,
 	size_t maxResultsCount,
-	size_t maxBestScoredResultsLength) const
+	size_t maxBestScoredResultsLength,
+	const std::function<bool()>& isCancelled) const
 {
-	// search in indices
-	const std::vector<SearchResult> results = m_symbolIndex.search(
-		query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength);
+	std::vector<SearchResult> results;
+	if (m_lowMemoryMode)
+	{
+		results = searchSymbolNames(
+			query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength, isCancelled);
+	}
+	else
+	{
+		// search in all shards at once, the results get merged by score
+		const SymbolIndexShards shards = getLoadedSymbolIndexShards(acceptedNodeTypes);
+
+		std::vector<std::vector<SearchResult>> shardResults(shards.size());
+		auto searchShard = [&](size_t i) {
+			shardResults[i] = shards[i]->index.search(
+				query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength, isCancelled);
+		};
+
+		TaskManager::getThreadPool()->parallelFor(
+			shards.size(), searchShard, ThreadPool::PRIORITY_INTERACTIVE);
+
+		for (std::vector<SearchResult>& currentResults: shardResults)
+		{
+			std::move(currentResults.begin(), currentResults.end(), std::back_inserter(results));
+		}
+		std::stable_sort(results.begin(), results.end());
+		if (maxResultsCount && results.size() > maxResultsCount)
+		{
+			results.erase(results.begin() + maxResultsCount, results.end());
+		}
+	}
 
 	// fetch StorageNodes for node ids
 	std::map<Id, StorageNode> storageNodeMap;
@@ -818,7 +1634,7 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 			elementIds.insert(elementIds.end(), result.elementIds.begin(), result.elementIds.end());
 		}
 
-		for (const StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(elementIds))
+		for (const StorageNode& node: getStorageNodesByIds(elementIds))
 		{
 			storageNodeMap.emplace(node.id, node);
 		}
@@ -838,7 +1654,8 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 				StorageNode* node = &storageNodeMap[elementId];
 
 				match.tokenIds.push_back(elementId);
-				match.tokenNames.push_back(NameHierarchy::deserialize(node->serializedName));
+				match.tokenNames.push_back(
+					NameHierarchy::deserializeFromBinary(node->serializedName));
 
 				if (!match.hasChildren &&
 					acceptedNodeTypes ==
@@ -862,7 +1679,7 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 		match.name = result.text;
 		match.text = result.text;
 
-		NameHierarchy name = NameHierarchy::deserialize(firstNode->serializedName);
+		NameHierarchy name = NameHierarchy::deserializeFromBinary(firstNode->serializedName);
 		if (name.getQualifiedName() == match.name)
 		{
 			const size_t idx = m_hierarchyCache.getIndexOfLastVisibleParentNode(firstNode->id);
@@ -875,6 +1692,7 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 
 		match.indices = result.indices;
 		match.score = result.score;
+		match.scoreBonus = result.scoreBonus;
 		match.nodeType = NodeType::intToType(firstNode->type);
 		match.typeName = match.nodeType.getReadableTypeWString();
 		match.searchType = SearchMatch::SEARCH_TOKEN;
@@ -891,13 +1709,14 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionFileMatches(
-	const std::wstring& query, size_t maxResultsCount) const
+	const std::wstring& query, size_t maxResultsCount, const std::function<bool()>& isCancelled) const
 {
 	const std::vector<SearchResult> results = m_fileIndex.search(
 		query,
 		NodeTypeSet::all().getWithMatchingKept([](const NodeType& type) { return type.isFile(); }),
 		maxResultsCount,
-		100);
+		100,
+		isCancelled);
 
 	// create SearchMatches
 	std::vector<SearchMatch> matches;
@@ -985,7 +1804,7 @@ std::vector<SearchMatch> PersistentStorage::getSearchMatchesForTokenIds(
 
 	// fetch StorageNodes for node ids
 	std::map<Id, StorageNode> storageNodeMap;
-	for (StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(elementIds))
+	for (StorageNode& node: getStorageNodesByIds(elementIds))
 	{
 		storageNodeMap.emplace(node.id, node);
 	}
@@ -1000,7 +1819,8 @@ std::vector<SearchMatch> PersistentStorage::getSearchMatchesForTokenIds(
 		StorageNode node = storageNodeMap[elementId];
 
 		SearchMatch match;
-		const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+		const NameHierarchy nameHierarchy = NameHierarchy::deserializeFromBinary(
+			node.serializedName);
 		match.name = nameHierarchy.getQualifiedName();
 		match.text = nameHierarchy.getRawName();
 
@@ -1025,29 +1845,19 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForAll() const
 	TRACE();
 
 	std::vector<Id> tokenIds;
-
-	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
-		bool showNode = true;
-		if (m_symbolDefinitionKinds.size())
-		{
-			auto it = m_symbolDefinitionKinds.find(node.id);
-			showNode = (it != m_symbolDefinitionKinds.end() && it->second == DEFINITION_EXPLICIT);
-		}
-
-		if (showNode &&
-			(NodeType(NodeType::intToType(node.type)).isPackage() ||
-			 !m_hierarchyCache.isChildOfVisibleNodeOrInvisible(node.id)))
-		{
-			tokenIds.push_back(node.id);
-		}
-	});
-
-	for (const auto& p: m_fileNodeIndexed)
+	if (!m_overviewSummary.isEmpty())
 	{
-		if (p.second)
-		{
-			tokenIds.push_back(p.first);
-		}
+		tokenIds = m_overviewSummary.getNodeIds();
+	}
+	else
+	{
+		getReadIndexStorage()->forEachRow<Id, int>(
+			"SELECT id, type FROM node;", [&](Id nodeId, int type) {
+				if (isOverviewNode(nodeId, NodeType::intToType(type)))
+				{
+					tokenIds.push_back(nodeId);
+				}
+			});
 	}
 
 	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
@@ -1062,16 +1872,25 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForNodeTypes(NodeTypeSet nodeT
 
 	std::vector<Id> tokenIds;
 
-	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
-		if (nodeTypes.contains(NodeType::intToType(node.type)))
+	// only the ids and types are read, the names are loaded for the accepted nodes alone
+	const auto addNode = [&](Id nodeId, int type) {
+		if (nodeTypes.contains(NodeType::intToType(type)))
 		{
-			auto it = m_symbolDefinitionKinds.find(node.id);
+			auto it = m_symbolDefinitionKinds.find(nodeId);
 			if (it != m_symbolDefinitionKinds.end() && it->second == DEFINITION_EXPLICIT)
 			{
-				tokenIds.push_back(node.id);
+				tokenIds.push_back(nodeId);
 			}
 		}
-	});
+	};
+	if (!m_adjacencyCache.isEmpty())
+	{
+		m_adjacencyCache.forEachNode(addNode);
+	}
+	else
+	{
+		getReadIndexStorage()->forEachRow<Id, int>("SELECT id, type FROM node;", addNode);
+	}
 
 	if (nodeTypes.containsMatching([](const NodeType& type) { return type.isFile(); }))
 	{
@@ -1087,6 +1906,40 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForNodeTypes(NodeTypeSet nodeT
 	return graph;
 }
 
+std::map<NodeType::Type, size_t> PersistentStorage::getOverviewNodeCounts() const
+{
+	TRACE();
+
+	return m_overviewSummary.getNodeCounts();
+}
+
+std::shared_ptr<Graph> PersistentStorage::getGraphForOverviewNodeType(NodeType nodeType) const
+{
+	TRACE();
+
+	std::vector<Id> tokenIds;
+	if (!m_overviewSummary.isEmpty())
+	{
+		tokenIds = m_overviewSummary.getNodeIdsOfType(nodeType.getType());
+	}
+	else
+	{
+		const std::string query = "SELECT id, type FROM node WHERE type = " +
+			std::to_string(NodeType::typeToInt(nodeType.getType())) + ";";
+		getReadIndexStorage()->forEachRow<Id, int>(query, [&](Id nodeId, int type) {
+			if (isOverviewNode(nodeId, NodeType::intToType(type)))
+			{
+				tokenIds.push_back(nodeId);
+			}
+		});
+	}
+
+	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+	addNodesToGraph(tokenIds, graph.get(), false);
+
+	return graph;
+}
+
 std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 	const std::vector<Id>& tokenIds, const std::vector<Id>& expandedNodeIds, bool* isActiveNamespace) const
 {
@@ -1106,7 +1959,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 	if (tokenIds.size() == 1)
 	{
 		const Id elementId = tokenIds[0];
-		const StorageNode node = m_sqliteIndexStorage.getFirstById<StorageNode>(elementId);
+		const StorageNode node = getStorageNodeById(elementId);
 
 		if (node.id > 0)
 		{
@@ -1121,19 +1974,19 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 			}
 			else
 			{
-				m_hierarchyCache.addFirstChildIdsForNodeId(elementId, &nodeIds, &edgeIds);
-
-				// don't expand active node if it has too many child nodes
-				if (nodeIds.size() > 100 && nodeType.isCollapsible())
+				// an active node with too many child nodes is added collapsed with its child count,
+				// its children are only loaded by getGraphForChildrenOfNodeId once it is expanded
+				if (!nodeType.isCollapsible() ||
+					m_hierarchyCache.getFirstChildIdsCountForNodeId(elementId) <=
+						s_maxActiveChildCount)
 				{
-					nodeIds.clear();
+					m_hierarchyCache.addFirstChildIdsForNodeId(elementId, &nodeIds, &edgeIds);
 				}
 
 				nodeIds.push_back(elementId);
 				edgeIds.clear();
 
-				for (const StorageEdge& edge:
-					 m_sqliteIndexStorage.getEdgesBySourceOrTargetId(elementId))
+				for (const StorageEdge& edge: getEdgesBySourceOrTargetId(elementId))
 				{
 					Edge::EdgeType edgeType = Edge::intToType(edge.type);
 					if (edgeType == Edge::EDGE_MEMBER)
@@ -1164,7 +2017,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 				}
 			}
 		}
-		else if (m_sqliteIndexStorage.isEdge(elementId))
+		else if (getReadIndexStorage()->isEdge(elementId))
 		{
 			edgeIds.push_back(elementId);
 		}
@@ -1173,7 +2026,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 	if (ids.size() >= 1 || isPackage)
 	{
 		std::set<Id> symbolIds;
-		for (const StorageSymbol& symbol: m_sqliteIndexStorage.getAllByIds<StorageSymbol>(ids))
+		for (const StorageSymbol& symbol: getReadIndexStorage()->getAllByIds<StorageSymbol>(ids))
 		{
 			if (symbol.id > 0 &&
 				(!isPackage || intToDefinitionKind(symbol.definitionKind) != DEFINITION_IMPLICIT))
@@ -1182,7 +2035,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 			}
 			symbolIds.insert(symbol.id);
 		}
-		for (const StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(ids))
+		for (const StorageNode& node: getStorageNodesByIds(ids))
 		{
 			if (symbolIds.find(node.id) == symbolIds.end())
 			{
@@ -1194,7 +2047,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(
 		{
 			if (nodeIds.size() != ids.size())
 			{
-				for (const StorageEdge& edge: m_sqliteIndexStorage.getAllByIds<StorageEdge>(ids))
+				for (const StorageEdge& edge: getReadIndexStorage()->getAllByIds<StorageEdge>(ids))
 				{
 					if (edge.id > 0)
 					{
@@ -1286,119 +2139,107 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
 	bool nodeNonIndexed,
 	size_t depth,
 	bool directed) const
+{
+	return getGraphForTrail(
+		originId, targetId, nodeTypes, edgeTypes, nodeNonIndexed, depth, directed, nullptr);
+}
+
+std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
+	Id originId,
+	Id targetId,
+	NodeType::TypeMask nodeTypes,
+	Edge::TypeMask edgeTypes,
+	bool nodeNonIndexed,
+	size_t depth,
+	bool directed,
+	std::function<bool(std::shared_ptr<Graph>)> partialResultsCallback) const
 {
 	TRACE();
 
 	std::set<Id> nodeIds;
 	std::set<Id> edgeIds;
 
-	nodeIds.insert(originId ? originId : targetId);
-	bool forward = originId;
-	size_t currentDepth = 0;
-
-	std::vector<Id> nodeIdsToProcess = {*nodeIds.begin()};
-
-	struct TrailNode
-	{
-		Id id = 0;
-		std::set<TrailNode*> parents;
-		std::set<Id> edgeIds;
-	};
-
-	bool isTerminatedTrail = originId && targetId;
-	std::map<Id, TrailNode> trailNodes;
-
-	if (isTerminatedTrail)
+	if (originId && targetId)
 	{
-		TrailNode root;
-		root.id = originId;
-		trailNodes.emplace(originId, root);
+		addTerminatedTrailNodeAndEdgeIds(
+			originId,
+			targetId,
+			nodeTypes,
+			edgeTypes,
+			nodeNonIndexed,
+			depth,
+			directed,
+			&nodeIds,
+			&edgeIds);
 	}
-
-	while (nodeIdsToProcess.size() && (!depth || currentDepth < depth))
+	else
 	{
-		std::vector<StorageEdge> edges = forward
-			? m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess)
-			: m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess);
+		nodeIds.insert(originId ? originId : targetId);
+		bool forward = originId;
+		size_t currentDepth = 0;
 
-		if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
-		{
-			utility::append(
-				edges,
-				forward ? m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess)
-						: m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess));
-		}
+		std::vector<Id> nodeIdsToProcess = {*nodeIds.begin()};
 
-		std::vector<Id> nodeIdsToCheck;
-		std::map<Id, std::vector<StorageEdge>> edgesToInsert;
+		// levels are reported in intervals, as each report builds the graph of all nodes so far
+		TimeStamp lastReportTime = TimeStamp::now();
 
-		for (const StorageEdge& edge: edges)
+		while (nodeIdsToProcess.size() && (!depth || currentDepth < depth))
 		{
-			if (Edge::intToType(edge.type) & edgeTypes && edgeIds.find(edge.id) == edgeIds.end())
+			std::vector<StorageEdge> edges = forward
+				? getEdgesBySourceIds(nodeIdsToProcess, edgeTypes)
+				: getEdgesByTargetIds(nodeIdsToProcess, edgeTypes);
+
+			if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
 			{
-				bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+				utility::append(
+					edges,
+					forward ? getEdgesByTargetIds(nodeIdsToProcess, edgeTypes)
+							: getEdgesBySourceIds(nodeIdsToProcess, edgeTypes));
+			}
 
-				const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
-				const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+			std::vector<Id> nodeIdsToCheck;
+			std::map<Id, std::vector<StorageEdge>> edgesToInsert;
 
-				if (nodeIds.find(targetNodeId) == nodeIds.end())
-				{
-					nodeIdsToCheck.push_back(targetNodeId);
-					edgesToInsert[targetNodeId].push_back(edge);
-				}
-				else if (nodeIds.find(sourceNodeId) == nodeIds.end())
+			for (const StorageEdge& edge: edges)
+			{
+				if (Edge::intToType(edge.type) & edgeTypes && edgeIds.find(edge.id) == edgeIds.end())
 				{
-					if (!directed)
+					bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+
+					const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
+					const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+
+					if (nodeIds.find(targetNodeId) == nodeIds.end())
 					{
-						nodeIdsToCheck.push_back(sourceNodeId);
-						edgesToInsert[sourceNodeId].push_back(edge);
+						nodeIdsToCheck.push_back(targetNodeId);
+						edgesToInsert[targetNodeId].push_back(edge);
 					}
-				}
-				else
-				{
-					edgeIds.insert(edge.id);
-
-					if (isTerminatedTrail)
+					else if (nodeIds.find(sourceNodeId) == nodeIds.end())
+					{
+						if (!directed)
+						{
+							nodeIdsToCheck.push_back(sourceNodeId);
+							edgesToInsert[sourceNodeId].push_back(edge);
+						}
+					}
+					else
 					{
-						TrailNode& target = trailNodes[targetNodeId];
-						TrailNode& origin = trailNodes[sourceNodeId];
-						target.id = targetNodeId;
-						origin.id = sourceNodeId;
-						target.parents.insert(&origin);
-						target.edgeIds.insert(edge.id);
+						edgeIds.insert(edge.id);
 					}
 				}
 			}
-		}
 
-		nodeIdsToProcess.clear();
+			nodeIdsToProcess.clear();
 
-		if (nodeTypes != 0)
-		{
-			for (const StorageNode& node:
-				 m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIdsToCheck))
+			if (nodeTypes != 0)
 			{
-				NodeType::Type type = NodeType::intToType(node.type);
-				if (type & nodeTypes || (type == NodeType::NODE_SYMBOL && nodeNonIndexed))
+				for (const std::pair<Id, int>& nodeType: getNodeTypesForNodeIds(nodeIdsToCheck))
 				{
-					if (!nodeNonIndexed)
+					const Id nodeId = nodeType.first;
+					NodeType::Type type = NodeType::intToType(nodeType.second);
+					if (!isTrailNodeAccepted(nodeId, type, nodeTypes, nodeNonIndexed))
 					{
-						if (type == NodeType::NODE_FILE)
-						{
-							auto it = m_fileNodeIndexed.find(node.id);
-							if (it == m_fileNodeIndexed.end() || !it->second)
-							{
-								continue;
-							}
-						}
-						else
-						{
-							auto it = m_symbolDefinitionKinds.find(node.id);
-							if (it == m_symbolDefinitionKinds.end() || it->second == DEFINITION_NONE)
-							{
-								continue;
-							}
-						}
+						continue;
 					}
 
 					// FIXME: don't add namespace nodes to the graph, because it destroys trail
@@ -1407,8 +2248,8 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
 						 (NodeType::NODE_MODULE | NodeType::NODE_NAMESPACE |
 						  NodeType::NODE_PACKAGE)) == 0)
 					{
-						nodeIds.insert(node.id);
-						for (const StorageEdge& edge: edgesToInsert[node.id])
+						nodeIds.insert(nodeId);
+						for (const StorageEdge& edge: edgesToInsert[nodeId])
 						{
 							if ((Edge::intToType(edge.type) & Edge::EDGE_MEMBER) == 0)
 							{
@@ -1416,97 +2257,49 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(
 							}
 						}
 					}
-					nodeIdsToProcess.push_back(node.id);
-
-					if (isTerminatedTrail)
-					{
-						TrailNode& targetNode = trailNodes[node.id];
-						targetNode.id = node.id;
-
-						for (const StorageEdge& edge: edgesToInsert[node.id])
-						{
-							targetNode.edgeIds.insert(edge.id);
-
-							Id sourceNodeId =
-								(edge.targetNodeId == node.id ? edge.sourceNodeId
-															  : edge.targetNodeId);
-							TrailNode& oldNode = trailNodes[sourceNodeId];
-							targetNode.parents.insert(&oldNode);
-						}
-					}
+					nodeIdsToProcess.push_back(nodeId);
 				}
 			}
-		}
-		else
-		{
-			for (const Id nodeId: nodeIdsToCheck)
+			else
 			{
-				nodeIds.insert(nodeId);
-				nodeIdsToProcess.push_back(nodeId);
-
-				for (const StorageEdge& edge: edgesToInsert[nodeId])
+				for (const Id nodeId: nodeIdsToCheck)
 				{
-					edgeIds.insert(edge.id);
+					nodeIds.insert(nodeId);
+					nodeIdsToProcess.push_back(nodeId);
+
+					for (const StorageEdge& edge: edgesToInsert[nodeId])
+					{
+						edgeIds.insert(edge.id);
+					}
 				}
 			}
-		}
 
-		edgesToInsert.clear();
-
-		currentDepth++;
-	}
-
-	if (isTerminatedTrail)
-	{
-		nodeIds.clear();
-		edgeIds.clear();
+			edgesToInsert.clear();
 
-		if (trailNodes.find(targetId) != trailNodes.end())
-		{
-			std::queue<TrailNode*> nodesToProcess;
-			nodesToProcess.push(&trailNodes[targetId]);
+			currentDepth++;
 
-			while (nodesToProcess.size())
+			if (partialResultsCallback && nodeIdsToProcess.size() &&
+				(!depth || currentDepth < depth) &&
+				TimeStamp::now().deltaMS(lastReportTime) >= s_partialTrailIntervalMs)
 			{
-				TrailNode* currentNode = nodesToProcess.front();
-				nodesToProcess.pop();
-
-				if (nodeIds.find(currentNode->id) != nodeIds.end())
-				{
-					continue;
-				}
-
-				nodeIds.insert(currentNode->id);
-				edgeIds.insert(currentNode->edgeIds.begin(), currentNode->edgeIds.end());
-
-				for (TrailNode* parent: currentNode->parents)
+				if (!partialResultsCallback(createTrailGraph(nodeIds, edgeIds)))
 				{
-					nodesToProcess.push(parent);
+					break;
 				}
+				lastReportTime = TimeStamp::now();
 			}
 		}
-		else
-		{
-			nodeIds.insert(originId);
-		}
 	}
 
-	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
-
-	addNodesWithParentsAndEdgesToGraph(
-		utility::toVector(nodeIds), utility::toVector(edgeIds), graph.get(), false);
-	addComponentAccessToGraph(graph.get());
-	addComponentIsAmbiguousToGraph(graph.get());
-
-	return graph;
-}
+	return createTrailGraph(nodeIds, edgeIds);
+}
 
 NodeType::TypeMask PersistentStorage::getAvailableNodeTypes() const
 {
 	TRACE();
 
 	NodeType::TypeMask mask = 0;
-	for (int type: m_sqliteIndexStorage.getAvailableNodeTypes())
+	for (int type: getReadIndexStorage()->getAvailableNodeTypes())
 	{
 		mask |= NodeType::intToType(type);
 	}
@@ -1518,7 +2311,7 @@ Edge::TypeMask PersistentStorage::getAvailableEdgeTypes() const
 	TRACE();
 
 	Edge::TypeMask mask = 0;
-	for (int type: m_sqliteIndexStorage.getAvailableEdgeTypes())
+	for (int type: getReadIndexStorage()->getAvailableEdgeTypes())
 	{
 		mask |= Edge::intToType(type);
 	}
@@ -1532,10 +2325,8 @@ std::vector<Id> PersistentStorage::getActiveTokenIdsForId(Id tokenId, Id* declar
 
 	std::vector<Id> activeTokenIds;
 
-	bool isNode = m_sqliteIndexStorage.isNode(tokenId);
-	bool isEdge = m_sqliteIndexStorage.isEdge(tokenId);
-
-	if (!isEdge && !isNode)
+	bool isNode = false;
+	if (!isNodeOrEdge(tokenId, &isNode))
 	{
 		return activeTokenIds;
 	}
@@ -1546,7 +2337,7 @@ std::vector<Id> PersistentStorage::getActiveTokenIdsForId(Id tokenId, Id* declar
 	{
 		*declarationId = tokenId;
 
-		for (const StorageEdge& edge: m_sqliteIndexStorage.getEdgesByTargetId(tokenId))
+		for (const StorageEdge& edge: getEdgesByTargetIds({tokenId}))
 		{
 			activeTokenIds.push_back(edge.id);
 		}
@@ -1562,12 +2353,19 @@ std::vector<Id> PersistentStorage::getNodeIdsForLocationIds(const std::vector<Id
 	std::set<Id> nodeIds;
 	std::set<Id> implicitNodeIds;
 
-	for (const StorageOccurrence& occurrence:
-		 m_sqliteIndexStorage.getOccurrencesForLocationIds(locationIds))
+	std::vector<Id> elementIds;
+	if (!getLocationElementIds(locationIds, &elementIds))
 	{
-		Id elementId = occurrence.elementId;
+		for (const StorageOccurrence& occurrence:
+			 getOccurrencesForLocationIds(locationIds))
+		{
+			elementIds.push_back(occurrence.elementId);
+		}
+	}
 
-		const StorageEdge edge = m_sqliteIndexStorage.getFirstById<StorageEdge>(elementId);
+	for (Id elementId: elementIds)
+	{
+		const StorageEdge edge = getEdgeById(elementId);
 		if (edge.id != 0)
 		{
 			elementId = edge.targetNodeId;
@@ -1595,6 +2393,13 @@ std::vector<Id> PersistentStorage::getNodeIdsForLocationIds(const std::vector<Id
 
 std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsForTokenIds(
 	const std::vector<Id>& tokenIds) const
+{
+	return getSourceLocationsForTokenIds(tokenIds, nullptr);
+}
+
+std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsForTokenIds(
+	const std::vector<Id>& tokenIds,
+	std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback) const
 {
 	TRACE();
 
@@ -1603,19 +2408,7 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsF
 
 	for (const Id tokenId: tokenIds)
 	{
-		FilePath path = getFileNodePath(tokenId);
-
-		// check for non-indexed file
-		if (path.empty() && m_symbolDefinitionKinds.find(tokenId) == m_symbolDefinitionKinds.end())
-		{
-			const StorageNode fileNode = m_sqliteIndexStorage.getNodeById(tokenId);
-			if (NodeType(NodeType::intToType(fileNode.type)).isFile())
-			{
-				path = FilePath(
-					NameHierarchy::deserialize(fileNode.serializedName).getQualifiedName());
-			}
-		}
-
+		const FilePath path = getFilePathOfFileToken(tokenId);
 		if (path.empty())
 		{
 			nonFileIds.push_back(tokenId);
@@ -1639,39 +2432,39 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsF
 		// FIXME: can we use get SqliteIndexStorage::getSourceLocationsForElementIds() here instead?
 		std::vector<Id> locationIds;
 		std::unordered_map<Id, Id> locationIdToElementIdMap;
-		for (const StorageOccurrence& occurrence:
-			 m_sqliteIndexStorage.getOccurrencesForElementIds(nonFileIds))
+		for (const StorageOccurrence& occurrence: getOccurrencesForElementIds(nonFileIds))
 		{
 			locationIds.push_back(occurrence.sourceLocationId);
 			locationIdToElementIdMap[occurrence.sourceLocationId] = occurrence.elementId;
 		}
 
+		std::map<Id, std::vector<StorageSourceLocation>> fileIdToSourceLocations;
 		for (const StorageSourceLocation& sourceLocation:
-			 m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(locationIds))
+			 getStorageSourceLocationsByIds(locationIds))
 		{
 			const LocationType type = intToLocationType(sourceLocation.type);
-			if (type != LOCATION_TOKEN && type != LOCATION_SCOPE && type != LOCATION_LOCAL_SYMBOL &&
-				type != LOCATION_UNSOLVED)
-			{
-				continue;
-			}
-
-			auto it = locationIdToElementIdMap.find(sourceLocation.id);
-			if (it == locationIdToElementIdMap.end())
+			if ((type == LOCATION_TOKEN || type == LOCATION_SCOPE || type == LOCATION_LOCAL_SYMBOL ||
+				 type == LOCATION_UNSOLVED) &&
+				locationIdToElementIdMap.find(sourceLocation.id) != locationIdToElementIdMap.end())
 			{
-				continue;
+				fileIdToSourceLocations[sourceLocation.fileNodeId].push_back(sourceLocation);
 			}
+		}
 
-			FilePath path = getFileNodePath(sourceLocation.fileNodeId);
+		// paths are resolved once per file, files are ordered like in the collection
+		std::map<FilePath, const std::vector<StorageSourceLocation>*> pathToSourceLocations;
+		for (const auto& p: fileIdToSourceLocations)
+		{
+			FilePath path = getFileNodePath(p.first);
 			// FIXME: This shouldn't be necessary since all files are stored, even non-indexed
 			if (path.empty())
 			{
-				const StorageNode fileNode = m_sqliteIndexStorage.getNodeById(
-					sourceLocation.fileNodeId);
+				const StorageNode fileNode = getStorageNodeById(p.first);
 				if (fileNode.id)
 				{
 					const FilePath path2 = FilePath(
-						NameHierarchy::deserialize(fileNode.serializedName).getQualifiedName());
+						NameHierarchy::deserializeFromBinary(fileNode.serializedName)
+							.getQualifiedName());
 					if (path2.exists())
 					{
 						path = path2;
@@ -1681,17 +2474,109 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsF
 
 			if (!path.empty())
 			{
-				collection->addSourceLocation(
-					type,
-					sourceLocation.id,
-					{it->second},
-					path,
-					sourceLocation.startLine,
-					sourceLocation.startCol,
-					sourceLocation.endLine,
-					sourceLocation.endCol);
+				pathToSourceLocations.emplace(path, &p.second);
+			}
+		}
+		const std::vector<std::pair<FilePath, const std::vector<StorageSourceLocation>*>> files(
+			pathToSourceLocations.begin(), pathToSourceLocations.end());
+
+		// workers build pages of files, pages are merged in order so the first files come first
+		const size_t filesPerPage = 16;
+		const size_t pageCount = (files.size() + filesPerPage - 1) / filesPerPage;
+		std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+		const size_t threadCount = std::min<size_t>(threadPool->getWorkerCount(), pageCount);
+
+		std::atomic<size_t> nextPageIndex(0);
+
+		std::mutex pagesMutex;
+		std::condition_variable pagesCondition;
+		std::vector<std::shared_ptr<SourceLocationCollection>> pages(pageCount);
+
+		const std::function<void(size_t)> buildPage = [&](size_t pageIndex) {
+			std::shared_ptr<SourceLocationCollection> page =
+				std::make_shared<SourceLocationCollection>();
+
+			const size_t pageEnd = std::min((pageIndex + 1) * filesPerPage, files.size());
+			for (size_t i = pageIndex * filesPerPage; i < pageEnd; i++)
+			{
+				std::shared_ptr<SourceLocationFile> file = std::make_shared<SourceLocationFile>(
+					files[i].first, L"", false, false, false);
+				for (const StorageSourceLocation& sourceLocation: *files[i].second)
+				{
+					file->addSourceLocation(
+						intToLocationType(sourceLocation.type),
+						sourceLocation.id,
+						{locationIdToElementIdMap.find(sourceLocation.id)->second},
+						sourceLocation.startLine,
+						sourceLocation.startCol,
+						sourceLocation.endLine,
+						sourceLocation.endCol);
+				}
+				page->addSourceLocationFile(file);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(pagesMutex);
+				pages[pageIndex] = page;
+			}
+			pagesCondition.notify_one();
+		};
+
+		std::vector<std::future<void>> jobs;
+		if (pageCount > 1)
+		{
+			for (size_t i = 0; i < threadCount; i++)
+			{
+				jobs.push_back(threadPool->run(
+					[&]() {
+						for (size_t pageIndex = nextPageIndex++; pageIndex < pageCount;
+							 pageIndex = nextPageIndex++)
+						{
+							buildPage(pageIndex);
+						}
+					},
+					ThreadPool::PRIORITY_INTERACTIVE));
+			}
+		}
+		else if (pageCount)
+		{
+			buildPage(0);
+		}
+
+		for (size_t pageIndex = 0; pageIndex < pageCount; pageIndex++)
+		{
+			std::shared_ptr<SourceLocationCollection> page;
+			{
+				std::unique_lock<std::mutex> lock(pagesMutex);
+				pagesCondition.wait(lock, [&]() { return pages[pageIndex] != nullptr; });
+				page.swap(pages[pageIndex]);
+			}
+
+			addCompleteFlagsToSourceLocationCollection(page.get());
+			page->forEachSourceLocationFile([&collection](std::shared_ptr<SourceLocationFile> file) {
+				// a token id may have added the file already
+				if (collection->getSourceLocationFileByPath(file->getFilePath()))
+				{
+					collection->addSourceLocationCopies(file.get());
+				}
+				else
+				{
+					collection->addSourceLocationFile(file);
+				}
+			});
+
+			// the first files are shown while the remaining pages are merged
+			if (partialResultsCallback && pageIndex == 0 && pageCount > 1)
+			{
+				addCompleteFlagsToSourceLocationCollection(collection.get());
+				partialResultsCallback(collection);
 			}
 		}
+
+		for (std::future<void>& job: jobs)
+		{
+			job.wait();
+		}
 	}
 
 	addCompleteFlagsToSourceLocationCollection(collection.get());
@@ -1699,6 +2584,34 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsF
 	return collection;
 }
 
+size_t PersistentStorage::getSourceLocationFileCountForTokenIds(
+	const std::vector<Id>& tokenIds, size_t* referenceCount) const
+{
+	TRACE();
+
+	// files show all of their content and are not paged
+	for (const Id tokenId: tokenIds)
+	{
+		if (!getFilePathOfFileToken(tokenId).empty())
+		{
+			return 0;
+		}
+	}
+
+	return m_sqliteIndexStorage.getSourceLocationFileCountForElementIds(tokenIds, referenceCount);
+}
+
+std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsPageForTokenIds(
+	const std::vector<Id>& tokenIds, FilePath* cursor, size_t fileCount) const
+{
+	TRACE();
+
+	std::shared_ptr<SourceLocationCollection> collection =
+		m_sqliteIndexStorage.getSourceLocationsPageForElementIds(tokenIds, cursor, fileCount);
+	addCompleteFlagsToSourceLocationCollection(collection.get());
+	return collection;
+}
+
 std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsForLocationIds(
 	const std::vector<Id>& locationIds) const
 {
@@ -1709,13 +2622,13 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getSourceLocationsF
 
 	std::map<Id, std::vector<Id>> m_locationIdToElementIds;
 	for (const StorageOccurrence& occurrence:
-		 m_sqliteIndexStorage.getOccurrencesForLocationIds(locationIds))
+		 getOccurrencesForLocationIds(locationIds))
 	{
 		m_locationIdToElementIds[occurrence.sourceLocationId].push_back(occurrence.elementId);
 	}
 
 	for (StorageSourceLocation location:
-		 m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(locationIds))
+		 getStorageSourceLocationsByIds(locationIds))
 	{
 		const LocationType type = intToLocationType(location.type);
 		if (type != LOCATION_TOKEN && type != LOCATION_SCOPE && type != LOCATION_LOCAL_SYMBOL &&
@@ -1745,8 +2658,18 @@ std::shared_ptr<SourceLocationFile> PersistentStorage::getSourceLocationsForFile
 {
 	TRACE();
 
-	return m_sqliteIndexStorage.getSourceLocationsForFile(filePath)->getFilteredByTypes(
-		{LOCATION_TOKEN, LOCATION_SCOPE, LOCATION_QUALIFIER, LOCATION_LOCAL_SYMBOL, LOCATION_UNSOLVED});
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	std::shared_ptr<SourceLocationFile> file =
+		(replica ? getReplicatedSourceLocationsForFile(*replica, filePath, 0, 0)
+				 : getReadIndexStorage()->getSourceLocationsForFile(filePath))
+			->getFilteredByTypes(
+				{LOCATION_TOKEN,
+				 LOCATION_SCOPE,
+				 LOCATION_QUALIFIER,
+				 LOCATION_LOCAL_SYMBOL,
+				 LOCATION_UNSOLVED});
+	addLocationElementIds(*file);
+	return file;
 }
 
 std::shared_ptr<SourceLocationFile> PersistentStorage::getSourceLocationsForLinesInFile(
@@ -1754,7 +2677,10 @@ std::shared_ptr<SourceLocationFile> PersistentStorage::getSourceLocationsForLine
 {
 	TRACE();
 
-	return m_sqliteIndexStorage.getSourceLocationsForLinesInFile(filePath, startLine, endLine)
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	return (replica ? getReplicatedSourceLocationsForFile(*replica, filePath, startLine, endLine)
+					: getReadIndexStorage()->getSourceLocationsForLinesInFile(
+						  filePath, startLine, endLine))
 		->getFilteredByLines(startLine, endLine)
 		->getFilteredByTypes(
 			{LOCATION_TOKEN,
@@ -1769,7 +2695,7 @@ std::shared_ptr<SourceLocationFile> PersistentStorage::getSourceLocationsOfTypeI
 {
 	TRACE();
 
-	return m_sqliteIndexStorage.getSourceLocationsOfTypeInFile(filePath, type);
+	return getReadIndexStorage()->getSourceLocationsOfTypeInFile(filePath, type);
 }
 
 std::shared_ptr<TextAccess> PersistentStorage::getFileContent(
@@ -1777,29 +2703,72 @@ std::shared_ptr<TextAccess> PersistentStorage::getFileContent(
 {
 	TRACE();
 
-	std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(
-		filePath.wstr());
-	if (fileContent->getLineCount() > 0)
+	return getFileContent(filePath, FileContentCache::CONSUMER_CODE_VIEW);
+}
+
+std::shared_ptr<TextAccess> PersistentStorage::getStoredFileContent(
+	const FilePath& filePath, FileContentCache::Consumer consumer) const
+{
+	return getStoredFileContent(getReadIndexStorage()->getFileByPath(filePath.wstr()), consumer);
+}
+
+std::string PersistentStorage::getFileContentHash(const FilePath& filePath) const
+{
+	const StorageFile file = getReadIndexStorage()->getFileByPath(filePath.wstr());
+	if (file.id)
 	{
-		return fileContent;
+		return getReadIndexStorage()->getFileContentHash(file.id);
 	}
-	return TextAccess::createFromFile(FilePath(filePath));
+	return "";
 }
 
-bool PersistentStorage::hasContentForFile(const FilePath& filePath) const
+std::map<FilePath, std::string> PersistentStorage::getFileContentHashesForAllFiles() const
 {
-	std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(
-		filePath.wstr());
-	if (fileContent->getLineCount() > 0)
+	TRACE();
+
+	std::map<FilePath, std::string> hashes;
+	for (const auto& p: getReadIndexStorage()->getAllFileContentHashes())
 	{
-		return true;
+		hashes.emplace(FilePath(p.first), p.second);
 	}
-	return false;
+	return hashes;
+}
+
+bool PersistentStorage::hasOnlyLayoutChanges(const FilePath& filePath) const
+{
+	TRACE();
+
+	return getSourceLocationsMovedToContent(
+		getReadIndexStorage()->getFileByPath(filePath.wstr()),
+		TextAccess::createFromFile(filePath)->getText(),
+		nullptr);
+}
+
+bool PersistentStorage::moveLocationsToCurrentContent(const FilePath& filePath)
+{
+	TRACE();
+
+	const StorageFile file = m_sqliteIndexStorage.getFileByPath(filePath.wstr());
+	const std::string content = TextAccess::createFromFile(filePath)->getText();
+
+	std::vector<StorageSourceLocation> locations;
+	if (!getSourceLocationsMovedToContent(file, content, &locations))
+	{
+		return false;
+	}
+
+	m_sqliteIndexStorage.beginTransaction();
+	m_sqliteIndexStorage.updateSourceLocationPositions(locations);
+	m_sqliteIndexStorage.updateFileContent(
+		file.id, content, FileSystem::getFileInfoForPath(filePath).lastWriteTime.toString());
+	m_sqliteIndexStorage.commitTransaction();
+
+	return true;
 }
 
 FileInfo PersistentStorage::getFileInfoForFileId(Id id) const
 {
-	StorageFile storageFile = m_sqliteIndexStorage.getFirstById<StorageFile>(id);
+	StorageFile storageFile = getReadIndexStorage()->getFirstById<StorageFile>(id);
 	return FileInfo(FilePath(storageFile.filePath), storageFile.modificationTime);
 }
 
@@ -1813,7 +2782,7 @@ std::vector<FileInfo> PersistentStorage::getFileInfosForFilePaths(
 {
 	std::vector<FileInfo> fileInfos;
 
-	for (const StorageFile& file: m_sqliteIndexStorage.getFilesByPaths(filePaths))
+	for (const StorageFile& file: getReadIndexStorage()->getFilesByPaths(filePaths))
 	{
 		fileInfos.push_back(FileInfo(FilePath(file.filePath), file.modificationTime));
 	}
@@ -1825,28 +2794,64 @@ StorageStats PersistentStorage::getStorageStats() const
 {
 	TRACE();
 
-	StorageStats stats;
+	return getReadIndexStorage()->getStorageStats();
+}
 
-	stats.nodeCount = m_sqliteIndexStorage.getNodeCount();
-	stats.edgeCount = m_sqliteIndexStorage.getEdgeCount();
+MemoryUsage PersistentStorage::getMemoryUsage() const
+{
+	MemoryUsage usage;
 
-	stats.fileCount = m_sqliteIndexStorage.getFileCount();
-	stats.completedFileCount = m_sqliteIndexStorage.getCompletedFileCount();
-	stats.fileLOCCount = m_sqliteIndexStorage.getFileLineSum();
+	size_t symbolIndexByteSize = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+		for (const std::shared_ptr<SymbolIndexShard>& shard: m_symbolIndexShards)
+		{
+			symbolIndexByteSize += shard->index.getByteSize();
+		}
+	}
+	usage.add("symbol search index", symbolIndexByteSize);
+	usage.add("file search index", m_fileIndex.getByteSize());
+	usage.add("command search index", m_commandIndex.getByteSize());
+	usage.add("fulltext search index", m_fullTextSearchIndex.getByteSize());
+	usage.add("hierarchy cache", m_hierarchyCache.getByteSize());
+	usage.add("adjacency cache", m_adjacencyCache.getByteSize());
+	usage.add("aggregation cache", m_aggregationCache.getByteSize());
+	usage.add("file reachability index", m_fileReachabilityIndex.getByteSize());
+	usage.add("overview summary", m_overviewSummary.getByteSize());
+	usage.add("file content cache (shared)", FileContentCache::getInstance()->getByteSize());
+	if (std::shared_ptr<const IndexReplica> replica = getIndexReplica())
+	{
+		usage.add("index replica", replica->getByteSize());
+	}
+	usage.add(
+		"file node maps",
+		utility::getByteSize(m_fileNodeIds) + utility::getByteSize(m_lowerCasefileNodeIds) +
+			utility::getByteSize(m_fileNodePaths) + utility::getByteSize(m_fileNodeComplete) +
+			utility::getByteSize(m_fileNodeIndexed) + utility::getByteSize(m_fileNodeLanguage));
+	usage.add(
+		"symbol maps",
+		utility::getByteSize(m_symbolDefinitionKinds) +
+			utility::getByteSize(m_memberEdgeIdOrderMap));
 
-	stats.timestamp = m_sqliteIndexStorage.getTime();
+	// shared by all storages of the process
+	usage.add("interned strings", InternedStringPool::getInstance()->getByteSize());
 
-	return stats;
+	return usage;
 }
 
 ErrorCountInfo PersistentStorage::getErrorCount() const
 {
-	return ErrorCountInfo(m_sqliteIndexStorage.getAllErrorInfos());
+	return getReadIndexStorage()->getErrorCountInfo(ErrorFilter());
+}
+
+ErrorCountInfo PersistentStorage::getErrorCountForFilter(const ErrorFilter& filter) const
+{
+	return getReadIndexStorage()->getErrorCountInfo(filter);
 }
 
 std::vector<ErrorInfo> PersistentStorage::getErrorsLimited(const ErrorFilter& filter) const
 {
-	return filter.filterErrors(m_sqliteIndexStorage.getAllErrorInfos());
+	return getReadIndexStorage()->getErrorInfos(filter);
 }
 
 std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(
@@ -1857,7 +2862,6 @@ std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(
 
 	std::unordered_map<Id, std::set<Id>> includedMap = getFileIdToIncludedFileIdMap();
 	std::set<Id> fileIdsToProcess = includedMap[getFileNodeId(filePath)];
-	std::set<Id> processedFileIds;
 
 	while (fileIdsToProcess.size())
 	{
@@ -1872,17 +2876,8 @@ std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(
 		fileIdsToProcess = nextFileIdsToProcess;
 	}
 
-	std::vector<ErrorInfo> res;
-
-	std::vector<ErrorInfo> errors = m_sqliteIndexStorage.getAllErrorInfos();
-	for (const ErrorInfo& error: errors)
-	{
-		if (filter.filter(error) &&
-			fileIds.find(getFileNodeId(FilePath(error.filePath))) != fileIds.end())
-		{
-			res.push_back(error);
-		}
-	}
+	std::vector<ErrorInfo> res = getReadIndexStorage()->getErrorInfos(
+		filter, utility::toVector(fileIds));
 
 	if (res.empty())
 	{
@@ -1903,13 +2898,13 @@ std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(
 			fileIdsToProcess = nextFileIdsToProcess;
 		}
 
-		for (const ErrorInfo& error: errors)
+		// only fatal errors of including files can be the reason for errors in this file
+		if (!fileIds.empty())
 		{
-			if (error.fatal && filter.filter(error) &&
-				fileIds.find(getFileNodeId(FilePath(error.filePath))) != fileIds.end())
-			{
-				res.push_back(error);
-			}
+			ErrorFilter fatalFilter = filter;
+			fatalFilter.error = false;
+			fatalFilter.unindexedError = false;
+			res = getReadIndexStorage()->getErrorInfos(fatalFilter, utility::toVector(fileIds));
 		}
 	}
 
@@ -1959,7 +2954,10 @@ Id PersistentStorage::addNodeBookmark(const NodeBookmark& bookmark)
 	for (const Id& nodeId: bookmark.getNodeIds())
 	{
 		m_sqliteBookmarkStorage.addBookmarkedNode(
-			StorageBookmarkedNodeData(id, m_sqliteIndexStorage.getNodeById(nodeId).serializedName));
+			StorageBookmarkedNodeData(
+				id,
+				NameHierarchy::convertBinaryToSerialized(
+					getStorageNodeById(nodeId).serializedName)));
 	}
 
 	return id;
@@ -1983,8 +2981,10 @@ Id PersistentStorage::addEdgeBookmark(const EdgeBookmark& bookmark)
 		m_sqliteBookmarkStorage.addBookmarkedEdge(StorageBookmarkedEdgeData(
 			id,
 			// todo: optimization for multiple edges in same bookmark: use a local cache here
-			m_sqliteIndexStorage.getNodeById(storageEdge.sourceNodeId).serializedName,
-			m_sqliteIndexStorage.getNodeById(storageEdge.targetNodeId).serializedName,
+			NameHierarchy::convertBinaryToSerialized(
+				getStorageNodeById(storageEdge.sourceNodeId).serializedName),
+			NameHierarchy::convertBinaryToSerialized(
+				getStorageNodeById(storageEdge.targetNodeId).serializedName),
 			storageEdge.type,
 			sourceNodeActive));
 	}
@@ -2027,6 +3027,19 @@ void PersistentStorage::removeBookmarkCategory(Id id)
 	m_sqliteBookmarkStorage.removeBookmarkCategory(id);
 }
 
+void PersistentStorage::setRecentNodeIds(const std::vector<Id>& nodeIds)
+{
+	std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+	m_recentNodeIds = nodeIds;
+	for (const std::shared_ptr<SymbolIndexShard>& shard: m_symbolIndexShards)
+	{
+		if (shard->loaded)
+		{
+			shard->index.setRecentIds(nodeIds);
+		}
+	}
+}
+
 std::vector<NodeBookmark> PersistentStorage::getAllNodeBookmarks() const
 {
 	std::unordered_map<Id, StorageBookmarkCategory> bookmarkCategories;
@@ -2036,11 +3049,25 @@ std::vector<NodeBookmark> PersistentStorage::getAllNodeBookmarks() const
 		bookmarkCategories[bookmarkCategory.id] = bookmarkCategory;
 	}
 
+	const std::vector<StorageBookmarkedNode> bookmarkedNodes =
+		m_sqliteBookmarkStorage.getAllBookmarkedNodes();
+
 	std::unordered_map<Id, std::vector<Id>> bookmarkIdToBookmarkedNodeIds;
-	for (const StorageBookmarkedNode& bookmarkedNode: m_sqliteBookmarkStorage.getAllBookmarkedNodes())
 	{
-		bookmarkIdToBookmarkedNodeIds[bookmarkedNode.bookmarkId].push_back(
-			m_sqliteIndexStorage.getNodeBySerializedName(bookmarkedNode.serializedNodeName).id);
+		std::vector<std::wstring> serializedNodeNames;
+		for (const StorageBookmarkedNode& bookmarkedNode: bookmarkedNodes)
+		{
+			serializedNodeNames.push_back(bookmarkedNode.serializedNodeName);
+		}
+
+		std::lock_guard<std::mutex> lock(m_bookmarkIndexMutex);
+		updateBookmarkIndex(serializedNodeNames, {});
+
+		for (const StorageBookmarkedNode& bookmarkedNode: bookmarkedNodes)
+		{
+			bookmarkIdToBookmarkedNodeIds[bookmarkedNode.bookmarkId].push_back(
+				m_bookmarkedNodeIds[bookmarkedNode.serializedNodeName]);
+		}
 	}
 
 	std::vector<NodeBookmark> nodeBookmarks;
@@ -2076,17 +3103,22 @@ std::vector<EdgeBookmark> PersistentStorage::getAllEdgeBookmarks() const
 		bookmarkCategories[bookmarkCategory.id] = bookmarkCategory;
 	}
 
+	const std::vector<StorageBookmarkedEdge> bookmarkedEdges =
+		m_sqliteBookmarkStorage.getAllBookmarkedEdges();
+
 	std::unordered_map<Id, std::vector<StorageBookmarkedEdge>> bookmarkIdToBookmarkedEdges;
-	for (const StorageBookmarkedEdge& bookmarkedEdge: m_sqliteBookmarkStorage.getAllBookmarkedEdges())
+	std::vector<std::wstring> serializedNodeNames;
+	for (const StorageBookmarkedEdge& bookmarkedEdge: bookmarkedEdges)
 	{
 		bookmarkIdToBookmarkedEdges[bookmarkedEdge.bookmarkId].push_back(bookmarkedEdge);
+		serializedNodeNames.push_back(bookmarkedEdge.serializedSourceNodeName);
+		serializedNodeNames.push_back(bookmarkedEdge.serializedTargetNodeName);
 	}
 
 	std::vector<EdgeBookmark> edgeBookmarks;
 
-	UnorderedCache<std::wstring, Id> nodeIdCache([&](const std::wstring& serializedNodeName) {
-		return m_sqliteIndexStorage.getNodeBySerializedName(serializedNodeName).id;
-	});
+	std::lock_guard<std::mutex> lock(m_bookmarkIndexMutex);
+	updateBookmarkIndex(serializedNodeNames, bookmarkedEdges);
 
 	for (const StorageBookmark& storageBookmark: m_sqliteBookmarkStorage.getAllBookmarks())
 	{
@@ -2105,13 +3137,10 @@ std::vector<EdgeBookmark> PersistentStorage::getAllEdgeBookmarks() const
 			Id activeNodeId = 0;
 			for (const StorageBookmarkedEdge& bookmarkedEdge: itBookmarkedEdges->second)
 			{
-				const Id sourceNodeId = nodeIdCache.getValue(bookmarkedEdge.serializedSourceNodeName);
-				const Id targetNodeId = nodeIdCache.getValue(bookmarkedEdge.serializedTargetNodeName);
-				const Id edgeId = m_sqliteIndexStorage
-									  .getEdgeBySourceTargetType(
-										  sourceNodeId, targetNodeId, bookmarkedEdge.edgeType)
-									  .id;
-				bookmark.addEdgeId(edgeId);
+				const Id sourceNodeId = m_bookmarkedNodeIds[bookmarkedEdge.serializedSourceNodeName];
+				const Id targetNodeId = m_bookmarkedNodeIds[bookmarkedEdge.serializedTargetNodeName];
+				bookmark.addEdgeId(m_bookmarkedEdgeIds[BookmarkedEdgeKey(
+					sourceNodeId, targetNodeId, bookmarkedEdge.edgeType)]);
 
 				if (activeNodeId == 0)
 				{
@@ -2151,14 +3180,14 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 		return info;
 	}
 
-	StorageNode node = m_sqliteIndexStorage.getFirstById<StorageNode>(tokenIds[0]);
+	StorageNode node = getStorageNodeById(tokenIds[0]);
 	if (node.id == 0 && origin == TOOLTIP_ORIGIN_CODE)
 	{
-		const StorageEdge edge = m_sqliteIndexStorage.getFirstById<StorageEdge>(tokenIds[0]);
+		const StorageEdge edge = getReadIndexStorage()->getFirstById<StorageEdge>(tokenIds[0]);
 
 		if (edge.id > 0)
 		{
-			node = m_sqliteIndexStorage.getFirstById<StorageNode>(edge.targetNodeId);
+			node = getStorageNodeById(edge.targetNodeId);
 		}
 	}
 
@@ -2171,7 +3200,7 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 	info.title = type.getReadableTypeWString();
 
 	DefinitionKind defKind = DEFINITION_NONE;
-	const StorageSymbol symbol = m_sqliteIndexStorage.getFirstById<StorageSymbol>(node.id);
+	const StorageSymbol symbol = getReadIndexStorage()->getFirstById<StorageSymbol>(node.id);
 	if (symbol.id > 0)
 	{
 		defKind = intToDefinitionKind(symbol.definitionKind);
@@ -2179,7 +3208,7 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 
 	if (type.isPotentialMember())
 	{
-		const StorageComponentAccess access = m_sqliteIndexStorage.getComponentAccessByNodeId(node.id);
+		const StorageComponentAccess access = getReadIndexStorage()->getComponentAccessByNodeId(node.id);
 		if (access.nodeId != 0)
 		{
 			info.title = accessKindToString(intToAccessKind(access.type)) + L" " + info.title;
@@ -2209,7 +3238,7 @@ TooltipInfo PersistentStorage::getTooltipInfoForTokenIds(
 
 	info.count = 0;
 	info.countText = "reference";
-	for (const auto& edge: m_sqliteIndexStorage.getEdgesByTargetId(node.id))
+	for (const auto& edge: getReadIndexStorage()->getEdgesByTargetId(node.id))
 	{
 		if (Edge::intToType(edge.type) != Edge::EDGE_MEMBER)
 		{
@@ -2235,27 +3264,27 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 {
 	TRACE();
 
-	const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+	const NameHierarchy nameHierarchy = NameHierarchy::deserializeFromBinary(node.serializedName);
 	TooltipSnippet snippet;
 	snippet.code = nameHierarchy.getQualifiedNameWithSignature();
 	snippet.locationFile = std::make_shared<SourceLocationFile>(
 		FilePath(L"main.txt"), L"", true, true, true);
 
 	// set file language
-	std::vector<StorageOccurrence> occurrences = m_sqliteIndexStorage.getOccurrencesForElementIds(
+	std::vector<StorageOccurrence> occurrences = getOccurrencesForElementIds(
 		{node.id});
 	if (occurrences.size())
 	{
 		const Id locationId = occurrences.front().sourceLocationId;
 		const Id fileId =
-			m_sqliteIndexStorage.getFirstById<StorageSourceLocation>(locationId).fileNodeId;
+			getStorageSourceLocationById(locationId).fileNodeId;
 		snippet.locationFile->setLanguage(getFileNodeLanguage(fileId));
 	}
 
 	if (nameHierarchy.hasSignature())
 	{
 		std::shared_ptr<SourceLocationCollection> locations =
-			m_sqliteIndexStorage.getSourceLocationsForElementIds({node.id});
+			getReadIndexStorage()->getSourceLocationsForElementIds({node.id});
 		SourceLocation* sigLoc = nullptr;
 
 		locations->forEachSourceLocation([&sigLoc](SourceLocation* location) {
@@ -2278,7 +3307,7 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 
 			std::vector<Annotation> annotations;
 			std::vector<std::string> lines =
-				getFileContent(sigLoc->getFilePath(), false)
+				getFileContent(sigLoc->getFilePath(), FileContentCache::CONSUMER_TOOLTIP)
 					->getLines(sigLoc->getLineNumber(), sigLoc->getEndLocation()->getLineNumber());
 
 			// check if signature location refers to correct locations in the code
@@ -2348,8 +3377,8 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 				size_t delimiterPos = code.rfind(delimiter, annotation.startPos);
 
 				// if is function name itself, replace with qualified name
-				if (utility::containsElement(
-						file->getSourceLocationById(annotation.locationId)->getTokenIds(), node.id) &&
+				const SourceLocation* location = file->getSourceLocationById(annotation.locationId);
+				if (location->getTokenIds().contains(node.id) &&
 					(delimiterPos == std::wstring::npos ||
 					 delimiterPos < annotation.startPos - delimiter.size()) &&
 					text.size() <= nameHierarchy.getRawName().size())
@@ -2385,7 +3414,7 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 					snippet.locationFile->addSourceLocation(
 						loc->getType(),
 						loc->getLocationId(),
-						loc->getTokenIds(),
+						loc->getTokenIds().toVector(),
 						1,
 						pos + 1,
 						1,
@@ -2407,7 +3436,7 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 			ApplicationSettings::getInstance()->getCodeTabWidth());
 
 		std::vector<Id> typeNodeIds;
-		for (const auto& edge: m_sqliteIndexStorage.getEdgesBySourceId(node.id))
+		for (const auto& edge: getReadIndexStorage()->getEdgesBySourceId(node.id))
 		{
 			if (Edge::intToType(edge.type) == Edge::EDGE_TYPE_USAGE)
 			{
@@ -2428,10 +3457,11 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 			});
 
 		typeNames.insert(std::make_pair(nameHierarchy.getQualifiedName(), node.id));
-		for (const auto& typeNode: m_sqliteIndexStorage.getAllByIds<StorageNode>(typeNodeIds))
+		for (const auto& typeNode: getStorageNodesByIds(typeNodeIds))
 		{
 			typeNames.insert(std::make_pair(
-				NameHierarchy::deserialize(typeNode.serializedName).getQualifiedName(), typeNode.id));
+				NameHierarchy::deserializeFromBinary(typeNode.serializedName).getQualifiedName(),
+				typeNode.id));
 		}
 
 		std::vector<std::pair<size_t, size_t>> locationRanges;
@@ -2500,15 +3530,16 @@ TooltipInfo PersistentStorage::getTooltipInfoForSourceLocationIdsAndLocalSymbolI
 	if (!locationIds.empty())
 	{
 		std::wstring fileLanguage = getFileNodeLanguage(
-			m_sqliteIndexStorage.getFirstById<StorageSourceLocation>(locationIds.front()).fileNodeId);
+			getStorageSourceLocationById(locationIds.front()).fileNodeId);
 
 		const std::vector<Id> nodeIds = getNodeIdsForLocationIds(locationIds);
 
-		for (const StorageNode& node: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+		for (const StorageNode& node: getStorageNodesByIds(nodeIds))
 		{
 			TooltipSnippet snippet;
 
-			const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+			const NameHierarchy nameHierarchy = NameHierarchy::deserializeFromBinary(
+				node.serializedName);
 			snippet.code = nameHierarchy.getQualifiedName();
 			snippet.locationFile = std::make_shared<SourceLocationFile>(
 				FilePath(L"main.txt"), fileLanguage, true, true, true);
@@ -2551,16 +3582,19 @@ Id PersistentStorage::getFileNodeId(const FilePath& filePath) const
 		return 0;
 	}
 
+	// handles of strings that were never added are 0, which no file uses
+	const InternedStringPool* pool = InternedStringPool::getInstance();
+	if (const InternedStringPool::Handle handle = pool->find(filePath.wstr()))
 	{
-		std::map<FilePath, Id>::const_iterator it = m_fileNodeIds.find(filePath);
+		auto it = m_fileNodeIds.find(handle);
 		if (it != m_fileNodeIds.end())
 		{
 			return it->second;
 		}
 	}
+	if (const InternedStringPool::Handle handle = pool->find(filePath.getLowerCase().wstr()))
 	{
-		std::map<FilePath, Id>::const_iterator it = m_lowerCasefileNodeIds.find(
-			filePath.getLowerCase());
+		auto it = m_lowerCasefileNodeIds.find(handle);
 		if (it != m_lowerCasefileNodeIds.end())
 		{
 			return it->second;
@@ -2598,16 +3632,34 @@ FilePath PersistentStorage::getFileNodePath(Id fileId) const
 		return FilePath();
 	}
 
-	std::map<Id, FilePath>::const_iterator it = m_fileNodePaths.find(fileId);
+	auto it = m_fileNodePaths.find(fileId);
 
 	if (it != m_fileNodePaths.end())
 	{
-		return it->second;
+		return FilePath(InternedStringPool::getInstance()->getString(it->second));
 	}
 
 	return FilePath();
 }
 
+FilePath PersistentStorage::getFilePathOfFileToken(Id tokenId) const
+{
+	FilePath path = getFileNodePath(tokenId);
+
+	// check for non-indexed file
+	if (path.empty() && m_symbolDefinitionKinds.find(tokenId) == m_symbolDefinitionKinds.end())
+	{
+		const StorageNode fileNode = getStorageNodeById(tokenId);
+		if (NodeType(NodeType::intToType(fileNode.type)).isFile())
+		{
+			path = FilePath(
+				NameHierarchy::deserializeFromBinary(fileNode.serializedName).getQualifiedName());
+		}
+	}
+
+	return path;
+}
+
 bool PersistentStorage::getFileNodeComplete(Id fileId) const
 {
 	auto it = m_fileNodeComplete.find(fileId);
@@ -2635,7 +3687,7 @@ std::wstring PersistentStorage::getFileNodeLanguage(Id fileId) const
 	auto it = m_fileNodeLanguage.find(fileId);
 	if (it != m_fileNodeLanguage.end())
 	{
-		return it->second;
+		return InternedStringPool::getInstance()->getString(it->second);
 	}
 
 	return L"";
@@ -2645,7 +3697,7 @@ std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToIncludingFile
 {
 	std::unordered_map<Id, std::set<Id>> fileIdToIncludingFileIdMap;
 
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
+	getReadIndexStorage()->forEachOfType<StorageEdge>(
 		Edge::typeToInt(Edge::EDGE_INCLUDE), [&fileIdToIncludingFileIdMap](StorageEdge&& edge) {
 			fileIdToIncludingFileIdMap[edge.targetNodeId].insert(edge.sourceNodeId);
 		});
@@ -2657,7 +3709,7 @@ std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToIncludedFileI
 {
 	std::unordered_map<Id, std::set<Id>> fileIdToIncludingFileIdMap;
 
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
+	getReadIndexStorage()->forEachOfType<StorageEdge>(
 		Edge::typeToInt(Edge::EDGE_INCLUDE), [&fileIdToIncludingFileIdMap](StorageEdge&& edge) {
 			fileIdToIncludingFileIdMap[edge.sourceNodeId].insert(edge.targetNodeId);
 		});
@@ -2672,7 +3724,7 @@ std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToImportingFile
 		std::vector<Id> importedElementIds;
 		std::map<Id, std::set<Id>> elementIdToImportingFileIds;
 
-		m_sqliteIndexStorage.forEachOfType<StorageEdge>(
+		getReadIndexStorage()->forEachOfType<StorageEdge>(
 			Edge::typeToInt(Edge::EDGE_IMPORT),
 			[&importedElementIds, &elementIdToImportingFileIds](StorageEdge&& edge) {
 				importedElementIds.push_back(edge.targetNodeId);
@@ -2684,14 +3736,14 @@ std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToImportingFile
 			std::vector<Id> importedSourceLocationIds;
 			std::unordered_map<Id, Id> importedSourceLocationToElementIds;
 			for (const StorageOccurrence& occurrence:
-				 m_sqliteIndexStorage.getOccurrencesForElementIds(importedElementIds))
+				 getOccurrencesForElementIds(importedElementIds))
 			{
 				importedSourceLocationIds.push_back(occurrence.sourceLocationId);
 				importedSourceLocationToElementIds[occurrence.sourceLocationId] = occurrence.elementId;
 			}
 
 			for (const StorageSourceLocation& sourceLocation:
-				 m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(importedSourceLocationIds))
+				 getStorageSourceLocationsByIds(importedSourceLocationIds))
 			{
 				auto it = importedSourceLocationToElementIds.find(sourceLocation.id);
 				if (it != importedSourceLocationToElementIds.end())
@@ -2714,105 +3766,92 @@ std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToImportingFile
 	return fileIdToImportingFileIdMap;
 }
 
-std::set<Id> PersistentStorage::getReferenced(
-	const std::set<Id>& ids, std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const
+std::shared_ptr<TextAccess> PersistentStorage::getFileContent(
+	const FilePath& filePath, FileContentCache::Consumer consumer) const
 {
-	std::unordered_map<Id, std::set<Id>> idToReferencedIdMap;
-	for (const auto& it: idToReferencingIdMap)
+	std::shared_ptr<TextAccess> fileContent = getStoredFileContent(filePath, consumer);
+	if (fileContent->getLineCount() > 0)
 	{
-		for (Id referencingId: it.second)
-		{
-			idToReferencedIdMap[referencingId].insert(it.first);
-		}
+		return fileContent;
 	}
-
-	return getReferencing(ids, idToReferencedIdMap);
+	return TextAccess::createFromFile(filePath);
 }
 
-std::set<Id> PersistentStorage::getReferencing(
-	const std::set<Id>& ids, std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const
+std::shared_ptr<TextAccess> PersistentStorage::getStoredFileContent(
+	const StorageFile& file, FileContentCache::Consumer consumer) const
 {
-	std::set<Id> referencingIds;
-
-	std::set<Id> processingIds = ids;
-	std::set<Id> processedIds;
-
-	while (!processingIds.empty())
+	if (!file.id)
 	{
-		std::set<Id> tempIds = processingIds;
-		utility::append(processedIds, processingIds);
-		processingIds.clear();
-
-		for (Id id: tempIds)
-		{
-			utility::append(referencingIds, idToReferencingIdMap[id]);
-			for (Id referencingId: idToReferencingIdMap[id])
-			{
-				if (processedIds.find(referencingId) == processedIds.end())
-				{
-					processingIds.insert(referencingId);
-				}
-			}
-		}
+		return TextAccess::createFromString("");
 	}
 
-	return referencingIds;
+	const Id fileId = file.id;
+	return FileContentCache::getInstance()->getText(
+		{file.id, m_contentVersion, file.modificationTime}, consumer, [this, fileId]() {
+			return getReadIndexStorage()->getFileContentById(fileId);
+		});
 }
 
-std::set<FilePath> PersistentStorage::getReferencedByIncludes(const std::set<FilePath>& filePaths) const
+std::shared_ptr<const FileContentCache::DecodedContent> PersistentStorage::getDecodedFileContent(
+	const FilePath& filePath, const TextCodec& codec, FileContentCache::Consumer consumer) const
 {
-	const std::set<Id> ids = getReferenced(
-		getFileNodeIds(filePaths), getFileIdToIncludingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
-	{	 // TODO: performance optimize: use just one request for all ids!
-		paths.insert(getFileNodePath(id));
+	const StorageFile file = getReadIndexStorage()->getFileByPath(filePath.wstr());
+	if (file.id)
+	{
+		const Id fileId = file.id;
+		std::shared_ptr<const FileContentCache::DecodedContent> decodedContent =
+			FileContentCache::getInstance()->getDecodedContent(
+				{file.id, m_contentVersion, file.modificationTime},
+				codec,
+				consumer,
+				[this, fileId]() { return getReadIndexStorage()->getFileContentById(fileId); });
+		if (!decodedContent->lines.empty())
+		{
+			return decodedContent;
+		}
 	}
-
-	return paths;
+	return FileContentCache::decode(*TextAccess::createFromFile(filePath), codec);
 }
 
-std::set<FilePath> PersistentStorage::getReferencedByImports(const std::set<FilePath>& filePaths) const
+bool PersistentStorage::getSourceLocationsMovedToContent(
+	const StorageFile& file,
+	const std::string& content,
+	std::vector<StorageSourceLocation>* locations) const
 {
-	const std::set<Id> ids = getReferenced(
-		getFileNodeIds(filePaths), getFileIdToImportingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
+	// the layout of other languages doesn't follow C comment rules or columns don't count bytes
+	if (!file.id || !file.indexed || (file.languageIdentifier != L"cpp" && file.languageIdentifier != L"c"))
 	{
-		paths.insert(getFileNodePath(id));
+		return false;
 	}
 
-	return paths;
-}
-
-std::set<FilePath> PersistentStorage::getReferencingByIncludes(const std::set<FilePath>& filePaths) const
-{
-	const std::set<Id> ids = getReferencing(
-		getFileNodeIds(filePaths), getFileIdToIncludingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
+	const std::string codeHash = getReadIndexStorage()->getFileCodeHash(file.id);
+	if (codeHash.empty() || codeHash != TextLayoutMapping::getCodeHash(content))
 	{
-		paths.insert(getFileNodePath(id));
+		return false;
 	}
 
-	return paths;
-}
-
-std::set<FilePath> PersistentStorage::getReferencingByImports(const std::set<FilePath>& filePaths) const
-{
-	const std::set<Id> ids = getReferencing(
-		getFileNodeIds(filePaths), getFileIdToImportingFileIdMap());
+	const TextLayoutMapping mapping(
+		getStoredFileContent(file, FileContentCache::CONSUMER_REFRESH)->getText(), content);
+	if (!mapping.isValid())
+	{
+		return false;
+	}
 
-	std::set<FilePath> paths;
-	for (Id id: ids)
+	for (StorageSourceLocation location: getReadIndexStorage()->getSourceLocationsByFileId(file.id))
 	{
-		paths.insert(getFileNodePath(id));
+		if (!mapping.mapPosition(location.startLine, location.startCol) ||
+			!mapping.mapPosition(location.endLine, location.endCol))
+		{
+			return false;
+		}
+
+		if (locations)
+		{
+			locations->push_back(location);
+		}
 	}
 
-	return paths;
+	return true;
 }
 
 void PersistentStorage::addNodesToGraph(
@@ -2841,9 +3880,10 @@ void PersistentStorage::addNodesToGraph(
 		return;
 	}
 
-	for (const StorageNode& storageNode: m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIds))
+	for (const StorageNode& storageNode: getStorageNodesByIds(nodeIds))
 	{
-		NameHierarchy nameHierarchy = NameHierarchy::deserialize(storageNode.serializedName);
+		NameHierarchy nameHierarchy = NameHierarchy::deserializeFromBinary(
+			storageNode.serializedName);
 
 		const NodeType type(NodeType::intToType(storageNode.type));
 		if (type.isFile())
@@ -2897,7 +3937,7 @@ void PersistentStorage::addEdgesToGraph(const std::vector<Id>& newEdgeIds, Graph
 		return;
 	}
 
-	for (const StorageEdge& storageEdge: m_sqliteIndexStorage.getAllByIds<StorageEdge>(edgeIds))
+	for (const StorageEdge& storageEdge: getReadIndexStorage()->getAllByIds<StorageEdge>(edgeIds))
 	{
 		Node* sourceNode = graph->getNodeById(storageEdge.sourceNodeId);
 		Node* targetNode = graph->getNodeById(storageEdge.targetNodeId);
@@ -2934,7 +3974,7 @@ void PersistentStorage::addNodesWithParentsAndEdgesToGraph(
 
 	if (edgeIds.size() > 0)
 	{
-		for (const StorageEdge& storageEdge: m_sqliteIndexStorage.getAllByIds<StorageEdge>(edgeIds))
+		for (const StorageEdge& storageEdge: getReadIndexStorage()->getAllByIds<StorageEdge>(edgeIds))
 		{
 			allNodeIds.insert(storageEdge.sourceNodeId);
 			allNodeIds.insert(storageEdge.targetNodeId);
@@ -2964,61 +4004,67 @@ void PersistentStorage::addAggregationEdgesToGraph(
 		bool forward;
 	};
 
-	// build aggregation edges:
-	// get all children of the active node
-	std::set<Id> childNodeIdsSet, edgeIdsSet;
-	m_hierarchyCache.addAllChildIdsForNodeId(nodeId, &childNodeIdsSet, &edgeIdsSet);
-	const std::vector<Id> childNodeIds = utility::toVector(childNodeIdsSet);
-	if (childNodeIds.size() == 0 && edgesToAggregate.size() == 0)
-	{
-		return;
-	}
+	// get all parent nodes of all connected nodes (up to last level except namespace/undefined)
+	const Id nodeParentNodeId = m_hierarchyCache.getLastVisibleParentNodeId(nodeId);
 
-	// get all edges of the children
-	std::map<Id, std::vector<EdgeInfo>> connectedNodeIds;
+	std::map<Id, std::vector<EdgeInfo>> connectedParentNodeIds;
 	for (const StorageEdge& edge: edgesToAggregate)
 	{
 		bool isSource = nodeId == edge.sourceNodeId;
-		EdgeInfo edgeInfo;
-		edgeInfo.edgeId = edge.id;
-		edgeInfo.forward = isSource;
-		connectedNodeIds[isSource ? edge.targetNodeId : edge.sourceNodeId].push_back(edgeInfo);
-	}
+		const Id parentNodeId = m_hierarchyCache.getLastVisibleParentNodeId(
+			isSource ? edge.targetNodeId : edge.sourceNodeId);
 
-	const std::vector<StorageEdge> outgoingEdges = m_sqliteIndexStorage.getEdgesBySourceIds(
-		childNodeIds);
-	for (const StorageEdge& outEdge: outgoingEdges)
-	{
-		EdgeInfo edgeInfo;
-		edgeInfo.edgeId = outEdge.id;
-		edgeInfo.forward = true;
-		connectedNodeIds[outEdge.targetNodeId].push_back(edgeInfo);
+		if (parentNodeId != nodeParentNodeId)
+		{
+			connectedParentNodeIds[parentNodeId].push_back({edge.id, isSource});
+		}
 	}
 
-	const std::vector<StorageEdge> incomingEdges = m_sqliteIndexStorage.getEdgesByTargetIds(
-		childNodeIds);
-	for (const StorageEdge& inEdge: incomingEdges)
+	// the edges of all children of a node that is its own last visible parent are precomputed
+	std::vector<AggregationCache::AggregatedEdge> aggregatedEdges;
+	if (nodeParentNodeId == nodeId &&
+		m_aggregationCache.getAggregatedEdges(nodeId, &aggregatedEdges))
 	{
-		EdgeInfo edgeInfo;
-		edgeInfo.edgeId = inEdge.id;
-		edgeInfo.forward = false;
-		connectedNodeIds[inEdge.sourceNodeId].push_back(edgeInfo);
+		for (const AggregationCache::AggregatedEdge& edge: aggregatedEdges)
+		{
+			connectedParentNodeIds[Id(edge.parentId)].push_back({Id(edge.edgeId), edge.forward});
+		}
 	}
+	else
+	{
+		// build aggregation edges:
+		// get all children of the active node
+		std::vector<Id> childNodeIds, childEdgeIds;
+		m_hierarchyCache.addAllChildIdsForNodeId(nodeId, &childNodeIds, &childEdgeIds);
 
-	// get all parent nodes of all connected nodes (up to last level except namespace/undefined)
-	const Id nodeParentNodeId = m_hierarchyCache.getLastVisibleParentNodeId(nodeId);
+		// get all edges of the children
+		std::map<Id, std::vector<EdgeInfo>> connectedNodeIds;
+		for (const StorageEdge& outEdge: getEdgesBySourceIds(childNodeIds))
+		{
+			connectedNodeIds[outEdge.targetNodeId].push_back({outEdge.id, true});
+		}
 
-	std::map<Id, std::vector<EdgeInfo>> connectedParentNodeIds;
-	for (const std::pair<Id, std::vector<EdgeInfo>>& p: connectedNodeIds)
-	{
-		const Id parentNodeId = m_hierarchyCache.getLastVisibleParentNodeId(p.first);
+		for (const StorageEdge& inEdge: getEdgesByTargetIds(childNodeIds))
+		{
+			connectedNodeIds[inEdge.sourceNodeId].push_back({inEdge.id, false});
+		}
 
-		if (parentNodeId != nodeParentNodeId)
+		for (const std::pair<Id, std::vector<EdgeInfo>>& p: connectedNodeIds)
 		{
-			utility::append(connectedParentNodeIds[parentNodeId], p.second);
+			const Id parentNodeId = m_hierarchyCache.getLastVisibleParentNodeId(p.first);
+
+			if (parentNodeId != nodeParentNodeId)
+			{
+				utility::append(connectedParentNodeIds[parentNodeId], p.second);
+			}
 		}
 	}
 
+	if (connectedParentNodeIds.empty())
+	{
+		return;
+	}
+
 	// add hierarchies of these parents
 	std::vector<Id> nodeIdsToAdd;
 	for (const std::pair<Id, std::vector<EdgeInfo>>& p: connectedParentNodeIds)
@@ -3070,7 +4116,7 @@ void PersistentStorage::addFileContentsToGraph(Id fileId, Graph* graph) const
 	std::set<Id> tokenIdsSet;
 
 	std::shared_ptr<SourceLocationFile> locationFile =
-		m_sqliteIndexStorage.getSourceLocationsForFile(path);
+		getReadIndexStorage()->getSourceLocationsForFile(path);
 	locationFile->forEachStartSourceLocation([this, &tokenIds, &tokenIdsSet](SourceLocation* location) {
 		if (location->getType() != LOCATION_TOKEN)
 		{
@@ -3116,7 +4162,7 @@ void PersistentStorage::addComponentAccessToGraph(Graph* graph) const
 	graph->forEachNode([&nodeIds](Node* node) { nodeIds.push_back(node->getId()); });
 
 	std::vector<StorageComponentAccess> accesses =
-		m_sqliteIndexStorage.getComponentAccessesByNodeIds(nodeIds);
+		getReadIndexStorage()->getComponentAccessesByNodeIds(nodeIds);
 	for (const StorageComponentAccess& access: accesses)
 	{
 		if (access.nodeId != 0)
@@ -3136,7 +4182,7 @@ void PersistentStorage::addComponentIsAmbiguousToGraph(Graph* graph) const
 
 	int componentKind = elementComponentKindToInt(ElementComponentKind::IS_AMBIGUOUS);
 	for (const StorageElementComponent& component:
-		 m_sqliteIndexStorage.getElementComponentsByElementIds(edgeIds))
+		 getReadIndexStorage()->getElementComponentsByElementIds(edgeIds))
 	{
 		if (component.type == componentKind)
 		{
@@ -3146,6 +4192,19 @@ void PersistentStorage::addComponentIsAmbiguousToGraph(Graph* graph) const
 	}
 }
 
+std::shared_ptr<Graph> PersistentStorage::createTrailGraph(
+	const std::set<Id>& nodeIds, const std::set<Id>& edgeIds) const
+{
+	std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+
+	addNodesWithParentsAndEdgesToGraph(
+		utility::toVector(nodeIds), utility::toVector(edgeIds), graph.get(), false);
+	addComponentAccessToGraph(graph.get());
+	addComponentIsAmbiguousToGraph(graph.get());
+
+	return graph;
+}
+
 void PersistentStorage::addCompleteFlagsToSourceLocationCollection(
 	SourceLocationCollection* collection) const
 {
@@ -3231,21 +4290,28 @@ void PersistentStorage::buildFilePathMaps()
 {
 	TRACE();
 
+	InternedStringPool* pool = InternedStringPool::getInstance();
 	m_sqliteIndexStorage.forEach<StorageFile>([&](StorageFile&& file) {
 		const FilePath path(file.filePath);
+		const InternedStringPool::Handle pathHandle = pool->intern(path.wstr());
 
-		m_fileNodeIds.emplace(path, file.id);
-		m_lowerCasefileNodeIds.emplace(path.getLowerCase(), file.id);
-		m_fileNodePaths.emplace(file.id, path);
+		m_fileNodeIds.emplace(pathHandle, file.id);
+		m_lowerCasefileNodeIds.emplace(pool->intern(path.getLowerCase().wstr()), file.id);
+		m_fileNodePaths.emplace(file.id, pathHandle);
 		m_fileNodeComplete.emplace(file.id, file.complete);
 		m_fileNodeIndexed.emplace(file.id, file.indexed);
-		m_fileNodeLanguage.emplace(file.id, file.languageIdentifier);
+		m_fileNodeLanguage.emplace(file.id, pool->intern(file.languageIdentifier));
 
 		if (!m_hasJavaFiles && path.extension() == L".java")
 		{
 			m_hasJavaFiles = true;
 		}
 	});
+}
+
+void PersistentStorage::buildSymbolDefinitionKindMap()
+{
+	TRACE();
 
 	m_sqliteIndexStorage.forEach<StorageSymbol>([&](StorageSymbol&& symbol) {
 		m_symbolDefinitionKinds.emplace(symbol.id, intToDefinitionKind(symbol.definitionKind));
@@ -3256,59 +4322,301 @@ void PersistentStorage::buildSearchIndex()
 {
 	TRACE();
 
-	const FilePath dbPath = getIndexDbFilePath();
+	buildFileIndex();
 
-	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
-		const NodeType type = NodeType::intToType(node.type);
-		if (type.isFile())
+	if (m_lowMemoryMode)
+	{
+		if (!m_sqliteIndexStorage.hasSearchNames())
 		{
-			bool indexed = getFileNodeIndexed(node.id);
-			if (!indexed)
-			{
-				return;
-			}
+			buildSearchNames();
+		}
+		return;
+	}
 
-			auto it = m_fileNodePaths.find(node.id);
-			if (it != m_fileNodePaths.end())
-			{
-				FilePath filePath(it->second);
+	// the shard list holds the name and the contained node types of each stored shard per line
+	SymbolIndexShards shards;
+	{
+		std::istringstream shardList(
+			m_sqliteIndexStorage.getSearchIndexData(s_symbolShardListName));
+		std::string name;
+		NodeType::TypeMask typeMask = 0;
+		while (shardList >> name >> typeMask)
+		{
+			std::shared_ptr<SymbolIndexShard> shard = std::make_shared<SymbolIndexShard>();
+			shard->name = name;
+			shard->nodeTypes = NodeTypeSet::all().getWithMatchingKept(
+				[typeMask](const NodeType& type) { return (type.getType() & typeMask) != 0; });
+			shards.push_back(shard);
+		}
+	}
 
-				if (filePath.exists())
-				{
-					filePath.makeRelativeTo(dbPath);
-				}
+	if (shards.empty())
+	{
+		shards = buildSymbolIndexShards();
+	}
 
-				m_fileIndex.addNode(node.id, filePath.wstr(), type);
+	std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+	m_symbolIndexShards = shards;
+}
+
+void PersistentStorage::buildSearchNames()
+{
+	TRACE();
+
+	const std::unordered_map<Id, uint32_t> referenceCounts = getSymbolReferenceCounts();
+
+	// written in one transaction, so the names are either all stored or missing
+	m_sqliteIndexStorage.beginTransaction();
+	m_sqliteIndexStorage.forEachRow<Id, int, SqliteIndexStorage::ColumnText>(
+		"SELECT id, type, serialized_name FROM node;",
+		[&](Id nodeId, int nodeType, const SqliteIndexStorage::ColumnText& serializedName) {
+			const std::wstring name = getSymbolSearchName(
+				nodeId, nodeType, NameHierarchy::deserializeFromBinary(serializedName.str()));
+			if (!name.empty())
+			{
+				auto referenceIt = referenceCounts.find(nodeId);
+				m_sqliteIndexStorage.addSearchName(
+					nodeId,
+					nodeType,
+					referenceIt != referenceCounts.end() ? referenceIt->second : 0,
+					name);
 			}
+		});
+	m_sqliteIndexStorage.commitTransaction();
+}
+
+std::vector<SearchResult> PersistentStorage::searchSymbolNames(
+	const std::wstring& query,
+	const NodeTypeSet& acceptedNodeTypes,
+	size_t maxResultsCount,
+	size_t maxBestScoredResultsLength,
+	const std::function<bool()>& isCancelled) const
+{
+	// names containing the ascii letters and digits of the query in the same order hold all fuzzy
+	// matches, LIKE ignores their case just like the search index
+	std::string pattern = "%";
+	for (wchar_t c: query)
+	{
+		if ((c >= L'0' && c <= L'9') || (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z'))
+		{
+			pattern += char(c);
+			pattern += '%';
 		}
-		else
+	}
+
+	NodeType::TypeMask typeMask = 0;
+	for (const NodeType& type: acceptedNodeTypes.getNodeTypes())
+	{
+		typeMask |= type.getType();
+	}
+
+	// only the candidates are kept in memory for scoring
+	SearchIndex index;
+	getReadIndexStorage()->forEachSearchName(
+		pattern,
+		typeMask,
+		s_maxSearchNameCandidateCount,
+		[&index](Id nodeId, int nodeType, uint32_t referenceCount, std::wstring&& name) {
+			index.addNode(nodeId, std::move(name), NodeType::intToType(nodeType), referenceCount);
+		});
+	if (isCancelled && isCancelled())
+	{
+		return {};
+	}
+	index.finishSetup();
+	{
+		std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
+		index.setRecentIds(m_recentNodeIds);
+	}
+
+	return index.search(
+		query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength, isCancelled);
+}
+
+void PersistentStorage::buildFileIndex()
+{
+	// file paths are relative to the database location, so only the symbols are kept in the database
+	const FilePath dbPath = getIndexDbFilePath();
+	for (const auto& p: m_fileNodePaths)
+	{
+		if (getFileNodeIndexed(p.first))
 		{
-			auto it = m_symbolDefinitionKinds.find(node.id);
-			const DefinitionKind defKind =
-				(it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
-			if (defKind != DEFINITION_IMPLICIT)
+			FilePath filePath(InternedStringPool::getInstance()->getString(p.second));
+			if (filePath.exists())
+			{
+				filePath.makeRelativeTo(dbPath);
+			}
+			m_fileIndex.addNode(p.first, filePath.wstr(), NodeType::NODE_FILE);
+		}
+	}
+	m_fileIndex.finishSetup();
+}
+
+std::unordered_map<Id, uint32_t> PersistentStorage::getSymbolReferenceCounts() const
+{
+	std::unordered_map<Id, uint32_t> referenceCounts;
+	m_sqliteIndexStorage.forEachRow<Id, int>(
+		"SELECT target_node_id, type FROM edge;", [&](Id targetNodeId, int edgeType) {
+			if (Edge::intToType(edgeType) != Edge::EDGE_MEMBER)
 			{
-				const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+				referenceCounts[targetNodeId]++;
+			}
+		});
+	return referenceCounts;
+}
 
-				// we don't use the signature here, so elements with the same signature share the
-				// same node.
-				std::wstring name = nameHierarchy.getQualifiedName();
+PersistentStorage::SymbolIndexShards PersistentStorage::buildSymbolIndexShards()
+{
+	const std::unordered_map<Id, uint32_t> referenceCounts = getSymbolReferenceCounts();
 
-				// replace template arguments with .. to avoid clutter in search results and have
-				// different template specializations share the same node.
-				if (defKind == DEFINITION_NONE &&
-					nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
-				{
-					name = utility::replaceBetween(name, L'<', L'>', L"..");
-				}
+	SymbolIndexShardMap shards;
+	m_sqliteIndexStorage.forEachRow<Id, int, SqliteIndexStorage::ColumnText>(
+		"SELECT id, type, serialized_name FROM node;",
+		[&](Id nodeId, int nodeType, const SqliteIndexStorage::ColumnText& serializedName) {
+			auto referenceIt = referenceCounts.find(nodeId);
+			addSymbolToIndexShards(
+				nodeId,
+				nodeType,
+				serializedName.str(),
+				referenceIt != referenceCounts.end() ? referenceIt->second : 0,
+				&shards);
+		});
+
+	return storeSymbolIndexShards(shards);
+}
+
+std::wstring PersistentStorage::getSymbolSearchName(
+	Id nodeId, int nodeType, const NameHierarchy& nameHierarchy) const
+{
+	const NodeType type = NodeType::intToType(nodeType);
+	if (type.isFile())
+	{
+		return L"";
+	}
+
+	auto it = m_symbolDefinitionKinds.find(nodeId);
+	const DefinitionKind defKind =
+		(it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
+	if (defKind == DEFINITION_IMPLICIT)
+	{
+		return L"";
+	}
+
+	const NameDelimiterType delimiterType = stringToNameDelimiterType(
+		nameHierarchy.getDelimiter());
+
+	// we don't use the signature here, so elements with the same signature share the
+	// same node.
+	std::wstring name = nameHierarchy.getQualifiedName();
+
+	// replace template arguments with .. to avoid clutter in search results and have
+	// different template specializations share the same node.
+	if (defKind == DEFINITION_NONE && delimiterType == NAME_DELIMITER_CXX)
+	{
+		name = utility::replaceBetween(name, L'<', L'>', L"..");
+	}
+	return name;
+}
+
+void PersistentStorage::addSymbolToIndexShards(
+	Id nodeId,
+	int nodeType,
+	const std::string& serializedName,
+	uint32_t referenceCount,
+	SymbolIndexShardMap* shards) const
+{
+	const NameHierarchy nameHierarchy = NameHierarchy::deserializeFromBinary(serializedName);
+	std::wstring name = getSymbolSearchName(nodeId, nodeType, nameHierarchy);
+	if (name.empty())
+	{
+		return;
+	}
+
+	const NameDelimiterType delimiterType = stringToNameDelimiterType(
+		nameHierarchy.getDelimiter());
+	const std::string shardName = "symbol_" + std::to_string(int(delimiterType));
+	std::shared_ptr<SymbolIndexShard>& shard = (*shards)[shardName];
+	if (!shard)
+	{
+		shard = std::make_shared<SymbolIndexShard>();
+		shard->name = shardName;
+		shard->loaded = true;
+	}
+
+	shard->index.addNode(nodeId, std::move(name), NodeType::intToType(nodeType), referenceCount);
+}
+
+PersistentStorage::SymbolIndexShards PersistentStorage::storeSymbolIndexShards(
+	const SymbolIndexShardMap& shards)
+{
+	SymbolIndexShards ret;
+	std::string shardList;
+	for (auto& p: shards)
+	{
+		std::shared_ptr<SymbolIndexShard> shard = p.second;
+		shard->index.finishSetup();
+		shard->index.setRecentIds(m_recentNodeIds);
+		shard->nodeTypes = shard->index.getContainedNodeTypes();
+
+		NodeType::TypeMask typeMask = 0;
+		for (const NodeType& type: shard->nodeTypes.getNodeTypes())
+		{
+			typeMask |= type.getType();
+		}
+
+		m_sqliteIndexStorage.setSearchIndexData(shard->name, shard->index.serialize());
+		shardList += shard->name + " " + std::to_string(typeMask) + "\n";
+		ret.push_back(shard);
+	}
+
+	// written last, so shards are only taken from the database once all of them are stored
+	m_sqliteIndexStorage.setSearchIndexData(s_symbolShardListName, shardList);
+	return ret;
+}
+
+PersistentStorage::SymbolIndexShards PersistentStorage::getLoadedSymbolIndexShards(
+	NodeTypeSet acceptedNodeTypes) const
+{
+	std::lock_guard<std::mutex> lock(m_symbolIndexShardsMutex);
 
-				m_symbolIndex.addNode(node.id, std::move(name), type);
+	SymbolIndexShards shards;
+	SymbolIndexShards unloadedShards;
+	for (const std::shared_ptr<SymbolIndexShard>& shard: m_symbolIndexShards)
+	{
+		if (shard->nodeTypes.intersectsWith(acceptedNodeTypes))
+		{
+			shards.push_back(shard);
+			if (!shard->loaded)
+			{
+				unloadedShards.push_back(shard);
 			}
 		}
-	});
+	}
 
-	m_symbolIndex.finishSetup();
-	m_fileIndex.finishSetup();
+	// the data is read one after another, deserializing is spread across threads
+	std::vector<std::future<void>> jobs;
+	for (const std::shared_ptr<SymbolIndexShard>& shard: unloadedShards)
+	{
+		std::string data = getReadIndexStorage()->getSearchIndexData(shard->name);
+		jobs.push_back(TaskManager::getThreadPool()->run(
+			[this, shard, data]() {
+				if (!shard->index.deserialize(data))
+				{
+					LOG_ERROR(
+						"Search index shard \"" + shard->name + "\" is malformed and was skipped.");
+				}
+				shard->index.setRecentIds(m_recentNodeIds);
+			},
+			ThreadPool::PRIORITY_INTERACTIVE));
+		shard->loaded = true;
+	}
+
+	for (std::future<void>& job: jobs)
+	{
+		job.wait();
+	}
+
+	return shards;
 }
 
 void PersistentStorage::buildFullTextSearchIndex() const
@@ -3321,39 +4629,110 @@ void PersistentStorage::buildFullTextSearchIndex() const
 
 	m_fullTextSearchIndex.clear();
 
-	std::vector<std::shared_ptr<std::thread>> threads;
+	std::vector<StorageFile> indexedFiles;
+	for (const StorageFile& file: getReadIndexStorage()->getAll<StorageFile>())
 	{
-		std::vector<StorageFile> indexedFiles;
-		for (const StorageFile& file: m_sqliteIndexStorage.getAll<StorageFile>())
+		if (file.indexed)
 		{
-			if (file.indexed)
+			indexedFiles.push_back(file);
+		}
+	}
+
+	std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+	const std::vector<std::vector<StorageFile>> parts = utility::splitToEqualySizedParts(
+		indexedFiles, threadPool->getWorkerCount());
+	threadPool->parallelFor(
+		parts.size(),
+		[&](size_t i) {
+			for (const StorageFile& file: parts[i])
 			{
-				indexedFiles.push_back(file);
+				m_fullTextSearchIndex.addFile(
+					file.id,
+					codec.decode(getReadIndexStorage()->getFileContentById(file.id)->getText()),
+					getReadIndexStorage()->getFullTextSearchIndexDataById(
+						file.id, m_fullTextSearchCodec));
 			}
-		}
-		for (std::vector<StorageFile> part:
-			 utility::splitToEqualySizedParts(indexedFiles, utility::getIdealThreadCount()))
+		},
+		ThreadPool::PRIORITY_INDEXING);
+}
+
+void PersistentStorage::updateFullTextSearchIndex()
+{
+	TRACE();
+
+	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+	const std::string codecName = codec.getName();
+
+	const std::set<Id> upToDateFileIds =
+		m_sqliteIndexStorage.getFileIdsWithFullTextSearchIndexData(codecName);
+
+	std::vector<Id> fileIds;
+	for (const StorageFile& file: m_sqliteIndexStorage.getAll<StorageFile>())
+	{
+		if (file.indexed && upToDateFileIds.find(file.id) == upToDateFileIds.end())
 		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[&](const std::vector<StorageFile>& files) {
-					for (const StorageFile& file: files)
-					{
-						m_fullTextSearchIndex.addFile(
-							file.id,
-							codec.decode(m_sqliteIndexStorage.getFileContentById(file.id)->getText()));
-					}
-				},
-				part);
-			threads.push_back(thread);
+			fileIds.push_back(file.id);
 		}
 	}
-	for (std::shared_ptr<std::thread> thread: threads)
+
+	if (fileIds.empty())
+	{
+		return;
+	}
+
+	LOG_INFO("Building fulltext search data for " + std::to_string(fileIds.size()) + " files");
+
+	// limit the amount of serialized data that is kept in memory before it gets written
+	std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+	const size_t threadCount = threadPool->getWorkerCount();
+	const size_t chunkSize = threadCount * 16;
+
+	m_sqliteIndexStorage.beginTransaction();
+	for (size_t chunkStart = 0; chunkStart < fileIds.size(); chunkStart += chunkSize)
 	{
-		thread->join();
+		const std::vector<Id> chunk(
+			fileIds.begin() + chunkStart,
+			fileIds.begin() + std::min(chunkStart + chunkSize, fileIds.size()));
+
+		std::vector<std::pair<Id, std::string>> serializedArrays;
+		std::mutex serializedArraysMutex;
+
+		const std::vector<std::vector<Id>> parts = utility::splitToEqualySizedParts(
+			chunk, threadCount);
+		threadPool->parallelFor(
+			parts.size(),
+			[&](size_t i) {
+				for (Id fileId: parts[i])
+				{
+					std::wstring content = codec.decode(
+						m_sqliteIndexStorage.getFileContentById(fileId)->getText());
+					if (content.empty())
+					{
+						continue;
+					}
+
+					std::string data = SuffixArray(content).serialize();
+
+					std::lock_guard<std::mutex> lock(serializedArraysMutex);
+					serializedArrays.emplace_back(fileId, std::move(data));
+				}
+			},
+			ThreadPool::PRIORITY_INDEXING);
+
+		for (const std::pair<Id, std::string>& p: serializedArrays)
+		{
+			m_sqliteIndexStorage.addFullTextSearchIndexData(p.first, codecName, p.second);
+		}
 	}
+	m_sqliteIndexStorage.commitTransaction();
+
+	std::lock_guard<std::mutex> lock(m_fullTextSearchMutex);
+	m_fullTextSearchIndex.clear();
+	m_fullTextSearchCodec = "";
 }
 
-void PersistentStorage::buildMemberEdgeIdOrderMap()
+void PersistentStorage::buildMemberEdgeIdOrderMap(
+	const SqliteIndexStoragePool::ScopedStorage& storage)
 {
 	TRACE();
 
@@ -3365,7 +4744,7 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 	std::vector<Id> childNodeIds;
 	std::unordered_map<Id, Id> childIdToMemberEdgeIdMap;
 
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
+	storage->forEachOfType<StorageEdge>(
 		Edge::typeToInt(Edge::EDGE_MEMBER),
 		[&childNodeIds, &childIdToMemberEdgeIdMap](StorageEdge&& edge) {
 			childNodeIds.push_back(edge.targetNodeId);
@@ -3374,8 +4753,7 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 
 	std::vector<Id> locationIds;
 	std::unordered_map<Id, Id> locationIdToElementIdMap;
-	for (const StorageOccurrence& occurrence:
-		 m_sqliteIndexStorage.getOccurrencesForElementIds(childNodeIds))
+	for (const StorageOccurrence& occurrence: storage->getOccurrencesForElementIds(childNodeIds))
 	{
 		locationIds.push_back(occurrence.sourceLocationId);
 		locationIdToElementIdMap.emplace(occurrence.sourceLocationId, occurrence.elementId);
@@ -3383,7 +4761,7 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 
 	SourceLocationCollection collection;
 	for (const StorageSourceLocation& location:
-		 m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(locationIds))
+		 storage->getAllByIds<StorageSourceLocation>(locationIds))
 	{
 		const LocationType locType = intToLocationType(location.type);
 		if (locType != LOCATION_TOKEN)
@@ -3391,7 +4769,7 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 			continue;
 		}
 
-		const FilePath path(m_fileNodePaths[location.fileNodeId]);
+		const FilePath path(getFileNodePath(location.fileNodeId));
 		if (path.extension() == L".java")
 		{
 			collection.addSourceLocation(
@@ -3425,62 +4803,1000 @@ void PersistentStorage::buildMemberEdgeIdOrderMap()
 	});
 }
 
-void PersistentStorage::buildHierarchyCache()
+std::vector<StorageCacheSnapshot::HierarchyEdge> PersistentStorage::getHierarchyEdges(
+	const SqliteIndexStoragePool::ScopedStorage& storage, const std::vector<Id>* elementIds) const
 {
 	TRACE();
 
+	// edges that are or touch one of the elements are passed on in the order of their ids
+	const auto forEachEdge = [&storage, elementIds](
+								 Edge::EdgeType type, std::function<void(Id, Id, Id)> func) {
+		const std::string query =
+			"SELECT id, source_node_id, target_node_id FROM edge WHERE type == " +
+			std::to_string(Edge::typeToInt(type));
+		if (!elementIds)
+		{
+			storage->forEachRow<Id, Id, Id>(query + ";", func);
+			return;
+		}
+
+		std::map<Id, std::pair<Id, Id>> edges;
+		for (const char* column: {"id", "source_node_id", "target_node_id"})
+		{
+			storage->forEachRowByIds<Id, Id, Id>(
+				*elementIds,
+				query + " AND " + column + " IN",
+				[&edges](Id id, Id sourceNodeId, Id targetNodeId) {
+					edges.emplace(id, std::make_pair(sourceNodeId, targetNodeId));
+				});
+		}
+		for (const auto& p: edges)
+		{
+			func(p.first, p.second.first, p.second.second);
+		}
+	};
+
 	std::vector<Id> sourceNodeIds;
 	std::vector<StorageEdge> memberEdges;
 
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-		Edge::typeToInt(Edge::EDGE_MEMBER), [&sourceNodeIds, &memberEdges](StorageEdge&& edge) {
-			sourceNodeIds.push_back(edge.sourceNodeId);
-			memberEdges.emplace_back(edge);
+	forEachEdge(
+		Edge::EDGE_MEMBER,
+		[&sourceNodeIds, &memberEdges](Id id, Id sourceNodeId, Id targetNodeId) {
+			sourceNodeIds.push_back(sourceNodeId);
+			memberEdges.emplace_back(
+				id, Edge::typeToInt(Edge::EDGE_MEMBER), sourceNodeId, targetNodeId);
 		});
 
 	std::set<Id> invisibleParentSourceNodeIds;
 
-	m_sqliteIndexStorage.forEachByIds<StorageNode>(
-		sourceNodeIds, [&invisibleParentSourceNodeIds](StorageNode&& node) {
-			if (!NodeType(NodeType::intToType(node.type)).isVisibleAsParentInGraph())
+	storage->forEachRowByIds<Id, int>(
+		sourceNodeIds,
+		"SELECT id, type FROM node WHERE id IN",
+		[&invisibleParentSourceNodeIds](Id nodeId, int nodeType) {
+			if (!NodeType(NodeType::intToType(nodeType)).isVisibleAsParentInGraph())
 			{
-				invisibleParentSourceNodeIds.insert(node.id);
+				invisibleParentSourceNodeIds.insert(nodeId);
 			}
 		});
 
+	std::vector<StorageCacheSnapshot::HierarchyEdge> edges;
 	for (const StorageEdge& edge: memberEdges)
 	{
-		bool sourceIsVisible = true;
-		if (invisibleParentSourceNodeIds.find(edge.sourceNodeId) != invisibleParentSourceNodeIds.end())
+		uint32_t flags = 0;
+		if (invisibleParentSourceNodeIds.find(edge.sourceNodeId) ==
+			invisibleParentSourceNodeIds.end())
 		{
-			sourceIsVisible = false;
+			flags |= StorageCacheSnapshot::EDGE_SOURCE_VISIBLE;
 		}
 
-		bool sourceIsImplicit = false;
 		auto it = m_symbolDefinitionKinds.find(edge.sourceNodeId);
-		if (it != m_symbolDefinitionKinds.end())
+		if (it != m_symbolDefinitionKinds.end() && it->second == DEFINITION_IMPLICIT)
 		{
-			sourceIsImplicit = (it->second == DEFINITION_IMPLICIT);
+			flags |= StorageCacheSnapshot::EDGE_SOURCE_IMPLICIT;
 		}
 
-		bool targetIsImplicit = false;
 		it = m_symbolDefinitionKinds.find(edge.targetNodeId);
-		if (it != m_symbolDefinitionKinds.end())
+		if (it != m_symbolDefinitionKinds.end() && it->second == DEFINITION_IMPLICIT)
 		{
-			targetIsImplicit = (it->second == DEFINITION_IMPLICIT);
+			flags |= StorageCacheSnapshot::EDGE_TARGET_IMPLICIT;
 		}
 
-		m_hierarchyCache.createConnection(
-			edge.id,
-			edge.sourceNodeId,
-			edge.targetNodeId,
-			sourceIsVisible,
-			sourceIsImplicit,
-			targetIsImplicit);
+		edges.push_back(
+			{uint64_t(edge.id), uint64_t(edge.sourceNodeId), uint64_t(edge.targetNodeId), flags});
 	}
 
-	m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-		Edge::typeToInt(Edge::EDGE_INHERITANCE), [this](StorageEdge&& edge) {
-			m_hierarchyCache.createInheritance(edge.id, edge.sourceNodeId, edge.targetNodeId);
+	forEachEdge(
+		Edge::EDGE_INHERITANCE,
+		[&edges](Id id, Id sourceNodeId, Id targetNodeId) {
+			edges.push_back(
+				{uint64_t(id),
+				 uint64_t(sourceNodeId),
+				 uint64_t(targetNodeId),
+				 StorageCacheSnapshot::EDGE_INHERITANCE});
 		});
+
+	return edges;
+}
+
+void PersistentStorage::buildHierarchyCache(
+	const std::vector<StorageCacheSnapshot::HierarchyEdge>& edges)
+{
+	TRACE();
+
+	// inheritance edges follow the member edges, so all their nodes are connected already
+	for (const StorageCacheSnapshot::HierarchyEdge& edge: edges)
+	{
+		if (edge.flags & StorageCacheSnapshot::EDGE_INHERITANCE)
+		{
+			m_hierarchyCache.createInheritance(
+				Id(edge.edgeId), Id(edge.sourceId), Id(edge.targetId));
+		}
+		else
+		{
+			m_hierarchyCache.createConnection(
+				Id(edge.edgeId),
+				Id(edge.sourceId),
+				Id(edge.targetId),
+				edge.flags & StorageCacheSnapshot::EDGE_SOURCE_VISIBLE,
+				edge.flags & StorageCacheSnapshot::EDGE_SOURCE_IMPLICIT,
+				edge.flags & StorageCacheSnapshot::EDGE_TARGET_IMPLICIT);
+		}
+	}
+	m_hierarchyCache.finishSetup();
+}
+
+void PersistentStorage::buildAdjacencyCache(const SqliteIndexStoragePool::ScopedStorage& storage)
+{
+	TRACE();
+
+	// the edges are read from the database in low memory mode
+	if (m_lowMemoryMode)
+	{
+		return;
+	}
+
+	std::vector<std::pair<Id, int>> nodeTypes;
+	storage->forEachRow<Id, int>("SELECT id, type FROM node;", [&nodeTypes](Id id, int type) {
+		nodeTypes.emplace_back(id, type);
+	});
+
+	m_adjacencyCache.build(nodeTypes, storage->getAll<StorageEdge>());
+}
+
+void PersistentStorage::buildAggregationCache()
+{
+	TRACE();
+
+	// without the adjacency cache the aggregations are computed for each request
+	if (m_adjacencyCache.isEmpty())
+	{
+		return;
+	}
+	m_aggregationCache.build(m_adjacencyCache, m_hierarchyCache);
+}
+
+void PersistentStorage::buildFileReachabilityIndex()
+{
+	TRACE();
+
+	m_fileReachabilityIndex = FileReachabilityIndex(getFileReferences());
+	m_hasFileReachabilityIndex = true;
+
+	LOG_INFO(
+		"Built file reachability index of " +
+		std::to_string(m_fileReachabilityIndex.getReferenceCount()) + " references with " +
+		std::to_string(m_fileReachabilityIndex.getByteSize()) + " bytes");
+}
+
+void PersistentStorage::buildOverviewSummary()
+{
+	TRACE();
+
+	// the adjacency cache holds the types of all nodes, without it the overview reads them itself
+	if (m_adjacencyCache.isEmpty())
+	{
+		return;
+	}
+	m_overviewSummary.build(m_adjacencyCache, m_hierarchyCache, [this](Id nodeId, NodeType type) {
+		return isOverviewNode(nodeId, type);
+	});
+
+	LOG_INFO(
+		"Built overview summary of " + std::to_string(m_overviewSummary.getNodeIds().size()) +
+		" nodes with " + std::to_string(m_overviewSummary.getEdges().size()) + " edges");
+}
+
+bool PersistentStorage::isOverviewNode(Id nodeId, NodeType type) const
+{
+	if (type.isFile())
+	{
+		auto it = m_fileNodeIndexed.find(nodeId);
+		return it != m_fileNodeIndexed.end() && it->second;
+	}
+
+	if (m_symbolDefinitionKinds.size())
+	{
+		auto it = m_symbolDefinitionKinds.find(nodeId);
+		if (it == m_symbolDefinitionKinds.end() || it->second != DEFINITION_EXPLICIT)
+		{
+			return false;
+		}
+	}
+
+	return type.isPackage() || !m_hierarchyCache.isChildOfVisibleNodeOrInvisible(nodeId);
+}
+
+void PersistentStorage::buildIndexReplica()
+{
+	TRACE();
+
+	if (m_lowMemoryMode)
+	{
+		return;
+	}
+
+	size_t generation = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_indexReplicaMutex);
+		generation = m_indexReplicaGeneration;
+	}
+
+	std::shared_ptr<IndexReplica> replica = std::make_shared<IndexReplica>();
+	replica->build(
+		m_sqliteIndexStorage.getAll<StorageNode>(),
+		m_sqliteIndexStorage.getAll<StorageSourceLocation>(),
+		m_sqliteIndexStorage.getAll<StorageOccurrence>());
+
+	// the storage may have been written to while the tables were read
+	std::lock_guard<std::mutex> lock(m_indexReplicaMutex);
+	if (generation == m_indexReplicaGeneration)
+	{
+		m_indexReplica = replica;
+		LOG_INFO(
+			"Index replica loaded with " + std::to_string(replica->getByteSize() / 1024 / 1024) +
+			" MB");
+	}
+}
+
+void PersistentStorage::startBuildingIndexReplica()
+{
+	if (m_indexReplicaBuild.valid())
+	{
+		m_indexReplicaBuild.wait();
+	}
+	m_indexReplicaBuild = TaskManager::getThreadPool()->runBlocking(
+		[this]() { buildIndexReplica(); });
+}
+
+std::shared_ptr<const IndexReplica> PersistentStorage::getIndexReplica() const
+{
+	std::lock_guard<std::mutex> lock(m_indexReplicaMutex);
+	return m_indexReplica;
+}
+
+void PersistentStorage::dropIndexReplica()
+{
+	std::lock_guard<std::mutex> lock(m_indexReplicaMutex);
+	m_indexReplica.reset();
+	m_indexReplicaGeneration++;
+}
+
+StorageNode PersistentStorage::getStorageNodeById(Id nodeId) const
+{
+	StorageNode node;
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	if (!replica)
+	{
+		return getReadIndexStorage()->getFirstById<StorageNode>(nodeId);
+	}
+
+	replica->getNodeById(nodeId, &node);
+	return node;
+}
+
+std::vector<StorageNode> PersistentStorage::getStorageNodesByIds(
+	const std::vector<Id>& nodeIds) const
+{
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	if (!replica)
+	{
+		return getReadIndexStorage()->getAllByIds<StorageNode>(nodeIds);
+	}
+	return replica->getNodesByIds(nodeIds);
+}
+
+StorageSourceLocation PersistentStorage::getStorageSourceLocationById(Id locationId) const
+{
+	StorageSourceLocation location;
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	if (!replica)
+	{
+		return getReadIndexStorage()->getFirstById<StorageSourceLocation>(locationId);
+	}
+
+	replica->getSourceLocationById(locationId, &location);
+	return location;
+}
+
+std::vector<StorageSourceLocation> PersistentStorage::getStorageSourceLocationsByIds(
+	const std::vector<Id>& locationIds) const
+{
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	if (!replica)
+	{
+		return getReadIndexStorage()->getAllByIds<StorageSourceLocation>(locationIds);
+	}
+	return replica->getSourceLocationsByIds(locationIds);
+}
+
+std::vector<StorageOccurrence> PersistentStorage::getOccurrencesForElementIds(
+	const std::vector<Id>& elementIds) const
+{
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	if (!replica)
+	{
+		return getReadIndexStorage()->getOccurrencesForElementIds(elementIds);
+	}
+	return replica->getOccurrencesForElementIds(elementIds);
+}
+
+std::vector<StorageOccurrence> PersistentStorage::getOccurrencesForLocationIds(
+	const std::vector<Id>& locationIds) const
+{
+	std::shared_ptr<const IndexReplica> replica = getIndexReplica();
+	if (!replica)
+	{
+		return getReadIndexStorage()->getOccurrencesForLocationIds(locationIds);
+	}
+	return replica->getOccurrencesForLocationIds(locationIds);
+}
+
+std::shared_ptr<SourceLocationFile> PersistentStorage::getReplicatedSourceLocationsForFile(
+	const IndexReplica& replica, const FilePath& filePath, size_t startLine, size_t endLine) const
+{
+	const Id fileId = getFileNodeId(filePath);
+	if (!fileId)
+	{
+		return std::make_shared<SourceLocationFile>(filePath, L"", true, false, false);
+	}
+
+	std::shared_ptr<SourceLocationFile> file = std::make_shared<SourceLocationFile>(
+		filePath,
+		getFileNodeLanguage(fileId),
+		true,
+		getFileNodeComplete(fileId),
+		getFileNodeIndexed(fileId));
+
+	std::vector<StorageSourceLocation> locations = replica.getSourceLocationsForFileId(fileId);
+	if (endLine)
+	{
+		locations.erase(
+			std::remove_if(
+				locations.begin(),
+				locations.end(),
+				[startLine, endLine](const StorageSourceLocation& location) {
+					return location.startLine > endLine || location.endLine < startLine;
+				}),
+			locations.end());
+	}
+
+	std::vector<Id> locationIds;
+	locationIds.reserve(locations.size());
+	for (const StorageSourceLocation& location: locations)
+	{
+		locationIds.push_back(location.id);
+	}
+
+	std::map<Id, std::vector<Id>> locationIdToElementIds;
+	for (const StorageOccurrence& occurrence: replica.getOccurrencesForLocationIds(locationIds))
+	{
+		locationIdToElementIds[occurrence.sourceLocationId].push_back(occurrence.elementId);
+	}
+
+	for (const StorageSourceLocation& location: locations)
+	{
+		auto it = locationIdToElementIds.find(location.id);
+		file->addSourceLocation(
+			intToLocationType(location.type),
+			location.id,
+			it != locationIdToElementIds.end() ? it->second : std::vector<Id>(),
+			location.startLine,
+			location.startCol,
+			location.endLine,
+			location.endCol);
+	}
+
+	return file;
+}
+
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceIds(
+	const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes) const
+{
+	if (!m_adjacencyCache.isEmpty())
+	{
+		return m_adjacencyCache.getEdgesBySourceIds(nodeIds, edgeTypes);
+	}
+
+	std::vector<StorageEdge> edges = getReadIndexStorage()->getEdgesBySourceIds(nodeIds);
+	edges.erase(
+		std::remove_if(
+			edges.begin(),
+			edges.end(),
+			[edgeTypes](const StorageEdge& edge) {
+				return !(Edge::intToType(edge.type) & edgeTypes);
+			}),
+		edges.end());
+	return edges;
+}
+
+std::vector<StorageEdge> PersistentStorage::getEdgesByTargetIds(
+	const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes) const
+{
+	if (!m_adjacencyCache.isEmpty())
+	{
+		return m_adjacencyCache.getEdgesByTargetIds(nodeIds, edgeTypes);
+	}
+
+	std::vector<StorageEdge> edges = getReadIndexStorage()->getEdgesByTargetIds(nodeIds);
+	edges.erase(
+		std::remove_if(
+			edges.begin(),
+			edges.end(),
+			[edgeTypes](const StorageEdge& edge) {
+				return !(Edge::intToType(edge.type) & edgeTypes);
+			}),
+		edges.end());
+	return edges;
+}
+
+std::vector<StorageEdge> PersistentStorage::getEdgesBySourceOrTargetId(Id nodeId) const
+{
+	if (m_adjacencyCache.isEmpty())
+	{
+		return getReadIndexStorage()->getEdgesBySourceOrTargetId(nodeId);
+	}
+
+	std::vector<StorageEdge> edges = getEdgesBySourceIds({nodeId});
+	utility::append(edges, getEdgesByTargetIds({nodeId}));
+	std::sort(edges.begin(), edges.end(), [](const StorageEdge& a, const StorageEdge& b) {
+		return a.id < b.id;
+	});
+
+	// edges from the node to itself are found twice
+	edges.erase(
+		std::unique(
+			edges.begin(),
+			edges.end(),
+			[](const StorageEdge& a, const StorageEdge& b) { return a.id == b.id; }),
+		edges.end());
+	return edges;
+}
+
+std::vector<std::pair<Id, int>> PersistentStorage::getNodeTypesForNodeIds(
+	const std::vector<Id>& nodeIds) const
+{
+	std::vector<std::pair<Id, int>> nodeTypes;
+	if (m_adjacencyCache.isEmpty())
+	{
+		for (const StorageNode& node: getStorageNodesByIds(nodeIds))
+		{
+			nodeTypes.emplace_back(node.id, node.type);
+		}
+		return nodeTypes;
+	}
+
+	std::vector<Id> sortedNodeIds = nodeIds;
+	std::sort(sortedNodeIds.begin(), sortedNodeIds.end());
+	sortedNodeIds.erase(std::unique(sortedNodeIds.begin(), sortedNodeIds.end()), sortedNodeIds.end());
+
+	for (Id nodeId: sortedNodeIds)
+	{
+		int type = 0;
+		if (m_adjacencyCache.getNodeType(nodeId, &type))
+		{
+			nodeTypes.emplace_back(nodeId, type);
+		}
+	}
+	return nodeTypes;
+}
+
+bool PersistentStorage::isTrailNodeAccepted(
+	Id nodeId, NodeType::Type type, NodeType::TypeMask nodeTypes, bool nodeNonIndexed) const
+{
+	if (!(type & nodeTypes || (type == NodeType::NODE_SYMBOL && nodeNonIndexed)))
+	{
+		return false;
+	}
+
+	if (!nodeNonIndexed)
+	{
+		if (type == NodeType::NODE_FILE)
+		{
+			auto it = m_fileNodeIndexed.find(nodeId);
+			if (it == m_fileNodeIndexed.end() || !it->second)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			auto it = m_symbolDefinitionKinds.find(nodeId);
+			if (it == m_symbolDefinitionKinds.end() || it->second == DEFINITION_NONE)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void PersistentStorage::addTerminatedTrailNodeAndEdgeIds(
+	Id originId,
+	Id targetId,
+	NodeType::TypeMask nodeTypes,
+	Edge::TypeMask edgeTypes,
+	bool nodeNonIndexed,
+	size_t depth,
+	bool directed,
+	std::set<Id>* nodeIds,
+	std::set<Id>* edgeIds) const
+{
+	TRACE();
+
+	nodeIds->insert(originId);
+	if (originId == targetId)
+	{
+		return;
+	}
+
+	// searching from both ends only expands the nodes close to either of them
+	TrailSearch searches[2];
+	searches[0].startId = originId;
+	searches[0].goalId = targetId;
+	searches[1].startId = targetId;
+	searches[1].goalId = originId;
+	searches[1].forward = false;
+	for (TrailSearch& search: searches)
+	{
+		search.frontier.push_back(search.startId);
+		search.depths.emplace(search.startId, 0);
+	}
+
+	size_t pathLength = 0;
+	while (!pathLength)
+	{
+		std::vector<TrailSearch*> activeSearches;
+		for (TrailSearch& search: searches)
+		{
+			if (!search.capped && search.frontier.size())
+			{
+				activeSearches.push_back(&search);
+			}
+		}
+
+		const size_t currentLength = searches[0].depth + searches[1].depth;
+		if (depth && currentLength + activeSearches.size() > depth && activeSearches.size() == 2)
+		{
+			// only one more step fits, so take it from the smaller frontier
+			if (activeSearches[0]->frontier.size() > activeSearches[1]->frontier.size())
+			{
+				std::swap(activeSearches[0], activeSearches[1]);
+			}
+			activeSearches.pop_back();
+		}
+
+		if (activeSearches.empty() || (depth && currentLength >= depth))
+		{
+			break;
+		}
+
+		// edge and node type lookups only run in parallel on the caches, not on the database
+		if (activeSearches.size() == 2 && !m_adjacencyCache.isEmpty())
+		{
+			TaskManager::getThreadPool()->parallelFor(
+				2,
+				[&](size_t i) {
+					expandTrailSearch(
+						activeSearches[i], nodeTypes, edgeTypes, nodeNonIndexed, directed);
+				},
+				ThreadPool::PRIORITY_INTERACTIVE);
+		}
+		else
+		{
+			for (TrailSearch* search: activeSearches)
+			{
+				expandTrailSearch(search, nodeTypes, edgeTypes, nodeNonIndexed, directed);
+			}
+		}
+
+		// nodes found by both searches were just added to the frontier of one of them
+		for (TrailSearch* search: activeSearches)
+		{
+			const TrailSearch& otherSearch = search == &searches[0] ? searches[1] : searches[0];
+			for (Id nodeId: search->frontier)
+			{
+				auto it = otherSearch.depths.find(nodeId);
+				if (it != otherSearch.depths.end() &&
+					(!pathLength || search->depth + it->second < pathLength))
+				{
+					pathLength = search->depth + it->second;
+				}
+			}
+		}
+	}
+
+	if (!pathLength)
+	{
+		return;
+	}
+
+	// all shortest trails pass through nodes found at matching depths from both ends
+	for (TrailSearch& search: searches)
+	{
+		const TrailSearch& otherSearch = &search == &searches[0] ? searches[1] : searches[0];
+
+		std::vector<Id> nodeIdsToProcess;
+		for (const std::pair<const Id, size_t>& nodeDepth: search.depths)
+		{
+			auto it = otherSearch.depths.find(nodeDepth.first);
+			if (it != otherSearch.depths.end() && nodeDepth.second + it->second == pathLength)
+			{
+				nodeIdsToProcess.push_back(nodeDepth.first);
+			}
+		}
+
+		std::set<Id> processedNodeIds;
+		while (nodeIdsToProcess.size())
+		{
+			const Id nodeId = nodeIdsToProcess.back();
+			nodeIdsToProcess.pop_back();
+			if (!processedNodeIds.insert(nodeId).second)
+			{
+				continue;
+			}
+
+			nodeIds->insert(nodeId);
+			auto it = search.parents.find(nodeId);
+			if (it != search.parents.end())
+			{
+				for (const std::pair<Id, Id>& parent: it->second)
+				{
+					nodeIdsToProcess.push_back(parent.first);
+					edgeIds->insert(parent.second);
+				}
+			}
+		}
+	}
+}
+
+void PersistentStorage::expandTrailSearch(
+	TrailSearch* search,
+	NodeType::TypeMask nodeTypes,
+	Edge::TypeMask edgeTypes,
+	bool nodeNonIndexed,
+	bool directed) const
+{
+	std::vector<StorageEdge> edges = search->forward
+		? getEdgesBySourceIds(search->frontier, edgeTypes)
+		: getEdgesByTargetIds(search->frontier, edgeTypes);
+
+	if (!directed || edgeTypes & Edge::LAYOUT_VERTICAL)
+	{
+		utility::append(
+			edges,
+			search->forward ? getEdgesByTargetIds(search->frontier, edgeTypes)
+							: getEdgesBySourceIds(search->frontier, edgeTypes));
+	}
+
+	std::map<Id, std::vector<std::pair<Id, Id>>> steps;
+	std::set<Id> edgeIds;
+	auto addStep = [search, &steps](Id fromNodeId, Id toNodeId, Id edgeId) {
+		auto it = search->depths.find(fromNodeId);
+		if (it != search->depths.end() && it->second == search->depth &&
+			search->depths.find(toNodeId) == search->depths.end())
+		{
+			steps[toNodeId].emplace_back(fromNodeId, edgeId);
+		}
+	};
+
+	for (const StorageEdge& edge: edges)
+	{
+		if (!edgeIds.insert(edge.id).second)
+		{
+			continue;
+		}
+
+		const bool isForward = search->forward ==
+			!(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
+		const Id fromNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
+		const Id toNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
+
+		addStep(fromNodeId, toNodeId, edge.id);
+		if (!directed)
+		{
+			addStep(toNodeId, fromNodeId, edge.id);
+		}
+	}
+
+	std::vector<Id> nodeIdsToCheck;
+	for (const std::pair<const Id, std::vector<std::pair<Id, Id>>>& step: steps)
+	{
+		nodeIdsToCheck.push_back(step.first);
+	}
+
+	search->frontier.clear();
+	search->depth++;
+
+	if (nodeTypes != 0)
+	{
+		std::set<Id> acceptedNodeIds;
+		if (steps.find(search->goalId) != steps.end())
+		{
+			acceptedNodeIds.insert(search->goalId);
+		}
+
+		for (const std::pair<Id, int>& nodeType: getNodeTypesForNodeIds(nodeIdsToCheck))
+		{
+			if (isTrailNodeAccepted(
+					nodeType.first, NodeType::intToType(nodeType.second), nodeTypes, nodeNonIndexed))
+			{
+				acceptedNodeIds.insert(nodeType.first);
+			}
+		}
+		nodeIdsToCheck = utility::toVector(acceptedNodeIds);
+	}
+
+	for (Id nodeId: nodeIdsToCheck)
+	{
+		search->frontier.push_back(nodeId);
+		search->depths.emplace(nodeId, search->depth);
+		search->parents.emplace(nodeId, std::move(steps[nodeId]));
+	}
+
+	// a huge frontier is kept for meeting the other search, but isn't expanded any further
+	if (search->frontier.size() > s_maxTrailFrontierSize)
+	{
+		LOG_INFO(
+			"Trail search frontier of " + std::to_string(search->frontier.size()) +
+			" nodes is not expanded further.");
+		search->capped = true;
+	}
+}
+
+void PersistentStorage::updateBookmarkIndex(
+	const std::vector<std::wstring>& serializedNodeNames,
+	const std::vector<StorageBookmarkedEdge>& bookmarkedEdges) const
+{
+	TRACE();
+
+	if (m_bookmarkIndexVersion != m_contentVersion)
+	{
+		m_bookmarkedNodeIds.clear();
+		m_bookmarkedEdgeIds.clear();
+		m_bookmarkIndexVersion = m_contentVersion;
+	}
+
+	std::map<std::string, std::wstring> binaryToSerializedNames;
+	for (const std::wstring& serializedNodeName: serializedNodeNames)
+	{
+		if (m_bookmarkedNodeIds.find(serializedNodeName) == m_bookmarkedNodeIds.end())
+		{
+			binaryToSerializedNames.emplace(
+				NameHierarchy::convertSerializedToBinary(serializedNodeName), serializedNodeName);
+		}
+	}
+
+	if (!binaryToSerializedNames.empty())
+	{
+		std::vector<std::string> binaryNames;
+		for (const auto& p: binaryToSerializedNames)
+		{
+			binaryNames.push_back(p.first);
+		}
+
+		for (const StorageNode& node: getReadIndexStorage()->getNodesBySerializedNames(binaryNames))
+		{
+			auto it = binaryToSerializedNames.find(node.serializedName);
+			if (it != binaryToSerializedNames.end())
+			{
+				m_bookmarkedNodeIds.emplace(it->second, node.id);
+			}
+		}
+
+		// names of nodes that no longer exist are kept as well, so they are not queried again
+		for (const auto& p: binaryToSerializedNames)
+		{
+			m_bookmarkedNodeIds.emplace(p.second, 0);
+		}
+	}
+
+	std::set<BookmarkedEdgeKey> edgeKeys;
+	std::vector<Id> sourceNodeIds;
+	for (const StorageBookmarkedEdge& bookmarkedEdge: bookmarkedEdges)
+	{
+		const BookmarkedEdgeKey key(
+			m_bookmarkedNodeIds[bookmarkedEdge.serializedSourceNodeName],
+			m_bookmarkedNodeIds[bookmarkedEdge.serializedTargetNodeName],
+			bookmarkedEdge.edgeType);
+		if (m_bookmarkedEdgeIds.find(key) == m_bookmarkedEdgeIds.end() &&
+			edgeKeys.insert(key).second)
+		{
+			sourceNodeIds.push_back(std::get<0>(key));
+		}
+	}
+
+	if (!edgeKeys.empty())
+	{
+		for (const StorageEdge& edge: getEdgesBySourceIds(sourceNodeIds))
+		{
+			const BookmarkedEdgeKey key(edge.sourceNodeId, edge.targetNodeId, edge.type);
+			if (edgeKeys.find(key) != edgeKeys.end())
+			{
+				m_bookmarkedEdgeIds.emplace(key, edge.id);
+			}
+		}
+
+		for (const BookmarkedEdgeKey& key: edgeKeys)
+		{
+			m_bookmarkedEdgeIds.emplace(key, 0);
+		}
+	}
+}
+
+bool PersistentStorage::isNodeOrEdge(Id elementId, bool* isNode) const
+{
+	if (m_adjacencyCache.isEmpty())
+	{
+		*isNode = getReadIndexStorage()->isNode(elementId);
+		return *isNode || getReadIndexStorage()->isEdge(elementId);
+	}
+
+	int type = 0;
+	*isNode = m_adjacencyCache.getNodeType(elementId, &type);
+	StorageEdge edge;
+	return *isNode || m_adjacencyCache.getEdgeById(elementId, &edge);
+}
+
+void PersistentStorage::addLocationElementIds(const SourceLocationFile& file) const
+{
+	LocationElementIds locationElementIds;
+	locationElementIds.fileId = getFileNodeId(file.getFilePath());
+	for (const SourceLocation* location: file.getSourceLocations())
+	{
+		if (location->isStartLocation())
+		{
+			locationElementIds.elementIds.emplace(
+				location->getLocationId(), location->getTokenIds().toVector());
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_locationElementIdsMutex);
+	m_locationElementIds.remove_if([&locationElementIds](const LocationElementIds& ids) {
+		return ids.fileId == locationElementIds.fileId;
+	});
+	m_locationElementIds.push_front(std::move(locationElementIds));
+	if (m_locationElementIds.size() > s_maxLocationElementIdsFileCount)
+	{
+		m_locationElementIds.pop_back();
+	}
+}
+
+bool PersistentStorage::getLocationElementIds(
+	const std::vector<Id>& locationIds, std::vector<Id>* elementIds) const
+{
+	std::lock_guard<std::mutex> lock(m_locationElementIdsMutex);
+	for (Id locationId: locationIds)
+	{
+		bool found = false;
+		for (const LocationElementIds& file: m_locationElementIds)
+		{
+			auto it = file.elementIds.find(locationId);
+			if (it != file.elementIds.end())
+			{
+				utility::append(*elementIds, it->second);
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+		{
+			elementIds->clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string PersistentStorage::getCacheSnapshotStamp() const
+{
+	// exported databases keep their stamp when they are moved, size and modification time do not
+	const std::string snapshotStamp = m_sqliteIndexStorage.getSnapshotStamp();
+	if (!snapshotStamp.empty())
+	{
+		return "snapshot " + snapshotStamp;
+	}
+	return StorageCacheSnapshot::getDatabaseStamp(getIndexDbFilePath());
+}
+
+void PersistentStorage::loadCacheSnapshot(const StorageCacheSnapshot& snapshot)
+{
+	TRACE();
+
+	InternedStringPool* pool = InternedStringPool::getInstance();
+	for (const StorageCacheSnapshot::File& file: snapshot.files)
+	{
+		const Id fileId = Id(file.id);
+		const FilePath path(snapshot.getText(file.pathBegin, file.pathLength));
+		const InternedStringPool::Handle pathHandle = pool->intern(path.wstr());
+
+		m_fileNodeIds.emplace(pathHandle, fileId);
+		m_lowerCasefileNodeIds.emplace(pool->intern(path.getLowerCase().wstr()), fileId);
+		m_fileNodePaths.emplace(fileId, pathHandle);
+		m_fileNodeComplete.emplace(fileId, file.flags & StorageCacheSnapshot::FILE_COMPLETE);
+		m_fileNodeIndexed.emplace(fileId, file.flags & StorageCacheSnapshot::FILE_INDEXED);
+		m_fileNodeLanguage.emplace(
+			fileId, pool->intern(snapshot.getText(file.languageBegin, file.languageLength)));
+
+		if (!m_hasJavaFiles && path.extension() == L".java")
+		{
+			m_hasJavaFiles = true;
+		}
+	}
+
+	for (const StorageCacheSnapshot::IdValue& symbol: snapshot.symbolDefinitionKinds)
+	{
+		m_symbolDefinitionKinds.emplace(Id(symbol.id), intToDefinitionKind(int(symbol.value)));
+	}
+
+	for (const StorageCacheSnapshot::IdValue& order: snapshot.memberEdgeIdOrder)
+	{
+		m_memberEdgeIdOrderMap.emplace(Id(order.id), Id(order.value));
+	}
+
+	buildHierarchyCache(snapshot.hierarchyEdges);
+
+	// snapshots saved in low memory mode hold an empty adjacency cache
+	if (m_lowMemoryMode || !m_adjacencyCache.deserialize(snapshot.adjacencyCacheData) ||
+		m_adjacencyCache.isEmpty())
+	{
+		buildAdjacencyCache(getReadIndexStorage());
+	}
+	buildAggregationCache();
+
+	m_hasFileReachabilityIndex = m_fileReachabilityIndex.deserialize(
+		snapshot.fileReachabilityIndexData);
+	if (!m_hasFileReachabilityIndex)
+	{
+		buildFileReachabilityIndex();
+	}
+
+	buildOverviewSummary();
+}
+
+StorageCacheSnapshot PersistentStorage::createCacheSnapshot(
+	const std::vector<StorageCacheSnapshot::HierarchyEdge>& hierarchyEdges) const
+{
+	InternedStringPool* pool = InternedStringPool::getInstance();
+
+	StorageCacheSnapshot snapshot;
+	for (const auto& p: m_fileNodePaths)
+	{
+		uint32_t flags = 0;
+		if (getFileNodeComplete(p.first))
+		{
+			flags |= StorageCacheSnapshot::FILE_COMPLETE;
+		}
+		if (getFileNodeIndexed(p.first))
+		{
+			flags |= StorageCacheSnapshot::FILE_INDEXED;
+		}
+
+		auto it = m_fileNodeLanguage.find(p.first);
+		snapshot.addFile(
+			p.first,
+			pool->getString(p.second),
+			it != m_fileNodeLanguage.end() ? pool->getString(it->second) : L"",
+			flags);
+	}
+
+	for (const auto& p: m_symbolDefinitionKinds)
+	{
+		snapshot.symbolDefinitionKinds.push_back(
+			{uint64_t(p.first), uint64_t(definitionKindToInt(p.second))});
+	}
+
+	for (const auto& p: m_memberEdgeIdOrderMap)
+	{
+		snapshot.memberEdgeIdOrder.push_back({uint64_t(p.first), uint64_t(p.second)});
+	}
+
+	snapshot.hierarchyEdges = hierarchyEdges;
+	snapshot.adjacencyCacheData = m_adjacencyCache.serialize();
+	if (m_hasFileReachabilityIndex)
+	{
+		snapshot.fileReachabilityIndexData = m_fileReachabilityIndex.serialize();
+	}
+	return snapshot;
 }
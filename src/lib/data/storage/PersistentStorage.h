@@ -1,16 +1,34 @@
 #ifndef PERSISTENT_STORAGE_H
 #define PERSISTENT_STORAGE_H
 
+#include <atomic>
+#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include "AdjacencyCache.h"
+#include "AggregationCache.h"
+#include "FileContentCache.h"
+#include "FileReferenceGraph.h"
 #include "FullTextSearchIndex.h"
 #include "HierarchyCache.h"
+#include "IndexReplica.h"
+#include "InternedStringPool.h"
+#include "OverviewSummary.h"
 #include "SearchIndex.h"
 #include "SqliteBookmarkStorage.h"
 #include "SqliteIndexStorage.h"
+#include "SqliteIndexStoragePool.h"
 #include "Storage.h"
 #include "StorageAccess.h"
+#include "StorageCacheSnapshot.h"
+
+class StorageGraphWriter;
+class TextCodec;
 
 class PersistentStorage
 	: public Storage
@@ -18,6 +36,7 @@ class PersistentStorage
 {
 public:
 	PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath);
+	~PersistentStorage();
 
 	std::pair<Id, bool> addNode(const StorageNodeData& data) override;
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes) override;
@@ -27,7 +46,7 @@ public:
 	Id addEdge(const StorageEdgeData& data) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& data) override;
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 	Id addSourceLocation(const StorageSourceLocationData& data) override;
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
 	void addOccurrence(const StorageOccurrence& data) override;
@@ -48,29 +67,65 @@ public:
 	const std::vector<StorageFile>& getStorageFiles() const override;
 	const std::vector<StorageSymbol>& getStorageSymbols() const override;
 	const std::vector<StorageEdge>& getStorageEdges() const override;
-	const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-	const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-	const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-	const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-	const std::set<StorageElementComponent>& getElementComponents() const override;
+	const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+	const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+	const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+	const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+	const std::vector<StorageElementComponent>& getElementComponents() const override;
 	const std::vector<StorageError>& getErrors() const override;
 
+	void addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes) override;
+	std::vector<StorageIndexingTime> getIndexingTimes() const override;
+
 	void startInjection() override;
 	void finishInjection() override;
 	void rollbackInjection();
 
+	// copies the content of another index database within sqlite, returns false if it needs to be
+	// injected instead
+	bool injectDatabase(const FilePath& dbFilePath);
+
+	void startInjectionGroup() override;
+	void finishInjectionGroup() override;
+
+	// keeps all following changes in one transaction, other connections to the database keep
+	// reading the previous state until it is finished. Returns the ids of the changed elements if
+	// the changes were kept.
+	void startRefreshTransaction();
+	std::vector<Id> finishRefreshTransaction(bool keepChanges);
+
 	void beforeErrorRecording();
 	void afterErrorRecording();
 
 	void setMode(const SqliteIndexStorage::StorageModeType mode);
 
+	void applyStorageSettings(
+		const SqliteStorageSettings& indexSettings, const SqliteStorageSettings& bookmarkSettings);
+	void checkpoint();
+
+	// lets queries of several threads run on up to count read only connections while the index
+	// database is in wal mode, 0 keeps all queries on the connection that writes
+	void setReadConnectionCount(size_t count);
+
 	FilePath getIndexDbFilePath() const;
 	FilePath getBookmarkDbFilePath() const;
 
+	// buildCaches loads its caches from the snapshot if it was saved for the current database and
+	// saves it otherwise, an empty path disables the snapshot
+	void setCacheSnapshotFilePath(const FilePath& filePath);
+
 	bool isEmpty() const;
 	bool isIncompatible() const;
 	std::string getProjectSettingsText() const;
 	void setProjectSettingsText(std::string text);
+	std::string getRevision() const;
+	void setRevision(const std::string& revision);
+	// an index delta holds the data of a refresh, which clears its files in the base revision
+	std::string getDeltaBaseRevision() const;
+	void setDeltaBaseRevision(const std::string& revision);
+	std::vector<FilePath> getDeltaClearedFilePaths() const;
+	void setDeltaClearedFilePaths(const std::vector<FilePath>& filePaths);
+	void setIndexingPhaseDurations(const std::map<std::string, float>& durations);
 
 	void setup();
 	void updateVersion();
@@ -79,6 +134,9 @@ public:
 
 	std::set<FilePath> getReferenced(const std::set<FilePath>& filePaths) const;
 	std::set<FilePath> getReferencing(const std::set<FilePath>& filePaths) const;
+	// all includes and imports, for callers with many queries, taken from the precomputed closure
+	// once the caches are built
+	FileReferenceGraph getFileReferenceGraph() const;
 
 	void clearAllErrors();
 	void clearFileElements(
@@ -89,10 +147,41 @@ public:
 	bool getFilePathIndexed(const FilePath& path) const;
 
 	void buildCaches();
+	// takes the caches of the storage of the database before a refresh and only reads the changed
+	// elements again, builds all caches if the previous storage has not loaded all of them
+	void buildCaches(
+		const PersistentStorage& previousStorage, const std::vector<Id>& changedElementIds);
+	// reads the stored search index, so the caches can still be taken after a refresh cleared it
+	void loadSearchIndex() const;
+
+	// copies the node, source_location and occurrence tables into memory, queries read from the
+	// copy once it is complete until the storage is written to again
+	void buildIndexReplica();
+	void startBuildingIndexReplica();	 // returns at once, builds on a thread of its own
+
+	// builds and stores fulltext search data for all indexed files that don't have up-to-date data
+	void updateFullTextSearchIndex();
+
+	// drops the stored search index, which gets built and stored again by the next buildCaches
+	void clearSearchIndexData();
+
+	// see SqliteIndexStorage::canonicalizeIds, only for storages without built caches
+	void canonicalizeIds();
 
 	void optimizeMemory();
 
+	// writes a vacuumed copy of the index database with all search data and a cache snapshot for
+	// it, which buildCaches of the copy loads even after both files were moved to another machine,
+	// needs buildCaches to be called before
+	bool exportSnapshot(const FilePath& dbFilePath, const FilePath& cacheSnapshotFilePath);
+
+	// streams the edges of the given types and the nodes they connect from the database to the
+	// writer, without building a graph or needing buildCaches
+	void exportGraph(Edge::TypeMask edgeTypes, StorageGraphWriter* writer) const;
+
 	// StorageAccess implementation
+	size_t getContentVersion() const override;
+
 	Id getNodeIdForFileNode(const FilePath& filePath) const override;
 	Id getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const override;
 	std::vector<Id> getNodeIdsForNameHierarchies(
@@ -108,23 +197,34 @@ public:
 	StorageEdge getEdgeById(Id edgeId) const override;
 
 	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback)
+		const override;
 
 	std::vector<SearchMatch> getAutocompletionMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		bool acceptCommands,
+		std::function<bool()> isCancelled) const override;
 	std::vector<SearchMatch> getAutocompletionSymbolMatches(
 		const std::wstring& query,
 		const NodeTypeSet& acceptedNodeTypes,
 		size_t maxResultsCount,
-		size_t maxBestScoredResultsLength) const;
+		size_t maxBestScoredResultsLength,
+		const std::function<bool()>& isCancelled = nullptr) const;
 	std::vector<SearchMatch> getAutocompletionFileMatches(
-		const std::wstring& query, size_t maxResultsCount) const;
+		const std::wstring& query,
+		size_t maxResultsCount,
+		const std::function<bool()>& isCancelled = nullptr) const;
 	std::vector<SearchMatch> getAutocompletionCommandMatches(
 		const std::wstring& query, NodeTypeSet acceptedNodeTypes) const;
 	std::vector<SearchMatch> getSearchMatchesForTokenIds(const std::vector<Id>& elementIds) const override;
 
 	std::shared_ptr<Graph> getGraphForAll() const override;
 	std::shared_ptr<Graph> getGraphForNodeTypes(NodeTypeSet nodeTypes) const override;
+	std::map<NodeType::Type, size_t> getOverviewNodeCounts() const override;
+	std::shared_ptr<Graph> getGraphForOverviewNodeType(NodeType nodeType) const override;
 	std::shared_ptr<Graph> getGraphForActiveTokenIds(
 		const std::vector<Id>& tokenIds,
 		const std::vector<Id>& expandedNodeIds,
@@ -138,6 +238,15 @@ public:
 		bool nodeNonIndexed,
 		size_t depth,
 		bool directed) const override;
+	std::shared_ptr<Graph> getGraphForTrail(
+		Id originId,
+		Id targetId,
+		NodeType::TypeMask nodeTypes,
+		Edge::TypeMask trailType,
+		bool nodeNonIndexed,
+		size_t depth,
+		bool directed,
+		std::function<bool(std::shared_ptr<Graph>)> partialResultsCallback) const override;
 
 	NodeType::TypeMask getAvailableNodeTypes() const override;
 	Edge::TypeMask getAvailableEdgeTypes() const override;
@@ -147,6 +256,14 @@ public:
 
 	std::shared_ptr<SourceLocationCollection> getSourceLocationsForTokenIds(
 		const std::vector<Id>& tokenIds) const override;
+	std::shared_ptr<SourceLocationCollection> getSourceLocationsForTokenIds(
+		const std::vector<Id>& tokenIds,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback)
+		const override;
+	size_t getSourceLocationFileCountForTokenIds(
+		const std::vector<Id>& tokenIds, size_t* referenceCount) const override;
+	std::shared_ptr<SourceLocationCollection> getSourceLocationsPageForTokenIds(
+		const std::vector<Id>& tokenIds, FilePath* cursor, size_t fileCount) const override;
 	std::shared_ptr<SourceLocationCollection> getSourceLocationsForLocationIds(
 		const std::vector<Id>& locationIds) const override;
 
@@ -157,7 +274,17 @@ public:
 		const FilePath& filePath, LocationType type) const override;
 
 	std::shared_ptr<TextAccess> getFileContent(const FilePath& filePath, bool showsErrors) const override;
-	bool hasContentForFile(const FilePath& filePath) const;
+	// empty if the storage has no content for the file
+	std::shared_ptr<TextAccess> getStoredFileContent(
+		const FilePath& filePath, FileContentCache::Consumer consumer) const;
+	std::string getFileContentHash(const FilePath& filePath) const;
+	// content hashes of all files that have stored content
+	std::map<FilePath, std::string> getFileContentHashesForAllFiles() const;
+
+	// true if the file on disk only differs from its indexed content in comment text and whitespace,
+	// so its recorded locations can be moved to the new content instead of indexing it again
+	bool hasOnlyLayoutChanges(const FilePath& filePath) const;
+	bool moveLocationsToCurrentContent(const FilePath& filePath);
 
 	FileInfo getFileInfoForFileId(Id id) const override;
 
@@ -165,8 +292,10 @@ public:
 	std::vector<FileInfo> getFileInfosForFilePaths(const std::vector<FilePath>& filePaths) const override;
 
 	StorageStats getStorageStats() const override;
+	MemoryUsage getMemoryUsage() const override;
 
 	ErrorCountInfo getErrorCount() const override;
+	ErrorCountInfo getErrorCountForFilter(const ErrorFilter& filter) const override;
 	std::vector<ErrorInfo> getErrorsLimited(const ErrorFilter& filter) const override;
 	std::vector<ErrorInfo> getErrorsForFileLimited(
 		const ErrorFilter& filter, const FilePath& filePath) const override;
@@ -185,6 +314,8 @@ public:
 	void removeBookmark(const Id id) override;
 	void removeBookmarkCategory(const Id id) override;
 
+	void setRecentNodeIds(const std::vector<Id>& nodeIds) override;
+
 	std::vector<NodeBookmark> getAllNodeBookmarks() const override;
 	std::vector<EdgeBookmark> getAllEdgeBookmarks() const override;
 	std::vector<BookmarkCategory> getAllBookmarkCategories() const override;
@@ -202,11 +333,11 @@ private:
 		std::vector<StorageFile> files;
 		std::vector<StorageSymbol> symbols;
 		std::vector<StorageEdge> edges;
-		std::set<StorageLocalSymbol> locals;
-		std::set<StorageSourceLocation> locations;
-		std::set<StorageOccurrence> occurrences;
-		std::set<StorageComponentAccess> accesses;
-		std::set<StorageElementComponent> components;
+		std::vector<StorageLocalSymbol> locals;
+		std::vector<StorageSourceLocation> locations;
+		std::vector<StorageOccurrence> occurrences;
+		std::vector<StorageComponentAccess> accesses;
+		std::vector<StorageElementComponent> components;
 		std::vector<StorageError> errors;
 	} m_storageData;
 
@@ -214,6 +345,8 @@ private:
 	std::vector<Id> getFileNodeIds(const std::vector<FilePath>& filePaths) const;
 	std::set<Id> getFileNodeIds(const std::set<FilePath>& filePaths) const;
 	FilePath getFileNodePath(Id fileId) const;
+	// the path of a token that is a file node, also of non-indexed files, empty for other tokens
+	FilePath getFilePathOfFileToken(Id tokenId) const;
 	bool getFileNodeComplete(Id fileId) const;
 	bool getFileNodeIndexed(Id fileId) const;
 	std::wstring getFileNodeLanguage(Id fileId) const;
@@ -221,18 +354,23 @@ private:
 	std::unordered_map<Id, std::set<Id>> getFileIdToIncludingFileIdMap() const;
 	std::unordered_map<Id, std::set<Id>> getFileIdToIncludedFileIdMap() const;
 	std::unordered_map<Id, std::set<Id>> getFileIdToImportingFileIdMap() const;
-	std::set<Id> getReferenced(
-		const std::set<Id>& filePaths,
-		std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const;
-	std::set<Id> getReferencing(
-		const std::set<Id>& filePaths,
-		std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const;
-
-	std::set<FilePath> getReferencedByIncludes(const std::set<FilePath>& filePaths) const;
-	std::set<FilePath> getReferencedByImports(const std::set<FilePath>& filePaths) const;
-
-	std::set<FilePath> getReferencingByIncludes(const std::set<FilePath>& filePaths) const;
-	std::set<FilePath> getReferencingByImports(const std::set<FilePath>& filePaths) const;
+	// includes and imports by file node ids, each pair is a referencing file and a referenced one
+	std::vector<std::pair<uint64_t, uint64_t>> getFileReferences() const;
+
+	// the stored content or the content on disk, see getStoredFileContent
+	std::shared_ptr<TextAccess> getFileContent(
+		const FilePath& filePath, FileContentCache::Consumer consumer) const;
+	std::shared_ptr<TextAccess> getStoredFileContent(
+		const StorageFile& file, FileContentCache::Consumer consumer) const;
+	std::shared_ptr<const FileContentCache::DecodedContent> getDecodedFileContent(
+		const FilePath& filePath,
+		const TextCodec& codec,
+		FileContentCache::Consumer consumer) const;
+
+	bool getSourceLocationsMovedToContent(
+		const StorageFile& file,
+		const std::string& content,
+		std::vector<StorageSourceLocation>* locations) const;
 
 	void addNodesToGraph(const std::vector<Id>& nodeIds, Graph* graph, bool addChildCount) const;
 	void addEdgesToGraph(const std::vector<Id>& edgeIds, Graph* graph) const;
@@ -247,24 +385,147 @@ private:
 	void addFileContentsToGraph(Id fileId, Graph* graph) const;
 	void addComponentAccessToGraph(Graph* graph) const;
 	void addComponentIsAmbiguousToGraph(Graph* graph) const;
+	std::shared_ptr<Graph> createTrailGraph(
+		const std::set<Id>& nodeIds, const std::set<Id>& edgeIds) const;
 
 	void addCompleteFlagsToSourceLocationCollection(SourceLocationCollection* collection) const;
 	void addInheritanceChainsToGraph(const std::vector<Id>& nodeIds, Graph* graph) const;
 
+	static const std::string s_symbolShardListName;
+	static const size_t s_maxTrailFrontierSize;
+	static const size_t s_maxActiveChildCount;
+	static const size_t s_partialTrailIntervalMs;
+	static const size_t s_maxSearchNameCandidateCount;
+
+	struct SymbolIndexShard
+	{
+		std::string name;
+		NodeTypeSet nodeTypes;
+		bool loaded = false;
+		SearchIndex index;
+	};
+	typedef std::vector<std::shared_ptr<SymbolIndexShard>> SymbolIndexShards;
+	typedef std::map<std::string, std::shared_ptr<SymbolIndexShard>> SymbolIndexShardMap;
+
 	void buildFilePathMaps();
+	void buildSymbolDefinitionKindMap();
 	void buildSearchIndex();
+	void buildFileIndex();
+	SymbolIndexShards buildSymbolIndexShards();
+	// symbols referenced more often get ranked up in the search results
+	std::unordered_map<Id, uint32_t> getSymbolReferenceCounts() const;
+	// the name a symbol is searched by, empty for files and implicit symbols that are not searched
+	std::wstring getSymbolSearchName(
+		Id nodeId, int nodeType, const NameHierarchy& nameHierarchy) const;
+	void addSymbolToIndexShards(
+		Id nodeId,
+		int nodeType,
+		const std::string& serializedName,
+		uint32_t referenceCount,
+		SymbolIndexShardMap* shards) const;
+	// finishes the setup of the shards and stores them in the database
+	SymbolIndexShards storeSymbolIndexShards(const SymbolIndexShardMap& shards);
+	SymbolIndexShards getLoadedSymbolIndexShards(NodeTypeSet acceptedNodeTypes) const;
+	// low memory mode stores the search names in the database and scores the candidates matching
+	// a query in a search index of their own
+	void buildSearchNames();
+	std::vector<SearchResult> searchSymbolNames(
+		const std::wstring& query,
+		const NodeTypeSet& acceptedNodeTypes,
+		size_t maxResultsCount,
+		size_t maxBestScoredResultsLength,
+		const std::function<bool()>& isCancelled) const;
 	void buildFullTextSearchIndex() const;
-	void buildMemberEdgeIdOrderMap();
-	void buildHierarchyCache();
+	// these read from the given connection, so buildCaches can run them in parallel
+	void buildMemberEdgeIdOrderMap(const SqliteIndexStoragePool::ScopedStorage& storage);
+	// all edges or only the ones that are or touch one of the given elements
+	std::vector<StorageCacheSnapshot::HierarchyEdge> getHierarchyEdges(
+		const SqliteIndexStoragePool::ScopedStorage& storage,
+		const std::vector<Id>* elementIds = nullptr) const;
+	void buildHierarchyCache(const std::vector<StorageCacheSnapshot::HierarchyEdge>& edges);
+	void buildAdjacencyCache(const SqliteIndexStoragePool::ScopedStorage& storage);
+	void buildAggregationCache();
+	void buildFileReachabilityIndex();
+	void buildOverviewSummary();
+	// the nodes shown by the overview of all symbols
+	bool isOverviewNode(Id nodeId, NodeType type) const;
+
+	// read from the adjacency cache once it was built, from the database otherwise
+	std::vector<StorageEdge> getEdgesBySourceIds(
+		const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes = ~Edge::TypeMask(0)) const;
+	std::vector<StorageEdge> getEdgesByTargetIds(
+		const std::vector<Id>& nodeIds, Edge::TypeMask edgeTypes = ~Edge::TypeMask(0)) const;
+	std::vector<StorageEdge> getEdgesBySourceOrTargetId(Id nodeId) const;
+	std::vector<std::pair<Id, int>> getNodeTypesForNodeIds(const std::vector<Id>& nodeIds) const;
+
+	// read from the index replica once it is complete, from the database otherwise
+	std::shared_ptr<const IndexReplica> getIndexReplica() const;
+	void dropIndexReplica();
+	StorageNode getStorageNodeById(Id nodeId) const;
+	std::vector<StorageNode> getStorageNodesByIds(const std::vector<Id>& nodeIds) const;
+	StorageSourceLocation getStorageSourceLocationById(Id locationId) const;
+	std::vector<StorageSourceLocation> getStorageSourceLocationsByIds(
+		const std::vector<Id>& locationIds) const;
+	std::vector<StorageOccurrence> getOccurrencesForElementIds(
+		const std::vector<Id>& elementIds) const;
+	std::vector<StorageOccurrence> getOccurrencesForLocationIds(
+		const std::vector<Id>& locationIds) const;
+	std::shared_ptr<SourceLocationFile> getReplicatedSourceLocationsForFile(
+		const IndexReplica& replica,
+		const FilePath& filePath,
+		size_t startLine,
+		size_t endLine) const;
+	// resolves the names stored with bookmarks in one batch, the caller holds m_bookmarkIndexMutex
+	void updateBookmarkIndex(
+		const std::vector<std::wstring>& serializedNodeNames,
+		const std::vector<StorageBookmarkedEdge>& bookmarkedEdges) const;
+	bool isNodeOrEdge(Id elementId, bool* isNode) const;
+
+	void addLocationElementIds(const SourceLocationFile& file) const;
+	bool getLocationElementIds(
+		const std::vector<Id>& locationIds, std::vector<Id>* elementIds) const;
+
+	struct TrailSearch;
+
+	bool isTrailNodeAccepted(
+		Id nodeId, NodeType::Type type, NodeType::TypeMask nodeTypes, bool nodeNonIndexed) const;
+	void addTerminatedTrailNodeAndEdgeIds(
+		Id originId,
+		Id targetId,
+		NodeType::TypeMask nodeTypes,
+		Edge::TypeMask edgeTypes,
+		bool nodeNonIndexed,
+		size_t depth,
+		bool directed,
+		std::set<Id>* nodeIds,
+		std::set<Id>* edgeIds) const;
+	void expandTrailSearch(
+		TrailSearch* search,
+		NodeType::TypeMask nodeTypes,
+		Edge::TypeMask edgeTypes,
+		bool nodeNonIndexed,
+		bool directed) const;
+
+	// identifies the database state a cache snapshot is saved for
+	std::string getCacheSnapshotStamp() const;
+	void loadCacheSnapshot(const StorageCacheSnapshot& snapshot);
+	StorageCacheSnapshot createCacheSnapshot(
+		const std::vector<StorageCacheSnapshot::HierarchyEdge>& hierarchyEdges) const;
 
 	bool m_preIndexingErrorCountSet = false;
 	size_t m_preIndexingErrorCount = 0;
 	size_t m_preInjectionErrorCount = 0;
+	bool m_injectionGroupStarted = false;
 
 	SearchIndex m_commandIndex;
-	SearchIndex m_symbolIndex;
 	SearchIndex m_fileIndex;
 
+	// symbols are split up by the delimiter of their names, which keeps the languages apart. Shards
+	// stored in the database are only read once a search needs them.
+	SymbolIndexShards m_symbolIndexShards;
+	std::vector<Id> m_recentNodeIds;
+	mutable std::mutex m_symbolIndexShardsMutex;
+
 	mutable FullTextSearchIndex m_fullTextSearchIndex;
 	mutable std::string m_fullTextSearchCodec;
 	mutable std::mutex m_fullTextSearchMutex;
@@ -272,19 +533,60 @@ private:
 	SqliteIndexStorage m_sqliteIndexStorage;
 	SqliteBookmarkStorage m_sqliteBookmarkStorage;
 
-	std::map<FilePath, Id> m_fileNodeIds;
-	std::map<FilePath, Id> m_lowerCasefileNodeIds;
-	std::map<Id, FilePath> m_fileNodePaths;
+	// const queries use a pooled connection unless the changes of an open transaction have to be
+	// visible to them
+	SqliteIndexStoragePool::ScopedStorage getReadIndexStorage() const;
+	SqliteStorageSettings m_indexStorageSettings;
+	std::unique_ptr<SqliteIndexStoragePool> m_readStoragePool;
+	std::atomic<bool> m_readStoragePoolEnabled;
+
+	std::atomic<size_t> m_contentVersion;
+
+	// ids of bookmarked nodes and edges, which are only valid for one content version
+	typedef std::tuple<Id, Id, int> BookmarkedEdgeKey;	  // source node, target node and edge type
+	mutable std::unordered_map<std::wstring, Id> m_bookmarkedNodeIds;
+	mutable std::map<BookmarkedEdgeKey, Id> m_bookmarkedEdgeIds;
+	mutable size_t m_bookmarkIndexVersion = 0;
+	mutable std::mutex m_bookmarkIndexMutex;
+
+	// element ids of the locations of the files loaded last, code view clicks are resolved with them
+	struct LocationElementIds
+	{
+		Id fileId;
+		std::unordered_map<Id, std::vector<Id>> elementIds;
+	};
+	static const size_t s_maxLocationElementIdsFileCount;
+	mutable std::list<LocationElementIds> m_locationElementIds;	   // most recently loaded in front
+	mutable std::mutex m_locationElementIdsMutex;
+
+	// paths and languages are kept as handles of the InternedStringPool
+	std::unordered_map<InternedStringPool::Handle, Id> m_fileNodeIds;
+	std::unordered_map<InternedStringPool::Handle, Id> m_lowerCasefileNodeIds;
+	std::map<Id, InternedStringPool::Handle> m_fileNodePaths;
 	std::map<Id, bool> m_fileNodeComplete;
 	std::map<Id, bool> m_fileNodeIndexed;
-	std::map<Id, std::wstring> m_fileNodeLanguage;
+	std::map<Id, InternedStringPool::Handle> m_fileNodeLanguage;
 
 	std::map<Id, DefinitionKind> m_symbolDefinitionKinds;
 	std::map<Id, Id> m_memberEdgeIdOrderMap;
 
 	HierarchyCache m_hierarchyCache;
+	AdjacencyCache m_adjacencyCache;
+	AggregationCache m_aggregationCache;
+	FileReachabilityIndex m_fileReachabilityIndex;	  // keyed by the ids of the file nodes
+	bool m_hasFileReachabilityIndex = false;
+	OverviewSummary m_overviewSummary;
+
+	std::shared_ptr<const IndexReplica> m_indexReplica;
+	mutable std::mutex m_indexReplicaMutex;
+	size_t m_indexReplicaGeneration = 0;	// replicas of previous generations are not used
+	std::future<void> m_indexReplicaBuild;
 
 	bool m_hasJavaFiles = false;
+	// leaves the symbol search index, the adjacency cache and the index replica to the database
+	bool m_lowMemoryMode = false;
+
+	FilePath m_cacheSnapshotFilePath;
 };
 
 #endif	  // PERSISTENT_STORAGE_H
@@ -134,24 +134,42 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject local symbols");
 
-		const std::set<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
+		std::vector<StorageLocalSymbol> symbols = injected->getStorageLocalSymbols();
+		for (size_t i = 0; i < symbols.size(); i++)
+		{
+			if (!symbols[i].fileNodeId)
+			{
+				continue;
+			}
+
+			auto it = injectedIdToOwnElementId.find(symbols[i].fileNodeId);
+			if (it != injectedIdToOwnElementId.end())
+			{
+				symbols[i].fileNodeId = it->second;
+			}
+			else
+			{
+				LOG_WARNING("New local symbol file id could not be found.");
+				symbols.erase(symbols.begin() + i);
+				i--;
+			}
+		}
+
 		std::vector<Id> symbolIds = addLocalSymbols(symbols);
 
-		auto it = symbols.begin();
 		for (size_t i = 0; i < symbols.size(); i++)
 		{
 			if (symbolIds[i])
 			{
-				injectedIdToOwnElementId.emplace(it->id, symbolIds[i]);
+				injectedIdToOwnElementId.emplace(symbols[i].id, symbolIds[i]);
 			}
-			it++;
 		}
 	}
 
 	{
 		// TRACE("inject locations");
 
-		const std::set<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
+		const std::vector<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
 		std::vector<StorageSourceLocation> locations;
 		locations.reserve(oldLocations.size());
 
@@ -193,7 +211,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject occurrences");
 
-		const std::set<StorageOccurrence>& oldOccurences = injected->getStorageOccurrences();
+		const std::vector<StorageOccurrence>& oldOccurences = injected->getStorageOccurrences();
 
 		std::vector<StorageOccurrence> occurrences;
 		occurrences.reserve(oldOccurences.size());
@@ -235,7 +253,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject element components");
 
-		const std::set<StorageElementComponent>& oldComponents = injected->getElementComponents();
+		const std::vector<StorageElementComponent>& oldComponents = injected->getElementComponents();
 		std::vector<StorageElementComponent> components;
 		components.reserve(oldComponents.size());
 
@@ -254,7 +272,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject accesses");
 
-		const std::set<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
+		const std::vector<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
 		std::vector<StorageComponentAccess> accesses;
 		accesses.reserve(oldAccesses.size());
 
@@ -270,9 +288,36 @@ void Storage::inject(Storage* injected)
 		addComponentAccesses(accesses);
 	}
 
+	{
+		// TRACE("inject indexing times");
+
+		addIndexingTimes(injected->getIndexingTimes());
+	}
+
 	finishInjection();
 }
 
+void Storage::addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes)
+{
+	// may be implemented in derived
+}
+
+std::vector<StorageIndexingTime> Storage::getIndexingTimes() const
+{
+	// may be implemented in derived
+	return {};
+}
+
+void Storage::startInjectionGroup()
+{
+	// may be implemented in derived
+}
+
+void Storage::finishInjectionGroup()
+{
+	// may be implemented in derived
+}
+
 void Storage::startInjection()
 {
 	// may be implemented in derived
@@ -3,14 +3,15 @@
 
 #include <functional>
 #include <mutex>
-#include <set>
 #include <string>
+#include <vector>
 
 #include "StorageComponentAccess.h"
 #include "StorageEdge.h"
 #include "StorageElementComponent.h"
 #include "StorageError.h"
 #include "StorageFile.h"
+#include "StorageIndexingTime.h"
 #include "StorageLocalSymbol.h"
 #include "StorageNode.h"
 #include "StorageOccurrence.h"
@@ -32,7 +33,7 @@ public:
 	virtual Id addEdge(const StorageEdgeData& data) = 0;
 	virtual std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) = 0;
 	virtual Id addLocalSymbol(const StorageLocalSymbolData& data) = 0;
-	virtual std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) = 0;
+	virtual std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) = 0;
 	virtual Id addSourceLocation(const StorageSourceLocationData& data) = 0;
 	virtual std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) = 0;
 	virtual void addOccurrence(const StorageOccurrence& data) = 0;
@@ -47,15 +48,24 @@ public:
 	virtual const std::vector<StorageFile>& getStorageFiles() const = 0;
 	virtual const std::vector<StorageSymbol>& getStorageSymbols() const = 0;
 	virtual const std::vector<StorageEdge>& getStorageEdges() const = 0;
-	virtual const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const = 0;
-	virtual const std::set<StorageSourceLocation>& getStorageSourceLocations() const = 0;
-	virtual const std::set<StorageOccurrence>& getStorageOccurrences() const = 0;
-	virtual const std::set<StorageComponentAccess>& getComponentAccesses() const = 0;
-	virtual const std::set<StorageElementComponent>& getElementComponents() const = 0;
+	virtual const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const = 0;
+	virtual const std::vector<StorageSourceLocation>& getStorageSourceLocations() const = 0;
+	virtual const std::vector<StorageOccurrence>& getStorageOccurrences() const = 0;
+	virtual const std::vector<StorageComponentAccess>& getComponentAccesses() const = 0;
+	virtual const std::vector<StorageElementComponent>& getElementComponents() const = 0;
 	virtual const std::vector<StorageError>& getErrors() const = 0;
 
+	// may be implemented in derived, storages that don't keep indexing times ignore them
+	virtual void addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes);
+	virtual std::vector<StorageIndexingTime> getIndexingTimes() const;
+
 	void inject(Storage* injected);
 
+	// may be implemented in derived, keeps all injections until the group is finished in one
+	// transaction
+	virtual void startInjectionGroup();
+	virtual void finishInjectionGroup();
+
 private:
 	virtual void startInjection();
 	virtual void finishInjection();
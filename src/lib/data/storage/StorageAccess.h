@@ -1,6 +1,8 @@
 #ifndef STORAGE_ACCESS_H
 #define STORAGE_ACCESS_H
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,6 +19,7 @@
 #include "NodeBookmark.h"
 #include "SearchMatch.h"
 #include "StorageEdge.h"
+#include "MemoryUsage.h"
 #include "StorageStats.h"
 #include "TooltipInfo.h"
 #include "TooltipOrigin.h"
@@ -35,6 +38,9 @@ class StorageAccess
 public:
 	virtual ~StorageAccess() = default;
 
+	// changes whenever the indexed data changes, e.g. after a refresh
+	virtual size_t getContentVersion() const = 0;
+
 	virtual Id getNodeIdForFileNode(const FilePath& filePath) const = 0;
 	virtual Id getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const = 0;
 	virtual std::vector<Id> getNodeIdsForNameHierarchies(
@@ -50,15 +56,25 @@ public:
 
 	virtual StorageEdge getEdgeById(Id edgeId) const = 0;
 
+	// partialResultsCallback is called on the calling thread with the results found so far
 	virtual std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const = 0;
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback) const = 0;
+	// returns no matches once isCancelled returns true, which is checked while searching
 	virtual std::vector<SearchMatch> getAutocompletionMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const = 0;
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		bool acceptCommands,
+		std::function<bool()> isCancelled) const = 0;
 	virtual std::vector<SearchMatch> getSearchMatchesForTokenIds(
 		const std::vector<Id>& tokenIds) const = 0;
 
 	virtual std::shared_ptr<Graph> getGraphForAll() const = 0;
 	virtual std::shared_ptr<Graph> getGraphForNodeTypes(NodeTypeSet nodeTypes) const = 0;
+	// the number of nodes of getGraphForAll for each type, empty if these were not counted
+	virtual std::map<NodeType::Type, size_t> getOverviewNodeCounts() const = 0;
+	virtual std::shared_ptr<Graph> getGraphForOverviewNodeType(NodeType nodeType) const = 0;
 	virtual std::shared_ptr<Graph> getGraphForActiveTokenIds(
 		const std::vector<Id>& tokenIds,
 		const std::vector<Id>& expandedNodeIds,
@@ -72,6 +88,17 @@ public:
 		bool nodeNonIndexed,
 		size_t depth,
 		bool directed) const = 0;
+	// partialResultsCallback is called on the calling thread with the graph of the levels traversed
+	// so far if the trail has no target, the traversal stops once it returns false
+	virtual std::shared_ptr<Graph> getGraphForTrail(
+		Id originId,
+		Id targetId,
+		NodeType::TypeMask nodeTypes,
+		Edge::TypeMask edgeTypes,
+		bool nodeNonIndexed,
+		size_t depth,
+		bool directed,
+		std::function<bool(std::shared_ptr<Graph>)> partialResultsCallback) const = 0;
 
 	virtual NodeType::TypeMask getAvailableNodeTypes() const = 0;
 	virtual Edge::TypeMask getAvailableEdgeTypes() const = 0;
@@ -81,6 +108,19 @@ public:
 
 	virtual std::shared_ptr<SourceLocationCollection> getSourceLocationsForTokenIds(
 		const std::vector<Id>& tokenIds) const = 0;
+	// partialResultsCallback is called on the calling thread once the first files are complete
+	virtual std::shared_ptr<SourceLocationCollection> getSourceLocationsForTokenIds(
+		const std::vector<Id>& tokenIds,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback)
+		const = 0;
+	// the number of files getSourceLocationsPageForTokenIds pages through, 0 if the tokens contain
+	// a file, which is shown as a whole, referenceCount receives the number of references in them
+	virtual size_t getSourceLocationFileCountForTokenIds(
+		const std::vector<Id>& tokenIds, size_t* referenceCount) const = 0;
+	// the locations of the tokens in the files following the file of the cursor, ordered by path,
+	// the cursor is moved to the last file of the page, an empty cursor starts with the first file
+	virtual std::shared_ptr<SourceLocationCollection> getSourceLocationsPageForTokenIds(
+		const std::vector<Id>& tokenIds, FilePath* cursor, size_t fileCount) const = 0;
 	virtual std::shared_ptr<SourceLocationCollection> getSourceLocationsForLocationIds(
 		const std::vector<Id>& locationIds) const = 0;
 
@@ -102,7 +142,13 @@ public:
 
 	virtual StorageStats getStorageStats() const = 0;
 
+	// heap bytes of the caches and indices kept in memory, the database itself is not included
+	virtual MemoryUsage getMemoryUsage() const = 0;
+
 	virtual ErrorCountInfo getErrorCount() const = 0;
+	// counts all errors passing the filter, without applying its limit and offset
+	virtual ErrorCountInfo getErrorCountForFilter(const ErrorFilter& filter) const = 0;
+	// the limit and offset of the filter select one page of the errors, ordered by id
 	virtual std::vector<ErrorInfo> getErrorsLimited(const ErrorFilter& filter) const = 0;
 	virtual std::vector<ErrorInfo> getErrorsForFileLimited(
 		const ErrorFilter& filter, const FilePath& filePath) const = 0;
@@ -122,6 +168,9 @@ public:
 	virtual void removeBookmark(const Id id) = 0;
 	virtual void removeBookmarkCategory(const Id id) = 0;
 
+	// most recently active nodes first, these get ranked up in autocompletion matches
+	virtual void setRecentNodeIds(const std::vector<Id>& nodeIds) = 0;
+
 	virtual std::vector<NodeBookmark> getAllNodeBookmarks() const = 0;
 	virtual std::vector<EdgeBookmark> getAllEdgeBookmarks() const = 0;
 	virtual std::vector<BookmarkCategory> getAllBookmarkCategories() const = 0;
@@ -131,6 +180,12 @@ public:
 	virtual TooltipInfo getTooltipInfoForSourceLocationIdsAndLocalSymbolIds(
 		const std::vector<Id>& locationIds, const std::vector<Id>& localSymbolIds) const = 0;
 
+	// computes the tooltips of single tokens ahead of time, the user is about to hover them
+	virtual void prefetchTooltipInfosForTokenIds(
+		const std::vector<Id>& tokenIds, TooltipOrigin origin) const
+	{
+	}
+
 	virtual void setUseErrorCache(bool enabled) {}
 	virtual void addErrorsToCache(const std::vector<ErrorInfo>& newErrors, const ErrorCountInfo& errorCount)
 	{
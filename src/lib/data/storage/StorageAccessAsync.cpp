@@ -0,0 +1,82 @@
+#include "StorageAccessAsync.h"
+
+#include "Graph.h"
+#include "NameHierarchy.h"
+#include "SourceLocationCollection.h"
+#include "StorageAccess.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
+
+StorageAccessAsync::StorageAccessAsync(const StorageAccess* storageAccess)
+	: m_storageAccess(storageAccess)
+{
+}
+
+std::future<Id> StorageAccessAsync::getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const
+{
+	const StorageAccess* storageAccess = m_storageAccess;
+	return run<Id>([storageAccess, nameHierarchy]() {
+		return storageAccess->getNodeIdForNameHierarchy(nameHierarchy);
+	});
+}
+
+std::future<std::vector<SearchMatch>> StorageAccessAsync::getSearchMatchesForTokenIds(
+	const std::vector<Id>& tokenIds) const
+{
+	const StorageAccess* storageAccess = m_storageAccess;
+	return run<std::vector<SearchMatch>>([storageAccess, tokenIds]() {
+		return storageAccess->getSearchMatchesForTokenIds(tokenIds);
+	});
+}
+
+std::future<StorageAccessAsync::GraphResult> StorageAccessAsync::getGraphForActiveTokenIds(
+	const std::vector<Id>& tokenIds, const std::vector<Id>& expandedNodeIds) const
+{
+	const StorageAccess* storageAccess = m_storageAccess;
+	return run<GraphResult>([storageAccess, tokenIds, expandedNodeIds]() {
+		GraphResult result;
+		result.graph = storageAccess->getGraphForActiveTokenIds(
+			tokenIds, expandedNodeIds, &result.isActiveNamespace);
+		return result;
+	});
+}
+
+std::future<StorageAccessAsync::ActiveTokenIdsResult> StorageAccessAsync::getActiveTokenIdsForId(
+	Id tokenId) const
+{
+	const StorageAccess* storageAccess = m_storageAccess;
+	return run<ActiveTokenIdsResult>([storageAccess, tokenId]() {
+		ActiveTokenIdsResult result;
+		result.tokenIds = storageAccess->getActiveTokenIdsForId(tokenId, &result.declarationId);
+		return result;
+	});
+}
+
+std::future<std::shared_ptr<SourceLocationCollection>> StorageAccessAsync::
+	getSourceLocationsForTokenIds(const std::vector<Id>& tokenIds) const
+{
+	const StorageAccess* storageAccess = m_storageAccess;
+	return run<std::shared_ptr<SourceLocationCollection>>([storageAccess, tokenIds]() {
+		return storageAccess->getSourceLocationsForTokenIds(tokenIds);
+	});
+}
+
+std::future<TooltipInfo> StorageAccessAsync::getTooltipInfoForTokenIds(
+	const std::vector<Id>& tokenIds, TooltipOrigin origin) const
+{
+	const StorageAccess* storageAccess = m_storageAccess;
+	return run<TooltipInfo>([storageAccess, tokenIds, origin]() {
+		return storageAccess->getTooltipInfoForTokenIds(tokenIds, origin);
+	});
+}
+
+template <typename ResultType>
+std::future<ResultType> StorageAccessAsync::run(std::function<ResultType()> function)
+{
+	std::shared_ptr<std::packaged_task<ResultType()>> task =
+		std::make_shared<std::packaged_task<ResultType()>>(std::move(function));
+	std::future<ResultType> future = task->get_future();
+
+	TaskManager::getThreadPool()->runBlocking([task]() { (*task)(); });
+	return future;
+}
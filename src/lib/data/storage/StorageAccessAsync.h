@@ -0,0 +1,58 @@
+#ifndef STORAGE_ACCESS_ASYNC_H
+#define STORAGE_ACCESS_ASYNC_H
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "SearchMatch.h"
+#include "TooltipInfo.h"
+#include "TooltipOrigin.h"
+#include "types.h"
+
+class Graph;
+class NameHierarchy;
+class SourceLocationCollection;
+class StorageAccess;
+
+// Runs the calls of the storage that controllers make on every activation outside of the thread
+// of their scheduler, so independent queries can overlap instead of waiting for each other. The
+// calls run on the blocking threads of the thread pool, because the storage waits for jobs of the
+// pool itself while answering them. The storage access has to outlive the returned futures.
+class StorageAccessAsync
+{
+public:
+	struct GraphResult
+	{
+		std::shared_ptr<Graph> graph;
+		bool isActiveNamespace = false;
+	};
+
+	struct ActiveTokenIdsResult
+	{
+		std::vector<Id> tokenIds;
+		Id declarationId = 0;
+	};
+
+	StorageAccessAsync(const StorageAccess* storageAccess);
+
+	std::future<Id> getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const;
+	std::future<std::vector<SearchMatch>> getSearchMatchesForTokenIds(
+		const std::vector<Id>& tokenIds) const;
+	std::future<GraphResult> getGraphForActiveTokenIds(
+		const std::vector<Id>& tokenIds, const std::vector<Id>& expandedNodeIds) const;
+	std::future<ActiveTokenIdsResult> getActiveTokenIdsForId(Id tokenId) const;
+	std::future<std::shared_ptr<SourceLocationCollection>> getSourceLocationsForTokenIds(
+		const std::vector<Id>& tokenIds) const;
+	std::future<TooltipInfo> getTooltipInfoForTokenIds(
+		const std::vector<Id>& tokenIds, TooltipOrigin origin) const;
+
+private:
+	template <typename ResultType>
+	static std::future<ResultType> run(std::function<ResultType()> function);
+
+	const StorageAccess* m_storageAccess;
+};
+
+#endif	  // STORAGE_ACCESS_ASYNC_H
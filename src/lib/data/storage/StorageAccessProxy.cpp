@@ -153,6 +153,38 @@ void StorageAccessProxy::setSubject(std::weak_ptr<StorageAccess> subject)
 		return _DEFAULT_VALUE_;                                                                    \
 	}
 
+#define DEF_GETTER_8(                                                                              \
+	_METHOD_NAME_,                                                                                 \
+	_PARAM_1_TYPE_,                                                                                \
+	_PARAM_2_TYPE_,                                                                                \
+	_PARAM_3_TYPE_,                                                                                \
+	_PARAM_4_TYPE_,                                                                                \
+	_PARAM_5_TYPE_,                                                                                \
+	_PARAM_6_TYPE_,                                                                                \
+	_PARAM_7_TYPE_,                                                                                \
+	_PARAM_8_TYPE_,                                                                                \
+	_RETURN_TYPE_,                                                                                 \
+	_DEFAULT_VALUE_)                                                                               \
+	UNWRAP(_RETURN_TYPE_)                                                                          \
+	StorageAccessProxy::_METHOD_NAME_(                                                             \
+		_PARAM_1_TYPE_ p1,                                                                         \
+		_PARAM_2_TYPE_ p2,                                                                         \
+		_PARAM_3_TYPE_ p3,                                                                         \
+		_PARAM_4_TYPE_ p4,                                                                         \
+		_PARAM_5_TYPE_ p5,                                                                         \
+		_PARAM_6_TYPE_ p6,                                                                         \
+		_PARAM_7_TYPE_ p7,                                                                         \
+		_PARAM_8_TYPE_ p8) const                                                                   \
+	{                                                                                              \
+		if (std::shared_ptr<StorageAccess> subject = m_subject.lock())                             \
+		{                                                                                          \
+			return subject->_METHOD_NAME_(p1, p2, p3, p4, p5, p6, p7, p8);                         \
+		}                                                                                          \
+		return _DEFAULT_VALUE_;                                                                    \
+	}
+
+DEF_GETTER_0(getContentVersion, size_t, 0)
+
 DEF_GETTER_1(getNodeIdForFileNode, const FilePath&, Id, 0)
 DEF_GETTER_1(getNodeIdForNameHierarchy, const NameHierarchy&, Id, 0)
 DEF_GETTER_1(getNodeIdsForNameHierarchies, const std::vector<NameHierarchy>, std::vector<Id>, {})
@@ -164,17 +196,21 @@ DEF_GETTER_1(getNodeIdToParentFileMap, const std::vector<Id>&, NodeIdToParentFil
 
 DEF_GETTER_1(getNodeTypeForNodeWithId, Id, NodeType, NodeType(NodeType::NODE_SYMBOL))
 DEF_GETTER_1(getEdgeById, Id, StorageEdge, StorageEdge())
-DEF_GETTER_2(
+typedef std::function<void(std::shared_ptr<SourceLocationCollection>)> PartialResultsCallback;
+DEF_GETTER_3(
 	getFullTextSearchLocations,
 	const std::wstring&,
 	bool,
+	PartialResultsCallback,
 	std::shared_ptr<SourceLocationCollection>,
 	std::make_shared<SourceLocationCollection>())
-DEF_GETTER_3(
+typedef std::function<bool()> IsCancelledCallback;
+DEF_GETTER_4(
 	getAutocompletionMatches,
 	const std::wstring&,
 	NodeTypeSet,
 	bool,
+	IsCancelledCallback,
 	std::vector<SearchMatch>,
 	std::vector<SearchMatch>())
 DEF_GETTER_1(
@@ -184,6 +220,10 @@ DEF_GETTER_1(
 	std::vector<SearchMatch>())
 DEF_GETTER_0(getGraphForAll, std::shared_ptr<Graph>, std::make_shared<Graph>())
 DEF_GETTER_1(getGraphForNodeTypes, NodeTypeSet, std::shared_ptr<Graph>, std::make_shared<Graph>())
+typedef std::map<NodeType::Type, size_t> NodeTypeCountMap;
+DEF_GETTER_0(getOverviewNodeCounts, NodeTypeCountMap, {})
+DEF_GETTER_1(
+	getGraphForOverviewNodeType, NodeType, std::shared_ptr<Graph>, std::make_shared<Graph>())
 DEF_GETTER_3(
 	getGraphForActiveTokenIds,
 	const std::vector<Id>&,
@@ -203,6 +243,18 @@ DEF_GETTER_7(
 	bool,
 	std::shared_ptr<Graph>,
 	std::make_shared<Graph>())
+DEF_GETTER_8(
+	getGraphForTrail,
+	Id,
+	Id,
+	NodeType::TypeMask,
+	Edge::TypeMask,
+	bool,
+	size_t,
+	bool,
+	std::function<bool(std::shared_ptr<Graph>)>,
+	std::shared_ptr<Graph>,
+	std::make_shared<Graph>())
 DEF_GETTER_0(getAvailableNodeTypes, NodeType::TypeMask, 0);
 DEF_GETTER_0(getAvailableEdgeTypes, Edge::TypeMask, 0);
 DEF_GETTER_2(getActiveTokenIdsForId, Id, Id*, std::vector<Id>, {})
@@ -212,6 +264,20 @@ DEF_GETTER_1(
 	const std::vector<Id>&,
 	std::shared_ptr<SourceLocationCollection>,
 	std::make_shared<SourceLocationCollection>())
+DEF_GETTER_2(
+	getSourceLocationsForTokenIds,
+	const std::vector<Id>&,
+	PartialResultsCallback,
+	std::shared_ptr<SourceLocationCollection>,
+	std::make_shared<SourceLocationCollection>())
+DEF_GETTER_2(getSourceLocationFileCountForTokenIds, const std::vector<Id>&, size_t*, size_t, 0)
+DEF_GETTER_3(
+	getSourceLocationsPageForTokenIds,
+	const std::vector<Id>&,
+	FilePath*,
+	size_t,
+	std::shared_ptr<SourceLocationCollection>,
+	std::make_shared<SourceLocationCollection>())
 DEF_GETTER_1(
 	getSourceLocationsForLocationIds,
 	const std::vector<Id>&,
@@ -240,7 +306,9 @@ DEF_GETTER_1(getFileInfoForFileId, Id, FileInfo, FileInfo())
 DEF_GETTER_1(getFileInfoForFilePath, const FilePath&, FileInfo, FileInfo())
 DEF_GETTER_1(getFileInfosForFilePaths, const std::vector<FilePath>&, std::vector<FileInfo>, {})
 DEF_GETTER_0(getStorageStats, StorageStats, StorageStats())
+DEF_GETTER_0(getMemoryUsage, MemoryUsage, MemoryUsage())
 DEF_GETTER_0(getErrorCount, ErrorCountInfo, ErrorCountInfo())
+DEF_GETTER_1(getErrorCountForFilter, const ErrorFilter&, ErrorCountInfo, ErrorCountInfo())
 DEF_GETTER_1(getErrorsLimited, const ErrorFilter&, std::vector<ErrorInfo>, {})
 DEF_GETTER_2(getErrorsForFileLimited, const ErrorFilter&, const FilePath&, std::vector<ErrorInfo>, {})
 DEF_GETTER_1(
@@ -307,6 +375,14 @@ void StorageAccessProxy::removeBookmarkCategory(const Id id)
 	}
 }
 
+void StorageAccessProxy::setRecentNodeIds(const std::vector<Id>& nodeIds)
+{
+	if (std::shared_ptr<StorageAccess> subject = m_subject.lock())
+	{
+		subject->setRecentNodeIds(nodeIds);
+	}
+}
+
 DEF_GETTER_0(getAllNodeBookmarks, std::vector<NodeBookmark>, {})
 DEF_GETTER_0(getAllEdgeBookmarks, std::vector<EdgeBookmark>, {})
 DEF_GETTER_0(getAllBookmarkCategories, std::vector<BookmarkCategory>, {})
@@ -13,6 +13,8 @@ public:
 	void setSubject(std::weak_ptr<StorageAccess> subject);
 
 	// StorageAccess implementation
+	size_t getContentVersion() const override;
+
 	Id getNodeIdForFileNode(const FilePath& filePath) const override;
 	Id getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const override;
 	std::vector<Id> getNodeIdsForNameHierarchies(
@@ -28,13 +30,21 @@ public:
 	StorageEdge getEdgeById(Id edgeId) const override;
 
 	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback)
+		const override;
 	std::vector<SearchMatch> getAutocompletionMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		bool acceptCommands,
+		std::function<bool()> isCancelled) const override;
 	std::vector<SearchMatch> getSearchMatchesForTokenIds(const std::vector<Id>& tokenIds) const override;
 
 	std::shared_ptr<Graph> getGraphForAll() const override;
 	std::shared_ptr<Graph> getGraphForNodeTypes(NodeTypeSet nodeTypes) const override;
+	std::map<NodeType::Type, size_t> getOverviewNodeCounts() const override;
+	std::shared_ptr<Graph> getGraphForOverviewNodeType(NodeType nodeType) const override;
 	std::shared_ptr<Graph> getGraphForActiveTokenIds(
 		const std::vector<Id>& tokenIds,
 		const std::vector<Id>& expandedNodeIds,
@@ -48,6 +58,15 @@ public:
 		bool nodeNonIndexed,
 		size_t depth,
 		bool directed) const override;
+	std::shared_ptr<Graph> getGraphForTrail(
+		Id originId,
+		Id targetId,
+		NodeType::TypeMask nodeTypes,
+		Edge::TypeMask edgeTypes,
+		bool nodeNonIndexed,
+		size_t depth,
+		bool directed,
+		std::function<bool(std::shared_ptr<Graph>)> partialResultsCallback) const override;
 
 	NodeType::TypeMask getAvailableNodeTypes() const override;
 	Edge::TypeMask getAvailableEdgeTypes() const override;
@@ -57,6 +76,14 @@ public:
 
 	std::shared_ptr<SourceLocationCollection> getSourceLocationsForTokenIds(
 		const std::vector<Id>& tokenIds) const override;
+	std::shared_ptr<SourceLocationCollection> getSourceLocationsForTokenIds(
+		const std::vector<Id>& tokenIds,
+		std::function<void(std::shared_ptr<SourceLocationCollection>)> partialResultsCallback)
+		const override;
+	size_t getSourceLocationFileCountForTokenIds(
+		const std::vector<Id>& tokenIds, size_t* referenceCount) const override;
+	std::shared_ptr<SourceLocationCollection> getSourceLocationsPageForTokenIds(
+		const std::vector<Id>& tokenIds, FilePath* cursor, size_t fileCount) const override;
 	std::shared_ptr<SourceLocationCollection> getSourceLocationsForLocationIds(
 		const std::vector<Id>& locationIds) const override;
 
@@ -74,8 +101,10 @@ public:
 	std::vector<FileInfo> getFileInfosForFilePaths(const std::vector<FilePath>& filePaths) const override;
 
 	StorageStats getStorageStats() const override;
+	MemoryUsage getMemoryUsage() const override;
 
 	ErrorCountInfo getErrorCount() const override;
+	ErrorCountInfo getErrorCountForFilter(const ErrorFilter& filter) const override;
 	std::vector<ErrorInfo> getErrorsLimited(const ErrorFilter& filter) const override;
 	std::vector<ErrorInfo> getErrorsForFileLimited(
 		const ErrorFilter& filter, const FilePath& filePath) const override;
@@ -94,6 +123,8 @@ public:
 		const std::wstring& categoryName) override;
 	void removeBookmark(const Id id) override;
 	void removeBookmarkCategory(const Id id) override;
+
+	void setRecentNodeIds(const std::vector<Id>& nodeIds) override;
 	// END TODO
 
 	std::vector<NodeBookmark> getAllNodeBookmarks() const override;
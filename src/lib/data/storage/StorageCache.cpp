@@ -5,9 +5,12 @@
 #include "TextAccess.h"
 #include "utility.h"
 
+const size_t StorageCache::s_maxTooltipCount = 100;
+
 void StorageCache::clear()
 {
 	m_graphForAll.reset();
+	clearTooltipInfos();
 
 	m_storageStats = StorageStats();
 
@@ -34,6 +37,21 @@ StorageStats StorageCache::getStorageStats() const
 	return m_storageStats;
 }
 
+MemoryUsage StorageCache::getMemoryUsage() const
+{
+	MemoryUsage usage = StorageAccessProxy::getMemoryUsage();
+
+	size_t errorByteSize = utility::getByteSize(m_cachedErrors);
+	for (const ErrorInfo& error: m_cachedErrors)
+	{
+		errorByteSize += utility::getByteSize(error.message) + utility::getByteSize(error.filePath) +
+			utility::getByteSize(error.translationUnit);
+	}
+	usage.add("error cache", errorByteSize);
+
+	return usage;
+}
+
 std::shared_ptr<TextAccess> StorageCache::getFileContent(const FilePath& filePath, bool showsErrors) const
 {
 	if (m_useErrorCache && showsErrors)
@@ -54,6 +72,19 @@ ErrorCountInfo StorageCache::getErrorCount() const
 	return m_errorCount;
 }
 
+ErrorCountInfo StorageCache::getErrorCountForFilter(const ErrorFilter& filter) const
+{
+	if (!m_useErrorCache)
+	{
+		return StorageAccessProxy::getErrorCountForFilter(filter);
+	}
+
+	ErrorFilter filterUnlimited = filter;
+	filterUnlimited.limit = 0;
+	filterUnlimited.offset = 0;
+	return ErrorCountInfo(filterUnlimited.filterErrors(m_cachedErrors));
+}
+
 std::vector<ErrorInfo> StorageCache::getErrorsLimited(const ErrorFilter& filter) const
 {
 	if (!m_useErrorCache)
@@ -107,6 +138,32 @@ std::shared_ptr<SourceLocationCollection> StorageCache::getErrorSourceLocations(
 	return collection;
 }
 
+TooltipInfo StorageCache::getTooltipInfoForTokenIds(
+	const std::vector<Id>& tokenIds, TooltipOrigin origin) const
+{
+	const TooltipKey key(tokenIds, origin);
+
+	TooltipInfo info;
+	if (getCachedTooltipInfo(key, &info))
+	{
+		return info;
+	}
+
+	// the version is taken first, a change while the tooltip is computed drops it again
+	const size_t contentVersion = getContentVersion();
+	info = StorageAccessProxy::getTooltipInfoForTokenIds(tokenIds, origin);
+	addTooltipInfo(key, contentVersion, info);
+	return info;
+}
+
+void StorageCache::prefetchTooltipInfosForTokenIds(
+	const std::vector<Id>& tokenIds, TooltipOrigin origin) const
+{
+	for (Id tokenId: tokenIds)
+	{
+		getTooltipInfoForTokenIds({tokenId}, origin);
+	}
+}
 
 void StorageCache::setUseErrorCache(bool enabled)
 {
@@ -121,3 +178,65 @@ void StorageCache::addErrorsToCache(
 	utility::append(m_cachedErrors, newErrors);
 	m_errorCount = errorCount;
 }
+
+bool StorageCache::getCachedTooltipInfo(const TooltipKey& key, TooltipInfo* info) const
+{
+	const size_t contentVersion = getContentVersion();
+
+	std::lock_guard<std::mutex> lock(m_tooltipMutex);
+	if (contentVersion != m_tooltipContentVersion)
+	{
+		return false;
+	}
+
+	auto it = m_tooltipIndex.find(key);
+	if (it == m_tooltipIndex.end())
+	{
+		return false;
+	}
+
+	m_tooltips.splice(m_tooltips.begin(), m_tooltips, it->second);
+	*info = it->second->second;
+	return true;
+}
+
+void StorageCache::addTooltipInfo(
+	const TooltipKey& key, size_t contentVersion, const TooltipInfo& info) const
+{
+	if (contentVersion != getContentVersion())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_tooltipMutex);
+	if (contentVersion != m_tooltipContentVersion)
+	{
+		m_tooltips.clear();
+		m_tooltipIndex.clear();
+		m_tooltipContentVersion = contentVersion;
+	}
+
+	auto it = m_tooltipIndex.find(key);
+	if (it != m_tooltipIndex.end())
+	{
+		m_tooltips.erase(it->second);
+		m_tooltipIndex.erase(it);
+	}
+
+	m_tooltips.emplace_front(key, info);
+	m_tooltipIndex.emplace(key, m_tooltips.begin());
+
+	if (m_tooltips.size() > s_maxTooltipCount)
+	{
+		m_tooltipIndex.erase(m_tooltips.back().first);
+		m_tooltips.pop_back();
+	}
+}
+
+void StorageCache::clearTooltipInfos() const
+{
+	std::lock_guard<std::mutex> lock(m_tooltipMutex);
+	m_tooltips.clear();
+	m_tooltipIndex.clear();
+	m_tooltipContentVersion = 0;
+}
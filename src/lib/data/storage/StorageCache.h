@@ -1,10 +1,15 @@
 #ifndef STORAGE_CACHE_H
 #define STORAGE_CACHE_H
 
+#include <list>
 #include <map>
+#include <mutex>
+#include <utility>
 
 #include "StorageAccessProxy.h"
 
+// Keeps results of the storage that are requested repeatedly, the tooltips of the recently hovered
+// tokens are dropped once the content of the storage changes.
 class StorageCache: public StorageAccessProxy
 {
 public:
@@ -13,27 +18,48 @@ public:
 	std::shared_ptr<Graph> getGraphForAll() const override;
 
 	StorageStats getStorageStats() const override;
+	MemoryUsage getMemoryUsage() const override;
 
 	std::shared_ptr<TextAccess> getFileContent(const FilePath& filePath, bool showsErrors) const override;
 
 	ErrorCountInfo getErrorCount() const override;
+	ErrorCountInfo getErrorCountForFilter(const ErrorFilter& filter) const override;
 	std::vector<ErrorInfo> getErrorsLimited(const ErrorFilter& filter) const override;
 	std::vector<ErrorInfo> getErrorsForFileLimited(
 		const ErrorFilter& filter, const FilePath& filePath) const override;
 	std::shared_ptr<SourceLocationCollection> getErrorSourceLocations(
 		const std::vector<ErrorInfo>& errors) const override;
 
+	TooltipInfo getTooltipInfoForTokenIds(
+		const std::vector<Id>& tokenIds, TooltipOrigin origin) const override;
+	void prefetchTooltipInfosForTokenIds(
+		const std::vector<Id>& tokenIds, TooltipOrigin origin) const override;
+
 	void setUseErrorCache(bool enabled) override;
 	void addErrorsToCache(
 		const std::vector<ErrorInfo>& newErrors, const ErrorCountInfo& errorCount) override;
 
 private:
+	typedef std::pair<std::vector<Id>, TooltipOrigin> TooltipKey;
+	typedef std::list<std::pair<TooltipKey, TooltipInfo>> TooltipList;
+
+	static const size_t s_maxTooltipCount;
+
+	bool getCachedTooltipInfo(const TooltipKey& key, TooltipInfo* info) const;
+	void addTooltipInfo(const TooltipKey& key, size_t contentVersion, const TooltipInfo& info) const;
+	void clearTooltipInfos() const;
+
 	mutable std::shared_ptr<Graph> m_graphForAll;
 	mutable StorageStats m_storageStats;
 
 	bool m_useErrorCache = false;
 	ErrorCountInfo m_errorCount;
 	std::vector<ErrorInfo> m_cachedErrors;
+
+	mutable std::mutex m_tooltipMutex;
+	mutable size_t m_tooltipContentVersion = 0;
+	mutable TooltipList m_tooltips;	   // most recently used in front
+	mutable std::map<TooltipKey, TooltipList::iterator> m_tooltipIndex;
 };
 
 #endif	  // STORAGE_CACHE_H
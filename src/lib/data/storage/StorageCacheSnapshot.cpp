@@ -0,0 +1,236 @@
+#include "StorageCacheSnapshot.h"
+
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FileSystem.h"
+#include "TimeStamp.h"
+#include "logging.h"
+#include "utilityBinary.h"
+#include "utilityString.h"
+#include "utilityUuid.h"
+
+const uint32_t StorageCacheSnapshot::s_version = 3;
+const std::wstring StorageCacheSnapshot::s_tempFileExtension = L".tmp";
+const size_t StorageCacheSnapshot::s_unusedSharedFileDeleteThresholdDays = 14;
+
+std::string StorageCacheSnapshot::getDatabaseStamp(const FilePath& dbFilePath)
+{
+	std::string stamp;
+
+	// changes may still be kept in the write-ahead log of sqlite instead of the database itself
+	for (const FilePath& filePath: {dbFilePath, FilePath(dbFilePath.wstr() + L"-wal")})
+	{
+		if (filePath.recheckExists())
+		{
+			stamp += std::to_string(FileSystem::getFileByteSize(filePath)) + " " +
+				FileSystem::getLastWriteTime(filePath).toString() + ";";
+		}
+		else
+		{
+			stamp += "-;";
+		}
+	}
+
+	return stamp;
+}
+
+FilePath StorageCacheSnapshot::getSharedFilePath(
+	const FilePath& sharedDirectoryPath, const FilePath& filePath)
+{
+	const std::string path = filePath.getCanonical().str();
+	std::stringstream hash;
+	hash << std::hex << utility::getStableHash(path.data(), path.size());
+
+	return sharedDirectoryPath.getConcatenated(
+		filePath.withoutExtension().fileName() + L"_" + utility::decodeFromUtf8(hash.str()) +
+		filePath.extension());
+}
+
+void StorageCacheSnapshot::removeUnusedSharedFiles(
+	const FilePath& sharedDirectoryPath, const std::wstring& fileExtension)
+{
+	if (!sharedDirectoryPath.recheckExists())
+	{
+		return;
+	}
+
+	// loading a snapshot updates its modification time, temporary files left behind by crashed
+	// instances are removed once they are just as old
+	const TimeStamp now = TimeStamp::now();
+	for (const FilePath& filePath: FileSystem::getFilePathsFromDirectory(sharedDirectoryPath))
+	{
+		if (filePath.fileName().find(fileExtension) != std::wstring::npos &&
+			now.deltaDays(FileSystem::getLastWriteTime(filePath)) >=
+				s_unusedSharedFileDeleteThresholdDays &&
+			FileSystem::remove(filePath))
+		{
+			LOG_INFO(L"Removed unused cache snapshot \"" + filePath.wstr() + L"\"");
+		}
+	}
+}
+
+bool StorageCacheSnapshot::load(const FilePath& filePath, const std::string& databaseStamp)
+{
+	if (!filePath.recheckExists() || FileSystem::getFileByteSize(filePath) == 0)
+	{
+		return false;
+	}
+
+	// mapped instead of read, so all instances loading the snapshot use the same pages
+	try
+	{
+		boost::interprocess::file_mapping mapping(
+			filePath.str().c_str(), boost::interprocess::read_only);
+		boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+		if (!load(
+				static_cast<const char*>(region.get_address()),
+				region.get_size(),
+				databaseStamp,
+				filePath))
+		{
+			return false;
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_STREAM(
+			<< "Unable to map cache snapshot \"" << filePath.str() << "\": " << e.what());
+		return false;
+	}
+
+	// fails for snapshots of other users, which are then removed as if they were not used
+	boost::system::error_code ec;
+	boost::filesystem::last_write_time(filePath.getPath(), std::time(nullptr), ec);
+	return true;
+}
+
+bool StorageCacheSnapshot::load(
+	const char* data, size_t size, const std::string& databaseStamp, const FilePath& filePath)
+{
+	uint32_t header[2] = {0, 0};
+	if (size < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(header, data, sizeof(header));
+	if (header[0] != s_version || header[1] != sizeof(wchar_t))
+	{
+		return false;
+	}
+
+	size_t position = sizeof(header);
+	std::vector<char> stamp;
+	if (!utility::readBinaryData(data, size, position, stamp) ||
+		std::string(stamp.begin(), stamp.end()) != databaseStamp)
+	{
+		return false;
+	}
+
+	StorageCacheSnapshot snapshot;
+	std::vector<char> adjacencyCacheData;
+	std::vector<char> fileReachabilityIndexData;
+	if (!utility::readBinaryData(data, size, position, snapshot.files) ||
+		!utility::readBinaryData(data, size, position, snapshot.text) ||
+		!utility::readBinaryData(data, size, position, snapshot.symbolDefinitionKinds) ||
+		!utility::readBinaryData(data, size, position, snapshot.memberEdgeIdOrder) ||
+		!utility::readBinaryData(data, size, position, snapshot.hierarchyEdges) ||
+		!utility::readBinaryData(data, size, position, adjacencyCacheData) ||
+		!utility::readBinaryData(data, size, position, fileReachabilityIndexData) ||
+		position != size)
+	{
+		LOG_ERROR(L"Cache snapshot \"" + filePath.wstr() + L"\" is malformed and was skipped.");
+		return false;
+	}
+
+	for (const File& file: snapshot.files)
+	{
+		if (file.pathBegin > snapshot.text.size() ||
+			file.pathLength > snapshot.text.size() - file.pathBegin ||
+			file.languageBegin > snapshot.text.size() ||
+			file.languageLength > snapshot.text.size() - file.languageBegin)
+		{
+			LOG_ERROR(L"Cache snapshot \"" + filePath.wstr() + L"\" is malformed and was skipped.");
+			return false;
+		}
+	}
+
+	snapshot.adjacencyCacheData.assign(adjacencyCacheData.begin(), adjacencyCacheData.end());
+	snapshot.fileReachabilityIndexData.assign(
+		fileReachabilityIndexData.begin(), fileReachabilityIndexData.end());
+	*this = std::move(snapshot);
+	return true;
+}
+
+bool StorageCacheSnapshot::save(const FilePath& filePath, const std::string& databaseStamp) const
+{
+	std::string data;
+	const uint32_t header[] = {s_version, uint32_t(sizeof(wchar_t))};
+	data.append(reinterpret_cast<const char*>(header), sizeof(header));
+
+	utility::appendBinaryData(data, std::vector<char>(databaseStamp.begin(), databaseStamp.end()));
+	utility::appendBinaryData(data, files);
+	utility::appendBinaryData(data, text);
+	utility::appendBinaryData(data, symbolDefinitionKinds);
+	utility::appendBinaryData(data, memberEdgeIdOrder);
+	utility::appendBinaryData(data, hierarchyEdges);
+	utility::appendBinaryData(
+		data, std::vector<char>(adjacencyCacheData.begin(), adjacencyCacheData.end()));
+	utility::appendBinaryData(
+		data,
+		std::vector<char>(fileReachabilityIndexData.begin(), fileReachabilityIndexData.end()));
+
+	// written to a temporary file first, so other instances never load half of a snapshot
+	const FilePath tempFilePath(
+		filePath.wstr() + L"." + utility::decodeFromUtf8(utility::getUuidString()) +
+		s_tempFileExtension);
+
+	std::ofstream fileStream(
+		tempFilePath.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	fileStream.write(data.data(), data.size());
+	fileStream.close();
+
+	if (!fileStream)
+	{
+		LOG_ERROR(L"Unable to write cache snapshot \"" + filePath.wstr() + L"\"");
+		FileSystem::remove(tempFilePath);
+		return false;
+	}
+
+	// replaces the snapshot at once, instances that mapped the old one keep reading it
+	boost::system::error_code ec;
+	boost::filesystem::rename(tempFilePath.getPath(), filePath.getPath(), ec);
+	if (ec)
+	{
+		LOG_ERROR(L"Unable to replace cache snapshot \"" + filePath.wstr() + L"\"");
+		FileSystem::remove(tempFilePath);
+		return false;
+	}
+	return true;
+}
+
+void StorageCacheSnapshot::addFile(
+	Id id, const std::wstring& path, const std::wstring& language, uint32_t flags)
+{
+	File file;
+	file.id = uint64_t(id);
+	file.pathBegin = uint32_t(text.size());
+	file.pathLength = uint32_t(path.size());
+	text.insert(text.end(), path.begin(), path.end());
+	file.languageBegin = uint32_t(text.size());
+	file.languageLength = uint32_t(language.size());
+	text.insert(text.end(), language.begin(), language.end());
+	file.flags = flags;
+	files.push_back(file);
+}
+
+std::wstring StorageCacheSnapshot::getText(uint32_t begin, uint32_t length) const
+{
+	return std::wstring(text.data() + begin, length);
+}
@@ -0,0 +1,94 @@
+#ifndef STORAGE_CACHE_SNAPSHOT_H
+#define STORAGE_CACHE_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+#include "types.h"
+
+// Copy of the caches the PersistentStorage builds from its index database, kept in a file next to
+// the database. All data is stored as arrays of fixed size records, so loading it only copies whole
+// blocks instead of running queries. A snapshot is only loaded for the database state it was saved
+// for, which is identified by the size and modification time of the database files.
+// Snapshots are mapped read only while loading and replaced as a whole when saved, so instances of
+// the application on one host can share them in a common directory, where the page cache holds the
+// only copy of the file. Shared snapshots that were not used for some time are removed.
+class StorageCacheSnapshot
+{
+public:
+	enum FileFlag : uint32_t
+	{
+		FILE_COMPLETE = 1 << 0,
+		FILE_INDEXED = 1 << 1
+	};
+
+	enum HierarchyEdgeFlag : uint32_t
+	{
+		EDGE_INHERITANCE = 1 << 0,	  // member edge otherwise
+		EDGE_SOURCE_VISIBLE = 1 << 1,
+		EDGE_SOURCE_IMPLICIT = 1 << 2,
+		EDGE_TARGET_IMPLICIT = 1 << 3
+	};
+
+	struct File
+	{
+		uint64_t id;
+		uint32_t pathBegin;
+		uint32_t pathLength;
+		uint32_t languageBegin;
+		uint32_t languageLength;
+		uint32_t flags;
+	};
+
+	struct IdValue
+	{
+		uint64_t id;
+		uint64_t value;
+	};
+
+	struct HierarchyEdge
+	{
+		uint64_t edgeId;
+		uint64_t sourceId;
+		uint64_t targetId;
+		uint32_t flags;
+	};
+
+	static std::string getDatabaseStamp(const FilePath& dbFilePath);
+
+	// snapshot of the file in the shared directory, named by the file and a hash of its path
+	static FilePath getSharedFilePath(
+		const FilePath& sharedDirectoryPath, const FilePath& filePath);
+	// only touches snapshots and their temporary files, which contain the extension in their names
+	static void removeUnusedSharedFiles(
+		const FilePath& sharedDirectoryPath, const std::wstring& fileExtension);
+
+	bool load(const FilePath& filePath, const std::string& databaseStamp);
+	bool save(const FilePath& filePath, const std::string& databaseStamp) const;
+
+	void addFile(Id id, const std::wstring& path, const std::wstring& language, uint32_t flags);
+	std::wstring getText(uint32_t begin, uint32_t length) const;
+
+	std::vector<File> files;
+	std::vector<wchar_t> text;	  // paths and languages of the files
+	std::vector<IdValue> symbolDefinitionKinds;
+	std::vector<IdValue> memberEdgeIdOrder;
+	std::vector<HierarchyEdge> hierarchyEdges;
+	std::string adjacencyCacheData;
+	std::string fileReachabilityIndexData;
+
+private:
+	bool load(
+		const char* data,
+		size_t size,
+		const std::string& databaseStamp,
+		const FilePath& filePath);
+
+	static const uint32_t s_version;
+	static const std::wstring s_tempFileExtension;
+	static const size_t s_unusedSharedFileDeleteThresholdDays;
+};
+
+#endif	  // STORAGE_CACHE_SNAPSHOT_H
@@ -0,0 +1,326 @@
+#include "StorageDiff.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "NameHierarchy.h"
+#include "SqliteIndexStorage.h"
+#include "SymbolIdIndex.h"
+#include "utilityString.h"
+
+namespace
+{
+// sqlite orders text by its bytes, shorter texts first if one is the start of the other
+int compareText(const std::string& a, const std::string& b)
+{
+	const int result = std::memcmp(a.data(), b.data(), std::min(a.size(), b.size()));
+	if (result)
+	{
+		return result;
+	}
+	return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+// merges two sorted sequences, compare returns the order of the current elements of both
+void mergeSorted(
+	const std::function<bool(bool old)>& atEnd,
+	const std::function<int()>& compare,
+	const std::function<void(int order)>& onElements)
+{
+	while (!atEnd(true) || !atEnd(false))
+	{
+		int order = 0;
+		if (atEnd(true))
+		{
+			order = 1;
+		}
+		else if (atEnd(false))
+		{
+			order = -1;
+		}
+		else
+		{
+			order = compare();
+		}
+		onElements(order);
+	}
+}
+
+struct EdgeRow
+{
+	uint64_t targetSymbolId;
+	std::string targetSerializedName;
+	int type;
+};
+
+// the edges of the next source node, ordered by the ids of their targets
+std::vector<EdgeRow> readEdgesOfSource(
+	SqliteIndexStorage::RowCursor* rows, std::string* sourceSerializedName)
+{
+	std::vector<EdgeRow> edges;
+	*sourceSerializedName = rows->get<SqliteIndexStorage::ColumnText>(0).str();
+	while (!rows->atEnd() &&
+		   rows->get<SqliteIndexStorage::ColumnText>(0).str() == *sourceSerializedName)
+	{
+		std::string targetSerializedName = rows->get<SqliteIndexStorage::ColumnText>(2).str();
+		const uint64_t targetSymbolId = StorageDiff::getSymbolId(targetSerializedName);
+		edges.push_back({targetSymbolId, std::move(targetSerializedName), rows->get<int>(1)});
+		rows->next();
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const EdgeRow& a, const EdgeRow& b) {
+		return std::tie(a.targetSymbolId, a.targetSerializedName, a.type) <
+			std::tie(b.targetSymbolId, b.targetSerializedName, b.type);
+	});
+	edges.erase(
+		std::unique(
+			edges.begin(),
+			edges.end(),
+			[](const EdgeRow& a, const EdgeRow& b) {
+				return a.type == b.type && a.targetSerializedName == b.targetSerializedName;
+			}),
+		edges.end());
+	return edges;
+}
+
+std::string escapeJson(const std::wstring& text)
+{
+	std::string escaped;
+	for (char c: utility::encodeToUtf8(text))
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			escaped += ' ';
+			continue;
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+std::string getSymbolJson(const std::string& prefix, const std::string& serializedName)
+{
+	char symbolId[17];
+	std::snprintf(
+		symbolId,
+		sizeof(symbolId),
+		"%016llx",
+		static_cast<unsigned long long>(StorageDiff::getSymbolId(serializedName)));
+
+	return "\"" + prefix + "id\":\"" + symbolId + "\",\"" + prefix + "name\":\"" +
+		escapeJson(NameHierarchy::deserializeFromBinary(serializedName).getQualifiedName()) + "\"";
+}
+
+const char* getChangeKindName(StorageDiff::ChangeKind kind)
+{
+	switch (kind)
+	{
+	case StorageDiff::CHANGE_ADDED:
+		return "added";
+	case StorageDiff::CHANGE_REMOVED:
+		return "removed";
+	case StorageDiff::CHANGE_CHANGED:
+		return "changed";
+	}
+	return "";
+}
+}	 // namespace
+
+uint64_t StorageDiff::getSymbolId(const std::string& serializedName)
+{
+	return SymbolIdIndex::getKey(serializedName).hash;
+}
+
+StorageDiff::StorageDiff(const SqliteIndexStorage* oldStorage, const SqliteIndexStorage* newStorage)
+	: m_oldStorage(oldStorage), m_newStorage(newStorage)
+{
+}
+
+void StorageDiff::compareNodes(const std::function<void(const NodeChange&)>& onChange) const
+{
+	// walks the index of the serialized names, so sqlite does not need to sort
+	const std::string query =
+		"SELECT n.serialized_name, n.type, COALESCE(s.definition_kind, 0) FROM node AS n "
+		"LEFT JOIN symbol AS s ON s.id = n.id ORDER BY n.serialized_name;";
+	SqliteIndexStorage::RowCursor oldRows(m_oldStorage, query);
+	SqliteIndexStorage::RowCursor newRows(m_newStorage, query);
+
+	std::string oldName;
+	std::string newName;
+	const auto readName = [](const SqliteIndexStorage::RowCursor& rows, std::string* name) {
+		const SqliteIndexStorage::ColumnText text = rows.get<SqliteIndexStorage::ColumnText>(0);
+		name->assign(text.data, text.size);
+	};
+
+	mergeSorted(
+		[&](bool old) { return old ? oldRows.atEnd() : newRows.atEnd(); },
+		[&]() {
+			readName(oldRows, &oldName);
+			readName(newRows, &newName);
+			return compareText(oldName, newName);
+		},
+		[&](int order) {
+			NodeChange change;
+			if (order <= 0)
+			{
+				readName(oldRows, &change.serializedName);
+				change.oldType = NodeType::intToType(oldRows.get<int>(1));
+				change.oldDefinitionKind = intToDefinitionKind(oldRows.get<int>(2));
+			}
+			if (order >= 0)
+			{
+				readName(newRows, &change.serializedName);
+				change.newType = NodeType::intToType(newRows.get<int>(1));
+				change.newDefinitionKind = intToDefinitionKind(newRows.get<int>(2));
+			}
+
+			if (order < 0)
+			{
+				change.kind = CHANGE_REMOVED;
+				oldRows.next();
+				onChange(change);
+			}
+			else if (order > 0)
+			{
+				change.kind = CHANGE_ADDED;
+				newRows.next();
+				onChange(change);
+			}
+			else
+			{
+				oldRows.next();
+				newRows.next();
+				if (change.oldType != change.newType ||
+					change.oldDefinitionKind != change.newDefinitionKind)
+				{
+					change.kind = CHANGE_CHANGED;
+					onChange(change);
+				}
+			}
+		});
+}
+
+void StorageDiff::compareEdges(const std::function<void(const EdgeChange&)>& onChange) const
+{
+	// the edges are joined to the source nodes in the order of their names, which needs no sorting
+	// either, only the edges of one source node get sorted in memory
+	const std::string query =
+		"SELECT s.serialized_name, e.type, t.serialized_name FROM node AS s "
+		"JOIN edge AS e ON e.source_node_id = s.id JOIN node AS t ON t.id = e.target_node_id "
+		"ORDER BY s.serialized_name;";
+	SqliteIndexStorage::RowCursor oldRows(m_oldStorage, query);
+	SqliteIndexStorage::RowCursor newRows(m_newStorage, query);
+
+	const auto reportEdges = [&onChange](
+								 ChangeKind kind,
+								 const std::string& sourceSerializedName,
+								 const std::vector<EdgeRow>& edges,
+								 size_t index) {
+		EdgeChange change;
+		change.kind = kind;
+		change.type = Edge::intToType(edges[index].type);
+		change.sourceSerializedName = sourceSerializedName;
+		change.targetSerializedName = edges[index].targetSerializedName;
+		onChange(change);
+	};
+
+	mergeSorted(
+		[&](bool old) { return old ? oldRows.atEnd() : newRows.atEnd(); },
+		[&]() {
+			return compareText(
+				oldRows.get<SqliteIndexStorage::ColumnText>(0).str(),
+				newRows.get<SqliteIndexStorage::ColumnText>(0).str());
+		},
+		[&](int order) {
+			std::string oldSourceName;
+			std::string newSourceName;
+			std::vector<EdgeRow> oldEdges;
+			std::vector<EdgeRow> newEdges;
+			if (order <= 0)
+			{
+				oldEdges = readEdgesOfSource(&oldRows, &oldSourceName);
+			}
+			if (order >= 0)
+			{
+				newEdges = readEdgesOfSource(&newRows, &newSourceName);
+			}
+
+			size_t oldIndex = 0;
+			size_t newIndex = 0;
+			while (oldIndex < oldEdges.size() || newIndex < newEdges.size())
+			{
+				if (newIndex == newEdges.size() ||
+					(oldIndex < oldEdges.size() &&
+					 std::tie(
+						 oldEdges[oldIndex].targetSymbolId,
+						 oldEdges[oldIndex].targetSerializedName,
+						 oldEdges[oldIndex].type) <
+						 std::tie(
+							 newEdges[newIndex].targetSymbolId,
+							 newEdges[newIndex].targetSerializedName,
+							 newEdges[newIndex].type)))
+				{
+					reportEdges(CHANGE_REMOVED, oldSourceName, oldEdges, oldIndex++);
+				}
+				else if (
+					oldIndex == oldEdges.size() ||
+					oldEdges[oldIndex].targetSerializedName !=
+						newEdges[newIndex].targetSerializedName ||
+					oldEdges[oldIndex].type != newEdges[newIndex].type)
+				{
+					reportEdges(CHANGE_ADDED, newSourceName, newEdges, newIndex++);
+				}
+				else
+				{
+					oldIndex++;
+					newIndex++;
+				}
+			}
+		});
+}
+
+size_t StorageDiff::write(std::ostream* stream) const
+{
+	size_t changeCount = 0;
+
+	compareNodes([&](const NodeChange& change) {
+		std::string line = "{\"change\":\"" + std::string(getChangeKindName(change.kind)) +
+			"\",\"element\":\"node\"," + getSymbolJson("", change.serializedName);
+		if (change.kind != CHANGE_ADDED)
+		{
+			line += ",\"old_type\":\"" + NodeType(change.oldType).getUnderscoredTypeString() + "\"";
+		}
+		if (change.kind != CHANGE_REMOVED)
+		{
+			line += ",\"new_type\":\"" + NodeType(change.newType).getUnderscoredTypeString() + "\"";
+		}
+		if (change.kind == CHANGE_CHANGED)
+		{
+			line += ",\"old_definition_kind\":" +
+				std::to_string(definitionKindToInt(change.oldDefinitionKind)) +
+				",\"new_definition_kind\":" +
+				std::to_string(definitionKindToInt(change.newDefinitionKind));
+		}
+		(*stream) << line << "}\n";
+		changeCount++;
+	});
+
+	compareEdges([&](const EdgeChange& change) {
+		(*stream) << "{\"change\":\"" << getChangeKindName(change.kind)
+				  << "\",\"element\":\"edge\",\"type\":\""
+				  << utility::encodeToUtf8(Edge::getUnderscoredTypeString(change.type)) << "\","
+				  << getSymbolJson("source_", change.sourceSerializedName) << ","
+				  << getSymbolJson("target_", change.targetSerializedName) << "}\n";
+		changeCount++;
+	});
+
+	stream->flush();
+	return changeCount;
+}
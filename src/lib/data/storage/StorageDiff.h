@@ -0,0 +1,65 @@
+#ifndef STORAGE_DIFF_H
+#define STORAGE_DIFF_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include "DefinitionKind.h"
+#include "Edge.h"
+#include "NodeType.h"
+
+class SqliteIndexStorage;
+
+// Compares the nodes and edges of two index databases by the serialized names of the nodes, as
+// their ids differ between indexing runs. Both databases are read in the order of the serialized
+// names and merged like sorted lists, so only the edges of the current source node are kept in
+// memory, no matter how large the databases are.
+class StorageDiff
+{
+public:
+	enum ChangeKind
+	{
+		CHANGE_ADDED,
+		CHANGE_REMOVED,
+		CHANGE_CHANGED
+	};
+
+	// the types and definition kinds are only set for the databases containing the node
+	struct NodeChange
+	{
+		ChangeKind kind = CHANGE_ADDED;
+		std::string serializedName;
+		NodeType::Type oldType = NodeType::NODE_SYMBOL;
+		NodeType::Type newType = NodeType::NODE_SYMBOL;
+		DefinitionKind oldDefinitionKind = DEFINITION_NONE;
+		DefinitionKind newDefinitionKind = DEFINITION_NONE;
+	};
+
+	// edges are identified by their type and nodes, so they are only added or removed
+	struct EdgeChange
+	{
+		ChangeKind kind = CHANGE_ADDED;
+		Edge::EdgeType type = Edge::EDGE_UNDEFINED;
+		std::string sourceSerializedName;
+		std::string targetSerializedName;
+	};
+
+	// the same for every process and platform, like the keys of the SymbolIdIndex
+	static uint64_t getSymbolId(const std::string& serializedName);
+
+	StorageDiff(const SqliteIndexStorage* oldStorage, const SqliteIndexStorage* newStorage);
+
+	void compareNodes(const std::function<void(const NodeChange&)>& onChange) const;
+	void compareEdges(const std::function<void(const EdgeChange&)>& onChange) const;
+
+	// writes each change as one line of json, returns the number of changes
+	size_t write(std::ostream* stream) const;
+
+private:
+	const SqliteIndexStorage* m_oldStorage;
+	const SqliteIndexStorage* m_newStorage;
+};
+
+#endif	  // STORAGE_DIFF_H
@@ -0,0 +1,158 @@
+#include "StorageGraphWriter.h"
+
+#include "utilityString.h"
+
+bool StorageGraphWriter::getFormatForName(const std::string& name, Format* format)
+{
+	if (name == "dot")
+	{
+		*format = FORMAT_DOT;
+	}
+	else if (name == "graphml")
+	{
+		*format = FORMAT_GRAPHML;
+	}
+	else if (name == "json")
+	{
+		*format = FORMAT_JSON;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+StorageGraphWriter::StorageGraphWriter(Format format, std::ostream* stream)
+	: m_format(format), m_stream(stream)
+{
+}
+
+void StorageGraphWriter::writeHeader()
+{
+	switch (m_format)
+	{
+	case FORMAT_DOT:
+		*m_stream << "digraph sourcetrail {\n";
+		break;
+	case FORMAT_GRAPHML:
+		*m_stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+				  << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+				  << "<key id=\"name\" for=\"node\" attr.name=\"name\" attr.type=\"string\"/>\n"
+				  << "<key id=\"type\" for=\"all\" attr.name=\"type\" attr.type=\"string\"/>\n"
+				  << "<graph edgedefault=\"directed\">\n";
+		break;
+	case FORMAT_JSON:
+		*m_stream << "{\"nodes\":[";
+		break;
+	}
+}
+
+void StorageGraphWriter::writeNode(Id id, NodeType type, const std::wstring& name)
+{
+	const std::string typeString = type.getUnderscoredTypeString();
+	switch (m_format)
+	{
+	case FORMAT_DOT:
+		*m_stream << "\t" << id << " [label=\"" << escape(name) << "\" type=\"" << typeString
+				  << "\"];\n";
+		break;
+	case FORMAT_GRAPHML:
+		*m_stream << "<node id=\"n" << id << "\"><data key=\"name\">" << escape(name)
+				  << "</data><data key=\"type\">" << typeString << "</data></node>\n";
+		break;
+	case FORMAT_JSON:
+		*m_stream << (m_nodeCount ? ",\n" : "\n") << "{\"id\":" << id << ",\"name\":\""
+				  << escape(name) << "\",\"type\":\"" << typeString << "\"}";
+		break;
+	}
+	m_nodeCount++;
+}
+
+void StorageGraphWriter::writeEdge(Id id, Edge::EdgeType type, Id sourceId, Id targetId)
+{
+	const std::string typeString = utility::encodeToUtf8(Edge::getUnderscoredTypeString(type));
+	switch (m_format)
+	{
+	case FORMAT_DOT:
+		*m_stream << "\t" << sourceId << " -> " << targetId << " [type=\"" << typeString
+				  << "\"];\n";
+		break;
+	case FORMAT_GRAPHML:
+		*m_stream << "<edge id=\"e" << id << "\" source=\"n" << sourceId << "\" target=\"n"
+				  << targetId << "\"><data key=\"type\">" << typeString << "</data></edge>\n";
+		break;
+	case FORMAT_JSON:
+		// the first edge closes the list of nodes
+		*m_stream << (m_edgeCount ? ",\n" : "\n],\"edges\":[\n") << "{\"id\":" << id
+				  << ",\"type\":\"" << typeString << "\",\"source\":" << sourceId
+				  << ",\"target\":" << targetId << "}";
+		break;
+	}
+	m_edgeCount++;
+}
+
+void StorageGraphWriter::writeFooter()
+{
+	switch (m_format)
+	{
+	case FORMAT_DOT:
+		*m_stream << "}\n";
+		break;
+	case FORMAT_GRAPHML:
+		*m_stream << "</graph>\n</graphml>\n";
+		break;
+	case FORMAT_JSON:
+		*m_stream << (m_edgeCount ? "\n]}\n" : "\n],\"edges\":[]}\n");
+		break;
+	}
+	m_stream->flush();
+}
+
+size_t StorageGraphWriter::getNodeCount() const
+{
+	return m_nodeCount;
+}
+
+size_t StorageGraphWriter::getEdgeCount() const
+{
+	return m_edgeCount;
+}
+
+std::string StorageGraphWriter::escape(const std::wstring& text) const
+{
+	std::string escaped;
+	for (char c: utility::encodeToUtf8(text))
+	{
+		if (m_format == FORMAT_GRAPHML)
+		{
+			switch (c)
+			{
+			case '<':
+				escaped += "&lt;";
+				continue;
+			case '>':
+				escaped += "&gt;";
+				continue;
+			case '&':
+				escaped += "&amp;";
+				continue;
+			case '"':
+				escaped += "&quot;";
+				continue;
+			}
+		}
+		else if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			// control characters don't occur in names, but would break the quoted strings
+			escaped += ' ';
+			continue;
+		}
+		escaped += c;
+	}
+	return escaped;
+}
@@ -0,0 +1,46 @@
+#ifndef STORAGE_GRAPH_WRITER_H
+#define STORAGE_GRAPH_WRITER_H
+
+#include <ostream>
+#include <string>
+
+#include "Edge.h"
+#include "NodeType.h"
+#include "types.h"
+
+// Writes nodes and edges read from the storage one by one as dot, graphml or json, so graphs of
+// any size are exported without building a Graph. All nodes are written before the first edge.
+class StorageGraphWriter
+{
+public:
+	enum Format
+	{
+		FORMAT_DOT,
+		FORMAT_GRAPHML,
+		FORMAT_JSON
+	};
+
+	// returns false for names other than dot, graphml and json
+	static bool getFormatForName(const std::string& name, Format* format);
+
+	StorageGraphWriter(Format format, std::ostream* stream);
+
+	void writeHeader();
+	void writeNode(Id id, NodeType type, const std::wstring& name);
+	void writeEdge(Id id, Edge::EdgeType type, Id sourceId, Id targetId);
+	void writeFooter();
+
+	size_t getNodeCount() const;
+	size_t getEdgeCount() const;
+
+private:
+	std::string escape(const std::wstring& text) const;
+
+	const Format m_format;
+	std::ostream* const m_stream;
+
+	size_t m_nodeCount = 0;
+	size_t m_edgeCount = 0;
+};
+
+#endif	  // STORAGE_GRAPH_WRITER_H
@@ -1,63 +1,178 @@
 #include "StorageProvider.h"
 
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "FileSystem.h"
+#include "SharedIntermediateStorage.h"
 #include "logging.h"
 
+const int StorageProvider::s_maxStorageCountWithoutBudget = 10;
+
+StorageProvider::StorageProvider(): m_memoryByteSize(0), m_memoryBudget(0), m_spilledFileCount(0) {}
+
+StorageProvider::~StorageProvider()
+{
+	clear();
+
+	if (!m_spillDirectoryPath.empty() && m_spillDirectoryPath.recheckExists())
+	{
+		FileSystem::remove(m_spillDirectoryPath);
+	}
+}
+
+void StorageProvider::setMemoryBudget(size_t byteCount, const FilePath& spillDirectoryPath)
+{
+	std::lock_guard<std::mutex> lock(m_storagesMutex);
+	m_memoryBudget = byteCount;
+	m_spillDirectoryPath = spillDirectoryPath;
+}
+
 int StorageProvider::getStorageCount() const
 {
 	std::lock_guard<std::mutex> lock(m_storagesMutex);
 	return m_storages.size();
 }
 
-void StorageProvider::clear()
+bool StorageProvider::canInsertStorage() const
 {
 	std::lock_guard<std::mutex> lock(m_storagesMutex);
-	return m_storages.clear();
+	if (!m_memoryBudget)
+	{
+		return m_storages.size() <= size_t(s_maxStorageCountWithoutBudget);
+	}
+
+	// only exceeded if the largest storage alone doesn't fit, which waits for injection
+	return m_memoryByteSize <= m_memoryBudget;
+}
+
+void StorageProvider::clear()
+{
+	std::list<std::shared_ptr<StorageEntry>> storages;
+	{
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		storages.swap(m_storages);
+		m_memoryByteSize = 0;
+	}
+
+	for (const std::shared_ptr<StorageEntry>& entry: storages)
+	{
+		if (!entry->storage)
+		{
+			FileSystem::remove(entry->filePath);
+		}
+	}
 }
 
 void StorageProvider::insert(std::shared_ptr<IntermediateStorage> storage)
 {
-	const std::size_t storageSize = storage->getSourceLocationCount();
-	std::list<std::shared_ptr<IntermediateStorage>>::iterator it;
+	std::shared_ptr<StorageEntry> entry = std::make_shared<StorageEntry>();
+	entry->storage = storage;
+	entry->sourceLocationCount = storage->getSourceLocationCount();
+	entry->byteSize = storage->getByteSize(sizeof(std::wstring));
 
-	std::lock_guard<std::mutex> lock(m_storagesMutex);
-	for (it = m_storages.begin(); it != m_storages.end(); it++)
+	bool exceedsBudget = false;
 	{
-		if ((*it)->getSourceLocationCount() < storageSize)
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		std::list<std::shared_ptr<StorageEntry>>::iterator it;
+		for (it = m_storages.begin(); it != m_storages.end(); it++)
 		{
-			break;
+			if ((*it)->sourceLocationCount < entry->sourceLocationCount)
+			{
+				break;
+			}
 		}
+		m_storages.insert(it, entry);
+		m_memoryByteSize += entry->byteSize;
+
+		exceedsBudget = m_memoryBudget && m_memoryByteSize > m_memoryBudget;
+	}
+
+	if (exceedsBudget)
+	{
+		spillEntries();
 	}
-	m_storages.insert(it, storage);
 }
 
 std::shared_ptr<IntermediateStorage> StorageProvider::consumeSecondLargestStorage()
 {
-	std::shared_ptr<IntermediateStorage> ret;
+	std::shared_ptr<StorageEntry> entry;
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
 		if (m_storages.size() > 1)
 		{
-			std::list<std::shared_ptr<IntermediateStorage>>::iterator it = m_storages.begin();
-			it++;
-			ret = *it;
-			m_storages.erase(it);
+			entry = removeEntry(std::next(m_storages.begin()));
 		}
 	}
-	return ret;
+	return loadEntry(entry);
 }
 
 std::shared_ptr<IntermediateStorage> StorageProvider::consumeLargestStorage()
 {
-	std::shared_ptr<IntermediateStorage> ret;
+	std::shared_ptr<StorageEntry> entry;
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
 		if (!m_storages.empty())
 		{
-			ret = m_storages.front();
-			m_storages.pop_front();
+			entry = removeEntry(m_storages.begin());
+		}
+	}
+	return loadEntry(entry);
+}
+
+std::vector<std::shared_ptr<IntermediateStorage>> StorageProvider::consumeAllButLargestStorage(
+	size_t maxSourceLocationCount)
+{
+	std::vector<std::shared_ptr<StorageEntry>> entries;
+	{
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		if (m_storages.size() > 1)
+		{
+			// the consumed storages stay in memory until they are merged and inserted again
+			size_t consumedByteSize = m_memoryByteSize;
+			size_t consumedSourceLocationCount = 0;
+			std::vector<std::list<std::shared_ptr<StorageEntry>>::iterator> consumedIts;
+			for (auto it = std::next(m_storages.begin()); it != m_storages.end(); it++)
+			{
+				if (maxSourceLocationCount &&
+					consumedSourceLocationCount + (*it)->sourceLocationCount > maxSourceLocationCount)
+				{
+					continue;
+				}
+
+				if ((*it)->storage || !m_memoryBudget ||
+					consumedByteSize + (*it)->byteSize <= m_memoryBudget)
+				{
+					if (!(*it)->storage)
+					{
+						consumedByteSize += (*it)->byteSize;
+					}
+					consumedSourceLocationCount += (*it)->sourceLocationCount;
+					consumedIts.push_back(it);
+				}
+			}
+
+			// a single storage would only be inserted again, which reads it from its file
+			if (consumedIts.size() > 1)
+			{
+				for (auto it: consumedIts)
+				{
+					entries.push_back(removeEntry(it));
+				}
+			}
 		}
 	}
 
+	std::vector<std::shared_ptr<IntermediateStorage>> ret;
+	for (const std::shared_ptr<StorageEntry>& entry: entries)
+	{
+		if (std::shared_ptr<IntermediateStorage> storage = loadEntry(entry))
+		{
+			ret.push_back(storage);
+		}
+	}
 	return ret;
 }
 
@@ -66,10 +181,134 @@ void StorageProvider::logCurrentState() const
 	std::string logString = "Storages waiting for injection:";
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
-		for (const std::shared_ptr<IntermediateStorage>& storage: m_storages)
+		for (const std::shared_ptr<StorageEntry>& entry: m_storages)
 		{
-			logString += " " + std::to_string(storage->getSourceLocationCount()) + ";";
+			logString += " " + std::to_string(entry->sourceLocationCount) +
+				(entry->storage ? ";" : " (file);");
 		}
+		logString += " " + std::to_string(m_memoryByteSize / 1024 / 1024) + " MB in memory";
 	}
 	LOG_INFO(logString);
 }
+
+std::shared_ptr<StorageProvider::StorageEntry> StorageProvider::removeEntry(
+	std::list<std::shared_ptr<StorageEntry>>::iterator it)
+{
+	std::shared_ptr<StorageEntry> entry = *it;
+	m_storages.erase(it);
+	if (entry->storage)
+	{
+		m_memoryByteSize -= entry->byteSize;
+	}
+	return entry;
+}
+
+std::shared_ptr<IntermediateStorage> StorageProvider::loadEntry(
+	const std::shared_ptr<StorageEntry>& entry) const
+{
+	if (!entry)
+	{
+		return nullptr;
+	}
+
+	// a storage that is still being spilled is used right away, the file gets removed after writing
+	if (entry->storage)
+	{
+		return entry->storage;
+	}
+
+	std::shared_ptr<IntermediateStorage> storage;
+	{
+		std::ifstream fileStream(entry->filePath.str(), std::ios::in | std::ios::binary);
+		std::stringstream data;
+		data << fileStream.rdbuf();
+		storage = SharedIntermediateStorage::deserialize(data.str());
+	}
+	FileSystem::remove(entry->filePath);
+
+	if (!storage)
+	{
+		LOG_ERROR(
+			L"Intermediate storage in file \"" + entry->filePath.wstr() +
+			L"\" is malformed and was skipped.");
+	}
+	return storage;
+}
+
+void StorageProvider::spillEntries()
+{
+	while (true)
+	{
+		std::shared_ptr<StorageEntry> entry;
+		std::shared_ptr<IntermediateStorage> storage;
+		FilePath filePath;
+		{
+			std::lock_guard<std::mutex> lock(m_storagesMutex);
+			if (m_memoryByteSize <= m_memoryBudget)
+			{
+				return;
+			}
+
+			// the largest storage is injected next, so smaller ones are moved out first
+			for (auto it = m_storages.rbegin(); it != std::prev(m_storages.rend()); it++)
+			{
+				if ((*it)->storage && !(*it)->spilling)
+				{
+					entry = *it;
+					break;
+				}
+			}
+
+			if (!entry)
+			{
+				return;
+			}
+
+			entry->spilling = true;
+			storage = entry->storage;
+			filePath = m_spillDirectoryPath.getConcatenated(
+				L"storage_" + std::to_wstring(++m_spilledFileCount) + L".bin");
+		}
+
+		if (!m_spillDirectoryPath.recheckExists())
+		{
+			FileSystem::createDirectory(m_spillDirectoryPath);
+		}
+
+		bool written = false;
+		{
+			const std::string data = SharedIntermediateStorage::serialize(*storage);
+			std::ofstream fileStream(
+				filePath.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			fileStream.write(data.data(), data.size());
+			fileStream.close();
+			written = bool(fileStream);
+		}
+
+		if (!written)
+		{
+			LOG_ERROR(
+				L"Unable to write intermediate storage to \"" + filePath.wstr() +
+				L"\", keeping storages in memory.");
+			FileSystem::remove(filePath);
+			return;
+		}
+
+		bool consumed = false;
+		{
+			std::lock_guard<std::mutex> lock(m_storagesMutex);
+			consumed = std::find(m_storages.begin(), m_storages.end(), entry) == m_storages.end();
+			if (!consumed)
+			{
+				entry->storage.reset();
+				entry->filePath = filePath;
+				m_memoryByteSize -= entry->byteSize;
+			}
+		}
+
+		if (consumed)
+		{
+			FileSystem::remove(filePath);
+		}
+	}
+}
@@ -1,16 +1,28 @@
 #ifndef STORAGE_PROVIDER_H
 #define STORAGE_PROVIDER_H
 
+#include "FilePath.h"
 #include "IntermediateStorage.h"
 #include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 class StorageProvider
 {
 public:
+	StorageProvider();
+	~StorageProvider();
+
+	// storages exceeding the budget are kept in files within the directory until they get consumed,
+	// a budget of 0 keeps all storages in memory
+	void setMemoryBudget(size_t byteCount, const FilePath& spillDirectoryPath);
+
 	int getStorageCount() const;
 
+	// false while the storages kept in memory exceed the limits, producers should wait then
+	bool canInsertStorage() const;
+
 	void clear();
 
 	void insert(std::shared_ptr<IntermediateStorage> storage);
@@ -21,10 +33,38 @@ public:
 	// returns empty shared_ptr if no storages available
 	std::shared_ptr<IntermediateStorage> consumeLargestStorage();
 
+	// returns all storages except for the largest one, larger storages first. Storages kept in
+	// files are only included as far as they fit into the memory budget. A maximum source location
+	// count other than 0 limits the sum of the returned storages, nothing is returned if less than
+	// two storages fit.
+	std::vector<std::shared_ptr<IntermediateStorage>> consumeAllButLargestStorage(
+		size_t maxSourceLocationCount = 0);
+
 	void logCurrentState() const;
 
 private:
-	std::list<std::shared_ptr<IntermediateStorage>> m_storages;	   // larger storages are in front
+	struct StorageEntry
+	{
+		std::shared_ptr<IntermediateStorage> storage;	 // empty while kept in the file
+		FilePath filePath;
+		size_t sourceLocationCount = 0;
+		size_t byteSize = 0;
+		bool spilling = false;
+	};
+
+	static const int s_maxStorageCountWithoutBudget;
+
+	// the caller needs to hold the lock
+	std::shared_ptr<StorageEntry> removeEntry(std::list<std::shared_ptr<StorageEntry>>::iterator it);
+
+	std::shared_ptr<IntermediateStorage> loadEntry(const std::shared_ptr<StorageEntry>& entry) const;
+	void spillEntries();
+
+	std::list<std::shared_ptr<StorageEntry>> m_storages;	// larger storages are in front
+	size_t m_memoryByteSize;
+	size_t m_memoryBudget;
+	FilePath m_spillDirectoryPath;
+	size_t m_spilledFileCount;
 	mutable std::mutex m_storagesMutex;
 };
 
@@ -0,0 +1,111 @@
+#include "StorageQueryExecutor.h"
+
+#include <algorithm>
+
+#include "PersistentStorage.h"
+#include "logging.h"
+
+StorageQueryExecutor::StorageQueryExecutor(const FilePath& indexDbFilePath, size_t workerCount)
+	: m_indexDbFilePath(indexDbFilePath), m_workerCount(std::max<size_t>(1, workerCount))
+{
+}
+
+StorageQueryExecutor::~StorageQueryExecutor()
+{
+	stop();
+}
+
+bool StorageQueryExecutor::start()
+{
+	if (!m_indexDbFilePath.exists())
+	{
+		LOG_ERROR(L"Query server found no index database: " + m_indexDbFilePath.wstr());
+		return false;
+	}
+
+	{
+		PersistentStorage storage(m_indexDbFilePath, FilePath());
+		if (storage.isEmpty() || storage.isIncompatible())
+		{
+			LOG_ERROR(L"Query server cannot read the index database: " + m_indexDbFilePath.wstr());
+			return false;
+		}
+	}
+
+	m_stopped = false;
+	for (size_t i = 0; i < m_workerCount; i++)
+	{
+		m_workers.emplace_back(&StorageQueryExecutor::runWorker, this);
+	}
+
+	LOG_INFO(
+		"Query server started " + std::to_string(m_workerCount) + " workers on " +
+		m_indexDbFilePath.str());
+	return true;
+}
+
+void StorageQueryExecutor::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		m_stopped = true;
+	}
+	m_queriesCondition.notify_all();
+
+	for (std::thread& worker: m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+}
+
+void StorageQueryExecutor::execute(
+	const std::string& type,
+	const std::map<std::string, std::string>& parameters,
+	ResponseCallback callback)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		m_queries.push_back({type, parameters, callback});
+	}
+	m_queriesCondition.notify_one();
+}
+
+void StorageQueryExecutor::runWorker()
+{
+	PersistentStorage storage(m_indexDbFilePath, FilePath());
+	storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+	storage.buildCaches();
+
+	const StorageQueryService service(&storage);
+
+	while (true)
+	{
+		Query query;
+		{
+			std::unique_lock<std::mutex> lock(m_queriesMutex);
+			m_queriesCondition.wait(lock, [this]() { return m_stopped || !m_queries.empty(); });
+			if (m_stopped)
+			{
+				return;
+			}
+
+			query = std::move(m_queries.front());
+			m_queries.pop_front();
+		}
+
+		StorageQueryService::Response response;
+		try
+		{
+			response = service.answer(query.type, query.parameters);
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_STREAM(<< "Query server failed to answer " << query.type << ": " << e.what());
+			response.status = 500;
+			response.body = "{\"error\":\"Internal error\"}";
+		}
+
+		query.callback(response);
+	}
+}
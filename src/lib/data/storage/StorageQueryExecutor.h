@@ -0,0 +1,59 @@
+#ifndef STORAGE_QUERY_EXECUTOR_H
+#define STORAGE_QUERY_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FilePath.h"
+#include "StorageQueryService.h"
+
+// Runs the queries of the query server on worker threads. Each worker opens its own read only
+// connection to the index database and builds its own caches, so the queries of different clients
+// run in parallel instead of waiting for one storage.
+class StorageQueryExecutor
+{
+public:
+	typedef std::function<void(const StorageQueryService::Response&)> ResponseCallback;
+
+	StorageQueryExecutor(const FilePath& indexDbFilePath, size_t workerCount);
+	~StorageQueryExecutor();
+
+	// returns false if the index database cannot be browsed, queries are answered once the caches
+	// of a worker are built
+	bool start();
+	void stop();
+
+	// the callback is called on the worker thread that answered the query
+	void execute(
+		const std::string& type,
+		const std::map<std::string, std::string>& parameters,
+		ResponseCallback callback);
+
+private:
+	struct Query
+	{
+		std::string type;
+		std::map<std::string, std::string> parameters;
+		ResponseCallback callback;
+	};
+
+	void runWorker();
+
+	const FilePath m_indexDbFilePath;
+	const size_t m_workerCount;
+
+	std::deque<Query> m_queries;
+	bool m_stopped = false;
+	std::mutex m_queriesMutex;
+	std::condition_variable m_queriesCondition;
+
+	std::vector<std::thread> m_workers;
+};
+
+#endif	  // STORAGE_QUERY_EXECUTOR_H
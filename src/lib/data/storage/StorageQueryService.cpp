@@ -0,0 +1,390 @@
+#include "StorageQueryService.h"
+
+#include <set>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Edge.h"
+#include "Graph.h"
+#include "NodeTypeSet.h"
+#include "SearchMatch.h"
+#include "SourceLocation.h"
+#include "SourceLocationCollection.h"
+#include "SourceLocationFile.h"
+#include "StorageAccess.h"
+#include "utilityString.h"
+
+namespace
+{
+StorageQueryService::Response createResponse(const QJsonObject& object, int status = 200)
+{
+	StorageQueryService::Response response;
+	response.status = status;
+	response.body = QJsonDocument(object).toJson(QJsonDocument::Compact).toStdString();
+	return response;
+}
+
+StorageQueryService::Response createErrorResponse(int status, const std::string& error)
+{
+	QJsonObject object;
+	object["error"] = QString::fromStdString(error);
+	return createResponse(object, status);
+}
+
+std::string getParameter(
+	const std::map<std::string, std::string>& parameters,
+	const std::string& name,
+	const std::string& defaultValue = "")
+{
+	auto it = parameters.find(name);
+	return it != parameters.end() ? it->second : defaultValue;
+}
+
+size_t getNumberParameter(
+	const std::map<std::string, std::string>& parameters, const std::string& name, size_t defaultValue)
+{
+	try
+	{
+		return std::stoul(getParameter(parameters, name, std::to_string(defaultValue)));
+	}
+	catch (std::exception&)
+	{
+		return defaultValue;
+	}
+}
+
+QJsonObject toJson(const SourceLocation* startLocation)
+{
+	const SourceLocation* endLocation = startLocation->getEndLocation();
+
+	QJsonObject object;
+	object["file"] = QString::fromStdWString(startLocation->getFilePath().wstr());
+	object["start_line"] = int(startLocation->getLineNumber());
+	object["start_column"] = int(startLocation->getColumnNumber());
+	object["end_line"] = int(endLocation ? endLocation->getLineNumber() : startLocation->getLineNumber());
+	object["end_column"] = int(
+		endLocation ? endLocation->getColumnNumber() : startLocation->getColumnNumber());
+	return object;
+}
+
+QJsonObject toJson(const Node* node)
+{
+	QJsonObject object;
+	object["id"] = double(node->getId());
+	object["name"] = QString::fromStdWString(node->getFullName());
+	object["type"] = QString::fromStdString(node->getType().getReadableTypeString());
+	return object;
+}
+
+// the definitions, the number of references and the direct callers or users of a symbol
+QJsonObject toSymbolJson(const StorageAccess* storageAccess, Id nodeId)
+{
+	QJsonArray definitions;
+	int referenceCount = 0;
+	storageAccess->getSourceLocationsForTokenIds({nodeId})->forEachSourceLocationFile(
+		[&](std::shared_ptr<SourceLocationFile> file) {
+			file->forEachStartSourceLocation([&](SourceLocation* location) {
+				if (!location->getTokenIds().contains(nodeId))
+				{
+					return;
+				}
+				if (location->getType() == LOCATION_SCOPE)
+				{
+					definitions.append(toJson(location));
+				}
+				else if (location->getType() == LOCATION_TOKEN)
+				{
+					referenceCount++;
+				}
+			});
+		});
+
+	const NodeType nodeType = storageAccess->getNodeTypeForNodeWithId(nodeId);
+	const Edge::TypeMask edgeTypes = nodeType.isCallable()
+		? Edge::EDGE_CALL
+		: Edge::EDGE_USAGE | Edge::EDGE_TYPE_USAGE;
+
+	QJsonArray callers;
+	std::set<Id> callerIds;
+	std::shared_ptr<Graph> graph =
+		storageAccess->getGraphForTrail(0, nodeId, 0, edgeTypes, false, 1, true);
+	graph->forEachEdge([&](Edge* edge) {
+		if (edge->getTo()->getId() == nodeId && edge->getFrom()->getId() != nodeId &&
+			callerIds.insert(edge->getFrom()->getId()).second)
+		{
+			callers.append(toJson(edge->getFrom()));
+		}
+	});
+
+	QJsonObject object;
+	object["id"] = double(nodeId);
+	object["name"] = QString::fromStdWString(
+		storageAccess->getNameHierarchyForNodeId(nodeId).getQualifiedName());
+	object["type"] = QString::fromStdString(nodeType.getReadableTypeString());
+	object["definitions"] = definitions;
+	object["reference_count"] = referenceCount;
+	object["callers"] = callers;
+	return object;
+}
+}	 // namespace
+
+StorageQueryService::StorageQueryService(const StorageAccess* storageAccess)
+	: m_storageAccess(storageAccess)
+{
+}
+
+StorageQueryService::Response StorageQueryService::answer(
+	const std::string& type, const std::map<std::string, std::string>& parameters) const
+{
+	if (type == "autocomplete")
+	{
+		return answerAutocomplete(parameters);
+	}
+	else if (type == "definition")
+	{
+		return answerLocations(parameters, true);
+	}
+	else if (type == "references")
+	{
+		return answerLocations(parameters, false);
+	}
+	else if (type == "trail")
+	{
+		return answerTrail(parameters);
+	}
+	else if (type == "symbol")
+	{
+		return answerSymbol(parameters);
+	}
+	else if (type == "symbols")
+	{
+		return answerSymbols(parameters);
+	}
+
+	return createErrorResponse(404, "Unknown query \"" + type + "\"");
+}
+
+StorageQueryService::Response StorageQueryService::answerAutocomplete(
+	const std::map<std::string, std::string>& parameters) const
+{
+	const std::wstring query = utility::decodeFromUtf8(getParameter(parameters, "query"));
+	if (query.empty())
+	{
+		return createErrorResponse(400, "Missing parameter \"query\"");
+	}
+
+	const size_t limit = getNumberParameter(parameters, "limit", 20);
+
+	QJsonArray matches;
+	for (const SearchMatch& match: m_storageAccess->getAutocompletionMatches(
+			 query, NodeTypeSet::all(), false, []() { return false; }))
+	{
+		if (size_t(matches.size()) >= limit)
+		{
+			break;
+		}
+
+		QJsonArray ids;
+		for (Id tokenId: match.tokenIds)
+		{
+			ids.append(double(tokenId));
+		}
+
+		QJsonObject object;
+		object["name"] = QString::fromStdWString(match.getFullName());
+		object["type"] = QString::fromStdString(match.nodeType.getReadableTypeString());
+		object["ids"] = ids;
+		matches.append(object);
+	}
+
+	QJsonObject object;
+	object["matches"] = matches;
+	return createResponse(object);
+}
+
+StorageQueryService::Response StorageQueryService::answerLocations(
+	const std::map<std::string, std::string>& parameters, bool definitions) const
+{
+	const Id nodeId = getNodeId(parameters);
+	if (!nodeId)
+	{
+		return createErrorResponse(404, "No symbol found for the parameter \"id\" or \"name\"");
+	}
+
+	// the scope of a symbol spans its definition, each of its tokens is a reference
+	const LocationType locationType = definitions ? LOCATION_SCOPE : LOCATION_TOKEN;
+
+	QJsonArray locations;
+	m_storageAccess->getSourceLocationsForTokenIds({nodeId})->forEachSourceLocationFile(
+		[&](std::shared_ptr<SourceLocationFile> file) {
+			file->forEachStartSourceLocation([&](SourceLocation* location) {
+				if (location->getType() == locationType && location->getTokenIds().contains(nodeId))
+				{
+					locations.append(toJson(location));
+				}
+			});
+		});
+
+	QJsonObject object;
+	object["id"] = double(nodeId);
+	object["name"] = QString::fromStdWString(
+		m_storageAccess->getNameHierarchyForNodeId(nodeId).getQualifiedName());
+	object[definitions ? "definitions" : "references"] = locations;
+	return createResponse(object);
+}
+
+StorageQueryService::Response StorageQueryService::answerTrail(
+	const std::map<std::string, std::string>& parameters) const
+{
+	const Id nodeId = getNodeId(parameters);
+	if (!nodeId)
+	{
+		return createErrorResponse(404, "No symbol found for the parameter \"id\" or \"name\"");
+	}
+
+	const std::string direction = getParameter(parameters, "direction", "callees");
+	if (direction != "callees" && direction != "callers")
+	{
+		return createErrorResponse(400, "The parameter \"direction\" is neither callees nor callers");
+	}
+
+	// the same edges the graph view follows for a trail of the active symbol
+	const NodeType nodeType = m_storageAccess->getNodeTypeForNodeWithId(nodeId);
+	Edge::TypeMask edgeTypes = 0;
+	if (nodeType.isInheritable())
+	{
+		edgeTypes = Edge::EDGE_INHERITANCE | Edge::EDGE_TEMPLATE_SPECIALIZATION;
+	}
+	else if (nodeType.isCallable())
+	{
+		edgeTypes = Edge::EDGE_CALL | Edge::EDGE_OVERRIDE;
+	}
+	else if (nodeType.isFile())
+	{
+		edgeTypes = Edge::EDGE_INCLUDE;
+	}
+	else
+	{
+		return createErrorResponse(400, "There is no trail for symbols of this type");
+	}
+
+	const bool forward = direction == "callees";
+	std::shared_ptr<Graph> graph = m_storageAccess->getGraphForTrail(
+		forward ? nodeId : 0,
+		forward ? 0 : nodeId,
+		0,
+		edgeTypes,
+		false,
+		getNumberParameter(parameters, "depth", 1),
+		true);
+
+	QJsonArray nodes;
+	graph->forEachNode([&](Node* node) { nodes.append(toJson(node)); });
+
+	QJsonArray edges;
+	graph->forEachEdge([&](Edge* edge) {
+		QJsonObject object;
+		object["id"] = double(edge->getId());
+		object["type"] = QString::fromStdWString(Edge::getReadableTypeString(edge->getType()));
+		object["source"] = double(edge->getFrom()->getId());
+		object["target"] = double(edge->getTo()->getId());
+		edges.append(object);
+	});
+
+	QJsonObject object;
+	object["id"] = double(nodeId);
+	object["nodes"] = nodes;
+	object["edges"] = edges;
+	return createResponse(object);
+}
+
+StorageQueryService::Response StorageQueryService::answerSymbol(
+	const std::map<std::string, std::string>& parameters) const
+{
+	const Id nodeId = getNodeId(parameters);
+	if (!nodeId)
+	{
+		return createErrorResponse(404, "No symbol found for the parameter \"id\" or \"name\"");
+	}
+
+	return createResponse(toSymbolJson(m_storageAccess, nodeId));
+}
+
+StorageQueryService::Response StorageQueryService::answerSymbols(
+	const std::map<std::string, std::string>& parameters) const
+{
+	const std::vector<std::wstring> names = utility::splitToVector(
+		utility::decodeFromUtf8(getParameter(parameters, "names")), L"\n");
+
+	QJsonArray symbols;
+	for (const std::wstring& name: names)
+	{
+		if (name.empty())
+		{
+			continue;
+		}
+
+		// symbols that are not found keep their place, so answers line up with the names
+		const Id nodeId = getNodeIdForName(name);
+		QJsonObject object;
+		if (nodeId)
+		{
+			object = toSymbolJson(m_storageAccess, nodeId);
+		}
+		else
+		{
+			object["error"] = QString::fromStdString("No symbol found");
+		}
+		object["query"] = QString::fromStdWString(name);
+		symbols.append(object);
+	}
+
+	if (symbols.isEmpty())
+	{
+		return createErrorResponse(400, "Missing parameter \"names\"");
+	}
+
+	QJsonObject object;
+	object["symbols"] = symbols;
+	return createResponse(object);
+}
+
+Id StorageQueryService::getNodeId(const std::map<std::string, std::string>& parameters) const
+{
+	const std::string id = getParameter(parameters, "id");
+	if (!id.empty())
+	{
+		try
+		{
+			const Id nodeId = std::stoull(id);
+			return m_storageAccess->getNameHierarchyForNodeId(nodeId).size() ? nodeId : 0;
+		}
+		catch (std::exception&)
+		{
+			return 0;
+		}
+	}
+
+	return getNodeIdForName(utility::decodeFromUtf8(getParameter(parameters, "name")));
+}
+
+Id StorageQueryService::getNodeIdForName(const std::wstring& name) const
+{
+	if (name.empty())
+	{
+		return 0;
+	}
+
+	// qualified names are resolved the way the search box of the GUI resolves them
+	for (const SearchMatch& match: m_storageAccess->getAutocompletionMatches(
+			 name, NodeTypeSet::all(), false, []() { return false; }))
+	{
+		if (match.getFullName() == name && !match.tokenIds.empty())
+		{
+			return match.tokenIds.front();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef STORAGE_QUERY_SERVICE_H
+#define STORAGE_QUERY_SERVICE_H
+
+#include <map>
+#include <string>
+
+#include "types.h"
+
+class StorageAccess;
+
+// Answers the code navigation queries of the query server with the same storage calls the
+// controllers of the GUI use. Answers are json objects, failed queries carry an "error" message.
+//
+//   autocomplete?query=<text>[&limit=<count>]
+//   definition?id=<node id> or definition?name=<qualified name>
+//   references?id=<node id> or references?name=<qualified name>
+//   trail?id=<node id>[&direction=callees|callers][&depth=<depth, 0 for all>]
+//   symbol?id=<node id> or symbol?name=<qualified name>
+//   symbols?names=<qualified names separated by newlines>
+//
+// A symbol is answered with its definitions, its reference count and its direct callers, which are
+// the users of the symbol if it is not callable.
+class StorageQueryService
+{
+public:
+	struct Response
+	{
+		int status = 200;
+		std::string body;
+	};
+
+	StorageQueryService(const StorageAccess* storageAccess);
+
+	// type is the path of the request without the leading slash
+	Response answer(
+		const std::string& type, const std::map<std::string, std::string>& parameters) const;
+
+private:
+	Response answerAutocomplete(const std::map<std::string, std::string>& parameters) const;
+	Response answerLocations(
+		const std::map<std::string, std::string>& parameters, bool definitions) const;
+	Response answerTrail(const std::map<std::string, std::string>& parameters) const;
+	Response answerSymbol(const std::map<std::string, std::string>& parameters) const;
+	Response answerSymbols(const std::map<std::string, std::string>& parameters) const;
+
+	// resolves the id or the qualified name parameter, returns 0 if neither matches a node
+	Id getNodeId(const std::map<std::string, std::string>& parameters) const;
+	Id getNodeIdForName(const std::wstring& name) const;
+
+	const StorageAccess* m_storageAccess;
+};
+
+#endif	  // STORAGE_QUERY_SERVICE_H
@@ -0,0 +1,63 @@
+#include "SymbolIdIndex.h"
+
+#include "utilityBinary.h"
+
+SymbolIdIndex::Key SymbolIdIndex::getKey(const char* serializedName, size_t size)
+{
+	// the check hash uses another offset basis, so both only collide for very few names
+	return {
+		utility::getStableHash(serializedName, size),
+		utility::getStableHash(serializedName, size, 0x9E3779B97F4A7C15ull)};
+}
+
+SymbolIdIndex::Key SymbolIdIndex::getKey(const std::string& serializedName)
+{
+	return getKey(serializedName.data(), serializedName.size());
+}
+
+SymbolIdIndex::Entry* SymbolIdIndex::find(const Key& key)
+{
+	auto it = m_entries.find(key.hash);
+	if (it == m_entries.end())
+	{
+		return nullptr;
+	}
+
+	if (it->second.check == key.check)
+	{
+		return &it->second.entry;
+	}
+
+	auto collisionIt = m_collisions.find(key);
+	return collisionIt != m_collisions.end() ? &collisionIt->second : nullptr;
+}
+
+void SymbolIdIndex::add(const Key& key, Id id, int type)
+{
+	auto it = m_entries.emplace(key.hash, HashedEntry {key.check, {id, type}}).first;
+	if (it->second.check != key.check)
+	{
+		m_collisions.emplace(key, Entry {id, type});
+	}
+}
+
+bool SymbolIdIndex::empty() const
+{
+	return m_entries.empty();
+}
+
+size_t SymbolIdIndex::size() const
+{
+	return m_entries.size() + m_collisions.size();
+}
+
+size_t SymbolIdIndex::getCollisionCount() const
+{
+	return m_collisions.size();
+}
+
+void SymbolIdIndex::clear()
+{
+	m_entries.clear();
+	m_collisions.clear();
+}
@@ -0,0 +1,61 @@
+#ifndef SYMBOL_ID_INDEX_H
+#define SYMBOL_ID_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "types.h"
+
+// Finds the ids and types of nodes by a stable 64 bit hash of their serialized names, so the names
+// themselves don't need to be kept. Each entry also keeps a second hash of the name, names whose
+// first hash collides with the one of another name are kept by both hashes instead.
+class SymbolIdIndex
+{
+public:
+	struct Key
+	{
+		bool operator<(const Key& other) const
+		{
+			return std::make_pair(hash, check) < std::make_pair(other.hash, other.check);
+		}
+
+		uint64_t hash;
+		uint64_t check;
+	};
+
+	struct Entry
+	{
+		Id id;
+		int type;
+	};
+
+	// the same for every process and platform
+	static Key getKey(const char* serializedName, size_t size);
+	static Key getKey(const std::string& serializedName);
+
+	// returns nullptr if no node with the name was added
+	Entry* find(const Key& key);
+
+	// keeps the entry of a key that was added before
+	void add(const Key& key, Id id, int type);
+
+	bool empty() const;
+	size_t size() const;
+	size_t getCollisionCount() const;
+	void clear();
+
+private:
+	struct HashedEntry
+	{
+		uint64_t check;
+		Entry entry;
+	};
+
+	std::unordered_map<uint64_t, HashedEntry> m_entries;
+	std::map<Key, Entry> m_collisions;
+};
+
+#endif	  // SYMBOL_ID_INDEX_H
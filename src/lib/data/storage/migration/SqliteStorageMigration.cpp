@@ -7,3 +7,16 @@ bool SqliteStorageMigration::executeStatementInStorage(
 {
 	return storage->executeStatement(statement);
 }
+
+void SqliteStorageMigration::setupTablesInStorage(SqliteStorage* storage) const
+{
+	storage->setupTables();
+}
+
+std::string SqliteStorageMigration::getIndexStatementInStorage(
+	SqliteStorage* storage, const std::string& indexName) const
+{
+	CppSQLite3Query q = storage->executeQuery(
+		"SELECT sql FROM sqlite_master WHERE type='index' AND name='" + indexName + "';");
+	return q.eof() ? "" : q.getStringField(0, "");
+}
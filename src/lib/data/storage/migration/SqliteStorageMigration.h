@@ -13,6 +13,13 @@ public:
 	virtual ~SqliteStorageMigration();
 
 	bool executeStatementInStorage(SqliteStorage* storage, const std::string& statement) const;
+
+protected:
+	// creates the missing tables of the current layout
+	void setupTablesInStorage(SqliteStorage* storage) const;
+	// the statement that created the index, empty if it does not exist
+	std::string getIndexStatementInStorage(
+		SqliteStorage* storage, const std::string& indexName) const;
 };
 
 #endif	  // SQLITE_STORAGE_MIGRATION_H
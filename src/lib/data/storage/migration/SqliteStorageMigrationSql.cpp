@@ -0,0 +1,99 @@
+#include "SqliteStorageMigrationSql.h"
+
+#include "MessageStatus.h"
+#include "TimeStamp.h"
+#include "logging.h"
+#include "utilityString.h"
+
+SqliteStorageMigrationSql::SqliteStorageMigrationSql(const std::wstring& description)
+	: m_description(description)
+{
+}
+
+SqliteStorageMigrationSql& SqliteStorageMigrationSql::addStatement(const std::string& statement)
+{
+	m_steps.push_back({statement, {}, false});
+	return *this;
+}
+
+SqliteStorageMigrationSql& SqliteStorageMigrationSql::addBulkStatement(
+	const std::string& statement, const std::vector<std::string>& rebuiltIndexNames)
+{
+	m_steps.push_back({statement, rebuiltIndexNames, false});
+	return *this;
+}
+
+SqliteStorageMigrationSql& SqliteStorageMigrationSql::addTableSetup()
+{
+	m_steps.push_back({"", {}, true});
+	return *this;
+}
+
+void SqliteStorageMigrationSql::apply(SqliteStorage* migratable) const
+{
+	const TimeStamp start = TimeStamp::now();
+
+	migratable->beginTransaction();
+	for (size_t i = 0; i < m_steps.size(); i++)
+	{
+		MessageStatus(
+			L"Migrating index database: " + m_description + L" (step " + std::to_wstring(i + 1) +
+				L" of " + std::to_wstring(m_steps.size()) + L")",
+			false,
+			true)
+			.dispatch();
+
+		if (!applyStep(migratable, m_steps[i]))
+		{
+			migratable->rollbackTransaction();
+			LOG_ERROR(L"Migration failed: " + m_description);
+			MessageStatus(L"Migrating index database failed: " + m_description, true, false)
+				.dispatch();
+			return;
+		}
+	}
+	migratable->commitTransaction();
+
+	LOG_INFO(
+		L"Migrated index database: " + m_description + L" in " +
+		utility::decodeFromUtf8(TimeStamp::secondsToString(TimeStamp::durationSeconds(start))));
+	MessageStatus(L"Migrated index database: " + m_description, false, false).dispatch();
+}
+
+bool SqliteStorageMigrationSql::applyStep(SqliteStorage* storage, const Step& step) const
+{
+	if (step.setupTables)
+	{
+		setupTablesInStorage(storage);
+		return true;
+	}
+
+	std::vector<std::string> indexStatements;
+	for (const std::string& indexName: step.rebuiltIndexNames)
+	{
+		const std::string indexStatement = getIndexStatementInStorage(storage, indexName);
+		if (!indexStatement.empty())
+		{
+			indexStatements.push_back(indexStatement + ";");
+			if (!executeStatementInStorage(storage, "DROP INDEX " + indexName + ";"))
+			{
+				return false;
+			}
+		}
+	}
+
+	if (!executeStatementInStorage(storage, step.statement))
+	{
+		return false;
+	}
+
+	// one pass over the written rows is cheaper than updating the index for each of them
+	for (const std::string& indexStatement: indexStatements)
+	{
+		if (!executeStatementInStorage(storage, indexStatement))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,42 @@
+#ifndef SQLITE_STORAGE_MIGRATION_SQL_H
+#define SQLITE_STORAGE_MIGRATION_SQL_H
+
+#include <string>
+#include <vector>
+
+#include "SqliteStorageMigration.h"
+
+// Migrates with set based statements like INSERT ... SELECT into the tables of the new layout,
+// so the time it takes is bound by reading and writing the rows. All steps run in one
+// transaction that is rolled back if one fails, and each step is shown as status.
+class SqliteStorageMigrationSql: public SqliteStorageMigration
+{
+public:
+	SqliteStorageMigrationSql(const std::wstring& description);
+
+	SqliteStorageMigrationSql& addStatement(const std::string& statement);
+
+	// the indices are dropped while the statement writes the rows and are created again after
+	SqliteStorageMigrationSql& addBulkStatement(
+		const std::string& statement, const std::vector<std::string>& rebuiltIndexNames);
+
+	// creates the tables of the current layout, e.g. after the old ones got renamed
+	SqliteStorageMigrationSql& addTableSetup();
+
+	void apply(SqliteStorage* migratable) const override;
+
+private:
+	struct Step
+	{
+		std::string statement;
+		std::vector<std::string> rebuiltIndexNames;
+		bool setupTables;
+	};
+
+	bool applyStep(SqliteStorage* storage, const Step& step) const;
+
+	const std::wstring m_description;
+	std::vector<Step> m_steps;
+};
+
+#endif	  // SQLITE_STORAGE_MIGRATION_SQL_H
@@ -1,29 +1,283 @@
 #include "SqliteIndexStorage.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "FileSystem.h"
 #include "LocationType.h"
+#include "MetricsRegistry.h"
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
+#include "SqliteStorageMigrationSql.h"
+#include "SqliteStorageMigrator.h"
 #include "TextAccess.h"
+#include "TextLayoutMapping.h"
 #include "logging.h"
+#include "utility.h"
+#include "utilityBinary.h"
+#include "utilityCompression.h"
 #include "utilityString.h"
 
-const size_t SqliteIndexStorage::s_storageVersion = 25;
+const size_t SqliteIndexStorage::s_storageVersion = 34;
 
 namespace
 {
-std::pair<std::wstring, std::wstring> splitLocalSymbolName(const std::wstring& name)
+// local symbols with a file are identified by their declaration location, the ones with a name
+// only if the name ends with a location suffix
+bool isUniqueLocalSymbol(const StorageLocalSymbolData& data)
 {
-	size_t pos = name.find_last_of(L'<');
-	if (pos == std::wstring::npos || name.back() != L'>')
+	if (data.fileNodeId)
 	{
-		return std::make_pair(L"", L"");
+		return true;
 	}
 
-	return std::make_pair(name.substr(0, pos), name.substr(pos + 1, name.size() - pos - 2));
+	const size_t pos = data.name.find_last_of(L'<');
+	return pos != std::wstring::npos && data.name.back() == L'>' && pos + 2 < data.name.size();
+}
+
+// smaller contents are stored as text, they would not become much smaller
+const size_t minCompressedFileContentSize = 1024;
+
+// contents are stored as compressed blob if that saves at least an eighth of their size
+void bindFileContent(CppSQLite3Statement& statement, int parameter, const std::string& content)
+{
+	if (content.size() >= minCompressedFileContentSize && content.size() < (size_t(1) << 31))
+	{
+		const std::string compressedContent = utility::compressData(content);
+		if (compressedContent.size() < content.size() - content.size() / 8)
+		{
+			statement.bind(
+				parameter,
+				reinterpret_cast<const unsigned char*>(compressedContent.data()),
+				int(compressedContent.size()));
+			return;
+		}
+	}
+	statement.bind(parameter, content.c_str());
+}
+
+// the event of a trigger recording changes and the ids it records
+typedef std::pair<std::string, std::vector<std::string>> ChangeTrigger;
+
+// deletions cascading from the element table fire the triggers of the node and edge tables
+std::vector<ChangeTrigger> getChangeTriggers()
+{
+	return {
+		{"AFTER INSERT ON main.node", {"NEW.id"}},
+		{"AFTER UPDATE ON main.node", {"NEW.id"}},
+		{"AFTER DELETE ON main.node", {"OLD.id"}},
+		{"AFTER INSERT ON main.edge", {"NEW.id", "NEW.target_node_id"}},
+		{"AFTER UPDATE ON main.edge", {"NEW.id", "OLD.target_node_id", "NEW.target_node_id"}},
+		{"AFTER DELETE ON main.edge", {"OLD.id", "OLD.target_node_id"}},
+		{"AFTER INSERT ON main.symbol", {"NEW.id"}},
+		{"AFTER UPDATE ON main.symbol", {"NEW.id"}}};
+}
+
+std::string getFileContent(CppSQLite3Query& query, int field)
+{
+	if (query.fieldDataType(field) != SQLITE_BLOB)
+	{
+		return query.getStringField(field, "");
+	}
+
+	int size = 0;
+	const unsigned char* data = query.getBlobField(field, size);
+	std::string content;
+	if (!utility::decompressData(reinterpret_cast<const char*>(data), size_t(size), &content))
+	{
+		LOG_ERROR("Stored file content could not be decompressed.");
+		return "";
+	}
+	return content;
+}
+
+// the location types the code view shows for the references of symbols
+std::string getPagedLocationTypesQuery()
+{
+	return "(" + std::to_string(locationTypeToInt(LOCATION_TOKEN)) + ", " +
+		std::to_string(locationTypeToInt(LOCATION_SCOPE)) + ", " +
+		std::to_string(locationTypeToInt(LOCATION_LOCAL_SYMBOL)) + ", " +
+		std::to_string(locationTypeToInt(LOCATION_UNSOLVED)) + ")";
+}
+
+// the locations of a file ordered by position, each number relative to the one before as varint
+std::string packSourceLocations(std::vector<StorageSourceLocation> locations)
+{
+	std::sort(
+		locations.begin(),
+		locations.end(),
+		[](const StorageSourceLocation& a, const StorageSourceLocation& b) {
+			if (a.startLine != b.startLine)
+			{
+				return a.startLine < b.startLine;
+			}
+			else if (a.startCol != b.startCol)
+			{
+				return a.startCol < b.startCol;
+			}
+			return a.id < b.id;
+		});
+
+	std::string data;
+	utility::appendVarint(data, locations.size());
+
+	size_t line = 0;
+	size_t col = 0;
+	Id id = 0;
+	for (const StorageSourceLocation& location: locations)
+	{
+		utility::appendVarint(data, location.startLine - line);
+		utility::appendVarint(
+			data, location.startLine == line ? location.startCol - col : location.startCol);
+		utility::appendSignedVarint(data, int64_t(location.endLine) - int64_t(location.startLine));
+		utility::appendVarint(data, location.endCol);
+		utility::appendVarint(data, uint64_t(location.type));
+		utility::appendSignedVarint(data, int64_t(location.id) - int64_t(id));
+
+		line = location.startLine;
+		col = location.startCol;
+		id = location.id;
+	}
+	return data;
+}
+
+bool unpackSourceLocations(
+	const std::string& data, Id fileNodeId, std::vector<StorageSourceLocation>* locations)
+{
+	size_t position = 0;
+	uint64_t count = 0;
+	if (!utility::readVarint(data, position, count) || count > data.size())
+	{
+		return false;
+	}
+	locations->reserve(locations->size() + count);
+
+	size_t line = 0;
+	size_t col = 0;
+	Id id = 0;
+	for (uint64_t i = 0; i < count; i++)
+	{
+		uint64_t lineDiff = 0;
+		uint64_t startCol = 0;
+		int64_t lineCount = 0;
+		uint64_t endCol = 0;
+		uint64_t type = 0;
+		int64_t idDiff = 0;
+		if (!utility::readVarint(data, position, lineDiff) ||
+			!utility::readVarint(data, position, startCol) ||
+			!utility::readSignedVarint(data, position, lineCount) ||
+			!utility::readVarint(data, position, endCol) ||
+			!utility::readVarint(data, position, type) ||
+			!utility::readSignedVarint(data, position, idDiff))
+		{
+			return false;
+		}
+
+		col = lineDiff ? size_t(startCol) : col + size_t(startCol);
+		line += size_t(lineDiff);
+		id = Id(int64_t(id) + idDiff);
+
+		locations->emplace_back(
+			id, fileNodeId, line, col, size_t(int64_t(line) + lineCount), size_t(endCol), int(type));
+	}
+	return true;
+}
+
+std::string joinTypes(const std::vector<int>& types)
+{
+	std::vector<std::string> typeStrings;
+	for (int type: types)
+	{
+		typeStrings.push_back(std::to_string(type));
+	}
+	return utility::join(typeStrings, ' ');
+}
+
+std::vector<int> splitTypes(const std::string& typesString)
+{
+	std::vector<int> types;
+	for (const std::string& type: utility::splitToVector(typesString, ' '))
+	{
+		if (!type.empty())
+		{
+			types.push_back(std::atoi(type.c_str()));
+		}
+	}
+	return types;
+}
+
+// condition on the joined error table that is true for errors passing the filter
+std::string getErrorFilterCondition(const ErrorFilter& filter)
+{
+	if (filter.error && filter.fatal && filter.unindexedError && filter.unindexedFatal)
+	{
+		return "1";
+	}
+
+	std::vector<std::string> conditions;
+	if (filter.error)
+	{
+		conditions.push_back("(error.fatal = 0 AND error.indexed != 0)");
+	}
+	if (filter.fatal)
+	{
+		conditions.push_back("(error.fatal != 0 AND error.indexed != 0)");
+	}
+	if (filter.unindexedError)
+	{
+		conditions.push_back("(error.fatal = 0 AND error.indexed = 0)");
+	}
+	if (filter.unindexedFatal)
+	{
+		conditions.push_back("(error.fatal != 0 AND error.indexed = 0)");
+	}
+	return conditions.empty() ? "0" : "(" + utility::join(conditions, " OR ") + ")";
+}
+
+// ids are bound as int in many statements, so stable ids stay below this limit and leave room for
+// the ids that later refreshes count up from the highest one
+const Id s_stableIdLimit = Id(1) << 30;
+
+// gives each row the id derived from the hash of its key, rows whose ids collide get the next free
+// one in the order of their keys, so the ids only depend on the keys of all rows
+void assignStableIds(
+	std::vector<std::pair<std::string, Id>> keys,
+	std::unordered_set<Id>* usedIds,
+	std::unordered_map<Id, Id>* stableIds)
+{
+	struct Row
+	{
+		Id stableId;
+		std::string key;
+		Id id;
+	};
+
+	std::vector<Row> rows;
+	rows.reserve(keys.size());
+	for (std::pair<std::string, Id>& key: keys)
+	{
+		const Id stableId = 1 +
+			Id(utility::getStableHash(key.first.data(), key.first.size()) % (s_stableIdLimit - 1));
+		rows.push_back({stableId, std::move(key.first), key.second});
+	}
+
+	std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+		return std::tie(a.stableId, a.key, a.id) < std::tie(b.stableId, b.key, b.id);
+	});
+
+	for (const Row& row: rows)
+	{
+		Id stableId = row.stableId;
+		while (!usedIds->insert(stableId).second)
+		{
+			stableId = stableId % (s_stableIdLimit - 1) + 1;
+		}
+		stableIds->emplace(row.id, stableId);
+	}
 }
 }	 // namespace
 
@@ -42,14 +296,285 @@ size_t SqliteIndexStorage::getStaticVersion() const
 	return s_storageVersion;
 }
 
-void SqliteIndexStorage::setMode(const StorageModeType mode)
+void SqliteIndexStorage::migrateIfNecessary()
+{
+	// older databases are indexed again
+	const size_t firstMigratedVersion = 28;
+	if (getVersion() < firstMigratedVersion || getVersion() >= s_storageVersion)
+	{
+		return;
+	}
+
+	// equal contents are merged, the triggers created by the table setup count the references
+	std::shared_ptr<SqliteStorageMigrationSql> mergeContents =
+		std::make_shared<SqliteStorageMigrationSql>(L"merging equal file contents");
+	mergeContents->addStatement("ALTER TABLE filecontent RENAME TO previous_filecontent;")
+		.addTableSetup()
+		.addBulkStatement(
+			"INSERT INTO content(id, hash, content, reference_count) "
+			"SELECT MIN(f.id), IFNULL(h.content_hash, ''), f.content, 0 "
+			"FROM previous_filecontent f LEFT JOIN file_hash h ON h.id = f.id "
+			"GROUP BY IFNULL(h.content_hash, ''), f.content;",
+			{"content_hash_index"})
+		.addStatement(
+			"INSERT INTO filecontent(id, content_id) SELECT f.id, c.id "
+			"FROM previous_filecontent f LEFT JOIN file_hash h ON h.id = f.id "
+			"JOIN content c ON c.hash = IFNULL(h.content_hash, '') AND c.content IS f.content;")
+		.addStatement("DROP TABLE previous_filecontent;");
+
+	// the composite edge indices and the primary key of occurrence replace the dropped indices
+	std::shared_ptr<SqliteStorageMigrationSql> moveOccurrences =
+		std::make_shared<SqliteStorageMigrationSql>(L"moving occurrences to a table without rowid");
+	moveOccurrences->addStatement("ALTER TABLE occurrence RENAME TO previous_occurrence;")
+		.addTableSetup()
+		.addStatement(
+			"INSERT INTO occurrence(element_id, source_location_id) "
+			"SELECT element_id, source_location_id FROM previous_occurrence "
+			"ORDER BY element_id, source_location_id;")
+		.addStatement("DROP TABLE previous_occurrence;")
+		.addStatement("DROP INDEX IF EXISTS edge_source_node_id_index;")
+		.addStatement("DROP INDEX IF EXISTS edge_target_node_id_index;")
+		.addStatement("DROP INDEX IF EXISTS edge_source_foreign_key_index;")
+		.addStatement("DROP INDEX IF EXISTS edge_target_foreign_key_index;");
+
+	// the packs are built when the storage is read
+	std::shared_ptr<SqliteStorageMigrationSql> addSourceLocationPacks =
+		std::make_shared<SqliteStorageMigrationSql>(L"adding packed source locations");
+	addSourceLocationPacks->addTableSetup();
+
+	// the node files are built when the storage is read as well
+	std::shared_ptr<SqliteStorageMigrationSql> addNodeFiles =
+		std::make_shared<SqliteStorageMigrationSql>(L"adding files of nodes");
+	addNodeFiles->addTableSetup();
+
+	// the search names are written when the storage is read in low memory mode
+	std::shared_ptr<SqliteStorageMigrationSql> addSearchNames =
+		std::make_shared<SqliteStorageMigrationSql>(L"adding search names");
+	addSearchNames->addTableSetup();
+
+	// local symbols of existing databases keep their names until their files are indexed again
+	std::shared_ptr<SqliteStorageMigrationSql> addLocalSymbolLocations =
+		std::make_shared<SqliteStorageMigrationSql>(L"adding local symbol locations");
+	addLocalSymbolLocations
+		->addStatement(
+			"ALTER TABLE local_symbol ADD COLUMN file_node_id INTEGER NOT NULL DEFAULT 0;")
+		.addStatement("ALTER TABLE local_symbol ADD COLUMN start_line INTEGER NOT NULL DEFAULT 0;")
+		.addStatement(
+			"ALTER TABLE local_symbol ADD COLUMN start_column INTEGER NOT NULL DEFAULT 0;");
+
+	SqliteStorageMigrator migrator;
+	migrator.addMigration(29, mergeContents);
+	migrator.addMigration(30, moveOccurrences);
+	migrator.addMigration(31, addSourceLocationPacks);
+	migrator.addMigration(32, addNodeFiles);
+	migrator.addMigration(33, addSearchNames);
+	migrator.addMigration(34, addLocalSymbolLocations);
+	migrator.migrate(this, s_storageVersion);
+}
+
+bool SqliteIndexStorage::hasSourceLocationPacks() const
+{
+	return !getMetaValue("source_location_packs").empty();
+}
+
+void SqliteIndexStorage::buildSourceLocationPacks()
+{
+	beginTransaction();
+	executeStatement("DELETE FROM source_location_pack;");
+
+	std::vector<StorageSourceLocation> locations;
+	forEach<StorageSourceLocation>(
+		"ORDER BY file_node_id", [&locations, this](StorageSourceLocation&& location) {
+			if (!locations.empty() && locations.back().fileNodeId != location.fileNodeId)
+			{
+				setSourceLocationPack(locations.back().fileNodeId, locations);
+				locations.clear();
+			}
+			locations.push_back(std::move(location));
+		});
+	if (!locations.empty())
+	{
+		setSourceLocationPack(locations.back().fileNodeId, locations);
+	}
+
+	insertOrUpdateMetaValue("source_location_packs", "1");
+	commitTransaction();
+}
+
+void SqliteIndexStorage::setSourceLocationPack(
+	Id fileId, const std::vector<StorageSourceLocation>& locations)
+{
+	const std::string data = packSourceLocations(locations);
+	m_insertSourceLocationPackStmt.bind(1, int(fileId));
+	m_insertSourceLocationPackStmt.bind(
+		2, reinterpret_cast<const unsigned char*>(data.data()), int(data.size()));
+	executeStatement(m_insertSourceLocationPackStmt);
+}
+
+bool SqliteIndexStorage::getSourceLocationPack(
+	Id fileId, std::vector<StorageSourceLocation>* locations) const
+{
+	if (!hasSourceLocationPacks())
+	{
+		return false;
+	}
+
+	std::string data;
+	try
+	{
+		CppSQLite3Query q = executeQuery(
+			"SELECT locations FROM source_location_pack WHERE file_node_id = " +
+			std::to_string(fileId) + ";");
+		if (q.eof())
+		{
+			// files without locations have no pack
+			return true;
+		}
+
+		int length = 0;
+		const unsigned char* blob = q.getBlobField(0, length);
+		if (blob && length > 0)
+		{
+			data.assign(reinterpret_cast<const char*>(blob), length);
+		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+		return false;
+	}
+
+	if (!unpackSourceLocations(data, fileId, locations))
+	{
+		LOG_ERROR("Stored source locations of file could not be unpacked.");
+		locations->clear();
+		return false;
+	}
+	return true;
+}
+
+bool SqliteIndexStorage::hasAggregates() const
+{
+	return !getMetaValue("aggregate_counts").empty();
+}
+
+void SqliteIndexStorage::updateAggregates()
+{
+	beginTransaction();
+	setAggregateStats(queryStorageStats());
+	insertOrUpdateMetaValue("aggregate_node_types", joinTypes(queryAvailableTypes("node")));
+	insertOrUpdateMetaValue("aggregate_edge_types", joinTypes(queryAvailableTypes("edge")));
+	commitTransaction();
+}
+
+void SqliteIndexStorage::setAggregateStats(const StorageStats& stats)
+{
+	insertOrUpdateMetaValue(
+		"aggregate_counts",
+		std::to_string(stats.nodeCount) + ' ' + std::to_string(stats.edgeCount) + ' ' +
+			std::to_string(stats.fileCount) + ' ' + std::to_string(stats.completedFileCount) + ' ' +
+			std::to_string(stats.fileLOCCount));
+}
+
+StorageStats SqliteIndexStorage::queryStorageStats() const
+{
+	StorageStats stats;
+	stats.nodeCount = getNodeCount();
+	stats.edgeCount = getEdgeCount();
+	stats.fileCount = getFileCount();
+	stats.completedFileCount = getCompletedFileCount();
+	stats.fileLOCCount = getFileLineSum();
+	return stats;
+}
+
+std::vector<int> SqliteIndexStorage::queryAvailableTypes(const std::string& tableName) const
+{
+	CppSQLite3Query q = executeQuery("SELECT DISTINCT type FROM " + tableName + ";");
+
+	std::vector<int> types;
+
+	while (!q.eof())
+	{
+		const int type = q.getIntField(0, -1);
+		if (type != -1)
+		{
+			types.push_back(type);
+		}
+
+		q.nextRow();
+	}
+
+	return types;
+}
+
+bool SqliteIndexStorage::hasNodeFiles() const
 {
-	m_tempNodeNameIndex.clear();
-	m_tempWNodeNameIndex.clear();
-	m_tempNodeTypes.clear();
+	return !getMetaValue("node_files").empty();
+}
+
+void SqliteIndexStorage::buildNodeFiles()
+{
+	// the first of the ordered rows of each node gets inserted, later ones are ignored
+	const std::string selectLocations =
+		"SELECT o.element_id, l.file_node_id FROM occurrence o "
+		"JOIN node n ON n.id = o.element_id "
+		"JOIN source_location l ON l.id = o.source_location_id "
+		"JOIN file f ON f.id = l.file_node_id ";
+
+	beginTransaction();
+	executeStatement("DELETE FROM node_file;");
+	executeStatement(
+		"INSERT OR IGNORE INTO node_file(node_id, file_node_id) " + selectLocations +
+		"WHERE l.type = " + std::to_string(locationTypeToInt(LOCATION_SCOPE)) +
+		" ORDER BY o.element_id, f.path;");
+	executeStatement(
+		"INSERT OR IGNORE INTO node_file(node_id, file_node_id) " + selectLocations +
+		"ORDER BY o.element_id, f.path;");
+	insertOrUpdateMetaValue("node_files", "1");
+	commitTransaction();
+}
+
+void SqliteIndexStorage::clearTempIndices()
+{
+	m_tempSymbolIdIndex.clear();
 	m_tempEdgeIndex.clear();
 	m_tempLocalSymbolIndex.clear();
 	m_tempSourceLocationIndices.clear();
+	m_tempFilePathIndex.clear();
+	m_tempErrorIndex.clear();
+}
+
+void SqliteIndexStorage::countInsertedRows(size_t rowCount)
+{
+	static MetricCounter& insertedRowCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_storage_inserted_rows_total", "Rows written by batched inserts into the index");
+	insertedRowCounter.add(rowCount);
+}
+
+void SqliteIndexStorage::setMode(const StorageModeType mode)
+{
+	clearTempIndices();
+
+	m_mode = mode;
+
+	if (mode != STORAGE_MODE_READ && !getSnapshotStamp().empty())
+	{
+		setSnapshotStamp("");
+	}
+
+	// the packs and aggregates are not kept up to date while writing
+	if (mode != STORAGE_MODE_READ && hasSourceLocationPacks())
+	{
+		insertOrUpdateMetaValue("source_location_packs", "");
+	}
+	if (mode != STORAGE_MODE_READ && hasAggregates())
+	{
+		insertOrUpdateMetaValue("aggregate_counts", "");
+	}
+	if (mode != STORAGE_MODE_READ && hasNodeFiles())
+	{
+		insertOrUpdateMetaValue("node_files", "");
+	}
 
 	std::vector<std::pair<int, SqliteDatabaseIndex>> indices = getIndices();
 	for (size_t i = 0; i < indices.size(); i++)
@@ -63,6 +588,19 @@ void SqliteIndexStorage::setMode(const StorageModeType mode)
 			indices[i].second.removeFromDatabase(m_database);
 		}
 	}
+
+	if (mode == STORAGE_MODE_READ && !hasSourceLocationPacks())
+	{
+		buildSourceLocationPacks();
+	}
+	if (mode == STORAGE_MODE_READ && !hasAggregates())
+	{
+		updateAggregates();
+	}
+	if (mode == STORAGE_MODE_READ && !hasNodeFiles())
+	{
+		buildNodeFiles();
+	}
 }
 
 std::string SqliteIndexStorage::getProjectSettingsText() const
@@ -75,6 +613,91 @@ void SqliteIndexStorage::setProjectSettingsText(std::string text)
 	insertOrUpdateMetaValue("project_settings", text);
 }
 
+std::string SqliteIndexStorage::getSnapshotStamp() const
+{
+	return getMetaValue("snapshot_stamp");
+}
+
+void SqliteIndexStorage::setSnapshotStamp(const std::string& stamp)
+{
+	insertOrUpdateMetaValue("snapshot_stamp", stamp);
+}
+
+std::string SqliteIndexStorage::getRevision() const
+{
+	return getMetaValue("revision");
+}
+
+void SqliteIndexStorage::setRevision(const std::string& revision)
+{
+	insertOrUpdateMetaValue("revision", revision);
+}
+
+std::string SqliteIndexStorage::getDeltaBaseRevision() const
+{
+	return getMetaValue("delta_base_revision");
+}
+
+void SqliteIndexStorage::setDeltaBaseRevision(const std::string& revision)
+{
+	insertOrUpdateMetaValue("delta_base_revision", revision);
+}
+
+std::vector<FilePath> SqliteIndexStorage::getDeltaClearedFilePaths() const
+{
+	std::vector<FilePath> filePaths;
+	for (const std::string& path: utility::splitToVector(getMetaValue("delta_cleared_files"), '\n'))
+	{
+		if (!path.empty())
+		{
+			filePaths.push_back(FilePath(utility::decodeFromUtf8(path)));
+		}
+	}
+	return filePaths;
+}
+
+void SqliteIndexStorage::setDeltaClearedFilePaths(const std::vector<FilePath>& filePaths)
+{
+	std::string text;
+	for (const FilePath& filePath: filePaths)
+	{
+		text += utility::encodeToUtf8(filePath.wstr()) + '\n';
+	}
+	insertOrUpdateMetaValue("delta_cleared_files", text);
+}
+
+std::map<std::string, float> SqliteIndexStorage::getIndexingPhaseDurations() const
+{
+	const std::string text = getMetaValue("indexing_phase_durations");
+
+	std::map<std::string, float> durations;
+	for (const std::string& entry: utility::splitToVector(text, ';'))
+	{
+		const size_t pos = entry.find('=');
+		if (pos != std::string::npos)
+		{
+			durations.emplace(entry.substr(0, pos), float(std::atof(entry.c_str() + pos + 1)));
+		}
+	}
+	return durations;
+}
+
+void SqliteIndexStorage::setIndexingPhaseDurations(const std::map<std::string, float>& durations)
+{
+	std::string text;
+	for (const auto& duration: durations)
+	{
+		text += (text.empty() ? "" : ";") + duration.first + "=" + std::to_string(duration.second);
+		MetricsRegistry::getInstance()
+			->getGauge(
+				"sourcetrail_indexing_phase_duration_seconds",
+				"Duration of each phase of the last indexing",
+				"phase=\"" + duration.first + "\"")
+			.set(duration.second);
+	}
+	insertOrUpdateMetaValue("indexing_phase_durations", text);
+}
+
 Id SqliteIndexStorage::addNode(const StorageNodeData& data)
 {
 	std::vector<Id> ids = addNodes({StorageNode(0, data)});
@@ -83,21 +706,15 @@ Id SqliteIndexStorage::addNode(const StorageNodeData& data)
 
 std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nodes)
 {
-	if (m_tempNodeNameIndex.empty() && m_tempWNodeNameIndex.empty())
+	if (m_tempSymbolIdIndex.empty())
 	{
-		forEach<StorageNode>([this](StorageNode&& node) {
-			std::string name = utility::encodeToUtf8(node.serializedName);
-			if (name.size() != node.serializedName.size())
-			{
-				m_tempWNodeNameIndex.add(node.serializedName, node.id);
-			}
-			else
-			{
-				m_tempNodeNameIndex.add(name, node.id);
-			}
-
-			m_tempNodeTypes.emplace(node.id, node.type);
-		});
+		// the names are hashed straight from the rows and never copied
+		forEachRow<Id, int, ColumnText>(
+			"SELECT id, type, serialized_name FROM node;",
+			[this](Id id, int type, const ColumnText& serializedName) {
+				m_tempSymbolIdIndex.add(
+					SymbolIdIndex::getKey(serializedName.data, serializedName.size), id, type);
+			});
 	}
 
 	std::vector<Id> nodeIds(nodes.size(), 0);
@@ -105,47 +722,27 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 	for (size_t i = 0; i < nodes.size(); i++)
 	{
 		const StorageNodeData& data = nodes[i];
-		std::string name = utility::encodeToUtf8(data.serializedName);
+		const SymbolIdIndex::Key key = SymbolIdIndex::getKey(data.serializedName);
+
+		if (SymbolIdIndex::Entry* entry = m_tempSymbolIdIndex.find(key))
 		{
-			Id nodeId;
-			if (name.size() != data.serializedName.size())
+			if (entry->type < data.type)
 			{
-				nodeId = m_tempWNodeNameIndex.find(data.serializedName);
-			}
-			else
-			{
-				nodeId = m_tempNodeNameIndex.find(name);
+				setNodeType(data.type, entry->id);
+				entry->type = data.type;
 			}
 
-			if (nodeId)
-			{
-				auto it = m_tempNodeTypes.find(nodeId);
-				if (it != m_tempNodeTypes.end() && it->second < data.type)
-				{
-					setNodeType(data.type, nodeId);
-					m_tempNodeTypes[nodeId] = data.type;
-				}
-
-				nodeIds[i] = nodeId;
-			}
-			else
-			{
-				executeStatement(m_insertElementStmt);
-				Id id = m_database.lastRowId();
+			nodeIds[i] = entry->id;
+		}
+		else
+		{
+			executeStatement(m_insertElementStmt);
+			Id id = m_database.lastRowId();
 
-				nodesToInsert.emplace_back(id, data);
-				nodeIds[i] = id;
+			nodesToInsert.emplace_back(id, data);
+			nodeIds[i] = id;
 
-				if (name.size() != data.serializedName.size())
-				{
-					m_tempWNodeNameIndex.add(data.serializedName, id);
-				}
-				else
-				{
-					m_tempNodeNameIndex.add(name, id);
-				}
-				m_tempNodeTypes.emplace(id, data.type);
-			}
+			m_tempSymbolIdIndex.add(key, id, data.type);
 		}
 	}
 
@@ -169,7 +766,21 @@ bool SqliteIndexStorage::addSymbols(const std::vector<StorageSymbol>& symbols)
 
 bool SqliteIndexStorage::addFile(const StorageFile& data)
 {
-	if (getFileByPath(data.filePath).id != 0)
+	if (m_mode == STORAGE_MODE_BULK_WRITE)
+	{
+		// file_path_index does not exist while bulk writing
+		if (m_tempFilePathIndex.empty())
+		{
+			forEach<StorageFile>(
+				[this](StorageFile&& file) { m_tempFilePathIndex.insert(file.filePath); });
+		}
+
+		if (!m_tempFilePathIndex.insert(data.filePath).second)
+		{
+			return false;
+		}
+	}
+	else if (getFileByPath(data.filePath).id != 0)
 	{
 		return false;
 	}
@@ -204,14 +815,54 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 
 	if (success && content)
 	{
-		m_insertFileContentStmt.bind(1, int(data.id));
-		m_insertFileContentStmt.bind(2, content->getText().c_str());
-		success = executeStatement(m_insertFileContentStmt);
+		const std::string text = content->getText();
+		const std::string contentHash = TextLayoutMapping::getContentHash(text);
+
+		success = addFileContent(data.id, text, contentHash);
+
+		m_insertFileHashStmt.bind(1, int(data.id));
+		m_insertFileHashStmt.bind(2, contentHash.c_str());
+		m_insertFileHashStmt.bind(3, TextLayoutMapping::getCodeHash(text).c_str());
+		success = success && executeStatement(m_insertFileHashStmt);
 	}
 
 	return success;
 }
 
+bool SqliteIndexStorage::addFileContent(
+	Id fileId, const std::string& content, const std::string& contentHash)
+{
+	Id contentId = 0;
+	{
+		m_findContentStmt.bind(1, contentHash.c_str());
+		CppSQLite3Query q = executeQuery(m_findContentStmt);
+		while (!q.eof() && !contentId)
+		{
+			if (getFileContent(q, 1) == content)
+			{
+				contentId = q.getIntField(0, 0);
+			}
+			q.nextRow();
+		}
+		m_findContentStmt.reset();
+	}
+
+	if (!contentId)
+	{
+		m_insertContentStmt.bind(1, contentHash.c_str());
+		bindFileContent(m_insertContentStmt, 2, content);
+		if (!executeStatement(m_insertContentStmt))
+		{
+			return false;
+		}
+		contentId = m_database.lastRowId();
+	}
+
+	m_insertFileContentStmt.bind(1, int(fileId));
+	m_insertFileContentStmt.bind(2, int(contentId));
+	return executeStatement(m_insertFileContentStmt);
+}
+
 Id SqliteIndexStorage::addEdge(const StorageEdgeData& data)
 {
 	std::vector<Id> ids = addEdges({StorageEdge(0, data)});
@@ -264,36 +915,30 @@ Id SqliteIndexStorage::addLocalSymbol(const StorageLocalSymbolData& data)
 	return ids.size() ? ids[0] : 0;
 }
 
-std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	if (m_tempLocalSymbolIndex.empty())
 	{
 		forEach<StorageLocalSymbol>([this](StorageLocalSymbol&& localSymbol) {
-			std::pair<std::wstring, std::wstring> name = splitLocalSymbolName(localSymbol.name);
-			if (name.second.size())
+			if (isUniqueLocalSymbol(localSymbol))
 			{
-				m_tempLocalSymbolIndex[name.first].emplace(name.second, localSymbol.id);
+				m_tempLocalSymbolIndex.emplace(localSymbol, localSymbol.id);
 			}
 		});
 	}
 
 	std::vector<Id> symbolIds(symbols.size(), 0);
 	std::vector<StorageLocalSymbol> symbolsToInsert;
-	auto it = symbols.begin();
 	for (size_t i = 0; i < symbols.size(); i++)
 	{
-		const StorageLocalSymbol& data = *it;
-		std::pair<std::wstring, std::wstring> name = splitLocalSymbolName(data.name);
-		if (name.second.size())
+		const StorageLocalSymbol& data = symbols[i];
+		const bool isUnique = isUniqueLocalSymbol(data);
+		if (isUnique)
 		{
-			auto it = m_tempLocalSymbolIndex.find(name.first);
+			auto it = m_tempLocalSymbolIndex.find(data);
 			if (it != m_tempLocalSymbolIndex.end())
 			{
-				auto it2 = it->second.find(name.second);
-				if (it2 != it->second.end())
-				{
-					symbolIds[i] = it2->second;
-				}
+				symbolIds[i] = it->second;
 			}
 		}
 
@@ -304,13 +949,11 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 			symbolIds[i] = id;
 			symbolsToInsert.emplace_back(id, data);
-			if (name.second.size())
+			if (isUnique)
 			{
-				m_tempLocalSymbolIndex[name.first].emplace(name.second, id);
+				m_tempLocalSymbolIndex.emplace(data, id);
 			}
 		}
-
-		it++;
 	}
 
 	if (symbolsToInsert.size())
@@ -419,37 +1062,498 @@ StorageError SqliteIndexStorage::addError(const StorageErrorData& data)
 	const std::wstring sanitizedMessage = utility::replace(data.message, L"'", L"''");
 
 	Id id = 0;
+	if (m_mode == STORAGE_MODE_BULK_WRITE)
+	{
+		// error_all_data_index does not exist while bulk writing
+		if (m_tempErrorIndex.empty())
+		{
+			forEach<StorageError>([this](StorageError&& error) {
+				m_tempErrorIndex.emplace(std::make_pair(error.message, error.fatal), error.id);
+			});
+		}
+
+		auto it = m_tempErrorIndex.find(std::make_pair(sanitizedMessage, data.fatal));
+		if (it != m_tempErrorIndex.end())
+		{
+			id = it->second;
+		}
+	}
+	else
 	{
 		m_checkErrorExistsStmt.bind(1, utility::encodeToUtf8(sanitizedMessage).c_str());
 		m_checkErrorExistsStmt.bind(2, int(data.fatal));
 
-		CppSQLite3Query checkQuery = executeQuery(m_checkErrorExistsStmt);
-		if (!checkQuery.eof() && checkQuery.numFields() > 0)
+		CppSQLite3Query checkQuery = executeQuery(m_checkErrorExistsStmt);
+		if (!checkQuery.eof() && checkQuery.numFields() > 0)
+		{
+			id = checkQuery.getIntField(0, -1);
+		}
+		m_checkErrorExistsStmt.reset();
+	}
+
+	if (id == 0)
+	{
+		executeStatement(m_insertElementStmt);
+		id = m_database.lastRowId();
+
+		m_insertErrorStmt.bind(1, int(id));
+		m_insertErrorStmt.bind(2, utility::encodeToUtf8(sanitizedMessage).c_str());
+		m_insertErrorStmt.bind(3, data.fatal);
+		m_insertErrorStmt.bind(4, data.indexed);
+		m_insertErrorStmt.bind(5, utility::encodeToUtf8(data.translationUnit).c_str());
+
+		const bool success = executeStatement(m_insertErrorStmt);
+		if (success)
+		{
+			id = m_database.lastRowId();
+
+			if (m_mode == STORAGE_MODE_BULK_WRITE)
+			{
+				m_tempErrorIndex.emplace(std::make_pair(sanitizedMessage, data.fatal), id);
+			}
+		}
+	}
+
+	return StorageError(id, data);
+}
+
+bool SqliteIndexStorage::injectDatabase(const FilePath& dbFilePath)
+{
+	// sqlite cannot attach databases within a transaction
+	if (isInTransaction())
+	{
+		return false;
+	}
+
+	const std::string path = utility::replace(utility::encodeToUtf8(dbFilePath.wstr()), "'", "''");
+	if (!executeStatement("ATTACH DATABASE '" + path + "' AS injected;"))
+	{
+		return false;
+	}
+
+	const int version = executeStatementScalar(
+		"SELECT CAST(value AS INTEGER) FROM injected.meta WHERE key = 'storage_version';", 0);
+	if (version != int(s_storageVersion))
+	{
+		LOG_WARNING(
+			L"Database \"" + dbFilePath.wstr() + L"\" has storage version " +
+			std::to_wstring(version) + L" and cannot be attached for injection.");
+		executeStatement("DETACH DATABASE injected;");
+		return false;
+	}
+
+	// the own ids of injected elements and source locations, elements are matched the same way
+	// as by the add methods. Joins on columns without an index of the current mode use the
+	// automatic indices of sqlite.
+	std::vector<std::string> statements = {
+		"CREATE TEMP TABLE injected_element_id(injected_id INTEGER PRIMARY KEY, own_id INTEGER);",
+		"CREATE INDEX temp.injected_element_own_id_index ON injected_element_id(own_id);",
+		"CREATE TEMP TABLE injected_location_id(injected_id INTEGER PRIMARY KEY, own_id INTEGER);",
+		"CREATE TEMP TABLE injected_content_id(injected_id INTEGER PRIMARY KEY, own_id INTEGER);",
+		"CREATE TEMP TABLE injected_new_id(own_id INTEGER PRIMARY KEY, injected_id INTEGER);",
+		"CREATE INDEX temp.injected_new_id_index ON injected_new_id(injected_id);"};
+
+	// adds the ids selected by the query to the id map and gives all injected ids without an own
+	// counterpart the next free ids of the own table, which stay in injected_new_id until the next
+	// mapping
+	auto mapIds = [&statements](
+					  const std::string& idTable,
+					  const std::string& ownTable,
+					  const std::string& selectQuery) {
+		statements.push_back("DELETE FROM injected_new_id;");
+		statements.push_back(
+			"INSERT INTO injected_new_id(own_id, injected_id) "
+			"SELECT IFNULL(MAX(id), 0), 0 FROM main." +
+			ownTable + ";");
+		statements.push_back(
+			"INSERT OR IGNORE INTO " + idTable + "(injected_id, own_id) " + selectQuery + ";");
+		statements.push_back(
+			"INSERT INTO injected_new_id(injected_id) "
+			"SELECT injected_id FROM " +
+			idTable + " WHERE own_id IS NULL;");
+		statements.push_back("DELETE FROM injected_new_id WHERE injected_id = 0;");
+		statements.push_back(
+			"UPDATE " + idTable +
+			" SET own_id = (SELECT n.own_id FROM injected_new_id n "
+			"WHERE n.injected_id = " +
+			idTable + ".injected_id) WHERE own_id IS NULL;");
+		if (ownTable == "element")
+		{
+			statements.push_back("INSERT INTO main.element(id) SELECT own_id FROM injected_new_id;");
+		}
+	};
+
+	mapIds(
+		"injected_element_id",
+		"element",
+		"SELECT i.id, (SELECT e.id FROM main.error e "
+		"WHERE e.message = i.message AND e.fatal = i.fatal LIMIT 1) "
+		"FROM injected.error i");
+	statements.push_back(
+		"INSERT INTO main.error(id, message, fatal, indexed, translation_unit) "
+		"SELECT n.own_id, i.message, i.fatal, i.indexed, i.translation_unit "
+		"FROM injected.error i JOIN injected_new_id n ON n.injected_id = i.id;");
+
+	mapIds(
+		"injected_element_id",
+		"element",
+		"SELECT i.id, n.id FROM injected.node i "
+		"LEFT JOIN main.node n ON n.serialized_name = i.serialized_name");
+	// existing nodes keep the highest node type, like in addNodes
+	statements.push_back(
+		"UPDATE main.node SET type = MAX(type, "
+		"(SELECT i.type FROM injected_element_id m JOIN injected.node i ON i.id = m.injected_id "
+		"WHERE m.own_id = main.node.id)) "
+		"WHERE id IN (SELECT m.own_id FROM injected_element_id m "
+		"JOIN injected.node i ON i.id = m.injected_id);");
+	statements.push_back(
+		"INSERT INTO main.node(id, type, serialized_name) "
+		"SELECT n.own_id, i.type, i.serialized_name "
+		"FROM injected.node i JOIN injected_new_id n ON n.injected_id = i.id;");
+
+	// the stored content is copied instead of reading the files again
+	statements.push_back(
+		"INSERT INTO main.file(id, path, language, modification_time, indexed, complete, "
+		"line_count) "
+		"SELECT m.own_id, i.path, i.language, i.modification_time, i.indexed, i.complete, "
+		"i.line_count "
+		"FROM injected.file i JOIN injected_element_id m ON m.injected_id = i.id "
+		"WHERE m.own_id NOT IN (SELECT id FROM main.file) "
+		"AND i.path NOT IN (SELECT path FROM main.file WHERE path IS NOT NULL);");
+
+	// contents that are stored already are shared, unreferenced copies are removed later on
+	mapIds(
+		"injected_content_id",
+		"content",
+		"SELECT i.id, (SELECT c.id FROM main.content c "
+		"WHERE c.hash = i.hash AND c.content IS i.content LIMIT 1) FROM injected.content i");
+	statements.push_back(
+		"INSERT INTO main.content(id, hash, content, reference_count) "
+		"SELECT n.own_id, i.hash, i.content, 0 "
+		"FROM injected.content i JOIN injected_new_id n ON n.injected_id = i.id;");
+	statements.push_back(
+		"INSERT OR IGNORE INTO main.filecontent(id, content_id) SELECT m.own_id, c.own_id "
+		"FROM injected.filecontent i JOIN injected_element_id m ON m.injected_id = i.id "
+		"JOIN injected_content_id c ON c.injected_id = i.content_id "
+		"WHERE m.own_id IN (SELECT id FROM main.file);");
+	statements.push_back(
+		"INSERT OR IGNORE INTO main.file_hash(id, content_hash, code_hash) "
+		"SELECT m.own_id, i.content_hash, i.code_hash "
+		"FROM injected.file_hash i JOIN injected_element_id m ON m.injected_id = i.id "
+		"WHERE m.own_id IN (SELECT id FROM main.file);");
+
+	statements.push_back(
+		"INSERT OR IGNORE INTO main.symbol(id, definition_kind) "
+		"SELECT m.own_id, i.definition_kind "
+		"FROM injected.symbol i JOIN injected_element_id m ON m.injected_id = i.id;");
+
+	mapIds(
+		"injected_element_id",
+		"element",
+		"SELECT i.id, e.id FROM injected.edge i "
+		"JOIN injected_element_id s ON s.injected_id = i.source_node_id "
+		"JOIN injected_element_id t ON t.injected_id = i.target_node_id "
+		"LEFT JOIN main.edge e ON e.type = i.type AND e.source_node_id = s.own_id "
+		"AND e.target_node_id = t.own_id");
+	statements.push_back(
+		"INSERT INTO main.edge(id, type, source_node_id, target_node_id) "
+		"SELECT n.own_id, i.type, s.own_id, t.own_id "
+		"FROM injected.edge i JOIN injected_new_id n ON n.injected_id = i.id "
+		"JOIN injected_element_id s ON s.injected_id = i.source_node_id "
+		"JOIN injected_element_id t ON t.injected_id = i.target_node_id;");
+
+	// local symbols are identified by their declaration location or by a name with a location
+	// suffix, see isUniqueLocalSymbol
+	mapIds(
+		"injected_element_id",
+		"element",
+		"SELECT i.id, l.id FROM injected.local_symbol i "
+		"LEFT JOIN injected_element_id f ON f.injected_id = i.file_node_id "
+		"LEFT JOIN main.local_symbol l ON l.file_node_id = IFNULL(f.own_id, 0) "
+		"AND l.start_line = i.start_line AND l.start_column = i.start_column "
+		"AND l.name = i.name AND (i.file_node_id != 0 OR i.name LIKE '%<_%>')");
+	statements.push_back(
+		"INSERT INTO main.local_symbol(id, name, file_node_id, start_line, start_column) "
+		"SELECT n.own_id, i.name, IFNULL(f.own_id, 0), i.start_line, i.start_column "
+		"FROM injected.local_symbol i JOIN injected_new_id n ON n.injected_id = i.id "
+		"LEFT JOIN injected_element_id f ON f.injected_id = i.file_node_id;");
+
+	mapIds(
+		"injected_location_id",
+		"source_location",
+		"SELECT i.id, l.id FROM injected.source_location i "
+		"JOIN injected_element_id f ON f.injected_id = i.file_node_id "
+		"LEFT JOIN main.source_location l ON l.file_node_id = f.own_id "
+		"AND l.start_line = i.start_line AND l.start_column = i.start_column "
+		"AND l.end_line = i.end_line AND l.end_column = i.end_column AND l.type = i.type");
+	statements.push_back(
+		"INSERT INTO main.source_location(id, file_node_id, start_line, start_column, end_line, "
+		"end_column, type) "
+		"SELECT n.own_id, f.own_id, i.start_line, i.start_column, i.end_line, i.end_column, "
+		"i.type "
+		"FROM injected.source_location i JOIN injected_new_id n ON n.injected_id = i.id "
+		"JOIN injected_element_id f ON f.injected_id = i.file_node_id;");
+
+	statements.push_back(
+		"INSERT OR IGNORE INTO main.occurrence(element_id, source_location_id) "
+		"SELECT e.own_id, l.own_id FROM injected.occurrence i "
+		"JOIN injected_element_id e ON e.injected_id = i.element_id "
+		"JOIN injected_location_id l ON l.injected_id = i.source_location_id;");
+	statements.push_back(
+		"INSERT INTO main.element_component(element_id, type, data) "
+		"SELECT m.own_id, i.type, i.data "
+		"FROM injected.element_component i JOIN injected_element_id m "
+		"ON m.injected_id = i.element_id;");
+	statements.push_back(
+		"INSERT OR IGNORE INTO main.component_access(node_id, type) SELECT m.own_id, i.type "
+		"FROM injected.component_access i JOIN injected_element_id m ON m.injected_id = i.node_id;");
+	statements.push_back(
+		"INSERT OR REPLACE INTO main.indexing_time(path, duration_ms, parse_duration_ms, "
+		"visit_duration_ms, peak_memory_kb, storage_byte_count, gc_duration_ms) "
+		"SELECT path, duration_ms, parse_duration_ms, visit_duration_ms, peak_memory_kb, "
+		"storage_byte_count, gc_duration_ms FROM injected.indexing_time;");
+
+	statements.push_back("DROP TABLE injected_element_id;");
+	statements.push_back("DROP TABLE injected_location_id;");
+	statements.push_back("DROP TABLE injected_content_id;");
+	statements.push_back("DROP TABLE injected_new_id;");
+
+	beginTransaction();
+	bool success = true;
+	for (const std::string& statement: statements)
+	{
+		if (!executeStatement(statement))
+		{
+			success = false;
+			break;
+		}
+	}
+
+	if (success)
+	{
+		commitTransaction();
+	}
+	else
+	{
+		// also drops the temporary tables
+		rollbackTransaction();
+	}
+	executeStatement("DETACH DATABASE injected;");
+
+	// the indices of the add methods don't know the copied content
+	clearTempIndices();
+
+	return success;
+}
+
+void SqliteIndexStorage::canonicalizeIds()
+{
+	auto readKeys = [this](
+						const std::string& query,
+						const std::function<std::string(CppSQLite3Query&)>& getKey) {
+		std::vector<std::pair<std::string, Id>> keys;
+		CppSQLite3Query q = executeQuery(query);
+		while (!q.eof())
+		{
+			keys.emplace_back(getKey(q), Id(q.getIntField(0, 0)));
+			q.nextRow();
+		}
+		return keys;
+	};
+
+	// nodes come first, the keys of the other elements contain the stable ids of their nodes
+	std::unordered_set<Id> usedElementIds;
+	std::unordered_map<Id, Id> elementIds;
+	auto getElementId = [&elementIds](Id id) {
+		auto it = elementIds.find(id);
+		return std::to_string(it != elementIds.end() ? it->second : id);
+	};
+
+	assignStableIds(
+		readKeys(
+			"SELECT id, serialized_name FROM node;",
+			[](CppSQLite3Query& q) { return "node\n" + std::string(q.getStringField(1, "")); }),
+		&usedElementIds,
+		&elementIds);
+
+	std::vector<std::pair<std::string, Id>> keys = readKeys(
+		"SELECT id, type, source_node_id, target_node_id FROM edge;",
+		[&getElementId](CppSQLite3Query& q) {
+			return "edge\n" + std::to_string(q.getIntField(1, 0)) + "\n" +
+				getElementId(Id(q.getIntField(2, 0))) + "\n" +
+				getElementId(Id(q.getIntField(3, 0)));
+		});
+	utility::append(
+		keys,
+		readKeys(
+			"SELECT id, name, file_node_id, start_line, start_column FROM local_symbol;",
+			[&getElementId](CppSQLite3Query& q) {
+				return "local_symbol\n" + std::string(q.getStringField(1, "")) + "\n" +
+					getElementId(Id(q.getIntField(2, 0))) + "\n" +
+					std::to_string(q.getIntField(3, 0)) + "\n" +
+					std::to_string(q.getIntField(4, 0));
+			}));
+	utility::append(
+		keys,
+		readKeys(
+			"SELECT id, message, fatal, indexed, translation_unit FROM error;",
+			[](CppSQLite3Query& q) {
+				return "error\n" + std::string(q.getStringField(1, "")) + "\n" +
+					std::to_string(q.getIntField(2, 0)) + std::to_string(q.getIntField(3, 0)) +
+					"\n" + q.getStringField(4, "");
+			}));
+	// elements without any data only keep their position among each other
+	utility::append(
+		keys,
+		readKeys(
+			"SELECT id FROM element WHERE id NOT IN (SELECT id FROM node UNION SELECT id FROM edge "
+			"UNION SELECT id FROM local_symbol UNION SELECT id FROM error);",
+			[](CppSQLite3Query& q) { return "element\n" + std::to_string(q.getIntField(0, 0)); }));
+	assignStableIds(std::move(keys), &usedElementIds, &elementIds);
+
+	std::unordered_set<Id> usedLocationIds;
+	std::unordered_map<Id, Id> locationIds;
+	assignStableIds(
+		readKeys(
+			"SELECT id, file_node_id, start_line, start_column, end_line, end_column, type "
+			"FROM source_location;",
+			[&getElementId](CppSQLite3Query& q) {
+				std::string key = getElementId(Id(q.getIntField(1, 0)));
+				for (int field = 2; field < 7; field++)
+				{
+					key += "\n" + std::to_string(q.getIntField(field, 0));
+				}
+				return key;
+			}),
+		&usedLocationIds,
+		&locationIds);
+
+	std::unordered_set<Id> usedContentIds;
+	std::unordered_map<Id, Id> contentIds;
+	assignStableIds(
+		readKeys(
+			"SELECT id, hash FROM content;",
+			[](CppSQLite3Query& q) { return std::string(q.getStringField(1, "")); }),
+		&usedContentIds,
+		&contentIds);
+
+	std::unordered_set<Id> usedComponentIds;
+	std::unordered_map<Id, Id> componentIds;
+	assignStableIds(
+		readKeys(
+			"SELECT id, element_id, type, data FROM element_component;",
+			[&getElementId](CppSQLite3Query& q) {
+				return getElementId(Id(q.getIntField(1, 0))) + "\n" +
+					std::to_string(q.getIntField(2, 0)) + "\n" + q.getStringField(3, "");
+			}),
+		&usedComponentIds,
+		&componentIds);
+
+	// foreign keys cannot be switched off within a transaction and would cascade the changed ids
+	executeStatement("PRAGMA foreign_keys=OFF;");
+	beginTransaction();
+
+	auto storeIds = [this](const std::string& idTable, const std::unordered_map<Id, Id>& ids) {
+		executeStatement(
+			"CREATE TEMP TABLE " + idTable + "(id INTEGER PRIMARY KEY, stable_id INTEGER);");
+		CppSQLite3Statement stmt = m_database.compileStatement(
+			("INSERT INTO " + idTable + "(id, stable_id) VALUES(?, ?);").c_str());
+		for (const std::pair<const Id, Id>& p: ids)
+		{
+			stmt.bind(1, int(p.first));
+			stmt.bind(2, int(p.second));
+			executeStatement(stmt);
+		}
+	};
+	storeIds("stable_element_id", elementIds);
+	storeIds("stable_location_id", locationIds);
+	storeIds("stable_content_id", contentIds);
+	storeIds("stable_component_id", componentIds);
+
+	// key columns are negated first, so no row takes an id that another row still has
+	std::vector<std::string> statements;
+	auto mapColumns = [&statements](
+						  const std::string& table,
+						  const std::vector<std::pair<std::string, std::string>>& keyColumns,
+						  const std::vector<std::pair<std::string, std::string>>& columns) {
+		std::vector<std::string> negations;
+		std::vector<std::string> assignments;
+		for (const std::pair<std::string, std::string>& column: keyColumns)
+		{
+			const std::string value = "-" + table + "." + column.first;
+			negations.push_back(column.first + " = -" + column.first);
+			assignments.push_back(
+				column.first + " = IFNULL((SELECT stable_id FROM " + column.second +
+				" WHERE id = " + value + "), " + value + ")");
+		}
+		for (const std::pair<std::string, std::string>& column: columns)
+		{
+			const std::string value = table + "." + column.first;
+			assignments.push_back(
+				column.first + " = IFNULL((SELECT stable_id FROM " + column.second +
+				" WHERE id = " + value + "), " + value + ")");
+		}
+
+		if (!negations.empty())
 		{
-			id = checkQuery.getIntField(0, -1);
+			statements.push_back(
+				"UPDATE " + table + " SET " + utility::join(negations, ", ") + ";");
+		}
+		statements.push_back("UPDATE " + table + " SET " + utility::join(assignments, ", ") + ";");
+	};
+
+	const std::string e = "stable_element_id";
+	mapColumns("element", {{"id", e}}, {});
+	mapColumns("node", {{"id", e}}, {});
+	mapColumns("symbol", {{"id", e}}, {});
+	mapColumns("file", {{"id", e}}, {});
+	mapColumns("content", {{"id", "stable_content_id"}}, {});
+	mapColumns("filecontent", {{"id", e}}, {{"content_id", "stable_content_id"}});
+	mapColumns("file_hash", {{"id", e}}, {});
+	mapColumns("fulltext_index", {{"id", e}}, {});
+	mapColumns("search_name", {{"node_id", e}}, {});
+	mapColumns("component_access", {{"node_id", e}}, {});
+	mapColumns("edge", {{"id", e}}, {{"source_node_id", e}, {"target_node_id", e}});
+	mapColumns("local_symbol", {{"id", e}}, {{"file_node_id", e}});
+	mapColumns("error", {{"id", e}}, {});
+	mapColumns("source_location", {{"id", "stable_location_id"}}, {{"file_node_id", e}});
+	mapColumns("occurrence", {{"element_id", e}, {"source_location_id", "stable_location_id"}}, {});
+	mapColumns("element_component", {{"id", "stable_component_id"}}, {{"element_id", e}});
+
+	// derived from the ids, they are built again in read mode or by the next buildCaches
+	statements.push_back("DELETE FROM source_location_pack;");
+	statements.push_back("DELETE FROM node_file;");
+	statements.push_back("DELETE FROM search_index;");
+
+	statements.push_back("DROP TABLE stable_element_id;");
+	statements.push_back("DROP TABLE stable_location_id;");
+	statements.push_back("DROP TABLE stable_content_id;");
+	statements.push_back("DROP TABLE stable_component_id;");
+
+	bool success = true;
+	for (const std::string& statement: statements)
+	{
+		if (!executeStatement(statement))
+		{
+			success = false;
+			break;
 		}
-		m_checkErrorExistsStmt.reset();
 	}
 
-	if (id == 0)
+	if (success)
 	{
-		executeStatement(m_insertElementStmt);
-		id = m_database.lastRowId();
-
-		m_insertErrorStmt.bind(1, int(id));
-		m_insertErrorStmt.bind(2, utility::encodeToUtf8(sanitizedMessage).c_str());
-		m_insertErrorStmt.bind(3, data.fatal);
-		m_insertErrorStmt.bind(4, data.indexed);
-		m_insertErrorStmt.bind(5, utility::encodeToUtf8(data.translationUnit).c_str());
-
-		const bool success = executeStatement(m_insertErrorStmt);
-		if (success)
-		{
-			id = m_database.lastRowId();
-		}
+		insertOrUpdateMetaValue("source_location_packs", "");
+		insertOrUpdateMetaValue("node_files", "");
+		commitTransaction();
+	}
+	else
+	{
+		LOG_ERROR("The ids of the index database could not be made stable.");
+		rollbackTransaction();
 	}
+	executeStatement("PRAGMA foreign_keys=ON;");
 
-	return StorageError(id, data);
+	clearTempIndices();
 }
 
 void SqliteIndexStorage::removeElement(Id id)
@@ -461,8 +1565,8 @@ void SqliteIndexStorage::removeElement(Id id)
 
 void SqliteIndexStorage::removeElements(const std::vector<Id>& ids)
 {
-	executeStatement(
-		"DELETE FROM element WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ");");
+	const IdList idList(this, ids);
+	executeStatement("DELETE FROM element WHERE id IN " + idList.getQuery() + ";");
 }
 
 void SqliteIndexStorage::removeOccurrence(const StorageOccurrence& occurrence)
@@ -482,150 +1586,117 @@ void SqliteIndexStorage::removeOccurrences(const std::vector<StorageOccurrence>&
 
 void SqliteIndexStorage::removeElementsWithoutOccurrences(const std::vector<Id>& elementIds)
 {
+	const IdList idList(this, elementIds);
 	executeStatement(
-		"DELETE FROM element WHERE id IN (" + utility::join(utility::toStrings(elementIds), ',') +
-		") AND id NOT IN (SELECT element_id FROM occurrence);");
+		"DELETE FROM element WHERE id IN " + idList.getQuery() +
+		" AND id NOT IN (SELECT element_id FROM occurrence);");
 }
 
 void SqliteIndexStorage::removeElementsWithLocationInFiles(
 	const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback)
 {
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(1);
-	}
-
-	// preparing
-	executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(2);
-	}
-
+	auto updateStatus = [&updateStatusCallback](int progress) {
+		if (updateStatusCallback != nullptr)
+		{
+			updateStatusCallback(progress);
+		}
+	};
+
+	// The files own their source locations by file_node_id, so all rows are found through the
+	// indices of the clear mode starting from there and the cost depends on the rows of the
+	// cleared files, not on the size of the database. The temp table is not written to the
+	// journal of the database.
+	updateStatus(1);
+	const IdList fileIdList(this, fileIds);
+	executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
 	executeStatement(
-		"CREATE TABLE IF NOT EXISTS element_id_to_clear("
+		"CREATE TEMP TABLE element_id_to_clear("
 		"id INTEGER NOT NULL, "
 		"PRIMARY KEY(id));");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(3);
-	}
-
-	// store ids of all elements located in fileIds into element_id_to_clear
-	executeStatement(
-		"INSERT INTO element_id_to_clear "
-		"	SELECT occurrence.element_id "
-		"	FROM occurrence "
-		"	INNER JOIN source_location ON ("
-		"		occurrence.source_location_id = source_location.id"
-		"	) "
-		"	WHERE source_location.file_node_id IN (" +
-		utility::join(utility::toStrings(fileIds), ',') +
-		")"
-		"	GROUP BY (occurrence.element_id)");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(4);
-	}
-
-	// delete all edges in element_id_to_clear
+	// all elements located in the files
+	updateStatus(3);
 	executeStatement(
-		"DELETE FROM element WHERE element.id IN "
-		"	(SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN edge ON "
-		"(element_id_to_clear.id = edge.id))");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(30);
-	}
-
-	// delete all edges originating from element_id_to_clear
+		"INSERT OR IGNORE INTO temp.element_id_to_clear "
+		"SELECT occurrence.element_id FROM source_location "
+		"INNER JOIN occurrence ON occurrence.source_location_id = source_location.id "
+		"WHERE source_location.file_node_id IN " +
+		fileIdList.getQuery() + ";");
+
+	// edges located in the files and edges originating from elements located in them
+	updateStatus(4);
 	executeStatement(
-		"DELETE FROM element WHERE element.id IN (SELECT id FROM edge WHERE source_node_id IN "
-		"(SELECT id FROM element_id_to_clear))");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(31);
-	}
-
-	// remove all non existing ids from element_id_to_clear (they have been cleared by now and we
-	// can disregard them)
+		"DELETE FROM element WHERE id IN ("
+		"SELECT edge.id FROM temp.element_id_to_clear c INNER JOIN edge ON edge.id = c.id "
+		"UNION "
+		"SELECT edge.id FROM temp.element_id_to_clear c "
+		"INNER JOIN edge ON edge.source_node_id = c.id);");
+
+	// also deletes the occurrences of the source locations
+	updateStatus(34);
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id NOT IN ("
-		"	SELECT id FROM element"
-		")");
+		"DELETE FROM source_location WHERE file_node_id IN " + fileIdList.getQuery() + ";");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(33);
-	}
-
-	// remove all files from element_id_to_clear (they will be cleared later)
+	// files are removed by the caller, and elements that are still used elsewhere are kept. All
+	// of them are checked by one statement probing the indices for each listed element.
+	updateStatus(45);
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT id FROM file"
-		")");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(34);
-	}
+		"DELETE FROM temp.element_id_to_clear WHERE "
+		"EXISTS (SELECT * FROM file WHERE file.id = element_id_to_clear.id) "
+		"OR EXISTS (SELECT * FROM occurrence WHERE occurrence.element_id = element_id_to_clear.id) "
+		"OR EXISTS (SELECT * FROM edge WHERE edge.target_node_id = element_id_to_clear.id);");
 
-	// delete source locations from fileIds (this also deletes the respective occurrences)
-	executeStatement(
-		"DELETE FROM source_location WHERE file_node_id IN (" +
-		utility::join(utility::toStrings(fileIds), ',') + ");");
+	updateStatus(74);
+	executeStatement("DELETE FROM element WHERE id IN (SELECT id FROM temp.element_id_to_clear);");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(45);
-	}
+	updateStatus(87);
+	executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
 
-	// remove all ids from element_id_to_clear that still have occurrences
-	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN occurrence ON "
-		"		element_id_to_clear.id = occurrence.element_id"
-		")");
+	updateStatus(89);
+}
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(59);
-	}
+void SqliteIndexStorage::startRecordingChanges()
+{
+	stopRecordingChanges();
 
-	// remove all ids from element_id_to_clear that still have an edge pointing to them
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT target_node_id FROM edge"
-		")");
+		"CREATE TEMP TABLE changed_element("
+		"id INTEGER NOT NULL, "
+		"PRIMARY KEY(id));");
 
-	if (updateStatusCallback != nullptr)
+	const std::vector<ChangeTrigger> triggers = getChangeTriggers();
+	for (size_t i = 0; i < triggers.size(); i++)
 	{
-		updateStatusCallback(74);
+		std::string statement = "CREATE TEMP TRIGGER record_change_" + std::to_string(i) + " " +
+			triggers[i].first + " BEGIN ";
+		for (const std::string& id: triggers[i].second)
+		{
+			statement += "INSERT OR IGNORE INTO changed_element VALUES (" + id + "); ";
+		}
+		executeStatement(statement + "END;");
 	}
+}
 
-	// delete all elements that are still listed in element_id_to_clear
-	executeStatement(
-		"DELETE FROM element WHERE EXISTS ("
-		"	SELECT * FROM element_id_to_clear WHERE element.id = element_id_to_clear.id"
-		")");
+std::vector<Id> SqliteIndexStorage::getRecordedChangedElementIds() const
+{
+	std::vector<Id> ids;
+	forEachRow<Id>(
+		"SELECT id FROM temp.changed_element;", [&ids](Id id) { ids.push_back(id); });
+	return ids;
+}
 
-	if (updateStatusCallback != nullptr)
+void SqliteIndexStorage::stopRecordingChanges()
+{
+	for (size_t i = 0; i < getChangeTriggers().size(); i++)
 	{
-		updateStatusCallback(87);
+		executeStatement("DROP TRIGGER IF EXISTS temp.record_change_" + std::to_string(i) + ";");
 	}
+	executeStatement("DROP TABLE IF EXISTS temp.changed_element;");
+}
 
-	// cleaning up
-	executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(89);
-	}
+void SqliteIndexStorage::removeUnreferencedFileContents()
+{
+	executeStatement("DELETE FROM content WHERE reference_count <= 0;");
 }
 
 void SqliteIndexStorage::removeAllErrors()
@@ -688,8 +1759,9 @@ std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceId(Id sourceId) con
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceIds(const std::vector<Id>& sourceIds) const
 {
+	const IdList idList(this, sourceIds);
 	return doGetAll<StorageEdge>(
-		"WHERE source_node_id IN (" + utility::join(utility::toStrings(sourceIds), ',') + ")");
+		"WHERE source_node_id IN " + idList.getQuery());
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetId(Id targetId) const
@@ -699,8 +1771,9 @@ std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetId(Id targetId) con
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetIds(const std::vector<Id>& targetIds) const
 {
+	const IdList idList(this, targetIds);
 	return doGetAll<StorageEdge>(
-		"WHERE target_node_id IN (" + utility::join(utility::toStrings(targetIds), ',') + ")");
+		"WHERE target_node_id IN " + idList.getQuery());
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceOrTargetId(Id id) const
@@ -725,11 +1798,9 @@ std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceType(Id sourceId, i
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourcesType(
 	const std::vector<Id>& sourceIds, int type) const
 {
+	const IdList idList(this, sourceIds);
 	return doGetAll<StorageEdge>(
-		"WHERE source_node_id IN (" + utility::join(utility::toStrings(sourceIds), ',') +
-		")"
-		" AND type == " +
-		std::to_string(type));
+		"WHERE source_node_id IN " + idList.getQuery() + " AND type == " + std::to_string(type));
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetType(Id targetId, int type) const
@@ -742,11 +1813,9 @@ std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetType(Id targetId, i
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetsType(
 	const std::vector<Id>& targetIds, int type) const
 {
+	const IdList idList(this, targetIds);
 	return doGetAll<StorageEdge>(
-		"WHERE target_node_id IN (" + utility::join(utility::toStrings(targetIds), ',') +
-		")"
-		" AND type == " +
-		std::to_string(type));
+		"WHERE target_node_id IN " + idList.getQuery() + " AND type == " + std::to_string(type));
 }
 
 StorageNode SqliteIndexStorage::getNodeById(Id id) const
@@ -761,12 +1830,12 @@ StorageNode SqliteIndexStorage::getNodeById(Id id) const
 	return StorageNode();
 }
 
-StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::wstring& serializedName) const
+StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::string& serializedName) const
 {
 	CppSQLite3Statement stmt = m_database.compileStatement(
 		"SELECT id, type, serialized_name FROM node WHERE serialized_name == ? LIMIT 1;");
 
-	stmt.bind(1, utility::encodeToUtf8(serializedName).c_str());
+	stmt.bind(1, serializedName.c_str());
 	CppSQLite3Query q = executeQuery(stmt);
 
 	if (!q.eof())
@@ -777,7 +1846,7 @@ StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::wstring& seri
 
 		if (id != 0 && type != -1)
 		{
-			return StorageNode(id, type, utility::decodeFromUtf8(name));
+			return StorageNode(id, type, name);
 		}
 	}
 
@@ -786,83 +1855,404 @@ StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::wstring& seri
 	return StorageNode();
 }
 
+std::vector<StorageNode> SqliteIndexStorage::getNodesBySerializedNames(
+	const std::vector<std::string>& serializedNames) const
+{
+	std::vector<StorageNode> nodes;
+
+	// sqlite allows no more than 999 bound variables per statement
+	const size_t batchSize = 999;
+	for (size_t i = 0; i < serializedNames.size(); i += batchSize)
+	{
+		const size_t count = std::min(batchSize, serializedNames.size() - i);
+		CppSQLite3Statement stmt = m_database.compileStatement(
+			("SELECT id, type, serialized_name FROM node WHERE serialized_name IN (" +
+			 utility::join(std::vector<std::string>(count, "?"), ',') + ");")
+				.c_str());
+
+		for (size_t j = 0; j < count; j++)
+		{
+			stmt.bind(int(j + 1), serializedNames[i + j].c_str());
+		}
+
+		CppSQLite3Query q = executeQuery(stmt);
+		while (!q.eof())
+		{
+			const Id id = q.getIntField(0, 0);
+			const int type = q.getIntField(1, -1);
+			const std::string name = q.getStringField(2, "");
+
+			if (id != 0 && type != -1)
+			{
+				nodes.emplace_back(id, type, name);
+			}
+
+			q.nextRow();
+		}
+
+		stmt.reset();
+	}
+
+	return nodes;
+}
+
 std::vector<int> SqliteIndexStorage::getAvailableNodeTypes() const
 {
-	CppSQLite3Query q = executeQuery("SELECT DISTINCT type FROM node;");
+	if (hasAggregates())
+	{
+		return splitTypes(getMetaValue("aggregate_node_types"));
+	}
+	return queryAvailableTypes("node");
+}
+
+std::vector<int> SqliteIndexStorage::getAvailableEdgeTypes() const
+{
+	if (hasAggregates())
+	{
+		return splitTypes(getMetaValue("aggregate_edge_types"));
+	}
+	return queryAvailableTypes("edge");
+}
 
-	std::vector<int> types;
+StorageFile SqliteIndexStorage::getFileByPath(const std::wstring& filePath) const
+{
+	return doGetFirst<StorageFile>("WHERE file.path == '" + utility::encodeToUtf8(filePath) + "'");
+}
+
+std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<FilePath>& filePaths) const
+{
+	return doGetAll<StorageFile>(
+		"WHERE file.path IN ('" + utility::join(utility::toStrings(filePaths), "', '") + "')");
+}
+
+std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) const
+{
+	CppSQLite3Query q = executeQuery(
+		"SELECT content.content FROM filecontent "
+		"INNER JOIN content ON content.id = filecontent.content_id "
+		"WHERE filecontent.id = " +
+		std::to_string(fileId) + ";");
+	if (!q.eof())
+	{
+		return TextAccess::createFromString(getFileContent(q, 0));
+	}
+
+	return TextAccess::createFromString("");
+}
+
+std::string SqliteIndexStorage::getFileContentHash(Id fileId) const
+{
+	CppSQLite3Query q = executeQuery(
+		"SELECT content_hash FROM file_hash WHERE id = " + std::to_string(fileId) + ";");
+	if (!q.eof())
+	{
+		return q.getStringField(0, "");
+	}
+	return "";
+}
+
+std::string SqliteIndexStorage::getFileCodeHash(Id fileId) const
+{
+	CppSQLite3Query q = executeQuery(
+		"SELECT code_hash FROM file_hash WHERE id = " + std::to_string(fileId) + ";");
+	if (!q.eof())
+	{
+		return q.getStringField(0, "");
+	}
+	return "";
+}
+
+std::map<std::wstring, std::string> SqliteIndexStorage::getAllFileContentHashes() const
+{
+	std::map<std::wstring, std::string> hashes;
 
+	CppSQLite3Query q = executeQuery(
+		"SELECT file.path, file_hash.content_hash FROM file_hash "
+		"JOIN file ON file.id = file_hash.id;");
 	while (!q.eof())
 	{
-		const int type = q.getIntField(0, -1);
-		if (type != -1)
+		hashes.emplace(
+			utility::decodeFromUtf8(q.getStringField(0, "")), q.getStringField(1, ""));
+		q.nextRow();
+	}
+
+	return hashes;
+}
+
+void SqliteIndexStorage::updateFileContent(
+	Id fileId, const std::string& content, const std::string& modificationTime)
+{
+	const std::string id = std::to_string(fileId);
+	const std::string contentHash = TextLayoutMapping::getContentHash(content);
+
+	// an unchanged content is not written again and keeps its full text search data
+	if (getFileContentHash(fileId) != contentHash ||
+		getFileContentById(fileId)->getText() != content)
+	{
+		executeStatement("DELETE FROM fulltext_index WHERE id = " + id + ";");
+		executeStatement("DELETE FROM filecontent WHERE id = " + id + ";");
+		executeStatement("DELETE FROM file_hash WHERE id = " + id + ";");
+
+		addFileContent(fileId, content, contentHash);
+
+		m_insertFileHashStmt.bind(1, int(fileId));
+		m_insertFileHashStmt.bind(2, contentHash.c_str());
+		m_insertFileHashStmt.bind(3, TextLayoutMapping::getCodeHash(content).c_str());
+		executeStatement(m_insertFileHashStmt);
+	}
+
+	executeStatement(
+		"UPDATE file SET modification_time = '" + modificationTime + "', line_count = " +
+		std::to_string(TextAccess::createFromString(content)->getLineCount()) + " WHERE id = " + id +
+		";");
+
+	// the content is also replaced in read mode
+	if (hasAggregates())
+	{
+		StorageStats stats = getStorageStats();
+		stats.fileLOCCount = getFileLineSum();
+		setAggregateStats(stats);
+	}
+}
+
+void SqliteIndexStorage::updateSourceLocationPositions(
+	const std::vector<StorageSourceLocation>& locations)
+{
+	for (const StorageSourceLocation& location: locations)
+	{
+		m_updateSourceLocationStmt.bind(1, int(location.startLine));
+		m_updateSourceLocationStmt.bind(2, int(location.startCol));
+		m_updateSourceLocationStmt.bind(3, int(location.endLine));
+		m_updateSourceLocationStmt.bind(4, int(location.endCol));
+		m_updateSourceLocationStmt.bind(5, int(location.id));
+		executeStatement(m_updateSourceLocationStmt);
+	}
+
+	if (!hasSourceLocationPacks())
+	{
+		return;
+	}
+
+	std::map<Id, std::map<Id, const StorageSourceLocation*>> locationsByFileId;
+	for (const StorageSourceLocation& location: locations)
+	{
+		locationsByFileId[location.fileNodeId][location.id] = &location;
+	}
+
+	for (const auto& p: locationsByFileId)
+	{
+		std::vector<StorageSourceLocation> packedLocations;
+		if (!getSourceLocationPack(p.first, &packedLocations))
 		{
-			types.push_back(type);
+			continue;
 		}
 
-		q.nextRow();
+		for (StorageSourceLocation& packedLocation: packedLocations)
+		{
+			auto it = p.second.find(packedLocation.id);
+			if (it != p.second.end())
+			{
+				packedLocation = *it->second;
+			}
+		}
+		setSourceLocationPack(p.first, packedLocations);
 	}
+}
 
-	return types;
+std::vector<StorageSourceLocation> SqliteIndexStorage::getSourceLocationsByFileId(Id fileId) const
+{
+	std::vector<StorageSourceLocation> locations;
+	if (!getSourceLocationPack(fileId, &locations))
+	{
+		locations = doGetAll<StorageSourceLocation>(
+			"WHERE file_node_id == " + std::to_string(fileId));
+	}
+	return locations;
 }
 
-std::vector<int> SqliteIndexStorage::getAvailableEdgeTypes() const
+std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::wstring& filePath) const
 {
-	CppSQLite3Query q = executeQuery("SELECT DISTINCT type FROM edge;");
+	try
+	{
+		CppSQLite3Query q = executeQuery(
+			"SELECT content.content "
+			"FROM filecontent "
+			"INNER JOIN file ON filecontent.id = file.id "
+			"INNER JOIN content ON content.id = filecontent.content_id "
+			"WHERE file.path = '" +
+			utility::encodeToUtf8(filePath) + "';");
 
-	std::vector<int> types;
+		if (!q.eof())
+		{
+			return TextAccess::createFromString(getFileContent(q, 0));
+		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
 
-	while (!q.eof())
+	return TextAccess::createFromString("");
+}
+
+void SqliteIndexStorage::addFullTextSearchIndexData(
+	Id fileId, const std::string& codecName, const std::string& serializedArrays)
+{
+	m_insertFullTextSearchIndexStmt.bind(1, int(fileId));
+	m_insertFullTextSearchIndexStmt.bind(2, codecName.c_str());
+	m_insertFullTextSearchIndexStmt.bind(
+		3,
+		reinterpret_cast<const unsigned char*>(serializedArrays.data()),
+		int(serializedArrays.size()));
+	executeStatement(m_insertFullTextSearchIndexStmt);
+}
+
+std::string SqliteIndexStorage::getFullTextSearchIndexDataById(
+	Id fileId, const std::string& codecName) const
+{
+	try
 	{
-		const int type = q.getIntField(0, -1);
-		if (type != -1)
+		CppSQLite3Query q = executeQuery(
+			"SELECT data FROM fulltext_index WHERE id = " + std::to_string(fileId) +
+			" AND codec = '" + codecName + "';");
+		if (!q.eof())
 		{
-			types.push_back(type);
+			int length = 0;
+			const unsigned char* data = q.getBlobField(0, length);
+			if (data && length > 0)
+			{
+				return std::string(reinterpret_cast<const char*>(data), length);
+			}
 		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
 
-		q.nextRow();
+	return "";
+}
+
+void SqliteIndexStorage::setSearchIndexData(const std::string& name, const std::string& data)
+{
+	m_insertSearchIndexStmt.bind(1, name.c_str());
+	m_insertSearchIndexStmt.bind(
+		2, reinterpret_cast<const unsigned char*>(data.data()), int(data.size()));
+	executeStatement(m_insertSearchIndexStmt);
+}
+
+std::string SqliteIndexStorage::getSearchIndexData(const std::string& name) const
+{
+	try
+	{
+		CppSQLite3Query q = executeQuery(
+			"SELECT data FROM search_index WHERE name = '" + name + "';");
+		if (!q.eof())
+		{
+			int length = 0;
+			const unsigned char* data = q.getBlobField(0, length);
+			if (data && length > 0)
+			{
+				return std::string(reinterpret_cast<const char*>(data), length);
+			}
+		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 	}
 
-	return types;
+	return "";
 }
 
-StorageFile SqliteIndexStorage::getFileByPath(const std::wstring& filePath) const
+void SqliteIndexStorage::clearSearchIndexData()
 {
-	return doGetFirst<StorageFile>("WHERE file.path == '" + utility::encodeToUtf8(filePath) + "'");
+	executeStatement("DELETE FROM search_index;");
+	executeStatement("DELETE FROM search_name;");
 }
 
-std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<FilePath>& filePaths) const
+void SqliteIndexStorage::addSearchName(
+	Id nodeId, int nodeType, uint32_t referenceCount, const std::wstring& name)
 {
-	return doGetAll<StorageFile>(
-		"WHERE file.path IN ('" + utility::join(utility::toStrings(filePaths), "', '") + "')");
+	m_insertSearchNameStmt.bind(1, int(nodeId));
+	m_insertSearchNameStmt.bind(2, nodeType);
+	m_insertSearchNameStmt.bind(3, int(referenceCount));
+	m_insertSearchNameStmt.bind(4, utility::encodeToUtf8(name).c_str());
+	executeStatement(m_insertSearchNameStmt);
 }
 
-std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) const
+bool SqliteIndexStorage::hasSearchNames() const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT content FROM filecontent WHERE id = '" + std::to_string(fileId) + "';");
-	if (!q.eof())
+	return executeStatementScalar("SELECT EXISTS(SELECT 1 FROM search_name);", 0) != 0;
+}
+
+void SqliteIndexStorage::forEachSearchName(
+	const std::string& likePattern,
+	NodeType::TypeMask nodeTypes,
+	size_t maxCount,
+	const std::function<void(Id, int, uint32_t, std::wstring&&)>& func) const
+{
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+		"SELECT node_id, type, reference_count, name FROM search_name "
+		"WHERE name LIKE ? AND (type & ?) != 0 ORDER BY reference_count DESC LIMIT ?;");
+	statement.get().bind(1, likePattern.c_str());
+	statement.get().bind(2, int(nodeTypes));
+	statement.get().bind(3, int(maxCount));
+
+	try
+	{
+		CppSQLite3Query q = executeQuery(statement);
+		while (!q.eof())
+		{
+			func(
+				Id(q.getInt64Field(0, 0)),
+				q.getIntField(1, 0),
+				uint32_t(q.getIntField(2, 0)),
+				utility::decodeFromUtf8(q.getStringField(3, "")));
+			q.nextRow();
+		}
+	}
+	catch (CppSQLite3Exception& e)
 	{
-		return TextAccess::createFromString(q.getStringField(0, ""));
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 	}
+}
 
-	return TextAccess::createFromString("");
+void SqliteIndexStorage::addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes)
+{
+	for (const StorageIndexingTime& indexingTime: indexingTimes)
+	{
+		m_insertIndexingTimeStmt.bind(1, utility::encodeToUtf8(indexingTime.filePath).c_str());
+		m_insertIndexingTimeStmt.bind(2, int(indexingTime.durationMs));
+		m_insertIndexingTimeStmt.bind(3, int(indexingTime.parseDurationMs));
+		m_insertIndexingTimeStmt.bind(4, int(indexingTime.visitDurationMs));
+		m_insertIndexingTimeStmt.bind(5, int(indexingTime.peakMemoryKb));
+		m_insertIndexingTimeStmt.bind(6, int(indexingTime.storageByteCount));
+		m_insertIndexingTimeStmt.bind(7, int(indexingTime.garbageCollectionDurationMs));
+		executeStatement(m_insertIndexingTimeStmt);
+	}
 }
 
-std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::wstring& filePath) const
+std::vector<StorageIndexingTime> SqliteIndexStorage::getIndexingTimes() const
 {
+	std::vector<StorageIndexingTime> indexingTimes;
+
 	try
 	{
 		CppSQLite3Query q = executeQuery(
-			"SELECT filecontent.content "
-			"FROM filecontent "
-			"INNER JOIN file ON filecontent.id = file.id "
-			"WHERE file.path = '" +
-			utility::encodeToUtf8(filePath) + "';");
-
-		if (!q.eof())
+			"SELECT path, duration_ms, parse_duration_ms, visit_duration_ms, peak_memory_kb, "
+			"storage_byte_count, gc_duration_ms FROM indexing_time;");
+		while (!q.eof())
 		{
-			return TextAccess::createFromString(q.getStringField(0, ""));
+			indexingTimes.emplace_back(
+				utility::decodeFromUtf8(q.getStringField(0, "")),
+				size_t(q.getInt64Field(1, 0)),
+				size_t(q.getInt64Field(2, 0)),
+				size_t(q.getInt64Field(3, 0)),
+				size_t(q.getInt64Field(4, 0)),
+				size_t(q.getInt64Field(5, 0)),
+				size_t(q.getInt64Field(6, 0)));
+			q.nextRow();
 		}
 	}
 	catch (CppSQLite3Exception& e)
@@ -870,7 +2260,26 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
 		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 	}
 
-	return TextAccess::createFromString("");
+	return indexingTimes;
+}
+
+std::set<Id> SqliteIndexStorage::getFileIdsWithFullTextSearchIndexData(const std::string& codecName) const
+{
+	std::set<Id> fileIds;
+
+	CppSQLite3Query q = executeQuery(
+		"SELECT id FROM fulltext_index WHERE codec = '" + codecName + "';");
+	while (!q.eof())
+	{
+		const Id id = q.getIntField(0, 0);
+		if (id != 0)
+		{
+			fileIds.insert(id);
+		}
+		q.nextRow();
+	}
+
+	return fileIds;
 }
 
 void SqliteIndexStorage::setFileIndexed(Id fileId, bool indexed)
@@ -902,7 +2311,13 @@ void SqliteIndexStorage::setNodeType(int type, Id nodeId)
 }
 
 std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFile(
-	const FilePath& filePath, const std::string& query) const
+	const FilePath& filePath) const
+{
+	return getSourceLocationsForFile(filePath, nullptr);
+}
+
+std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFile(
+	const FilePath& filePath, std::function<bool(const StorageSourceLocation&)> filter) const
 {
 	std::shared_ptr<SourceLocationFile> ret = std::make_shared<SourceLocationFile>(
 		filePath, L"", true, false, false);
@@ -917,8 +2332,16 @@ std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFil
 	ret->setIsComplete(file.complete);
 	ret->setIsIndexed(file.indexed);
 
-	std::vector<StorageSourceLocation> sourceLocations = doGetAll<StorageSourceLocation>(
-		"WHERE file_node_id == " + std::to_string(file.id) + " " + query);
+	std::vector<StorageSourceLocation> sourceLocations = getSourceLocationsByFileId(file.id);
+	if (filter)
+	{
+		sourceLocations.erase(
+			std::remove_if(
+				sourceLocations.begin(),
+				sourceLocations.end(),
+				[&filter](const StorageSourceLocation& location) { return !filter(location); }),
+			sourceLocations.end());
+	}
 
 	std::vector<Id> sourceLocationIds;
 	sourceLocationIds.reserve(sourceLocations.size());
@@ -954,16 +2377,19 @@ std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForLin
 	const FilePath& filePath, size_t startLine, size_t endLine) const
 {
 	return getSourceLocationsForFile(
-		filePath,
-		"AND start_line <= " + std::to_string(endLine) +
-			" AND end_line >= " + std::to_string(startLine));
+		filePath, [startLine, endLine](const StorageSourceLocation& location) {
+			return location.startLine <= endLine && location.endLine >= startLine;
+		});
 }
 
 std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsOfTypeInFile(
 	const FilePath& filePath, LocationType type) const
 {
+	const int typeInt = locationTypeToInt(type);
 	return getSourceLocationsForFile(
-		filePath, "AND type == " + std::to_string(locationTypeToInt(type)));
+		filePath, [typeInt](const StorageSourceLocation& location) {
+			return location.type == typeInt;
+		});
 }
 
 std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocationsForElementIds(
@@ -977,13 +2403,15 @@ std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocations
 		sourceLocationIdToElementIds[occurrence.sourceLocationId].push_back(occurrence.elementId);
 	}
 
-	CppSQLite3Query q = executeQuery(
+	const IdList idList(this, sourceLocationIds);
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
 		"SELECT source_location.id, file.path, source_location.start_line, "
 		"source_location.start_column, "
 		"source_location.end_line, source_location.end_column, source_location.type "
 		"FROM source_location INNER JOIN file ON (file.id = source_location.file_node_id) "
-		"WHERE source_location.id IN (" +
-		utility::join(utility::toStrings(sourceLocationIds), ',') + ");");
+		"WHERE source_location.id IN " +
+		idList.getQuery() + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	std::shared_ptr<SourceLocationCollection> ret = std::make_shared<SourceLocationCollection>();
 
@@ -1017,6 +2445,150 @@ std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocations
 	return ret;
 }
 
+size_t SqliteIndexStorage::getSourceLocationFileCountForElementIds(
+	const std::vector<Id>& elementIds, size_t* referenceCount) const
+{
+	const IdList elementIdList(this, elementIds);
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+		"SELECT COUNT(DISTINCT source_location.file_node_id), "
+		"SUM(source_location.type != " +
+		std::to_string(locationTypeToInt(LOCATION_SCOPE)) +
+		") "
+		"FROM occurrence "
+		"INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
+		"INNER JOIN file ON (file.id = source_location.file_node_id) "
+		"WHERE occurrence.element_id IN " +
+		elementIdList.getQuery() + " AND source_location.type IN " +
+		getPagedLocationTypesQuery() + ";");
+	CppSQLite3Query q = executeQuery(statement);
+
+	size_t fileCount = 0;
+	if (!q.eof())
+	{
+		fileCount = size_t(q.getIntField(0, 0));
+		if (referenceCount)
+		{
+			*referenceCount = size_t(q.getIntField(1, 0));
+		}
+	}
+	return fileCount;
+}
+
+std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocationsPageForElementIds(
+	const std::vector<Id>& elementIds, FilePath* cursor, size_t fileCount) const
+{
+	std::shared_ptr<SourceLocationCollection> ret = std::make_shared<SourceLocationCollection>();
+
+	const IdList elementIdList(this, elementIds);
+
+	// the paths are compared as text, so the next page starts right after the last path
+	std::vector<Id> fileIds;
+	std::map<Id, FilePath> filePaths;
+	{
+		SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+			"SELECT file.id, file.path FROM file WHERE file.path > :cursor_path AND file.id IN "
+			"(SELECT source_location.file_node_id FROM occurrence "
+			"INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
+			"WHERE occurrence.element_id IN " +
+			elementIdList.getQuery() + " AND source_location.type IN " +
+			getPagedLocationTypesQuery() + ") ORDER BY file.path LIMIT " +
+			std::to_string(fileCount) + ";");
+		const std::string cursorPath = utility::encodeToUtf8(cursor->wstr());
+		statement.get().bind(
+			statement.get().bindParameterIndex(":cursor_path"), cursorPath.c_str());
+		CppSQLite3Query q = executeQuery(statement);
+
+		while (!q.eof())
+		{
+			const Id id = q.getIntField(0, 0);
+			const std::string filePath = q.getStringField(1, "");
+			if (id != 0 && filePath.size())
+			{
+				fileIds.push_back(id);
+				filePaths.emplace(id, FilePath(utility::decodeFromUtf8(filePath)));
+				*cursor = filePaths[id];
+			}
+
+			q.nextRow();
+		}
+	}
+
+	if (fileIds.empty())
+	{
+		return ret;
+	}
+
+	const IdList fileIdList(this, fileIds);
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+		"SELECT source_location.id, source_location.file_node_id, source_location.start_line, "
+		"source_location.start_column, source_location.end_line, source_location.end_column, "
+		"source_location.type, occurrence.element_id "
+		"FROM occurrence "
+		"INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
+		"WHERE occurrence.element_id IN " +
+		elementIdList.getQuery() + " AND source_location.file_node_id IN " +
+		fileIdList.getQuery() + " AND source_location.type IN " + getPagedLocationTypesQuery() +
+		" ORDER BY source_location.id;");
+	CppSQLite3Query q = executeQuery(statement);
+
+	// rows of the same location follow each other, one for each of its elements
+	std::vector<Id> locationElementIds;
+	StorageSourceLocation location;
+	const auto addLocation = [&]() {
+		if (location.id != 0)
+		{
+			ret->addSourceLocation(
+				intToLocationType(location.type),
+				location.id,
+				locationElementIds,
+				filePaths[location.fileNodeId],
+				location.startLine,
+				location.startCol,
+				location.endLine,
+				location.endCol);
+		}
+		locationElementIds.clear();
+	};
+
+	while (!q.eof())
+	{
+		const Id id = q.getIntField(0, 0);
+		if (id != location.id)
+		{
+			addLocation();
+			location = StorageSourceLocation(
+				id,
+				q.getIntField(1, 0),
+				q.getIntField(2, -1),
+				q.getIntField(3, -1),
+				q.getIntField(4, -1),
+				q.getIntField(5, -1),
+				q.getIntField(6, -1));
+		}
+		locationElementIds.push_back(q.getIntField(7, 0));
+
+		q.nextRow();
+	}
+	addLocation();
+
+	return ret;
+}
+
+bool SqliteIndexStorage::getFileNodeIdsOfNodes(
+	const std::vector<Id>& nodeIds, std::map<Id, Id>* fileNodeIds) const
+{
+	if (!hasNodeFiles())
+	{
+		return false;
+	}
+
+	forEachRowByIds<Id, Id>(
+		nodeIds,
+		"SELECT node_id, file_node_id FROM node_file WHERE node_id IN",
+		[fileNodeIds](Id nodeId, Id fileNodeId) { fileNodeIds->emplace(nodeId, fileNodeId); });
+	return true;
+}
+
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationId(Id locationId) const
 {
 	std::vector<Id> locationIds {locationId};
@@ -1026,15 +2598,17 @@ std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationId(I
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationIds(
 	const std::vector<Id>& locationIds) const
 {
+	const IdList idList(this, locationIds);
 	return doGetAll<StorageOccurrence>(
-		"WHERE source_location_id IN (" + utility::join(utility::toStrings(locationIds), ',') + ")");
+		"WHERE source_location_id IN " + idList.getQuery());
 }
 
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForElementIds(
 	const std::vector<Id>& elementIds) const
 {
+	const IdList idList(this, elementIds);
 	return doGetAll<StorageOccurrence>(
-		"WHERE element_id IN (" + utility::join(utility::toStrings(elementIds), ',') + ")");
+		"WHERE element_id IN " + idList.getQuery());
 }
 
 StorageComponentAccess SqliteIndexStorage::getComponentAccessByNodeId(Id nodeId) const
@@ -1045,15 +2619,17 @@ StorageComponentAccess SqliteIndexStorage::getComponentAccessByNodeId(Id nodeId)
 std::vector<StorageComponentAccess> SqliteIndexStorage::getComponentAccessesByNodeIds(
 	const std::vector<Id>& nodeIds) const
 {
+	const IdList idList(this, nodeIds);
 	return doGetAll<StorageComponentAccess>(
-		"WHERE node_id IN (" + utility::join(utility::toStrings(nodeIds), ',') + ")");
+		"WHERE node_id IN " + idList.getQuery());
 }
 
 std::vector<StorageElementComponent> SqliteIndexStorage::getElementComponentsByElementIds(
 	const std::vector<Id>& elementIds) const
 {
+	const IdList idList(this, elementIds);
 	return doGetAll<StorageElementComponent>(
-		"WHERE element_id IN (" + utility::join(utility::toStrings(elementIds), ',') + ")");
+		"WHERE element_id IN " + idList.getQuery());
 }
 
 std::vector<ErrorInfo> SqliteIndexStorage::getAllErrorInfos() const
@@ -1063,10 +2639,11 @@ std::vector<ErrorInfo> SqliteIndexStorage::getAllErrorInfos() const
 	CppSQLite3Query q = executeQuery(
 		"SELECT error.id, error.message, error.fatal, error.indexed, error.translation_unit, "
 		"file.path, source_location.start_line, source_location.start_column "
-		"FROM occurrence "
-		"INNER JOIN error ON (error.id = occurrence.element_id) "
+		"FROM error "
+		"INNER JOIN occurrence ON (occurrence.element_id = error.id) "
 		"INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
-		"INNER JOIN file ON (file.id = source_location.file_node_id);");
+		"INNER JOIN file ON (file.id = source_location.file_node_id) "
+		"ORDER BY error.id, occurrence.source_location_id;");
 
 	std::map<Id, size_t> errorIdCount;
 
@@ -1113,6 +2690,100 @@ std::vector<ErrorInfo> SqliteIndexStorage::getAllErrorInfos() const
 	return errorInfos;
 }
 
+std::vector<ErrorInfo> SqliteIndexStorage::getErrorInfos(
+	const ErrorFilter& filter, const std::vector<Id>& fileIds) const
+{
+	std::unique_ptr<IdList> fileIdList;
+	std::string condition = getErrorFilterCondition(filter);
+	if (!fileIds.empty())
+	{
+		fileIdList = std::make_unique<IdList>(this, fileIds);
+		condition += " AND source_location.file_node_id IN " + fileIdList->getQuery();
+	}
+
+	// the occurrences of the same error with a smaller location id are counted for the id, as
+	// getAllErrorInfos does while walking them in order
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+		"SELECT error.id, error.message, error.fatal, error.indexed, error.translation_unit, "
+		"file.path, source_location.start_line, source_location.start_column, "
+		"(SELECT COUNT(*) FROM occurrence AS previous "
+		"WHERE previous.element_id = error.id AND "
+		"previous.source_location_id < occurrence.source_location_id) "
+		"FROM error "
+		"INNER JOIN occurrence ON (occurrence.element_id = error.id) "
+		"INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
+		"INNER JOIN file ON (file.id = source_location.file_node_id) "
+		"WHERE " + condition + " ORDER BY error.id, occurrence.source_location_id "
+		"LIMIT " + (filter.limit ? std::to_string(filter.limit) : "-1") +
+		" OFFSET " + std::to_string(filter.offset) + ";");
+	CppSQLite3Query q = executeQuery(statement);
+
+	std::vector<ErrorInfo> errorInfos;
+	while (!q.eof())
+	{
+		const Id id = q.getIntField(0, 0);
+		if (id != 0)
+		{
+			errorInfos.push_back(ErrorInfo(
+				id * 10000 + Id(q.getIntField(8, 0)),
+				utility::decodeFromUtf8(q.getStringField(1, "")),
+				utility::decodeFromUtf8(q.getStringField(5, "")),
+				q.getIntField(6, -1),
+				q.getIntField(7, -1),
+				utility::decodeFromUtf8(q.getStringField(4, "")),
+				q.getIntField(2, 0),
+				q.getIntField(3, 0)));
+		}
+
+		q.nextRow();
+	}
+
+	return errorInfos;
+}
+
+ErrorCountInfo SqliteIndexStorage::getErrorCountInfo(
+	const ErrorFilter& filter, const std::vector<Id>& fileIds) const
+{
+	std::unique_ptr<IdList> fileIdList;
+	std::string condition = getErrorFilterCondition(filter);
+	std::string join;
+	if (!fileIds.empty())
+	{
+		fileIdList = std::make_unique<IdList>(this, fileIds);
+		join = "INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) ";
+		condition += " AND source_location.file_node_id IN " + fileIdList->getQuery();
+	}
+
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+		"SELECT COUNT(*), SUM(error.fatal != 0) FROM error "
+		"INNER JOIN occurrence ON (occurrence.element_id = error.id) " +
+		join + "WHERE " + condition + ";");
+	CppSQLite3Query q = executeQuery(statement);
+
+	if (q.eof())
+	{
+		return ErrorCountInfo();
+	}
+	return ErrorCountInfo(size_t(q.getIntField(0, 0)), size_t(q.getIntField(1, 0)));
+}
+
+SqliteIndexStorage::RowCursor::RowCursor(
+	const SqliteIndexStorage* storage, const std::string& query)
+	: m_statement(storage->getCachedStatement(query))
+	, m_query(storage->executeQuery(m_statement))
+{
+}
+
+bool SqliteIndexStorage::RowCursor::atEnd() const
+{
+	return m_query.eof();
+}
+
+void SqliteIndexStorage::RowCursor::next()
+{
+	m_query.nextRow();
+}
+
 int SqliteIndexStorage::getNodeCount() const
 {
 	return executeStatementScalar("SELECT COUNT(*) FROM node;", 0);
@@ -1128,6 +2799,11 @@ int SqliteIndexStorage::getFileCount() const
 	return executeStatementScalar("SELECT COUNT(*) FROM file WHERE indexed = 1;", 0);
 }
 
+int SqliteIndexStorage::getFileContentCount() const
+{
+	return executeStatementScalar("SELECT COUNT(*) FROM content;", 0);
+}
+
 int SqliteIndexStorage::getCompletedFileCount() const
 {
 	return executeStatementScalar("SELECT COUNT(*) FROM file WHERE indexed = 1 AND complete = 1;", 0);
@@ -1149,28 +2825,61 @@ int SqliteIndexStorage::getErrorCount() const
 		"SELECT COUNT(*) FROM error INNER JOIN occurrence ON (error.id = occurrence.element_id);", 0);
 }
 
+StorageStats SqliteIndexStorage::getStorageStats() const
+{
+	StorageStats stats;
+
+	const std::vector<std::string> counts =
+		utility::splitToVector(getMetaValue("aggregate_counts"), ' ');
+	if (counts.size() == 5)
+	{
+		stats.nodeCount = std::strtoull(counts[0].c_str(), nullptr, 10);
+		stats.edgeCount = std::strtoull(counts[1].c_str(), nullptr, 10);
+		stats.fileCount = std::strtoull(counts[2].c_str(), nullptr, 10);
+		stats.completedFileCount = std::strtoull(counts[3].c_str(), nullptr, 10);
+		stats.fileLOCCount = std::strtoull(counts[4].c_str(), nullptr, 10);
+	}
+	else
+	{
+		stats = queryStorageStats();
+	}
+
+	stats.timestamp = getTime();
+	return stats;
+}
+
 std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices() const
 {
 	std::vector<std::pair<int, SqliteDatabaseIndex>> indices;
+	// cover the expansion of edges in both directions, the rowid id is part of every index
 	indices.push_back(std::make_pair(
-		STORAGE_MODE_CLEAR,
-		SqliteDatabaseIndex("edge_source_node_id_index", "edge(source_node_id)")));
+		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
+		SqliteDatabaseIndex(
+			"edge_source_type_target_index", "edge(source_node_id, type, target_node_id)")));
 	indices.push_back(std::make_pair(
-		STORAGE_MODE_CLEAR,
-		SqliteDatabaseIndex("edge_target_node_id_index", "edge(target_node_id)")));
+		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
+		SqliteDatabaseIndex(
+			"edge_target_type_source_index", "edge(target_node_id, type, source_node_id)")));
 	indices.push_back(std::make_pair(
 		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex("node_serialized_name_index", "node(serialized_name)")));
+	// the source location packs replace it in read mode
 	indices.push_back(std::make_pair(
-		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
+		STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex("source_location_file_node_id_index", "source_location(file_node_id)")));
 	indices.push_back(std::make_pair(
 		STORAGE_MODE_WRITE, SqliteDatabaseIndex("error_all_data_index", "error(message, fatal)")));
+	indices.push_back(std::make_pair(
+		STORAGE_MODE_READ,
+		SqliteDatabaseIndex("error_fatal_indexed_index", "error(fatal, indexed)")));
 	indices.push_back(
 		std::make_pair(STORAGE_MODE_WRITE, SqliteDatabaseIndex("file_path_index", "file(path)")));
 	indices.push_back(std::make_pair(
-		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
-		SqliteDatabaseIndex("occurrence_element_id_index", "occurrence(element_id)")));
+		STORAGE_MODE_WRITE,
+		SqliteDatabaseIndex(
+			"local_symbol_location_index",
+			"local_symbol(file_node_id, start_line, start_column)")));
+	// the primary key of occurrence is its lookup by element, this one also holds the element ids
 	indices.push_back(std::make_pair(
 		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex(
@@ -1179,18 +2888,9 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
 		STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex(
 			"element_component_foreign_key_index", "element_component(element_id)")));
-	indices.push_back(std::make_pair(
-		STORAGE_MODE_CLEAR,
-		SqliteDatabaseIndex("edge_source_foreign_key_index", "edge(source_node_id)")));
-	indices.push_back(std::make_pair(
-		STORAGE_MODE_CLEAR,
-		SqliteDatabaseIndex("edge_target_foreign_key_index", "edge(target_node_id)")));
 	indices.push_back(std::make_pair(
 		STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex("source_location_foreign_key_index", "source_location(file_node_id)")));
-	indices.push_back(std::make_pair(
-		STORAGE_MODE_CLEAR,
-		SqliteDatabaseIndex("occurrence_element_foreign_key_index", "occurrence(element_id)")));
 	indices.push_back(std::make_pair(
 		STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex(
@@ -1206,9 +2906,17 @@ void SqliteIndexStorage::clearTables()
 		m_database.execDML("DROP TABLE IF EXISTS main.error;");
 		m_database.execDML("DROP TABLE IF EXISTS main.component_access;");
 		m_database.execDML("DROP TABLE IF EXISTS main.occurrence;");
+		m_database.execDML("DROP TABLE IF EXISTS main.source_location_pack;");
+		m_database.execDML("DROP TABLE IF EXISTS main.node_file;");
 		m_database.execDML("DROP TABLE IF EXISTS main.source_location;");
 		m_database.execDML("DROP TABLE IF EXISTS main.local_symbol;");
+		m_database.execDML("DROP TABLE IF EXISTS main.fulltext_index;");
+		m_database.execDML("DROP TABLE IF EXISTS main.search_index;");
+		m_database.execDML("DROP TABLE IF EXISTS main.search_name;");
+		m_database.execDML("DROP TABLE IF EXISTS main.indexing_time;");
+		m_database.execDML("DROP TABLE IF EXISTS main.file_hash;");
 		m_database.execDML("DROP TABLE IF EXISTS main.filecontent;");
+		m_database.execDML("DROP TABLE IF EXISTS main.content;");
 		m_database.execDML("DROP TABLE IF EXISTS main.file;");
 		m_database.execDML("DROP TABLE IF EXISTS main.symbol;");
 		m_database.execDML("DROP TABLE IF EXISTS main.node;");
@@ -1280,19 +2988,89 @@ void SqliteIndexStorage::setupTables()
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES node(id) ON DELETE CASCADE);");
 
+		// files with equal content share one row, which stays until removeUnreferencedFileContents
+		// even without references, so files refreshed without changes don't write it again
 		m_database.execDML(
-			"CREATE TABLE IF NOT EXISTS filecontent("
-			"id INTERGER, "
+			"CREATE TABLE IF NOT EXISTS content("
+			"id INTEGER NOT NULL, "
+			"hash TEXT NOT NULL, "
 			"content TEXT, "
+			"reference_count INTEGER NOT NULL, "
+			"PRIMARY KEY(id));");
+
+		m_database.execDML("CREATE INDEX IF NOT EXISTS content_hash_index ON content(hash);");
+
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS filecontent("
+			"id INTEGER NOT NULL, "
+			"content_id INTEGER NOT NULL, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES file(id)"
 			"ON DELETE CASCADE "
 			"ON UPDATE CASCADE);");
 
+		// also run for rows deleted by the cascade of removed files
+		m_database.execDML(
+			"CREATE TRIGGER IF NOT EXISTS filecontent_insert_trigger AFTER INSERT ON filecontent "
+			"BEGIN "
+			"UPDATE content SET reference_count = reference_count + 1 WHERE id = NEW.content_id; "
+			"END;");
+		m_database.execDML(
+			"CREATE TRIGGER IF NOT EXISTS filecontent_delete_trigger AFTER DELETE ON filecontent "
+			"BEGIN "
+			"UPDATE content SET reference_count = reference_count - 1 WHERE id = OLD.content_id; "
+			"END;");
+
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS file_hash("
+			"id INTEGER NOT NULL, "
+			"content_hash TEXT, "
+			"code_hash TEXT, "
+			"PRIMARY KEY(id), "
+			"FOREIGN KEY(id) REFERENCES file(id) ON DELETE CASCADE);");
+
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS fulltext_index("
+			"id INTEGER NOT NULL, "
+			"codec TEXT, "
+			"data BLOB, "
+			"PRIMARY KEY(id), "
+			"FOREIGN KEY(id) REFERENCES file(id) ON DELETE CASCADE);");
+
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS search_index("
+			"name TEXT NOT NULL, "
+			"data BLOB, "
+			"PRIMARY KEY(name));");
+
+		// names of the searched symbols, which replace the search index in low memory mode
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS search_name("
+			"node_id INTEGER NOT NULL, "
+			"type INTEGER NOT NULL, "
+			"reference_count INTEGER NOT NULL, "
+			"name TEXT NOT NULL, "
+			"PRIMARY KEY(node_id));");
+
+		// keyed by path instead of file id, so the times of the last run survive clearing files
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS indexing_time("
+			"path TEXT NOT NULL, "
+			"duration_ms INTEGER NOT NULL, "
+			"parse_duration_ms INTEGER NOT NULL, "
+			"visit_duration_ms INTEGER NOT NULL, "
+			"peak_memory_kb INTEGER NOT NULL, "
+			"storage_byte_count INTEGER NOT NULL, "
+			"gc_duration_ms INTEGER NOT NULL, "
+			"PRIMARY KEY(path));");
+
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS local_symbol("
 			"id INTEGER NOT NULL, "
 			"name TEXT, "
+			"file_node_id INTEGER NOT NULL DEFAULT 0, "
+			"start_line INTEGER NOT NULL DEFAULT 0, "
+			"start_column INTEGER NOT NULL DEFAULT 0, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES element(id) ON DELETE CASCADE);");
 
@@ -1308,13 +3086,28 @@ void SqliteIndexStorage::setupTables()
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(file_node_id) REFERENCES node(id) ON DELETE CASCADE);");
 
+		// see packSourceLocations
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS source_location_pack("
+			"file_node_id INTEGER NOT NULL, "
+			"locations BLOB NOT NULL, "
+			"PRIMARY KEY(file_node_id));");
+
+		// see buildNodeFiles
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS node_file("
+			"node_id INTEGER NOT NULL, "
+			"file_node_id INTEGER NOT NULL, "
+			"PRIMARY KEY(node_id)) WITHOUT ROWID;");
+
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS occurrence("
 			"element_id INTEGER NOT NULL, "
 			"source_location_id INTEGER NOT NULL, "
 			"PRIMARY KEY(element_id, source_location_id), "
 			"FOREIGN KEY(element_id) REFERENCES element(id) ON DELETE CASCADE, "
-			"FOREIGN KEY(source_location_id) REFERENCES source_location(id) ON DELETE CASCADE);");
+			"FOREIGN KEY(source_location_id) REFERENCES source_location(id) ON DELETE CASCADE) "
+			"WITHOUT ROWID;");
 
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS component_access("
@@ -1345,70 +3138,13 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 {
 	try
 	{
-		m_insertNodeBatchStatement.compile(
-			"INSERT INTO node(id, type, serialized_name) VALUES",
-			3,
-			[](CppSQLite3Statement& stmt, const StorageNode& node, size_t index) {
-				stmt.bind(index * 3 + 1, int(node.id));
-				stmt.bind(index * 3 + 2, int(node.type));
-				stmt.bind(index * 3 + 3, utility::encodeToUtf8(node.serializedName).c_str());
-			},
-			m_database);
-		m_insertEdgeBatchStatement.compile(
-			"INSERT INTO edge(id, type, source_node_id, target_node_id) VALUES",
-			4,
-			[](CppSQLite3Statement& stmt, const StorageEdge& edge, size_t index) {
-				stmt.bind(index * 4 + 1, int(edge.id));
-				stmt.bind(index * 4 + 2, int(edge.type));
-				stmt.bind(index * 4 + 3, int(edge.sourceNodeId));
-				stmt.bind(index * 4 + 4, int(edge.targetNodeId));
-			},
-			m_database);
-		m_insertSymbolBatchStatement.compile(
-			"INSERT OR IGNORE INTO symbol(id, definition_kind) VALUES",
-			2,
-			[](CppSQLite3Statement& stmt, const StorageSymbol& symbol, size_t index) {
-				stmt.bind(index * 2 + 1, int(symbol.id));
-				stmt.bind(index * 2 + 2, int(symbol.definitionKind));
-			},
-			m_database);
-		m_insertLocalSymbolBatchStatement.compile(
-			"INSERT INTO local_symbol(id, name) VALUES",
-			2,
-			[](CppSQLite3Statement& stmt, const StorageLocalSymbol& symbol, size_t index) {
-				stmt.bind(index * 2 + 1, int(symbol.id));
-				stmt.bind(index * 2 + 2, utility::encodeToUtf8(symbol.name).c_str());
-			},
-			m_database);
-		m_insertSourceLocationBatchStatement.compile(
-			"INSERT INTO source_location(file_node_id, start_line, start_column, end_line, "
-			"end_column, type) VALUES",
-			6,
-			[](CppSQLite3Statement& stmt, const StorageSourceLocationData& location, size_t index) {
-				stmt.bind(index * 6 + 1, int(location.fileNodeId));
-				stmt.bind(index * 6 + 2, int(location.startLine));
-				stmt.bind(index * 6 + 3, int(location.startCol));
-				stmt.bind(index * 6 + 4, int(location.endLine));
-				stmt.bind(index * 6 + 5, int(location.endCol));
-				stmt.bind(index * 6 + 6, int(location.type));
-			},
-			m_database);
-		m_insertOccurenceBatchStatement.compile(
-			"INSERT OR IGNORE INTO occurrence(element_id, source_location_id) VALUES",
-			2,
-			[](CppSQLite3Statement& stmt, const StorageOccurrence& occurrence, size_t index) {
-				stmt.bind(index * 2 + 1, int(occurrence.elementId));
-				stmt.bind(index * 2 + 2, int(occurrence.sourceLocationId));
-			},
-			m_database);
-		m_insertComponentAccessBatchStatement.compile(
-			"INSERT OR IGNORE INTO component_access(node_id, type) VALUES",
-			2,
-			[](CppSQLite3Statement& stmt, const StorageComponentAccess& componentAccess, size_t index) {
-				stmt.bind(index * 2 + 1, int(componentAccess.nodeId));
-				stmt.bind(index * 2 + 2, int(componentAccess.type));
-			},
-			m_database);
+		m_insertNodeBatchStatement.compile("INSERT", m_database);
+		m_insertEdgeBatchStatement.compile("INSERT", m_database);
+		m_insertSymbolBatchStatement.compile("INSERT OR IGNORE", m_database);
+		m_insertLocalSymbolBatchStatement.compile("INSERT", m_database);
+		m_insertSourceLocationBatchStatement.compile("INSERT", m_database);
+		m_insertOccurenceBatchStatement.compile("INSERT OR IGNORE", m_database);
+		m_insertComponentAccessBatchStatement.compile("INSERT OR IGNORE", m_database);
 
 		m_insertElementStmt = m_database.compileStatement("INSERT INTO element(id) VALUES(NULL);");
 		m_insertElementComponentStmt = m_database.compileStatement(
@@ -1417,7 +3153,29 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 			"INSERT INTO file(id, path, language, modification_time, indexed, complete, "
 			"line_count) VALUES(?, ?, ?, ?, ?, ?, ?);");
 		m_insertFileContentStmt = m_database.compileStatement(
-			"INSERT INTO filecontent(id, content) VALUES(?, ?);");
+			"INSERT INTO filecontent(id, content_id) VALUES(?, ?);");
+		m_findContentStmt = m_database.compileStatement(
+			"SELECT id, content FROM content WHERE hash = ?;");
+		m_insertContentStmt = m_database.compileStatement(
+			"INSERT INTO content(id, hash, content, reference_count) VALUES(NULL, ?, ?, 0);");
+		m_insertFileHashStmt = m_database.compileStatement(
+			"INSERT INTO file_hash(id, content_hash, code_hash) VALUES(?, ?, ?);");
+		m_updateSourceLocationStmt = m_database.compileStatement(
+			"UPDATE source_location SET start_line = ?, start_column = ?, end_line = ?, "
+			"end_column = ? WHERE id = ?;");
+		m_insertSourceLocationPackStmt = m_database.compileStatement(
+			"INSERT OR REPLACE INTO source_location_pack(file_node_id, locations) VALUES(?, ?);");
+		m_insertFullTextSearchIndexStmt = m_database.compileStatement(
+			"INSERT OR REPLACE INTO fulltext_index(id, codec, data) VALUES(?, ?, ?);");
+		m_insertSearchIndexStmt = m_database.compileStatement(
+			"INSERT OR REPLACE INTO search_index(name, data) VALUES(?, ?);");
+		m_insertSearchNameStmt = m_database.compileStatement(
+			"INSERT OR REPLACE INTO search_name(node_id, type, reference_count, name) "
+			"VALUES(?, ?, ?, ?);");
+		m_insertIndexingTimeStmt = m_database.compileStatement(
+			"INSERT OR REPLACE INTO indexing_time(path, duration_ms, parse_duration_ms, "
+			"visit_duration_ms, peak_memory_kb, storage_byte_count, gc_duration_ms) "
+			"VALUES(?, ?, ?, ?, ?, ?, ?);");
 		m_checkErrorExistsStmt = m_database.compileStatement(
 			"SELECT id FROM error WHERE "
 			"message = ? AND "
@@ -1441,51 +3199,22 @@ template <>
 void SqliteIndexStorage::forEach<StorageEdge>(
 	const std::string& query, std::function<void(StorageEdge&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT id, type, source_node_id, target_node_id FROM edge " + query + ";");
-
-	while (!q.eof())
-	{
-		const Id id = q.getIntField(0, 0);
-		const int type = q.getIntField(1, -1);
-		const Id sourceId = q.getIntField(2, 0);
-		const Id targetId = q.getIntField(3, 0);
-
-		if (id != 0 && type != -1)
-		{
-			func(StorageEdge(id, type, sourceId, targetId));
-		}
-
-		q.nextRow();
-	}
+	forEachRecord(query, func);
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageNode>(
 	const std::string& query, std::function<void(StorageNode&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT id, type, serialized_name FROM node " + query + ";");
-
-	while (!q.eof())
-	{
-		const Id id = q.getIntField(0, 0);
-		const int type = q.getIntField(1, -1);
-		const std::string serializedName = q.getStringField(2, "");
-
-		if (id != 0 && type != -1)
-		{
-			func(StorageNode(id, type, utility::decodeFromUtf8(serializedName)));
-		}
-
-		q.nextRow();
-	}
+	forEachRecord(query, func);
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageSymbol>(
 	const std::string& query, std::function<void(StorageSymbol&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT id, definition_kind FROM symbol " + query + ";");
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement("SELECT id, definition_kind FROM symbol " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
@@ -1505,8 +3234,9 @@ template <>
 void SqliteIndexStorage::forEach<StorageFile>(
 	const std::string& query, std::function<void(StorageFile&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
 		"SELECT id, path, language, modification_time, indexed, complete FROM file " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
@@ -1535,16 +3265,25 @@ template <>
 void SqliteIndexStorage::forEach<StorageLocalSymbol>(
 	const std::string& query, std::function<void(StorageLocalSymbol&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT id, name FROM local_symbol " + query + ";");
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+		"SELECT id, name, file_node_id, start_line, start_column FROM local_symbol " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
 		const Id id = q.getIntField(0, 0);
 		const std::string name = q.getStringField(1, "");
+		const Id fileNodeId = q.getIntField(2, 0);
+		const int startLine = q.getIntField(3, 0);
+		const int startCol = q.getIntField(4, 0);
 
 		if (id != 0)
 		{
-			func(StorageLocalSymbol(id, utility::decodeFromUtf8(name)));
+			StorageLocalSymbol localSymbol(id, utility::decodeFromUtf8(name));
+			localSymbol.fileNodeId = fileNodeId;
+			localSymbol.startLine = startLine;
+			localSymbol.startCol = startCol;
+			func(std::move(localSymbol));
 		}
 
 		q.nextRow();
@@ -1555,38 +3294,16 @@ template <>
 void SqliteIndexStorage::forEach<StorageSourceLocation>(
 	const std::string& query, std::function<void(StorageSourceLocation&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT id, file_node_id, start_line, start_column, end_line, end_column, type FROM "
-		"source_location " +
-		query + ";");
-
-	while (!q.eof())
-	{
-		const Id id = q.getIntField(0, 0);
-		const Id fileNodeId = q.getIntField(1, 0);
-		const int startLineNumber = q.getIntField(2, -1);
-		const int startColNumber = q.getIntField(3, -1);
-		const int endLineNumber = q.getIntField(4, -1);
-		const int endColNumber = q.getIntField(5, -1);
-		const int type = q.getIntField(6, -1);
-
-		if (id != 0 && fileNodeId != 0 && startLineNumber != -1 && startColNumber != -1 &&
-			endLineNumber != -1 && endColNumber != -1 && type != -1)
-		{
-			func(StorageSourceLocation(
-				id, fileNodeId, startLineNumber, startColNumber, endLineNumber, endColNumber, type));
-		}
-
-		q.nextRow();
-	}
+	forEachRecord(query, func);
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageOccurrence>(
 	const std::string& query, std::function<void(StorageOccurrence&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
 		"SELECT element_id, source_location_id FROM occurrence " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
@@ -1606,7 +3323,8 @@ template <>
 void SqliteIndexStorage::forEach<StorageComponentAccess>(
 	const std::string& query, std::function<void(StorageComponentAccess&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT node_id, type FROM component_access " + query + ";");
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement("SELECT node_id, type FROM component_access " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
@@ -1626,8 +3344,9 @@ template <>
 void SqliteIndexStorage::forEach<StorageElementComponent>(
 	const std::string& query, std::function<void(StorageElementComponent&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
 		"SELECT element_id, type, data FROM element_component " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
@@ -1648,8 +3367,9 @@ template <>
 void SqliteIndexStorage::forEach<StorageError>(
 	const std::string& query, std::function<void(StorageError&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
+	SqliteStatementCache::ScopedStatement statement = getCachedStatement(
 		"SELECT id, message, fatal, indexed, translation_unit FROM error " + query + ";");
+	CppSQLite3Query q = executeQuery(statement);
 
 	while (!q.eof())
 	{
@@ -1,13 +1,20 @@
 #ifndef SQLITE_INDEX_STORAGE_H
 #define SQLITE_INDEX_STORAGE_H
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "ErrorCountInfo.h"
+#include "ErrorFilter.h"
 #include "ErrorInfo.h"
 #include "LocationType.h"
-#include "LowMemoryStringMap.h"
+#include "NodeType.h"
 #include "SqliteDatabaseIndex.h"
 #include "SqliteStorage.h"
 #include "StorageComponentAccess.h"
@@ -15,11 +22,14 @@
 #include "StorageElementComponent.h"
 #include "StorageError.h"
 #include "StorageFile.h"
+#include "StorageIndexingTime.h"
 #include "StorageLocalSymbol.h"
 #include "StorageNode.h"
 #include "StorageOccurrence.h"
 #include "StorageSourceLocation.h"
+#include "StorageStats.h"
 #include "StorageSymbol.h"
+#include "SymbolIdIndex.h"
 #include "types.h"
 #include "utility.h"
 #include "utilityString.h"
@@ -38,18 +48,42 @@ public:
 	{
 		STORAGE_MODE_READ = 1,
 		STORAGE_MODE_WRITE = 2,
-		STORAGE_MODE_CLEAR = 4
+		STORAGE_MODE_CLEAR = 4,
+		// writing into an empty database: no secondary indices are kept until the mode changes
+		STORAGE_MODE_BULK_WRITE = 8
 	};
 
 	SqliteIndexStorage(const FilePath& dbFilePath);
 
 	virtual size_t getStaticVersion() const;
 
+	// only migrates from the previous version, older databases need to be indexed again
+	void migrateIfNecessary();
+
 	void setMode(const StorageModeType mode);
 
 	std::string getProjectSettingsText() const;
 	void setProjectSettingsText(std::string text);
 
+	// set in exported snapshots to identify the content independently of the database file, cleared
+	// when the storage is written to again
+	std::string getSnapshotStamp() const;
+	void setSnapshotStamp(const std::string& stamp);
+
+	// identifies the indexed state, every refresh sets a new revision
+	std::string getRevision() const;
+	void setRevision(const std::string& revision);
+
+	// set in index deltas, which hold the data that a refresh of the base revision indexed
+	std::string getDeltaBaseRevision() const;
+	void setDeltaBaseRevision(const std::string& revision);
+	std::vector<FilePath> getDeltaClearedFilePaths() const;
+	void setDeltaClearedFilePaths(const std::vector<FilePath>& filePaths);
+
+	// wall time in seconds of each indexing phase of the last indexing run, by phase name
+	std::map<std::string, float> getIndexingPhaseDurations() const;
+	void setIndexingPhaseDurations(const std::map<std::string, float>& durations);
+
 	Id addNode(const StorageNodeData& data);
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes);
 	bool addSymbol(const StorageSymbol& data);
@@ -58,7 +92,7 @@ public:
 	Id addEdge(const StorageEdgeData& data);
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges);
 	Id addLocalSymbol(const StorageLocalSymbolData& data);
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols);
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols);
 	Id addSourceLocation(const StorageSourceLocationData& data);
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations);
 	bool addOccurrence(const StorageOccurrence& data);
@@ -69,6 +103,16 @@ public:
 	void addElementComponents(const std::vector<StorageElementComponent>& components);
 	StorageError addError(const StorageErrorData& data);
 
+	// Copies all content of another index database with the current storage version by attaching
+	// it and remapping its ids within sqlite, the result is the same as injecting it through the
+	// Storage interface. Returns false and keeps this database unchanged if it cannot be copied.
+	bool injectDatabase(const FilePath& dbFilePath);
+
+	// Replaces the ids of all elements, source locations, contents and element components with
+	// ids derived from hashes of their data, so indexing the same sources always gives the same
+	// ids and a vacuum writes the rows in the same order. Drops the data derived from the ids.
+	void canonicalizeIds();
+
 	void removeElement(Id id);
 	void removeElements(const std::vector<Id>& ids);
 	void removeOccurrence(const StorageOccurrence& occurrence);
@@ -77,6 +121,14 @@ public:
 	void removeElementsWithLocationInFiles(
 		const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback);
 
+	// temporary triggers of this connection record the ids of all nodes, edges and symbols that
+	// are added, changed or removed from then on, edges also record their target nodes
+	void startRecordingChanges();
+	std::vector<Id> getRecordedChangedElementIds() const;
+	void stopRecordingChanges();
+
+	// contents of removed files are kept until then, in case their files are added again
+	void removeUnreferencedFileContents();
 	void removeAllErrors();
 
 	bool isEdge(Id elementId) const;
@@ -99,7 +151,10 @@ public:
 	std::vector<StorageEdge> getEdgesByTargetsType(const std::vector<Id>& targetIds, int type) const;
 
 	StorageNode getNodeById(Id id) const;
-	StorageNode getNodeBySerializedName(const std::wstring& serializedName) const;
+	StorageNode getNodeBySerializedName(const std::string& serializedName) const;
+	// names without a node are left out of the result
+	std::vector<StorageNode> getNodesBySerializedNames(
+		const std::vector<std::string>& serializedNames) const;
 
 	std::vector<int> getAvailableNodeTypes() const;
 	std::vector<int> getAvailableEdgeTypes() const;
@@ -110,12 +165,45 @@ public:
 	std::shared_ptr<TextAccess> getFileContentByPath(const std::wstring& filePath) const;
 	std::shared_ptr<TextAccess> getFileContentById(Id fileId) const;
 
+	// hashes of the stored content, see TextLayoutMapping, empty if no content was stored
+	std::string getFileContentHash(Id fileId) const;
+	std::string getFileCodeHash(Id fileId) const;
+	// content hashes of all files with stored content by file path
+	std::map<std::wstring, std::string> getAllFileContentHashes() const;
+
+	// replaces the stored content of an indexed file whose recorded locations were moved to it
+	void updateFileContent(Id fileId, const std::string& content, const std::string& modificationTime);
+	void updateSourceLocationPositions(const std::vector<StorageSourceLocation>& locations);
+	std::vector<StorageSourceLocation> getSourceLocationsByFileId(Id fileId) const;
+
+	void addFullTextSearchIndexData(
+		Id fileId, const std::string& codecName, const std::string& serializedArrays);
+	std::string getFullTextSearchIndexDataById(Id fileId, const std::string& codecName) const;
+	std::set<Id> getFileIdsWithFullTextSearchIndexData(const std::string& codecName) const;
+
+	// serialized SearchIndex by its name, needs to be cleared whenever indexing changes nodes
+	void setSearchIndexData(const std::string& name, const std::string& data);
+	std::string getSearchIndexData(const std::string& name) const;
+	void clearSearchIndexData();
+
+	// the names symbols are searched by in low memory mode, cleared with the search index data
+	void addSearchName(Id nodeId, int nodeType, uint32_t referenceCount, const std::wstring& name);
+	bool hasSearchNames() const;
+	// the names matching the LIKE pattern, the most referenced ones first
+	void forEachSearchName(
+		const std::string& likePattern,
+		NodeType::TypeMask nodeTypes,
+		size_t maxCount,
+		const std::function<void(Id, int, uint32_t, std::wstring&&)>& func) const;
+
+	void addIndexingTimes(const std::vector<StorageIndexingTime>& indexingTimes);
+	std::vector<StorageIndexingTime> getIndexingTimes() const;
+
 	void setFileIndexed(Id fileId, bool indexed);
 	void setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete);
 	void setNodeType(int type, Id nodeId);
 
-	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(
-		const FilePath& filePath, const std::string& query = "") const;
+	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(const FilePath& filePath) const;
 	std::shared_ptr<SourceLocationFile> getSourceLocationsForLinesInFile(
 		const FilePath& filePath, size_t startLine, size_t endLine) const;
 	std::shared_ptr<SourceLocationFile> getSourceLocationsOfTypeInFile(
@@ -124,6 +212,19 @@ public:
 	std::shared_ptr<SourceLocationCollection> getSourceLocationsForElementIds(
 		const std::vector<Id>& elementIds) const;
 
+	// counts the files holding token, scope, local symbol or unsolved locations of the elements and
+	// the occurrences of the elements that are references, i.e. not scopes
+	size_t getSourceLocationFileCountForElementIds(
+		const std::vector<Id>& elementIds, size_t* referenceCount) const;
+	// the locations counted above for the files following the file of the cursor in the order of
+	// their paths, at most fileCount files, the cursor is moved to the last file of the page
+	std::shared_ptr<SourceLocationCollection> getSourceLocationsPageForElementIds(
+		const std::vector<Id>& elementIds, FilePath* cursor, size_t fileCount) const;
+
+	// the file of the first scope location of each node, or of its first location if it has no
+	// scope, returns false if they are not known because the storage is not in read mode
+	bool getFileNodeIdsOfNodes(const std::vector<Id>& nodeIds, std::map<Id, Id>* fileNodeIds) const;
+
 	std::vector<StorageOccurrence> getOccurrencesForLocationId(Id locationId) const;
 	std::vector<StorageOccurrence> getOccurrencesForLocationIds(const std::vector<Id>& locationIds) const;
 	std::vector<StorageOccurrence> getOccurrencesForElementIds(const std::vector<Id>& elementIds) const;
@@ -137,6 +238,15 @@ public:
 
 	std::vector<ErrorInfo> getAllErrorInfos() const;
 
+	// one page of the errors passing the filter, in the order of getAllErrorInfos and with the same
+	// ids, only errors located in the given files are returned unless no files are given
+	std::vector<ErrorInfo> getErrorInfos(
+		const ErrorFilter& filter, const std::vector<Id>& fileIds = {}) const;
+
+	// counts the errors passing the filter, its limit and offset are ignored
+	ErrorCountInfo getErrorCountInfo(
+		const ErrorFilter& filter, const std::vector<Id>& fileIds = {}) const;
+
 	template <typename ResultType>
 	std::vector<ResultType> getAll() const
 	{
@@ -158,8 +268,8 @@ public:
 	{
 		if (ids.size())
 		{
-			return doGetAll<ResultType>(
-				"WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ")");
+			const IdList idList(this, ids);
+			return doGetAll<ResultType>("WHERE id IN " + idList.getQuery());
 		}
 		return std::vector<ResultType>();
 	}
@@ -181,7 +291,68 @@ public:
 	{
 		if (ids.size())
 		{
-			forEach("WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ")", func);
+			const IdList idList(this, ids);
+			forEach("WHERE id IN " + idList.getQuery(), func);
+		}
+	}
+
+	// the bytes of a text column, only valid until the next row is read
+	struct ColumnText
+	{
+		std::string str() const
+		{
+			return std::string(data, size);
+		}
+
+		const char* data = nullptr;
+		size_t size = 0;
+	};
+
+	// calls func with the selected columns of each row read as ColumnTypes (int, Id or ColumnText),
+	// so scans that need few columns don't build the storage types
+	template <typename... ColumnTypes, typename FuncType>
+	void forEachRow(const std::string& query, FuncType&& func) const
+	{
+		SqliteStatementCache::ScopedStatement statement = getCachedStatement(query);
+		CppSQLite3Query q = executeQuery(statement);
+		while (!q.eof())
+		{
+			callWithColumns<ColumnTypes...>(q, func, std::index_sequence_for<ColumnTypes...>());
+			q.nextRow();
+		}
+	}
+
+	// steps through the rows of a query on demand, so the rows of several storages can be merged,
+	// the storage has to outlive the cursor
+	class RowCursor
+	{
+	public:
+		RowCursor(const SqliteIndexStorage* storage, const std::string& query);
+
+		bool atEnd() const;
+		void next();
+
+		// read as ColumnType (int, Id or ColumnText) like the columns of forEachRow
+		template <typename ColumnType>
+		ColumnType get(int field) const
+		{
+			return readColumn(m_query, field, static_cast<ColumnType*>(nullptr));
+		}
+
+	private:
+		SqliteStatementCache::ScopedStatement m_statement;
+		mutable CppSQLite3Query m_query;
+	};
+
+	// the query ends with "IN", the list of ids gets appended
+	template <typename... ColumnTypes, typename FuncType>
+	void forEachRowByIds(
+		const std::vector<Id>& ids, const std::string& query, FuncType&& func) const
+	{
+		if (ids.size())
+		{
+			const IdList idList(this, ids);
+			forEachRow<ColumnTypes...>(query + " " + idList.getQuery() + ";", func);
 		}
 	}
 
@@ -189,13 +360,167 @@ public:
 	int getEdgeCount() const;
 	int getFileCount() const;
 	int getCompletedFileCount() const;
+	int getFileContentCount() const;	// equal contents of several files are counted once
 	int getFileLineSum() const;
 	int getSourceLocationCount() const;
 	int getErrorCount() const;
 
+	// read from the meta table while in read mode, counted otherwise
+	StorageStats getStorageStats() const;
+
 private:
 	static const size_t s_storageVersion;
 
+	template <typename... ColumnTypes, typename FuncType, size_t... Indices>
+	static void callWithColumns(CppSQLite3Query& q, FuncType& func, std::index_sequence<Indices...>)
+	{
+		func(readColumn(q, int(Indices), static_cast<ColumnTypes*>(nullptr))...);
+	}
+
+	static int readColumn(CppSQLite3Query& q, int field, int*)
+	{
+		return q.getIntField(field, 0);
+	}
+
+	static Id readColumn(CppSQLite3Query& q, int field, Id*)
+	{
+		return Id(q.getInt64Field(field, 0));
+	}
+
+	static ColumnText readColumn(CppSQLite3Query& q, int field, ColumnText*)
+	{
+		// the blob of a text column is its utf-8 without a conversion or copy
+		ColumnText text;
+		int size = 0;
+		text.data = reinterpret_cast<const char*>(q.getBlobField(field, size));
+		text.size = text.data ? size_t(size) : 0;
+		return text;
+	}
+
+	// the columns of the fields of a storage type, separated by commas
+	template <typename StorageType>
+	static const std::string& getColumnList()
+	{
+		static const std::string columns = []() {
+			std::vector<std::string> names;
+			utility::forEachStorageField<StorageType>(
+				[&names](size_t, const auto& field) { names.push_back(field.column); });
+			return utility::join(names, ", ");
+		}();
+		return columns;
+	}
+
+	template <typename ValueType>
+	static typename std::enable_if<std::is_integral<ValueType>::value>::type bindField(
+		CppSQLite3Statement& stmt, int index, ValueType value)
+	{
+		stmt.bind(index, int(value));
+	}
+
+	static void bindField(CppSQLite3Statement& stmt, int index, const std::string& value)
+	{
+		stmt.bind(index, value.c_str());
+	}
+
+	static void bindField(CppSQLite3Statement& stmt, int index, const std::wstring& value)
+	{
+		stmt.bind(index, utility::encodeToUtf8(value).c_str());
+	}
+
+	// binds the fields of the value to the parameters following firstIndex
+	template <typename StorageType>
+	static void bindFields(CppSQLite3Statement& stmt, const StorageType& value, int firstIndex)
+	{
+		utility::forEachStorageField<StorageType>([&](size_t index, const auto& field) {
+			bindField(stmt, firstIndex + int(index), value.*(field.member));
+		});
+	}
+
+	template <typename ValueType>
+	static typename std::enable_if<std::is_integral<ValueType>::value>::type readField(
+		CppSQLite3Query& q, int field, ValueType* value)
+	{
+		*value = ValueType(q.getIntField(field, 0));
+	}
+
+	static void readField(CppSQLite3Query& q, int field, std::string* value)
+	{
+		*value = q.getStringField(field, "");
+	}
+
+	static void readField(CppSQLite3Query& q, int field, std::wstring* value)
+	{
+		*value = utility::decodeFromUtf8(q.getStringField(field, ""));
+	}
+
+	// reads the fields of the value from the columns of the current row in the order of the
+	// fields, returns false if one of them is null
+	template <typename StorageType>
+	static bool readFields(CppSQLite3Query& q, StorageType* value)
+	{
+		bool complete = true;
+		utility::forEachStorageField<StorageType>([&](size_t index, const auto& field) {
+			if (q.fieldIsNull(int(index)))
+			{
+				complete = false;
+			}
+			else
+			{
+				readField(q, int(index), &(value->*(field.member)));
+			}
+		});
+		return complete;
+	}
+
+	// calls func for all complete rows of the table of the storage type that have an id
+	template <typename StorageType>
+	void forEachRecord(
+		const std::string& query, const std::function<void(StorageType&&)>& func) const
+	{
+		SqliteStatementCache::ScopedStatement statement = getCachedStatement(
+			"SELECT " + getColumnList<StorageType>() + " FROM " + StorageType::getTableName() + " " +
+			query + ";");
+		CppSQLite3Query q = executeQuery(statement);
+
+		while (!q.eof())
+		{
+			StorageType value;
+			if (readFields(q, &value) && value.id != 0)
+			{
+				func(std::move(value));
+			}
+
+			q.nextRow();
+		}
+	}
+
+	void clearTempIndices();
+
+	// the locations of each file packed into one row, only kept up to date in read mode
+	bool hasSourceLocationPacks() const;
+	void buildSourceLocationPacks();
+	void setSourceLocationPack(Id fileId, const std::vector<StorageSourceLocation>& locations);
+	bool getSourceLocationPack(Id fileId, std::vector<StorageSourceLocation>* locations) const;
+
+	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(
+		const FilePath& filePath, std::function<bool(const StorageSourceLocation&)> filter) const;
+
+	// the stats and available types kept in the meta table, also only up to date in read mode
+	bool hasAggregates() const;
+	void updateAggregates();
+	void setAggregateStats(const StorageStats& stats);
+	StorageStats queryStorageStats() const;
+	std::vector<int> queryAvailableTypes(const std::string& tableName) const;
+
+	// the file of each node for getFileNodeIdsOfNodes, only up to date in read mode as well
+	bool hasNodeFiles() const;
+	void buildNodeFiles();
+
+	// stores the content once for all files having it
+	bool addFileContent(Id fileId, const std::string& content, const std::string& contentHash);
+
+	static void countInsertedRows(size_t rowCount);
+
 	struct TempSourceLocation
 	{
 		TempSourceLocation(
@@ -264,30 +589,31 @@ private:
 	template <typename StorageType>
 	void forEach(const std::string& query, std::function<void(StorageType&&)> func) const;
 
-	LowMemoryStringMap<std::string, uint32_t, 0> m_tempNodeNameIndex;
-	LowMemoryStringMap<std::wstring, uint32_t, 0> m_tempWNodeNameIndex;
-	std::map<uint32_t, int> m_tempNodeTypes;
+	SymbolIdIndex m_tempSymbolIdIndex;
 	std::map<StorageEdgeData, uint32_t> m_tempEdgeIndex;
-	std::map<std::wstring, std::map<std::wstring, uint32_t>> m_tempLocalSymbolIndex;
+	std::map<StorageLocalSymbolData, uint32_t> m_tempLocalSymbolIndex;
 	std::map<uint32_t, std::map<TempSourceLocation, uint32_t>> m_tempSourceLocationIndices;
+	std::set<std::wstring> m_tempFilePathIndex;
+	std::map<std::pair<std::wstring, bool>, Id> m_tempErrorIndex;
+
+	StorageModeType m_mode = STORAGE_MODE_READ;
 
+	// inserts rows of a storage type in batches of as many rows as the parameters of a statement
+	// allow, the columns and their binding are generated from the fields of the type
 	template <typename StorageType>
 	class InsertBatchStatement
 	{
 	public:
-		void compile(
-			const std::string header,
-			size_t valueCount,
-			std::function<void(CppSQLite3Statement& stmt, const StorageType&, size_t)> bindValuesFunc,
-			CppSQLite3DB& database)
+		// the command is e.g. "INSERT" or "INSERT OR IGNORE"
+		void compile(const std::string& command, CppSQLite3DB& database)
 		{
-			m_bindValuesFunc = bindValuesFunc;
-
+			const std::string header = command + " INTO " + StorageType::getTableName() + "(" +
+				getColumnList<StorageType>() + ") VALUES";
 			std::string valueStr = '(' +
-				utility::join(std::vector<std::string>(valueCount, "?"), ',') + ')';
+				utility::join(std::vector<std::string>(s_valueCount, "?"), ',') + ')';
 
 			const size_t MAX_VARIABLE_COUNT = 999;
-			size_t batchSize = MAX_VARIABLE_COUNT / valueCount;
+			size_t batchSize = MAX_VARIABLE_COUNT / s_valueCount;
 
 			while (true)
 			{
@@ -330,7 +656,7 @@ private:
 				{
 					for (size_t j = 0; j < batchSize; j++)
 					{
-						m_bindValuesFunc(stmt, types[i + j], j);
+						bindFields(stmt, types[i + j], int(j * s_valueCount + 1));
 					}
 
 					const bool success = storage->executeStatement(stmt);
@@ -343,13 +669,14 @@ private:
 				}
 			}
 
+			countInsertedRows(types.size());
 			return true;
 		}
 
 	private:
-		std::vector<std::pair<size_t, CppSQLite3Statement>> m_stmts;
+		static constexpr size_t s_valueCount = utility::getStorageFieldCount<StorageType>();
 
-		std::function<void(CppSQLite3Statement& stmt, const StorageType&, size_t)> m_bindValuesFunc;
+		std::vector<std::pair<size_t, CppSQLite3Statement>> m_stmts;
 	};
 
 	InsertBatchStatement<StorageNode> m_insertNodeBatchStatement;
@@ -364,6 +691,15 @@ private:
 	CppSQLite3Statement m_insertElementComponentStmt;
 	CppSQLite3Statement m_insertFileStmt;
 	CppSQLite3Statement m_insertFileContentStmt;
+	CppSQLite3Statement m_findContentStmt;
+	CppSQLite3Statement m_insertContentStmt;
+	CppSQLite3Statement m_insertFileHashStmt;
+	CppSQLite3Statement m_updateSourceLocationStmt;
+	CppSQLite3Statement m_insertSourceLocationPackStmt;
+	CppSQLite3Statement m_insertFullTextSearchIndexStmt;
+	CppSQLite3Statement m_insertSearchIndexStmt;
+	CppSQLite3Statement m_insertSearchNameStmt;
+	CppSQLite3Statement m_insertIndexingTimeStmt;
 	CppSQLite3Statement m_checkErrorExistsStmt;
 	CppSQLite3Statement m_insertErrorStmt;
 };
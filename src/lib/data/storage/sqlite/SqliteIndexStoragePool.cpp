@@ -0,0 +1,130 @@
+#include "SqliteIndexStoragePool.h"
+
+#include "CppSQLite3.h"
+#include "logging.h"
+
+SqliteIndexStoragePool::ScopedStorage::ScopedStorage(const SqliteIndexStorage* storage)
+	: m_pool(nullptr), m_storage(storage), m_generation(0)
+{
+}
+
+SqliteIndexStoragePool::ScopedStorage::ScopedStorage(ScopedStorage&& other)
+	: m_pool(other.m_pool)
+	, m_ownedStorage(std::move(other.m_ownedStorage))
+	, m_storage(other.m_storage)
+	, m_generation(other.m_generation)
+{
+	other.m_pool = nullptr;
+	other.m_storage = nullptr;
+}
+
+SqliteIndexStoragePool::ScopedStorage::~ScopedStorage()
+{
+	if (m_pool && m_ownedStorage)
+	{
+		m_pool->release(std::move(m_ownedStorage), m_generation);
+	}
+}
+
+const SqliteIndexStorage* SqliteIndexStoragePool::ScopedStorage::operator->() const
+{
+	return m_storage;
+}
+
+SqliteIndexStoragePool::ScopedStorage::operator bool() const
+{
+	return m_storage != nullptr;
+}
+
+bool SqliteIndexStoragePool::ScopedStorage::isPooled() const
+{
+	return m_pool != nullptr;
+}
+
+SqliteIndexStoragePool::ScopedStorage::ScopedStorage(
+	SqliteIndexStoragePool* pool, std::unique_ptr<SqliteIndexStorage> storage, size_t generation)
+	: m_pool(pool)
+	, m_ownedStorage(std::move(storage))
+	, m_storage(m_ownedStorage.get())
+	, m_generation(generation)
+{
+}
+
+SqliteIndexStoragePool::SqliteIndexStoragePool(
+	const FilePath& dbFilePath, size_t maxConnectionCount, const SqliteStorageSettings& settings)
+	: m_dbFilePath(dbFilePath), m_maxConnectionCount(maxConnectionCount), m_settings(settings)
+{
+	// the journal mode belongs to the database file and is only set by the writing connection
+	m_settings.journalMode.clear();
+	// no query_only here, the temp id lists of queries are written on every connection
+}
+
+SqliteIndexStoragePool::ScopedStorage SqliteIndexStoragePool::acquire()
+{
+	size_t generation = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		generation = m_generation;
+		if (!m_idleStorages.empty())
+		{
+			std::unique_ptr<SqliteIndexStorage> storage = std::move(m_idleStorages.back());
+			m_idleStorages.pop_back();
+			return ScopedStorage(this, std::move(storage), generation);
+		}
+
+		if (m_connectionCount >= m_maxConnectionCount)
+		{
+			return ScopedStorage(nullptr);
+		}
+		m_connectionCount++;
+	}
+
+	// opening happens outside of the lock, so it doesn't hold up threads with idle connections
+	try
+	{
+		std::unique_ptr<SqliteIndexStorage> storage = std::make_unique<SqliteIndexStorage>(
+			m_dbFilePath);
+		storage->applySettings(m_settings);
+		return ScopedStorage(this, std::move(storage), generation);
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(
+			"Failed to open read connection: " + std::to_string(e.errorCode()) + ": " +
+			e.errorMessage());
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_connectionCount--;
+	return ScopedStorage(nullptr);
+}
+
+void SqliteIndexStoragePool::clear()
+{
+	std::vector<std::unique_ptr<SqliteIndexStorage>> idleStorages;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		idleStorages.swap(m_idleStorages);
+		m_connectionCount -= idleStorages.size();
+		m_generation++;
+	}
+}
+
+size_t SqliteIndexStoragePool::getConnectionCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_connectionCount;
+}
+
+void SqliteIndexStoragePool::release(std::unique_ptr<SqliteIndexStorage> storage, size_t generation)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (generation == m_generation)
+	{
+		m_idleStorages.push_back(std::move(storage));
+		return;
+	}
+
+	// the connection is closed together with the argument, after the lock is released
+	m_connectionCount--;
+}
@@ -0,0 +1,73 @@
+#ifndef SQLITE_INDEX_STORAGE_POOL_H
+#define SQLITE_INDEX_STORAGE_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "FilePath.h"
+#include "SqliteIndexStorage.h"
+#include "SqliteStorageSettings.h"
+
+// Read only connections to an index database, which let queries of several threads run in
+// parallel. Connections are opened on demand up to the maximum count and are only useful while
+// the database is in wal mode, otherwise readers and the writer block each other.
+class SqliteIndexStoragePool
+{
+public:
+	class ScopedStorage
+	{
+	public:
+		// wraps a storage that is not owned by any pool
+		explicit ScopedStorage(const SqliteIndexStorage* storage);
+		ScopedStorage(ScopedStorage&& other);
+		~ScopedStorage();
+
+		ScopedStorage(const ScopedStorage&) = delete;
+		ScopedStorage& operator=(const ScopedStorage&) = delete;
+
+		const SqliteIndexStorage* operator->() const;
+		explicit operator bool() const;
+
+		// false for the wrapped storages, which may be used by other threads as well
+		bool isPooled() const;
+
+	private:
+		friend SqliteIndexStoragePool;
+
+		ScopedStorage(
+			SqliteIndexStoragePool* pool,
+			std::unique_ptr<SqliteIndexStorage> storage,
+			size_t generation);
+
+		SqliteIndexStoragePool* m_pool;
+		std::unique_ptr<SqliteIndexStorage> m_ownedStorage;
+		const SqliteIndexStorage* m_storage;
+		size_t m_generation;
+	};
+
+	SqliteIndexStoragePool(
+		const FilePath& dbFilePath, size_t maxConnectionCount, const SqliteStorageSettings& settings);
+
+	// the returned handle is empty if all connections are in use
+	ScopedStorage acquire();
+
+	// closes the idle connections, handles in use keep their connection until they are destroyed
+	void clear();
+
+	size_t getConnectionCount() const;
+
+private:
+	void release(std::unique_ptr<SqliteIndexStorage> storage, size_t generation);
+
+	const FilePath m_dbFilePath;
+	const size_t m_maxConnectionCount;
+	SqliteStorageSettings m_settings;
+
+	std::vector<std::unique_ptr<SqliteIndexStorage>> m_idleStorages;
+	size_t m_connectionCount = 0;
+	size_t m_generation = 0;	// connections of previous generations are closed on release
+	mutable std::mutex m_mutex;
+};
+
+#endif	  // SQLITE_INDEX_STORAGE_POOL_H
@@ -0,0 +1,243 @@
+#include "SqliteQueryProfile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <memory>
+
+#include "FilePath.h"
+#include "utilityString.h"
+
+namespace
+{
+std::string toMsString(long long microseconds)
+{
+	return std::to_string(microseconds / 1000) + "." + std::to_string((microseconds % 1000) / 100) +
+		" ms";
+}
+
+bool isIdentifierChar(char c)
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool endsWith(const std::string& text, const std::string& end)
+{
+	return text.size() >= end.size() && text.compare(text.size() - end.size(), end.size(), end) == 0;
+}
+}	 // namespace
+
+SqliteQueryProfile* SqliteQueryProfile::getInstance()
+{
+	static std::shared_ptr<SqliteQueryProfile> instance = std::make_shared<SqliteQueryProfile>();
+	return instance.get();
+}
+
+std::string SqliteQueryProfile::normalizeSql(const std::string& sql)
+{
+	std::string normalized;
+	size_t i = 0;
+	while (i < sql.size())
+	{
+		const char c = sql[i];
+		bool isValue = false;
+
+		if (c == '\'')
+		{
+			// quotes within strings are doubled
+			i++;
+			while (i < sql.size() && (sql[i] != '\'' || (i + 1 < sql.size() && sql[i + 1] == '\'')))
+			{
+				i += sql[i] == '\'' ? 2 : 1;
+			}
+			i++;
+			isValue = true;
+		}
+		else if (
+			(c == ':' || c == '@' || c == '$') && i + 1 < sql.size() && isIdentifierChar(sql[i + 1]))
+		{
+			i++;
+			while (i < sql.size() && isIdentifierChar(sql[i]))
+			{
+				i++;
+			}
+			isValue = true;
+		}
+		else if (
+			(std::isdigit(static_cast<unsigned char>(c)) || c == '?') &&
+			(normalized.empty() || !isIdentifierChar(normalized.back())))
+		{
+			i++;
+			while (i < sql.size() && (isIdentifierChar(sql[i]) || sql[i] == '.'))
+			{
+				i++;
+			}
+			isValue = true;
+		}
+		else if (std::isspace(static_cast<unsigned char>(c)))
+		{
+			if (!normalized.empty() && normalized.back() != ' ')
+			{
+				normalized += ' ';
+			}
+			i++;
+		}
+		else
+		{
+			normalized += c;
+			i++;
+		}
+
+		if (isValue)
+		{
+			// lists of values of any length become one value
+			if (endsWith(normalized, "?, "))
+			{
+				normalized.resize(normalized.size() - 2);
+			}
+			else if (endsWith(normalized, "?,"))
+			{
+				normalized.resize(normalized.size() - 1);
+			}
+			else
+			{
+				normalized += '?';
+			}
+		}
+	}
+
+	// as well as the rows of batched inserts
+	for (const char* rows: {"(?), (?)", "(?),(?)"})
+	{
+		while (normalized.find(rows) != std::string::npos)
+		{
+			normalized = utility::replace(normalized, rows, "(?)");
+		}
+	}
+	while (!normalized.empty() && normalized.back() == ' ')
+	{
+		normalized.pop_back();
+	}
+	return normalized;
+}
+
+SqliteQueryProfile::SqliteQueryProfile(): m_enabled(false), m_slowThresholdMs(100) {}
+
+bool SqliteQueryProfile::isEnabled() const
+{
+	return m_enabled;
+}
+
+void SqliteQueryProfile::setEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+size_t SqliteQueryProfile::getSlowThresholdMs() const
+{
+	return m_slowThresholdMs;
+}
+
+void SqliteQueryProfile::setSlowThresholdMs(size_t thresholdMs)
+{
+	m_slowThresholdMs = thresholdMs;
+}
+
+bool SqliteQueryProfile::addExecution(const std::string& sql, long long duration, size_t rowCount)
+{
+	const std::string normalizedSql = normalizeSql(sql);
+	const bool isSlow = duration >= static_cast<long long>(m_slowThresholdMs) * 1000;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Entry& entry = m_entries[normalizedSql];
+	if (entry.sql.empty())
+	{
+		entry.sql = normalizedSql;
+	}
+
+	entry.count++;
+	entry.totalDuration += duration;
+	entry.maxDuration = std::max(entry.maxDuration, duration);
+	entry.rowCount += rowCount;
+
+	if (!isSlow)
+	{
+		return false;
+	}
+	entry.slowCount++;
+	return entry.plan.empty();
+}
+
+void SqliteQueryProfile::setPlan(const std::string& sql, const std::string& plan)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_entries.find(normalizeSql(sql));
+	if (it != m_entries.end() && it->second.plan.empty())
+	{
+		it->second.plan = plan;
+	}
+}
+
+std::vector<SqliteQueryProfile::Entry> SqliteQueryProfile::getEntries() const
+{
+	std::vector<Entry> entries;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (const auto& p: m_entries)
+		{
+			entries.push_back(p.second);
+		}
+	}
+
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+		return a.totalDuration > b.totalDuration;
+	});
+	return entries;
+}
+
+void SqliteQueryProfile::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+}
+
+std::string SqliteQueryProfile::getReport() const
+{
+	const std::vector<Entry> entries = getEntries();
+
+	std::string report = "SQLite query profile, " + std::to_string(entries.size()) +
+		" statements, slow above " + std::to_string(getSlowThresholdMs()) +
+		" ms. Durations of queries end at their first row.\n";
+
+	for (const Entry& entry: entries)
+	{
+		report += "\n" + entry.sql + "\n";
+		report += "\tcount: " + std::to_string(entry.count) +
+			", slow: " + std::to_string(entry.slowCount) +
+			", total: " + toMsString(entry.totalDuration) +
+			", average: " + toMsString(entry.totalDuration / static_cast<long long>(entry.count)) +
+			", max: " + toMsString(entry.maxDuration) +
+			", rows changed: " + std::to_string(entry.rowCount) + "\n";
+
+		for (const std::string& line: utility::splitToVector(entry.plan, "\n"))
+		{
+			if (!line.empty())
+			{
+				report += "\tplan: " + line + "\n";
+			}
+		}
+	}
+	return report;
+}
+
+bool SqliteQueryProfile::writeReport(const FilePath& filePath) const
+{
+	std::ofstream file(filePath.str(), std::ios::out | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+
+	file << getReport();
+	return bool(file);
+}
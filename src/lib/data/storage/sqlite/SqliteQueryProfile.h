@@ -0,0 +1,61 @@
+#ifndef SQLITE_QUERY_PROFILE_H
+#define SQLITE_QUERY_PROFILE_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class FilePath;
+
+// Durations of the statements run by the sqlite storages of the process, grouped by their sql with
+// literals and parameters replaced by "?". Statements slower than the threshold get the plan sqlite
+// chose for them recorded once, which shows full table scans and temporary indices. Nothing is
+// timed unless the profile is enabled.
+class SqliteQueryProfile
+{
+public:
+	struct Entry
+	{
+		std::string sql;	// normalized
+		size_t count = 0;
+		size_t slowCount = 0;
+		long long totalDuration = 0;	// microseconds
+		long long maxDuration = 0;
+		size_t rowCount = 0;	// rows changed by statements, rows of queries are not counted
+		std::string plan;	 // of the first execution above the threshold
+	};
+
+	static SqliteQueryProfile* getInstance();
+
+	static std::string normalizeSql(const std::string& sql);
+
+	SqliteQueryProfile();
+
+	bool isEnabled() const;
+	void setEnabled(bool enabled);
+
+	size_t getSlowThresholdMs() const;
+	void setSlowThresholdMs(size_t thresholdMs);
+
+	// returns true if the statement was slow and no plan is known for it yet
+	bool addExecution(const std::string& sql, long long duration, size_t rowCount);
+	void setPlan(const std::string& sql, const std::string& plan);
+
+	// ordered by total duration, slowest first
+	std::vector<Entry> getEntries() const;
+	void clear();
+
+	std::string getReport() const;
+	bool writeReport(const FilePath& filePath) const;
+
+private:
+	std::atomic<bool> m_enabled;
+	std::atomic<size_t> m_slowThresholdMs;
+
+	mutable std::mutex m_mutex;
+	std::map<std::string, Entry> m_entries;
+};
+
+#endif	  // SQLITE_QUERY_PROFILE_H
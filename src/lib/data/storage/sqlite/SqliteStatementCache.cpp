@@ -0,0 +1,94 @@
+#include "SqliteStatementCache.h"
+
+#include "logging.h"
+
+const size_t SqliteStatementCache::s_maxSize = 128;
+
+SqliteStatementCache::ScopedStatement::ScopedStatement(ScopedStatement&& other)
+	: m_cache(other.m_cache), m_sql(std::move(other.m_sql)), m_statement(other.m_statement)
+{
+	other.m_cache = nullptr;
+}
+
+SqliteStatementCache::ScopedStatement::~ScopedStatement()
+{
+	if (m_cache)
+	{
+		m_cache->release(m_sql, m_statement);
+	}
+}
+
+CppSQLite3Statement& SqliteStatementCache::ScopedStatement::get()
+{
+	return m_statement;
+}
+
+const std::string& SqliteStatementCache::ScopedStatement::getSql() const
+{
+	return m_sql;
+}
+
+SqliteStatementCache::ScopedStatement::ScopedStatement(
+	SqliteStatementCache* cache, const std::string& sql, CppSQLite3Statement statement)
+	: m_cache(cache), m_sql(sql), m_statement(statement)
+{
+}
+
+SqliteStatementCache::ScopedStatement SqliteStatementCache::acquire(
+	CppSQLite3DB& database, const std::string& sql)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_statements.find(sql);
+		if (it != m_statements.end())
+		{
+			CppSQLite3Statement statement = it->second;
+			m_statements.erase(it);
+			return ScopedStatement(this, sql, statement);
+		}
+	}
+
+	try
+	{
+		return ScopedStatement(this, sql, database.compileStatement(sql.c_str()));
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+
+	// an empty statement fails on execution and is not put back into the cache
+	return ScopedStatement(nullptr, sql, CppSQLite3Statement());
+}
+
+void SqliteStatementCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statements.clear();
+}
+
+size_t SqliteStatementCache::size() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statements.size();
+}
+
+void SqliteStatementCache::release(const std::string& sql, CppSQLite3Statement& statement)
+{
+	try
+	{
+		statement.reset();
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		// the error was already reported when stepping the statement, it can still be reused
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_statements.size() >= s_maxSize)
+	{
+		// most queries with varying text are only run once, so starting over is good enough
+		m_statements.clear();
+	}
+	m_statements.emplace(sql, statement);
+}
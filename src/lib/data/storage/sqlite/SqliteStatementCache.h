@@ -0,0 +1,52 @@
+#ifndef SQLITE_STATEMENT_CACHE_H
+#define SQLITE_STATEMENT_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "CppSQLite3.h"
+
+// Keeps compiled statements keyed by their sql text. A statement is taken out of the cache while
+// in use, so nested or concurrent queries with the same text compile their own copy.
+class SqliteStatementCache
+{
+public:
+	class ScopedStatement
+	{
+	public:
+		ScopedStatement(ScopedStatement&& other);
+		~ScopedStatement();
+
+		ScopedStatement(const ScopedStatement&) = delete;
+		ScopedStatement& operator=(const ScopedStatement&) = delete;
+
+		CppSQLite3Statement& get();
+		const std::string& getSql() const;
+
+	private:
+		friend SqliteStatementCache;
+
+		ScopedStatement(
+			SqliteStatementCache* cache, const std::string& sql, CppSQLite3Statement statement);
+
+		SqliteStatementCache* m_cache;
+		std::string m_sql;
+		CppSQLite3Statement m_statement;
+	};
+
+	ScopedStatement acquire(CppSQLite3DB& database, const std::string& sql);
+
+	void clear();
+	size_t size() const;
+
+private:
+	static const size_t s_maxSize;
+
+	void release(const std::string& sql, CppSQLite3Statement& statement);
+
+	std::multimap<std::string, CppSQLite3Statement> m_statements;
+	mutable std::mutex m_mutex;
+};
+
+#endif	  // SQLITE_STATEMENT_CACHE_H
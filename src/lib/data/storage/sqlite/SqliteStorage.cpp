@@ -1,8 +1,13 @@
 #include "SqliteStorage.h"
 
+#include <algorithm>
+
 #include "FileSystem.h"
+#include "SqliteQueryProfile.h"
 #include "TimeStamp.h"
 #include "logging.h"
+#include "tracing.h"
+#include "utility.h"
 #include "utilityString.h"
 
 SqliteStorage::SqliteStorage(const FilePath& dbFilePath): m_dbFilePath(dbFilePath.getCanonical())
@@ -19,6 +24,9 @@ SqliteStorage::SqliteStorage(const FilePath& dbFilePath): m_dbFilePath(dbFilePat
 
 SqliteStorage::~SqliteStorage()
 {
+	// the database can only be closed when all statements are finalized
+	m_statementCache.clear();
+
 	try
 	{
 		m_database.close();
@@ -32,6 +40,8 @@ SqliteStorage::~SqliteStorage()
 void SqliteStorage::setup()
 {
 	executeStatement("PRAGMA foreign_keys=ON;");
+	// only applies before the first table gets created or with the next VACUUM
+	executeStatement("PRAGMA auto_vacuum=INCREMENTAL;");
 	setupMetaTable();
 
 	if (isEmpty() || !isIncompatible())
@@ -74,22 +84,147 @@ void SqliteStorage::setVersion(size_t version)
 
 void SqliteStorage::beginTransaction()
 {
-	executeStatement("BEGIN TRANSACTION;");
+	executeStatement(m_transactionDepth ? "SAVEPOINT nested_transaction;" : "BEGIN TRANSACTION;");
+	m_transactionDepth++;
 }
 
 void SqliteStorage::commitTransaction()
 {
+	if (m_transactionDepth > 1)
+	{
+		executeStatement("RELEASE nested_transaction;");
+		m_transactionDepth--;
+		return;
+	}
+
 	executeStatement("COMMIT TRANSACTION;");
+	m_transactionDepth = 0;
 }
 
 void SqliteStorage::rollbackTransaction()
 {
+	if (m_transactionDepth > 1)
+	{
+		executeStatement("ROLLBACK TO nested_transaction;");
+		executeStatement("RELEASE nested_transaction;");
+		m_transactionDepth--;
+		return;
+	}
+
 	executeStatement("ROLLBACK TRANSACTION;");
+	m_transactionDepth = 0;
+}
+
+bool SqliteStorage::isInTransaction() const
+{
+	return m_transactionDepth > 0;
 }
 
 void SqliteStorage::optimizeMemory() const
 {
-	executeStatement("VACUUM;");
+	// sqlite cannot vacuum within a transaction
+	if (!isInTransaction())
+	{
+		executeStatement("VACUUM;");
+	}
+}
+
+size_t SqliteStorage::getPageCount() const
+{
+	return size_t(std::max(0, executeStatementScalar("PRAGMA page_count;", 0)));
+}
+
+size_t SqliteStorage::getFreePageCount() const
+{
+	return size_t(std::max(0, executeStatementScalar("PRAGMA freelist_count;", 0)));
+}
+
+bool SqliteStorage::hasIncrementalVacuum() const
+{
+	return executeStatementScalar("PRAGMA auto_vacuum;", 0) == 2;
+}
+
+bool SqliteStorage::hasCurrentStatistics() const
+{
+	return hasTable("sqlite_stat1") &&
+		getMetaValue("analyze_timestamp") == getMetaValue("timestamp");
+}
+
+bool SqliteStorage::analyze()
+{
+	if (!executeMaintenanceStatement("ANALYZE;"))
+	{
+		return false;
+	}
+	insertOrUpdateMetaValue("analyze_timestamp", getMetaValue("timestamp"));
+	return true;
+}
+
+bool SqliteStorage::incrementalVacuum(size_t pageCount)
+{
+	return executeMaintenanceStatement(
+		"PRAGMA incremental_vacuum(" + std::to_string(pageCount) + ");");
+}
+
+bool SqliteStorage::reindex()
+{
+	return executeMaintenanceStatement("REINDEX;");
+}
+
+void SqliteStorage::interrupt() const
+{
+	m_database.interrupt();
+}
+
+void SqliteStorage::applySettings(const SqliteStorageSettings& settings)
+{
+	const std::vector<std::string> journalModes = {
+		"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+	const std::vector<std::string> synchronousModes = {"OFF", "NORMAL", "FULL", "EXTRA"};
+
+	const std::string journalMode = utility::toUpperCase(settings.journalMode);
+	if (utility::containsElement(journalModes, journalMode))
+	{
+		executeStatement("PRAGMA journal_mode=" + journalMode + ";");
+	}
+	else if (!journalMode.empty())
+	{
+		LOG_WARNING("Ignoring unknown sqlite journal mode: " + settings.journalMode);
+	}
+
+	const std::string synchronous = utility::toUpperCase(settings.synchronous);
+	if (utility::containsElement(synchronousModes, synchronous))
+	{
+		executeStatement("PRAGMA synchronous=" + synchronous + ";");
+	}
+	else if (!synchronous.empty())
+	{
+		LOG_WARNING("Ignoring unknown sqlite synchronous mode: " + settings.synchronous);
+	}
+
+	if (settings.cacheSizeKb > 0)
+	{
+		// negative values are interpreted as KiB by sqlite
+		executeStatement("PRAGMA cache_size=-" + std::to_string(settings.cacheSizeKb) + ";");
+	}
+
+	if (settings.mmapSizeMb > 0)
+	{
+		executeStatement(
+			"PRAGMA mmap_size=" + std::to_string(int64_t(settings.mmapSizeMb) * 1024 * 1024) +
+			";");
+	}
+}
+
+void SqliteStorage::checkpoint()
+{
+	if (isInTransaction())
+	{
+		return;
+	}
+
+	executeStatement("PRAGMA wal_checkpoint(TRUNCATE);");
+	executeStatement("PRAGMA journal_mode=DELETE;");
 }
 
 FilePath SqliteStorage::getDbFilePath() const
@@ -155,11 +290,85 @@ void SqliteStorage::clearMetaTable()
 	}
 }
 
+bool SqliteStorage::executeMaintenanceStatement(const std::string& statement) const
+{
+	try
+	{
+		// the pragma frees pages while its rows are stepped through
+		CppSQLite3Query q = m_database.execQuery(statement.c_str());
+		while (!q.eof())
+		{
+			q.nextRow();
+		}
+	}
+	catch (CppSQLite3Exception e)
+	{
+		if (e.errorCode() == SQLITE_INTERRUPT)
+		{
+			LOG_INFO("Interrupted: " + statement);
+		}
+		else
+		{
+			LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+		}
+		return false;
+	}
+	return true;
+}
+
+long long SqliteStorage::getProfileStartTime() const
+{
+	return SqliteQueryProfile::getInstance()->isEnabled() ? TimelineTracer::now() : -1;
+}
+
+void SqliteStorage::profileExecution(
+	const std::string& sql, long long startTime, size_t rowCount) const
+{
+	if (startTime < 0)
+	{
+		return;
+	}
+
+	SqliteQueryProfile* profile = SqliteQueryProfile::getInstance();
+	if (profile->addExecution(sql, TimelineTracer::now() - startTime, rowCount))
+	{
+		profile->setPlan(sql, getQueryPlan(sql));
+	}
+}
+
+std::string SqliteStorage::getQueryPlan(const std::string& sql) const
+{
+	// runs on the database directly, the plan itself must not be profiled
+	std::string plan;
+	try
+	{
+		CppSQLite3Query q = m_database.execQuery(("EXPLAIN QUERY PLAN " + sql).c_str());
+		while (!q.eof())
+		{
+			plan += q.getStringField(3, "") + std::string("\n");
+			q.nextRow();
+		}
+	}
+	catch (CppSQLite3Exception e)
+	{
+		plan = std::string("no plan: ") + e.errorMessage();
+	}
+	return plan;
+}
+
 bool SqliteStorage::executeStatement(const std::string& statement) const
 {
+	if (statement.find(":id_list_") != std::string::npos)
+	{
+		SqliteStatementCache::ScopedStatement boundStatement = getCachedStatement(statement);
+		return executeStatement(boundStatement);
+	}
+
+	const long long startTime = getProfileStartTime();
 	try
 	{
-		m_database.execDML(statement.c_str());
+		const int rowCount = m_database.execDML(statement.c_str());
+		profileExecution(statement, startTime, rowCount);
 	}
 	catch (CppSQLite3Exception e)
 	{
@@ -185,12 +394,32 @@ bool SqliteStorage::executeStatement(CppSQLite3Statement& statement) const
 	return true;
 }
 
+bool SqliteStorage::executeStatement(SqliteStatementCache::ScopedStatement& statement) const
+{
+	const long long startTime = getProfileStartTime();
+	try
+	{
+		const int rowCount = statement.get().execDML();
+		profileExecution(statement.getSql(), startTime, rowCount);
+	}
+	catch (CppSQLite3Exception e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+		return false;
+	}
+
+	statement.get().reset();
+	return true;
+}
+
 int SqliteStorage::executeStatementScalar(const std::string& statement, const int nullValue) const
 {
+	const long long startTime = getProfileStartTime();
 	int ret = 0;
 	try
 	{
 		ret = m_database.execScalar(statement.c_str(), nullValue);
+		profileExecution(statement, startTime, 0);
 	}
 	catch (CppSQLite3Exception e)
 	{
@@ -224,9 +453,12 @@ int SqliteStorage::executeStatementScalar(CppSQLite3Statement& statement, const
 
 CppSQLite3Query SqliteStorage::executeQuery(const std::string& statement) const
 {
+	const long long startTime = getProfileStartTime();
 	try
 	{
-		return m_database.execQuery(statement.c_str());
+		CppSQLite3Query query = m_database.execQuery(statement.c_str());
+		profileExecution(statement, startTime, 0);
+		return query;
 	}
 	catch (CppSQLite3Exception e)
 	{
@@ -248,6 +480,47 @@ CppSQLite3Query SqliteStorage::executeQuery(CppSQLite3Statement& statement) cons
 	return CppSQLite3Query();
 }
 
+CppSQLite3Query SqliteStorage::executeQuery(SqliteStatementCache::ScopedStatement& statement) const
+{
+	const long long startTime = getProfileStartTime();
+	CppSQLite3Query query = executeQuery(statement.get());
+	profileExecution(statement.getSql(), startTime, 0);
+	return query;
+}
+
+SqliteStatementCache::ScopedStatement SqliteStorage::getCachedStatement(
+	const std::string& statement) const
+{
+	SqliteStatementCache::ScopedStatement cachedStatement =
+		m_statementCache.acquire(m_database, statement);
+	bindIdLists(statement, cachedStatement.get());
+	return cachedStatement;
+}
+
+void SqliteStorage::bindIdLists(const std::string& sql, CppSQLite3Statement& statement) const
+{
+	if (sql.find(":id_list_") == std::string::npos)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_idListMutex);
+	try
+	{
+		for (const IdList* idList: m_idListsInUse)
+		{
+			if (idList && !idList->m_boundIds.empty())
+			{
+				idList->bind(sql, statement);
+			}
+		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		// statements that failed to compile report their error on execution
+	}
+}
+
 bool SqliteStorage::hasTable(const std::string& tableName) const
 {
 	CppSQLite3Query q = executeQuery(
@@ -289,3 +562,102 @@ void SqliteStorage::insertOrUpdateMetaValue(const std::string& key, const std::s
 	stmt.bind(3, value.c_str());
 	executeStatement(stmt);
 }
+
+const size_t SqliteStorage::IdList::s_maxBoundIdCount = 32;
+
+SqliteStorage::IdList::IdList(const SqliteStorage* storage, const std::vector<Id>& ids)
+	: m_storage(storage)
+{
+	std::lock_guard<std::mutex> lock(m_storage->m_idListMutex);
+
+	std::vector<const IdList*>& listsInUse = m_storage->m_idListsInUse;
+	m_slot = std::find(listsInUse.begin(), listsInUse.end(), nullptr) - listsInUse.begin();
+	if (m_slot == listsInUse.size())
+	{
+		listsInUse.push_back(nullptr);
+		m_storage->m_idListTablesCreated.push_back(false);
+	}
+	listsInUse[m_slot] = this;
+
+	if (ids.size() <= s_maxBoundIdCount)
+	{
+		// lengths are rounded up to powers of two by repeating an id, id 0 is used by no element
+		size_t boundIdCount = 1;
+		while (boundIdCount < ids.size())
+		{
+			boundIdCount *= 2;
+		}
+		m_boundIds = ids;
+		m_boundIds.resize(boundIdCount, ids.empty() ? 0 : ids.back());
+		return;
+	}
+
+	if (!m_storage->m_idListTablesCreated[m_slot])
+	{
+		m_storage->m_idListTablesCreated[m_slot] = true;
+		m_storage->executeStatement(
+			"CREATE TEMP TABLE IF NOT EXISTS id_list_" + std::to_string(m_slot) +
+			"(id INTEGER, PRIMARY KEY(id));");
+	}
+
+	// the savepoint keeps all inserts in one transaction of the temp database
+	m_storage->executeStatement("SAVEPOINT fill_id_list;");
+	{
+		SqliteStatementCache::ScopedStatement statement = m_storage->getCachedStatement(
+			"INSERT OR IGNORE INTO temp.id_list_" + std::to_string(m_slot) + "(id) VALUES(?);");
+		for (Id id: ids)
+		{
+			statement.get().bind(1, int(id));
+			m_storage->executeStatement(statement);
+		}
+	}
+	m_storage->executeStatement("RELEASE fill_id_list;");
+}
+
+SqliteStorage::IdList::~IdList()
+{
+	std::lock_guard<std::mutex> lock(m_storage->m_idListMutex);
+
+	if (m_boundIds.empty())
+	{
+		m_storage->executeStatement("DELETE FROM temp.id_list_" + std::to_string(m_slot) + ";");
+	}
+	m_storage->m_idListsInUse[m_slot] = nullptr;
+}
+
+std::string SqliteStorage::IdList::getQuery() const
+{
+	if (m_boundIds.empty())
+	{
+		return "(SELECT id FROM temp.id_list_" + std::to_string(m_slot) + ")";
+	}
+
+	std::string query = "(";
+	for (size_t i = 0; i < m_boundIds.size(); i++)
+	{
+		query += (i ? ", " : "") + getParameterName(i);
+	}
+	return query + ")";
+}
+
+std::string SqliteStorage::IdList::getParameterName(size_t index) const
+{
+	return ":id_list_" + std::to_string(m_slot) + "_" + std::to_string(index);
+}
+
+void SqliteStorage::IdList::bind(const std::string& sql, CppSQLite3Statement& statement) const
+{
+	// looking up an unknown parameter name throws, so the sql text is checked first
+	const std::string firstName = getParameterName(0);
+	if (sql.find(firstName + (m_boundIds.size() > 1 ? "," : ")")) == std::string::npos)
+	{
+		return;
+	}
+	const int firstIndex = statement.bindParameterIndex(firstName.c_str());
+
+	// parameters of a list are numbered in order from the first one
+	for (size_t i = 0; i < m_boundIds.size(); i++)
+	{
+		statement.bind(firstIndex + int(i), int(m_boundIds[i]));
+	}
+}
@@ -1,10 +1,16 @@
 #ifndef SQLITE_STORAGE_H
 #define SQLITE_STORAGE_H
 
+#include <mutex>
+#include <vector>
+
 #include "CppSQLite3.h"
 
 #include "FilePath.h"
 #include "SqliteDatabaseIndex.h"
+#include "SqliteStatementCache.h"
+#include "SqliteStorageSettings.h"
+#include "types.h"
 
 class SqliteStorageMigration;
 class TimeStamp;
@@ -21,12 +27,38 @@ public:
 	size_t getVersion() const;
 	void setVersion(size_t version);
 
+	// transactions begun within a transaction are nested as savepoints
 	void beginTransaction();
 	void commitTransaction();
 	void rollbackTransaction();
+	bool isInTransaction() const;
 
+	// does nothing within a transaction
 	void optimizeMemory() const;
 
+	// pages of the database file and the unused ones among them
+	size_t getPageCount() const;
+	size_t getFreePageCount() const;
+	// free pages can be released in steps, databases created before only switch with a VACUUM
+	bool hasIncrementalVacuum() const;
+
+	// false if the query planner statistics are missing or older than the last indexing
+	bool hasCurrentStatistics() const;
+
+	// return false if they failed or got interrupted, which rolls back their changes
+	bool analyze();
+	bool incrementalVacuum(size_t pageCount);
+	bool reindex();
+
+	// aborts the statement running on this connection, may be called from any thread
+	void interrupt() const;
+
+	void applySettings(const SqliteStorageSettings& settings);
+
+	// moves all content of the write-ahead log into the database file and leaves wal mode, so the
+	// file can be copied or renamed on its own, does nothing within a transaction
+	void checkpoint();
+
 	FilePath getDbFilePath() const;
 
 	bool isEmpty() const;
@@ -36,6 +68,37 @@ public:
 	TimeStamp getTime() const;
 
 protected:
+	// Selects ids for the IN clause of a query for as long as it exists. Small lists are bound as
+	// parameters, padded to a few fixed lengths, and larger lists are filled into a temporary
+	// table to join with. Either way queries keep the same sql text for lists of similar size, so
+	// they can be cached, and they don't hit sqlite's limits on the statement length or the number
+	// of parameters. The parameters get bound to all statements taken from getCachedStatement or
+	// run with executeStatement.
+	class IdList
+	{
+	public:
+		IdList(const SqliteStorage* storage, const std::vector<Id>& ids);
+		~IdList();
+
+		IdList(const IdList&) = delete;
+		IdList& operator=(const IdList&) = delete;
+
+		// subquery to use with IN, e.g. "WHERE id IN " + getQuery()
+		std::string getQuery() const;
+
+	private:
+		friend SqliteStorage;
+
+		static const size_t s_maxBoundIdCount;
+
+		std::string getParameterName(size_t index) const;
+		void bind(const std::string& sql, CppSQLite3Statement& statement) const;
+
+		const SqliteStorage* m_storage;
+		size_t m_slot;
+		std::vector<Id> m_boundIds;
+	};
+
 	void setupMetaTable();
 	void clearMetaTable();
 
@@ -46,6 +109,13 @@ protected:
 	CppSQLite3Query executeQuery(const std::string& statement) const;
 	CppSQLite3Query executeQuery(CppSQLite3Statement& statement) const;
 
+	// statements of the cache are added to the SqliteQueryProfile with their sql, the others are not
+	bool executeStatement(SqliteStatementCache::ScopedStatement& statement) const;
+	CppSQLite3Query executeQuery(SqliteStatementCache::ScopedStatement& statement) const;
+
+	// the returned statement needs to outlive all queries executed on it
+	SqliteStatementCache::ScopedStatement getCachedStatement(const std::string& statement) const;
+
 	bool hasTable(const std::string& tableName) const;
 
 	std::string getMetaValue(const std::string& key) const;
@@ -60,9 +130,27 @@ private:
 	virtual void setupTables() = 0;
 	virtual void setupPrecompiledStatements() = 0;
 
+	// interruptions are expected and don't get logged as errors
+	bool executeMaintenanceStatement(const std::string& statement) const;
+
+	// returns -1 if the SqliteQueryProfile is disabled
+	long long getProfileStartTime() const;
+	void profileExecution(const std::string& sql, long long startTime, size_t rowCount) const;
+	std::string getQueryPlan(const std::string& sql) const;
+
 	std::vector<std::pair<int, SqliteDatabaseIndex>> m_indices;
 
 	bool m_precompiledStatementsInitialized = false;
+	size_t m_transactionDepth = 0;
+
+	mutable SqliteStatementCache m_statementCache;
+
+	// binds the parameters of the bound id lists used in the statement
+	void bindIdLists(const std::string& sql, CppSQLite3Statement& statement) const;
+
+	mutable std::mutex m_idListMutex;
+	mutable std::vector<const IdList*> m_idListsInUse;
+	mutable std::vector<bool> m_idListTablesCreated;
 
 	friend SqliteStorageMigration;
 };
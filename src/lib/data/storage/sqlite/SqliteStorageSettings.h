@@ -0,0 +1,27 @@
+#ifndef SQLITE_STORAGE_SETTINGS_H
+#define SQLITE_STORAGE_SETTINGS_H
+
+#include <string>
+#include <utility>
+
+// Connection pragmas of a SqliteStorage. Empty strings and zero values keep the SQLite defaults.
+struct SqliteStorageSettings
+{
+	SqliteStorageSettings() = default;
+
+	SqliteStorageSettings(
+		std::string journalMode, std::string synchronous, int cacheSizeKb, int mmapSizeMb)
+		: journalMode(std::move(journalMode))
+		, synchronous(std::move(synchronous))
+		, cacheSizeKb(cacheSizeKb)
+		, mmapSizeMb(mmapSizeMb)
+	{
+	}
+
+	std::string journalMode;	// DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF
+	std::string synchronous;	// OFF, NORMAL, FULL or EXTRA
+	int cacheSizeKb = 0;
+	int mmapSizeMb = 0;
+};
+
+#endif	  // SQLITE_STORAGE_SETTINGS_H
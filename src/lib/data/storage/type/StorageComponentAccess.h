@@ -1,6 +1,7 @@
 #ifndef STORAGE_COMPONENT_ACCESS_H
 #define STORAGE_COMPONENT_ACCESS_H
 
+#include "StorageField.h"
 #include "types.h"
 
 struct StorageComponentAccess
@@ -14,6 +15,18 @@ struct StorageComponentAccess
 		return nodeId < other.nodeId;
 	}
 
+	static const char* getTableName()
+	{
+		return "component_access";
+	}
+
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("node_id", &StorageComponentAccess::nodeId),
+			makeStorageField("type", &StorageComponentAccess::type));
+	}
+
 	Id nodeId;
 	int type;
 };
@@ -1,6 +1,7 @@
 #ifndef STORAGE_EDGE_H
 #define STORAGE_EDGE_H
 
+#include "StorageField.h"
 #include "types.h"
 
 struct StorageEdgeData
@@ -44,6 +45,20 @@ struct StorageEdge: public StorageEdgeData
 	{
 	}
 
+	static const char* getTableName()
+	{
+		return "edge";
+	}
+
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("id", &StorageEdge::id),
+			makeStorageField("type", &StorageEdge::type),
+			makeStorageField("source_node_id", &StorageEdge::sourceNodeId),
+			makeStorageField("target_node_id", &StorageEdge::targetNodeId));
+	}
+
 	Id id;
 };
 
@@ -0,0 +1,52 @@
+#ifndef STORAGE_FIELD_H
+#define STORAGE_FIELD_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+// A column of a storage table together with the member of the storage type that holds it. The
+// storage types list their fields in a constexpr tuple in the order of the columns, so the code that
+// binds, reads and serializes them is generated for each type and can be inlined.
+template <typename OwnerType, typename MemberType>
+struct StorageField
+{
+	typedef MemberType Type;
+
+	const char* column;
+	MemberType OwnerType::*member;
+};
+
+template <typename OwnerType, typename MemberType>
+constexpr StorageField<OwnerType, MemberType> makeStorageField(
+	const char* column, MemberType OwnerType::*member)
+{
+	return {column, member};
+}
+
+namespace utility
+{
+template <typename FieldsType, typename FuncType, size_t... Indices>
+void forEachStorageField(const FieldsType& fields, FuncType& func, std::index_sequence<Indices...>)
+{
+	(void)std::initializer_list<int> {(func(Indices, std::get<Indices>(fields)), 0)...};
+}
+
+// calls func with the index and the StorageField of each field of the storage type
+template <typename StorageType, typename FuncType>
+void forEachStorageField(FuncType&& func)
+{
+	constexpr auto fields = StorageType::getFields();
+	forEachStorageField(
+		fields, func, std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+}
+
+template <typename StorageType>
+constexpr size_t getStorageFieldCount()
+{
+	return std::tuple_size<decltype(StorageType::getFields())>::value;
+}
+}	 // namespace utility
+
+#endif	  // STORAGE_FIELD_H
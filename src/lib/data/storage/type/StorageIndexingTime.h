@@ -0,0 +1,59 @@
+#ifndef STORAGE_INDEXING_TIME_H
+#define STORAGE_INDEXING_TIME_H
+
+#include <string>
+
+// cost of indexing the translation unit of a source file, used to schedule the next run and to
+// report the files that dominate an indexing run
+struct StorageIndexingTime
+{
+	StorageIndexingTime()
+		: filePath(L"")
+		, durationMs(0)
+		, parseDurationMs(0)
+		, visitDurationMs(0)
+		, peakMemoryKb(0)
+		, storageByteCount(0)
+		, garbageCollectionDurationMs(0)
+	{
+	}
+
+	StorageIndexingTime(std::wstring filePath, size_t durationMs)
+		: filePath(std::move(filePath))
+		, durationMs(durationMs)
+		, parseDurationMs(durationMs)
+		, visitDurationMs(0)
+		, peakMemoryKb(0)
+		, storageByteCount(0)
+		, garbageCollectionDurationMs(0)
+	{
+	}
+
+	StorageIndexingTime(
+		std::wstring filePath,
+		size_t durationMs,
+		size_t parseDurationMs,
+		size_t visitDurationMs,
+		size_t peakMemoryKb,
+		size_t storageByteCount,
+		size_t garbageCollectionDurationMs = 0)
+		: filePath(std::move(filePath))
+		, durationMs(durationMs)
+		, parseDurationMs(parseDurationMs)
+		, visitDurationMs(visitDurationMs)
+		, peakMemoryKb(peakMemoryKb)
+		, storageByteCount(storageByteCount)
+		, garbageCollectionDurationMs(garbageCollectionDurationMs)
+	{
+	}
+
+	std::wstring filePath;
+	size_t durationMs;
+	size_t parseDurationMs;
+	size_t visitDurationMs;
+	size_t peakMemoryKb;	// peak resident memory of the indexing process so far
+	size_t storageByteCount;
+	size_t garbageCollectionDurationMs;	   // part of the duration the JVM spent collecting garbage
+};
+
+#endif	  // STORAGE_INDEXING_TIME_H
@@ -2,21 +2,37 @@
 #define STORAGE_LOCAL_SYMBOL_H
 
 #include <string>
+#include <tuple>
 
+#include "StorageField.h"
 #include "types.h"
 
+// local symbols are identified by the location of their declaration, the ones recorded by indexers
+// that only know a name of the symbol have no file and are identified by that name
 struct StorageLocalSymbolData
 {
-	StorageLocalSymbolData(): name(L"") {}
+	StorageLocalSymbolData(): name(L""), fileNodeId(0), startLine(0), startCol(0) {}
 
-	StorageLocalSymbolData(std::wstring name): name(std::move(name)) {}
+	StorageLocalSymbolData(std::wstring name)
+		: name(std::move(name)), fileNodeId(0), startLine(0), startCol(0)
+	{
+	}
+
+	StorageLocalSymbolData(Id fileNodeId, size_t startLine, size_t startCol)
+		: name(L""), fileNodeId(fileNodeId), startLine(startLine), startCol(startCol)
+	{
+	}
 
 	bool operator<(const StorageLocalSymbolData& other) const
 	{
-		return name < other.name;
+		return std::tie(fileNodeId, startLine, startCol, name) <
+			std::tie(other.fileNodeId, other.startLine, other.startCol, other.name);
 	}
 
 	std::wstring name;
+	Id fileNodeId;
+	size_t startLine;
+	size_t startCol;
 };
 
 struct StorageLocalSymbol: public StorageLocalSymbolData
@@ -30,6 +46,21 @@ struct StorageLocalSymbol: public StorageLocalSymbolData
 
 	StorageLocalSymbol(Id id, std::wstring name): StorageLocalSymbolData(std::move(name)), id(id) {}
 
+	static const char* getTableName()
+	{
+		return "local_symbol";
+	}
+
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("id", &StorageLocalSymbol::id),
+			makeStorageField("name", &StorageLocalSymbol::name),
+			makeStorageField("file_node_id", &StorageLocalSymbol::fileNodeId),
+			makeStorageField("start_line", &StorageLocalSymbol::startLine),
+			makeStorageField("start_column", &StorageLocalSymbol::startCol));
+	}
+
 	Id id;
 };
 
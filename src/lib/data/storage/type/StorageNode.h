@@ -3,13 +3,14 @@
 
 #include <string>
 
+#include "StorageField.h"
 #include "types.h"
 
 struct StorageNodeData
 {
-	StorageNodeData(): type(0), serializedName(L"") {}
+	StorageNodeData(): type(0) {}
 
-	StorageNodeData(int type, std::wstring serializedName)
+	StorageNodeData(int type, std::string serializedName)
 		: type(type), serializedName(std::move(serializedName))
 	{
 	}
@@ -20,20 +21,33 @@ struct StorageNodeData
 	}
 
 	int type;
-	std::wstring serializedName;
+	std::string serializedName;	   // binary serialization of the NameHierarchy
 };
 
 struct StorageNode: public StorageNodeData
 {
 	StorageNode(): StorageNodeData(), id(0) {}
 
-	StorageNode(Id id, int type, std::wstring serializedName)
+	StorageNode(Id id, int type, std::string serializedName)
 		: StorageNodeData(type, std::move(serializedName)), id(id)
 	{
 	}
 
 	StorageNode(Id id, const StorageNodeData& data): StorageNodeData(data), id(id) {}
 
+	static const char* getTableName()
+	{
+		return "node";
+	}
+
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("id", &StorageNode::id),
+			makeStorageField("type", &StorageNode::type),
+			makeStorageField("serialized_name", &StorageNode::serializedName));
+	}
+
 	Id id;
 };
 
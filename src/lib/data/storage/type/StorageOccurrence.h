@@ -1,6 +1,7 @@
 #ifndef STORAGE_OCCURRENCE_H
 #define STORAGE_OCCURRENCE_H
 
+#include "StorageField.h"
 #include "types.h"
 
 struct StorageOccurrence
@@ -24,6 +25,18 @@ struct StorageOccurrence
 		}
 	}
 
+	static const char* getTableName()
+	{
+		return "occurrence";
+	}
+
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("element_id", &StorageOccurrence::elementId),
+			makeStorageField("source_location_id", &StorageOccurrence::sourceLocationId));
+	}
+
 	Id elementId;
 	Id sourceLocationId;
 };
@@ -1,6 +1,7 @@
 #ifndef STORAGE_SOURCE_LOCATION_H
 #define STORAGE_SOURCE_LOCATION_H
 
+#include "StorageField.h"
 #include "types.h"
 
 struct StorageSourceLocationData
@@ -49,6 +50,23 @@ struct StorageSourceLocationData
 		}
 	}
 
+	static const char* getTableName()
+	{
+		return "source_location";
+	}
+
+	// the id is assigned by the database when the location is inserted
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("file_node_id", &StorageSourceLocationData::fileNodeId),
+			makeStorageField("start_line", &StorageSourceLocationData::startLine),
+			makeStorageField("start_column", &StorageSourceLocationData::startCol),
+			makeStorageField("end_line", &StorageSourceLocationData::endLine),
+			makeStorageField("end_column", &StorageSourceLocationData::endCol),
+			makeStorageField("type", &StorageSourceLocationData::type));
+	}
+
 	Id fileNodeId;
 	size_t startLine;
 	size_t startCol;
@@ -72,6 +90,13 @@ struct StorageSourceLocation: public StorageSourceLocationData
 	{
 	}
 
+	static constexpr auto getFields()
+	{
+		return std::tuple_cat(
+			std::make_tuple(makeStorageField("id", &StorageSourceLocation::id)),
+			StorageSourceLocationData::getFields());
+	}
+
 	Id id;
 };
 
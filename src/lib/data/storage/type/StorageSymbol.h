@@ -2,6 +2,7 @@
 #define STORAGE_SYMBOL_H
 
 #include "DefinitionKind.h"
+#include "StorageField.h"
 #include "types.h"
 
 struct StorageSymbol
@@ -10,6 +11,18 @@ struct StorageSymbol
 
 	StorageSymbol(Id id, int definitionKind): id(id), definitionKind(definitionKind) {}
 
+	static const char* getTableName()
+	{
+		return "symbol";
+	}
+
+	static constexpr auto getFields()
+	{
+		return std::make_tuple(
+			makeStorageField("id", &StorageSymbol::id),
+			makeStorageField("definition_kind", &StorageSymbol::definitionKind));
+	}
+
 	Id id;
 	int definitionKind;
 };
@@ -1,10 +1,16 @@
 #include "Project.h"
 
+#include <algorithm>
+
 #include "ApplicationSettings.h"
 #include "CombinedIndexerCommandProvider.h"
 #include "DialogView.h"
 #include "IndexerCommand.h"
 #include "IndexerCommandCustom.h"
+#include "IndexerProcessPool.h"
+#include "IndexingCheckpoint.h"
+#include "IndexingThrottle.h"
+#include "IntermediateStorage.h"
 #include "PersistentStorage.h"
 #include "ProjectSettings.h"
 #include "RefreshInfoGenerator.h"
@@ -12,6 +18,7 @@
 #include "SourceGroupFactory.h"
 #include "SourceGroupStatusType.h"
 #include "StorageCache.h"
+#include "StorageCacheSnapshot.h"
 #include "StorageProvider.h"
 #include "TaskBuildIndex.h"
 #include "TaskCleanStorage.h"
@@ -19,11 +26,14 @@
 #include "TaskFillIndexerCommandQueue.h"
 #include "TaskFinishParsing.h"
 #include "TaskInjectStorage.h"
+#include "TaskMaintainStorage.h"
 #include "TaskMergeStorages.h"
 #include "TaskParseWrapper.h"
 
+#include "FileInfo.h"
 #include "FilePath.h"
 #include "FileSystem.h"
+#include "FileSystemWatcher.h"
 #include "MessageErrorCountClear.h"
 #include "MessageIndexingFinished.h"
 #include "MessageIndexingShowDialog.h"
@@ -38,13 +48,17 @@
 #include "TaskGroupSelector.h"
 #include "TaskGroupSequence.h"
 #include "TaskLambda.h"
+#include "TaskManager.h"
 #include "TaskReturnSuccessIf.h"
 #include "TaskSetValue.h"
 #include "TextAccess.h"
+#include "ThreadPool.h"
 #include "utility.h"
 #include "utilityApp.h"
 #include "utilityFile.h"
 #include "utilityString.h"
+#include "utilitySystemResources.h"
+#include "utilityUuid.h"
 
 Project::Project(
 	std::shared_ptr<ProjectSettings> settings,
@@ -55,6 +69,8 @@ Project::Project(
 	, m_storageCache(storageCache)
 	, m_state(PROJECT_STATE_NOT_LOADED)
 	, m_refreshStage(RefreshStageType::NONE)
+	, m_fileSystemChangesSynchronized(false)
+	, m_resumesIndexing(false)
 	, m_appUUID(appUUID)
 	, m_hasGUI(hasGUI)
 {
@@ -132,9 +148,21 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 	{
 		if (tempDbPath.exists())
 		{
+			IndexingCheckpoint checkpoint(IndexingCheckpoint::getFilePath(tempDbPath));
+			const bool resumable = checkpoint.exists();
+			if (resumable)
+			{
+				LOG_INFO(
+					"Found checkpoint of interrupted indexing with " +
+					std::to_string(checkpoint.getCompletedSourceFilePaths().size()) +
+					" indexed source files");
+			}
+
 			if (dbPath.exists())
 			{
-				if (dialogView->confirm(
+				// runs without gui continue the interrupted indexing run
+				if ((resumable && !m_hasGUI) ||
+					dialogView->confirm(
 						L"Sourcetrail has been closed unexpectedly while indexing this project. "
 						L"You can either choose to keep "
 						L"the data that has already been indexed or discard that data and restore "
@@ -149,12 +177,14 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 						MessageStatus(L"Unable to load project", true, false).dispatch();
 						return;
 					}
+					m_resumesIndexing = resumable;
 				}
 				else
 				{
 					LOG_INFO("Discarding temporary indexing data on user's decision");
 					FileSystem::remove(tempDbPath);
 				}
+				checkpoint.remove();
 			}
 			else
 			{
@@ -162,11 +192,19 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 					"Switching to temporary indexing data because no other persistent data was "
 					"found");
 				FileSystem::rename(tempDbPath, dbPath);
+				checkpoint.remove();
+				m_resumesIndexing = resumable;
 			}
 		}
 	}
 
 	m_storage = std::make_shared<PersistentStorage>(dbPath, bookmarkDbPath);
+	m_storage->applyStorageSettings(
+		ApplicationSettings::getInstance()->getBrowsingStorageSettings(),
+		ApplicationSettings::getInstance()->getBookmarkStorageSettings());
+	m_storage->setReadConnectionCount(
+		size_t(std::max(0, ApplicationSettings::getInstance()->getStorageReadConnectionCount())));
+	m_storage->setCacheSnapshotFilePath(getCacheSnapshotFilePath());
 
 	bool canLoad = false;
 
@@ -222,10 +260,17 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 	{
 		m_storage->setMode(SqliteIndexStorage::STORAGE_MODE_READ);
 		m_storage->buildCaches();
+		if (ApplicationSettings::getInstance()->getIndexReplicaEnabled())
+		{
+			m_storage->startBuildingIndexReplica();
+		}
 		m_storageCache->setSubject(m_storage);
 
+		updateWatchedDirectories();
+
 		if (m_hasGUI)
 		{
+			startStorageMaintenance();
 			MessageIndexingFinished().dispatch();
 		}
 		MessageStatus(L"Finished Loading", false, false).dispatch();
@@ -272,7 +317,11 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 	}
 }
 
-void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refreshMode, bool shallowIndexingRequested)
+void Project::refresh(
+	std::shared_ptr<DialogView> dialogView,
+	RefreshMode refreshMode,
+	bool shallowIndexingRequested,
+	const IndexShard& shard)
 {
 	if (m_refreshStage != RefreshStageType::NONE)
 	{
@@ -366,20 +415,14 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
 		m_settings->migrate();
 	}
 
-	m_settings->reload();
-
-	m_sourceGroups = SourceGroupFactory::getInstance()->createSourceGroups(
-		m_settings->getAllSourceGroupSettings());
-	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+	if (!prepareSourceGroups())
 	{
-		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED && !sourceGroup->prepareIndexing())
-		{
-			m_refreshStage = RefreshStageType::NONE;
-			return;
-		}
+		m_refreshStage = RefreshStageType::NONE;
+		return;
 	}
 
-	if (needsFullRefresh || fullRefresh)
+	// shards always start from an empty database
+	if (needsFullRefresh || fullRefresh || shard.isPartial())
 	{
 		refreshMode = REFRESH_ALL_FILES;
 	}
@@ -387,6 +430,13 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
 	{
 		refreshMode = REFRESH_UPDATED_FILES;
 	}
+	else if (refreshMode == REFRESH_ALL_FILES && m_resumesIndexing)
+	{
+		// the files missing from the kept data are indexed like new ones
+		LOG_INFO("Resuming the interrupted indexing run");
+		refreshMode = REFRESH_UPDATED_FILES;
+	}
+	m_resumesIndexing = false;
 
 	bool allowsShallowIndexing = false;
 	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
@@ -423,27 +473,95 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
 	{
 		RefreshInfo info = getRefreshInfo(refreshMode);
 		info.shallow = useShallowIndexing;
+		if (shard.isPartial())
+		{
+			info = RefreshInfoGenerator::getRefreshInfoForShard(info, shard);
+		}
 		buildIndex(info, dialogView);
 	}
 }
 
+void Project::refreshInBackground(
+	std::shared_ptr<DialogView> dialogView, const std::set<FilePath>& changedFilePaths)
+{
+	if (m_refreshStage != RefreshStageType::NONE || m_state != PROJECT_STATE_LOADED)
+	{
+		return;
+	}
+
+	m_refreshStage = RefreshStageType::REFRESHING;
+
+	if (!prepareSourceGroups())
+	{
+		m_refreshStage = RefreshStageType::NONE;
+		return;
+	}
+
+	RefreshInfo info;
+	if (changedFilePaths.empty())
+	{
+		info = getRefreshInfo(REFRESH_UPDATED_FILES);
+	}
+	else
+	{
+		std::set<FilePath> directoryPaths;
+		for (const FilePath& filePath: changedFilePaths)
+		{
+			directoryPaths.insert(filePath.getCanonical().getParentDirectory());
+		}
+		info = RefreshInfoGenerator::getRefreshInfoForChangedDirectories(
+			m_sourceGroups, m_storage, directoryPaths);
+	}
+
+	if (info.filesToIndex.empty() && info.filesToClear.empty() && info.filesToMoveLocations.empty())
+	{
+		synchronizeFileSystemChanges(info);
+		m_refreshStage = RefreshStageType::NONE;
+		return;
+	}
+
+	LOG_INFO("Refreshing updated files in the background");
+	buildIndex(info, dialogView);
+}
+
 RefreshInfo Project::getRefreshInfo(RefreshMode mode) const
 {
+	const bool tracksFileSystemChanges = m_fileSystemWatcher && m_fileSystemWatcher->isWatching();
+	const size_t fileSystemChangeCount = tracksFileSystemChanges
+		? m_fileSystemWatcher->getChangeCount()
+		: 0;
+
+	RefreshInfo info;
 	switch (mode)
 	{
 	case REFRESH_NONE:
-		return RefreshInfo();
+		return info;
 
 	case REFRESH_UPDATED_FILES:
-		return RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+		if (tracksFileSystemChanges && m_fileSystemChangesSynchronized)
+		{
+			info = RefreshInfoGenerator::getRefreshInfoForChangedDirectories(
+				m_sourceGroups, m_storage, m_fileSystemWatcher->getChangedDirectories());
+		}
+		else
+		{
+			info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+		}
+		break;
 
 	case REFRESH_UPDATED_AND_INCOMPLETE_FILES:
-		return RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(m_sourceGroups, m_storage);
+		info = RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(m_sourceGroups, m_storage);
+		break;
 
 	case REFRESH_ALL_FILES:
 	default:
-		return RefreshInfoGenerator::getRefreshInfoForAllFiles(m_sourceGroups);
+		info = RefreshInfoGenerator::getRefreshInfoForAllFiles(m_sourceGroups);
+		break;
 	}
+
+	info.coversFileSystemChanges = tracksFileSystemChanges;
+	info.fileSystemChangeCount = fileSystemChangeCount;
+	return info;
 }
 
 void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogView)
@@ -454,9 +572,21 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		return;
 	}
 
+	synchronizeFileSystemChanges(info);
+
+	const FilePath indexDeltaFilePath = m_indexDeltaFilePath;
+	m_indexDeltaFilePath = FilePath();
+	if (!indexDeltaFilePath.empty())
+	{
+		// clients apply the delta without the file contents on disk to move locations to
+		info = RefreshInfoGenerator::getRefreshInfoWithoutMovedLocations(
+			info, m_sourceGroups, m_storage);
+	}
+
 	{
 		std::wstring message;
-		if (info.mode != REFRESH_ALL_FILES && info.filesToClear.empty() && info.filesToIndex.empty())
+		if (info.mode != REFRESH_ALL_FILES && info.filesToClear.empty() && info.filesToIndex.empty() &&
+			info.filesToMoveLocations.empty())
 		{
 			message = L"Nothing to refresh, all files are up-to-date.";
 		}
@@ -539,19 +669,57 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	m_storageCache->clear();
 	m_storageCache->setSubject(m_storage);
 
-	const FilePath indexDbFilePath = m_settings->getDBFilePath();
-	const FilePath tempIndexDbFilePath = m_settings->getTempDBFilePath();
-
-	if (info.mode != REFRESH_ALL_FILES)
+	m_indexShard = info.shard;
+	const FilePath indexDbFilePath = getIndexDbFilePath();
+	const FilePath tempIndexDbFilePath = getTempIndexDbFilePath();
+
+	const SqliteStorageSettings browsingStorageSettings =
+		ApplicationSettings::getInstance()->getBrowsingStorageSettings();
+	const bool inPlaceRefresh = info.mode != REFRESH_ALL_FILES &&
+		ApplicationSettings::getInstance()->getInPlaceRefreshEnabled() &&
+		utility::toUpperCase(browsingStorageSettings.journalMode) == "WAL";
+
+	SqliteStorageSettings indexingStorageSettings =
+		ApplicationSettings::getInstance()->getIndexingStorageSettings();
+	std::shared_ptr<PersistentStorage> tempStorage;
+	std::shared_ptr<IndexingCheckpoint> checkpoint;
+	if (inPlaceRefresh)
 	{
-		// store the indexed data into the temp db but keep the current state to allow browsing
-		// while indexing
-		FileSystem::copyFile(indexDbFilePath, tempIndexDbFilePath);
+		// the indexed data is written into the current db within one transaction, browsing keeps
+		// reading the state before it until the data is kept. The current db has to stay
+		// consistent on a crash.
+		LOG_INFO("Refreshing the index database in place");
+		m_storage->applyStorageSettings(
+			browsingStorageSettings,
+			ApplicationSettings::getInstance()->getBookmarkStorageSettings());
+		indexingStorageSettings.journalMode = browsingStorageSettings.journalMode;
+		indexingStorageSettings.synchronous = browsingStorageSettings.synchronous;
+
+		tempStorage = std::make_shared<PersistentStorage>(
+			indexDbFilePath, m_storage->getBookmarkDbFilePath());
 	}
+	else
+	{
+		if (info.mode != REFRESH_ALL_FILES)
+		{
+			// store the indexed data into the temp db but keep the current state to allow
+			// browsing while indexing
+			m_storage->checkpoint();
+			FileSystem::copyFile(indexDbFilePath, tempIndexDbFilePath);
+		}
 
-	std::shared_ptr<PersistentStorage> tempStorage = std::make_shared<PersistentStorage>(
-		tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
+		tempStorage = std::make_shared<PersistentStorage>(
+			tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
+		checkpoint = std::make_shared<IndexingCheckpoint>(
+			IndexingCheckpoint::getFilePath(tempIndexDbFilePath));
+	}
+	tempStorage->applyStorageSettings(
+		indexingStorageSettings, ApplicationSettings::getInstance()->getBookmarkStorageSettings());
 	tempStorage->setup();
+	if (inPlaceRefresh)
+	{
+		tempStorage->startRefreshTransaction();
+	}
 
 	std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
 
@@ -565,10 +733,40 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			info.mode == REFRESH_UPDATED_AND_INCOMPLETE_FILES));
 	}
 
+	if (info.mode != REFRESH_ALL_FILES && info.filesToMoveLocations.size())
+	{
+		const std::set<FilePath> filesToMoveLocations = info.filesToMoveLocations;
+		taskSequential->addTask(std::make_shared<TaskLambda>([tempStorage, filesToMoveLocations]() {
+			for (const FilePath& filePath: filesToMoveLocations)
+			{
+				if (!tempStorage->moveLocationsToCurrentContent(filePath))
+				{
+					LOG_WARNING(
+						L"Unable to move locations of file \"" + filePath.wstr() +
+						L"\", its locations may be outdated until it is re-indexed.");
+				}
+			}
+		}));
+	}
+
 	tempStorage->setProjectSettingsText(
 		TextAccess::createFromFile(getProjectSettingsFilePath())->getText());
 	tempStorage->updateVersion();
 
+	const std::string baseRevision = m_storage->getRevision();
+	const std::string revision = utility::getUuidString();
+	tempStorage->setRevision(revision);
+	if (checkpoint)
+	{
+		checkpoint->start(revision);
+	}
+
+	std::shared_ptr<PersistentStorage> deltaStorage;
+	if (!indexDeltaFilePath.empty())
+	{
+		deltaStorage = createIndexDeltaStorage(indexDeltaFilePath, info, revision);
+	}
+
 	std::unique_ptr<CombinedIndexerCommandProvider> indexerCommandProvider =
 		std::make_unique<CombinedIndexerCommandProvider>();
 	std::unique_ptr<CombinedIndexerCommandProvider> customIndexerCommandProvider =
@@ -603,6 +801,8 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	taskSequential->addTask(std::make_shared<TaskSetValue<int>>("indexed_source_file_count", 0));
 	taskSequential->addTask(std::make_shared<TaskSetValue<bool>>("interrupted_indexing", false));
 	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("index_time", 0.0f));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("merge_time", 0.0f));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("inject_time", 0.0f));
 
 	int indexerThreadCount = ApplicationSettings::getInstance()->getIndexerThreadCount();
 	if (indexerThreadCount <= 0)
@@ -612,6 +812,22 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		{
 			indexerThreadCount = 4;	   // setting to some fallback value
 		}
+
+		// every indexer process may use up to its limit, which all of them share in a container
+		const unsigned long long memoryLimit = utility::getCgroupMemoryLimit();
+		const int processMemoryLimitMb =
+			ApplicationSettings::getInstance()->getIndexerProcessMemoryLimitMb();
+		if (memoryLimit > 0 && processMemoryLimitMb > 0)
+		{
+			const unsigned long long processMemoryLimit =
+				static_cast<unsigned long long>(processMemoryLimitMb) * 1024 * 1024;
+			indexerThreadCount = std::max(
+				1, std::min(indexerThreadCount, int(memoryLimit / processMemoryLimit)));
+			LOG_INFO(
+				"Using " + std::to_string(indexerThreadCount) +
+				" indexers for a memory limit of " + std::to_string(memoryLimit / 1024 / 1024) +
+				" MB");
+		}
 	}
 
 	if (!indexerCommandProvider->empty())
@@ -620,6 +836,14 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			indexerThreadCount, indexerCommandProvider->size());
 
 		std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+		const int storageMemoryBudgetMb =
+			ApplicationSettings::getInstance()->getStorageMemoryBudgetMb();
+		if (storageMemoryBudgetMb > 0)
+		{
+			storageProvider->setMemoryBudget(
+				size_t(storageMemoryBudgetMb) * 1024 * 1024,
+				FilePath(tempIndexDbFilePath.wstr() + L"_storages"));
+		}
 		// add tasks for setting some variables on the blackboard that are used during indexing
 		taskSequential->addTask(
 			std::make_shared<TaskSetValue<bool>>("indexer_threads_started", false));
@@ -641,20 +865,53 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		}
 
 		std::shared_ptr<TaskParseWrapper> taskParserWrapper = std::make_shared<TaskParseWrapper>(
-			tempStorage, dialogView);
+			tempStorage, dialogView, info.mode == REFRESH_ALL_FILES);
 		taskSequential->addTask(taskParserWrapper);
 
 		std::shared_ptr<TaskGroupParallel> taskParallelIndexing =
 			std::make_shared<TaskGroupParallel>();
 		taskParserWrapper->setTask(taskParallelIndexing);
 
+		// times from the last run are still available in the current storage, also for full
+		// re-indexes
+		std::map<std::wstring, size_t> previousIndexingTimesMs;
+		for (const StorageIndexingTime& indexingTime: m_storage->getIndexingTimes())
+		{
+			previousIndexingTimesMs.emplace(indexingTime.filePath, indexingTime.durationMs);
+		}
+
+		// only indexing in the gui competes with a user browsing the previous index
+		IndexingThrottle::getInstance()->setEnabled(
+			m_hasGUI && ApplicationSettings::getInstance()->getIndexingInteractivePriorityEnabled());
+
+		std::shared_ptr<IndexerProcessPool> processPool;
+		if (ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() &&
+			hasCxxSourceGroup())
+		{
+			if (!m_indexerProcessPool ||
+				m_indexerProcessPool->getProcessCount() != size_t(indexerThreadCount))
+			{
+				// the old pool has to release the shared memory before the new one creates it
+				m_indexerProcessPool.reset();
+				m_indexerProcessPool = std::make_shared<IndexerProcessPool>(
+					m_appUUID, indexerThreadCount);
+			}
+			processPool = m_indexerProcessPool;
+		}
+		else
+		{
+			m_indexerProcessPool.reset();
+		}
+
 		// add task for refilling the indexer command queue
 		taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(
-			m_appUUID, std::move(indexerCommandProvider), 20));
+			m_appUUID,
+			std::move(indexerCommandProvider),
+			20,
+			std::move(previousIndexingTimesMs),
+			processPool));
 
 		// add task for indexing
-		bool multiProcess = ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() &&
-			hasCxxSourceGroup();
 		taskParallelIndexing->addChildTasks(std::make_shared<TaskGroupSequence>()->addChildTasks(
 			// block until there are indexer commands to process
 			std::make_shared<TaskDecoratorRepeat>(
@@ -662,7 +919,7 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
 					"indexer_command_queue_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
 			std::make_shared<TaskBuildIndex>(
-				adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, multiProcess)));
+				adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, processPool)));
 
 		// add task for merging the intermediate storages
 		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
@@ -691,7 +948,8 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			std::make_shared<TaskDecoratorRepeat>(
 				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
 				->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
-					std::make_shared<TaskInjectStorage>(storageProvider, tempStorage),
+					std::make_shared<TaskInjectStorage>(
+						storageProvider, tempStorage, deltaStorage, checkpoint, true),
 					// continuing when indexers still running, even if there are no storages right now.
 					std::make_shared<TaskReturnSuccessIf<bool>>(
 						"indexer_threads_stopped",
@@ -709,13 +967,33 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		taskSequential->addTask(
 			std::make_shared<TaskDecoratorRepeat>(
 				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
-				->addChildTask(std::make_shared<TaskInjectStorage>(storageProvider, tempStorage)));
+				->addChildTask(std::make_shared<TaskInjectStorage>(
+					storageProvider, tempStorage, deltaStorage, checkpoint)));
 	}
 	else
 	{
 		dialogView->hideUnknownProgressDialog();
 	}
 
+	if (deltaStorage)
+	{
+		// only the delta of a complete refresh gets the base revision that it can be applied to
+		taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
+			std::make_shared<TaskGroupSequence>()->addChildTasks(
+				std::make_shared<TaskReturnSuccessIf<bool>>(
+					"interrupted_indexing", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false),
+				std::make_shared<TaskLambda>([deltaStorage, baseRevision]() {
+					deltaStorage->setDeltaBaseRevision(baseRevision);
+					deltaStorage->setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+					deltaStorage->optimizeMemory();
+				})),
+			std::make_shared<TaskLambda>([indexDeltaFilePath]() {
+				LOG_WARNING(
+					L"Indexing was interrupted, the index delta \"" + indexDeltaFilePath.wstr() +
+					L"\" cannot be applied.");
+			})));
+	}
+
 	if (!customIndexerCommandProvider->empty())
 	{
 		const int adjustedIndexerThreadCount = std::min<int>(
@@ -729,19 +1007,402 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			getProjectSettingsFilePath().getParentDirectory()));
 	}
 
-	taskSequential->addTask(std::make_shared<TaskFinishParsing>(tempStorage, dialogView));
+	addFinishIndexingTasks(taskSequential, tempStorage, dialogView, inPlaceRefresh);
+
+	taskSequential->setIsBackgroundTask(true);
+	Task::dispatch(TabId::app(), taskSequential);
+
+	m_refreshStage = RefreshStageType::INDEXING;
+	MessageStatus(
+		L"Starting Indexing: " + std::to_wstring(sourceFileCount) + L" source files", false, true)
+		.dispatch();
+	MessageIndexingStarted().dispatch();
+}
+
+void Project::mergeIndexShards(
+	const std::vector<FilePath>& shardDbFilePaths, std::shared_ptr<DialogView> dialogView)
+{
+	if (m_refreshStage != RefreshStageType::NONE || m_state == PROJECT_STATE_NOT_LOADED)
+	{
+		MessageStatus(L"Cannot merge index shards while indexing.", true, false).dispatch();
+		return;
+	}
+
+	// the source files of all shards are reported as indexed, which they were on their machines
+	size_t sourceFileCount = 0;
+	for (const FilePath& shardDbFilePath: shardDbFilePaths)
+	{
+		std::wstring error;
+		if (!shardDbFilePath.exists())
+		{
+			error = L"does not exist";
+		}
+		else
+		{
+			PersistentStorage shardStorage(shardDbFilePath, FilePath());
+			if (shardStorage.isIncompatible())
+			{
+				error = L"was indexed with a different version of Sourcetrail";
+			}
+			sourceFileCount += shardStorage.getIndexingTimes().size();
+		}
+
+		if (!error.empty())
+		{
+			MessageStatus(
+				L"Cannot merge index shards, the database \"" + shardDbFilePath.wstr() + L"\" " +
+					error + L".",
+				true,
+				false)
+				.dispatch();
+			return;
+		}
+	}
+
+	MessageStatus(L"Preparing Merging of Index Shards", false, true).dispatch();
+	MessageErrorCountClear().dispatch();
+	MessageIndexingStatus(true, 0).dispatch();
+
+	m_storageCache->clear();
+	m_storageCache->setSubject(m_storage);
+
+	m_indexShard = IndexShard();
+	const FilePath tempIndexDbFilePath = getTempIndexDbFilePath();
+	FileSystem::remove(tempIndexDbFilePath);
+
+	std::shared_ptr<PersistentStorage> tempStorage = std::make_shared<PersistentStorage>(
+		tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
+	tempStorage->applyStorageSettings(
+		ApplicationSettings::getInstance()->getIndexingStorageSettings(),
+		ApplicationSettings::getInstance()->getBookmarkStorageSettings());
+	tempStorage->setup();
+	tempStorage->setProjectSettingsText(
+		TextAccess::createFromFile(getProjectSettingsFilePath())->getText());
+	tempStorage->updateVersion();
+	tempStorage->setRevision(utility::getUuidString());
+
+	std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
+	taskSequential->addTask(std::make_shared<TaskSetValue<bool>>("shallow_indexing", false));
+	taskSequential->addTask(
+		std::make_shared<TaskSetValue<int>>("source_file_count", int(sourceFileCount)));
+	taskSequential->addTask(
+		std::make_shared<TaskSetValue<int>>("indexed_source_file_count", int(sourceFileCount)));
+	taskSequential->addTask(std::make_shared<TaskSetValue<bool>>("interrupted_indexing", false));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("index_time", 0.0f));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("merge_time", 0.0f));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("inject_time", 0.0f));
+
+	// the shards are read in parallel and take the same merge and inject path as indexed files
+	std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+	taskSequential->addTask(
+		std::make_shared<TaskLambda>([shardDbFilePaths, storageProvider, dialogView]() {
+			dialogView->showUnknownProgressDialog(L"Merging Index Shards", L"Reading Shards");
+
+			std::vector<std::shared_ptr<IntermediateStorage>> storages(shardDbFilePaths.size());
+			TaskManager::getThreadPool()->parallelFor(
+				shardDbFilePaths.size(),
+				[&](size_t i) {
+					PersistentStorage shardStorage(shardDbFilePaths[i], FilePath());
+					storages[i] = std::make_shared<IntermediateStorage>();
+					storages[i]->inject(&shardStorage);
+				},
+				ThreadPool::PRIORITY_INDEXING);
+
+			for (const std::shared_ptr<IntermediateStorage>& storage: storages)
+			{
+				storageProvider->insert(storage);
+			}
+
+			dialogView->showUnknownProgressDialog(L"Merging Index Shards", L"Merging Shards");
+		}));
+	taskSequential->addTask(
+		std::make_shared<TaskDecoratorRepeat>(
+			TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+			->addChildTask(std::make_shared<TaskMergeStorages>(storageProvider)));
+	taskSequential->addTask(
+		std::make_shared<TaskDecoratorRepeat>(
+			TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+			->addChildTask(std::make_shared<TaskInjectStorage>(storageProvider, tempStorage)));
+
+	addFinishIndexingTasks(taskSequential, tempStorage, dialogView, false);
+
+	taskSequential->setIsBackgroundTask(true);
+	Task::dispatch(TabId::app(), taskSequential);
+
+	m_refreshStage = RefreshStageType::INDEXING;
+	MessageStatus(
+		L"Merging " + std::to_wstring(shardDbFilePaths.size()) + L" index shards", false, true)
+		.dispatch();
+	MessageIndexingStarted().dispatch();
+}
+
+void Project::setIndexDeltaFilePath(const FilePath& filePath)
+{
+	m_indexDeltaFilePath = filePath;
+}
+
+void Project::applyIndexDeltas(
+	const std::vector<FilePath>& deltaFilePaths, std::shared_ptr<DialogView> dialogView)
+{
+	if (m_refreshStage != RefreshStageType::NONE || m_state == PROJECT_STATE_NOT_LOADED)
+	{
+		MessageStatus(L"Cannot apply index deltas while indexing.", true, false).dispatch();
+		return;
+	}
+
+	// each delta needs to continue the revision of the index or of the delta before
+	std::string revision = m_storage->getRevision();
+	size_t sourceFileCount = 0;
+	for (const FilePath& deltaFilePath: deltaFilePaths)
+	{
+		std::wstring error;
+		if (!deltaFilePath.exists())
+		{
+			error = L"does not exist";
+		}
+		else
+		{
+			PersistentStorage deltaStorage(deltaFilePath, FilePath());
+			if (deltaStorage.isIncompatible())
+			{
+				error = L"was indexed with a different version of Sourcetrail";
+			}
+			else if (deltaStorage.getDeltaBaseRevision().empty())
+			{
+				error = L"is no complete index delta";
+			}
+			else if (deltaStorage.getDeltaBaseRevision() != revision)
+			{
+				error = L"does not continue the revision of the index";
+			}
+			revision = deltaStorage.getRevision();
+			sourceFileCount += deltaStorage.getIndexingTimes().size();
+		}
+
+		if (!error.empty())
+		{
+			MessageStatus(
+				L"Cannot apply index deltas, the database \"" + deltaFilePath.wstr() + L"\" " +
+					error + L".",
+				true,
+				false)
+				.dispatch();
+			return;
+		}
+	}
+
+	MessageStatus(L"Preparing Applying of Index Deltas", false, true).dispatch();
+	MessageErrorCountClear().dispatch();
+	MessageIndexingStatus(true, 0).dispatch();
+
+	m_storageCache->clear();
+	m_storageCache->setSubject(m_storage);
+
+	// the deltas are applied to a copy, which keeps the current state for browsing meanwhile
+	m_indexShard = IndexShard();
+	const FilePath tempIndexDbFilePath = getTempIndexDbFilePath();
+	FileSystem::remove(tempIndexDbFilePath);
+	m_storage->checkpoint();
+	FileSystem::copyFile(getIndexDbFilePath(), tempIndexDbFilePath);
+
+	std::shared_ptr<PersistentStorage> tempStorage = std::make_shared<PersistentStorage>(
+		tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
+	tempStorage->applyStorageSettings(
+		ApplicationSettings::getInstance()->getIndexingStorageSettings(),
+		ApplicationSettings::getInstance()->getBookmarkStorageSettings());
+	tempStorage->setup();
+
+	std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
+	taskSequential->addTask(std::make_shared<TaskSetValue<bool>>("shallow_indexing", false));
+	taskSequential->addTask(
+		std::make_shared<TaskSetValue<int>>("source_file_count", int(sourceFileCount)));
+	taskSequential->addTask(
+		std::make_shared<TaskSetValue<int>>("indexed_source_file_count", int(sourceFileCount)));
+	taskSequential->addTask(std::make_shared<TaskSetValue<bool>>("interrupted_indexing", false));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("index_time", 0.0f));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("merge_time", 0.0f));
+	taskSequential->addTask(std::make_shared<TaskSetValue<float>>("inject_time", 0.0f));
+
+	for (const FilePath& deltaFilePath: deltaFilePaths)
+	{
+		taskSequential->addTask(
+			std::make_shared<TaskLambda>([deltaFilePath, tempStorage, dialogView]() {
+				PersistentStorage deltaStorage(deltaFilePath, FilePath());
+				const std::vector<FilePath> clearedFilePaths =
+					deltaStorage.getDeltaClearedFilePaths();
+
+				dialogView->showUnknownProgressDialog(
+					L"Applying Index Deltas",
+					L"Clearing " + std::to_wstring(clearedFilePaths.size()) + L" Files");
+				tempStorage->setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+				tempStorage->clearFileElements(clearedFilePaths, [=](int progress) {
+					dialogView->showProgressDialog(
+						L"Applying Index Deltas",
+						L"Clearing " + std::to_wstring(clearedFilePaths.size()) + L" Files",
+						progress);
+				});
+
+				dialogView->showUnknownProgressDialog(
+					L"Applying Index Deltas", L"Injecting " + deltaFilePath.fileName());
+				tempStorage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+				tempStorage->startInjectionGroup();
+				tempStorage->inject(&deltaStorage);
+				tempStorage->finishInjectionGroup();
+				tempStorage->setRevision(deltaStorage.getRevision());
+			}));
+	}
+
+	addFinishIndexingTasks(taskSequential, tempStorage, dialogView, false);
+
+	taskSequential->setIsBackgroundTask(true);
+	Task::dispatch(TabId::app(), taskSequential);
+
+	m_refreshStage = RefreshStageType::INDEXING;
+	MessageStatus(
+		L"Applying " + std::to_wstring(deltaFilePaths.size()) + L" index deltas", false, true)
+		.dispatch();
+	MessageIndexingStarted().dispatch();
+}
+
+FilePath Project::getIndexDbFilePath() const
+{
+	return m_indexShard.isPartial()
+		? m_settings->getShardDBFilePath(m_indexShard.index, m_indexShard.count)
+		: m_settings->getDBFilePath();
+}
+
+FilePath Project::getTempIndexDbFilePath() const
+{
+	return m_indexShard.isPartial()
+		? m_settings->getTempShardDBFilePath(m_indexShard.index, m_indexShard.count)
+		: m_settings->getTempDBFilePath();
+}
+
+FilePath Project::getCacheSnapshotFilePath() const
+{
+	const FilePath sharedDirectoryPath =
+		ApplicationSettings::getInstance()->getSharedCacheSnapshotPath();
+	if (sharedDirectoryPath.empty())
+	{
+		return m_settings->getCacheSnapshotFilePath();
+	}
+
+	FileSystem::createDirectory(sharedDirectoryPath);
+	StorageCacheSnapshot::removeUnusedSharedFiles(
+		sharedDirectoryPath, ProjectSettings::CACHE_SNAPSHOT_FILE_EXTENSION);
+	return StorageCacheSnapshot::getSharedFilePath(
+		sharedDirectoryPath, m_settings->getCacheSnapshotFilePath());
+}
+
+std::shared_ptr<PersistentStorage> Project::createIndexDeltaStorage(
+	const FilePath& filePath, const RefreshInfo& info, const std::string& revision) const
+{
+	std::wstring error;
+	if (m_storage->getRevision().empty())
+	{
+		error = L"the index has no revision yet, index the project once without a delta";
+	}
+	else if (info.shard.isPartial())
+	{
+		error = L"shards of distributed indexing runs cannot write deltas";
+	}
+	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+	{
+		// custom commands write into the index directly instead of injecting their storages
+		bool writesIntoIndex = sourceGroup->getType() == SOURCE_GROUP_CUSTOM_COMMAND;
+#if BUILD_PYTHON_LANGUAGE_PACKAGE
+		writesIntoIndex = writesIntoIndex || sourceGroup->getType() == SOURCE_GROUP_PYTHON_EMPTY;
+#endif	  // BUILD_PYTHON_LANGUAGE_PACKAGE
+		if (error.empty() && sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED &&
+			writesIntoIndex)
+		{
+			error = L"source groups of custom commands cannot write deltas";
+		}
+	}
+
+	if (!error.empty())
+	{
+		MessageStatus(
+			L"Cannot write the index delta \"" + filePath.wstr() + L"\", " + error + L".",
+			true,
+			false)
+			.dispatch();
+		return nullptr;
+	}
+
+	FileSystem::remove(filePath);
+	std::shared_ptr<PersistentStorage> deltaStorage =
+		std::make_shared<PersistentStorage>(filePath, FilePath());
+	deltaStorage->applyStorageSettings(
+		ApplicationSettings::getInstance()->getIndexingStorageSettings(),
+		ApplicationSettings::getInstance()->getBookmarkStorageSettings());
+	deltaStorage->setup();
+	deltaStorage->setProjectSettingsText(
+		TextAccess::createFromFile(getProjectSettingsFilePath())->getText());
+	deltaStorage->updateVersion();
+	deltaStorage->setRevision(revision);
+
+	// a full refresh replaces all files of the index before it
+	std::vector<FilePath> clearedFilePaths;
+	if (info.mode == REFRESH_ALL_FILES)
+	{
+		for (const FileInfo& fileInfo: m_storage->getFileInfoForAllFiles())
+		{
+			clearedFilePaths.push_back(fileInfo.path);
+		}
+	}
+	else
+	{
+		clearedFilePaths = utility::toVector(
+			utility::concat(info.filesToClear, info.nonIndexedFilesToClear));
+	}
+	deltaStorage->setDeltaClearedFilePaths(clearedFilePaths);
+	deltaStorage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+
+	return deltaStorage;
+}
 
+void Project::addFinishIndexingTasks(
+	std::shared_ptr<TaskGroupSequence> taskSequential,
+	std::shared_ptr<PersistentStorage> tempStorage,
+	std::shared_ptr<DialogView> dialogView,
+	bool inPlaceRefresh)
+{
+	// an in place refresh keeps the ids of the current caches
+	taskSequential->addTask(std::make_shared<TaskFinishParsing>(
+		tempStorage,
+		dialogView,
+		!inPlaceRefresh &&
+			ApplicationSettings::getInstance()->getDeterministicIndexOutputEnabled()));
+
+	// a refresh that is not finished here is rolled back when its storage gets closed
+	std::shared_ptr<PersistentStorage> refreshStorage = inPlaceRefresh ? tempStorage : nullptr;
 	taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
 			std::make_shared<TaskFindKeyOnBlackboard>("keep_database"),
-			std::make_shared<TaskLambda>([dialogView, this]() {
-				Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([dialogView, this]() {
-								   swapToTempStorage(dialogView);
-							   }));
+			std::make_shared<TaskLambda>([dialogView, refreshStorage, this]() {
+				std::shared_ptr<const std::vector<Id>> changedElementIds;
+				if (refreshStorage && m_storage)
+				{
+					// the search index has to be read before the refresh clears it for all
+					// connections, the current caches are taken over with the changes
+					m_storage->loadSearchIndex();
+					changedElementIds = std::make_shared<const std::vector<Id>>(
+						refreshStorage->finishRefreshTransaction(true));
+				}
+				Task::dispatch(
+					TabId::app(),
+					std::make_shared<TaskLambda>([dialogView, changedElementIds, this]() {
+						swapToTempStorage(dialogView, changedElementIds);
+					}));
 			})),
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
 			std::make_shared<TaskFindKeyOnBlackboard>("discard_database"),
-			std::make_shared<TaskLambda>([this]() {
+			std::make_shared<TaskLambda>([refreshStorage, this]() {
+				if (refreshStorage)
+				{
+					refreshStorage->finishRefreshTransaction(false);
+				}
 				Task::dispatch(
 					TabId::app(), std::make_shared<TaskLambda>([this]() { discardTempStorage(); }));
 			}))));
@@ -764,43 +1425,69 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([this]() {}));
 		}))));
 
-	taskSequential->setIsBackgroundTask(true);
-	Task::dispatch(TabId::app(), taskSequential);
-
-	m_refreshStage = RefreshStageType::INDEXING;
-	MessageStatus(
-		L"Starting Indexing: " + std::to_wstring(sourceFileCount) + L" source files", false, true)
-		.dispatch();
-	MessageIndexingStarted().dispatch();
 }
 
-void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView)
+void Project::swapToTempStorage(
+	std::shared_ptr<DialogView> dialogView,
+	std::shared_ptr<const std::vector<Id>> refreshedElementIds)
 {
-	LOG_INFO("Switching to temporary indexing data");
+	const bool inPlaceRefresh = refreshedElementIds != nullptr;
+	LOG_INFO(
+		inPlaceRefresh ? "Reloading refreshed indexing data"
+					   : "Switching to temporary indexing data");
 
-	const FilePath indexDbFilePath = m_settings->getDBFilePath();
-	const FilePath tempIndexDbFilePath = m_settings->getTempDBFilePath();
+	const FilePath indexDbFilePath = getIndexDbFilePath();
+	const FilePath tempIndexDbFilePath = getTempIndexDbFilePath();
 	const FilePath bookmarkDbFilePath = m_settings->getBookmarkDBFilePath();
 
+	// the storage of the database before an in place refresh hands its caches over
+	std::shared_ptr<const PersistentStorage> previousStorage = inPlaceRefresh ? m_storage : nullptr;
 	m_storage.reset();
 
-	if (!swapToTempStorageFile(indexDbFilePath, tempIndexDbFilePath, dialogView))
+	if (!inPlaceRefresh &&
+		!swapToTempStorageFile(indexDbFilePath, tempIndexDbFilePath, dialogView))
 	{
 		m_state = PROJECT_STATE_NOT_LOADED;
 		return;
 	}
+	IndexingCheckpoint(IndexingCheckpoint::getFilePath(tempIndexDbFilePath)).remove();
 
 	m_storage = std::make_shared<PersistentStorage>(indexDbFilePath, bookmarkDbFilePath);
+	m_storage->applyStorageSettings(
+		ApplicationSettings::getInstance()->getBrowsingStorageSettings(),
+		ApplicationSettings::getInstance()->getBookmarkStorageSettings());
+	m_storage->setReadConnectionCount(
+		size_t(std::max(0, ApplicationSettings::getInstance()->getStorageReadConnectionCount())));
+	m_storage->setCacheSnapshotFilePath(getCacheSnapshotFilePath());
 	m_storage->setup();
 
 	// std::shared_ptr<DialogView> dialogView =
 	// Application::getInstance()->getDialogView(DialogView::UseCase::INDEXING);
 	// dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building caches");
-	m_storage->buildCaches();
+	if (previousStorage)
+	{
+		m_storage->buildCaches(*previousStorage, *refreshedElementIds);
+		previousStorage.reset();
+	}
+	else
+	{
+		m_storage->buildCaches();
+	}
 	// dialogView->hideUnknownProgressDialog();
+	if (ApplicationSettings::getInstance()->getIndexReplicaEnabled())
+	{
+		m_storage->startBuildingIndexReplica();
+	}
 
 	m_storageCache->setSubject(m_storage);
 	m_state = PROJECT_STATE_LOADED;
+
+	updateWatchedDirectories();
+
+	if (m_hasGUI)
+	{
+		startStorageMaintenance();
+	}
 }
 
 bool Project::swapToTempStorageFile(
@@ -831,12 +1518,16 @@ bool Project::swapToTempStorageFile(
 
 void Project::discardTempStorage()
 {
-	const FilePath tempIndexDbPath = m_settings->getTempDBFilePath();
+	const FilePath tempIndexDbPath = getTempIndexDbFilePath();
 	if (tempIndexDbPath.exists())
 	{
 		LOG_INFO("Discarding temporary indexing data");
 		FileSystem::remove(tempIndexDbPath);
 	}
+	IndexingCheckpoint(IndexingCheckpoint::getFilePath(tempIndexDbPath)).remove();
+
+	// the changes covered by the discarded refresh are not part of the kept data
+	m_fileSystemChangesSynchronized = false;
 }
 
 bool Project::hasCxxSourceGroup() const
@@ -855,3 +1546,70 @@ bool Project::hasCxxSourceGroup() const
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 	return false;
 }
+
+bool Project::prepareSourceGroups()
+{
+	m_settings->reload();
+
+	m_sourceGroups = SourceGroupFactory::getInstance()->createSourceGroups(
+		m_settings->getAllSourceGroupSettings());
+	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+	{
+		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED && !sourceGroup->prepareIndexing())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void Project::startStorageMaintenance()
+{
+	const int idleSeconds = ApplicationSettings::getInstance()->getStorageMaintenanceIdleSeconds();
+	if (idleSeconds > 0)
+	{
+		Task::dispatch(
+			TabId::app(),
+			std::make_shared<TaskMaintainStorage>(
+				m_storage,
+				ApplicationSettings::getInstance()->getBrowsingStorageSettings(),
+				size_t(idleSeconds) * 1000,
+				ApplicationSettings::getInstance()->getStorageMaintenanceRebuildsIndices()));
+	}
+}
+
+void Project::updateWatchedDirectories()
+{
+	if (!m_hasGUI || !ApplicationSettings::getInstance()->getFileSystemWatcherEnabled())
+	{
+		m_fileSystemWatcher.reset();
+		return;
+	}
+
+	if (!m_fileSystemWatcher)
+	{
+		m_fileSystemWatcher = std::make_shared<FileSystemWatcher>([]() {
+			if (ApplicationSettings::getInstance()->getRefreshOnFileSystemChangeEnabled())
+			{
+				MessageRefresh().refreshInBackground().dispatch();
+			}
+		});
+		m_fileSystemChangesSynchronized = false;
+	}
+
+	std::set<FilePath> directoryPaths;
+	for (const FileInfo& fileInfo: m_storage->getFileInfoForAllFiles())
+	{
+		directoryPaths.insert(fileInfo.path.getParentDirectory());
+	}
+	m_fileSystemWatcher->setWatchedDirectories(directoryPaths);
+}
+
+void Project::synchronizeFileSystemChanges(const RefreshInfo& info)
+{
+	if (m_fileSystemWatcher && info.coversFileSystemChanges)
+	{
+		m_fileSystemWatcher->clearChangedDirectories(info.fileSystemChangeCount);
+		m_fileSystemChangesSynchronized = true;
+	}
+}
@@ -8,13 +8,17 @@
 
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
+#include "types.h"
 
 struct FileInfo;
 class DialogView;
 class FilePath;
+class FileSystemWatcher;
+class IndexerProcessPool;
 class PersistentStorage;
 class ProjectSettings;
 class StorageCache;
+class TaskGroupSequence;
 
 class Project
 {
@@ -37,12 +41,34 @@ public:
 
 	void load(std::shared_ptr<DialogView> dialogView);
 
-	void refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refreshMode, bool shallowIndexingRequested);
+	void refresh(
+		std::shared_ptr<DialogView> dialogView,
+		RefreshMode refreshMode,
+		bool shallowIndexingRequested,
+		const IndexShard& shard = IndexShard());
+
+	// indexes updated files without asking, only if the project is up-to-date otherwise, known
+	// changed files limit the check to their directories
+	void refreshInBackground(
+		std::shared_ptr<DialogView> dialogView,
+		const std::set<FilePath>& changedFilePaths = std::set<FilePath>());
 
 	RefreshInfo getRefreshInfo(RefreshMode mode) const;
 
 	void buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogView);
 
+	// combines the databases written by the shards of a distributed indexing run into the index
+	// database of the project
+	void mergeIndexShards(
+		const std::vector<FilePath>& shardDbFilePaths, std::shared_ptr<DialogView> dialogView);
+
+	// the next refresh also writes the data it indexes into an index delta at this path
+	void setIndexDeltaFilePath(const FilePath& filePath);
+
+	// brings the index database up to date with index deltas, which are applied in order
+	void applyIndexDeltas(
+		const std::vector<FilePath>& deltaFilePaths, std::shared_ptr<DialogView> dialogView);
+
 private:
 	enum ProjectStateType
 	{
@@ -64,24 +90,64 @@ private:
 
 	Project(const Project&);
 
-	void swapToTempStorage(std::shared_ptr<DialogView> dialogView);
+	// the database of the shard while a partial index is built, the one of the project otherwise
+	FilePath getIndexDbFilePath() const;
+	FilePath getTempIndexDbFilePath() const;
+	// in the shared directory of the application settings if there is one
+	FilePath getCacheSnapshotFilePath() const;
+
+	// returns nullptr and reports the reason if the index delta cannot be written
+	std::shared_ptr<PersistentStorage> createIndexDeltaStorage(
+		const FilePath& filePath, const RefreshInfo& info, const std::string& revision) const;
+
+	void addFinishIndexingTasks(
+		std::shared_ptr<TaskGroupSequence> taskSequential,
+		std::shared_ptr<PersistentStorage> tempStorage,
+		std::shared_ptr<DialogView> dialogView,
+		bool inPlaceRefresh);
+
+	// reloads the storage from the database file that an in place refresh wrote into instead, which
+	// passes the ids of the elements it changed
+	void swapToTempStorage(
+		std::shared_ptr<DialogView> dialogView,
+		std::shared_ptr<const std::vector<Id>> refreshedElementIds);
 	bool swapToTempStorageFile(
 		const FilePath& indexDbFilePath,
 		const FilePath& tempIndexDbFilePath,
 		std::shared_ptr<DialogView> dialogView);
 	void discardTempStorage();
 
+	// queues the maintenance of the index database for the next time the user is idle
+	void startStorageMaintenance();
+
 	bool hasCxxSourceGroup() const;
 
+	bool prepareSourceGroups();
+
+	void updateWatchedDirectories();
+	void synchronizeFileSystemChanges(const RefreshInfo& info);
+
 	std::shared_ptr<ProjectSettings> m_settings;
 	StorageCache* const m_storageCache;
 
 	ProjectStateType m_state;
 	RefreshStageType m_refreshStage;
+	IndexShard m_indexShard;
+	FilePath m_indexDeltaFilePath;
 
 	std::shared_ptr<PersistentStorage> m_storage;
 	std::vector<std::shared_ptr<SourceGroup>> m_sourceGroups;
 
+	// kept between refreshes, so indexer processes only start up once
+	std::shared_ptr<IndexerProcessPool> m_indexerProcessPool;
+
+	// changes seen by the watcher are only complete after a refresh looked at all files once
+	std::shared_ptr<FileSystemWatcher> m_fileSystemWatcher;
+	bool m_fileSystemChangesSynchronized;
+
+	// the data of a killed indexing run was kept, so the next full refresh only indexes the rest
+	bool m_resumesIndexing;
+
 	std::string m_appUUID;
 	bool m_hasGUI;
 };
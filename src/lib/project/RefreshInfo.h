@@ -13,14 +13,32 @@ enum RefreshMode
 	REFRESH_ALL_FILES
 };
 
+// part of the source files that one machine of a distributed indexing run indexes
+struct IndexShard
+{
+	size_t index = 0;	 // starting at 0
+	size_t count = 1;
+
+	bool isPartial() const
+	{
+		return count > 1;
+	}
+};
+
 struct RefreshInfo
 {
 	std::set<FilePath> filesToIndex;
 	std::set<FilePath> filesToClear;
 	std::set<FilePath> nonIndexedFilesToClear;
+	std::set<FilePath> filesToMoveLocations;
 
 	RefreshMode mode = REFRESH_NONE;
 	bool shallow = false;
+	IndexShard shard;	 // the indexed data is written to the database of the shard if partial
+
+	// file system changes reported up to this count are covered by this info
+	bool coversFileSystemChanges = false;
+	size_t fileSystemChangeCount = 0;
 };
 
 #endif	  // REFRESH_INFO_H
@@ -1,28 +1,73 @@
 #include "RefreshInfoGenerator.h"
 
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+
 #include "FileInfo.h"
+#include "FileReferenceGraph.h"
+#include "FilePathTable.h"
 #include "FileSystem.h"
 #include "PersistentStorage.h"
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
 #include "SourceGroupStatusType.h"
+#include "TaskManager.h"
 #include "TextAccess.h"
+#include "TextLayoutMapping.h"
+#include "ThreadPool.h"
 #include "utility.h"
 
+namespace
+{
+typedef std::unordered_set<FilePathTable::Id> FilePathIdSet;
+
+FilePathIdSet toFilePathIds(const std::set<FilePath>& filePaths)
+{
+	FilePathIdSet ids;
+	ids.reserve(filePaths.size());
+	for (const FilePath& filePath: filePaths)
+	{
+		ids.insert(FilePathTable::getInstance()->getId(filePath));
+	}
+	return ids;
+}
+}	 // namespace
+
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
 	std::shared_ptr<const PersistentStorage> storage)
 {
+	return getRefreshInfoForUpdatedFiles(sourceGroups, storage, nullptr);
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForChangedDirectories(
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage,
+	const std::set<FilePath>& changedDirectoryPaths)
+{
+	return getRefreshInfoForUpdatedFiles(sourceGroups, storage, &changedDirectoryPaths);
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage,
+	const std::set<FilePath>* changedDirectoryPaths)
+{
+	// the sets of this computation are kept as ids of the FilePathTable
+	FilePathTable* pathTable = FilePathTable::getInstance();
+
 	// 1) Divide filepaths that are already known by the storage to "unchanged and indexed",
 	// "unchanged and non-indexed" and "changed"
-	std::set<FilePath> unchangedIndexedFilePaths;
-	std::set<FilePath> unchangedNonindexedFilePaths;
-	std::set<FilePath> changedFilePaths;
+	FilePathIdSet unchangedIndexedFileIds;
+	FilePathIdSet unchangedNonindexedFileIds;
+	FilePathIdSet changedFileIds;
+	FilePathIdSet layoutChangedFileIds;
 
 	{
 		const std::vector<FileInfo> fileInfosFromStorage = storage->getFileInfoForAllFiles();
 
-		std::set<FilePath> alreadyKnownPaths;
+		FilePathIdSet alreadyKnownFileIds;
 		{
 			const std::set<FilePath> filePathsFromStorage = utility::toSet(
 				utility::convert<FileInfo, FilePath>(
@@ -33,52 +78,112 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 				if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
 				{
 					utility::append(
-						alreadyKnownPaths,
-						sourceGroup->filterToContainedFilePaths(filePathsFromStorage));
+						alreadyKnownFileIds,
+						toFilePathIds(
+							sourceGroup->filterToContainedFilePaths(filePathsFromStorage)));
 				}
 			}
 		}
 
+		FilePathIdSet changedDirectoryIds;
+		if (changedDirectoryPaths)
+		{
+			changedDirectoryIds = toFilePathIds(*changedDirectoryPaths);
+		}
+
+		// files in directories without changes still exist and have not been modified, all others
+		// are looked up on disk at once and compared to the storage if they may be unchanged
+		std::vector<char> needsStat(fileInfosFromStorage.size(), 0);
+		std::vector<char> needsComparison(fileInfosFromStorage.size(), 0);
+		for (size_t i = 0; i < fileInfosFromStorage.size(); i++)
+		{
+			const FilePathTable::Id id = pathTable->getId(fileInfosFromStorage[i].path);
+			needsStat[i] = !changedDirectoryPaths ||
+				changedDirectoryIds.find(pathTable->getParentId(id)) != changedDirectoryIds.end();
+
+			// indexed files matter if a source group knows them, non-indexed files if none does
+			const bool known = alreadyKnownFileIds.find(id) != alreadyKnownFileIds.end();
+			needsComparison[i] = needsStat[i] &&
+				known == storage->getFilePathIndexed(fileInfosFromStorage[i].path);
+		}
+
+		std::vector<char> fileExists;
+		std::vector<char> fileChanged;
+		checkFilesOnDisk(
+			fileInfosFromStorage, needsStat, needsComparison, storage, &fileExists, &fileChanged);
+
 		// checking source and header files
-		for (const FileInfo& info: fileInfosFromStorage)
+		for (size_t i = 0; i < fileInfosFromStorage.size(); i++)
 		{
-			if (alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() && info.path.exists())
+			const FileInfo& info = fileInfosFromStorage[i];
+			const FilePathTable::Id id = pathTable->getId(info.path);
+
+			if (alreadyKnownFileIds.find(id) != alreadyKnownFileIds.end() &&
+				fileExists[i])
 			{
 				if (storage->getFilePathIndexed(info.path))
 				{
-					if (didFileChange(info, storage))
+					if (!fileChanged[i])
+					{
+						unchangedIndexedFileIds.insert(id);
+					}
+					// only comments or whitespace changed, so the stored locations can be moved
+					else if (storage->hasOnlyLayoutChanges(info.path))
 					{
-						changedFilePaths.insert(info.path);
+						layoutChangedFileIds.insert(id);
+						unchangedIndexedFileIds.insert(id);
 					}
 					else
 					{
-						unchangedIndexedFilePaths.insert(info.path);
+						changedFileIds.insert(id);
 					}
 				}
 				else
 				{
-					changedFilePaths.insert(info.path);
+					changedFileIds.insert(id);
 				}
 			}
-			else if (!storage->getFilePathIndexed(info.path) && !didFileChange(info, storage))
+			else if (!storage->getFilePathIndexed(info.path) && !fileChanged[i])
 			{
-				unchangedNonindexedFilePaths.insert(info.path);
+				unchangedNonindexedFileIds.insert(id);
 			}
 			else	// file has been removed
 			{
-				changedFilePaths.insert(info.path);
+				changedFileIds.insert(id);
 			}
 		}
 	}
 
-	const std::set<FilePath> allSourceFilePathsFromSourcegroups = getAllSourceFilePaths(sourceGroups);
+	const FilePathIdSet allSourceFileIdsFromSourcegroups = toFilePathIds(
+		getAllSourceFilePaths(sourceGroups));
+
+	// the includes and imports are read once for all of the following queries
+	const FileReferenceGraph referenceGraph = storage->getFileReferenceGraph();
 
 	// 2) Figure out which files need to be cleared
 	// 2.1) Add all changed files
-	std::set<FilePath> filesToClear = changedFilePaths;
+	FilePathIdSet fileIdsToClear = changedFileIds;
 
 	// 2.2) Add files that are reference the changed files
-	utility::append(filesToClear, storage->getReferencing(changedFilePaths));
+	utility::append(fileIdsToClear, referenceGraph.getReferencing(changedFileIds));
+
+	// 2.2.1) Files with layout changes that get cleared anyways are re-indexed like changed files
+	// and need the files referencing them cleared as well
+	for (bool clearedLayoutChangedFile = true; clearedLayoutChangedFile;)
+	{
+		clearedLayoutChangedFile = false;
+		for (const FilePathTable::Id id: layoutChangedFileIds)
+		{
+			if (fileIdsToClear.find(id) != fileIdsToClear.end())
+			{
+				utility::append(fileIdsToClear, referenceGraph.getReferencing({id}));
+				unchangedIndexedFileIds.erase(id);
+				layoutChangedFileIds.erase(id);
+				clearedLayoutChangedFile = true;
+				break;
+			}
+		}
+	}
 
 	// 2.3) Handle files that are referenced by the files that will be cleared. These will be
 	// re-indexed on the fly. However, we do not
@@ -92,47 +197,51 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	//   paths because they are not part of the DB. Source files that are new to the project but are
 	//   already in the DB will be removed from this list if they have changed or reference changed
 	//   files.
-	std::set<FilePath> staticSourceFiles = allSourceFilePathsFromSourcegroups;
-	for (const FilePath& path: filesToClear)
+	FilePathIdSet staticSourceFileIds = allSourceFileIdsFromSourcegroups;
+	for (const FilePathTable::Id id: fileIdsToClear)
 	{
-		staticSourceFiles.erase(path);
+		staticSourceFileIds.erase(id);
 	}
 
 	// 2.3.2) Get sets of referenced files
-	const std::set<FilePath> staticReferencedFilePaths = storage->getReferenced(staticSourceFiles);
-	const std::set<FilePath> dynamicReferencedFilePaths = storage->getReferenced(filesToClear);
+	const FilePathIdSet staticReferencedFileIds = referenceGraph.getReferenced(staticSourceFileIds);
+	const FilePathIdSet dynamicReferencedFileIds = referenceGraph.getReferenced(fileIdsToClear);
 
 	// 2.3.3) Add "dynamicReferencedFilePaths" to "filesToClear" that are not refenced by static
 	// paths, because these files may not be
 	//        referenced anymore. If they still are, they will be re-added when encountered during
 	//        re-indexing.
-	for (const FilePath& path: dynamicReferencedFilePaths)
+	for (const FilePathTable::Id id: dynamicReferencedFileIds)
 	{
-		if (staticReferencedFilePaths.find(path) == staticReferencedFilePaths.end() &&
-			staticSourceFiles.find(path) == staticSourceFiles.end())
+		if (staticReferencedFileIds.find(id) == staticReferencedFileIds.end() &&
+			staticSourceFileIds.find(id) == staticSourceFileIds.end())
 		{
-			filesToClear.insert(path);
+			fileIdsToClear.insert(id);
 		}
 	}
 
-	// 3) Figure out which files need to be indexed
-	std::set<FilePath> filesToIndex;
-	for (const FilePath& path: allSourceFilePathsFromSourcegroups)
+	// 3) Figure out which files need to be indexed and 4) store and return this information
+	RefreshInfo info;
+	info.mode = REFRESH_UPDATED_FILES;
+	for (const FilePathTable::Id id: allSourceFileIdsFromSourcegroups)
 	{
-		if (filesToClear.find(path) != filesToClear.end() ||	// file will be cleared
-			unchangedIndexedFilePaths.find(path) ==
-				unchangedIndexedFilePaths.end())	// file has been changed or added
+		if (fileIdsToClear.find(id) != fileIdsToClear.end() ||	// file will be cleared
+			unchangedIndexedFileIds.find(id) ==
+				unchangedIndexedFileIds.end())	  // file has been changed or added
 		{
-			filesToIndex.insert(path);
+			info.filesToIndex.insert(pathTable->getPath(id));
 		}
 	}
-
-	// 4) Store and return this information
-	RefreshInfo info;
-	info.mode = REFRESH_UPDATED_FILES;
-	info.filesToIndex = filesToIndex;
-	for (const FilePath fileToClear: filesToClear)
+	for (const FilePathTable::Id id: layoutChangedFileIds)
+	{
+		if (fileIdsToClear.find(id) == fileIdsToClear.end())
+		{
+			info.filesToMoveLocations.insert(pathTable->getPath(id));
+		}
+	}
+	for (const FilePathTable::Id id: fileIdsToClear)
 	{
+		const FilePath fileToClear = pathTable->getPath(id);
 		if (storage->getFilePathIndexed(fileToClear))
 		{
 			info.filesToClear.insert(fileToClear);
@@ -168,34 +277,23 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(
 
 	if (!incompleteFiles.empty())
 	{
-		utility::append(incompleteFiles, storage->getReferencing(incompleteFiles));
-
-		std::set<FilePath> staticSourceFilePaths = getAllSourceFilePaths(sourceGroups);
-		for (const FilePath& path: incompleteFiles)
-		{
-			staticSourceFilePaths.erase(path);
+		addFilesToReindex(incompleteFiles, sourceGroups, storage, &info);
+	}
 
-			if (storage->getFilePathIndexed(path))
-			{
-				info.filesToClear.insert(path);
-			}
-			else
-			{
-				info.nonIndexedFilesToClear.insert(path);
-			}
-		}
+	return info;
+}
 
-		for (const std::shared_ptr<const SourceGroup>& sourceGroup: sourceGroups)
-		{
-			if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
-			{
-				utility::append(
-					info.filesToIndex,
-					sourceGroup->filterToContainedSourceFilePath(staticSourceFilePaths));
-			}
-		}
+RefreshInfo RefreshInfoGenerator::getRefreshInfoWithoutMovedLocations(
+	RefreshInfo info,
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage)
+{
+	if (!info.filesToMoveLocations.empty())
+	{
+		const std::set<FilePath> filesToMoveLocations = info.filesToMoveLocations;
+		info.filesToMoveLocations.clear();
+		addFilesToReindex(filesToMoveLocations, sourceGroups, storage, &info);
 	}
-
 	return info;
 }
 
@@ -208,6 +306,87 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForAllFiles(
 	return info;
 }
 
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForShard(RefreshInfo info, const IndexShard& shard)
+{
+	info.filesToIndex = getFilePathsOfShard(
+		info.filesToIndex, shard, [](const FilePath& filePath) {
+			return FileSystem::getFileByteSize(filePath);
+		});
+	info.shard = shard;
+	return info;
+}
+
+void RefreshInfoGenerator::addFilesToReindex(
+	std::set<FilePath> filePaths,
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage,
+	RefreshInfo* info)
+{
+	utility::append(filePaths, storage->getReferencing(filePaths));
+
+	std::set<FilePath> staticSourceFilePaths = getAllSourceFilePaths(sourceGroups);
+	for (const FilePath& path: filePaths)
+	{
+		staticSourceFilePaths.erase(path);
+		info->filesToMoveLocations.erase(path);
+
+		if (storage->getFilePathIndexed(path))
+		{
+			info->filesToClear.insert(path);
+		}
+		else
+		{
+			info->nonIndexedFilesToClear.insert(path);
+		}
+	}
+
+	for (const std::shared_ptr<const SourceGroup>& sourceGroup: sourceGroups)
+	{
+		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
+		{
+			utility::append(
+				info->filesToIndex,
+				sourceGroup->filterToContainedSourceFilePath(staticSourceFilePaths));
+		}
+	}
+}
+
+std::set<FilePath> RefreshInfoGenerator::getFilePathsOfShard(
+	const std::set<FilePath>& filePaths,
+	const IndexShard& shard,
+	std::function<unsigned long long(const FilePath&)> getFileCost)
+{
+	if (!shard.isPartial())
+	{
+		return filePaths;
+	}
+
+	std::vector<std::pair<unsigned long long, FilePath>> costs;
+	for (const FilePath& filePath: filePaths)
+	{
+		costs.emplace_back(getFileCost(filePath), filePath);
+	}
+	std::stable_sort(
+		costs.begin(),
+		costs.end(),
+		[](const std::pair<unsigned long long, FilePath>& a,
+		   const std::pair<unsigned long long, FilePath>& b) { return a.first > b.first; });
+
+	std::set<FilePath> shardFilePaths;
+	std::vector<unsigned long long> shardCosts(shard.count, 0);
+	for (const std::pair<unsigned long long, FilePath>& cost: costs)
+	{
+		const size_t shardIndex = std::min_element(shardCosts.begin(), shardCosts.end()) -
+			shardCosts.begin();
+		shardCosts[shardIndex] += cost.first + 1;
+		if (shardIndex == shard.index)
+		{
+			shardFilePaths.insert(cost.second);
+		}
+	}
+	return shardFilePaths;
+}
+
 std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
 	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups)
 {
@@ -230,36 +409,74 @@ std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
 	return allSourceFilePaths;
 }
 
-bool RefreshInfoGenerator::didFileChange(
-	const FileInfo& info, std::shared_ptr<const PersistentStorage> storage)
+void RefreshInfoGenerator::checkFilesOnDisk(
+	const std::vector<FileInfo>& fileInfos,
+	const std::vector<char>& needsStat,
+	const std::vector<char>& needsComparison,
+	std::shared_ptr<const PersistentStorage> storage,
+	std::vector<char>* fileExists,
+	std::vector<char>* fileChanged)
 {
-	FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
-	if (diskFileInfo.lastWriteTime > info.lastWriteTime)
-	{
-		if (!storage->hasContentForFile(info.path))
-		{
-			return true;
-		}
-
-		std::shared_ptr<TextAccess> storedFileContent = storage->getFileContent(info.path, false);
-		std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFileInfo.path);
+	const std::map<FilePath, std::string> storedContentHashes =
+		storage->getFileContentHashesForAllFiles();
 
-		const std::vector<std::string>& diskFileLines = diskFileContent->getAllLines();
-		const std::vector<std::string>& storedFileLines = storedFileContent->getAllLines();
+	// stored contents are only loaded for files without hash, the storage is not used in parallel
+	fileExists->assign(fileInfos.size(), 1);
+	fileChanged->assign(fileInfos.size(), 0);
+	std::vector<char> needsContentComparison(fileInfos.size(), 0);
+	TaskManager::getThreadPool()->parallelFor(
+		fileInfos.size(),
+		[&](size_t i) {
+			if (!needsStat[i])
+			{
+				return;
+			}
 
-		if (diskFileLines.size() != storedFileLines.size())
-		{
-			return true;
-		}
+			const FileInfo& info = fileInfos[i];
+			FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
+			(*fileExists)[i] = !diskFileInfo.path.empty();
+			if (!needsComparison[i] || !(diskFileInfo.lastWriteTime > info.lastWriteTime))
+			{
+				return;
+			}
 
-		for (size_t i = 0; i < diskFileLines.size(); i++)
-		{
-			if (diskFileLines[i] != storedFileLines[i])
+			auto it = storedContentHashes.find(info.path);
+			if (it == storedContentHashes.end())
 			{
-				return true;
+				needsContentComparison[i] = 1;
+				return;
 			}
+
+			(*fileChanged)[i] = it->second !=
+				TextLayoutMapping::getContentHash(TextAccess::createFromFile(info.path)->getText());
+		},
+		ThreadPool::PRIORITY_INDEXING);
+
+	for (size_t i = 0; i < fileInfos.size(); i++)
+	{
+		if (needsContentComparison[i])
+		{
+			(*fileChanged)[i] = didFileContentChange(fileInfos[i].path, storage);
 		}
-		return false;
 	}
-	return false;
+}
+
+bool RefreshInfoGenerator::didFileContentChange(
+	const FilePath& filePath, std::shared_ptr<const PersistentStorage> storage)
+{
+	std::shared_ptr<TextAccess> storedFileContent = storage->getStoredFileContent(
+		filePath, FileContentCache::CONSUMER_REFRESH);
+	if (storedFileContent->getLineCount() == 0)
+	{
+		return true;
+	}
+
+	std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(filePath);
+
+	if (diskFileContent->getLineCount() != storedFileContent->getLineCount())
+	{
+		return true;
+	}
+
+	return diskFileContent->getText() != storedFileContent->getText();
 }
@@ -1,12 +1,14 @@
 #ifndef REFRESH_INFO_GENERATOR_H
 #define REFRESH_INFO_GENERATOR_H
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <vector>
 
 struct FileInfo;
 class FilePath;
+struct IndexShard;
 class PersistentStorage;
 struct RefreshInfo;
 class SourceGroup;
@@ -18,18 +20,65 @@ public:
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
 		std::shared_ptr<const PersistentStorage> storage);
 
+	// only checks stored files in the given directories for changes, files elsewhere are assumed to
+	// be unchanged
+	static RefreshInfo getRefreshInfoForChangedDirectories(
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		std::shared_ptr<const PersistentStorage> storage,
+		const std::set<FilePath>& changedDirectoryPaths);
+
 	static RefreshInfo getRefreshInfoForIncompleteFiles(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
 		std::shared_ptr<const PersistentStorage> storage);
 
+	// clears and indexes the files whose locations would only be moved again, together with the
+	// files referencing them, so the refresh does not depend on the file contents on disk
+	static RefreshInfo getRefreshInfoWithoutMovedLocations(
+		RefreshInfo info,
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		std::shared_ptr<const PersistentStorage> storage);
+
 	static RefreshInfo getRefreshInfoForAllFiles(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
+	// keeps the files to index that belong to the shard, shards get files of about the same size
+	static RefreshInfo getRefreshInfoForShard(RefreshInfo info, const IndexShard& shard);
+
+	// the same files and costs give the same shards on every machine, files are assigned from the
+	// most expensive one on to the shard with the lowest cost so far
+	static std::set<FilePath> getFilePathsOfShard(
+		const std::set<FilePath>& filePaths,
+		const IndexShard& shard,
+		std::function<unsigned long long(const FilePath&)> getFileCost);
+
 private:
+	static RefreshInfo getRefreshInfoForUpdatedFiles(
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		std::shared_ptr<const PersistentStorage> storage,
+		const std::set<FilePath>* changedDirectoryPaths);
+
+	// clears the files and the files referencing them and indexes the contained source files again
+	static void addFilesToReindex(
+		std::set<FilePath> filePaths,
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		std::shared_ptr<const PersistentStorage> storage,
+		RefreshInfo* info);
+
 	static std::set<FilePath> getAllSourceFilePaths(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
-	static bool didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage);
+	// looks up the files on disk in parallel and compares the disk files with newer modification
+	// times to the stored content hashes
+	static void checkFilesOnDisk(
+		const std::vector<FileInfo>& fileInfos,
+		const std::vector<char>& needsStat,
+		const std::vector<char>& needsComparison,
+		std::shared_ptr<const PersistentStorage> storage,
+		std::vector<char>* fileExists,
+		std::vector<char>* fileChanged);
+
+	static bool didFileContentChange(
+		const FilePath& filePath, std::shared_ptr<const PersistentStorage> storage);
 };
 
 #endif	  // REFRESH_INFO_GENERATOR_H
@@ -44,19 +44,23 @@ std::vector<std::shared_ptr<IndexerCommand>> SourceGroupCustomCommand::getIndexe
 {
 	const std::wstring customCommand = m_settings->getCustomCommand();
 	const bool runInParallel = m_settings->getRunInParallel();
+	const int executionOrder = m_settings->getExecutionOrder();
 
 	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
 	for (const FilePath& sourcePath: getAllSourceFilePaths())
 	{
 		if (info.filesToIndex.find(sourcePath) != info.filesToIndex.end())
 		{
-			indexerCommands.push_back(std::make_shared<IndexerCommandCustom>(
-				customCommand,
-				m_settings->getProjectSettings()->getProjectFilePath(),
-				m_settings->getProjectSettings()->getTempDBFilePath(),
-				std::to_wstring(SqliteIndexStorage::getStorageVersion()),
-				sourcePath,
-				runInParallel));
+			std::shared_ptr<IndexerCommandCustom> indexerCommand =
+				std::make_shared<IndexerCommandCustom>(
+					customCommand,
+					m_settings->getProjectSettings()->getProjectFilePath(),
+					m_settings->getProjectSettings()->getTempDBFilePath(),
+					std::to_wstring(SqliteIndexStorage::getStorageVersion()),
+					sourcePath,
+					runInParallel);
+			indexerCommand->setExecutionOrder(executionOrder);
+			indexerCommands.push_back(indexerCommand);
 		}
 	}
 
@@ -138,6 +138,19 @@ bool ApplicationSettings::operator==(const ApplicationSettings& other) const
 		utility::isPermutation<FilePath>(getFrameworkSearchPaths(), other.getFrameworkSearchPaths());
 }
 
+std::shared_ptr<const ApplicationSettings::Snapshot> ApplicationSettings::getSnapshot() const
+{
+	std::lock_guard<std::mutex> lock(m_snapshotMutex);
+
+	const size_t revision = getConfigRevision();
+	if (!m_snapshot || m_snapshotRevision != revision)
+	{
+		m_snapshot = createSnapshot();
+		m_snapshotRevision = revision;
+	}
+	return m_snapshot;
+}
+
 int ApplicationSettings::getMaxRecentProjectsCount() const
 {
 	return 7;
@@ -145,7 +158,7 @@ int ApplicationSettings::getMaxRecentProjectsCount() const
 
 std::string ApplicationSettings::getFontName() const
 {
-	return getValue<std::string>("application/font_name", "Source Code Pro");
+	return getSnapshot()->fontName;
 }
 
 void ApplicationSettings::setFontName(const std::string& fontName)
@@ -155,7 +168,7 @@ void ApplicationSettings::setFontName(const std::string& fontName)
 
 int ApplicationSettings::getFontSize() const
 {
-	return getValue<int>("application/font_size", 14);
+	return getSnapshot()->fontSize;
 }
 
 void ApplicationSettings::setFontSize(int fontSize)
@@ -165,7 +178,7 @@ void ApplicationSettings::setFontSize(int fontSize)
 
 std::string ApplicationSettings::getTextEncoding() const
 {
-	return getValue<std::string>("application/text_encoding", "UTF-8");
+	return getSnapshot()->textEncoding;
 }
 
 void ApplicationSettings::setTextEncoding(const std::string& textEncoding)
@@ -175,7 +188,7 @@ void ApplicationSettings::setTextEncoding(const std::string& textEncoding)
 
 bool ApplicationSettings::getUseAnimations() const
 {
-	return getValue<bool>("application/use_animations", true);
+	return getSnapshot()->useAnimations;
 }
 
 void ApplicationSettings::setUseAnimations(bool useAnimations)
@@ -185,7 +198,7 @@ void ApplicationSettings::setUseAnimations(bool useAnimations)
 
 bool ApplicationSettings::getShowBuiltinTypesInGraph() const
 {
-	return getValue<bool>("application/builtin_types_in_graph", false);
+	return getSnapshot()->showBuiltinTypesInGraph;
 }
 
 void ApplicationSettings::setShowBuiltinTypesInGraph(bool showBuiltinTypes)
@@ -297,6 +310,26 @@ void ApplicationSettings::setGraphGrouping(GroupType type)
 	setValue<std::wstring>("application/graph_grouping", groupTypeToString(type));
 }
 
+bool ApplicationSettings::getGraphHardwareRenderingEnabled() const
+{
+	return getValue<bool>("application/graph_hardware_rendering", false);
+}
+
+void ApplicationSettings::setGraphHardwareRenderingEnabled(bool enabled)
+{
+	setValue<bool>("application/graph_hardware_rendering", enabled);
+}
+
+int ApplicationSettings::getLiveTabCount() const
+{
+	return getValue<int>("application/live_tab_count", 8);
+}
+
+void ApplicationSettings::setLiveTabCount(int count)
+{
+	setValue<int>("application/live_tab_count", count);
+}
+
 int ApplicationSettings::getScreenAutoScaling() const
 {
 	return getValue<int>("screen/auto_scaling", 1);
@@ -347,6 +380,16 @@ void ApplicationSettings::setStatusFilter(int mask)
 	setValue<int>("application/status_filter", mask);
 }
 
+int ApplicationSettings::getActivationLatencyBudgetMs() const
+{
+	return getValue<int>("application/activation_latency_budget_ms", 200);
+}
+
+void ApplicationSettings::setActivationLatencyBudgetMs(int budgetMs)
+{
+	setValue<int>("application/activation_latency_budget_ms", budgetMs);
+}
+
 int ApplicationSettings::getStatusFilter() const
 {
 	return getValue<int>(
@@ -378,6 +421,287 @@ void ApplicationSettings::setMultiProcessIndexingEnabled(bool enabled)
 	setValue<bool>("indexing/multi_process_indexing", enabled);
 }
 
+int ApplicationSettings::getIndexerProcessMemoryLimitMb() const
+{
+	return getValue<int>("indexing/indexer_process_memory_limit_mb", 4096);
+}
+
+void ApplicationSettings::setIndexerProcessMemoryLimitMb(int limit)
+{
+	setValue<int>("indexing/indexer_process_memory_limit_mb", limit);
+}
+
+int ApplicationSettings::getIsolatedIndexerProcessMemoryLimitMb() const
+{
+	return getValue<int>("indexing/isolated_indexer_process_memory_limit_mb", 16384);
+}
+
+void ApplicationSettings::setIsolatedIndexerProcessMemoryLimitMb(int limit)
+{
+	setValue<int>("indexing/isolated_indexer_process_memory_limit_mb", limit);
+}
+
+bool ApplicationSettings::getIndexerNumaPinningEnabled() const
+{
+	return getValue<bool>("indexing/numa_pinning_enabled", true);
+}
+
+void ApplicationSettings::setIndexerNumaPinningEnabled(bool enabled)
+{
+	setValue<bool>("indexing/numa_pinning_enabled", enabled);
+}
+
+bool ApplicationSettings::getIndexingInteractivePriorityEnabled() const
+{
+	return getValue<bool>("indexing/interactive_priority", true);
+}
+
+void ApplicationSettings::setIndexingInteractivePriorityEnabled(bool enabled)
+{
+	setValue<bool>("indexing/interactive_priority", enabled);
+}
+
+int ApplicationSettings::getStorageMemoryBudgetMb() const
+{
+	return getValue<int>("indexing/storage_memory_budget_mb", 4096);
+}
+
+void ApplicationSettings::setStorageMemoryBudgetMb(int budget)
+{
+	setValue<int>("indexing/storage_memory_budget_mb", budget);
+}
+
+bool ApplicationSettings::getAutomaticPrecompiledHeadersEnabled() const
+{
+	return getValue<bool>("indexing/automatic_precompiled_headers", true);
+}
+
+void ApplicationSettings::setAutomaticPrecompiledHeadersEnabled(bool enabled)
+{
+	setValue<bool>("indexing/automatic_precompiled_headers", enabled);
+}
+
+bool ApplicationSettings::getSkipIndexedHeadersEnabled() const
+{
+	return getValue<bool>("indexing/skip_indexed_headers", true);
+}
+
+void ApplicationSettings::setSkipIndexedHeadersEnabled(bool enabled)
+{
+	setValue<bool>("indexing/skip_indexed_headers", enabled);
+}
+
+FilePath ApplicationSettings::getIndexerResultCachePath() const
+{
+	return FilePath(getValue<std::wstring>("indexing/result_cache_path", L""));
+}
+
+void ApplicationSettings::setIndexerResultCachePath(const FilePath& path)
+{
+	setValue<std::wstring>("indexing/result_cache_path", path.wstr());
+}
+
+bool ApplicationSettings::getDeterministicIndexOutputEnabled() const
+{
+	return getValue<bool>("indexing/deterministic_output", false);
+}
+
+void ApplicationSettings::setDeterministicIndexOutputEnabled(bool enabled)
+{
+	setValue<bool>("indexing/deterministic_output", enabled);
+}
+
+bool ApplicationSettings::getCxxBraceRecordingEnabled() const
+{
+	return getValue<bool>("indexing/cxx/record_braces", true);
+}
+
+void ApplicationSettings::setCxxBraceRecordingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/cxx/record_braces", enabled);
+}
+
+bool ApplicationSettings::getCxxCommentRecordingEnabled() const
+{
+	return getValue<bool>("indexing/cxx/record_comments", true);
+}
+
+void ApplicationSettings::setCxxCommentRecordingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/cxx/record_comments", enabled);
+}
+
+bool ApplicationSettings::getCxxVisitorProfilingEnabled() const
+{
+	return getValue<bool>("indexing/cxx/visitor_profiling", false);
+}
+
+void ApplicationSettings::setCxxVisitorProfilingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/cxx/visitor_profiling", enabled);
+}
+
+int ApplicationSettings::getCxxVisitorThreadCount() const
+{
+	return getValue<int>("indexing/cxx/visitor_thread_count", 1);
+}
+
+void ApplicationSettings::setCxxVisitorThreadCount(int threadCount)
+{
+	setValue<int>("indexing/cxx/visitor_thread_count", threadCount);
+}
+
+bool ApplicationSettings::getCxxSharedModuleCacheEnabled() const
+{
+	return getValue<bool>("indexing/cxx/shared_module_cache", true);
+}
+
+void ApplicationSettings::setCxxSharedModuleCacheEnabled(bool enabled)
+{
+	setValue<bool>("indexing/cxx/shared_module_cache", enabled);
+}
+
+bool ApplicationSettings::getFileSystemWatcherEnabled() const
+{
+	return getValue<bool>("indexing/watch_file_system", true);
+}
+
+void ApplicationSettings::setFileSystemWatcherEnabled(bool enabled)
+{
+	setValue<bool>("indexing/watch_file_system", enabled);
+}
+
+bool ApplicationSettings::getRefreshOnFileSystemChangeEnabled() const
+{
+	return getValue<bool>("indexing/refresh_on_file_system_change", false);
+}
+
+void ApplicationSettings::setRefreshOnFileSystemChangeEnabled(bool enabled)
+{
+	setValue<bool>("indexing/refresh_on_file_system_change", enabled);
+}
+
+bool ApplicationSettings::getInPlaceRefreshEnabled() const
+{
+	return getValue<bool>("indexing/in_place_refresh", false);
+}
+
+void ApplicationSettings::setInPlaceRefreshEnabled(bool enabled)
+{
+	setValue<bool>("indexing/in_place_refresh", enabled);
+}
+
+bool ApplicationSettings::getIndexReplicaEnabled() const
+{
+	return getValue<bool>("storage/index_replica", false);
+}
+
+void ApplicationSettings::setIndexReplicaEnabled(bool enabled)
+{
+	setValue<bool>("storage/index_replica", enabled);
+}
+
+bool ApplicationSettings::getLowMemoryModeEnabled() const
+{
+	return getValue<bool>("storage/low_memory_mode", false);
+}
+
+void ApplicationSettings::setLowMemoryModeEnabled(bool enabled)
+{
+	setValue<bool>("storage/low_memory_mode", enabled);
+}
+
+int ApplicationSettings::getStorageReadConnectionCount() const
+{
+	return getValue<int>("storage/read_connection_count", 4);
+}
+
+void ApplicationSettings::setStorageReadConnectionCount(int count)
+{
+	setValue<int>("storage/read_connection_count", count);
+}
+
+int ApplicationSettings::getStorageMaintenanceIdleSeconds() const
+{
+	return getValue<int>("storage/maintenance_idle_seconds", 60);
+}
+
+void ApplicationSettings::setStorageMaintenanceIdleSeconds(int seconds)
+{
+	setValue<int>("storage/maintenance_idle_seconds", seconds);
+}
+
+bool ApplicationSettings::getStorageMaintenanceRebuildsIndices() const
+{
+	return getValue<bool>("storage/maintenance_rebuilds_indices", false);
+}
+
+void ApplicationSettings::setStorageMaintenanceRebuildsIndices(bool enabled)
+{
+	setValue<bool>("storage/maintenance_rebuilds_indices", enabled);
+}
+
+FilePath ApplicationSettings::getSharedCacheSnapshotPath() const
+{
+	return FilePath(getValue<std::wstring>("storage/shared_cache_snapshot_path", L""));
+}
+
+void ApplicationSettings::setSharedCacheSnapshotPath(const FilePath& path)
+{
+	setValue<std::wstring>("storage/shared_cache_snapshot_path", path.wstr());
+}
+
+int ApplicationSettings::getFileContentCacheMb() const
+{
+	return getValue<int>("storage/file_content_cache_mb", 64);
+}
+
+void ApplicationSettings::setFileContentCacheMb(int megabytes)
+{
+	setValue<int>("storage/file_content_cache_mb", megabytes);
+}
+
+bool ApplicationSettings::getSqliteQueryProfilingEnabled() const
+{
+	return getValue<bool>("storage/query_profiling", false);
+}
+
+void ApplicationSettings::setSqliteQueryProfilingEnabled(bool enabled)
+{
+	setValue<bool>("storage/query_profiling", enabled);
+}
+
+int ApplicationSettings::getSqliteSlowQueryThresholdMs() const
+{
+	return getValue<int>("storage/slow_query_threshold_ms", 100);
+}
+
+void ApplicationSettings::setSqliteSlowQueryThresholdMs(int thresholdMs)
+{
+	setValue<int>("storage/slow_query_threshold_ms", thresholdMs);
+}
+
+SqliteStorageSettings ApplicationSettings::getIndexingStorageSettings() const
+{
+	// the temp database is discarded if indexing does not finish, so there is no need to sync
+	return getStorageSettings("storage/indexing", SqliteStorageSettings("DELETE", "OFF", 65536, 0));
+}
+
+void ApplicationSettings::setIndexingStorageSettings(const SqliteStorageSettings& settings)
+{
+	setStorageSettings("storage/indexing", settings);
+}
+
+SqliteStorageSettings ApplicationSettings::getBrowsingStorageSettings() const
+{
+	return getStorageSettings("storage/browsing", SqliteStorageSettings("WAL", "NORMAL", 32768, 256));
+}
+
+SqliteStorageSettings ApplicationSettings::getBookmarkStorageSettings() const
+{
+	return getStorageSettings("storage/bookmarks", SqliteStorageSettings("", "", 0, 0));
+}
+
 FilePath ApplicationSettings::getJavaPath() const
 {
 	return FilePath(getValue<std::wstring>("indexing/java/java_path", L""));
@@ -398,6 +722,26 @@ void ApplicationSettings::setHasPrefilledJavaPath(bool v)
 	setValue<bool>("indexing/java/has_prefilled_java_path", v);
 }
 
+int ApplicationSettings::getJavaMaximumMemory() const
+{
+	return getValue<int>("indexing/java/java_maximum_memory", 0);
+}
+
+void ApplicationSettings::setJavaMaximumMemory(int size)
+{
+	setValue<int>("indexing/java/java_maximum_memory", size);
+}
+
+std::vector<std::string> ApplicationSettings::getJavaVmOptions() const
+{
+	return getValues<std::string>("indexing/java/jvm_options/jvm_option", {});
+}
+
+void ApplicationSettings::setJavaVmOptions(const std::vector<std::string>& options)
+{
+	setValues("indexing/java/jvm_options/jvm_option", options);
+}
+
 std::vector<FilePath> ApplicationSettings::getJreSystemLibraryPaths() const
 {
 	return getPathValues("indexing/java/jre_system_library_paths/jre_system_library_path");
@@ -424,6 +768,26 @@ void ApplicationSettings::setHasPrefilledJreSystemLibraryPaths(bool v)
 	setValue<bool>("indexing/java/has_prefilled_jre_system_library_paths", v);
 }
 
+int ApplicationSettings::getJavaIndexerBatchSize() const
+{
+	return getValue<int>("indexing/java/batch_size", 16);
+}
+
+void ApplicationSettings::setJavaIndexerBatchSize(int batchSize)
+{
+	setValue<int>("indexing/java/batch_size", batchSize);
+}
+
+int ApplicationSettings::getJavaParserThreadCount() const
+{
+	return getValue<int>("indexing/java/parser_thread_count", 1);
+}
+
+void ApplicationSettings::setJavaParserThreadCount(int threadCount)
+{
+	setValue<int>("indexing/java/parser_thread_count", threadCount);
+}
+
 FilePath ApplicationSettings::getMavenPath() const
 {
 	return FilePath(getValue<std::wstring>("indexing/java/maven_path", L""));
@@ -454,6 +818,16 @@ void ApplicationSettings::setPythonPostProcessingEnabled(bool enabled)
 	setValue<bool>("indexing/python/post_processing", enabled);
 }
 
+bool ApplicationSettings::getPythonRecordStreamingEnabled() const
+{
+	return getValue<bool>("indexing/python/record_streaming", false);
+}
+
+void ApplicationSettings::setPythonRecordStreamingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/python/record_streaming", enabled);
+}
+
 std::vector<FilePath> ApplicationSettings::getHeaderSearchPaths() const
 {
 	return getPathValues("indexing/cxx/header_search_paths/header_search_path");
@@ -507,7 +881,7 @@ void ApplicationSettings::setHasPrefilledFrameworkSearchPaths(bool v)
 
 int ApplicationSettings::getCodeTabWidth() const
 {
-	return getValue<int>("code/tab_width", 4);
+	return getSnapshot()->codeTabWidth;
 }
 
 void ApplicationSettings::setCodeTabWidth(int codeTabWidth)
@@ -527,7 +901,7 @@ void ApplicationSettings::setCodeSnippetSnapRange(int range)
 
 int ApplicationSettings::getCodeSnippetExpandRange() const
 {
-	return getValue<int>("code/snippet/expand_range", 3);
+	return getSnapshot()->codeSnippetExpandRange;
 }
 
 void ApplicationSettings::setCodeSnippetExpandRange(int range)
@@ -677,6 +1051,36 @@ void ApplicationSettings::setSourcetrailPort(const int sourcetrailPort)
 	setValue<int>("network/sourcetrail_port", sourcetrailPort);
 }
 
+int ApplicationSettings::getPluginActivationDelayMs() const
+{
+	return getValue<int>("network/plugin_activation_delay_ms", 50);
+}
+
+void ApplicationSettings::setPluginActivationDelayMs(int delay)
+{
+	setValue<int>("network/plugin_activation_delay_ms", delay);
+}
+
+bool ApplicationSettings::getIdeSavedFileIndexingEnabled() const
+{
+	return getValue<bool>("network/saved_file_indexing", false);
+}
+
+void ApplicationSettings::setIdeSavedFileIndexingEnabled(bool enabled)
+{
+	setValue<bool>("network/saved_file_indexing", enabled);
+}
+
+int ApplicationSettings::getIdeSavedFileIndexingDelayMs() const
+{
+	return getValue<int>("network/saved_file_indexing_delay_ms", 1000);
+}
+
+void ApplicationSettings::setIdeSavedFileIndexingDelayMs(int delay)
+{
+	setValue<int>("network/saved_file_indexing_delay_ms", delay);
+}
+
 int ApplicationSettings::getControlsMouseBackButton() const
 {
 	return getValue<int>("controls/mouse_back_button", 0x8);
@@ -696,3 +1100,35 @@ void ApplicationSettings::setControlsGraphZoomOnMouseWheel(bool zoomingDefault)
 {
 	setValue<bool>("controls/graph_zoom_on_mouse_wheel", zoomingDefault);
 }
+
+std::shared_ptr<const ApplicationSettings::Snapshot> ApplicationSettings::createSnapshot() const
+{
+	std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+	snapshot->fontName = getValue<std::string>("application/font_name", "Source Code Pro");
+	snapshot->fontSize = getValue<int>("application/font_size", 14);
+	snapshot->textEncoding = getValue<std::string>("application/text_encoding", "UTF-8");
+	snapshot->useAnimations = getValue<bool>("application/use_animations", true);
+	snapshot->showBuiltinTypesInGraph = getValue<bool>("application/builtin_types_in_graph", false);
+	snapshot->codeTabWidth = getValue<int>("code/tab_width", 4);
+	snapshot->codeSnippetExpandRange = getValue<int>("code/snippet/expand_range", 3);
+	return snapshot;
+}
+
+SqliteStorageSettings ApplicationSettings::getStorageSettings(
+	const std::string& key, const SqliteStorageSettings& defaultSettings) const
+{
+	return SqliteStorageSettings(
+		getValue<std::string>(key + "/journal_mode", defaultSettings.journalMode),
+		getValue<std::string>(key + "/synchronous", defaultSettings.synchronous),
+		getValue<int>(key + "/cache_size_kb", defaultSettings.cacheSizeKb),
+		getValue<int>(key + "/mmap_size_mb", defaultSettings.mmapSizeMb));
+}
+
+void ApplicationSettings::setStorageSettings(
+	const std::string& key, const SqliteStorageSettings& settings)
+{
+	setValue<std::string>(key + "/journal_mode", settings.journalMode);
+	setValue<std::string>(key + "/synchronous", settings.synchronous);
+	setValue<int>(key + "/cache_size_kb", settings.cacheSizeKb);
+	setValue<int>(key + "/mmap_size_mb", settings.mmapSizeMb);
+}
@@ -2,9 +2,11 @@
 #define APPLICATION_SETTINGS_H
 
 #include <memory>
+#include <mutex>
 
 #include "GroupType.h"
 #include "Settings.h"
+#include "SqliteStorageSettings.h"
 
 class TimeStamp;
 class Version;
@@ -22,6 +24,20 @@ public:
 
 	bool operator==(const ApplicationSettings& other) const;
 
+	// values read on hot paths, resolved once after each change of the settings
+	struct Snapshot
+	{
+		std::string fontName;
+		int fontSize = 0;
+		std::string textEncoding;
+		bool useAnimations = false;
+		bool showBuiltinTypesInGraph = false;
+		int codeTabWidth = 0;
+		int codeSnippetExpandRange = 0;
+	};
+
+	std::shared_ptr<const Snapshot> getSnapshot() const;
+
 	int getMaxRecentProjectsCount() const;
 
 	// application
@@ -68,6 +84,15 @@ public:
 	GroupType getGraphGrouping() const;
 	void setGraphGrouping(GroupType type);
 
+	// paints the graph through OpenGL, which keeps zooming and scrolling large graphs smooth
+	bool getGraphHardwareRenderingEnabled() const;
+	void setGraphHardwareRenderingEnabled(bool enabled);
+
+	// tabs that keep their views, the views of the least recently shown other tabs are released
+	// until they are shown again, 0 keeps all of them
+	int getLiveTabCount() const;
+	void setLiveTabCount(int count);
+
 	// screen
 	int getScreenAutoScaling() const;
 	void setScreenAutoScaling(int autoScaling);
@@ -88,6 +113,10 @@ public:
 	int getStatusFilter() const;
 	void setStatusFilter(int mask);
 
+	// activations of tokens that take longer get logged, 0 disables the logging
+	int getActivationLatencyBudgetMs() const;
+	void setActivationLatencyBudgetMs(int budgetMs);
+
 	// indexing
 	int getIndexerThreadCount() const;
 	void setIndexerThreadCount(const int count);
@@ -95,15 +124,130 @@ public:
 	bool getMultiProcessIndexingEnabled() const;
 	void setMultiProcessIndexingEnabled(bool enabled);
 
+	int getIndexerProcessMemoryLimitMb() const;
+	void setIndexerProcessMemoryLimitMb(int limit);
+	// allowance of the separate process that retries a file which exceeded the limit above
+	int getIsolatedIndexerProcessMemoryLimitMb() const;
+	void setIsolatedIndexerProcessMemoryLimitMb(int limit);
+
+	// spreads the indexer processes over the numa nodes, each one runs on the cpus of its node
+	bool getIndexerNumaPinningEnabled() const;
+	void setIndexerNumaPinningEnabled(bool enabled);
+
+	// indexer processes run at a lower priority, and indexing in the gui slows down while the user
+	// interacts with the app
+	bool getIndexingInteractivePriorityEnabled() const;
+	void setIndexingInteractivePriorityEnabled(bool enabled);
+
+	// memory for indexed data waiting to be stored, more is moved to temporary files
+	int getStorageMemoryBudgetMb() const;
+	void setStorageMemoryBudgetMb(int budget);
+
+	bool getAutomaticPrecompiledHeadersEnabled() const;
+	void setAutomaticPrecompiledHeadersEnabled(bool enabled);
+
+	bool getSkipIndexedHeadersEnabled() const;
+	void setSkipIndexedHeadersEnabled(bool enabled);
+
+	// directory with the indexed data of translation units, which may be shared between the
+	// machines indexing the same sources, no translation units are cached if empty
+	FilePath getIndexerResultCachePath() const;
+	void setIndexerResultCachePath(const FilePath& path);
+
+	// gives all elements ids derived from their data after indexing, so indexing the same sources
+	// writes the same database, which takes longer to finish
+	bool getDeterministicIndexOutputEnabled() const;
+	void setDeterministicIndexOutputEnabled(bool enabled);
+
+	// optional parts of the C/C++ indexer that can be turned off for faster headless indexing
+	bool getCxxBraceRecordingEnabled() const;
+	void setCxxBraceRecordingEnabled(bool enabled);
+
+	bool getCxxCommentRecordingEnabled() const;
+	void setCxxCommentRecordingEnabled(bool enabled);
+
+	// logs the time spent within each component of the C/C++ AST visitor
+	bool getCxxVisitorProfilingEnabled() const;
+	void setCxxVisitorProfilingEnabled(bool enabled);
+
+	// threads that visit the top level declarations of one large translation unit, each recording
+	// into its own storage that is merged afterwards
+	int getCxxVisitorThreadCount() const;
+	void setCxxVisitorThreadCount(int threadCount);
+
+	// translation units using implicit Clang modules share one module cache within the project
+	bool getCxxSharedModuleCacheEnabled() const;
+	void setCxxSharedModuleCacheEnabled(bool enabled);
+
+	bool getFileSystemWatcherEnabled() const;
+	void setFileSystemWatcherEnabled(bool enabled);
+
+	bool getRefreshOnFileSystemChangeEnabled() const;
+	void setRefreshOnFileSystemChangeEnabled(bool enabled);
+
+	// partial refreshes write into the index database within one transaction instead of a copy,
+	// which needs the browsing storage to use the WAL journal mode
+	bool getInPlaceRefreshEnabled() const;
+	void setInPlaceRefreshEnabled(bool enabled);
+
+	// keeps a copy of the most read tables of the index database in memory while browsing
+	bool getIndexReplicaEnabled() const;
+	void setIndexReplicaEnabled(bool enabled);
+
+	// searches symbols within the index database and reads edges from it while browsing, which
+	// bounds the memory used for large projects at the cost of slower searches and graphs
+	bool getLowMemoryModeEnabled() const;
+	void setLowMemoryModeEnabled(bool enabled);
+
+	// read only connections used next to the writing one while browsing, 0 disables them
+	int getStorageReadConnectionCount() const;
+	void setStorageReadConnectionCount(int count);
+
+	// seconds without input after which the index database gets analyzed and vacuumed, 0 disables
+	// the maintenance, rebuilding the indices is optional
+	int getStorageMaintenanceIdleSeconds() const;
+	void setStorageMaintenanceIdleSeconds(int seconds);
+	bool getStorageMaintenanceRebuildsIndices() const;
+	void setStorageMaintenanceRebuildsIndices(bool enabled);
+
+	// directory where all instances on the host keep the cache snapshots of the projects they open,
+	// so a shared index is loaded from one snapshot, snapshots are kept next to the projects if
+	// empty
+	FilePath getSharedCacheSnapshotPath() const;
+	void setSharedCacheSnapshotPath(const FilePath& path);
+
+	// budget of the stored file contents shared by code view, tooltips, fulltext search and refresh
+	int getFileContentCacheMb() const;
+	void setFileContentCacheMb(int megabytes);
+
+	// statements of the sqlite storages get timed and the plans of the slow ones written to the log
+	// directory on exit
+	bool getSqliteQueryProfilingEnabled() const;
+	void setSqliteQueryProfilingEnabled(bool enabled);
+	int getSqliteSlowQueryThresholdMs() const;
+	void setSqliteSlowQueryThresholdMs(int thresholdMs);
+
+	// sqlite pragmas of the temporary index database written while indexing, the index database
+	// used for browsing and the bookmark database
+	SqliteStorageSettings getIndexingStorageSettings() const;
+	void setIndexingStorageSettings(const SqliteStorageSettings& settings);
+	SqliteStorageSettings getBrowsingStorageSettings() const;
+	SqliteStorageSettings getBookmarkStorageSettings() const;
+
 	FilePath getJavaPath() const;
 	void setJavaPath(const FilePath& path);
 
 	bool getHasPrefilledJavaPath() const;
 	void setHasPrefilledJavaPath(bool v);
 
+	// maximum heap size of the JVM in MB, 0 keeps the default of the JVM
 	int getJavaMaximumMemory() const;
 	void setJavaMaximumMemory(int size);
 
+	// additional options passed to the JVM on startup, e.g. to choose the garbage collector
+	std::vector<std::string> getJavaVmOptions() const;
+	void setJavaVmOptions(const std::vector<std::string>& options);
+
 	std::vector<FilePath> getJreSystemLibraryPaths() const;
 	std::vector<FilePath> getJreSystemLibraryPathsExpanded() const;
 	bool setJreSystemLibraryPaths(const std::vector<FilePath>& jreSystemLibraryPaths);
@@ -111,6 +255,13 @@ public:
 	bool getHasPrefilledJreSystemLibraryPaths() const;
 	void setHasPrefilledJreSystemLibraryPaths(bool v);
 
+	// number of java files an indexer process parses together, 1 indexes each file on its own
+	int getJavaIndexerBatchSize() const;
+	void setJavaIndexerBatchSize(int batchSize);
+
+	int getJavaParserThreadCount() const;
+	void setJavaParserThreadCount(int threadCount);
+
 	FilePath getMavenPath() const;
 	void setMavenPath(const FilePath& path);
 
@@ -120,6 +271,10 @@ public:
 	bool getPythonPostProcessingEnabled() const;
 	void setPythonPostProcessingEnabled(bool enabled);
 
+	// lets the python indexer stream its records to stdout instead of writing a database
+	bool getPythonRecordStreamingEnabled() const;
+	void setPythonRecordStreamingEnabled(bool enabled);
+
 	std::vector<FilePath> getHeaderSearchPaths() const;
 	std::vector<FilePath> getHeaderSearchPathsExpanded() const;
 	bool setHeaderSearchPaths(const std::vector<FilePath>& headerSearchPaths);
@@ -182,6 +337,17 @@ public:
 	int getSourcetrailPort() const;
 	void setSourcetrailPort(const int sourcetrailPort);
 
+	// cursor positions a plugin sends within this time are coalesced into the last one
+	int getPluginActivationDelayMs() const;
+	void setPluginActivationDelayMs(int delay);
+
+	// files a plugin reports as saved are indexed in the background, saves within the delay are
+	// indexed together
+	bool getIdeSavedFileIndexingEnabled() const;
+	void setIdeSavedFileIndexingEnabled(bool enabled);
+	int getIdeSavedFileIndexingDelayMs() const;
+	void setIdeSavedFileIndexingDelayMs(int delay);
+
 	// controls
 	int getControlsMouseBackButton() const;
 	int getControlsMouseForwardButton() const;
@@ -193,7 +359,17 @@ private:
 	ApplicationSettings(const ApplicationSettings&);
 	void operator=(const ApplicationSettings&);
 
+	std::shared_ptr<const Snapshot> createSnapshot() const;
+
+	SqliteStorageSettings getStorageSettings(
+		const std::string& key, const SqliteStorageSettings& defaultSettings) const;
+	void setStorageSettings(const std::string& key, const SqliteStorageSettings& settings);
+
 	static std::shared_ptr<ApplicationSettings> s_instance;
+
+	mutable std::mutex m_snapshotMutex;
+	mutable std::shared_ptr<const Snapshot> m_snapshot;
+	mutable size_t m_snapshotRevision = 0;
 };
 
 #endif	  // APPLICATION_SETTINGS_H
@@ -31,6 +31,7 @@ const std::wstring ProjectSettings::PROJECT_FILE_EXTENSION = L".srctrlprj";
 const std::wstring ProjectSettings::BOOKMARK_DB_FILE_EXTENSION = L".srctrlbm";
 const std::wstring ProjectSettings::INDEX_DB_FILE_EXTENSION = L".srctrldb";
 const std::wstring ProjectSettings::TEMP_INDEX_DB_FILE_EXTENSION = L".srctrldb_tmp";
+const std::wstring ProjectSettings::CACHE_SNAPSHOT_FILE_EXTENSION = L".srctrlcache";
 
 const size_t ProjectSettings::VERSION = 8;
 
@@ -152,11 +153,30 @@ FilePath ProjectSettings::getTempDBFilePath() const
 	return getFilePath().replaceExtension(TEMP_INDEX_DB_FILE_EXTENSION);
 }
 
+FilePath ProjectSettings::getShardDBFilePath(size_t shardIndex, size_t shardCount) const
+{
+	return getFilePath().replaceExtension(
+		L".shard-" + std::to_wstring(shardIndex + 1) + L"-of-" + std::to_wstring(shardCount) +
+		INDEX_DB_FILE_EXTENSION);
+}
+
+FilePath ProjectSettings::getTempShardDBFilePath(size_t shardIndex, size_t shardCount) const
+{
+	return getFilePath().replaceExtension(
+		L".shard-" + std::to_wstring(shardIndex + 1) + L"-of-" + std::to_wstring(shardCount) +
+		TEMP_INDEX_DB_FILE_EXTENSION);
+}
+
 FilePath ProjectSettings::getBookmarkDBFilePath() const
 {
 	return getFilePath().replaceExtension(BOOKMARK_DB_FILE_EXTENSION);
 }
 
+FilePath ProjectSettings::getCacheSnapshotFilePath() const
+{
+	return getFilePath().replaceExtension(CACHE_SNAPSHOT_FILE_EXTENSION);
+}
+
 std::wstring ProjectSettings::getProjectName() const
 {
 	return getFilePath().withoutExtension().fileName();
@@ -17,6 +17,7 @@ public:
 	static const std::wstring BOOKMARK_DB_FILE_EXTENSION;
 	static const std::wstring INDEX_DB_FILE_EXTENSION;
 	static const std::wstring TEMP_INDEX_DB_FILE_EXTENSION;
+	static const std::wstring CACHE_SNAPSHOT_FILE_EXTENSION;
 
 	static const size_t VERSION;
 	static LanguageType getLanguageOfProject(const FilePath& filePath);
@@ -38,7 +39,11 @@ public:
 
 	FilePath getDBFilePath() const;
 	FilePath getTempDBFilePath() const;
+	// partial index databases written by distributed indexing, the index starts at 0
+	FilePath getShardDBFilePath(size_t shardIndex, size_t shardCount) const;
+	FilePath getTempShardDBFilePath(size_t shardIndex, size_t shardCount) const;
 	FilePath getBookmarkDBFilePath() const;
+	FilePath getCacheSnapshotFilePath() const;
 
 	std::wstring getProjectName() const;
 	FilePath getProjectDirectoryPath() const;
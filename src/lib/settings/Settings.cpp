@@ -131,6 +131,11 @@ bool Settings::isValueDefined(const std::string& key) const
 	return m_config->isValueDefined(key);
 }
 
+size_t Settings::getConfigRevision() const
+{
+	return m_config ? m_config->getRevision() : 0;
+}
+
 void Settings::removeValues(const std::string& key)
 {
 	m_config->removeValues(key);
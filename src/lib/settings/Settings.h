@@ -52,6 +52,9 @@ protected:
 
 	bool isValueDefined(const std::string& key) const;
 
+	// changes with every change or reload of the values
+	size_t getConfigRevision() const;
+
 	void removeValues(const std::string& key);
 
 	void enableWarnings() const;
@@ -22,6 +22,16 @@ void SourceGroupSettingsWithCustomCommand::setRunInParallel(bool runInParallel)
 	m_runInParallel = runInParallel;
 }
 
+int SourceGroupSettingsWithCustomCommand::getExecutionOrder() const
+{
+	return m_executionOrder;
+}
+
+void SourceGroupSettingsWithCustomCommand::setExecutionOrder(int executionOrder)
+{
+	m_executionOrder = executionOrder;
+}
+
 bool SourceGroupSettingsWithCustomCommand::equals(const SourceGroupSettingsBase* other) const
 {
 	const SourceGroupSettingsWithCustomCommand* otherPtr =
@@ -34,10 +44,12 @@ void SourceGroupSettingsWithCustomCommand::load(const ConfigManager* config, con
 {
 	setCustomCommand(config->getValueOrDefault(key + "/custom_command", std::wstring()));
 	setRunInParallel(config->getValueOrDefault(key + "/run_in_parallel", false));
+	setExecutionOrder(config->getValueOrDefault(key + "/execution_order", 0));
 }
 
 void SourceGroupSettingsWithCustomCommand::save(ConfigManager* config, const std::string& key)
 {
 	config->setValue(key + "/custom_command", getCustomCommand());
 	config->setValue(key + "/run_in_parallel", getRunInParallel());
+	config->setValue(key + "/execution_order", getExecutionOrder());
 }
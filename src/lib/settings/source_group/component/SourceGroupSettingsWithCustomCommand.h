@@ -14,6 +14,10 @@ public:
 	bool getRunInParallel() const;
 	void setRunInParallel(bool runInParallel);
 
+	// commands of source groups with a lower execution order finish before these ones start
+	int getExecutionOrder() const;
+	void setExecutionOrder(int executionOrder);
+
 protected:
 	bool equals(const SourceGroupSettingsBase* other) const override;
 
@@ -23,6 +27,7 @@ protected:
 private:
 	std::wstring m_customCommand;
 	bool m_runInParallel = false;
+	int m_executionOrder = 0;
 };
 
 #endif	  // SOURCE_GROUP_SETTINGS_WITH_CUSTOM_COMMAND_H
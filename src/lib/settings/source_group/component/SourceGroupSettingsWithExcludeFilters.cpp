@@ -1,5 +1,7 @@
 #include "SourceGroupSettingsWithExcludeFilters.h"
 
+#include <regex>
+
 #include "FilePathFilter.h"
 #include "FileSystem.h"
 #include "ProjectSettings.h"
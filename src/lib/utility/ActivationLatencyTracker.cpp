@@ -0,0 +1,158 @@
+#include "ActivationLatencyTracker.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "logging.h"
+#include "tracing.h"
+#include "utilityString.h"
+
+namespace
+{
+const size_t maxActivationCount = 32;
+
+thread_local Id t_currentActivationId = 0;
+
+std::wstring toMsString(long long microseconds)
+{
+	return std::to_wstring(microseconds / 1000) + L"." +
+		std::to_wstring((microseconds % 1000) / 100) + L" ms";
+}
+}	 // namespace
+
+ActivationLatencyTracker* ActivationLatencyTracker::getInstance()
+{
+	static std::shared_ptr<ActivationLatencyTracker> instance =
+		std::make_shared<ActivationLatencyTracker>();
+	return instance.get();
+}
+
+Id ActivationLatencyTracker::getCurrentActivationId()
+{
+	return t_currentActivationId;
+}
+
+ActivationLatencyTracker::ActivationLatencyTracker(): m_budgetMs(200) {}
+
+size_t ActivationLatencyTracker::getBudgetMs() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_budgetMs;
+}
+
+void ActivationLatencyTracker::setBudgetMs(size_t budgetMs)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_budgetMs = budgetMs;
+}
+
+void ActivationLatencyTracker::setDescription(Id activationId, const std::wstring& description)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	getActivation(activationId).description = description;
+}
+
+void ActivationLatencyTracker::addSpan(Id activationId, const Span& span)
+{
+	std::wstring report;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Activation& activation = getActivation(activationId);
+		if (activation.spans.empty())
+		{
+			activation.startTime = span.startTime;
+		}
+		activation.startTime = std::min(activation.startTime, span.startTime);
+		activation.endTime = std::max(activation.endTime, span.endTime);
+		activation.spans.push_back(span);
+
+		// only checked on view updates, the activation is not visible to the user before
+		if (span.isViewUpdate && !activation.exceededBudget && m_budgetMs &&
+			activation.getLatency() > static_cast<long long>(m_budgetMs) * 1000)
+		{
+			activation.exceededBudget = true;
+			report = getReport(activation);
+		}
+	}
+
+	if (!report.empty())
+	{
+		LOG_WARNING(
+			L"Activation exceeded the latency budget of " + std::to_wstring(getBudgetMs()) +
+			L" ms:\n" + report);
+	}
+}
+
+std::vector<ActivationLatencyTracker::Activation> ActivationLatencyTracker::getActivations() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return std::vector<Activation>(m_activations.begin(), m_activations.end());
+}
+
+std::wstring ActivationLatencyTracker::getReport(const Activation& activation)
+{
+	std::wstring report = L"activation " + std::to_wstring(activation.id);
+	if (!activation.description.empty())
+	{
+		report += L" \"" + activation.description + L"\"";
+	}
+	report += L": " + toMsString(activation.getLatency()) + L"\n";
+
+	std::vector<Span> spans = activation.spans;
+	std::stable_sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+		return a.startTime < b.startTime;
+	});
+	for (const Span& span: spans)
+	{
+		report += L"  +" + toMsString(span.startTime - activation.startTime) + L"  " +
+			utility::decodeFromUtf8(span.name) + L": " + toMsString(span.endTime - span.startTime) +
+			L"\n";
+	}
+	return report;
+}
+
+ActivationLatencyTracker::Activation& ActivationLatencyTracker::getActivation(Id activationId)
+{
+	for (auto it = m_activations.rbegin(); it != m_activations.rend(); it++)
+	{
+		if (it->id == activationId)
+		{
+			return *it;
+		}
+	}
+
+	if (m_activations.size() >= maxActivationCount)
+	{
+		m_activations.pop_front();
+	}
+	m_activations.emplace_back();
+	m_activations.back().id = activationId;
+	return m_activations.back();
+}
+
+ActivationLatencySpan::ActivationLatencySpan(const char* name, bool isViewUpdate)
+	: ActivationLatencySpan(t_currentActivationId, name, isViewUpdate)
+{
+}
+
+ActivationLatencySpan::ActivationLatencySpan(Id activationId, const char* name, bool isViewUpdate)
+	: m_activationId(activationId)
+	, m_previousActivationId(t_currentActivationId)
+	, m_name(name)
+	, m_isViewUpdate(isViewUpdate)
+	, m_startTime(activationId ? TimelineTracer::now() : 0)
+{
+	t_currentActivationId = activationId;
+}
+
+ActivationLatencySpan::~ActivationLatencySpan()
+{
+	t_currentActivationId = m_previousActivationId;
+
+	if (m_activationId)
+	{
+		ActivationLatencyTracker::getInstance()->addSpan(
+			m_activationId,
+			{m_name, m_startTime, TimelineTracer::now(), m_isViewUpdate});
+	}
+}
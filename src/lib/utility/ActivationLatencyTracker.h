@@ -0,0 +1,86 @@
+#ifndef ACTIVATION_LATENCY_TRACKER_H
+#define ACTIVATION_LATENCY_TRACKER_H
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+// Collects the time spent on each activation of tokens, from the creation of the
+// MessageActivateTokens until the last view showed its result. The controllers, their storage
+// calls and the view updates record spans for the activation, which is identified by the id of the
+// message. An activation that takes longer than the budget gets logged once with its spans.
+class ActivationLatencyTracker
+{
+public:
+	struct Span
+	{
+		std::string name;
+		long long startTime;	// microseconds, see TimelineTracer::now()
+		long long endTime;
+		bool isViewUpdate;
+	};
+
+	struct Activation
+	{
+		Id id = 0;
+		std::wstring description;
+		long long startTime = 0;
+		long long endTime = 0;
+		std::vector<Span> spans;
+		bool exceededBudget = false;
+
+		long long getLatency() const
+		{
+			return endTime - startTime;
+		}
+	};
+
+	static ActivationLatencyTracker* getInstance();
+
+	// id of the activation the spans of the calling thread are recorded for, 0 if there is none
+	static Id getCurrentActivationId();
+
+	ActivationLatencyTracker();
+
+	size_t getBudgetMs() const;
+	void setBudgetMs(size_t budgetMs);
+
+	void setDescription(Id activationId, const std::wstring& description);
+	void addSpan(Id activationId, const Span& span);
+
+	// the most recent activations, oldest first
+	std::vector<Activation> getActivations() const;
+
+	static std::wstring getReport(const Activation& activation);
+
+private:
+	friend class ActivationLatencySpan;
+
+	Activation& getActivation(Id activationId);
+
+	mutable std::mutex m_mutex;
+	std::deque<Activation> m_activations;
+	size_t m_budgetMs;
+};
+
+// Records a span for the passed activation, or for the current one of the thread if none is passed,
+// and makes the activation the current one of the thread until it is destroyed.
+class ActivationLatencySpan
+{
+public:
+	ActivationLatencySpan(const char* name, bool isViewUpdate = false);
+	ActivationLatencySpan(Id activationId, const char* name, bool isViewUpdate = false);
+	~ActivationLatencySpan();
+
+private:
+	const Id m_activationId;
+	const Id m_previousActivationId;
+	const char* m_name;
+	const bool m_isViewUpdate;
+	long long m_startTime;
+};
+
+#endif	  // ACTIVATION_LATENCY_TRACKER_H
@@ -10,6 +10,8 @@
 #include "utility.h"
 #include "utilityString.h"
 
+std::atomic<size_t> ConfigManager::s_revisionCount(0);
+
 std::shared_ptr<ConfigManager> ConfigManager::createEmpty()
 {
 	return std::shared_ptr<ConfigManager>(new ConfigManager());
@@ -30,6 +32,7 @@ std::shared_ptr<ConfigManager> ConfigManager::createCopy()
 void ConfigManager::clear()
 {
 	m_values.clear();
+	updateRevision();
 }
 
 bool ConfigManager::getValue(const std::string& key, std::string& value) const
@@ -219,6 +222,7 @@ void ConfigManager::setValue(const std::string& key, const std::string& value)
 	{
 		m_values.emplace(key, value);
 	}
+	updateRevision();
 }
 
 void ConfigManager::setValue(const std::string& key, const std::wstring& value)
@@ -260,6 +264,7 @@ void ConfigManager::setValues(const std::string& key, const std::vector<std::str
 	{
 		m_values.emplace(key, s);
 	}
+	updateRevision();
 }
 
 void ConfigManager::setValues(const std::string& key, const std::vector<std::wstring>& values)
@@ -319,6 +324,7 @@ void ConfigManager::removeValues(const std::string& key)
 		removeValues(sublevelKey);
 	}
 	m_values.erase(key);
+	updateRevision();
 }
 
 bool ConfigManager::isValueDefined(const std::string& key) const
@@ -366,6 +372,7 @@ bool ConfigManager::load(const std::shared_ptr<TextAccess> textAccess)
 		{
 			parseSubtree(childNode, "");
 		}
+		updateRevision();
 	}
 	else
 	{
@@ -381,16 +388,28 @@ void ConfigManager::save(const std::string filepath)
 	createXmlDocument(true, filepath, output);
 }
 
+size_t ConfigManager::getRevision() const
+{
+	return m_revision;
+}
+
 void ConfigManager::setWarnOnEmptyKey(bool warnOnEmptyKey) const
 {
 	m_warnOnEmptyKey = warnOnEmptyKey;
 }
 
-ConfigManager::ConfigManager(): m_warnOnEmptyKey(true) {}
+ConfigManager::ConfigManager(): m_revision(++s_revisionCount), m_warnOnEmptyKey(true) {}
 
 ConfigManager::ConfigManager(const ConfigManager& other)
-	: m_values(other.m_values), m_warnOnEmptyKey(other.m_warnOnEmptyKey)
+	: m_values(other.m_values)
+	, m_revision(++s_revisionCount)
+	, m_warnOnEmptyKey(other.m_warnOnEmptyKey)
+{
+}
+
+void ConfigManager::updateRevision()
 {
+	m_revision = ++s_revisionCount;
 }
 
 bool ConfigManager::createXmlDocument(bool saveAsFile, const std::string filepath, std::string& output)
@@ -1,6 +1,7 @@
 #ifndef CONFIG_MANAGER_H
 #define CONFIG_MANAGER_H
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -58,6 +59,9 @@ public:
 	bool isValueDefined(const std::string& key) const;
 	std::vector<std::string> getSublevelKeys(const std::string& key) const;
 
+	// changes with every change of the values, no two configs share a revision
+	size_t getRevision() const;
+
 	bool load(const std::shared_ptr<TextAccess> textAccess);
 	void save(const std::string filepath);
 	std::string toString();
@@ -69,10 +73,15 @@ private:
 	ConfigManager(const ConfigManager&);
 	void operator=(const ConfigManager&) = delete;
 
+	void updateRevision();
+
 	void parseSubtree(TiXmlNode* parentElement, const std::string& currentPath);
 	bool createXmlDocument(bool saveAsFile, std::string filepath, std::string& output);
 
+	static std::atomic<size_t> s_revisionCount;
+
 	std::multimap<std::string, std::string> m_values;
+	std::atomic<size_t> m_revision;
 	mutable bool m_warnOnEmptyKey;
 };
 
@@ -0,0 +1,71 @@
+#include "InternedStringPool.h"
+
+#include "MemoryUsage.h"
+
+InternedStringPool* InternedStringPool::getInstance()
+{
+	static InternedStringPool s_instance;
+	return &s_instance;
+}
+
+InternedStringPool::InternedStringPool()
+{
+	m_strings.emplace_back();
+}
+
+InternedStringPool::Handle InternedStringPool::intern(const std::wstring& str)
+{
+	if (str.empty())
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Handle handle = m_handles.find(str);
+	if (!handle)
+	{
+		handle = Handle(m_strings.size());
+		m_strings.push_back(str);
+		m_handles.add(str, handle);
+	}
+	return handle;
+}
+
+InternedStringPool::Handle InternedStringPool::find(const std::wstring& str) const
+{
+	if (str.empty())
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_handles.find(str);
+}
+
+const std::wstring& InternedStringPool::getString(Handle handle) const
+{
+	// elements of a deque keep their address when appending, so the reference outlives the lock
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (handle >= m_strings.size())
+	{
+		return m_strings.front();
+	}
+	return m_strings[handle];
+}
+
+size_t InternedStringPool::getStringCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_strings.size() - 1;
+}
+
+size_t InternedStringPool::getByteSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t byteSize = m_handles.getByteSize();
+	for (const std::wstring& str: m_strings)
+	{
+		byteSize += sizeof(str) + utility::getByteSize(str);
+	}
+	return byteSize;
+}
@@ -0,0 +1,40 @@
+#ifndef INTERNED_STRING_POOL_H
+#define INTERNED_STRING_POOL_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "LowMemoryStringMap.h"
+
+// Process wide pool that keeps each added string once and refers to it by a 32-bit handle, so
+// equal strings share their memory and are compared by their handles. Strings stay in the pool
+// for the lifetime of the process. The empty string always has the handle 0.
+class InternedStringPool
+{
+public:
+	typedef uint32_t Handle;
+
+	static InternedStringPool* getInstance();
+
+	InternedStringPool();
+
+	Handle intern(const std::wstring& str);
+
+	// returns 0 if the string was not added before
+	Handle find(const std::wstring& str) const;
+
+	// the returned reference stays valid, unknown handles return the empty string
+	const std::wstring& getString(Handle handle) const;
+
+	size_t getStringCount() const;
+	size_t getByteSize() const;
+
+private:
+	LowMemoryStringMap<std::wstring, Handle, 0> m_handles;
+	std::deque<std::wstring> m_strings;	   // the empty string is in front
+	mutable std::mutex m_mutex;
+};
+
+#endif	  // INTERNED_STRING_POOL_H
@@ -0,0 +1,88 @@
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// Unbounded queue that any number of threads push to without locking. Only one thread at a time
+// may pop, it sees the values of each pushing thread in the order they were pushed.
+template <typename ValueType>
+class LockFreeQueue
+{
+public:
+	LockFreeQueue();
+	~LockFreeQueue();
+
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+	void push(ValueType value);
+
+	// returns false if no value was pushed completely yet
+	bool pop(ValueType& value);
+
+	bool empty() const;
+
+private:
+	struct Node
+	{
+		Node(): next(nullptr) {}
+		Node(ValueType value): value(std::move(value)), next(nullptr) {}
+
+		ValueType value;
+		std::atomic<Node*> next;
+	};
+
+	// the newest node, pushing threads link their node behind it
+	std::atomic<Node*> m_head;
+
+	// the node whose value was popped last, its successor holds the next value
+	Node* m_tail;
+};
+
+template <typename ValueType>
+LockFreeQueue<ValueType>::LockFreeQueue(): m_head(new Node()), m_tail(m_head.load())
+{
+}
+
+template <typename ValueType>
+LockFreeQueue<ValueType>::~LockFreeQueue()
+{
+	while (m_tail)
+	{
+		Node* next = m_tail->next.load(std::memory_order_acquire);
+		delete m_tail;
+		m_tail = next;
+	}
+}
+
+template <typename ValueType>
+void LockFreeQueue<ValueType>::push(ValueType value)
+{
+	Node* node = new Node(std::move(value));
+	Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+	previous->next.store(node, std::memory_order_release);
+}
+
+template <typename ValueType>
+bool LockFreeQueue<ValueType>::pop(ValueType& value)
+{
+	Node* next = m_tail->next.load(std::memory_order_acquire);
+	if (!next)
+	{
+		return false;
+	}
+
+	value = std::move(next->value);
+	delete m_tail;
+	m_tail = next;
+	return true;
+}
+
+template <typename ValueType>
+bool LockFreeQueue<ValueType>::empty() const
+{
+	return !m_tail->next.load(std::memory_order_acquire);
+}
+
+#endif	  // LOCK_FREE_QUEUE_H
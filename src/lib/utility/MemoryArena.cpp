@@ -0,0 +1,63 @@
+#include "MemoryArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+const size_t MemoryArena::s_initialBlockSize = 64 * 1024;
+const size_t MemoryArena::s_maxBlockSize = 4 * 1024 * 1024;
+
+MemoryArena::MemoryArena()
+	: m_nextBlockSize(s_initialBlockSize)
+	, m_current(nullptr)
+	, m_remaining(0)
+	, m_allocatedByteCount(0)
+	, m_reservedByteCount(0)
+{
+}
+
+void* MemoryArena::allocate(size_t byteCount, size_t alignment)
+{
+	size_t padding = (alignment - reinterpret_cast<uintptr_t>(m_current) % alignment) % alignment;
+	if (!m_current || padding + byteCount > m_remaining)
+	{
+		addBlock(byteCount + alignment);
+		padding = (alignment - reinterpret_cast<uintptr_t>(m_current) % alignment) % alignment;
+	}
+
+	char* memory = m_current + padding;
+	m_current = memory + byteCount;
+	m_remaining -= padding + byteCount;
+	m_allocatedByteCount += byteCount;
+	return memory;
+}
+
+void MemoryArena::release()
+{
+	m_blocks.clear();
+	m_nextBlockSize = s_initialBlockSize;
+	m_current = nullptr;
+	m_remaining = 0;
+	m_allocatedByteCount = 0;
+	m_reservedByteCount = 0;
+}
+
+size_t MemoryArena::getAllocatedByteCount() const
+{
+	return m_allocatedByteCount;
+}
+
+size_t MemoryArena::getReservedByteCount() const
+{
+	return m_reservedByteCount;
+}
+
+void MemoryArena::addBlock(size_t minByteCount)
+{
+	const size_t blockSize = std::max(m_nextBlockSize, minByteCount);
+	m_blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+	m_reservedByteCount += blockSize;
+	m_nextBlockSize = std::min(m_nextBlockSize * 2, s_maxBlockSize);
+
+	m_current = m_blocks.back().get();
+	m_remaining = blockSize;
+}
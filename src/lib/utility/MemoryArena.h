@@ -0,0 +1,86 @@
+#ifndef MEMORY_ARENA_H
+#define MEMORY_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Monotonic allocator for data that is freed all at once, e.g. everything recorded while indexing
+// a single indexer command. Memory is handed out from growing blocks and only given back when the
+// arena is released or destroyed. Not thread safe, each indexer command uses its own arena.
+class MemoryArena
+{
+public:
+	MemoryArena();
+
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+
+	void* allocate(size_t byteCount, size_t alignment);
+
+	// all memory handed out before becomes invalid
+	void release();
+
+	size_t getAllocatedByteCount() const;
+	size_t getReservedByteCount() const;
+
+private:
+	static const size_t s_initialBlockSize;
+	static const size_t s_maxBlockSize;
+
+	void addBlock(size_t minByteCount);
+
+	std::vector<std::unique_ptr<char[]>> m_blocks;
+	size_t m_nextBlockSize;
+
+	char* m_current;
+	size_t m_remaining;
+
+	size_t m_allocatedByteCount;
+	size_t m_reservedByteCount;
+};
+
+// Standard allocator interface on top of a MemoryArena, deallocation is a no-op. The arena has to
+// outlive all containers using it.
+template <typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	ArenaAllocator(MemoryArena* arena): m_arena(arena) {}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other): m_arena(other.getArena())
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, size_t) {}
+
+	MemoryArena* getArena() const
+	{
+		return m_arena;
+	}
+
+private:
+	MemoryArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+	return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+	return !(a == b);
+}
+
+#endif	  // MEMORY_ARENA_H
@@ -0,0 +1,56 @@
+#include "MemoryUsage.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+void MemoryUsage::add(const std::string& name, size_t byteSize)
+{
+	entries.emplace_back(name, byteSize);
+}
+
+size_t MemoryUsage::getTotalByteSize() const
+{
+	size_t byteSize = 0;
+	for (const std::pair<std::string, size_t>& entry: entries)
+	{
+		byteSize += entry.second;
+	}
+	return byteSize;
+}
+
+std::string MemoryUsage::toString() const
+{
+	size_t nameWidth = 5;
+	for (const std::pair<std::string, size_t>& entry: entries)
+	{
+		nameWidth = std::max(nameWidth, entry.first.size());
+	}
+
+	std::stringstream ss;
+	for (const std::pair<std::string, size_t>& entry: entries)
+	{
+		ss << std::left << std::setw(int(nameWidth)) << entry.first << "  " << std::right
+		   << std::setw(10) << utility::getByteSizeString(entry.second) << "\n";
+	}
+	ss << std::left << std::setw(int(nameWidth)) << "total"
+	   << "  " << std::right << std::setw(10) << utility::getByteSizeString(getTotalByteSize())
+	   << "\n";
+	return ss.str();
+}
+
+std::string utility::getByteSizeString(size_t byteSize)
+{
+	const char* units[] = {"B", "KB", "MB", "GB"};
+	double size = double(byteSize);
+	size_t unit = 0;
+	while (size >= 1024.0 && unit < 3)
+	{
+		size /= 1024.0;
+		unit++;
+	}
+
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(unit ? 1 : 0) << size << " " << units[unit];
+	return ss.str();
+}
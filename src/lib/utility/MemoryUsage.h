@@ -0,0 +1,57 @@
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Heap bytes used by the parts of a subsystem, as far as they account for them. Containers count
+// with their capacity, the bookkeeping of node based containers is estimated.
+struct MemoryUsage
+{
+	void add(const std::string& name, size_t byteSize);
+	size_t getTotalByteSize() const;
+
+	// one line per entry and a total line
+	std::string toString() const;
+
+	std::vector<std::pair<std::string, size_t>> entries;
+};
+
+namespace utility
+{
+template <typename T>
+size_t getByteSize(const std::vector<T>& v)
+{
+	return v.capacity() * sizeof(T);
+}
+
+// short strings are stored within the object and don't use heap memory
+template <typename CharT>
+size_t getByteSize(const std::basic_string<CharT>& str)
+{
+	return str.capacity() * sizeof(CharT) >= sizeof(str) ? (str.capacity() + 1) * sizeof(CharT)
+														  : 0;
+}
+
+template <typename KeyT, typename ValueT>
+size_t getByteSize(const std::map<KeyT, ValueT>& m)
+{
+	return m.size() * (sizeof(typename std::map<KeyT, ValueT>::value_type) + 4 * sizeof(void*));
+}
+
+template <typename KeyT, typename ValueT>
+size_t getByteSize(const std::unordered_map<KeyT, ValueT>& m)
+{
+	return m.size() *
+		(sizeof(typename std::unordered_map<KeyT, ValueT>::value_type) + 2 * sizeof(void*)) +
+		m.bucket_count() * sizeof(void*);
+}
+
+// e.g. "12.3 MB"
+std::string getByteSizeString(size_t byteSize);
+}	 // namespace utility
+
+#endif	  // MEMORY_USAGE_H
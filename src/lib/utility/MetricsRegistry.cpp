@@ -0,0 +1,306 @@
+#include "MetricsRegistry.h"
+
+#include <sstream>
+
+#include "logging.h"
+
+namespace
+{
+std::string formatNumber(double value)
+{
+	std::ostringstream stream;
+	stream.precision(12);
+	stream << value;
+	return stream.str();
+}
+
+std::string getMetricName(const std::string& name, const std::string& labels)
+{
+	return labels.empty() ? name : name + '{' + labels + '}';
+}
+
+// the bucket bound is added to the labels of the metric
+std::string getBucketName(
+	const std::string& name, const std::string& labels, const std::string& bound)
+{
+	return name + "_bucket{" + (labels.empty() ? "" : labels + ',') + "le=\"" + bound + "\"}";
+}
+
+std::string escapeJson(const std::string& str)
+{
+	std::string escaped;
+	for (const char c: str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+void addAtomically(std::atomic<double>& target, double value)
+{
+	double current = target.load();
+	while (!target.compare_exchange_weak(current, current + value))
+	{
+	}
+}
+}	 // namespace
+
+MetricCounter::MetricCounter(): m_value(0) {}
+
+void MetricCounter::add(unsigned long long value)
+{
+	m_value.fetch_add(value, std::memory_order_relaxed);
+}
+
+unsigned long long MetricCounter::getValue() const
+{
+	return m_value.load(std::memory_order_relaxed);
+}
+
+MetricGauge::MetricGauge(): m_value(0.0) {}
+
+void MetricGauge::set(double value)
+{
+	m_value.store(value, std::memory_order_relaxed);
+}
+
+void MetricGauge::setFunction(std::function<double()> function)
+{
+	std::lock_guard<std::mutex> lock(m_functionMutex);
+	m_function = function;
+}
+
+double MetricGauge::getValue() const
+{
+	{
+		std::lock_guard<std::mutex> lock(m_functionMutex);
+		if (m_function)
+		{
+			return m_function();
+		}
+	}
+	return m_value.load(std::memory_order_relaxed);
+}
+
+MetricHistogram::MetricHistogram(const std::vector<double>& bucketBounds)
+	: m_bucketBounds(bucketBounds)
+	, m_bucketCounts(new std::atomic<unsigned long long>[bucketBounds.size()])
+	, m_count(0)
+	, m_sum(0.0)
+{
+	for (size_t i = 0; i < m_bucketBounds.size(); i++)
+	{
+		m_bucketCounts[i] = 0;
+	}
+}
+
+void MetricHistogram::observe(double value)
+{
+	for (size_t i = 0; i < m_bucketBounds.size(); i++)
+	{
+		if (value <= m_bucketBounds[i])
+		{
+			m_bucketCounts[i].fetch_add(1, std::memory_order_relaxed);
+			break;
+		}
+	}
+	m_count.fetch_add(1, std::memory_order_relaxed);
+	addAtomically(m_sum, value);
+}
+
+const std::vector<double>& MetricHistogram::getBucketBounds() const
+{
+	return m_bucketBounds;
+}
+
+std::vector<unsigned long long> MetricHistogram::getBucketCounts() const
+{
+	std::vector<unsigned long long> bucketCounts;
+	unsigned long long count = 0;
+	for (size_t i = 0; i < m_bucketBounds.size(); i++)
+	{
+		count += m_bucketCounts[i].load(std::memory_order_relaxed);
+		bucketCounts.push_back(count);
+	}
+	return bucketCounts;
+}
+
+unsigned long long MetricHistogram::getCount() const
+{
+	return m_count.load(std::memory_order_relaxed);
+}
+
+double MetricHistogram::getSum() const
+{
+	return m_sum.load(std::memory_order_relaxed);
+}
+
+const std::vector<double> MetricsRegistry::s_durationBuckets = {
+	0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0, 5.0, 10.0, 60.0};
+
+std::shared_ptr<MetricsRegistry> MetricsRegistry::getInstance()
+{
+	static std::shared_ptr<MetricsRegistry> instance = std::make_shared<MetricsRegistry>();
+	return instance;
+}
+
+MetricsRegistry::MetricsRegistry() {}
+
+MetricCounter& MetricsRegistry::getCounter(
+	const std::string& name, const std::string& help, const std::string& labels)
+{
+	std::lock_guard<std::mutex> lock(m_familiesMutex);
+	std::unique_ptr<MetricCounter>& counter =
+		getFamily(name, help, METRIC_COUNTER).counters[labels];
+	if (!counter)
+	{
+		counter = std::make_unique<MetricCounter>();
+	}
+	return *counter;
+}
+
+MetricGauge& MetricsRegistry::getGauge(
+	const std::string& name, const std::string& help, const std::string& labels)
+{
+	std::lock_guard<std::mutex> lock(m_familiesMutex);
+	std::unique_ptr<MetricGauge>& gauge = getFamily(name, help, METRIC_GAUGE).gauges[labels];
+	if (!gauge)
+	{
+		gauge = std::make_unique<MetricGauge>();
+	}
+	return *gauge;
+}
+
+MetricHistogram& MetricsRegistry::getHistogram(
+	const std::string& name,
+	const std::string& help,
+	const std::vector<double>& bucketBounds,
+	const std::string& labels)
+{
+	std::lock_guard<std::mutex> lock(m_familiesMutex);
+	std::unique_ptr<MetricHistogram>& histogram =
+		getFamily(name, help, METRIC_HISTOGRAM).histograms[labels];
+	if (!histogram)
+	{
+		histogram = std::make_unique<MetricHistogram>(bucketBounds);
+	}
+	return *histogram;
+}
+
+std::string MetricsRegistry::toJson() const
+{
+	std::lock_guard<std::mutex> lock(m_familiesMutex);
+
+	std::ostringstream json;
+	json << "{";
+	bool first = true;
+	auto addKey = [&](const std::string& key) {
+		json << (first ? "\n\t\"" : ",\n\t\"") << escapeJson(key) << "\": ";
+		first = false;
+	};
+
+	for (const std::pair<const std::string, MetricFamily>& family: m_families)
+	{
+		for (const auto& counter: family.second.counters)
+		{
+			addKey(getMetricName(family.first, counter.first));
+			json << counter.second->getValue();
+		}
+		for (const auto& gauge: family.second.gauges)
+		{
+			addKey(getMetricName(family.first, gauge.first));
+			json << formatNumber(gauge.second->getValue());
+		}
+		for (const auto& histogram: family.second.histograms)
+		{
+			addKey(getMetricName(family.first, histogram.first));
+			json << "{\"count\": " << histogram.second->getCount()
+				 << ", \"sum\": " << formatNumber(histogram.second->getSum()) << ", \"buckets\": {";
+
+			const std::vector<double>& bounds = histogram.second->getBucketBounds();
+			const std::vector<unsigned long long> counts = histogram.second->getBucketCounts();
+			for (size_t i = 0; i < bounds.size(); i++)
+			{
+				json << (i ? ", \"" : "\"") << formatNumber(bounds[i]) << "\": " << counts[i];
+			}
+			json << "}}";
+		}
+	}
+
+	json << "\n}\n";
+	return json.str();
+}
+
+std::string MetricsRegistry::toPrometheusText() const
+{
+	std::lock_guard<std::mutex> lock(m_familiesMutex);
+
+	std::ostringstream text;
+	for (const std::pair<const std::string, MetricFamily>& family: m_families)
+	{
+		const std::string& name = family.first;
+		switch (family.second.type)
+		{
+		case METRIC_COUNTER:
+			text << "# HELP " << name << ' ' << family.second.help << '\n';
+			text << "# TYPE " << name << " counter\n";
+			for (const auto& counter: family.second.counters)
+			{
+				text << getMetricName(name, counter.first) << ' ' << counter.second->getValue()
+					 << '\n';
+			}
+			break;
+		case METRIC_GAUGE:
+			text << "# HELP " << name << ' ' << family.second.help << '\n';
+			text << "# TYPE " << name << " gauge\n";
+			for (const auto& gauge: family.second.gauges)
+			{
+				text << getMetricName(name, gauge.first) << ' '
+					 << formatNumber(gauge.second->getValue()) << '\n';
+			}
+			break;
+		case METRIC_HISTOGRAM:
+			text << "# HELP " << name << ' ' << family.second.help << '\n';
+			text << "# TYPE " << name << " histogram\n";
+			for (const auto& histogram: family.second.histograms)
+			{
+				const std::vector<double>& bounds = histogram.second->getBucketBounds();
+				const std::vector<unsigned long long> counts = histogram.second->getBucketCounts();
+				for (size_t i = 0; i < bounds.size(); i++)
+				{
+					text << getBucketName(name, histogram.first, formatNumber(bounds[i])) << ' '
+						 << counts[i] << '\n';
+				}
+				text << getBucketName(name, histogram.first, "+Inf") << ' '
+					 << histogram.second->getCount() << '\n';
+				text << getMetricName(name + "_sum", histogram.first) << ' '
+					 << formatNumber(histogram.second->getSum()) << '\n';
+				text << getMetricName(name + "_count", histogram.first) << ' '
+					 << histogram.second->getCount() << '\n';
+			}
+			break;
+		}
+	}
+	return text.str();
+}
+
+MetricsRegistry::MetricFamily& MetricsRegistry::getFamily(
+	const std::string& name, const std::string& help, MetricType type)
+{
+	std::map<std::string, MetricFamily>::iterator it = m_families.find(name);
+	if (it == m_families.end())
+	{
+		it = m_families.emplace(name, MetricFamily()).first;
+		it->second.type = type;
+		it->second.help = help;
+	}
+	else if (it->second.type != type)
+	{
+		LOG_ERROR("Metric " + name + " is registered with another type and will not be exported");
+	}
+	return it->second;
+}
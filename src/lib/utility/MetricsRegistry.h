@@ -0,0 +1,115 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class MetricCounter
+{
+public:
+	MetricCounter();
+
+	void add(unsigned long long value = 1);
+	unsigned long long getValue() const;
+
+private:
+	std::atomic<unsigned long long> m_value;
+};
+
+class MetricGauge
+{
+public:
+	MetricGauge();
+
+	void set(double value);
+
+	// the function is called for every export instead of using the set value
+	void setFunction(std::function<double()> function);
+
+	double getValue() const;
+
+private:
+	std::atomic<double> m_value;
+
+	mutable std::mutex m_functionMutex;
+	std::function<double()> m_function;
+};
+
+class MetricHistogram
+{
+public:
+	// upper bounds of the buckets in ascending order, larger values are only counted in the total
+	MetricHistogram(const std::vector<double>& bucketBounds);
+
+	void observe(double value);
+
+	const std::vector<double>& getBucketBounds() const;
+
+	// cumulative like in Prometheus, the count of each bucket includes all smaller values
+	std::vector<unsigned long long> getBucketCounts() const;
+
+	unsigned long long getCount() const;
+	double getSum() const;
+
+private:
+	const std::vector<double> m_bucketBounds;
+	std::unique_ptr<std::atomic<unsigned long long>[]> m_bucketCounts;
+	std::atomic<unsigned long long> m_count;
+	std::atomic<double> m_sum;
+};
+
+// Keeps the metrics of the process, which can be exported as json or in the Prometheus text
+// format. Metrics are never removed, so callers can keep the returned references. Labels are
+// passed preformatted, like: phase="parse"
+class MetricsRegistry
+{
+public:
+	static std::shared_ptr<MetricsRegistry> getInstance();
+
+	// seconds from a millisecond to a minute
+	static const std::vector<double> s_durationBuckets;
+
+	MetricsRegistry();
+
+	MetricCounter& getCounter(
+		const std::string& name, const std::string& help, const std::string& labels = "");
+	MetricGauge& getGauge(
+		const std::string& name, const std::string& help, const std::string& labels = "");
+	MetricHistogram& getHistogram(
+		const std::string& name,
+		const std::string& help,
+		const std::vector<double>& bucketBounds = s_durationBuckets,
+		const std::string& labels = "");
+
+	std::string toJson() const;
+	std::string toPrometheusText() const;
+
+private:
+	enum MetricType
+	{
+		METRIC_COUNTER,
+		METRIC_GAUGE,
+		METRIC_HISTOGRAM
+	};
+
+	struct MetricFamily
+	{
+		MetricType type;
+		std::string help;
+		std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+		std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+		std::map<std::string, std::unique_ptr<MetricHistogram>> histograms;
+	};
+
+	MetricFamily& getFamily(const std::string& name, const std::string& help, MetricType type);
+
+	mutable std::mutex m_familiesMutex;
+	std::map<std::string, MetricFamily> m_families;
+};
+
+#endif	  // METRICS_REGISTRY_H
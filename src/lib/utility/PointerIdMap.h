@@ -0,0 +1,182 @@
+#ifndef POINTER_ID_MAP_H
+#define POINTER_ID_MAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "types.h"
+
+// Unordered map from pointers to ids stored as a single open addressing table with linear probing.
+// Lookups don't follow any node pointers, which makes them cheaper than the ones of an
+// std::unordered_map for the many small lookups done while indexing. The table is at most half
+// full, empty slots have a null key and the null pointer key is kept outside of the table.
+template <typename T>
+class PointerIdMap
+{
+public:
+	PointerIdMap(size_t expectedSize = 0);
+
+	// returns nullptr if the key is unknown
+	const Id* find(const T* key) const;
+
+	// keeps the id of a key that was inserted before
+	void emplace(const T* key, Id id);
+
+	size_t size() const;
+	void reserve(size_t expectedSize);
+	void clear();
+
+private:
+	struct Slot
+	{
+		const T* key;
+		Id id;
+	};
+
+	static const size_t s_minSlotCount = 16;
+
+	size_t getSlotIndex(const T* key) const;
+	void rehash(size_t slotCount);
+
+	std::vector<Slot> m_slots;	  // power of two slot count
+	size_t m_shift;
+	size_t m_size;
+
+	bool m_hasNullKey;
+	Id m_nullKeyId;
+};
+
+template <typename T>
+PointerIdMap<T>::PointerIdMap(size_t expectedSize)
+	: m_shift(0), m_size(0), m_hasNullKey(false), m_nullKeyId(0)
+{
+	rehash(s_minSlotCount);
+	reserve(expectedSize);
+}
+
+template <typename T>
+const Id* PointerIdMap<T>::find(const T* key) const
+{
+	if (!key)
+	{
+		return m_hasNullKey ? &m_nullKeyId : nullptr;
+	}
+
+	const size_t mask = m_slots.size() - 1;
+	for (size_t i = getSlotIndex(key);; i = (i + 1) & mask)
+	{
+		const Slot& slot = m_slots[i];
+		if (slot.key == key)
+		{
+			return &slot.id;
+		}
+		if (!slot.key)
+		{
+			return nullptr;
+		}
+	}
+}
+
+template <typename T>
+void PointerIdMap<T>::emplace(const T* key, Id id)
+{
+	if (!key)
+	{
+		if (!m_hasNullKey)
+		{
+			m_hasNullKey = true;
+			m_nullKeyId = id;
+			m_size++;
+		}
+		return;
+	}
+
+	if (2 * (m_size + 1) > m_slots.size())
+	{
+		rehash(2 * m_slots.size());
+	}
+
+	const size_t mask = m_slots.size() - 1;
+	for (size_t i = getSlotIndex(key);; i = (i + 1) & mask)
+	{
+		Slot& slot = m_slots[i];
+		if (slot.key == key)
+		{
+			return;
+		}
+		if (!slot.key)
+		{
+			slot.key = key;
+			slot.id = id;
+			m_size++;
+			return;
+		}
+	}
+}
+
+template <typename T>
+size_t PointerIdMap<T>::size() const
+{
+	return m_size;
+}
+
+template <typename T>
+void PointerIdMap<T>::reserve(size_t expectedSize)
+{
+	size_t slotCount = m_slots.size();
+	while (slotCount < 2 * expectedSize)
+	{
+		slotCount *= 2;
+	}
+
+	if (slotCount > m_slots.size())
+	{
+		rehash(slotCount);
+	}
+}
+
+template <typename T>
+void PointerIdMap<T>::clear()
+{
+	m_slots.clear();
+	rehash(s_minSlotCount);
+	m_size = 0;
+	m_hasNullKey = false;
+	m_nullKeyId = 0;
+}
+
+template <typename T>
+size_t PointerIdMap<T>::getSlotIndex(const T* key) const
+{
+	// fibonacci hashing spreads the aligned pointer values over the upper bits
+	return size_t((uint64_t(reinterpret_cast<uintptr_t>(key)) * 0x9E3779B97F4A7C15ull) >> m_shift);
+}
+
+template <typename T>
+void PointerIdMap<T>::rehash(size_t slotCount)
+{
+	std::vector<Slot> slots(slotCount, Slot {nullptr, 0});
+	slots.swap(m_slots);
+
+	m_shift = 64;
+	for (size_t count = slotCount; count > 1; count /= 2)
+	{
+		m_shift--;
+	}
+
+	const size_t mask = m_slots.size() - 1;
+	for (const Slot& slot: slots)
+	{
+		if (slot.key)
+		{
+			size_t i = getSlotIndex(slot.key);
+			while (m_slots[i].key)
+			{
+				i = (i + 1) & mask;
+			}
+			m_slots[i] = slot;
+		}
+	}
+}
+
+#endif	  // POINTER_ID_MAP_H
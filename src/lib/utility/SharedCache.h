@@ -0,0 +1,126 @@
+#ifndef SHARED_CACHE_H
+#define SHARED_CACHE_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "UnorderedCache.h"
+
+// An UnorderedCache that can be used by several threads at once. The keys are spread over shards
+// with their own lock, so threads only wait for each other when they look up keys of the same
+// shard. Values are calculated while the shard is locked, so each key is calculated once. A
+// maximum size other than 0 is split evenly between the shards.
+template <typename KeyType, typename ValType, typename Hasher = std::hash<KeyType>>
+class SharedCache
+{
+public:
+	SharedCache(
+		std::function<ValType(const KeyType&)> calculator,
+		size_t maxSize = 0,
+		size_t shardCount = 16);
+	ValType getValue(const KeyType& key) const;
+
+	size_t getSize() const;
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+	void clear();
+
+private:
+	struct Shard
+	{
+		Shard(std::function<ValType(const KeyType&)> calculator, size_t maxSize)
+			: cache(calculator, maxSize)
+		{
+		}
+
+		mutable std::mutex mutex;
+		UnorderedCache<KeyType, ValType, Hasher> cache;
+	};
+
+	Shard& getShard(const KeyType& key) const;
+
+	std::vector<std::unique_ptr<Shard>> m_shards;
+	Hasher m_hasher;
+};
+
+template <typename KeyType, typename ValType, typename Hasher>
+SharedCache<KeyType, ValType, Hasher>::SharedCache(
+	std::function<ValType(const KeyType&)> calculator, size_t maxSize, size_t shardCount)
+{
+	if (!shardCount)
+	{
+		shardCount = 1;
+	}
+
+	const size_t shardSize = (maxSize + shardCount - 1) / shardCount;
+	for (size_t i = 0; i < shardCount; i++)
+	{
+		m_shards.push_back(std::make_unique<Shard>(calculator, shardSize));
+	}
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+ValType SharedCache<KeyType, ValType, Hasher>::getValue(const KeyType& key) const
+{
+	Shard& shard = getShard(key);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	return shard.cache.getValue(key);
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t SharedCache<KeyType, ValType, Hasher>::getSize() const
+{
+	size_t size = 0;
+	for (const std::unique_ptr<Shard>& shard: m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		size += shard->cache.getSize();
+	}
+	return size;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t SharedCache<KeyType, ValType, Hasher>::getHitCount() const
+{
+	size_t count = 0;
+	for (const std::unique_ptr<Shard>& shard: m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		count += shard->cache.getHitCount();
+	}
+	return count;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t SharedCache<KeyType, ValType, Hasher>::getMissCount() const
+{
+	size_t count = 0;
+	for (const std::unique_ptr<Shard>& shard: m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		count += shard->cache.getMissCount();
+	}
+	return count;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void SharedCache<KeyType, ValType, Hasher>::clear()
+{
+	for (const std::unique_ptr<Shard>& shard: m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		shard->cache.clear();
+	}
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+typename SharedCache<KeyType, ValType, Hasher>::Shard& SharedCache<KeyType, ValType, Hasher>::
+	getShard(const KeyType& key) const
+{
+	return *m_shards[m_hasher(key) % m_shards.size()];
+}
+
+#endif	  // SHARED_CACHE_H
@@ -0,0 +1,95 @@
+#include "StartupProfile.h"
+
+#include <memory>
+
+#include "logging.h"
+#include "tracing.h"
+
+namespace
+{
+std::string toMsString(long long microseconds)
+{
+	return std::to_string(microseconds / 1000) + "." + std::to_string((microseconds % 1000) / 100) +
+		" ms";
+}
+}	 // namespace
+
+StartupProfile* StartupProfile::getInstance()
+{
+	static std::shared_ptr<StartupProfile> instance = std::make_shared<StartupProfile>();
+	return instance.get();
+}
+
+StartupProfile::StartupProfile()
+	: m_startTime(TimelineTracer::now()), m_phaseStartTime(m_startTime), m_finished(false)
+{
+}
+
+void StartupProfile::start()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_startTime = TimelineTracer::now();
+	m_phaseStartTime = m_startTime;
+	m_phases.clear();
+	m_finished = false;
+}
+
+void StartupProfile::finishPhase(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_finished)
+	{
+		addPhase(name);
+	}
+}
+
+void StartupProfile::finish(const std::string& name)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_finished)
+		{
+			return;
+		}
+
+		addPhase(name);
+		m_finished = true;
+	}
+
+	LOG_INFO(getReport());
+}
+
+bool StartupProfile::isFinished() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_finished;
+}
+
+std::vector<StartupProfile::Phase> StartupProfile::getPhases() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_phases;
+}
+
+long long StartupProfile::getTotalDuration() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_phaseStartTime - m_startTime;
+}
+
+std::string StartupProfile::getReport() const
+{
+	std::string report = "startup: " + toMsString(getTotalDuration()) + "\n";
+	for (const Phase& phase: getPhases())
+	{
+		report += "  " + phase.name + ": " + toMsString(phase.duration) + "\n";
+	}
+	return report;
+}
+
+void StartupProfile::addPhase(const std::string& name)
+{
+	const long long now = TimelineTracer::now();
+	m_phases.push_back({name, now - m_phaseStartTime});
+	m_phaseStartTime = now;
+}
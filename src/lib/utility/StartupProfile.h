@@ -0,0 +1,48 @@
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Collects the durations of the phases of the application startup, from the start of main until the
+// main window got painted for the first time, and logs them once as a breakdown.
+class StartupProfile
+{
+public:
+	struct Phase
+	{
+		std::string name;
+		long long duration;	   // microseconds
+	};
+
+	static StartupProfile* getInstance();
+
+	StartupProfile();
+
+	// drops the recorded phases, the first phase starts now
+	void start();
+
+	// ends the current phase, the next one starts now
+	void finishPhase(const std::string& name);
+
+	// ends the last phase and logs the breakdown, only the first call after start has an effect
+	void finish(const std::string& name);
+	bool isFinished() const;
+
+	std::vector<Phase> getPhases() const;
+	long long getTotalDuration() const;
+
+	std::string getReport() const;
+
+private:
+	void addPhase(const std::string& name);
+
+	mutable std::mutex m_mutex;
+	long long m_startTime;
+	long long m_phaseStartTime;
+	std::vector<Phase> m_phases;
+	bool m_finished;
+};
+
+#endif	  // STARTUP_PROFILE_H
@@ -0,0 +1,52 @@
+#include "TokenBucket.h"
+
+#include <algorithm>
+
+TokenBucket::TokenBucket(double capacity, double refillPerSecond)
+	: m_capacity(capacity)
+	, m_refillPerSecond(refillPerSecond)
+	, m_tokens(capacity)
+	, m_lastRefill(std::chrono::steady_clock::now())
+{
+}
+
+void TokenBucket::setRefillRate(double refillPerSecond)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	refill();
+	m_refillPerSecond = refillPerSecond;
+}
+
+void TokenBucket::fill()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_tokens = m_capacity;
+	m_lastRefill = std::chrono::steady_clock::now();
+}
+
+bool TokenBucket::hasTokens()
+{
+	return getTokens() > 0;
+}
+
+double TokenBucket::getTokens()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	refill();
+	return m_tokens;
+}
+
+void TokenBucket::consume(double tokens)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	refill();
+	m_tokens -= tokens;
+}
+
+void TokenBucket::refill()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const double seconds = std::chrono::duration<double>(now - m_lastRefill).count();
+	m_tokens = std::min(m_capacity, m_tokens + seconds * m_refillPerSecond);
+	m_lastRefill = now;
+}
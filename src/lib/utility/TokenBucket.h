@@ -0,0 +1,31 @@
+#ifndef TOKEN_BUCKET_H
+#define TOKEN_BUCKET_H
+
+#include <chrono>
+#include <mutex>
+
+// Grants work as long as tokens are left, the tokens refill at a constant rate up to the capacity.
+// Work may consume more tokens than are left, the debt delays the following work accordingly.
+class TokenBucket
+{
+public:
+	TokenBucket(double capacity, double refillPerSecond);
+
+	void setRefillRate(double refillPerSecond);
+	void fill();
+
+	bool hasTokens();
+	double getTokens();
+	void consume(double tokens);
+
+private:
+	void refill();
+
+	const double m_capacity;
+	double m_refillPerSecond;
+	double m_tokens;
+	std::chrono::steady_clock::time_point m_lastRefill;
+	std::mutex m_mutex;
+};
+
+#endif	  // TOKEN_BUCKET_H
@@ -2,26 +2,41 @@
 #define UNORDERED_CACHE_H
 
 #include <functional>
+#include <list>
 #include <unordered_map>
+#include <utility>
 
+// A maximum size other than 0 drops the least recently used values once the cache is full.
 template <typename KeyType, typename ValType, typename Hasher = std::hash<KeyType>>
 class UnorderedCache
 {
 public:
-	UnorderedCache(std::function<ValType(const KeyType&)> calculator);
+	UnorderedCache(std::function<ValType(const KeyType&)> calculator, size_t maxSize = 0);
 	ValType getValue(const KeyType& key);
 
+	size_t getSize() const;
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+	void clear();
+
 private:
+	typedef std::list<std::pair<KeyType, ValType>> EntryList;
+
 	std::function<ValType(const KeyType&)> m_calculator;
-	std::unordered_map<KeyType, ValType, Hasher> m_map;
+	const size_t m_maxSize;
+
+	EntryList m_entries;	// most recently used in front
+	std::unordered_map<KeyType, typename EntryList::iterator, Hasher> m_map;
 
 	size_t m_hitCount;
 	size_t m_missCount;
 };
 
 template <typename KeyType, typename ValType, typename Hasher>
-UnorderedCache<KeyType, ValType, Hasher>::UnorderedCache(std::function<ValType(const KeyType&)> calculator)
-	: m_calculator(calculator), m_hitCount(0), m_missCount(0)
+UnorderedCache<KeyType, ValType, Hasher>::UnorderedCache(
+	std::function<ValType(const KeyType&)> calculator, size_t maxSize)
+	: m_calculator(calculator), m_maxSize(maxSize), m_hitCount(0), m_missCount(0)
 {
 }
 
@@ -32,12 +47,49 @@ ValType UnorderedCache<KeyType, ValType, Hasher>::getValue(const KeyType& key)
 	if (it != m_map.end())
 	{
 		++m_hitCount;
-		return it->second;
+		if (m_maxSize)
+		{
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+		}
+		return it->second->second;
 	}
 	++m_missCount;
 	ValType val = m_calculator(key);
-	m_map.emplace(key, val);
+
+	if (m_maxSize && m_map.size() >= m_maxSize)
+	{
+		m_map.erase(m_entries.back().first);
+		m_entries.pop_back();
+	}
+
+	m_entries.emplace_front(key, val);
+	m_map.emplace(key, m_entries.begin());
 	return val;
 }
 
+template <typename KeyType, typename ValType, typename Hasher>
+size_t UnorderedCache<KeyType, ValType, Hasher>::getSize() const
+{
+	return m_map.size();
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t UnorderedCache<KeyType, ValType, Hasher>::getHitCount() const
+{
+	return m_hitCount;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t UnorderedCache<KeyType, ValType, Hasher>::getMissCount() const
+{
+	return m_missCount;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void UnorderedCache<KeyType, ValType, Hasher>::clear()
+{
+	m_map.clear();
+	m_entries.clear();
+}
+
 #endif	  // UNORDERED_CACHE_H
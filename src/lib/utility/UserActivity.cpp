@@ -0,0 +1,23 @@
+#include "UserActivity.h"
+
+#include <chrono>
+
+std::atomic<long long> UserActivity::s_lastActivityMs(UserActivity::now());
+
+void UserActivity::notify()
+{
+	s_lastActivityMs = now();
+}
+
+size_t UserActivity::getIdleMs()
+{
+	const long long idleMs = now() - s_lastActivityMs;
+	return idleMs > 0 ? size_t(idleMs) : 0;
+}
+
+long long UserActivity::now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
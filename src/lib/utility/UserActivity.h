@@ -0,0 +1,24 @@
+#ifndef USER_ACTIVITY_H
+#define USER_ACTIVITY_H
+
+#include <atomic>
+#include <cstddef>
+
+// Keeps track of the input of the user, so background work that would slow down the ui only runs
+// while the user is idle and can stop as soon as there is new input.
+class UserActivity
+{
+public:
+	// called for each key press, click and scroll, may be called from any thread
+	static void notify();
+
+	// milliseconds since the latest input or since the start of the application
+	static size_t getIdleMs();
+
+private:
+	static long long now();
+
+	static std::atomic<long long> s_lastActivityMs;
+};
+
+#endif	  // USER_ACTIVITY_H
@@ -6,7 +6,13 @@
 #include <boost/program_options.hpp>
 
 #include "CommandlineCommandConfig.h"
+#include "CommandlineCommandDiff.h"
+#include "CommandlineCommandExport.h"
+#include "CommandlineCommandGraph.h"
 #include "CommandlineCommandIndex.h"
+#include "CommandlineCommandLsp.h"
+#include "CommandlineCommandQuery.h"
+#include "CommandlineCommandServe.h"
 #include "CommandlineHelper.h"
 #include "ConfigManager.h"
 #include "TextAccess.h"
@@ -29,6 +35,12 @@ CommandLineParser::CommandLineParser(const std::string& version): m_version(vers
 
 	m_commands.push_back(std::make_unique<commandline::CommandlineCommandConfig>(this));
 	m_commands.push_back(std::make_unique<commandline::CommandlineCommandIndex>(this));
+	m_commands.push_back(std::make_unique<commandline::CommandlineCommandServe>(this));
+	m_commands.push_back(std::make_unique<commandline::CommandlineCommandQuery>(this));
+	m_commands.push_back(std::make_unique<commandline::CommandlineCommandLsp>(this));
+	m_commands.push_back(std::make_unique<commandline::CommandlineCommandExport>(this));
+	m_commands.push_back(std::make_unique<commandline::CommandlineCommandGraph>(this));
+	m_commands.push_back(std::make_unique<commandline::CommandlineCommandDiff>(this));
 
 	for (auto& command : m_commands)
 	{
@@ -251,4 +263,248 @@ bool CommandLineParser::getShallowIndexingRequested() const
 	return m_shallowIndexingRequested;
 }
 
+const FilePath& CommandLineParser::getIndexingReportFilePath() const
+{
+	return m_indexingReportFile;
+}
+
+void CommandLineParser::setIndexingReportFile(const FilePath& filepath)
+{
+	m_indexingReportFile = filepath;
+}
+
+const FilePath& CommandLineParser::getBenchmarkFilePath() const
+{
+	return m_benchmarkFile;
+}
+
+void CommandLineParser::setBenchmarkFile(const FilePath& filepath)
+{
+	m_benchmarkFile = filepath;
+}
+
+const FilePath& CommandLineParser::getTraceFilePath() const
+{
+	return m_traceFile;
+}
+
+void CommandLineParser::setTraceFile(const FilePath& filepath)
+{
+	m_traceFile = filepath;
+}
+
+const FilePath& CommandLineParser::getMetricsFilePath() const
+{
+	return m_metricsFile;
+}
+
+void CommandLineParser::setMetricsFile(const FilePath& filepath)
+{
+	m_metricsFile = filepath;
+}
+
+int CommandLineParser::getMetricsPort() const
+{
+	return m_metricsPort;
+}
+
+void CommandLineParser::setMetricsPort(int port)
+{
+	m_metricsPort = port;
+}
+
+const FilePath& CommandLineParser::getMemoryReportFilePath() const
+{
+	return m_memoryReportFile;
+}
+
+void CommandLineParser::setMemoryReportFile(const FilePath& filepath)
+{
+	m_memoryReportFile = filepath;
+}
+
+const IndexShard& CommandLineParser::getIndexShard() const
+{
+	return m_indexShard;
+}
+
+void CommandLineParser::setIndexShard(const IndexShard& shard)
+{
+	m_indexShard = shard;
+}
+
+const std::vector<FilePath>& CommandLineParser::getShardDbFilesToMerge() const
+{
+	return m_shardDbFilesToMerge;
+}
+
+void CommandLineParser::setShardDbFilesToMerge(const std::vector<FilePath>& filePaths)
+{
+	m_shardDbFilesToMerge = filePaths;
+}
+
+int CommandLineParser::getQueryServerPort() const
+{
+	return m_queryServerPort;
+}
+
+const std::string& CommandLineParser::getQueryServerHost() const
+{
+	return m_queryServerHost;
+}
+
+int CommandLineParser::getQueryServerWorkerCount() const
+{
+	return m_queryServerWorkerCount;
+}
+
+void CommandLineParser::setQueryServer(const std::string& host, int port, int workerCount)
+{
+	m_queryServerHost = host;
+	m_queryServerPort = port;
+	m_queryServerWorkerCount = workerCount;
+}
+
+const std::vector<std::string>& CommandLineParser::getQueriedSymbolNames() const
+{
+	return m_queriedSymbolNames;
+}
+
+int CommandLineParser::getSymbolQueryWorkerCount() const
+{
+	return m_symbolQueryWorkerCount;
+}
+
+void CommandLineParser::setSymbolQuery(const std::vector<std::string>& symbolNames, int workerCount)
+{
+	m_queriedSymbolNames = symbolNames;
+	m_symbolQueryWorkerCount = workerCount;
+}
+
+const FilePath& CommandLineParser::getIndexDeltaFilePath() const
+{
+	return m_indexDeltaFile;
+}
+
+void CommandLineParser::setIndexDeltaFile(const FilePath& filePath)
+{
+	m_indexDeltaFile = filePath;
+}
+
+const std::vector<FilePath>& CommandLineParser::getIndexDeltaFilesToApply() const
+{
+	return m_indexDeltaFilesToApply;
+}
+
+void CommandLineParser::setIndexDeltaFilesToApply(const std::vector<FilePath>& filePaths)
+{
+	m_indexDeltaFilesToApply = filePaths;
+}
+
+bool CommandLineParser::getJsonProgressRequested() const
+{
+	return m_jsonProgressRequested;
+}
+
+void CommandLineParser::setJsonProgressRequested(bool requested)
+{
+	m_jsonProgressRequested = requested;
+}
+
+int CommandLineParser::getIndexerProcessCount() const
+{
+	return m_indexerProcessCount;
+}
+
+void CommandLineParser::setIndexerProcessCount(int count)
+{
+	m_indexerProcessCount = count;
+}
+
+int CommandLineParser::getStorageMemoryBudgetMb() const
+{
+	return m_storageMemoryBudgetMb;
+}
+
+void CommandLineParser::setStorageMemoryBudgetMb(int budget)
+{
+	m_storageMemoryBudgetMb = budget;
+}
+
+const SqliteStorageSettings* CommandLineParser::getIndexingStorageSettings() const
+{
+	return m_indexingStorageSettings.get();
+}
+
+void CommandLineParser::setIndexingStorageSettings(const SqliteStorageSettings& settings)
+{
+	m_indexingStorageSettings = std::make_unique<SqliteStorageSettings>(settings);
+}
+
+bool CommandLineParser::getLanguageServerRequested() const
+{
+	return m_languageServerRequested;
+}
+
+void CommandLineParser::setLanguageServerRequested(bool requested)
+{
+	m_languageServerRequested = requested;
+}
+
+const FilePath& CommandLineParser::getExportDirectoryPath() const
+{
+	return m_exportDirectory;
+}
+
+void CommandLineParser::setExportDirectory(const FilePath& directoryPath)
+{
+	m_exportDirectory = directoryPath;
+}
+
+const std::string& CommandLineParser::getGraphExportFormat() const
+{
+	return m_graphExportFormat;
+}
+
+int CommandLineParser::getGraphExportEdgeTypes() const
+{
+	return m_graphExportEdgeTypes;
+}
+
+const FilePath& CommandLineParser::getGraphExportFilePath() const
+{
+	return m_graphExportFile;
+}
+
+void CommandLineParser::setGraphExport(
+	const std::string& format, int edgeTypes, const FilePath& filePath)
+{
+	m_graphExportFormat = format;
+	m_graphExportEdgeTypes = edgeTypes;
+	m_graphExportFile = filePath;
+}
+
+const FilePath& CommandLineParser::getIndexDiffOldDbFilePath() const
+{
+	return m_indexDiffOldDbFile;
+}
+
+const FilePath& CommandLineParser::getIndexDiffNewDbFilePath() const
+{
+	return m_indexDiffNewDbFile;
+}
+
+const FilePath& CommandLineParser::getIndexDiffFilePath() const
+{
+	return m_indexDiffFile;
+}
+
+void CommandLineParser::setIndexDiff(
+	const FilePath& oldDbFilePath, const FilePath& newDbFilePath, const FilePath& filePath)
+{
+	m_indexDiffOldDbFile = oldDbFilePath;
+	m_indexDiffNewDbFile = newDbFilePath;
+	m_indexDiffFile = filePath;
+}
+
 }	 // namespace commandline
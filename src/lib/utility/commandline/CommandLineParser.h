@@ -9,6 +9,7 @@
 
 #include "FilePath.h"
 #include "RefreshInfo.h"
+#include "SqliteStorageSettings.h"
 
 namespace po = boost::program_options;
 
@@ -42,6 +43,73 @@ public:
 	RefreshMode getRefreshMode() const;
 	bool getShallowIndexingRequested() const;
 
+	const FilePath& getIndexingReportFilePath() const;
+	void setIndexingReportFile(const FilePath& filepath);
+	const FilePath& getBenchmarkFilePath() const;
+	void setBenchmarkFile(const FilePath& filepath);
+	const FilePath& getTraceFilePath() const;
+	void setTraceFile(const FilePath& filepath);
+	const FilePath& getMetricsFilePath() const;
+	void setMetricsFile(const FilePath& filepath);
+	int getMetricsPort() const;
+	void setMetricsPort(int port);
+	const FilePath& getMemoryReportFilePath() const;
+	void setMemoryReportFile(const FilePath& filepath);
+	const IndexShard& getIndexShard() const;
+	void setIndexShard(const IndexShard& shard);
+	const std::vector<FilePath>& getShardDbFilesToMerge() const;
+	void setShardDbFilesToMerge(const std::vector<FilePath>& filePaths);
+	const FilePath& getIndexDeltaFilePath() const;
+	void setIndexDeltaFile(const FilePath& filePath);
+	const std::vector<FilePath>& getIndexDeltaFilesToApply() const;
+	void setIndexDeltaFilesToApply(const std::vector<FilePath>& filePaths);
+
+	// writes the progress of indexing as json lines to stdout
+	bool getJsonProgressRequested() const;
+	void setJsonProgressRequested(bool requested);
+
+	// overrides of the application settings for a single run, zero and nullptr keep the settings
+	int getIndexerProcessCount() const;
+	void setIndexerProcessCount(int count);
+	int getStorageMemoryBudgetMb() const;
+	void setStorageMemoryBudgetMb(int budget);
+	const SqliteStorageSettings* getIndexingStorageSettings() const;
+	void setIndexingStorageSettings(const SqliteStorageSettings& settings);
+
+	// the query server runs instead of indexing if a port is set
+	int getQueryServerPort() const;
+	const std::string& getQueryServerHost() const;
+	int getQueryServerWorkerCount() const;
+	void setQueryServer(const std::string& host, int port, int workerCount);
+
+	// the symbols get queried in parallel and printed as json instead of indexing if names are set
+	const std::vector<std::string>& getQueriedSymbolNames() const;
+	int getSymbolQueryWorkerCount() const;
+	void setSymbolQuery(const std::vector<std::string>& symbolNames, int workerCount);
+
+	// the language server answers on stdio instead of indexing
+	bool getLanguageServerRequested() const;
+	void setLanguageServerRequested(bool requested);
+
+	// a snapshot of the index gets exported instead of indexing if a directory is set
+	const FilePath& getExportDirectoryPath() const;
+	void setExportDirectory(const FilePath& directoryPath);
+
+	// the graph of the index gets written instead of indexing if a format is set, to stdout if the
+	// output file is empty
+	const std::string& getGraphExportFormat() const;
+	int getGraphExportEdgeTypes() const;
+	const FilePath& getGraphExportFilePath() const;
+	void setGraphExport(const std::string& format, int edgeTypes, const FilePath& filePath);
+
+	// the changes between two index databases get written instead of indexing if both are set, to
+	// stdout if the output file is empty
+	const FilePath& getIndexDiffOldDbFilePath() const;
+	const FilePath& getIndexDiffNewDbFilePath() const;
+	const FilePath& getIndexDiffFilePath() const;
+	void setIndexDiff(
+		const FilePath& oldDbFilePath, const FilePath& newDbFilePath, const FilePath& filePath);
+
 private:
 	void processProjectfile();
 	void printHelp() const;
@@ -54,6 +122,33 @@ private:
 
 	const std::string m_version;
 	FilePath m_projectFile;
+	FilePath m_indexingReportFile;
+	FilePath m_benchmarkFile;
+	FilePath m_traceFile;
+	FilePath m_metricsFile;
+	int m_metricsPort = 0;
+	FilePath m_memoryReportFile;
+	IndexShard m_indexShard;
+	std::vector<FilePath> m_shardDbFilesToMerge;
+	FilePath m_indexDeltaFile;
+	std::vector<FilePath> m_indexDeltaFilesToApply;
+	bool m_jsonProgressRequested = false;
+	int m_indexerProcessCount = 0;
+	int m_storageMemoryBudgetMb = 0;
+	std::unique_ptr<SqliteStorageSettings> m_indexingStorageSettings;
+	std::string m_queryServerHost;
+	int m_queryServerPort = 0;
+	int m_queryServerWorkerCount = 0;
+	std::vector<std::string> m_queriedSymbolNames;
+	int m_symbolQueryWorkerCount = 0;
+	bool m_languageServerRequested = false;
+	FilePath m_exportDirectory;
+	std::string m_graphExportFormat;
+	int m_graphExportEdgeTypes = 0;
+	FilePath m_graphExportFile;
+	FilePath m_indexDiffOldDbFile;
+	FilePath m_indexDiffNewDbFile;
+	FilePath m_indexDiffFile;
 	RefreshMode m_refreshMode = REFRESH_UPDATED_FILES;
 	bool m_shallowIndexingRequested = false;
 
@@ -95,6 +95,10 @@ void CommandlineCommandConfig::setup()
 		"indexing speed")(
 		"jvm-path,j", po::value<std::string>(), "Path to the location of the jvm library")(
 		"maven-path,m", po::value<std::string>(), "Path to the maven binary")(
+		"indexer-cache-path,c",
+		po::value<std::string>(),
+		"Directory that keeps the indexed translation units for later indexing runs, which may be "
+		"shared between machines (empty to disable)")(
 		"jre-system-library-paths,J",
 		po::value<std::vector<std::string>>(),
 		"paths to the jars of the JRE system library. "
@@ -152,7 +156,8 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 				  << "\n  verbose-indexer-logging-enabled: "
 				  << settings->getVerboseIndexerLoggingEnabled()
 				  << "\n  jvm-path: " << settings->getJavaPath().str()
-				  << "\n  maven-path: " << settings->getMavenPath().str();
+				  << "\n  maven-path: " << settings->getMavenPath().str()
+				  << "\n  indexer-cache-path: " << settings->getIndexerResultCachePath().str();
 		printVector("global-header-search-paths", settings->getHeaderSearchPaths());
 		printVector("global-framework-search-paths", settings->getFrameworkSearchPaths());
 		printVector("jre-system-library-paths", settings->getJreSystemLibraryPaths());
@@ -172,6 +177,8 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 
 	parseAndSetValue(&ApplicationSettings::setMavenPath, "maven-path", settings, vm);
 	parseAndSetValue(&ApplicationSettings::setJavaPath, "jvm-path", settings, vm);
+	parseAndSetValue(
+		&ApplicationSettings::setIndexerResultCachePath, "indexer-cache-path", settings, vm);
 
 	parseAndSetValue(
 		&ApplicationSettings::setJreSystemLibraryPaths, "jre-system-library-paths", settings, vm);
@@ -0,0 +1,79 @@
+#include "CommandlineCommandDiff.h"
+
+#include <iostream>
+
+#include "CommandLineParser.h"
+#include "CommandlineHelper.h"
+
+namespace po = boost::program_options;
+
+namespace commandline
+{
+CommandlineCommandDiff::CommandlineCommandDiff(CommandLineParser* parser)
+	: CommandlineCommand(
+		  "diff",
+		  "Write the symbols and edges added, removed or changed between two index databases as json lines.",
+		  parser)
+{
+}
+
+CommandlineCommandDiff::~CommandlineCommandDiff() {}
+
+void CommandlineCommandDiff::setup()
+{
+	po::options_description options("Config Options");
+	options.add_options()
+		("help,h", "Print this help message")
+		("output,o", po::value<std::string>(), "File to write the changes to, stdout if not set")
+		("old-db", po::value<std::string>(), "Index database of the old state (.srctrldb)")
+		("new-db", po::value<std::string>(), "Index database of the new state (.srctrldb)");
+
+	m_options.add(options);
+	m_positional.add("old-db", 1);
+	m_positional.add("new-db", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandDiff::parse(std::vector<std::string>& args)
+{
+	po::variables_map vm;
+	try
+	{
+		po::store(
+			po::command_line_parser(args).options(m_options).positional(m_positional).run(), vm);
+		po::notify(vm);
+
+		parseConfigFile(vm, m_options);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << m_options << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	if (vm.count("help") || args.size() == 0 || args[0] == "help")
+	{
+		printHelp();
+		return ReturnStatus::CMD_QUIT;
+	}
+
+	if (!vm.count("old-db") || !vm.count("new-db"))
+	{
+		std::cerr << "ERROR: Both index databases to compare are needed." << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	FilePath filePath;
+	if (vm.count("output"))
+	{
+		filePath = FilePath(vm["output"].as<std::string>()).makeAbsolute();
+	}
+	m_parser->setIndexDiff(
+		FilePath(vm["old-db"].as<std::string>()).makeAbsolute(),
+		FilePath(vm["new-db"].as<std::string>()).makeAbsolute(),
+		filePath);
+
+	return ReturnStatus::CMD_OK;
+}
+
+}	 // namespace commandline
@@ -0,0 +1,25 @@
+#ifndef COMMANDLINE_COMMAND_DIFF_H
+#define COMMANDLINE_COMMAND_DIFF_H
+
+#include "CommandlineCommand.h"
+
+namespace commandline
+{
+class CommandlineCommandDiff: public CommandlineCommand
+{
+public:
+	CommandlineCommandDiff(CommandLineParser* parser);
+	virtual ~CommandlineCommandDiff();
+
+	virtual void setup();
+	virtual ReturnStatus parse(std::vector<std::string>& args);
+
+	virtual bool hasHelp() const
+	{
+		return true;
+	}
+};
+
+}	 // namespace commandline
+
+#endif	  // COMMANDLINE_COMMAND_DIFF_H
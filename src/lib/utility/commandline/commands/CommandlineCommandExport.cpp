@@ -0,0 +1,71 @@
+#include "CommandlineCommandExport.h"
+
+#include <iostream>
+
+#include "CommandLineParser.h"
+#include "CommandlineHelper.h"
+
+namespace po = boost::program_options;
+
+namespace commandline
+{
+CommandlineCommandExport::CommandlineCommandExport(CommandLineParser* parser)
+	: CommandlineCommand(
+		  "export", "Export a read-only snapshot of an indexed project for distribution.", parser)
+{
+}
+
+CommandlineCommandExport::~CommandlineCommandExport() {}
+
+void CommandlineCommandExport::setup()
+{
+	po::options_description options("Config Options");
+	options.add_options()
+		("help,h", "Print this help message")
+		("output,o", po::value<std::string>(), "Directory to write the project file, index database and cache snapshot to")
+		("project-file", po::value<std::string>(), "Project file of the index to export (.srctrlprj)");
+
+	m_options.add(options);
+	m_positional.add("project-file", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandExport::parse(std::vector<std::string>& args)
+{
+	po::variables_map vm;
+	try
+	{
+		po::store(
+			po::command_line_parser(args).options(m_options).positional(m_positional).run(), vm);
+		po::notify(vm);
+
+		parseConfigFile(vm, m_options);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << m_options << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	if (vm.count("help") || args.size() == 0 || args[0] == "help")
+	{
+		printHelp();
+		return ReturnStatus::CMD_QUIT;
+	}
+
+	if (!vm.count("output"))
+	{
+		std::cerr << "ERROR: The output directory of the snapshot is missing." << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+	m_parser->setExportDirectory(FilePath(vm["output"].as<std::string>()).makeAbsolute());
+
+	if (vm.count("project-file"))
+	{
+		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
+	}
+
+	return ReturnStatus::CMD_OK;
+}
+
+}	 // namespace commandline
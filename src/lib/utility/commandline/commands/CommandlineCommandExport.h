@@ -0,0 +1,25 @@
+#ifndef COMMANDLINE_COMMAND_EXPORT_H
+#define COMMANDLINE_COMMAND_EXPORT_H
+
+#include "CommandlineCommand.h"
+
+namespace commandline
+{
+class CommandlineCommandExport: public CommandlineCommand
+{
+public:
+	CommandlineCommandExport(CommandLineParser* parser);
+	virtual ~CommandlineCommandExport();
+
+	virtual void setup();
+	virtual ReturnStatus parse(std::vector<std::string>& args);
+
+	virtual bool hasHelp() const
+	{
+		return true;
+	}
+};
+
+}	 // namespace commandline
+
+#endif	  // COMMANDLINE_COMMAND_EXPORT_H
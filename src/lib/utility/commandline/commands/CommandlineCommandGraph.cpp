@@ -0,0 +1,108 @@
+#include "CommandlineCommandGraph.h"
+
+#include <iostream>
+
+#include "CommandLineParser.h"
+#include "CommandlineHelper.h"
+#include "Edge.h"
+#include "StorageGraphWriter.h"
+#include "utilityString.h"
+
+namespace po = boost::program_options;
+
+namespace commandline
+{
+CommandlineCommandGraph::CommandlineCommandGraph(CommandLineParser* parser)
+	: CommandlineCommand(
+		  "graph",
+		  "Write the nodes and edges of an indexed project as dot, graphml or json.",
+		  parser)
+{
+}
+
+CommandlineCommandGraph::~CommandlineCommandGraph() {}
+
+void CommandlineCommandGraph::setup()
+{
+	po::options_description options("Config Options");
+	options.add_options()
+		("help,h", "Print this help message")
+		("format,f", po::value<std::string>()->default_value("dot"), "Format of the graph: dot, graphml or json")
+		("edges,e", po::value<std::string>()->default_value("all"), "Comma separated types of the edges to write, e.g. call,include,inheritance,type_use (all writes every type)")
+		("output,o", po::value<std::string>(), "File to write the graph to, stdout if not set")
+		("project-file", po::value<std::string>(), "Project file of the index to write the graph of (.srctrlprj)");
+
+	m_options.add(options);
+	m_positional.add("project-file", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandGraph::parse(std::vector<std::string>& args)
+{
+	po::variables_map vm;
+	try
+	{
+		po::store(
+			po::command_line_parser(args).options(m_options).positional(m_positional).run(), vm);
+		po::notify(vm);
+
+		parseConfigFile(vm, m_options);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << m_options << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	if (vm.count("help") || args.size() == 0 || args[0] == "help")
+	{
+		printHelp();
+		return ReturnStatus::CMD_QUIT;
+	}
+
+	const std::string format = vm["format"].as<std::string>();
+	StorageGraphWriter::Format writerFormat;
+	if (!StorageGraphWriter::getFormatForName(format, &writerFormat))
+	{
+		std::cerr << "ERROR: The graph format " << format << " is not valid." << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	Edge::TypeMask edgeTypes = 0;
+	for (const std::string& name: utility::splitToVector(vm["edges"].as<std::string>(), ','))
+	{
+		const std::wstring typeName = utility::decodeFromUtf8(utility::trim(name));
+		Edge::TypeMask typeMask = 0;
+		for (Edge::TypeMask mask = 1; mask <= Edge::EDGE_MAX_VALUE; mask *= 2)
+		{
+			if (typeName == L"all" ||
+				typeName == Edge::getUnderscoredTypeString(Edge::intToType(mask)))
+			{
+				typeMask |= mask;
+			}
+		}
+
+		if (!typeMask)
+		{
+			std::cerr << "ERROR: The edge type " << name << " is not valid." << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+		edgeTypes |= typeMask;
+	}
+
+	FilePath filePath;
+	if (vm.count("output"))
+	{
+		filePath = FilePath(vm["output"].as<std::string>()).makeAbsolute();
+	}
+	m_parser->setGraphExport(format, edgeTypes, filePath);
+
+	if (vm.count("project-file"))
+	{
+		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
+	}
+
+	return ReturnStatus::CMD_OK;
+}
+
+}	 // namespace commandline
@@ -0,0 +1,25 @@
+#ifndef COMMANDLINE_COMMAND_GRAPH_H
+#define COMMANDLINE_COMMAND_GRAPH_H
+
+#include "CommandlineCommand.h"
+
+namespace commandline
+{
+class CommandlineCommandGraph: public CommandlineCommand
+{
+public:
+	CommandlineCommandGraph(CommandLineParser* parser);
+	virtual ~CommandlineCommandGraph();
+
+	virtual void setup();
+	virtual ReturnStatus parse(std::vector<std::string>& args);
+
+	virtual bool hasHelp() const
+	{
+		return true;
+	}
+};
+
+}	 // namespace commandline
+
+#endif	  // COMMANDLINE_COMMAND_GRAPH_H
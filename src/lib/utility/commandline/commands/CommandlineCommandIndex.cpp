@@ -1,6 +1,7 @@
 #include "CommandlineCommandIndex.h"
 
 #include <iostream>
+#include <stdexcept>
 
 #include "CommandLineParser.h"
 #include "CommandlineHelper.h"
@@ -24,6 +25,20 @@ void CommandlineCommandIndex::setup()
 		("incomplete,i", "Also reindex incomplete files (files with errors)")
 		("full,f", "Index full project (omit to only index new/changed files)")
 		("shallow,s", "Build a shallow index is supported by the project")
+		("report,r", po::value<std::string>(), "Write indexing time and memory usage per source file to this csv file")
+		("benchmark,b", po::value<std::string>(), "Write throughput, peak memory, database size and phase times of the run to this json file")
+		("trace,t", po::value<std::string>(), "Record a timeline of the run and write it to this json file, which chrome://tracing and Perfetto open")
+		("metrics,m", po::value<std::string>(), "Write the metrics of the run to this file on exit, in the Prometheus text format for .prom files and as json otherwise")
+		("metrics-port", po::value<int>(), "Serve the metrics in the Prometheus text format on http://localhost:<port>/metrics while indexing")
+		("memory-report", po::value<std::string>(), "Write the memory used by the caches and search indices of the indexed project to this text file")
+		("shard", po::value<std::string>(), "Index only the part <i>/<N> of the source files into a partial database next to the project, for distributed indexing on N machines")
+		("merge", po::value<std::vector<std::string>>()->multitoken(), "Merge these partial databases of a distributed indexing run into the project database instead of indexing")
+		("delta", po::value<std::string>(), "Also write the data indexed by this run into this index delta, which brings copies of the index before the run up to date")
+		("apply-delta", po::value<std::vector<std::string>>()->multitoken(), "Apply these index deltas in order to the project database instead of indexing")
+		("json-progress", "Write the phases and progress of indexing as json lines to stdout instead of log messages")
+		("processes,p", po::value<int>(), "Number of indexer processes (overrides the application settings for this run)")
+		("memory-budget", po::value<int>(), "Memory budget of the storage in MB (overrides the application settings for this run)")
+		("storage-profile", po::value<std::string>(), "Tuning of the database while indexing: fast, default or low-memory (overrides the application settings for this run)")
 		("project-file", po::value<std::string>(), "Project file to index (.srctrlprj)");
 
 	m_options.add(options);
@@ -68,6 +83,164 @@ CommandlineCommand::ReturnStatus CommandlineCommandIndex::parse(std::vector<std:
 		m_parser->setShallowIndexingRequested();
 	}
 
+	if (vm.count("report"))
+	{
+		m_parser->setIndexingReportFile(FilePath(vm["report"].as<std::string>()));
+	}
+
+	if (vm.count("benchmark"))
+	{
+		m_parser->setBenchmarkFile(FilePath(vm["benchmark"].as<std::string>()));
+	}
+
+	if (vm.count("trace"))
+	{
+		m_parser->setTraceFile(FilePath(vm["trace"].as<std::string>()));
+	}
+
+	if (vm.count("metrics"))
+	{
+		m_parser->setMetricsFile(FilePath(vm["metrics"].as<std::string>()));
+	}
+
+	if (vm.count("metrics-port"))
+	{
+		m_parser->setMetricsPort(vm["metrics-port"].as<int>());
+	}
+
+	if (vm.count("memory-report"))
+	{
+		m_parser->setMemoryReportFile(FilePath(vm["memory-report"].as<std::string>()));
+	}
+
+	if (vm.count("shard"))
+	{
+		IndexShard shard;
+		const std::string value = vm["shard"].as<std::string>();
+		const size_t pos = value.find('/');
+		try
+		{
+			if (pos == std::string::npos)
+			{
+				throw std::invalid_argument(value);
+			}
+			shard.index = std::stoul(value.substr(0, pos));
+			shard.count = std::stoul(value.substr(pos + 1));
+		}
+		catch (std::exception&)
+		{
+			shard.count = 0;
+		}
+
+		if (shard.count == 0 || shard.index == 0 || shard.index > shard.count)
+		{
+			std::cerr << "ERROR: The shard \"" << value
+					  << "\" is not of the form <i>/<N> with 1 <= i <= N." << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+
+		// shards are numbered from 1 on the command line
+		shard.index--;
+		m_parser->setIndexShard(shard);
+		m_parser->fullRefresh();
+	}
+
+	if (vm.count("merge"))
+	{
+		if (vm.count("shard"))
+		{
+			std::cerr << "ERROR: The options shard and merge cannot be combined." << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+
+		std::vector<FilePath> shardDbFilePaths;
+		for (const std::string& filePath: vm["merge"].as<std::vector<std::string>>())
+		{
+			shardDbFilePaths.push_back(FilePath(filePath).makeAbsolute());
+		}
+		m_parser->setShardDbFilesToMerge(shardDbFilePaths);
+	}
+
+	if (vm.count("delta"))
+	{
+		if (vm.count("shard") || vm.count("merge"))
+		{
+			std::cerr << "ERROR: The option delta cannot be combined with shard or merge."
+					  << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+		m_parser->setIndexDeltaFile(FilePath(vm["delta"].as<std::string>()).makeAbsolute());
+	}
+
+	if (vm.count("apply-delta"))
+	{
+		if (vm.count("shard") || vm.count("merge") || vm.count("delta"))
+		{
+			std::cerr
+				<< "ERROR: The option apply-delta cannot be combined with shard, merge or delta."
+				<< std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+
+		std::vector<FilePath> deltaFilePaths;
+		for (const std::string& filePath: vm["apply-delta"].as<std::vector<std::string>>())
+		{
+			deltaFilePaths.push_back(FilePath(filePath).makeAbsolute());
+		}
+		m_parser->setIndexDeltaFilesToApply(deltaFilePaths);
+	}
+
+	if (vm.count("json-progress"))
+	{
+		m_parser->setJsonProgressRequested(true);
+	}
+
+	if (vm.count("processes"))
+	{
+		const int count = vm["processes"].as<int>();
+		if (count <= 0)
+		{
+			std::cerr << "ERROR: The number of processes has to be positive." << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+		m_parser->setIndexerProcessCount(count);
+	}
+
+	if (vm.count("memory-budget"))
+	{
+		const int budget = vm["memory-budget"].as<int>();
+		if (budget <= 0)
+		{
+			std::cerr << "ERROR: The memory budget has to be positive." << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+		m_parser->setStorageMemoryBudgetMb(budget);
+	}
+
+	if (vm.count("storage-profile"))
+	{
+		const std::string profile = vm["storage-profile"].as<std::string>();
+		if (profile == "fast")
+		{
+			// no rollback journal, so an interrupted run leaves a database that has to be reindexed
+			m_parser->setIndexingStorageSettings(SqliteStorageSettings("OFF", "OFF", 262144, 1024));
+		}
+		else if (profile == "default")
+		{
+			m_parser->setIndexingStorageSettings(SqliteStorageSettings("DELETE", "OFF", 65536, 0));
+		}
+		else if (profile == "low-memory")
+		{
+			m_parser->setIndexingStorageSettings(SqliteStorageSettings("DELETE", "OFF", 8192, 0));
+		}
+		else
+		{
+			std::cerr << "ERROR: The storage profile \"" << profile
+					  << "\" is not one of fast, default or low-memory." << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+	}
+
 	if (vm.count("project-file"))
 	{
 		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
@@ -0,0 +1,65 @@
+#include "CommandlineCommandLsp.h"
+
+#include <iostream>
+
+#include "CommandLineParser.h"
+#include "CommandlineHelper.h"
+
+namespace po = boost::program_options;
+
+namespace commandline
+{
+CommandlineCommandLsp::CommandlineCommandLsp(CommandLineParser* parser)
+	: CommandlineCommand(
+		  "lsp", "Answer language server protocol requests over stdio with an indexed project.", parser)
+{
+}
+
+CommandlineCommandLsp::~CommandlineCommandLsp() {}
+
+void CommandlineCommandLsp::setup()
+{
+	po::options_description options("Config Options");
+	options.add_options()
+		("help,h", "Print this help message")
+		("project-file", po::value<std::string>(), "Project file of the index to answer with (.srctrlprj)");
+
+	m_options.add(options);
+	m_positional.add("project-file", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandLsp::parse(std::vector<std::string>& args)
+{
+	po::variables_map vm;
+	try
+	{
+		po::store(
+			po::command_line_parser(args).options(m_options).positional(m_positional).run(), vm);
+		po::notify(vm);
+
+		parseConfigFile(vm, m_options);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << m_options << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	if (vm.count("help") || args.size() == 0 || args[0] == "help")
+	{
+		printHelp();
+		return ReturnStatus::CMD_QUIT;
+	}
+
+	m_parser->setLanguageServerRequested(true);
+
+	if (vm.count("project-file"))
+	{
+		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
+	}
+
+	return ReturnStatus::CMD_OK;
+}
+
+}	 // namespace commandline
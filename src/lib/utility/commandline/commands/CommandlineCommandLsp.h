@@ -0,0 +1,25 @@
+#ifndef COMMANDLINE_COMMAND_LSP_H
+#define COMMANDLINE_COMMAND_LSP_H
+
+#include "CommandlineCommand.h"
+
+namespace commandline
+{
+class CommandlineCommandLsp: public CommandlineCommand
+{
+public:
+	CommandlineCommandLsp(CommandLineParser* parser);
+	virtual ~CommandlineCommandLsp();
+
+	virtual void setup();
+	virtual ReturnStatus parse(std::vector<std::string>& args);
+
+	virtual bool hasHelp() const
+	{
+		return true;
+	}
+};
+
+}	 // namespace commandline
+
+#endif	  // COMMANDLINE_COMMAND_LSP_H
@@ -0,0 +1,115 @@
+#include "CommandlineCommandQuery.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "CommandLineParser.h"
+#include "CommandlineHelper.h"
+#include "utilityString.h"
+
+namespace po = boost::program_options;
+
+namespace commandline
+{
+CommandlineCommandQuery::CommandlineCommandQuery(CommandLineParser* parser)
+	: CommandlineCommand(
+		  "query",
+		  "Print the definitions, reference counts and callers of symbols of an indexed project as "
+		  "json.",
+		  parser)
+{
+}
+
+CommandlineCommandQuery::~CommandlineCommandQuery() {}
+
+void CommandlineCommandQuery::setup()
+{
+	po::options_description options("Config Options");
+	options.add_options()
+		("help,h", "Print this help message")
+		("symbol,s", po::value<std::vector<std::string>>()->composing(), "Qualified name of a symbol to query, may be given multiple times")
+		("symbol-file", po::value<std::string>(), "File with the qualified names of the symbols to query, one per line")
+		("workers,w", po::value<int>()->default_value(0), "Number of workers answering the queries in parallel, each with its own caches (0 uses ideal thread count)")
+		("project-file", po::value<std::string>(), "Project file of the index to query (.srctrlprj)");
+
+	m_options.add(options);
+	m_positional.add("project-file", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandQuery::parse(std::vector<std::string>& args)
+{
+	po::variables_map vm;
+	try
+	{
+		po::store(
+			po::command_line_parser(args).options(m_options).positional(m_positional).run(), vm);
+		po::notify(vm);
+
+		parseConfigFile(vm, m_options);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << m_options << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	if (vm.count("help") || args.size() == 0 || args[0] == "help")
+	{
+		printHelp();
+		return ReturnStatus::CMD_QUIT;
+	}
+
+	std::vector<std::string> symbolNames;
+	if (vm.count("symbol"))
+	{
+		symbolNames = vm["symbol"].as<std::vector<std::string>>();
+	}
+	if (vm.count("symbol-file"))
+	{
+		std::ifstream symbolFile(vm["symbol-file"].as<std::string>());
+		if (!symbolFile.is_open())
+		{
+			std::cerr << "ERROR: Could not open the symbol file "
+					  << vm["symbol-file"].as<std::string>() << std::endl;
+			return ReturnStatus::CMD_FAILURE;
+		}
+
+		std::string line;
+		while (std::getline(symbolFile, line))
+		{
+			line = utility::trim(line);
+			if (!line.empty())
+			{
+				symbolNames.push_back(line);
+			}
+		}
+	}
+
+	if (symbolNames.empty())
+	{
+		std::cerr << "ERROR: No symbols to query, use --symbol or --symbol-file." << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	int workerCount = vm["workers"].as<int>();
+	if (workerCount <= 0)
+	{
+		workerCount = std::max<int>(1, int(std::thread::hardware_concurrency()));
+	}
+
+	// more workers than symbols would only build caches that answer nothing
+	m_parser->setSymbolQuery(
+		symbolNames, std::min<int>(workerCount, int(symbolNames.size())));
+
+	if (vm.count("project-file"))
+	{
+		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
+	}
+
+	return ReturnStatus::CMD_OK;
+}
+
+}	 // namespace commandline
@@ -0,0 +1,25 @@
+#ifndef COMMANDLINE_COMMAND_QUERY_H
+#define COMMANDLINE_COMMAND_QUERY_H
+
+#include "CommandlineCommand.h"
+
+namespace commandline
+{
+class CommandlineCommandQuery: public CommandlineCommand
+{
+public:
+	CommandlineCommandQuery(CommandLineParser* parser);
+	virtual ~CommandlineCommandQuery();
+
+	virtual void setup();
+	virtual ReturnStatus parse(std::vector<std::string>& args);
+
+	virtual bool hasHelp() const
+	{
+		return true;
+	}
+};
+
+}	 // namespace commandline
+
+#endif	  // COMMANDLINE_COMMAND_QUERY_H
@@ -0,0 +1,82 @@
+#include "CommandlineCommandServe.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include "CommandLineParser.h"
+#include "CommandlineHelper.h"
+
+namespace po = boost::program_options;
+
+namespace commandline
+{
+CommandlineCommandServe::CommandlineCommandServe(CommandLineParser* parser)
+	: CommandlineCommand("serve", "Answer code navigation queries over an indexed project.", parser)
+{
+}
+
+CommandlineCommandServe::~CommandlineCommandServe() {}
+
+void CommandlineCommandServe::setup()
+{
+	po::options_description options("Config Options");
+	options.add_options()
+		("help,h", "Print this help message")
+		("port,p", po::value<int>()->default_value(6680), "Port to answer the json queries on")
+		("host", po::value<std::string>()->default_value("127.0.0.1"), "Address to listen on, 0.0.0.0 serves all network interfaces")
+		("workers,w", po::value<int>()->default_value(0), "Number of workers answering queries in parallel, each with its own caches (0 uses ideal thread count)")
+		("project-file", po::value<std::string>(), "Project file of the index to serve (.srctrlprj)");
+
+	m_options.add(options);
+	m_positional.add("project-file", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandServe::parse(std::vector<std::string>& args)
+{
+	po::variables_map vm;
+	try
+	{
+		po::store(
+			po::command_line_parser(args).options(m_options).positional(m_positional).run(), vm);
+		po::notify(vm);
+
+		parseConfigFile(vm, m_options);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << m_options << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	if (vm.count("help") || args.size() == 0 || args[0] == "help")
+	{
+		printHelp();
+		return ReturnStatus::CMD_QUIT;
+	}
+
+	const int port = vm["port"].as<int>();
+	if (port <= 0 || port > 65535)
+	{
+		std::cerr << "ERROR: The port " << port << " is not valid." << std::endl;
+		return ReturnStatus::CMD_FAILURE;
+	}
+
+	int workerCount = vm["workers"].as<int>();
+	if (workerCount <= 0)
+	{
+		workerCount = std::max<int>(1, int(std::thread::hardware_concurrency()));
+	}
+
+	m_parser->setQueryServer(vm["host"].as<std::string>(), port, workerCount);
+
+	if (vm.count("project-file"))
+	{
+		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
+	}
+
+	return ReturnStatus::CMD_OK;
+}
+
+}	 // namespace commandline
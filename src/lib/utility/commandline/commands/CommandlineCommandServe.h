@@ -0,0 +1,25 @@
+#ifndef COMMANDLINE_COMMAND_SERVE_H
+#define COMMANDLINE_COMMAND_SERVE_H
+
+#include "CommandlineCommand.h"
+
+namespace commandline
+{
+class CommandlineCommandServe: public CommandlineCommand
+{
+public:
+	CommandlineCommandServe(CommandLineParser* parser);
+	virtual ~CommandlineCommandServe();
+
+	virtual void setup();
+	virtual ReturnStatus parse(std::vector<std::string>& args);
+
+	virtual bool hasHelp() const
+	{
+		return true;
+	}
+};
+
+}	 // namespace commandline
+
+#endif	  // COMMANDLINE_COMMAND_SERVE_H
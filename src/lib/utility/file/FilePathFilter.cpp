@@ -1,7 +1,10 @@
 #include "FilePathFilter.h"
 
+#include "FilePathFilterMatcher.h"
+
 FilePathFilter::FilePathFilter(const std::wstring& filterString)
-	: m_filterString(filterString), m_filterRegex(convertFilterStringToRegex(filterString))
+	: m_filterString(filterString)
+	, m_matcher(std::make_shared<FilePathFilterMatcher>(std::vector<std::wstring> {filterString}))
 {
 }
 
@@ -12,89 +15,15 @@ std::wstring FilePathFilter::wstr() const
 
 bool FilePathFilter::isMatching(const FilePath& filePath) const
 {
-	const std::wstring s = filePath.wstr();
-	std::wsmatch match;
-	return std::regex_match(s, match, m_filterRegex);
+	return m_matcher->isMatching(filePath.wstr());
 }
 
-bool FilePathFilter::operator<(const FilePathFilter& other) const
+bool FilePathFilter::isMatchingAllPathsBelow(const FilePath& directoryPath) const
 {
-	return m_filterString.compare(other.m_filterString) < 0;
+	return m_matcher->isMatchingAllPathsBelow(directoryPath.wstr());
 }
 
-std::wregex FilePathFilter::convertFilterStringToRegex(const std::wstring& filterString)
+bool FilePathFilter::operator<(const FilePathFilter& other) const
 {
-	std::wstring regexFilterString = filterString;
-
-	{
-		std::wregex regex(L"[\\\\/]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\\\/]");
-	}
-
-	{
-		std::wregex regex(L"([^\\\\])([^/])([\\]])");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"$1$2[\\]]");
-	}
-
-	{
-		std::wregex regex(L"([\\[])([^\\\\])");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\[]$2");
-	}
-
-	{
-		std::wregex regex(L"[\\(]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\(]");
-	}
-
-	{
-		std::wregex regex(L"[\\)]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\)]");
-	}
-
-	{
-		std::wregex regex(L"[\\{]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\{]");
-	}
-
-	{
-		std::wregex regex(L"[\\}]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\}]");
-	}
-
-	{
-		std::wregex regex(L"[\\+]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\+]");
-	}
-
-	{
-		std::wregex regex(L"[\\-]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\-]");
-	}
-
-	{
-		std::wregex regex(L"[\\$]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\$]");
-	}
-
-	{
-		std::wregex regex(L"[\\.]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\.]");
-	}
-
-	{
-		std::wregex regex(L"[\\^]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[\\^]");
-	}
-
-	{
-		std::wregex regex(L"[\\*][\\*]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L".{0,}");
-	}
-
-	{
-		std::wregex regex(L"[\\*]");
-		regexFilterString = std::regex_replace(regexFilterString, regex, L"[^\\\\/]*");
-	}
-
-	return std::wregex(regexFilterString);
+	return m_filterString.compare(other.m_filterString) < 0;
 }
@@ -1,11 +1,13 @@
 #ifndef FILE_PATH_FILTER_H
 #define FILE_PATH_FILTER_H
 
-#include <regex>
+#include <memory>
 #include <string>
 
 #include "FilePath.h"
 
+class FilePathFilterMatcher;
+
 class FilePathFilter
 {
 public:
@@ -15,13 +17,15 @@ public:
 
 	bool isMatching(const FilePath& filePath) const;
 
+	// true if every path within the directory is matching, e.g. for the filters ending with "**"
+	// that are created for excluded directories
+	bool isMatchingAllPathsBelow(const FilePath& directoryPath) const;
+
 	bool operator<(const FilePathFilter& other) const;
 
 private:
-	static std::wregex convertFilterStringToRegex(const std::wstring& filterString);
-
 	std::wstring m_filterString;
-	std::wregex m_filterRegex;
+	std::shared_ptr<const FilePathFilterMatcher> m_matcher;	   // shared by copies
 };
 
 #endif	  // FILE_PATH_FILTER_H
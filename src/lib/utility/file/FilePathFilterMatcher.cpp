@@ -0,0 +1,221 @@
+#include "FilePathFilterMatcher.h"
+
+#include <algorithm>
+
+namespace
+{
+bool isSeparator(wchar_t c)
+{
+	return c == L'/' || c == L'\\';
+}
+}	 // namespace
+
+std::mutex FilePathFilterMatcher::s_sharedMutex;
+std::weak_ptr<const FilePathFilterMatcher> FilePathFilterMatcher::s_shared;
+
+std::shared_ptr<const FilePathFilterMatcher> FilePathFilterMatcher::getShared(
+	const std::vector<std::wstring>& filterStrings)
+{
+	std::lock_guard<std::mutex> lock(s_sharedMutex);
+
+	std::shared_ptr<const FilePathFilterMatcher> matcher = s_shared.lock();
+	if (!matcher || matcher->getFilterStrings() != filterStrings)
+	{
+		matcher = std::make_shared<FilePathFilterMatcher>(filterStrings);
+		s_shared = matcher;
+	}
+	return matcher;
+}
+
+FilePathFilterMatcher::FilePathFilterMatcher(const std::vector<std::wstring>& filterStrings)
+	: m_filterStrings(filterStrings), m_states(1)
+{
+	for (const std::wstring& filterString: filterStrings)
+	{
+		addFilter(filterString);
+	}
+
+	for (uint32_t i = 0; i < m_states.size(); i++)
+	{
+		m_states[i].acceptingAllSuffixes = m_states[i].loop == LOOP_ANY &&
+			isAcceptingWithoutInput(i);
+	}
+}
+
+const std::vector<std::wstring>& FilePathFilterMatcher::getFilterStrings() const
+{
+	return m_filterStrings;
+}
+
+bool FilePathFilterMatcher::isMatching(const std::wstring& path) const
+{
+	std::vector<uint32_t> states;
+	std::vector<char> added(m_states.size(), 0);
+	walk(path, states, added);
+
+	for (uint32_t index: states)
+	{
+		if (m_states[index].accepting || m_states[index].acceptingAllSuffixes)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FilePathFilterMatcher::isMatchingAllPathsBelow(const std::wstring& directoryPath) const
+{
+	std::vector<uint32_t> states;
+	std::vector<char> added(m_states.size(), 0);
+	walk(directoryPath + L"/", states, added);
+
+	for (uint32_t index: states)
+	{
+		if (m_states[index].acceptingAllSuffixes)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FilePathFilterMatcher::addFilter(const std::wstring& filterString)
+{
+	uint32_t index = 0;
+	for (size_t i = 0; i < filterString.size(); i++)
+	{
+		const wchar_t c = filterString[i];
+		if (c == L'*' && i + 1 < filterString.size() && filterString[i + 1] == L'*')
+		{
+			index = getOrAddTransition(index, &State::doubleStarTransition, LOOP_ANY);
+			i++;
+		}
+		else if (c == L'*')
+		{
+			index = getOrAddTransition(index, &State::starTransition, LOOP_NO_SEPARATOR);
+		}
+		else if (isSeparator(c))
+		{
+			index = getOrAddTransition(index, &State::separatorTransition, LOOP_NONE);
+		}
+		else
+		{
+			index = getOrAddCharTransition(index, c);
+		}
+	}
+	m_states[index].accepting = true;
+}
+
+uint32_t FilePathFilterMatcher::getOrAddCharTransition(uint32_t index, wchar_t c)
+{
+	std::vector<std::pair<wchar_t, uint32_t>>& transitions = m_states[index].charTransitions;
+	auto it = std::lower_bound(
+		transitions.begin(), transitions.end(), std::make_pair(c, uint32_t(0)));
+	if (it != transitions.end() && it->first == c)
+	{
+		return it->second;
+	}
+
+	const uint32_t target = uint32_t(m_states.size());
+	transitions.insert(it, std::make_pair(c, target));
+	m_states.emplace_back();
+	return target;
+}
+
+uint32_t FilePathFilterMatcher::getOrAddTransition(
+	uint32_t index, uint32_t State::*transition, LoopKind loop)
+{
+	if (!(m_states[index].*transition))
+	{
+		m_states[index].*transition = uint32_t(m_states.size());
+		m_states.emplace_back();
+		m_states.back().loop = loop;
+	}
+	return m_states[index].*transition;
+}
+
+bool FilePathFilterMatcher::isAcceptingWithoutInput(uint32_t index) const
+{
+	const State& state = m_states[index];
+	return state.accepting ||
+		(state.starTransition && isAcceptingWithoutInput(state.starTransition)) ||
+		(state.doubleStarTransition && isAcceptingWithoutInput(state.doubleStarTransition));
+}
+
+void FilePathFilterMatcher::addState(
+	uint32_t index, std::vector<uint32_t>& states, std::vector<char>& added) const
+{
+	if (added[index])
+	{
+		return;
+	}
+	added[index] = 1;
+	states.push_back(index);
+
+	// wildcards may match nothing
+	const State& state = m_states[index];
+	if (state.starTransition)
+	{
+		addState(state.starTransition, states, added);
+	}
+	if (state.doubleStarTransition)
+	{
+		addState(state.doubleStarTransition, states, added);
+	}
+}
+
+void FilePathFilterMatcher::walk(
+	const std::wstring& path, std::vector<uint32_t>& states, std::vector<char>& added) const
+{
+	addState(0, states, added);
+
+	std::vector<uint32_t> nextStates;
+	for (const wchar_t c: path)
+	{
+		for (uint32_t index: states)
+		{
+			if (m_states[index].acceptingAllSuffixes)
+			{
+				// nothing that follows can change the result
+				return;
+			}
+			added[index] = 0;
+		}
+
+		const bool separator = isSeparator(c);
+		for (uint32_t index: states)
+		{
+			const State& state = m_states[index];
+			if (state.loop == LOOP_ANY || (state.loop == LOOP_NO_SEPARATOR && !separator))
+			{
+				addState(index, nextStates, added);
+			}
+
+			if (separator)
+			{
+				if (state.separatorTransition)
+				{
+					addState(state.separatorTransition, nextStates, added);
+				}
+			}
+			else if (!state.charTransitions.empty())
+			{
+				auto it = std::lower_bound(
+					state.charTransitions.begin(),
+					state.charTransitions.end(),
+					std::make_pair(c, uint32_t(0)));
+				if (it != state.charTransitions.end() && it->first == c)
+				{
+					addState(it->second, nextStates, added);
+				}
+			}
+		}
+
+		states.swap(nextStates);
+		nextStates.clear();
+		if (states.empty())
+		{
+			return;
+		}
+	}
+}
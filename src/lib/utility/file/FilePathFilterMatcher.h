@@ -0,0 +1,68 @@
+#ifndef FILE_PATH_FILTER_MATCHER_H
+#define FILE_PATH_FILTER_MATCHER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Matches paths against the patterns of many FilePathFilters at once: "*" matches any characters
+// except for path separators, "**" matches any characters and "/" and "\" both match either
+// separator, all other characters match themselves. The patterns are compiled into one automaton
+// whose states are shared by patterns starting alike and each path is walked through it once.
+// The matcher is not changed after construction, so several threads can use it.
+class FilePathFilterMatcher
+{
+public:
+	// callers passing the same patterns as the previous caller share its matcher
+	static std::shared_ptr<const FilePathFilterMatcher> getShared(
+		const std::vector<std::wstring>& filterStrings);
+
+	explicit FilePathFilterMatcher(const std::vector<std::wstring>& filterStrings);
+
+	const std::vector<std::wstring>& getFilterStrings() const;
+
+	bool isMatching(const std::wstring& path) const;
+
+	// true if every path within the directory is matching one of the patterns
+	bool isMatchingAllPathsBelow(const std::wstring& directoryPath) const;
+
+private:
+	enum LoopKind : uint8_t
+	{
+		LOOP_NONE,
+		LOOP_NO_SEPARATOR,	  // reached by "*"
+		LOOP_ANY			  // reached by "**"
+	};
+
+	// transitions to state 0 mean there is none, the start state is never a target
+	struct State
+	{
+		std::vector<std::pair<wchar_t, uint32_t>> charTransitions;	  // sorted by character
+		uint32_t separatorTransition = 0;
+		uint32_t starTransition = 0;
+		uint32_t doubleStarTransition = 0;
+		LoopKind loop = LOOP_NONE;
+		bool accepting = false;
+		bool acceptingAllSuffixes = false;
+	};
+
+	static std::mutex s_sharedMutex;
+	static std::weak_ptr<const FilePathFilterMatcher> s_shared;
+
+	void addFilter(const std::wstring& filterString);
+	uint32_t getOrAddCharTransition(uint32_t index, wchar_t c);
+	uint32_t getOrAddTransition(uint32_t index, uint32_t State::*transition, LoopKind loop);
+	bool isAcceptingWithoutInput(uint32_t index) const;
+
+	void addState(uint32_t index, std::vector<uint32_t>& states, std::vector<char>& added) const;
+	void walk(
+		const std::wstring& path, std::vector<uint32_t>& states, std::vector<char>& added) const;
+
+	std::vector<std::wstring> m_filterStrings;
+	std::vector<State> m_states;
+};
+
+#endif	  // FILE_PATH_FILTER_MATCHER_H
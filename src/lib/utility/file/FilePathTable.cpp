@@ -0,0 +1,127 @@
+#include "FilePathTable.h"
+
+#include <boost/filesystem/path.hpp>
+
+#include "FilePath.h"
+
+FilePathTable* FilePathTable::getInstance()
+{
+	static FilePathTable s_instance;
+	return &s_instance;
+}
+
+FilePathTable::FilePathTable()
+{
+	m_entries.push_back({L"", 0, 0, 0});
+}
+
+FilePathTable::Id FilePathTable::getId(const FilePath& path)
+{
+	return getId(path.wstr());
+}
+
+FilePathTable::Id FilePathTable::findId(const FilePath& path) const
+{
+	const std::wstring str = path.wstr();
+	if (str.empty())
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_ids.find(str);
+}
+
+FilePath FilePathTable::getPath(Id id) const
+{
+	return FilePath(getString(id));
+}
+
+const std::wstring& FilePathTable::getString(Id id) const
+{
+	// elements of a deque keep their address when appending, so the reference outlives the lock
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_entries.size())
+	{
+		return m_entries.front().path;
+	}
+	return m_entries[id].path;
+}
+
+FilePathTable::Id FilePathTable::getParentId(Id id) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return id < m_entries.size() ? m_entries[id].parentId : 0;
+}
+
+std::wstring FilePathTable::getExtension(Id id) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (id >= m_entries.size())
+	{
+		return L"";
+	}
+
+	const Entry& entry = m_entries[id];
+	return entry.path.substr(entry.path.size() - entry.extensionSize);
+}
+
+FilePathTable::Id FilePathTable::getCanonicalId(Id id)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (id >= m_entries.size())
+		{
+			return 0;
+		}
+		if (!id || m_entries[id].canonicalId)
+		{
+			return m_entries[id].canonicalId;
+		}
+	}
+
+	// threads asking at the same time compute the same id
+	const Id canonicalId = getId(getPath(id).getCanonical());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries[id].canonicalId = canonicalId;
+	return canonicalId;
+}
+
+size_t FilePathTable::getPathCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.size() - 1;
+}
+
+FilePathTable::Id FilePathTable::getId(const std::wstring& path)
+{
+	if (path.empty())
+	{
+		return 0;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const Id id = m_ids.find(path);
+		if (id)
+		{
+			return id;
+		}
+	}
+
+	// the parents are added without holding the lock, most of them are known already
+	const boost::filesystem::path p(path);
+	const Id parentId = getId(p.parent_path().generic_wstring());
+	const uint32_t extensionSize = uint32_t(p.extension().generic_wstring().size());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Id id = m_ids.find(path);
+	if (!id)
+	{
+		id = Id(m_entries.size());
+		m_entries.push_back({path, parentId, extensionSize, 0});
+		m_ids.add(path, id);
+	}
+	return id;
+}
@@ -0,0 +1,60 @@
+#ifndef FILE_PATH_TABLE_H
+#define FILE_PATH_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "LowMemoryStringMap.h"
+
+class FilePath;
+
+// Process wide table that gives each added path a 32-bit id, so sets of paths can be kept as sets
+// of integers. Equal paths get the same id, the parent of each path is added with it and its
+// canonical form is computed once on request. Ids stay valid for the lifetime of the process, the
+// empty path always has the id 0.
+class FilePathTable
+{
+public:
+	typedef uint32_t Id;
+
+	static FilePathTable* getInstance();
+
+	FilePathTable();
+
+	Id getId(const FilePath& path);
+
+	// returns 0 if the path was not added before
+	Id findId(const FilePath& path) const;
+
+	FilePath getPath(Id id) const;
+
+	// the returned reference stays valid, unknown ids return the empty string
+	const std::wstring& getString(Id id) const;
+
+	Id getParentId(Id id) const;
+	std::wstring getExtension(Id id) const;
+
+	// id of the canonical path, which only touches the file system the first time
+	Id getCanonicalId(Id id);
+
+	size_t getPathCount() const;
+
+private:
+	struct Entry
+	{
+		std::wstring path;
+		Id parentId;
+		uint32_t extensionSize;
+		Id canonicalId;	   // 0 until it is requested
+	};
+
+	Id getId(const std::wstring& path);
+
+	LowMemoryStringMap<std::wstring, Id, 0> m_ids;
+	std::deque<Entry> m_entries;	// the empty path is in front
+	mutable std::mutex m_mutex;
+};
+
+#endif	  // FILE_PATH_TABLE_H
@@ -2,6 +2,23 @@
 
 #include "FilePath.h"
 #include "FilePathFilter.h"
+#include "FilePathFilterMatcher.h"
+#include "MetricsRegistry.h"
+
+namespace
+{
+std::vector<std::wstring> getFilterStrings(const std::set<FilePathFilter>& filters)
+{
+	std::vector<std::wstring> filterStrings;
+	for (const FilePathFilter& filter: filters)
+	{
+		filterStrings.push_back(filter.wstr());
+	}
+	return filterStrings;
+}
+}	 // namespace
+
+const size_t FileRegister::s_maxCachedFilePathCount = 100000;
 
 FileRegister::FileRegister(
 	const FilePath& currentPath,
@@ -9,7 +26,7 @@ FileRegister::FileRegister(
 	const std::set<FilePathFilter>& excludeFilters)
 	: m_currentPath(currentPath)
 	, m_indexedPaths(indexedPaths)
-	, m_excludeFilters(excludeFilters)
+	, m_excludeFilterMatcher(FilePathFilterMatcher::getShared(getFilterStrings(excludeFilters)))
 	, m_hasFilePathCache([&](const std::wstring& f) {
 		const FilePath filePath(f);
 		bool ret = false;
@@ -42,25 +59,39 @@ FileRegister::FileRegister(
 			}
 		}
 
-		if (ret)
+		if (ret && m_excludeFilterMatcher->isMatching(filePath.wstr()))
 		{
-			for (const FilePathFilter& excludeFilter: m_excludeFilters)
-			{
-				if (excludeFilter.isMatching(filePath))
-				{
-					ret = false;
-					break;
-				}
-			}
+			ret = false;
 		}
 		return ret;
-	})
+	}, s_maxCachedFilePathCount)
 {
 }
 
-FileRegister::~FileRegister() {}
+FileRegister::~FileRegister()
+{
+	static MetricCounter& hitCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_file_register_cache_hits_total",
+		"Project file checks answered from the cache of a file register");
+	static MetricCounter& missCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_file_register_cache_misses_total",
+		"Project file checks not answered from the cache of a file register");
+	hitCounter.add(m_hasFilePathCache.getHitCount());
+	missCounter.add(m_hasFilePathCache.getMissCount());
+}
 
 bool FileRegister::hasFilePath(const FilePath& filePath) const
 {
 	return m_hasFilePathCache.getValue(filePath.wstr());
 }
+
+void FileRegister::setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths)
+{
+	m_alreadyIndexedFilePaths = filePaths;
+	m_alreadyIndexedFilePaths.erase(m_currentPath);
+}
+
+bool FileRegister::isAlreadyIndexed(const FilePath& filePath) const
+{
+	return m_alreadyIndexedFilePaths.find(filePath) != m_alreadyIndexedFilePaths.end();
+}
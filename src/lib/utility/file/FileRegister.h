@@ -1,12 +1,14 @@
 #ifndef FILE_REGISTER_H
 #define FILE_REGISTER_H
 
+#include <memory>
 #include <set>
 
 #include "FilePath.h"
-#include "UnorderedCache.h"
+#include "SharedCache.h"
 
 class FilePathFilter;
+class FilePathFilterMatcher;
 
 class FileRegister
 {
@@ -19,11 +21,19 @@ public:
 
 	virtual bool hasFilePath(const FilePath& filePath) const;
 
+	// files of the project that were indexed by a previous translation unit
+	void setAlreadyIndexedFilePaths(const std::set<FilePath>& filePaths);
+	bool isAlreadyIndexed(const FilePath& filePath) const;
+
 private:
+	static const size_t s_maxCachedFilePathCount;
+
 	const FilePath& m_currentPath;
 	const std::set<FilePath> m_indexedPaths;
-	const std::set<FilePathFilter> m_excludeFilters;
-	mutable UnorderedCache<std::wstring, bool> m_hasFilePathCache;
+	std::shared_ptr<const FilePathFilterMatcher> m_excludeFilterMatcher;
+	// shared by the threads that index the translation unit
+	const SharedCache<std::wstring, bool> m_hasFilePathCache;
+	std::set<FilePath> m_alreadyIndexedFilePaths;
 };
 
 #endif	  // FILE_REGISTER_H
@@ -1,42 +1,389 @@
 #include "FileSystem.h"
 
+#include <algorithm>
+#include <ctime>
 #include <set>
 
 #include <boost/date_time.hpp>
 #include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/filesystem.hpp>
 
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include <dirent.h>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#endif
+
+#include "FilePathFilterMatcher.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
 #include "utilityString.h"
 
-std::vector<FilePath> FileSystem::getFilePathsFromDirectory(
-	const FilePath& path, const std::vector<std::wstring>& extensions)
+namespace
 {
-	std::set<std::wstring> ext(extensions.begin(), extensions.end());
-	std::vector<FilePath> files;
+enum class EntryType
+{
+	FILE,
+	DIRECTORY,
+	SYMLINK,
+	OTHER
+};
 
-	if (path.isDirectory())
+struct DirectoryEntry
+{
+	boost::filesystem::path name;
+	EntryType type;
+	std::time_t lastWriteTime;	  // 0 if it was not read
+};
+
+enum class SymLinkMode
+{
+	SKIPPED,
+	FOLLOWED,	 // files reached more than once are only listed once
+	FILES_LISTED	// symlinked files are listed with their own path, directories are skipped
+};
+
+struct CrawlOptions
+{
+	std::set<std::wstring> extensions;
+	bool caseSensitiveExtensions = true;
+	SymLinkMode symLinkMode = SymLinkMode::SKIPPED;
+	bool readLastWriteTimes = false;
+	std::shared_ptr<const FilePathFilterMatcher> excludeFilterMatcher;
+};
+
+struct CrawledDirectory
+{
+	boost::filesystem::path path;	 // as reached from the crawled path
+	boost::filesystem::path canonicalPath;
+};
+
+struct CrawledFile
+{
+	FileInfo info;
+	boost::filesystem::path canonicalPath;
+};
+
+struct CrawlResult
+{
+	std::vector<CrawledDirectory> directories;
+	std::vector<CrawledFile> files;
+};
+
+TimeStamp toLocalTimeStamp(std::time_t t)
+{
+	boost::posix_time::ptime lastWriteTime = boost::posix_time::from_time_t(t);
+	return TimeStamp(
+		boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(lastWriteTime));
+}
+
+bool hasExtension(const boost::filesystem::path& name, const CrawlOptions& options)
+{
+	if (options.extensions.empty())
+	{
+		return true;
+	}
+
+	const std::wstring extension = name.extension().wstring();
+	return options.extensions.find(
+			   options.caseSensitiveExtensions ? extension : utility::toLowerCase(extension)) !=
+		options.extensions.end();
+}
+
+bool isExcluded(const FilePath& path, const CrawlOptions& options)
+{
+	return options.excludeFilterMatcher && options.excludeFilterMatcher->isMatching(path.wstr());
+}
+
+bool isExcludedDirectory(const FilePath& path, const CrawlOptions& options)
+{
+	return options.excludeFilterMatcher &&
+		options.excludeFilterMatcher->isMatchingAllPathsBelow(path.wstr());
+}
+
+// Reads the names of a directory together with the types the file system keeps in the directory
+// itself, so no file needs to be opened for them. Windows keeps the last write times there as
+// well, elsewhere they are read relative to the open directory for the files that need them.
+bool readDirectory(
+	const boost::filesystem::path& path,
+	const CrawlOptions& options,
+	std::vector<DirectoryEntry>& entries)
+{
+#ifdef _WIN32
+	WIN32_FIND_DATAW data;
+	HANDLE handle = FindFirstFileExW(
+		(path / L"*").wstring().c_str(),
+		FindExInfoBasic,
+		&data,
+		FindExSearchNameMatch,
+		nullptr,
+		FIND_FIRST_EX_LARGE_FETCH);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	do
+	{
+		const std::wstring name = data.cFileName;
+		if (name == L"." || name == L"..")
+		{
+			continue;
+		}
+
+		DirectoryEntry entry;
+		entry.name = name;
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+		{
+			entry.type = EntryType::SYMLINK;
+		}
+		else if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			entry.type = EntryType::DIRECTORY;
+		}
+		else
+		{
+			entry.type = EntryType::FILE;
+		}
+
+		// file times count 100ns intervals since 1601
+		ULARGE_INTEGER fileTime;
+		fileTime.LowPart = data.ftLastWriteTime.dwLowDateTime;
+		fileTime.HighPart = data.ftLastWriteTime.dwHighDateTime;
+		entry.lastWriteTime = std::time_t((fileTime.QuadPart - 116444736000000000ULL) / 10000000ULL);
+
+		entries.push_back(entry);
+	} while (FindNextFileW(handle, &data));
+
+	FindClose(handle);
+	return true;
+#else
+	DIR* dir = opendir(path.c_str());
+	if (!dir)
 	{
-		boost::filesystem::recursive_directory_iterator it(path.getPath());
-		boost::filesystem::recursive_directory_iterator endit;
-		while (it != endit)
+		return false;
+	}
+
+	while (const dirent* d = readdir(dir))
+	{
+		const std::string name = d->d_name;
+		if (name == "." || name == "..")
+		{
+			continue;
+		}
+
+		unsigned char type = d->d_type;
+		struct stat st;
+		bool hasStat = false;
+		if (type == DT_UNKNOWN)
+		{
+			// some file systems don't keep the types in the directory
+			hasStat = fstatat(dirfd(dir), name.c_str(), &st, AT_SYMLINK_NOFOLLOW) == 0;
+			if (!hasStat)
+			{
+				continue;
+			}
+			type = S_ISLNK(st.st_mode) ? DT_LNK
+									   : (S_ISDIR(st.st_mode) ? DT_DIR
+															  : (S_ISREG(st.st_mode) ? DT_REG : 0));
+		}
+
+		DirectoryEntry entry;
+		entry.name = name;
+		entry.type = type == DT_REG
+			? EntryType::FILE
+			: (type == DT_DIR ? EntryType::DIRECTORY
+							  : (type == DT_LNK ? EntryType::SYMLINK : EntryType::OTHER));
+		entry.lastWriteTime = 0;
+
+		if (entry.type == EntryType::FILE && options.readLastWriteTimes &&
+			hasExtension(entry.name, options))
+		{
+			if (!hasStat)
+			{
+				hasStat = fstatat(dirfd(dir), name.c_str(), &st, AT_SYMLINK_NOFOLLOW) == 0;
+			}
+			if (hasStat)
+			{
+				entry.lastWriteTime = st.st_mtime;
+			}
+		}
+
+		entries.push_back(entry);
+	}
+
+	closedir(dir);
+	return true;
+#endif
+}
+
+void crawlDirectory(
+	const CrawledDirectory& directory, const CrawlOptions& options, CrawlResult& result)
+{
+	std::vector<DirectoryEntry> entries;
+	if (!readDirectory(directory.path, options, entries))
+	{
+		return;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const DirectoryEntry& a, const DirectoryEntry& b) {
+		return a.name < b.name;
+	});
+
+	for (const DirectoryEntry& entry: entries)
+	{
+		const boost::filesystem::path path = directory.path / entry.name;
+		boost::filesystem::path canonicalPath = directory.canonicalPath / entry.name;
+		EntryType type = entry.type;
+		std::time_t lastWriteTime = entry.lastWriteTime;
+
+		if (type == EntryType::SYMLINK)
 		{
-			if (boost::filesystem::is_symlink(*it))
+			if (options.symLinkMode == SymLinkMode::SKIPPED)
+			{
+				continue;
+			}
+
+			// fails for broken and self-referencing symlinks
+			boost::system::error_code ec;
+			const boost::filesystem::file_status status = boost::filesystem::status(path, ec);
+			if (ec)
 			{
-				// check for self-referencing symlinks
-				boost::filesystem::path p = boost::filesystem::read_symlink(*it);
-				if (p.filename() == p.string() && p.filename() == it->path().filename())
+				continue;
+			}
+
+			if (boost::filesystem::is_directory(status))
+			{
+				if (options.symLinkMode == SymLinkMode::FILES_LISTED)
 				{
-					++it;
 					continue;
 				}
+				type = EntryType::DIRECTORY;
+			}
+			else if (boost::filesystem::is_regular_file(status))
+			{
+				type = EntryType::FILE;
+			}
+			else
+			{
+				continue;
 			}
 
-			if (boost::filesystem::is_regular_file(*it) &&
-				(ext.empty() || ext.find(it->path().extension().wstring()) != ext.end()))
+			if (options.symLinkMode == SymLinkMode::FOLLOWED)
 			{
-				files.push_back(FilePath(it->path().generic_wstring()));
+				canonicalPath = boost::filesystem::canonical(path, ec);
+				if (ec)
+				{
+					continue;
+				}
 			}
-			++it;
+			lastWriteTime = 0;
+		}
+
+		if (type == EntryType::DIRECTORY)
+		{
+			if (!isExcludedDirectory(FilePath(path.wstring()), options))
+			{
+				result.directories.push_back({path, canonicalPath});
+			}
+		}
+		else if (type == EntryType::FILE && hasExtension(entry.name, options))
+		{
+			FilePath filePath(path.wstring());
+			if (isExcluded(filePath, options))
+			{
+				continue;
+			}
+
+			FileInfo info(filePath);
+			if (options.readLastWriteTimes)
+			{
+				info.lastWriteTime = lastWriteTime ? toLocalTimeStamp(lastWriteTime)
+												   : FileSystem::getLastWriteTime(filePath);
+			}
+			result.files.push_back({info, canonicalPath});
+		}
+	}
+}
+
+// Crawls the directory level by level and reads the directories of a level in parallel. Each
+// directory and file is listed once, even if symlinks lead to it more than once.
+std::vector<FileInfo> crawlDirectories(
+	const std::vector<boost::filesystem::path>& paths,
+	const CrawlOptions& options,
+	std::set<boost::filesystem::path>& crawledFilePaths)
+{
+	std::set<boost::filesystem::path> crawledDirectoryPaths;
+	std::vector<CrawledDirectory> directories;
+	for (const boost::filesystem::path& path: paths)
+	{
+		boost::system::error_code ec;
+		const boost::filesystem::path canonicalPath = boost::filesystem::canonical(path, ec);
+		if (!ec && !isExcludedDirectory(FilePath(path.wstring()), options) &&
+			crawledDirectoryPaths.insert(canonicalPath).second)
+		{
+			directories.push_back({path, canonicalPath});
+		}
+	}
+
+	std::vector<FileInfo> files;
+	while (!directories.empty())
+	{
+		std::vector<CrawlResult> results(directories.size());
+		if (directories.size() == 1)
+		{
+			crawlDirectory(directories.front(), options, results.front());
+		}
+		else
+		{
+			TaskManager::getThreadPool()->parallelFor(
+				directories.size(),
+				[&](size_t i) { crawlDirectory(directories[i], options, results[i]); },
+				ThreadPool::PRIORITY_INDEXING);
+		}
+
+		std::vector<CrawledDirectory> nextDirectories;
+		for (CrawlResult& result: results)
+		{
+			for (CrawledFile& file: result.files)
+			{
+				if (crawledFilePaths.insert(file.canonicalPath).second)
+				{
+					files.push_back(std::move(file.info));
+				}
+			}
+
+			for (CrawledDirectory& directory: result.directories)
+			{
+				if (crawledDirectoryPaths.insert(directory.canonicalPath).second)
+				{
+					nextDirectories.push_back(std::move(directory));
+				}
+			}
+		}
+		directories.swap(nextDirectories);
+	}
+	return files;
+}
+}	 // namespace
+
+std::vector<FilePath> FileSystem::getFilePathsFromDirectory(
+	const FilePath& path, const std::vector<std::wstring>& extensions)
+{
+	std::vector<FilePath> files;
+
+	if (path.isDirectory())
+	{
+		CrawlOptions options;
+		options.extensions.insert(extensions.begin(), extensions.end());
+		options.symLinkMode = SymLinkMode::FILES_LISTED;
+
+		std::set<boost::filesystem::path> crawledFilePaths;
+		for (FileInfo& fileInfo: crawlDirectories({path.getPath()}, options, crawledFilePaths))
+		{
+			files.push_back(FilePath(fileInfo.path.wstr()));
 		}
 	}
 	return files;
@@ -54,83 +401,50 @@ FileInfo FileSystem::getFileInfoForPath(const FilePath& filePath)
 std::vector<FileInfo> FileSystem::getFileInfosFromPaths(
 	const std::vector<FilePath>& paths,
 	const std::vector<std::wstring>& fileExtensions,
-	bool followSymLinks)
+	bool followSymLinks,
+	const std::vector<FilePathFilter>& excludeFilters)
 {
-	std::set<std::wstring> ext;
+	CrawlOptions options;
 	for (const std::wstring& e: fileExtensions)
 	{
-		ext.insert(utility::toLowerCase(e));
+		options.extensions.insert(utility::toLowerCase(e));
+	}
+	options.caseSensitiveExtensions = false;
+	options.symLinkMode = followSymLinks ? SymLinkMode::FOLLOWED : SymLinkMode::SKIPPED;
+	options.readLastWriteTimes = true;
+	if (!excludeFilters.empty())
+	{
+		std::vector<std::wstring> filterStrings;
+		for (const FilePathFilter& filter: excludeFilters)
+		{
+			filterStrings.push_back(filter.wstr());
+		}
+		options.excludeFilterMatcher = std::make_shared<FilePathFilterMatcher>(filterStrings);
 	}
 
-	std::set<boost::filesystem::path> symlinkDirs;
 	std::set<boost::filesystem::path> filePaths;
-
 	std::vector<FileInfo> files;
 
 	for (const FilePath& path: paths)
 	{
 		if (path.isDirectory())
 		{
-			boost::filesystem::recursive_directory_iterator it(
-				path.getPath(), boost::filesystem::symlink_option::recurse);
-			boost::filesystem::recursive_directory_iterator endit;
-			boost::system::error_code ec;
-			for (; it != endit; it.increment(ec))
+			for (FileInfo& fileInfo: crawlDirectories({path.getPath()}, options, filePaths))
 			{
-				if (boost::filesystem::is_symlink(*it))
-				{
-					if (!followSymLinks)
-					{
-						it.no_push();
-						continue;
-					}
-
-					// check for self-referencing symlinks
-					boost::filesystem::path p = boost::filesystem::read_symlink(*it);
-					if (p.filename() == p.string() && p.filename() == it->path().filename())
-					{
-						continue;
-					}
-
-					// check for duplicates when following directory symlinks
-					if (boost::filesystem::is_directory(*it))
-					{
-						boost::filesystem::path absDir = boost::filesystem::canonical(
-							p, it->path().parent_path());
-
-						if (symlinkDirs.find(absDir) != symlinkDirs.end())
-						{
-							it.no_push();
-							continue;
-						}
-
-						symlinkDirs.insert(absDir);
-					}
-				}
-
-				if (boost::filesystem::is_regular_file(*it) &&
-					(ext.empty() ||
-					 ext.find(utility::toLowerCase(it->path().extension().wstring())) != ext.end()))
-				{
-					boost::filesystem::path p = boost::filesystem::canonical(it->path());
-					if (filePaths.find(p) != filePaths.end())
-					{
-						continue;
-					}
-					filePaths.insert(p);
-					files.push_back(getFileInfoForPath(FilePath(it->path().wstring())));
-				}
+				files.push_back(std::move(fileInfo));
 			}
 		}
-		else if (path.exists() && (ext.empty() || ext.find(utility::toLowerCase(path.extension())) != ext.end()))
+		else if (
+			path.exists() && (options.extensions.empty() ||
+							  options.extensions.find(utility::toLowerCase(path.extension())) !=
+								  options.extensions.end()))
 		{
 			const FilePath canonicalPath = path.getCanonical();
-			boost::filesystem::path p = canonicalPath.getPath();
-			if (filePaths.find(p) != filePaths.end())
+			if (isExcluded(canonicalPath, options) ||
+				!filePaths.insert(canonicalPath.getPath()).second)
 			{
 				continue;
 			}
-			filePaths.insert(p);
 			files.push_back(getFileInfoForPath(canonicalPath));
 		}
 	}
@@ -200,15 +514,11 @@ unsigned long long FileSystem::getFileByteSize(const FilePath& filePath)
 
 TimeStamp FileSystem::getLastWriteTime(const FilePath& filePath)
 {
-	boost::posix_time::ptime lastWriteTime;
 	if (filePath.exists())
 	{
-		std::time_t t = boost::filesystem::last_write_time(filePath.getPath());
-		lastWriteTime = boost::posix_time::from_time_t(t);
-		lastWriteTime = boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(
-			lastWriteTime);
+		return toLocalTimeStamp(boost::filesystem::last_write_time(filePath.getPath()));
 	}
-	return TimeStamp(lastWriteTime);
+	return TimeStamp(boost::posix_time::ptime());
 }
 
 bool FileSystem::remove(const FilePath& path)
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "FileInfo.h"
+#include "FilePathFilter.h"
 #include "TimeStamp.h"
 
 class FileSystem
@@ -16,10 +17,13 @@ public:
 
 	static FileInfo getFileInfoForPath(const FilePath& filePath);
 
+	// directories are crawled in parallel, files matching one of the exclude filters are left out
+	// and directories that are excluded with all of their content are not read
 	static std::vector<FileInfo> getFileInfosFromPaths(
 		const std::vector<FilePath>& paths,
 		const std::vector<std::wstring>& fileExtensions,
-		bool followSymLinks = true);
+		bool followSymLinks = true,
+		const std::vector<FilePathFilter>& excludeFilters = {});
 
 	static std::set<FilePath> getSymLinkedDirectories(const FilePath& path);
 	static std::set<FilePath> getSymLinkedDirectories(const std::vector<FilePath>& paths);
@@ -51,6 +51,70 @@ std::vector<FilePath> utility::partitionFilePathsBySize(std::vector<FilePath> fi
 	return sortedFilePaths;
 }
 
+std::vector<FilePath> utility::orderFilePathsByPredictedCost(
+	const std::vector<FilePath>& filePaths, const std::map<std::wstring, size_t>& previousCostsMs)
+{
+	struct Cost
+	{
+		FilePath path;
+		unsigned long long int byteSize;
+		double costMs;
+		bool known;
+	};
+
+	std::vector<Cost> costs;
+	costs.reserve(filePaths.size());
+
+	double knownCostMs = 0.0;
+	double knownByteSize = 0.0;
+	for (const FilePath& path: filePaths)
+	{
+		Cost cost = {path, path.exists() ? FileSystem::getFileByteSize(path) : 1, 0.0, false};
+
+		auto it = previousCostsMs.find(path.wstr());
+		if (it != previousCostsMs.end())
+		{
+			cost.costMs = double(it->second);
+			cost.known = true;
+
+			knownCostMs += cost.costMs;
+			knownByteSize += double(cost.byteSize);
+		}
+
+		costs.push_back(cost);
+	}
+
+	if (knownByteSize == 0.0)
+	{
+		return partitionFilePathsBySize(filePaths, 2);
+	}
+
+	const double msPerByte = knownCostMs / knownByteSize;
+	for (Cost& cost: costs)
+	{
+		if (!cost.known)
+		{
+			cost.costMs = double(cost.byteSize) * msPerByte;
+		}
+	}
+
+	std::sort(costs.begin(), costs.end(), [](const Cost& a, const Cost& b) {
+		if (a.costMs != b.costMs)
+		{
+			return a.costMs > b.costMs;
+		}
+		return a.path.wstr() < b.path.wstr();
+	});
+
+	std::vector<FilePath> sortedFilePaths;
+	sortedFilePaths.reserve(costs.size());
+	for (const Cost& cost: costs)
+	{
+		sortedFilePaths.push_back(cost.path);
+	}
+	return sortedFilePaths;
+}
+
 std::vector<FilePath> utility::getTopLevelPaths(const std::vector<FilePath>& paths)
 {
 	return utility::getTopLevelPaths(utility::toSet(paths));
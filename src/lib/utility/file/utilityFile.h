@@ -1,7 +1,9 @@
 #ifndef UTILITY_FILE_H
 #define UTILITY_FILE_H
 
+#include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 class FilePath;
@@ -10,6 +12,11 @@ namespace utility
 {
 std::vector<FilePath> partitionFilePathsBySize(std::vector<FilePath> filePaths, int partitionCount = 0);
 
+// Orders by the time it took to index each file last time, longest first. Files without previous
+// time are estimated from their size using the average time per byte of the known files.
+std::vector<FilePath> orderFilePathsByPredictedCost(
+	const std::vector<FilePath>& filePaths, const std::map<std::wstring, size_t>& previousCostsMs);
+
 std::vector<FilePath> getTopLevelPaths(const std::vector<FilePath>& paths);
 std::vector<FilePath> getTopLevelPaths(const std::set<FilePath>& paths);
 
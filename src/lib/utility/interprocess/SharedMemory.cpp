@@ -1,13 +1,17 @@
 #include "SharedMemory.h"
 
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
 #include "SharedMemoryGarbageCollector.h"
 #include "logging.h"
 
 const char* SharedMemory::s_memoryNamePrefix = "srctrlmem_";
 const char* SharedMemory::s_mutexNamePrefix = "srctrlmtx_";
+const char* SharedMemory::s_conditionNamePrefix = "srctrlcnd_";
 
 SharedMemory::ScopedAccess::ScopedAccess(SharedMemory* memory)
 	: boost::interprocess::scoped_lock<boost::interprocess::named_mutex>(memory->getMutex())
+	, m_condition(memory->getCondition())
 	, m_memory(boost::interprocess::open_only, memory->getMemoryName().c_str())
 	, m_memoryName(memory->getMemoryName())
 	, m_minimumMemorySize(memory->getInitialMemorySize())
@@ -36,14 +40,17 @@ size_t SharedMemory::ScopedAccess::getUsedMemorySize() const
 	return getMemorySize() - getFreeMemorySize();
 }
 
-void SharedMemory::ScopedAccess::growMemory(size_t size)
+bool SharedMemory::ScopedAccess::growMemory(size_t size)
 {
 	m_memory = boost::interprocess::managed_shared_memory();
 
-	boost::interprocess::managed_shared_memory::grow(m_memoryName.c_str(), size);
+	const bool grown = boost::interprocess::managed_shared_memory::grow(
+		m_memoryName.c_str(), size);
 
 	m_memory = boost::interprocess::managed_shared_memory(
 		boost::interprocess::open_only, m_memoryName.c_str());
+
+	return grown;
 }
 
 void SharedMemory::ScopedAccess::shrinkToFitMemory()
@@ -61,6 +68,25 @@ void SharedMemory::ScopedAccess::shrinkToFitMemory()
 		boost::interprocess::open_only, m_memoryName.c_str());
 }
 
+void SharedMemory::ScopedAccess::notifyChange()
+{
+	m_condition.notify_all();
+}
+
+void SharedMemory::ScopedAccess::waitForChange(size_t timeoutMS)
+{
+	m_memory = boost::interprocess::managed_shared_memory();
+
+	m_condition.timed_wait(
+		*this,
+		boost::posix_time::microsec_clock::universal_time() +
+			boost::posix_time::milliseconds(timeoutMS));
+
+	// the memory may have grown in the meantime
+	m_memory = boost::interprocess::managed_shared_memory(
+		boost::interprocess::open_only, m_memoryName.c_str());
+}
+
 std::string SharedMemory::ScopedAccess::logString() const
 {
 	std::string log = m_memoryName + " -";
@@ -99,6 +125,7 @@ void SharedMemory::deleteSharedMemory(const std::string& name)
 {
 	boost::interprocess::shared_memory_object::remove((s_memoryNamePrefix + name).c_str());
 	boost::interprocess::named_mutex::remove((s_mutexNamePrefix + name).c_str());
+	boost::interprocess::named_condition::remove((s_conditionNamePrefix + name).c_str());
 }
 
 SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, AccessMode mode)
@@ -131,6 +158,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 				permissions);
 			boost::interprocess::named_mutex(
 				boost::interprocess::create_only, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::create_only, getConditionName().c_str());
 		}
 		break;
 
@@ -138,6 +167,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 			boost::interprocess::managed_shared_memory(
 				boost::interprocess::open_only, getMemoryName().c_str());
 			boost::interprocess::named_mutex(boost::interprocess::open_only, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::open_only, getConditionName().c_str());
 			unlockMutex = false;
 			break;
 
@@ -154,6 +185,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 				permissions);
 			boost::interprocess::named_mutex(
 				boost::interprocess::open_or_create, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::open_or_create, getConditionName().c_str());
 		}
 		break;
 		}
@@ -243,6 +276,11 @@ std::string SharedMemory::getMutexName() const
 	return s_mutexNamePrefix + m_name;
 }
 
+std::string SharedMemory::getConditionName() const
+{
+	return s_conditionNamePrefix + m_name;
+}
+
 boost::interprocess::named_mutex& SharedMemory::getMutex()
 {
 	if (!m_mutex)
@@ -254,6 +292,17 @@ boost::interprocess::named_mutex& SharedMemory::getMutex()
 	return *m_mutex.get();
 }
 
+boost::interprocess::named_condition& SharedMemory::getCondition()
+{
+	if (!m_condition)
+	{
+		m_condition = std::make_shared<boost::interprocess::named_condition>(
+			boost::interprocess::open_only, getConditionName().c_str());
+	}
+
+	return *m_condition.get();
+}
+
 size_t SharedMemory::getInitialMemorySize() const
 {
 	return m_initialMemorySize;
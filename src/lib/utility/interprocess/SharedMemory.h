@@ -9,6 +9,7 @@
 #include <boost/interprocess/containers/string.hpp>
 #include <boost/interprocess/containers/vector.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/named_condition.hpp>
 #include <boost/interprocess/sync/named_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
@@ -61,9 +62,15 @@ public:
 		size_t getFreeMemorySize() const;
 		size_t getUsedMemorySize() const;
 
-		void growMemory(size_t size);
+		// returns false if the segment could not be grown, it stays mapped with its old size then
+		bool growMemory(size_t size);
 		void shrinkToFitMemory();
 
+		// wakes the accesses of all processes that wait for a change of the memory
+		void notifyChange();
+		// releases the memory while waiting, values accessed before have to be accessed again
+		void waitForChange(size_t timeoutMS);
+
 		template <typename T>
 		T* accessValue(const std::string& key)
 		{
@@ -97,6 +104,7 @@ public:
 		std::string logString() const;
 
 	private:
+		boost::interprocess::named_condition& m_condition;
 		boost::interprocess::managed_shared_memory m_memory;
 		std::string m_memoryName;
 		size_t m_minimumMemorySize;
@@ -107,15 +115,19 @@ public:
 private:
 	static const char* s_memoryNamePrefix;
 	static const char* s_mutexNamePrefix;
+	static const char* s_conditionNamePrefix;
 
 	std::string getMemoryName() const;
 	std::string getMutexName() const;
+	std::string getConditionName() const;
 
 	boost::interprocess::named_mutex& getMutex();
+	boost::interprocess::named_condition& getCondition();
 
 	size_t getInitialMemorySize() const;
 
 	std::shared_ptr<boost::interprocess::named_mutex> m_mutex;
+	std::shared_ptr<boost::interprocess::named_condition> m_condition;
 	std::string m_name;
 	AccessMode m_mode;
 
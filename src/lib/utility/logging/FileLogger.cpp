@@ -1,5 +1,6 @@
 #include "FileLogger.h"
 
+#include <chrono>
 #include <cstdio>
 #include <ctime>
 #include <fstream>
@@ -50,34 +51,53 @@ FileLogger::FileLogger()
 	, m_maxLogFileCount(0)
 	, m_currentLogLineCount(0)
 	, m_currentLogFileCount(0)
+	, m_maxLogFileByteSize(0)
+	, m_currentLogFileByteSize(0)
+	, m_writerStopped(false)
 {
 	updateLogFileName();
+	m_writerThread = std::thread(&FileLogger::runWriter, this);
+}
+
+FileLogger::~FileLogger()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_writerMutex);
+		m_writerStopped = true;
+	}
+	m_writerCondition.notify_one();
+	m_writerThread.join();
 }
 
 FilePath FileLogger::getLogFilePath() const
 {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 	return m_currentLogFilePath;
 }
 
 void FileLogger::setLogFilePath(const FilePath& filePath)
 {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 	m_currentLogFilePath = filePath;
 	m_logFileName = L"";
 }
 
 void FileLogger::setLogDirectory(const FilePath& filePath)
 {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 	m_logDirectory = filePath;
 	FileSystem::createDirectory(m_logDirectory);
 }
 
 void FileLogger::setFileName(const std::wstring& fileName)
 {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 	if (fileName != m_logFileName)
 	{
 		m_logFileName = fileName;
 		m_currentLogLineCount = 0;
 		m_currentLogFileCount = 0;
+		m_currentLogFileByteSize = 0;
 		updateLogFileName();
 	}
 }
@@ -99,17 +119,31 @@ void FileLogger::logError(const LogMessage& message)
 
 void FileLogger::setMaxLogLineCount(unsigned int lineCount)
 {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 	m_maxLogLineCount = lineCount;
 }
 
+void FileLogger::setMaxLogFileByteSize(size_t byteSize)
+{
+	std::lock_guard<std::mutex> lock(m_fileMutex);
+	m_maxLogFileByteSize = byteSize;
+}
+
 void FileLogger::setMaxLogFileCount(unsigned int fileCount)
 {
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 	m_maxLogFileCount = fileCount;
 }
 
 void FileLogger::deleteLogFiles(const std::wstring& cutoffDate)
 {
-	for (const FilePath& file: FileSystem::getFilePathsFromDirectory(m_logDirectory, {L".txt"}))
+	FilePath logDirectory;
+	{
+		std::lock_guard<std::mutex> lock(m_fileMutex);
+		logDirectory = m_logDirectory;
+	}
+
+	for (const FilePath& file: FileSystem::getFilePathsFromDirectory(logDirectory, {L".txt"}))
 	{
 		if (file.fileName() < cutoffDate)
 		{
@@ -118,6 +152,17 @@ void FileLogger::deleteLogFiles(const std::wstring& cutoffDate)
 	}
 }
 
+void FileLogger::flush()
+{
+	writeQueuedMessages();
+}
+
+bool FileLogger::isLogFileFull() const
+{
+	return (m_maxLogLineCount > 0 && m_currentLogLineCount >= m_maxLogLineCount) ||
+		(m_maxLogFileByteSize > 0 && m_currentLogFileByteSize >= m_maxLogFileByteSize);
+}
+
 void FileLogger::updateLogFileName()
 {
 	if (m_logFileName.empty())
@@ -131,9 +176,10 @@ void FileLogger::updateLogFileName()
 	if (m_maxLogFileCount > 0)
 	{
 		currentLogFilePath += L"_";
-		if (m_currentLogLineCount >= m_maxLogLineCount)
+		if (isLogFileFull())
 		{
 			m_currentLogLineCount = 0;
+			m_currentLogFileByteSize = 0;
 
 			m_currentLogFileCount++;
 			if (m_currentLogFileCount >= m_maxLogFileCount)
@@ -154,25 +200,75 @@ void FileLogger::updateLogFileName()
 	}
 }
 
-void FileLogger::logMessage(const std::string& type, const LogMessage& message)
+void FileLogger::logMessage(const char* type, const LogMessage& message)
 {
-	std::ofstream fileStream;
-	fileStream.open(m_currentLogFilePath.str(), std::ios::app);
-	fileStream << message.getTimeString("%H:%M:%S") << " | ";
-	fileStream << message.threadId << " | ";
+	QueuedMessage queuedMessage;
+	queuedMessage.type = type;
+	queuedMessage.message = std::make_unique<LogMessage>(message);
+	m_queue.push(std::move(queuedMessage));
+
+	m_writerCondition.notify_one();
+}
 
-	if (message.filePath.size())
+void FileLogger::runWriter()
+{
+	while (true)
 	{
-		fileStream << message.getFileName() << ':' << message.line << ' ' << message.functionName
-				   << "() | ";
+		bool stopped = false;
+		{
+			// a notification sent right before waiting is missed, the timeout bounds the delay then
+			std::unique_lock<std::mutex> lock(m_writerMutex);
+			m_writerCondition.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+				return m_writerStopped || !m_queue.empty();
+			});
+			stopped = m_writerStopped;
+		}
+
+		writeQueuedMessages();
+
+		if (stopped)
+		{
+			return;
+		}
 	}
+}
 
-	fileStream << type << ": " << utility::encodeToUtf8(message.message) << std::endl;
-	fileStream.close();
+void FileLogger::writeQueuedMessages()
+{
+	std::lock_guard<std::mutex> lock(m_fileMutex);
 
-	m_currentLogLineCount++;
-	if (m_maxLogFileCount > 0)
+	std::ofstream fileStream;
+	QueuedMessage queuedMessage;
+	while (m_queue.pop(queuedMessage))
 	{
-		updateLogFileName();
+		const LogMessage& message = *queuedMessage.message;
+
+		std::stringstream line;
+		line << message.getTimeString("%H:%M:%S") << " | ";
+		line << message.threadId << " | ";
+
+		if (message.filePath.size())
+		{
+			line << message.getFileName() << ':' << message.line << ' ' << message.functionName
+				 << "() | ";
+		}
+
+		line << queuedMessage.type << ": " << utility::encodeToUtf8(message.message) << '\n';
+
+		if (!fileStream.is_open())
+		{
+			fileStream.open(m_currentLogFilePath.str(), std::ios::app);
+		}
+
+		const std::string lineString = line.str();
+		fileStream << lineString;
+
+		m_currentLogLineCount++;
+		m_currentLogFileByteSize += lineString.size();
+		if (m_maxLogFileCount > 0 && !m_logFileName.empty() && isLogFileFull())
+		{
+			fileStream.close();
+			updateLogFileName();
+		}
 	}
 }
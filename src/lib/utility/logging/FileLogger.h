@@ -1,12 +1,19 @@
 #ifndef FILE_LOGGER_H
 #define FILE_LOGGER_H
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "FilePath.h"
+#include "LockFreeQueue.h"
 #include "LogMessage.h"
 #include "Logger.h"
 
+// Logging threads only queue their messages, a thread of the logger writes them in batches. The
+// destructor writes the messages that are still queued.
 class FileLogger: public Logger
 {
 public:
@@ -14,6 +21,7 @@ public:
 		const std::wstring& prefix = L"", const std::wstring& suffix = L"", int offsetDays = 0);
 
 	FileLogger();
+	~FileLogger() override;
 
 	FilePath getLogFilePath() const;
 	void setLogFilePath(const FilePath& filePath);
@@ -21,18 +29,32 @@ public:
 	void setLogDirectory(const FilePath& filePath);
 	void setFileName(const std::wstring& fileName);
 	void setMaxLogLineCount(unsigned int logCount);
+	void setMaxLogFileByteSize(size_t byteSize);
 
-	// setting the max log file count to 0 will disable ringlogging
+	// setting the max log file count to 0 will disable ringlogging, otherwise the next file is used
+	// once the line count or the byte size of the current one is reached
 	void setMaxLogFileCount(unsigned int amount);
 
 	void deleteLogFiles(const std::wstring& cutoffDate);
 
+	// writes all messages that were logged so far
+	void flush();
+
 private:
+	struct QueuedMessage
+	{
+		const char* type = nullptr;
+		std::unique_ptr<LogMessage> message;
+	};
+
 	void logInfo(const LogMessage& message) override;
 	void logWarning(const LogMessage& message) override;
 	void logError(const LogMessage& message) override;
 
-	void logMessage(const std::string& type, const LogMessage& message);
+	void logMessage(const char* type, const LogMessage& message);
+	void runWriter();
+	void writeQueuedMessages();
+	bool isLogFileFull() const;
 	void updateLogFileName();
 
 	std::wstring m_logFileName;
@@ -43,6 +65,18 @@ private:
 	unsigned int m_maxLogFileCount;
 	unsigned int m_currentLogLineCount;
 	unsigned int m_currentLogFileCount;
+	size_t m_maxLogFileByteSize;
+	size_t m_currentLogFileByteSize;
+
+	// guards the file state above and lets only one thread at a time take the queued messages
+	mutable std::mutex m_fileMutex;
+
+	LockFreeQueue<QueuedMessage> m_queue;
+
+	std::mutex m_writerMutex;
+	std::condition_variable m_writerCondition;
+	bool m_writerStopped;
+	std::thread m_writerThread;
 };
 
 #endif	  // FILE_LOGGER_H
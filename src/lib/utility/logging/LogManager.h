@@ -1,6 +1,7 @@
 #ifndef LOG_MANAGER_H
 #define LOG_MANAGER_H
 
+#include <atomic>
 #include <memory>
 
 #include "LogManagerImplementation.h"
@@ -64,7 +65,7 @@ private:
 	void operator=(const LogManager&);
 
 	LogManagerImplementation m_logManagerImplementation;
-	bool m_loggingEnabled;
+	std::atomic<bool> m_loggingEnabled;
 };
 
 #endif	  // LOG_MANAGER_H
@@ -88,12 +88,7 @@ void LogManagerImplementation::logInfo(
 	const std::string& function,
 	const unsigned int line)
 {
-	std::lock_guard<std::mutex> lockGuardLogger(m_loggerMutex);
-	for (unsigned int i = 0; i < m_loggers.size(); i++)
-	{
-		m_loggers[i]->onInfo(
-			LogMessage(message, file, function, line, getTime(), std::this_thread::get_id()));
-	}
+	logMessage(Logger::LOG_INFOS, message, file, function, line);
 }
 
 void LogManagerImplementation::logWarning(
@@ -102,12 +97,7 @@ void LogManagerImplementation::logWarning(
 	const std::string& function,
 	const unsigned int line)
 {
-	std::lock_guard<std::mutex> lockGuardLogger(m_loggerMutex);
-	for (unsigned int i = 0; i < m_loggers.size(); i++)
-	{
-		m_loggers[i]->onWarning(
-			LogMessage(message, file, function, line, getTime(), std::this_thread::get_id()));
-	}
+	logMessage(Logger::LOG_WARNINGS, message, file, function, line);
 }
 
 void LogManagerImplementation::logError(
@@ -115,12 +105,46 @@ void LogManagerImplementation::logError(
 	const std::string& file,
 	const std::string& function,
 	const unsigned int line)
+{
+	logMessage(Logger::LOG_ERRORS, message, file, function, line);
+}
+
+void LogManagerImplementation::logMessage(
+	Logger::LogLevel level,
+	const std::wstring& message,
+	const std::string& file,
+	const std::string& function,
+	const unsigned int line)
 {
 	std::lock_guard<std::mutex> lockGuardLogger(m_loggerMutex);
+
+	// the message is only created if one of the loggers takes its level
+	std::unique_ptr<LogMessage> logMessage;
 	for (unsigned int i = 0; i < m_loggers.size(); i++)
 	{
-		m_loggers[i]->onError(
-			LogMessage(message, file, function, line, getTime(), std::this_thread::get_id()));
+		if (!m_loggers[i]->isLogLevel(level))
+		{
+			continue;
+		}
+
+		if (!logMessage)
+		{
+			logMessage = std::make_unique<LogMessage>(
+				message, file, function, line, getTime(), std::this_thread::get_id());
+		}
+
+		switch (level)
+		{
+		case Logger::LOG_INFOS:
+			m_loggers[i]->onInfo(*logMessage);
+			break;
+		case Logger::LOG_WARNINGS:
+			m_loggers[i]->onWarning(*logMessage);
+			break;
+		default:
+			m_loggers[i]->onError(*logMessage);
+			break;
+		}
 	}
 }
 
@@ -46,6 +46,13 @@ public:
 		const unsigned int line);
 
 private:
+	void logMessage(
+		Logger::LogLevel level,
+		const std::wstring& message,
+		const std::string& file,
+		const std::string& function,
+		const unsigned int line);
+
 	tm getTime();
 
 	std::vector<std::shared_ptr<Logger>> m_loggers;
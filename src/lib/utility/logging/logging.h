@@ -6,42 +6,61 @@
 #include "LogManager.h"
 
 /**
- * @brief Makros to simplify usage of the log manager
+ * @brief Makros to simplify usage of the log manager, the message is not evaluated while logging
+ * is disabled
  */
 #define LOG_INFO(__str__)                                                                          \
 	do                                                                                             \
 	{                                                                                              \
-		LogManager::getInstance()->logInfo(__str__, __FILE__, __FUNCTION__, __LINE__);             \
+		if (LogManager::getInstance()->getLoggingEnabled())                                        \
+		{                                                                                          \
+			LogManager::getInstance()->logInfo(__str__, __FILE__, __FUNCTION__, __LINE__);         \
+		}                                                                                          \
 	} while (0)
 
 #define LOG_WARNING(__str__)                                                                       \
 	do                                                                                             \
 	{                                                                                              \
-		LogManager::getInstance()->logWarning(__str__, __FILE__, __FUNCTION__, __LINE__);          \
+		if (LogManager::getInstance()->getLoggingEnabled())                                        \
+		{                                                                                          \
+			LogManager::getInstance()->logWarning(__str__, __FILE__, __FUNCTION__, __LINE__);      \
+		}                                                                                          \
 	} while (0)
 
 #define LOG_ERROR(__str__)                                                                         \
 	do                                                                                             \
 	{                                                                                              \
-		LogManager::getInstance()->logError(__str__, __FILE__, __FUNCTION__, __LINE__);            \
+		if (LogManager::getInstance()->getLoggingEnabled())                                        \
+		{                                                                                          \
+			LogManager::getInstance()->logError(__str__, __FILE__, __FUNCTION__, __LINE__);        \
+		}                                                                                          \
 	} while (0)
 
 #define LOG_INFO_BARE(__str__)                                                                     \
 	do                                                                                             \
 	{                                                                                              \
-		LogManager::getInstance()->logInfo(__str__, "", "", 0);                                    \
+		if (LogManager::getInstance()->getLoggingEnabled())                                        \
+		{                                                                                          \
+			LogManager::getInstance()->logInfo(__str__, "", "", 0);                                \
+		}                                                                                          \
 	} while (0)
 
 #define LOG_WARNING_BARE(__str__)                                                                  \
 	do                                                                                             \
 	{                                                                                              \
-		LogManager::getInstance()->logWarning(__str__, "", "", 0);                                 \
+		if (LogManager::getInstance()->getLoggingEnabled())                                        \
+		{                                                                                          \
+			LogManager::getInstance()->logWarning(__str__, "", "", 0);                             \
+		}                                                                                          \
 	} while (0)
 
 #define LOG_ERROR_BARE(__str__)                                                                    \
 	do                                                                                             \
 	{                                                                                              \
-		LogManager::getInstance()->logError(__str__, "", "", 0);                                   \
+		if (LogManager::getInstance()->getLoggingEnabled())                                        \
+		{                                                                                          \
+			LogManager::getInstance()->logError(__str__, "", "", 0);                               \
+		}                                                                                          \
 	} while (0)
 
 #define LOG_INFO_STREAM(__s__)                                                                     \
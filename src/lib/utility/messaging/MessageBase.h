@@ -10,6 +10,14 @@
 class MessageBase
 {
 public:
+	// background messages are only processed while no other messages are queued, so user
+	// interaction is not held up by the status updates sent during indexing
+	enum Priority
+	{
+		PRIORITY_DEFAULT = 0,
+		PRIORITY_BACKGROUND = 1
+	};
+
 	MessageBase()
 		: m_id(s_nextId++)
 		, m_schedulerId(0)
@@ -19,6 +27,9 @@ public:
 		, m_keepContent(false)
 		, m_isLast(true)
 		, m_isLogged(true)
+		, m_priority(PRIORITY_DEFAULT)
+		, m_isCoalesced(false)
+		, m_batchesViewUpdates(false)
 	{
 	}
 
@@ -92,6 +103,38 @@ public:
 		m_isLogged = isLogged;
 	}
 
+	Priority getPriority() const
+	{
+		return m_priority;
+	}
+
+	void setPriority(Priority priority)
+	{
+		m_priority = priority;
+	}
+
+	// queued messages of the same type are dropped when a coalesced message is pushed
+	bool isCoalesced() const
+	{
+		return m_isCoalesced;
+	}
+
+	void setIsCoalesced(bool isCoalesced)
+	{
+		m_isCoalesced = isCoalesced;
+	}
+
+	// the view updates made while the listeners handle the message are applied together
+	bool batchesViewUpdates() const
+	{
+		return m_batchesViewUpdates;
+	}
+
+	void setBatchesViewUpdates(bool batchesViewUpdates)
+	{
+		m_batchesViewUpdates = batchesViewUpdates;
+	}
+
 	void setKeepContent(bool keepContent)
 	{
 		m_keepContent = keepContent;
@@ -126,6 +169,10 @@ private:
 
 	bool m_isLast;
 	bool m_isLogged;
+
+	Priority m_priority;
+	bool m_isCoalesced;
+	bool m_batchesViewUpdates;
 };
 
 #endif	  // MESSAGE_BASE_H
@@ -1,15 +1,17 @@
 #include "MessageQueue.h"
 
-#include <chrono>
+#include <algorithm>
 #include <thread>
 
 #include "MessageBase.h"
 #include "MessageFilter.h"
 #include "MessageListenerBase.h"
 #include "TabId.h"
+#include "TaskDecoratorViewUpdateBatch.h"
 #include "TaskGroupParallel.h"
 #include "TaskGroupSequence.h"
 #include "TaskLambda.h"
+#include "ViewUpdateBatch.h"
 #include "logging.h"
 
 std::shared_ptr<MessageQueue> MessageQueue::getInstance()
@@ -24,56 +26,62 @@ std::shared_ptr<MessageQueue> MessageQueue::getInstance()
 MessageQueue::~MessageQueue()
 {
 	std::lock_guard<std::mutex> lock(m_listenersMutex);
-	for (size_t i = 0; i < m_listeners.size(); i++)
+	for (const std::pair<const Id, std::shared_ptr<ListenerEntry>>& p: m_listenersById)
 	{
-		m_listeners[i]->removedListener();
+		p.second->listener->removedListener();
 	}
-	m_listeners.clear();
+	m_pendingListeners.clear();
+	m_listenersByType.clear();
+	m_listenersById.clear();
 }
 
 void MessageQueue::registerListener(MessageListenerBase* listener)
 {
+	std::shared_ptr<ListenerEntry> entry = std::make_shared<ListenerEntry>(listener);
+
 	std::lock_guard<std::mutex> lock(m_listenersMutex);
-	m_listeners.push_back(listener);
+	m_pendingListeners.push_back(entry);
+	m_listenersById.emplace(listener->getId(), entry);
 }
 
 void MessageQueue::unregisterListener(MessageListenerBase* listener)
 {
 	std::lock_guard<std::mutex> lock(m_listenersMutex);
-	for (size_t i = 0; i < m_listeners.size(); i++)
+
+	auto it = m_listenersById.find(listener->getId());
+	if (it == m_listenersById.end())
 	{
-		if (m_listeners[i] == listener)
-		{
-			m_listeners.erase(m_listeners.begin() + i);
+		LOG_ERROR("Listener was not found");
+		return;
+	}
 
-			// m_currentListenerIndex and m_listenersLength need to be updated in case this happens
-			// while a message is handled.
-			if (i <= m_currentListenerIndex)
-			{
-				m_currentListenerIndex--;
-			}
+	std::shared_ptr<ListenerEntry> entry = it->second;
+	m_listenersById.erase(it);
 
-			if (i < m_listenersLength)
-			{
-				m_listenersLength--;
-			}
+	// dispatches that are running keep their list, but skip the listener from now on
+	entry->alive = false;
 
-			return;
-		}
+	auto pendingIt = std::find(m_pendingListeners.begin(), m_pendingListeners.end(), entry);
+	if (pendingIt != m_pendingListeners.end())
+	{
+		m_pendingListeners.erase(pendingIt);
+		return;
 	}
 
-	LOG_ERROR("Listener was not found");
+	std::shared_ptr<ListenerList> listeners = std::make_shared<ListenerList>(
+		*m_listenersByType[entry->messageType]);
+	listeners->erase(std::find(listeners->begin(), listeners->end(), entry));
+	m_listenersByType[entry->messageType] = listeners;
 }
 
 MessageListenerBase* MessageQueue::getListenerById(Id listenerId) const
 {
 	std::lock_guard<std::mutex> lock(m_listenersMutex);
-	for (size_t i = 0; i < m_listeners.size(); i++)
+
+	auto it = m_listenersById.find(listenerId);
+	if (it != m_listenersById.end())
 	{
-		if (m_listeners[i]->getId() == listenerId)
-		{
-			return m_listeners[i];
-		}
+		return it->second->listener;
 	}
 	return nullptr;
 }
@@ -85,8 +93,24 @@ void MessageQueue::addMessageFilter(std::shared_ptr<MessageFilter> filter)
 
 void MessageQueue::pushMessage(std::shared_ptr<MessageBase> message)
 {
-	std::lock_guard<std::mutex> lock(m_messageBufferMutex);
-	m_messageBuffer.push_back(message);
+	{
+		std::lock_guard<std::mutex> lock(m_messageBufferMutex);
+		MessageBufferType& messageBuffer = m_messageBuffers[message->getPriority()];
+		if (message->isCoalesced())
+		{
+			const std::string type = message->getType();
+			messageBuffer.erase(
+				std::remove_if(
+					messageBuffer.begin(),
+					messageBuffer.end(),
+					[&type](const std::shared_ptr<MessageBase>& queuedMessage) {
+						return queuedMessage->getType() == type;
+					}),
+				messageBuffer.end());
+		}
+		messageBuffer.push_back(message);
+	}
+	m_messageBufferCondition.notify_one();
 }
 
 void MessageQueue::processMessage(std::shared_ptr<MessageBase> message, bool asNextTask)
@@ -132,24 +156,25 @@ void MessageQueue::startMessageLoop()
 	{
 		processMessages();
 
-		{
-			std::lock_guard<std::mutex> lock(m_loopMutex);
+		// sleeps until a message gets pushed or the loop is stopped
+		std::unique_lock<std::mutex> lock(m_messageBufferMutex);
+		m_messageBufferCondition.wait(
+			lock, [this]() { return !messageBuffersEmpty() || !loopIsRunning(); });
 
-			if (!m_loopIsRunning)
-			{
-				break;
-			}
+		if (!loopIsRunning())
+		{
+			break;
 		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 
 	{
+		// notifying within the lock keeps the stopping thread from destroying the condition first
 		std::lock_guard<std::mutex> lock(m_threadMutex);
 		if (m_threadIsRunning)
 		{
 			m_threadIsRunning = false;
 		}
+		m_threadCondition.notify_all();
 	}
 }
 
@@ -166,18 +191,15 @@ void MessageQueue::stopMessageLoop()
 		m_loopIsRunning = false;
 	}
 
-	while (true)
 	{
-		{
-			std::lock_guard<std::mutex> lock(m_threadMutex);
-			if (!m_threadIsRunning)
-			{
-				break;
-			}
-		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
+		// the loop checks whether it is running while holding the buffer mutex, so it cannot miss
+		// this notification between the check and starting to wait
+		std::lock_guard<std::mutex> lock(m_messageBufferMutex);
 	}
+	m_messageBufferCondition.notify_all();
+
+	std::unique_lock<std::mutex> lock(m_threadMutex);
+	m_threadCondition.wait(lock, [this]() { return !m_threadIsRunning; });
 }
 
 bool MessageQueue::loopIsRunning() const
@@ -189,7 +211,7 @@ bool MessageQueue::loopIsRunning() const
 bool MessageQueue::hasMessagesQueued() const
 {
 	std::lock_guard<std::mutex> lock(m_messageBufferMutex);
-	return m_messageBuffer.size() > 0;
+	return !messageBuffersEmpty();
 }
 
 void MessageQueue::setSendMessagesAsTasks(bool sendMessagesAsTasks)
@@ -200,9 +222,7 @@ void MessageQueue::setSendMessagesAsTasks(bool sendMessagesAsTasks)
 std::shared_ptr<MessageQueue> MessageQueue::s_instance;
 
 MessageQueue::MessageQueue()
-	: m_currentListenerIndex(0)
-	, m_listenersLength(0)
-	, m_loopIsRunning(false)
+	: m_loopIsRunning(false)
 	, m_threadIsRunning(false)
 	, m_sendMessagesAsTasks(false)
 {
@@ -216,57 +236,73 @@ void MessageQueue::processMessages()
 		{
 			std::lock_guard<std::mutex> lock(m_messageBufferMutex);
 
+			if (messageBuffersEmpty())
+			{
+				break;
+			}
+
+			MessageBufferType* messageBuffer = &m_messageBuffers[MessageBase::PRIORITY_DEFAULT];
+			if (messageBuffer->empty())
+			{
+				messageBuffer = &m_messageBuffers[MessageBase::PRIORITY_BACKGROUND];
+			}
+
 			for (std::shared_ptr<MessageFilter> filter: m_filters)
 			{
-				if (!m_messageBuffer.size())
+				if (!messageBuffer->size())
 				{
 					break;
 				}
 
-				filter->filter(&m_messageBuffer);
+				filter->filter(messageBuffer);
 			}
 
-			if (!m_messageBuffer.size())
+			if (!messageBuffer->size())
 			{
-				break;
+				continue;
 			}
 
-			message = m_messageBuffer.front();
-			m_messageBuffer.pop_front();
+			message = messageBuffer->front();
+			messageBuffer->pop_front();
 		}
 
 		processMessage(message, false);
 	}
 }
 
-void MessageQueue::sendMessage(std::shared_ptr<MessageBase> message)
+bool MessageQueue::messageBuffersEmpty() const
 {
-	std::lock_guard<std::mutex> lock(m_listenersMutex);
-
-	// m_listenersLength is saved, so that new listeners registered whithin message handling don't
-	// get the current message and the length can be reduced when a listener gets unregistered.
-	m_listenersLength = m_listeners.size();
+	return m_messageBuffers[MessageBase::PRIORITY_DEFAULT].empty() &&
+		m_messageBuffers[MessageBase::PRIORITY_BACKGROUND].empty();
+}
 
-	// The currentListenerIndex holds the index of the current listener being handled, so it can be
-	// changed when a listener gets removed while message handling.
-	for (m_currentListenerIndex = 0; m_currentListenerIndex < m_listenersLength;
-		 m_currentListenerIndex++)
+void MessageQueue::sendMessage(std::shared_ptr<MessageBase> message)
+{
+	if (message->batchesViewUpdates())
 	{
-		MessageListenerBase* listener = m_listeners[m_currentListenerIndex];
+		ViewUpdateBatch::begin();
+	}
 
-		if (listener->getType() == message->getType() &&
-			(message->getSchedulerId() == 0 || listener->getSchedulerId() == 0 ||
-			 listener->getSchedulerId() == message->getSchedulerId()))
+	// no lock is held while the listeners handle the message, so they can register and unregister
+	// listeners
+	const std::shared_ptr<const ListenerList> listeners = getListeners(message->getType());
+	for (const std::shared_ptr<ListenerEntry>& entry: *listeners)
+	{
+		if (entry->alive &&
+			(message->getSchedulerId() == 0 || entry->listener->getSchedulerId() == 0 ||
+			 entry->listener->getSchedulerId() == message->getSchedulerId()))
 		{
-			// The listenersMutex gets unlocked so changes to listeners are possible while message handling.
-			m_listenersMutex.unlock();
-			listener->handleMessageBase(message.get());
-			m_listenersMutex.lock();
+			entry->listener->handleMessageBase(message.get());
 		}
 	}
+
+	if (message->batchesViewUpdates())
+	{
+		ViewUpdateBatch::end();
+	}
 }
 
-void MessageQueue::sendMessageAsTask(std::shared_ptr<MessageBase> message, bool asNextTask) const
+void MessageQueue::sendMessageAsTask(std::shared_ptr<MessageBase> message, bool asNextTask)
 {
 	std::shared_ptr<TaskGroup> taskGroup;
 	if (message->isParallel())
@@ -278,29 +314,33 @@ void MessageQueue::sendMessageAsTask(std::shared_ptr<MessageBase> message, bool
 		taskGroup = std::make_shared<TaskGroupSequence>();
 	}
 
+	const std::shared_ptr<const ListenerList> listeners = getListeners(message->getType());
+	for (const std::shared_ptr<ListenerEntry>& entry: *listeners)
 	{
-		std::lock_guard<std::mutex> lock(m_listenersMutex);
-		for (size_t i = 0; i < m_listeners.size(); i++)
-		{
-			MessageListenerBase* listener = m_listeners[i];
+		MessageListenerBase* listener = entry->listener;
 
-			if (listener->getType() == message->getType() &&
-				(message->getSchedulerId() == 0 || listener->getSchedulerId() == 0 ||
-				 listener->getSchedulerId() == message->getSchedulerId()))
-			{
-				Id listenerId = listener->getId();
-				taskGroup->addTask(std::make_shared<TaskLambda>([listenerId, message]() {
-					MessageListenerBase* listener = MessageQueue::getInstance()->getListenerById(
-						listenerId);
-					if (listener)
-					{
-						listener->handleMessageBase(message.get());
-					}
-				}));
-			}
+		if (entry->alive &&
+			(message->getSchedulerId() == 0 || listener->getSchedulerId() == 0 ||
+			 listener->getSchedulerId() == message->getSchedulerId()))
+		{
+			Id listenerId = listener->getId();
+			taskGroup->addTask(std::make_shared<TaskLambda>([listenerId, message]() {
+				MessageListenerBase* listener = MessageQueue::getInstance()->getListenerById(
+					listenerId);
+				if (listener)
+				{
+					listener->handleMessageBase(message.get());
+				}
+			}));
 		}
 	}
 
+	std::shared_ptr<Task> task = taskGroup;
+	if (message->batchesViewUpdates())
+	{
+		task = std::make_shared<TaskDecoratorViewUpdateBatch>()->addChildTask(taskGroup);
+	}
+
 	Id schedulerId = message->getSchedulerId();
 	if (!schedulerId)
 	{
@@ -309,10 +349,48 @@ void MessageQueue::sendMessageAsTask(std::shared_ptr<MessageBase> message, bool
 
 	if (asNextTask)
 	{
-		Task::dispatchNext(schedulerId, taskGroup);
+		Task::dispatchNext(schedulerId, task);
 	}
 	else
 	{
-		Task::dispatch(schedulerId, taskGroup);
+		Task::dispatch(schedulerId, task);
+	}
+}
+
+std::shared_ptr<const MessageQueue::ListenerList> MessageQueue::getListeners(
+	const std::string& messageType)
+{
+	std::lock_guard<std::mutex> lock(m_listenersMutex);
+
+	if (!m_pendingListeners.empty())
+	{
+		std::map<std::string, std::shared_ptr<ListenerList>> changedLists;
+		for (const std::shared_ptr<ListenerEntry>& entry: m_pendingListeners)
+		{
+			entry->messageType = entry->listener->getType();
+
+			std::shared_ptr<ListenerList>& listeners = changedLists[entry->messageType];
+			if (!listeners)
+			{
+				std::shared_ptr<const ListenerList>& currentListeners =
+					m_listenersByType[entry->messageType];
+				listeners = currentListeners ? std::make_shared<ListenerList>(*currentListeners)
+											 : std::make_shared<ListenerList>();
+			}
+			listeners->push_back(entry);
+		}
+		m_pendingListeners.clear();
+
+		for (const std::pair<const std::string, std::shared_ptr<ListenerList>>& p: changedLists)
+		{
+			m_listenersByType[p.first] = p.second;
+		}
+	}
+
+	auto it = m_listenersByType.find(messageType);
+	if (it != m_listenersByType.end())
+	{
+		return it->second;
 	}
+	return std::make_shared<const ListenerList>();
 }
@@ -1,9 +1,13 @@
 #ifndef MESSAGE_QUEUE_H
 #define MESSAGE_QUEUE_H
 
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "types.h"
@@ -43,20 +47,39 @@ public:
 private:
 	static std::shared_ptr<MessageQueue> s_instance;
 
+	struct ListenerEntry
+	{
+		ListenerEntry(MessageListenerBase* listener): listener(listener), alive(true) {}
+
+		MessageListenerBase* const listener;
+		std::string messageType;	// set when the listener is sorted in
+		std::atomic<bool> alive;
+	};
+
+	typedef std::vector<std::shared_ptr<ListenerEntry>> ListenerList;
+
 	MessageQueue();
 	MessageQueue(const MessageQueue&) = delete;
 	void operator=(const MessageQueue&) = delete;
 
 	void processMessages();
+	bool messageBuffersEmpty() const;
 	void sendMessage(std::shared_ptr<MessageBase> message);
-	void sendMessageAsTask(std::shared_ptr<MessageBase> message, bool asNextTask) const;
+	void sendMessageAsTask(std::shared_ptr<MessageBase> message, bool asNextTask);
 
-	MessageBufferType m_messageBuffer;
-	std::vector<MessageListenerBase*> m_listeners;
+	// the returned list stays unchanged, listeners registered afterwards are not part of it and
+	// listeners unregistered afterwards are no longer alive
+	std::shared_ptr<const ListenerList> getListeners(const std::string& messageType);
+
+	// one buffer per message priority, the filters only see the messages of one buffer
+	MessageBufferType m_messageBuffers[2];
 	std::vector<std::shared_ptr<MessageFilter>> m_filters;
 
-	size_t m_currentListenerIndex;
-	size_t m_listenersLength;
+	// listeners are sorted in by message type on the next dispatch after their registration,
+	// because the base constructor registers them before their message type is known
+	ListenerList m_pendingListeners;
+	std::map<std::string, std::shared_ptr<const ListenerList>> m_listenersByType;
+	std::map<Id, std::shared_ptr<ListenerEntry>> m_listenersById;
 
 	bool m_loopIsRunning;
 	bool m_threadIsRunning;
@@ -66,6 +89,10 @@ private:
 	mutable std::mutex m_loopMutex;
 	mutable std::mutex m_threadMutex;
 
+	// wakes the idle loop when messages are pushed or the loop is stopped
+	std::condition_variable m_messageBufferCondition;
+	std::condition_variable m_threadCondition;
+
 	bool m_sendMessagesAsTasks;
 };
 
@@ -0,0 +1,24 @@
+#include "ViewUpdateBatch.h"
+
+std::shared_ptr<ViewUpdateBatch::Handler> ViewUpdateBatch::s_handler;
+
+void ViewUpdateBatch::setHandler(std::shared_ptr<Handler> handler)
+{
+	s_handler = handler;
+}
+
+void ViewUpdateBatch::begin()
+{
+	if (s_handler)
+	{
+		s_handler->beginBatch();
+	}
+}
+
+void ViewUpdateBatch::end()
+{
+	if (s_handler)
+	{
+		s_handler->endBatch();
+	}
+}
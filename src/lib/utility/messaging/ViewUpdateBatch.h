@@ -0,0 +1,30 @@
+#ifndef VIEW_UPDATE_BATCH_H
+#define VIEW_UPDATE_BATCH_H
+
+#include <memory>
+
+// Groups the view updates the controllers make while handling one message, so the gui can apply
+// them together instead of laying out and repainting after each one. Batches may be nested and
+// span several threads, they do nothing until the gui sets a handler.
+class ViewUpdateBatch
+{
+public:
+	class Handler
+	{
+	public:
+		virtual ~Handler() = default;
+
+		virtual void beginBatch() = 0;
+		virtual void endBatch() = 0;
+	};
+
+	static void setHandler(std::shared_ptr<Handler> handler);
+
+	static void begin();
+	static void end();
+
+private:
+	static std::shared_ptr<Handler> s_handler;
+};
+
+#endif	  // VIEW_UPDATE_BATCH_H
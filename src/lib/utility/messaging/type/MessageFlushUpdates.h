@@ -10,6 +10,7 @@ public:
 	MessageFlushUpdates(bool keepsContent = false)
 	{
 		setKeepContent(keepsContent);
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
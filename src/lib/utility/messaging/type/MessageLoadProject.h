@@ -1,6 +1,8 @@
 #ifndef MESSAGE_LOAD_PROJECT_H
 #define MESSAGE_LOAD_PROJECT_H
 
+#include <vector>
+
 #include "RefreshInfo.h"
 
 #include "FilePath.h"
@@ -28,12 +30,34 @@ public:
 		os << projectSettingsFilePath.wstr();
 		os << L", settingsChanged: " << std::boolalpha << settingsChanged;
 		os << L", refreshMode: " << refreshMode;
+		if (indexShard.isPartial())
+		{
+			os << L", shard: " << (indexShard.index + 1) << L"/" << indexShard.count;
+		}
+		if (!shardDbFilesToMerge.empty())
+		{
+			os << L", merging shards: " << shardDbFilesToMerge.size();
+		}
+		if (!indexDeltaFilePath.empty())
+		{
+			os << L", writing delta: " << indexDeltaFilePath.wstr();
+		}
+		if (!indexDeltaFilesToApply.empty())
+		{
+			os << L", applying deltas: " << indexDeltaFilesToApply.size();
+		}
 	}
 
 	const FilePath projectSettingsFilePath;
 	const bool settingsChanged;
 	const RefreshMode refreshMode;
 	const bool shallowIndexingRequested;
+
+	// used by distributed indexing runs on the command line
+	IndexShard indexShard;
+	std::vector<FilePath> shardDbFilesToMerge;
+	FilePath indexDeltaFilePath;
+	std::vector<FilePath> indexDeltaFilesToApply;
 };
 
 #endif	  // MESSAGE_LOAD_PROJECT_H
@@ -1,6 +1,9 @@
 #ifndef MESSAGE_REFRESH_H
 #define MESSAGE_REFRESH_H
 
+#include <set>
+
+#include "FilePath.h"
 #include "Message.h"
 
 class MessageRefresh: public Message<MessageRefresh>
@@ -11,7 +14,7 @@ public:
 		return "MessageRefresh";
 	}
 
-	MessageRefresh(): all(false) {}
+	MessageRefresh(): all(false), background(false) {}
 
 	MessageRefresh& refreshAll()
 	{
@@ -19,15 +22,39 @@ public:
 		return *this;
 	}
 
+	MessageRefresh& refreshInBackground()
+	{
+		background = true;
+		return *this;
+	}
+
+	// only checks the given files and the other files of their directories for changes
+	MessageRefresh& refreshChangedFiles(const std::set<FilePath>& filePaths)
+	{
+		background = true;
+		changedFilePaths = filePaths;
+		return *this;
+	}
+
 	void print(std::wostream& os) const override
 	{
 		if (all)
 		{
 			os << "all";
 		}
+		else if (background)
+		{
+			os << "background";
+			for (const FilePath& filePath: changedFilePaths)
+			{
+				os << " " << filePath.wstr();
+			}
+		}
 	}
 
 	bool all;
+	bool background;
+	std::set<FilePath> changedFilePaths;
 };
 
 #endif	  // MESSAGE_REFRESH_H
@@ -0,0 +1,17 @@
+#ifndef MESSAGE_SHOW_MEMORY_REPORT_H
+#define MESSAGE_SHOW_MEMORY_REPORT_H
+
+#include "Message.h"
+
+class MessageShowMemoryReport: public Message<MessageShowMemoryReport>
+{
+public:
+	MessageShowMemoryReport() {}
+
+	static const std::string getStaticType()
+	{
+		return "MessageShowMemoryReport";
+	}
+};
+
+#endif	  // MESSAGE_SHOW_MEMORY_REPORT_H
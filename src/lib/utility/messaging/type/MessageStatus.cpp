@@ -9,6 +9,7 @@ MessageStatus::MessageStatus(
 	m_stati.push_back(utility::replace(status, L"\n", L" "));
 
 	setSendAsTask(false);
+	setPriority(PRIORITY_BACKGROUND);
 }
 
 MessageStatus::MessageStatus(
@@ -16,6 +17,7 @@ MessageStatus::MessageStatus(
 	: isError(isError), showLoader(showLoader), showInStatusBar(showInStatusBar), m_stati(stati)
 {
 	setSendAsTask(false);
+	setPriority(PRIORITY_BACKGROUND);
 }
 
 const std::string MessageStatus::getStaticType()
@@ -20,6 +20,7 @@ public:
 	MessageActivateErrors(const ErrorFilter& filter, const FilePath& file = FilePath())
 		: filter(filter), file(file)
 	{
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
@@ -18,6 +18,7 @@ public:
 	MessageActivateFullTextSearch(const std::wstring& searchTerm, bool caseSensitive = false)
 		: searchTerm(searchTerm), caseSensitive(caseSensitive)
 	{
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
@@ -12,6 +12,7 @@ class MessageActivateLegend
 public:
 	MessageActivateLegend()
 	{
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
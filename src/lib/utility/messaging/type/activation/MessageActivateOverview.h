@@ -21,6 +21,7 @@ public:
 		: acceptedNodeTypes(acceptedNodeTypes)
 	{
 		setIsParallel(true);
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
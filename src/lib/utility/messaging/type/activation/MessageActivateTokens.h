@@ -21,6 +21,7 @@ public:
 		: isEdge(false), isAggregation(false), isFromSearch(false)
 	{
 		setIsParallel(true);
+		setBatchesViewUpdates(true);
 		setKeepContent(other->keepContent());
 		setSchedulerId(other->getSchedulerId());
 	}
@@ -23,6 +23,7 @@ public:
 		, horizontalLayout(horizontalLayout)
 		, custom(false)
 	{
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
@@ -43,6 +44,7 @@ public:
 		, horizontalLayout(horizontalLayout)
 		, custom(true)
 	{
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
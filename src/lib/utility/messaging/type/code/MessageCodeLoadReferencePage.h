@@ -0,0 +1,23 @@
+#ifndef MESSAGE_CODE_LOAD_REFERENCE_PAGE_H
+#define MESSAGE_CODE_LOAD_REFERENCE_PAGE_H
+
+#include "Message.h"
+#include "TabId.h"
+
+// requests the files of the next references once the code list got scrolled to its end
+class MessageCodeLoadReferencePage: public Message<MessageCodeLoadReferencePage>
+{
+public:
+	MessageCodeLoadReferencePage()
+	{
+		setIsLogged(false);
+		setSchedulerId(TabId::currentTab());
+	}
+
+	static const std::string getStaticType()
+	{
+		return "MessageCodeLoadReferencePage";
+	}
+};
+
+#endif	  // MESSAGE_CODE_LOAD_REFERENCE_PAGE_H
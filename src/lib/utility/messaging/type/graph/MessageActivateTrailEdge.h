@@ -22,6 +22,7 @@ public:
 		, sourceNameHierarchy(sourceNameHierarchy)
 		, targetNameHierarchy(targetNameHierarchy)
 	{
+		setBatchesViewUpdates(true);
 		setSchedulerId(TabId::currentTab());
 	}
 
@@ -15,6 +15,8 @@ public:
 		: showProgress(showProgress), progressPercent(progressPercent)
 	{
 		setSendAsTask(false);
+		setPriority(PRIORITY_BACKGROUND);
+		setIsCoalesced(true);
 	}
 
 	const bool showProgress;
@@ -1,6 +1,8 @@
 #ifndef MESSAGE_SEARCH_AUTOCOMPLETE_H
 #define MESSAGE_SEARCH_AUTOCOMPLETE_H
 
+#include <atomic>
+
 #include "Message.h"
 #include "Node.h"
 #include "NodeTypeSet.h"
@@ -10,7 +12,7 @@ class MessageSearchAutocomplete: public Message<MessageSearchAutocomplete>
 {
 public:
 	MessageSearchAutocomplete(const std::wstring& query, NodeTypeSet acceptedNodeTypes)
-		: query(query), acceptedNodeTypes(acceptedNodeTypes)
+		: query(query), acceptedNodeTypes(acceptedNodeTypes), requestId(++getLatestRequestIdRef())
 	{
 		setSchedulerId(TabId::currentTab());
 	}
@@ -20,6 +22,12 @@ public:
 		return "MessageSearchAutocomplete";
 	}
 
+	// a request is superseded as soon as the next one was created
+	static size_t getLatestRequestId()
+	{
+		return getLatestRequestIdRef();
+	}
+
 	virtual void print(std::wostream& os) const
 	{
 		os << query << L"[";
@@ -37,6 +45,14 @@ public:
 
 	const std::wstring query;
 	const NodeTypeSet acceptedNodeTypes;
+	const size_t requestId;
+
+private:
+	static std::atomic<size_t>& getLatestRequestIdRef()
+	{
+		static std::atomic<size_t> latestRequestId(0);
+		return latestRequestId;
+	}
 };
 
 #endif	  // MESSAGE_SEARCH_AUTOCOMPLETE_H
@@ -0,0 +1,25 @@
+#include "TaskDecoratorViewUpdateBatch.h"
+
+#include "ViewUpdateBatch.h"
+
+TaskDecoratorViewUpdateBatch::TaskDecoratorViewUpdateBatch() {}
+
+void TaskDecoratorViewUpdateBatch::doEnter(std::shared_ptr<Blackboard> blackboard)
+{
+	ViewUpdateBatch::begin();
+}
+
+Task::TaskState TaskDecoratorViewUpdateBatch::doUpdate(std::shared_ptr<Blackboard> blackboard)
+{
+	return m_taskRunner->update(blackboard);
+}
+
+void TaskDecoratorViewUpdateBatch::doExit(std::shared_ptr<Blackboard> blackboard)
+{
+	ViewUpdateBatch::end();
+}
+
+void TaskDecoratorViewUpdateBatch::doReset(std::shared_ptr<Blackboard> blackboard)
+{
+	m_taskRunner->reset();
+}
@@ -0,0 +1,20 @@
+#ifndef TASK_DECORATOR_VIEW_UPDATE_BATCH_H
+#define TASK_DECORATOR_VIEW_UPDATE_BATCH_H
+
+#include "TaskDecorator.h"
+#include "TaskRunner.h"
+
+// keeps a ViewUpdateBatch open while the child task runs, also when it fails
+class TaskDecoratorViewUpdateBatch: public TaskDecorator
+{
+public:
+	TaskDecoratorViewUpdateBatch();
+
+private:
+	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
+	TaskState doUpdate(std::shared_ptr<Blackboard> blackboard) override;
+	void doExit(std::shared_ptr<Blackboard> blackboard) override;
+	void doReset(std::shared_ptr<Blackboard> blackboard) override;
+};
+
+#endif	  // TASK_DECORATOR_VIEW_UPDATE_BATCH_H
@@ -1,9 +1,10 @@
 #include "TaskGroupParallel.h"
 
 #include <chrono>
-#include <thread>
 
 #include "ScopedFunctor.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
 
 TaskGroupParallel::TaskGroupParallel()
 	: m_needsToStartThreads(true), m_activeTaskCountMutex(std::make_shared<std::mutex>())
@@ -26,23 +27,22 @@ void TaskGroupParallel::doEnter(std::shared_ptr<Blackboard> blackboard)
 		for (size_t i = 0; i < m_tasks.size(); i++)
 		{
 			m_tasks[i]->active = true;
-			m_tasks[i]->thread = std::make_shared<std::thread>(
-				&TaskGroupParallel::processTaskThreaded,
-				this,
-				m_tasks[i],
-				blackboard,
-				m_activeTaskCountMutex);
+			startTaskThreaded(m_tasks[i], blackboard);
 		}
 	}
 }
 
 Task::TaskState TaskGroupParallel::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
-	std::this_thread::sleep_for(std::chrono::milliseconds(25));
-
-	if (m_tasks.size() != 0 && getActiveTaskCount() > 0)
+	if (m_tasks.size() != 0)
 	{
-		return STATE_RUNNING;
+		// wakes up when the last task finished, the timeout lets the scheduler check for termination
+		std::unique_lock<std::mutex> lock(*m_activeTaskCountMutex.get());
+		if (!m_activeTaskCountCondition.wait_for(
+				lock, std::chrono::milliseconds(100), [this]() { return m_activeTaskCount <= 0; }))
+		{
+			return STATE_RUNNING;
+		}
 	}
 
 	return (m_taskFailed ? STATE_FAILURE : STATE_SUCCESS);
@@ -52,8 +52,11 @@ void TaskGroupParallel::doExit(std::shared_ptr<Blackboard> blackboard)
 {
 	for (size_t i = 0; i < m_tasks.size(); i++)
 	{
-		m_tasks[i]->thread->join();
-		m_tasks[i]->thread.reset();
+		if (m_tasks[i]->finished.valid())
+		{
+			m_tasks[i]->finished.wait();
+			m_tasks[i]->finished = std::future<void>();
+		}
 	}
 }
 
@@ -68,14 +71,12 @@ void TaskGroupParallel::doReset(std::shared_ptr<Blackboard> blackboard)
 				std::lock_guard<std::mutex> lock(*m_activeTaskCountMutex.get());
 				m_activeTaskCount++;
 			}
-			m_tasks[i]->thread->join();
+			if (m_tasks[i]->finished.valid())
+			{
+				m_tasks[i]->finished.wait();
+			}
 			m_tasks[i]->active = true;
-			m_tasks[i]->thread = std::make_shared<std::thread>(
-				&TaskGroupParallel::processTaskThreaded,
-				this,
-				m_tasks[i],
-				blackboard,
-				m_activeTaskCountMutex);
+			startTaskThreaded(m_tasks[i], blackboard);
 		}
 	}
 }
@@ -89,14 +90,26 @@ void TaskGroupParallel::doTerminate()
 
 	for (size_t i = 0; i < m_tasks.size(); i++)
 	{
-		if (m_tasks[i]->thread)
+		if (m_tasks[i]->finished.valid())
 		{
-			m_tasks[i]->thread->join();
-			m_tasks[i]->thread.reset();
+			m_tasks[i]->finished.wait();
+			m_tasks[i]->finished = std::future<void>();
 		}
 	}
 }
 
+void TaskGroupParallel::startTaskThreaded(
+	std::shared_ptr<TaskInfo> taskInfo, std::shared_ptr<Blackboard> blackboard)
+{
+	// the tasks of the group run until they are done and may wait for each other, so they do not
+	// take the workers of the pool
+	std::shared_ptr<std::mutex> activeTaskCountMutex = m_activeTaskCountMutex;
+	taskInfo->finished = TaskManager::getThreadPool()->runBlocking(
+		[this, taskInfo, blackboard, activeTaskCountMutex]() {
+			processTaskThreaded(taskInfo, blackboard, activeTaskCountMutex);
+		});
+}
+
 void TaskGroupParallel::processTaskThreaded(
 	std::shared_ptr<TaskInfo> taskInfo,
 	std::shared_ptr<Blackboard> blackboard,
@@ -105,6 +118,7 @@ void TaskGroupParallel::processTaskThreaded(
 	ScopedFunctor functor([&]() {
 		std::lock_guard<std::mutex> lock(*activeTaskCountMutex.get());
 		m_activeTaskCount--;
+		m_activeTaskCountCondition.notify_all();
 	});
 
 	while (true)
@@ -122,9 +136,3 @@ void TaskGroupParallel::processTaskThreaded(
 		}
 	}
 }
-
-int TaskGroupParallel::getActiveTaskCount() const
-{
-	std::lock_guard<std::mutex> lock(*m_activeTaskCountMutex.get());
-	return m_activeTaskCount;
-}
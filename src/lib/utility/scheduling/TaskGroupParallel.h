@@ -1,9 +1,10 @@
 #ifndef TASK_GROUP_PARALLEL_H
 #define TASK_GROUP_PARALLEL_H
 
+#include <condition_variable>
+#include <future>
 #include <map>
 #include <mutex>
-#include <thread>
 
 #include "TaskGroup.h"
 #include "TaskRunner.h"
@@ -20,7 +21,7 @@ private:
 	{
 		TaskInfo(std::shared_ptr<TaskRunner> taskRunner): taskRunner(taskRunner), active(false) {}
 		std::shared_ptr<TaskRunner> taskRunner;
-		std::shared_ptr<std::thread> thread;
+		std::future<void> finished;	   // set while the task runs on a thread of the pool
 		volatile bool active;
 	};
 
@@ -30,11 +31,12 @@ private:
 	void doReset(std::shared_ptr<Blackboard> blackboard) override;
 	void doTerminate() override;
 
+	void startTaskThreaded(
+		std::shared_ptr<TaskInfo> taskInfo, std::shared_ptr<Blackboard> blackboard);
 	void processTaskThreaded(
 		std::shared_ptr<TaskInfo> taskInfo,
 		std::shared_ptr<Blackboard> blackboard,
 		std::shared_ptr<std::mutex> activeTaskCountMutex);
-	int getActiveTaskCount() const;
 
 	std::vector<std::shared_ptr<TaskInfo>> m_tasks;
 	bool m_needsToStartThreads;
@@ -42,6 +44,7 @@ private:
 	volatile bool m_taskFailed;
 	volatile int m_activeTaskCount;
 	mutable std::shared_ptr<std::mutex> m_activeTaskCountMutex;
+	std::condition_variable m_activeTaskCountCondition;
 };
 
 #endif	  // TASK_GROUP_PARALLEL_H
@@ -1,10 +1,15 @@
 #include "TaskManager.h"
 
 #include "TaskScheduler.h"
+#include "ThreadPool.h"
+#include "utilityApp.h"
 
 std::map<Id, std::shared_ptr<TaskScheduler>> TaskManager::s_schedulers;
 std::mutex TaskManager::s_schedulersMutex;
 
+std::shared_ptr<ThreadPool> TaskManager::s_threadPool;
+std::mutex TaskManager::s_threadPoolMutex;
+
 std::shared_ptr<TaskScheduler> TaskManager::createScheduler(Id schedulerId)
 {
 	return getScheduler(schedulerId);
@@ -35,3 +40,14 @@ std::shared_ptr<TaskScheduler> TaskManager::getScheduler(Id schedulerId)
 	s_schedulers.emplace(schedulerId, scheduler);
 	return scheduler;
 }
+
+std::shared_ptr<ThreadPool> TaskManager::getThreadPool()
+{
+	std::lock_guard<std::mutex> lock(s_threadPoolMutex);
+
+	if (!s_threadPool)
+	{
+		s_threadPool = std::make_shared<ThreadPool>(utility::getIdealThreadCount());
+	}
+	return s_threadPool;
+}
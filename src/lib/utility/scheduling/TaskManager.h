@@ -8,6 +8,7 @@
 #include "types.h"
 
 class TaskScheduler;
+class ThreadPool;
 
 class TaskManager
 {
@@ -17,9 +18,15 @@ public:
 
 	static std::shared_ptr<TaskScheduler> getScheduler(Id schedulerId);
 
+	// shared by all schedulers, so indexing and interactive work do not oversubscribe the cores
+	static std::shared_ptr<ThreadPool> getThreadPool();
+
 private:
 	static std::map<Id, std::shared_ptr<TaskScheduler>> s_schedulers;
 	static std::mutex s_schedulersMutex;
+
+	static std::shared_ptr<ThreadPool> s_threadPool;
+	static std::mutex s_threadPoolMutex;
 };
 
 #endif	  // TASK_MANAGER_H
@@ -1,6 +1,5 @@
 #include "TaskScheduler.h"
 
-#include <chrono>
 #include <thread>
 
 #include "ScopedFunctor.h"
@@ -21,22 +20,28 @@ TaskScheduler::~TaskScheduler()
 
 void TaskScheduler::pushTask(std::shared_ptr<Task> task)
 {
-	std::lock_guard<std::mutex> lock(m_tasksMutex);
-	m_taskRunners.push_back(std::make_shared<TaskRunner>(task));
+	{
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
+		m_taskRunners.push_back(std::make_shared<TaskRunner>(task));
+	}
+	m_tasksCondition.notify_one();
 }
 
 void TaskScheduler::pushNextTask(std::shared_ptr<Task> task)
 {
-	std::lock_guard<std::mutex> lock(m_tasksMutex);
-
-	if (m_taskRunners.size() == 0)
-	{
-		m_taskRunners.push_front(std::make_shared<TaskRunner>(task));
-	}
-	else
 	{
-		m_taskRunners.insert(m_taskRunners.begin() + 1, std::make_shared<TaskRunner>(task));
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
+
+		if (m_taskRunners.size() == 0)
+		{
+			m_taskRunners.push_front(std::make_shared<TaskRunner>(task));
+		}
+		else
+		{
+			m_taskRunners.insert(m_taskRunners.begin() + 1, std::make_shared<TaskRunner>(task));
+		}
 	}
+	m_tasksCondition.notify_one();
 }
 
 void TaskScheduler::startSchedulerLoopThreaded()
@@ -65,24 +70,24 @@ void TaskScheduler::startSchedulerLoop()
 	{
 		processTasks();
 
-		{
-			std::lock_guard<std::mutex> lock(m_loopMutex);
+		// sleeps until a task gets pushed or the loop is stopped
+		std::unique_lock<std::mutex> lock(m_tasksMutex);
+		m_tasksCondition.wait(lock, [this]() { return m_taskRunners.size() || !loopIsRunning(); });
 
-			if (!m_loopIsRunning)
-			{
-				break;
-			}
+		if (!loopIsRunning())
+		{
+			break;
 		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
 	}
 
 	{
+		// notifying within the lock keeps the stopping thread from destroying the condition first
 		std::lock_guard<std::mutex> lock(m_threadMutex);
 		if (m_threadIsRunning)
 		{
 			m_threadIsRunning = false;
 		}
+		m_threadCondition.notify_all();
 	}
 }
 
@@ -99,18 +104,15 @@ void TaskScheduler::stopSchedulerLoop()
 		m_loopIsRunning = false;
 	}
 
-	while (true)
 	{
-		{
-			std::lock_guard<std::mutex> lock(m_threadMutex);
-			if (!m_threadIsRunning)
-			{
-				break;
-			}
-		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(25));
+		// the loop checks whether it is running while holding the tasks mutex, so it cannot miss
+		// this notification between the check and starting to wait
+		std::lock_guard<std::mutex> lock(m_tasksMutex);
 	}
+	m_tasksCondition.notify_all();
+
+	std::unique_lock<std::mutex> lock(m_threadMutex);
+	m_threadCondition.wait(lock, [this]() { return !m_threadIsRunning; });
 }
 
 bool TaskScheduler::loopIsRunning() const
@@ -125,6 +127,12 @@ bool TaskScheduler::hasTasksQueued() const
 	return m_taskRunners.size();
 }
 
+size_t TaskScheduler::getTaskCount() const
+{
+	std::lock_guard<std::mutex> lock(m_tasksMutex);
+	return m_taskRunners.size();
+}
+
 void TaskScheduler::terminateRunningTasks()
 {
 	m_terminateRunningTasks = true;
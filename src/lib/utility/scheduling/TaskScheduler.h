@@ -1,6 +1,7 @@
 #ifndef TASK_SCHEDULER_H
 #define TASK_SCHEDULER_H
 
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -24,6 +25,8 @@ public:
 
 	bool loopIsRunning() const;
 	bool hasTasksQueued() const;
+	// includes the running task
+	size_t getTaskCount() const;
 
 	void terminateRunningTasks();
 
@@ -41,6 +44,10 @@ private:
 	mutable std::mutex m_tasksMutex;
 	mutable std::mutex m_loopMutex;
 	mutable std::mutex m_threadMutex;
+
+	// wakes the idle loop when tasks are pushed or the loop is stopped
+	std::condition_variable m_tasksCondition;
+	std::condition_variable m_threadCondition;
 };
 
 #endif	  // TASK_SCHEDULER_H
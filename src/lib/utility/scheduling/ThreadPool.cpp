@@ -0,0 +1,285 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+// lets jobs submitted from a worker end up in the jobs of that worker
+thread_local const ThreadPool* t_workerPool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+// threads for blocking functions quit after being idle for this long
+const std::chrono::seconds blockingThreadIdleTimeout(30);
+
+struct ParallelForBatch
+{
+	ParallelForBatch(size_t count, const std::function<void(size_t)>* function)
+		: count(count), function(function), nextIndex(0), finishedCount(0)
+	{
+	}
+
+	const size_t count;
+	const std::function<void(size_t)>* function;
+	std::atomic<size_t> nextIndex;
+
+	std::mutex finishedMutex;
+	std::condition_variable finishedCondition;
+	size_t finishedCount;
+};
+
+void runParallelForBatch(std::shared_ptr<ParallelForBatch> batch)
+{
+	size_t finishedCount = 0;
+	for (size_t i = batch->nextIndex++; i < batch->count; i = batch->nextIndex++)
+	{
+		(*batch->function)(i);
+		finishedCount++;
+	}
+
+	if (finishedCount)
+	{
+		std::lock_guard<std::mutex> lock(batch->finishedMutex);
+		batch->finishedCount += finishedCount;
+		if (batch->finishedCount == batch->count)
+		{
+			batch->finishedCondition.notify_all();
+		}
+	}
+}
+}	 // namespace
+
+ThreadPool::ThreadPool(size_t workerCount)
+	: m_jobCount(0), m_stopped(false), m_blockingThreads(std::make_shared<BlockingThreads>())
+{
+	workerCount = std::max<size_t>(1, workerCount);
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		m_workerThreads.emplace_back(&ThreadPool::runWorker, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_stopped = true;
+	}
+	m_jobsCondition.notify_all();
+
+	for (std::thread& thread: m_workerThreads)
+	{
+		thread.join();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_blockingThreads->mutex);
+		m_blockingThreads->stopped = true;
+	}
+	m_blockingThreads->condition.notify_all();
+}
+
+size_t ThreadPool::getWorkerCount() const
+{
+	return m_workers.size();
+}
+
+std::future<void> ThreadPool::run(std::function<void()> function, Priority priority)
+{
+	std::shared_ptr<std::packaged_task<void()>> task =
+		std::make_shared<std::packaged_task<void()>>(std::move(function));
+	std::future<void> future = task->get_future();
+	pushJob([task]() { (*task)(); }, priority);
+	return future;
+}
+
+void ThreadPool::parallelFor(
+	size_t count, const std::function<void(size_t)>& function, Priority priority)
+{
+	const size_t helperCount = count ? std::min(count - 1, m_workers.size()) : 0;
+	if (!helperCount)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			function(i);
+		}
+		return;
+	}
+
+	// helpers that start after all indices are taken return without calling the function
+	std::shared_ptr<ParallelForBatch> batch = std::make_shared<ParallelForBatch>(count, &function);
+	for (size_t i = 0; i < helperCount; i++)
+	{
+		pushJob([batch]() { runParallelForBatch(batch); }, priority);
+	}
+	runParallelForBatch(batch);
+
+	std::unique_lock<std::mutex> lock(batch->finishedMutex);
+	batch->finishedCondition.wait(lock, [&]() { return batch->finishedCount == count; });
+}
+
+std::future<void> ThreadPool::runBlocking(std::function<void()> function)
+{
+	std::shared_ptr<std::packaged_task<void()>> task =
+		std::make_shared<std::packaged_task<void()>>(std::move(function));
+	std::future<void> future = task->get_future();
+
+	bool startThread = false;
+	{
+		std::lock_guard<std::mutex> lock(m_blockingThreads->mutex);
+		m_blockingThreads->jobs.push_back([task]() { (*task)(); });
+		startThread = m_blockingThreads->jobs.size() > m_blockingThreads->idleThreadCount;
+	}
+
+	if (startThread)
+	{
+		std::thread(&ThreadPool::runBlockingThread, m_blockingThreads).detach();
+	}
+	else
+	{
+		m_blockingThreads->condition.notify_one();
+	}
+	return future;
+}
+
+void ThreadPool::pushJob(std::function<void()> job, Priority priority)
+{
+	if (t_workerPool == this && priority != PRIORITY_INTERACTIVE)
+	{
+		Worker& worker = *m_workers[t_workerIndex];
+		std::lock_guard<std::mutex> lock(worker.jobsMutex);
+		worker.jobs.push_back(std::move(job));
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobs[priority].push_back(std::move(job));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobCount++;
+	}
+	m_jobsCondition.notify_one();
+}
+
+bool ThreadPool::popJob(size_t workerIndex, std::function<void()>& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		if (!m_jobs[PRIORITY_INTERACTIVE].empty())
+		{
+			job = std::move(m_jobs[PRIORITY_INTERACTIVE].front());
+			m_jobs[PRIORITY_INTERACTIVE].pop_front();
+			m_jobCount--;
+			return true;
+		}
+	}
+
+	// the own jobs are taken newest first, they most likely work on data that is still cached
+	bool found = false;
+	{
+		Worker& worker = *m_workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker.jobsMutex);
+		if (!worker.jobs.empty())
+		{
+			job = std::move(worker.jobs.back());
+			worker.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		if (!found && !m_jobs[PRIORITY_INDEXING].empty())
+		{
+			job = std::move(m_jobs[PRIORITY_INDEXING].front());
+			m_jobs[PRIORITY_INDEXING].pop_front();
+			found = true;
+		}
+
+		if (found)
+		{
+			m_jobCount--;
+			return true;
+		}
+	}
+
+	// other workers are robbed of their oldest jobs
+	for (size_t i = 1; i < m_workers.size() && !found; i++)
+	{
+		Worker& worker = *m_workers[(workerIndex + i) % m_workers.size()];
+		std::lock_guard<std::mutex> lock(worker.jobsMutex);
+		if (!worker.jobs.empty())
+		{
+			job = std::move(worker.jobs.front());
+			worker.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (found)
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobCount--;
+	}
+	return found;
+}
+
+void ThreadPool::runWorker(size_t workerIndex)
+{
+	t_workerPool = this;
+	t_workerIndex = workerIndex;
+
+	while (true)
+	{
+		std::function<void()> job;
+		if (popJob(workerIndex, job))
+		{
+			job();
+			continue;
+		}
+
+		// a job may be counted while another worker is just taking it, the loop retries then
+		std::unique_lock<std::mutex> lock(m_jobsMutex);
+		m_jobsCondition.wait(lock, [this]() { return m_jobCount || m_stopped; });
+		if (m_stopped)
+		{
+			return;
+		}
+	}
+}
+
+void ThreadPool::runBlockingThread(std::shared_ptr<BlockingThreads> blockingThreads)
+{
+	std::unique_lock<std::mutex> lock(blockingThreads->mutex);
+	while (true)
+	{
+		if (blockingThreads->jobs.empty())
+		{
+			blockingThreads->idleThreadCount++;
+			blockingThreads->condition.wait_for(lock, blockingThreadIdleTimeout, [&]() {
+				return !blockingThreads->jobs.empty() || blockingThreads->stopped;
+			});
+			blockingThreads->idleThreadCount--;
+
+			if (blockingThreads->jobs.empty())
+			{
+				return;
+			}
+		}
+
+		std::function<void()> job = std::move(blockingThreads->jobs.front());
+		blockingThreads->jobs.pop_front();
+
+		lock.unlock();
+		job();
+		job = nullptr;
+		lock.lock();
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs short jobs on a fixed number of worker threads. Each worker keeps the jobs it submits
+// itself and idle workers steal from the others. Functions that may block for a long time run on
+// threads outside of the workers, which are kept for a while to be reused.
+class ThreadPool
+{
+public:
+	enum Priority
+	{
+		PRIORITY_INTERACTIVE = 0,	 // taken before all other jobs
+		PRIORITY_INDEXING = 1
+	};
+
+	ThreadPool(size_t workerCount);
+	~ThreadPool();
+
+	size_t getWorkerCount() const;
+
+	// waiting for the returned future within a job of the pool may wait for a job that cannot start
+	std::future<void> run(std::function<void()> function, Priority priority);
+
+	// calls the function for all indices below count on the workers and the calling thread and
+	// returns when all calls returned, the calling thread takes the indices no worker got to
+	void parallelFor(
+		size_t count, const std::function<void(size_t)>& function, Priority priority);
+
+	// for functions that wait for other threads or run until they are stopped
+	std::future<void> runBlocking(std::function<void()> function);
+
+private:
+	struct Worker
+	{
+		std::mutex jobsMutex;
+		std::deque<std::function<void()>> jobs;
+	};
+
+	struct BlockingThreads
+	{
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<std::function<void()>> jobs;
+		size_t idleThreadCount = 0;
+		bool stopped = false;
+	};
+
+	void pushJob(std::function<void()> job, Priority priority);
+	bool popJob(size_t workerIndex, std::function<void()>& job);
+	void runWorker(size_t workerIndex);
+
+	static void runBlockingThread(std::shared_ptr<BlockingThreads> blockingThreads);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_workerThreads;
+
+	std::mutex m_jobsMutex;
+	std::condition_variable m_jobsCondition;
+	std::deque<std::function<void()>> m_jobs[2];
+	size_t m_jobCount;	  // includes the jobs of the workers
+	bool m_stopped;
+
+	// shared with the blocking threads, which outlive the pool if their function does not return
+	std::shared_ptr<BlockingThreads> m_blockingThreads;
+};
+
+#endif	  // THREAD_POOL_H
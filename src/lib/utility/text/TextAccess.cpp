@@ -1,57 +1,36 @@
 #include "TextAccess.h"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 #include "logging.h"
 
 namespace
 {
-std::istream& safeGetline(std::istream& is, std::string& t)
-{
-	t.clear();
-
-	// The characters in the stream are read one-by-one using a std::streambuf.
-	// That is faster than reading them one-by-one using the std::istream.
-	// Code that uses streambuf this way must be guarded by a sentry object.
-	// The sentry object performs various tasks,
-	// such as thread synchronization and updating the stream state.
-
-	std::istream::sentry se(is, true);
-	std::streambuf* sb = is.rdbuf();
-
-	while (true)
-	{
-		int c = sb->sbumpc();
-		switch (c)
-		{
-		case '\n':
-			return is;
-		case '\r':
-			if (sb->sgetc() == '\n')
-			{
-				sb->sbumpc();
-			}
-			return is;
-		case std::streambuf::traits_type::eof():
-			// Also handle the case when the last line has no line ending
-			if (t.empty())
-			{
-				is.setstate(std::ios::eofbit);
-			}
-			return is;
-		default:
-			t += (char)c;
-		}
-	}
-}
+// smaller files are read, mapping them costs more than copying their contents
+const size_t minMappedFileSize = 256 * 1024;
 }	 // namespace
 
+struct TextAccess::MappedFile
+{
+	boost::interprocess::file_mapping mapping;
+	boost::interprocess::mapped_region region;
+};
+
 std::shared_ptr<TextAccess> TextAccess::createFromFile(const FilePath& filePath)
 {
 	std::shared_ptr<TextAccess> result(new TextAccess());
 
 	result->m_filePath = filePath;
-	result->m_lines = readFile(filePath);
+	result->m_carriageReturnEndsLine = true;
+	if (!result->readFile(filePath))
+	{
+		result->setText("");
+	}
 
 	return result;
 }
@@ -60,7 +39,7 @@ std::shared_ptr<TextAccess> TextAccess::createFromString(const std::string& text
 {
 	std::shared_ptr<TextAccess> result(new TextAccess());
 
-	result->m_lines = splitStringByLines(text);
+	result->setText(text);
 	result->m_filePath = filePath;
 
 	return result;
@@ -71,7 +50,19 @@ std::shared_ptr<TextAccess> TextAccess::createFromLines(
 {
 	std::shared_ptr<TextAccess> result(new TextAccess());
 
-	result->m_lines = lines;
+	std::string text;
+	std::vector<size_t> lineStarts;
+	for (const std::string& line: lines)
+	{
+		lineStarts.push_back(text.size());
+		text += line;
+	}
+	lineStarts.push_back(text.size());
+
+	// the lines are kept as given, even if they contain line breaks
+	result->setText(std::move(text));
+	result->m_lineStarts = std::move(lineStarts);
+	std::call_once(result->m_lineStartsFlag, []() {});
 	result->m_filePath = filePath;
 
 	return result;
@@ -81,12 +72,12 @@ TextAccess::~TextAccess() {}
 
 unsigned int TextAccess::getLineCount() const
 {
-	return m_lines.size();
+	return getLineStarts().size() - 1;
 }
 
 bool TextAccess::isEmpty() const
 {
-	return m_lines.empty();
+	return getLineCount() == 0;
 }
 
 FilePath TextAccess::getFilePath() const
@@ -101,7 +92,34 @@ std::string TextAccess::getLine(const unsigned int lineNumber) const
 		return "";
 	}
 
-	return m_lines[lineNumber - 1];	   // -1 to correct for use as index
+	const LineView line = getLineView(lineNumber);
+	std::string result(line.data, line.size);
+	if (hasLineEnding(lineNumber - 1))	  // -1 to correct for use as index
+	{
+		result += '\n';
+	}
+	return result;
+}
+
+TextAccess::LineView TextAccess::getLineView(const unsigned int lineNumber) const
+{
+	const std::vector<size_t>& lineStarts = getLineStarts();
+	if (lineNumber < 1 || lineNumber >= lineStarts.size())
+	{
+		return {m_data, 0};
+	}
+
+	const size_t begin = lineStarts[lineNumber - 1];
+	size_t end = lineStarts[lineNumber];
+	if (end > begin && m_data[end - 1] == '\n')
+	{
+		end--;
+	}
+	if (m_carriageReturnEndsLine && end > begin && m_data[end - 1] == '\r')
+	{
+		end--;
+	}
+	return {m_data + begin, end - begin};
 }
 
 std::vector<std::string> TextAccess::getLines(
@@ -112,101 +130,154 @@ std::vector<std::string> TextAccess::getLines(
 		return std::vector<std::string>();
 	}
 
-	std::vector<std::string>::iterator first = m_lines.begin() + firstLineNumber -
-		1;	  // -1 to correct for use as index
-	std::vector<std::string>::iterator last = m_lines.begin() + lastLineNumber;
-	return std::vector<std::string>(first, last);
+	std::vector<std::string> result;
+	result.reserve(lastLineNumber - firstLineNumber + 1);
+	for (unsigned int lineNumber = firstLineNumber; lineNumber <= lastLineNumber; lineNumber++)
+	{
+		result.push_back(getLine(lineNumber));
+	}
+	return result;
 }
 
 const std::vector<std::string>& TextAccess::getAllLines() const
 {
+	std::call_once(m_linesFlag, [this]() {
+		const unsigned int lineCount = getLineCount();
+		m_lines.reserve(lineCount);
+		for (unsigned int lineNumber = 1; lineNumber <= lineCount; lineNumber++)
+		{
+			m_lines.push_back(getLine(lineNumber));
+		}
+	});
 	return m_lines;
 }
 
 std::string TextAccess::getText() const
 {
-	std::string result = "";
-
-	for (unsigned int i = 0; i < m_lines.size(); i++)
+	if (!m_carriageReturnEndsLine || !std::memchr(m_data, '\r', m_size))
 	{
-		result += m_lines[i];
+		return std::string(m_data, m_size);
 	}
 
+	// line endings are returned as "\n"
+	std::string result;
+	result.reserve(m_size);
+	const unsigned int lineCount = getLineCount();
+	for (unsigned int lineNumber = 1; lineNumber <= lineCount; lineNumber++)
+	{
+		const LineView line = getLineView(lineNumber);
+		result.append(line.data, line.size);
+		if (hasLineEnding(lineNumber - 1))
+		{
+			result += '\n';
+		}
+	}
 	return result;
 }
 
-std::vector<std::string> TextAccess::readFile(const FilePath& filePath)
+size_t TextAccess::getByteSize() const
 {
-	std::vector<std::string> result;
+	return m_size + getLineStarts().size() * sizeof(size_t);
+}
 
+bool TextAccess::readFile(const FilePath& filePath)
+{
 	try
 	{
-		std::ifstream srcFile;
-		srcFile.open(filePath.str());
-
+		std::ifstream srcFile(filePath.str(), std::ios::binary | std::ios::ate);
 		if (srcFile.fail())
 		{
 			LOG_ERROR(L"Could not open file " + filePath.wstr());
-			return result;
+			return false;
 		}
 
-		while (!srcFile.eof())
+		const std::streamoff size = srcFile.tellg();
+		if (size >= std::streamoff(minMappedFileSize))
 		{
-			std::string line;
-			safeGetline(srcFile, line);
-			result.push_back(line + '\n');
+			srcFile.close();
+
+			std::unique_ptr<MappedFile> mappedFile = std::make_unique<MappedFile>();
+			mappedFile->mapping = boost::interprocess::file_mapping(
+				filePath.str().c_str(), boost::interprocess::read_only);
+			mappedFile->region = boost::interprocess::mapped_region(
+				mappedFile->mapping, boost::interprocess::read_only);
+
+			m_mappedFile = std::move(mappedFile);
+			m_data = static_cast<const char*>(m_mappedFile->region.get_address());
+			m_size = m_mappedFile->region.get_size();
+			return true;
 		}
 
-		srcFile.close();
+		std::string text(size_t(std::max<std::streamoff>(size, 0)), '\0');
+		srcFile.seekg(0);
+		srcFile.read(&text[0], text.size());
+		text.resize(size_t(srcFile.gcount()));
+		setText(std::move(text));
+		return true;
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_STREAM(
 			<< "Exception thrown while reading file \"" << filePath.str() << "\": " << e.what());
-		result.clear();
 	}
 	catch (...)
 	{
 		LOG_ERROR_STREAM(<< "Unknown exception thrown while reading file \"" << filePath.str() << "\"");
-		result.clear();
 	}
 
-	if (!result.empty())
-	{
-		std::string last = result.back().substr(0, result.back().size() - 1);
-		result.pop_back();
-		if (!last.empty())
-		{
-			result.push_back(last);
-		}
-	}
-
-	return result;
+	m_mappedFile.reset();
+	return false;
 }
 
-std::vector<std::string> TextAccess::splitStringByLines(const std::string& text)
+void TextAccess::setText(std::string text)
 {
-	std::vector<std::string> result;
-	size_t prevIndex = 0;
-	size_t index = text.find('\n');
-
-	while (index != std::string::npos)
-	{
-		result.push_back(text.substr(prevIndex, index - prevIndex) + '\n');
+	m_mappedFile.reset();
+	m_text = std::move(text);
+	m_data = m_text.data();
+	m_size = m_text.size();
+}
 
-		prevIndex = index + 1;
-		index = text.find('\n', prevIndex);
-	}
+TextAccess::TextAccess()
+	: m_filePath(L""), m_data(m_text.data()), m_size(0), m_carriageReturnEndsLine(false)
+{
+}
 
-	if (prevIndex < text.length())
-	{
-		result.push_back(text.substr(prevIndex));
-	}
+const std::vector<size_t>& TextAccess::getLineStarts() const
+{
+	std::call_once(m_lineStartsFlag, [this]() {
+		m_lineStarts.push_back(0);
+		for (size_t i = 0; i < m_size; i++)
+		{
+			const char c = m_data[i];
+			if (c == '\r' && m_carriageReturnEndsLine)
+			{
+				if (i + 1 < m_size && m_data[i + 1] == '\n')
+				{
+					i++;
+				}
+				m_lineStarts.push_back(i + 1);
+			}
+			else if (c == '\n')
+			{
+				m_lineStarts.push_back(i + 1);
+			}
+		}
 
-	return result;
+		// a last line without a line ending is a line too
+		if (m_lineStarts.back() != m_size)
+		{
+			m_lineStarts.push_back(m_size);
+		}
+	});
+	return m_lineStarts;
 }
 
-TextAccess::TextAccess(): m_filePath(L"") {}
+bool TextAccess::hasLineEnding(const unsigned int index) const
+{
+	const size_t end = getLineStarts()[index + 1];
+	return end > getLineStarts()[index] &&
+		(m_data[end - 1] == '\n' || (m_carriageReturnEndsLine && m_data[end - 1] == '\r'));
+}
 
 bool TextAccess::checkIndexInRange(const unsigned int index) const
 {
@@ -215,10 +286,10 @@ bool TextAccess::checkIndexInRange(const unsigned int index) const
 		LOG_WARNING_STREAM(<< "Line numbers start with one, is " << index);
 		return false;
 	}
-	else if (index > m_lines.size())
+	else if (index > getLineCount())
 	{
 		LOG_WARNING_STREAM(
-			<< "Tried to access index " << index << ". Maximum index is " << m_lines.size());
+			<< "Tried to access index " << index << ". Maximum index is " << getLineCount());
 		return false;
 	}
 
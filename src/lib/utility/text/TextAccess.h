@@ -2,14 +2,25 @@
 #define TEXT_ACCESS_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "FilePath.h"
 
+// Holds the text of a file or string as one buffer, large files are mapped into memory instead of
+// being read. The offsets of the lines are computed on first use and lines can be accessed as
+// views into the buffer without copying them.
 class TextAccess
 {
 public:
+	// characters of a line without its line ending, valid as long as the TextAccess lives
+	struct LineView
+	{
+		const char* data;
+		size_t size;
+	};
+
 	static std::shared_ptr<TextAccess> createFromFile(const FilePath& filePath);
 	static std::shared_ptr<TextAccess> createFromString(
 		const std::string& text, const FilePath& filePath = FilePath());
@@ -27,18 +38,28 @@ public:
 	 * @param lineNumber: starts with 1
 	 */
 	std::string getLine(const unsigned int lineNumber) const;
+	/**
+	 * @param lineNumber: starts with 1
+	 */
+	LineView getLineView(const unsigned int lineNumber) const;
 	/**
 	 * @param firstLineNumber: starts with 1
 	 * @param lastLineNumber: starts with 1
 	 */
 	std::vector<std::string> getLines(
 		const unsigned int firstLineNumber, const unsigned int lastLineNumber);
+	// copies all lines on the first call, prefer getLineView for large texts
 	const std::vector<std::string>& getAllLines() const;
 	std::string getText() const;
 
+	// text and line offsets, computes the offsets if they are not known yet
+	size_t getByteSize() const;
+
 private:
-	static std::vector<std::string> readFile(const FilePath& filePath);
-	static std::vector<std::string> splitStringByLines(const std::string& text);
+	struct MappedFile;
+
+	bool readFile(const FilePath& filePath);
+	void setText(std::string text);
 
 	TextAccess();
 	TextAccess(const TextAccess&);
@@ -47,8 +68,26 @@ private:
 	bool checkIndexInRange(const unsigned int index) const;
 	bool checkIndexIntervalInRange(const unsigned int firstIndex, const unsigned int lastIndex) const;
 
+	const std::vector<size_t>& getLineStarts() const;
+	bool hasLineEnding(const unsigned int index) const;
+
 	FilePath m_filePath;
-	std::vector<std::string> m_lines;
+
+	// the text is owned by either m_text or m_mappedFile
+	std::string m_text;
+	std::unique_ptr<MappedFile> m_mappedFile;
+	const char* m_data;
+	size_t m_size;
+
+	// files end lines at "\n", "\r\n" and "\r", strings only at "\n"
+	bool m_carriageReturnEndsLine;
+
+	// offsets of the lines followed by the size of the text
+	mutable std::vector<size_t> m_lineStarts;
+	mutable std::once_flag m_lineStartsFlag;
+
+	mutable std::vector<std::string> m_lines;
+	mutable std::once_flag m_linesFlag;
 };
 
 #endif	  // TEXT_ACCESS_H
@@ -0,0 +1,210 @@
+#include "TextLayoutMapping.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+const char s_commentMarker = '\x01';
+
+bool isWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f' || c == '\n';
+}
+
+bool isIdentifierChar(char c)
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+}	 // namespace
+
+std::string TextLayoutMapping::getContentHash(const std::string& text)
+{
+	// 64 bit FNV-1a, which unlike std::hash stays the same across platforms and builds
+	uint64_t hash = 14695981039346656037ULL;
+	for (char c: text)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+
+	char buffer[17];
+	std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+	return buffer;
+}
+
+std::string TextLayoutMapping::getCodeHash(const std::string& text)
+{
+	return getContentHash(getLayout(text).code);
+}
+
+TextLayoutMapping::TextLayoutMapping(const std::string& oldText, const std::string& newText)
+	: m_valid(false)
+{
+	const Layout oldLayout = getLayout(oldText);
+	const Layout newLayout = getLayout(newText);
+
+	if (oldLayout.code != newLayout.code)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < oldLayout.codePositions.size(); i++)
+	{
+		m_positions.emplace(oldLayout.codePositions[i], newLayout.codePositions[i]);
+	}
+
+	// code positions win where a comment ends right before code
+	for (size_t i = 0; i < oldLayout.commentPositions.size(); i++)
+	{
+		m_positions.emplace(oldLayout.commentPositions[i], newLayout.commentPositions[i]);
+	}
+
+	m_valid = true;
+}
+
+bool TextLayoutMapping::isValid() const
+{
+	return m_valid;
+}
+
+bool TextLayoutMapping::mapPosition(size_t& line, size_t& column) const
+{
+	auto it = m_positions.find(Position(line, column));
+	if (it == m_positions.end())
+	{
+		return false;
+	}
+
+	line = it->second.first;
+	column = it->second.second;
+	return true;
+}
+
+TextLayoutMapping::Layout TextLayoutMapping::getLayout(const std::string& text)
+{
+	Layout layout;
+
+	size_t line = 1;
+	size_t column = 1;
+	size_t i = 0;
+
+	auto advance = [&]() {
+		if (text[i] == '\n')
+		{
+			line++;
+			column = 1;
+		}
+		else
+		{
+			column++;
+		}
+		i++;
+	};
+
+	// consecutive whitespace counts as one gap, gaps spanning lines stay distinct for the preprocessor
+	char gap = 0;
+	auto addCode = [&](char c) {
+		if (gap && !layout.code.empty())
+		{
+			layout.code.push_back(gap);
+		}
+		gap = 0;
+		layout.code.push_back(c);
+	};
+
+	auto addCodeChar = [&]() {
+		addCode(text[i]);
+		layout.codePositions.emplace_back(line, column);
+		advance();
+	};
+
+	while (i < text.size())
+	{
+		const char c = text[i];
+
+		if (isWhitespace(c))
+		{
+			gap = (c == '\n' || gap == '\n') ? '\n' : ' ';
+			advance();
+		}
+		else if (c == '/' && i + 1 < text.size() && (text[i + 1] == '/' || text[i + 1] == '*'))
+		{
+			const bool isBlockComment = text[i + 1] == '*';
+
+			addCode(s_commentMarker);
+			layout.commentPositions.emplace_back(line, column);
+
+			advance();
+			Position lastPosition(line, column);
+			advance();
+
+			while (i < text.size())
+			{
+				if (isBlockComment && text.compare(i, 2, "*/") == 0)
+				{
+					advance();
+					lastPosition = Position(line, column);
+					advance();
+					break;
+				}
+				else if (!isBlockComment && text[i] == '\n')
+				{
+					break;
+				}
+
+				lastPosition = Position(line, column);
+				advance();
+			}
+
+			layout.commentPositions.push_back(lastPosition);
+			layout.commentPositions.emplace_back(line, column);
+		}
+		else if (c == '"' || (c == '\'' && (layout.code.empty() || !isIdentifierChar(layout.code.back()))))
+		{
+			const bool isRawString = c == '"' && !layout.code.empty() && layout.code.back() == 'R';
+
+			std::string rawStringEnd;
+			if (isRawString)
+			{
+				const size_t delimiterEnd = text.find('(', i);
+				rawStringEnd = ")" +
+					text.substr(i + 1, delimiterEnd == std::string::npos ? 0 : delimiterEnd - i - 1) +
+					"\"";
+			}
+
+			addCodeChar();
+			while (i < text.size())
+			{
+				if (isRawString)
+				{
+					if (text.compare(i, rawStringEnd.size(), rawStringEnd) == 0)
+					{
+						for (size_t j = 0; j < rawStringEnd.size(); j++)
+						{
+							addCodeChar();
+						}
+						break;
+					}
+				}
+				else if (text[i] == '\\' && i + 1 < text.size())
+				{
+					addCodeChar();
+				}
+				else if (text[i] == c || text[i] == '\n')
+				{
+					addCodeChar();
+					break;
+				}
+				addCodeChar();
+			}
+		}
+		else
+		{
+			addCodeChar();
+		}
+	}
+
+	return layout;
+}
@@ -0,0 +1,40 @@
+#ifndef TEXT_LAYOUT_MAPPING_H
+#define TEXT_LAYOUT_MAPPING_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Maps positions between two versions of a C or C++ source text that contain the same code and
+// only differ in the text of their comments or in whitespace within lines. Code characters map to
+// their counterparts, comments map by their first, last and one past their last character. Lines
+// and columns are 1-based and columns count bytes, like the locations recorded by clang.
+class TextLayoutMapping
+{
+public:
+	static std::string getContentHash(const std::string& text);
+	static std::string getCodeHash(const std::string& text);
+
+	TextLayoutMapping(const std::string& oldText, const std::string& newText);
+
+	bool isValid() const;
+	bool mapPosition(size_t& line, size_t& column) const;
+
+private:
+	typedef std::pair<size_t, size_t> Position;
+
+	struct Layout
+	{
+		std::string code;
+		std::vector<Position> codePositions;
+		std::vector<Position> commentPositions;
+	};
+
+	static Layout getLayout(const std::string& text);
+
+	bool m_valid;
+	std::map<Position, Position> m_positions;
+};
+
+#endif	  // TEXT_LAYOUT_MAPPING_H
@@ -1,6 +1,186 @@
 #include "tracing.h"
 
+#include <chrono>
+#include <fstream>
 #include <set>
+#include <vector>
+
+namespace
+{
+// the oldest events of a thread are overwritten once it recorded this many
+const size_t timelineEventsPerThread = 16384;
+
+struct TimelineEvent
+{
+	const char* eventName;
+	const char* functionName;
+	const char* fileName;
+	int lineNumber;
+	long long startTime;
+	long long endTime;
+};
+
+// only locked by its own thread while recording, so recording does not contend
+struct ThreadTimeline
+{
+	ThreadTimeline(size_t threadIndex): threadIndex(threadIndex), eventCount(0) {}
+
+	const size_t threadIndex;
+	std::mutex mutex;
+	std::vector<TimelineEvent> events;
+	size_t eventCount;	  // includes the overwritten events
+};
+
+const std::chrono::steady_clock::time_point timelineStartTime = std::chrono::steady_clock::now();
+
+std::mutex timelinesMutex;
+std::vector<std::shared_ptr<ThreadTimeline>> timelines;
+thread_local std::shared_ptr<ThreadTimeline> t_timeline;
+
+ThreadTimeline& getThreadTimeline()
+{
+	if (!t_timeline)
+	{
+		std::lock_guard<std::mutex> lock(timelinesMutex);
+		t_timeline = std::make_shared<ThreadTimeline>(timelines.size() + 1);
+		timelines.push_back(t_timeline);
+	}
+	return *t_timeline;
+}
+
+std::string escapeJson(const char* str)
+{
+	std::string escaped;
+	for (const char* c = str; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			escaped += '\\';
+			escaped += *c;
+		}
+		else if (static_cast<unsigned char>(*c) < 0x20)
+		{
+			escaped += ' ';
+		}
+		else
+		{
+			escaped += *c;
+		}
+	}
+	return escaped;
+}
+}	 // namespace
+
+std::atomic<bool> TimelineTracer::s_enabled(false);
+
+void TimelineTracer::setEnabled(bool enabled)
+{
+	if (enabled)
+	{
+		std::lock_guard<std::mutex> lock(timelinesMutex);
+		for (const std::shared_ptr<ThreadTimeline>& timeline: timelines)
+		{
+			std::lock_guard<std::mutex> timelineLock(timeline->mutex);
+			timeline->events.clear();
+			timeline->eventCount = 0;
+		}
+	}
+
+	s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+long long TimelineTracer::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			   std::chrono::steady_clock::now() - timelineStartTime)
+		.count();
+}
+
+void TimelineTracer::recordEvent(
+	const char* eventName,
+	const char* functionName,
+	const char* fileName,
+	int lineNumber,
+	long long startTime,
+	long long endTime)
+{
+	const TimelineEvent event = {eventName, functionName, fileName, lineNumber, startTime, endTime};
+
+	ThreadTimeline& timeline = getThreadTimeline();
+	std::lock_guard<std::mutex> lock(timeline.mutex);
+	if (timeline.events.size() < timelineEventsPerThread)
+	{
+		timeline.events.push_back(event);
+	}
+	else
+	{
+		timeline.events[timeline.eventCount % timelineEventsPerThread] = event;
+	}
+	timeline.eventCount++;
+}
+
+size_t TimelineTracer::getEventCount()
+{
+	size_t eventCount = 0;
+	std::lock_guard<std::mutex> lock(timelinesMutex);
+	for (const std::shared_ptr<ThreadTimeline>& timeline: timelines)
+	{
+		std::lock_guard<std::mutex> timelineLock(timeline->mutex);
+		eventCount += timeline->events.size();
+	}
+	return eventCount;
+}
+
+bool TimelineTracer::exportChromeTrace(const FilePath& filePath)
+{
+	std::ofstream fileStream(filePath.str());
+	if (!fileStream.is_open())
+	{
+		return false;
+	}
+
+	fileStream << "{\"traceEvents\":[\n";
+	fileStream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+			   << "\"args\":{\"name\":\"Sourcetrail\"}}";
+
+	std::vector<std::shared_ptr<ThreadTimeline>> threadTimelines;
+	{
+		std::lock_guard<std::mutex> lock(timelinesMutex);
+		threadTimelines = timelines;
+	}
+
+	for (const std::shared_ptr<ThreadTimeline>& timeline: threadTimelines)
+	{
+		std::vector<TimelineEvent> events;
+		size_t firstIndex = 0;
+		{
+			std::lock_guard<std::mutex> lock(timeline->mutex);
+			events = timeline->events;
+			firstIndex = timeline->eventCount % timelineEventsPerThread;
+		}
+
+		if (events.size() < timelineEventsPerThread)
+		{
+			firstIndex = 0;
+		}
+
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			const TimelineEvent& event = events[(firstIndex + i) % events.size()];
+			const std::string functionName = escapeJson(event.functionName);
+			fileStream << ",\n{\"name\":\""
+					   << (*event.eventName ? escapeJson(event.eventName) : functionName)
+					   << "\",\"cat\":\"trace\",\"ph\":\"X\",\"ts\":" << event.startTime
+					   << ",\"dur\":" << (event.endTime - event.startTime)
+					   << ",\"pid\":1,\"tid\":" << timeline->threadIndex
+					   << ",\"args\":{\"function\":\"" << functionName << "\",\"location\":\""
+					   << escapeJson(event.fileName) << ":" << event.lineNumber << "\"}}";
+		}
+	}
+
+	fileStream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return fileStream.good();
+}
 
 std::shared_ptr<Tracer> Tracer::s_instance;
 Id Tracer::s_nextTraceId = 0;
@@ -6,6 +6,7 @@
 // #define USE_ACCUMULATED_TRACING
 
 
+#include <atomic>
 #include <mutex>
 #include <stack>
 #include <thread>
@@ -93,6 +94,75 @@ private:
 };
 
 
+// Records the TRACE scopes of all threads into a ring buffer per thread while it is enabled and
+// only costs an atomic load per scope otherwise. The timeline is written as Chrome trace json,
+// which can be opened in chrome://tracing or Perfetto.
+class TimelineTracer
+{
+public:
+	static bool isEnabled()
+	{
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+
+	// enabling drops the events recorded before
+	static void setEnabled(bool enabled);
+
+	// microseconds since the start of the process
+	static long long now();
+
+	// the strings have to stay valid for the lifetime of the process, like literals do
+	static void recordEvent(
+		const char* eventName,
+		const char* functionName,
+		const char* fileName,
+		int lineNumber,
+		long long startTime,
+		long long endTime);
+
+	static size_t getEventCount();
+	static bool exportChromeTrace(const FilePath& filePath);
+
+private:
+	static std::atomic<bool> s_enabled;
+};
+
+class ScopedTimelineTrace
+{
+public:
+	ScopedTimelineTrace(
+		const char* eventName, const char* fileName, int lineNumber, const char* functionName)
+		: m_eventName(eventName)
+		, m_fileName(fileName)
+		, m_lineNumber(lineNumber)
+		, m_functionName(functionName)
+		, m_startTime(TimelineTracer::isEnabled() ? TimelineTracer::now() : -1)
+	{
+	}
+
+	~ScopedTimelineTrace()
+	{
+		if (m_startTime >= 0)
+		{
+			TimelineTracer::recordEvent(
+				m_eventName,
+				m_functionName,
+				m_fileName,
+				m_lineNumber,
+				m_startTime,
+				TimelineTracer::now());
+		}
+	}
+
+private:
+	const char* m_eventName;
+	const char* m_fileName;
+	int m_lineNumber;
+	const char* m_functionName;
+	long long m_startTime;
+};
+
+
 template <typename TracerType>
 class ScopedTrace
 {
@@ -132,15 +202,21 @@ ScopedTrace<TracerType>::~ScopedTrace()
 }
 
 
+// names have to be string literals, an empty name shows the function name
+#define TRACE_TIMELINE(__name__)                                                                   \
+	ScopedTimelineTrace __timeline_trace__("" __name__, __FILE__, __LINE__, __FUNCTION__)
+
 #ifdef TRACING_ENABLED
 #	ifdef USE_ACCUMULATED_TRACING
 #		define TRACE(__name__)                                                                    \
+			TRACE_TIMELINE(__name__);                                                              \
 			ScopedTrace<AccumulatingTracer> __trace__(                                             \
 				std::string(__name__), __FILE__, __LINE__, __FUNCTION__)
 
 #		define PRINT_TRACES() AccumulatingTracer::getInstance()->printTraces()
 #	else
 #		define TRACE(__name__)                                                                    \
+			TRACE_TIMELINE(__name__);                                                              \
 			ScopedTrace<Tracer> __trace__(std::string(__name__), __FILE__, __LINE__, __FUNCTION__)
 
 #		define PRINT_TRACES() Tracer::getInstance()->printTraces()
@@ -148,7 +224,7 @@ ScopedTrace<TracerType>::~ScopedTrace()
 
 
 #else
-#	define TRACE(__name__)
+#	define TRACE(__name__) TRACE_TIMELINE(__name__)
 #	define PRINT_TRACES()
 #endif
 
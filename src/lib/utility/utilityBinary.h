@@ -0,0 +1,111 @@
+#ifndef UTILITY_BINARY_H
+#define UTILITY_BINARY_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Raw copies of arrays of fixed size records, preceded by their count. The data is only meant to
+// be read by the same build on the same platform.
+namespace utility
+{
+template <typename T>
+void appendBinaryData(std::string& data, const std::vector<T>& values)
+{
+	const uint64_t count = values.size();
+	data.append(reinterpret_cast<const char*>(&count), sizeof(count));
+	if (count)
+	{
+		data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+}
+
+template <typename T>
+bool readBinaryData(const char* data, size_t size, size_t& position, std::vector<T>& values)
+{
+	uint64_t count = 0;
+	if (size - position < sizeof(count))
+	{
+		return false;
+	}
+	std::memcpy(&count, data + position, sizeof(count));
+	position += sizeof(count);
+
+	if (count > (size - position) / sizeof(T))
+	{
+		return false;
+	}
+
+	values.resize(count);
+	if (count)
+	{
+		std::memcpy(values.data(), data + position, count * sizeof(T));
+	}
+	position += count * sizeof(T);
+	return true;
+}
+
+template <typename T>
+bool readBinaryData(const std::string& data, size_t& position, std::vector<T>& values)
+{
+	return readBinaryData(data.data(), data.size(), position, values);
+}
+
+// unsigned numbers in groups of 7 bits, the high bit of a byte marks that another one follows
+inline void appendVarint(std::string& data, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back(char((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.push_back(char(value));
+}
+
+inline bool readVarint(const std::string& data, size_t& position, uint64_t& value)
+{
+	value = 0;
+	for (size_t shift = 0; shift < 64 && position < data.size(); shift += 7)
+	{
+		const uint64_t byte = uint8_t(data[position++]);
+		value |= (byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// signed numbers alternate with their sign, so small differences stay small in both directions
+inline void appendSignedVarint(std::string& data, int64_t value)
+{
+	appendVarint(data, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+inline bool readSignedVarint(const std::string& data, size_t& position, int64_t& value)
+{
+	uint64_t encoded = 0;
+	if (!readVarint(data, position, encoded))
+	{
+		return false;
+	}
+	value = int64_t(encoded >> 1) ^ -int64_t(encoded & 1);
+	return true;
+}
+
+// fnv-1a, unlike std::hash it is the same in every process and on every platform
+inline uint64_t getStableHash(const char* data, size_t size, uint64_t seed = 14695981039346656037ull)
+{
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= uint8_t(data[i]);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+}	 // namespace utility
+
+#endif	  // UTILITY_BINARY_H
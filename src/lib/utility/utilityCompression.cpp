@@ -0,0 +1,213 @@
+#include "utilityCompression.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const size_t minMatchLength = 4;
+const size_t lastLiteralCount = 5;	  // the format ends every block with literals
+const size_t matchStartLimit = 12;	  // no match starts within the last bytes of a block
+const size_t maxOffset = 65535;
+const size_t hashBits = 16;
+const size_t sizeHeaderLength = 4;
+
+uint32_t read32(const char* data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint32_t getHash(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - hashBits);
+}
+
+void appendLength(std::string& result, size_t length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		result += char(255);
+	}
+	result += char(length);
+}
+
+void appendSequence(
+	std::string& result,
+	const char* literals,
+	size_t literalCount,
+	size_t offset,
+	size_t matchLength)
+{
+	const size_t matchLengthCode = matchLength ? matchLength - minMatchLength : 0;
+	result += char(
+		((literalCount < 15 ? literalCount : 15) << 4) |
+		(matchLengthCode < 15 ? matchLengthCode : 15));
+	if (literalCount >= 15)
+	{
+		appendLength(result, literalCount - 15);
+	}
+	result.append(literals, literalCount);
+
+	if (matchLength)
+	{
+		result += char(offset & 0xFF);
+		result += char(offset >> 8);
+		if (matchLengthCode >= 15)
+		{
+			appendLength(result, matchLengthCode - 15);
+		}
+	}
+}
+
+bool readLength(const unsigned char* data, size_t size, size_t& position, size_t& length)
+{
+	unsigned char byte = 255;
+	while (byte == 255)
+	{
+		if (position == size)
+		{
+			return false;
+		}
+		byte = data[position++];
+		length += byte;
+	}
+	return true;
+}
+}	 // namespace
+
+namespace utility
+{
+std::string compressData(const std::string& data)
+{
+	const char* input = data.data();
+	const size_t size = data.size();
+
+	std::string result;
+	result.reserve(sizeHeaderLength + size / 2);
+	const uint32_t sizeHeader = uint32_t(size);
+	for (size_t i = 0; i < sizeHeaderLength; i++)
+	{
+		result += char((sizeHeader >> (8 * i)) & 0xFF);
+	}
+
+	// positions of the last sequence of four bytes with each hash, a single candidate per hash
+	// keeps compression fast at the cost of some ratio
+	std::vector<uint32_t> positions(size_t(1) << hashBits, 0);
+
+	size_t anchor = 0;
+	size_t position = 0;
+	while (position + matchStartLimit <= size)
+	{
+		const uint32_t sequence = read32(input + position);
+		uint32_t& candidateEntry = positions[getHash(sequence)];
+		const size_t candidate = candidateEntry;
+		candidateEntry = uint32_t(position);
+
+		if (candidate >= position || position - candidate > maxOffset ||
+			read32(input + candidate) != sequence)
+		{
+			position++;
+			continue;
+		}
+
+		size_t matchEnd = position + minMatchLength;
+		const size_t matchEndLimit = size - lastLiteralCount;
+		const size_t distance = position - candidate;
+		while (matchEnd < matchEndLimit && input[matchEnd] == input[matchEnd - distance])
+		{
+			matchEnd++;
+		}
+
+		appendSequence(
+			result, input + anchor, position - anchor, distance, matchEnd - position);
+		position = matchEnd;
+		anchor = position;
+	}
+
+	appendSequence(result, input + anchor, size - anchor, 0, 0);
+	return result;
+}
+
+bool decompressData(const char* compressedData, size_t compressedSize, std::string* data)
+{
+	const unsigned char* input = reinterpret_cast<const unsigned char*>(compressedData);
+	if (compressedSize < sizeHeaderLength + 1)
+	{
+		return false;
+	}
+
+	size_t size = 0;
+	for (size_t i = 0; i < sizeHeaderLength; i++)
+	{
+		size |= size_t(input[i]) << (8 * i);
+	}
+
+	std::string& result = *data;
+	result.resize(size);
+	size_t outputPosition = 0;
+
+	size_t position = sizeHeaderLength;
+	while (true)
+	{
+		if (position == compressedSize)
+		{
+			return false;
+		}
+		const unsigned char token = input[position++];
+
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !readLength(input, compressedSize, position, literalCount))
+		{
+			return false;
+		}
+		if (literalCount > compressedSize - position || literalCount > size - outputPosition)
+		{
+			return false;
+		}
+		std::memcpy(&result[0] + outputPosition, input + position, literalCount);
+		position += literalCount;
+		outputPosition += literalCount;
+
+		if (position == compressedSize)
+		{
+			return outputPosition == size;
+		}
+
+		if (compressedSize - position < 2)
+		{
+			return false;
+		}
+		const size_t offset = size_t(input[position]) | (size_t(input[position + 1]) << 8);
+		position += 2;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(input, compressedSize, position, matchLength))
+		{
+			return false;
+		}
+		matchLength += minMatchLength;
+		if (!offset || offset > outputPosition || matchLength > size - outputPosition)
+		{
+			return false;
+		}
+
+		// matches may overlap the bytes they produce
+		char* output = &result[0] + outputPosition;
+		if (offset >= matchLength)
+		{
+			std::memcpy(output, output - offset, matchLength);
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				output[i] = output[i - offset];
+			}
+		}
+		outputPosition += matchLength;
+	}
+}
+}	 // namespace utility
@@ -0,0 +1,16 @@
+#ifndef UTILITY_COMPRESSION_H
+#define UTILITY_COMPRESSION_H
+
+#include <string>
+
+// Fast compression of text in the block format of LZ4, without its frame format. The compressed
+// data starts with the size of the uncompressed data, so it can be decompressed on its own.
+namespace utility
+{
+std::string compressData(const std::string& data);
+
+// returns false for data that was not produced by compressData
+bool decompressData(const char* compressedData, size_t compressedSize, std::string* data);
+}	 // namespace utility
+
+#endif	  // UTILITY_COMPRESSION_H
@@ -0,0 +1,242 @@
+#include "utilitySystemResources.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include <sys/resource.h>
+#endif
+#ifdef __linux__
+#	include <sched.h>
+#endif
+
+#include "logging.h"
+#include "utilityString.h"
+
+namespace
+{
+// cgroup v1 reports a value close to the maximum of a 64 bit integer for no limit
+const unsigned long long s_unlimitedMemory = 1ull << 60;
+
+std::string readFile(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		return "";
+	}
+
+	std::stringstream content;
+	content << file.rdbuf();
+	return utility::trim(content.str());
+}
+
+// the cgroup v2 hierarchy of the process below the mount point, empty for cgroup v1
+std::string getCgroupV2Path()
+{
+	std::ifstream file("/proc/self/cgroup");
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (utility::isPrefix<std::string>("0::", line))
+		{
+			return "/sys/fs/cgroup" + utility::trim(line.substr(3));
+		}
+	}
+	return "";
+}
+
+// looks at the cgroup of the process first and at the root for containers with their own namespace
+std::string readCgroupV2File(const std::string& fileName)
+{
+	const std::string cgroupPath = getCgroupV2Path();
+	std::string text = cgroupPath.empty() ? "" : readFile(cgroupPath + "/" + fileName);
+	if (text.empty())
+	{
+		text = readFile("/sys/fs/cgroup/" + fileName);
+	}
+	return text;
+}
+}	 // namespace
+
+namespace utility
+{
+size_t getAvailableCpuCount()
+{
+#ifdef __linux__
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0)
+	{
+		return size_t(CPU_COUNT(&cpus));
+	}
+#endif
+	return 0;
+}
+
+double getCgroupCpuLimit()
+{
+#ifdef __linux__
+	const std::string cpuMax = readCgroupV2File("cpu.max");
+	if (!cpuMax.empty())
+	{
+		return parseCgroupV2CpuMax(cpuMax);
+	}
+
+	for (const std::string& directory: {"/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct"})
+	{
+		const std::string quota = readFile(directory + "/cpu.cfs_quota_us");
+		if (!quota.empty())
+		{
+			return parseCgroupV1CpuQuota(quota, readFile(directory + "/cpu.cfs_period_us"));
+		}
+	}
+#endif
+	return 0;
+}
+
+unsigned long long getCgroupMemoryLimit()
+{
+#ifdef __linux__
+	const std::string memoryMax = readCgroupV2File("memory.max");
+	if (!memoryMax.empty())
+	{
+		return parseCgroupMemoryLimit(memoryMax);
+	}
+
+	return parseCgroupMemoryLimit(readFile("/sys/fs/cgroup/memory/memory.limit_in_bytes"));
+#else
+	return 0;
+#endif
+}
+
+bool pinProcessToNumaNode(size_t index)
+{
+#ifdef __linux__
+	cpu_set_t allowedCpus;
+	CPU_ZERO(&allowedCpus);
+	if (sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) != 0)
+	{
+		return false;
+	}
+
+	// only the nodes with cpus the process may run on are used
+	std::vector<cpu_set_t> nodeCpus;
+	for (size_t node: parseCpuList(readFile("/sys/devices/system/node/online")))
+	{
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		for (size_t cpu: parseCpuList(
+				 readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")))
+		{
+			if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowedCpus))
+			{
+				CPU_SET(cpu, &cpus);
+			}
+		}
+
+		if (CPU_COUNT(&cpus) > 0)
+		{
+			nodeCpus.push_back(cpus);
+		}
+	}
+
+	if (nodeCpus.size() < 2)
+	{
+		return false;
+	}
+
+	const size_t node = index % nodeCpus.size();
+	if (sched_setaffinity(0, sizeof(cpu_set_t), &nodeCpus[node]) != 0)
+	{
+		LOG_WARNING("Unable to pin the process to the cpus of numa node " + std::to_string(node));
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool lowerProcessPriority()
+{
+#ifdef _WIN32
+	return SetPriorityClass(GetCurrentProcess(), BELOW_NORMAL_PRIORITY_CLASS) != 0;
+#else
+	return setpriority(PRIO_PROCESS, 0, 10) == 0;
+#endif
+}
+
+double parseCgroupV2CpuMax(const std::string& text)
+{
+	std::istringstream stream(text);
+	std::string quota;
+	std::string period;
+	if (!(stream >> quota >> period) || quota == "max")
+	{
+		return 0;
+	}
+	return parseCgroupV1CpuQuota(quota, period);
+}
+
+double parseCgroupV1CpuQuota(const std::string& quotaText, const std::string& periodText)
+{
+	try
+	{
+		const double quota = std::stod(quotaText);
+		const double period = std::stod(periodText);
+		// a quota of -1 means no limit
+		if (quota > 0 && period > 0)
+		{
+			return quota / period;
+		}
+	}
+	catch (std::exception&)
+	{
+	}
+	return 0;
+}
+
+unsigned long long parseCgroupMemoryLimit(const std::string& text)
+{
+	try
+	{
+		const unsigned long long limit = std::stoull(text);
+		if (limit < s_unlimitedMemory)
+		{
+			return limit;
+		}
+	}
+	catch (std::exception&)
+	{
+		// "max" for no limit in cgroup v2
+	}
+	return 0;
+}
+
+std::vector<size_t> parseCpuList(const std::string& text)
+{
+	std::vector<size_t> cpus;
+	for (const std::string& range: splitToVector(trim(text), ','))
+	{
+		try
+		{
+			const size_t dashPos = range.find('-');
+			const size_t first = std::stoul(range.substr(0, dashPos));
+			const size_t last = dashPos == std::string::npos ? first
+															  : std::stoul(range.substr(dashPos + 1));
+			for (size_t cpu = first; cpu <= last; cpu++)
+			{
+				cpus.push_back(cpu);
+			}
+		}
+		catch (std::exception&)
+		{
+		}
+	}
+	return cpus;
+}
+}	 // namespace utility
@@ -0,0 +1,29 @@
+#ifndef UTILITY_SYSTEM_RESOURCES_H
+#define UTILITY_SYSTEM_RESOURCES_H
+
+#include <string>
+#include <vector>
+
+// Limits of the cpus and memory the process may use, which containers set by cpu affinity and by
+// the quotas of cgroups v1 or v2. All values are 0 where there is no limit or it is unknown.
+namespace utility
+{
+size_t getAvailableCpuCount();
+double getCgroupCpuLimit();	   // in cpus, may be fractional
+unsigned long long getCgroupMemoryLimit();	  // in bytes
+
+// pins the calling process to the cpus of one numa node, which makes the memory it touches first
+// local to that node, nodes are picked round robin by the index. Returns false if there is only one
+// node the process may run on or pinning is not supported.
+bool pinProcessToNumaNode(size_t index);
+
+// lets the process yield the cpus to processes of normal priority, returns false if not supported
+bool lowerProcessPriority();
+
+double parseCgroupV2CpuMax(const std::string& text);	// "<quota> <period>" or "max <period>"
+double parseCgroupV1CpuQuota(const std::string& quotaText, const std::string& periodText);
+unsigned long long parseCgroupMemoryLimit(const std::string& text);
+std::vector<size_t> parseCpuList(const std::string& text);	  // e.g. "0-3,8,10-11"
+}	 // namespace utility
+
+#endif	  // UTILITY_SYSTEM_RESOURCES_H
@@ -82,26 +82,53 @@ void CxxIndexerCommandProvider::addCommand(const std::shared_ptr<IndexerCommandC
 	}
 
 	{
+		// commands of the same target only differ in the flags naming their input and output
+		// files, so all other flags are shared between them as a single flag set
 		const std::vector<std::wstring>& compilerFlags = command->getCompilerFlags();
-		representation->m_compilerFlagIds.reserve(compilerFlags.size());
-		for (const std::wstring& compilerFlag: compilerFlags)
+		const std::vector<size_t> sourceFileFlagIndices =
+			command->getSourceFileSpecificCompilerFlagIndices();
+
+		std::vector<Id> flagIds;
+		flagIds.reserve(compilerFlags.size());
+		size_t sourceFileFlagIndex = 0;
+		for (size_t i = 0; i < compilerFlags.size(); i++)
 		{
-			std::unordered_map<std::wstring, Id>::const_iterator it = m_compilerFlagsToIds.find(
-				compilerFlag);
-			if (it != m_compilerFlagsToIds.end())
+			const Id flagId = getCompilerFlagId(compilerFlags[i]);
+			if (sourceFileFlagIndex < sourceFileFlagIndices.size() &&
+				sourceFileFlagIndices[sourceFileFlagIndex] == i)
 			{
-				representation->m_compilerFlagIds.emplace_back(it->second);
+				representation->m_sourceFileFlagIds.emplace_back(i, flagId);
+				flagIds.push_back(0);
+				sourceFileFlagIndex++;
 			}
 			else
 			{
-				const Id id = getId();
-				m_compilerFlagsToIds.emplace(compilerFlag, id);
-				m_idsToCompilerFlags.emplace(id, compilerFlag);
-				representation->m_compilerFlagIds.emplace_back(id);
+				flagIds.push_back(flagId);
+			}
+		}
+
+		std::map<std::vector<Id>, Id>::const_iterator it = m_compilerFlagSetsToIds.find(flagIds);
+		if (it != m_compilerFlagSetsToIds.end())
+		{
+			representation->m_compilerFlagSetId = it->second;
+		}
+		else
+		{
+			std::wstring flags;
+			for (const Id flagId: flagIds)
+			{
+				flags += (flagId ? m_idsToCompilerFlags[flagId] : L"") + L' ';
 			}
+
+			const Id id = getId();
+			m_idsToCompilerFlagSets[id] = {flagIds, std::hash<std::wstring>()(flags)};
+			m_compilerFlagSetsToIds.emplace(std::move(flagIds), id);
+			representation->m_compilerFlagSetId = id;
 		}
 	}
 
+	representation->m_shallow = command->isShallow();
+
 	m_commands.emplace(command->getSourceFilePath(), representation);
 }
 
@@ -176,6 +203,30 @@ size_t CxxIndexerCommandProvider::size() const
 	return m_commands.size();
 }
 
+size_t CxxIndexerCommandProvider::getClusterKey(const FilePath& filePath) const
+{
+	std::map<FilePath, std::shared_ptr<CommandRepresentation>>::const_iterator it = m_commands.find(
+		filePath);
+	if (it == m_commands.end() || !it->second)
+	{
+		return 0;
+	}
+
+	std::map<Id, CompilerFlagSet>::const_iterator flagSetIt = m_idsToCompilerFlagSets.find(
+		it->second->m_compilerFlagSetId);
+	std::map<Id, FilePath>::const_iterator directoryIt = m_idsToWorkingDirectories.find(
+		it->second->m_workingDirectoryId);
+	if (flagSetIt == m_idsToCompilerFlagSets.end() || directoryIt == m_idsToWorkingDirectories.end())
+	{
+		return 0;
+	}
+
+	// unlike the ids the hashes of the flags also match across providers
+	const size_t key = flagSetIt->second.hash ^
+		std::hash<std::wstring>()(directoryIt->second.wstr());
+	return key ? key : 1;
+}
+
 void CxxIndexerCommandProvider::logStats() const
 {
 	LOG_INFO("CxxIndexerCommandProvider stats:");
@@ -184,6 +235,7 @@ void CxxIndexerCommandProvider::logStats() const
 	LOG_INFO("\tinclude filter count: " + std::to_string(m_idsToIncludeFilters.size()));
 	LOG_INFO("\tworking directory count: " + std::to_string(m_idsToWorkingDirectories.size()));
 	LOG_INFO("\tcompiler flag count: " + std::to_string(m_idsToCompilerFlags.size()));
+	LOG_INFO("\tcompiler flag set count: " + std::to_string(m_idsToCompilerFlagSets.size()));
 }
 
 Id CxxIndexerCommandProvider::getId()
@@ -191,6 +243,21 @@ Id CxxIndexerCommandProvider::getId()
 	return m_nextId++;
 }
 
+Id CxxIndexerCommandProvider::getCompilerFlagId(const std::wstring& compilerFlag)
+{
+	std::unordered_map<std::wstring, Id>::const_iterator it = m_compilerFlagsToIds.find(
+		compilerFlag);
+	if (it != m_compilerFlagsToIds.end())
+	{
+		return it->second;
+	}
+
+	const Id id = getId();
+	m_compilerFlagsToIds.emplace(compilerFlag, id);
+	m_idsToCompilerFlags.emplace(id, compilerFlag);
+	return id;
+}
+
 std::shared_ptr<IndexerCommandCxx> CxxIndexerCommandProvider::represetationToCommand(
 	const FilePath& sourceFilePath, std::shared_ptr<CommandRepresentation> representation)
 {
@@ -214,12 +281,21 @@ std::shared_ptr<IndexerCommandCxx> CxxIndexerCommandProvider::represetationToCom
 
 	FilePath workingDirectory = m_idsToWorkingDirectories[representation->m_workingDirectoryId];
 
+	const std::vector<Id>& flagIds =
+		m_idsToCompilerFlagSets[representation->m_compilerFlagSetId].flagIds;
 	std::vector<std::wstring> compilerFlags;
-	for (const Id id: representation->m_compilerFlagIds)
+	compilerFlags.reserve(flagIds.size());
+	for (const Id id: flagIds)
+	{
+		compilerFlags.push_back(id ? m_idsToCompilerFlags[id] : L"");
+	}
+	for (const std::pair<size_t, Id>& p: representation->m_sourceFileFlagIds)
 	{
-		compilerFlags.push_back(m_idsToCompilerFlags[id]);
+		compilerFlags[p.first] = m_idsToCompilerFlags[p.second];
 	}
 
-	return std::make_shared<IndexerCommandCxx>(
+	std::shared_ptr<IndexerCommandCxx> command = std::make_shared<IndexerCommandCxx>(
 		sourceFilePath, indexedPaths, excludeFilters, includeFilters, workingDirectory, compilerFlags);
+	command->setShallow(representation->m_shallow);
+	return command;
 }
@@ -22,6 +22,7 @@ public:
 	std::vector<std::shared_ptr<IndexerCommand>> consumeAllCommands() override;
 	void clear() override;
 	size_t size() const override;
+	size_t getClusterKey(const FilePath& filePath) const override;
 	void logStats() const;
 
 private:
@@ -31,10 +32,20 @@ private:
 		std::set<Id> m_excludeFilterIds;
 		std::set<Id> m_includeFilterIds;
 		Id m_workingDirectoryId;
-		std::vector<Id> m_compilerFlagIds;
+		Id m_compilerFlagSetId;
+		// flags naming the input and output files, which are left out of the shared flag set
+		std::vector<std::pair<size_t, Id>> m_sourceFileFlagIds;
+		bool m_shallow;
+	};
+
+	struct CompilerFlagSet
+	{
+		std::vector<Id> flagIds;
+		size_t hash;
 	};
 
 	Id getId();
+	Id getCompilerFlagId(const std::wstring& compilerFlag);
 	std::shared_ptr<IndexerCommandCxx> represetationToCommand(
 		const FilePath& sourceFilePath, std::shared_ptr<CommandRepresentation> representation);
 
@@ -52,6 +63,8 @@ private:
 	std::map<FilePath, Id> m_workingDirectoriesToIds;
 	std::map<Id, std::wstring> m_idsToCompilerFlags;
 	std::unordered_map<std::wstring, Id> m_compilerFlagsToIds;
+	std::map<Id, CompilerFlagSet> m_idsToCompilerFlagSets;
+	std::map<std::vector<Id>, Id> m_compilerFlagSetsToIds;
 };
 
 #endif	  // CXX_INDEXER_COMMAND_PROVIDER_H
@@ -3,20 +3,18 @@
 #include <QJsonArray>
 #include <QJsonObject>
 
+#include "CachedCompilationDatabase.h"
 #include "MessageStatus.h"
-#include "OrderedCache.h"
 #include "ResourcePaths.h"
 #include "logging.h"
 #include "utility.h"
 #include "utilitySourceGroupCxx.h"
 #include "utilityString.h"
-#include <clang/Tooling/CompilationDatabase.h>
-#include <clang/Tooling/JSONCompilationDatabase.h>
 
 std::vector<FilePath> IndexerCommandCxx::getSourceFilesFromCDB(const FilePath& cdbPath)
 {
 	std::string error;
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath, &error);
+	std::shared_ptr<const CachedCompilationDatabase> cdb = utility::loadCDB(cdbPath, &error);
 
 	if (!error.empty())
 	{
@@ -26,41 +24,7 @@ std::vector<FilePath> IndexerCommandCxx::getSourceFilesFromCDB(const FilePath& c
 		MessageStatus(message, true).dispatch();
 	}
 
-	return getSourceFilesFromCDB(cdb, cdbPath);
-}
-
-std::vector<FilePath> IndexerCommandCxx::getSourceFilesFromCDB(
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb, const FilePath& cdbPath)
-{
-	std::vector<FilePath> filePaths;
-	if (cdb)
-	{
-		OrderedCache<FilePath, FilePath> canonicalDirectoryPathCache(
-			[](const FilePath& path) { return path.getCanonical(); });
-
-		for (const std::string& fileString: cdb->getAllFiles())
-		{
-			FilePath path = FilePath(utility::decodeFromUtf8(fileString));
-			if (!path.isAbsolute())
-			{
-				std::vector<clang::tooling::CompileCommand> commands = cdb->getCompileCommands(
-					fileString);
-				if (!commands.empty())
-				{
-					path = FilePath(utility::decodeFromUtf8(
-										commands.front().Directory + '/' + commands.front().Filename))
-							   .makeCanonical();
-				}
-			}
-			if (!path.isAbsolute())
-			{
-				path = cdbPath.getParentDirectory().getConcatenated(path).makeCanonical();
-			}
-			filePaths.push_back(canonicalDirectoryPathCache.getValue(path.getParentDirectory())
-									.concatenate(path.fileName()));
-		}
-	}
-	return filePaths;
+	return cdb ? cdb->getSourceFilePaths() : std::vector<FilePath>();
 }
 
 std::wstring IndexerCommandCxx::getCompilerFlagLanguageStandard(const std::wstring& languageStandard)
@@ -123,6 +87,7 @@ IndexerCommandCxx::IndexerCommandCxx(
 	, m_includeFilters(includeFilters)
 	, m_workingDirectory(workingDirectory)
 	, m_compilerFlags(compilerFlags)
+	, m_shallow(false)
 {
 }
 
@@ -158,6 +123,28 @@ size_t IndexerCommandCxx::getByteSize(size_t stringSize) const
 	return size;
 }
 
+std::wstring IndexerCommandCxx::getPreprocessorContextKey() const
+{
+	// leave out the arguments that name the input and output files of the compile command
+	const std::vector<size_t> skippedIndices = getSourceFileSpecificCompilerFlagIndices();
+
+	std::wstring key = m_workingDirectory.wstr();
+	size_t skippedIndex = 0;
+	for (size_t i = 0; i < m_compilerFlags.size(); i++)
+	{
+		if (skippedIndex < skippedIndices.size() && skippedIndices[skippedIndex] == i)
+		{
+			skippedIndex++;
+		}
+		else
+		{
+			key += L' ' + m_compilerFlags[i];
+		}
+	}
+
+	return std::to_wstring(std::hash<std::wstring>()(key));
+}
+
 const std::set<FilePath>& IndexerCommandCxx::getIndexedPaths() const
 {
 	return m_indexedPaths;
@@ -178,11 +165,46 @@ const std::vector<std::wstring>& IndexerCommandCxx::getCompilerFlags() const
 	return m_compilerFlags;
 }
 
+std::vector<size_t> IndexerCommandCxx::getSourceFileSpecificCompilerFlagIndices() const
+{
+	std::vector<size_t> indices;
+	for (size_t i = 0; i < m_compilerFlags.size(); i++)
+	{
+		const std::wstring& flag = m_compilerFlags[i];
+		if (flag == L"-o" || flag == L"-MF" || flag == L"-MT" || flag == L"-MQ")
+		{
+			indices.push_back(i);
+			if (i + 1 < m_compilerFlags.size())
+			{
+				indices.push_back(++i);
+			}
+		}
+		else if (
+			flag == getSourceFilePath().wstr() ||
+			(!utility::isPrefix<std::wstring>(L"-", flag) &&
+			 FilePath(flag).fileName() == getSourceFilePath().fileName()))
+		{
+			indices.push_back(i);
+		}
+	}
+	return indices;
+}
+
 const FilePath& IndexerCommandCxx::getWorkingDirectory() const
 {
 	return m_workingDirectory;
 }
 
+bool IndexerCommandCxx::isShallow() const
+{
+	return m_shallow;
+}
+
+void IndexerCommandCxx::setShallow(bool shallow)
+{
+	m_shallow = shallow;
+}
+
 QJsonObject IndexerCommandCxx::doSerialize() const
 {
 	QJsonObject jsonObject = IndexerCommand::doSerialize();
@@ -222,6 +244,9 @@ QJsonObject IndexerCommandCxx::doSerialize() const
 		}
 		jsonObject["compiler_flags"] = compilerFlagsArray;
 	}
+	{
+		jsonObject["shallow"] = m_shallow;
+	}
 
 	return jsonObject;
 }
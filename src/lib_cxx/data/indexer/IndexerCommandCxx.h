@@ -7,20 +7,11 @@
 #include "IndexerCommand.h"
 
 class FilePath;
-namespace clang
-{
-namespace tooling
-{
-class JSONCompilationDatabase;
-}
-}	 // namespace clang
 
 class IndexerCommandCxx: public IndexerCommand
 {
 public:
 	static std::vector<FilePath> getSourceFilesFromCDB(const FilePath& cdbPath);
-	static std::vector<FilePath> getSourceFilesFromCDB(
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb, const FilePath& cdbPath);
 
 	static std::wstring getCompilerFlagLanguageStandard(const std::wstring& languageStandard);
 	static std::vector<std::wstring> getCompilerFlagsForSystemHeaderSearchPaths(
@@ -40,13 +31,20 @@ public:
 
 	IndexerCommandType getIndexerCommandType() const override;
 	size_t getByteSize(size_t stringSize) const override;
+	std::wstring getPreprocessorContextKey() const override;
 
 	const std::set<FilePath>& getIndexedPaths() const;
 	const std::set<FilePathFilter>& getExcludeFilters() const;
 	const std::set<FilePathFilter>& getIncludeFilters() const;
 	const std::vector<std::wstring>& getCompilerFlags() const;
+	// indices of the compiler flags that name the input and output files of the command
+	std::vector<size_t> getSourceFileSpecificCompilerFlagIndices() const;
 	const FilePath& getWorkingDirectory() const;
 
+	// shallow commands skip function bodies and only record what is declared outside of them
+	bool isShallow() const;
+	void setShallow(bool shallow);
+
 protected:
 	QJsonObject doSerialize() const override;
 
@@ -56,6 +54,7 @@ private:
 	std::set<FilePathFilter> m_includeFilters;
 	FilePath m_workingDirectory;
 	std::vector<std::wstring> m_compilerFlags;
+	bool m_shallow;
 };
 
 #endif	  // INDEXER_COMMAND_CXXL_H
@@ -1,20 +1,52 @@
 #include "IndexerCxx.h"
 
+#include "ApplicationSettings.h"
+#include "CxxAstVisitorProfile.h"
+#include "CxxDeclNameCache.h"
+#include "CxxFileContentCache.h"
 #include "CxxParser.h"
 #include "FileRegister.h"
 
+namespace
+{
+const size_t maxCachedDeclNameCount = 1000000;
+const size_t maxCachedFileContentByteCount = 512 * 1024 * 1024;
+}	 // namespace
+
+IndexerCxx::IndexerCxx()
+	: m_declNameCache(std::make_shared<CxxDeclNameCache>(maxCachedDeclNameCount))
+	, m_fileContentCache(CxxFileContentCache::getShared(maxCachedFileContentByteCount))
+{
+	if (ApplicationSettings::getInstance()->getCxxVisitorProfilingEnabled())
+	{
+		m_visitorProfile = std::make_shared<CxxAstVisitorProfile>();
+	}
+}
+
 void IndexerCxx::doIndex(
 	std::shared_ptr<IndexerCommandCxx> indexerCommand,
 	std::shared_ptr<ParserClientImpl> parserClient,
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo)
 {
+	std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
+		indexerCommand->getSourceFilePath(),
+		indexerCommand->getIndexedPaths(),
+		indexerCommand->getExcludeFilters());
+	fileRegister->setAlreadyIndexedFilePaths(m_indexerStateInfo->alreadyIndexedFilePaths);
+
 	CxxParser parser(
 		parserClient,
-		std::make_shared<FileRegister>(
-			indexerCommand->getSourceFilePath(),
-			indexerCommand->getIndexedPaths(),
-			indexerCommand->getExcludeFilters()),
-		m_indexerStateInfo);
+		fileRegister,
+		m_indexerStateInfo,
+		m_declNameCache,
+		m_fileContentCache,
+		m_visitorProfile);
 
 	parser.buildIndex(indexerCommand);
+
+	if (indexerCommand->isShallow())
+	{
+		// references within function bodies are missing
+		parserClient->setAllFilesIncomplete();
+	}
 }
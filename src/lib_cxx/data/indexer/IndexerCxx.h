@@ -4,13 +4,24 @@
 #include "Indexer.h"
 #include "IndexerCommandCxx.h"
 
+class CxxAstVisitorProfile;
+class CxxDeclNameCache;
+class CxxFileContentCache;
+
 class IndexerCxx: public Indexer<IndexerCommandCxx>
 {
+public:
+	IndexerCxx();
+
 private:
 	void doIndex(
 		std::shared_ptr<IndexerCommandCxx> indexerCommand,
 		std::shared_ptr<ParserClientImpl> parserClient,
 		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo) override;
+
+	std::shared_ptr<CxxDeclNameCache> m_declNameCache;	  // shared by all translation units
+	std::shared_ptr<CxxFileContentCache> m_fileContentCache;	 // shared by all indexers
+	std::shared_ptr<CxxAstVisitorProfile> m_visitorProfile;		 // null if profiling is disabled
 };
 
 #endif	  // INDEXER_CXX_H
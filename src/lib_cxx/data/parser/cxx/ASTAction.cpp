@@ -3,15 +3,22 @@
 #include <clang/Frontend/CompilerInstance.h>
 
 #include "ASTConsumer.h"
+#include "ApplicationSettings.h"
 #include "PreprocessorCallbacks.h"
 
 ASTAction::ASTAction(
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
-	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
+	std::shared_ptr<CxxDeclNameCache> declNameCache,
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	bool skipFunctionBodies,
+	std::shared_ptr<CxxAstVisitorProfile> visitorProfile)
 	: m_client(client)
 	, m_canonicalFilePathCache(canonicalFilePathCache)
+	, m_declNameCache(declNameCache)
 	, m_indexerStateInfo(indexerStateInfo)
+	, m_skipFunctionBodies(skipFunctionBodies)
+	, m_visitorProfile(visitorProfile)
 	, m_commentHandler(client, canonicalFilePathCache)
 {
 }
@@ -24,14 +31,25 @@ std::unique_ptr<clang::ASTConsumer> ASTAction::CreateASTConsumer(
 		&compiler.getPreprocessor(),
 		m_client,
 		m_canonicalFilePathCache,
-		m_indexerStateInfo));
+		m_declNameCache,
+		m_indexerStateInfo,
+		m_visitorProfile));
 }
 
 bool ASTAction::BeginSourceFileAction(clang::CompilerInstance& compiler)
 {
+	if (m_skipFunctionBodies)
+	{
+		// the parser reads this option when the action gets executed, which happens afterwards
+		compiler.getFrontendOpts().SkipFunctionBodies = true;
+	}
+
 	clang::Preprocessor& preprocessor = compiler.getPreprocessor();
 	preprocessor.addPPCallbacks(llvm::make_unique<PreprocessorCallbacks>(
 		compiler.getSourceManager(), m_client, m_canonicalFilePathCache));
-	preprocessor.addCommentHandler(&m_commentHandler);
+	if (ApplicationSettings::getInstance()->getCxxCommentRecordingEnabled())
+	{
+		preprocessor.addCommentHandler(&m_commentHandler);
+	}
 	return true;
 }
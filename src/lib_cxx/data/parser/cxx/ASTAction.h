@@ -9,6 +9,8 @@
 
 class ParserClient;
 class CanonicalFilePathCache;
+class CxxAstVisitorProfile;
+class CxxDeclNameCache;
 struct IndexerStateInfo;
 
 class ASTAction: public clang::ASTFrontendAction
@@ -17,7 +19,10 @@ public:
 	explicit ASTAction(
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
-		std::shared_ptr<IndexerStateInfo> indexerStateInfo);
+		std::shared_ptr<CxxDeclNameCache> declNameCache,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+		bool skipFunctionBodies = false,
+		std::shared_ptr<CxxAstVisitorProfile> visitorProfile = nullptr);
 
 protected:
 	std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(
@@ -27,7 +32,10 @@ protected:
 private:
 	std::shared_ptr<ParserClient> m_client;
 	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
+	std::shared_ptr<CxxDeclNameCache> m_declNameCache;
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
+	const bool m_skipFunctionBodies;
+	std::shared_ptr<CxxAstVisitorProfile> m_visitorProfile;
 	CommentHandler m_commentHandler;
 };
 
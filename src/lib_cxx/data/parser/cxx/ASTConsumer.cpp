@@ -2,30 +2,62 @@
 
 #include "ApplicationSettings.h"
 #include "CxxAstVisitor.h"
+#include "CxxParallelAstTraversal.h"
 #include "CxxVerboseAstVisitor.h"
+#include "ParserClientImpl.h"
+#include "TimeStamp.h"
 
 ASTConsumer::ASTConsumer(
 	clang::ASTContext* context,
 	clang::Preprocessor* preprocessor,
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
-	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
+	std::shared_ptr<CxxDeclNameCache> declNameCache,
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	std::shared_ptr<CxxAstVisitorProfile> visitorProfile)
+	: m_client(client)
 {
 	ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
 
 	if (appSettings->getLoggingEnabled() && appSettings->getVerboseIndexerLoggingEnabled())
 	{
 		m_visitor = std::make_shared<CxxVerboseAstVisitor>(
-			context, preprocessor, client, canonicalFilePathCache, indexerStateInfo);
+			context, preprocessor, client, canonicalFilePathCache, declNameCache, indexerStateInfo);
 	}
 	else
 	{
 		m_visitor = std::make_shared<CxxAstVisitor>(
-			context, preprocessor, client, canonicalFilePathCache, indexerStateInfo);
+			context, preprocessor, client, canonicalFilePathCache, declNameCache, indexerStateInfo);
+	}
+
+	m_visitor->setBraceRecordingEnabled(appSettings->getCxxBraceRecordingEnabled());
+	m_visitor->setProfile(visitorProfile);
+
+	// the verbose visitor logs the traversal in order
+	const int visitorThreadCount = appSettings->getCxxVisitorThreadCount();
+	std::shared_ptr<ParserClientImpl> clientImpl = std::dynamic_pointer_cast<ParserClientImpl>(
+		client);
+	if (visitorThreadCount > 1 && clientImpl &&
+		!std::dynamic_pointer_cast<CxxVerboseAstVisitor>(m_visitor))
+	{
+		m_parallelTraversal = std::make_shared<CxxParallelAstTraversal>(
+			preprocessor,
+			clientImpl,
+			canonicalFilePathCache,
+			declNameCache,
+			indexerStateInfo,
+			visitorProfile,
+			appSettings->getCxxBraceRecordingEnabled(),
+			size_t(visitorThreadCount));
 	}
 }
 
 void ASTConsumer::HandleTranslationUnit(clang::ASTContext& context)
 {
-	m_visitor->indexDecl(context.getTranslationUnitDecl());
+	const TimeStamp start = TimeStamp::now();
+	if (!m_parallelTraversal || !m_parallelTraversal->indexTranslationUnit(context))
+	{
+		m_visitor->indexDecl(context.getTranslationUnitDecl());
+	}
+	m_client->recordVisitDuration(TimeStamp::now().deltaMS(start));
 }
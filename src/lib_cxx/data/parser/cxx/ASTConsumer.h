@@ -6,6 +6,9 @@
 
 class CanonicalFilePathCache;
 class CxxAstVisitor;
+class CxxAstVisitorProfile;
+class CxxDeclNameCache;
+class CxxParallelAstTraversal;
 class ParserClient;
 struct IndexerStateInfo;
 
@@ -17,14 +20,18 @@ public:
 		clang::Preprocessor* preprocessor,
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
-		std::shared_ptr<IndexerStateInfo> indexerStateInfo);
+		std::shared_ptr<CxxDeclNameCache> declNameCache,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+		std::shared_ptr<CxxAstVisitorProfile> visitorProfile = nullptr);
 
 	virtual ~ASTConsumer() = default;
 
 	virtual void HandleTranslationUnit(clang::ASTContext& context) override;
 
 private:
+	std::shared_ptr<ParserClient> m_client;
 	std::shared_ptr<CxxAstVisitor> m_visitor;
+	std::shared_ptr<CxxParallelAstTraversal> m_parallelTraversal;	 // null if not enabled
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
 };
 
@@ -1,7 +1,10 @@
 #include "CanonicalFilePathCache.h"
 
+#include <algorithm>
+
 #include <clang/AST/ASTContext.h>
 
+#include "CxxAstContextLock.h"
 #include "utilityClang.h"
 #include "utilityString.h"
 
@@ -121,8 +124,38 @@ Id CanonicalFilePathCache::getFileSymbolId(const std::wstring& path)
 	return 0;
 }
 
+void CanonicalFilePathCache::replaceFileSymbolIds(const std::map<Id, Id>& symbolIds)
+{
+	std::map<clang::FileID, Id> fileIdSymbolIdMap;
+	std::map<Id, clang::FileID> symbolIdFileIdMap;
+	for (const auto& p: m_fileIdSymbolIdMap)
+	{
+		auto it = symbolIds.find(p.second);
+		if (it != symbolIds.end())
+		{
+			fileIdSymbolIdMap.emplace(p.first, it->second);
+			symbolIdFileIdMap.emplace(it->second, p.first);
+		}
+	}
+
+	std::unordered_map<std::wstring, Id> fileStringSymbolIdMap;
+	for (const auto& p: m_fileStringSymbolIdMap)
+	{
+		auto it = symbolIds.find(p.second);
+		if (it != symbolIds.end())
+		{
+			fileStringSymbolIdMap.emplace(p.first, it->second);
+		}
+	}
+
+	m_fileIdSymbolIdMap = std::move(fileIdSymbolIdMap);
+	m_symbolIdFileIdMap = std::move(symbolIdFileIdMap);
+	m_fileStringSymbolIdMap = std::move(fileStringSymbolIdMap);
+}
+
 std::wstring CanonicalFilePathCache::getDeclarationFileName(const clang::Decl* declaration)
 {
+	CxxAstContextLock lock;
 	const clang::SourceManager& sourceManager = declaration->getASTContext().getSourceManager();
 	const clang::FileID fileId = sourceManager.getFileID(declaration->getBeginLoc());
 	const clang::FileEntry* fileEntry = sourceManager.getFileEntryForID(fileId);
@@ -144,13 +177,45 @@ bool CanonicalFilePathCache::isProjectFile(
 		return false;
 	}
 
-	auto it = m_isProjectFileMap.find(fileId);
-	if (it != m_isProjectFileMap.end())
+	uint8_t* flags = getFileFlags(fileId);
+	if (!(*flags & FILE_PROJECT_KNOWN))
 	{
-		return it->second;
+		const bool isProjectFile = m_fileRegister->hasFilePath(
+			getCanonicalFilePath(fileId, sourceManager));
+		*flags |= FILE_PROJECT_KNOWN | (isProjectFile ? FILE_PROJECT : 0);
 	}
+	return *flags & FILE_PROJECT;
+}
 
-	bool ret = m_fileRegister->hasFilePath(getCanonicalFilePath(fileId, sourceManager));
-	m_isProjectFileMap.emplace(fileId, ret);
-	return ret;
+bool CanonicalFilePathCache::isAlreadyIndexedFile(
+	const clang::FileID& fileId, const clang::SourceManager& sourceManager)
+{
+	if (!fileId.isValid())
+	{
+		return false;
+	}
+
+	uint8_t* flags = getFileFlags(fileId);
+	if (!(*flags & FILE_ALREADY_INDEXED_KNOWN))
+	{
+		const bool isAlreadyIndexed = m_fileRegister->isAlreadyIndexed(
+			getCanonicalFilePath(fileId, sourceManager));
+		*flags |= FILE_ALREADY_INDEXED_KNOWN | (isAlreadyIndexed ? FILE_ALREADY_INDEXED : 0);
+	}
+	return *flags & FILE_ALREADY_INDEXED;
+}
+
+uint8_t* CanonicalFilePathCache::getFileFlags(const clang::FileID& fileId)
+{
+	const int id = int(fileId.getHashValue());
+	if (id < 0)
+	{
+		return &m_loadedFileFlags[fileId];
+	}
+
+	if (size_t(id) >= m_fileFlags.size())
+	{
+		m_fileFlags.resize(std::max(size_t(id) + 1, 2 * m_fileFlags.size()), 0);
+	}
+	return &m_fileFlags[id];
 }
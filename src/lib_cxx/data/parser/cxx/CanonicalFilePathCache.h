@@ -1,9 +1,11 @@
 #ifndef CANONICAL_FILE_PATH_CACHE_H
 #define CANONICAL_FILE_PATH_CACHE_H
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <clang/AST/Decl.h>
 #include <clang/Basic/SourceManager.h>
@@ -29,11 +31,27 @@ public:
 	Id getFileSymbolId(const clang::FileEntry* entry);
 	Id getFileSymbolId(const std::wstring& path);
 
+	// for a copy of the cache that records into another storage, files missing in the map are
+	// forgotten and get recorded again
+	void replaceFileSymbolIds(const std::map<Id, Id>& symbolIds);
+
 	std::wstring getDeclarationFileName(const clang::Decl* declaration);
 
 	bool isProjectFile(const clang::FileID& fileId, const clang::SourceManager& sourceManager);
+	bool isAlreadyIndexedFile(const clang::FileID& fileId, const clang::SourceManager& sourceManager);
 
 private:
+	enum FileFlag : uint8_t
+	{
+		FILE_PROJECT_KNOWN = 1 << 0,
+		FILE_PROJECT = 1 << 1,
+		FILE_ALREADY_INDEXED_KNOWN = 1 << 2,
+		FILE_ALREADY_INDEXED = 1 << 3
+	};
+
+	// FileIDs loaded from a precompiled header have negative ids and keep their flags in a map
+	uint8_t* getFileFlags(const clang::FileID& fileId);
+
 	std::shared_ptr<FileRegister> m_fileRegister;
 
 	std::map<clang::FileID, FilePath> m_fileIdMap;
@@ -43,7 +61,9 @@ private:
 	std::map<Id, clang::FileID> m_symbolIdFileIdMap;
 	std::unordered_map<std::wstring, Id> m_fileStringSymbolIdMap;
 
-	std::map<clang::FileID, bool> m_isProjectFileMap;
+	// flags of the FileIDs of the translation unit, indexed by their small positive ids
+	std::vector<uint8_t> m_fileFlags;
+	std::map<clang::FileID, uint8_t> m_loadedFileFlags;
 };
 
 #endif	  // CANONICAL_FILE_PATH_CACHE_H
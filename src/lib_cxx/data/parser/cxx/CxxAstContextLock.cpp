@@ -0,0 +1,24 @@
+#include "CxxAstContextLock.h"
+
+thread_local std::recursive_mutex* CxxAstContextLock::s_threadMutex = nullptr;
+
+void CxxAstContextLock::setThreadMutex(std::recursive_mutex* mutex)
+{
+	s_threadMutex = mutex;
+}
+
+CxxAstContextLock::CxxAstContextLock(): m_mutex(s_threadMutex)
+{
+	if (m_mutex)
+	{
+		m_mutex->lock();
+	}
+}
+
+CxxAstContextLock::~CxxAstContextLock()
+{
+	if (m_mutex)
+	{
+		m_mutex->unlock();
+	}
+}
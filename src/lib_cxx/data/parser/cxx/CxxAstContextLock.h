@@ -0,0 +1,28 @@
+#ifndef CXX_AST_CONTEXT_LOCK_H
+#define CXX_AST_CONTEXT_LOCK_H
+
+#include <mutex>
+
+// Serializes the calls into the ASTContext and its SourceManager that fill lazy caches, e.g. the
+// last looked up FileID, the line tables and the printed names, while several visitors traverse
+// the declarations of the same translation unit. Only locks on threads that got a mutex assigned,
+// so a single visitor does not pay for it.
+class CxxAstContextLock
+{
+public:
+	// the mutex is used by all locks of the calling thread, null disables locking
+	static void setThreadMutex(std::recursive_mutex* mutex);
+
+	CxxAstContextLock();
+	~CxxAstContextLock();
+
+	CxxAstContextLock(const CxxAstContextLock&) = delete;
+	CxxAstContextLock& operator=(const CxxAstContextLock&) = delete;
+
+private:
+	static thread_local std::recursive_mutex* s_threadMutex;
+
+	std::recursive_mutex* const m_mutex;
+};
+
+#endif	  // CXX_AST_CONTEXT_LOCK_H
@@ -4,6 +4,7 @@
 #include <clang/Lex/Preprocessor.h>
 
 #include "CanonicalFilePathCache.h"
+#include "CxxAstContextLock.h"
 #include "CxxDeclNameResolver.h"
 #include "CxxTypeNameResolver.h"
 #include "IndexerStateInfo.h"
@@ -18,18 +19,21 @@ CxxAstVisitor::CxxAstVisitor(
 	clang::Preprocessor* preprocessor,
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
+	std::shared_ptr<CxxDeclNameCache> declNameCache,
 	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
 	: m_astContext(astContext)
 	, m_preprocessor(preprocessor)
 	, m_client(client)
 	, m_indexerStateInfo(indexerStateInfo)
 	, m_canonicalFilePathCache(canonicalFilePathCache)
+	, m_declNameCache(declNameCache)
 	, m_contextComponent(this)
 	, m_declRefKindComponent(this)
 	, m_typeRefKindComponent(this)
 	, m_implicitCodeComponent(this)
 	, m_indexerComponent(this, astContext, client)
 	, m_braceRecorderComponent(this, astContext, client)
+	, m_braceRecordingEnabled(true)
 {
 }
 
@@ -62,10 +66,74 @@ CanonicalFilePathCache* CxxAstVisitor::getCanonicalFilePathCache() const
 	return m_canonicalFilePathCache.get();
 }
 
+CxxDeclNameCache* CxxAstVisitor::getDeclNameCache() const
+{
+	return m_declNameCache.get();
+}
+
 void CxxAstVisitor::indexDecl(clang::Decl* d)
 {
 	LOG_INFO("starting AST traversal");
 	this->TraverseDecl(d);
+	finishIndexing();
+
+	if (m_sharedProfile)
+	{
+		m_sharedProfile->add(m_profile);
+		LOG_INFO("AST visitor components: " + m_profile.toString());
+		LOG_INFO("AST visitor components of all translation units: " + m_sharedProfile->toString());
+	}
+}
+
+void CxxAstVisitor::setBraceRecordingEnabled(bool enabled)
+{
+	m_braceRecordingEnabled = enabled;
+}
+
+void CxxAstVisitor::setProfile(std::shared_ptr<CxxAstVisitorProfile> profile)
+{
+	m_sharedProfile = profile;
+}
+
+const CxxAstVisitorProfile& CxxAstVisitor::getProfile() const
+{
+	return m_profile;
+}
+
+void CxxAstVisitor::finishIndexing()
+{
+	m_indexerComponent.flushLocations();
+	reportTruncatedTemplateInstantiations();
+}
+
+void CxxAstVisitor::reportTruncatedTemplateInstantiations()
+{
+	CxxAstContextLock lock;
+	const clang::SourceManager& sourceManager = m_astContext->getSourceManager();
+	const FilePath translationUnitPath = m_canonicalFilePathCache->getCanonicalFilePath(
+		sourceManager.getMainFileID(), sourceManager);
+
+	m_implicitCodeComponent.forEachTruncatedTemplate(
+		[&](const clang::NamedDecl* templateDecl, size_t visitedCount, size_t totalCount) {
+			const ParseLocation location = getParseLocation(templateDecl->getLocation());
+			if (!location.isValid())
+			{
+				return;
+			}
+
+			LOG_INFO(
+				"Truncated instantiations of " + templateDecl->getQualifiedNameAsString() + ": " +
+				std::to_string(visitedCount) + " of " + std::to_string(totalCount) + " visited");
+
+			m_client->recordError(
+				L"Indexed only " + std::to_wstring(visitedCount) + L" of " +
+					std::to_wstring(totalCount) + L" implicit instantiations of template \"" +
+					utility::decodeFromUtf8(templateDecl->getQualifiedNameAsString()) + L"\"",
+				false,
+				true,
+				translationUnitPath,
+				location);
+		});
 }
 
 bool CxxAstVisitor::shouldVisitTemplateInstantiations() const
@@ -94,14 +162,31 @@ bool CxxAstVisitor::checkIgnoresTypeLoc(const clang::TypeLoc& tl) const
 	return true;
 }
 
+#define CALL_COMPONENT(__COMPONENT__, __PROFILE_COMPONENT__, __METHOD_CALL__)                      \
+	if (m_sharedProfile)                                                                           \
+	{                                                                                              \
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();      \
+		__COMPONENT__.__METHOD_CALL__;                                                             \
+		m_profile.addDuration(                                                                     \
+			CxxAstVisitorProfile::__PROFILE_COMPONENT__,                                           \
+			std::chrono::steady_clock::now() - start);                                             \
+	}                                                                                              \
+	else                                                                                           \
+	{                                                                                              \
+		__COMPONENT__.__METHOD_CALL__;                                                             \
+	}
+
 #define FOREACH_COMPONENT(__METHOD_CALL__)                                                         \
 	{                                                                                              \
-		m_contextComponent.__METHOD_CALL__;                                                        \
-		m_typeRefKindComponent.__METHOD_CALL__;                                                    \
-		m_declRefKindComponent.__METHOD_CALL__;                                                    \
-		m_implicitCodeComponent.__METHOD_CALL__;                                                   \
-		m_indexerComponent.__METHOD_CALL__;                                                        \
-		m_braceRecorderComponent.__METHOD_CALL__;                                                  \
+		CALL_COMPONENT(m_contextComponent, COMPONENT_CONTEXT, __METHOD_CALL__);                    \
+		CALL_COMPONENT(m_typeRefKindComponent, COMPONENT_TYPE_REF_KIND, __METHOD_CALL__);          \
+		CALL_COMPONENT(m_declRefKindComponent, COMPONENT_DECL_REF_KIND, __METHOD_CALL__);          \
+		CALL_COMPONENT(m_implicitCodeComponent, COMPONENT_IMPLICIT_CODE, __METHOD_CALL__);         \
+		CALL_COMPONENT(m_indexerComponent, COMPONENT_INDEXER, __METHOD_CALL__);                    \
+		if (m_braceRecordingEnabled)                                                               \
+		{                                                                                          \
+			CALL_COMPONENT(m_braceRecorderComponent, COMPONENT_BRACE_RECORDER, __METHOD_CALL__);   \
+		}                                                                                          \
 	}
 
 #define DEF_TRAVERSE_CUSTOM_TYPE_PTR(__NAME_TYPE__, __PARAM_TYPE__, CODE_BEFORE, CODE_AFTER)       \
@@ -142,11 +227,29 @@ bool CxxAstVisitor::checkIgnoresTypeLoc(const clang::TypeLoc& tl) const
 #define DEF_TRAVERSE_TYPE(__TYPE__, CODE_BEFORE, CODE_AFTER)                                       \
 	DEF_TRAVERSE_CUSTOM_TYPE(__TYPE__, __TYPE__, CODE_BEFORE, CODE_AFTER)
 
+void CxxAstVisitor::indexDecls(
+	clang::TranslationUnitDecl* translationUnitDecl, const std::vector<clang::Decl*>& decls)
+{
+	// the components see the same context as for the declarations of a complete traversal
+	FOREACH_COMPONENT(beginTraverseDecl(translationUnitDecl));
+	for (clang::Decl* decl: decls)
+	{
+		if (!TraverseDecl(decl))
+		{
+			break;
+		}
+	}
+	FOREACH_COMPONENT(endTraverseDecl(translationUnitDecl));
+
+	finishIndexing();
+}
+
 bool CxxAstVisitor::TraverseDecl(clang::Decl* decl)
 {
 	bool traverse = true;
 	if (decl)
 	{
+		CxxAstContextLock lock;
 		const clang::SourceManager& sourceManager = m_astContext->getSourceManager();
 		clang::SourceLocation loc = sourceManager.getExpansionLoc(decl->getLocation());
 
@@ -170,8 +273,12 @@ bool CxxAstVisitor::TraverseDecl(clang::Decl* decl)
 				m_canonicalFilePathCache->addFileSymbolId(fileId, filePath, symbolId);
 			}
 
-			traverse = isLocatedInProjectFile(loc);
+			// another translation unit already recorded everything declared in that file
+			traverse = isLocatedInProjectFile(loc) &&
+				!m_canonicalFilePathCache->isAlreadyIndexedFile(fileId, sourceManager);
 		}
+
+		traverse = traverse && m_implicitCodeComponent.shouldVisitTemplateInstantiation(decl);
 	}
 
 	if (traverse)
@@ -651,6 +758,7 @@ bool CxxAstVisitor::shouldVisitStmt(const clang::Stmt* s) const
 {
 	if (s)
 	{
+		CxxAstContextLock lock;
 		clang::SourceLocation loc = m_astContext->getSourceManager().getExpansionLoc(s->getBeginLoc());
 
 		if (loc.isInvalid())
@@ -670,6 +778,7 @@ bool CxxAstVisitor::shouldVisitDecl(const clang::Decl* decl) const
 {
 	if (decl)
 	{
+		CxxAstContextLock lock;
 		clang::SourceLocation loc = m_astContext->getSourceManager().getExpansionLoc(
 			decl->getLocation());
 
@@ -688,6 +797,7 @@ bool CxxAstVisitor::shouldVisitDecl(const clang::Decl* decl) const
 
 bool CxxAstVisitor::shouldVisitReference(const clang::SourceLocation& referenceLocation) const
 {
+	CxxAstContextLock lock;
 	clang::SourceLocation loc = m_astContext->getSourceManager().getExpansionLoc(referenceLocation);
 	if (loc.isInvalid())
 	{
@@ -709,6 +819,7 @@ bool CxxAstVisitor::isLocatedInProjectFile(clang::SourceLocation loc) const
 		return false;
 	}
 
+	CxxAstContextLock lock;
 	const clang::SourceManager& sourceManager = m_astContext->getSourceManager();
 	return m_canonicalFilePathCache->isProjectFile(sourceManager.getFileID(loc), sourceManager);
 }
@@ -2,6 +2,7 @@
 #define CXX_AST_VISITOR_H
 
 #include <memory>
+#include <vector>
 
 #include <clang/AST/RecursiveASTVisitor.h>
 
@@ -11,9 +12,11 @@
 #include "CxxAstVisitorComponentImplicitCode.h"
 #include "CxxAstVisitorComponentIndexer.h"
 #include "CxxAstVisitorComponentTypeRefKind.h"
+#include "CxxAstVisitorProfile.h"
 #include "CxxContext.h"
 
 class CanonicalFilePathCache;
+class CxxDeclNameCache;
 class ParserClient;
 class FilePath;
 
@@ -39,6 +42,7 @@ public:
 		clang::Preprocessor* preprocessor,
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
+		std::shared_ptr<CxxDeclNameCache> declNameCache,
 		std::shared_ptr<IndexerStateInfo> indexerStateInfo);
 	virtual ~CxxAstVisitor() = default;
 
@@ -46,10 +50,22 @@ public:
 	T* getComponent();
 
 	CanonicalFilePathCache* getCanonicalFilePathCache() const;
+	CxxDeclNameCache* getDeclNameCache() const;	   // may be null
 
 	// Indexing entry point
 	void indexDecl(clang::Decl* d);
 
+	// indexes a part of the top level declarations of the translation unit, the component durations
+	// are not added to the shared profile but can be taken from getProfile()
+	void indexDecls(
+		clang::TranslationUnitDecl* translationUnitDecl, const std::vector<clang::Decl*>& decls);
+
+	void setBraceRecordingEnabled(bool enabled);
+
+	// the component durations of the visited translation unit get added to the profile
+	void setProfile(std::shared_ptr<CxxAstVisitorProfile> profile);
+	const CxxAstVisitorProfile& getProfile() const;
+
 	// Visitor options
 	virtual bool shouldVisitTemplateInstantiations() const;
 	virtual bool shouldVisitImplicitCode() const;
@@ -160,11 +176,17 @@ public:
 protected:
 	typedef clang::RecursiveASTVisitor<CxxAstVisitor> Base;
 
+	void finishIndexing();
+
+	// instantiations beyond the budget of the implicit code component are shown as errors
+	void reportTruncatedTemplateInstantiations();
+
 	clang::ASTContext* m_astContext;
 	clang::Preprocessor* m_preprocessor;
 	std::shared_ptr<ParserClient> m_client;
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
 	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
+	std::shared_ptr<CxxDeclNameCache> m_declNameCache;
 
 	CxxAstVisitorComponentContext m_contextComponent;
 	CxxAstVisitorComponentDeclRefKind m_declRefKindComponent;
@@ -172,6 +194,10 @@ protected:
 	CxxAstVisitorComponentImplicitCode m_implicitCodeComponent;
 	CxxAstVisitorComponentIndexer m_indexerComponent;
 	CxxAstVisitorComponentBraceRecorder m_braceRecorderComponent;
+
+	bool m_braceRecordingEnabled;
+	std::shared_ptr<CxxAstVisitorProfile> m_sharedProfile;
+	CxxAstVisitorProfile m_profile;
 };
 
 template <>
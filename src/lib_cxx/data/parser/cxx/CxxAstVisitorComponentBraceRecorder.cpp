@@ -2,7 +2,7 @@
 
 #include <clang/Lex/Preprocessor.h>
 
-#include "CanonicalFilePathCache.h"
+#include "CxxAstContextLock.h"
 #include "CxxAstVisitor.h"
 #include "CxxAstVisitorComponentContext.h"
 #include "ParserClient.h"
@@ -24,7 +24,6 @@ void CxxAstVisitorComponentBraceRecorder::visitTagDecl(clang::TagDecl* d)
 				 clang::TSK_ImplicitInstantiation))
 		{
 			recordBraces(
-				getFilePath(d->getBraceRange().getBegin()),
 				getParseLocation(d->getBraceRange().getBegin()),
 				getParseLocation(d->getBraceRange().getEnd()));
 		}
@@ -36,7 +35,6 @@ void CxxAstVisitorComponentBraceRecorder::visitNamespaceDecl(clang::NamespaceDec
 	if (getAstVisitor()->shouldVisitDecl(d))
 	{
 		recordBraces(
-			getFilePath(d->getBeginLoc()),
 			getParseLocation(getFirstLBraceLocation(d->getBeginLoc(), d->getEndLoc())),
 			getParseLocation(getLastRBraceLocation(d->getBeginLoc(), d->getEndLoc())));
 	}
@@ -50,10 +48,7 @@ void CxxAstVisitorComponentBraceRecorder::visitCompoundStmt(clang::CompoundStmt*
 			getAstVisitor()->getComponent<CxxAstVisitorComponentContext>()->getTopmostContextDecl();
 		if (!contextDecl || !utility::isImplicit(contextDecl))
 		{
-			recordBraces(
-				getFilePath(s->getLBracLoc()),
-				getParseLocation(s->getLBracLoc()),
-				getParseLocation(s->getRBracLoc()));
+			recordBraces(getParseLocation(s->getLBracLoc()), getParseLocation(s->getRBracLoc()));
 		}
 	}
 }
@@ -69,7 +64,6 @@ void CxxAstVisitorComponentBraceRecorder::visitInitListExpr(clang::InitListExpr*
 			if (!contextDecl || !utility::isImplicit(contextDecl))
 			{
 				recordBraces(
-					getFilePath(s->getLBraceLoc()),
 					getParseLocation(s->getLBraceLoc()),
 					getParseLocation(s->getRBraceLoc()));
 			}
@@ -88,7 +82,6 @@ void CxxAstVisitorComponentBraceRecorder::visitMSAsmStmt(clang::MSAsmStmt* s)
 			if (!contextDecl || !utility::isImplicit(contextDecl))
 			{
 				recordBraces(
-					getFilePath(s->getLBraceLoc()),
 					getParseLocation(s->getLBraceLoc()),
 					getParseLocation(getLastRBraceLocation(s->getBeginLoc(), s->getEndLoc())));
 			}
@@ -101,32 +94,23 @@ ParseLocation CxxAstVisitorComponentBraceRecorder::getParseLocation(const clang:
 	return getAstVisitor()->getParseLocation(loc);
 }
 
-FilePath CxxAstVisitorComponentBraceRecorder::getFilePath(const clang::SourceLocation& loc)
-{
-	const clang::SourceManager& sm = m_astContext->getSourceManager();
-	return getAstVisitor()->getCanonicalFilePathCache()->getCanonicalFilePath(sm.getFileID(loc), sm);
-}
-
 void CxxAstVisitorComponentBraceRecorder::recordBraces(
-	const FilePath& filePath, const ParseLocation& lbraceLoc, const ParseLocation& rbraceLoc)
+	const ParseLocation& lbraceLoc, const ParseLocation& rbraceLoc)
 {
 	if (lbraceLoc.startColumnNumber != rbraceLoc.startColumnNumber ||
 		lbraceLoc.endColumnNumber != rbraceLoc.endColumnNumber ||
 		lbraceLoc.startLineNumber != rbraceLoc.startLineNumber ||
 		lbraceLoc.endLineNumber != rbraceLoc.endLineNumber)
 	{
-		std::wstring name = filePath.fileName() + L"<" + std::to_wstring(lbraceLoc.startLineNumber) +
-			L":" + std::to_wstring(lbraceLoc.startColumnNumber) + L">";
-
 		if (lbraceLoc.startColumnNumber == lbraceLoc.endColumnNumber &&
 			lbraceLoc.startLineNumber == lbraceLoc.endLineNumber)
 		{
-			m_client->recordLocalSymbol(name, lbraceLoc);
+			m_client->recordLocalSymbol(lbraceLoc, lbraceLoc);
 		}
 		if (rbraceLoc.startColumnNumber == rbraceLoc.endColumnNumber &&
 			rbraceLoc.startLineNumber == rbraceLoc.endLineNumber)
 		{
-			m_client->recordLocalSymbol(name, rbraceLoc);
+			m_client->recordLocalSymbol(lbraceLoc, rbraceLoc);
 		}
 	}
 }
@@ -134,6 +118,7 @@ void CxxAstVisitorComponentBraceRecorder::recordBraces(
 clang::SourceLocation CxxAstVisitorComponentBraceRecorder::getFirstLBraceLocation(
 	clang::SourceLocation searchStartLoc, clang::SourceLocation searchEndLoc) const
 {
+	CxxAstContextLock lock;
 	const clang::SourceManager& sm = m_astContext->getSourceManager();
 	const clang::LangOptions& opts = m_astContext->getLangOpts();
 
@@ -178,6 +163,7 @@ clang::SourceLocation CxxAstVisitorComponentBraceRecorder::getFirstLBraceLocatio
 clang::SourceLocation CxxAstVisitorComponentBraceRecorder::getLastRBraceLocation(
 	clang::SourceLocation searchStartLoc, clang::SourceLocation searchEndLoc) const
 {
+	CxxAstContextLock lock;
 	const clang::SourceManager& sm = m_astContext->getSourceManager();
 	const clang::LangOptions& opts = m_astContext->getLangOpts();
 
@@ -22,10 +22,8 @@ public:
 
 private:
 	ParseLocation getParseLocation(const clang::SourceLocation& loc) const;
-	FilePath getFilePath(const clang::SourceLocation& loc);
 
-	void recordBraces(
-		const FilePath& filePath, const ParseLocation& lbraceLoc, const ParseLocation& rbraceLoc);
+	void recordBraces(const ParseLocation& lbraceLoc, const ParseLocation& rbraceLoc);
 	clang::SourceLocation getFirstLBraceLocation(
 		clang::SourceLocation searchStartLoc, clang::SourceLocation searchEndLoc) const;
 	clang::SourceLocation getLastRBraceLocation(
@@ -1,7 +1,45 @@
 #include "CxxAstVisitorComponentImplicitCode.h"
 
+namespace
+{
+const size_t maxVisitedInstantiationsPerTemplate = 200;
+const size_t maxVisitedInstantiationsPerTranslationUnit = 50000;
+const size_t sampledInstantiationInterval = 16;
+
+// returns nullptr if the declaration is not an implicit instantiation of a template
+const clang::NamedDecl* getInstantiatedTemplate(const clang::Decl* d)
+{
+	if (const clang::ClassTemplateSpecializationDecl* classDecl =
+			clang::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(d))
+	{
+		if (classDecl->getSpecializationKind() == clang::TSK_ImplicitInstantiation)
+		{
+			return classDecl->getSpecializedTemplate();
+		}
+	}
+	else if (
+		const clang::VarTemplateSpecializationDecl* varDecl =
+			clang::dyn_cast_or_null<clang::VarTemplateSpecializationDecl>(d))
+	{
+		if (varDecl->getSpecializationKind() == clang::TSK_ImplicitInstantiation)
+		{
+			return varDecl->getSpecializedTemplate();
+		}
+	}
+	else if (
+		const clang::FunctionDecl* functionDecl = clang::dyn_cast_or_null<clang::FunctionDecl>(d))
+	{
+		if (functionDecl->getTemplateSpecializationKind() == clang::TSK_ImplicitInstantiation)
+		{
+			return functionDecl->getPrimaryTemplate();
+		}
+	}
+	return nullptr;
+}
+}	 // namespace
+
 CxxAstVisitorComponentImplicitCode::CxxAstVisitorComponentImplicitCode(CxxAstVisitor* astVisitor)
-	: CxxAstVisitorComponent(astVisitor)
+	: CxxAstVisitorComponent(astVisitor), m_visitedInstantiationCount(0)
 {
 }
 
@@ -14,6 +52,42 @@ bool CxxAstVisitorComponentImplicitCode::shouldVisitImplicitCode() const
 	return true;
 }
 
+bool CxxAstVisitorComponentImplicitCode::shouldVisitTemplateInstantiation(const clang::Decl* d)
+{
+	const clang::NamedDecl* templateDecl = getInstantiatedTemplate(d);
+	if (!templateDecl)
+	{
+		return true;
+	}
+
+	InstantiationCount& count = m_instantiationCounts[templateDecl];
+	count.totalCount++;
+
+	const bool sampled = count.totalCount % sampledInstantiationInterval == 0;
+	const bool visit = m_visitedInstantiationCount < maxVisitedInstantiationsPerTranslationUnit
+		? count.totalCount <= maxVisitedInstantiationsPerTemplate || sampled
+		: sampled && count.visitedCount < maxVisitedInstantiationsPerTemplate;
+
+	if (visit)
+	{
+		count.visitedCount++;
+		m_visitedInstantiationCount++;
+	}
+	return visit;
+}
+
+void CxxAstVisitorComponentImplicitCode::forEachTruncatedTemplate(
+	std::function<void(const clang::NamedDecl*, size_t, size_t)> callback) const
+{
+	for (const auto& p: m_instantiationCounts)
+	{
+		if (p.second.visitedCount < p.second.totalCount)
+		{
+			callback(p.first, p.second.visitedCount, p.second.totalCount);
+		}
+	}
+}
+
 void CxxAstVisitorComponentImplicitCode::beginTraverseDecl(clang::Decl* d)
 {
 	m_stack.push_back(true);
@@ -1,10 +1,14 @@
 #ifndef CXX_AST_VISITOR_COMPONENT_IMPLICIT_CODE_H
 #define CXX_AST_VISITOR_COMPONENT_IMPLICIT_CODE_H
 
+#include <functional>
+#include <unordered_map>
+
 #include "CxxAstVisitorComponent.h"
 
 // This CxxAstVisitorComponent is responsible for deciding if the AstVisitor should visit implicit
-// code in the current context.
+// code in the current context. Implicit template instantiations are visited within a budget per
+// template and per translation unit, beyond which only a sample of them gets visited.
 class CxxAstVisitorComponentImplicitCode: public CxxAstVisitorComponent
 {
 public:
@@ -12,6 +16,14 @@ public:
 
 	bool shouldVisitImplicitCode() const;
 
+	// counts the implicit instantiations of each template
+	bool shouldVisitTemplateInstantiation(const clang::Decl* d);
+
+	// calls the callback with the visited and total instantiation count of each template that was
+	// visited only partially
+	void forEachTruncatedTemplate(
+		std::function<void(const clang::NamedDecl*, size_t, size_t)> callback) const;
+
 	void beginTraverseDecl(clang::Decl* d);
 	void endTraverseDecl(clang::Decl* d);
 
@@ -19,7 +31,16 @@ public:
 	void endTraverseCXXForRangeStmt(clang::CXXForRangeStmt* s);
 
 private:
+	struct InstantiationCount
+	{
+		size_t visitedCount = 0;
+		size_t totalCount = 0;
+	};
+
 	std::vector<bool> m_stack;
+
+	std::unordered_map<const clang::NamedDecl*, InstantiationCount> m_instantiationCounts;
+	size_t m_visitedInstantiationCount;
 };
 
 #endif	  // CXX_AST_VISITOR_COMPONENT_IMPLICIT_CODE_H
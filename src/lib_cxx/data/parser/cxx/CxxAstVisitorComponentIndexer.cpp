@@ -6,19 +6,32 @@
 #include <clang/Lex/Preprocessor.h>
 
 #include "CanonicalFilePathCache.h"
+#include "CxxAstContextLock.h"
 #include "CxxAstVisitor.h"
 #include "CxxAstVisitorComponentContext.h"
 #include "CxxAstVisitorComponentDeclRefKind.h"
 #include "CxxAstVisitorComponentTypeRefKind.h"
+#include "CxxDeclNameCache.h"
 #include "CxxDeclNameResolver.h"
 #include "CxxFunctionDeclName.h"
 #include "CxxTypeNameResolver.h"
 #include "ParserClient.h"
 #include "utilityClang.h"
 
+namespace
+{
+// the AST is still empty when the indexer is created, typical translation units exceed this soon
+const size_t expectedSymbolCount = 8192;
+}	 // namespace
+
 CxxAstVisitorComponentIndexer::CxxAstVisitorComponentIndexer(
 	CxxAstVisitor* astVisitor, clang::ASTContext* astContext, std::shared_ptr<ParserClient> client)
-	: CxxAstVisitorComponent(astVisitor), m_astContext(astContext), m_client(client)
+	: CxxAstVisitorComponent(astVisitor)
+	, m_astContext(astContext)
+	, m_client(client)
+	, m_locationBuffer(client)
+	, m_declSymbolIds(expectedSymbolCount)
+	, m_typeSymbolIds(expectedSymbolCount)
 {
 }
 
@@ -38,7 +51,7 @@ void CxxAstVisitorComponentIndexer::beginTraverseNestedNameSpecifierLoc(
 	{
 		Id symbolId = getOrCreateSymbolId(loc.getNestedNameSpecifier()->getAsNamespace());
 		m_client->recordSymbolKind(symbolId, SYMBOL_NAMESPACE);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(loc.getLocalBeginLoc()), ParseLocationType::QUALIFIER);
 	}
 	break;
@@ -77,7 +90,7 @@ void CxxAstVisitorComponentIndexer::beginTraverseNestedNameSpecifierLoc(
 			{
 				const Id symbolId = getOrCreateSymbolId(recordDecl);
 				m_client->recordSymbolKind(symbolId, symbolKind);
-				m_client->recordLocation(
+				m_locationBuffer.recordLocation(
 					symbolId, getParseLocation(loc.getLocalBeginLoc()), ParseLocationType::QUALIFIER);
 			}
 		}
@@ -91,13 +104,14 @@ void CxxAstVisitorComponentIndexer::beginTraverseNestedNameSpecifierLoc(
 				clang::TemplateTypeParmDecl* d = tpt->getDecl();
 				if (d)
 				{
-					m_client->recordLocalSymbol(getLocalSymbolName(d->getLocation()), parseLocation);
+					m_client->recordLocalSymbol(getParseLocation(d->getLocation()), parseLocation);
 				}
 			}
 			else
 			{
 				const Id symbolId = getOrCreateSymbolId(type);
-				m_client->recordLocation(symbolId, parseLocation, ParseLocationType::QUALIFIER);
+				m_locationBuffer.recordLocation(
+					symbolId, parseLocation, ParseLocationType::QUALIFIER);
 			}
 		}
 	}
@@ -126,7 +140,7 @@ void CxxAstVisitorComponentIndexer::beginTraverseTemplateArgumentLoc(
 				{
 					declLocation = loc.getLocation();
 				}
-				m_client->recordLocalSymbol(getLocalSymbolName(declLocation), parseLocation);
+				m_client->recordLocalSymbol(getParseLocation(declLocation), parseLocation);
 			}
 			else
 			{
@@ -170,7 +184,7 @@ void CxxAstVisitorComponentIndexer::beginTraverseLambdaCapture(
 			if (!d->getNameAsString().empty())	  // don't record anonymous parameters
 			{
 				m_client->recordLocalSymbol(
-					getLocalSymbolName(d->getLocation()), getParseLocation(capture->getLocation()));
+					getParseLocation(d->getLocation()), getParseLocation(capture->getLocation()));
 			}
 		}
 	}
@@ -191,8 +205,8 @@ void CxxAstVisitorComponentIndexer::visitTagDecl(clang::TagDecl* d)
 
 		Id symbolId = getOrCreateSymbolId(d);
 		m_client->recordSymbolKind(symbolId, symbolKind);
-		m_client->recordLocation(symbolId, location, ParseLocationType::TOKEN);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(symbolId, location, ParseLocationType::TOKEN);
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocationOfTagDeclBody(d), ParseLocationType::SCOPE);
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(symbolId, definitionKind);
@@ -245,8 +259,8 @@ void CxxAstVisitorComponentIndexer::visitVarDecl(clang::VarDecl* d)
 		{
 			if (!d->getNameAsString().empty())	  // don't record anonymous parameters
 			{
-				m_client->recordLocalSymbol(
-					getLocalSymbolName(d->getLocation()), getParseLocation(d->getLocation()));
+				const ParseLocation location = getParseLocation(d->getLocation());
+				m_client->recordLocalSymbol(location, location);
 			}
 		}
 		else
@@ -256,7 +270,7 @@ void CxxAstVisitorComponentIndexer::visitVarDecl(clang::VarDecl* d)
 
 			Id symbolId = getOrCreateSymbolId(d);
 			m_client->recordSymbolKind(symbolId, symbolKind);
-			m_client->recordLocation(symbolId, location, ParseLocationType::TOKEN);
+			m_locationBuffer.recordLocation(symbolId, location, ParseLocationType::TOKEN);
 			m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 			m_client->recordDefinitionKind(
 				symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
@@ -307,7 +321,7 @@ void CxxAstVisitorComponentIndexer::visitFieldDecl(clang::FieldDecl* d)
 
 		Id fieldId = getOrCreateSymbolId(d);
 		m_client->recordSymbolKind(fieldId, SYMBOL_FIELD);
-		m_client->recordLocation(fieldId, location, ParseLocationType::TOKEN);
+		m_locationBuffer.recordLocation(fieldId, location, ParseLocationType::TOKEN);
 		m_client->recordAccessKind(fieldId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
 			fieldId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
@@ -341,9 +355,9 @@ void CxxAstVisitorComponentIndexer::visitFunctionDecl(clang::FunctionDecl* d)
 		Id symbolId = getOrCreateSymbolId(d);
 		m_client->recordSymbolKind(
 			symbolId, clang::isa<clang::CXXMethodDecl>(d) ? SYMBOL_METHOD : SYMBOL_FUNCTION);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getNameInfo().getSourceRange()), ParseLocationType::TOKEN);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocationOfFunctionBody(d), ParseLocationType::SCOPE);
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
@@ -351,7 +365,8 @@ void CxxAstVisitorComponentIndexer::visitFunctionDecl(clang::FunctionDecl* d)
 
 		if (d->isFirstDecl())
 		{
-			m_client->recordLocation(symbolId, getSignatureLocation(d), ParseLocationType::SIGNATURE);
+			m_locationBuffer.recordLocation(
+				symbolId, getSignatureLocation(d), ParseLocationType::SIGNATURE);
 		}
 
 		if (d->isFunctionTemplateSpecialization())
@@ -439,7 +454,7 @@ void CxxAstVisitorComponentIndexer::visitEnumConstantDecl(clang::EnumConstantDec
 	{
 		Id symbolId = getOrCreateSymbolId(d);
 		m_client->recordSymbolKind(symbolId, SYMBOL_ENUM_CONSTANT);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getLocation()), ParseLocationType::TOKEN);
 		m_client->recordDefinitionKind(
 			symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
@@ -452,9 +467,9 @@ void CxxAstVisitorComponentIndexer::visitNamespaceDecl(clang::NamespaceDecl* d)
 	{
 		Id symbolId = getOrCreateSymbolId(d);
 		m_client->recordSymbolKind(symbolId, SYMBOL_NAMESPACE);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getLocation()), ParseLocationType::TOKEN);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getSourceRange()), ParseLocationType::SCOPE);
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
@@ -468,7 +483,7 @@ void CxxAstVisitorComponentIndexer::visitNamespaceAliasDecl(clang::NamespaceAlia
 	{
 		Id symbolId = getOrCreateSymbolId(d);
 		m_client->recordSymbolKind(symbolId, SYMBOL_NAMESPACE);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getLocation()), ParseLocationType::TOKEN);
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
@@ -494,7 +509,7 @@ void CxxAstVisitorComponentIndexer::visitTypedefDecl(clang::TypedefDecl* d)
 			d->getAnonDeclWithTypedefName() == nullptr
 				? SYMBOL_TYPEDEF
 				: utility::convertTagKind(d->getAnonDeclWithTypedefName()->getTagKind()));
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getLocation()), ParseLocationType::TOKEN);
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
@@ -512,7 +527,7 @@ void CxxAstVisitorComponentIndexer::visitTypeAliasDecl(clang::TypeAliasDecl* d)
 			d->getAnonDeclWithTypedefName() == nullptr
 				? SYMBOL_TYPEDEF
 				: utility::convertTagKind(d->getAnonDeclWithTypedefName()->getTagKind()));
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(d->getLocation()), ParseLocationType::TOKEN);
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
@@ -570,8 +585,8 @@ void CxxAstVisitorComponentIndexer::visitNonTypeTemplateParmDecl(clang::NonTypeT
 	if (getAstVisitor()->shouldVisitDecl(d) &&
 		!d->getName().empty())	  // We don't create symbols for unnamed template parameters.
 	{
-		m_client->recordLocalSymbol(
-			getLocalSymbolName(d->getLocation()), getParseLocation(d->getLocation()));
+		const ParseLocation location = getParseLocation(d->getLocation());
+		m_client->recordLocalSymbol(location, location);
 	}
 }
 
@@ -580,8 +595,8 @@ void CxxAstVisitorComponentIndexer::visitTemplateTypeParmDecl(clang::TemplateTyp
 	if (getAstVisitor()->shouldVisitDecl(d) &&
 		!d->getName().empty())	  // We don't create symbols for unnamed template parameters.
 	{
-		m_client->recordLocalSymbol(
-			getLocalSymbolName(d->getLocation()), getParseLocation(d->getLocation()));
+		const ParseLocation location = getParseLocation(d->getLocation());
+		m_client->recordLocalSymbol(location, location);
 	}
 }
 
@@ -590,8 +605,8 @@ void CxxAstVisitorComponentIndexer::visitTemplateTemplateParmDecl(clang::Templat
 	if (getAstVisitor()->shouldVisitDecl(d) &&
 		!d->getName().empty())	  // We don't create symbols for unnamed template parameters.
 	{
-		m_client->recordLocalSymbol(
-			getLocalSymbolName(d->getLocation()), getParseLocation(d->getLocation()));
+		const ParseLocation location = getParseLocation(d->getLocation());
+		m_client->recordLocalSymbol(location, location);
 	}
 }
 
@@ -607,7 +622,7 @@ void CxxAstVisitorComponentIndexer::visitTypeLoc(clang::TypeLoc tl)
 			const clang::TemplateTypeParmTypeLoc& ttptl = tl.castAs<clang::TemplateTypeParmTypeLoc>();
 			clang::TemplateTypeParmDecl* d = ttptl.getDecl();
 			m_client->recordLocalSymbol(
-				getLocalSymbolName(d->getLocation()), getParseLocation(tl.getBeginLoc()));
+				getParseLocation(d->getLocation()), getParseLocation(tl.getBeginLoc()));
 		}
 		else
 		{
@@ -623,7 +638,7 @@ void CxxAstVisitorComponentIndexer::visitTypeLoc(clang::TypeLoc tl)
 				{
 					clang::TemplateDecl* d = tst->getTemplateName().getAsTemplateDecl();
 					m_client->recordLocalSymbol(
-						getLocalSymbolName(d->getLocation()), getParseLocation(tl.getBeginLoc()));
+						getParseLocation(d->getLocation()), getParseLocation(tl.getBeginLoc()));
 					return;
 				}
 			}
@@ -690,7 +705,7 @@ void CxxAstVisitorComponentIndexer::visitDeclRefExpr(clang::DeclRefExpr* s)
 			if (!utility::isImplicit(decl))
 			{
 				m_client->recordLocalSymbol(
-					getLocalSymbolName(decl->getLocation()), getParseLocation(s->getLocation()));
+					getParseLocation(decl->getLocation()), getParseLocation(s->getLocation()));
 			}
 			// else { don't do anything }
 		}
@@ -700,7 +715,7 @@ void CxxAstVisitorComponentIndexer::visitDeclRefExpr(clang::DeclRefExpr* s)
 			(clang::isa<clang::TemplateTemplateParmDecl>(decl)))
 		{
 			m_client->recordLocalSymbol(
-				getLocalSymbolName(decl->getLocation()), getParseLocation(s->getLocation()));
+				getParseLocation(decl->getLocation()), getParseLocation(s->getLocation()));
 		}
 		else
 		{
@@ -780,8 +795,11 @@ void CxxAstVisitorComponentIndexer::visitCXXConstructExpr(clang::CXXConstructExp
 		{
 			loc = s->getSourceRange().getEnd();
 		}
-		loc = clang::Lexer::GetBeginningOfToken(
-			loc, m_astContext->getSourceManager(), m_astContext->getLangOpts());
+		{
+			CxxAstContextLock lock;
+			loc = clang::Lexer::GetBeginningOfToken(
+				loc, m_astContext->getSourceManager(), m_astContext->getLangOpts());
+		}
 
 		Id symbolId = getOrCreateSymbolId(s->getConstructor());
 
@@ -807,9 +825,9 @@ void CxxAstVisitorComponentIndexer::visitLambdaExpr(clang::LambdaExpr* s)
 	{
 		Id symbolId = getOrCreateSymbolId(methodDecl);
 		m_client->recordSymbolKind(symbolId, SYMBOL_FUNCTION);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocation(s->getBeginLoc()), ParseLocationType::TOKEN);
-		m_client->recordLocation(
+		m_locationBuffer.recordLocation(
 			symbolId, getParseLocationOfFunctionBody(methodDecl), ParseLocationType::SCOPE);
 		m_client->recordDefinitionKind(
 			symbolId, utility::isImplicit(methodDecl) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
@@ -833,6 +851,11 @@ void CxxAstVisitorComponentIndexer::visitConstructorInitializer(clang::CXXCtorIn
 	}
 }
 
+void CxxAstVisitorComponentIndexer::flushLocations()
+{
+	m_locationBuffer.flush();
+}
+
 void CxxAstVisitorComponentIndexer::recordTemplateMemberSpecialization(
 	const clang::MemberSpecializationInfo* memberSpecializationInfo,
 	Id contextId,
@@ -858,6 +881,7 @@ ParseLocation CxxAstVisitorComponentIndexer::getSignatureLocation(clang::Functio
 			return ParseLocation();
 		}
 
+		CxxAstContextLock lock;
 		const clang::SourceManager& sm = m_astContext->getSourceManager();
 		const clang::LangOptions& opts = m_astContext->getLangOpts();
 
@@ -920,14 +944,6 @@ ParseLocation CxxAstVisitorComponentIndexer::getParseLocation(const clang::Sourc
 	return getAstVisitor()->getParseLocation(sourceRange);
 }
 
-std::wstring CxxAstVisitorComponentIndexer::getLocalSymbolName(const clang::SourceLocation& loc) const
-{
-	const ParseLocation location = getParseLocation(loc);
-	return getAstVisitor()->getCanonicalFilePathCache()->getCanonicalFilePath(location.fileId).fileName() +
-		L"<" + std::to_wstring(location.startLineNumber) + L":" +
-		std::to_wstring(location.startColumnNumber) + L">";
-}
-
 ReferenceKind CxxAstVisitorComponentIndexer::consumeDeclRefContextKind()
 {
 	ReferenceKind refKind = REFERENCE_UNDEFINED;
@@ -948,13 +964,26 @@ ReferenceKind CxxAstVisitorComponentIndexer::consumeDeclRefContextKind()
 
 Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* decl)
 {
-	auto it = m_declSymbolIds.find(decl);
-	if (it != m_declSymbolIds.end())
+	if (const Id* symbolId = m_declSymbolIds.find(decl))
 	{
-		return it->second;
+		return *symbolId;
 	}
 
 	NameHierarchy symbolName(L"global", NAME_DELIMITER_UNKNOWN);
+
+	// USRs and printed names query the SourceManager, the lock also guards the name cache
+	CxxAstContextLock lock;
+
+	CxxDeclNameCache* declNameCache = getAstVisitor()->getDeclNameCache();
+	std::string declNameKey;
+	const bool isCacheable = declNameCache && declNameCache->getKey(decl, &declNameKey);
+	if (isCacheable && declNameCache->getName(declNameKey, &symbolName))
+	{
+		Id symbolId = m_client->recordSymbol(symbolName);
+		m_declSymbolIds.emplace(decl, symbolId);
+		return symbolId;
+	}
+
 	if (decl)
 	{
 		std::unique_ptr<CxxDeclName> declName =
@@ -975,6 +1004,10 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* de
 					sig.getPrefix(),
 					sig.getPostfix()));
 			}
+			else if (isCacheable)
+			{
+				declNameCache->addName(declNameKey, symbolName);
+			}
 		}
 	}
 
@@ -985,15 +1018,15 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* de
 
 Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::Type* type)
 {
-	auto it = m_typeSymbolIds.find(type);
-	if (it != m_typeSymbolIds.end())
+	if (const Id* symbolId = m_typeSymbolIds.find(type))
 	{
-		return it->second;
+		return *symbolId;
 	}
 
 	NameHierarchy symbolName(L"global", NAME_DELIMITER_UNKNOWN);
 	if (type)
 	{
+		CxxAstContextLock lock;
 		std::unique_ptr<CxxTypeName> typeName =
 			CxxTypeNameResolver(getAstVisitor()->getCanonicalFilePathCache()).getName(type);
 		if (typeName)
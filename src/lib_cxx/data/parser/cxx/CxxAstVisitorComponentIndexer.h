@@ -1,10 +1,10 @@
 #ifndef CXX_AST_VISITOR_COMPONENT_INDEXER_H
 #define CXX_AST_VISITOR_COMPONENT_INDEXER_H
 
-#include <unordered_map>
-
 #include "CxxAstVisitorComponent.h"
 #include "ParseLocation.h"
+#include "ParserLocationBuffer.h"
+#include "PointerIdMap.h"
 #include "ReferenceKind.h"
 #include "SymbolKind.h"
 
@@ -51,6 +51,9 @@ public:
 
 	void visitConstructorInitializer(clang::CXXCtorInitializer* init);
 
+	// passes the buffered locations on to the client
+	void flushLocations();
+
 private:
 	void recordTemplateMemberSpecialization(
 		const clang::MemberSpecializationInfo* memberSpecializationInfo,
@@ -64,8 +67,6 @@ private:
 	ParseLocation getParseLocation(const clang::SourceLocation& loc) const;
 	ParseLocation getParseLocation(const clang::SourceRange& sourceRange) const;
 
-	std::wstring getLocalSymbolName(const clang::SourceLocation& loc) const;
-
 	ReferenceKind consumeDeclRefContextKind();
 
 	Id getOrCreateSymbolId(const clang::NamedDecl* decl);
@@ -76,9 +77,10 @@ private:
 
 	clang::ASTContext* m_astContext;
 	std::shared_ptr<ParserClient> m_client;
+	ParserLocationBuffer m_locationBuffer;
 
-	std::map<const clang::NamedDecl*, Id> m_declSymbolIds;
-	std::map<const clang::Type*, Id> m_typeSymbolIds;
+	PointerIdMap<clang::NamedDecl> m_declSymbolIds;
+	PointerIdMap<clang::Type> m_typeSymbolIds;
 };
 
 #endif	  // CXX_AST_VISITOR_COMPONENT_INDEXER_H
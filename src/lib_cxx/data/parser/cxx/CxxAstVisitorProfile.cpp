@@ -0,0 +1,63 @@
+#include "CxxAstVisitorProfile.h"
+
+const char* CxxAstVisitorProfile::getComponentName(Component component)
+{
+	switch (component)
+	{
+	case COMPONENT_CONTEXT:
+		return "context";
+	case COMPONENT_TYPE_REF_KIND:
+		return "type ref kind";
+	case COMPONENT_DECL_REF_KIND:
+		return "decl ref kind";
+	case COMPONENT_IMPLICIT_CODE:
+		return "implicit code";
+	case COMPONENT_INDEXER:
+		return "indexer";
+	case COMPONENT_BRACE_RECORDER:
+		return "brace recorder";
+	case COMPONENT_COUNT:
+		break;
+	}
+	return "";
+}
+
+CxxAstVisitorProfile::CxxAstVisitorProfile()
+{
+	for (std::chrono::steady_clock::duration& duration: m_durations)
+	{
+		duration = std::chrono::steady_clock::duration::zero();
+	}
+}
+
+void CxxAstVisitorProfile::addDuration(
+	Component component, std::chrono::steady_clock::duration duration)
+{
+	m_durations[component] += duration;
+}
+
+void CxxAstVisitorProfile::add(const CxxAstVisitorProfile& other)
+{
+	for (int i = 0; i < COMPONENT_COUNT; i++)
+	{
+		m_durations[i] += other.m_durations[i];
+	}
+}
+
+size_t CxxAstVisitorProfile::getDurationMs(Component component) const
+{
+	return size_t(
+		std::chrono::duration_cast<std::chrono::milliseconds>(m_durations[component]).count());
+}
+
+std::string CxxAstVisitorProfile::toString() const
+{
+	std::string str;
+	for (int i = 0; i < COMPONENT_COUNT; i++)
+	{
+		const Component component = Component(i);
+		str += std::string(i ? ", " : "") + getComponentName(component) + " " +
+			std::to_string(getDurationMs(component)) + " ms";
+	}
+	return str;
+}
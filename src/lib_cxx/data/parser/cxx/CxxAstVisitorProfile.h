@@ -0,0 +1,38 @@
+#ifndef CXX_AST_VISITOR_PROFILE_H
+#define CXX_AST_VISITOR_PROFILE_H
+
+#include <chrono>
+#include <string>
+
+// Time the CxxAstVisitor spent within each of its components. The indexer owns a profile that sums
+// up the profiles of all translation units it visited.
+class CxxAstVisitorProfile
+{
+public:
+	enum Component
+	{
+		COMPONENT_CONTEXT = 0,
+		COMPONENT_TYPE_REF_KIND,
+		COMPONENT_DECL_REF_KIND,
+		COMPONENT_IMPLICIT_CODE,
+		COMPONENT_INDEXER,
+		COMPONENT_BRACE_RECORDER,
+		COMPONENT_COUNT
+	};
+
+	static const char* getComponentName(Component component);
+
+	CxxAstVisitorProfile();
+
+	void addDuration(Component component, std::chrono::steady_clock::duration duration);
+	void add(const CxxAstVisitorProfile& other);
+
+	size_t getDurationMs(Component component) const;
+
+	std::string toString() const;
+
+private:
+	std::chrono::steady_clock::duration m_durations[COMPONENT_COUNT];
+};
+
+#endif	  // CXX_AST_VISITOR_PROFILE_H
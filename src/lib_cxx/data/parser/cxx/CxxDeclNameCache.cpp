@@ -0,0 +1,74 @@
+#include "CxxDeclNameCache.h"
+
+#include <clang/AST/DeclCXX.h>
+#include <clang/Index/USRGeneration.h>
+#include <llvm/ADT/SmallString.h>
+
+CxxDeclNameCache::CxxDeclNameCache(size_t maxSize)
+	: m_maxSize(maxSize), m_hitCount(0), m_missCount(0)
+{
+}
+
+bool CxxDeclNameCache::getKey(const clang::NamedDecl* decl, std::string* key) const
+{
+	// names of local, internal and anonymous symbols contain the translation unit or location
+	if (!decl || !decl->isExternallyVisible() || decl->getParentFunctionOrMethod())
+	{
+		return false;
+	}
+
+	if (const clang::CXXRecordDecl* recordDecl = clang::dyn_cast<clang::CXXRecordDecl>(decl))
+	{
+		if (recordDecl->isLambda())
+		{
+			return false;
+		}
+	}
+
+	llvm::SmallString<128> usr;
+	if (clang::index::generateUSRForDecl(decl, usr))
+	{
+		return false;
+	}
+
+	*key = usr.str().str();
+	return true;
+}
+
+bool CxxDeclNameCache::getName(const std::string& key, NameHierarchy* name)
+{
+	auto it = m_names.find(key);
+	if (it == m_names.end())
+	{
+		m_missCount++;
+		return false;
+	}
+
+	m_hitCount++;
+	*name = it->second;
+	return true;
+}
+
+void CxxDeclNameCache::addName(const std::string& key, const NameHierarchy& name)
+{
+	// names that are needed most are found early, so a full cache just keeps what it has
+	if (m_names.size() < m_maxSize)
+	{
+		m_names.emplace(key, name);
+	}
+}
+
+size_t CxxDeclNameCache::getSize() const
+{
+	return m_names.size();
+}
+
+size_t CxxDeclNameCache::getHitCount() const
+{
+	return m_hitCount;
+}
+
+size_t CxxDeclNameCache::getMissCount() const
+{
+	return m_missCount;
+}
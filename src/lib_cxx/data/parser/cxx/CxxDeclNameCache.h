@@ -0,0 +1,37 @@
+#ifndef CXX_DECL_NAME_CACHE_H
+#define CXX_DECL_NAME_CACHE_H
+
+#include <string>
+#include <unordered_map>
+
+#include <clang/AST/Decl.h>
+
+#include "NameHierarchy.h"
+
+// Symbol names of declarations that are visible across translation units, keyed by their USR. The
+// cache is owned by the indexer and outlives the parsing of a single translation unit, so each name
+// within the shared headers gets resolved only once per indexer process.
+class CxxDeclNameCache
+{
+public:
+	CxxDeclNameCache(size_t maxSize);
+
+	// returns false for declarations whose name may differ between translation units
+	bool getKey(const clang::NamedDecl* decl, std::string* key) const;
+
+	bool getName(const std::string& key, NameHierarchy* name);
+	void addName(const std::string& key, const NameHierarchy& name);
+
+	size_t getSize() const;
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+private:
+	const size_t m_maxSize;
+
+	std::unordered_map<std::string, NameHierarchy> m_names;
+	size_t m_hitCount;
+	size_t m_missCount;
+};
+
+#endif	  // CXX_DECL_NAME_CACHE_H
@@ -4,21 +4,28 @@
 #include <clang/Tooling/Tooling.h>
 
 #include "CanonicalFilePathCache.h"
+#include "IndexerStateInfo.h"
 #include "ParseLocation.h"
 #include "ParserClient.h"
 #include "utilityClang.h"
 #include "utilityString.h"
 
+// budget of the non-fatal errors of a translation unit, fatal ones make all of its files incomplete
+// and are always recorded
+const size_t CxxDiagnosticConsumer::s_maxErrorCount = 1000;
+
 CxxDiagnosticConsumer::CxxDiagnosticConsumer(
 	clang::raw_ostream& os,
 	clang::DiagnosticOptions* diags,
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
 	const FilePath& sourceFilePath,
-	bool useLogging)
+	bool useLogging,
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
 	: clang::TextDiagnosticPrinter(os, diags)
 	, m_client(client)
 	, m_canonicalFilePathCache(canonicalFilePathCache)
+	, m_indexerStateInfo(indexerStateInfo)
 	, m_sourceFilePath(sourceFilePath)
 	, m_useLogging(useLogging)
 {
@@ -114,14 +121,44 @@ void CxxDiagnosticConsumer::HandleDiagnostic(
 			columnNumber = 1;
 		}
 
-		if (fileId != 0)
+		if (fileId == 0)
 		{
-			m_client->recordError(
-				utility::decodeFromUtf8(message),
-				level == clang::DiagnosticsEngine::Fatal,
-				m_canonicalFilePathCache->getFileRegister()->hasFilePath(filePath),
-				m_sourceFilePath,
-				ParseLocation(fileId, lineNumber, columnNumber));
+			return;
+		}
+
+		const bool fatal = level == clang::DiagnosticsEngine::Fatal;
+		if (!fatal)
+		{
+			if (m_errorCount >= s_maxErrorCount)
+			{
+				m_skippedErrorCount++;
+				m_client->recordIncompleteFile(fileId);
+				return;
+			}
+			m_errorCount++;
+
+			// errors in headers repeat for every translation unit that includes them
+			if (m_indexerStateInfo && m_indexerStateInfo->claimError &&
+				!m_indexerStateInfo->claimError(
+					message + '|' + utility::encodeToUtf8(filePath.wstr()) + ':' +
+						std::to_string(lineNumber) + ':' + std::to_string(columnNumber),
+					m_sourceFilePath))
+			{
+				m_client->recordIncompleteFile(fileId);
+				return;
+			}
 		}
+
+		m_client->recordError(
+			utility::decodeFromUtf8(message),
+			fatal,
+			m_canonicalFilePathCache->getFileRegister()->hasFilePath(filePath),
+			m_sourceFilePath,
+			ParseLocation(fileId, lineNumber, columnNumber));
 	}
 }
+
+size_t CxxDiagnosticConsumer::getSkippedErrorCount() const
+{
+	return m_skippedErrorCount;
+}
@@ -6,6 +6,7 @@
 
 class CanonicalFilePathCache;
 class ParserClient;
+struct IndexerStateInfo;
 
 class CxxDiagnosticConsumer: public clang::TextDiagnosticPrinter
 {
@@ -16,7 +17,8 @@ public:
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
 		const FilePath& sourceFilePath,
-		bool useLogging = true);
+		bool useLogging = true,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo = nullptr);
 
 	void BeginSourceFile(
 		const clang::LangOptions& langOptions, const clang::Preprocessor* preProcessor) override;
@@ -24,12 +26,21 @@ public:
 
 	void HandleDiagnostic(clang::DiagnosticsEngine::Level level, const clang::Diagnostic& info) override;
 
+	// errors that were not recorded because the translation unit exceeded its error budget
+	size_t getSkippedErrorCount() const;
+
 private:
+	static const size_t s_maxErrorCount;
+
 	std::shared_ptr<ParserClient> m_client;
 	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
 
 	const FilePath m_sourceFilePath;
 	bool m_useLogging;
+
+	size_t m_errorCount = 0;
+	size_t m_skippedErrorCount = 0;
 };
 
 #endif	  // CXX_DIAGNOSTIC_CONSUMER
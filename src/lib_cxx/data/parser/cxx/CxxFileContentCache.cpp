@@ -0,0 +1,242 @@
+#include "CxxFileContentCache.h"
+
+#include <llvm/ADT/SmallString.h>
+
+namespace
+{
+// memory buffer referencing cached content, which stays alive for as long as clang uses it
+class CachedMemoryBuffer: public llvm::MemoryBuffer
+{
+public:
+	CachedMemoryBuffer(std::shared_ptr<const llvm::MemoryBuffer> content, const std::string& name)
+		: m_content(content), m_name(name)
+	{
+		init(content->getBufferStart(), content->getBufferEnd(), false);
+	}
+
+	llvm::StringRef getBufferIdentifier() const override
+	{
+		return m_name;
+	}
+
+	BufferKind getBufferKind() const override
+	{
+		return MemoryBuffer_Malloc;
+	}
+
+private:
+	std::shared_ptr<const llvm::MemoryBuffer> m_content;
+	const std::string m_name;
+};
+
+class CachedFile: public llvm::vfs::File
+{
+public:
+	CachedFile(const llvm::vfs::Status& status, std::shared_ptr<const llvm::MemoryBuffer> content)
+		: m_status(status), m_content(content)
+	{
+	}
+
+	llvm::ErrorOr<llvm::vfs::Status> status() override
+	{
+		return m_status;
+	}
+
+	llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> getBuffer(
+		const llvm::Twine& name,
+		int64_t fileSize,
+		bool requiresNullTerminator,
+		bool isVolatile) override
+	{
+		return std::unique_ptr<llvm::MemoryBuffer>(new CachedMemoryBuffer(m_content, name.str()));
+	}
+
+	std::error_code close() override
+	{
+		return std::error_code();
+	}
+
+private:
+	const llvm::vfs::Status m_status;
+	std::shared_ptr<const llvm::MemoryBuffer> m_content;
+};
+
+class CachedFileSystem: public llvm::vfs::ProxyFileSystem
+{
+public:
+	CachedFileSystem(
+		llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlyingFileSystem,
+		std::shared_ptr<CxxFileContentCache> cache)
+		: ProxyFileSystem(underlyingFileSystem), m_cache(cache)
+	{
+	}
+
+	llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine& path) override
+	{
+		const std::string key = getKey(path);
+
+		llvm::ErrorOr<llvm::vfs::Status> status = std::make_error_code(
+			std::errc::no_such_file_or_directory);
+		if (!m_cache->getStatus(key, &status))
+		{
+			status = getUnderlyingFS().status(key);
+			m_cache->addStatus(key, status);
+		}
+
+		if (!status)
+		{
+			return status;
+		}
+
+		// clang expects the status to carry the path it asked for
+		return llvm::vfs::Status::copyWithNewName(*status, path);
+	}
+
+	llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(
+		const llvm::Twine& path) override
+	{
+		const std::string key = getKey(path);
+
+		llvm::ErrorOr<llvm::vfs::Status> status = this->status(path);
+		if (!status)
+		{
+			return status.getError();
+		}
+
+		std::shared_ptr<const llvm::MemoryBuffer> content = m_cache->getContent(key);
+		if (!content)
+		{
+			if (status->getType() != llvm::sys::fs::file_type::regular_file)
+			{
+				return getUnderlyingFS().openFileForRead(path);
+			}
+
+			llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> file =
+				getUnderlyingFS().openFileForRead(key);
+			if (!file)
+			{
+				return file;
+			}
+
+			llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer = (*file)->getBuffer(key);
+			if (!buffer)
+			{
+				return buffer.getError();
+			}
+
+			content = m_cache->addContent(key, std::move(*buffer));
+		}
+
+		return std::unique_ptr<llvm::vfs::File>(new CachedFile(*status, content));
+	}
+
+private:
+	std::string getKey(const llvm::Twine& path) const
+	{
+		llvm::SmallString<256> absolutePath;
+		path.toVector(absolutePath);
+		makeAbsolute(absolutePath);
+		return absolutePath.str().str();
+	}
+
+	std::shared_ptr<CxxFileContentCache> m_cache;
+};
+}	 // namespace
+
+std::mutex CxxFileContentCache::s_sharedMutex;
+std::weak_ptr<CxxFileContentCache> CxxFileContentCache::s_shared;
+
+std::shared_ptr<CxxFileContentCache> CxxFileContentCache::getShared(size_t maxByteCount)
+{
+	std::lock_guard<std::mutex> lock(s_sharedMutex);
+
+	std::shared_ptr<CxxFileContentCache> cache = s_shared.lock();
+	if (!cache)
+	{
+		cache = std::make_shared<CxxFileContentCache>(maxByteCount);
+		s_shared = cache;
+	}
+	return cache;
+}
+
+CxxFileContentCache::CxxFileContentCache(size_t maxByteCount)
+	: m_maxByteCount(maxByteCount), m_byteCount(0), m_hitCount(0), m_missCount(0)
+{
+}
+
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> CxxFileContentCache::createFileSystem(
+	llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlyingFileSystem)
+{
+	return new CachedFileSystem(underlyingFileSystem, shared_from_this());
+}
+
+bool CxxFileContentCache::getStatus(
+	const std::string& path, llvm::ErrorOr<llvm::vfs::Status>* status)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_statuses.find(path);
+	if (it == m_statuses.end())
+	{
+		m_missCount++;
+		return false;
+	}
+
+	m_hitCount++;
+	*status = it->second;
+	return true;
+}
+
+void CxxFileContentCache::addStatus(
+	const std::string& path, const llvm::ErrorOr<llvm::vfs::Status>& status)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statuses.emplace(path, status);
+}
+
+std::shared_ptr<const llvm::MemoryBuffer> CxxFileContentCache::getContent(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_contents.find(path);
+	return it != m_contents.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const llvm::MemoryBuffer> CxxFileContentCache::addContent(
+	const std::string& path, std::unique_ptr<llvm::MemoryBuffer> content)
+{
+	std::shared_ptr<const llvm::MemoryBuffer> sharedContent(std::move(content));
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_contents.find(path);
+	if (it != m_contents.end())
+	{
+		return it->second;
+	}
+
+	if (m_byteCount + sharedContent->getBufferSize() <= m_maxByteCount)
+	{
+		m_byteCount += sharedContent->getBufferSize();
+		m_contents.emplace(path, sharedContent);
+	}
+	return sharedContent;
+}
+
+size_t CxxFileContentCache::getByteCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_byteCount;
+}
+
+size_t CxxFileContentCache::getHitCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_hitCount;
+}
+
+size_t CxxFileContentCache::getMissCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_missCount;
+}
@@ -0,0 +1,59 @@
+#ifndef CXX_FILE_CONTENT_CACHE_H
+#define CXX_FILE_CONTENT_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/VirtualFileSystem.h>
+
+// Status and contents of the files clang looked up while indexing, keyed by their absolute path.
+// The cache is shared by all indexers of a process and outlives the parsing of a single translation
+// unit, so each header gets stat'ed and read from disk only once per indexing run. Files are not
+// expected to change during indexing, so entries are never invalidated.
+class CxxFileContentCache: public std::enable_shared_from_this<CxxFileContentCache>
+{
+public:
+	// all callers share the same cache until the last of them releases it
+	static std::shared_ptr<CxxFileContentCache> getShared(size_t maxByteCount);
+
+	CxxFileContentCache(size_t maxByteCount);
+
+	// file system for a single clang tool run that reads through the cache, which has to be owned
+	// by a shared_ptr
+	llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> createFileSystem(
+		llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlyingFileSystem);
+
+	// returns false if the status of the path is unknown
+	bool getStatus(const std::string& path, llvm::ErrorOr<llvm::vfs::Status>* status);
+	void addStatus(const std::string& path, const llvm::ErrorOr<llvm::vfs::Status>& status);
+
+	// returns nullptr if the content of the path is unknown
+	std::shared_ptr<const llvm::MemoryBuffer> getContent(const std::string& path);
+
+	// keeps the content of a path that was added before and drops content beyond the byte limit
+	std::shared_ptr<const llvm::MemoryBuffer> addContent(
+		const std::string& path, std::unique_ptr<llvm::MemoryBuffer> content);
+
+	size_t getByteCount() const;
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+private:
+	static std::mutex s_sharedMutex;
+	static std::weak_ptr<CxxFileContentCache> s_shared;
+
+	const size_t m_maxByteCount;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, llvm::ErrorOr<llvm::vfs::Status>> m_statuses;
+	std::unordered_map<std::string, std::shared_ptr<const llvm::MemoryBuffer>> m_contents;
+	size_t m_byteCount;
+	size_t m_hitCount;
+	size_t m_missCount;
+};
+
+#endif	  // CXX_FILE_CONTENT_CACHE_H
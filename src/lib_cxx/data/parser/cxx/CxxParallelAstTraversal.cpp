@@ -0,0 +1,194 @@
+#include "CxxParallelAstTraversal.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include "CanonicalFilePathCache.h"
+#include "CxxAstContextLock.h"
+#include "CxxAstVisitor.h"
+#include "CxxAstVisitorProfile.h"
+#include "FilePath.h"
+#include "IntermediateStorage.h"
+#include "ParserClientImpl.h"
+#include "TaskManager.h"
+#include "ThreadPool.h"
+#include "logging.h"
+
+namespace
+{
+// below this the setup and the merge of the storages take longer than the split saves
+const size_t minPartSourceSize = 256 * 1024;
+
+size_t getSourceSize(const clang::Decl* decl, const clang::SourceManager& sourceManager)
+{
+	const clang::SourceLocation beginLoc = sourceManager.getExpansionLoc(decl->getBeginLoc());
+	const clang::SourceLocation endLoc = sourceManager.getExpansionLoc(decl->getEndLoc());
+	if (beginLoc.isInvalid() || endLoc.isInvalid() ||
+		sourceManager.getFileID(beginLoc) != sourceManager.getFileID(endLoc))
+	{
+		return 1;
+	}
+
+	const unsigned int beginOffset = sourceManager.getFileOffset(beginLoc);
+	const unsigned int endOffset = sourceManager.getFileOffset(endLoc);
+	return endOffset > beginOffset ? endOffset - beginOffset + 1 : 1;
+}
+}	 // namespace
+
+CxxParallelAstTraversal::CxxParallelAstTraversal(
+	clang::Preprocessor* preprocessor,
+	std::shared_ptr<ParserClientImpl> client,
+	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
+	std::shared_ptr<CxxDeclNameCache> declNameCache,
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	std::shared_ptr<CxxAstVisitorProfile> visitorProfile,
+	bool braceRecordingEnabled,
+	size_t threadCount)
+	: m_preprocessor(preprocessor)
+	, m_client(client)
+	, m_canonicalFilePathCache(canonicalFilePathCache)
+	, m_declNameCache(declNameCache)
+	, m_indexerStateInfo(indexerStateInfo)
+	, m_visitorProfile(visitorProfile)
+	, m_braceRecordingEnabled(braceRecordingEnabled)
+	, m_threadCount(threadCount)
+{
+}
+
+bool CxxParallelAstTraversal::indexTranslationUnit(clang::ASTContext& context)
+{
+	// declarations of precompiled headers and modules get deserialized lazily while visiting
+	if (context.getExternalSource())
+	{
+		return false;
+	}
+
+	const std::vector<std::vector<clang::Decl*>> parts = splitDecls(context);
+	if (parts.size() < 2)
+	{
+		return false;
+	}
+
+	LOG_INFO("starting AST traversal on " + std::to_string(parts.size()) + " threads");
+
+	IntermediateStorage* storage = m_client->getStorage();
+
+	std::vector<std::shared_ptr<IntermediateStorage>> partStorages;
+	std::vector<std::shared_ptr<CxxAstVisitor>> visitors;
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		std::shared_ptr<IntermediateStorage> partStorage = std::make_shared<IntermediateStorage>();
+		std::shared_ptr<ParserClientImpl> partClient = std::make_shared<ParserClientImpl>(
+			partStorage.get());
+
+		// the locations of the visitor refer to the files by the ids of its own storage
+		std::map<Id, Id> fileIds;
+		for (const StorageFile& file: storage->getStorageFiles())
+		{
+			const Id fileId = partClient->recordFile(FilePath(file.filePath), file.indexed);
+			if (!file.languageIdentifier.empty())
+			{
+				partClient->recordFileLanguage(fileId, file.languageIdentifier);
+			}
+			fileIds.emplace(file.id, fileId);
+		}
+
+		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
+			std::make_shared<CanonicalFilePathCache>(*m_canonicalFilePathCache);
+		canonicalFilePathCache->replaceFileSymbolIds(fileIds);
+
+		std::shared_ptr<CxxAstVisitor> visitor = std::make_shared<CxxAstVisitor>(
+			&context,
+			m_preprocessor,
+			partClient,
+			canonicalFilePathCache,
+			m_declNameCache,
+			m_indexerStateInfo);
+		visitor->setBraceRecordingEnabled(m_braceRecordingEnabled);
+		visitor->setProfile(m_visitorProfile);
+
+		partStorages.push_back(partStorage);
+		visitors.push_back(visitor);
+	}
+
+	std::recursive_mutex contextMutex;
+	TaskManager::getThreadPool()->parallelFor(
+		parts.size(),
+		[&](size_t i) {
+			CxxAstContextLock::setThreadMutex(&contextMutex);
+			visitors[i]->indexDecls(context.getTranslationUnitDecl(), parts[i]);
+			CxxAstContextLock::setThreadMutex(nullptr);
+		},
+		ThreadPool::PRIORITY_INDEXING);
+
+	for (const std::shared_ptr<IntermediateStorage>& partStorage: partStorages)
+	{
+		storage->inject(partStorage.get());
+	}
+
+	if (m_visitorProfile)
+	{
+		CxxAstVisitorProfile profile;
+		for (const std::shared_ptr<CxxAstVisitor>& visitor: visitors)
+		{
+			profile.add(visitor->getProfile());
+		}
+		m_visitorProfile->add(profile);
+		LOG_INFO("AST visitor components: " + profile.toString());
+		LOG_INFO("AST visitor components of all translation units: " + m_visitorProfile->toString());
+	}
+
+	return true;
+}
+
+std::vector<std::vector<clang::Decl*>> CxxParallelAstTraversal::splitDecls(
+	clang::ASTContext& context) const
+{
+	const clang::SourceManager& sourceManager = context.getSourceManager();
+
+	std::vector<clang::Decl*> decls;
+	std::vector<size_t> sourceSizes;
+	size_t totalSourceSize = 0;
+	for (clang::Decl* decl: context.getTranslationUnitDecl()->decls())
+	{
+		// BlockDecls and CapturedDecls are traversed through BlockExprs and CapturedStmts
+		if (!llvm::isa<clang::BlockDecl>(decl) && !llvm::isa<clang::CapturedDecl>(decl))
+		{
+			decls.push_back(decl);
+			sourceSizes.push_back(getSourceSize(decl, sourceManager));
+			totalSourceSize += sourceSizes.back();
+		}
+	}
+
+	const size_t partCount = std::min(
+		std::min(m_threadCount, decls.size()), totalSourceSize / minPartSourceSize);
+
+	std::vector<std::vector<clang::Decl*>> parts;
+	if (partCount < 2)
+	{
+		return parts;
+	}
+
+	parts.resize(partCount);
+	size_t sourceSize = 0;
+	for (size_t i = 0; i < decls.size(); i++)
+	{
+		const size_t partIndex = std::min(partCount - 1, sourceSize * partCount / totalSourceSize);
+		parts[partIndex].push_back(decls[i]);
+		sourceSize += sourceSizes[i];
+	}
+
+	// declarations larger than a part leave the following parts empty
+	parts.erase(
+		std::remove_if(
+			parts.begin(),
+			parts.end(),
+			[](const std::vector<clang::Decl*>& part) { return part.empty(); }),
+		parts.end());
+	if (parts.size() < 2)
+	{
+		parts.clear();
+	}
+	return parts;
+}
@@ -0,0 +1,50 @@
+#ifndef CXX_PARALLEL_AST_TRAVERSAL_H
+#define CXX_PARALLEL_AST_TRAVERSAL_H
+
+#include <memory>
+#include <vector>
+
+#include <clang/AST/ASTContext.h>
+
+class CanonicalFilePathCache;
+class CxxAstVisitorProfile;
+class CxxDeclNameCache;
+class ParserClientImpl;
+struct IndexerStateInfo;
+
+// Splits the top level declarations of a large translation unit into contiguous parts of similar
+// source size and visits each part on its own thread. Each visitor records into a storage of its
+// own that starts out with the files recorded by the preprocessor, and the storages get injected
+// into the storage of the translation unit in the order of their parts afterwards. The visitors
+// share the read only AST, calls that fill lazy caches of the ASTContext are serialized by the
+// CxxAstContextLock.
+class CxxParallelAstTraversal
+{
+public:
+	CxxParallelAstTraversal(
+		clang::Preprocessor* preprocessor,
+		std::shared_ptr<ParserClientImpl> client,
+		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
+		std::shared_ptr<CxxDeclNameCache> declNameCache,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+		std::shared_ptr<CxxAstVisitorProfile> visitorProfile,
+		bool braceRecordingEnabled,
+		size_t threadCount);
+
+	// returns false without visiting anything if the translation unit is too small to be split
+	bool indexTranslationUnit(clang::ASTContext& context);
+
+private:
+	std::vector<std::vector<clang::Decl*>> splitDecls(clang::ASTContext& context) const;
+
+	clang::Preprocessor* m_preprocessor;
+	std::shared_ptr<ParserClientImpl> m_client;
+	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
+	std::shared_ptr<CxxDeclNameCache> m_declNameCache;
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
+	std::shared_ptr<CxxAstVisitorProfile> m_visitorProfile;
+	const bool m_braceRecordingEnabled;
+	const size_t m_threadCount;
+};
+
+#endif	  // CXX_PARALLEL_AST_TRAVERSAL_H
@@ -14,7 +14,9 @@
 #include "CanonicalFilePathCache.h"
 #include "ClangInvocationInfo.h"
 #include "CxxCompilationDatabaseSingle.h"
+#include "CxxDeclNameCache.h"
 #include "CxxDiagnosticConsumer.h"
+#include "CxxFileContentCache.h"
 #include "FilePath.h"
 #include "FileRegister.h"
 #include "IndexerCommandCxx.h"
@@ -121,8 +123,16 @@ void CxxParser::initializeLLVM()
 CxxParser::CxxParser(
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<FileRegister> fileRegister,
-	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
-	: Parser(client), m_fileRegister(fileRegister), m_indexerStateInfo(indexerStateInfo)
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	std::shared_ptr<CxxDeclNameCache> declNameCache,
+	std::shared_ptr<CxxFileContentCache> fileContentCache,
+	std::shared_ptr<CxxAstVisitorProfile> visitorProfile)
+	: Parser(client)
+	, m_fileRegister(fileRegister)
+	, m_indexerStateInfo(indexerStateInfo)
+	, m_declNameCache(declNameCache)
+	, m_fileContentCache(fileContentCache)
+	, m_visitorProfile(visitorProfile)
 {
 	llvm::InitializeNativeTarget();
 	llvm::InitializeNativeTargetAsmParser();
@@ -142,7 +152,8 @@ void CxxParser::buildIndex(std::shared_ptr<IndexerCommandCxx> indexerCommand)
 	compileCommand.CommandLine = prependSyntaxOnlyToolArgs(compileCommand.CommandLine);
 
 	CxxCompilationDatabaseSingle compilationDatabase(compileCommand);
-	runTool(&compilationDatabase, indexerCommand->getSourceFilePath());
+	runTool(
+		&compilationDatabase, indexerCommand->getSourceFilePath(), indexerCommand->isShallow());
 }
 
 void CxxParser::buildIndex(
@@ -156,7 +167,7 @@ void CxxParser::buildIndex(
 	std::shared_ptr<CxxDiagnosticConsumer> diagnostics = getDiagnostics(
 		FilePath(), canonicalFilePathCache, false);
 	clang::ASTFrontendAction* action = new ASTAction(
-		m_client, canonicalFilePathCache, m_indexerStateInfo);
+		m_client, canonicalFilePathCache, m_declNameCache, m_indexerStateInfo);
 
 	std::vector<std::string> args = getCommandlineArgumentsEssential(compilerFlags);
 
@@ -165,13 +176,24 @@ void CxxParser::buildIndex(
 }
 
 void CxxParser::runTool(
-	clang::tooling::CompilationDatabase* compilationDatabase, const FilePath& sourceFilePath)
+	clang::tooling::CompilationDatabase* compilationDatabase,
+	const FilePath& sourceFilePath,
+	bool skipFunctionBodies)
 {
 	initializeLLVM();
 
+	llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fileSystem = llvm::vfs::getRealFileSystem();
+	if (m_fileContentCache)
+	{
+		// headers shared by many translation units don't get stat'ed and read again each time
+		fileSystem = m_fileContentCache->createFileSystem(fileSystem);
+	}
+
 	clang::tooling::ClangTool tool(
 		*compilationDatabase,
-		std::vector<std::string>(1, utility::encodeToUtf8(sourceFilePath.wstr())));
+		std::vector<std::string>(1, utility::encodeToUtf8(sourceFilePath.wstr())),
+		std::make_shared<clang::PCHContainerOperations>(),
+		fileSystem);
 
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
 		std::make_shared<CanonicalFilePathCache>(m_fileRegister);
@@ -198,10 +220,43 @@ void CxxParser::runTool(
 		}
 	}
 
+	if (skipFunctionBodies)
+	{
+		LOG_INFO("Skipping function bodies for shallow indexing");
+	}
+
 	clang::ASTFrontendAction* action = new ASTAction(
-		m_client, canonicalFilePathCache, m_indexerStateInfo);
+		m_client,
+		canonicalFilePathCache,
+		m_declNameCache,
+		m_indexerStateInfo,
+		skipFunctionBodies,
+		m_visitorProfile);
 	tool.run(new SingleFrontendActionFactory(action));
 
+	if (diagnostics->getSkippedErrorCount())
+	{
+		LOG_INFO(
+			"Skipped " + std::to_string(diagnostics->getSkippedErrorCount()) +
+			" errors after recording the first ones of the translation unit");
+	}
+
+	if (m_declNameCache)
+	{
+		LOG_INFO(
+			"Declaration name cache: " + std::to_string(m_declNameCache->getHitCount()) +
+			" hits, " + std::to_string(m_declNameCache->getMissCount()) + " misses, " +
+			std::to_string(m_declNameCache->getSize()) + " names");
+	}
+
+	if (m_fileContentCache)
+	{
+		LOG_INFO(
+			"File content cache: " + std::to_string(m_fileContentCache->getHitCount()) +
+			" hits, " + std::to_string(m_fileContentCache->getMissCount()) + " misses, " +
+			std::to_string(m_fileContentCache->getByteCount()) + " bytes");
+	}
+
 	if (!m_client->hasContent())
 	{
 		if (info.invocation.empty())
@@ -229,5 +284,11 @@ std::shared_ptr<CxxDiagnosticConsumer> CxxParser::getDiagnostics(
 {
 	llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options = new clang::DiagnosticOptions();
 	return std::make_shared<CxxDiagnosticConsumer>(
-		llvm::errs(), &*options, m_client, canonicalFilePathCache, sourceFilePath, logErrors);
+		llvm::errs(),
+		&*options,
+		m_client,
+		canonicalFilePathCache,
+		sourceFilePath,
+		logErrors,
+		m_indexerStateInfo);
 }
@@ -7,7 +7,10 @@
 #include "Parser.h"
 
 class CanonicalFilePathCache;
+class CxxAstVisitorProfile;
+class CxxDeclNameCache;
 class CxxDiagnosticConsumer;
+class CxxFileContentCache;
 class FilePath;
 class FileRegister;
 class IndexerCommandCxx;
@@ -35,7 +38,10 @@ public:
 	CxxParser(
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<FileRegister> fileRegister,
-		std::shared_ptr<IndexerStateInfo> indexerStateInfo);
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+		std::shared_ptr<CxxDeclNameCache> declNameCache = nullptr,
+		std::shared_ptr<CxxFileContentCache> fileContentCache = nullptr,
+		std::shared_ptr<CxxAstVisitorProfile> visitorProfile = nullptr);
 
 	void buildIndex(std::shared_ptr<IndexerCommandCxx> indexerCommand);
 	void buildIndex(
@@ -45,7 +51,9 @@ public:
 
 private:
 	void runTool(
-		clang::tooling::CompilationDatabase* compilationDatabase, const FilePath& sourceFilePath);
+		clang::tooling::CompilationDatabase* compilationDatabase,
+		const FilePath& sourceFilePath,
+		bool skipFunctionBodies = false);
 
 	std::shared_ptr<CxxDiagnosticConsumer> getDiagnostics(
 		const FilePath& sourceFilePath,
@@ -56,6 +64,9 @@ private:
 
 	std::shared_ptr<FileRegister> m_fileRegister;
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
+	std::shared_ptr<CxxDeclNameCache> m_declNameCache;
+	std::shared_ptr<CxxFileContentCache> m_fileContentCache;
+	std::shared_ptr<CxxAstVisitorProfile> m_visitorProfile;
 };
 
 #endif	  // CXX_PARSER_H
@@ -16,8 +16,10 @@ CxxVerboseAstVisitor::CxxVerboseAstVisitor(
 	clang::Preprocessor* preprocessor,
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
+	std::shared_ptr<CxxDeclNameCache> declNameCache,
 	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
-	: base(context, preprocessor, client, canonicalFilePathCache, indexerStateInfo), m_indentation(0)
+	: base(context, preprocessor, client, canonicalFilePathCache, declNameCache, indexerStateInfo)
+	, m_indentation(0)
 {
 }
 
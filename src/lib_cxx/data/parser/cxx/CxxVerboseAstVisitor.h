@@ -7,6 +7,7 @@
 #include "CxxAstVisitor.h"
 
 class CanonicalFilePathCache;
+class CxxDeclNameCache;
 class ParserClient;
 
 class CxxVerboseAstVisitor: public CxxAstVisitor
@@ -17,6 +18,7 @@ public:
 		clang::Preprocessor* preprocessor,
 		std::shared_ptr<ParserClient> client,
 		std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
+		std::shared_ptr<CxxDeclNameCache> declNameCache,
 		std::shared_ptr<IndexerStateInfo> indexerStateInfo);
 
 private:
@@ -28,27 +28,29 @@ void PreprocessorCallbacks::FileChanged(
 	clang::FileID prevID)
 {
 	const clang::FileID fileId = m_sourceManager.getFileID(location);
+	m_currentFileIsIndexed = false;
+
+	// files are entered and exited again and again, only the first time needs the file path
+	if (m_fileWasRecorded.find(fileId) != m_fileWasRecorded.end())
+	{
+		m_currentFileSymbolId = m_canonicalFilePathCache->getFileSymbolId(fileId);
+		m_currentFileIsIndexed = isIndexedFile(fileId);
+		return;
+	}
+
 	const FilePath currentPath = m_canonicalFilePathCache->getCanonicalFilePath(
 		fileId, m_sourceManager);
-	m_currentPathIsProjectFile = false;
-
 	if (!currentPath.empty())
 	{
-		m_currentPathIsProjectFile = m_canonicalFilePathCache->isProjectFile(fileId, m_sourceManager);
+		// todo: fix for tests
+		m_currentFileSymbolId = m_client->recordFile(
+			currentPath, m_canonicalFilePathCache->isProjectFile(fileId, m_sourceManager));
+		m_client->recordFileLanguage(m_currentFileSymbolId, L"cpp");
 
-		if (m_fileWasRecorded.find(fileId) == m_fileWasRecorded.end())
-		{
-			m_currentFileSymbolId = m_client->recordFile(
-				currentPath, m_currentPathIsProjectFile);	 // todo: fix for tests
-			m_client->recordFileLanguage(m_currentFileSymbolId, L"cpp");
+		m_canonicalFilePathCache->addFileSymbolId(fileId, currentPath, m_currentFileSymbolId);
+		m_fileWasRecorded.insert(fileId);
 
-			m_canonicalFilePathCache->addFileSymbolId(fileId, currentPath, m_currentFileSymbolId);
-			m_fileWasRecorded.insert(fileId);
-		}
-		else
-		{
-			m_currentFileSymbolId = m_canonicalFilePathCache->getFileSymbolId(fileId);
-		}
+		m_currentFileIsIndexed = isIndexedFile(fileId);
 	}
 }
 
@@ -82,7 +84,7 @@ void PreprocessorCallbacks::InclusionDirective(
 void PreprocessorCallbacks::MacroDefined(
 	const clang::Token& macroNameToken, const clang::MacroDirective* macroDirective)
 {
-	if (m_currentPathIsProjectFile)
+	if (m_currentFileIsIndexed)
 	{
 		// ignore builtin macros
 		if (m_sourceManager.getSpellingLoc(macroNameToken.getLocation())
@@ -147,7 +149,7 @@ void PreprocessorCallbacks::MacroExpands(
 
 void PreprocessorCallbacks::onMacroUsage(const clang::Token& macroNameToken)
 {
-	if (m_currentPathIsProjectFile && isLocatedInProjectFile(macroNameToken.getLocation()))
+	if (m_currentFileIsIndexed && isLocatedInProjectFile(macroNameToken.getLocation()))
 	{
 		const ParseLocation loc = getParseLocation(macroNameToken);
 
@@ -224,6 +226,13 @@ ParseLocation PreprocessorCallbacks::getParseLocation(const clang::SourceRange&
 	return ParseLocation();
 }
 
+bool PreprocessorCallbacks::isIndexedFile(const clang::FileID& fileId)
+{
+	// another translation unit already recorded the macros of that file
+	return m_canonicalFilePathCache->isProjectFile(fileId, m_sourceManager) &&
+		!m_canonicalFilePathCache->isAlreadyIndexedFile(fileId, m_sourceManager);
+}
+
 bool PreprocessorCallbacks::isLocatedInProjectFile(const clang::SourceLocation loc)
 {
 	// we need the spelling loc here, since this is the location where the macro comes from
@@ -75,6 +75,7 @@ private:
 	ParseLocation getParseLocation(const clang::Token& macroNameToc) const;
 	ParseLocation getParseLocation(const clang::MacroInfo* macroNameToc) const;
 	ParseLocation getParseLocation(const clang::SourceRange& sourceRange) const;
+	bool isIndexedFile(const clang::FileID& fileId);
 	bool isLocatedInProjectFile(const clang::SourceLocation loc);
 
 	const clang::SourceManager& m_sourceManager;
@@ -82,7 +83,7 @@ private:
 	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
 
 	Id m_currentFileSymbolId;
-	bool m_currentPathIsProjectFile = false;
+	bool m_currentFileIsIndexed = false;	 // macros of non indexed files are skipped entirely
 
 	std::set<clang::FileID> m_fileWasRecorded;
 };
@@ -5,6 +5,7 @@
 #include <clang/Lex/Preprocessor.h>
 
 #include "CanonicalFilePathCache.h"
+#include "CxxAstContextLock.h"
 #include "FilePath.h"
 #include "ParseLocation.h"
 #include "utilityString.h"
@@ -150,6 +151,7 @@ ParseLocation utility::getParseLocation(
 {
 	if (sourceLocation.isValid())
 	{
+		CxxAstContextLock lock;
 		clang::SourceLocation loc = sourceLocation;
 		if (sourceManager.isMacroBodyExpansion(sourceLocation))
 		{
@@ -199,6 +201,7 @@ ParseLocation utility::getParseLocation(
 {
 	if (sourceRange.isValid())
 	{
+		CxxAstContextLock lock;
 		clang::SourceRange range = sourceRange;
 		clang::SourceLocation endLoc = preprocessor->getLocForEndOfToken(range.getEnd());
 
@@ -0,0 +1,303 @@
+#include "CxxAutomaticPch.h"
+
+#include <fstream>
+#include <map>
+
+#include "FileSystem.h"
+#include "TaskGroupSequence.h"
+#include "TaskLambda.h"
+#include "logging.h"
+#include "utility.h"
+#include "utilitySourceGroupCxx.h"
+#include "utilityString.h"
+
+namespace
+{
+std::string removeComments(const std::string& line, bool& inBlockComment)
+{
+	std::string code;
+	for (size_t i = 0; i < line.size(); i++)
+	{
+		if (inBlockComment)
+		{
+			if (line.compare(i, 2, "*/") == 0)
+			{
+				inBlockComment = false;
+				i++;
+			}
+		}
+		else if (line.compare(i, 2, "/*") == 0)
+		{
+			inBlockComment = true;
+			code.push_back(' ');
+			i++;
+		}
+		else if (line.compare(i, 2, "//") == 0)
+		{
+			break;
+		}
+		else
+		{
+			code.push_back(line[i]);
+		}
+	}
+	return code;
+}
+
+// files like ".def" or ".inc" are meant to be included several times and can't be precompiled
+bool isHeaderFileName(const std::string& fileName)
+{
+	const size_t nameStart = fileName.find_last_of("/\\");
+	const size_t extensionStart = fileName.find_last_of('.');
+	if (extensionStart == std::string::npos ||
+		(nameStart != std::string::npos && extensionStart < nameStart))
+	{
+		return true;
+	}
+
+	const std::string extension = utility::toLowerCase(fileName.substr(extensionStart));
+	return extension == ".h" || extension == ".hh" || extension == ".hpp" ||
+		extension == ".hxx" || extension == ".h++";
+}
+}	 // namespace
+
+const size_t CxxAutomaticPch::s_minimumSourceFileCount = 2;
+const size_t CxxAutomaticPch::s_maximumScannedLineCount = 256;
+
+std::vector<std::string> CxxAutomaticPch::getLeadingIncludeDirectives(
+	const std::vector<std::string>& lines)
+{
+	std::vector<std::string> includeDirectives;
+	bool inBlockComment = false;
+
+	for (const std::string& line: lines)
+	{
+		const std::string code = utility::trim(removeComments(line, inBlockComment));
+		if (code.empty())
+		{
+			continue;
+		}
+
+		if (code[0] != '#')
+		{
+			break;
+		}
+
+		const std::string directive = utility::trim(code.substr(1));
+		if (directive == "pragma once")
+		{
+			continue;
+		}
+
+		if (!utility::isPrefix<std::string>("include", directive))
+		{
+			break;
+		}
+
+		const std::string target = utility::trim(directive.substr(7));
+		if (target.size() < 3 || (target[0] != '<' && target[0] != '"'))
+		{
+			break;
+		}
+
+		const size_t end = target.find(target[0] == '<' ? '>' : '"', 1);
+		if (end == std::string::npos || !isHeaderFileName(target.substr(1, end - 1)))
+		{
+			break;
+		}
+
+		includeDirectives.push_back("#include " + target.substr(0, end + 1));
+	}
+
+	return includeDirectives;
+}
+
+std::vector<std::string> CxxAutomaticPch::getSharedIncludePrefix(
+	const std::vector<std::vector<std::string>>& includeDirectives)
+{
+	std::map<std::vector<std::string>, size_t> prefixCounts;
+	for (const std::vector<std::string>& directives: includeDirectives)
+	{
+		std::vector<std::string> prefix;
+		for (const std::string& directive: directives)
+		{
+			prefix.push_back(directive);
+			prefixCounts[prefix]++;
+		}
+	}
+
+	// favor prefixes that save the most header parses: length times number of source files
+	std::vector<std::string> bestPrefix;
+	size_t bestScore = 0;
+	for (const auto& p: prefixCounts)
+	{
+		const size_t score = p.first.size() * p.second;
+		if (p.second >= s_minimumSourceFileCount &&
+			(score > bestScore || (score == bestScore && p.first.size() > bestPrefix.size())))
+		{
+			bestPrefix = p.first;
+			bestScore = score;
+		}
+	}
+
+	return bestPrefix;
+}
+
+CxxAutomaticPch CxxAutomaticPch::create(
+	const std::set<FilePath>& sourceFilePaths, const FilePath& pchDependenciesDirectoryPath)
+{
+	CxxAutomaticPch pch;
+	if (pchDependenciesDirectoryPath.empty() || sourceFilePaths.size() < s_minimumSourceFileCount)
+	{
+		return pch;
+	}
+
+	std::vector<FilePath> filePaths;
+	std::vector<std::vector<std::string>> includeDirectives;
+	for (const FilePath& sourceFilePath: sourceFilePaths)
+	{
+		std::vector<std::string> directives = getLeadingIncludeDirectives(
+			readLeadingLines(sourceFilePath));
+
+		// quoted includes are looked up next to the including file first, which is a different
+		// directory for the generated header, so these get referenced by their absolute path
+		for (std::string& directive: directives)
+		{
+			if (directive.back() == '"')
+			{
+				const std::string target = directive.substr(10, directive.size() - 11);
+				const FilePath includedFilePath = sourceFilePath.getParentDirectory()
+													  .getConcatenated(utility::decodeFromUtf8(target))
+													  .makeCanonical();
+				if (includedFilePath.exists())
+				{
+					directive = "#include \"" + utility::encodeToUtf8(includedFilePath.wstr()) + "\"";
+				}
+			}
+		}
+
+		filePaths.push_back(sourceFilePath);
+		includeDirectives.push_back(directives);
+	}
+
+	pch.m_includeDirectives = getSharedIncludePrefix(includeDirectives);
+	if (pch.m_includeDirectives.empty())
+	{
+		return pch;
+	}
+
+	for (size_t i = 0; i < filePaths.size(); i++)
+	{
+		if (includeDirectives[i].size() >= pch.m_includeDirectives.size() &&
+			std::equal(
+				pch.m_includeDirectives.begin(),
+				pch.m_includeDirectives.end(),
+				includeDirectives[i].begin()))
+		{
+			pch.m_sourceFilePaths.insert(filePaths[i]);
+		}
+	}
+
+	pch.m_headerFilePath = pchDependenciesDirectoryPath.getConcatenated(L"automatic_pch.h");
+
+	LOG_INFO(
+		"Using automatic precompiled header with " +
+		std::to_string(pch.m_includeDirectives.size()) + " includes for " +
+		std::to_string(pch.m_sourceFilePaths.size()) + " source files");
+
+	return pch;
+}
+
+bool CxxAutomaticPch::isEmpty() const
+{
+	return m_sourceFilePaths.empty();
+}
+
+bool CxxAutomaticPch::contains(const FilePath& sourceFilePath) const
+{
+	return m_sourceFilePaths.find(sourceFilePath) != m_sourceFilePaths.end();
+}
+
+const FilePath& CxxAutomaticPch::getHeaderFilePath() const
+{
+	return m_headerFilePath;
+}
+
+FilePath CxxAutomaticPch::getPchFilePath() const
+{
+	// clang looks for "foo.h.pch" when "foo.h" is passed via "-include"
+	return FilePath(m_headerFilePath.wstr() + L".pch");
+}
+
+const std::vector<std::string>& CxxAutomaticPch::getIncludeDirectives() const
+{
+	return m_includeDirectives;
+}
+
+std::vector<std::wstring> CxxAutomaticPch::getIncludeFlags() const
+{
+	if (isEmpty())
+	{
+		return {};
+	}
+
+	return {L"-fallow-pch-with-compiler-errors", L"-include", m_headerFilePath.wstr()};
+}
+
+std::shared_ptr<Task> CxxAutomaticPch::createBuildTask(
+	const std::vector<std::wstring>& compilerFlags,
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::shared_ptr<DialogView> dialogView) const
+{
+	if (isEmpty())
+	{
+		return std::make_shared<TaskLambda>([]() {});
+	}
+
+	const FilePath headerFilePath = m_headerFilePath;
+	const FilePath pchFilePath = getPchFilePath();
+	const std::vector<std::string> includeDirectives = m_includeDirectives;
+
+	std::shared_ptr<TaskGroupSequence> sequence = std::make_shared<TaskGroupSequence>();
+	sequence->addTask(std::make_shared<TaskLambda>([headerFilePath, pchFilePath, includeDirectives]() {
+		if (!headerFilePath.getParentDirectory().exists())
+		{
+			FileSystem::createDirectory(headerFilePath.getParentDirectory());
+		}
+
+		// a stale precompiled header would be picked up if building the new one fails
+		if (pchFilePath.recheckExists())
+		{
+			FileSystem::remove(pchFilePath);
+		}
+
+		std::ofstream fileStream(headerFilePath.str(), std::ios::out | std::ios::trunc);
+		for (const std::string& includeDirective: includeDirectives)
+		{
+			fileStream << includeDirective << '\n';
+		}
+		fileStream.close();
+
+		if (!fileStream)
+		{
+			LOG_ERROR(L"Unable to write automatic precompiled header \"" + headerFilePath.wstr() + L"\"");
+		}
+	}));
+	sequence->addTask(utility::createBuildPchTask(
+		headerFilePath, pchFilePath, compilerFlags, storageProvider, dialogView));
+	return sequence;
+}
+
+std::vector<std::string> CxxAutomaticPch::readLeadingLines(const FilePath& filePath)
+{
+	std::vector<std::string> lines;
+
+	std::ifstream fileStream(filePath.str());
+	std::string line;
+	while (lines.size() < s_maximumScannedLineCount && std::getline(fileStream, line))
+	{
+		lines.push_back(line);
+	}
+
+	return lines;
+}
@@ -0,0 +1,55 @@
+#ifndef CXX_AUTOMATIC_PCH_H
+#define CXX_AUTOMATIC_PCH_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+
+class DialogView;
+class StorageProvider;
+class Task;
+
+// Precompiled header that is generated without any configuration for source files that start with
+// the same include directives. The generated header only contains that shared prefix, so the
+// translation units using it see the same declarations in the same order as before. Translation
+// units pass the header via "-include", which lets clang pick up the precompiled version next to
+// it and fall back to parsing the header if building the precompiled header failed.
+class CxxAutomaticPch
+{
+public:
+	static std::vector<std::string> getLeadingIncludeDirectives(const std::vector<std::string>& lines);
+	static std::vector<std::string> getSharedIncludePrefix(
+		const std::vector<std::vector<std::string>>& includeDirectives);
+
+	static CxxAutomaticPch create(
+		const std::set<FilePath>& sourceFilePaths, const FilePath& pchDependenciesDirectoryPath);
+
+	bool isEmpty() const;
+	bool contains(const FilePath& sourceFilePath) const;
+
+	const FilePath& getHeaderFilePath() const;
+	FilePath getPchFilePath() const;
+	const std::vector<std::string>& getIncludeDirectives() const;
+
+	std::vector<std::wstring> getIncludeFlags() const;
+
+	std::shared_ptr<Task> createBuildTask(
+		const std::vector<std::wstring>& compilerFlags,
+		std::shared_ptr<StorageProvider> storageProvider,
+		std::shared_ptr<DialogView> dialogView) const;
+
+private:
+	static const size_t s_minimumSourceFileCount;
+	static const size_t s_maximumScannedLineCount;
+
+	static std::vector<std::string> readLeadingLines(const FilePath& filePath);
+
+	FilePath m_headerFilePath;
+	std::vector<std::string> m_includeDirectives;
+	std::set<FilePath> m_sourceFilePaths;
+};
+
+#endif	  // CXX_AUTOMATIC_PCH_H
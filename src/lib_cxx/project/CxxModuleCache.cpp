@@ -0,0 +1,218 @@
+#include "CxxModuleCache.h"
+
+#include <fstream>
+#include <map>
+
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Frontend/FrontendActions.h>
+#include <clang/Tooling/Tooling.h>
+
+#include "CxxCompilationDatabaseSingle.h"
+#include "CxxParser.h"
+#include "DialogView.h"
+#include "FileSystem.h"
+#include "IndexerCommandCxx.h"
+#include "TaskLambda.h"
+#include "TaskManager.h"
+#include "TimeStamp.h"
+#include "ThreadPool.h"
+#include "logging.h"
+#include "utility.h"
+#include "utilityString.h"
+
+const size_t CxxModuleCache::s_minimumSharedCommandCount = 2;
+
+bool CxxModuleCache::usesImplicitModules(const std::vector<std::wstring>& compilerFlags)
+{
+	bool modules = false;
+	bool implicitModules = true;
+	for (const std::wstring& flag: compilerFlags)
+	{
+		if (flag == L"-fmodules" || flag == L"-fcxx-modules")
+		{
+			modules = true;
+		}
+		else if (flag == L"-fno-modules" || flag == L"-fno-cxx-modules")
+		{
+			modules = false;
+		}
+		else if (flag == L"-fimplicit-modules")
+		{
+			implicitModules = true;
+		}
+		else if (flag == L"-fno-implicit-modules")
+		{
+			implicitModules = false;
+		}
+	}
+	return modules && implicitModules;
+}
+
+void CxxModuleCache::removeModuleCacheFlags(std::vector<std::wstring>& compilerFlags)
+{
+	for (size_t i = 0; i < compilerFlags.size(); i++)
+	{
+		const std::wstring& flag = compilerFlags[i];
+		if (utility::isPrefix<std::wstring>(L"-fmodules-cache-path=", flag) ||
+			utility::isPrefix<std::wstring>(L"-fbuild-session-file=", flag) ||
+			utility::isPrefix<std::wstring>(L"-fbuild-session-timestamp=", flag) ||
+			flag == L"-fmodules-validate-once-per-build-session")
+		{
+			compilerFlags.erase(compilerFlags.begin() + i);
+			i--;
+		}
+	}
+}
+
+std::vector<std::wstring> CxxModuleCache::getConfigurationFlags(
+	const std::vector<std::wstring>& compilerFlags, const FilePath& sourceFilePath)
+{
+	std::vector<std::wstring> configurationFlags;
+	for (size_t i = 0; i < compilerFlags.size(); i++)
+	{
+		const std::wstring& flag = compilerFlags[i];
+		if (flag == L"-o" || flag == L"-MF" || flag == L"-MT" || flag == L"-MQ")
+		{
+			i++;
+		}
+		else if (
+			utility::isPrefix<std::wstring>(L"-", flag) ||
+			FilePath(flag).fileName() != sourceFilePath.fileName())
+		{
+			configurationFlags.push_back(flag);
+		}
+	}
+	return configurationFlags;
+}
+
+CxxModuleCache::CxxModuleCache(const FilePath& directoryPath): m_directoryPath(directoryPath) {}
+
+bool CxxModuleCache::isEmpty() const
+{
+	return m_directoryPath.empty();
+}
+
+const FilePath& CxxModuleCache::getDirectoryPath() const
+{
+	return m_directoryPath;
+}
+
+FilePath CxxModuleCache::getBuildSessionFilePath() const
+{
+	return m_directoryPath.getConcatenated(L"build_session");
+}
+
+void CxxModuleCache::addFlags(std::vector<std::wstring>& compilerFlags) const
+{
+	if (isEmpty() || !usesImplicitModules(compilerFlags))
+	{
+		return;
+	}
+
+	removeModuleCacheFlags(compilerFlags);
+	compilerFlags.push_back(L"-fmodules-cache-path=" + m_directoryPath.wstr());
+	// modules older than the last write of the file are checked against their headers once
+	compilerFlags.push_back(L"-fmodules-validate-once-per-build-session");
+	compilerFlags.push_back(L"-fbuild-session-file=" + getBuildSessionFilePath().wstr());
+}
+
+std::shared_ptr<Task> CxxModuleCache::createBuildTask(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands,
+	std::shared_ptr<DialogView> dialogView) const
+{
+	if (isEmpty())
+	{
+		return std::make_shared<TaskLambda>([]() {});
+	}
+
+	std::map<std::vector<std::wstring>, std::vector<std::shared_ptr<IndexerCommandCxx>>>
+		configurations;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		std::shared_ptr<IndexerCommandCxx> indexerCommandCxx =
+			std::dynamic_pointer_cast<IndexerCommandCxx>(indexerCommand);
+		if (indexerCommandCxx && usesImplicitModules(indexerCommandCxx->getCompilerFlags()))
+		{
+			configurations[getConfigurationFlags(
+							   indexerCommandCxx->getCompilerFlags(),
+							   indexerCommandCxx->getSourceFilePath())]
+				.push_back(indexerCommandCxx);
+		}
+	}
+
+	if (configurations.empty())
+	{
+		return std::make_shared<TaskLambda>([]() {});
+	}
+
+	// modules imported by a single translation unit get built by its indexer
+	std::vector<std::shared_ptr<IndexerCommandCxx>> buildCommands;
+	for (const auto& p: configurations)
+	{
+		if (p.second.size() >= s_minimumSharedCommandCount)
+		{
+			buildCommands.push_back(p.second.front());
+		}
+	}
+
+	const FilePath directoryPath = m_directoryPath;
+	const FilePath buildSessionFilePath = getBuildSessionFilePath();
+
+	return std::make_shared<TaskLambda>(
+		[dialogView, directoryPath, buildSessionFilePath, buildCommands]() {
+			if (!directoryPath.exists())
+			{
+				FileSystem::createDirectory(directoryPath);
+			}
+
+			// starts a new build session, so each module gets validated again once
+			std::ofstream buildSessionFile(
+				buildSessionFilePath.str(), std::ios::out | std::ios::trunc);
+			buildSessionFile << TimeStamp::now().toString();
+			buildSessionFile.close();
+
+			if (buildCommands.empty())
+			{
+				return;
+			}
+
+			dialogView->showUnknownProgressDialog(L"Preparing Indexing", L"Building Clang Modules");
+			LOG_INFO(
+				L"Building Clang modules of " + std::to_wstring(buildCommands.size()) +
+				L" configurations at \"" + directoryPath.wstr() + L"\"");
+
+			CxxParser::initializeLLVM();
+
+			// preprocessing imports all modules of a translation unit without parsing its code
+			std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+			threadPool->parallelFor(
+				buildCommands.size(),
+				[&](size_t i) {
+					const std::shared_ptr<IndexerCommandCxx>& indexerCommand = buildCommands[i];
+
+					std::vector<std::wstring> args = indexerCommand->getCompilerFlags();
+					if (!args.empty() && !utility::isPrefix<std::wstring>(L"-", args.front()))
+					{
+						args.erase(args.begin());
+					}
+
+					clang::tooling::CompileCommand compileCommand;
+					compileCommand.Filename = utility::encodeToUtf8(
+						indexerCommand->getSourceFilePath().wstr());
+					compileCommand.Directory = utility::encodeToUtf8(
+						indexerCommand->getWorkingDirectory().wstr());
+					compileCommand.CommandLine = utility::concat(
+						{"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(args));
+
+					CxxCompilationDatabaseSingle compilationDatabase(compileCommand);
+					clang::tooling::ClangTool tool(
+						compilationDatabase, {compileCommand.Filename});
+					clang::IgnoringDiagConsumer diagnostics;
+					tool.setDiagnosticConsumer(&diagnostics);
+					tool.clearArgumentsAdjusters();
+					tool.run(clang::tooling::newFrontendActionFactory<clang::PreprocessOnlyAction>()
+								 .get());
+				},
+				ThreadPool::PRIORITY_INDEXING);
+		});
+}
@@ -0,0 +1,52 @@
+#ifndef CXX_MODULE_CACHE_H
+#define CXX_MODULE_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+
+class DialogView;
+class IndexerCommand;
+class Task;
+
+// Cache of implicitly built Clang modules that is shared by all indexer processes of a project.
+// Translation units using implicit modules get the cache directory of the project instead of the
+// one of their build, so each module gets built once per configuration instead of once per
+// indexer process. Clang builds modules behind lock files and moves them into the cache when done,
+// so several processes can fill the cache at the same time. The pre-index task builds the modules
+// of each configuration shared by several translation units, and the indexers only validate each
+// module once per indexing run.
+class CxxModuleCache
+{
+public:
+	static bool usesImplicitModules(const std::vector<std::wstring>& compilerFlags);
+	static void removeModuleCacheFlags(std::vector<std::wstring>& compilerFlags);
+
+	// flags without the ones that differ between translation units importing the same modules
+	static std::vector<std::wstring> getConfigurationFlags(
+		const std::vector<std::wstring>& compilerFlags, const FilePath& sourceFilePath);
+
+	CxxModuleCache() = default;
+	CxxModuleCache(const FilePath& directoryPath);
+
+	bool isEmpty() const;
+
+	const FilePath& getDirectoryPath() const;
+	FilePath getBuildSessionFilePath() const;
+
+	// replaces the module cache of translation units using implicit modules
+	void addFlags(std::vector<std::wstring>& compilerFlags) const;
+
+	std::shared_ptr<Task> createBuildTask(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands,
+		std::shared_ptr<DialogView> dialogView) const;
+
+private:
+	static const size_t s_minimumSharedCommandCount;
+
+	FilePath m_directoryPath;
+};
+
+#endif	  // CXX_MODULE_CACHE_H
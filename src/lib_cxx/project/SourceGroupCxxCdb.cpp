@@ -1,16 +1,20 @@
 #include "SourceGroupCxxCdb.h"
 
-#include <clang/Tooling/JSONCompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
 
 #include "Application.h"
 #include "ApplicationSettings.h"
+#include "CachedCompilationDatabase.h"
 #include "ClangInvocationInfo.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxIndexerCommandProvider.h"
+#include "CxxModuleCache.h"
 #include "IndexerCommandCxx.h"
 #include "MessageStatus.h"
+#include "ProjectSettings.h"
+#include "RefreshInfo.h"
 #include "SourceGroupSettingsCxxCdb.h"
+#include "TaskGroupSequence.h"
 #include "TaskLambda.h"
 #include "logging.h"
 #include "utility.h"
@@ -21,6 +25,11 @@ SourceGroupCxxCdb::SourceGroupCxxCdb(std::shared_ptr<SourceGroupSettingsCxxCdb>
 {
 }
 
+bool SourceGroupCxxCdb::allowsShallowIndexing() const
+{
+	return true;
+}
+
 bool SourceGroupCxxCdb::prepareIndexing()
 {
 	FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
@@ -53,7 +62,7 @@ std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths() const
 }
 
 std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths(
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const
+	std::shared_ptr<const CachedCompilationDatabase> cdb) const
 {
 	std::set<FilePath> sourceFilePaths;
 
@@ -61,8 +70,7 @@ std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths(
 	{
 		const std::vector<FilePathFilter> excludeFilters =
 			m_settings->getExcludeFiltersExpandedAndAbsolute();
-		for (const FilePath& path: IndexerCommandCxx::getSourceFilesFromCDB(
-				 cdb, m_settings->getCompilationDatabasePathExpandedAndAbsolute()))
+		for (const FilePath& path: cdb->getSourceFilePaths())
 		{
 			bool excluded = false;
 			for (const FilePathFilter& filter: excludeFilters)
@@ -90,8 +98,8 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 	std::shared_ptr<CxxIndexerCommandProvider> provider =
 		std::make_shared<CxxIndexerCommandProvider>();
 
-	const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+	std::shared_ptr<const CachedCompilationDatabase> cdb = utility::loadCDB(
+		m_settings->getCompilationDatabasePathExpandedAndAbsolute());
 	if (!cdb)
 	{
 		return provider;
@@ -101,6 +109,7 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 	utility::append(compilerFlags, m_settings->getCompilerFlags());
 
 	const std::vector<std::wstring> includePchFlags = utility::getIncludePchFlags(m_settings.get());
+	const CxxModuleCache moduleCache = getModuleCache();
 
 	const std::set<FilePath> indexedHeaderPaths = utility::toSet(
 		m_settings->getIndexedHeaderPathsExpandedAndAbsolute());
@@ -108,39 +117,35 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 		m_settings->getExcludeFiltersExpandedAndAbsolute());
 	const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
 
-	for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+	for (const CachedCompilationDatabase::Command& command: cdb->getCommands())
 	{
-		FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-		if (!sourcePath.isAbsolute())
-		{
-			sourcePath = FilePath(utility::decodeFromUtf8(command.Directory + '/' + command.Filename))
-							 .makeCanonical();
-			if (!sourcePath.isAbsolute())
-			{
-				sourcePath = cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
-			}
-		}
-
+		const FilePath& sourcePath = command.sourceFilePath;
 		if (info.filesToIndex.find(sourcePath) != info.filesToIndex.end() &&
 			sourceFilePaths.find(sourcePath) != sourceFilePaths.end())
 		{
-			std::vector<std::wstring> cdbFlags = utility::convert<std::string, std::wstring>(
-				command.CommandLine, [](const std::string& s) { return utility::decodeFromUtf8(s); });
+			std::vector<std::wstring> cdbFlags = utility::convert<const std::string*, std::wstring>(
+				command.arguments,
+				[](const std::string* argument) { return utility::decodeFromUtf8(*argument); });
 
 			utility::removeIncludePchFlag(cdbFlags);
 
-			if (command.CommandLine.size() != cdbFlags.size())
+			if (command.arguments.size() != cdbFlags.size())
 			{
 				utility::append(cdbFlags, includePchFlags);
 			}
 
-			provider->addCommand(std::make_shared<IndexerCommandCxx>(
+			std::vector<std::wstring> flags = utility::concat(cdbFlags, compilerFlags);
+			moduleCache.addFlags(flags);
+
+			std::shared_ptr<IndexerCommandCxx> indexerCommand = std::make_shared<IndexerCommandCxx>(
 				sourcePath,
 				utility::concat(indexedHeaderPaths, {sourcePath}),
 				excludeFilters,
 				std::set<FilePathFilter>(),
-				FilePath(utility::decodeFromUtf8(command.Directory)),
-				utility::concat(cdbFlags, compilerFlags)));
+				FilePath(utility::decodeFromUtf8(command.directory)),
+				flags);
+			indexerCommand->setShallow(info.shallow);
+			provider->addCommand(indexerCommand);
 		}
 	}
 
@@ -157,6 +162,36 @@ std::vector<std::shared_ptr<IndexerCommand>> SourceGroupCxxCdb::getIndexerComman
 
 std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 	std::shared_ptr<StorageProvider> storageProvider, std::shared_ptr<DialogView> dialogView) const
+{
+	const CxxModuleCache moduleCache = getModuleCache();
+	if (moduleCache.isEmpty())
+	{
+		return getBuildPchTask(storageProvider, dialogView);
+	}
+
+	// the modules are built with the same flags as the indexed translation units, which include
+	// the precompiled header
+	RefreshInfo info;
+	info.filesToIndex = getAllSourceFilePaths();
+
+	std::shared_ptr<TaskGroupSequence> sequence = std::make_shared<TaskGroupSequence>();
+	sequence->addTask(getBuildPchTask(storageProvider, dialogView));
+	sequence->addTask(moduleCache.createBuildTask(getIndexerCommands(info), dialogView));
+	return sequence;
+}
+
+std::shared_ptr<SourceGroupSettings> SourceGroupCxxCdb::getSourceGroupSettings()
+{
+	return m_settings;
+}
+
+std::shared_ptr<const SourceGroupSettings> SourceGroupCxxCdb::getSourceGroupSettings() const
+{
+	return m_settings;
+}
+
+std::shared_ptr<Task> SourceGroupCxxCdb::getBuildPchTask(
+	std::shared_ptr<StorageProvider> storageProvider, std::shared_ptr<DialogView> dialogView) const
 {
 	if (m_settings->getPchInputFilePath().empty())
 	{
@@ -167,31 +202,19 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 
 	if (m_settings->getUseCompilerFlags())
 	{
-		const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+		std::shared_ptr<const CachedCompilationDatabase> cdb = utility::loadCDB(
+			m_settings->getCompilationDatabasePathExpandedAndAbsolute());
 		if (cdb)
 		{
 			const std::set<FilePath> sourceFilePaths = getAllSourceFilePaths(cdb);
-			for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+			for (const CachedCompilationDatabase::Command& command: cdb->getCommands())
 			{
-				FilePath sourcePath =
-					FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-				if (!sourcePath.isAbsolute())
-				{
-					sourcePath = FilePath(utility::decodeFromUtf8(
-											  command.Directory + '/' + command.Filename))
-									 .makeCanonical();
-					if (!sourcePath.isAbsolute())
-					{
-						sourcePath =
-							cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
-					}
-				}
-
+				const FilePath& sourcePath = command.sourceFilePath;
+				const std::vector<std::string> commandLine = command.getCommandLine();
 				if (sourceFilePaths.find(sourcePath) != sourceFilePaths.end() &&
-					utility::containsIncludePchFlag(command.CommandLine))
+					utility::containsIncludePchFlag(commandLine))
 				{
-					for (const std::string& arg: command.CommandLine)
+					for (const std::string& arg: commandLine)
 					{
 						if ((!compilerFlags.empty() || utility::isPrefix<std::string>("-", arg)) &&
 							FilePath(arg).fileName() != sourcePath.fileName())
@@ -200,7 +223,7 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 						}
 					}
 
-					CxxCompilationDatabaseSingle compilationDatabase(command);
+					CxxCompilationDatabaseSingle compilationDatabase(command.toCompileCommand());
 					ClangInvocationInfo info = ClangInvocationInfo::getClangInvocationString(
 						&compilationDatabase);
 
@@ -227,14 +250,17 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 	return utility::createBuildPchTask(m_settings.get(), compilerFlags, storageProvider, dialogView);
 }
 
-std::shared_ptr<SourceGroupSettings> SourceGroupCxxCdb::getSourceGroupSettings()
+CxxModuleCache SourceGroupCxxCdb::getModuleCache() const
 {
-	return m_settings;
-}
+	if (!ApplicationSettings::getInstance()->getCxxSharedModuleCacheEnabled())
+	{
+		return CxxModuleCache();
+	}
 
-std::shared_ptr<const SourceGroupSettings> SourceGroupCxxCdb::getSourceGroupSettings() const
-{
-	return m_settings;
+	// shared by the source groups of the project, clang keeps modules of different configurations
+	// apart
+	return CxxModuleCache(
+		m_settings->getProjectSettings()->getDependenciesDirectoryPath().concatenate(L"modules"));
 }
 
 std::vector<std::wstring> SourceGroupCxxCdb::getBaseCompilerFlags() const
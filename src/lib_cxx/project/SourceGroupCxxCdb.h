@@ -7,15 +7,9 @@
 
 #include "SourceGroup.h"
 
+class CachedCompilationDatabase;
+class CxxModuleCache;
 class FilePath;
-namespace clang
-{
-namespace tooling
-{
-class JSONCompilationDatabase;
-}
-}	 // namespace clang
-
 class SourceGroupSettingsCxxCdb;
 
 class SourceGroupCxxCdb: public SourceGroup
@@ -23,11 +17,12 @@ class SourceGroupCxxCdb: public SourceGroup
 public:
 	SourceGroupCxxCdb(std::shared_ptr<SourceGroupSettingsCxxCdb> settings);
 
+	bool allowsShallowIndexing() const override;
 	bool prepareIndexing() override;
 	std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override;
 	std::set<FilePath> getAllSourceFilePaths() const override;
 	std::set<FilePath> getAllSourceFilePaths(
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const;
+		std::shared_ptr<const CachedCompilationDatabase> cdb) const;
 	std::shared_ptr<IndexerCommandProvider> getIndexerCommandProvider(
 		const RefreshInfo& info) const override;
 	std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& info) const override;
@@ -39,6 +34,10 @@ private:
 	std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override;
 	std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override;
 	std::vector<std::wstring> getBaseCompilerFlags() const;
+	std::shared_ptr<Task> getBuildPchTask(
+		std::shared_ptr<StorageProvider> storageProvider,
+		std::shared_ptr<DialogView> dialogView) const;
+	CxxModuleCache getModuleCache() const;
 
 	std::shared_ptr<SourceGroupSettingsCxxCdb> m_settings;
 };
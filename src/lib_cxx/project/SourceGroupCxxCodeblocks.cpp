@@ -15,6 +15,11 @@ SourceGroupCxxCodeblocks::SourceGroupCxxCodeblocks(
 {
 }
 
+bool SourceGroupCxxCodeblocks::allowsShallowIndexing() const
+{
+	return true;
+}
+
 bool SourceGroupCxxCodeblocks::prepareIndexing()
 {
 	FilePath codeblocksProjectPath = m_settings->getCodeblocksProjectPathExpandedAndAbsolute();
@@ -85,6 +90,7 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCodeblocks::getIndexerComm
 		{
 			if (info.filesToIndex.find(indexerCommand->getSourceFilePath()) != info.filesToIndex.end())
 			{
+				indexerCommand->setShallow(info.shallow);
 				provider->addCommand(indexerCommand);
 			}
 		}
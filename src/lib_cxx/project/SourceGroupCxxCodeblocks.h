@@ -13,6 +13,7 @@ class SourceGroupCxxCodeblocks: public SourceGroup
 public:
 	SourceGroupCxxCodeblocks(std::shared_ptr<SourceGroupSettingsCxxCodeblocks> settings);
 
+	bool allowsShallowIndexing() const override;
 	bool prepareIndexing() override;
 	std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override;
 	std::set<FilePath> getAllSourceFilePaths() const override;
@@ -1,6 +1,7 @@
 #include "SourceGroupCxxEmpty.h"
 
 #include "ApplicationSettings.h"
+#include "CxxAutomaticPch.h"
 #include "CxxIndexerCommandProvider.h"
 #include "FileManager.h"
 #include "IndexerCommandCxx.h"
@@ -20,6 +21,11 @@ SourceGroupCxxEmpty::SourceGroupCxxEmpty(std::shared_ptr<SourceGroupSettings> se
 {
 }
 
+bool SourceGroupCxxEmpty::allowsShallowIndexing() const
+{
+	return true;
+}
+
 std::set<FilePath> SourceGroupCxxEmpty::filterToContainedFilePaths(const std::set<FilePath>& filePaths) const
 {
 	std::vector<FilePath> indexedPaths;
@@ -95,19 +101,30 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxEmpty::getIndexerCommandPr
 		utility::getIncludePchFlags(
 			dynamic_cast<const SourceGroupSettingsWithCxxPchOptions*>(m_settings.get())));
 
+	const CxxAutomaticPch automaticPch = getAutomaticPch();
+
 	std::shared_ptr<CxxIndexerCommandProvider> provider =
 		std::make_shared<CxxIndexerCommandProvider>();
 	for (const FilePath& sourcePath: getAllSourceFilePaths())
 	{
 		if (info.filesToIndex.find(sourcePath) != info.filesToIndex.end())
 		{
-			provider->addCommand(std::make_shared<IndexerCommandCxx>(
+			std::vector<std::wstring> flags = compilerFlags;
+			if (automaticPch.contains(sourcePath))
+			{
+				utility::append(flags, automaticPch.getIncludeFlags());
+			}
+			flags.push_back(sourcePath.wstr());
+
+			std::shared_ptr<IndexerCommandCxx> indexerCommand = std::make_shared<IndexerCommandCxx>(
 				sourcePath,
 				indexedPaths,
 				excludeFilters,
 				std::set<FilePathFilter>(),
 				m_settings->getProjectDirectoryPath(),
-				utility::concat(compilerFlags, sourcePath.wstr())));
+				flags);
+			indexerCommand->setShallow(info.shallow);
+			provider->addCommand(indexerCommand);
 		}
 	}
 
@@ -125,11 +142,22 @@ std::shared_ptr<Task> SourceGroupCxxEmpty::getPreIndexTask(
 {
 	const SourceGroupSettingsWithCxxPchOptions* pchSettings =
 		dynamic_cast<const SourceGroupSettingsWithCxxPchOptions*>(m_settings.get());
-	if (!pchSettings || pchSettings->getPchInputFilePath().empty())
+	if (!pchSettings)
 	{
 		return std::make_shared<TaskLambda>([]() {});
 	}
 
+	if (pchSettings->getPchInputFilePath().empty())
+	{
+		std::vector<std::wstring> compilerFlags = getBaseCompilerFlags();
+		utility::append(
+			compilerFlags,
+			dynamic_cast<const SourceGroupSettingsWithCxxPathsAndFlags*>(m_settings.get())
+				->getCompilerFlags());
+
+		return getAutomaticPch().createBuildTask(compilerFlags, storageProvider, dialogView);
+	}
+
 	std::vector<std::wstring> compilerFlags = getBaseCompilerFlags();
 
 	if (std::shared_ptr<SourceGroupSettingsWithCxxPchOptions> pchSettings =
@@ -163,6 +191,26 @@ std::shared_ptr<const SourceGroupSettings> SourceGroupCxxEmpty::getSourceGroupSe
 	return m_settings;
 }
 
+CxxAutomaticPch SourceGroupCxxEmpty::getAutomaticPch() const
+{
+	const SourceGroupSettingsWithCxxPchOptions* pchSettings =
+		dynamic_cast<const SourceGroupSettingsWithCxxPchOptions*>(m_settings.get());
+	const SourceGroupSettingsWithCxxPathsAndFlags* settingsCxx =
+		dynamic_cast<const SourceGroupSettingsWithCxxPathsAndFlags*>(m_settings.get());
+
+	// a precompiled header configured by the user always takes precedence
+	if (!ApplicationSettings::getInstance()->getAutomaticPrecompiledHeadersEnabled() ||
+		!pchSettings || !pchSettings->getPchInputFilePath().empty() || !settingsCxx ||
+		utility::getWithRemoveIncludePchFlag(settingsCxx->getCompilerFlags()).size() !=
+			settingsCxx->getCompilerFlags().size())
+	{
+		return CxxAutomaticPch();
+	}
+
+	return CxxAutomaticPch::create(
+		getAllSourceFilePaths(), pchSettings->getPchDependenciesDirectoryPath());
+}
+
 std::vector<std::wstring> SourceGroupCxxEmpty::getBaseCompilerFlags() const
 {
 	std::vector<std::wstring> compilerFlags;
@@ -6,6 +6,7 @@
 
 #include "SourceGroup.h"
 
+class CxxAutomaticPch;
 class SourceGroupSettingsCxx;
 
 class SourceGroupCxxEmpty: public SourceGroup
@@ -13,6 +14,7 @@ class SourceGroupCxxEmpty: public SourceGroup
 public:
 	SourceGroupCxxEmpty(std::shared_ptr<SourceGroupSettings> settings);
 
+	bool allowsShallowIndexing() const override;
 	std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override;
 	std::set<FilePath> getAllSourceFilePaths() const override;
 	std::shared_ptr<IndexerCommandProvider> getIndexerCommandProvider(
@@ -26,6 +28,7 @@ private:
 	std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override;
 	std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override;
 	std::vector<std::wstring> getBaseCompilerFlags() const;
+	CxxAutomaticPch getAutomaticPch() const;
 
 	std::shared_ptr<SourceGroupSettings> m_settings;
 };
@@ -2,6 +2,7 @@
 
 #include <clang/Tooling/JSONCompilationDatabase.h>
 
+#include "CachedCompilationDatabase.h"
 #include "CanonicalFilePathCache.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxDiagnosticConsumer.h"
@@ -46,6 +47,17 @@ std::shared_ptr<Task> createBuildPchTask(
 										   .getConcatenated(pchInputFilePath.fileName())
 										   .replaceExtension(L"pch");
 
+	return createBuildPchTask(
+		pchInputFilePath, pchOutputFilePath, compilerFlags, storageProvider, dialogView);
+}
+
+std::shared_ptr<Task> createBuildPchTask(
+	const FilePath& pchInputFilePath,
+	const FilePath& pchOutputFilePath,
+	std::vector<std::wstring> compilerFlags,
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::shared_ptr<DialogView> dialogView)
+{
 	utility::removeIncludePchFlag(compilerFlags);
 	compilerFlags.push_back(pchInputFilePath.wstr());
 	compilerFlags.push_back(L"-emit-pch");
@@ -102,35 +114,17 @@ std::shared_ptr<Task> createBuildPchTask(
 		});
 }
 
-std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(
+std::shared_ptr<const CachedCompilationDatabase> loadCDB(
 	const FilePath& cdbPath, std::string* error)
 {
-	if (cdbPath.empty() || !cdbPath.exists())
-	{
-		return std::shared_ptr<clang::tooling::JSONCompilationDatabase>();
-	}
-
-	std::string errorString;
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb =
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase>(
-			clang::tooling::JSONCompilationDatabase::loadFromFile(
-				utility::encodeToUtf8(cdbPath.wstr()),
-				errorString,
-				clang::tooling::JSONCommandLineSyntax::AutoDetect));
-
-	if (error && !errorString.empty())
-	{
-		*error = errorString;
-	}
-
-	return cdb;
+	return CachedCompilationDatabase::load(cdbPath, error);
 }
 
-bool containsIncludePchFlags(std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb)
+bool containsIncludePchFlags(std::shared_ptr<const CachedCompilationDatabase> cdb)
 {
-	for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+	for (const CachedCompilationDatabase::Command& command: cdb->getCommands())
 	{
-		if (containsIncludePchFlag(command.CommandLine))
+		if (containsIncludePchFlag(command.getCommandLine()))
 		{
 			return true;
 		}
@@ -5,14 +5,7 @@
 #include <string>
 #include <vector>
 
-namespace clang
-{
-namespace tooling
-{
-class JSONCompilationDatabase;
-}
-}	 // namespace clang
-
+class CachedCompilationDatabase;
 class DialogView;
 class FilePath;
 class SourceGroupSettingsWithCxxPchOptions;
@@ -26,10 +19,17 @@ std::shared_ptr<Task> createBuildPchTask(
 	std::vector<std::wstring> compilerFlags,
 	std::shared_ptr<StorageProvider> storageProvider,
 	std::shared_ptr<DialogView> dialogView);
+std::shared_ptr<Task> createBuildPchTask(
+	const FilePath& pchInputFilePath,
+	const FilePath& pchOutputFilePath,
+	std::vector<std::wstring> compilerFlags,
+	std::shared_ptr<StorageProvider> storageProvider,
+	std::shared_ptr<DialogView> dialogView);
 
-std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(
+// the database is only parsed again once the file changed
+std::shared_ptr<const CachedCompilationDatabase> loadCDB(
 	const FilePath& cdbPath, std::string* error = nullptr);
-bool containsIncludePchFlags(std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb);
+bool containsIncludePchFlags(std::shared_ptr<const CachedCompilationDatabase> cdb);
 bool containsIncludePchFlag(const std::vector<std::string>& args);
 std::vector<std::wstring> getWithRemoveIncludePchFlag(const std::vector<std::wstring>& args);
 void removeIncludePchFlag(std::vector<std::wstring>& args);
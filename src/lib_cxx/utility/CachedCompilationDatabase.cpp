@@ -0,0 +1,190 @@
+#include "CachedCompilationDatabase.h"
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include <clang/Tooling/CompilationDatabase.h>
+#include <clang/Tooling/JSONCompilationDatabase.h>
+
+#include "FileSystem.h"
+#include "logging.h"
+#include "tracing.h"
+#include "utilityString.h"
+
+namespace
+{
+struct CacheEntry
+{
+	std::string modificationTime;
+	unsigned long long byteSize = 0;
+	size_t contentHash = 0;
+	std::shared_ptr<const CachedCompilationDatabase> database;
+};
+
+std::mutex s_cacheMutex;
+std::map<FilePath, CacheEntry> s_cache;
+}	 // namespace
+
+std::vector<std::string> CachedCompilationDatabase::Command::getCommandLine() const
+{
+	std::vector<std::string> commandLine;
+	commandLine.reserve(arguments.size());
+	for (const std::string* argument: arguments)
+	{
+		commandLine.push_back(*argument);
+	}
+	return commandLine;
+}
+
+clang::tooling::CompileCommand CachedCompilationDatabase::Command::toCompileCommand() const
+{
+	return clang::tooling::CompileCommand(directory, filename, getCommandLine(), output);
+}
+
+std::shared_ptr<const CachedCompilationDatabase> CachedCompilationDatabase::load(
+	const FilePath& filePath, std::string* error)
+{
+	if (filePath.empty() || !filePath.exists())
+	{
+		return nullptr;
+	}
+
+	const std::string modificationTime = FileSystem::getLastWriteTime(filePath).toString();
+	const unsigned long long byteSize = FileSystem::getFileByteSize(filePath);
+
+	// reading and hashing the file is cheap compared to parsing it
+	std::string content;
+	{
+		std::ifstream fileStream(filePath.str(), std::ios::in | std::ios::binary);
+		std::stringstream stream;
+		stream << fileStream.rdbuf();
+		content = stream.str();
+	}
+	const size_t contentHash = std::hash<std::string>()(content);
+
+	{
+		std::lock_guard<std::mutex> lock(s_cacheMutex);
+		auto it = s_cache.find(filePath);
+		if (it != s_cache.end() && it->second.modificationTime == modificationTime &&
+			it->second.byteSize == byteSize && it->second.contentHash == contentHash)
+		{
+			return it->second.database;
+		}
+	}
+
+	std::shared_ptr<const CachedCompilationDatabase> database = parse(filePath, content, error);
+	if (database)
+	{
+		std::lock_guard<std::mutex> lock(s_cacheMutex);
+		CacheEntry& entry = s_cache[filePath];
+		entry.modificationTime = modificationTime;
+		entry.byteSize = byteSize;
+		entry.contentHash = contentHash;
+		entry.database = database;
+	}
+	return database;
+}
+
+void CachedCompilationDatabase::clearCache()
+{
+	std::lock_guard<std::mutex> lock(s_cacheMutex);
+	s_cache.clear();
+}
+
+const std::vector<CachedCompilationDatabase::Command>& CachedCompilationDatabase::getCommands()
+	const
+{
+	return m_commands;
+}
+
+std::vector<FilePath> CachedCompilationDatabase::getSourceFilePaths() const
+{
+	std::vector<FilePath> filePaths;
+	std::set<FilePath> addedFilePaths;
+	for (const Command& command: m_commands)
+	{
+		if (addedFilePaths.insert(command.sourceFilePath).second)
+		{
+			filePaths.push_back(command.sourceFilePath);
+		}
+	}
+	return filePaths;
+}
+
+std::shared_ptr<const CachedCompilationDatabase> CachedCompilationDatabase::parse(
+	const FilePath& filePath, const std::string& content, std::string* error)
+{
+	std::string errorString;
+	std::unique_ptr<clang::tooling::JSONCompilationDatabase> cdb =
+		clang::tooling::JSONCompilationDatabase::loadFromBuffer(
+			content, errorString, clang::tooling::JSONCommandLineSyntax::AutoDetect);
+
+	if (error && !errorString.empty())
+	{
+		*error = errorString;
+	}
+	if (!cdb)
+	{
+		return nullptr;
+	}
+
+	TRACE();
+
+	std::shared_ptr<CachedCompilationDatabase> database =
+		std::make_shared<CachedCompilationDatabase>();
+
+	// only the directories are made canonical, most commands share them with others
+	std::unordered_map<std::wstring, FilePath> canonicalDirectoryPaths;
+	const FilePath cdbDirectoryPath = filePath.getParentDirectory();
+
+	std::vector<clang::tooling::CompileCommand> compileCommands = cdb->getAllCompileCommands();
+	cdb.reset();
+
+	database->m_commands.reserve(compileCommands.size());
+	for (clang::tooling::CompileCommand& compileCommand: compileCommands)
+	{
+		Command command;
+
+		FilePath sourceFilePath(utility::decodeFromUtf8(compileCommand.Filename));
+		if (!sourceFilePath.isAbsolute())
+		{
+			sourceFilePath = FilePath(
+				utility::decodeFromUtf8(compileCommand.Directory + '/' + compileCommand.Filename));
+			if (!sourceFilePath.isAbsolute())
+			{
+				sourceFilePath = cdbDirectoryPath.getConcatenated(sourceFilePath);
+			}
+		}
+
+		const FilePath directoryPath = sourceFilePath.getParentDirectory();
+		auto it = canonicalDirectoryPaths.find(directoryPath.wstr());
+		if (it == canonicalDirectoryPaths.end())
+		{
+			it = canonicalDirectoryPaths.emplace(directoryPath.wstr(), directoryPath.getCanonical())
+					 .first;
+		}
+		command.sourceFilePath = it->second.getConcatenated(sourceFilePath.fileName());
+
+		command.directory = std::move(compileCommand.Directory);
+		command.filename = std::move(compileCommand.Filename);
+		command.output = std::move(compileCommand.Output);
+		command.arguments.reserve(compileCommand.CommandLine.size());
+		for (std::string& argument: compileCommand.CommandLine)
+		{
+			command.arguments.push_back(&*database->m_arguments.insert(std::move(argument)).first);
+		}
+
+		database->m_commands.push_back(std::move(command));
+	}
+
+	LOG_INFO(
+		"Parsed compilation database with " + std::to_string(database->m_commands.size()) +
+		" commands and " + std::to_string(database->m_arguments.size()) + " distinct arguments");
+
+	return database;
+}
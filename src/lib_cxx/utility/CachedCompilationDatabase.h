@@ -0,0 +1,56 @@
+#ifndef CACHED_COMPILATION_DATABASE_H
+#define CACHED_COMPILATION_DATABASE_H
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "FilePath.h"
+
+namespace clang
+{
+namespace tooling
+{
+struct CompileCommand;
+}
+}	 // namespace clang
+
+// The compile commands of a compilation database file. Each state of the file, told apart by its
+// modification time, size and content hash, is only parsed once and shared by all callers. The
+// arguments are interned, so the flags most commands have in common are stored once.
+class CachedCompilationDatabase
+{
+public:
+	struct Command
+	{
+		// the command line with its interned arguments
+		std::vector<std::string> getCommandLine() const;
+		clang::tooling::CompileCommand toCompileCommand() const;
+
+		FilePath sourceFilePath;	// absolute, within a canonical directory
+		std::string directory;
+		std::string filename;
+		std::string output;
+		std::vector<const std::string*> arguments;
+	};
+
+	// returns null if the file can't be read or parsed, the error is set in the latter case
+	static std::shared_ptr<const CachedCompilationDatabase> load(
+		const FilePath& filePath, std::string* error = nullptr);
+	static void clearCache();
+
+	const std::vector<Command>& getCommands() const;
+
+	// the source files of all commands in the order of the database, each one once
+	std::vector<FilePath> getSourceFilePaths() const;
+
+private:
+	static std::shared_ptr<const CachedCompilationDatabase> parse(
+		const FilePath& filePath, const std::string& content, std::string* error);
+
+	std::unordered_set<std::string> m_arguments;
+	std::vector<Command> m_commands;
+};
+
+#endif	  // CACHED_COMPILATION_DATABASE_H
@@ -2,9 +2,7 @@
 
 #include <set>
 
-#include <clang/Tooling/CompilationDatabase.h>
-#include <clang/Tooling/JSONCompilationDatabase.h>
-
+#include "CachedCompilationDatabase.h"
 #include "FilePath.h"
 #include "logging.h"
 #include "utility.h"
@@ -40,11 +38,8 @@ std::vector<FilePath> utility::CompilationDatabase::getFrameworkHeaderPaths() co
 void utility::CompilationDatabase::init()
 {
 	std::string error;
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb(
-		clang::tooling::JSONCompilationDatabase::loadFromFile(
-			utility::encodeToUtf8(m_filePath.wstr()),
-			error,
-			clang::tooling::JSONCommandLineSyntax::AutoDetect));
+	std::shared_ptr<const CachedCompilationDatabase> cdb = CachedCompilationDatabase::load(
+		m_filePath, &error);
 
 	if (!cdb)
 	{
@@ -54,7 +49,6 @@ void utility::CompilationDatabase::init()
 		return;
 	}
 
-	std::vector<clang::tooling::CompileCommand> commands = cdb->getAllCompileCommands();
 	std::set<FilePath> frameworkHeaders;
 	std::set<FilePath> systemHeaders;
 	std::set<FilePath> headers;
@@ -64,16 +58,17 @@ void utility::CompilationDatabase::init()
 		const std::wstring systemIncludeFlag = L"-isystem";
 		const std::wstring quoteFlag = L"-iquote";
 		const std::wstring includeFlag = L"-I";
-		for (clang::tooling::CompileCommand& command: commands)
+		for (const CachedCompilationDatabase::Command& command: cdb->getCommands())
 		{
-			const std::wstring commandDirectory = utility::decodeFromUtf8(command.Directory);
-			for (size_t i = 0; i < command.CommandLine.size(); i++)
+			const std::wstring commandDirectory = utility::decodeFromUtf8(command.directory);
+			const std::vector<const std::string*>& arguments = command.arguments;
+			for (size_t i = 0; i < arguments.size(); i++)
 			{
-				std::wstring argument = utility::decodeFromUtf8(command.CommandLine[i]);
-				if (i + 1 < command.CommandLine.size() &&
-					!utility::isPrefix<std::string>("-", command.CommandLine[i + 1]))
+				std::wstring argument = utility::decodeFromUtf8(*arguments[i]);
+				if (i + 1 < arguments.size() &&
+					!utility::isPrefix<std::string>("-", *arguments[i + 1]))
 				{
-					argument += utility::decodeFromUtf8(command.CommandLine[++i]);
+					argument += utility::decodeFromUtf8(*arguments[++i]);
 				}
 
 				if (utility::isPrefix(frameworkIncludeFlag, argument))
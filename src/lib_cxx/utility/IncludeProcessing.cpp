@@ -1,15 +1,22 @@
 #include "IncludeProcessing.h"
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iterator>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "ApplicationSettings.h"
 #include "FilePath.h"
 #include "FileTree.h"
 #include "IncludeDirective.h"
+#include "TaskManager.h"
 #include "TextAccess.h"
 #include "TextCodec.h"
+#include "ThreadPool.h"
 #include "utility.h"
 #include "utilityString.h"
 
@@ -22,8 +29,158 @@ struct IncludeDirectiveComparator
 		return a.getIncludedFile() < b.getIncludedFile();
 	}
 };
+
+bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+// finds the included file of a line like: #  include <foo.h>
+bool getIncludedFile(
+	const char* begin, const char* end, std::string* includedFile, bool* usesBrackets)
+{
+	const char* it = begin;
+	while (it != end && isSpace(*it))
+	{
+		it++;
+	}
+	if (it == end || *it != '#')
+	{
+		return false;
+	}
+
+	it++;
+	while (it != end && isSpace(*it))
+	{
+		it++;
+	}
+
+	static const char keyword[] = "include";
+	const size_t keywordLength = sizeof(keyword) - 1;
+	if (size_t(end - it) < keywordLength || std::string(it, it + keywordLength) != keyword)
+	{
+		return false;
+	}
+	it += keywordLength;
+
+	const char* openingBracket = std::find(it, end, '<');
+	const char* closingBracket = std::find(openingBracket, end, '>');
+	if (closingBracket != end && closingBracket - openingBracket > 1)
+	{
+		includedFile->assign(openingBracket + 1, closingBracket);
+		*usesBrackets = true;
+		return true;
+	}
+
+	const char* openingQuote = std::find(it, end, '"');
+	const char* closingQuote = openingQuote != end ? std::find(openingQuote + 1, end, '"') : end;
+	if (closingQuote != end && closingQuote - openingQuote > 1)
+	{
+		includedFile->assign(openingQuote + 1, closingQuote);
+		*usesBrackets = false;
+		return true;
+	}
+
+	return false;
+}
+
+std::string readFileContent(const FilePath& filePath)
+{
+	std::ifstream file(filePath.str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return std::string();
+	}
+
+	file.seekg(0, std::ios::end);
+	const std::streamoff size = file.tellg();
+	if (size <= 0)
+	{
+		return std::string();
+	}
+
+	std::string content(size_t(size), '\0');
+	file.seekg(0, std::ios::beg);
+	file.read(&content[0], size);
+	content.resize(size_t(file.gcount()));
+	return content;
+}
+
+// calls the function for all file paths in parallel, every thread uses its own codec
+template <typename ResultType, typename FunctionType>
+std::vector<ResultType> processInParallel(
+	const std::vector<FilePath>& filePaths, const std::string& encoding, FunctionType function)
+{
+	std::vector<ResultType> results(filePaths.size());
+
+	std::atomic<size_t> nextIndex(0);
+	auto process = [&]() {
+		TextCodec codec(encoding);
+		for (size_t i = nextIndex++; i < filePaths.size(); i = nextIndex++)
+		{
+			function(filePaths[i], codec, &results[i]);
+		}
+	};
+
+	std::shared_ptr<ThreadPool> threadPool = TaskManager::getThreadPool();
+	threadPool->parallelFor(
+		std::min<size_t>(threadPool->getWorkerCount(), filePaths.size()),
+		[&](size_t) { process(); },
+		ThreadPool::PRIORITY_INDEXING);
+
+	return results;
+}
 }	 // namespace
 
+// the same header search directories get checked for most of the include directives, so the
+// results of the file system queries are shared between all threads
+class IncludeProcessing::FileStatusCache
+{
+public:
+	bool exists(const FilePath& filePath)
+	{
+		const std::wstring key = filePath.wstr();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_exists.find(key);
+			if (it != m_exists.end())
+			{
+				return it->second;
+			}
+		}
+
+		const bool exists = filePath.exists();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_exists.emplace(key, exists);
+		return exists;
+	}
+
+	FilePath getCanonical(const FilePath& filePath)
+	{
+		const std::wstring key = filePath.wstr();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_canonicalPaths.find(key);
+			if (it != m_canonicalPaths.end())
+			{
+				return FilePath(it->second);
+			}
+		}
+
+		const FilePath canonicalPath = filePath.getCanonical();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_canonicalPaths.emplace(key, canonicalPath.wstr());
+		return canonicalPath;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::unordered_map<std::wstring, bool> m_exists;
+	std::unordered_map<std::wstring, std::wstring> m_canonicalPaths;
+};
+
 std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
 	const std::set<FilePath>& sourceFilePaths,
 	const std::set<FilePath>& indexedPaths,
@@ -31,6 +188,7 @@ std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
 	const size_t desiredQuantileCount,
 	std::function<void(float)> progress)
 {
+	FileStatusCache fileStatusCache;
 	std::unordered_set<std::wstring> processedFilePaths;
 	std::set<IncludeDirective, IncludeDirectiveComparator> unresolvedIncludeDirectives;
 
@@ -42,7 +200,11 @@ std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
 		progress(float(i) / parts.size());
 
 		const std::vector<IncludeDirective> directives = doGetUnresolvedIncludeDirectives(
-			utility::toSet(parts[i]), processedFilePaths, indexedPaths, headerSearchDirectories);
+			utility::toSet(parts[i]),
+			processedFilePaths,
+			indexedPaths,
+			headerSearchDirectories,
+			&fileStatusCache);
 		std::copy(
 			directives.begin(),
 			directives.end(),
@@ -76,6 +238,48 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(
 		existingFileTrees.push_back(std::make_shared<FileTree>(searchedPath));
 	}
 
+	const std::string encoding = ApplicationSettings::getInstance()->getTextEncoding();
+	FileStatusCache fileStatusCache;
+
+	struct FileResult
+	{
+		std::vector<FilePath> headerSearchDirectories;
+		std::vector<FilePath> includedFilePaths;
+	};
+
+	auto processFile = [&](const FilePath& filePath, const TextCodec& codec, FileResult* result) {
+		for (const IncludeDirective& includeDirective: getIncludeDirectives(filePath, codec))
+		{
+			const FilePath includedFilePath = includeDirective.getIncludedFile();
+
+			FilePath foundIncludedPath = resolveIncludeDirective(
+				includeDirective, currentHeaderSearchDirectories, &fileStatusCache);
+			if (foundIncludedPath.empty())
+			{
+				for (std::shared_ptr<FileTree> existingFileTree: existingFileTrees)
+				{
+					// TODO: handle the case where a file can be found by two different paths
+					const FilePath rootPath =
+						existingFileTree->getAbsoluteRootPathForRelativeFilePath(includedFilePath);
+					if (!rootPath.empty())
+					{
+						foundIncludedPath = rootPath.getConcatenated(includedFilePath);
+						if (fileStatusCache.exists(foundIncludedPath))
+						{
+							result->headerSearchDirectories.push_back(rootPath);
+							break;
+						}
+					}
+				}
+			}
+			if (!foundIncludedPath.empty() && fileStatusCache.exists(foundIncludedPath))
+			{
+				result->includedFilePaths.push_back(
+					fileStatusCache.getCanonical(foundIncludedPath));
+			}
+		}
+	};
+
 	std::set<FilePath> headerSearchDirectories;
 	std::unordered_set<std::wstring> processedFilePaths;
 	std::vector<std::vector<FilePath>> parts = utility::splitToEqualySizedParts(
@@ -95,44 +299,22 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(
 				std::inserter(processedFilePaths, processedFilePaths.begin()),
 				[](const FilePath& p) { return p.getAbsolute().wstr(); });
 
-			std::set<FilePath> unprocessedFilePathsForNextIteration;
+			// the files of one iteration are scanned in parallel and merged in their order
+			const std::vector<FileResult> results = processInParallel<FileResult>(
+				utility::toVector(unprocessedFilePaths), encoding, processFile);
 
-			for (const FilePath& unprocessedFilePath: unprocessedFilePaths)
+			std::set<FilePath> unprocessedFilePathsForNextIteration;
+			for (const FileResult& result: results)
 			{
-				for (const IncludeDirective& includeDirective:
-					 getIncludeDirectives(unprocessedFilePath))
-				{
-					const FilePath includedFilePath = includeDirective.getIncludedFile();
+				headerSearchDirectories.insert(
+					result.headerSearchDirectories.begin(), result.headerSearchDirectories.end());
 
-					FilePath foundIncludedPath = resolveIncludeDirective(
-						includeDirective, currentHeaderSearchDirectories);
-					if (foundIncludedPath.empty())
-					{
-						for (std::shared_ptr<FileTree> existingFileTree: existingFileTrees)
-						{
-							// TODO: handle the case where a file can be found by two different paths
-							const FilePath rootPath =
-								existingFileTree->getAbsoluteRootPathForRelativeFilePath(
-									includedFilePath);
-							if (!rootPath.empty())
-							{
-								foundIncludedPath = rootPath.getConcatenated(includedFilePath);
-								if (foundIncludedPath.exists())
-								{
-									headerSearchDirectories.insert(rootPath);
-									break;
-								}
-							}
-						}
-					}
-					if (foundIncludedPath.exists())
+				for (const FilePath& includedFilePath: result.includedFilePaths)
+				{
+					if (processedFilePaths.find(includedFilePath.wstr()) ==
+						processedFilePaths.end())
 					{
-						foundIncludedPath.makeCanonical();
-						if (processedFilePaths.find(foundIncludedPath.wstr()) ==
-							processedFilePaths.end())
-						{
-							unprocessedFilePathsForNextIteration.insert(foundIncludedPath);
-						}
+						unprocessedFilePathsForNextIteration.insert(includedFilePath);
 					}
 				}
 			}
@@ -148,11 +330,8 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(
 
 std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(const FilePath& filePath)
 {
-	if (filePath.exists())
-	{
-		return getIncludeDirectives(TextAccess::createFromFile(filePath));
-	}
-	return std::vector<IncludeDirective>();
+	return getIncludeDirectives(
+		filePath, TextCodec(ApplicationSettings::getInstance()->getTextEncoding()));
 }
 
 std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(
@@ -161,34 +340,58 @@ std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(
 	std::vector<IncludeDirective> includeDirectives;
 
 	TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
-	const std::vector<std::string> lines = textAccess->getAllLines();
-	for (size_t i = 0; i < lines.size(); i++)
+	const unsigned int lineCount = textAccess->getLineCount();
+	for (unsigned int lineNumber = 1; lineNumber <= lineCount; lineNumber++)
 	{
-		const std::wstring line = codec.decode(lines[i]);
-		const std::wstring lineTrimmedToHash = utility::trim(line);
-		if (utility::isPrefix<std::wstring>(L"#", lineTrimmedToHash))
+		const TextAccess::LineView line = textAccess->getLineView(lineNumber);
+		std::string includedFile;
+		bool usesBrackets = false;
+		if (getIncludedFile(line.data, line.data + line.size, &includedFile, &usesBrackets))
 		{
-			const std::wstring lineTrimmedToInclude = utility::trim(lineTrimmedToHash.substr(1));
-			if (utility::isPrefix<std::wstring>(L"include", lineTrimmedToInclude))
-			{
-				std::wstring includeString = utility::substrBetween<std::wstring>(
-					lineTrimmedToInclude, L"<", L">");
-				bool usesBrackets = true;
-				if (includeString.empty())
-				{
-					includeString = utility::substrBetween<std::wstring>(
-						lineTrimmedToInclude, L"\"", L"\"");
-					usesBrackets = false;
-				}
+			includeDirectives.push_back(IncludeDirective(
+				FilePath(codec.decode(includedFile)),
+				textAccess->getFilePath(),
+				lineNumber,
+				usesBrackets));
+		}
+	}
 
-				if (!includeString.empty())
-				{
-					// lines are 1 based
-					includeDirectives.push_back(IncludeDirective(
-						FilePath(includeString), textAccess->getFilePath(), i + 1, usesBrackets));
-				}
-			}
+	return includeDirectives;
+}
+
+std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(
+	const FilePath& filePath, const TextCodec& codec)
+{
+	std::vector<IncludeDirective> includeDirectives;
+
+	// the whole file is read at once and only lines with a '#' are looked at more closely
+	const std::string content = readFileContent(filePath);
+	const char* const end = content.data() + content.size();
+
+	size_t lineNumber = 1;
+	for (const char* lineBegin = content.data(); lineBegin < end; lineNumber++)
+	{
+		const char* lineEnd = lineBegin;
+		while (lineEnd != end && *lineEnd != '\n' && *lineEnd != '\r')
+		{
+			lineEnd++;
 		}
+
+		std::string includedFile;
+		bool usesBrackets = false;
+		if (std::find(lineBegin, lineEnd, '#') != lineEnd &&
+			getIncludedFile(lineBegin, lineEnd, &includedFile, &usesBrackets))
+		{
+			includeDirectives.push_back(IncludeDirective(
+				FilePath(codec.decode(includedFile)), filePath, lineNumber, usesBrackets));
+		}
+
+		// lines may end with "\n", "\r\n" or "\r"
+		if (lineEnd != end && *lineEnd == '\r' && lineEnd + 1 != end && lineEnd[1] == '\n')
+		{
+			lineEnd++;
+		}
+		lineBegin = lineEnd + 1;
 	}
 
 	return includeDirectives;
@@ -198,8 +401,34 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
 	std::set<FilePath> filePathsToProcess,
 	std::unordered_set<std::wstring>& processedFilePaths,
 	const std::set<FilePath>& indexedPaths,
-	const std::set<FilePath>& headerSearchDirectories)
+	const std::set<FilePath>& headerSearchDirectories,
+	FileStatusCache* fileStatusCache)
 {
+	const std::string encoding = ApplicationSettings::getInstance()->getTextEncoding();
+
+	struct FileResult
+	{
+		std::vector<IncludeDirective> unresolvedIncludeDirectives;
+		std::vector<FilePath> resolvedIncludePaths;
+	};
+
+	auto processFile = [&](const FilePath& filePath, const TextCodec& codec, FileResult* result) {
+		for (const IncludeDirective& includeDirective: getIncludeDirectives(filePath, codec))
+		{
+			const FilePath resolvedIncludePath = resolveIncludeDirective(
+				includeDirective, headerSearchDirectories, fileStatusCache);
+			if (resolvedIncludePath.empty())
+			{
+				result->unresolvedIncludeDirectives.push_back(includeDirective);
+			}
+			else
+			{
+				result->resolvedIncludePaths.push_back(
+					fileStatusCache->getCanonical(resolvedIncludePath));
+			}
+		}
+	};
+
 	std::vector<IncludeDirective> unresolvedIncludeDirectives;
 
 	while (!filePathsToProcess.empty())
@@ -210,19 +439,21 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
 			std::inserter(processedFilePaths, processedFilePaths.begin()),
 			[](const FilePath& p) { return p.getAbsolute().makeCanonical().wstr(); });
 
-		std::set<FilePath> filePathsToProcessForNextIteration;
+		// the files of one iteration are scanned in parallel and merged in their order
+		const std::vector<FileResult> results = processInParallel<FileResult>(
+			utility::toVector(filePathsToProcess), encoding, processFile);
 
-		for (const FilePath& filePath: filePathsToProcess)
+		std::set<FilePath> filePathsToProcessForNextIteration;
+		for (const FileResult& result: results)
 		{
-			for (const IncludeDirective& includeDirective: getIncludeDirectives(filePath))
+			for (const IncludeDirective& includeDirective: result.unresolvedIncludeDirectives)
 			{
-				const FilePath resolvedIncludePath =
-					resolveIncludeDirective(includeDirective, headerSearchDirectories).makeCanonical();
-				if (resolvedIncludePath.empty())
-				{
-					unresolvedIncludeDirectives.push_back(includeDirective);
-				}
-				else if (processedFilePaths.find(resolvedIncludePath.wstr()) == processedFilePaths.end())
+				unresolvedIncludeDirectives.push_back(includeDirective);
+			}
+
+			for (const FilePath& resolvedIncludePath: result.resolvedIncludePaths)
+			{
+				if (processedFilePaths.find(resolvedIncludePath.wstr()) == processedFilePaths.end())
 				{
 					for (const FilePath& indexedPath: indexedPaths)
 					{
@@ -243,7 +474,9 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
 }
 
 FilePath IncludeProcessing::resolveIncludeDirective(
-	const IncludeDirective& includeDirective, const std::set<FilePath>& headerSearchDirectories)
+	const IncludeDirective& includeDirective,
+	const std::set<FilePath>& headerSearchDirectories,
+	FileStatusCache* fileStatusCache)
 {
 	const FilePath includedFilePath = includeDirective.getIncludedFile();
 
@@ -252,7 +485,7 @@ FilePath IncludeProcessing::resolveIncludeDirective(
 		if (includedFilePath.isAbsolute())
 		{
 			const FilePath resolvedIncludePath = includedFilePath;
-			if (resolvedIncludePath.exists())
+			if (fileStatusCache->exists(resolvedIncludePath))
 			{
 				return includedFilePath;
 			}
@@ -263,7 +496,7 @@ FilePath IncludeProcessing::resolveIncludeDirective(
 		// check for an include path relative to the including path
 		const FilePath resolvedIncludePath =
 			includeDirective.getIncludingFile().getParentDirectory().concatenate(includedFilePath);
-		if (resolvedIncludePath.exists())
+		if (fileStatusCache->exists(resolvedIncludePath))
 		{
 			return resolvedIncludePath;
 		}
@@ -275,7 +508,7 @@ FilePath IncludeProcessing::resolveIncludeDirective(
 		{
 			const FilePath resolvedIncludePath = headerSearchDirectory.getConcatenated(
 				includedFilePath);
-			if (resolvedIncludePath.exists())
+			if (fileStatusCache->exists(resolvedIncludePath))
 			{
 				return resolvedIncludePath;
 			}
@@ -11,6 +11,7 @@
 class FilePath;
 class IncludeDirective;
 class TextAccess;
+class TextCodec;
 
 class IncludeProcessing
 {
@@ -34,14 +35,22 @@ public:
 	static std::vector<IncludeDirective> getIncludeDirectives(std::shared_ptr<TextAccess> textAccess);
 
 private:
+	class FileStatusCache;
+
 	static std::vector<IncludeDirective> doGetUnresolvedIncludeDirectives(
 		std::set<FilePath> filePathsToProcess,
 		std::unordered_set<std::wstring>& processedFilePaths,
 		const std::set<FilePath>& indexedPaths,
-		const std::set<FilePath>& headerSearchDirectories);
+		const std::set<FilePath>& headerSearchDirectories,
+		FileStatusCache* fileStatusCache);
+
+	static std::vector<IncludeDirective> getIncludeDirectives(
+		const FilePath& filePath, const TextCodec& codec);
 
 	static FilePath resolveIncludeDirective(
-		const IncludeDirective& includeDirective, const std::set<FilePath>& headerSearchDirectories);
+		const IncludeDirective& includeDirective,
+		const std::set<FilePath>& headerSearchDirectories,
+		FileStatusCache* fileStatusCache);
 
 	IncludeProcessing() = delete;
 };
@@ -6,6 +6,7 @@
 #include "LogManager.h"
 #include "MessageLoadProject.h"
 #include "MessageWindowFocus.h"
+#include "UserActivity.h"
 #include "utilityApp.h"
 
 QtApplication::QtApplication(int& argc, char** argv): QApplication(argc, argv)
@@ -41,6 +42,24 @@ bool QtApplication::event(QEvent* event)
 	return QApplication::event(event);
 }
 
+bool QtApplication::notify(QObject* receiver, QEvent* event)
+{
+	switch (event->type())
+	{
+	case QEvent::KeyPress:
+	case QEvent::MouseButtonPress:
+	case QEvent::MouseButtonDblClick:
+	case QEvent::Wheel:
+	case QEvent::TouchBegin:
+		UserActivity::notify();
+		break;
+	default:
+		break;
+	}
+
+	return QApplication::notify(receiver, event);
+}
+
 void QtApplication::onApplicationStateChanged(Qt::ApplicationState state)
 {
 	MessageWindowFocus(state == Qt::ApplicationActive).dispatch();
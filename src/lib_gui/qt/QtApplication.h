@@ -10,6 +10,8 @@ public:
 	QtApplication(int& argc, char** argv);
 
 	bool event(QEvent* event);
+	// records the input of the user before delivering it
+	bool notify(QObject* receiver, QEvent* event) override;
 	int exec();
 
 private slots:
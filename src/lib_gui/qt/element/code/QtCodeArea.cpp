@@ -1,6 +1,7 @@
 #include "QtCodeArea.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include <QApplication>
 #include <QDrag>
@@ -146,8 +147,69 @@ void QtCodeArea::lineNumberAreaPaintEvent(QPaintEvent* event)
 	int top = static_cast<int>(blockBoundingGeometry(block).translated(contentOffset()).top());
 	int bottom = top + static_cast<int>(blockBoundingRect(block).height());
 
-	std::set<int> activeLineNumbers;
-	std::set<int> focusedLineNumbers;
+	if (m_lineNumberMarkersRevision != m_annotationsRevision)
+	{
+		createLineNumberMarkers(&m_activeLineNumbers, &m_focusedLineNumbers);
+		m_lineNumberMarkersRevision = m_annotationsRevision;
+	}
+
+	ColorScheme* scheme = ColorScheme::getInstance().get();
+
+	QColor textColor(scheme->getColor("code/snippet/line_number/text").c_str());
+	QColor inactiveTextColor(scheme->getColor("code/snippet/line_number/inactive_text").c_str());
+	QColor activeMarkerColor(scheme->getColor("code/snippet/line_number/marker/active").c_str());
+	QColor focusedMarkerColor(scheme->getColor("code/snippet/line_number/marker/focus").c_str());
+
+	QPen p = painter.pen();
+
+	int drawAreaTop = event->rect().top();
+	int drawAreaBottom = event->rect().bottom() + 1;
+
+	if (horizontalScrollBar()->minimum() != horizontalScrollBar()->maximum() &&
+		utility::getOsType() != OS_MAC && drawAreaBottom > height() - horizontalScrollBar()->height())
+	{
+		drawAreaBottom = height() - horizontalScrollBar()->height();
+	}
+
+	while (block.isValid() && top <= drawAreaBottom)
+	{
+		if (block.isVisible() && bottom >= drawAreaTop)
+		{
+			const int number = blockNumber + getStartLineNumber();
+			const int height = bottom - top - std::max(0, bottom - drawAreaBottom);
+
+			p.setColor(textColor);
+
+			if (m_focusedLineNumbers.find(number) != m_focusedLineNumbers.end())
+			{
+				painter.fillRect(m_lineNumberArea->width() - 8, top, 3, height, focusedMarkerColor);
+			}
+			else if (m_activeLineNumbers.find(number) != m_activeLineNumbers.end())
+			{
+				painter.fillRect(m_lineNumberArea->width() - 8, top, 3, height, activeMarkerColor);
+			}
+			else if (!m_isActiveFile)
+			{
+				p.setColor(inactiveTextColor);
+			}
+
+			painter.setPen(p);
+			painter.drawText(
+				0, top, m_lineNumberArea->width() - 16, height, Qt::AlignRight, QString::number(number));
+		}
+
+		block = block.next();
+		top = bottom;
+		bottom = top + static_cast<int>(blockBoundingRect(block).height());
+		blockNumber++;
+	}
+}
+
+void QtCodeArea::createLineNumberMarkers(
+	std::set<int>* activeLineNumbers, std::set<int>* focusedLineNumbers) const
+{
+	activeLineNumbers->clear();
+	focusedLineNumbers->clear();
 
 	const std::set<Id>& activeSymbolIds = m_navigator->getActiveTokenIds();
 	const std::set<Id>& activeLocalTokenIds = m_navigator->getActiveLocalTokenIds();
@@ -210,66 +272,50 @@ void QtCodeArea::lineNumberAreaPaintEvent(QPaintEvent* event)
 			{
 				if (active)
 				{
-					activeLineNumbers.insert(i);
+					activeLineNumbers->insert(i);
 				}
 				else
 				{
-					focusedLineNumbers.insert(i);
+					focusedLineNumbers->insert(i);
 				}
 			}
 		}
 	}
+}
 
-	ColorScheme* scheme = ColorScheme::getInstance().get();
-
-	QColor textColor(scheme->getColor("code/snippet/line_number/text").c_str());
-	QColor inactiveTextColor(scheme->getColor("code/snippet/line_number/inactive_text").c_str());
-	QColor activeMarkerColor(scheme->getColor("code/snippet/line_number/marker/active").c_str());
-	QColor focusedMarkerColor(scheme->getColor("code/snippet/line_number/marker/focus").c_str());
-
-	QPen p = painter.pen();
+void QtCodeArea::updateLineNumberMarkers()
+{
+	std::set<int> activeLineNumbers;
+	std::set<int> focusedLineNumbers;
+	createLineNumberMarkers(&activeLineNumbers, &focusedLineNumbers);
 
-	int drawAreaTop = event->rect().top();
-	int drawAreaBottom = event->rect().bottom() + 1;
+	// only lines with changed markers are painted again
+	std::vector<int> changedLineNumbers;
+	std::set_symmetric_difference(
+		activeLineNumbers.begin(),
+		activeLineNumbers.end(),
+		m_activeLineNumbers.begin(),
+		m_activeLineNumbers.end(),
+		std::back_inserter(changedLineNumbers));
+	std::set_symmetric_difference(
+		focusedLineNumbers.begin(),
+		focusedLineNumbers.end(),
+		m_focusedLineNumbers.begin(),
+		m_focusedLineNumbers.end(),
+		std::back_inserter(changedLineNumbers));
 
-	if (horizontalScrollBar()->minimum() != horizontalScrollBar()->maximum() &&
-		utility::getOsType() != OS_MAC && drawAreaBottom > height() - horizontalScrollBar()->height())
+	QRegion changedRegion;
+	for (int lineNumber: changedLineNumbers)
 	{
-		drawAreaBottom = height() - horizontalScrollBar()->height();
+		const QRect rect = getRectForLines(lineNumber, lineNumber);
+		changedRegion += QRect(0, rect.top(), m_lineNumberArea->width(), rect.height());
 	}
 
-	while (block.isValid() && top <= drawAreaBottom)
-	{
-		if (block.isVisible() && bottom >= drawAreaTop)
-		{
-			const int number = blockNumber + getStartLineNumber();
-			const int height = bottom - top - std::max(0, bottom - drawAreaBottom);
-
-			p.setColor(textColor);
+	m_activeLineNumbers.swap(activeLineNumbers);
+	m_focusedLineNumbers.swap(focusedLineNumbers);
+	m_lineNumberMarkersRevision = m_annotationsRevision;
 
-			if (focusedLineNumbers.find(number) != focusedLineNumbers.end())
-			{
-				painter.fillRect(m_lineNumberArea->width() - 8, top, 3, height, focusedMarkerColor);
-			}
-			else if (activeLineNumbers.find(number) != activeLineNumbers.end())
-			{
-				painter.fillRect(m_lineNumberArea->width() - 8, top, 3, height, activeMarkerColor);
-			}
-			else if (!m_isActiveFile)
-			{
-				p.setColor(inactiveTextColor);
-			}
-
-			painter.setPen(p);
-			painter.drawText(
-				0, top, m_lineNumberArea->width() - 16, height, Qt::AlignRight, QString::number(number));
-		}
-
-		block = block.next();
-		top = bottom;
-		bottom = top + static_cast<int>(blockBoundingRect(block).height());
-		blockNumber++;
-	}
+	m_lineNumberArea->update(changedRegion);
 }
 
 int QtCodeArea::lineNumberDigits() const
@@ -433,18 +479,50 @@ QRectF QtCodeArea::getLineRectForLineNumber(size_t lineNumber) const
 void QtCodeArea::findScreenMatches(
 	const std::wstring& query, std::vector<std::pair<QtCodeArea*, Id>>* screenMatches)
 {
-	TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
-	// remove carriage return
-	const std::wstring& code = utility::toLowerCase(
-		codec.decode(utility::replace(getCode(), "\r", "")));
-	size_t pos = 0;
-	while (pos != std::string::npos)
+	if (!m_hasLowerCaseCode)
+	{
+		TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+		// remove carriage return
+		m_lowerCaseCode = utility::toLowerCase(
+			codec.decode(utility::replace(getCode(), "\r", "")));
+		m_hasLowerCaseCode = true;
+	}
+
+	const std::wstring& code = m_lowerCaseCode;
+	if (m_screenMatchQuery.size() &&
+		query.compare(0, m_screenMatchQuery.size(), m_screenMatchQuery) == 0)
 	{
-		pos = code.find(query, pos);
-		if (pos == std::string::npos)
+		std::vector<size_t> positions;
+		for (size_t pos: m_screenMatchPositions)
 		{
-			break;
+			if (code.compare(pos, query.size(), query) == 0)
+			{
+				positions.push_back(pos);
+			}
+		}
+		m_screenMatchPositions.swap(positions);
+	}
+	else
+	{
+		// overlapping positions are kept for extending queries, matches are not overlapping
+		m_screenMatchPositions.clear();
+		size_t pos = code.find(query);
+		while (pos != std::wstring::npos)
+		{
+			m_screenMatchPositions.push_back(pos);
+			pos = code.find(query, pos + 1);
 		}
+	}
+	m_screenMatchQuery = query;
+
+	size_t matchEnd = 0;
+	for (size_t pos: m_screenMatchPositions)
+	{
+		if (pos < matchEnd)
+		{
+			continue;
+		}
+		matchEnd = pos + query.size();
 
 		Annotation matchAnnotation;
 		matchAnnotation.start = pos;
@@ -467,12 +545,11 @@ void QtCodeArea::findScreenMatches(
 
 		m_annotations.push_back(matchAnnotation);
 		screenMatches->push_back(std::make_pair(this, matchAnnotation.locationId));
-
-		pos += query.size();
 	}
 
 	if (screenMatches->size() && screenMatches->back().first == this)
 	{
+		m_annotationsRevision++;
 		viewport()->update();
 	}
 }
@@ -489,6 +566,7 @@ void QtCodeArea::clearScreenMatches()
 	if (i != m_annotations.size())
 	{
 		m_annotations.erase(m_annotations.begin() + i, m_annotations.end());
+		m_annotationsRevision++;
 		viewport()->update();
 	}
 }
@@ -900,7 +978,7 @@ void QtCodeArea::annotateText()
 		activeSymbolIds, activeLocationIds, focusedSymbolIds);
 	if (needsUpdate)
 	{
-		m_lineNumberArea->update();
+		updateLineNumberMarkers();
 	}
 }
 
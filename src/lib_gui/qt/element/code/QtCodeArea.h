@@ -2,6 +2,7 @@
 #define QT_CODE_AREA_H
 
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "QtCodeField.h"
@@ -112,6 +113,10 @@ private:
 
 	void activateAnnotationsOrErrors(const std::vector<const Annotation*>& annotations);
 
+	void createLineNumberMarkers(
+		std::set<int>* activeLineNumbers, std::set<int>* focusedLineNumbers) const;
+	void updateLineNumberMarkers();
+
 	void annotateText();
 
 	void createActions();
@@ -135,6 +140,18 @@ private:
 	bool m_isActiveFile;
 	bool m_showLineNumbers;
 
+	// lines marked in the line number area for a revision of the annotations
+	std::set<int> m_activeLineNumbers;
+	std::set<int> m_focusedLineNumbers;
+	size_t m_lineNumberMarkersRevision = 0;
+
+	// the code does not change, so its lower case text is built for the first screen search.
+	// All positions of the last query are kept, queries extending it only check them.
+	std::wstring m_lowerCaseCode;
+	bool m_hasLowerCaseCode = false;
+	std::wstring m_screenMatchQuery;
+	std::vector<size_t> m_screenMatchPositions;
+
 	QtScrollSpeedChangeListener m_scrollSpeedChangeListener;
 };
 
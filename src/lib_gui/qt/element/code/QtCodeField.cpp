@@ -2,6 +2,7 @@
 
 #include <QAction>
 #include <QPainter>
+#include <QScrollBar>
 #include <QTextBlock>
 #include <QTextCodec>
 
@@ -101,6 +102,11 @@ QtCodeField::QtCodeField(
 	m_openInTabAction->setToolTip("Opens the node in a new tab");
 	m_openInTabAction->setEnabled(false);
 	connect(m_openInTabAction, &QAction::triggered, this, &QtCodeField::openInTab);
+
+	// content coordinates are relative to the first visible block
+	connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int) {
+		clearAnnotationRects();
+	});
 }
 
 QtCodeField::~QtCodeField() {}
@@ -169,7 +175,6 @@ void QtCodeField::paintEvent(QPaintEvent* event)
 	QTextBlock block = firstVisibleBlock();
 	int top = blockBoundingGeometry(block).translated(contentOffset()).top();
 	int bottom = top + blockBoundingRect(block).height();
-	int blockHeight = blockBoundingRect(block).height();
 
 	int firstVisibleLine = -1;
 	int lastVisibleLine = -1;
@@ -198,7 +203,8 @@ void QtCodeField::paintEvent(QPaintEvent* event)
 	firstVisibleLine += m_startLineNumber;
 	lastVisibleLine += m_startLineNumber;
 
-	int borderRadius = 3;
+	const int borderRadius = 3;
+	const QPoint offset = contentOffset().toPoint();
 
 	for (const Annotation& annotation: m_annotations)
 	{
@@ -230,20 +236,15 @@ void QtCodeField::paintEvent(QPaintEvent* event)
 		painter.setPen(pen);
 		painter.setBrush(QBrush(color.fill.c_str()));
 
-		if (annotation.locationType == LOCATION_SCOPE)
-		{
-			painter.drawRoundedRect(
-				0,
-				top + (annotation.startLine - m_startLineNumber) * blockHeight,
-				width(),
-				(annotation.endLine - annotation.startLine + 1) * blockHeight,
-				borderRadius,
-				borderRadius);
-		}
-		else
+		for (QRect rect: getContentRectsForAnnotation(annotation))
 		{
-			std::vector<QRect> rects = getCursorRectsForAnnotation(annotation);
-			for (QRect rect: rects)
+			rect.translate(offset);
+			if (annotation.locationType == LOCATION_SCOPE)
+			{
+				painter.drawRoundedRect(
+					0, rect.top(), width(), rect.height(), borderRadius, borderRadius);
+			}
+			else
 			{
 				rect.adjust(-1, 0, 1, 1);
 				painter.drawRoundedRect(rect, borderRadius, borderRadius);
@@ -254,6 +255,16 @@ void QtCodeField::paintEvent(QPaintEvent* event)
 	QPlainTextEdit::paintEvent(event);
 }
 
+void QtCodeField::changeEvent(QEvent* event)
+{
+	if (event->type() == QEvent::FontChange)
+	{
+		clearAnnotationRects();
+	}
+
+	QPlainTextEdit::changeEvent(event);
+}
+
 void QtCodeField::enterEvent(QEvent* event) {}
 
 void QtCodeField::leaveEvent(QEvent* event)
@@ -335,6 +346,9 @@ bool QtCodeField::annotateText(
 	const std::set<Id>& activeLocationIds,
 	const std::set<Id>& focusedSymbolIds)
 {
+	// only the lines of annotations changing their state are painted again
+	QRegion changedRegion;
+
 	for (size_t i = 0; i < m_annotations.size(); i++)
 	{
 		Annotation& annotation = m_annotations[i];
@@ -370,12 +384,14 @@ bool QtCodeField::annotateText(
 		if (wasFocused != annotation.isFocused || wasActive != annotation.isActive)
 		{
 			m_linesToRehighlight.push_back(annotation.startLine - m_startLineNumber);
+			changedRegion += getRectForLines(annotation.startLine, annotation.endLine);
 		}
 	}
 
 	if (m_linesToRehighlight.size())
 	{
-		viewport()->update();
+		m_annotationsRevision++;
+		viewport()->update(changedRegion);
 		return true;
 	}
 
@@ -388,6 +404,7 @@ void QtCodeField::createAnnotations(std::shared_ptr<SourceLocationFile> location
 
 	m_locationFile = locationFile;
 	m_annotations.clear();
+	m_annotationsRevision++;
 
 	size_t endLineNumber = getEndLineNumber();
 	std::set<Id> locationIds;
@@ -632,6 +649,25 @@ std::vector<QRect> QtCodeField::getCursorRectsForAnnotation(const Annotation& an
 	return rects;
 }
 
+QRect QtCodeField::getRectForLines(int startLine, int endLine) const
+{
+	const int lastBlockNumber = document()->blockCount() - 1;
+	const QTextBlock startBlock = document()->findBlockByNumber(
+		std::max(0, std::min(startLine - int(m_startLineNumber), lastBlockNumber)));
+	const QTextBlock endBlock = document()->findBlockByNumber(
+		std::max(0, std::min(endLine - int(m_startLineNumber), lastBlockNumber)));
+
+	const QRectF startRect = blockBoundingGeometry(startBlock).translated(contentOffset());
+	const QRectF endRect = blockBoundingGeometry(endBlock).translated(contentOffset());
+
+	// annotation borders reach one pixel into the surrounding lines
+	return QRect(
+		0,
+		int(startRect.top()) - 1,
+		viewport()->width(),
+		int(endRect.bottom() - startRect.top()) + 2);
+}
+
 const QtCodeField::AnnotationColor& QtCodeField::getAnnotationColorForAnnotation(
 	const Annotation& annotation)
 {
@@ -752,6 +788,39 @@ void QtCodeField::openInTab()
 	}
 }
 
+const std::vector<QRect>& QtCodeField::getContentRectsForAnnotation(
+	const Annotation& annotation) const
+{
+	if (annotation.rects.empty())
+	{
+		const QPoint offset = contentOffset().toPoint();
+		if (annotation.locationType == LOCATION_SCOPE)
+		{
+			annotation.rects.push_back(
+				getRectForLines(annotation.startLine, annotation.endLine).adjusted(0, 1, 0, -1));
+		}
+		else
+		{
+			annotation.rects = getCursorRectsForAnnotation(annotation);
+		}
+
+		for (QRect& rect: annotation.rects)
+		{
+			rect.translate(-offset);
+		}
+	}
+
+	return annotation.rects;
+}
+
+void QtCodeField::clearAnnotationRects()
+{
+	for (const Annotation& annotation: m_annotations)
+	{
+		annotation.rects.clear();
+	}
+}
+
 void QtCodeField::createLineLengthCache()
 {
 	m_endTextEditPosition = -1;
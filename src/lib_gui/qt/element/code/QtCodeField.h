@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <set>
+#include <vector>
 
 #include <QPlainTextEdit>
 
@@ -44,6 +45,7 @@ public:
 
 protected:
 	virtual void paintEvent(QPaintEvent* event) override;
+	virtual void changeEvent(QEvent* event) override;
 	virtual void enterEvent(QEvent* event) override;
 	virtual void leaveEvent(QEvent* event) override;
 
@@ -73,6 +75,9 @@ protected:
 
 		bool isActive;
 		bool isFocused;
+
+		// cursor rects relative to the content, computed when the annotation is painted first
+		mutable std::vector<QRect> rects;
 	};
 
 	struct AnnotationColor
@@ -98,6 +103,8 @@ protected:
 
 	void setHoveredAnnotations(const std::vector<const Annotation*>& annotations);
 	std::vector<QRect> getCursorRectsForAnnotation(const Annotation& annotation) const;
+	// the rows of the lines in viewport coordinates, spanning the width of the viewport
+	QRect getRectForLines(int startLine, int endLine) const;
 
 	const AnnotationColor& getAnnotationColorForAnnotation(const Annotation& annotation);
 	void setTextColorForAnnotation(const Annotation& annotation, QColor color) const;
@@ -110,6 +117,8 @@ protected:
 	std::vector<Annotation> m_annotations;
 	std::vector<const Annotation*> m_hoveredAnnotations;
 	std::vector<int> m_linesToRehighlight;
+	// changes whenever annotations are added, removed or change their state
+	size_t m_annotationsRevision = 0;
 
 	QAction* m_openInTabAction;
 
@@ -119,6 +128,9 @@ private slots:
 private:
 	static std::vector<AnnotationColor> s_annotationColors;
 
+	const std::vector<QRect>& getContentRectsForAnnotation(const Annotation& annotation) const;
+	void clearAnnotationRects();
+
 	void createLineLengthCache();
 	void createMultibyteCharacterLocationCache(const QString& code);
 	int getColumnCorrectedForMultibyteCharacters(int line, int column) const;
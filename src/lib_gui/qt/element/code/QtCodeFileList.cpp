@@ -1,10 +1,14 @@
 #include "QtCodeFileList.h"
 
+#include <algorithm>
+
 #include <QScrollBar>
+#include <QStyle>
 #include <QTimer>
 #include <QVBoxLayout>
 
 #include "FilePath.h"
+#include "MessageCodeLoadReferencePage.h"
 #include "ResourcePaths.h"
 #include "utility.h"
 #include "utilityApp.h"
@@ -17,6 +21,12 @@
 #include "SourceLocationFile.h"
 #include "utilityQt.h"
 
+namespace
+{
+const size_t initialFileCount = 50;
+const size_t pendingFileBatchCount = 50;
+}	 // namespace
+
 QtCodeFileList::QtCodeFileList(QtCodeNavigator* navigator)
 	: QFrame()
 	, m_navigator(navigator)
@@ -78,6 +88,11 @@ QtCodeFileList::QtCodeFileList(QtCodeNavigator* navigator)
 		&QScrollBar::valueChanged,
 		m_navigator,
 		&QtCodeNavigator::scrolled);
+	connect(
+		m_scrollArea->verticalScrollBar(),
+		&QScrollBar::valueChanged,
+		this,
+		&QtCodeFileList::scrolled);
 }
 
 void QtCodeFileList::clear()
@@ -89,6 +104,10 @@ void QtCodeFileList::clear()
 	}
 
 	m_files.clear();
+	m_pendingFiles.clear();
+	m_pendingFilesComplete = true;
+	m_hasMoreFiles = false;
+	m_moreFilesRequested = false;
 	m_scrollArea->verticalScrollBar()->setValue(0);
 
 	clearSnippetTitleAndScrollBar();
@@ -102,32 +121,110 @@ void QtCodeFileList::clearSnippetTitleAndScrollBar()
 
 QtCodeFile* QtCodeFileList::getFile(const FilePath filePath)
 {
-	QtCodeFile* file = nullptr;
+	QtCodeFile* file = findFile(filePath);
 
-	for (QtCodeFile* filePtr: m_files)
+	if (!file && m_pendingFiles.size())
 	{
-		if (filePtr->getFilePath() == filePath)
-		{
-			file = filePtr;
-			break;
-		}
+		// keep the order of the files when a later file is requested directly
+		addPendingFiles(m_pendingFiles.size());
+		file = findFile(filePath);
 	}
 
 	if (!file)
 	{
-		file = new QtCodeFile(filePath, m_navigator, !m_files.size());
-		m_files.push_back(file);
-
-		m_filesArea->layout()->addWidget(file);
-		file->hide();
+		file = createFile(filePath);
 	}
 
 	return file;
 }
 
 void QtCodeFileList::addFile(const CodeFileParams& params)
+{
+	// all files are added again on each update, followed by updateFiles()
+	if (m_pendingFilesComplete)
+	{
+		m_pendingFiles.clear();
+		m_pendingFilesComplete = false;
+	}
+
+	if (params.isMinimized && !findFile(params.locationFile->getFilePath()) &&
+		(m_pendingFiles.size() || m_files.size() >= initialFileCount))
+	{
+		m_pendingFiles.push_back(params);
+		return;
+	}
+
+	addFileWidget(getFile(params.locationFile->getFilePath()), params);
+}
+
+void QtCodeFileList::setHasMoreFiles(bool hasMoreFiles)
+{
+	m_hasMoreFiles = hasMoreFiles;
+}
+
+QScrollArea* QtCodeFileList::getScrollArea()
+{
+	return m_scrollArea;
+}
+
+void QtCodeFileList::updateSourceLocations(const CodeSnippetParams& params)
 {
 	QtCodeFile* file = getFile(params.locationFile->getFilePath());
+	if (file)
+	{
+		file->updateSourceLocations(params);
+	}
+}
+
+void QtCodeFileList::updateFiles()
+{
+	m_pendingFilesComplete = true;
+
+	for (QtCodeFile* file: m_files)
+	{
+		updateFilesLastProperty(file);
+		file->updateContent();
+		file->updateTitleBar();
+		file->show();
+	}
+
+	// the files of the requested page continue the list the user scrolled to
+	if (m_moreFilesRequested)
+	{
+		m_moreFilesRequested = false;
+		addPendingFiles(pendingFileBatchCount);
+	}
+
+	// Perform delayed so all widgets are already visible
+	QTimer::singleShot(100, this, &QtCodeFileList::updateSnippetTitleAndScrollBarSlot);
+}
+
+QtCodeFile* QtCodeFileList::findFile(const FilePath& filePath) const
+{
+	for (QtCodeFile* file: m_files)
+	{
+		if (file->getFilePath() == filePath)
+		{
+			return file;
+		}
+	}
+
+	return nullptr;
+}
+
+QtCodeFile* QtCodeFileList::createFile(const FilePath& filePath)
+{
+	QtCodeFile* file = new QtCodeFile(filePath, m_navigator, !m_files.size());
+	m_files.push_back(file);
+
+	m_filesArea->layout()->addWidget(file);
+	file->hide();
+
+	return file;
+}
+
+void QtCodeFileList::addFileWidget(QtCodeFile* file, const CodeFileParams& params)
+{
 	file->setWholeFile(params.locationFile->isWhole(), params.referenceCount);
 	file->setModificationTime(params.modificationTime);
 	file->setIsComplete(params.locationFile->isComplete());
@@ -172,32 +269,52 @@ void QtCodeFileList::addFile(const CodeFileParams& params)
 	}
 }
 
-QScrollArea* QtCodeFileList::getScrollArea()
+void QtCodeFileList::addPendingFiles(size_t count)
 {
-	return m_scrollArea;
-}
+	if (!m_pendingFiles.size())
+	{
+		return;
+	}
 
-void QtCodeFileList::updateSourceLocations(const CodeSnippetParams& params)
-{
-	QtCodeFile* file = getFile(params.locationFile->getFilePath());
-	if (file)
+	count = std::min(count, m_pendingFiles.size());
+	std::vector<CodeFileParams> files(m_pendingFiles.begin(), m_pendingFiles.begin() + count);
+	m_pendingFiles.erase(m_pendingFiles.begin(), m_pendingFiles.begin() + count);
+
+	// the formerly last file is not the last one anymore
+	QtCodeFile* lastFile = m_files.size() ? m_files.back() : nullptr;
+
+	for (const CodeFileParams& params: files)
 	{
-		file->updateSourceLocations(params);
+		addFileWidget(createFile(params.locationFile->getFilePath()), params);
+	}
+
+	if (lastFile)
+	{
+		updateFilesLastProperty(lastFile);
+	}
+
+	if (m_pendingFilesComplete)
+	{
+		for (size_t i = m_files.size() - files.size(); i < m_files.size(); i++)
+		{
+			QtCodeFile* file = m_files[i];
+			updateFilesLastProperty(file);
+			file->updateContent();
+			file->updateTitleBar();
+			file->show();
+		}
 	}
 }
 
-void QtCodeFileList::updateFiles()
+void QtCodeFileList::updateFilesLastProperty(QtCodeFile* file)
 {
-	for (QtCodeFile* file: m_files)
+	bool last = file == m_files.back() && !m_pendingFiles.size();
+	if (file->property("last").toBool() != last)
 	{
-		file->setProperty("last", file == m_files.back());
-		file->updateContent();
-		file->updateTitleBar();
-		file->show();
+		file->setProperty("last", last);
+		file->style()->unpolish(file);
+		file->style()->polish(file);
 	}
-
-	// Perform delayed so all widgets are already visible
-	QTimer::singleShot(100, this, &QtCodeFileList::updateSnippetTitleAndScrollBarSlot);
 }
 
 void QtCodeFileList::scrollTo(
@@ -386,6 +503,25 @@ void QtCodeFileList::updateSnippetTitleAndScrollBar(int value)
 	updateLastSnippetScrollBar(lastSnippetScrollBar);
 }
 
+void QtCodeFileList::scrolled(int value)
+{
+	QScrollBar* scrollBar = m_scrollArea->verticalScrollBar();
+	if (value + 2 * scrollBar->pageStep() < scrollBar->maximum())
+	{
+		return;
+	}
+
+	if (m_pendingFiles.size())
+	{
+		addPendingFiles(pendingFileBatchCount);
+	}
+	else if (m_hasMoreFiles && !m_moreFilesRequested)
+	{
+		m_moreFilesRequested = true;
+		MessageCodeLoadReferencePage().dispatch();
+	}
+}
+
 void QtCodeFileList::scrollLastSnippet(int value)
 {
 	if (m_mirroredSnippetScrollBar && m_mirroredSnippetScrollBar->value() != value)
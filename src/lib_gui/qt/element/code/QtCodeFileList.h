@@ -31,6 +31,8 @@ public:
 	QtCodeFile* getFile(const FilePath filePath);
 
 	void addFile(const CodeFileParams& params);
+	// the controller loads more files when the list is scrolled past the last one it got
+	void setHasMoreFiles(bool hasMoreFiles);
 
 	// QtCodeNaviatebale implementation
 	QScrollArea* getScrollArea() override;
@@ -62,10 +64,18 @@ private slots:
 	void updateSnippetTitleAndScrollBarSlot();
 	void updateSnippetTitleAndScrollBar(int value = 0);
 
+	void scrolled(int value);
 	void scrollLastSnippet(int value);
 	void scrollLastSnippetScrollBar(int value);
 
 private:
+	QtCodeFile* findFile(const FilePath& filePath) const;
+	QtCodeFile* createFile(const FilePath& filePath);
+	void addFileWidget(QtCodeFile* file, const CodeFileParams& params);
+
+	void addPendingFiles(size_t count);
+	void updateFilesLastProperty(QtCodeFile* file);
+
 	void updateFirstSnippetTitleBar(const QtCodeFile* file, int fileTitleBarOffset = 0);
 	void updateLastSnippetScrollBar(QScrollBar* mirroredScrollBar);
 
@@ -75,6 +85,13 @@ private:
 
 	std::vector<QtCodeFile*> m_files;
 
+	// minimized files after the first ones only get widgets when scrolled close to them
+	std::vector<CodeFileParams> m_pendingFiles;
+	bool m_pendingFilesComplete = true;
+
+	bool m_hasMoreFiles = false;
+	bool m_moreFilesRequested = false;
+
 	QtCodeFileTitleBar* m_firstSnippetTitleBar;
 	const QtCodeFileTitleBar* m_mirroredTitleBar;
 
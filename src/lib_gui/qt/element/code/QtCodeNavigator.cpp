@@ -172,6 +172,11 @@ void QtCodeNavigator::addSnippetFile(const CodeFileParams& params)
 	m_list->addFile(params);
 }
 
+void QtCodeNavigator::setHasMoreSnippetFiles(bool hasMoreFiles)
+{
+	m_list->setHasMoreFiles(hasMoreFiles);
+}
+
 bool QtCodeNavigator::addSingleFile(const CodeFileParams& params, bool useSingleFileCache)
 {
 	return m_single->addFile(params, useSingleFileCache);
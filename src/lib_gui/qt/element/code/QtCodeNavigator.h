@@ -39,6 +39,7 @@ public:
 	virtual ~QtCodeNavigator();
 
 	void addSnippetFile(const CodeFileParams& params);
+	void setHasMoreSnippetFiles(bool hasMoreFiles);
 	bool addSingleFile(const CodeFileParams& params, bool useSingleFileCache);
 	void updateSourceLocations(const CodeSnippetParams& params);
 	void updateReferenceCount(
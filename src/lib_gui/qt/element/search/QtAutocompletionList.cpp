@@ -10,15 +10,34 @@
 #include "ResourcePaths.h"
 #include "utilityString.h"
 
-QtAutocompletionModel::QtAutocompletionModel(QObject* parent): QAbstractTableModel(parent) {}
+QtAutocompletionModel::QtAutocompletionModel(QObject* parent)
+	: QAbstractTableModel(parent), m_longestTextIdx(0), m_longestSubTextIdx(0), m_longestTypeIdx(0)
+{
+}
 
 QtAutocompletionModel::~QtAutocompletionModel() {}
 
 void QtAutocompletionModel::setMatchList(const std::vector<SearchMatch>& matchList)
 {
-	size_t rowCount = std::max(m_matchList.size(), matchList.size());
+	beginResetModel();
 	m_matchList = matchList;
-	emit dataChanged(index(0, 0), index(rowCount - 1, 5));
+	m_longestTextIdx = m_longestSubTextIdx = m_longestTypeIdx = 0;
+	updateLongestMatches(0);
+	endResetModel();
+}
+
+void QtAutocompletionModel::appendMatchList(const std::vector<SearchMatch>& matchList)
+{
+	if (matchList.empty())
+	{
+		return;
+	}
+
+	const size_t startIdx = m_matchList.size();
+	beginInsertRows(QModelIndex(), int(startIdx), int(startIdx + matchList.size() - 1));
+	m_matchList.insert(m_matchList.end(), matchList.begin(), matchList.end());
+	updateLongestMatches(startIdx);
+	endInsertRows();
 }
 
 int QtAutocompletionModel::rowCount(const QModelIndex& parent) const
@@ -80,41 +99,49 @@ const SearchMatch* QtAutocompletionModel::getSearchMatchAt(int idx) const
 
 QString QtAutocompletionModel::longestText() const
 {
-	std::wstring str;
-	for (const SearchMatch& match: m_matchList)
+	if (m_matchList.empty())
 	{
-		if (match.text.size() > str.size())
-		{
-			str = match.text;
-		}
+		return QString();
 	}
-	return QString::fromStdWString(str);
+	return QString::fromStdWString(m_matchList[m_longestTextIdx].text);
 }
 
 QString QtAutocompletionModel::longestSubText() const
 {
-	std::wstring str;
-	for (const SearchMatch& match: m_matchList)
+	if (m_matchList.empty())
 	{
-		if (match.subtext.size() > str.size())
-		{
-			str = match.subtext;
-		}
+		return QString();
 	}
-	return QString::fromStdWString(str);
+	return QString::fromStdWString(m_matchList[m_longestSubTextIdx].subtext);
 }
 
 QString QtAutocompletionModel::longestType() const
 {
-	std::wstring str;
-	for (const SearchMatch& match: m_matchList)
+	if (m_matchList.empty())
+	{
+		return QString();
+	}
+	return QString::fromStdWString(m_matchList[m_longestTypeIdx].typeName);
+}
+
+void QtAutocompletionModel::updateLongestMatches(size_t startIdx)
+{
+	for (size_t i = startIdx; i < m_matchList.size(); i++)
 	{
-		if (match.typeName.size() > str.size())
+		const SearchMatch& match = m_matchList[i];
+		if (match.text.size() > m_matchList[m_longestTextIdx].text.size())
+		{
+			m_longestTextIdx = i;
+		}
+		if (match.subtext.size() > m_matchList[m_longestSubTextIdx].subtext.size())
+		{
+			m_longestSubTextIdx = i;
+		}
+		if (match.typeName.size() > m_matchList[m_longestTypeIdx].typeName.size())
 		{
-			str = match.typeName;
+			m_longestTypeIdx = i;
 		}
 	}
-	return QString::fromStdWString(str);
 }
 
 
@@ -129,16 +156,22 @@ QtAutocompletionDelegate::~QtAutocompletionDelegate() {}
 void QtAutocompletionDelegate::paint(
 	QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
 {
+	// the match is only converted for display here, so just the visible rows pay for it
+	const SearchMatch* match = m_model->getSearchMatchAt(index.row());
+	if (!match)
+	{
+		return;
+	}
+
 	painter->save();
 
 	// get data
-	QString name = index.data().toString();
-	QString text = index.sibling(index.row(), index.column() + 1).data().toString();
-	QString subtext = index.sibling(index.row(), index.column() + 2).data().toString();
-	QString type = index.sibling(index.row(), index.column() + 3).data().toString();
-	QList<QVariant> indices = index.sibling(index.row(), index.column() + 4).data().toList();
-	NodeType nodeType = NodeType::intToType(
-		index.sibling(index.row(), index.column() + 5).data().toInt());
+	QString name = QString::fromStdWString(match->name);
+	QString text = QString::fromStdWString(match->text);
+	QString subtext = QString::fromStdWString(match->subtext);
+	QString type = QString::fromStdWString(match->typeName);
+	const std::vector<size_t>& indices = match->indices;
+	const NodeType& nodeType = match->nodeType;
 
 	// define highlight colors
 	ColorScheme* scheme = ColorScheme::getInstance().get();
@@ -180,9 +213,9 @@ void QtAutocompletionDelegate::paint(
 	QString highlightText(text.size(), ' ');
 	if (!indices.empty())
 	{
-		for (int i = 0; i < indices.size(); i++)
+		for (const size_t charIdx: indices)
 		{
-			int idx = indices[i].toInt() - (name.size() - text.size());
+			int idx = int(charIdx) - (name.size() - text.size());
 			if (idx < 0)
 			{
 				continue;
@@ -231,9 +264,9 @@ void QtAutocompletionDelegate::paint(
 		QString highlightSubtext(subtext.size(), ' ');
 		if (indices.size())
 		{
-			for (int i = 0; i < indices.size(); i++)
+			for (const size_t charIdx: indices)
 			{
-				int idx = indices[i].toInt();
+				int idx = int(charIdx);
 				if (idx >= subtext.size())
 				{
 					continue;
@@ -428,6 +461,20 @@ void QtAutocompletionList::completeAt(const QPoint& pos, const std::vector<Searc
 	list->setCurrentIndex(completionModel()->index(0, 0));
 }
 
+void QtAutocompletionList::appendCompletions(const std::vector<SearchMatch>& autocompletionList)
+{
+	QListView* list = dynamic_cast<QListView*>(popup());
+	if (!list->isVisible() || autocompletionList.empty())
+	{
+		return;
+	}
+
+	// the completion model gets invalidated by inserted rows, so the current row is set again
+	const int currentRow = std::max(list->currentIndex().row(), 0);
+	m_model->appendMatchList(autocompletionList);
+	list->setCurrentIndex(completionModel()->index(currentRow, 0));
+}
+
 const SearchMatch* QtAutocompletionList::getSearchMatchAt(int idx) const
 {
 	return m_model->getSearchMatchAt(idx);
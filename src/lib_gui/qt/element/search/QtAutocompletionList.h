@@ -12,6 +12,8 @@
 #include "QtDeviceScaledPixmap.h"
 #include "SearchMatch.h"
 
+// Keeps the matches as they are, the delegate renders a row only when the view paints it. The
+// longest texts are tracked while matches are added, so sizing the rows does not scan all of them.
 class QtAutocompletionModel: public QAbstractTableModel
 {
 	Q_OBJECT
@@ -21,6 +23,7 @@ public:
 	virtual ~QtAutocompletionModel();
 
 	void setMatchList(const std::vector<SearchMatch>& matchList);
+	void appendMatchList(const std::vector<SearchMatch>& matchList);
 
 	virtual int rowCount(const QModelIndex& parent) const;
 	virtual int columnCount(const QModelIndex& parent) const;
@@ -34,7 +37,13 @@ public:
 	QString longestType() const;
 
 private:
+	void updateLongestMatches(size_t startIdx);
+
 	std::vector<SearchMatch> m_matchList;
+
+	size_t m_longestTextIdx;
+	size_t m_longestSubTextIdx;
+	size_t m_longestTypeIdx;
 };
 
 
@@ -80,6 +89,8 @@ public:
 	virtual ~QtAutocompletionList();
 
 	void completeAt(const QPoint& pos, const std::vector<SearchMatch>& autocompletionList);
+	// adds matches of a running search to the shown list, keeping the current row
+	void appendCompletions(const std::vector<SearchMatch>& autocompletionList);
 
 	const SearchMatch* getSearchMatchAt(int idx) const;
 
@@ -89,6 +89,11 @@ void QtSearchBar::setAutocompletionList(const std::vector<SearchMatch>& autocomp
 	m_searchBox->setAutocompletionList(autocompletionList);
 }
 
+void QtSearchBar::appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList)
+{
+	m_searchBox->appendAutocompletionList(autocompletionList);
+}
+
 QAbstractItemView* QtSearchBar::getCompleterPopup()
 {
 	return m_searchBox->getCompleter()->popup();
@@ -27,6 +27,7 @@ public:
 	void setFocus();
 	void findFulltext();
 	void setAutocompletionList(const std::vector<SearchMatch>& autocompletionList);
+	void appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList);
 
 	QAbstractItemView* getCompleterPopup();
 
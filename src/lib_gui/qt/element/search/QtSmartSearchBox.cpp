@@ -136,6 +136,11 @@ void QtSmartSearchBox::setAutocompletionList(const std::vector<SearchMatch>& aut
 	}
 }
 
+void QtSmartSearchBox::appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList)
+{
+	m_completer->appendCompletions(autocompletionList);
+}
+
 void QtSmartSearchBox::setMatches(const std::vector<SearchMatch>& matches)
 {
 	if (SearchMatch::searchMatchesToString(matches) ==
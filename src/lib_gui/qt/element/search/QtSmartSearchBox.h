@@ -47,6 +47,7 @@ public:
 	std::vector<SearchMatch> getMatches() const;
 
 	void setAutocompletionList(const std::vector<SearchMatch>& autocompletionList);
+	void appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList);
 	void setMatches(const std::vector<SearchMatch>& matches);
 	void setFocus();
 	void findFulltext();
@@ -2,7 +2,9 @@
 
 #include <QDir>
 #include <QMouseEvent>
+#include <QPainter>
 #include <QScrollBar>
+#include <QStyleOptionGraphicsItem>
 #include <QTimer>
 
 #include <QApplication>
@@ -30,6 +32,11 @@
 #include "utilityApp.h"
 #include "utilityQt.h"
 
+bool QtGraphicsView::isZoomedOut(const QPainter* painter)
+{
+	return QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()) < 0.4;
+}
+
 QtGraphicsView::QtGraphicsView(QWidget* parent)
 	: QGraphicsView(parent)
 	, m_zoomFactor(1.0f)
@@ -7,6 +7,7 @@
 
 #include "types.h"
 
+class QPainter;
 class QPushButton;
 class QTimer;
 class QtGraphEdge;
@@ -18,6 +19,9 @@ class QtGraphicsView: public QGraphicsView
 	Q_OBJECT
 
 public:
+	// nodes and edges are drawn without details when zoomed out this far
+	static bool isZoomedOut(const QPainter* painter);
+
 	QtGraphicsView(QWidget* parent);
 
 	float getZoomFactor() const;
@@ -31,6 +31,11 @@ QPainterPath QtLineItemAngled::shape() const
 
 void QtLineItemAngled::paint(QPainter* painter, const QStyleOptionGraphicsItem* options, QWidget* widget)
 {
+	if (paintSimplified(painter))
+	{
+		return;
+	}
+
 	QPen p = pen();
 	painter->setPen(p);
 
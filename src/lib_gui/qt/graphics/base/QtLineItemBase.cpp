@@ -2,8 +2,11 @@
 
 #include <QBrush>
 #include <QCursor>
+#include <QPainter>
 #include <QPen>
 
+#include "QtGraphicsView.h"
+
 QtLineItemBase::QtLineItemBase(QGraphicsItem* parent)
 	: QGraphicsLineItem(parent)
 	, m_showArrow(true)
@@ -318,6 +321,24 @@ QPolygon QtLineItemBase::getPath() const
 	return poly;
 }
 
+bool QtLineItemBase::paintSimplified(QPainter* painter) const
+{
+	if (!QtGraphicsView::isZoomedOut(painter))
+	{
+		return false;
+	}
+
+	QPen p = pen();
+	if (m_style.dashed)
+	{
+		p.setStyle(Qt::DashLine);
+	}
+
+	painter->setPen(p);
+	painter->drawPolyline(getPath());
+	return true;
+}
+
 int QtLineItemBase::getDirection(const QPointF& a, const QPointF& b) const
 {
 	if (a.x() != b.x())
@@ -37,6 +37,9 @@ public:
 
 protected:
 	QPolygon getPath() const;
+
+	// draws the plain path without rounded corners or arrow heads when zoomed out
+	bool paintSimplified(QPainter* painter) const;
 	int getDirection(const QPointF& a, const QPointF& b) const;
 
 	QRectF getArrowBoundingRect(const QPolygon& poly) const;
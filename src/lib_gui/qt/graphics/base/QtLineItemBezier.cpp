@@ -22,6 +22,11 @@ QPainterPath QtLineItemBezier::shape() const
 
 void QtLineItemBezier::paint(QPainter* painter, const QStyleOptionGraphicsItem* options, QWidget* widget)
 {
+	if (paintSimplified(painter))
+	{
+		return;
+	}
+
 	QPainterPath path = getCurve();
 
 	if (m_showArrow)
@@ -3,6 +3,8 @@
 #include <QGraphicsDropShadowEffect>
 #include <QPainter>
 
+#include "QtGraphicsView.h"
+
 QtRoundedRectItem::QtRoundedRectItem(QGraphicsItem* parent)
 	: QGraphicsRectItem(parent), m_radius(0.0f)
 {
@@ -16,6 +18,12 @@ void QtRoundedRectItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
 	painter->setPen(pen());
 	painter->setBrush(brush());
 
+	if (QtGraphicsView::isZoomedOut(painter))
+	{
+		painter->drawRect(this->rect());
+		return;
+	}
+
 	painter->setRenderHint(QPainter::Antialiasing);
 
 	painter->drawRoundedRect(this->rect(), m_radius, m_radius);
@@ -0,0 +1,27 @@
+#include "QtSimpleTextItem.h"
+
+#include <QBrush>
+#include <QPainter>
+
+#include "QtGraphicsView.h"
+
+QtSimpleTextItem::QtSimpleTextItem(QGraphicsItem* parent): QGraphicsSimpleTextItem(parent) {}
+
+QtSimpleTextItem::~QtSimpleTextItem() {}
+
+void QtSimpleTextItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* options, QWidget* widget)
+{
+	if (!QtGraphicsView::isZoomedOut(painter))
+	{
+		QGraphicsSimpleTextItem::paint(painter, options, widget);
+		return;
+	}
+
+	QColor color = brush().color();
+	color.setAlphaF(color.alphaF() * 0.5);
+
+	QRectF rect = boundingRect();
+	rect.adjust(0, rect.height() / 4, 0, -rect.height() / 4);
+
+	painter->fillRect(rect, color);
+}
@@ -0,0 +1,16 @@
+#ifndef QT_SIMPLE_TEXT_ITEM_H
+#define QT_SIMPLE_TEXT_ITEM_H
+
+#include <QGraphicsSimpleTextItem>
+
+// text item that only draws a placeholder bar when the view is zoomed out too far to read it
+class QtSimpleTextItem: public QGraphicsSimpleTextItem
+{
+public:
+	QtSimpleTextItem(QGraphicsItem* parent);
+	virtual ~QtSimpleTextItem();
+
+	virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* options, QWidget* widget);
+};
+
+#endif	  // QT_SIMPLE_TEXT_ITEM_H
@@ -79,6 +79,7 @@ public:
 	void showNodeRecursive();
 
 	void matchNameRecursive(const std::wstring& query, std::vector<QtGraphNode*>* matchedNodes);
+	virtual void matchName(const std::wstring& query, std::vector<QtGraphNode*>* matchedNodes);
 	void removeNameMatch();
 	void setActiveMatch(bool active);
 
@@ -114,8 +115,6 @@ protected:
 
 	void notifyEdgesAfterMove();
 
-	virtual void matchName(const std::wstring& query, std::vector<QtGraphNode*>* matchedNodes);
-
 	void setStyle(const GraphViewStyle::NodeStyle& style);
 
 	std::list<QtGraphEdge*> m_outEdges;
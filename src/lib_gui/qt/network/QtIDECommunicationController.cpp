@@ -9,6 +9,12 @@ QtIDECommunicationController::QtIDECommunicationController(QObject* parent, Stor
 {
 	m_tcpWrapper.setReadCallback(std::bind(
 		&QtIDECommunicationController::handleIncomingMessage, this, std::placeholders::_1));
+
+	m_activationTimer.setSingleShot(true);
+	QObject::connect(&m_activationTimer, &QTimer::timeout, [this]() { activatePendingToken(); });
+
+	m_indexingTimer.setSingleShot(true);
+	QObject::connect(&m_indexingTimer, &QTimer::timeout, [this]() { indexSavedFiles(); });
 }
 
 QtIDECommunicationController::~QtIDECommunicationController() {}
@@ -39,3 +45,32 @@ void QtIDECommunicationController::sendMessage(const std::wstring& message) cons
 {
 	m_tcpWrapper.sendMessage(message);
 }
+
+void QtIDECommunicationController::scheduleTokenActivation()
+{
+	// the timer is not restarted by further messages, so a stream of cursor moves still activates
+	// the latest position every delay
+	const int delayMs = ApplicationSettings::getInstance()->getPluginActivationDelayMs();
+	if (delayMs <= 0)
+	{
+		activatePendingToken();
+	}
+	else if (!m_activationTimer.isActive())
+	{
+		m_activationTimer.start(delayMs);
+	}
+}
+
+void QtIDECommunicationController::scheduleSavedFileIndexing()
+{
+	// every save restarts the timer, so saving many files at once only refreshes once
+	const int delayMs = ApplicationSettings::getInstance()->getIdeSavedFileIndexingDelayMs();
+	if (delayMs <= 0)
+	{
+		indexSavedFiles();
+	}
+	else
+	{
+		m_indexingTimer.start(delayMs);
+	}
+}
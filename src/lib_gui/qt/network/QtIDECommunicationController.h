@@ -2,6 +2,7 @@
 #define QT_IDE_COMMUNICATION_CONTROLLER
 
 #include <qobject.h>
+#include <qtimer.h>
 
 #include "QtTcpWrapper.h"
 
@@ -23,8 +24,12 @@ public:
 
 private:
 	virtual void sendMessage(const std::wstring& message) const;
+	virtual void scheduleTokenActivation();
+	virtual void scheduleSavedFileIndexing();
 
 	QtTcpWrapper m_tcpWrapper;
+	QTimer m_activationTimer;
+	QTimer m_indexingTimer;
 
 	QtThreadedLambdaFunctor m_onQtThread;
 };
@@ -0,0 +1,87 @@
+#include "QtMetricsServer.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "MetricsRegistry.h"
+#include "logging.h"
+
+namespace
+{
+// requests without a complete header within this many bytes are dropped
+const int maxRequestHeaderSize = 8192;
+}	 // namespace
+
+QtMetricsServer::QtMetricsServer(QObject* parent): QObject(parent)
+{
+	m_tcpServer = new QTcpServer(this);
+	connect(m_tcpServer, &QTcpServer::newConnection, this, &QtMetricsServer::acceptConnection);
+}
+
+bool QtMetricsServer::startListening(quint16 port)
+{
+	if (!m_tcpServer->listen(QHostAddress::LocalHost, port))
+	{
+		LOG_ERROR(
+			"Metrics server failed to listen on port " + std::to_string(port) + ": " +
+			m_tcpServer->errorString().toStdString());
+		return false;
+	}
+
+	LOG_INFO("Serving metrics on http://localhost:" + std::to_string(port) + "/metrics");
+	return true;
+}
+
+void QtMetricsServer::acceptConnection()
+{
+	while (QTcpSocket* socket = m_tcpServer->nextPendingConnection())
+	{
+		connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { answerRequest(socket); });
+		connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+	}
+}
+
+void QtMetricsServer::answerRequest(QTcpSocket* socket)
+{
+	// the request stays in the socket until its header is complete
+	const QByteArray request = socket->peek(maxRequestHeaderSize);
+	if (!request.contains("\r\n\r\n"))
+	{
+		if (request.size() >= maxRequestHeaderSize)
+		{
+			socket->abort();
+		}
+		return;
+	}
+	socket->readAll();
+
+	const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+	const QByteArray path = requestLine.size() > 1 ? requestLine[1] : QByteArray();
+
+	QByteArray status = "200 OK";
+	QByteArray contentType = "text/plain; version=0.0.4";
+	QByteArray body;
+	if (requestLine[0] != "GET")
+	{
+		status = "405 Method Not Allowed";
+	}
+	else if (path == "/metrics")
+	{
+		body = QByteArray::fromStdString(MetricsRegistry::getInstance()->toPrometheusText());
+	}
+	else if (path == "/metrics.json")
+	{
+		contentType = "application/json";
+		body = QByteArray::fromStdString(MetricsRegistry::getInstance()->toJson());
+	}
+	else
+	{
+		status = "404 Not Found";
+	}
+
+	socket->write(
+		"HTTP/1.1 " + status + "\r\nContent-Type: " + contentType +
+		"\r\nContent-Length: " + QByteArray::number(body.size()) +
+		"\r\nConnection: close\r\n\r\n" + body);
+	socket->disconnectFromHost();
+}
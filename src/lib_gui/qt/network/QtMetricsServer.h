@@ -0,0 +1,29 @@
+#ifndef QT_METRICS_SERVER_H
+#define QT_METRICS_SERVER_H
+
+#include <QObject>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Answers HTTP requests on the local host with the metrics of the MetricsRegistry, /metrics in the
+// Prometheus text format and /metrics.json as json.
+class QtMetricsServer: public QObject
+{
+	Q_OBJECT
+
+public:
+	QtMetricsServer(QObject* parent = nullptr);
+
+	bool startListening(quint16 port);
+
+private slots:
+	void acceptConnection();
+
+private:
+	void answerRequest(QTcpSocket* socket);
+
+	QTcpServer* m_tcpServer;
+};
+
+#endif	  // QT_METRICS_SERVER_H
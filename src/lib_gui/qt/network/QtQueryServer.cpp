@@ -0,0 +1,133 @@
+#include "QtQueryServer.h"
+
+#include <QHostAddress>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include "StorageQueryExecutor.h"
+#include "logging.h"
+
+namespace
+{
+// requests without a complete header within this many bytes are dropped
+const int maxRequestHeaderSize = 8192;
+
+QByteArray getStatusText(int status)
+{
+	switch (status)
+	{
+	case 200:
+		return "200 OK";
+	case 400:
+		return "400 Bad Request";
+	case 404:
+		return "404 Not Found";
+	case 405:
+		return "405 Method Not Allowed";
+	default:
+		return "500 Internal Server Error";
+	}
+}
+
+void writeResponse(QTcpSocket* socket, int status, const QByteArray& body)
+{
+	socket->write(
+		"HTTP/1.1 " + getStatusText(status) +
+		"\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size()) +
+		"\r\nConnection: close\r\n\r\n" + body);
+	socket->disconnectFromHost();
+}
+}	 // namespace
+
+QtQueryServer::QtQueryServer(const FilePath& indexDbFilePath, size_t workerCount, QObject* parent)
+	: QObject(parent), m_executor(std::make_unique<StorageQueryExecutor>(indexDbFilePath, workerCount))
+{
+	m_tcpServer = new QTcpServer(this);
+	connect(m_tcpServer, &QTcpServer::newConnection, this, &QtQueryServer::acceptConnection);
+}
+
+QtQueryServer::~QtQueryServer()
+{
+	// workers may still answer, their responses are dropped with the sockets
+	m_executor->stop();
+}
+
+bool QtQueryServer::startListening(const QString& host, quint16 port)
+{
+	if (!m_executor->start())
+	{
+		return false;
+	}
+
+	if (!m_tcpServer->listen(QHostAddress(host), port))
+	{
+		LOG_ERROR(
+			"Query server failed to listen on " + host.toStdString() + ":" + std::to_string(port) +
+			": " + m_tcpServer->errorString().toStdString());
+		return false;
+	}
+
+	LOG_INFO("Serving queries on http://" + host.toStdString() + ":" + std::to_string(port) + "/");
+	return true;
+}
+
+void QtQueryServer::acceptConnection()
+{
+	while (QTcpSocket* socket = m_tcpServer->nextPendingConnection())
+	{
+		connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { answerRequest(socket); });
+		connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+	}
+}
+
+void QtQueryServer::answerRequest(QTcpSocket* socket)
+{
+	// the request stays in the socket until its header is complete
+	const QByteArray request = socket->peek(maxRequestHeaderSize);
+	if (!request.contains("\r\n\r\n"))
+	{
+		if (request.size() >= maxRequestHeaderSize)
+		{
+			socket->abort();
+		}
+		return;
+	}
+	socket->readAll();
+
+	const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+	if (requestLine[0] != "GET" || requestLine.size() < 2)
+	{
+		writeResponse(socket, 405, "{\"error\":\"Only GET requests are answered\"}");
+		return;
+	}
+
+	const QUrl url(QString::fromUtf8(requestLine[1]));
+	std::map<std::string, std::string> parameters;
+	for (const QPair<QString, QString>& item: QUrlQuery(url).queryItems(QUrl::FullyDecoded))
+	{
+		parameters[item.first.toStdString()] = item.second.toStdString();
+	}
+
+	// the response is written on the thread of the server, unless the socket was closed meanwhile.
+	// the server stops the workers before it is destroyed, so it outlives all callbacks.
+	QPointer<QTcpSocket> socketPointer(socket);
+	m_executor->execute(
+		url.path().mid(1).toStdString(),
+		parameters,
+		[this, socketPointer](const StorageQueryService::Response& response) {
+			const QByteArray body = QByteArray::fromStdString(response.body);
+			const int status = response.status;
+			QMetaObject::invokeMethod(
+				this,
+				[socketPointer, status, body]() {
+					if (socketPointer)
+					{
+						writeResponse(socketPointer.data(), status, body);
+					}
+				},
+				Qt::QueuedConnection);
+		});
+}
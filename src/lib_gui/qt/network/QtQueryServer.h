@@ -0,0 +1,37 @@
+#ifndef QT_QUERY_SERVER_H
+#define QT_QUERY_SERVER_H
+
+#include <memory>
+
+#include <QObject>
+
+#include "FilePath.h"
+
+class QTcpServer;
+class QTcpSocket;
+class StorageQueryExecutor;
+
+// Answers HTTP GET requests for code navigation queries over an index database with json, the
+// queries are listed at StorageQueryService. The server keeps reading requests on the Qt event
+// loop while the queries are answered by the workers of a StorageQueryExecutor.
+class QtQueryServer: public QObject
+{
+	Q_OBJECT
+
+public:
+	QtQueryServer(const FilePath& indexDbFilePath, size_t workerCount, QObject* parent = nullptr);
+	~QtQueryServer();
+
+	bool startListening(const QString& host, quint16 port);
+
+private slots:
+	void acceptConnection();
+
+private:
+	void answerRequest(QTcpSocket* socket);
+
+	QTcpServer* m_tcpServer;
+	std::unique_ptr<StorageQueryExecutor> m_executor;
+};
+
+#endif	  // QT_QUERY_SERVER_H
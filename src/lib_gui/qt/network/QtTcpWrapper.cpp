@@ -1,7 +1,8 @@
 #include "QtTcpWrapper.h"
-#include "qdatastream.h"
 
+#include "NetworkProtocolHelper.h"
 #include "logging.h"
+#include "utilityString.h"
 
 QtTcpWrapper::QtTcpWrapper(
 	QObject* parent, const std::string& ip, const quint16 serverPort, const quint16 clientPort)
@@ -91,38 +92,52 @@ bool QtTcpWrapper::isListening() const
 
 void QtTcpWrapper::acceptConnection()
 {
-	m_tcpClient = m_tcpServer->nextPendingConnection();
+	while (m_tcpServer->hasPendingConnections())
+	{
+		QTcpSocket* socket = m_tcpServer->nextPendingConnection();
+		m_receivedData[socket];
 
-	connect(m_tcpClient, &QTcpSocket::readyRead, this, &QtTcpWrapper::startRead);
+		connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readFromSocket(socket); });
+		connect(socket, &QTcpSocket::disconnected, this, [this, socket]() { closeSocket(socket); });
+	}
 }
 
-void QtTcpWrapper::startRead()
+void QtTcpWrapper::readFromSocket(QTcpSocket* socket)
 {
-	QByteArray byteArray;
-	while (m_tcpClient->atEnd() == false)
+	auto it = m_receivedData.find(socket);
+	if (it == m_receivedData.end())
 	{
-		QByteArray data = m_tcpClient->read(128);
-		byteArray += data;
+		return;
 	}
 
-	/*QDataStream stream(&byteArray, QIODevice::ReadOnly);
-	QString string;
-	stream >> string;*/
-
-	QString message = QString::fromUtf8(byteArray);
+	const QByteArray data = socket->readAll();
+	it->second.append(data.constData(), size_t(data.size()));
 
-	if (m_readCallback != nullptr)
+	// all messages of one read are passed on in order, intermediate cursor moves are coalesced by
+	// the receiver
+	for (const std::wstring& message: NetworkProtocolHelper::takeCompleteMessages(&it->second))
 	{
-		m_readCallback(message.toStdWString());
+		if (m_readCallback != nullptr)
+		{
+			m_readCallback(message);
+		}
 	}
+}
 
-	/*char buffer[1024] = { 0 };
-	m_tcpClient->read(buffer, m_tcpClient->bytesAvailable());
-
-	m_tcpClient->close();
+void QtTcpWrapper::closeSocket(QTcpSocket* socket)
+{
+	readFromSocket(socket);
 
-	if (m_readCallback != nullptr)
+	auto it = m_receivedData.find(socket);
+	if (it != m_receivedData.end())
 	{
-		m_readCallback(buffer);
-	}*/
+		if (!it->second.empty())
+		{
+			LOG_WARNING(
+				L"Dropping incomplete plugin message: " + utility::decodeFromUtf8(it->second));
+		}
+		m_receivedData.erase(it);
+	}
+
+	socket->deleteLater();
 }
@@ -2,6 +2,9 @@
 #define QT_SOCKET_WRAPPER_H
 
 #include <functional>
+#include <map>
+#include <string>
+
 #include <qobject.h>
 #include <qudpsocket.h>
 
@@ -39,9 +42,12 @@ signals:
 
 public slots:
 	void acceptConnection();
-	void startRead();
 
 private:
+	// plugins may keep their connection open and send many messages over it
+	void readFromSocket(QTcpSocket* socket);
+	void closeSocket(QTcpSocket* socket);
+
 	quint16 m_serverPort;
 	quint16 m_clientPort;
 	std::string m_ip;
@@ -49,7 +55,7 @@ private:
 	std::function<void(const std::wstring&)> m_readCallback;
 
 	QTcpServer* m_tcpServer;
-	QTcpSocket* m_tcpClient;
+	std::map<QTcpSocket*, std::string> m_receivedData;	  // incomplete messages per connection
 };
 
 #endif	  // QT_SOCKET_WRAPPER_H
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <QCheckBox>
 #include <QLineEdit>
 #include <QMessageBox>
+#include <QSpinBox>
 #include <boost/filesystem/path.hpp>
 
 #include "FileSystem.h"
@@ -60,6 +61,22 @@ void QtProjectWizardContentCustomCommand::populate(QGridLayout* layout, int& row
 	layout->addWidget(m_runInParallel, row, QtProjectWizardWindow::BACK_COL);
 	row++;
 
+	QLabel* executionOrderLabel = createFormLabel("Execution Order");
+	addHelpButton(
+		"Execution Order",
+		"<p>Source Groups with a lower execution order run all of their commands before the "
+		"commands of Source Groups with a higher execution order start. Use this if a command "
+		"depends on the output of another Source Group.</p>",
+		layout,
+		row);
+
+	m_executionOrder = new QSpinBox();
+	m_executionOrder->setRange(0, 99);
+
+	layout->addWidget(executionOrderLabel, row, QtProjectWizardWindow::FRONT_COL, Qt::AlignRight);
+	layout->addWidget(m_executionOrder, row, QtProjectWizardWindow::BACK_COL, Qt::AlignLeft);
+	row++;
+
 	if (!isInForm())
 	{
 		layout->setRowMinimumHeight(row, 15);
@@ -71,12 +88,14 @@ void QtProjectWizardContentCustomCommand::load()
 {
 	m_customCommand->setText(QString::fromStdWString(m_settings->getCustomCommand()));
 	m_runInParallel->setChecked(m_settings->getRunInParallel());
+	m_executionOrder->setValue(m_settings->getExecutionOrder());
 }
 
 void QtProjectWizardContentCustomCommand::save()
 {
 	m_settings->setCustomCommand(m_customCommand->text().toStdWString());
 	m_settings->setRunInParallel(m_runInParallel->isChecked());
+	m_settings->setExecutionOrder(m_executionOrder->value());
 }
 
 bool QtProjectWizardContentCustomCommand::check()
@@ -5,6 +5,7 @@
 
 class QCheckBox;
 class QLineEdit;
+class QSpinBox;
 class SourceGroupSettingsCustomCommand;
 
 class QtProjectWizardContentCustomCommand: public QtProjectWizardContent
@@ -27,6 +28,7 @@ private:
 
 	QLineEdit* m_customCommand;
 	QCheckBox* m_runInParallel;
+	QSpinBox* m_executionOrder;
 };
 
 #endif	  // QT_PROJECT_WIZARD_CONTENT_CUSTOM_COMMAND_H
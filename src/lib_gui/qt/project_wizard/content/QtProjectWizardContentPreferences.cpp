@@ -108,6 +108,15 @@ void QtProjectWizardContentPreferences::populate(QGridLayout* layout, int& row)
 		layout,
 		row);
 
+	// graph rendering
+	m_graphHardwareRendering = addCheckBox(
+		"Graph Rendering",
+		"Render graph with OpenGL",
+		"<p>Paint the graph view on the graphics card, which keeps zooming and scrolling large "
+		"graphs smooth. Applies to tabs opened afterwards.</p>",
+		layout,
+		row);
+
 	// directory in code
 	m_showDirectoryInCode = addCheckBox(
 		"Directory in File Title",
@@ -467,6 +476,7 @@ void QtProjectWizardContentPreferences::load()
 
 	m_useAnimations->setChecked(appSettings->getUseAnimations());
 	m_showBuiltinTypes->setChecked(appSettings->getShowBuiltinTypesInGraph());
+	m_graphHardwareRendering->setChecked(appSettings->getGraphHardwareRenderingEnabled());
 	m_showDirectoryInCode->setChecked(appSettings->getShowDirectoryInCodeFileTitle());
 
 	if (m_screenAutoScaling)
@@ -532,6 +542,7 @@ void QtProjectWizardContentPreferences::save()
 
 	appSettings->setUseAnimations(m_useAnimations->isChecked());
 	appSettings->setShowBuiltinTypesInGraph(m_showBuiltinTypes->isChecked());
+	appSettings->setGraphHardwareRenderingEnabled(m_graphHardwareRendering->isChecked());
 	appSettings->setShowDirectoryInCodeFileTitle(m_showDirectoryInCode->isChecked());
 
 	if (m_screenAutoScaling)
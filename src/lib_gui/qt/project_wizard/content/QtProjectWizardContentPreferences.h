@@ -101,6 +101,7 @@ private:
 
 	QCheckBox* m_useAnimations;
 	QCheckBox* m_showBuiltinTypes;
+	QCheckBox* m_graphHardwareRendering;
 	QCheckBox* m_showDirectoryInCode;
 
 	QComboBox* m_screenAutoScaling;
@@ -126,7 +126,7 @@ void QtProjectWizardContentPathCDB::onPickerTextChanged(const QString& text)
 		cdbPath != m_settings->getCompilationDatabasePathExpandedAndAbsolute())
 	{
 		std::string error;
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(
+		std::shared_ptr<const CachedCompilationDatabase> cdb = utility::loadCDB(
 			cdbPath, &error);
 		if (cdb && error.empty())
 		{
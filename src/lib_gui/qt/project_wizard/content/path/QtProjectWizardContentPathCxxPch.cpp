@@ -54,7 +54,7 @@ bool QtProjectWizardContentPathCxxPch::check()
 			std::dynamic_pointer_cast<SourceGroupSettingsCxxCdb>(m_settings))
 	{
 		const FilePath cdbPath = cdbSettings->getCompilationDatabasePathExpandedAndAbsolute();
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+		std::shared_ptr<const CachedCompilationDatabase> cdb = utility::loadCDB(cdbPath);
 		if (!cdb)
 		{
 			QMessageBox msgBox;
@@ -1,5 +1,6 @@
 #include "QtHighlighter.h"
 
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -17,6 +18,9 @@
 
 std::map<std::wstring, std::vector<QtHighlighter::HighlightingRule>> QtHighlighter::s_highlightingRules;
 std::map<QtHighlighter::HighlightType, QTextCharFormat> QtHighlighter::s_charFormats;
+std::map<QtHighlighter::RangesKey, QtHighlighter::CachedRanges> QtHighlighter::s_cachedRanges;
+std::deque<QtHighlighter::RangesKey> QtHighlighter::s_cachedRangesOrder;
+const size_t QtHighlighter::s_maxCachedRangesCount = 100;
 
 std::string QtHighlighter::highlightTypeToString(QtHighlighter::HighlightType type)
 {
@@ -149,10 +153,12 @@ void QtHighlighter::loadHighlightingRules()
 void QtHighlighter::clearHighlightingRules()
 {
 	s_highlightingRules.clear();
+	s_cachedRanges.clear();
+	s_cachedRangesOrder.clear();
 }
 
 QtHighlighter::QtHighlighter(QTextDocument* document, const std::wstring& language)
-	: m_document(document)
+	: m_document(document), m_language(language)
 {
 	if (!s_highlightingRules.size())
 	{
@@ -202,7 +208,15 @@ void QtHighlighter::highlightDocument()
 			singleLineRules.emplace_back(rule);
 		}
 	}
-	createRanges(doc, singleLineRules);
+
+	// the same file is shown again and again when moving between references
+	const QString text = doc->toPlainText();
+	const RangesKey key(m_language, text.size(), qHash(text));
+	if (!restoreRanges(key))
+	{
+		createRanges(doc, singleLineRules);
+		cacheRanges(key);
+	}
 }
 
 void QtHighlighter::highlightRange(int startLine, int endLine)
@@ -312,6 +326,33 @@ QTextCharFormat QtHighlighter::getFormat(int startPosition, int endPosition) con
 	return cursor.charFormat();
 }
 
+bool QtHighlighter::restoreRanges(const RangesKey& key)
+{
+	auto it = s_cachedRanges.find(key);
+	if (it == s_cachedRanges.end())
+	{
+		return false;
+	}
+
+	m_singleLineRanges = it->second.singleLineRanges;
+	m_multiLineRanges = it->second.multiLineRanges;
+	return true;
+}
+
+void QtHighlighter::cacheRanges(const RangesKey& key) const
+{
+	if (s_cachedRanges.size() >= s_maxCachedRangesCount)
+	{
+		s_cachedRanges.erase(s_cachedRangesOrder.front());
+		s_cachedRangesOrder.pop_front();
+	}
+
+	if (s_cachedRanges.emplace(key, CachedRanges{m_singleLineRanges, m_multiLineRanges}).second)
+	{
+		s_cachedRangesOrder.push_back(key);
+	}
+}
+
 void QtHighlighter::createRanges(QTextDocument* doc, const std::vector<HighlightingRule>& singleLineRules)
 {
 	m_singleLineRanges.clear();
@@ -1,6 +1,11 @@
 #ifndef QT_HIGHLIGHTER_H
 #define QT_HIGHLIGHTER_H
 
+#include <deque>
+#include <map>
+#include <tuple>
+#include <vector>
+
 #include <QTextCharFormat>
 
 class QTextBlock;
@@ -52,6 +57,18 @@ private:
 		bool multiLine = false;
 	};
 
+	// ranges of the priority rules for a document, identified by language, text length and hash
+	typedef std::tuple<std::wstring, int, uint> RangesKey;
+
+	struct CachedRanges
+	{
+		std::vector<std::tuple<HighlightType, int, int>> singleLineRanges;
+		std::vector<std::tuple<HighlightType, int, int>> multiLineRanges;
+	};
+
+	bool restoreRanges(const RangesKey& key);
+	void cacheRanges(const RangesKey& key) const;
+
 	void createRanges(QTextDocument* doc, const std::vector<HighlightingRule>& quotationRules);
 	std::vector<std::tuple<HighlightType, int, int>> createMultiLineRanges(
 		QTextDocument* doc, std::vector<std::tuple<HighlightType, int, int>>* ranges);
@@ -81,7 +98,12 @@ private:
 	static std::map<std::wstring, std::vector<HighlightingRule>> s_highlightingRules;
 	static std::map<HighlightType, QTextCharFormat> s_charFormats;
 
+	static std::map<RangesKey, CachedRanges> s_cachedRanges;
+	static std::deque<RangesKey> s_cachedRangesOrder;	 // oldest first
+	static const size_t s_maxCachedRangesCount;
+
 	QTextDocument* m_document;
+	std::wstring m_language;
 
 	std::vector<HighlightingRule> m_highlightingRules;
 	std::vector<std::tuple<HighlightType, int, int>> m_singleLineRanges;
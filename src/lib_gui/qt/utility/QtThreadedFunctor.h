@@ -10,6 +10,7 @@
 
 #include "MessageListener.h"
 #include "MessageWindowClosed.h"
+#include "QtViewUpdateBatch.h"
 
 class QtThreadedFunctorHelper
 	: public QObject
@@ -36,6 +37,12 @@ public:
 
 	void operator()(std::function<void(void)> callback)
 	{
+		// the updates of an activation are applied together
+		if (QtViewUpdateBatch::addCallback(callback))
+		{
+			return;
+		}
+
 		m_freeCallbacks.acquire();
 		m_callback = callback;
 		emit signalExecution();
@@ -0,0 +1,85 @@
+#include "QtViewUpdateBatch.h"
+
+#include <QThread>
+#include <QTimer>
+
+const int QtViewUpdateBatch::s_maxDelayMS = 100;
+
+QtViewUpdateBatch* QtViewUpdateBatch::s_instance = nullptr;
+
+bool QtViewUpdateBatch::addCallback(std::function<void(void)> callback)
+{
+	QtViewUpdateBatch* batch = s_instance;
+	if (!batch || QThread::currentThread() == batch->thread())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(batch->m_mutex);
+	if (!batch->m_openBatchCount)
+	{
+		return false;
+	}
+
+	batch->m_callbacks.push_back(callback);
+
+	if (!batch->m_flushScheduled)
+	{
+		batch->m_flushScheduled = true;
+		emit batch->signalScheduleFlush();
+	}
+	return true;
+}
+
+QtViewUpdateBatch::QtViewUpdateBatch()
+{
+	connect(this, &QtViewUpdateBatch::signalFlush, this, &QtViewUpdateBatch::flush);
+	connect(this, &QtViewUpdateBatch::signalScheduleFlush, this, &QtViewUpdateBatch::scheduleFlush);
+
+	s_instance = this;
+}
+
+QtViewUpdateBatch::~QtViewUpdateBatch()
+{
+	s_instance = nullptr;
+}
+
+void QtViewUpdateBatch::beginBatch()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_openBatchCount++;
+}
+
+void QtViewUpdateBatch::endBatch()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_openBatchCount > 0)
+	{
+		m_openBatchCount--;
+	}
+
+	if (!m_openBatchCount && !m_callbacks.empty())
+	{
+		emit signalFlush();
+	}
+}
+
+void QtViewUpdateBatch::flush()
+{
+	std::vector<std::function<void(void)>> callbacks;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		callbacks.swap(m_callbacks);
+		m_flushScheduled = false;
+	}
+
+	for (const std::function<void(void)>& callback: callbacks)
+	{
+		callback();
+	}
+}
+
+void QtViewUpdateBatch::scheduleFlush()
+{
+	QTimer::singleShot(s_maxDelayMS, this, &QtViewUpdateBatch::flush);
+}
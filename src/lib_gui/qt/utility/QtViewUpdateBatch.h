@@ -0,0 +1,49 @@
+#ifndef QT_VIEW_UPDATE_BATCH_H
+#define QT_VIEW_UPDATE_BATCH_H
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QObject>
+
+#include "ViewUpdateBatch.h"
+
+// Collects the callbacks that other threads send to the Qt thread while a ViewUpdateBatch is open
+// and runs them within one event, so the widgets get laid out and painted once. No callback waits
+// longer than s_maxDelayMS, so slow activations still show their partial results.
+class QtViewUpdateBatch
+	: public QObject
+	, public ViewUpdateBatch::Handler
+{
+	Q_OBJECT
+
+signals:
+	void signalFlush();
+	void signalScheduleFlush();
+
+private slots:
+	void flush();
+	void scheduleFlush();
+
+public:
+	// returns false if the callback has to be sent on its own
+	static bool addCallback(std::function<void(void)> callback);
+
+	QtViewUpdateBatch();
+	~QtViewUpdateBatch();
+
+	void beginBatch() override;
+	void endBatch() override;
+
+private:
+	static const int s_maxDelayMS;
+	static QtViewUpdateBatch* s_instance;
+
+	std::mutex m_mutex;
+	int m_openBatchCount = 0;
+	bool m_flushScheduled = false;
+	std::vector<std::function<void(void)>> m_callbacks;
+};
+
+#endif	  // QT_VIEW_UPDATE_BATCH_H
@@ -1,5 +1,6 @@
 #include "QtCodeView.h"
 
+#include "ActivationLatencyTracker.h"
 #include "CodeController.h"
 #include "ResourcePaths.h"
 #include "tracing.h"
@@ -86,8 +87,10 @@ void QtCodeView::showSnippets(
 	const CodeParams params,
 	const CodeScrollParams scrollParams)
 {
+	const Id activationId = ActivationLatencyTracker::getCurrentActivationId();
 	m_onQtThread([=]() {
 		TRACE("show snippets");
+		ActivationLatencySpan latencySpan(activationId, "QtCodeView::showSnippets", true);
 
 		m_widget->setMode(QtCodeNavigator::MODE_LIST);
 
@@ -98,6 +101,7 @@ void QtCodeView::showSnippets(
 
 		setNavigationState(params);
 
+		m_widget->setHasMoreSnippetFiles(params.hasMoreReferenceFiles);
 		for (const CodeFileParams& file: files)
 		{
 			m_widget->addSnippetFile(file);
@@ -112,8 +116,10 @@ void QtCodeView::showSnippets(
 void QtCodeView::showSingleFile(
 	const CodeFileParams file, const CodeParams params, const CodeScrollParams scrollParams)
 {
+	const Id activationId = ActivationLatencyTracker::getCurrentActivationId();
 	m_onQtThread([=]() {
 		TRACE("show single file");
+		ActivationLatencySpan latencySpan(activationId, "QtCodeView::showSingleFile", true);
 
 		bool animatedScroll = !m_widget->isInListMode();
 
@@ -262,7 +262,8 @@ DatabasePolicy QtDialogView::finishedIndexingDialog(
 	float time,
 	ErrorCountInfo errorInfo,
 	bool interrupted,
-	bool shallow)
+	bool shallow,
+	const std::vector<StorageIndexingTime>& slowestFiles)
 {
 	DatabasePolicy policy = DATABASE_POLICY_UNKNOWN;
 	m_resultReady = false;
@@ -280,6 +281,7 @@ DatabasePolicy QtDialogView::finishedIndexingDialog(
 			interrupted,
 			shallow);
 		window->updateErrorCount(errorInfo.total, errorInfo.fatal);
+		window->updateSlowestFiles(slowestFiles);
 		connect(window, &QtIndexingDialog::finished, [this, &policy]() {
 			setUIBlocked(false);
 			policy = DATABASE_POLICY_KEEP;
@@ -63,7 +63,8 @@ public:
 		float time,
 		ErrorCountInfo errorInfo,
 		bool interrupted,
-		bool shallow) override;
+		bool shallow,
+		const std::vector<StorageIndexingTime>& slowestFiles) override;
 
 	int confirm(const std::wstring& message, const std::vector<std::wstring>& options) override;
 
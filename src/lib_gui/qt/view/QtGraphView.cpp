@@ -5,6 +5,7 @@
 #include <QGraphicsScene>
 #include <QLabel>
 #include <QMouseEvent>
+#include <QOpenGLWidget>
 #include <QParallelAnimationGroup>
 #include <QPropertyAnimation>
 #include <QPushButton>
@@ -13,9 +14,11 @@
 #include <QSlider>
 #include <QStackedLayout>
 
+#include "ActivationLatencyTracker.h"
 #include "ApplicationSettings.h"
 #include "DummyEdge.h"
 #include "DummyNode.h"
+#include "GraphController.h"
 #include "GraphViewStyle.h"
 #include "MessageActivateTrail.h"
 #include "MessageCustomTrailShow.h"
@@ -60,6 +63,18 @@ QtGraphView::QtGraphView(ViewLayout* viewLayout)
 	view->setScene(scene);
 	view->setDragMode(QGraphicsView::ScrollHandDrag);
 	view->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+
+	if (ApplicationSettings::getInstance()->getGraphHardwareRenderingEnabled())
+	{
+		// the scene is painted by the OpenGL paint engine, which batches the geometry of the items.
+		// Partial updates would need the whole frame anyway.
+		QOpenGLWidget* viewport = new QOpenGLWidget();
+		QSurfaceFormat format;
+		format.setSamples(4);
+		viewport->setFormat(format);
+		view->setViewport(viewport);
+		view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+	}
 	view->viewport()->setCursor(Qt::ArrowCursor);
 
 	widget->layout()->addWidget(view);
@@ -221,6 +236,23 @@ QtGraphView::QtGraphView(ViewLayout* viewLayout)
 
 		m_groupWidget->setLayout(layout);
 	}
+
+	// stop control, shown while the levels of a custom trail come in
+	{
+		m_stopTrailButton = new QPushButton("Stop Here", widget);
+		m_stopTrailButton->setObjectName("stop_trail_button");
+		m_stopTrailButton->setToolTip("keep the trail traversed so far");
+		m_stopTrailButton->setGeometry(96, 8, 80, 26);
+		m_stopTrailButton->hide();
+
+		connect(m_stopTrailButton, &QPushButton::clicked, [this]() {
+			if (GraphController* controller = getController<GraphController>())
+			{
+				controller->stopTrail();
+			}
+			m_stopTrailButton->hide();
+		});
+	}
 }
 
 void QtGraphView::createWidgetWrapper() {}
@@ -239,6 +271,7 @@ void QtGraphView::refreshView()
 
 		m_trailWidget->setStyleSheet(css.c_str());
 		m_groupWidget->setStyleSheet(css.c_str());
+		m_stopTrailButton->setStyleSheet(css.c_str());
 
 		updateTrailButtons();
 	});
@@ -254,10 +287,23 @@ void QtGraphView::findMatches(ScreenSearchSender* sender, const std::wstring& qu
 	m_onQtThread([sender, query, this]() {
 		m_matchedNodes.clear();
 
-		for (QtGraphNode* node: m_oldNodes)
+		if (m_matchQuery.size() && query.compare(0, m_matchQuery.size(), m_matchQuery) == 0)
 		{
-			node->matchNameRecursive(query, &m_matchedNodes);
+			for (QtGraphNode* node: m_matchCandidates)
+			{
+				node->matchName(query, &m_matchedNodes);
+			}
 		}
+		else
+		{
+			for (QtGraphNode* node: m_oldNodes)
+			{
+				node->matchNameRecursive(query, &m_matchedNodes);
+			}
+		}
+
+		m_matchQuery = query;
+		m_matchCandidates = m_matchedNodes;
 
 		sender->foundMatches(this, m_matchedNodes.size());
 	});
@@ -317,7 +363,10 @@ void QtGraphView::rebuildGraph(
 	const std::vector<std::shared_ptr<DummyEdge>>& edges,
 	const GraphParams params)
 {
+	const Id activationId = ActivationLatencyTracker::getCurrentActivationId();
 	m_onQtThread([=]() {
+		ActivationLatencySpan latencySpan(activationId, "QtGraphView::rebuildGraph", true);
+
 		if (m_transition && m_transition->currentTime() < m_transition->totalDuration())
 		{
 			m_transition->stop();
@@ -331,6 +380,8 @@ void QtGraphView::rebuildGraph(
 		}
 
 		m_matchedNodes.clear();
+		m_matchQuery.clear();
+		m_matchCandidates.clear();
 
 		QGraphicsView* view = getView();
 
@@ -400,6 +451,8 @@ void QtGraphView::rebuildGraph(
 		m_scrollToTop = params.scrollToTop;
 		m_isIndexedList = params.isIndexedList;
 
+		m_stopTrailButton->setVisible(params.isPartialTrail);
+
 		if (params.animatedTransition && ApplicationSettings::getInstance()->getUseAnimations() &&
 			view->isVisible())
 		{
@@ -415,6 +468,8 @@ void QtGraphView::rebuildGraph(
 void QtGraphView::clear()
 {
 	m_onQtThread([this]() {
+		m_stopTrailButton->hide();
+
 		m_oldActiveNode = nullptr;
 		m_activeNodes.clear();
 
@@ -438,6 +493,8 @@ void QtGraphView::clear()
 		m_oldGraph.reset();
 
 		m_matchedNodes.clear();
+		m_matchQuery.clear();
+		m_matchCandidates.clear();
 
 		getView()->scene()->clear();
 	});
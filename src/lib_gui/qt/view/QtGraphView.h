@@ -172,10 +172,16 @@ private:
 	QtSelfRefreshIconButton* m_groupFileButton;
 	QtSelfRefreshIconButton* m_groupNamespaceButton;
 
+	QPushButton* m_stopTrailButton;
+
 	std::vector<QRectF> m_virtualNodeRects;
 
 	// Name matches
 	std::vector<QtGraphNode*> m_matchedNodes;
+
+	// the nodes matching the last query, only these can match queries extending it
+	std::wstring m_matchQuery;
+	std::vector<QtGraphNode*> m_matchCandidates;
 };
 
 #endif	  // QT_GRAPH_VIEW_H
@@ -55,6 +55,11 @@ void QtSearchView::setAutocompletionList(const std::vector<SearchMatch>& autocom
 	m_onQtThread([=]() { m_widget->setAutocompletionList(autocompletionList); });
 }
 
+void QtSearchView::appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList)
+{
+	m_onQtThread([=]() { m_widget->appendAutocompletionList(autocompletionList); });
+}
+
 void QtSearchView::setStyleSheet()
 {
 	const std::string css = utility::getStyleSheet(
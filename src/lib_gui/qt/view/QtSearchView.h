@@ -24,6 +24,7 @@ public:
 	void setFocus() override;
 	void findFulltext() override;
 	void setAutocompletionList(const std::vector<SearchMatch>& autocompletionList) override;
+	void appendAutocompletionList(const std::vector<SearchMatch>& autocompletionList) override;
 
 private:
 	void setStyleSheet();
@@ -0,0 +1,95 @@
+#include "QtActivationLatencyWindow.h"
+
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QSpinBox>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "ActivationLatencyTracker.h"
+#include "ApplicationSettings.h"
+
+QtActivationLatencyWindow::QtActivationLatencyWindow(QWidget* parent)
+	: QtWindow(false, parent), m_budget(nullptr), m_report(nullptr), m_timer(nullptr)
+{
+}
+
+QSize QtActivationLatencyWindow::sizeHint() const
+{
+	return QSize(700, 600);
+}
+
+void QtActivationLatencyWindow::populateWindow(QWidget* widget)
+{
+	QVBoxLayout* layout = new QVBoxLayout(widget);
+
+	QHBoxLayout* budgetLayout = new QHBoxLayout();
+	budgetLayout->addWidget(new QLabel("Log activations slower than"));
+
+	m_budget = new QSpinBox();
+	m_budget->setRange(0, 60000);
+	m_budget->setSuffix(" ms");
+	m_budget->setSpecialValueText("never");
+	m_budget->setValue(int(ActivationLatencyTracker::getInstance()->getBudgetMs()));
+	connect(
+		m_budget,
+		QOverload<int>::of(&QSpinBox::valueChanged),
+		this,
+		&QtActivationLatencyWindow::budgetChanged);
+	budgetLayout->addWidget(m_budget);
+	budgetLayout->addStretch();
+	layout->addLayout(budgetLayout);
+
+	m_report = new QPlainTextEdit();
+	m_report->setReadOnly(true);
+	m_report->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+	layout->addWidget(m_report);
+
+	widget->setLayout(layout);
+
+	m_timer = new QTimer(this);
+	connect(m_timer, &QTimer::timeout, this, &QtActivationLatencyWindow::updateReport);
+	m_timer->start(500);
+	updateReport();
+}
+
+void QtActivationLatencyWindow::windowReady()
+{
+	updateTitle("Activation Latencies");
+	updateCloseButton("Close");
+
+	setNextVisible(false);
+	setPreviousVisible(false);
+}
+
+void QtActivationLatencyWindow::updateReport()
+{
+	const std::vector<ActivationLatencyTracker::Activation> activations =
+		ActivationLatencyTracker::getInstance()->getActivations();
+
+	std::wstring text;
+	for (auto it = activations.rbegin(); it != activations.rend(); it++)
+	{
+		text += ActivationLatencyTracker::getReport(*it) + L"\n";
+	}
+
+	const QString report = QString::fromStdWString(text);
+	if (report != m_report->toPlainText())
+	{
+		const int scrollPosition = m_report->verticalScrollBar()->value();
+		m_report->setPlainText(report);
+		m_report->verticalScrollBar()->setValue(scrollPosition);
+	}
+}
+
+void QtActivationLatencyWindow::budgetChanged(int budgetMs)
+{
+	ActivationLatencyTracker::getInstance()->setBudgetMs(size_t(budgetMs));
+
+	ApplicationSettings* settings = ApplicationSettings::getInstance().get();
+	settings->setActivationLatencyBudgetMs(budgetMs);
+	settings->save();
+}
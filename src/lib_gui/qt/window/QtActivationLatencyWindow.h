@@ -0,0 +1,32 @@
+#ifndef QT_ACTIVATION_LATENCY_WINDOW_H
+#define QT_ACTIVATION_LATENCY_WINDOW_H
+
+#include "QtWindow.h"
+
+class QPlainTextEdit;
+class QSpinBox;
+class QTimer;
+
+// Developer panel that lists the spans of the recent activations of tokens, latest first.
+class QtActivationLatencyWindow: public QtWindow
+{
+	Q_OBJECT
+public:
+	QtActivationLatencyWindow(QWidget* parent = 0);
+	QSize sizeHint() const override;
+
+protected:
+	// QtWindow implementation
+	virtual void populateWindow(QWidget* widget) override;
+	virtual void windowReady() override;
+
+private:
+	void updateReport();
+	void budgetChanged(int budgetMs);
+
+	QSpinBox* m_budget;
+	QPlainTextEdit* m_report;
+	QTimer* m_timer;
+};
+
+#endif	  // QT_ACTIVATION_LATENCY_WINDOW_H
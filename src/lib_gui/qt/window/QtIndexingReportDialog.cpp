@@ -6,6 +6,7 @@
 #include "MessageErrorsHelpMessage.h"
 #include "MessageIndexingShowDialog.h"
 #include "MessageRefresh.h"
+#include "FilePath.h"
 #include "TimeStamp.h"
 
 QtIndexingReportDialog::QtIndexingReportDialog(
@@ -48,6 +49,10 @@ QtIndexingReportDialog::QtIndexingReportDialog(
 	QtIndexingDialog::createMessageLabel(m_layout)->setText(
 		"Time:   " + QString::fromStdString(TimeStamp::secondsToString(time)));
 
+	m_layout->addSpacing(12);
+	m_slowestFilesLabel = QtIndexingDialog::createMessageLabel(m_layout);
+	m_slowestFilesLabel->hide();
+
 	m_layout->addSpacing(12);
 	m_errorWidget = QtIndexingDialog::createErrorWidget(m_layout);
 
@@ -106,7 +111,7 @@ QtIndexingReportDialog::QtIndexingReportDialog(
 
 QSize QtIndexingReportDialog::sizeHint() const
 {
-	return QSize(m_interrupted ? 400 : 430, 280);
+	return QSize(m_interrupted ? 400 : 430, 280 + int(m_slowestFileCount) * 18);
 }
 
 void QtIndexingReportDialog::updateErrorCount(size_t errorCount, size_t fatalCount)
@@ -131,6 +136,43 @@ void QtIndexingReportDialog::updateErrorCount(size_t errorCount, size_t fatalCou
 	}
 }
 
+void QtIndexingReportDialog::updateSlowestFiles(const std::vector<StorageIndexingTime>& slowestFiles)
+{
+	if (slowestFiles.empty())
+	{
+		return;
+	}
+
+	QString text = "Slowest files:";
+	QString toolTip;
+	for (const StorageIndexingTime& indexingTime: slowestFiles)
+	{
+		text += "<br />&nbsp;&nbsp;" +
+			QString::fromStdWString(FilePath(indexingTime.filePath).fileName()).toHtmlEscaped() +
+			"&nbsp;&nbsp;" +
+			QString::fromStdString(TimeStamp::secondsToString(indexingTime.durationMs / 1000.0f));
+
+		if (!toolTip.isEmpty())
+		{
+			toolTip += "\n";
+		}
+		toolTip += QString::fromStdWString(indexingTime.filePath) + " (parse " +
+			QString::number(indexingTime.parseDurationMs) + " ms, visit " +
+			QString::number(indexingTime.visitDurationMs) + " ms, " +
+			(indexingTime.garbageCollectionDurationMs
+				 ? "gc " + QString::number(indexingTime.garbageCollectionDurationMs) + " ms, "
+				 : QString()) +
+			QString::number(indexingTime.storageByteCount / 1024) + " KB)";
+	}
+
+	m_slowestFilesLabel->setText(text);
+	m_slowestFilesLabel->setToolTip(toolTip);
+	m_slowestFilesLabel->show();
+
+	m_slowestFileCount = slowestFiles.size();
+	resize(sizeHint());
+}
+
 void QtIndexingReportDialog::closeEvent(QCloseEvent* event)
 {
 	emit QtIndexingDialog::canceled();
@@ -2,6 +2,7 @@
 #define QT_INDEXING_REPORT_DIALOG_H
 
 #include "QtIndexingDialog.h"
+#include "StorageIndexingTime.h"
 
 class QtIndexingReportDialog: public QtIndexingDialog
 {
@@ -23,6 +24,7 @@ public:
 	QSize sizeHint() const override;
 
 	void updateErrorCount(size_t errorCount, size_t fatalCount);
+	void updateSlowestFiles(const std::vector<StorageIndexingTime>& slowestFiles);
 
 protected:
 	void closeEvent(QCloseEvent* event) override;
@@ -34,6 +36,8 @@ private:
 	void onStartInDepthPressed();
 
 	QWidget* m_errorWidget;
+	QLabel* m_slowestFilesLabel;
+	size_t m_slowestFileCount = 0;
 	bool m_interrupted;
 };
 
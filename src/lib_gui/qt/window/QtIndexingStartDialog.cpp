@@ -52,9 +52,11 @@ QtIndexingStartDialog::QtIndexingStartDialog(
 				"<b>All files:</b> Deletes the previous index and reindexes all files from "
 				"scratch.<br /><br />") +
 			(enabledShallowOption
-				 ? "<br /><b>Shallow Python Indexing:</b> References within your code base (calls, "
+				 ? "<br /><b>Shallow Indexing:</b> References within your Python code base (calls, "
 				   "usages, etc.) are resolved by name, which is "
-				   "imprecise but much faster than in-depth indexing.<br />"
+				   "imprecise but much faster than in-depth indexing. C/C++ files are indexed "
+				   "without their function bodies and are marked incomplete until they get "
+				   "indexed in depth.<br />"
 				   "<i>Hint: Use this option for a quick first indexing pass and start browsing "
 				   "the code base "
 				   "while running a second pass for in-depth indexing.<br /><br />"
@@ -108,7 +110,7 @@ QtIndexingStartDialog::QtIndexingStartDialog(
 
 	if (enabledShallowOption)
 	{
-		QCheckBox* shallowIndexingCheckBox = new QCheckBox("Shallow Python Indexing");
+		QCheckBox* shallowIndexingCheckBox = new QCheckBox("Shallow Indexing");
 		connect(shallowIndexingCheckBox, &QCheckBox::toggled, [=]() {
 			emit setShallowIndexing(shallowIndexingCheckBox->isChecked());
 		});
@@ -14,6 +14,7 @@
 #include "ApplicationSettings.h"
 #include "Bookmark.h"
 #include "CompositeView.h"
+#include "FileLogger.h"
 #include "FileSystem.h"
 #include "MessageActivateBase.h"
 #include "MessageActivateOverview.h"
@@ -32,12 +33,15 @@
 #include "MessageRefresh.h"
 #include "MessageRefreshUI.h"
 #include "MessageResetZoom.h"
+#include "MessageShowMemoryReport.h"
+#include "MessageStatus.h"
 #include "MessageTabClose.h"
 #include "MessageTabOpen.h"
 #include "MessageTabSelect.h"
 #include "MessageWindowClosed.h"
 #include "MessageZoom.h"
 #include "QtAbout.h"
+#include "QtActivationLatencyWindow.h"
 #include "QtContextMenu.h"
 #include "QtFileDialog.h"
 #include "QtKeyboardShortcuts.h"
@@ -549,6 +553,38 @@ void QtMainWindow::showLogFolder()
 		QUrl::TolerantMode));
 }
 
+void QtMainWindow::toggleTraceRecording(bool enabled)
+{
+	TimelineTracer::setEnabled(enabled);
+	if (enabled)
+	{
+		MessageStatus(L"Recording trace").dispatch();
+		return;
+	}
+
+	const FilePath tracePath = UserPaths::getLogPath().concatenate(
+		FileLogger::generateDatedFileName(L"trace") + L".json");
+	if (TimelineTracer::exportChromeTrace(tracePath))
+	{
+		MessageStatus(L"Saved trace to " + tracePath.wstr()).dispatch();
+	}
+	else
+	{
+		MessageStatus(L"Failed to save trace to " + tracePath.wstr(), true).dispatch();
+	}
+}
+
+void QtMainWindow::showActivationLatencies()
+{
+	QtActivationLatencyWindow* latencyWindow = createWindow<QtActivationLatencyWindow>();
+	latencyWindow->setup();
+}
+
+void QtMainWindow::showMemoryReport()
+{
+	MessageShowMemoryReport().dispatch();
+}
+
 void QtMainWindow::openTab()
 {
 	MessageTabOpen().dispatch();
@@ -1084,6 +1120,15 @@ void QtMainWindow::setupHelpMenu()
 
 	menu->addAction(tr("Show Data Folder"), this, &QtMainWindow::showDataFolder);
 	menu->addAction(tr("Show Log Folder"), this, &QtMainWindow::showLogFolder);
+
+	QAction* traceAction = menu->addAction(tr("Record Trace"));
+	traceAction->setCheckable(true);
+	traceAction->setToolTip(tr("Saves a timeline to the log folder when unchecked"));
+	connect(traceAction, &QAction::toggled, this, &QtMainWindow::toggleTraceRecording);
+
+	menu->addAction(
+		tr("Show Activation Latencies"), this, &QtMainWindow::showActivationLatencies);
+	menu->addAction(tr("Show Memory Report"), this, &QtMainWindow::showMemoryReport);
 }
 
 QtMainWindow::DockWidget* QtMainWindow::getDockWidgetForView(View* view)
@@ -107,6 +107,9 @@ public slots:
 
 	void showDataFolder();
 	void showLogFolder();
+	void toggleTraceRecording(bool enabled);
+	void showActivationLatencies();
+	void showMemoryReport();
 
 	void openTab();
 	void closeTab();
@@ -0,0 +1,169 @@
+#include "FileSystemWatcher.h"
+
+#include <mutex>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include "logging.h"
+
+namespace
+{
+// changes come in bursts when saving several files or switching branches
+const int changeNotificationDelayMs = 2000;
+
+void onQtThread(std::function<void()> callback)
+{
+	if (QCoreApplication* application = QCoreApplication::instance())
+	{
+		QMetaObject::invokeMethod(application, callback, Qt::QueuedConnection);
+	}
+}
+}	 // namespace
+
+struct FileSystemWatcher::State
+{
+	std::function<void()> onChange;
+
+	// only accessed on the Qt thread
+	QFileSystemWatcher* watcher = nullptr;
+	QTimer* timer = nullptr;
+
+	mutable std::mutex mutex;
+	std::set<FilePath> changedDirectoryPaths;
+	std::set<FilePath> unwatchedDirectoryPaths;
+	size_t changeCount = 0;
+	size_t pendingUpdateCount = 0;
+};
+
+FileSystemWatcher::FileSystemWatcher(std::function<void()> onChange)
+	: m_state(std::make_shared<State>())
+{
+	m_state->onChange = onChange;
+}
+
+FileSystemWatcher::~FileSystemWatcher()
+{
+	std::shared_ptr<State> state = m_state;
+	onQtThread([state]() {
+		delete state->watcher;
+		delete state->timer;
+		state->watcher = nullptr;
+		state->timer = nullptr;
+	});
+}
+
+void FileSystemWatcher::setWatchedDirectories(const std::set<FilePath>& directoryPaths)
+{
+	QSet<QString> paths;
+	for (const FilePath& directoryPath: directoryPaths)
+	{
+		paths.insert(QString::fromStdWString(directoryPath.wstr()));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_state->mutex);
+		m_state->pendingUpdateCount++;
+	}
+
+	std::shared_ptr<State> state = m_state;
+	onQtThread([state, paths]() {
+		if (!state->watcher)
+		{
+			state->watcher = new QFileSystemWatcher();
+			state->timer = new QTimer();
+			state->timer->setSingleShot(true);
+			state->timer->setInterval(changeNotificationDelayMs);
+
+			QObject::connect(state->timer, &QTimer::timeout, [state]() {
+				if (state->onChange)
+				{
+					state->onChange();
+				}
+			});
+
+			QObject::connect(
+				state->watcher, &QFileSystemWatcher::directoryChanged, [state](const QString& path) {
+					{
+						std::lock_guard<std::mutex> lock(state->mutex);
+						state->changedDirectoryPaths.insert(FilePath(path.toStdWString()));
+						state->changeCount++;
+
+						// removed directories are not watched anymore
+						if (!QFileInfo::exists(path))
+						{
+							state->unwatchedDirectoryPaths.insert(FilePath(path.toStdWString()));
+						}
+					}
+					state->timer->start();
+				});
+		}
+
+		const QSet<QString> watchedPaths = state->watcher->directories().toSet();
+
+		const QStringList removedPaths = (watchedPaths - paths).toList();
+		if (!removedPaths.isEmpty())
+		{
+			state->watcher->removePaths(removedPaths);
+		}
+
+		QStringList failedPaths;
+		const QStringList addedPaths = (paths - watchedPaths).toList();
+		if (!addedPaths.isEmpty())
+		{
+			failedPaths = state->watcher->addPaths(addedPaths);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->unwatchedDirectoryPaths.clear();
+			for (const QString& path: failedPaths)
+			{
+				state->unwatchedDirectoryPaths.insert(FilePath(path.toStdWString()));
+			}
+			state->pendingUpdateCount--;
+		}
+
+		if (!failedPaths.isEmpty())
+		{
+			LOG_WARNING(
+				"Unable to watch " + std::to_string(failedPaths.size()) + " of " +
+				std::to_string(paths.size()) +
+				" directories for changes, their files are checked on every refresh.");
+		}
+	});
+}
+
+bool FileSystemWatcher::isWatching() const
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	return QCoreApplication::instance() && m_state->pendingUpdateCount == 0;
+}
+
+size_t FileSystemWatcher::getChangeCount() const
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	return m_state->changeCount;
+}
+
+std::set<FilePath> FileSystemWatcher::getChangedDirectories() const
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	std::set<FilePath> directoryPaths = m_state->changedDirectoryPaths;
+	directoryPaths.insert(
+		m_state->unwatchedDirectoryPaths.begin(), m_state->unwatchedDirectoryPaths.end());
+	return directoryPaths;
+}
+
+void FileSystemWatcher::clearChangedDirectories(size_t changeCount)
+{
+	std::lock_guard<std::mutex> lock(m_state->mutex);
+	if (m_state->changeCount == changeCount)
+	{
+		m_state->changedDirectoryPaths.clear();
+	}
+}
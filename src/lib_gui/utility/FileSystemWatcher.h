@@ -0,0 +1,41 @@
+#ifndef FILE_SYSTEM_WATCHER_H
+#define FILE_SYSTEM_WATCHER_H
+
+#include <functional>
+#include <memory>
+#include <set>
+
+#include "FilePath.h"
+
+// Tracks changes within directories using the native change notifications of the platform
+// (inotify, FSEvents or ReadDirectoryChangesW as wrapped by Qt). A change of a file is reported
+// for the directory containing it, so a refresh only needs to look at the files of changed
+// directories. Directories that can't be watched are always reported as changed.
+class FileSystemWatcher
+{
+public:
+	// the callback is called on the Qt thread once no more changes came in for a moment
+	FileSystemWatcher(std::function<void()> onChange);
+	~FileSystemWatcher();
+
+	FileSystemWatcher(const FileSystemWatcher&) = delete;
+	FileSystemWatcher& operator=(const FileSystemWatcher&) = delete;
+
+	void setWatchedDirectories(const std::set<FilePath>& directoryPaths);
+
+	// false until the directories passed last are watched
+	bool isWatching() const;
+
+	size_t getChangeCount() const;
+	std::set<FilePath> getChangedDirectories() const;
+
+	// only clears if no change came in after the given change count
+	void clearChangedDirectories(size_t changeCount);
+
+private:
+	struct State;
+
+	std::shared_ptr<State> m_state;
+};
+
+#endif	  // FILE_SYSTEM_WATCHER_H
@@ -1,5 +1,7 @@
 #include "utilityApp.h"
 
+#include <cmath>
+#include <fstream>
 #include <mutex>
 #include <set>
 
@@ -9,44 +11,82 @@
 #include <QThread>
 #include <qprocessordetection.h>
 
+#ifdef _WIN32
+#	include <windows.h>
+#	include <psapi.h>
+#else
+#	include <sys/resource.h>
+#	include <unistd.h>
+#	ifdef __APPLE__
+#		include <mach/mach.h>
+#	endif
+#endif
+
 #include "AppPath.h"
 #include "ApplicationSettings.h"
 #include "UserPaths.h"
 #include "logging.h"
 #include "utilityString.h"
+#include "utilitySystemResources.h"
 
 namespace
 {
-void logProcessStreams(QProcess& process, std::wstring& outputBuffer, std::wstring& errorBuffer)
+void logProcessOutputStream(QProcess& process, std::wstring& outputBuffer)
 {
+	outputBuffer += QString(process.readAllStandardOutput()).toStdWString();
+	std::vector<std::wstring> outputLines = utility::split<std::vector<std::wstring>>(
+		outputBuffer, L"\n");
+	for (size_t i = 0; i < outputLines.size() - 1; i++)
 	{
-		outputBuffer += QString(process.readAllStandardOutput()).toStdWString();
-		std::vector<std::wstring> outputLines = utility::split<std::vector<std::wstring>>(
-			outputBuffer, L"\n");
-		for (size_t i = 0; i < outputLines.size() - 1; i++)
+		if (outputLines[i].back() == L'\r')
 		{
-			if (outputLines[i].back() == L'\r')
-			{
-				outputLines[i].pop_back();
-			}
-			LOG_INFO_BARE(L"Process output: " + outputLines[i]);
+			outputLines[i].pop_back();
 		}
-		outputBuffer = outputLines.back();
+		LOG_INFO_BARE(L"Process output: " + outputLines[i]);
 	}
+	outputBuffer = outputLines.back();
+}
+
+void logProcessErrorStream(QProcess& process, std::wstring& errorBuffer)
+{
+	errorBuffer += QString(process.readAllStandardError()).toStdWString();
+	std::vector<std::wstring> errorLines = utility::split<std::vector<std::wstring>>(
+		errorBuffer, L"\n");
+	for (size_t i = 0; i < errorLines.size() - 1; i++)
 	{
-		errorBuffer += QString(process.readAllStandardError()).toStdWString();
-		std::vector<std::wstring> errorLines = utility::split<std::vector<std::wstring>>(
-			errorBuffer, L"\n");
-		for (size_t i = 0; i < errorLines.size() - 1; i++)
+		if (errorLines[i].back() == L'\r')
 		{
-			if (errorLines[i].back() == L'\r')
-			{
-				errorLines[i].pop_back();
-			}
-			LOG_ERROR_BARE(L"Process error: " + errorLines[i]);
+			errorLines[i].pop_back();
 		}
-		errorBuffer = errorLines.back();
+		LOG_ERROR_BARE(L"Process error: " + errorLines[i]);
+	}
+	errorBuffer = errorLines.back();
+}
+
+void logProcessStreams(QProcess& process, std::wstring& outputBuffer, std::wstring& errorBuffer)
+{
+	logProcessOutputStream(process, outputBuffer);
+	logProcessErrorStream(process, errorBuffer);
+}
+
+std::wstring getProcessErrorMessage(QProcess::ProcessError error)
+{
+	switch (error)
+	{
+	case QProcess::FailedToStart:
+		return L"File not found or resource error occurred.";
+	case QProcess::Crashed:
+		return L"Process crashed.";
+	case QProcess::Timedout:
+		return L"Process timed out.";
+	case QProcess::ReadError:
+		return L"A read error occurred while executing process.";
+	case QProcess::WriteError:
+		return L"A write error occurred while executing process.";
+	case QProcess::UnknownError:
+		break;
 	}
+	return L"An unknown error occurred while executing process.";
 }
 }	 // namespace
 
@@ -165,27 +205,7 @@ int utility::executeProcessAndGetExitCode(
 			finished = true;
 			if (errorMessage != nullptr)
 			{
-				switch (error)
-				{
-				case QProcess::FailedToStart:
-					*errorMessage = L"File not found or resource error occurred.";
-					break;
-				case QProcess::Crashed:
-					*errorMessage = L"Process crashed.";
-					break;
-				case QProcess::Timedout:
-					*errorMessage = L"Process timed out.";
-					break;
-				case QProcess::ReadError:
-					*errorMessage = L"A read error occurred while executing process.";
-					break;
-				case QProcess::WriteError:
-					*errorMessage = L"A write error occurred while executing process.";
-					break;
-				case QProcess::UnknownError:
-					*errorMessage = L"An unknown error occurred while executing process.";
-					break;
-				}
+				*errorMessage = getProcessErrorMessage(error);
 			};
 		});
 
@@ -254,6 +274,83 @@ int utility::executeProcessAndGetExitCode(
 	return exitCode;
 }
 
+int utility::executeProcessAndReadOutput(
+	const std::wstring& commandPath,
+	const std::vector<std::wstring>& commandArguments,
+	const FilePath& workingDirectory,
+	std::function<void(const char*, size_t)> onOutput,
+	std::wstring* errorMessage)
+{
+	bool finished = false;
+
+	QProcess process;
+
+	QObject::connect(
+		&process, &QProcess::errorOccurred, [&finished, errorMessage](QProcess::ProcessError error) {
+			finished = true;
+			if (errorMessage != nullptr)
+			{
+				*errorMessage = getProcessErrorMessage(error);
+			}
+		});
+
+	QObject::connect(
+		&process,
+		static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+		[&finished](int exitCode, QProcess::ExitStatus exitStatus) { finished = true; });
+
+	if (!workingDirectory.empty())
+	{
+		process.setWorkingDirectory(QString::fromStdWString(workingDirectory.wstr()));
+	}
+
+	QString command = QString::fromStdWString(commandPath);
+	for (const std::wstring& commandArgument: commandArguments)
+	{
+		command += " " + QString::fromStdWString(commandArgument);
+	}
+
+	QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+	QStringList envlist = env.toStringList();
+	envlist.replaceInStrings(
+		QRegularExpression("^(?i)PATH=(.*)"), "PATH=/opt/local/bin:/usr/local/bin:$HOME/bin:\\1");
+	process.setEnvironment(envlist);
+
+	{
+		std::lock_guard<std::mutex> lock(s_runningProcessesMutex);
+		process.start(command);
+		s_runningProcesses.insert(&process);
+	}
+
+	std::wstring errorBuffer;
+	auto readStreams = [&]() {
+		const QByteArray output = process.readAllStandardOutput();
+		if (!output.isEmpty())
+		{
+			onOutput(output.constData(), size_t(output.size()));
+		}
+		logProcessErrorStream(process, errorBuffer);
+	};
+
+	while (!finished && !process.waitForFinished(0))
+	{
+		if (process.waitForReadyRead(1000))
+		{
+			readStreams();
+		}
+	}
+	readStreams();
+
+	{
+		std::lock_guard<std::mutex> lock(s_runningProcessesMutex);
+		s_runningProcesses.erase(&process);
+	}
+
+	const int exitCode = process.exitCode();
+	process.close();
+	return exitCode;
+}
+
 void utility::killRunningProcesses()
 {
 	std::lock_guard<std::mutex> lock(s_runningProcessesMutex);
@@ -266,6 +363,19 @@ void utility::killRunningProcesses()
 int utility::getIdealThreadCount()
 {
 	int threadCount = QThread::idealThreadCount();
+
+	// containers restrict the cpus by affinity or by a quota of cpu time
+	const size_t availableCpuCount = getAvailableCpuCount();
+	if (availableCpuCount > 0)
+	{
+		threadCount = std::min(threadCount, int(availableCpuCount));
+	}
+	const double cpuLimit = getCgroupCpuLimit();
+	if (cpuLimit > 0)
+	{
+		threadCount = std::min(threadCount, int(std::ceil(cpuLimit)));
+	}
+
 	if (getOsType() == OS_WINDOWS)
 	{
 		threadCount -= 1;
@@ -273,6 +383,61 @@ int utility::getIdealThreadCount()
 	return std::max(1, threadCount);
 }
 
+size_t utility::getPeakMemoryUsageKb()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize / 1024;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#	ifdef __APPLE__
+	return size_t(usage.ru_maxrss) / 1024;	  // reported in bytes on macOS
+#	else
+	return size_t(usage.ru_maxrss);
+#	endif
+#endif
+}
+
+size_t utility::getMemoryUsageKb()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.WorkingSetSize / 1024;
+	}
+	return 0;
+#elif defined(__APPLE__)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(
+			mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+		KERN_SUCCESS)
+	{
+		return 0;
+	}
+	return size_t(info.resident_size) / 1024;
+#else
+	// the second value is the resident set size in pages
+	std::ifstream statm("/proc/self/statm");
+	size_t totalPages = 0;
+	size_t residentPages = 0;
+	if (!(statm >> totalPages >> residentPages))
+	{
+		return 0;
+	}
+	return residentPages * size_t(sysconf(_SC_PAGESIZE)) / 1024;
+#endif
+}
+
 OsType utility::getOsType()
 {
 	if (QSysInfo::windowsVersion() != QSysInfo::WV_None)
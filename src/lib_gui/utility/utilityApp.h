@@ -1,6 +1,7 @@
 #ifndef UTILITY_APP_H
 #define UTILITY_APP_H
 
+#include <functional>
 #include <string>
 
 #include "ApplicationArchitectureType.h"
@@ -23,8 +24,19 @@ int executeProcessAndGetExitCode(
 	bool logProcessOutput = false,
 	std::wstring* errorMessage = nullptr);
 
+// passes the standard output of the process to the handler while it runs, so binary output can be
+// consumed as a stream, the standard error is logged
+int executeProcessAndReadOutput(
+	const std::wstring& commandPath,
+	const std::vector<std::wstring>& commandArguments,
+	const FilePath& workingDirectory,
+	std::function<void(const char*, size_t)> onOutput,
+	std::wstring* errorMessage = nullptr);
+
 void killRunningProcesses();
 int getIdealThreadCount();
+size_t getPeakMemoryUsageKb();
+size_t getMemoryUsageKb();	  // resident set size of this process right now
 
 OsType getOsType();
 std::string getOsTypeString();
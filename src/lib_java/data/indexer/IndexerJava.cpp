@@ -1,5 +1,10 @@
 #include "IndexerJava.h"
 
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#include "ApplicationSettings.h"
 #include "JavaParser.h"
 
 IndexerJava::~IndexerJava()
@@ -14,3 +19,89 @@ void IndexerJava::doIndex(
 {
 	JavaParser(parserClient, m_indexerStateInfo).buildIndex(indexerCommand);
 }
+
+size_t IndexerJava::getBatchSize(IndexerCommandType type) const
+{
+	if (type != getSupportedIndexerCommandType())
+	{
+		return 1;
+	}
+	// every parser thread gets a batch of its own
+	return size_t(std::max(1, ApplicationSettings::getInstance()->getJavaIndexerBatchSize())) *
+		getParserThreadCount();
+}
+
+void IndexerJava::doIndexBatch(
+	const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+	const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo)
+{
+	std::map<std::wstring, std::vector<size_t>> commandIndicesByEnvironment;
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		std::wstring key = indexerCommands[i]->getLanguageStandard();
+		for (const FilePath& path: indexerCommands[i]->getClassPath())
+		{
+			key += L";" + path.wstr();
+		}
+		commandIndicesByEnvironment[key].push_back(i);
+	}
+
+	const size_t threadCount = getParserThreadCount();
+
+	for (const auto& it: commandIndicesByEnvironment)
+	{
+		if (m_indexerStateInfo->indexingInterrupted)
+		{
+			return;
+		}
+
+		// split the commands into one contiguous slice per thread
+		const size_t sliceCount = std::min(threadCount, it.second.size());
+		std::vector<std::vector<size_t>> slices(sliceCount);
+		for (size_t i = 0; i < it.second.size(); i++)
+		{
+			slices[i * sliceCount / it.second.size()].push_back(it.second[i]);
+		}
+
+		// all threads share the JVM of this process, each one attaches with its own parsers
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < slices.size(); i++)
+		{
+			threads.emplace_back([&, i]() {
+				indexSlice(slices[i], indexerCommands, parserClients, m_indexerStateInfo);
+			});
+		}
+
+		indexSlice(slices.front(), indexerCommands, parserClients, m_indexerStateInfo);
+
+		for (std::thread& thread: threads)
+		{
+			thread.join();
+		}
+	}
+}
+
+size_t IndexerJava::getParserThreadCount()
+{
+	return size_t(std::max(1, ApplicationSettings::getInstance()->getJavaParserThreadCount()));
+}
+
+void IndexerJava::indexSlice(
+	const std::vector<size_t>& commandIndices,
+	const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+	const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo)
+{
+	std::vector<std::shared_ptr<JavaParser>> parsers;
+	std::vector<JavaParser*> parserPtrs;
+	std::vector<std::shared_ptr<IndexerCommandJava>> commands;
+	for (size_t i: commandIndices)
+	{
+		parsers.push_back(std::make_shared<JavaParser>(parserClients[i], m_indexerStateInfo));
+		parserPtrs.push_back(parsers.back().get());
+		commands.push_back(indexerCommands[i]);
+	}
+
+	JavaParser::buildIndex(parserPtrs, commands);
+}
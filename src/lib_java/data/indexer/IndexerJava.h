@@ -11,11 +11,29 @@ class IndexerJava: public Indexer<IndexerCommandJava>
 public:
 	virtual ~IndexerJava();
 
+	size_t getBatchSize(IndexerCommandType type) const override;
+
 private:
 	void doIndex(
 		std::shared_ptr<IndexerCommandJava> indexerCommand,
 		std::shared_ptr<ParserClientImpl> parserClient,
 		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo) override;
+
+	// parses commands that share language standard and class path with one name environment per
+	// parser thread
+	void doIndexBatch(
+		const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+		const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo) override;
+
+	static size_t getParserThreadCount();
+
+	// parses the given commands on the calling thread
+	static void indexSlice(
+		const std::vector<size_t>& commandIndices,
+		const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+		const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo);
 };
 
 #endif	  // INDEXER_JAVA_H
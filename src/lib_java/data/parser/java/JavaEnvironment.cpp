@@ -73,6 +73,57 @@ bool JavaEnvironment::callStaticVoidMethod(
 	return false;
 }
 
+bool JavaEnvironment::callStaticVoidMethod(
+	std::string className,
+	std::string methodName,
+	const std::vector<int>& arg1,
+	const std::vector<std::string>& arg2,
+	const std::vector<std::string>& arg3,
+	std::string arg4,
+	std::string arg5,
+	int arg6)
+{
+	jclass javaClass = getJavaClass(className);
+	jmethodID javaMethodId = getJavaStaticMethod(
+		javaClass,
+		methodName,
+		"([I[Ljava/lang/String;[Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;I)V");
+	if (javaMethodId != nullptr)
+	{
+		std::vector<jint> ints(arg1.begin(), arg1.end());
+		jintArray jarg1 = m_env->NewIntArray(jsize(ints.size()));
+		m_env->SetIntArrayRegion(jarg1, 0, jsize(ints.size()), ints.data());
+		jobjectArray jarg2 = toJStringArray(arg2);
+		jobjectArray jarg3 = toJStringArray(arg3);
+		jstring jarg4 = m_env->NewStringUTF(arg4.c_str());
+		jstring jarg5 = m_env->NewStringUTF(arg5.c_str());
+		jint jarg6 = arg6;
+		m_env->CallStaticVoidMethod(
+			javaClass, javaMethodId, jarg1, jarg2, jarg3, jarg4, jarg5, jarg6);
+
+		m_env->DeleteLocalRef(jarg1);
+		m_env->DeleteLocalRef(jarg2);
+		m_env->DeleteLocalRef(jarg3);
+		m_env->DeleteLocalRef(jarg4);
+		m_env->DeleteLocalRef(jarg5);
+		return true;
+	}
+	return false;
+}
+
+bool JavaEnvironment::callStaticLongMethod(
+	std::string className, std::string methodName, long long& ret)
+{
+	jclass javaClass = getJavaClass(className);
+	jmethodID javaMethodId = getJavaStaticMethod(javaClass, methodName, "()J");
+	if (javaMethodId != nullptr)
+	{
+		ret = m_env->CallStaticLongMethod(javaClass, javaMethodId);
+		return true;
+	}
+	return false;
+}
+
 bool JavaEnvironment::callStaticStringMethod(
 	std::string className, std::string methodName, std::string& ret, const std::string& arg1)
 {
@@ -133,6 +184,19 @@ jstring JavaEnvironment::toJString(std::string s)
 	return m_env->NewStringUTF(s.c_str());
 }
 
+jobjectArray JavaEnvironment::toJStringArray(const std::vector<std::string>& strings)
+{
+	jobjectArray array = m_env->NewObjectArray(
+		jsize(strings.size()), m_env->FindClass("java/lang/String"), nullptr);
+	for (size_t i = 0; i < strings.size(); i++)
+	{
+		jstring s = m_env->NewStringUTF(strings[i].c_str());
+		m_env->SetObjectArrayElement(array, jsize(i), s);
+		m_env->DeleteLocalRef(s);
+	}
+	return array;
+}
+
 void JavaEnvironment::registerNativeMethods(std::string className, std::vector<NativeMethod> methods)
 {
 	JNINativeMethod* jniMethods = new JNINativeMethod[methods.size()];
@@ -16,6 +16,9 @@ typedef _jclass* jclass;
 class _jstring;
 typedef _jstring* jstring;
 
+class _jobjectArray;
+typedef _jobjectArray* jobjectArray;
+
 struct _jmethodID;
 typedef struct _jmethodID* jmethodID;
 
@@ -48,6 +51,16 @@ public:
 		std::string arg4,
 		std::string arg5,
 		int arg6);
+	bool callStaticVoidMethod(
+		std::string className,
+		std::string methodName,
+		const std::vector<int>& arg1,
+		const std::vector<std::string>& arg2,
+		const std::vector<std::string>& arg3,
+		std::string arg4,
+		std::string arg5,
+		int arg6);
+	bool callStaticLongMethod(std::string className, std::string methodName, long long& ret);
 	bool callStaticStringMethod(
 		std::string className, std::string methodName, std::string& ret, const std::string& arg1);
 	bool callStaticStringMethod(
@@ -59,6 +72,7 @@ public:
 
 	std::string toStdString(jstring s);
 	jstring toJString(std::string s);
+	jobjectArray toJStringArray(const std::vector<std::string>& strings);
 
 	void registerNativeMethods(std::string className, std::vector<NativeMethod> methods);
 
@@ -1,6 +1,7 @@
 #include "JavaEnvironmentFactory.h"
 
 #include <cstdlib>
+#include <vector>
 
 #include <jni.h>
 
@@ -12,6 +13,9 @@
 
 void JavaEnvironmentFactory::createInstance(std::string classPath, std::string& errorString)
 {
+	// parsers of several indexer threads may try to launch the JVM at the same time
+	std::lock_guard<std::mutex> lock(s_instanceMutex);
+
 	if (s_instance)
 	{
 		if (classPath == s_classPath)
@@ -47,16 +51,32 @@ void JavaEnvironmentFactory::createInstance(std::string classPath, std::string&
 
 	s_classPath = classPath;
 
-	const int optionCount = 2;
+	std::vector<std::string> optionStrings = {"-Djava.class.path=" + classPath, "-Xms64m"};
+	const int maximumMemoryMb = ApplicationSettings::getInstance()->getJavaMaximumMemory();
+	if (maximumMemoryMb > 0)
+	{
+		optionStrings.push_back("-Xmx" + std::to_string(maximumMemoryMb) + "m");
+	}
+	for (const std::string& option: ApplicationSettings::getInstance()->getJavaVmOptions())
+	{
+		if (!option.empty())
+		{
+			optionStrings.push_back(option);
+		}
+	}
+
+	const int optionCount = int(optionStrings.size());
 
 	JavaVM* jvm = nullptr;	  // Pointer to the JVM (Java Virtual Machine)
 	JNIEnv* env = nullptr;	  // Pointer to native interface
 
 	JavaVMInitArgs vm_args;									  // Initialization arguments
 	JavaVMOption* options = new JavaVMOption[optionCount];	  // JVM invocation options
-	std::string classPathOption = "-Djava.class.path=" + classPath;
-	options[0].optionString = const_cast<char*>(classPathOption.c_str());
-	options[1].optionString = const_cast<char*>("-Xms64m");
+	for (int i = 0; i < optionCount; i++)
+	{
+		options[i].optionString = const_cast<char*>(optionStrings[i].c_str());
+		options[i].extraInfo = nullptr;
+	}
 
 	// use these options to enable profiling in VisualVM
 	// options[2].optionString = const_cast<char*>("-Dcom.sun.management.jmxremote");
@@ -108,6 +128,7 @@ void JavaEnvironmentFactory::createInstance(std::string classPath, std::string&
 
 std::shared_ptr<JavaEnvironmentFactory> JavaEnvironmentFactory::getInstance()
 {
+	std::lock_guard<std::mutex> lock(s_instanceMutex);
 	return s_instance;
 }
 
@@ -145,6 +166,8 @@ std::shared_ptr<JavaEnvironment> JavaEnvironmentFactory::createEnvironment()
 
 std::shared_ptr<JavaEnvironmentFactory> JavaEnvironmentFactory::s_instance;
 
+std::mutex JavaEnvironmentFactory::s_instanceMutex;
+
 std::string JavaEnvironmentFactory::s_classPath;
 
 JavaEnvironmentFactory::JavaEnvironmentFactory(JavaVM* jvm): m_jvm(jvm) {}
@@ -29,6 +29,7 @@ private:
 	friend class JavaEnvironment;
 
 	static std::shared_ptr<JavaEnvironmentFactory> s_instance;
+	static std::mutex s_instanceMutex;
 	static std::string s_classPath;
 
 	JavaEnvironmentFactory(JavaVM* jvm);
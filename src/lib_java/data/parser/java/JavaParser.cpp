@@ -1,5 +1,7 @@
 #include "JavaParser.h"
 
+#include <algorithm>
+
 #include <jni.h>
 
 #include "ApplicationSettings.h"
@@ -29,7 +31,11 @@ void JavaParser::clearCaches()
 
 JavaParser::JavaParser(
 	std::shared_ptr<ParserClient> client, std::shared_ptr<IndexerStateInfo> indexerStateInfo)
-	: Parser(client), m_indexerStateInfo(indexerStateInfo), m_id(s_nextParserId++), m_currentFileId(0)
+	: Parser(client)
+	, m_indexerStateInfo(indexerStateInfo)
+	, m_id(s_nextParserId++)
+	, m_currentFileId(0)
+	, m_recordDecoder(client)
 {
 	const std::string errorString = utility::prepareJavaEnvironment();
 	if (!errorString.empty())
@@ -49,32 +55,7 @@ JavaParser::JavaParser(
 		methods.push_back({"logWarning", "(ILjava/lang/String;)V", (void*)&JavaParser::LogWarning});
 		methods.push_back({"logError", "(ILjava/lang/String;)V", (void*)&JavaParser::LogError});
 		methods.push_back(
-			{"recordSymbol", "(ILjava/lang/String;III)V", (void*)&JavaParser::RecordSymbol});
-		methods.push_back(
-			{"recordSymbolWithLocation",
-			 "(ILjava/lang/String;IIIIIII)V",
-			 (void*)&JavaParser::RecordSymbolWithLocation});
-		methods.push_back(
-			{"recordSymbolWithLocationAndScope",
-			 "(ILjava/lang/String;IIIIIIIIIII)V",
-			 (void*)&JavaParser::RecordSymbolWithLocationAndScope});
-		methods.push_back(
-			{"recordSymbolWithLocationAndScopeAndSignature",
-			 "(ILjava/lang/String;IIIIIIIIIIIIIII)V",
-			 (void*)&JavaParser::RecordSymbolWithLocationAndScopeAndSignature});
-		methods.push_back(
-			{"recordReference",
-			 "(IILjava/lang/String;Ljava/lang/String;IIII)V",
-			 (void*)&JavaParser::RecordReference});
-		methods.push_back(
-			{"recordQualifierLocation",
-			 "(ILjava/lang/String;IIII)V",
-			 (void*)&JavaParser::RecordQualifierLocation});
-		methods.push_back(
-			{"recordLocalSymbol", "(ILjava/lang/String;IIII)V", (void*)&JavaParser::RecordLocalSymbol});
-		methods.push_back({"recordComment", "(IIIII)V", (void*)&JavaParser::RecordComment});
-		methods.push_back(
-			{"recordError", "(ILjava/lang/String;IIIIII)V", (void*)&JavaParser::RecordError});
+			{"flushRecords", "(ILjava/nio/ByteBuffer;I)V", (void*)&JavaParser::FlushRecords});
 
 		m_javaEnvironment->registerNativeMethods("com/sourcetrail/JavaIndexer", methods);
 	}
@@ -86,22 +67,64 @@ JavaParser::JavaParser(
 
 JavaParser::~JavaParser()
 {
+	std::lock_guard<std::mutex> lock(s_parsersMutex);
 	s_parsers.erase(m_id);
 }
 
-void JavaParser::buildIndex(std::shared_ptr<IndexerCommandJava> indexerCommand)
+void JavaParser::buildIndex(
+	const std::vector<JavaParser*>& parsers,
+	const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands)
 {
-	std::string classPath = "";
-	for (const FilePath& path: indexerCommand->getClassPath())
+	if (parsers.empty() || parsers.size() != indexerCommands.size() ||
+		!parsers.front()->m_javaEnvironment)
 	{
-		// the separator used here should be the same as the one used in JavaIndexer.java
-		classPath += path.str() + ";";
+		return;
+	}
+
+	std::vector<int> parserIds;
+	std::vector<std::string> filePaths;
+	std::vector<std::string> fileContents;
+	for (size_t i = 0; i < parsers.size(); i++)
+	{
+		const FilePath& sourceFilePath = indexerCommands[i]->getSourceFilePath();
+
+		parserIds.push_back(parsers[i]->m_id);
+		filePaths.push_back(sourceFilePath.str());
+		fileContents.push_back(
+			parsers[i]->startFile(sourceFilePath, TextAccess::createFromFile(sourceFilePath)));
+	}
+
+	const long long garbageCollectionStartMs = parsers.front()->getGarbageCollectionTimeMs();
+
+	parsers.front()->m_javaEnvironment->callStaticVoidMethod(
+		"com/sourcetrail/JavaIndexer",
+		"processFiles",
+		parserIds,
+		filePaths,
+		fileContents,
+		utility::encodeToUtf8(indexerCommands.front()->getLanguageStandard()),
+		getClassPathString(indexerCommands.front()),
+		getVerbose());
+
+	// the files of a batch are parsed together, so each of them gets an equal share of the time
+	const size_t garbageCollectionMs = size_t(std::max(
+		0LL, parsers.front()->getGarbageCollectionTimeMs() - garbageCollectionStartMs));
+	for (JavaParser* parser: parsers)
+	{
+		parser->m_recordDecoder.flush();
+		parser->m_client->recordGarbageCollectionDuration(garbageCollectionMs / parsers.size());
 	}
 
+	parsers.front()->m_javaEnvironment->callStaticVoidMethod(
+		"com/sourcetrail/JavaIndexer", "clearCaches");
+}
+
+void JavaParser::buildIndex(std::shared_ptr<IndexerCommandJava> indexerCommand)
+{
 	buildIndex(
 		indexerCommand->getSourceFilePath(),
 		indexerCommand->getLanguageStandard(),
-		classPath,
+		getClassPathString(indexerCommand),
 		TextAccess::createFromFile(indexerCommand->getSourceFilePath()));
 }
 
@@ -118,17 +141,8 @@ void JavaParser::buildIndex(
 {
 	if (m_javaEnvironment)
 	{
-		m_currentFilePath = sourceFilePath;
-		m_currentFileId = m_client->recordFile(sourceFilePath, true);
-		m_client->recordFileLanguage(m_currentFileId, L"java");
-
-		// remove tabs because they screw with javaparser's location resolver
-		std::string fileContent = utility::replace(textAccess->getText(), "\t", " ");
-
-		int verbose = ApplicationSettings::getInstance()->getLoggingEnabled() &&
-				ApplicationSettings::getInstance()->getVerboseIndexerLoggingEnabled()
-			? 1
-			: 0;
+		const std::string fileContent = startFile(sourceFilePath, textAccess);
+		const long long garbageCollectionStartMs = getGarbageCollectionTimeMs();
 
 		m_javaEnvironment->callStaticVoidMethod(
 			"com/sourcetrail/JavaIndexer",
@@ -138,206 +152,121 @@ void JavaParser::buildIndex(
 			fileContent,
 			utility::encodeToUtf8(languageStandard),
 			classPath,
-			verbose);
-	}
-}
-
-int JavaParser::s_nextParserId = 0;
-
-std::map<int, JavaParser*> JavaParser::s_parsers;
-
-std::mutex JavaParser::s_parsersMutex;
+			getVerbose());
 
+		m_recordDecoder.flush();
+		m_client->recordGarbageCollectionDuration(
+			size_t(std::max(0LL, getGarbageCollectionTimeMs() - garbageCollectionStartMs)));
 
-// definition of native methods
-
-bool JavaParser::doGetInterrupted()
-{
-	return m_indexerStateInfo->indexingInterrupted;
+		m_javaEnvironment->callStaticVoidMethod("com/sourcetrail/JavaIndexer", "clearCaches");
+	}
 }
 
-void JavaParser::doLogInfo(jstring jInfo)
+std::string JavaParser::getClassPathString(std::shared_ptr<IndexerCommandJava> indexerCommand)
 {
-	LOG_INFO_STREAM_BARE(<< "Indexer - " << m_javaEnvironment->toStdString(jInfo));
+	std::string classPath = "";
+	for (const FilePath& path: indexerCommand->getClassPath())
+	{
+		// the separator used here should be the same as the one used in JavaIndexer.java
+		classPath += path.str() + ";";
+	}
+	return classPath;
 }
 
-void JavaParser::doLogWarning(jstring jWarning)
+long long JavaParser::getGarbageCollectionTimeMs() const
 {
-	LOG_WARNING_STREAM_BARE(<< "Indexer - " << m_javaEnvironment->toStdString(jWarning));
+	long long timeMs = 0;
+	m_javaEnvironment->callStaticLongMethod(
+		"com/sourcetrail/JavaIndexer", "getGarbageCollectionTime", timeMs);
+	return timeMs;
 }
 
-void JavaParser::doLogError(jstring jError)
+int JavaParser::getVerbose()
 {
-	LOG_ERROR_STREAM_BARE(<< "Indexer - " << m_javaEnvironment->toStdString(jError));
+	return ApplicationSettings::getInstance()->getLoggingEnabled() &&
+			ApplicationSettings::getInstance()->getVerboseIndexerLoggingEnabled()
+		? 1
+		: 0;
 }
 
-void JavaParser::doRecordSymbol(jstring jSymbolName, jint jSymbolKind, jint jAccess, jint jDefinitionKind)
+std::string JavaParser::startFile(
+	const FilePath& sourceFilePath, std::shared_ptr<TextAccess> textAccess)
 {
-	Id symbolId = getOrCreateSymbolId(jSymbolName);
-	m_client->recordSymbolKind(symbolId, intToSymbolKind(jSymbolKind));
-	m_client->recordAccessKind(symbolId, intToAccessKind(jAccess));
-	m_client->recordDefinitionKind(symbolId, intToDefinitionKind(jDefinitionKind));
-}
+	m_currentFilePath = sourceFilePath;
+	m_currentFileId = m_client->recordFile(sourceFilePath, true);
+	m_client->recordFileLanguage(m_currentFileId, L"java");
 
-void JavaParser::doRecordSymbolWithLocation(
-	jstring jSymbolName,
-	jint jSymbolKind,
-	jint beginLine,
-	jint beginColumn,
-	jint endLine,
-	jint endColumn,
-	jint jAccess,
-	jint jDefinitionKind)
-{
-	Id symbolId = getOrCreateSymbolId(jSymbolName);
-	m_client->recordSymbolKind(symbolId, intToSymbolKind(jSymbolKind));
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn),
-		ParseLocationType::TOKEN);
-	m_client->recordAccessKind(symbolId, intToAccessKind(jAccess));
-	m_client->recordDefinitionKind(symbolId, intToDefinitionKind(jDefinitionKind));
-}
+	m_recordDecoder.startFile(m_currentFileId);
 
-void JavaParser::doRecordSymbolWithLocationAndScope(
-	jstring jSymbolName,
-	jint jSymbolKind,
-	jint beginLine,
-	jint beginColumn,
-	jint endLine,
-	jint endColumn,
-	jint scopeBeginLine,
-	jint scopeBeginColumn,
-	jint scopeEndLine,
-	jint scopeEndColumn,
-	jint jAccess,
-	jint jDefinitionKind)
-{
-	Id symbolId = getOrCreateSymbolId(jSymbolName);
-	m_client->recordSymbolKind(symbolId, intToSymbolKind(jSymbolKind));
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn),
-		ParseLocationType::TOKEN);
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(m_currentFileId, scopeBeginLine, scopeBeginColumn, scopeEndLine, scopeEndColumn),
-		ParseLocationType::SCOPE);
-	m_client->recordAccessKind(symbolId, intToAccessKind(jAccess));
-	m_client->recordDefinitionKind(symbolId, intToDefinitionKind(jDefinitionKind));
+	// remove tabs because they screw with javaparser's location resolver
+	return utility::replace(textAccess->getText(), "\t", " ");
 }
 
-void JavaParser::doRecordSymbolWithLocationAndScopeAndSignature(
-	jstring jSymbolName,
-	jint jSymbolKind,
-	jint beginLine,
-	jint beginColumn,
-	jint endLine,
-	jint endColumn,
-	jint scopeBeginLine,
-	jint scopeBeginColumn,
-	jint scopeEndLine,
-	jint scopeEndColumn,
-	jint signatureBeginLine,
-	jint signatureBeginColumn,
-	jint signatureEndLine,
-	jint signatureEndColumn,
-	jint jAccess,
-	jint jDefinitionKind)
-{
-	Id symbolId = getOrCreateSymbolId(jSymbolName);
-	m_client->recordSymbolKind(symbolId, intToSymbolKind(jSymbolKind));
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn),
-		ParseLocationType::TOKEN);
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(m_currentFileId, scopeBeginLine, scopeBeginColumn, scopeEndLine, scopeEndColumn),
-		ParseLocationType::SCOPE);
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(
-			m_currentFileId, signatureBeginLine, signatureBeginColumn, signatureEndLine, signatureEndColumn),
-		ParseLocationType::SIGNATURE);
-	m_client->recordAccessKind(symbolId, intToAccessKind(jAccess));
-	m_client->recordDefinitionKind(symbolId, intToDefinitionKind(jDefinitionKind));
-}
+std::atomic<int> JavaParser::s_nextParserId(0);
+
+std::map<int, JavaParser*> JavaParser::s_parsers;
+
+std::mutex JavaParser::s_parsersMutex;
+
 
-void JavaParser::doRecordReference(
-	jint jReferenceKind,
-	jstring jReferencedName,
-	jstring jContextName,
-	jint beginLine,
-	jint beginColumn,
-	jint endLine,
-	jint endColumn)
+// definition of native methods
+
+JavaParser* JavaParser::getParser(jint parserId)
 {
-	m_client->recordReference(
-		intToReferenceKind(jReferenceKind),
-		getOrCreateSymbolId(jReferencedName),
-		getOrCreateSymbolId(jContextName),
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn));
+	std::lock_guard<std::mutex> lock(s_parsersMutex);
+	std::map<int, JavaParser*>::iterator it = s_parsers.find(int(parserId));
+	if (it == s_parsers.end())
+	{
+		LOG_ERROR("parser with id " + std::to_string(parserId) + " not found");
+		return nullptr;
+	}
+	return it->second;
 }
 
-void JavaParser::doRecordQualifierLocation(
-	jstring jQualifierName, jint beginLine, jint beginColumn, jint endLine, jint endColumn)
+bool JavaParser::doGetInterrupted()
 {
-	Id symbolId = getOrCreateSymbolId(jQualifierName);
-	m_client->recordLocation(
-		symbolId,
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn),
-		ParseLocationType::QUALIFIER);
+	return m_indexerStateInfo->indexingInterrupted;
 }
 
-void JavaParser::doRecordLocalSymbol(
-	jstring jSymbolName, jint beginLine, jint beginColumn, jint endLine, jint endColumn)
+void JavaParser::doLogInfo(jstring jInfo)
 {
-	m_client->recordLocalSymbol(
-		NameHierarchy::deserialize(
-			utility::decodeFromUtf8(m_javaEnvironment->toStdString(jSymbolName)))
-			.getQualifiedName(),
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn));
+	LOG_INFO_STREAM_BARE(<< "Indexer - " << m_javaEnvironment->toStdString(jInfo));
 }
 
-void JavaParser::doRecordComment(jint beginLine, jint beginColumn, jint endLine, jint endColumn)
+void JavaParser::doLogWarning(jstring jWarning)
 {
-	m_client->recordComment(
-		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn));
+	LOG_WARNING_STREAM_BARE(<< "Indexer - " << m_javaEnvironment->toStdString(jWarning));
 }
 
-void JavaParser::doRecordError(
-	jstring jMessage,
-	jint jFatal,
-	jint jIndexed,
-	jint beginLine,
-	jint beginColumn,
-	jint endLine,
-	jint endColumn)
+void JavaParser::doLogError(jstring jError)
 {
-	bool fatal = jFatal;
-	bool indexed = jIndexed;
-
-	m_client->recordError(
-		utility::decodeFromUtf8(m_javaEnvironment->toStdString(jMessage)),
-		fatal,
-		indexed,
-		FilePath(),
-		ParseLocation(m_currentFileId, beginLine, beginColumn));
+	LOG_ERROR_STREAM_BARE(<< "Indexer - " << m_javaEnvironment->toStdString(jError));
 }
 
-Id JavaParser::getOrCreateSymbolId(jstring jSymbolName)
+void JavaParser::FlushRecords(
+	JNIEnv* env, jobject objectOrClass, jint parserId, jobject buffer, jint size)
 {
-	std::string name = m_javaEnvironment->toStdString(jSymbolName);
+	JavaParser* parser = getParser(parserId);
+	if (!parser)
+	{
+		return;
+	}
 
-	auto it = m_symbolNameToIdMap.find(name);
-	if (it != m_symbolNameToIdMap.end())
+	const char* address = static_cast<const char*>(env->GetDirectBufferAddress(buffer));
+	if (!address)
 	{
-		return it->second;
+		LOG_ERROR("records of parser with id " + std::to_string(parserId) + " are not accessible");
+		return;
 	}
 
-	Id symbolId = m_client->recordSymbol(NameHierarchy::deserialize(utility::decodeFromUtf8(name)));
+	parser->doFlushRecords(address, size_t(size));
+}
 
-	m_symbolNameToIdMap.emplace(name, symbolId);
-	return symbolId;
+void JavaParser::doFlushRecords(const char* buffer, size_t size)
+{
+	// the java indexer never splits a record between two flushes
+	if (m_recordDecoder.decode(buffer, size) != size)
+	{
+		LOG_ERROR("received truncated records for file " + m_currentFilePath.str());
+	}
 }
@@ -1,15 +1,18 @@
 #ifndef JAVA_PARSER_H
 #define JAVA_PARSER_H
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "FilePath.h"
 #include "IndexerCommandJava.h"
 #include "IndexerStateInfo.h"
 #include "JavaEnvironment.h"
 #include "Parser.h"
+#include "RecordStreamDecoder.h"
 #include "logging.h"
 #include "types.h"
 
@@ -39,10 +42,26 @@ public:
 	JavaParser(std::shared_ptr<ParserClient> client, std::shared_ptr<IndexerStateInfo> indexerStateInfo);
 	~JavaParser();
 
+	// indexes the files of all commands with a single JDT run, the parser at each index records the
+	// file of the command at the same index. All commands need to share language standard and class
+	// path.
+	static void buildIndex(
+		const std::vector<JavaParser*>& parsers,
+		const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands);
+
 	void buildIndex(std::shared_ptr<IndexerCommandJava> indexerCommand);
 	void buildIndex(const FilePath& filePath, std::shared_ptr<TextAccess> textAccess);
 
 private:
+	static std::string getClassPathString(std::shared_ptr<IndexerCommandJava> indexerCommand);
+	static int getVerbose();
+
+	// accumulated garbage collection time of the JVM
+	long long getGarbageCollectionTimeMs() const;
+
+	// records the file and returns its content prepared for the java indexer
+	std::string startFile(const FilePath& sourceFilePath, std::shared_ptr<TextAccess> textAccess);
+
 	void buildIndex(
 		const FilePath& sourceFilePath,
 		const std::wstring& languageStandard,
@@ -177,76 +196,32 @@ private:
 #define DEF_RELAYING_METHOD(NAME, PARAMETERS, ARGUMENTS)                                           \
 	static void NAME(JNIEnv* env, jobject objectOrClass, jint parserId PARAMETERS)                 \
 	{                                                                                              \
-		std::map<int, JavaParser*>::iterator it = s_parsers.find(int(parserId));                   \
-		if (it != s_parsers.end())                                                                 \
-		{                                                                                          \
-			it->second->do##NAME(ARGUMENTS);                                                       \
-		}                                                                                          \
-		else                                                                                       \
+		if (JavaParser* parser = getParser(parserId))                                              \
 		{                                                                                          \
-			LOG_ERROR("parser with id " + std::to_string(parserId) + " not found");                \
+			parser->do##NAME(ARGUMENTS);                                                           \
 		}                                                                                          \
 	}
 
 	DEF_RELAYING_METHOD_1(LogInfo, jstring)
 	DEF_RELAYING_METHOD_1(LogWarning, jstring)
 	DEF_RELAYING_METHOD_1(LogError, jstring)
-	DEF_RELAYING_METHOD_4(RecordSymbol, jstring, jint, jint, jint)
-	DEF_RELAYING_METHOD_8(RecordSymbolWithLocation, jstring, jint, jint, jint, jint, jint, jint, jint)
-	DEF_RELAYING_METHOD_12(
-		RecordSymbolWithLocationAndScope,
-		jstring,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint)
-	DEF_RELAYING_METHOD_16(
-		RecordSymbolWithLocationAndScopeAndSignature,
-		jstring,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint,
-		jint)
-	DEF_RELAYING_METHOD_7(RecordReference, jint, jstring, jstring, jint, jint, jint, jint)
-	DEF_RELAYING_METHOD_5(RecordQualifierLocation, jstring, jint, jint, jint, jint)
-	DEF_RELAYING_METHOD_5(RecordLocalSymbol, jstring, jint, jint, jint, jint)
-	DEF_RELAYING_METHOD_4(RecordComment, jint, jint, jint, jint)
-	DEF_RELAYING_METHOD_7(RecordError, jstring, jint, jint, jint, jint, jint, jint)
+
+	static void FlushRecords(
+		JNIEnv* env, jobject objectOrClass, jint parserId, jobject buffer, jint size);
 
 	static bool GetInterrupted(JNIEnv* env, jobject objectOrClass, jint parserId)
 	{
-		std::map<int, JavaParser*>::iterator it = s_parsers.find(int(parserId));
-		if (it != s_parsers.end())
-		{
-			return it->second->doGetInterrupted();
-		}
-		else
+		if (JavaParser* parser = getParser(parserId))
 		{
-			LOG_ERROR("parser with id " + std::to_string(parserId) + " not found");
+			return parser->doGetInterrupted();
 		}
-
 		return false;
 	}
 
-	static int s_nextParserId;
+	// parsers of several threads call back into the native code concurrently
+	static JavaParser* getParser(jint parserId);
+
+	static std::atomic<int> s_nextParserId;
 	static std::map<int, JavaParser*> s_parsers;
 	static std::mutex s_parsersMutex;
 
@@ -259,73 +234,8 @@ private:
 
 	void doLogError(jstring jError);
 
-	void doRecordSymbol(jstring jSymbolName, jint jSymbolKind, jint jAccess, jint jDefinitionKind);
-
-	void doRecordSymbolWithLocation(
-		jstring jSymbolName,
-		jint jSymbolKind,
-		jint beginLine,
-		jint beginColumn,
-		jint endLine,
-		jint endColumn,
-		jint jAccess,
-		jint jDefinitionKind);
-
-	void doRecordSymbolWithLocationAndScope(
-		jstring jSymbolName,
-		jint jSymbolKind,
-		jint beginLine,
-		jint beginColumn,
-		jint endLine,
-		jint endColumn,
-		jint scopeBeginLine,
-		jint scopeBeginColumn,
-		jint scopeEndLine,
-		jint scopeEndColumn,
-		jint jAccess,
-		jint jDefinitionKind);
-
-	void doRecordSymbolWithLocationAndScopeAndSignature(
-		jstring jSymbolName,
-		jint jSymbolKind,
-		jint beginLine,
-		jint beginColumn,
-		jint endLine,
-		jint endColumn,
-		jint scopeBeginLine,
-		jint scopeBeginColumn,
-		jint scopeEndLine,
-		jint scopeEndColumn,
-		jint signatureBeginLine,
-		jint signatureBeginColumn,
-		jint signatureEndLine,
-		jint signatureEndColumn,
-		jint jAccess,
-		jint jDefinitionKind);
-
-	void doRecordReference(
-		jint jReferenceKind,
-		jstring jReferencedName,
-		jstring jContextName,
-		jint beginLine,
-		jint beginColumn,
-		jint endLine,
-		jint endColumn);
-	void doRecordQualifierLocation(
-		jstring jQualifierName, jint beginLine, jint beginColumn, jint endLine, jint endColumn);
-	void doRecordLocalSymbol(
-		jstring jSymbolName, jint beginLine, jint beginColumn, jint endLine, jint endColumn);
-	void doRecordComment(jint beginLine, jint beginColumn, jint endLine, jint endColumn);
-	void doRecordError(
-		jstring jMessage,
-		jint jFatal,
-		jint jIndexed,
-		jint beginLine,
-		jint beginColumn,
-		jint endLine,
-		jint endColumn);
-
-	Id getOrCreateSymbolId(jstring jSymbolName);
+	// decodes the records serialized by RecordChannel.java
+	void doFlushRecords(const char* buffer, size_t size);
 
 	std::shared_ptr<JavaEnvironment> m_javaEnvironment;
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
@@ -334,7 +244,7 @@ private:
 	FilePath m_currentFilePath;
 	Id m_currentFileId;
 
-	std::map<std::string, Id> m_symbolNameToIdMap;
+	RecordStreamDecoder m_recordDecoder;
 };
 
 #endif	  // JAVA_PARSER_H
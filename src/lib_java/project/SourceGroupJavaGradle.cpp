@@ -3,6 +3,7 @@
 #include "Application.h"
 #include "DialogView.h"
 #include "FileSystem.h"
+#include "JavaBuildResolutionCache.h"
 #include "ScopedFunctor.h"
 #include "SourceGroupSettingsJavaGradle.h"
 #include "logging.h"
@@ -73,6 +74,14 @@ bool SourceGroupJavaGradle::prepareGradleData()
 		const FilePath projectRootPath =
 			m_settings->getGradleProjectFilePathExpandedAndAbsolute().getParentDirectory();
 
+		JavaBuildResolutionCache cache(
+			m_settings->getGradleDependenciesDirectoryPath(), getBuildHash());
+		if (cache.getDependenciesResolved())
+		{
+			LOG_INFO("Gradle build files did not change, skipping dependency resolution.");
+			return true;
+		}
+
 		std::shared_ptr<DialogView> dialogView = Application::getInstance()->getDialogView(
 			DialogView::UseCase::PROJECT_SETUP);
 
@@ -86,6 +95,11 @@ bool SourceGroupJavaGradle::prepareGradleData()
 			m_settings->getGradleDependenciesDirectoryPath(),
 			m_settings->getShouldIndexGradleTests());
 
+		if (success)
+		{
+			cache.setDependenciesResolved();
+		}
+
 		return success;
 	}
 
@@ -97,6 +111,13 @@ std::vector<FilePath> SourceGroupJavaGradle::doGetAllSourcePaths() const
 	std::vector<FilePath> sourcePaths;
 	if (m_settings->getGradleProjectFilePathExpandedAndAbsolute().exists())
 	{
+		JavaBuildResolutionCache cache(
+			m_settings->getGradleDependenciesDirectoryPath(), getBuildHash());
+		if (cache.getSourceDirectories(sourcePaths))
+		{
+			return sourcePaths;
+		}
+
 		std::shared_ptr<DialogView> dialogView = Application::getInstance()->getDialogView(
 			DialogView::UseCase::PROJECT_SETUP);
 		dialogView->showUnknownProgressDialog(
@@ -107,6 +128,11 @@ std::vector<FilePath> SourceGroupJavaGradle::doGetAllSourcePaths() const
 		sourcePaths = utility::gradleGetAllSourceDirectories(
 			projectRootPath, m_settings->getShouldIndexGradleTests());
 
+		if (!sourcePaths.empty())
+		{
+			cache.setSourceDirectories(sourcePaths);
+		}
+
 		dialogView->hideUnknownProgressDialog();
 	}
 	else
@@ -115,3 +141,10 @@ std::vector<FilePath> SourceGroupJavaGradle::doGetAllSourcePaths() const
 	}
 	return sourcePaths;
 }
+
+std::string SourceGroupJavaGradle::getBuildHash() const
+{
+	return JavaBuildResolutionCache::getBuildHash(
+		m_settings->getGradleProjectFilePathExpandedAndAbsolute().getParentDirectory(),
+		m_settings->getShouldIndexGradleTests() ? "1" : "0");
+}
@@ -2,6 +2,7 @@
 #define SOURCE_GROUP_JAVA_GRADLE_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "SingleValueCache.h"
@@ -23,6 +24,9 @@ private:
 	bool prepareGradleData();
 	std::vector<FilePath> doGetAllSourcePaths() const;
 
+	// changes whenever a build file or a setting that affects the resolved paths changes
+	std::string getBuildHash() const;
+
 	std::shared_ptr<SourceGroupSettingsJavaGradle> m_settings;
 	mutable SingleValueCache<std::vector<FilePath>> m_allSourcePathsCache;
 };
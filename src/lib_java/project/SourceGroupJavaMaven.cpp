@@ -4,9 +4,11 @@
 #include "ApplicationSettings.h"
 #include "DialogView.h"
 #include "FileSystem.h"
+#include "JavaBuildResolutionCache.h"
 #include "MessageStatus.h"
 #include "ScopedFunctor.h"
 #include "SourceGroupSettingsJavaMaven.h"
+#include "TextAccess.h"
 #include "logging.h"
 #include "utility.h"
 #include "utilityJava.h"
@@ -77,6 +79,14 @@ bool SourceGroupJavaMaven::prepareMavenData()
 		const FilePath projectRootPath =
 			m_settings->getMavenProjectFilePathExpandedAndAbsolute().getParentDirectory();
 
+		JavaBuildResolutionCache cache(
+			m_settings->getMavenDependenciesDirectoryPath(), getBuildHash());
+		if (cache.getDependenciesResolved())
+		{
+			LOG_INFO("Maven build files did not change, skipping dependency resolution.");
+			return true;
+		}
+
 		std::shared_ptr<DialogView> dialogView = Application::getInstance()->getDialogView(
 			DialogView::UseCase::PROJECT_SETUP);
 		dialogView->showUnknownProgressDialog(
@@ -102,6 +112,11 @@ bool SourceGroupJavaMaven::prepareMavenData()
 			projectRootPath,
 			m_settings->getMavenDependenciesDirectoryPath());
 
+		if (success)
+		{
+			cache.setDependenciesResolved();
+		}
+
 		return success;
 	}
 
@@ -113,6 +128,13 @@ std::vector<FilePath> SourceGroupJavaMaven::doGetAllSourcePaths() const
 	std::vector<FilePath> sourcePaths;
 	if (m_settings && m_settings->getMavenProjectFilePathExpandedAndAbsolute().exists())
 	{
+		JavaBuildResolutionCache cache(
+			m_settings->getMavenDependenciesDirectoryPath(), getBuildHash());
+		if (cache.getSourceDirectories(sourcePaths))
+		{
+			return sourcePaths;
+		}
+
 		std::shared_ptr<DialogView> dialogView = Application::getInstance()->getDialogView(
 			DialogView::UseCase::PROJECT_SETUP);
 		dialogView->showUnknownProgressDialog(
@@ -130,7 +152,27 @@ std::vector<FilePath> SourceGroupJavaMaven::doGetAllSourcePaths() const
 			m_settings->getMavenDependenciesDirectoryPath(),
 			m_settings->getShouldIndexMavenTests());
 
+		if (!sourcePaths.empty())
+		{
+			cache.setSourceDirectories(sourcePaths);
+		}
+
 		dialogView->hideUnknownProgressDialog();
 	}
 	return sourcePaths;
 }
+
+std::string SourceGroupJavaMaven::getBuildHash() const
+{
+	const FilePath mavenSettingsPath = m_settings->getMavenSettingsFilePathExpandedAndAbsolute();
+
+	std::string settings = ApplicationSettings::getInstance()->getMavenPath().str() + "\n" +
+		mavenSettingsPath.str() + "\n" + (m_settings->getShouldIndexMavenTests() ? "1" : "0");
+	if (!mavenSettingsPath.empty() && mavenSettingsPath.exists())
+	{
+		settings += "\n" + TextAccess::createFromFile(mavenSettingsPath)->getText();
+	}
+
+	return JavaBuildResolutionCache::getBuildHash(
+		m_settings->getMavenProjectFilePathExpandedAndAbsolute().getParentDirectory(), settings);
+}
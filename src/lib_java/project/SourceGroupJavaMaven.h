@@ -2,6 +2,7 @@
 #define SOURCE_GROUP_JAVA_MAVEN_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "SingleValueCache.h"
@@ -23,6 +24,9 @@ private:
 	bool prepareMavenData();
 	std::vector<FilePath> doGetAllSourcePaths() const;
 
+	// changes whenever a build file or a setting that affects the resolved paths changes
+	std::string getBuildHash() const;
+
 	std::shared_ptr<SourceGroupSettingsJavaMaven> m_settings;
 	mutable SingleValueCache<std::vector<FilePath>> m_allSourcePathsCache;
 };
@@ -0,0 +1,143 @@
+#include "JavaBuildResolutionCache.h"
+
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "ConfigManager.h"
+#include "FileSystem.h"
+#include "TextAccess.h"
+#include "TextLayoutMapping.h"
+#include "logging.h"
+
+namespace
+{
+const std::wstring cacheFileName = L"build_resolution_cache.xml";
+
+bool isBuildFileName(const std::wstring& fileName)
+{
+	return fileName == L"pom.xml" || fileName == L"build.gradle" ||
+		fileName == L"build.gradle.kts" || fileName == L"settings.gradle" ||
+		fileName == L"settings.gradle.kts" || fileName == L"gradle.properties";
+}
+
+// output and tool directories that never contain build files of the project itself
+bool isSkippedDirectoryName(const std::wstring& directoryName)
+{
+	return directoryName == L"target" || directoryName == L"build" ||
+		directoryName == L"node_modules" || (!directoryName.empty() && directoryName[0] == L'.');
+}
+
+std::vector<FilePath> getBuildFilePaths(const FilePath& projectRootPath)
+{
+	std::vector<FilePath> buildFilePaths;
+	if (!projectRootPath.isDirectory())
+	{
+		return buildFilePaths;
+	}
+
+	boost::system::error_code ec;
+	boost::filesystem::recursive_directory_iterator it(projectRootPath.getPath(), ec);
+	boost::filesystem::recursive_directory_iterator endit;
+	while (!ec && it != endit)
+	{
+		const std::wstring fileName = it->path().filename().wstring();
+		if (boost::filesystem::is_directory(it->status()))
+		{
+			if (isSkippedDirectoryName(fileName))
+			{
+				it.no_push();
+			}
+		}
+		else if (isBuildFileName(fileName))
+		{
+			buildFilePaths.push_back(FilePath(it->path().generic_wstring()));
+		}
+		it.increment(ec);
+	}
+
+	// the iteration order of the file system must not change the hash
+	std::sort(buildFilePaths.begin(), buildFilePaths.end());
+	return buildFilePaths;
+}
+}	 // namespace
+
+std::string JavaBuildResolutionCache::getBuildHash(
+	const FilePath& projectRootPath, const std::string& settings)
+{
+	std::string content = settings;
+	for (const FilePath& buildFilePath: getBuildFilePaths(projectRootPath))
+	{
+		content += "\n" + buildFilePath.str() + "\n" +
+			TextAccess::createFromFile(buildFilePath)->getText();
+	}
+	return TextLayoutMapping::getContentHash(content);
+}
+
+JavaBuildResolutionCache::JavaBuildResolutionCache(
+	const FilePath& dependenciesDirectoryPath, const std::string& buildHash)
+	: m_cacheFilePath(dependenciesDirectoryPath.getConcatenated(cacheFileName))
+	, m_buildHash(buildHash)
+{
+	if (m_cacheFilePath.exists())
+	{
+		m_config = ConfigManager::createAndLoad(TextAccess::createFromFile(m_cacheFilePath));
+		m_config->setWarnOnEmptyKey(false);
+	}
+
+	if (!m_config || m_config->getValueOrDefault<std::string>("build_hash", "") != m_buildHash)
+	{
+		m_config = ConfigManager::createEmpty();
+		m_config->setWarnOnEmptyKey(false);
+		m_config->setValue("build_hash", m_buildHash);
+	}
+}
+
+bool JavaBuildResolutionCache::getDependenciesResolved() const
+{
+	return m_config->getValueOrDefault<bool>("dependencies_resolved", false);
+}
+
+void JavaBuildResolutionCache::setDependenciesResolved()
+{
+	m_config->setValue("dependencies_resolved", true);
+	save();
+}
+
+bool JavaBuildResolutionCache::getSourceDirectories(std::vector<FilePath>& sourceDirectories) const
+{
+	if (!m_config->getValueOrDefault<bool>("source_directories_resolved", false))
+	{
+		return false;
+	}
+
+	sourceDirectories = m_config->getValuesOrDefaults<FilePath>(
+		"source_directories/source_directory", {});
+
+	// a clean build removes generated source directories, which need to be resolved again
+	for (const FilePath& sourceDirectory: sourceDirectories)
+	{
+		if (!sourceDirectory.exists())
+		{
+			return false;
+		}
+	}
+
+	LOG_INFO(
+		"Using " + std::to_string(sourceDirectories.size()) +
+		" cached source directories for build hash " + m_buildHash);
+	return true;
+}
+
+void JavaBuildResolutionCache::setSourceDirectories(const std::vector<FilePath>& sourceDirectories)
+{
+	m_config->setValue("source_directories_resolved", true);
+	m_config->setValues("source_directories/source_directory", sourceDirectories);
+	save();
+}
+
+void JavaBuildResolutionCache::save()
+{
+	FileSystem::createDirectory(m_cacheFilePath.getParentDirectory());
+	m_config->save(m_cacheFilePath.str());
+}
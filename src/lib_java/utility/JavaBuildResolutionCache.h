@@ -0,0 +1,40 @@
+#ifndef JAVA_BUILD_RESOLUTION_CACHE_H
+#define JAVA_BUILD_RESOLUTION_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+
+class ConfigManager;
+
+// Remembers what resolving a Maven or Gradle project produced, so a refresh can skip running the
+// build tool as long as no build file and no relevant setting changed. The cache is stored in the
+// dependencies directory of the source group and is dropped whenever the build hash differs.
+class JavaBuildResolutionCache
+{
+public:
+	// hash of the contents of all pom.xml and gradle build files below the project root, combined
+	// with the passed settings of the source group
+	static std::string getBuildHash(const FilePath& projectRootPath, const std::string& settings);
+
+	JavaBuildResolutionCache(
+		const FilePath& dependenciesDirectoryPath, const std::string& buildHash);
+
+	bool getDependenciesResolved() const;
+	void setDependenciesResolved();
+
+	// returns false if the source directories were not resolved for the current build hash
+	bool getSourceDirectories(std::vector<FilePath>& sourceDirectories) const;
+	void setSourceDirectories(const std::vector<FilePath>& sourceDirectories);
+
+private:
+	void save();
+
+	const FilePath m_cacheFilePath;
+	const std::string m_buildHash;
+	std::shared_ptr<ConfigManager> m_config;
+};
+
+#endif	  // JAVA_BUILD_RESOLUTION_CACHE_H
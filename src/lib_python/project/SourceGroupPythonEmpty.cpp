@@ -52,7 +52,14 @@ std::vector<std::shared_ptr<IndexerCommand>> SourceGroupPythonEmpty::getIndexerC
 	std::wstring args = L"";
 
 	args += L" --source-file-path=%{SOURCE_FILE_PATH}";
-	args += L" --database-file-path=%{DATABASE_FILE_PATH}";
+	if (ApplicationSettings::getInstance()->getPythonRecordStreamingEnabled())
+	{
+		args += L" --record-stream";
+	}
+	else
+	{
+		args += L" --database-file-path=%{DATABASE_FILE_PATH}";
+	}
 
 	if (!m_settings->getEnvironmentPath().empty())
 	{
@@ -2,9 +2,12 @@
 
 #include <QTextCodec>
 
+#include "utilityString.h"
+
 TextCodec::TextCodec(const std::string& name): m_name(name)
 {
 	m_codec = QTextCodec::codecForName(m_name.c_str());
+	m_isUtf8 = (m_codec && m_codec->mibEnum() == 106);	  // the IANA number of UTF-8
 	m_decoder = std::make_shared<QTextDecoder>(m_codec);
 	m_encoder = std::make_shared<QTextEncoder>(m_codec);
 }
@@ -25,6 +28,12 @@ bool TextCodec::isValid() const
 
 std::wstring TextCodec::decode(const std::string& unicodeString) const
 {
+	// most lines of code are ascii, which is converted the same way without going through Qt
+	if (m_isUtf8 && utility::isAscii(unicodeString))
+	{
+		return std::wstring(unicodeString.begin(), unicodeString.end());
+	}
+
 	if (m_decoder)
 	{
 		return m_decoder->toUnicode(unicodeString.c_str()).toStdWString();
@@ -34,6 +43,11 @@ std::wstring TextCodec::decode(const std::string& unicodeString) const
 
 std::string TextCodec::encode(const std::wstring& string) const
 {
+	if (m_isUtf8)
+	{
+		return utility::encodeToUtf8(string);
+	}
+
 	if (m_encoder)
 	{
 		return m_encoder->fromUnicode(QString::fromStdWString(string)).toStdString();
@@ -23,6 +23,7 @@ public:
 private:
 	const std::string m_name;
 	QTextCodec* m_codec;
+	bool m_isUtf8;
 	std::shared_ptr<QTextDecoder> m_decoder;
 	std::shared_ptr<QTextEncoder> m_encoder;
 };
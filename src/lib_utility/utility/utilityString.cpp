@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <iterator>
 #include <string>
 
@@ -9,6 +10,40 @@
 
 namespace
 {
+// tests eight bytes at once as long as none of them has the high bit set
+size_t getAsciiPrefixLength(const std::string& s)
+{
+	const char* data = s.data();
+	const size_t size = s.size();
+
+	size_t pos = 0;
+	for (; pos + sizeof(uint64_t) <= size; pos += sizeof(uint64_t))
+	{
+		uint64_t block;
+		std::memcpy(&block, data + pos, sizeof(block));
+		if (block & 0x8080808080808080ull)
+		{
+			break;
+		}
+	}
+
+	while (pos < size && !(static_cast<unsigned char>(data[pos]) & 0x80))
+	{
+		pos++;
+	}
+	return pos;
+}
+
+size_t getAsciiPrefixLength(const std::wstring& s)
+{
+	size_t pos = 0;
+	while (pos < s.size() && !(s[pos] & ~0x7F))
+	{
+		pos++;
+	}
+	return pos;
+}
+
 template <typename StringType>
 StringType doReplace(StringType str, const StringType& from, const StringType& to)
 {
@@ -71,12 +106,46 @@ namespace utility
 {
 std::string encodeToUtf8(const std::wstring& s)
 {
-	return boost::locale::conv::utf_to_utf<char>(s.c_str(), s.c_str() + s.size());
+	// an ascii character never is part of a multi byte sequence, so the rest converts on its own
+	const size_t asciiLength = getAsciiPrefixLength(s);
+
+	std::string result;
+	result.reserve(s.size());
+	for (size_t i = 0; i < asciiLength; i++)
+	{
+		result.push_back(static_cast<char>(s[i]));
+	}
+
+	if (asciiLength < s.size())
+	{
+		result += boost::locale::conv::utf_to_utf<char>(
+			s.c_str() + asciiLength, s.c_str() + s.size());
+	}
+	return result;
 }
 
 std::wstring decodeFromUtf8(const std::string& s)
 {
-	return boost::locale::conv::utf_to_utf<wchar_t>(s.c_str(), s.c_str() + s.size());
+	const size_t asciiLength = getAsciiPrefixLength(s);
+
+	std::wstring result(s.begin(), s.begin() + asciiLength);
+
+	if (asciiLength < s.size())
+	{
+		result += boost::locale::conv::utf_to_utf<wchar_t>(
+			s.c_str() + asciiLength, s.c_str() + s.size());
+	}
+	return result;
+}
+
+bool isAscii(const std::string& s)
+{
+	return getAsciiPrefixLength(s) == s.size();
+}
+
+bool isAscii(const std::wstring& s)
+{
+	return getAsciiPrefixLength(s) == s.size();
 }
 
 std::deque<std::string> split(const std::string& str, char delimiter)
@@ -274,8 +343,29 @@ std::string toLowerCase(const std::string& in)
 
 std::wstring toLowerCase(const std::wstring& in)
 {
-	std::wstring out;
-	std::transform(in.begin(), in.end(), std::back_inserter(out), towlower);
+	std::wstring out(in);
+
+	// both loops are free of branches and calls for pure ASCII text, so they get vectorized
+	uint32_t nonAscii = 0;
+	for (wchar_t c: out)
+	{
+		nonAscii |= static_cast<uint32_t>(c) & ~uint32_t(0x7F);
+	}
+
+	if (nonAscii)
+	{
+		for (wchar_t& c: out)
+		{
+			c = toLowerCase(c);
+		}
+	}
+	else
+	{
+		for (wchar_t& c: out)
+		{
+			c += (c >= L'A' && c <= L'Z') ? (L'a' - L'A') : 0;
+		}
+	}
 	return out;
 }
 
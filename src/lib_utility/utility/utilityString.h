@@ -2,6 +2,8 @@
 #define UTILITY_STRING_H
 
 #include <algorithm>
+#include <cstdint>
+#include <cwctype>
 #include <deque>
 #include <sstream>
 #include <string>
@@ -9,9 +11,13 @@
 
 namespace utility
 {
+// copy the leading ascii characters directly and only convert the rest
 std::string encodeToUtf8(const std::wstring& s);
 std::wstring decodeFromUtf8(const std::string& s);
 
+bool isAscii(const std::string& s);
+bool isAscii(const std::wstring& s);
+
 template <typename ContainerType>
 ContainerType split(const std::string& str, const std::string& delimiter);
 
@@ -64,6 +70,34 @@ std::wstring toUpperCase(const std::wstring& in);
 std::string toLowerCase(const std::string& in);
 std::wstring toLowerCase(const std::wstring& in);
 
+// ASCII characters are converted without a locale lookup, which keeps matching loops cheap
+inline wchar_t toLowerCase(wchar_t c)
+{
+	if (static_cast<uint32_t>(c) < 128)
+	{
+		return (c >= L'A' && c <= L'Z') ? c + (L'a' - L'A') : c;
+	}
+	return std::towlower(c);
+}
+
+inline bool isUpperCase(wchar_t c)
+{
+	if (static_cast<uint32_t>(c) < 128)
+	{
+		return c >= L'A' && c <= L'Z';
+	}
+	return std::iswupper(c);
+}
+
+inline bool isLowerCase(wchar_t c)
+{
+	if (static_cast<uint32_t>(c) < 128)
+	{
+		return c >= L'a' && c <= L'z';
+	}
+	return std::iswlower(c);
+}
+
 template <typename StringType>
 bool equalsCaseInsensitive(const std::string& a, const std::string& b);
 
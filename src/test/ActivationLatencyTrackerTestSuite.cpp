@@ -0,0 +1,73 @@
+#include "catch.hpp"
+
+#include <thread>
+
+#include "ActivationLatencyTracker.h"
+
+namespace
+{
+ActivationLatencyTracker::Activation getActivation(Id activationId)
+{
+	for (const ActivationLatencyTracker::Activation& activation:
+		 ActivationLatencyTracker::getInstance()->getActivations())
+	{
+		if (activation.id == activationId)
+		{
+			return activation;
+		}
+	}
+	return ActivationLatencyTracker::Activation();
+}
+}	 // namespace
+
+TEST_CASE("activation latency spans are recorded for the current activation of the thread")
+{
+	const Id activationId = 1000001;
+	{
+		ActivationLatencySpan controllerSpan(activationId, "controller");
+		REQUIRE(ActivationLatencyTracker::getCurrentActivationId() == activationId);
+		{
+			ActivationLatencySpan storageSpan("storage");
+		}
+
+		const Id capturedId = ActivationLatencyTracker::getCurrentActivationId();
+		std::thread([capturedId]() { ActivationLatencySpan viewSpan(capturedId, "view", true); })
+			.join();
+	}
+	REQUIRE(ActivationLatencyTracker::getCurrentActivationId() == 0);
+
+	{
+		ActivationLatencySpan untrackedSpan("untracked");
+	}
+
+	const ActivationLatencyTracker::Activation activation = getActivation(activationId);
+	REQUIRE(activation.spans.size() == 3);
+	REQUIRE(activation.spans[0].name == "storage");
+	REQUIRE(activation.spans[1].name == "view");
+	REQUIRE(activation.spans[1].isViewUpdate);
+	REQUIRE(activation.spans[2].name == "controller");
+	REQUIRE(activation.startTime == activation.spans[2].startTime);
+}
+
+TEST_CASE("activation latency budget is only checked on view updates")
+{
+	ActivationLatencyTracker* tracker = ActivationLatencyTracker::getInstance();
+	const size_t budgetMs = tracker->getBudgetMs();
+	tracker->setBudgetMs(10);
+
+	const Id activationId = 1000002;
+	tracker->setDescription(activationId, L"Activate \"foo\"");
+	tracker->addSpan(activationId, {"controller", 0, 20000, false});
+	REQUIRE(!getActivation(activationId).exceededBudget);
+
+	tracker->addSpan(activationId, {"view", 20000, 25000, true});
+	const ActivationLatencyTracker::Activation activation = getActivation(activationId);
+	REQUIRE(activation.exceededBudget);
+	REQUIRE(activation.getLatency() == 25000);
+
+	const std::wstring report = ActivationLatencyTracker::getReport(activation);
+	REQUIRE(report.find(L"Activate \"foo\"") != std::wstring::npos);
+	REQUIRE(report.find(L"view: 5.0 ms") != std::wstring::npos);
+
+	tracker->setBudgetMs(budgetMs);
+}
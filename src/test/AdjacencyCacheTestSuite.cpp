@@ -0,0 +1,90 @@
+#include "catch.hpp"
+
+#include "AdjacencyCache.h"
+#include "NodeType.h"
+
+namespace
+{
+AdjacencyCache createCache()
+{
+	std::vector<std::pair<Id, int>> nodeTypes = {
+		{1, NodeType::typeToInt(NodeType::NODE_CLASS)},
+		{2, NodeType::typeToInt(NodeType::NODE_METHOD)},
+		{3, NodeType::typeToInt(NodeType::NODE_FUNCTION)},
+		{4, NodeType::typeToInt(NodeType::NODE_FILE)}};
+
+	std::vector<StorageEdge> edges = {
+		StorageEdge(13, Edge::typeToInt(Edge::EDGE_CALL), 3, 2),
+		StorageEdge(11, Edge::typeToInt(Edge::EDGE_MEMBER), 1, 2),
+		StorageEdge(12, Edge::typeToInt(Edge::EDGE_TYPE_USAGE), 3, 1),
+		StorageEdge(14, Edge::typeToInt(Edge::EDGE_INCLUDE), 4, 5),
+		StorageEdge(15, Edge::typeToInt(Edge::EDGE_CALL), 2, 3)};
+
+	AdjacencyCache cache;
+	cache.build(nodeTypes, edges);
+	return cache;
+}
+
+std::vector<Id> getEdgeIds(const std::vector<StorageEdge>& edges)
+{
+	std::vector<Id> edgeIds;
+	for (const StorageEdge& edge: edges)
+	{
+		edgeIds.push_back(edge.id);
+	}
+	return edgeIds;
+}
+}	 // namespace
+
+TEST_CASE("adjacency cache returns edges of source and target nodes ordered by id")
+{
+	AdjacencyCache cache = createCache();
+	REQUIRE(!cache.isEmpty());
+
+	REQUIRE(
+		std::vector<Id>({12, 13}) ==
+		getEdgeIds(cache.getEdgesBySourceIds({3}, ~Edge::TypeMask(0))));
+	REQUIRE(
+		std::vector<Id>({11, 13, 15}) ==
+		getEdgeIds(cache.getEdgesBySourceIds({1, 2, 3}, Edge::EDGE_MEMBER | Edge::EDGE_CALL)));
+	REQUIRE(
+		std::vector<Id>({11, 13}) ==
+		getEdgeIds(cache.getEdgesByTargetIds({2, 2}, ~Edge::TypeMask(0))));
+	REQUIRE(cache.getEdgesByTargetIds({2}, Edge::EDGE_INCLUDE).empty());
+	REQUIRE(cache.getEdgesBySourceIds({42}, ~Edge::TypeMask(0)).empty());
+
+	const std::vector<StorageEdge> edges = cache.getEdgesByTargetIds({5}, ~Edge::TypeMask(0));
+	REQUIRE(1 == edges.size());
+	REQUIRE(4 == edges[0].sourceNodeId);
+	REQUIRE(5 == edges[0].targetNodeId);
+	REQUIRE(Edge::typeToInt(Edge::EDGE_INCLUDE) == edges[0].type);
+}
+
+TEST_CASE("adjacency cache knows the types of the nodes passed to build")
+{
+	AdjacencyCache cache = createCache();
+
+	int type = 0;
+	REQUIRE(cache.getNodeType(2, &type));
+	REQUIRE(NodeType::typeToInt(NodeType::NODE_METHOD) == type);
+	REQUIRE(!cache.getNodeType(5, &type));
+	REQUIRE(!cache.getNodeType(42, &type));
+}
+
+TEST_CASE("adjacency cache keeps its edges when serialized")
+{
+	AdjacencyCache cache;
+	REQUIRE(cache.deserialize(createCache().serialize()));
+
+	REQUIRE(
+		std::vector<Id>({13, 15}) ==
+		getEdgeIds(cache.getEdgesBySourceIds({2, 3}, Edge::EDGE_CALL)));
+	int type = 0;
+	REQUIRE(cache.getNodeType(4, &type));
+	REQUIRE(NodeType::typeToInt(NodeType::NODE_FILE) == type);
+
+	std::string data = createCache().serialize();
+	data.pop_back();
+	REQUIRE(!cache.deserialize(data));
+	REQUIRE(cache.isEmpty());
+}
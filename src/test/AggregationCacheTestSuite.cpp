@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "AdjacencyCache.h"
+#include "AggregationCache.h"
+#include "HierarchyCache.h"
+#include "NodeType.h"
+
+namespace
+{
+// namespace 1 contains the classes 2 and 4 with the methods 3 and 5, method 3 calls method 5 and
+// class 2 uses class 4. class 6 contains the namespace 7, which contains class 8.
+void buildCaches(AdjacencyCache* adjacencyCache, HierarchyCache* hierarchyCache)
+{
+	hierarchyCache->createConnection(10, 1, 2, false, false, false);
+	hierarchyCache->createConnection(11, 2, 3, true, false, false);
+	hierarchyCache->createConnection(12, 1, 4, false, false, false);
+	hierarchyCache->createConnection(13, 4, 5, true, false, false);
+	hierarchyCache->createConnection(14, 6, 7, true, false, false);
+	hierarchyCache->createConnection(15, 7, 8, false, false, false);
+	hierarchyCache->finishSetup();
+
+	adjacencyCache->build(
+		{},
+		{StorageEdge(10, Edge::typeToInt(Edge::EDGE_MEMBER), 1, 2),
+		 StorageEdge(11, Edge::typeToInt(Edge::EDGE_MEMBER), 2, 3),
+		 StorageEdge(12, Edge::typeToInt(Edge::EDGE_MEMBER), 1, 4),
+		 StorageEdge(13, Edge::typeToInt(Edge::EDGE_MEMBER), 4, 5),
+		 StorageEdge(14, Edge::typeToInt(Edge::EDGE_MEMBER), 6, 7),
+		 StorageEdge(15, Edge::typeToInt(Edge::EDGE_MEMBER), 7, 8),
+		 StorageEdge(20, Edge::typeToInt(Edge::EDGE_CALL), 3, 5),
+		 StorageEdge(21, Edge::typeToInt(Edge::EDGE_TYPE_USAGE), 2, 4)});
+}
+}	 // namespace
+
+TEST_CASE("aggregation cache groups edges of children by the last visible parents of both ends")
+{
+	AdjacencyCache adjacencyCache;
+	HierarchyCache hierarchyCache;
+	buildCaches(&adjacencyCache, &hierarchyCache);
+
+	AggregationCache cache;
+	REQUIRE(cache.isEmpty());
+	cache.build(adjacencyCache, hierarchyCache);
+	REQUIRE(!cache.isEmpty());
+
+	std::vector<AggregationCache::AggregatedEdge> edges;
+	REQUIRE(cache.getAggregatedEdges(2, &edges));
+	REQUIRE(1 == edges.size());
+	REQUIRE(4 == edges[0].parentId);
+	REQUIRE(20 == edges[0].edgeId);
+	REQUIRE(edges[0].forward);
+
+	edges.clear();
+	REQUIRE(cache.getAggregatedEdges(4, &edges));
+	REQUIRE(1 == edges.size());
+	REQUIRE(2 == edges[0].parentId);
+	REQUIRE(!edges[0].forward);
+
+	edges.clear();
+	REQUIRE(cache.getAggregatedEdges(1, &edges));
+	REQUIRE(edges.empty());
+}
+
+TEST_CASE("aggregation cache does not cover nodes with invisible children")
+{
+	AdjacencyCache adjacencyCache;
+	HierarchyCache hierarchyCache;
+	buildCaches(&adjacencyCache, &hierarchyCache);
+
+	AggregationCache cache;
+	cache.build(adjacencyCache, hierarchyCache);
+
+	std::vector<AggregationCache::AggregatedEdge> edges;
+	REQUIRE(!cache.getAggregatedEdges(6, &edges));
+
+	cache.clear();
+	REQUIRE(!cache.getAggregatedEdges(2, &edges));
+}
@@ -0,0 +1,68 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include "CxxAutomaticPch.h"
+
+TEST_CASE("automatic pch finds leading includes")
+{
+	const std::vector<std::string> includeDirectives = CxxAutomaticPch::getLeadingIncludeDirectives(
+		{"// comment",
+		 "/* block",
+		 "   comment */",
+		 "#pragma once",
+		 "",
+		 "#include <vector>",
+		 "#  include \"foo.h\" // comment",
+		 "#include <bar.hpp>",
+		 "int a = 0;",
+		 "#include <baz.h>"});
+
+	REQUIRE(includeDirectives.size() == 3);
+	REQUIRE(includeDirectives[0] == "#include <vector>");
+	REQUIRE(includeDirectives[1] == "#include \"foo.h\"");
+	REQUIRE(includeDirectives[2] == "#include <bar.hpp>");
+}
+
+TEST_CASE("automatic pch stops leading includes at other preprocessor directives")
+{
+	const std::vector<std::string> includeDirectives = CxxAutomaticPch::getLeadingIncludeDirectives(
+		{"#include <vector>", "#define FOO", "#include <bar.h>"});
+
+	REQUIRE(includeDirectives.size() == 1);
+	REQUIRE(includeDirectives[0] == "#include <vector>");
+}
+
+TEST_CASE("automatic pch stops leading includes at files that are not headers")
+{
+	const std::vector<std::string> includeDirectives = CxxAutomaticPch::getLeadingIncludeDirectives(
+		{"#include <vector>", "#include \"nodes.def\"", "#include <bar.h>"});
+
+	REQUIRE(includeDirectives.size() == 1);
+	REQUIRE(includeDirectives[0] == "#include <vector>");
+}
+
+TEST_CASE("automatic pch shares include prefix of most source files")
+{
+	const std::vector<std::string> prefix = CxxAutomaticPch::getSharedIncludePrefix(
+		{{"#include <a.h>", "#include <b.h>", "#include <c.h>"},
+		 {"#include <a.h>", "#include <b.h>", "#include <d.h>"},
+		 {"#include <a.h>", "#include <b.h>"},
+		 {"#include <e.h>"}});
+
+	REQUIRE(prefix.size() == 2);
+	REQUIRE(prefix[0] == "#include <a.h>");
+	REQUIRE(prefix[1] == "#include <b.h>");
+}
+
+TEST_CASE("automatic pch does not share include prefix of single source file")
+{
+	const std::vector<std::string> prefix = CxxAutomaticPch::getSharedIncludePrefix(
+		{{"#include <a.h>", "#include <b.h>"}, {"#include <c.h>"}});
+
+	REQUIRE(prefix.empty());
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -0,0 +1,66 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include "CxxIndexerCommandProvider.h"
+#	include "IndexerCommandCxx.h"
+
+namespace
+{
+std::shared_ptr<IndexerCommandCxx> createCommand(
+	const std::wstring& sourceFileName, const std::vector<std::wstring>& compilerFlags)
+{
+	return std::make_shared<IndexerCommandCxx>(
+		FilePath(L"/src/" + sourceFileName),
+		std::set<FilePath>(),
+		std::set<FilePathFilter>(),
+		std::set<FilePathFilter>(),
+		FilePath(L"/build"),
+		compilerFlags);
+}
+}	 // namespace
+
+TEST_CASE("cxx indexer command provider restores compiler flags of shared flag sets")
+{
+	CxxIndexerCommandProvider provider;
+	provider.addCommand(
+		createCommand(L"a.cpp", {L"-I/include", L"-o", L"a.o", L"-c", L"/src/a.cpp"}));
+	provider.addCommand(
+		createCommand(L"b.cpp", {L"-I/include", L"-o", L"b.o", L"-c", L"/src/b.cpp"}));
+
+	std::shared_ptr<IndexerCommandCxx> command = std::dynamic_pointer_cast<IndexerCommandCxx>(
+		provider.consumeCommandForSourceFilePath(FilePath(L"/src/b.cpp")));
+
+	REQUIRE(command);
+	REQUIRE(
+		command->getCompilerFlags() ==
+		std::vector<std::wstring>({L"-I/include", L"-o", L"b.o", L"-c", L"/src/b.cpp"}));
+}
+
+TEST_CASE("cxx indexer command provider clusters commands with the same compiler flags")
+{
+	CxxIndexerCommandProvider provider;
+	provider.addCommand(createCommand(L"a.cpp", {L"-DA", L"-c", L"/src/a.cpp"}));
+	provider.addCommand(createCommand(L"b.cpp", {L"-DB", L"-c", L"/src/b.cpp"}));
+	provider.addCommand(createCommand(L"c.cpp", {L"-DA", L"-c", L"/src/c.cpp"}));
+
+	REQUIRE(provider.getClusterKey(FilePath(L"/src/a.cpp")) != 0);
+	REQUIRE(
+		provider.getClusterKey(FilePath(L"/src/a.cpp")) ==
+		provider.getClusterKey(FilePath(L"/src/c.cpp")));
+	REQUIRE(
+		provider.getClusterKey(FilePath(L"/src/a.cpp")) !=
+		provider.getClusterKey(FilePath(L"/src/b.cpp")));
+
+	const std::vector<FilePath> filePaths = provider.clusterSourceFilePaths(
+		{FilePath(L"/src/a.cpp"), FilePath(L"/src/b.cpp"), FilePath(L"/src/c.cpp")}, 10);
+
+	REQUIRE(filePaths.size() == 3);
+	REQUIRE(filePaths[0] == FilePath(L"/src/a.cpp"));
+	REQUIRE(filePaths[1] == FilePath(L"/src/c.cpp"));
+	REQUIRE(filePaths[2] == FilePath(L"/src/b.cpp"));
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
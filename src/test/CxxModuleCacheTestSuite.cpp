@@ -0,0 +1,60 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include "CxxModuleCache.h"
+
+TEST_CASE("module cache detects implicit modules")
+{
+	REQUIRE(CxxModuleCache::usesImplicitModules({L"-std=c++17", L"-fmodules"}));
+	REQUIRE(CxxModuleCache::usesImplicitModules({L"-fcxx-modules"}));
+	REQUIRE(!CxxModuleCache::usesImplicitModules({L"-std=c++17"}));
+	REQUIRE(!CxxModuleCache::usesImplicitModules({L"-fmodules", L"-fno-modules"}));
+	REQUIRE(!CxxModuleCache::usesImplicitModules({L"-fmodules", L"-fno-implicit-modules"}));
+}
+
+TEST_CASE("module cache replaces the module cache of the build")
+{
+	const CxxModuleCache moduleCache(FilePath(L"/project/modules"));
+
+	std::vector<std::wstring> flags = {
+		L"-fmodules",
+		L"-fmodules-cache-path=/build/modules",
+		L"-fbuild-session-timestamp=1234",
+		L"-DFOO"};
+	moduleCache.addFlags(flags);
+
+	REQUIRE(flags.size() == 5);
+	REQUIRE(flags[0] == L"-fmodules");
+	REQUIRE(flags[1] == L"-DFOO");
+	REQUIRE(flags[2] == L"-fmodules-cache-path=" + FilePath(L"/project/modules").wstr());
+	REQUIRE(flags[3] == L"-fmodules-validate-once-per-build-session");
+	REQUIRE(flags[4] == L"-fbuild-session-file=" + moduleCache.getBuildSessionFilePath().wstr());
+}
+
+TEST_CASE("module cache keeps the flags of translation units without modules")
+{
+	std::vector<std::wstring> flags = {L"-fmodules-cache-path=/build/modules", L"-DFOO"};
+	CxxModuleCache(FilePath(L"/project/modules")).addFlags(flags);
+	REQUIRE(flags.size() == 2);
+
+	std::vector<std::wstring> moduleFlags = {L"-fmodules"};
+	CxxModuleCache().addFlags(moduleFlags);
+	REQUIRE(moduleFlags.size() == 1);
+}
+
+TEST_CASE("module cache configuration leaves out source and output files")
+{
+	const std::vector<std::wstring> configurationFlags = CxxModuleCache::getConfigurationFlags(
+		{L"clang++", L"-fmodules", L"-o", L"a.o", L"-MF", L"a.d", L"-c", L"src/a.cpp"},
+		FilePath(L"/project/src/a.cpp"));
+
+	REQUIRE(configurationFlags.size() == 3);
+	REQUIRE(configurationFlags[0] == L"clang++");
+	REQUIRE(configurationFlags[1] == L"-fmodules");
+	REQUIRE(configurationFlags[2] == L"-c");
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -4165,6 +4165,25 @@ TEST_CASE("cxx parser catches error in macro expansion")
 		client->errors, L"'this_path_does_not_exist.txt' file not found <2:10 2:10>"));
 }
 
+TEST_CASE("cxx parser reports truncated template instantiations")
+{
+	std::shared_ptr<TestIntermediateStorage> client = parseCode(
+		"template <int N>\n"
+		"struct A { A<N - 1> a; };\n"
+		"template <>\n"
+		"struct A<0> {};\n"
+		"A<1000> a;\n");
+
+	bool reported = false;
+	for (const std::wstring& error: client->errors)
+	{
+		reported |= utility::isPrefix<std::wstring>(L"Indexed only ", error) &&
+			utility::isPostfix<std::wstring>(
+				L" of 1000 implicit instantiations of template \"A\" <2:8 2:8>", error);
+	}
+	REQUIRE(reported);
+}
+
 TEST_CASE("cxx parser finds location of line comment")
 {
 	std::shared_ptr<TestIntermediateStorage> client = parseCode("// this is a line comment\n");
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+
+#include "FileContentCache.h"
+#include "TextAccess.h"
+#include "TextCodec.h"
+
+namespace
+{
+std::function<std::shared_ptr<TextAccess>()> countLoads(const std::string& text, size_t* loadCount)
+{
+	return [text, loadCount]() {
+		(*loadCount)++;
+		return TextAccess::createFromString(text);
+	};
+}
+}	 // namespace
+
+TEST_CASE("file content cache loads a content once per file and revision")
+{
+	FileContentCache cache;
+	size_t loadCount = 0;
+
+	std::shared_ptr<TextAccess> text = cache.getText(
+		{1, 1, "t"}, FileContentCache::CONSUMER_CODE_VIEW, countLoads("a\nb\n", &loadCount));
+	REQUIRE(2 == text->getLineCount());
+
+	REQUIRE(
+		text ==
+		cache.getText({1, 1, "t"}, FileContentCache::CONSUMER_TOOLTIP, countLoads("", &loadCount)));
+	REQUIRE(1 == loadCount);
+
+	cache.getText({1, 2, "t"}, FileContentCache::CONSUMER_CODE_VIEW, countLoads("c", &loadCount));
+	cache.getText({1, 2, "u"}, FileContentCache::CONSUMER_CODE_VIEW, countLoads("d", &loadCount));
+	REQUIRE(3 == loadCount);
+	REQUIRE(3 == cache.getEntryCount());
+
+	REQUIRE(0 == cache.getConsumerStats(FileContentCache::CONSUMER_CODE_VIEW).hitCount);
+	REQUIRE(3 == cache.getConsumerStats(FileContentCache::CONSUMER_CODE_VIEW).missCount);
+	REQUIRE(1 == cache.getConsumerStats(FileContentCache::CONSUMER_TOOLTIP).hitCount);
+	REQUIRE(0 == cache.getConsumerStats(FileContentCache::CONSUMER_TOOLTIP).missCount);
+}
+
+TEST_CASE("file content cache drops least recently used contents above its budget")
+{
+	FileContentCache cache;
+	size_t loadCount = 0;
+	const std::string content(1000, 'a');
+
+	cache.getText({1, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	const size_t byteSize = cache.getByteSize();
+	REQUIRE(byteSize >= content.size());
+
+	cache.setByteBudget(2 * byteSize);
+	cache.getText({2, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	cache.getText({1, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	cache.getText({3, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	REQUIRE(3 == loadCount);
+	REQUIRE(2 == cache.getEntryCount());
+	REQUIRE(2 * byteSize == cache.getByteSize());
+
+	// file 2 was used least recently
+	cache.getText({1, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	REQUIRE(3 == loadCount);
+	cache.getText({2, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	REQUIRE(4 == loadCount);
+
+	cache.setByteBudget(byteSize / 2);
+	REQUIRE(0 == cache.getEntryCount());
+	REQUIRE(0 == cache.getByteSize());
+
+	cache.getText({1, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads(content, &loadCount));
+	REQUIRE(0 == cache.getEntryCount());
+}
+
+TEST_CASE("file content cache decodes the lines of a stored content")
+{
+	FileContentCache cache;
+	size_t loadCount = 0;
+	const TextCodec codec("UTF-8");
+
+	std::shared_ptr<const FileContentCache::DecodedContent> decodedContent =
+		cache.getDecodedContent(
+			{1, 1, ""},
+			codec,
+			FileContentCache::CONSUMER_FULLTEXT_SEARCH,
+			countLoads("first\nsecond", &loadCount));
+	REQUIRE(2 == decodedContent->lines.size());
+	REQUIRE(L"first\n" == decodedContent->lines[0]);
+	REQUIRE(L"second" == decodedContent->lines[1]);
+
+	REQUIRE(
+		decodedContent ==
+		cache.getDecodedContent(
+			{1, 1, ""},
+			codec,
+			FileContentCache::CONSUMER_FULLTEXT_SEARCH,
+			countLoads("", &loadCount)));
+	cache.getText({1, 1, ""}, FileContentCache::CONSUMER_CODE_VIEW, countLoads("", &loadCount));
+	REQUIRE(1 == loadCount);
+	REQUIRE(2 == cache.getEntryCount());
+
+	REQUIRE(1 == cache.getConsumerStats(FileContentCache::CONSUMER_FULLTEXT_SEARCH).hitCount);
+	REQUIRE(1 == cache.getConsumerStats(FileContentCache::CONSUMER_CODE_VIEW).hitCount);
+}
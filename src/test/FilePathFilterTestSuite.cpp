@@ -1,6 +1,7 @@
 #include "catch.hpp"
 
 #include "FilePathFilter.h"
+#include "FilePathFilterMatcher.h"
 
 TEST_CASE("file path filter finds exact match")
 {
@@ -121,3 +122,26 @@ TEST_CASE("file path filter finds slash if backslash was provided")
 
 	REQUIRE(filter.isMatching(FilePath(L"folder/test.h")));
 }
+
+TEST_CASE("file path filter with wildcard suffix matches all paths below directory")
+{
+	FilePathFilter filter(L"**/build/**");
+
+	REQUIRE(filter.isMatchingAllPathsBelow(FilePath(L"folder/build")));
+	REQUIRE(!filter.isMatchingAllPathsBelow(FilePath(L"folder/source")));
+	REQUIRE(!FilePathFilter(L"**/build/*.h").isMatchingAllPathsBelow(FilePath(L"folder/build")));
+	REQUIRE(!FilePathFilter(L"folder/build").isMatchingAllPathsBelow(FilePath(L"folder/build")));
+}
+
+TEST_CASE("file path filter matcher matches paths against all of its filters")
+{
+	FilePathFilterMatcher matcher({L"root/**/test.h", L"root/*.cpp", L"root/build/**"});
+
+	REQUIRE(matcher.isMatching(L"root/folder1/folder2/test.h"));
+	REQUIRE(matcher.isMatching(L"root\\main.cpp"));
+	REQUIRE(matcher.isMatching(L"root/build/main.cpp"));
+	REQUIRE(!matcher.isMatching(L"root/folder/main.cpp"));
+	REQUIRE(!matcher.isMatching(L"root/test.hpp"));
+	REQUIRE(matcher.isMatchingAllPathsBelow(L"root/build"));
+	REQUIRE(!matcher.isMatchingAllPathsBelow(L"root/folder"));
+}
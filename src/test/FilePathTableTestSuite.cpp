@@ -0,0 +1,27 @@
+#include "catch.hpp"
+
+#include "FilePath.h"
+#include "FilePathTable.h"
+
+TEST_CASE("file path table returns the same id for equal paths")
+{
+	FilePathTable table;
+	const FilePathTable::Id id = table.getId(FilePath(L"/root/folder/test.cpp"));
+
+	REQUIRE(id != 0);
+	REQUIRE(table.getId(FilePath(L"/root/folder/test.cpp")) == id);
+	REQUIRE(table.findId(FilePath(L"/root/folder/test.cpp")) == id);
+	REQUIRE(table.findId(FilePath(L"/root/folder/test.h")) == 0);
+	REQUIRE(table.getPath(id).wstr() == L"/root/folder/test.cpp");
+	REQUIRE(table.getId(FilePath()) == 0);
+}
+
+TEST_CASE("file path table keeps parent and extension of paths")
+{
+	FilePathTable table;
+	const FilePathTable::Id id = table.getId(FilePath(L"/root/folder/test.cpp"));
+
+	REQUIRE(table.getExtension(id) == L".cpp");
+	REQUIRE(table.getParentId(id) == table.findId(FilePath(L"/root/folder")));
+	REQUIRE(table.getString(table.getParentId(table.getParentId(id))) == L"/root");
+}
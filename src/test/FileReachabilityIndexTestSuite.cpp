@@ -0,0 +1,52 @@
+#include "catch.hpp"
+
+#include "FileReachabilityIndex.h"
+
+TEST_CASE("file reachability index follows references through shared files")
+{
+	// 1 and 2 include 3, 3 includes 4 and 5, 5 includes 6
+	const FileReachabilityIndex index({{1, 3}, {2, 3}, {3, 4}, {3, 5}, {5, 6}});
+
+	REQUIRE(index.getReferenceCount() == 5);
+	REQUIRE(index.getReferenced({1}) == FileReachabilityIndex::IdSet({3, 4, 5, 6}));
+	REQUIRE(index.getReferenced({5}) == FileReachabilityIndex::IdSet({6}));
+	REQUIRE(index.getReferenced({4, 6}).empty());
+	REQUIRE(index.getReferencing({6}) == FileReachabilityIndex::IdSet({1, 2, 3, 5}));
+	REQUIRE(index.getReferencing({4}) == FileReachabilityIndex::IdSet({1, 2, 3}));
+	REQUIRE(index.getReferencing({1, 7}).empty());
+}
+
+TEST_CASE("file reachability index keeps files of cycles in one component")
+{
+	// 1 and 2 include each other, 3 includes itself
+	const FileReachabilityIndex index({{1, 2}, {2, 1}, {2, 4}, {3, 3}, {5, 1}});
+
+	REQUIRE(index.getReferenced({1}) == FileReachabilityIndex::IdSet({1, 2, 4}));
+	REQUIRE(index.getReferenced({3}) == FileReachabilityIndex::IdSet({3}));
+	REQUIRE(index.getReferenced({4}).empty());
+	REQUIRE(index.getReferencing({4}) == FileReachabilityIndex::IdSet({1, 2, 5}));
+}
+
+TEST_CASE("file reachability index answers the same after serialization")
+{
+	const FileReachabilityIndex index({{1, 2}, {2, 3}, {3, 2}, {4, 3}});
+
+	FileReachabilityIndex loadedIndex;
+	REQUIRE(loadedIndex.deserialize(index.serialize()));
+	REQUIRE(loadedIndex.getReferenceCount() == 4);
+	REQUIRE(loadedIndex.getReferenced({1}) == FileReachabilityIndex::IdSet({2, 3}));
+	REQUIRE(loadedIndex.getReferencing({3}) == FileReachabilityIndex::IdSet({1, 2, 3, 4}));
+
+	REQUIRE_FALSE(loadedIndex.deserialize(index.serialize().substr(0, 20)));
+	REQUIRE(loadedIndex.getReferenceCount() == 0);
+}
+
+TEST_CASE("file reachability index answers for other ids")
+{
+	const FileReachabilityIndex index =
+		FileReachabilityIndex({{1, 2}, {2, 3}}).withIds([](uint64_t id) { return 10 - id; });
+
+	REQUIRE(index.getReferenced({9}) == FileReachabilityIndex::IdSet({8, 7}));
+	REQUIRE(index.getReferencing({7}) == FileReachabilityIndex::IdSet({8, 9}));
+	REQUIRE(index.getReferenced({1}).empty());
+}
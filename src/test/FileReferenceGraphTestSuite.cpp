@@ -0,0 +1,25 @@
+#include "catch.hpp"
+
+#include "FileReferenceGraph.h"
+
+TEST_CASE("file reference graph follows references transitively")
+{
+	// 1 includes 2, 2 includes 3 and 4 includes 3
+	const FileReferenceGraph graph({{1, 2}, {2, 3}, {4, 3}, {1, 2}});
+
+	REQUIRE(graph.getReferenceCount() == 3);
+	REQUIRE(graph.getReferenced({1}) == FileReferenceGraph::IdSet({2, 3}));
+	REQUIRE(graph.getReferenced({3}).empty());
+	REQUIRE(graph.getReferencing({3}) == FileReferenceGraph::IdSet({1, 2, 4}));
+	REQUIRE(graph.getReferencing({2, 4}) == FileReferenceGraph::IdSet({1}));
+	REQUIRE(graph.getReferencing({5}).empty());
+}
+
+TEST_CASE("file reference graph contains files of cycles that reference themselves")
+{
+	const FileReferenceGraph graph({{1, 2}, {2, 1}, {3, 1}});
+
+	REQUIRE(graph.getReferenced({1}) == FileReferenceGraph::IdSet({1, 2}));
+	REQUIRE(graph.getReferencing({1}) == FileReferenceGraph::IdSet({1, 2, 3}));
+	REQUIRE(graph.getReferenced({3}) == FileReferenceGraph::IdSet({1, 2}));
+}
@@ -132,6 +132,26 @@ TEST_CASE("find file infos with symlinks")
 #endif
 }
 
+TEST_CASE("find file infos skips excluded directories")
+{
+#ifndef _WIN32
+	std::vector<FilePath> directoryPaths;
+	directoryPaths.push_back(FilePath(L"./data/FileSystemTestSuite"));
+
+	std::vector<FileInfo> files = FileSystem::getFileInfosFromPaths(
+		directoryPaths,
+		{L".h", L".hpp", L".cpp"},
+		false,
+		{FilePathFilter(L"**/src/**"), FilePathFilter(L"**/Sound.hpp")});
+
+	REQUIRE(files.size() == 4);
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/main.cpp"));
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/tictactoe.h"));
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/Settings/player.h"));
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/Settings/sample.cpp"));
+#endif
+}
+
 TEST_CASE("find symlinked directories")
 {
 #ifndef _WIN32
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include "FullTextSearchIndex.h"
+#include "FullTextSearchRegex.h"
+#include "SuffixArray.h"
+
+TEST_CASE("suffix array finds all occurrences of term")
+{
+	SuffixArray array(L"abcabcab");
+	std::vector<int> positions = array.searchForTerm(L"ab");
+
+	REQUIRE(3 == positions.size());
+	REQUIRE(0 == positions[0]);
+	REQUIRE(3 == positions[1]);
+	REQUIRE(6 == positions[2]);
+}
+
+TEST_CASE("suffix array search is case insensitive")
+{
+	SuffixArray array(L"FooBar foobar");
+	std::vector<int> positions = array.searchForTerm(L"BAR");
+
+	REQUIRE(2 == positions.size());
+	REQUIRE(3 == positions[0]);
+	REQUIRE(10 == positions[1]);
+}
+
+TEST_CASE("suffix array returns character positions for text with non ascii characters")
+{
+	SuffixArray array(L"\u00e4\u00f6\u00fc \u4e2d\u6587 foo \u4e2d");
+	std::vector<int> positions = array.searchForTerm(L"foo");
+	std::vector<int> nonAsciiPositions = array.searchForTerm(L"\u4e2d");
+
+	REQUIRE(1 == positions.size());
+	REQUIRE(7 == positions[0]);
+	REQUIRE(2 == nonAsciiPositions.size());
+	REQUIRE(4 == nonAsciiPositions[0]);
+	REQUIRE(11 == nonAsciiPositions[1]);
+}
+
+TEST_CASE("suffix array restored from serialized data finds same occurrences")
+{
+	const std::wstring text = L"int foo(); int bar() { return foo(); }";
+	const std::string serialized = SuffixArray(text).serialize();
+
+	SuffixArray array(text, serialized);
+	std::vector<int> positions = array.searchForTerm(L"foo");
+
+	REQUIRE(2 == positions.size());
+	REQUIRE(4 == positions[0]);
+	REQUIRE(30 == positions[1]);
+}
+
+TEST_CASE("suffix array ignores serialized data of different text")
+{
+	const std::string serialized = SuffixArray(L"short").serialize();
+
+	SuffixArray array(L"a longer text", serialized);
+	std::vector<int> positions = array.searchForTerm(L"text");
+
+	REQUIRE(1 == positions.size());
+	REQUIRE(9 == positions[0]);
+}
+
+TEST_CASE("fulltext search index finds results in added files")
+{
+	FullTextSearchIndex index;
+	index.addFile(1, L"void foo();");
+	index.addFile(2, L"void bar();");
+	index.addFile(3, L"foo(); foo();");
+
+	std::vector<FullTextSearchResult> results = index.searchForTerm(L"foo");
+
+	REQUIRE(3 == index.fileCount());
+	REQUIRE(2 == results.size());
+	REQUIRE(1 == results[0].fileId);
+	REQUIRE(1 == results[0].positions.size());
+	REQUIRE(3 == results[1].fileId);
+	REQUIRE(2 == results[1].positions.size());
+}
+
+TEST_CASE("fulltext search regex detects regex terms")
+{
+	REQUIRE(FullTextSearchRegex::isRegexTerm(L"/fo+/"));
+	REQUIRE(!FullTextSearchRegex::isRegexTerm(L"//"));
+	REQUIRE(!FullTextSearchRegex::isRegexTerm(L"foo"));
+	REQUIRE(L"fo+" == FullTextSearchRegex::getPattern(L"/fo+/"));
+}
+
+TEST_CASE("fulltext search regex finds required literal of pattern")
+{
+	REQUIRE(L"foo" == FullTextSearchRegex::getRequiredLiteral(L"\\bfoo\\b"));
+	REQUIRE(L"barbaz" == FullTextSearchRegex::getRequiredLiteral(L"foo.*barbaz"));
+	REQUIRE(L"f" == FullTextSearchRegex::getRequiredLiteral(L"fo?"));
+	REQUIRE(L"" == FullTextSearchRegex::getRequiredLiteral(L"a|b"));
+	REQUIRE(L"" == FullTextSearchRegex::getRequiredLiteral(L"[a-z]+"));
+}
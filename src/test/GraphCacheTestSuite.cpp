@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "Graph.h"
+#include "GraphCache.h"
+
+namespace
+{
+GraphCache::Key createKey(Id nodeId)
+{
+	GraphCache::Key key;
+	key.nodeIds = {nodeId};
+	return key;
+}
+
+GraphCache::Entry createEntry(Id nodeId)
+{
+	GraphCache::Entry entry;
+	entry.graph = std::make_shared<Graph>();
+	Node* node = entry.graph->createNode(
+		nodeId,
+		NodeType(NodeType::NODE_CLASS),
+		NameHierarchy(L"A", NAME_DELIMITER_CXX),
+		DEFINITION_EXPLICIT);
+
+	std::shared_ptr<DummyNode> dummyNode = std::make_shared<DummyNode>(DummyNode::DUMMY_DATA);
+	dummyNode->data = node;
+	dummyNode->tokenId = nodeId;
+	entry.dummyNodes.push_back(dummyNode);
+	entry.dummyGraphNodes.emplace(nodeId, dummyNode);
+	return entry;
+}
+}	 // namespace
+
+TEST_CASE("graph cache returns copies of added entries")
+{
+	GraphCache cache(2);
+	cache.addEntry(createKey(1), 1, createEntry(1));
+
+	GraphCache::Entry entry;
+	REQUIRE(!cache.getEntry(createKey(2), 1, &entry));
+	REQUIRE(cache.getEntry(createKey(1), 1, &entry));
+
+	REQUIRE(1 == entry.dummyNodes.size());
+	REQUIRE(entry.dummyNodes[0] == entry.dummyGraphNodes[1]);
+	REQUIRE(entry.dummyNodes[0]->data == entry.graph->getNodeById(1));
+
+	entry.dummyNodes[0]->expanded = true;
+
+	GraphCache::Entry otherEntry;
+	REQUIRE(cache.getEntry(createKey(1), 1, &otherEntry));
+	REQUIRE(!otherEntry.dummyNodes[0]->expanded);
+	REQUIRE(otherEntry.graph != entry.graph);
+}
+
+TEST_CASE("graph cache drops least recently used entries")
+{
+	GraphCache cache(2);
+	cache.addEntry(createKey(1), 1, createEntry(1));
+	cache.addEntry(createKey(2), 1, createEntry(2));
+
+	GraphCache::Entry entry;
+	REQUIRE(cache.getEntry(createKey(1), 1, &entry));
+
+	cache.addEntry(createKey(3), 1, createEntry(3));
+	REQUIRE(2 == cache.getSize());
+	REQUIRE(cache.getEntry(createKey(1), 1, &entry));
+	REQUIRE(!cache.getEntry(createKey(2), 1, &entry));
+}
+
+TEST_CASE("graph cache drops entries of other content versions")
+{
+	GraphCache cache(2);
+	cache.addEntry(createKey(1), 1, createEntry(1));
+
+	GraphCache::Entry entry;
+	REQUIRE(!cache.getEntry(createKey(1), 2, &entry));
+	REQUIRE(0 == cache.getSize());
+}
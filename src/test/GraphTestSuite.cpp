@@ -434,3 +434,32 @@ TEST_CASE("graph removes nodes")
 
 	REQUIRE(1 == graph.getNodeCount());
 }
+
+TEST_CASE("graph keeps nodes sorted by id and detaches removed edges")
+{
+	Graph graph;
+
+	Node* a = graph.createNode(
+		5,
+		NodeType(NodeType::NODE_FUNCTION),
+		NameHierarchy(L"A", NAME_DELIMITER_CXX),
+		DEFINITION_EXPLICIT);
+	Node* b = graph.createNode(
+		2,
+		NodeType(NodeType::NODE_FUNCTION),
+		NameHierarchy(L"B", NAME_DELIMITER_CXX),
+		DEFINITION_EXPLICIT);
+	Edge* e = graph.createEdge(7, Edge::EDGE_CALL, a, b);
+
+	REQUIRE(2 == graph.getNodes().size());
+	REQUIRE(b == graph.getNodes()[0]);
+	REQUIRE(a == graph.getNodes()[1]);
+	REQUIRE(a == graph.getNodeById(5));
+	REQUIRE(!graph.getNodeById(3));
+
+	graph.removeEdge(e);
+
+	REQUIRE(0 == graph.getEdgeCount());
+	REQUIRE(0 == a->getEdgeCount());
+	REQUIRE(0 == b->getEdgeCount());
+}
@@ -0,0 +1,109 @@
+#include "catch.hpp"
+
+#include "HierarchyCache.h"
+
+namespace
+{
+// namespace 1 contains class 2 with the members 3 and 4, member 4 is implicit and contains 5.
+// class 6 derives from class 2 and class 7 derives from class 6.
+HierarchyCache createCache()
+{
+	HierarchyCache cache;
+	cache.createConnection(11, 1, 2, false, false, false);
+	cache.createConnection(12, 2, 3, true, false, false);
+	cache.createConnection(13, 2, 4, true, false, true);
+	cache.createConnection(14, 4, 5, true, true, false);
+	cache.createInheritance(15, 6, 2);
+	cache.createInheritance(16, 7, 6);
+	cache.finishSetup();
+	return cache;
+}
+}	 // namespace
+
+TEST_CASE("hierarchy cache finds visible parents")
+{
+	const HierarchyCache cache = createCache();
+
+	REQUIRE(2 == cache.getLastVisibleParentNodeId(5));
+	REQUIRE(2 == cache.getLastVisibleParentNodeId(2));
+	REQUIRE(1 == cache.getLastVisibleParentNodeId(1));
+	REQUIRE(42 == cache.getLastVisibleParentNodeId(42));
+	REQUIRE(1 == cache.getIndexOfLastVisibleParentNode(5));
+
+	std::set<Id> nodeIds, edgeIds;
+	cache.addAllVisibleParentIdsForNodeId(5, &nodeIds, &edgeIds);
+	REQUIRE(std::set<Id>({2, 4, 5}) == nodeIds);
+	REQUIRE(std::set<Id>({13, 14}) == edgeIds);
+
+	REQUIRE(cache.isChildOfVisibleNodeOrInvisible(3));
+	REQUIRE(cache.isChildOfVisibleNodeOrInvisible(1));
+	REQUIRE(!cache.isChildOfVisibleNodeOrInvisible(2));
+	REQUIRE(!cache.isChildOfVisibleNodeOrInvisible(42));
+}
+
+TEST_CASE("hierarchy cache finds children")
+{
+	const HierarchyCache cache = createCache();
+
+	std::vector<Id> nodeIds, edgeIds;
+	cache.addAllChildIdsForNodeId(2, &nodeIds, &edgeIds);
+	REQUIRE(std::vector<Id>({3, 4, 5}) == nodeIds);
+	REQUIRE(std::vector<Id>({12, 13, 14}) == edgeIds);
+
+	nodeIds.clear();
+	edgeIds.clear();
+	cache.addAllChildIdsForNodeId(1, &nodeIds, &edgeIds);
+	REQUIRE(nodeIds.empty());
+
+	cache.addFirstChildIdsForNodeId(2, &nodeIds, &edgeIds);
+	REQUIRE(std::vector<Id>({3}) == nodeIds);
+	REQUIRE(std::vector<Id>({12}) == edgeIds);
+	REQUIRE(1 == cache.getFirstChildIdsCountForNodeId(2));
+	REQUIRE(1 == cache.getFirstChildIdsCountForNodeId(4));
+
+	REQUIRE(cache.nodeHasChildren(4));
+	REQUIRE(!cache.nodeHasChildren(5));
+	REQUIRE(cache.nodeIsImplicit(4));
+	REQUIRE(!cache.nodeIsVisible(1));
+	REQUIRE(cache.nodeIsVisible(6));
+}
+
+TEST_CASE("hierarchy cache finds inheritance chains to the given nodes")
+{
+	const HierarchyCache cache = createCache();
+
+	const std::vector<std::tuple<Id, Id, std::vector<Id>>> inheritanceEdges =
+		cache.getInheritanceEdgesForNodeId(7, {2, 6});
+	REQUIRE(2 == inheritanceEdges.size());
+	REQUIRE(std::make_tuple(Id(7), Id(6), std::vector<Id>({16})) == inheritanceEdges[0]);
+	REQUIRE(std::make_tuple(Id(7), Id(2), std::vector<Id>({16, 15})) == inheritanceEdges[1]);
+	REQUIRE(cache.getInheritanceEdgesForNodeId(2, {6, 7}).empty());
+}
+
+TEST_CASE("hierarchy cache passes on its connections to set up the same cache")
+{
+	const HierarchyCache cache = createCache();
+
+	HierarchyCache copy;
+	cache.forEachConnection([&copy](
+								Id edgeId,
+								Id fromId,
+								Id toId,
+								bool sourceVisible,
+								bool sourceImplicit,
+								bool targetImplicit) {
+		copy.createConnection(edgeId, fromId, toId, sourceVisible, sourceImplicit, targetImplicit);
+	});
+	cache.forEachInheritance(
+		[&copy](Id edgeId, Id fromId, Id toId) { copy.createInheritance(edgeId, fromId, toId); });
+	copy.finishSetup();
+
+	std::vector<Id> nodeIds, edgeIds;
+	copy.addFirstChildIdsForNodeId(2, &nodeIds, &edgeIds);
+	REQUIRE(std::vector<Id>({3}) == nodeIds);
+	REQUIRE(std::vector<Id>({12}) == edgeIds);
+	REQUIRE(2 == copy.getLastVisibleParentNodeId(5));
+	REQUIRE(copy.nodeIsImplicit(4));
+	REQUIRE(!copy.nodeIsVisible(1));
+	REQUIRE(2 == copy.getInheritanceEdgesForNodeId(7, {2, 6}).size());
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "IndexReplica.h"
+
+namespace
+{
+// file 1 holds the locations 12 and 10, file 2 holds location 11. node 3 occurs at 10 and 11,
+// node 4 at 10 and 12.
+IndexReplica buildReplica()
+{
+	IndexReplica replica;
+	replica.build(
+		{StorageNode(4, 2, "four"), StorageNode(3, 1, "three")},
+		{StorageSourceLocation(12, 1, 5, 1, 5, 8, 0),
+		 StorageSourceLocation(10, 1, 1, 2, 1, 6, 1),
+		 StorageSourceLocation(11, 2, 3, 4, 3, 9, 0)},
+		{StorageOccurrence(4, 12),
+		 StorageOccurrence(3, 11),
+		 StorageOccurrence(4, 10),
+		 StorageOccurrence(3, 10)});
+	return replica;
+}
+
+std::vector<Id> getLocationIds(const std::vector<StorageSourceLocation>& locations)
+{
+	std::vector<Id> ids;
+	for (const StorageSourceLocation& location: locations)
+	{
+		ids.push_back(location.id);
+	}
+	return ids;
+}
+}	 // namespace
+
+TEST_CASE("index replica finds nodes by id")
+{
+	IndexReplica replica = buildReplica();
+
+	StorageNode node;
+	REQUIRE(replica.getNodeById(3, &node));
+	REQUIRE(1 == node.type);
+	REQUIRE("three" == node.serializedName);
+	REQUIRE(!replica.getNodeById(5, &node));
+
+	const std::vector<StorageNode> nodes = replica.getNodesByIds({4, 5, 3, 4});
+	REQUIRE(2 == nodes.size());
+	REQUIRE(3 == nodes[0].id);
+	REQUIRE("four" == nodes[1].serializedName);
+}
+
+TEST_CASE("index replica keeps the locations of each file in order of their ids")
+{
+	IndexReplica replica = buildReplica();
+
+	REQUIRE(std::vector<Id>({10, 12}) == getLocationIds(replica.getSourceLocationsForFileId(1)));
+	REQUIRE(std::vector<Id>({11}) == getLocationIds(replica.getSourceLocationsForFileId(2)));
+	REQUIRE(replica.getSourceLocationsForFileId(3).empty());
+
+	StorageSourceLocation location;
+	REQUIRE(replica.getSourceLocationById(11, &location));
+	REQUIRE(2 == location.fileNodeId);
+	REQUIRE(3 == location.startLine);
+	REQUIRE(9 == location.endCol);
+	REQUIRE(std::vector<Id>({10, 11}) == getLocationIds(replica.getSourceLocationsByIds({11, 10})));
+}
+
+TEST_CASE("index replica finds occurrences of elements and locations")
+{
+	IndexReplica replica = buildReplica();
+
+	const std::vector<StorageOccurrence> elementOccurrences =
+		replica.getOccurrencesForElementIds({4});
+	REQUIRE(2 == elementOccurrences.size());
+	REQUIRE(10 == elementOccurrences[0].sourceLocationId);
+	REQUIRE(12 == elementOccurrences[1].sourceLocationId);
+
+	const std::vector<StorageOccurrence> locationOccurrences =
+		replica.getOccurrencesForLocationIds({10, 13});
+	REQUIRE(2 == locationOccurrences.size());
+	REQUIRE(3 == locationOccurrences[0].elementId);
+	REQUIRE(4 == locationOccurrences[1].elementId);
+}
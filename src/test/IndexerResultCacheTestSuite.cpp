@@ -0,0 +1,107 @@
+#include "catch.hpp"
+
+#include <fstream>
+
+#include "FileSystem.h"
+#include "IndexerCommandCustom.h"
+#include "IndexerResultCache.h"
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "NodeType.h"
+
+namespace
+{
+const FilePath cacheDirectoryPath(L"data/IndexerResultCacheTestSuite/cache");
+const FilePath sourceFilePath(L"data/IndexerResultCacheTestSuite/src/main.cpp");
+const FilePath headerFilePath(L"data/IndexerResultCacheTestSuite/src/header.h");
+
+void writeFile(const FilePath& filePath, const std::string& content)
+{
+	FileSystem::createDirectory(filePath.getParentDirectory());
+	std::ofstream file;
+	file.open(filePath.str());
+	file << content;
+	file.close();
+}
+
+void addFile(const FilePath& filePath, std::shared_ptr<IntermediateStorage> storage)
+{
+	const Id id = storage
+					  ->addNode(StorageNodeData(
+						  NodeType::NODE_FILE,
+						  NameHierarchy::serializeToBinary(
+							  NameHierarchy(filePath.wstr(), NAME_DELIMITER_FILE))))
+					  .first;
+	storage->addFile(
+		StorageFile(id, filePath.wstr(), L"someLanguage", "2000-01-01 10:10:10", true, true));
+}
+
+std::shared_ptr<IndexerCommand> createIndexerCommand(const std::wstring& customCommand)
+{
+	return std::make_shared<IndexerCommandCustom>(
+		customCommand, FilePath(), FilePath(), L"", sourceFilePath, false);
+}
+
+void cleanup()
+{
+	for (const FilePath& entryFilePath:
+		 FileSystem::getFilePathsFromDirectory(cacheDirectoryPath, {L".srctrldb"}))
+	{
+		FileSystem::remove(entryFilePath);
+	}
+	FileSystem::remove(sourceFilePath);
+	FileSystem::remove(headerFilePath);
+}
+}	 // namespace
+
+TEST_CASE("indexer result cache returns the stored index of an unchanged translation unit")
+{
+	cleanup();
+	{
+		writeFile(sourceFilePath, "#include \"header.h\"\n");
+		writeFile(headerFilePath, "int foo;\n");
+
+		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+		addFile(sourceFilePath, storage);
+		addFile(headerFilePath, storage);
+
+		IndexerResultCache cache(cacheDirectoryPath);
+		REQUIRE(!cache.load(createIndexerCommand(L"cmd")));
+
+		cache.store(createIndexerCommand(L"cmd"), storage);
+
+		std::shared_ptr<IntermediateStorage> cachedStorage = cache.load(createIndexerCommand(L"cmd"));
+		REQUIRE(cachedStorage);
+		REQUIRE(2 == cachedStorage->getStorageFiles().size());
+
+		// the command is part of the key
+		REQUIRE(!cache.load(createIndexerCommand(L"other cmd")));
+	}
+	cleanup();
+}
+
+TEST_CASE("indexer result cache drops the stored index if an indexed file changed")
+{
+	cleanup();
+	{
+		writeFile(sourceFilePath, "#include \"header.h\"\n");
+		writeFile(headerFilePath, "int foo;\n");
+
+		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+		addFile(sourceFilePath, storage);
+		addFile(headerFilePath, storage);
+
+		IndexerResultCache cache(cacheDirectoryPath);
+		cache.store(createIndexerCommand(L"cmd"), storage);
+
+		writeFile(headerFilePath, "int bar;\n");
+		REQUIRE(!cache.load(createIndexerCommand(L"cmd")));
+
+		writeFile(headerFilePath, "int foo;\n");
+		REQUIRE(cache.load(createIndexerCommand(L"cmd")));
+
+		writeFile(sourceFilePath, "#include \"header.h\"\nint baz;\n");
+		REQUIRE(!cache.load(createIndexerCommand(L"cmd")));
+	}
+	cleanup();
+}
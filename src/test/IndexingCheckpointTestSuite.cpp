@@ -0,0 +1,44 @@
+#include "catch.hpp"
+
+#include "FileSystem.h"
+#include "IndexingCheckpoint.h"
+
+namespace
+{
+const FilePath tempDbFilePath(L"data/IndexingCheckpointTestSuite/project.srctrldb_tmp");
+}
+
+TEST_CASE("indexing checkpoint lists the completed source files of its revision")
+{
+	FileSystem::createDirectory(tempDbFilePath.getParentDirectory());
+	IndexingCheckpoint checkpoint(IndexingCheckpoint::getFilePath(tempDbFilePath));
+
+	checkpoint.start("rev1");
+	checkpoint.addCompletedSourceFilePaths({FilePath(L"src/a.cpp"), FilePath(L"src/b.cpp")});
+	checkpoint.addCompletedSourceFilePaths({FilePath(L"src/c.cpp")});
+
+	REQUIRE(checkpoint.exists());
+	REQUIRE(checkpoint.getRevision() == "rev1");
+
+	const std::set<FilePath> filePaths = checkpoint.getCompletedSourceFilePaths();
+	REQUIRE(filePaths.size() == 3);
+	REQUIRE(filePaths.count(FilePath(L"src/b.cpp")) == 1);
+
+	checkpoint.remove();
+	REQUIRE(!checkpoint.exists());
+}
+
+TEST_CASE("indexing checkpoint starts an empty list for a new run")
+{
+	FileSystem::createDirectory(tempDbFilePath.getParentDirectory());
+	IndexingCheckpoint checkpoint(IndexingCheckpoint::getFilePath(tempDbFilePath));
+
+	checkpoint.start("rev1");
+	checkpoint.addCompletedSourceFilePaths({FilePath(L"src/a.cpp")});
+	checkpoint.start("rev2");
+
+	REQUIRE(checkpoint.getRevision() == "rev2");
+	REQUIRE(checkpoint.getCompletedSourceFilePaths().empty());
+
+	checkpoint.remove();
+}
@@ -0,0 +1,38 @@
+#include "catch.hpp"
+
+#include "InternedStringPool.h"
+
+TEST_CASE("interned string pool returns same handle for equal strings")
+{
+	InternedStringPool pool;
+	const InternedStringPool::Handle handle = pool.intern(L"foo::bar");
+
+	REQUIRE(handle != 0);
+	REQUIRE(handle == pool.intern(std::wstring(L"foo::") + L"bar"));
+	REQUIRE(handle != pool.intern(L"foo::baz"));
+	REQUIRE(2 == pool.getStringCount());
+}
+
+TEST_CASE("interned string pool returns strings of handles")
+{
+	InternedStringPool pool;
+	const InternedStringPool::Handle fooHandle = pool.intern(L"foo");
+	const InternedStringPool::Handle foobarHandle = pool.intern(L"foobar");
+
+	REQUIRE(L"foo" == pool.getString(fooHandle));
+	REQUIRE(L"foobar" == pool.getString(foobarHandle));
+	REQUIRE(L"" == pool.getString(0));
+	REQUIRE(L"" == pool.getString(42));
+}
+
+TEST_CASE("interned string pool finds only added strings")
+{
+	InternedStringPool pool;
+	const InternedStringPool::Handle handle = pool.intern(L"foobar");
+
+	REQUIRE(handle == pool.find(L"foobar"));
+	REQUIRE(0 == pool.find(L"foo"));
+	REQUIRE(0 == pool.find(L""));
+	REQUIRE(0 == pool.intern(L""));
+	REQUIRE(1 == pool.getStringCount());
+}
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+
+#include <sstream>
+
+#include "JsonProgressDialogView.h"
+
+namespace
+{
+std::vector<std::string> getLines(const std::stringstream& stream)
+{
+	std::vector<std::string> lines;
+	std::stringstream in(stream.str());
+	std::string line;
+	while (std::getline(in, line))
+	{
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+bool containsText(const std::string& line, const std::string& text)
+{
+	return line.find(text) != std::string::npos;
+}
+}	 // namespace
+
+TEST_CASE("json progress dialog view writes a line when a phase starts and finishes")
+{
+	std::stringstream out;
+	JsonProgressDialogView view(out);
+
+	view.showUnknownProgressDialog(L"Preparing Project", L"Processing Files");
+	view.showUnknownProgressDialog(L"Preparing Project", L"Processing Files");
+	view.showUnknownProgressDialog(L"Finish Indexing", L"Optimizing database");
+
+	const std::vector<std::string> lines = getLines(out);
+	REQUIRE(lines.size() == 3);
+	REQUIRE(containsText(lines[0], "\"event\":\"phase\""));
+	REQUIRE(containsText(lines[0], "\"phase\":\"Preparing Project\""));
+	REQUIRE(containsText(lines[1], "\"event\":\"phase_finished\""));
+	REQUIRE(containsText(lines[1], "\"duration_s\":"));
+	REQUIRE(containsText(lines[2], "\"step\":\"Optimizing database\""));
+}
+
+TEST_CASE("json progress dialog view throttles progress but writes the last update")
+{
+	std::stringstream out;
+	JsonProgressDialogView view(out);
+
+	view.updateIndexingDialog(1, 0, 3, {});
+	view.updateIndexingDialog(2, 1, 3, {});
+	view.updateIndexingDialog(3, 3, 3, {});
+
+	const std::vector<std::string> lines = getLines(out);
+	REQUIRE(lines.size() == 3);
+	REQUIRE(containsText(lines[0], "\"event\":\"phase\""));
+	REQUIRE(containsText(lines[1], "\"finished_files\":0"));
+	REQUIRE(containsText(lines[2], "\"finished_files\":3"));
+	REQUIRE(containsText(lines[2], "\"total_files\":3"));
+}
+
+TEST_CASE("json progress dialog view finishes the current phase when indexing finishes")
+{
+	std::stringstream out;
+	JsonProgressDialogView view(out);
+
+	view.updateIndexingDialog(1, 1, 1, {});
+	view.finishedIndexingDialog(1, 1, 1, 1, 2.0f, ErrorCountInfo(3, 1), false, false, {});
+
+	const std::vector<std::string> lines = getLines(out);
+	REQUIRE(lines.size() == 4);
+	REQUIRE(containsText(lines[2], "\"event\":\"phase_finished\""));
+	REQUIRE(containsText(lines[3], "\"event\":\"finished\""));
+	REQUIRE(containsText(lines[3], "\"errors\":3"));
+	REQUIRE(containsText(lines[3], "\"fatal_errors\":1"));
+	REQUIRE(containsText(lines[3], "\"interrupted\":false"));
+}
@@ -0,0 +1,56 @@
+#include "catch.hpp"
+
+#include <sstream>
+
+#include "LanguageServerService.h"
+
+TEST_CASE("language server reads messages framed with content length headers")
+{
+	std::stringstream stream;
+	LanguageServerService::writeMessage(stream, "{\"a\":1}");
+	stream << "Content-Length: 8\r\nContent-Type: application/vscode-jsonrpc\r\n\r\n{\"b\":\n2}";
+
+	std::string content;
+	REQUIRE(LanguageServerService::readMessage(stream, &content));
+	REQUIRE(content == "{\"a\":1}");
+	REQUIRE(LanguageServerService::readMessage(stream, &content));
+	REQUIRE(content == "{\"b\":\n2}");
+	REQUIRE(!LanguageServerService::readMessage(stream, &content));
+}
+
+TEST_CASE("language server answers requests and ignores notifications")
+{
+	LanguageServerService service(nullptr);
+
+	const std::string initialize = service.answer(
+		"{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"initialize\",\"params\":{}}");
+	REQUIRE(initialize.find("\"definitionProvider\":true") != std::string::npos);
+	REQUIRE(initialize.find("\"id\":1") != std::string::npos);
+
+	REQUIRE(service.answer("{\"jsonrpc\":\"2.0\",\"method\":\"initialized\",\"params\":{}}").empty());
+
+	const std::string unknown = service.answer(
+		"{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"textDocument/hover\",\"params\":{}}");
+	REQUIRE(unknown.find("-32601") != std::string::npos);
+
+	REQUIRE(service.answer("no json").find("-32700") != std::string::npos);
+}
+
+TEST_CASE("language server exits cleanly only after shutdown")
+{
+	std::stringstream in;
+	LanguageServerService::writeMessage(in, "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"shutdown\"}");
+	LanguageServerService::writeMessage(in, "{\"jsonrpc\":\"2.0\",\"method\":\"exit\"}");
+	LanguageServerService::writeMessage(in, "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"shutdown\"}");
+
+	std::stringstream out;
+	REQUIRE(0 == LanguageServerService::run(nullptr, in, out));
+
+	std::string content;
+	REQUIRE(LanguageServerService::readMessage(out, &content));
+	REQUIRE(content.find("\"result\":null") != std::string::npos);
+	REQUIRE(!LanguageServerService::readMessage(out, &content));
+
+	std::stringstream emptyIn;
+	REQUIRE(1 == LanguageServerService::run(nullptr, emptyIn, out));
+}
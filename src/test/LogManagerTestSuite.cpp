@@ -1,7 +1,10 @@
 #include "catch.hpp"
 
+#include <fstream>
 #include <thread>
 
+#include "FileLogger.h"
+#include "FileSystem.h"
 #include "LogManagerImplementation.h"
 
 namespace
@@ -135,6 +138,18 @@ void logSomeMessages(
 		logManagerImplementation->logError(message, __FILE__, __FUNCTION__, __LINE__);
 	}
 }
+
+unsigned int getLineCount(const FilePath& filePath)
+{
+	std::ifstream fileStream(filePath.str());
+	unsigned int lineCount = 0;
+	std::string line;
+	while (std::getline(fileStream, line))
+	{
+		lineCount++;
+	}
+	return lineCount;
+}
 }	 // namespace
 
 TEST_CASE("new logger can be added to manager")
@@ -289,3 +304,55 @@ TEST_CASE("logger logs threaded")
 		messageCount * 6 ==
 		logger->getErrorCount() + logger->getWarningCount() + logger->getMessageCount());
 }
+
+TEST_CASE("file logger writes messages of all threads")
+{
+	const FilePath logDirectory(L"data/LogManagerTestSuite/");
+	FilePath logFilePath;
+	{
+		LogManagerImplementation logManagerImplementation;
+		std::shared_ptr<FileLogger> logger = std::make_shared<FileLogger>();
+		logger->setLogDirectory(logDirectory);
+		logger->setFileName(L"threaded");
+		logManagerImplementation.addLogger(logger);
+		logFilePath = logger->getLogFilePath();
+
+		std::thread thread0(logSomeMessages, &logManagerImplementation, L"foo", 100);
+		std::thread thread1(logSomeMessages, &logManagerImplementation, L"bar", 100);
+		thread0.join();
+		thread1.join();
+
+		logger->flush();
+		REQUIRE(getLineCount(logFilePath) == 600);
+	}
+
+	FileSystem::remove(logFilePath);
+	FileSystem::remove(logDirectory);
+}
+
+TEST_CASE("file logger switches to next file when byte size is reached")
+{
+	const FilePath logDirectory(L"data/LogManagerTestSuite/");
+	std::vector<FilePath> logFilePaths;
+	{
+		LogManagerImplementation logManagerImplementation;
+		std::shared_ptr<FileLogger> logger = std::make_shared<FileLogger>();
+		logger->setLogDirectory(logDirectory);
+		logger->setMaxLogFileCount(3);
+		logger->setMaxLogFileByteSize(1);
+		logger->setFileName(L"ring");
+		logManagerImplementation.addLogger(logger);
+
+		logManagerImplementation.logInfo(L"first", "", "", 0);
+		logManagerImplementation.logInfo(L"second", "", "", 0);
+	}
+
+	logFilePaths = FileSystem::getFilePathsFromDirectory(logDirectory, {L".txt"});
+	REQUIRE(logFilePaths.size() == 2);
+	for (const FilePath& logFilePath: logFilePaths)
+	{
+		REQUIRE(getLineCount(logFilePath) == 1);
+		FileSystem::remove(logFilePath);
+	}
+	FileSystem::remove(logDirectory);
+}
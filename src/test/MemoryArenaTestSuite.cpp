@@ -0,0 +1,66 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryArena.h"
+
+TEST_CASE("memory arena returns aligned memory")
+{
+	MemoryArena arena;
+
+	arena.allocate(1, 1);
+	void* memory = arena.allocate(sizeof(double), alignof(double));
+
+	REQUIRE(reinterpret_cast<uintptr_t>(memory) % alignof(double) == 0);
+	REQUIRE(arena.getAllocatedByteCount() == 1 + sizeof(double));
+}
+
+TEST_CASE("memory arena serves allocations larger than a block")
+{
+	MemoryArena arena;
+
+	char* memory = static_cast<char*>(arena.allocate(16 * 1024 * 1024, 1));
+	memory[16 * 1024 * 1024 - 1] = 'a';
+
+	REQUIRE(arena.getReservedByteCount() >= 16 * 1024 * 1024);
+}
+
+TEST_CASE("memory arena release frees all memory")
+{
+	MemoryArena arena;
+	arena.allocate(100, 1);
+	arena.release();
+
+	REQUIRE(arena.getAllocatedByteCount() == 0);
+	REQUIRE(arena.getReservedByteCount() == 0);
+}
+
+TEST_CASE("arena allocator works with standard containers")
+{
+	MemoryArena arena;
+	{
+		std::vector<int, ArenaAllocator<int>> numbers(&arena);
+		std::unordered_map<
+			int,
+			int,
+			std::hash<int>,
+			std::equal_to<int>,
+			ArenaAllocator<std::pair<const int, int>>>
+			map(0, std::hash<int>(), std::equal_to<int>(), &arena);
+
+		for (int i = 0; i < 10000; i++)
+		{
+			numbers.push_back(i);
+			map.emplace(i, i * 2);
+		}
+
+		REQUIRE(numbers.size() == 10000);
+		REQUIRE(numbers[9999] == 9999);
+		REQUIRE(map.size() == 10000);
+		REQUIRE(map[5000] == 10000);
+	}
+
+	REQUIRE(arena.getAllocatedByteCount() > 0);
+}
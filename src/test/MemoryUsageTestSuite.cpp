@@ -0,0 +1,30 @@
+#include "catch.hpp"
+
+#include "MemoryUsage.h"
+#include "SearchIndex.h"
+
+TEST_CASE("memory usage sums up its entries")
+{
+	MemoryUsage usage;
+	usage.add("first", 1024);
+	usage.add("second", 2048);
+
+	REQUIRE(usage.getTotalByteSize() == 3072);
+	REQUIRE(usage.toString().find("total") != std::string::npos);
+	REQUIRE(utility::getByteSizeString(3072) == "3.0 KB");
+}
+
+TEST_CASE("memory usage of search index grows with added nodes")
+{
+	SearchIndex index;
+	index.finishSetup();
+	const size_t emptyByteSize = index.getByteSize();
+
+	for (Id id = 1; id <= 100; id++)
+	{
+		index.addNode(id, L"namespace::Class" + std::to_wstring(id) + L"::method");
+	}
+	index.finishSetup();
+
+	REQUIRE(index.getByteSize() > emptyByteSize + 100 * sizeof(wchar_t));
+}
@@ -108,6 +108,42 @@ private:
 	}
 };
 
+class BackgroundTestMessage: public Message<BackgroundTestMessage>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "BackgroundTestMessage";
+	}
+
+	BackgroundTestMessage(int value): value(value)
+	{
+		setPriority(PRIORITY_BACKGROUND);
+		setIsCoalesced(true);
+	}
+
+	const int value;
+};
+
+class OrderMessageListener
+	: public MessageListener<TestMessage>
+	, public MessageListener<BackgroundTestMessage>
+{
+public:
+	std::vector<int> m_values;
+
+private:
+	virtual void handleMessage(TestMessage* message)
+	{
+		m_values.push_back(0);
+	}
+
+	virtual void handleMessage(BackgroundTestMessage* message)
+	{
+		m_values.push_back(message->value);
+	}
+};
+
 void waitForThread()
 {
 	static const int THREAD_WAIT_TIME_MS = 20;
@@ -237,3 +273,21 @@ TEST_CASE("listener registration to front and back within message handling")
 	REQUIRE(2 == listener.m_listeners[3]->m_messageCount);
 	REQUIRE(2 == listener.m_listeners[4]->m_messageCount);
 }
+
+TEST_CASE("background messages are coalesced and processed after other messages")
+{
+	OrderMessageListener listener;
+
+	BackgroundTestMessage(1).dispatch();
+	BackgroundTestMessage(2).dispatch();
+	TestMessage().dispatch();
+	BackgroundTestMessage(3).dispatch();
+
+	MessageQueue::getInstance()->startMessageLoopThreaded();
+
+	waitForThread();
+
+	MessageQueue::getInstance()->stopMessageLoop();
+
+	REQUIRE(listener.m_values == std::vector<int>({0, 3}));
+}
@@ -0,0 +1,61 @@
+#include "catch.hpp"
+
+#include <thread>
+
+#include "MetricsRegistry.h"
+
+TEST_CASE("metrics registry returns the same metric for the same name and labels")
+{
+	MetricsRegistry registry;
+
+	registry.getCounter("rows_total", "rows").add(2);
+	registry.getCounter("rows_total", "rows").add(3);
+	registry.getCounter("rows_total", "rows", "table=\"node\"").add();
+
+	REQUIRE(registry.getCounter("rows_total", "rows").getValue() == 5);
+	REQUIRE(registry.getCounter("rows_total", "rows", "table=\"node\"").getValue() == 1);
+}
+
+TEST_CASE("metrics histogram counts values cumulatively")
+{
+	MetricHistogram histogram({1.0, 2.0});
+
+	std::thread thread([&histogram]() {
+		for (int i = 0; i < 100; i++)
+		{
+			histogram.observe(0.5);
+		}
+	});
+	for (int i = 0; i < 100; i++)
+	{
+		histogram.observe(1.5);
+	}
+	thread.join();
+	histogram.observe(3.0);
+
+	REQUIRE(histogram.getCount() == 201);
+	REQUIRE(histogram.getSum() == Approx(203.0));
+	REQUIRE(histogram.getBucketCounts() == std::vector<unsigned long long>({100, 200}));
+}
+
+TEST_CASE("metrics registry exports prometheus text and json")
+{
+	MetricsRegistry registry;
+	registry.getCounter("rows_total", "Inserted rows").add(7);
+	registry.getGauge("phase_seconds", "Phase durations", "phase=\"parse\"").set(1.5);
+	registry.getGauge("memory_kilobytes", "Memory").setFunction([]() { return 42.0; });
+	registry.getHistogram("inject_seconds", "Injection durations", {0.1}).observe(0.05);
+
+	const std::string text = registry.toPrometheusText();
+	REQUIRE(text.find("# TYPE rows_total counter\nrows_total 7\n") != std::string::npos);
+	REQUIRE(text.find("phase_seconds{phase=\"parse\"} 1.5\n") != std::string::npos);
+	REQUIRE(text.find("memory_kilobytes 42\n") != std::string::npos);
+	REQUIRE(text.find("inject_seconds_bucket{le=\"0.1\"} 1\n") != std::string::npos);
+	REQUIRE(text.find("inject_seconds_bucket{le=\"+Inf\"} 1\n") != std::string::npos);
+	REQUIRE(text.find("inject_seconds_count 1\n") != std::string::npos);
+
+	const std::string json = registry.toJson();
+	REQUIRE(json.find("\"rows_total\": 7") != std::string::npos);
+	REQUIRE(json.find("\"phase_seconds{phase=\\\"parse\\\"}\": 1.5") != std::string::npos);
+	REQUIRE(json.find("\"inject_seconds\": {\"count\": 1") != std::string::npos);
+}
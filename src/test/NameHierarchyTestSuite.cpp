@@ -0,0 +1,83 @@
+#include "catch.hpp"
+
+#include "NameHierarchy.h"
+
+namespace
+{
+NameHierarchy createFunctionName()
+{
+	NameHierarchy name(L"foo", NAME_DELIMITER_CXX);
+	name.push(NameElement(L"b\u00e4r<int>", L"void", L"(const char *) const"));
+	return name;
+}
+}	 // namespace
+
+TEST_CASE("name hierarchy keeps all parts in binary serialization")
+{
+	const NameHierarchy name = createFunctionName();
+	const NameHierarchy result = NameHierarchy::deserializeFromBinary(
+		NameHierarchy::serializeToBinary(name));
+
+	REQUIRE(result.getDelimiter() == L"::");
+	REQUIRE(result.size() == 2);
+	REQUIRE(result[0].getName() == L"foo");
+	REQUIRE(!result[0].hasSignature());
+	REQUIRE(result[1].getName() == L"b\u00e4r<int>");
+	REQUIRE(result[1].getSignature().getPrefix() == L"void");
+	REQUIRE(result[1].getSignature().getPostfix() == L"(const char *) const");
+}
+
+TEST_CASE("name hierarchy binary serialization of parent is prefix of child")
+{
+	const NameHierarchy name = createFunctionName();
+	const std::string parent = NameHierarchy::serializeRangeToBinary(name, 0, 1);
+	const std::string child = NameHierarchy::serializeToBinary(name);
+
+	REQUIRE(parent.size() < child.size());
+	REQUIRE(child.compare(0, parent.size(), parent) == 0);
+	REQUIRE(child.find('\0') == std::string::npos);
+}
+
+TEST_CASE("name hierarchy binary reader points into serialized data")
+{
+	const std::string data = NameHierarchy::serializeToBinary(createFunctionName());
+	NameHierarchy::BinaryReader reader(data);
+
+	REQUIRE(std::string(reader.getDelimiter().data, reader.getDelimiter().size) == "::");
+
+	NameHierarchy::BinaryReader::Field name;
+	NameHierarchy::BinaryReader::Field prefix;
+	NameHierarchy::BinaryReader::Field postfix;
+	REQUIRE(reader.readElement(&name, &prefix, &postfix));
+	REQUIRE(std::string(name.data, name.size) == "foo");
+	REQUIRE(prefix.size == 0);
+	REQUIRE(reader.readElement(&name, &prefix, &postfix));
+	REQUIRE(name.data > data.data());
+	REQUIRE(name.data + name.size <= data.data() + data.size());
+	REQUIRE(std::string(prefix.data, prefix.size) == "void");
+	REQUIRE(!reader.readElement(&name, &prefix, &postfix));
+	REQUIRE(reader.isValid());
+}
+
+TEST_CASE("name hierarchy binary reader detects truncated data")
+{
+	const std::string data = NameHierarchy::serializeToBinary(createFunctionName());
+	NameHierarchy::BinaryReader reader(data.substr(0, data.size() - 3));
+
+	NameHierarchy::BinaryReader::Field name;
+	NameHierarchy::BinaryReader::Field prefix;
+	NameHierarchy::BinaryReader::Field postfix;
+	while (reader.readElement(&name, &prefix, &postfix))
+	{
+	}
+	REQUIRE(!reader.isValid());
+}
+
+TEST_CASE("name hierarchy converts between text and binary serialization")
+{
+	const NameHierarchy name = createFunctionName();
+	const std::wstring text = NameHierarchy::serialize(name);
+
+	REQUIRE(NameHierarchy::convertSerializedToBinary(text) == NameHierarchy::serializeToBinary(name));
+	REQUIRE(NameHierarchy::convertBinaryToSerialized(NameHierarchy::serializeToBinary(name)) == text);
+}
@@ -69,3 +69,65 @@ TEST_CASE("parse message")
 	REQUIRE(networkMessage.column == 0);
 	REQUIRE(networkMessage.valid == false);
 }
+
+TEST_CASE("take complete messages keeps incomplete rest of received data")
+{
+	std::string receivedData =
+		"ping>>vim<EOM>setActiveToken>>C:/f\xc3\xbc.cpp>>1>>2<EOM>setActiveToken>>C:/f\xc3";
+
+	std::vector<std::wstring> messages = NetworkProtocolHelper::takeCompleteMessages(&receivedData);
+
+	REQUIRE(messages.size() == 2);
+	REQUIRE(messages[0] == L"ping>>vim<EOM>");
+	REQUIRE(messages[1] == L"setActiveToken>>C:/f\u00fc.cpp>>1>>2<EOM>");
+	REQUIRE(receivedData == "setActiveToken>>C:/f\xc3");
+
+	receivedData += "\xbc.cpp>>3>>4<EOM>";
+	messages = NetworkProtocolHelper::takeCompleteMessages(&receivedData);
+
+	REQUIRE(messages.size() == 1);
+	REQUIRE(NetworkProtocolHelper::parseSetActiveTokenMessage(messages[0]).row == 3);
+	REQUIRE(receivedData.empty());
+}
+
+TEST_CASE("parse file saved message")
+{
+	const std::wstring message = L"fileSaved>>C:/project/src/main.cpp<EOM>";
+
+	REQUIRE(
+		NetworkProtocolHelper::getMessageType(message) ==
+		NetworkProtocolHelper::MESSAGE_TYPE::FILE_SAVED);
+
+	NetworkProtocolHelper::FileSavedMessage networkMessage =
+		NetworkProtocolHelper::parseFileSavedMessage(message);
+
+	REQUIRE(networkMessage.valid);
+	REQUIRE(networkMessage.filePath.wstr() == L"C:/project/src/main.cpp");
+
+	REQUIRE(!NetworkProtocolHelper::parseFileSavedMessage(L"fileSaved>><EOM>").valid);
+	REQUIRE(!NetworkProtocolHelper::parseFileSavedMessage(L"fileSaved>>a.cpp>>b.cpp<EOM>").valid);
+}
+
+TEST_CASE("parse query symbols message")
+{
+	const std::wstring message = L"querySymbols>>Foo::bar\nstd::vector<std::vector<int>>\n<EOM>";
+
+	REQUIRE(
+		NetworkProtocolHelper::getMessageType(message) ==
+		NetworkProtocolHelper::MESSAGE_TYPE::QUERY_SYMBOLS);
+
+	NetworkProtocolHelper::QuerySymbolsMessage networkMessage =
+		NetworkProtocolHelper::parseQuerySymbolsMessage(message);
+
+	REQUIRE(networkMessage.valid);
+	REQUIRE(networkMessage.names.size() == 2);
+	REQUIRE(networkMessage.names[0] == L"Foo::bar");
+	REQUIRE(networkMessage.names[1] == L"std::vector<std::vector<int>>");
+
+	REQUIRE(!NetworkProtocolHelper::parseQuerySymbolsMessage(L"querySymbols>><EOM>").valid);
+	REQUIRE(!NetworkProtocolHelper::parseQuerySymbolsMessage(L"ping>>Foo<EOM>").valid);
+
+	REQUIRE(
+		NetworkProtocolHelper::buildSymbolsMessage(L"{\"symbols\":[]}") ==
+		L"symbols>>{\"symbols\":[]}<EOM>");
+}
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+
+#include "AdjacencyCache.h"
+#include "HierarchyCache.h"
+#include "NodeType.h"
+#include "OverviewSummary.h"
+
+namespace
+{
+// namespace 1 contains the classes 2 and 4 with the methods 3 and 5, namespace 6 contains class 7
+// with method 8 and function 9 is global. method 3 calls method 5 and 8, class 2 uses class 7 and
+// function 9 calls method 3.
+void buildSummary(OverviewSummary* summary)
+{
+	HierarchyCache hierarchyCache;
+	hierarchyCache.createConnection(10, 1, 2, false, false, false);
+	hierarchyCache.createConnection(11, 2, 3, true, false, false);
+	hierarchyCache.createConnection(12, 1, 4, false, false, false);
+	hierarchyCache.createConnection(13, 4, 5, true, false, false);
+	hierarchyCache.createConnection(14, 6, 7, false, false, false);
+	hierarchyCache.createConnection(15, 7, 8, true, false, false);
+	hierarchyCache.finishSetup();
+
+	AdjacencyCache adjacencyCache;
+	adjacencyCache.build(
+		{{1, NodeType::typeToInt(NodeType::NODE_NAMESPACE)},
+		 {2, NodeType::typeToInt(NodeType::NODE_CLASS)},
+		 {3, NodeType::typeToInt(NodeType::NODE_METHOD)},
+		 {4, NodeType::typeToInt(NodeType::NODE_CLASS)},
+		 {5, NodeType::typeToInt(NodeType::NODE_METHOD)},
+		 {6, NodeType::typeToInt(NodeType::NODE_NAMESPACE)},
+		 {7, NodeType::typeToInt(NodeType::NODE_CLASS)},
+		 {8, NodeType::typeToInt(NodeType::NODE_METHOD)},
+		 {9, NodeType::typeToInt(NodeType::NODE_FUNCTION)}},
+		{StorageEdge(10, Edge::typeToInt(Edge::EDGE_MEMBER), 1, 2),
+		 StorageEdge(11, Edge::typeToInt(Edge::EDGE_MEMBER), 2, 3),
+		 StorageEdge(12, Edge::typeToInt(Edge::EDGE_MEMBER), 1, 4),
+		 StorageEdge(13, Edge::typeToInt(Edge::EDGE_MEMBER), 4, 5),
+		 StorageEdge(14, Edge::typeToInt(Edge::EDGE_MEMBER), 6, 7),
+		 StorageEdge(15, Edge::typeToInt(Edge::EDGE_MEMBER), 7, 8),
+		 StorageEdge(20, Edge::typeToInt(Edge::EDGE_CALL), 3, 5),
+		 StorageEdge(21, Edge::typeToInt(Edge::EDGE_CALL), 3, 8),
+		 StorageEdge(22, Edge::typeToInt(Edge::EDGE_TYPE_USAGE), 2, 7),
+		 StorageEdge(23, Edge::typeToInt(Edge::EDGE_CALL), 9, 3)});
+
+	summary->build(adjacencyCache, hierarchyCache, [&hierarchyCache](Id nodeId, NodeType type) {
+		return type.isPackage() || !hierarchyCache.isChildOfVisibleNodeOrInvisible(nodeId);
+	});
+}
+}	 // namespace
+
+TEST_CASE("overview summary counts the nodes of the overview by type")
+{
+	OverviewSummary summary;
+	REQUIRE(summary.isEmpty());
+	buildSummary(&summary);
+	REQUIRE(!summary.isEmpty());
+
+	REQUIRE(std::vector<Id>({1, 2, 4, 6, 7, 9}) == summary.getNodeIds());
+	REQUIRE(std::vector<Id>({2, 4, 7}) == summary.getNodeIdsOfType(NodeType::NODE_CLASS));
+
+	const std::map<NodeType::Type, size_t> counts = summary.getNodeCounts();
+	REQUIRE(3 == counts.size());
+	REQUIRE(2 == counts.at(NodeType::NODE_NAMESPACE));
+	REQUIRE(3 == counts.at(NodeType::NODE_CLASS));
+	REQUIRE(1 == counts.at(NodeType::NODE_FUNCTION));
+}
+
+TEST_CASE("overview summary weighs the edges between the outermost nodes")
+{
+	OverviewSummary summary;
+	buildSummary(&summary);
+
+	REQUIRE(2 == summary.getEdges().size());
+	REQUIRE(2 == summary.getEdgeWeight(1, 6));
+	REQUIRE(1 == summary.getEdgeWeight(9, 1));
+	REQUIRE(0 == summary.getEdgeWeight(6, 1));
+	REQUIRE(0 == summary.getEdgeWeight(2, 4));
+
+	summary.clear();
+	REQUIRE(summary.isEmpty());
+	REQUIRE(summary.getEdges().empty());
+}
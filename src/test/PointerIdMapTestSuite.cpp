@@ -0,0 +1,54 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include "PointerIdMap.h"
+
+TEST_CASE("pointer id map finds inserted ids")
+{
+	std::vector<int> values(1000);
+	PointerIdMap<int> map;
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		map.emplace(&values[i], Id(i + 1));
+	}
+
+	REQUIRE(map.size() == values.size());
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		const Id* id = map.find(&values[i]);
+		REQUIRE(id != nullptr);
+		REQUIRE(*id == Id(i + 1));
+	}
+
+	int other = 0;
+	REQUIRE(map.find(&other) == nullptr);
+}
+
+TEST_CASE("pointer id map keeps the first id of a key")
+{
+	int value = 0;
+	PointerIdMap<int> map;
+
+	map.emplace(&value, 1);
+	map.emplace(&value, 2);
+
+	REQUIRE(map.size() == 1);
+	REQUIRE(*map.find(&value) == 1);
+}
+
+TEST_CASE("pointer id map supports null pointer keys")
+{
+	PointerIdMap<int> map(100);
+	REQUIRE(map.find(nullptr) == nullptr);
+
+	map.emplace(nullptr, 3);
+
+	REQUIRE(map.size() == 1);
+	REQUIRE(*map.find(nullptr) == 3);
+
+	map.clear();
+	REQUIRE(map.size() == 0);
+	REQUIRE(map.find(nullptr) == nullptr);
+}
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include "AccessKind.h"
+#include "DefinitionKind.h"
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "ParserClientImpl.h"
+#include "RecordStreamDecoder.h"
+#include "SymbolKind.h"
+#include "utilityString.h"
+
+namespace
+{
+class RecordStreamWriter
+{
+public:
+	void putInt(int value)
+	{
+		const int32_t v = value;
+		m_bytes.append(reinterpret_cast<const char*>(&v), sizeof(v));
+	}
+
+	void putString(const std::string& str)
+	{
+		putInt(int(str.size()));
+		m_bytes += str;
+	}
+
+	void putLocation(int beginLine, int beginColumn, int endLine, int endColumn)
+	{
+		putInt(beginLine);
+		putInt(beginColumn);
+		putInt(endLine);
+		putInt(endColumn);
+	}
+
+	const std::string& getBytes() const
+	{
+		return m_bytes;
+	}
+
+private:
+	std::string m_bytes;
+};
+
+// a file record, a name and a symbol of that name with a location in the file
+std::string getFunctionRecords()
+{
+	RecordStreamWriter writer;
+
+	writer.putInt(10);
+	writer.putString("/src/main.py");
+	writer.putString("python");
+	writer.putInt(1);
+
+	writer.putInt(0);
+	writer.putInt(0);
+	writer.putString(utility::encodeToUtf8(
+		NameHierarchy::serialize(NameHierarchy(L"main", NAME_DELIMITER_JAVA))));
+
+	writer.putInt(2);
+	writer.putInt(0);
+	writer.putInt(symbolKindToInt(SYMBOL_FUNCTION));
+	writer.putLocation(1, 5, 1, 8);
+	writer.putInt(accessKindToInt(ACCESS_NONE));
+	writer.putInt(definitionKindToInt(DEFINITION_EXPLICIT));
+
+	return writer.getBytes();
+}
+}	 // namespace
+
+TEST_CASE("record stream decoder decodes records split between chunks")
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	RecordStreamDecoder decoder(std::make_shared<ParserClientImpl>(storage.get()));
+
+	const std::string records = getFunctionRecords();
+	for (size_t i = 0; i < records.size(); i += 3)
+	{
+		decoder.decodeChunk(records.data() + i, std::min<size_t>(3, records.size() - i));
+	}
+
+	REQUIRE(decoder.finish());
+	REQUIRE(storage->getStorageFiles().size() == 1);
+	REQUIRE(storage->getStorageFiles().front().filePath == L"/src/main.py");
+	REQUIRE(storage->getStorageFiles().front().languageIdentifier == L"python");
+	REQUIRE(storage->getStorageSourceLocations().size() == 1);
+	REQUIRE(storage->getStorageSourceLocations().front().startLine == 1);
+	REQUIRE(storage->getStorageSourceLocations().front().startCol == 5);
+}
+
+TEST_CASE("record stream decoder reports a stream that ends within a record")
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	RecordStreamDecoder decoder(std::make_shared<ParserClientImpl>(storage.get()));
+
+	const std::string records = getFunctionRecords();
+	decoder.decodeChunk(records.data(), records.size() - 1);
+
+	REQUIRE(!decoder.finish());
+	REQUIRE(storage->getStorageFiles().size() == 1);
+	REQUIRE(storage->getStorageSourceLocations().empty());
+}
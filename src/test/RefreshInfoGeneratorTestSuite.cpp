@@ -135,7 +135,8 @@ Id addFileToStorage(
 		storage
 			->addNode(StorageNodeData(
 				NodeType::NODE_FILE,
-				NameHierarchy::serialize(NameHierarchy(filePath.wstr(), NAME_DELIMITER_FILE))))
+				NameHierarchy::serializeToBinary(
+					NameHierarchy(filePath.wstr(), NAME_DELIMITER_FILE))))
 			.first;
 	storage->addFile(
 		StorageFile(id, filePath.wstr(), L"someLanguage", modificationTime, indexed, complete));
@@ -1060,3 +1061,107 @@ TEST_CASE(
 	}
 	cleanup();
 }
+
+TEST_CASE("refresh info for changed directories only checks files of changed directories")
+{
+	cleanup();
+	{
+		const FilePath outOfDateSourceFilePath = m_sourceFolder.getConcatenated(
+			L"out_of_date_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(
+			new SourceGroupTest({outOfDateSourceFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		addVeryOldFileToStorage(outOfDateSourceFilePath, true, true, storage);
+		addFileToFileSystem(outOfDateSourceFilePath);
+
+		storage->buildCaches();
+
+		const RefreshInfo unchangedDirectoryRefreshInfo =
+			RefreshInfoGenerator::getRefreshInfoForChangedDirectories(sourceGroups, storage, {});
+		const RefreshInfo changedDirectoryRefreshInfo =
+			RefreshInfoGenerator::getRefreshInfoForChangedDirectories(
+				sourceGroups, storage, {m_sourceFolder});
+
+		REQUIRE(REFRESH_UPDATED_FILES == unchangedDirectoryRefreshInfo.mode);
+		REQUIRE(0 == unchangedDirectoryRefreshInfo.filesToClear.size());
+		REQUIRE(0 == unchangedDirectoryRefreshInfo.filesToIndex.size());
+
+		REQUIRE(1 == changedDirectoryRefreshInfo.filesToClear.size());
+		REQUIRE(utility::containsElement<FilePath>(
+			utility::toVector(changedDirectoryRefreshInfo.filesToIndex), outOfDateSourceFilePath));
+	}
+	cleanup();
+}
+
+TEST_CASE("refresh info for updated files compares content hashes of touched files")
+{
+	cleanup();
+	{
+		const FilePath touchedFilePath = m_sourceFolder.getConcatenated(L"touched_file.cpp");
+		const FilePath editedFilePath = m_sourceFolder.getConcatenated(L"edited_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(
+			new SourceGroupTest({touchedFilePath, editedFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		// the stored content is read from disk, both files are older in the storage
+		addFileToFileSystem(touchedFilePath);
+		addFileToFileSystem(editedFilePath);
+		addVeryOldFileToStorage(touchedFilePath, true, true, storage);
+		addVeryOldFileToStorage(editedFilePath, true, true, storage);
+
+		std::ofstream file;
+		file.open(editedFilePath.str(), std::ios::app);
+		file << "This is some more file content.\n";
+		file.close();
+
+		storage->buildCaches();
+
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+
+		REQUIRE(1 == refreshInfo.filesToClear.size());
+		REQUIRE(utility::containsElement<FilePath>(
+			utility::toVector(refreshInfo.filesToClear), editedFilePath));
+		REQUIRE(!utility::containsElement<FilePath>(
+			utility::toVector(refreshInfo.filesToIndex), touchedFilePath));
+	}
+	cleanup();
+}
+
+TEST_CASE("shards of the source files are balanced by cost and cover all files once")
+{
+	const std::set<FilePath> filePaths = {
+		FilePath(L"a.cpp"), FilePath(L"b.cpp"), FilePath(L"c.cpp"), FilePath(L"d.cpp")};
+	const std::function<unsigned long long(const FilePath&)> getFileCost =
+		[](const FilePath& filePath) -> unsigned long long {
+		return filePath.wstr() == L"a.cpp" ? 30 : 10;
+	};
+
+	IndexShard shard;
+	shard.count = 2;
+	shard.index = 0;
+	const std::set<FilePath> firstShard = RefreshInfoGenerator::getFilePathsOfShard(
+		filePaths, shard, getFileCost);
+	shard.index = 1;
+	const std::set<FilePath> secondShard = RefreshInfoGenerator::getFilePathsOfShard(
+		filePaths, shard, getFileCost);
+
+	// the largest file is indexed alone, the same files are picked on every machine
+	REQUIRE(std::set<FilePath>({FilePath(L"a.cpp")}) == firstShard);
+	REQUIRE(3 == secondShard.size());
+	REQUIRE(
+		firstShard ==
+		RefreshInfoGenerator::getFilePathsOfShard(
+			filePaths, IndexShard({0, 2}), getFileCost));
+}
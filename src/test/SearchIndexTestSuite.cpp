@@ -55,6 +55,31 @@ TEST_CASE("search index does not find anything after clear")
 	REQUIRE(0 == results.size());
 }
 
+TEST_CASE("search index takes nodes of other index except skipped ids")
+{
+	SearchIndex previousIndex;
+	previousIndex.addNode(1, L"foo");
+	previousIndex.addNode(2, L"foobar");
+	previousIndex.addNode(3, L"bar");
+	previousIndex.finishSetup();
+
+	SearchIndex index;
+	index.addNodes(previousIndex, {2});
+	index.addNode(4, L"foobaz");
+	index.finishSetup();
+
+	std::set<Id> ids;
+	for (const SearchResult& result: index.search(L"foo", NodeTypeSet::all(), 0))
+	{
+		ids.insert(result.elementIds.begin(), result.elementIds.end());
+	}
+	REQUIRE(std::set<Id>({1, 4}) == ids);
+
+	const std::vector<SearchResult> results = index.search(L"bar", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(std::vector<Id>({3}) == results[0].elementIds);
+}
+
 TEST_CASE("search index does not find all results when max amount is limited")
 {
 	SearchIndex index;
@@ -91,3 +116,161 @@ TEST_CASE("search index rates higher on consecutive letters")
 	REQUIRE(L"ocbcabc" == results[0].text);
 	REQUIRE(L"oaabbcc" == results[1].text);
 }
+
+TEST_CASE("search index only finds elements of accepted node types")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo::bar", NodeType::NODE_FUNCTION);
+	index.addNode(2, L"foo::baz", NodeType::NODE_CLASS);
+	index.addNode(3, L"foo", NodeType::NODE_NAMESPACE);
+	index.finishSetup();
+	std::vector<SearchResult> results = index.search(
+		L"fb", NodeTypeSet(NodeType(NodeType::NODE_CLASS)), 0);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(L"foo::baz" == results[0].text);
+	REQUIRE(std::vector<Id>({2}) == results[0].elementIds);
+}
+
+TEST_CASE("search index finds same results after serialization")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo::bar", NodeType::NODE_FUNCTION);
+	index.addNode(2, L"foo::baz", NodeType::NODE_CLASS);
+	index.addNode(3, L"Foo", NodeType::NODE_NAMESPACE);
+	index.finishSetup();
+
+	SearchIndex deserializedIndex;
+	REQUIRE(deserializedIndex.deserialize(index.serialize()));
+	REQUIRE(!SearchIndex().deserialize(index.serialize().substr(1)));
+
+	const std::vector<SearchResult> results = index.search(L"fo", NodeTypeSet::all(), 0);
+	const std::vector<SearchResult> deserializedResults = deserializedIndex.search(
+		L"fo", NodeTypeSet::all(), 0);
+
+	REQUIRE(3 == results.size());
+	REQUIRE(results.size() == deserializedResults.size());
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		REQUIRE(results[i].text == deserializedResults[i].text);
+		REQUIRE(results[i].elementIds == deserializedResults[i].elementIds);
+		REQUIRE(results[i].score == deserializedResults[i].score);
+	}
+}
+
+TEST_CASE("search index finds same results for extended query as for new query")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo::getBar", NodeType::NODE_FUNCTION);
+	index.addNode(2, L"foo::getBaz", NodeType::NODE_FUNCTION);
+	index.addNode(3, L"foo::setGate", NodeType::NODE_FUNCTION);
+	index.addNode(4, L"geometry", NodeType::NODE_NAMESPACE);
+	index.finishSetup();
+
+	SearchIndex otherIndex;
+	REQUIRE(otherIndex.deserialize(index.serialize()));
+
+	index.search(L"g", NodeTypeSet::all(), 0);
+	index.search(L"ge", NodeTypeSet::all(), 0);
+	const std::vector<SearchResult> results = index.search(L"get", NodeTypeSet::all(), 0);
+	const std::vector<SearchResult> otherResults = otherIndex.search(L"get", NodeTypeSet::all(), 0);
+
+	REQUIRE(3 == results.size());
+	REQUIRE(results.size() == otherResults.size());
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		REQUIRE(results[i].text == otherResults[i].text);
+		REQUIRE(results[i].indices == otherResults[i].indices);
+		REQUIRE(results[i].score == otherResults[i].score);
+	}
+}
+
+TEST_CASE("search index finds all matches of large index")
+{
+	SearchIndex index;
+	std::vector<std::wstring> names;
+	for (size_t i = 0; i < 150000; i++)
+	{
+		names.push_back(L"ns" + std::to_wstring(i % 7) + L"::f" + std::to_wstring(i));
+		index.addNode(i + 1, names.back(), NodeType::NODE_FUNCTION);
+	}
+	index.finishSetup();
+
+	const std::wstring query = L"n3f1234";
+	size_t expectedCount = 0;
+	for (const std::wstring& name: names)
+	{
+		size_t j = 0;
+		for (size_t i = 0; i < name.size() && j < query.size(); i++)
+		{
+			if (name[i] == query[j])
+			{
+				j++;
+			}
+		}
+		expectedCount += (j == query.size() ? 1 : 0);
+	}
+
+	REQUIRE(expectedCount > 0);
+	REQUIRE(expectedCount == index.search(query, NodeTypeSet::all(), 0).size());
+}
+
+TEST_CASE("search index finds nothing for cancelled search and all after it")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo::getBar", NodeType::NODE_FUNCTION);
+	index.addNode(2, L"foo::getBaz", NodeType::NODE_FUNCTION);
+	index.finishSetup();
+
+	REQUIRE(index.search(L"get", NodeTypeSet::all(), 0, 0, []() { return true; }).empty());
+	REQUIRE(2 == index.search(L"get", NodeTypeSet::all(), 0).size());
+}
+
+TEST_CASE("search index scores results of repeated query like the first time")
+{
+	SearchIndex index;
+	index.addNode(1, L"util::getFooBar", NodeType::NODE_FUNCTION);
+	index.addNode(2, L"util::getFoo", NodeType::NODE_FUNCTION);
+	index.finishSetup();
+
+	const std::vector<SearchResult> results = index.search(L"gfb", NodeTypeSet::all(), 0);
+	const std::vector<SearchResult> repeatedResults = index.search(L"gfb", NodeTypeSet::all(), 0);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(1 == repeatedResults.size());
+	REQUIRE(results[0].text == repeatedResults[0].text);
+	REQUIRE(results[0].elementIds == repeatedResults[0].elementIds);
+	REQUIRE(results[0].indices == repeatedResults[0].indices);
+	REQUIRE(results[0].score == repeatedResults[0].score);
+
+	const SearchResult rescoredResult = SearchIndex::rescoreText(
+		results[0].text, L"getFooBar", results[0].indices, results[0].score, 0);
+	REQUIRE(L"getFooBar" == rescoredResult.text);
+	REQUIRE(results[0].indices == rescoredResult.indices);
+}
+
+TEST_CASE("search index ranks referenced and recent results higher")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo::getBar", NodeType::NODE_FUNCTION);
+	index.addNode(2, L"foo::getBaz", NodeType::NODE_FUNCTION, 100);
+	index.finishSetup();
+
+	std::vector<SearchResult> results = index.search(L"get", NodeTypeSet::all(), 0);
+	REQUIRE(2 == results.size());
+	REQUIRE(std::vector<Id>({2}) == results[0].elementIds);
+	REQUIRE(results[0].score > results[1].score);
+
+	SearchIndex deserializedIndex;
+	REQUIRE(deserializedIndex.deserialize(index.serialize()));
+	REQUIRE(results[0].score == deserializedIndex.search(L"get", NodeTypeSet::all(), 0)[0].score);
+
+	index.setRecentIds({1});
+	results = index.search(L"get", NodeTypeSet::all(), 0);
+	REQUIRE(2 == results.size());
+	REQUIRE(std::vector<Id>({1}) == results[0].elementIds);
+
+	index.setRecentIds({});
+	results = index.search(L"get", NodeTypeSet::all(), 0);
+	REQUIRE(std::vector<Id>({2}) == results[0].elementIds);
+}
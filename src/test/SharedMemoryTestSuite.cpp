@@ -3,6 +3,12 @@
 #include <memory>
 #include <thread>
 
+#include "IntermediateStorage.h"
+#include "InterprocessIndexingStatusManager.h"
+#include "InterprocessIntermediateStorageManager.h"
+#include "MetricsRegistry.h"
+#include "NameHierarchy.h"
+#include "SharedIntermediateStorage.h"
 #include "SharedMemory.h"
 
 TEST_CASE("shared memory")
@@ -95,3 +101,195 @@ TEST_CASE("shared memory")
 		}
 	}
 }
+
+TEST_CASE("shared intermediate storage keeps all recorded data")
+{
+	IntermediateStorage storage;
+	const std::string serializedName = NameHierarchy::serializeToBinary(
+		NameHierarchy(L"\u00e4node", NAME_DELIMITER_CXX));
+	const Id nodeId = storage.addNode(StorageNodeData(1, serializedName)).first;
+	storage.addFile(StorageFile(nodeId, L"file.cpp", L"cpp", "2020-01-01", true, false));
+	const Id edgeId = storage.addEdge(StorageEdgeData(2, nodeId, nodeId));
+	const Id locationId = storage.addSourceLocation(StorageSourceLocationData(nodeId, 1, 2, 3, 4, 5));
+	storage.addOccurrence(StorageOccurrence(edgeId, locationId));
+	storage.addLocalSymbol(StorageLocalSymbolData(L"local"));
+	storage.addComponentAccess(StorageComponentAccess(nodeId, 3));
+	storage.addElementComponent(StorageElementComponent(edgeId, 1, L"data"));
+	storage.addError(StorageErrorData(L"message", L"file.cpp", true, false));
+	storage.addIndexingTimes({StorageIndexingTime(L"file.cpp", 42, 30, 12, 2048, 100, 7)});
+
+	SharedMemory memory("intermediate", 1048576, SharedMemory::CREATE_AND_DELETE);
+	SharedMemory::ScopedAccess access(&memory);
+
+	SharedIntermediateStorage sharedStorage(access.getAllocator());
+	sharedStorage.write(storage);
+	REQUIRE(sharedStorage.getDataSize() == SharedIntermediateStorage::getByteSize(storage));
+
+	std::shared_ptr<IntermediateStorage> result = sharedStorage.read();
+	REQUIRE(result);
+	REQUIRE(result->getNextId() == storage.getNextId());
+
+	REQUIRE(result->getStorageNodes().size() == 1);
+	REQUIRE(result->getStorageNodes()[0].serializedName == serializedName);
+
+	REQUIRE(result->getStorageFiles().size() == 1);
+	REQUIRE(result->getStorageFiles()[0].modificationTime == "2020-01-01");
+	REQUIRE(!result->getStorageFiles()[0].complete);
+
+	REQUIRE(result->getStorageEdges().size() == 1);
+	REQUIRE(result->getStorageEdges()[0].id == edgeId);
+
+	REQUIRE(result->getStorageSourceLocations().size() == 1);
+	REQUIRE(result->getStorageSourceLocations()[0].endCol == 4);
+
+	REQUIRE(result->getStorageOccurrences().size() == 1);
+	REQUIRE(result->getStorageLocalSymbols().size() == 1);
+	REQUIRE(result->getComponentAccesses().size() == 1);
+	REQUIRE(result->getElementComponents().size() == 1);
+	REQUIRE(result->getElementComponents()[0].data == L"data");
+
+	REQUIRE(result->getErrors().size() == 1);
+	REQUIRE(result->getErrors()[0].fatal);
+
+	REQUIRE(result->getIndexingTimes().size() == 1);
+	REQUIRE(result->getIndexingTimes()[0].durationMs == 42);
+	REQUIRE(result->getIndexingTimes()[0].visitDurationMs == 12);
+	REQUIRE(result->getIndexingTimes()[0].storageByteCount == 100);
+	REQUIRE(result->getIndexingTimes()[0].garbageCollectionDurationMs == 7);
+}
+
+TEST_CASE("intermediate storage manager grows segment and reports grow events")
+{
+	MetricCounter& growCounter = MetricsRegistry::getInstance()->getCounter(
+		"sourcetrail_shared_memory_grow_events_total", "");
+	const unsigned long long growCount = growCounter.getValue();
+
+	InterprocessIntermediateStorageManager owner("test_uuid", 1, true);
+	InterprocessIntermediateStorageManager worker("test_uuid", 1, false);
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	for (size_t i = 0; i < 100000; i++)
+	{
+		storage->addNode(StorageNodeData(
+			1,
+			NameHierarchy::serializeToBinary(
+				NameHierarchy(L"node_" + std::to_wstring(i), NAME_DELIMITER_CXX))));
+	}
+
+	worker.pushIntermediateStorage(storage);
+	worker.pushIntermediateStorage(storage);
+	REQUIRE(owner.getIntermediateStorageCount() == 2);
+
+	std::shared_ptr<IntermediateStorage> result = owner.popIntermediateStorage();
+	REQUIRE(result);
+	REQUIRE(result->getStorageNodes().size() == 100000);
+	REQUIRE(growCounter.getValue() > growCount);
+	REQUIRE(owner.popIntermediateStorage());
+}
+
+TEST_CASE("indexing status keeps worker pool alive until stopped")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+	InterprocessIndexingStatusManager worker("test_uuid", 1, false);
+
+	REQUIRE(!worker.isWorkerPoolAlive());
+
+	owner.updateWorkerPoolHeartbeat();
+	REQUIRE(worker.isWorkerPoolAlive());
+
+	owner.stopWorkerPool();
+	REQUIRE(!worker.isWorkerPoolAlive());
+}
+
+TEST_CASE("indexing status counts busy processes until a crashed one is cleared")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+	InterprocessIndexingStatusManager worker("test_uuid", 1, false);
+
+	worker.setProcessBusy(1, true);
+	worker.startIndexingSourceFile(FilePath(L"a.cpp"));
+	REQUIRE(owner.getBusyProcessCount() == 1);
+
+	owner.setProcessBusy(1, false);
+	REQUIRE(owner.getBusyProcessCount() == 0);
+	REQUIRE(owner.getCrashedSourceFilePaths().size() == 1);
+
+	owner.clearIndexingStatus();
+	REQUIRE(owner.getCrashedSourceFilePaths().empty());
+	REQUIRE(owner.getCurrentlyIndexedSourceFilePaths().empty());
+}
+
+TEST_CASE("indexing status shares indexed headers of same preprocessor context")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+	InterprocessIndexingStatusManager worker("test_uuid", 1, false);
+
+	worker.addIndexedHeaderFilePaths(L"1", {FilePath(L"/a.h"), FilePath(L"/b.h")});
+	worker.addIndexedHeaderFilePaths(L"2", {FilePath(L"/c.h")});
+
+	const std::set<FilePath> filePaths = owner.getIndexedHeaderFilePaths(L"1");
+	REQUIRE(filePaths.size() == 2);
+	REQUIRE(filePaths.find(FilePath(L"/a.h")) != filePaths.end());
+	REQUIRE(filePaths.find(FilePath(L"/b.h")) != filePaths.end());
+	REQUIRE(owner.getIndexedHeaderFilePaths(L"2").size() == 1);
+	REQUIRE(owner.getIndexedHeaderFilePaths(L"3").empty());
+
+	owner.clearIndexingStatus();
+	REQUIRE(worker.getIndexedHeaderFilePaths(L"1").empty());
+}
+
+TEST_CASE("indexing status lets only the first translation unit claim an error")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+	InterprocessIndexingStatusManager worker("test_uuid", 1, false);
+
+	REQUIRE(worker.claimError("error|/a.h:1:1", FilePath(L"/a.cpp")));
+	REQUIRE(owner.claimError("error|/a.h:1:1", FilePath(L"/a.cpp")));
+	REQUIRE(!owner.claimError("error|/a.h:1:1", FilePath(L"/b.cpp")));
+	REQUIRE(owner.claimError("error|/a.h:2:1", FilePath(L"/b.cpp")));
+
+	owner.clearIndexingStatus();
+	REQUIRE(worker.claimError("error|/a.h:1:1", FilePath(L"/b.cpp")));
+}
+
+TEST_CASE("indexing status wakes waiting process when a worker finishes a file")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+
+	const size_t revision = owner.waitForStatusChange(0, 0);
+
+	std::thread workerThread([]() {
+		InterprocessIndexingStatusManager worker("test_uuid", 1, false);
+		worker.startIndexingSourceFile(FilePath(L"a.cpp"));
+		worker.finishIndexingSourceFile();
+	});
+
+	size_t newRevision = revision;
+	for (size_t i = 0; i < 100 && newRevision < revision + 2; i++)
+	{
+		newRevision = owner.waitForStatusChange(newRevision, 1000);
+	}
+	workerThread.join();
+
+	REQUIRE(newRevision == revision + 2);
+	REQUIRE(owner.getNextFinishedProcessId() == 1);
+	REQUIRE(owner.waitForStatusChange(revision, 1000) == newRevision);
+}
+
+TEST_CASE("indexing status keeps files that exceeded the memory limit until cleared")
+{
+	InterprocessIndexingStatusManager owner("test_uuid", 0, true);
+	InterprocessIndexingStatusManager worker("test_uuid", 1, false);
+
+	worker.addIsolatedSourceFilePath(FilePath(L"/a.cpp"));
+	worker.addIsolatedSourceFilePath(FilePath(L"/b.cpp"));
+	worker.addMemoryExceededSourceFilePath(FilePath(L"/b.cpp"));
+
+	REQUIRE(owner.getIsolatedSourceFilePaths().size() == 2);
+	REQUIRE(owner.getMemoryExceededSourceFilePaths().size() == 1);
+	REQUIRE(owner.getMemoryExceededSourceFilePaths().front() == FilePath(L"/b.cpp"));
+
+	owner.clearIndexingStatus();
+	REQUIRE(worker.getIsolatedSourceFilePaths().empty());
+	REQUIRE(worker.getMemoryExceededSourceFilePaths().empty());
+}
@@ -18,6 +18,7 @@
 #include "utilityString.h"
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
+#	include "CachedCompilationDatabase.h"
 #	include "IndexerCommandCxx.h"
 #	include "SourceGroupCxxCdb.h"
 #	include "SourceGroupCxxCodeblocks.h"
@@ -451,6 +452,42 @@ TEST_CASE("source group cxx cdb generates expected output")
 	applicationSettings->setFrameworkSearchPaths(storedFrameworkSearchPaths);
 }
 
+TEST_CASE("compilation database is only parsed again once its file changed")
+{
+	const FilePath cdbPath =
+		getInputDirectoryPath(L"cxx_cdb").getParentDirectory().concatenate(L"cached_cdb.json");
+	const auto writeCdb = [&cdbPath](const std::string& fileName) {
+		std::ofstream fileStream(cdbPath.str(), std::ios::out | std::ios::trunc);
+		fileStream << "[{\"directory\": \"/build\", \"command\": \"clang -Iinclude -c " << fileName
+				   << "\", \"file\": \"" << fileName << "\"}]";
+	};
+
+	writeCdb("a.cpp");
+	std::shared_ptr<const CachedCompilationDatabase> cdb = CachedCompilationDatabase::load(cdbPath);
+	std::shared_ptr<const CachedCompilationDatabase> unchangedCdb = CachedCompilationDatabase::load(
+		cdbPath);
+
+	// the size stays the same and the modification time may as well, so the hash tells them apart
+	writeCdb("b.cpp");
+	std::shared_ptr<const CachedCompilationDatabase> changedCdb = CachedCompilationDatabase::load(
+		cdbPath);
+
+	FileSystem::remove(cdbPath);
+	CachedCompilationDatabase::clearCache();
+
+	REQUIRE(cdb);
+	REQUIRE(cdb == unchangedCdb);
+	REQUIRE(1 == cdb->getCommands().size());
+	REQUIRE(
+		std::vector<std::string>({"clang", "-Iinclude", "-c", "a.cpp"}) ==
+		cdb->getCommands()[0].getCommandLine());
+	REQUIRE(L"a.cpp" == cdb->getCommands()[0].sourceFilePath.fileName());
+
+	REQUIRE(changedCdb);
+	REQUIRE(cdb != changedCdb);
+	REQUIRE(L"b.cpp" == changedCdb->getSourceFilePaths()[0].fileName());
+}
+
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 
 #if BUILD_JAVA_LANGUAGE_PACKAGE
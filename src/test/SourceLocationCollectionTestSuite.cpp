@@ -79,6 +79,25 @@ TEST_CASE("source locations have right file path line column and token id")
 	REQUIRE(L"file.c" == a->getFilePath().wstr());
 }
 
+TEST_CASE("source locations added out of order are iterated sorted with their token ids")
+{
+	SourceLocationFile file(FilePath(L"file.c"), L"c", true, true, true);
+	file.addSourceLocation(LOCATION_TOKEN, 1, {1, 2}, 5, 1, 5, 4);
+	file.addSourceLocation(LOCATION_TOKEN, 2, {3}, 2, 1, 2, 4);
+	SourceLocation* copy = file.addSourceLocationCopy(file.getSourceLocationById(2));
+
+	const std::vector<SourceLocation*>& locations = file.getSourceLocations();
+	REQUIRE(4 == locations.size());
+	REQUIRE(2 == locations[0]->getLocationId());
+	REQUIRE(2 == locations[1]->getLocationId());
+	REQUIRE(1 == locations[2]->getLocationId());
+	REQUIRE(1 == locations[3]->getLocationId());
+
+	REQUIRE(std::vector<Id>({1, 2}) == locations[2]->getTokenIds().toVector());
+	REQUIRE(std::vector<Id>({3}) == locations[0]->getTokenIds().toVector());
+	REQUIRE(locations[0] == copy);
+}
+
 TEST_CASE("finding source locations by id")
 {
 	SourceLocationCollection collection;
@@ -1,7 +1,15 @@
 #include "catch.hpp"
 
+#include <fstream>
+
 #include "FileSystem.h"
+#include "SourceLocationCollection.h"
+#include "SourceLocationFile.h"
 #include "SqliteIndexStorage.h"
+#include "SqliteIndexStoragePool.h"
+#include "SqliteStorageMigrationSql.h"
+#include "TextAccess.h"
+#include "utilityString.h"
 
 TEST_CASE("storage adds node successfully")
 {
@@ -11,7 +19,7 @@ TEST_CASE("storage adds node successfully")
 		SqliteIndexStorage storage(databasePath);
 		storage.setup();
 		storage.beginTransaction();
-		storage.addNode(StorageNodeData(0, L"a"));
+		storage.addNode(StorageNodeData(0, "a"));
 		storage.commitTransaction();
 		nodeCount = storage.getNodeCount();
 	}
@@ -28,7 +36,7 @@ TEST_CASE("storage removes node successfully")
 		SqliteIndexStorage storage(databasePath);
 		storage.setup();
 		storage.beginTransaction();
-		int nodeId = storage.addNode(StorageNodeData(0, L"a"));
+		int nodeId = storage.addNode(StorageNodeData(0, "a"));
 		storage.removeElement(nodeId);
 		storage.commitTransaction();
 		nodeCount = storage.getNodeCount();
@@ -38,6 +46,30 @@ TEST_CASE("storage removes node successfully")
 	REQUIRE(0 == nodeCount);
 }
 
+TEST_CASE("storage finds nodes by serialized names in one batch")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<StorageNode> nodes;
+	Id bNodeId = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, "a"));
+		bNodeId = storage.addNode(StorageNodeData(0, "b"));
+		storage.commitTransaction();
+
+		std::vector<std::string> serializedNames(1000, "c");
+		serializedNames.push_back("b");
+		nodes = storage.getNodesBySerializedNames(serializedNames);
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(1 == nodes.size());
+	REQUIRE(bNodeId == nodes[0].id);
+	REQUIRE("b" == nodes[0].serializedName);
+}
+
 TEST_CASE("storage adds edge successfully")
 {
 	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
@@ -46,8 +78,8 @@ TEST_CASE("storage adds edge successfully")
 		SqliteIndexStorage storage(databasePath);
 		storage.setup();
 		storage.beginTransaction();
-		int sourceNodeId = storage.addNode(StorageNodeData(0, L"a"));
-		int targetNodeId = storage.addNode(StorageNodeData(0, L"b"));
+		int sourceNodeId = storage.addNode(StorageNodeData(0, "a"));
+		int targetNodeId = storage.addNode(StorageNodeData(0, "b"));
 		storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId));
 		storage.commitTransaction();
 		edgeCount = storage.getEdgeCount();
@@ -65,8 +97,8 @@ TEST_CASE("storage removes edge successfully")
 		SqliteIndexStorage storage(databasePath);
 		storage.setup();
 		storage.beginTransaction();
-		int sourceNodeId = storage.addNode(StorageNodeData(0, L"a"));
-		int targetNodeId = storage.addNode(StorageNodeData(0, L"b"));
+		int sourceNodeId = storage.addNode(StorageNodeData(0, "a"));
+		int targetNodeId = storage.addNode(StorageNodeData(0, "b"));
 		int edgeId = storage.addEdge(StorageEdgeData(0, sourceNodeId, targetNodeId));
 		storage.removeElement(edgeId);
 		storage.commitTransaction();
@@ -76,3 +108,1141 @@ TEST_CASE("storage removes edge successfully")
 
 	REQUIRE(0 == edgeCount);
 }
+
+TEST_CASE("storage records ids of changed elements and the targets of changed edges")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> changedIds;
+	std::vector<Id> expectedIds;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		const Id aNodeId = storage.addNode(StorageNodeData(0, "a"));
+		const Id bNodeId = storage.addNode(StorageNodeData(0, "b"));
+		storage.addNode(StorageNodeData(0, "unchanged"));
+		storage.commitTransaction();
+
+		storage.beginTransaction();
+		storage.startRecordingChanges();
+		const Id cNodeId = storage.addNode(StorageNodeData(0, "c"));
+		const Id edgeId = storage.addEdge(StorageEdgeData(0, cNodeId, bNodeId));
+		storage.removeElement(aNodeId);
+		changedIds = storage.getRecordedChangedElementIds();
+		storage.stopRecordingChanges();
+		storage.commitTransaction();
+
+		expectedIds = {aNodeId, bNodeId, cNodeId, edgeId};
+	}
+	FileSystem::remove(databasePath);
+
+	std::sort(changedIds.begin(), changedIds.end());
+	std::sort(expectedIds.begin(), expectedIds.end());
+	REQUIRE(expectedIds == changedIds);
+}
+
+TEST_CASE("storage finds search names matching pattern by reference count")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<std::wstring> names;
+	bool hadSearchNames = false;
+	bool hasSearchNamesAfterClear = true;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.addSearchName(1, NodeType::NODE_CLASS, 2, L"foo::bar");
+		storage.addSearchName(2, NodeType::NODE_FUNCTION, 5, L"fbo");
+		storage.addSearchName(3, NodeType::NODE_CLASS, 7, L"baz");
+		storage.addSearchName(4, NodeType::NODE_CLASS, 9, L"FOO");
+		hadSearchNames = storage.hasSearchNames();
+
+		storage.forEachSearchName(
+			"%f%o%",
+			NodeType::NODE_CLASS | NodeType::NODE_FUNCTION,
+			10,
+			[&names](Id, int, uint32_t, std::wstring&& name) { names.push_back(name); });
+		storage.forEachSearchName(
+			"%b%", NodeType::NODE_CLASS, 1, [&names](Id, int, uint32_t, std::wstring&& name) {
+				names.push_back(name);
+			});
+
+		storage.clearSearchIndexData();
+		hasSearchNamesAfterClear = storage.hasSearchNames();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(hadSearchNames);
+	REQUIRE(!hasSearchNamesAfterClear);
+	REQUIRE(std::vector<std::wstring>({L"FOO", L"fbo", L"foo::bar", L"baz"}) == names);
+}
+
+TEST_CASE("storage removes elements located only in cleared files")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	std::vector<bool> remaining;
+	int sourceLocationCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+
+		const Id clearedFileId = storage.addNode(StorageNodeData(0, "a.h"));
+		storage.addFile(StorageFile(clearedFileId, L"a.h", L"cpp", "", true, true));
+		const Id fileId = storage.addNode(StorageNodeData(0, "b.h"));
+		storage.addFile(StorageFile(fileId, L"b.h", L"cpp", "", true, true));
+
+		const Id localNodeId = storage.addNode(StorageNodeData(0, "local"));
+		const Id sharedNodeId = storage.addNode(StorageNodeData(0, "shared"));
+		const Id targetNodeId = storage.addNode(StorageNodeData(0, "target"));
+		const Id edgeId = storage.addEdge(StorageEdgeData(0, localNodeId, sharedNodeId));
+		const Id otherEdgeId = storage.addEdge(StorageEdgeData(0, targetNodeId, sharedNodeId));
+
+		const Id clearedLocationId = storage.addSourceLocation(
+			StorageSourceLocationData(clearedFileId, 1, 1, 1, 5, 0));
+		const Id locationId = storage.addSourceLocation(
+			StorageSourceLocationData(fileId, 1, 1, 1, 5, 0));
+		for (Id elementId: {localNodeId, sharedNodeId, edgeId, fileId})
+		{
+			storage.addOccurrence(StorageOccurrence(elementId, clearedLocationId));
+		}
+		storage.addOccurrence(StorageOccurrence(sharedNodeId, locationId));
+		storage.addOccurrence(StorageOccurrence(otherEdgeId, locationId));
+
+		storage.removeElementsWithLocationInFiles({clearedFileId}, nullptr);
+
+		for (Id elementId: {localNodeId, sharedNodeId, targetNodeId, fileId, clearedFileId})
+		{
+			remaining.push_back(storage.isNode(elementId));
+		}
+		for (Id elementId: {edgeId, otherEdgeId})
+		{
+			remaining.push_back(storage.isEdge(elementId));
+		}
+		sourceLocationCount = storage.getSourceLocationCount();
+	}
+	FileSystem::remove(databasePath);
+
+	// the cleared file itself is removed by the caller
+	REQUIRE(remaining == std::vector<bool>({false, true, true, true, true, false, true}));
+	REQUIRE(sourceLocationCount == 1);
+}
+
+TEST_CASE("storage keeps fulltext search data of file for codec")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::string data;
+	std::string otherCodecData;
+	std::set<Id> fileIds;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		Id fileId = storage.addNode(StorageNodeData(0, "a"));
+		storage.addFile(StorageFile(fileId, L"a.cpp", L"cpp", "", false, true));
+		storage.addFullTextSearchIndexData(fileId, "UTF-8", std::string("\0\1\2", 3));
+		storage.commitTransaction();
+
+		data = storage.getFullTextSearchIndexDataById(fileId, "UTF-8");
+		otherCodecData = storage.getFullTextSearchIndexDataById(fileId, "UTF-16");
+		fileIds = storage.getFileIdsWithFullTextSearchIndexData("UTF-8");
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(std::string("\0\1\2", 3) == data);
+	REQUIRE(otherCodecData.empty());
+	REQUIRE(1 == fileIds.size());
+}
+
+TEST_CASE("storage keeps search index data until cleared")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::string data;
+	std::string clearedData;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setSearchIndexData("symbol", std::string("\0\1\2", 3));
+		data = storage.getSearchIndexData("symbol");
+		storage.clearSearchIndexData();
+		clearedData = storage.getSearchIndexData("symbol");
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(std::string("\0\1\2", 3) == data);
+	REQUIRE(clearedData.empty());
+}
+
+TEST_CASE("storage keeps latest indexing time of file")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<StorageIndexingTime> indexingTimes;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.addIndexingTimes({StorageIndexingTime(L"a.cpp", 10), StorageIndexingTime(L"b.cpp", 5)});
+		storage.addIndexingTimes({StorageIndexingTime(L"a.cpp", 20, 15, 5, 1024, 64, 3)});
+		indexingTimes = storage.getIndexingTimes();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(2 == indexingTimes.size());
+	for (const StorageIndexingTime& indexingTime: indexingTimes)
+	{
+		if (indexingTime.filePath == L"a.cpp")
+		{
+			REQUIRE(indexingTime.durationMs == 20);
+			REQUIRE(indexingTime.parseDurationMs == 15);
+			REQUIRE(indexingTime.visitDurationMs == 5);
+			REQUIRE(indexingTime.peakMemoryKb == 1024);
+			REQUIRE(indexingTime.storageByteCount == 64);
+			REQUIRE(indexingTime.garbageCollectionDurationMs == 3);
+		}
+		else
+		{
+			REQUIRE(indexingTime.durationMs == 5);
+		}
+	}
+}
+
+TEST_CASE("storage skips duplicate files and errors in bulk write mode")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	int fileCount = -1;
+	int errorCount = -1;
+	Id errorId = 0;
+	Id duplicateErrorId = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_BULK_WRITE);
+		storage.beginTransaction();
+		Id fileId = storage.addNode(StorageNodeData(0, "a"));
+		storage.addFile(StorageFile(fileId, L"a.cpp", L"cpp", "", false, true));
+		storage.addFile(StorageFile(fileId, L"a.cpp", L"cpp", "", false, true));
+		errorId = storage.addError(StorageErrorData(L"it's wrong", L"a.cpp", false, true)).id;
+		duplicateErrorId =
+			storage.addError(StorageErrorData(L"it's wrong", L"a.cpp", false, true)).id;
+		storage.commitTransaction();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+		fileCount = static_cast<int>(storage.getAll<StorageFile>().size());
+		errorCount = static_cast<int>(storage.getAll<StorageError>().size());
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(1 == fileCount);
+	REQUIRE(1 == errorCount);
+	REQUIRE(errorId == duplicateErrorId);
+}
+
+TEST_CASE("storage pages through filtered errors in order of all errors")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	std::vector<Id> allIds;
+	std::vector<Id> pagedIds;
+	std::vector<Id> fileIds;
+	ErrorCountInfo fatalCount;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+
+		const Id aFileId = storage.addNode(StorageNodeData(0, "a.cpp"));
+		storage.addFile(StorageFile(aFileId, L"a.cpp", L"cpp", "", true, true));
+		const Id bFileId = storage.addNode(StorageNodeData(0, "b.cpp"));
+		storage.addFile(StorageFile(bFileId, L"b.cpp", L"cpp", "", true, true));
+
+		const Id fatalId = storage.addError(StorageErrorData(L"fatal", L"a.cpp", true, true)).id;
+		const Id errorId = storage.addError(StorageErrorData(L"error", L"b.cpp", false, true)).id;
+		const Id unindexedId =
+			storage.addError(StorageErrorData(L"unindexed", L"b.cpp", true, false)).id;
+
+		for (int line: {1, 2})
+		{
+			storage.addOccurrence(StorageOccurrence(
+				fatalId,
+				storage.addSourceLocation(StorageSourceLocationData(aFileId, line, 1, line, 1, 0))));
+		}
+		storage.addOccurrence(StorageOccurrence(
+			errorId, storage.addSourceLocation(StorageSourceLocationData(bFileId, 1, 1, 1, 1, 0))));
+		storage.addOccurrence(StorageOccurrence(
+			unindexedId,
+			storage.addSourceLocation(StorageSourceLocationData(bFileId, 2, 1, 2, 1, 0))));
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+		for (const ErrorInfo& error: storage.getAllErrorInfos())
+		{
+			allIds.push_back(error.id);
+		}
+
+		ErrorFilter filter;
+		filter.limit = 2;
+		filter.offset = 1;
+		for (const ErrorInfo& error: storage.getErrorInfos(filter))
+		{
+			pagedIds.push_back(error.id);
+		}
+
+		filter.limit = 0;
+		filter.offset = 0;
+		for (const ErrorInfo& error: storage.getErrorInfos(filter, {bFileId}))
+		{
+			fileIds.push_back(error.id);
+		}
+
+		filter.error = false;
+		filter.unindexedError = false;
+		fatalCount = storage.getErrorCountInfo(filter);
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(allIds.size() == 4);
+	REQUIRE(pagedIds == std::vector<Id>({allIds[1], allIds[2]}));
+	REQUIRE(fileIds == std::vector<Id>({allIds[2], allIds[3]}));
+	REQUIRE(fatalCount.total == 3);
+	REQUIRE(fatalCount.fatal == 3);
+}
+
+TEST_CASE("storage keeps data written in wal mode after checkpoint")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	int nodeCount = -1;
+	bool walFileExists = true;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.applySettings(SqliteStorageSettings("WAL", "OFF", 1024, 16));
+		storage.setup();
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, "a"));
+		storage.commitTransaction();
+		storage.checkpoint();
+
+		walFileExists = FilePath(databasePath.wstr() + L"-wal").exists();
+		nodeCount = storage.getNodeCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(!walFileExists);
+	REQUIRE(1 == nodeCount);
+}
+
+TEST_CASE("storage gets nodes for long id lists")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> nodeIds;
+	size_t nodeCount = 0;
+	size_t repeatedNodeCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		for (int i = 0; i < 5000; i++)
+		{
+			nodeIds.push_back(storage.addNode(StorageNodeData(0, "node" + std::to_string(i))));
+		}
+		storage.commitTransaction();
+
+		nodeCount = storage.getAllByIds<StorageNode>(nodeIds).size();
+
+		storage.forEachByIds<StorageNode>({nodeIds[0], nodeIds[1]}, [&](StorageNode&& node) {
+			// nested lookups use their own id list
+			repeatedNodeCount += storage.getAllByIds<StorageNode>({node.id}).size();
+		});
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(5000 == nodeCount);
+	REQUIRE(2 == repeatedNodeCount);
+}
+
+TEST_CASE("storage gets nodes for id lists bound as parameters or filled into tables")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> nodeIds;
+	std::vector<size_t> nodeCounts;
+	size_t remainingNodeCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		for (int i = 0; i < 100; i++)
+		{
+			nodeIds.push_back(storage.addNode(StorageNodeData(0, "node" + std::to_string(i))));
+		}
+		storage.commitTransaction();
+
+		for (size_t count: {size_t(1), size_t(3), size_t(32), size_t(33), size_t(100)})
+		{
+			nodeCounts.push_back(
+				storage
+					.getAllByIds<StorageNode>(
+						std::vector<Id>(nodeIds.begin(), nodeIds.begin() + count))
+					.size());
+		}
+
+		storage.removeElements({nodeIds[0], nodeIds[1], nodeIds[2]});
+		remainingNodeCount = storage.getAllByIds<StorageNode>(nodeIds).size();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(nodeCounts == std::vector<size_t>({1, 3, 32, 33, 100}));
+	REQUIRE(97 == remainingNodeCount);
+}
+
+TEST_CASE("storage updates content hashes of file")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath filePath(L"data/SQLiteTestSuite/hashed.cpp");
+	{
+		std::ofstream fileStream(filePath.str());
+		fileStream << "int a; // old\n";
+	}
+
+	std::string contentHash;
+	std::string codeHash;
+	std::string updatedContentHash;
+	std::string updatedCodeHash;
+	std::string updatedContent;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		Id fileId = storage.addNode(StorageNodeData(0, "a"));
+		storage.addFile(StorageFile(fileId, filePath.wstr(), L"cpp", "", true, true));
+		contentHash = storage.getFileContentHash(fileId);
+		codeHash = storage.getFileCodeHash(fileId);
+
+		storage.updateFileContent(fileId, "int a; // new\n", "2020-01-01 00:00:00");
+		storage.commitTransaction();
+
+		updatedContentHash = storage.getFileContentHash(fileId);
+		updatedCodeHash = storage.getFileCodeHash(fileId);
+		updatedContent = storage.getFileContentById(fileId)->getText();
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(filePath);
+
+	REQUIRE(!contentHash.empty());
+	REQUIRE(contentHash != updatedContentHash);
+	REQUIRE(codeHash == updatedCodeHash);
+	REQUIRE("int a; // new\n" == updatedContent);
+}
+
+TEST_CASE("storage keeps changes of a transaction from other connections until committed")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	std::vector<int> readNodeCounts;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.applySettings(SqliteStorageSettings("WAL", "NORMAL", 0, 0));
+		storage.setup();
+		storage.addNode(StorageNodeData(0, "a"));
+
+		SqliteIndexStorage readingStorage(databasePath);
+		readingStorage.setup();
+
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, "b"));
+
+		// nested transactions only roll back their own changes
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, "c"));
+		storage.rollbackTransaction();
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, "d"));
+		storage.commitTransaction();
+
+		readNodeCounts.push_back(readingStorage.getNodeCount());
+		readNodeCounts.push_back(storage.getNodeCount());
+
+		storage.commitTransaction();
+		readNodeCounts.push_back(readingStorage.getNodeCount());
+		REQUIRE(!storage.isInTransaction());
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(readNodeCounts == std::vector<int>({1, 3, 3}));
+}
+
+TEST_CASE("storage compresses large file contents")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	std::string content;
+	for (int i = 0; i < 200; i++)
+	{
+		content += "int variable" + std::to_string(i) + " = " + std::to_string(i * i) + ";\n";
+	}
+
+	std::string storedContent;
+	std::string storedSmallContent;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		const Id fileId = storage.addNode(StorageNodeData(0, "a"));
+		storage.addFile(StorageFile(fileId, L"a.cpp", L"cpp", "", false, true));
+		storage.updateFileContent(fileId, content, "2020-01-01 00:00:00");
+		const Id smallFileId = storage.addNode(StorageNodeData(0, "b"));
+		storage.addFile(StorageFile(smallFileId, L"b.cpp", L"cpp", "", false, true));
+		storage.updateFileContent(smallFileId, "int b;\n", "2020-01-01 00:00:00");
+		storage.commitTransaction();
+
+		storedContent = storage.getFileContentById(fileId)->getText();
+		storedSmallContent = storage.getFileContentByPath(L"b.cpp")->getText();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(content == storedContent);
+	REQUIRE("int b;\n" == storedSmallContent);
+}
+
+TEST_CASE("storage keeps equal file contents of several files once")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	std::string contentA;
+	std::string contentC;
+	int countAfterAdd = 0;
+	int countAfterRemove = 0;
+	int countAfterCleanup = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		std::vector<Id> fileIds;
+		for (const std::wstring& path: {L"a.h", L"b.h", L"c.h"})
+		{
+			const Id fileId = storage.addNode(StorageNodeData(0, utility::encodeToUtf8(path)));
+			storage.addFile(StorageFile(fileId, path, L"cpp", "", false, true));
+			storage.updateFileContent(fileId, "int a;\n", "2020-01-01 00:00:00");
+			fileIds.push_back(fileId);
+		}
+		storage.updateFileContent(fileIds[2], "int c;\n", "2020-01-01 00:00:00");
+		countAfterAdd = storage.getFileContentCount();
+
+		storage.removeElement(fileIds[1]);
+		contentA = storage.getFileContentById(fileIds[0])->getText();
+		contentC = storage.getFileContentById(fileIds[2])->getText();
+
+		storage.removeElement(fileIds[0]);
+		countAfterRemove = storage.getFileContentCount();
+		storage.removeUnreferencedFileContents();
+		countAfterCleanup = storage.getFileContentCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(countAfterAdd == 2);
+	REQUIRE("int a;\n" == contentA);
+	REQUIRE("int c;\n" == contentC);
+	REQUIRE(countAfterRemove == 2);
+	REQUIRE(countAfterCleanup == 1);
+}
+
+TEST_CASE("storage migrates file contents of previous version to shared contents")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	std::vector<std::string> storedContents;
+	int contentCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		for (const std::wstring& path: {L"a.h", L"b.h"})
+		{
+			const Id fileId = storage.addNode(StorageNodeData(0, utility::encodeToUtf8(path)));
+			storage.addFile(StorageFile(fileId, path, L"cpp", "", false, true));
+			storage.updateFileContent(fileId, "int a;\n", "2020-01-01 00:00:00");
+		}
+		storage.setVersion(28);
+	}
+	{
+		// the previous version kept a copy of the content for each file
+		CppSQLite3DB database;
+		database.open(utility::encodeToUtf8(databasePath.wstr()).c_str());
+		database.execDML("DROP TABLE filecontent;");
+		database.execDML("DROP TABLE content;");
+		database.execDML(
+			"CREATE TABLE filecontent(id INTERGER, content TEXT, PRIMARY KEY(id), "
+			"FOREIGN KEY(id) REFERENCES file(id) ON DELETE CASCADE ON UPDATE CASCADE);");
+		database.execDML(
+			"INSERT INTO filecontent(id, content) SELECT id, 'int a;' || char(10) FROM file;");
+	}
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.migrateIfNecessary();
+		storage.setup();
+		storedContents.push_back(storage.getFileContentByPath(L"a.h")->getText());
+		storedContents.push_back(storage.getFileContentByPath(L"b.h")->getText());
+		contentCount = storage.getFileContentCount();
+		REQUIRE(!storage.isIncompatible());
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(storedContents == std::vector<std::string>({"int a;\n", "int a;\n"}));
+	REQUIRE(contentCount == 1);
+}
+
+TEST_CASE("storage migration rolls back all steps if one fails")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	size_t nodeCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.addNode(StorageNodeData(0, "a"));
+
+		SqliteStorageMigrationSql migration(L"test");
+		migration.addStatement("DELETE FROM node;")
+			.addBulkStatement("INSERT INTO missing_table VALUES(1);", {"content_hash_index"});
+		migration.apply(&storage);
+
+		nodeCount = storage.getAllByIds<StorageNode>({1}).size();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(nodeCount == 1);
+}
+
+TEST_CASE("storage injects attached database and remaps its ids")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath injectedDatabasePath(L"data/SQLiteTestSuite/injected.sqlite");
+
+	bool injected = false;
+	StorageNode nodeA;
+	StorageNode nodeB;
+	StorageEdge edge;
+	int nodeCount = -1;
+	int sourceLocationCount = -1;
+	size_t occurrenceCount = 0;
+	std::vector<StorageLocalSymbol> localSymbols;
+	{
+		SqliteIndexStorage injectedStorage(injectedDatabasePath);
+		injectedStorage.setup();
+		injectedStorage.setVersion(injectedStorage.getStaticVersion());
+		injectedStorage.beginTransaction();
+		injectedStorage.addNode(StorageNodeData(0, "c"));
+		const Id a = injectedStorage.addNode(StorageNodeData(2, "a"));
+		const Id b = injectedStorage.addNode(StorageNodeData(1, "b"));
+		const Id edgeId = injectedStorage.addEdge(StorageEdgeData(0, a, b));
+		const Id locationId =
+			injectedStorage.addSourceLocation(StorageSourceLocationData(a, 1, 1, 1, 5, 0));
+		injectedStorage.addOccurrence(StorageOccurrence(edgeId, locationId));
+		injectedStorage.addLocalSymbol(StorageLocalSymbolData(a, 3, 4));
+		injectedStorage.addLocalSymbol(StorageLocalSymbolData(b, 3, 4));
+		injectedStorage.commitTransaction();
+	}
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, "d"));
+		const Id a = storage.addNode(StorageNodeData(1, "a"));
+		storage.addLocalSymbol(StorageLocalSymbolData(a, 3, 4));
+		storage.commitTransaction();
+
+		injected = storage.injectDatabase(injectedDatabasePath);
+
+		nodeA = storage.getNodeBySerializedName("a");
+		nodeB = storage.getNodeBySerializedName("b");
+		edge = storage.getEdgeBySourceTargetType(nodeA.id, nodeB.id, 0);
+		nodeCount = storage.getNodeCount();
+		sourceLocationCount = storage.getSourceLocationCount();
+		occurrenceCount = storage.getOccurrencesForElementIds({edge.id}).size();
+		localSymbols = storage.getAll<StorageLocalSymbol>();
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(injectedDatabasePath);
+
+	REQUIRE(injected);
+	REQUIRE(4 == nodeCount);
+	REQUIRE(2 == nodeA.type);
+	REQUIRE(nodeB.id != 0);
+	REQUIRE(edge.id != 0);
+	REQUIRE(1 == sourceLocationCount);
+	REQUIRE(1 == occurrenceCount);
+	REQUIRE(2 == localSymbols.size());
+	REQUIRE(nodeA.id == localSymbols[0].fileNodeId);
+	REQUIRE(nodeB.id == localSymbols[1].fileNodeId);
+}
+
+TEST_CASE("storage gives the same stable ids to the same data added in any order")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+
+	auto addAndCanonicalize = [&databasePath](bool reversed) {
+		std::vector<std::pair<std::string, Id>> ids;
+
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.beginTransaction();
+		storage.addNode(StorageNodeData(0, reversed ? "c" : "d"));
+		const Id a = storage.addNode(StorageNodeData(0, reversed ? "b" : "a"));
+		const Id b = storage.addNode(StorageNodeData(0, reversed ? "a" : "b"));
+		storage.addNode(StorageNodeData(0, reversed ? "d" : "c"));
+		const Id edgeId = reversed ? storage.addEdge(StorageEdgeData(0, b, a))
+								   : storage.addEdge(StorageEdgeData(0, a, b));
+		const Id locationId = storage.addSourceLocation(
+			StorageSourceLocationData(reversed ? b : a, 1, 1, 1, 5, 0));
+		storage.addOccurrence(StorageOccurrence(edgeId, locationId));
+		storage.addLocalSymbol(StorageLocalSymbolData(reversed ? b : a, 3, 4));
+		storage.commitTransaction();
+
+		storage.canonicalizeIds();
+
+		for (const std::string& name: {"a", "b", "c", "d"})
+		{
+			ids.emplace_back(name, storage.getNodeBySerializedName(name).id);
+		}
+		const StorageEdge edge = storage.getEdgeBySourceTargetType(ids[0].second, ids[1].second, 0);
+		ids.emplace_back("edge", edge.id);
+		for (const StorageOccurrence& occurrence: storage.getOccurrencesForElementIds({edge.id}))
+		{
+			ids.emplace_back("location", occurrence.sourceLocationId);
+		}
+		for (const StorageLocalSymbol& localSymbol: storage.getAll<StorageLocalSymbol>())
+		{
+			ids.emplace_back("local symbol", localSymbol.id);
+			ids.emplace_back("local symbol file", localSymbol.fileNodeId);
+		}
+		return ids;
+	};
+
+	const std::vector<std::pair<std::string, Id>> ids = addAndCanonicalize(false);
+	FileSystem::remove(databasePath);
+	const std::vector<std::pair<std::string, Id>> reversedIds = addAndCanonicalize(true);
+	FileSystem::remove(databasePath);
+
+	REQUIRE(8 == ids.size());
+	REQUIRE(ids == reversedIds);
+	REQUIRE(ids[0].second != 0);
+	REQUIRE(ids[4].second != 0);
+	REQUIRE(ids[0].second == ids[7].second);
+}
+
+TEST_CASE("storage does not inject attached database of other version")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath injectedDatabasePath(L"data/SQLiteTestSuite/injected.sqlite");
+
+	bool injected = true;
+	int nodeCount = -1;
+	{
+		SqliteIndexStorage injectedStorage(injectedDatabasePath);
+		injectedStorage.setup();
+		injectedStorage.setVersion(injectedStorage.getStaticVersion() - 1);
+		injectedStorage.addNode(StorageNodeData(0, "a"));
+	}
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		injected = storage.injectDatabase(injectedDatabasePath);
+		nodeCount = storage.getNodeCount();
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(injectedDatabasePath);
+
+	REQUIRE(!injected);
+	REQUIRE(0 == nodeCount);
+}
+
+TEST_CASE("storage pool reads committed data on up to the maximum count of connections")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	int nodeCountA = -1;
+	int nodeCountB = -1;
+	bool thirdAcquired = true;
+	size_t connectionCount = 0;
+	size_t connectionCountAfterClear = 1;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.applySettings(SqliteStorageSettings("WAL", "NORMAL", 0, 0));
+		storage.setup();
+
+		SqliteIndexStoragePool pool(databasePath, 2, SqliteStorageSettings("WAL", "NORMAL", 0, 0));
+		{
+			SqliteIndexStoragePool::ScopedStorage storageA = pool.acquire();
+			storage.beginTransaction();
+			storage.addNode(StorageNodeData(0, "a"));
+			storage.commitTransaction();
+
+			SqliteIndexStoragePool::ScopedStorage storageB = pool.acquire();
+			thirdAcquired = bool(pool.acquire());
+
+			nodeCountA = storageA ? storageA->getNodeCount() : -1;
+			nodeCountB = storageB ? storageB->getNodeCount() : -1;
+			connectionCount = pool.getConnectionCount();
+		}
+		pool.clear();
+		connectionCountAfterClear = pool.getConnectionCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(1 == nodeCountA);
+	REQUIRE(1 == nodeCountB);
+	REQUIRE(!thirdAcquired);
+	REQUIRE(2 == connectionCount);
+	REQUIRE(0 == connectionCountAfterClear);
+}
+
+TEST_CASE("storage keeps snapshot stamp until it is written to")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/snapshotTest.sqlite");
+	std::string stampAfterRead;
+	std::string stampAfterWrite;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setSnapshotStamp("snapshot");
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		stampAfterRead = storage.getSnapshotStamp();
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		stampAfterWrite = storage.getSnapshotStamp();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE("snapshot" == stampAfterRead);
+	REQUIRE(stampAfterWrite.empty());
+}
+
+TEST_CASE("storage keeps revisions and cleared files of index delta")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/deltaTest.sqlite");
+	std::string revision;
+	std::string baseRevision;
+	std::vector<FilePath> clearedFilePaths;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setRevision("b");
+		storage.setDeltaBaseRevision("a");
+		storage.setDeltaClearedFilePaths({FilePath(L"/src/a.cpp"), FilePath(L"/src/b.h")});
+
+		revision = storage.getRevision();
+		baseRevision = storage.getDeltaBaseRevision();
+		clearedFilePaths = storage.getDeltaClearedFilePaths();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE("b" == revision);
+	REQUIRE("a" == baseRevision);
+	REQUIRE(2 == clearedFilePaths.size());
+	REQUIRE(L"/src/a.cpp" == clearedFilePaths[0].wstr());
+	REQUIRE(L"/src/b.h" == clearedFilePaths[1].wstr());
+}
+
+TEST_CASE("storage reads packed source locations of file in read mode")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/packTest.sqlite");
+	size_t locationCount = 0;
+	size_t locationCountInLines = 0;
+	std::vector<StorageSourceLocation> locations;
+	std::vector<StorageSourceLocation> movedLocations;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+
+		const Id fileId = storage.addNode(StorageNodeData(0, "a.h"));
+		storage.addFile(StorageFile(fileId, L"a.h", L"cpp", "", true, true));
+		const Id otherFileId = storage.addNode(StorageNodeData(0, "b.h"));
+		storage.addFile(StorageFile(otherFileId, L"b.h", L"cpp", "", true, true));
+
+		const Id lastLocationId = storage.addSourceLocation(
+			StorageSourceLocationData(fileId, 300, 2, 310, 1, 1));
+		storage.addSourceLocation(StorageSourceLocationData(fileId, 3, 20, 3, 25, 0));
+		storage.addSourceLocation(StorageSourceLocationData(otherFileId, 1, 1, 1, 5, 0));
+		storage.addSourceLocation(StorageSourceLocationData(fileId, 3, 4, 3, 9, 0));
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		locationCount =
+			storage.getSourceLocationsForFile(FilePath(L"a.h"))->getSourceLocationCount();
+		locationCountInLines = storage.getSourceLocationsForLinesInFile(FilePath(L"a.h"), 1, 10)
+								   ->getSourceLocationCount();
+		locations = storage.getSourceLocationsByFileId(fileId);
+
+		storage.updateSourceLocationPositions(
+			{StorageSourceLocation(lastLocationId, fileId, 301, 2, 311, 1, 1)});
+		movedLocations = storage.getSourceLocationsByFileId(fileId);
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(3 == locationCount);
+	REQUIRE(2 == locationCountInLines);
+	REQUIRE(3 == locations.size());
+	REQUIRE(3 == locations[0].startLine);
+	REQUIRE(4 == locations[0].startCol);
+	REQUIRE(9 == locations[0].endCol);
+	REQUIRE(20 == locations[1].startCol);
+	REQUIRE(300 == locations[2].startLine);
+	REQUIRE(310 == locations[2].endLine);
+	REQUIRE(1 == locations[2].type);
+	REQUIRE(301 == movedLocations[2].startLine);
+	REQUIRE(311 == movedLocations[2].endLine);
+}
+
+TEST_CASE("storage keeps stats and available types of read mode in meta table")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/aggregateTest.sqlite");
+	StorageStats stats;
+	StorageStats statsAfterContentUpdate;
+	StorageStats statsInWriteMode;
+	std::vector<int> nodeTypes;
+	std::vector<int> edgeTypes;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+
+		const Id fileId = storage.addNode(StorageNodeData(4, "a.h"));
+		storage.addFile(StorageFile(fileId, L"a.h", L"cpp", "", true, true));
+		storage.updateFileContent(fileId, "int a;\n", "2020-01-01 00:00:00");
+		const Id nodeId = storage.addNode(StorageNodeData(2, "a"));
+		storage.addEdge(StorageEdgeData(8, fileId, nodeId));
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		stats = storage.getStorageStats();
+		nodeTypes = storage.getAvailableNodeTypes();
+		edgeTypes = storage.getAvailableEdgeTypes();
+
+		storage.updateFileContent(fileId, "int a;\nint b;\nint c;\n", "2020-01-02 00:00:00");
+		statsAfterContentUpdate = storage.getStorageStats();
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.addNode(StorageNodeData(2, "b"));
+		statsInWriteMode = storage.getStorageStats();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(2 == stats.nodeCount);
+	REQUIRE(1 == stats.edgeCount);
+	REQUIRE(1 == stats.fileCount);
+	REQUIRE(1 == stats.completedFileCount);
+	REQUIRE(1 == stats.fileLOCCount);
+	REQUIRE(2 == nodeTypes.size());
+	REQUIRE(edgeTypes == std::vector<int>({8}));
+	REQUIRE(3 == statsAfterContentUpdate.fileLOCCount);
+	REQUIRE(2 == statsAfterContentUpdate.nodeCount);
+	REQUIRE(3 == statsInWriteMode.nodeCount);
+}
+
+TEST_CASE("storage pool connections query lists of ids")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/poolIdTest.sqlite");
+	std::vector<StorageNode> nodes;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.applySettings(SqliteStorageSettings("WAL", "NORMAL", 0, 0));
+		storage.setup();
+		const Id nodeId = storage.addNode(StorageNodeData(0, "a"));
+		storage.addNode(StorageNodeData(0, "b"));
+
+		SqliteIndexStoragePool pool(databasePath, 1, SqliteStorageSettings("WAL", "NORMAL", 0, 0));
+		SqliteIndexStoragePool::ScopedStorage pooledStorage = pool.acquire();
+		nodes = pooledStorage->getAllByIds<StorageNode>({nodeId});
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(1 == nodes.size());
+	REQUIRE("a" == nodes[0].serializedName);
+}
+
+TEST_CASE("storage reads typed columns of rows")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<std::pair<Id, int>> nodeTypes;
+	std::vector<std::string> names;
+	std::vector<Id> idsOfList;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		const Id nodeIdA = storage.addNode(StorageNodeData(2, "a"));
+		const Id nodeIdB = storage.addNode(StorageNodeData(4, ""));
+
+		storage.forEachRow<Id, int>(
+			"SELECT id, type FROM node ORDER BY id;",
+			[&nodeTypes](Id id, int type) { nodeTypes.emplace_back(id, type); });
+		storage.forEachRow<SqliteIndexStorage::ColumnText>(
+			"SELECT serialized_name FROM node ORDER BY id;",
+			[&names](const SqliteIndexStorage::ColumnText& name) { names.push_back(name.str()); });
+		storage.forEachRowByIds<Id>(
+			{nodeIdB}, "SELECT id FROM node WHERE id IN", [&idsOfList](Id id) {
+				idsOfList.push_back(id);
+			});
+
+		REQUIRE(nodeTypes == std::vector<std::pair<Id, int>>({{nodeIdA, 2}, {nodeIdB, 4}}));
+		REQUIRE(idsOfList == std::vector<Id>({nodeIdB}));
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(names == std::vector<std::string>({"a", ""}));
+}
+
+TEST_CASE("storage analyzes and releases free pages in steps")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	bool hadStatistics = true;
+	bool hasStatistics = false;
+	bool hasStatisticsAfterIndexing = true;
+	size_t freePageCount = 0;
+	size_t freePageCountAfterVacuum = 1;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		REQUIRE(storage.hasIncrementalVacuum());
+
+		storage.beginTransaction();
+		for (size_t i = 0; i < 2000; i++)
+		{
+			storage.addNode(StorageNodeData(2, "node_with_a_long_name_" + std::to_string(i)));
+		}
+		storage.commitTransaction();
+
+		hadStatistics = storage.hasCurrentStatistics();
+		REQUIRE(storage.analyze());
+		hasStatistics = storage.hasCurrentStatistics();
+		storage.setTime();
+		hasStatisticsAfterIndexing = storage.hasCurrentStatistics();
+
+		storage.clear();
+		freePageCount = storage.getFreePageCount();
+		while (storage.getFreePageCount() > 0 && storage.incrementalVacuum(4))
+		{
+		}
+		freePageCountAfterVacuum = storage.getFreePageCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(!hadStatistics);
+	REQUIRE(hasStatistics);
+	REQUIRE(!hasStatisticsAfterIndexing);
+	REQUIRE(freePageCount > 0);
+	REQUIRE(freePageCountAfterVacuum == 0);
+}
+
+TEST_CASE("storage keeps file of scope location of each node in read mode")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	bool foundInWriteMode = true;
+	std::map<Id, Id> fileNodeIds;
+	Id fileIdA = 0;
+	Id fileIdB = 0;
+	Id declaredNodeId = 0;
+	Id definedNodeId = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		fileIdA = storage.addNode(StorageNodeData(0, "a.h"));
+		storage.addFile(StorageFile(fileIdA, L"a.h", L"cpp", "", false, true));
+		fileIdB = storage.addNode(StorageNodeData(0, "b.cpp"));
+		storage.addFile(StorageFile(fileIdB, L"b.cpp", L"cpp", "", false, true));
+
+		declaredNodeId = storage.addNode(StorageNodeData(2, "declared"));
+		definedNodeId = storage.addNode(StorageNodeData(2, "defined"));
+		const Id tokenId = storage.addSourceLocation(StorageSourceLocationData(
+			fileIdA, 1, 1, 1, 5, locationTypeToInt(LOCATION_TOKEN)));
+		const Id scopeId = storage.addSourceLocation(StorageSourceLocationData(
+			fileIdB, 1, 1, 3, 1, locationTypeToInt(LOCATION_SCOPE)));
+		storage.addOccurrence(StorageOccurrence(declaredNodeId, tokenId));
+		storage.addOccurrence(StorageOccurrence(definedNodeId, tokenId));
+		storage.addOccurrence(StorageOccurrence(definedNodeId, scopeId));
+
+		foundInWriteMode = storage.getFileNodeIdsOfNodes({declaredNodeId}, &fileNodeIds);
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		storage.getFileNodeIdsOfNodes({declaredNodeId, definedNodeId, fileIdA}, &fileNodeIds);
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(!foundInWriteMode);
+	REQUIRE(fileNodeIds == std::map<Id, Id>({{declaredNodeId, fileIdA}, {definedNodeId, fileIdB}}));
+}
+
+TEST_CASE("storage pages source locations of elements in order of file paths")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	size_t fileCount = 0;
+	size_t referenceCount = 0;
+	std::vector<std::vector<FilePath>> pagePaths;
+	std::vector<size_t> pageLocationCounts;
+	size_t sharedLocationTokenIdCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+
+		const Id nodeId = storage.addNode(StorageNodeData(2, "node"));
+		const Id edgeId = storage.addNode(StorageNodeData(0, "edge"));
+		const Id otherNodeId = storage.addNode(StorageNodeData(2, "other"));
+
+		Id sharedLocationId = 0;
+		for (const std::wstring& path: {L"c.cpp", L"a.h", L"d.cpp", L"b.cpp", L"e.cpp"})
+		{
+			const Id fileId = storage.addNode(StorageNodeData(0, utility::encodeToUtf8(path)));
+			storage.addFile(StorageFile(fileId, path, L"cpp", "", true, true));
+
+			const Id tokenId = storage.addSourceLocation(StorageSourceLocationData(
+				fileId, 2, 1, 2, 5, locationTypeToInt(LOCATION_TOKEN)));
+			storage.addOccurrence(StorageOccurrence(edgeId, tokenId));
+
+			if (path == L"a.h")
+			{
+				const Id scopeId = storage.addSourceLocation(StorageSourceLocationData(
+					fileId, 1, 1, 3, 1, locationTypeToInt(LOCATION_SCOPE)));
+				storage.addOccurrence(StorageOccurrence(nodeId, scopeId));
+				storage.addOccurrence(StorageOccurrence(nodeId, tokenId));
+				sharedLocationId = tokenId;
+
+				const Id commentId = storage.addSourceLocation(StorageSourceLocationData(
+					fileId, 5, 1, 5, 9, locationTypeToInt(LOCATION_COMMENT)));
+				storage.addOccurrence(StorageOccurrence(nodeId, commentId));
+			}
+			else if (path == L"e.cpp")
+			{
+				storage.addOccurrence(StorageOccurrence(otherNodeId, tokenId));
+			}
+		}
+
+		fileCount =
+			storage.getSourceLocationFileCountForElementIds({nodeId, edgeId}, &referenceCount);
+
+		FilePath cursor;
+		for (size_t i = 0; i < 3; i++)
+		{
+			std::shared_ptr<SourceLocationCollection> page =
+				storage.getSourceLocationsPageForElementIds({nodeId, edgeId}, &cursor, 2);
+
+			std::vector<FilePath> paths;
+			page->forEachSourceLocationFile(
+				[&paths](std::shared_ptr<SourceLocationFile> file) {
+					paths.push_back(file->getFilePath());
+				});
+			pagePaths.push_back(paths);
+			pageLocationCounts.push_back(page->getSourceLocationCount());
+
+			if (i == 0)
+			{
+				sharedLocationTokenIdCount =
+					page->getSourceLocationById(sharedLocationId)->getTokenIds().size();
+			}
+		}
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(5 == fileCount);
+	REQUIRE(6 == referenceCount);
+
+	REQUIRE(3 == pagePaths.size());
+	REQUIRE(pagePaths[0] == std::vector<FilePath>({FilePath(L"a.h"), FilePath(L"b.cpp")}));
+	REQUIRE(pagePaths[1] == std::vector<FilePath>({FilePath(L"c.cpp"), FilePath(L"d.cpp")}));
+	REQUIRE(pagePaths[2] == std::vector<FilePath>({FilePath(L"e.cpp")}));
+	REQUIRE(3 == pageLocationCounts[0]);
+	REQUIRE(1 == pageLocationCounts[2]);
+	REQUIRE(2 == sharedLocationTokenIdCount);
+}
@@ -0,0 +1,69 @@
+#include "catch.hpp"
+
+#include "SqliteQueryProfile.h"
+
+TEST_CASE("sqlite query profile normalizes literals and parameters")
+{
+	REQUIRE(
+		"SELECT * FROM node WHERE id = ? AND name = ?" ==
+		SqliteQueryProfile::normalizeSql("SELECT *  FROM node\n\tWHERE id = 12 AND name = 'it''s'"));
+	REQUIRE(
+		"SELECT * FROM node WHERE id = ?" ==
+		SqliteQueryProfile::normalizeSql("SELECT * FROM node WHERE id = :id"));
+	REQUIRE(
+		"SELECT * FROM node WHERE id IN (?)" ==
+		SqliteQueryProfile::normalizeSql("SELECT * FROM node WHERE id IN (1, 2, 3)"));
+	REQUIRE(
+		"INSERT INTO edge VALUES (?)" ==
+		SqliteQueryProfile::normalizeSql("INSERT INTO edge VALUES (?, ?), (?, ?), (?, ?)"));
+}
+
+TEST_CASE("sqlite query profile keeps identifiers containing digits")
+{
+	REQUIRE(
+		"SELECT * FROM table2 WHERE id = ?" ==
+		SqliteQueryProfile::normalizeSql("SELECT * FROM table2 WHERE id = 5"));
+}
+
+TEST_CASE("sqlite query profile groups executions of the same statement")
+{
+	SqliteQueryProfile profile;
+	profile.setSlowThresholdMs(10);
+
+	REQUIRE(!profile.addExecution("DELETE FROM node WHERE id = 1", 2000, 1));
+	REQUIRE(!profile.addExecution("DELETE FROM node WHERE id = 2", 4000, 0));
+	REQUIRE(!profile.addExecution("SELECT * FROM edge", 1000, 0));
+
+	const std::vector<SqliteQueryProfile::Entry> entries = profile.getEntries();
+	REQUIRE(2 == entries.size());
+	REQUIRE("DELETE FROM node WHERE id = ?" == entries[0].sql);
+	REQUIRE(2 == entries[0].count);
+	REQUIRE(6000 == entries[0].totalDuration);
+	REQUIRE(4000 == entries[0].maxDuration);
+	REQUIRE(1 == entries[0].rowCount);
+	REQUIRE(0 == entries[0].slowCount);
+}
+
+TEST_CASE("sqlite query profile asks for the plan of a slow statement once")
+{
+	SqliteQueryProfile profile;
+	profile.setSlowThresholdMs(10);
+
+	REQUIRE(profile.addExecution("SELECT * FROM node WHERE id = 1", 20000, 0));
+	REQUIRE(profile.addExecution("SELECT * FROM node WHERE id = 2", 30000, 0));
+
+	profile.setPlan("SELECT * FROM node WHERE id = 3", "SCAN TABLE node\n");
+	REQUIRE(!profile.addExecution("SELECT * FROM node WHERE id = 4", 40000, 0));
+
+	const std::vector<SqliteQueryProfile::Entry> entries = profile.getEntries();
+	REQUIRE(1 == entries.size());
+	REQUIRE(3 == entries[0].slowCount);
+	REQUIRE("SCAN TABLE node\n" == entries[0].plan);
+
+	const std::string report = profile.getReport();
+	REQUIRE(report.find("SELECT * FROM node WHERE id = ?") != std::string::npos);
+	REQUIRE(report.find("\tplan: SCAN TABLE node\n") != std::string::npos);
+
+	profile.clear();
+	REQUIRE(profile.getEntries().empty());
+}
@@ -0,0 +1,44 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include "StartupProfile.h"
+
+TEST_CASE("startup profile records the phases in order until it is finished")
+{
+	StartupProfile profile;
+	profile.finishPhase("settings");
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	profile.finishPhase("views");
+	REQUIRE(!profile.isFinished());
+
+	profile.finish("first paint");
+	profile.finishPhase("ignored");
+	profile.finish("ignored");
+	REQUIRE(profile.isFinished());
+
+	const std::vector<StartupProfile::Phase> phases = profile.getPhases();
+	REQUIRE(phases.size() == 3);
+	REQUIRE(phases[0].name == "settings");
+	REQUIRE(phases[1].name == "views");
+	REQUIRE(phases[1].duration >= 2000);
+	REQUIRE(phases[2].name == "first paint");
+	REQUIRE(
+		profile.getTotalDuration() == phases[0].duration + phases[1].duration + phases[2].duration);
+}
+
+TEST_CASE("startup profile drops the recorded phases when started again")
+{
+	StartupProfile profile;
+	profile.finish("first paint");
+
+	profile.start();
+	REQUIRE(!profile.isFinished());
+	REQUIRE(profile.getPhases().empty());
+	REQUIRE(profile.getTotalDuration() == 0);
+
+	profile.finishPhase("settings");
+	REQUIRE(profile.getPhases().size() == 1);
+	REQUIRE(profile.getReport().find("  settings: ") != std::string::npos);
+}
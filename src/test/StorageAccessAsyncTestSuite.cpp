@@ -0,0 +1,53 @@
+#include "catch.hpp"
+
+#include "Graph.h"
+#include "IntermediateStorage.h"
+#include "PersistentStorage.h"
+#include "StorageAccessAsync.h"
+
+namespace
+{
+std::shared_ptr<PersistentStorage> createStorage(const NameHierarchy& nameHierarchy, Id* nodeId)
+{
+	std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+		FilePath(L"data/StorageAccessAsyncTestSuite.sqlite"),
+		FilePath(L"data/StorageAccessAsyncTestSuiteBookmarks.sqlite"));
+	storage->clear();
+
+	IntermediateStorage intermediateStorage;
+	intermediateStorage.addNode(StorageNodeData(
+		NodeType::typeToInt(NodeType::NODE_CLASS), NameHierarchy::serializeToBinary(nameHierarchy)));
+	storage->inject(&intermediateStorage);
+	*nodeId = storage->getNodeIdForNameHierarchy(nameHierarchy);
+	storage->buildCaches();
+	return storage;
+}
+}	 // namespace
+
+TEST_CASE("storage access async answers like the storage")
+{
+	NameHierarchy nameHierarchy(NAME_DELIMITER_CXX);
+	nameHierarchy.push(L"Foo");
+
+	Id nodeId = 0;
+	std::shared_ptr<PersistentStorage> storage = createStorage(nameHierarchy, &nodeId);
+	const StorageAccessAsync storageAccessAsync(storage.get());
+
+	std::future<Id> nodeIdFuture = storageAccessAsync.getNodeIdForNameHierarchy(nameHierarchy);
+	std::future<std::vector<SearchMatch>> matchesFuture =
+		storageAccessAsync.getSearchMatchesForTokenIds({nodeId});
+	std::future<StorageAccessAsync::GraphResult> graphFuture =
+		storageAccessAsync.getGraphForActiveTokenIds({nodeId}, {});
+
+	REQUIRE(nodeId != 0);
+	REQUIRE(nodeId == nodeIdFuture.get());
+
+	const std::vector<SearchMatch> matches = matchesFuture.get();
+	REQUIRE(1 == matches.size());
+	REQUIRE(L"Foo" == matches[0].name);
+
+	const StorageAccessAsync::GraphResult graphResult = graphFuture.get();
+	REQUIRE(graphResult.graph);
+	REQUIRE(graphResult.graph->getNodeById(nodeId));
+	REQUIRE(!graphResult.isActiveNamespace);
+}
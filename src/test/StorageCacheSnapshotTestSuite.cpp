@@ -0,0 +1,102 @@
+#include "catch.hpp"
+
+#include <fstream>
+
+#include "FileSystem.h"
+#include "StorageCacheSnapshot.h"
+
+TEST_CASE("storage cache snapshot loads saved data for the same database stamp")
+{
+	const FilePath snapshotPath(L"data/SQLiteTestSuite/snapshotTest.srctrlcache");
+
+	StorageCacheSnapshot snapshot;
+	snapshot.addFile(
+		3,
+		L"/src/main.cpp",
+		L"cpp",
+		StorageCacheSnapshot::FILE_COMPLETE | StorageCacheSnapshot::FILE_INDEXED);
+	snapshot.addFile(5, L"/src/info.h", L"", 0);
+	snapshot.symbolDefinitionKinds.push_back({7, 2});
+	snapshot.memberEdgeIdOrder.push_back({11, 13});
+	snapshot.hierarchyEdges.push_back({17, 7, 19, StorageCacheSnapshot::EDGE_SOURCE_VISIBLE});
+	snapshot.adjacencyCacheData = std::string("a\0b", 3);
+	REQUIRE(snapshot.save(snapshotPath, "stamp"));
+
+	StorageCacheSnapshot loadedSnapshot;
+	REQUIRE(!loadedSnapshot.load(snapshotPath, "other stamp"));
+	REQUIRE(loadedSnapshot.load(snapshotPath, "stamp"));
+	FileSystem::remove(snapshotPath);
+
+	REQUIRE(2 == loadedSnapshot.files.size());
+	const StorageCacheSnapshot::File& file = loadedSnapshot.files[0];
+	REQUIRE(3 == file.id);
+	REQUIRE(L"/src/main.cpp" == loadedSnapshot.getText(file.pathBegin, file.pathLength));
+	REQUIRE(L"cpp" == loadedSnapshot.getText(file.languageBegin, file.languageLength));
+	REQUIRE(
+		(StorageCacheSnapshot::FILE_COMPLETE | StorageCacheSnapshot::FILE_INDEXED) == file.flags);
+	REQUIRE(0 == loadedSnapshot.files[1].languageLength);
+
+	REQUIRE(1 == loadedSnapshot.symbolDefinitionKinds.size());
+	REQUIRE(2 == loadedSnapshot.symbolDefinitionKinds[0].value);
+	REQUIRE(1 == loadedSnapshot.memberEdgeIdOrder.size());
+	REQUIRE(13 == loadedSnapshot.memberEdgeIdOrder[0].value);
+	REQUIRE(1 == loadedSnapshot.hierarchyEdges.size());
+	REQUIRE(19 == loadedSnapshot.hierarchyEdges[0].targetId);
+	REQUIRE(StorageCacheSnapshot::EDGE_SOURCE_VISIBLE == loadedSnapshot.hierarchyEdges[0].flags);
+	REQUIRE(std::string("a\0b", 3) == loadedSnapshot.adjacencyCacheData);
+}
+
+TEST_CASE("storage cache snapshot database stamp changes with the database")
+{
+	const FilePath dbPath(L"data/SQLiteTestSuite/snapshotTest.sqlite");
+	FileSystem::remove(dbPath);
+
+	const std::string missingStamp = StorageCacheSnapshot::getDatabaseStamp(dbPath);
+	{
+		std::ofstream fileStream(dbPath.str(), std::ios::out | std::ios::binary);
+		fileStream << "data";
+	}
+	const std::string stamp = StorageCacheSnapshot::getDatabaseStamp(dbPath);
+	{
+		std::ofstream fileStream(dbPath.str(), std::ios::out | std::ios::binary | std::ios::app);
+		fileStream << "more data";
+	}
+	const std::string changedStamp = StorageCacheSnapshot::getDatabaseStamp(dbPath);
+	FileSystem::remove(dbPath);
+
+	REQUIRE(missingStamp != stamp);
+	REQUIRE(stamp != changedStamp);
+}
+
+TEST_CASE("storage cache snapshot replaces a saved snapshot without leaving temporary files")
+{
+	const FilePath directoryPath(L"data/SQLiteTestSuite/snapshotShared");
+	FileSystem::createDirectory(directoryPath);
+
+	const FilePath snapshotPath = StorageCacheSnapshot::getSharedFilePath(
+		directoryPath, FilePath(L"data/project.srctrlcache"));
+	REQUIRE(directoryPath.getConcatenated(L"project").wstr().size() < snapshotPath.wstr().size());
+	REQUIRE(L".srctrlcache" == snapshotPath.extension());
+	REQUIRE(
+		snapshotPath !=
+		StorageCacheSnapshot::getSharedFilePath(
+			directoryPath, FilePath(L"data/other/project.srctrlcache")));
+
+	StorageCacheSnapshot snapshot;
+	snapshot.addFile(3, L"/src/main.cpp", L"cpp", 0);
+	REQUIRE(snapshot.save(snapshotPath, "stamp"));
+	snapshot.addFile(5, L"/src/info.h", L"", 0);
+	REQUIRE(snapshot.save(snapshotPath, "stamp"));
+
+	// recently used snapshots are kept
+	StorageCacheSnapshot::removeUnusedSharedFiles(directoryPath, L".srctrlcache");
+	const std::vector<FilePath> filePaths = FileSystem::getFilePathsFromDirectory(directoryPath);
+
+	StorageCacheSnapshot loadedSnapshot;
+	REQUIRE(loadedSnapshot.load(snapshotPath, "stamp"));
+	FileSystem::remove(snapshotPath);
+	FileSystem::remove(directoryPath);
+
+	REQUIRE(1 == filePaths.size());
+	REQUIRE(2 == loadedSnapshot.files.size());
+}
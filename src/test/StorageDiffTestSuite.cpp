@@ -0,0 +1,84 @@
+#include "catch.hpp"
+
+#include <set>
+
+#include "FileSystem.h"
+#include "NodeType.h"
+#include "SqliteIndexStorage.h"
+#include "StorageDiff.h"
+
+namespace
+{
+// the nodes are added in an order that differs from the one of their names, so ids differ as well
+void fillStorage(SqliteIndexStorage* storage, bool isNew)
+{
+	const int classType = NodeType::typeToInt(NodeType::NODE_CLASS);
+	const int functionType = NodeType::typeToInt(NodeType::NODE_FUNCTION);
+	const int callType = Edge::typeToInt(Edge::EDGE_CALL);
+	const int usageType = Edge::typeToInt(Edge::EDGE_USAGE);
+
+	storage->setup();
+	storage->beginTransaction();
+	if (isNew)
+	{
+		const Id dId = storage->addNode(StorageNodeData(functionType, "d"));
+		const Id cId = storage->addNode(StorageNodeData(classType, "c"));
+		const Id aId = storage->addNode(StorageNodeData(functionType, "a"));
+		storage->addSymbol(StorageSymbol(aId, definitionKindToInt(DEFINITION_EXPLICIT)));
+		storage->addEdge(StorageEdgeData(callType, aId, cId));
+		storage->addEdge(StorageEdgeData(usageType, aId, dId));
+	}
+	else
+	{
+		const Id aId = storage->addNode(StorageNodeData(functionType, "a"));
+		const Id bId = storage->addNode(StorageNodeData(functionType, "b"));
+		const Id cId = storage->addNode(StorageNodeData(functionType, "c"));
+		storage->addSymbol(StorageSymbol(aId, definitionKindToInt(DEFINITION_EXPLICIT)));
+		storage->addEdge(StorageEdgeData(callType, aId, bId));
+		storage->addEdge(StorageEdgeData(callType, aId, cId));
+	}
+	storage->commitTransaction();
+}
+}	 // namespace
+
+TEST_CASE("storage diff compares nodes and edges by their names")
+{
+	const FilePath oldDbPath(L"data/StorageDiffTestSuiteOld.sqlite");
+	const FilePath newDbPath(L"data/StorageDiffTestSuiteNew.sqlite");
+
+	std::set<std::string> nodeChanges;
+	std::set<std::string> edgeChanges;
+	{
+		SqliteIndexStorage oldStorage(oldDbPath);
+		SqliteIndexStorage newStorage(newDbPath);
+		fillStorage(&oldStorage, false);
+		fillStorage(&newStorage, true);
+
+		const StorageDiff diff(&oldStorage, &newStorage);
+		diff.compareNodes([&nodeChanges](const StorageDiff::NodeChange& change) {
+			nodeChanges.insert(std::to_string(change.kind) + " " + change.serializedName);
+		});
+		diff.compareEdges([&edgeChanges](const StorageDiff::EdgeChange& change) {
+			edgeChanges.insert(
+				std::to_string(change.kind) + " " + std::to_string(Edge::typeToInt(change.type)) +
+				" " + change.sourceSerializedName + " " + change.targetSerializedName);
+		});
+	}
+	FileSystem::remove(oldDbPath);
+	FileSystem::remove(newDbPath);
+
+	REQUIRE(
+		nodeChanges ==
+		std::set<std::string>(
+			{std::to_string(StorageDiff::CHANGE_REMOVED) + " b",
+			 std::to_string(StorageDiff::CHANGE_CHANGED) + " c",
+			 std::to_string(StorageDiff::CHANGE_ADDED) + " d"}));
+
+	REQUIRE(
+		edgeChanges ==
+		std::set<std::string>(
+			{std::to_string(StorageDiff::CHANGE_REMOVED) + " " +
+				 std::to_string(Edge::typeToInt(Edge::EDGE_CALL)) + " a b",
+			 std::to_string(StorageDiff::CHANGE_ADDED) + " " +
+				 std::to_string(Edge::typeToInt(Edge::EDGE_USAGE)) + " a d"}));
+}
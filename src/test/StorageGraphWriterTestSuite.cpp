@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include <sstream>
+
+#include "IntermediateStorage.h"
+#include "PersistentStorage.h"
+#include "StorageGraphWriter.h"
+
+namespace
+{
+Id addNode(IntermediateStorage* storage, const std::wstring& name, NodeType::Type type)
+{
+	NameHierarchy nameHierarchy(NAME_DELIMITER_CXX);
+	nameHierarchy.push(name);
+	return storage
+		->addNode(StorageNodeData(
+			NodeType::typeToInt(type), NameHierarchy::serializeToBinary(nameHierarchy)))
+		.first;
+}
+}	 // namespace
+
+TEST_CASE("storage graph writer knows the names of its formats")
+{
+	StorageGraphWriter::Format format = StorageGraphWriter::FORMAT_DOT;
+	REQUIRE(StorageGraphWriter::getFormatForName("graphml", &format));
+	REQUIRE(format == StorageGraphWriter::FORMAT_GRAPHML);
+	REQUIRE(StorageGraphWriter::getFormatForName("json", &format));
+	REQUIRE(format == StorageGraphWriter::FORMAT_JSON);
+	REQUIRE(!StorageGraphWriter::getFormatForName("png", &format));
+}
+
+TEST_CASE("storage graph writer escapes names for each format")
+{
+	std::stringstream dot;
+	StorageGraphWriter dotWriter(StorageGraphWriter::FORMAT_DOT, &dot);
+	dotWriter.writeHeader();
+	dotWriter.writeNode(1, NodeType(NodeType::NODE_FUNCTION), L"operator\"\"");
+	dotWriter.writeEdge(3, Edge::EDGE_CALL, 1, 2);
+	dotWriter.writeFooter();
+
+	REQUIRE(
+		std::string::npos != dot.str().find("1 [label=\"operator\\\"\\\"\" type=\"function\"];"));
+	REQUIRE(std::string::npos != dot.str().find("1 -> 2 [type=\"call\"];"));
+
+	std::stringstream graphml;
+	StorageGraphWriter graphmlWriter(StorageGraphWriter::FORMAT_GRAPHML, &graphml);
+	graphmlWriter.writeHeader();
+	graphmlWriter.writeNode(1, NodeType(NodeType::NODE_CLASS), L"A<B>");
+	graphmlWriter.writeFooter();
+
+	REQUIRE(std::string::npos != graphml.str().find("<data key=\"name\">A&lt;B&gt;</data>"));
+	REQUIRE(std::string::npos != graphml.str().find("</graphml>"));
+}
+
+TEST_CASE("storage graph writer writes valid json without edges")
+{
+	std::stringstream json;
+	StorageGraphWriter writer(StorageGraphWriter::FORMAT_JSON, &json);
+	writer.writeHeader();
+	writer.writeNode(1, NodeType(NodeType::NODE_CLASS), L"A");
+	writer.writeNode(2, NodeType(NodeType::NODE_CLASS), L"B");
+	writer.writeFooter();
+
+	REQUIRE(
+		json.str() ==
+		"{\"nodes\":[\n{\"id\":1,\"name\":\"A\",\"type\":\"class\"},\n"
+		"{\"id\":2,\"name\":\"B\",\"type\":\"class\"}\n],\"edges\":[]}\n");
+	REQUIRE(writer.getNodeCount() == 2);
+	REQUIRE(writer.getEdgeCount() == 0);
+}
+
+TEST_CASE("persistent storage exports edges of the given types and the nodes they connect")
+{
+	PersistentStorage storage(
+		FilePath(L"data/StorageGraphWriterTestSuite.sqlite"),
+		FilePath(L"data/StorageGraphWriterTestSuiteBookmarks.sqlite"));
+	storage.clear();
+
+	IntermediateStorage intermediateStorage;
+	const Id callerId = addNode(&intermediateStorage, L"caller", NodeType::NODE_FUNCTION);
+	const Id calleeId = addNode(&intermediateStorage, L"callee", NodeType::NODE_FUNCTION);
+	const Id typeId = addNode(&intermediateStorage, L"Type", NodeType::NODE_CLASS);
+	addNode(&intermediateStorage, L"unconnected", NodeType::NODE_FUNCTION);
+	intermediateStorage.addEdge(
+		StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), callerId, calleeId));
+	intermediateStorage.addEdge(
+		StorageEdgeData(Edge::typeToInt(Edge::EDGE_TYPE_USAGE), callerId, typeId));
+	storage.inject(&intermediateStorage);
+
+	std::stringstream json;
+	StorageGraphWriter writer(StorageGraphWriter::FORMAT_JSON, &json);
+	storage.exportGraph(Edge::EDGE_CALL, &writer);
+
+	REQUIRE(writer.getNodeCount() == 2);
+	REQUIRE(writer.getEdgeCount() == 1);
+	REQUIRE(std::string::npos != json.str().find("\"name\":\"callee\""));
+	REQUIRE(std::string::npos == json.str().find("\"name\":\"Type\""));
+	REQUIRE(std::string::npos == json.str().find("\"name\":\"unconnected\""));
+}
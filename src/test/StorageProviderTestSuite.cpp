@@ -0,0 +1,83 @@
+#include "catch.hpp"
+
+#include "FileSystem.h"
+#include "IntermediateStorage.h"
+#include "StorageProvider.h"
+
+namespace
+{
+std::shared_ptr<IntermediateStorage> createStorage(size_t sourceLocationCount)
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	const Id fileId = storage->addNode(StorageNodeData(0, "file" + std::to_string(sourceLocationCount))).first;
+	for (size_t i = 0; i < sourceLocationCount; i++)
+	{
+		storage->addSourceLocation(StorageSourceLocationData(fileId, i + 1, 1, i + 1, 2, 0));
+	}
+	return storage;
+}
+}	 // namespace
+
+TEST_CASE("storage provider keeps all storages in memory without budget")
+{
+	StorageProvider provider;
+	for (size_t i = 1; i <= 11; i++)
+	{
+		provider.insert(createStorage(i));
+	}
+
+	REQUIRE(11 == provider.getStorageCount());
+	REQUIRE(!provider.canInsertStorage());
+	REQUIRE(11 == provider.consumeLargestStorage()->getSourceLocationCount());
+	REQUIRE(provider.canInsertStorage());
+}
+
+TEST_CASE("storage provider moves storages exceeding budget to files and reads them back")
+{
+	const FilePath spillDirectoryPath(L"data/StorageProviderTestSuite/storages");
+	std::vector<size_t> sourceLocationCounts;
+	bool spillDirectoryExisted = false;
+	{
+		StorageProvider provider;
+		provider.setMemoryBudget(
+			createStorage(100)->getByteSize(sizeof(std::wstring)) * 3 / 2, spillDirectoryPath);
+
+		provider.insert(createStorage(100));
+		provider.insert(createStorage(50));
+		provider.insert(createStorage(20));
+
+		spillDirectoryExisted = spillDirectoryPath.recheckExists();
+
+		REQUIRE(3 == provider.getStorageCount());
+		REQUIRE(provider.canInsertStorage());
+
+		while (std::shared_ptr<IntermediateStorage> storage = provider.consumeLargestStorage())
+		{
+			sourceLocationCounts.push_back(storage->getSourceLocationCount());
+		}
+	}
+
+	REQUIRE(spillDirectoryExisted);
+	REQUIRE(!spillDirectoryPath.recheckExists());
+	REQUIRE(std::vector<size_t>({100, 50, 20}) == sourceLocationCounts);
+}
+
+TEST_CASE("storage provider limits source locations of storages consumed for merging")
+{
+	StorageProvider provider;
+	provider.insert(createStorage(100));
+	provider.insert(createStorage(60));
+	provider.insert(createStorage(30));
+	provider.insert(createStorage(20));
+
+	std::vector<size_t> sourceLocationCounts;
+	for (const std::shared_ptr<IntermediateStorage>& storage: provider.consumeAllButLargestStorage(50))
+	{
+		sourceLocationCounts.push_back(storage->getSourceLocationCount());
+	}
+
+	REQUIRE(std::vector<size_t>({30, 20}) == sourceLocationCounts);
+	REQUIRE(2 == provider.getStorageCount());
+	REQUIRE(provider.consumeAllButLargestStorage(50).empty());
+	REQUIRE(2 == provider.getStorageCount());
+}
@@ -0,0 +1,90 @@
+#include "catch.hpp"
+
+#include "IntermediateStorage.h"
+#include "PersistentStorage.h"
+#include "StorageQueryService.h"
+
+namespace
+{
+std::shared_ptr<PersistentStorage> createStorage(Id* nodeId)
+{
+	std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+		FilePath(L"data/StorageQueryServiceTestSuite.sqlite"),
+		FilePath(L"data/StorageQueryServiceTestSuiteBookmarks.sqlite"));
+	storage->clear();
+
+	NameHierarchy nameHierarchy(NAME_DELIMITER_CXX);
+	nameHierarchy.push(L"Foo");
+
+	IntermediateStorage intermediateStorage;
+	*nodeId = intermediateStorage
+				  .addNode(StorageNodeData(
+					  NodeType::typeToInt(NodeType::NODE_CLASS),
+					  NameHierarchy::serializeToBinary(nameHierarchy)))
+				  .first;
+	intermediateStorage.addSymbol(StorageSymbol(*nodeId, DEFINITION_EXPLICIT));
+	storage->inject(&intermediateStorage);
+	*nodeId = storage->getNodeIdForNameHierarchy(nameHierarchy);
+	storage->buildCaches();
+	return storage;
+}
+}	 // namespace
+
+TEST_CASE("storage query service rejects unknown and incomplete queries")
+{
+	Id nodeId = 0;
+	std::shared_ptr<PersistentStorage> storage = createStorage(&nodeId);
+	const StorageQueryService service(storage.get());
+
+	REQUIRE(404 == service.answer("unknown", {}).status);
+	REQUIRE(400 == service.answer("autocomplete", {}).status);
+	REQUIRE(404 == service.answer("definition", {}).status);
+	REQUIRE(404 == service.answer("references", {{"id", "not a number"}}).status);
+	REQUIRE(404 == service.answer("trail", {{"name", "Bar"}}).status);
+}
+
+TEST_CASE("storage query service answers queries for symbols by id and name")
+{
+	Id nodeId = 0;
+	std::shared_ptr<PersistentStorage> storage = createStorage(&nodeId);
+	const StorageQueryService service(storage.get());
+
+	const StorageQueryService::Response byId = service.answer(
+		"definition", {{"id", std::to_string(nodeId)}});
+	REQUIRE(200 == byId.status);
+	REQUIRE(std::string::npos != byId.body.find("\"definitions\""));
+
+	const StorageQueryService::Response byName = service.answer("references", {{"name", "Foo"}});
+	REQUIRE(200 == byName.status);
+	REQUIRE(std::string::npos != byName.body.find("\"id\":" + std::to_string(nodeId)));
+
+	const StorageQueryService::Response matches = service.answer("autocomplete", {{"query", "Foo"}});
+	REQUIRE(200 == matches.status);
+	REQUIRE(std::string::npos != matches.body.find("\"name\":\"Foo\""));
+
+	// classes have a trail of their base and derived classes
+	REQUIRE(200 == service.answer("trail", {{"id", std::to_string(nodeId)}}).status);
+}
+
+TEST_CASE("storage query service answers batches of symbols in the order of their names")
+{
+	Id nodeId = 0;
+	std::shared_ptr<PersistentStorage> storage = createStorage(&nodeId);
+	const StorageQueryService service(storage.get());
+
+	REQUIRE(400 == service.answer("symbols", {}).status);
+	REQUIRE(404 == service.answer("symbol", {{"name", "Bar"}}).status);
+
+	const StorageQueryService::Response symbol = service.answer("symbol", {{"name", "Foo"}});
+	REQUIRE(200 == symbol.status);
+	REQUIRE(std::string::npos != symbol.body.find("\"reference_count\":0"));
+	REQUIRE(std::string::npos != symbol.body.find("\"callers\":[]"));
+
+	const StorageQueryService::Response symbols = service.answer("symbols", {{"names", "Bar\nFoo"}});
+	REQUIRE(200 == symbols.status);
+	const size_t barPos = symbols.body.find("\"query\":\"Bar\"");
+	const size_t fooPos = symbols.body.find("\"id\":" + std::to_string(nodeId));
+	REQUIRE(std::string::npos != barPos);
+	REQUIRE(std::string::npos != fooPos);
+	REQUIRE(barPos < fooPos);
+}
@@ -2,9 +2,13 @@
 
 #include "utilityString.h"
 
+#include "Graph.h"
 #include "IntermediateStorage.h"
 #include "ParseLocation.h"
 #include "PersistentStorage.h"
+#include "SourceLocation.h"
+#include "SourceLocationFile.h"
+#include "TokenComponentAggregation.h"
 
 namespace
 {
@@ -64,7 +68,8 @@ TEST_CASE("storage saves file")
 	Id id = intermetiateStorage
 				->addNode(StorageNodeData(
 					NodeType::typeToInt(NodeType::NODE_FILE),
-					NameHierarchy::serialize(NameHierarchy(filePath, NAME_DELIMITER_FILE))))
+					NameHierarchy::serializeToBinary(
+						NameHierarchy(filePath, NAME_DELIMITER_FILE))))
 				.first;
 	intermetiateStorage->addFile(StorageFile(id, filePath, L"someLanguage", "someTime", true, true));
 
@@ -82,7 +87,8 @@ TEST_CASE("storage saves node")
 
 	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
 	intermetiateStorage->addNode(
-		StorageNodeData(NodeType::typeToInt(NodeType::NODE_TYPEDEF), NameHierarchy::serialize(a)));
+		StorageNodeData(
+			NodeType::typeToInt(NodeType::NODE_TYPEDEF), NameHierarchy::serializeToBinary(a)));
 
 	storage.inject(intermetiateStorage.get());
 
@@ -92,6 +98,40 @@ TEST_CASE("storage saves node")
 	REQUIRE(storage.getNodeTypeForNodeWithId(storedId).getType() == NodeType::NODE_TYPEDEF);
 }
 
+TEST_CASE("storage merges local symbols declared at the same location")
+{
+	TestStorage storage;
+
+	const NameHierarchy fileName(L"path/to/test.h", NAME_DELIMITER_FILE);
+	for (size_t i = 0; i < 2; i++)
+	{
+		std::shared_ptr<IntermediateStorage> intermetiateStorage =
+			std::make_shared<IntermediateStorage>();
+		if (i)
+		{
+			// gives the file another id within the second storage
+			intermetiateStorage->addNode(StorageNodeData(
+				NodeType::typeToInt(NodeType::NODE_TYPEDEF),
+				NameHierarchy::serializeToBinary(createNameHierarchy(L"type"))));
+		}
+
+		const Id fileId = intermetiateStorage
+							  ->addNode(StorageNodeData(
+								  NodeType::typeToInt(NodeType::NODE_FILE),
+								  NameHierarchy::serializeToBinary(fileName)))
+							  .first;
+		intermetiateStorage->addLocalSymbol(StorageLocalSymbolData(fileId, 2, 3));
+
+		storage.inject(intermetiateStorage.get());
+	}
+
+	const std::vector<StorageLocalSymbol>& localSymbols = storage.getStorageLocalSymbols();
+	REQUIRE(localSymbols.size() == 1);
+	REQUIRE(localSymbols[0].fileNodeId == storage.getNodeIdForNameHierarchy(fileName));
+	REQUIRE(localSymbols[0].startLine == 2);
+	REQUIRE(localSymbols[0].startCol == 3);
+}
+
 TEST_CASE("storage saves field as member")
 {
 	NameHierarchy a = createNameHierarchy(L"Struct");
@@ -103,13 +143,13 @@ TEST_CASE("storage saves field as member")
 
 	Id aId = intermetiateStorage
 				 ->addNode(StorageNodeData(
-					 NodeType::typeToInt(NodeType::NODE_STRUCT), NameHierarchy::serialize(a)))
+					 NodeType::typeToInt(NodeType::NODE_STRUCT), NameHierarchy::serializeToBinary(a)))
 				 .first;
 	intermetiateStorage->addSymbol(StorageSymbol(aId, DEFINITION_EXPLICIT));
 
 	Id bId = intermetiateStorage
 				 ->addNode(StorageNodeData(
-					 NodeType::typeToInt(NodeType::NODE_FIELD), NameHierarchy::serialize(b)))
+					 NodeType::typeToInt(NodeType::NODE_FIELD), NameHierarchy::serializeToBinary(b)))
 				 .first;
 	intermetiateStorage->addSymbol(StorageSymbol(bId, DEFINITION_EXPLICIT));
 	intermetiateStorage->addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), aId, bId));
@@ -130,6 +170,148 @@ TEST_CASE("storage saves field as member")
 	REQUIRE(foundEdge);
 }
 
+TEST_CASE("storage loads members of active node with many members only once expanded")
+{
+	TestStorage storage;
+
+	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
+
+	const Id structId = intermetiateStorage
+							->addNode(StorageNodeData(
+								NodeType::typeToInt(NodeType::NODE_STRUCT),
+								NameHierarchy::serializeToBinary(createNameHierarchy(L"Struct"))))
+							.first;
+	intermetiateStorage->addSymbol(StorageSymbol(structId, DEFINITION_EXPLICIT));
+
+	for (size_t i = 0; i < 101; i++)
+	{
+		const Id fieldId = intermetiateStorage
+							   ->addNode(StorageNodeData(
+								   NodeType::typeToInt(NodeType::NODE_FIELD),
+								   NameHierarchy::serializeToBinary(createNameHierarchy(
+									   L"Struct::m_field" + std::to_wstring(i)))))
+							   .first;
+		intermetiateStorage->addSymbol(StorageSymbol(fieldId, DEFINITION_EXPLICIT));
+		intermetiateStorage->addEdge(
+			StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), structId, fieldId));
+	}
+
+	storage.inject(intermetiateStorage.get());
+	storage.buildCaches();
+
+	const Id activeId = storage.getNodeIdForNameHierarchy(createNameHierarchy(L"Struct"));
+	std::shared_ptr<Graph> graph = storage.getGraphForActiveTokenIds({activeId}, {});
+	REQUIRE(1 == graph->getNodeCount());
+	REQUIRE(101 == graph->getNodeById(activeId)->getChildCount());
+
+	std::shared_ptr<Graph> childGraph = storage.getGraphForChildrenOfNodeId(activeId);
+	REQUIRE(102 == childGraph->getNodeCount());
+	REQUIRE(101 == childGraph->getEdgeCount());
+}
+
+TEST_CASE("storage aggregates edges of members of active node")
+{
+	TestStorage storage;
+
+	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
+
+	std::vector<Id> ids;
+	for (const std::wstring& name: {L"A", L"A::a", L"B", L"B::b"})
+	{
+		const NodeType::Type type = name.size() == 1 ? NodeType::NODE_STRUCT : NodeType::NODE_METHOD;
+		ids.push_back(intermetiateStorage
+						  ->addNode(StorageNodeData(
+							  NodeType::typeToInt(type),
+							  NameHierarchy::serializeToBinary(createNameHierarchy(name))))
+						  .first);
+		intermetiateStorage->addSymbol(StorageSymbol(ids.back(), DEFINITION_EXPLICIT));
+	}
+	intermetiateStorage->addEdge(
+		StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), ids[0], ids[1]));
+	intermetiateStorage->addEdge(
+		StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), ids[2], ids[3]));
+	intermetiateStorage->addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), ids[1], ids[3]));
+
+	storage.inject(intermetiateStorage.get());
+	storage.buildCaches();
+
+	const Id activeId = storage.getNodeIdForNameHierarchy(createNameHierarchy(L"A"));
+	const Id targetId = storage.getNodeIdForNameHierarchy(createNameHierarchy(L"B"));
+	std::shared_ptr<Graph> graph = storage.getGraphForActiveTokenIds({activeId}, {});
+
+	Edge* aggregation = graph->findEdge(
+		[](Edge* edge) { return edge->isType(Edge::EDGE_AGGREGATION); });
+	REQUIRE(aggregation);
+	REQUIRE(activeId == aggregation->getFrom()->getId());
+	REQUIRE(targetId == aggregation->getTo()->getId());
+	REQUIRE(1 == aggregation->getComponent<TokenComponentAggregation>()->getAggregationCount());
+}
+
+TEST_CASE("storage resolves locations of loaded file to nodes")
+{
+	TestStorage storage;
+
+	const std::wstring filePath = L"path/to/test.cpp";
+
+	std::shared_ptr<IntermediateStorage> intermetiateStorage = std::make_shared<IntermediateStorage>();
+	const Id fileId = intermetiateStorage
+						  ->addNode(StorageNodeData(
+							  NodeType::typeToInt(NodeType::NODE_FILE),
+							  NameHierarchy::serializeToBinary(
+								  NameHierarchy(filePath, NAME_DELIMITER_FILE))))
+						  .first;
+	intermetiateStorage->addFile(StorageFile(fileId, filePath, L"cpp", "", true, true));
+
+	std::vector<Id> ids;
+	for (const std::wstring& name: {L"caller", L"callee"})
+	{
+		ids.push_back(intermetiateStorage
+						  ->addNode(StorageNodeData(
+							  NodeType::typeToInt(NodeType::NODE_FUNCTION),
+							  NameHierarchy::serializeToBinary(createNameHierarchy(name))))
+						  .first);
+		intermetiateStorage->addSymbol(StorageSymbol(ids.back(), DEFINITION_EXPLICIT));
+	}
+	const Id callId = intermetiateStorage->addEdge(
+		StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), ids[0], ids[1]));
+
+	const int tokenType = locationTypeToInt(LOCATION_TOKEN);
+	intermetiateStorage->addOccurrence(StorageOccurrence(
+		ids[0],
+		intermetiateStorage->addSourceLocation(
+			StorageSourceLocationData(fileId, 1, 1, 1, 6, tokenType))));
+	intermetiateStorage->addOccurrence(StorageOccurrence(
+		callId,
+		intermetiateStorage->addSourceLocation(
+			StorageSourceLocationData(fileId, 2, 1, 2, 6, tokenType))));
+
+	storage.inject(intermetiateStorage.get());
+	storage.buildCaches();
+
+	const Id callerId = storage.getNodeIdForNameHierarchy(createNameHierarchy(L"caller"));
+	const Id calleeId = storage.getNodeIdForNameHierarchy(createNameHierarchy(L"callee"));
+
+	std::shared_ptr<SourceLocationFile> file = storage.getSourceLocationsForFile(FilePath(filePath));
+	std::vector<Id> locationIds;
+	for (const SourceLocation* location: file->getSourceLocations())
+	{
+		if (location->isStartLocation())
+		{
+			locationIds.push_back(location->getLocationId());
+		}
+	}
+	REQUIRE(2 == locationIds.size());
+
+	// the call is resolved to its target
+	REQUIRE(std::vector<Id>({callerId}) == storage.getNodeIdsForLocationIds({locationIds[0]}));
+	REQUIRE(std::vector<Id>({calleeId}) == storage.getNodeIdsForLocationIds({locationIds[1]}));
+
+	Id declarationId = 0;
+	const std::vector<Id> activeTokenIds = storage.getActiveTokenIdsForId(calleeId, &declarationId);
+	REQUIRE(calleeId == declarationId);
+	REQUIRE(2 == activeTokenIds.size());
+}
+
 TEST_CASE("storage saves method static")
 {
 	// TestStorage storage;
@@ -285,3 +467,50 @@ TEST_CASE("storage finds and removes depending file nodes")
 	// TS_ASSERT(!storage.getEdgeWithId(id4));
 	// TS_ASSERT(!storage.getEdgeWithId(id5));
 }
+
+TEST_CASE("intermediate storage returns existing ids for duplicate elements")
+{
+	IntermediateStorage storage;
+
+	const Id nodeId = storage.addNode(StorageNodeData(1, "a")).first;
+	REQUIRE(storage.addNode(StorageNodeData(1, "a")).first == nodeId);
+
+	const Id edgeId = storage.addEdge(StorageEdgeData(1, nodeId, nodeId));
+	REQUIRE(storage.addEdge(StorageEdgeData(1, nodeId, nodeId)) == edgeId);
+
+	const Id locationId = storage.addSourceLocation(StorageSourceLocationData(nodeId, 2, 1, 2, 5, 0));
+	storage.addSourceLocation(StorageSourceLocationData(nodeId, 1, 1, 1, 5, 0));
+	REQUIRE(storage.getStorageSourceLocations().size() == 2);
+	REQUIRE(
+		storage.addSourceLocation(StorageSourceLocationData(nodeId, 2, 1, 2, 5, 0)) == locationId);
+
+	const Id localSymbolId = storage.addLocalSymbol(StorageLocalSymbolData(L"b"));
+	REQUIRE(storage.addLocalSymbol(StorageLocalSymbolData(L"b")) == localSymbolId);
+
+	const Id declaredSymbolId = storage.addLocalSymbol(StorageLocalSymbolData(nodeId, 2, 1));
+	REQUIRE(declaredSymbolId != localSymbolId);
+	REQUIRE(storage.addLocalSymbol(StorageLocalSymbolData(nodeId, 2, 1)) == declaredSymbolId);
+	REQUIRE(storage.addLocalSymbol(StorageLocalSymbolData(nodeId, 2, 2)) != declaredSymbolId);
+}
+
+TEST_CASE("intermediate storage returns sorted unique elements")
+{
+	IntermediateStorage storage;
+
+	storage.addOccurrence(StorageOccurrence(5, 6));
+	storage.addOccurrence(StorageOccurrence(1, 6));
+	storage.addOccurrence(StorageOccurrence(5, 6));
+
+	const std::vector<StorageOccurrence>& occurrences = storage.getStorageOccurrences();
+	REQUIRE(occurrences.size() == 2);
+	REQUIRE(occurrences[0].elementId == 1);
+	REQUIRE(occurrences[1].elementId == 5);
+
+	storage.addSourceLocation(StorageSourceLocationData(1, 3, 1, 3, 5, 0));
+	storage.addSourceLocation(StorageSourceLocationData(1, 1, 1, 1, 5, 0));
+
+	const std::vector<StorageSourceLocation>& locations = storage.getStorageSourceLocations();
+	REQUIRE(locations.size() == 2);
+	REQUIRE(locations[0].startLine == 1);
+	REQUIRE(locations[1].startLine == 3);
+}
@@ -0,0 +1,50 @@
+#include "catch.hpp"
+
+#include <string>
+
+#include "SymbolIdIndex.h"
+
+TEST_CASE("symbol id index finds added names")
+{
+	SymbolIdIndex index;
+	for (size_t i = 0; i < 1000; i++)
+	{
+		index.add(SymbolIdIndex::getKey("name" + std::to_string(i)), Id(i + 1), int(i % 3));
+	}
+
+	REQUIRE(index.size() == 1000);
+	for (size_t i = 0; i < 1000; i++)
+	{
+		const SymbolIdIndex::Entry* entry = index.find(
+			SymbolIdIndex::getKey("name" + std::to_string(i)));
+		REQUIRE(entry != nullptr);
+		REQUIRE(entry->id == Id(i + 1));
+		REQUIRE(entry->type == int(i % 3));
+	}
+
+	REQUIRE(index.find(SymbolIdIndex::getKey("other")) == nullptr);
+}
+
+TEST_CASE("symbol id index keys are stable")
+{
+	const std::string name = "::a::b";
+	const SymbolIdIndex::Key key = SymbolIdIndex::getKey(name);
+
+	REQUIRE(key.hash == SymbolIdIndex::getKey(name.data(), name.size()).hash);
+	REQUIRE(key.check == SymbolIdIndex::getKey(name.data(), name.size()).check);
+	REQUIRE(SymbolIdIndex::getKey("").hash == 14695981039346656037ull);
+}
+
+TEST_CASE("symbol id index keeps names with colliding hashes apart")
+{
+	SymbolIdIndex index;
+	index.add({1, 2}, 10, 0);
+	index.add({1, 3}, 11, 0);
+	index.add({1, 2}, 12, 0);
+
+	REQUIRE(index.size() == 2);
+	REQUIRE(index.getCollisionCount() == 1);
+	REQUIRE(index.find({1, 2})->id == 10);
+	REQUIRE(index.find({1, 3})->id == 11);
+	REQUIRE(index.find({1, 4}) == nullptr);
+}
@@ -1,5 +1,8 @@
 #include "catch.hpp"
 
+#include <fstream>
+
+#include "FileSystem.h"
 #include "TextAccess.h"
 
 namespace
@@ -20,6 +23,15 @@ std::string getTestText()
 
 	return text;
 }
+
+FilePath writeTestFile(const std::wstring& name, const std::string& content)
+{
+	const FilePath filePath(L"data/TextAccessTestSuite/" + name);
+	std::ofstream file(filePath.str(), std::ios::binary);
+	file << content;
+	file.close();
+	return filePath;
+}
 }	 // namespace
 
 TEST_CASE("textAccessString constructor")
@@ -148,3 +160,74 @@ TEST_CASE("textAccessFile get filePath")
 
 	REQUIRE(textAccess->getFilePath() == filePath);
 }
+
+TEST_CASE("textAccessString line views exclude line endings")
+{
+	std::shared_ptr<TextAccess> textAccess = TextAccess::createFromString("foo\n\nbar");
+
+	REQUIRE(textAccess->getLineCount() == 3);
+	REQUIRE(std::string(textAccess->getLineView(1).data, textAccess->getLineView(1).size) == "foo");
+	REQUIRE(textAccess->getLineView(2).size == 0);
+	REQUIRE(std::string(textAccess->getLineView(3).data, textAccess->getLineView(3).size) == "bar");
+	REQUIRE(textAccess->getLine(3) == "bar");
+	REQUIRE(textAccess->getLineView(4).size == 0);
+}
+
+TEST_CASE("textAccessLines keeps lines as given")
+{
+	std::shared_ptr<TextAccess> textAccess = TextAccess::createFromLines({"foo", "bar\n", ""});
+
+	REQUIRE(textAccess->getLineCount() == 3);
+	REQUIRE(textAccess->getLine(1) == "foo");
+	REQUIRE(textAccess->getLine(2) == "bar\n");
+	REQUIRE(textAccess->getLine(3) == "");
+	REQUIRE(textAccess->getText() == "foobar\n");
+}
+
+TEST_CASE("textAccessFile converts line endings")
+{
+	const FilePath filePath = writeTestFile(L"line_endings.txt", "foo\r\nbar\rbaz\n\r\nqux");
+	std::shared_ptr<TextAccess> textAccess = TextAccess::createFromFile(filePath);
+
+	REQUIRE(textAccess->getLineCount() == 5);
+	REQUIRE(textAccess->getLine(1) == "foo\n");
+	REQUIRE(textAccess->getLine(2) == "bar\n");
+	REQUIRE(textAccess->getLine(3) == "baz\n");
+	REQUIRE(textAccess->getLine(4) == "\n");
+	REQUIRE(textAccess->getLine(5) == "qux");
+	REQUIRE(textAccess->getText() == "foo\nbar\nbaz\n\nqux");
+	REQUIRE(textAccess->getAllLines().size() == 5);
+
+	FileSystem::remove(filePath);
+}
+
+TEST_CASE("textAccessFile reads large files")
+{
+	std::string content;
+	for (int i = 0; i < 100000; i++)
+	{
+		content += "line " + std::to_string(i) + "\n";
+	}
+	const FilePath filePath = writeTestFile(L"large.txt", content);
+	std::shared_ptr<TextAccess> textAccess = TextAccess::createFromFile(filePath);
+
+	REQUIRE(textAccess->getLineCount() == 100000);
+	REQUIRE(textAccess->getLine(1) == "line 0\n");
+	REQUIRE(textAccess->getLine(100000) == "line 99999\n");
+	REQUIRE(textAccess->getText() == content);
+
+	textAccess.reset();
+	FileSystem::remove(filePath);
+}
+
+TEST_CASE("textAccessFile of empty file has no lines")
+{
+	const FilePath filePath = writeTestFile(L"empty.txt", "");
+	std::shared_ptr<TextAccess> textAccess = TextAccess::createFromFile(filePath);
+
+	REQUIRE(textAccess->isEmpty());
+	REQUIRE(textAccess->getLineCount() == 0);
+	REQUIRE(textAccess->getText() == "");
+
+	FileSystem::remove(filePath);
+}
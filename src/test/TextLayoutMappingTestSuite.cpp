@@ -0,0 +1,56 @@
+#include "catch.hpp"
+
+#include "TextLayoutMapping.h"
+
+TEST_CASE("text layout mapping moves code after changed comment")
+{
+	const TextLayoutMapping mapping(
+		"// old comment\nint foo;\n", "/* a much longer comment\n   in two lines */\nint foo;\n");
+
+	REQUIRE(mapping.isValid());
+
+	size_t line = 2;
+	size_t column = 5;
+	REQUIRE(mapping.mapPosition(line, column));
+	REQUIRE(line == 3);
+	REQUIRE(column == 5);
+}
+
+TEST_CASE("text layout mapping does not map changed code")
+{
+	REQUIRE(!TextLayoutMapping("int foo;", "int bar;").isValid());
+	REQUIRE(!TextLayoutMapping("int foo;", "int foo; // new comment").isValid());
+	REQUIRE(!TextLayoutMapping("#define A 1\nint a;", "#define A 1 int a;").isValid());
+}
+
+TEST_CASE("text layout mapping keeps comment markers in string literals as code")
+{
+	REQUIRE(!TextLayoutMapping("const char* a = \"// b\";", "const char* a = \"// c\";").isValid());
+	REQUIRE(!TextLayoutMapping("char a = '/'; int b = 1 /* x */;", "char a = '/'; int b = 2 /* x */;")
+				 .isValid());
+}
+
+TEST_CASE("text layout mapping maps comment boundaries")
+{
+	const TextLayoutMapping mapping("/* a */ int foo;", "  /* abc */ int foo;");
+
+	REQUIRE(mapping.isValid());
+
+	size_t line = 1;
+	size_t column = 7;
+	REQUIRE(mapping.mapPosition(line, column));
+	REQUIRE(column == 11);
+
+	column = 4;
+	REQUIRE(!mapping.mapPosition(line, column));
+}
+
+TEST_CASE("text layout hashes ignore comment text and indentation")
+{
+	REQUIRE(
+		TextLayoutMapping::getCodeHash("// a\n\tint foo;") ==
+		TextLayoutMapping::getCodeHash("// b\n int  foo;"));
+	REQUIRE(
+		TextLayoutMapping::getContentHash("// a\n\tint foo;") !=
+		TextLayoutMapping::getContentHash("// b\n int  foo;"));
+}
@@ -0,0 +1,80 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "ThreadPool.h"
+
+TEST_CASE("thread pool calls function for every index once")
+{
+	ThreadPool pool(3);
+
+	std::vector<std::atomic<int>> callCounts(100);
+	for (std::atomic<int>& callCount: callCounts)
+	{
+		callCount = 0;
+	}
+
+	pool.parallelFor(
+		callCounts.size(), [&](size_t i) { callCounts[i]++; }, ThreadPool::PRIORITY_INDEXING);
+
+	for (const std::atomic<int>& callCount: callCounts)
+	{
+		REQUIRE(callCount == 1);
+	}
+}
+
+TEST_CASE("thread pool finishes parallel for within jobs of all workers")
+{
+	ThreadPool pool(2);
+
+	std::atomic<int> callCount(0);
+	std::vector<std::future<void>> jobs;
+	for (size_t i = 0; i < 4; i++)
+	{
+		jobs.push_back(pool.run(
+			[&]() {
+				pool.parallelFor(
+					10, [&](size_t) { callCount++; }, ThreadPool::PRIORITY_INTERACTIVE);
+			},
+			ThreadPool::PRIORITY_INDEXING));
+	}
+
+	for (std::future<void>& job: jobs)
+	{
+		job.wait();
+	}
+
+	REQUIRE(callCount == 40);
+}
+
+TEST_CASE("thread pool runs blocking functions at the same time")
+{
+	ThreadPool pool(1);
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	int startedCount = 0;
+
+	// each function only returns after all of them started
+	std::vector<std::future<void>> jobs;
+	for (size_t i = 0; i < 3; i++)
+	{
+		jobs.push_back(pool.runBlocking([&]() {
+			std::unique_lock<std::mutex> lock(mutex);
+			startedCount++;
+			condition.notify_all();
+			condition.wait(lock, [&]() { return startedCount == 3; });
+		}));
+	}
+
+	for (std::future<void>& job: jobs)
+	{
+		job.wait();
+	}
+
+	REQUIRE(startedCount == 3);
+}
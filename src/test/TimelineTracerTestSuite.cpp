@@ -0,0 +1,58 @@
+#include "catch.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "tracing.h"
+
+namespace
+{
+void tracedFunction()
+{
+	TRACE();
+}
+
+std::string readFile(const FilePath& filePath)
+{
+	std::ifstream fileStream(filePath.str());
+	return std::string(
+		std::istreambuf_iterator<char>(fileStream), std::istreambuf_iterator<char>());
+}
+}	 // namespace
+
+TEST_CASE("timeline tracer does not record while disabled")
+{
+	TimelineTracer::setEnabled(true);
+	TimelineTracer::setEnabled(false);
+
+	tracedFunction();
+
+	REQUIRE(TimelineTracer::getEventCount() == 0);
+}
+
+TEST_CASE("timeline tracer exports events of all threads as chrome trace")
+{
+	TimelineTracer::setEnabled(true);
+	{
+		TRACE("outer \"scope\"");
+		tracedFunction();
+		std::thread(tracedFunction).join();
+	}
+	TimelineTracer::setEnabled(false);
+
+	REQUIRE(TimelineTracer::getEventCount() == 3);
+
+	const FilePath tracePath(L"data/SQLiteTestSuite/timelineTrace.json");
+	REQUIRE(TimelineTracer::exportChromeTrace(tracePath));
+
+	const std::string trace = readFile(tracePath);
+	FileSystem::remove(tracePath);
+
+	REQUIRE(trace.find("{\"traceEvents\":[") == 0);
+	REQUIRE(trace.find("\"name\":\"outer \\\"scope\\\"\"") != std::string::npos);
+	REQUIRE(trace.find("\"name\":\"tracedFunction\"") != std::string::npos);
+	REQUIRE(trace.find("\"ph\":\"X\"") != std::string::npos);
+}
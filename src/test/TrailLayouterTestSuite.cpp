@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include "Graph.h"
+#include "TrailLayouter.h"
+
+namespace
+{
+class TrailLayouterTestGraph
+{
+public:
+	void addNode(Id id, bool active = false)
+	{
+		Node* node = m_graph.createNode(
+			id,
+			NodeType(NodeType::NODE_FUNCTION),
+			NameHierarchy(std::to_wstring(id), NAME_DELIMITER_CXX),
+			DEFINITION_EXPLICIT);
+
+		std::shared_ptr<DummyNode> dummyNode = std::make_shared<DummyNode>(DummyNode::DUMMY_DATA);
+		dummyNode->data = node;
+		dummyNode->tokenId = id;
+		dummyNode->visible = true;
+		dummyNode->active = active;
+		dummyNode->size = Vec2i(100, 30);
+
+		dummyNodes.push_back(dummyNode);
+		topLevelAncestorIds.emplace(id, id);
+	}
+
+	void addEdge(Id id, Id fromId, Id toId)
+	{
+		Edge* edge = m_graph.createEdge(
+			id, Edge::EDGE_CALL, m_graph.getNodeById(fromId), m_graph.getNodeById(toId));
+
+		std::shared_ptr<DummyEdge> dummyEdge = std::make_shared<DummyEdge>(fromId, toId, edge);
+		dummyEdge->visible = true;
+		dummyEdges.push_back(dummyEdge);
+	}
+
+	std::vector<std::shared_ptr<DummyNode>> dummyNodes;
+	std::vector<std::shared_ptr<DummyEdge>> dummyEdges;
+	std::map<Id, Id> topLevelAncestorIds;
+
+private:
+	Graph m_graph;
+};
+}	 // namespace
+
+TEST_CASE("trail layouter places callees in consecutive columns")
+{
+	TrailLayouterTestGraph graph;
+	graph.addNode(1, true);
+	graph.addNode(2);
+	graph.addNode(3);
+	graph.addEdge(11, 1, 2);
+	graph.addEdge(12, 2, 3);
+
+	TrailLayouter layouter(TrailLayouter::LAYOUT_LEFT_RIGHT);
+	layouter.layoutGraph(graph.dummyNodes, graph.dummyEdges, graph.topLevelAncestorIds);
+
+	REQUIRE(graph.dummyNodes[0]->position.x < graph.dummyNodes[1]->position.x);
+	REQUIRE(graph.dummyNodes[1]->position.x < graph.dummyNodes[2]->position.x);
+}
+
+TEST_CASE("trail layouter handles cycles and graphs with many paths")
+{
+	// a chain of diamonds has exponentially many paths from the first to the last node
+	const Id diamondCount = 40;
+
+	TrailLayouterTestGraph graph;
+	graph.addNode(1, true);
+
+	Id edgeId = 1000;
+	for (Id i = 0; i < diamondCount; i++)
+	{
+		const Id start = 1 + i * 3;
+		graph.addNode(start + 1);
+		graph.addNode(start + 2);
+		graph.addNode(start + 3);
+		graph.addEdge(edgeId++, start, start + 1);
+		graph.addEdge(edgeId++, start, start + 2);
+		graph.addEdge(edgeId++, start + 1, start + 3);
+		graph.addEdge(edgeId++, start + 2, start + 3);
+	}
+	graph.addEdge(edgeId++, 1 + diamondCount * 3, 1);
+
+	TrailLayouter layouter(TrailLayouter::LAYOUT_LEFT_RIGHT);
+	layouter.layoutGraph(graph.dummyNodes, graph.dummyEdges, graph.topLevelAncestorIds);
+
+	for (const std::shared_ptr<DummyNode>& node: graph.dummyNodes)
+	{
+		REQUIRE(node->visible);
+	}
+	REQUIRE(graph.dummyNodes[0]->position.x < graph.dummyNodes[1]->position.x);
+	REQUIRE(graph.dummyNodes[1]->position.x == graph.dummyNodes[2]->position.x);
+	REQUIRE(graph.dummyNodes[1]->position.x < graph.dummyNodes[3]->position.x);
+}
@@ -5,6 +5,8 @@
 #if BUILD_JAVA_LANGUAGE_PACKAGE
 
 #	include "FilePath.h"
+#	include "FileSystem.h"
+#	include "JavaBuildResolutionCache.h"
 #	include "utility.h"
 #	include "utilityMaven.h"
 #	include "utilityPathDetection.h"
@@ -135,4 +137,42 @@ TEST_CASE("maven wrapper detects source and test directories of nested modules")
 	}
 }
 
+TEST_CASE("java build resolution cache is dropped when the build hash changes")
+{
+	const FilePath projectRootPath(L"data/UtilityMavenTestSuite/simple_maven_project");
+	const FilePath cacheDirectoryPath(L"data/UtilityMavenTestSuite/resolution_cache");
+	const std::vector<FilePath> sourceDirectories = {
+		projectRootPath.getConcatenated(L"src/main/java").makeAbsolute()};
+
+	const std::string buildHash = JavaBuildResolutionCache::getBuildHash(projectRootPath, "0");
+	REQUIRE(buildHash == JavaBuildResolutionCache::getBuildHash(projectRootPath, "0"));
+	REQUIRE(buildHash != JavaBuildResolutionCache::getBuildHash(projectRootPath, "1"));
+
+	{
+		JavaBuildResolutionCache cache(cacheDirectoryPath, buildHash);
+		REQUIRE(!cache.getDependenciesResolved());
+		cache.setDependenciesResolved();
+		cache.setSourceDirectories(sourceDirectories);
+	}
+
+	std::vector<FilePath> cachedSourceDirectories;
+	{
+		JavaBuildResolutionCache cache(cacheDirectoryPath, buildHash);
+		REQUIRE(cache.getDependenciesResolved());
+		REQUIRE(cache.getSourceDirectories(cachedSourceDirectories));
+	}
+
+	bool otherHashResolved = false;
+	{
+		JavaBuildResolutionCache cache(cacheDirectoryPath, buildHash + "x");
+		otherHashResolved = cache.getDependenciesResolved();
+	}
+
+	FileSystem::remove(cacheDirectoryPath.getConcatenated(L"build_resolution_cache.xml"));
+	FileSystem::remove(cacheDirectoryPath);
+
+	REQUIRE(cachedSourceDirectories == sourceDirectories);
+	REQUIRE(!otherHashResolved);
+}
+
 #endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
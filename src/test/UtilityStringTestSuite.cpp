@@ -266,6 +266,20 @@ TEST_CASE("to lower case")
 	REQUIRE("foobar" == utility::toLowerCase("foobar"));
 }
 
+TEST_CASE("to lower case with wide characters")
+{
+	REQUIRE(L"foo_bar::baz" == utility::toLowerCase(std::wstring(L"Foo_BAR::baz")));
+	REQUIRE(
+		std::wstring(1, std::towlower(L'\u00c4')) + L"foo" ==
+		utility::toLowerCase(std::wstring(L"\u00c4FOO")));
+	REQUIRE(L'a' == utility::toLowerCase(L'A'));
+	REQUIRE(L'@' == utility::toLowerCase(L'@'));
+	REQUIRE(utility::isUpperCase(L'Z'));
+	REQUIRE_FALSE(utility::isUpperCase(L'z'));
+	REQUIRE(utility::isLowerCase(L'z'));
+	REQUIRE_FALSE(utility::isLowerCase(L'_'));
+}
+
 TEST_CASE("equals case insensitive with different cases")
 {
 	const std::string foo = "FooBar";
@@ -300,3 +314,26 @@ TEST_CASE("replace")
 	REQUIRE("" == utility::replace("", "foo", "bar"));
 	REQUIRE("foobar" == utility::replace("foobar", "ba", "ba"));
 }
+
+TEST_CASE("utf8 conversion of ascii strings")
+{
+	const std::string ascii = "std::vector<int>::push_back";
+
+	REQUIRE(utility::isAscii(ascii));
+	REQUIRE(utility::decodeFromUtf8(ascii) == L"std::vector<int>::push_back");
+	REQUIRE(utility::encodeToUtf8(L"std::vector<int>::push_back") == ascii);
+	REQUIRE(utility::decodeFromUtf8("") == L"");
+	REQUIRE(utility::encodeToUtf8(L"") == "");
+}
+
+TEST_CASE("utf8 conversion of strings with non ascii characters after the ascii prefix")
+{
+	const std::string utf8 = "namespace_f\xC3\xBC" "r_gr\xC3\xB6\xC3\x9F" "en_\xE2\x82\xAC";
+	const std::wstring wide = L"namespace_f\u00FCr_gr\u00F6\u00DFen_\u20AC";
+
+	REQUIRE(!utility::isAscii(utf8));
+	REQUIRE(!utility::isAscii(wide));
+	REQUIRE(utility::decodeFromUtf8(utf8) == wide);
+	REQUIRE(utility::encodeToUtf8(wide) == utf8);
+	REQUIRE(utility::decodeFromUtf8(utility::encodeToUtf8(L"\u00E4\u00E4")) == L"\u00E4\u00E4");
+}
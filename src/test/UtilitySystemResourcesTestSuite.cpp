@@ -0,0 +1,31 @@
+#include "catch.hpp"
+
+#include "utilitySystemResources.h"
+
+TEST_CASE("cgroup v2 cpu limit is the quota per period")
+{
+	REQUIRE(utility::parseCgroupV2CpuMax("250000 100000") == Approx(2.5));
+	REQUIRE(utility::parseCgroupV2CpuMax("max 100000") == 0);
+	REQUIRE(utility::parseCgroupV2CpuMax("") == 0);
+}
+
+TEST_CASE("cgroup v1 cpu quota of -1 is no limit")
+{
+	REQUIRE(utility::parseCgroupV1CpuQuota("200000", "100000") == Approx(2.0));
+	REQUIRE(utility::parseCgroupV1CpuQuota("-1", "100000") == 0);
+	REQUIRE(utility::parseCgroupV1CpuQuota("100000", "") == 0);
+}
+
+TEST_CASE("cgroup memory limit ignores values for no limit")
+{
+	REQUIRE(utility::parseCgroupMemoryLimit("8589934592") == 8589934592ull);
+	REQUIRE(utility::parseCgroupMemoryLimit("max") == 0);
+	REQUIRE(utility::parseCgroupMemoryLimit("9223372036854771712") == 0);
+}
+
+TEST_CASE("cpu list contains single cpus and ranges")
+{
+	REQUIRE(utility::parseCpuList("0-3,8,10-11\n") == std::vector<size_t>({0, 1, 2, 3, 8, 10, 11}));
+	REQUIRE(utility::parseCpuList("0") == std::vector<size_t>({0}));
+	REQUIRE(utility::parseCpuList("").empty());
+}
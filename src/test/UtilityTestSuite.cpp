@@ -1,6 +1,14 @@
 #include "catch.hpp"
 
+#include <atomic>
+#include <thread>
+
+#include "OrderedCache.h"
+#include "SharedCache.h"
+#include "TokenBucket.h"
+#include "UnorderedCache.h"
 #include "utility.h"
+#include "utilityCompression.h"
 
 TEST_CASE("trim blank spaces of string")
 {
@@ -11,3 +19,149 @@ TEST_CASE("trim blank spaces of wstring")
 {
 	REQUIRE(utility::trim(L" foo  ") == L"foo");
 }
+
+TEST_CASE("bounded unordered cache drops least recently used value")
+{
+	size_t calculationCount = 0;
+	UnorderedCache<int, int> cache(
+		[&calculationCount](const int& key) {
+			calculationCount++;
+			return key * 2;
+		},
+		2);
+
+	REQUIRE(cache.getValue(1) == 2);
+	REQUIRE(cache.getValue(2) == 4);
+	REQUIRE(cache.getValue(1) == 2);
+	REQUIRE(cache.getValue(3) == 6);
+	REQUIRE(cache.getSize() == 2);
+	REQUIRE(calculationCount == 3);
+
+	REQUIRE(cache.getValue(1) == 2);
+	REQUIRE(calculationCount == 3);
+
+	REQUIRE(cache.getValue(2) == 4);
+	REQUIRE(calculationCount == 4);
+}
+
+TEST_CASE("bounded ordered cache drops least recently used value")
+{
+	size_t calculationCount = 0;
+	OrderedCache<int, int> cache(
+		[&calculationCount](const int& key) {
+			calculationCount++;
+			return key * 2;
+		},
+		2);
+
+	REQUIRE(cache.getValue(1) == 2);
+	REQUIRE(cache.getValue(2) == 4);
+	REQUIRE(cache.getValue(1) == 2);
+	REQUIRE(cache.getValue(3) == 6);
+	REQUIRE(cache.getSize() == 2);
+	REQUIRE(cache.getHitCount() == 1);
+	REQUIRE(cache.getMissCount() == 3);
+
+	REQUIRE(cache.getValue(2) == 4);
+	REQUIRE(calculationCount == 4);
+}
+
+TEST_CASE("shared cache calculates each value once for several threads")
+{
+	std::atomic<size_t> calculationCount(0);
+	SharedCache<int, int> cache(
+		[&calculationCount](const int& key) {
+			calculationCount++;
+			return key * 2;
+		},
+		0,
+		4);
+
+	std::vector<std::thread> threads;
+	std::atomic<bool> correct(true);
+	for (int i = 0; i < 4; i++)
+	{
+		threads.emplace_back([&cache, &correct]() {
+			for (int key = 0; key < 100; key++)
+			{
+				if (cache.getValue(key) != key * 2)
+				{
+					correct = false;
+				}
+			}
+		});
+	}
+	for (std::thread& thread: threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(correct);
+	REQUIRE(calculationCount == 100);
+	REQUIRE(cache.getSize() == 100);
+	REQUIRE(cache.getMissCount() == 100);
+	REQUIRE(cache.getHitCount() == 300);
+}
+
+TEST_CASE("bounded shared cache splits its size between the shards")
+{
+	SharedCache<int, int> cache([](const int& key) { return key; }, 8, 4);
+
+	for (int key = 0; key < 100; key++)
+	{
+		cache.getValue(key);
+	}
+
+	REQUIRE(cache.getSize() <= 8);
+
+	cache.clear();
+	REQUIRE(cache.getSize() == 0);
+}
+
+TEST_CASE("token bucket grants work until consumed tokens are refilled")
+{
+	TokenBucket bucket(10, 1000);
+	REQUIRE(bucket.hasTokens());
+
+	bucket.consume(60);
+	REQUIRE(!bucket.hasTokens());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	REQUIRE(bucket.hasTokens());
+	REQUIRE(bucket.getTokens() <= 10);
+
+	bucket.setRefillRate(0);
+	bucket.consume(20);
+	REQUIRE(!bucket.hasTokens());
+
+	bucket.fill();
+	REQUIRE(bucket.getTokens() == 10);
+}
+
+TEST_CASE("compressed data decompresses to original data")
+{
+	std::string data;
+	for (int i = 0; i < 1000; i++)
+	{
+		data += "line " + std::to_string(i % 17) + "\n";
+	}
+
+	for (const std::string& original: {std::string(), std::string("short"), data})
+	{
+		const std::string compressed = utility::compressData(original);
+		std::string decompressed;
+		REQUIRE(utility::decompressData(compressed.data(), compressed.size(), &decompressed));
+		REQUIRE(decompressed == original);
+	}
+
+	REQUIRE(utility::compressData(data).size() < data.size() / 4);
+}
+
+TEST_CASE("decompressing invalid data fails")
+{
+	const std::string compressed = utility::compressData("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+	std::string decompressed;
+
+	REQUIRE(!utility::decompressData(compressed.data(), compressed.size() - 1, &decompressed));
+	REQUIRE(!utility::decompressData("abc", 3, &decompressed));
+}
@@ -117,7 +117,7 @@ public:
 			nodesMap.emplace(node.id, node);
 
 			std::wstring nameStr =
-				NameHierarchy::deserialize(node.serializedName).getQualifiedNameWithSignature();
+				NameHierarchy::deserializeFromBinary(node.serializedName).getQualifiedNameWithSignature();
 
 			for (auto qualifierLocationIt = qualifierLocationMap.find(node.id);
 				 qualifierLocationIt != qualifierLocationMap.end() &&
@@ -216,7 +216,7 @@ public:
 			if (bin != nullptr)
 			{
 				std::wstring sourceName =
-					NameHierarchy::deserialize(source.serializedName).getQualifiedNameWithSignature();
+					NameHierarchy::deserializeFromBinary(source.serializedName).getQualifiedNameWithSignature();
 				try
 				{
 					if (FilePath(sourceName).exists())
@@ -229,7 +229,7 @@ public:
 				}
 
 				std::wstring targetName =
-					NameHierarchy::deserialize(target.serializedName).getQualifiedNameWithSignature();
+					NameHierarchy::deserializeFromBinary(target.serializedName).getQualifiedNameWithSignature();
 				try
 				{
 					if (FilePath(targetName).exists())
@@ -264,8 +264,17 @@ public:
 			}
 		}
 
-		for (const StorageLocalSymbol& localSymbol: getStorageLocalSymbols())
+		for (const StorageLocalSymbol& storageLocalSymbol: getStorageLocalSymbols())
 		{
+			// symbols identified by their declaration location are shown like named ones
+			StorageLocalSymbol localSymbol = storageLocalSymbol;
+			if (localSymbol.fileNodeId)
+			{
+				localSymbol.name = filePathMap[localSymbol.fileNodeId].fileName() + L"<" +
+					std::to_wstring(localSymbol.startLine) + L":" +
+					std::to_wstring(localSymbol.startCol) + L">";
+			}
+
 			bool added = false;
 			for (auto localSymbolLocationIt = localSymbolLocationMap.find(localSymbol.id);
 				 localSymbolLocationIt != localSymbolLocationMap.end() &&